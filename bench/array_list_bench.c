@@ -0,0 +1,216 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2020 Cole Vikupitz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "bench_common.h"
+#include "array_list.h"
+#include "ts_array_list.h"
+
+// Maximum number of front insertions performed, since each one is linear
+#define MAX_FRONT_INSERTS 10000L
+
+/*
+ * Benchmarks the single-threaded add/get/set/insert/remove paths of the ArrayList with `n` items.
+ */
+static void benchArrayList(BenchCorpus *corpus, long n) {
+
+    ArrayList *list;
+    BenchSamples lat;
+    void *prev;
+    long i, start, front = ( n < MAX_FRONT_INSERTS ) ? n : MAX_FRONT_INSERTS;
+
+    if (arraylist_new(&list, 0L) != OK) {
+        exit(1);
+    }
+
+    bench_samples_init(&lat, n);
+    start = bench_now();
+    for (i = 0L; i < n; i++) {
+        BENCH_TIMED(&lat, i, (void)arraylist_add(list, corpus->keys[i % corpus->len]));
+    }
+    bench_report("ArrayList", "add", n, 1L, n, bench_now() - start, &lat);
+
+    lat.len = 0L;
+    start = bench_now();
+    for (i = 0L; i < n; i++) {
+        BENCH_TIMED(&lat, i, (void)arraylist_get(list, (i * 7919L) % n, &prev));
+    }
+    bench_report("ArrayList", "get", n, 1L, n, bench_now() - start, &lat);
+
+    lat.len = 0L;
+    start = bench_now();
+    for (i = 0L; i < n; i++) {
+        BENCH_TIMED(&lat, i, (void)arraylist_set(list, i, corpus->keys[0], &prev));
+    }
+    bench_report("ArrayList", "set", n, 1L, n, bench_now() - start, &lat);
+
+    lat.len = 0L;
+    start = bench_now();
+    for (i = 0L; i < front; i++) {
+        BENCH_TIMED(&lat, i, (void)arraylist_insert(list, 0L, corpus->keys[0]));
+    }
+    bench_report("ArrayList", "insert(0)", n, 1L, front, bench_now() - start, &lat);
+
+    lat.len = 0L;
+    start = bench_now();
+    for (i = 0L; i < n; i++) {
+        BENCH_TIMED(&lat, i, (void)arraylist_remove(list, arraylist_size(list) - 1L, &prev));
+    }
+    bench_report("ArrayList", "remove(last)", n, 1L, n, bench_now() - start, &lat);
+
+    bench_samples_free(&lat);
+    arraylist_destroy(list, NULL);
+}
+
+/*
+ * Comparator over the corpus keys.
+ */
+static int compareKeys(void *a, void *b) {
+    return strcmp((char *)a, (char *)b);
+}
+
+/*
+ * Fills `list` with `n` corpus keys in a scrambled order.
+ */
+static void fillScrambled(ArrayList *list, BenchCorpus *corpus, long n) {
+
+    long i;
+
+    arraylist_clear(list, NULL);
+    for (i = 0L; i < n; i++) {
+        (void)arraylist_add(list, corpus->keys[( (i * 7919L) + (i >> 3) ) % corpus->len]);
+    }
+}
+
+/*
+ * Benchmarks sorting `n` items in place, stably, and across 2 to `maxThreads` threads.
+ */
+static void benchSort(BenchCorpus *corpus, long n, long maxThreads) {
+
+    ArrayList *list;
+    long t, start;
+
+    if (arraylist_new(&list, n) != OK) {
+        exit(1);
+    }
+
+    fillScrambled(list, corpus, n);
+    start = bench_now();
+    (void)arraylist_sort(list, compareKeys);
+    bench_report("ArrayList", "sort", n, 1L, n, bench_now() - start, NULL);
+
+    fillScrambled(list, corpus, n);
+    start = bench_now();
+    (void)arraylist_stableSort(list, compareKeys);
+    bench_report("ArrayList", "stableSort", n, 1L, n, bench_now() - start, NULL);
+
+    // Sorting the already sorted list again
+    start = bench_now();
+    (void)arraylist_stableSort(list, compareKeys);
+    bench_report("ArrayList", "resort(stable)", n, 1L, n, bench_now() - start, NULL);
+
+    for (t = 2L; t <= maxThreads; t *= 2L) {
+        fillScrambled(list, corpus, n);
+        start = bench_now();
+        (void)arraylist_parallelSort(list, compareKeys, (int)t);
+        bench_report("ArrayList", "parallelSort", n, t, n, bench_now() - start, NULL);
+    }
+    arraylist_destroy(list, NULL);
+}
+
+// Size of the index range the concurrent workers operate over
+static long range;
+
+/*
+ * Worker routine performing a 90% get, 10% set mix on the ConcurrentArrayList.
+ */
+static void *mixedWorker(void *arg) {
+
+    BenchWorker *w = (BenchWorker *)arg;
+    ConcurrentArrayList *list = (ConcurrentArrayList *)w->instance;
+    void *prev;
+    long i, k;
+
+    for (i = 0L; i < w->ops; i++) {
+        k = ( (i * w->nthreads) + w->id ) % range;
+        if ((i % 10L) == 0L) {
+            BENCH_TIMED(&(w->lat), i, (void)ts_arraylist_set(list, k, w->corpus->keys[0], &prev));
+        } else {
+            BENCH_TIMED(&(w->lat), i, (void)ts_arraylist_get(list, k, &prev));
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Benchmarks the ConcurrentArrayList with `n` items across 1 to `maxThreads` threads.
+ */
+static void benchConcurrentArrayList(BenchCorpus *corpus, long n, long maxThreads) {
+
+    ConcurrentArrayList *list;
+    BenchSamples lat;
+    long i, t, start;
+
+    if (ts_arraylist_new(&list, 0L) != OK) {
+        exit(1);
+    }
+
+    bench_samples_init(&lat, n);
+    start = bench_now();
+    for (i = 0L; i < n; i++) {
+        BENCH_TIMED(&lat, i, (void)ts_arraylist_add(list, corpus->keys[i % corpus->len]));
+    }
+    bench_report("ConcurrentArrayList", "add", n, 1L, n, bench_now() - start, &lat);
+    bench_samples_free(&lat);
+
+    range = n;
+    for (t = 1L; t <= maxThreads; t *= 2L) {
+        (void)bench_run_threads("ConcurrentArrayList", "get90/set10", n, list, corpus, t, n,
+                                mixedWorker);
+    }
+    ts_arraylist_destroy(list, NULL);
+}
+
+// The benchmarked list sizes
+static long sizes[] = { 1000L, 100000L, 1000000L };
+#define NSIZES 3
+
+int main(int argc, char **argv) {
+
+    BenchCorpus corpus;
+    long maxSize = 1000000L, maxThreads = BENCH_MAX_THREADS;
+    int i;
+
+    bench_parse_args(argc, argv, &maxSize, &maxThreads);
+    bench_corpus_load(&corpus, BENCH_BIBLE, 0L);
+    for (i = 0; i < NSIZES && sizes[i] <= maxSize; i++) {
+        benchArrayList(&corpus, sizes[i]);
+        benchSort(&corpus, sizes[i], maxThreads);
+        benchConcurrentArrayList(&corpus, sizes[i], maxThreads);
+    }
+    bench_corpus_free(&corpus);
+
+    return 0;
+}
@@ -0,0 +1,322 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2020 Cole Vikupitz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "bench_common.h"
+
+long bench_now(void) {
+
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ( (ts.tv_sec * 1000000000L) + ts.tv_nsec );
+}
+
+void bench_corpus_load(BenchCorpus *corpus, const char *path, long max) {
+
+    FILE *fd;
+    char line[4096];
+    long cap = 1024L;
+    size_t len;
+
+    if ((fd = fopen(path, "r")) == NULL) {
+        fprintf(stderr, "ERROR: Failed to open the corpus file %s\n", path);
+        exit(1);
+    }
+
+    corpus->len = 0L;
+    corpus->keys = (char **)malloc(cap * sizeof(char *));
+    if (corpus->keys == NULL) {
+        fprintf(stderr, "ERROR: Allocation failure while loading %s\n", path);
+        exit(1);
+    }
+
+    while (fgets(line, sizeof(line), fd) != NULL) {
+        if (max > 0L && corpus->len == max) {
+            break;
+        }
+        // Strip the trailing newline, skip over empty lines
+        len = strcspn(line, "\r\n");
+        line[len] = '\0';
+        if (len == 0) {
+            continue;
+        }
+
+        if (corpus->len == cap) {
+            cap *= 2L;
+            char **keys = (char **)realloc(corpus->keys, cap * sizeof(char *));
+            if (keys == NULL) {
+                fprintf(stderr, "ERROR: Allocation failure while loading %s\n", path);
+                exit(1);
+            }
+            corpus->keys = keys;
+        }
+        corpus->keys[corpus->len] = (char *)malloc(len + 1);
+        if (corpus->keys[corpus->len] == NULL) {
+            fprintf(stderr, "ERROR: Allocation failure while loading %s\n", path);
+            exit(1);
+        }
+        memcpy(corpus->keys[corpus->len++], line, len + 1);
+    }
+    fclose(fd);
+}
+
+void bench_corpus_free(BenchCorpus *corpus) {
+
+    long i;
+    for (i = 0L; i < corpus->len; i++) {
+        free(corpus->keys[i]);
+    }
+    free(corpus->keys);
+    corpus->keys = NULL;
+    corpus->len = 0L;
+}
+
+void bench_samples_init(BenchSamples *lat, long expected) {
+
+    lat->len = 0L;
+    lat->capacity = ( expected <= 0L ) ? 1L : expected;
+    lat->samples = (long *)malloc(lat->capacity * sizeof(long));
+    if (lat->samples == NULL) {
+        fprintf(stderr, "ERROR: Allocation failure for latency samples\n");
+        exit(1);
+    }
+}
+
+void bench_samples_add(BenchSamples *lat, long ns) {
+
+    if (lat->len < lat->capacity) {
+        lat->samples[lat->len++] = ns;
+    }
+}
+
+void bench_samples_merge(BenchSamples *dst, BenchSamples *src) {
+
+    long i;
+    for (i = 0L; i < src->len; i++) {
+        bench_samples_add(dst, src->samples[i]);
+    }
+    bench_samples_free(src);
+}
+
+void bench_samples_free(BenchSamples *lat) {
+
+    free(lat->samples);
+    lat->samples = NULL;
+    lat->len = lat->capacity = 0L;
+}
+
+/**
+ * Comparator used for sorting the latency samples.
+ */
+static int _cmp_sample(const void *a, const void *b) {
+
+    long x = *(const long *)a, y = *(const long *)b;
+    return ( x < y ) ? -1 : ( x > y );
+}
+
+/**
+ * Returns the `pct` percentile out of the sorted samples.
+ */
+static long _percentile(BenchSamples *lat, double pct) {
+
+    long i = (long)(pct * (double)(lat->len - 1L));
+    return lat->samples[i];
+}
+
+void bench_histogram_init(BenchHistogram *hist) {
+
+    memset(hist->counts, 0, sizeof(hist->counts));
+    hist->total = 0L;
+    hist->max = 0L;
+}
+
+/**
+ * Returns the bucket of the histogram the latency falls into.
+ */
+static long _hist_bucket(long ns) {
+
+    int magnitude;
+
+    if (ns < (1L << BENCH_HIST_SUB_BITS)) {
+        return ( ns < 0L ) ? 0L : ns;
+    }
+    // Keep the leading bits of the latency, below its magnitude
+    magnitude = 63 - __builtin_clzl((unsigned long)ns);
+    return ((long)(magnitude - BENCH_HIST_SUB_BITS + 1) << BENCH_HIST_SUB_BITS) +
+           ((ns >> (magnitude - BENCH_HIST_SUB_BITS)) & ((1L << BENCH_HIST_SUB_BITS) - 1L));
+}
+
+/**
+ * Returns the highest latency that falls into the bucket.
+ */
+static long _hist_highest(long bucket) {
+
+    long shift, sub;
+
+    if (bucket < (1L << BENCH_HIST_SUB_BITS)) {
+        return bucket;
+    }
+    shift = (bucket >> BENCH_HIST_SUB_BITS) - 1L;
+    sub = bucket & ((1L << BENCH_HIST_SUB_BITS) - 1L);
+    return (((1L << BENCH_HIST_SUB_BITS) + sub + 1L) << shift) - 1L;
+}
+
+void bench_histogram_record(BenchHistogram *hist, long ns) {
+
+    hist->counts[_hist_bucket(ns)]++;
+    hist->total++;
+    if (ns > hist->max) {
+        hist->max = ns;
+    }
+}
+
+void bench_histogram_merge(BenchHistogram *dst, const BenchHistogram *src) {
+
+    long i;
+    for (i = 0L; i < BENCH_HIST_BUCKETS; i++) {
+        dst->counts[i] += src->counts[i];
+    }
+    dst->total += src->total;
+    if (src->max > dst->max) {
+        dst->max = src->max;
+    }
+}
+
+long bench_histogram_percentile(const BenchHistogram *hist, double pct) {
+
+    long i, seen = 0L, rank = (long)(pct * (double)hist->total + 0.999999);
+
+    if (hist->total == 0L) {
+        return 0L;
+    }
+    rank = ( rank < 1L ) ? 1L : rank;
+    for (i = 0L; i < BENCH_HIST_BUCKETS; i++) {
+        seen += hist->counts[i];
+        if (seen >= rank) {
+            break;
+        }
+    }
+    // The top bucket's bound may exceed every recorded latency
+    return ( _hist_highest(i) < hist->max ) ? _hist_highest(i) : hist->max;
+}
+
+void bench_report(const char *adt, const char *op, long n, long nthreads, long ops, long elapsed,
+                  BenchSamples *lat) {
+
+    double nsPerOp = ( ops == 0L ) ? 0.0 : ( (double)elapsed / (double)ops );
+    long p50 = 0L, p99 = 0L;
+
+    if (lat != NULL && lat->len > 0L) {
+        qsort(lat->samples, lat->len, sizeof(long), _cmp_sample);
+        p50 = _percentile(lat, 0.50);
+        p99 = _percentile(lat, 0.99);
+    }
+    fprintf(stdout, "%-32s %-16s n=%-9ld threads=%-3ld ns/op=%-10.1f p50=%-8ld p99=%-8ld\n",
+            adt, op, n, nthreads, nsPerOp, p50, p99);
+    fflush(stdout);
+}
+
+long bench_run_threads(const char *adt, const char *op, long n, void *instance,
+                       BenchCorpus *corpus, long nthreads, long ops, void *(*worker)(void *)) {
+
+    pthread_t threads[BENCH_MAX_THREADS];
+    BenchWorker workers[BENCH_MAX_THREADS];
+    BenchSamples lat;
+    long i, start, elapsed;
+
+    if (nthreads > BENCH_MAX_THREADS) {
+        nthreads = BENCH_MAX_THREADS;
+    }
+    for (i = 0L; i < nthreads; i++) {
+        workers[i].instance = instance;
+        workers[i].corpus = corpus;
+        workers[i].id = i;
+        workers[i].nthreads = nthreads;
+        workers[i].ops = ops / nthreads;
+        bench_samples_init(&(workers[i].lat), (workers[i].ops / (BENCH_SAMPLE_MASK + 1L)) + 1L);
+    }
+
+    start = bench_now();
+    for (i = 0L; i < nthreads; i++) {
+        pthread_create(&threads[i], NULL, worker, &workers[i]);
+    }
+    for (i = 0L; i < nthreads; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    elapsed = bench_now() - start;
+
+    bench_samples_init(&lat, (ops / (BENCH_SAMPLE_MASK + 1L)) + nthreads);
+    for (i = 0L; i < nthreads; i++) {
+        bench_samples_merge(&lat, &(workers[i].lat));
+    }
+    bench_report(adt, op, n, nthreads, (ops / nthreads) * nthreads, elapsed, &lat);
+    bench_samples_free(&lat);
+
+    return elapsed;
+}
+
+long bench_hash(void *key, long N) {
+
+    unsigned long val = 5381UL;
+    unsigned char *ch;
+
+    for (ch = (unsigned char *)key; *ch != '\0'; ch++) {
+        val = ((val << 5) + val) + *ch;
+    }
+    return (long)(val % (unsigned long)N);
+}
+
+uint64_t bench_hashCode(void *key) {
+
+    uint64_t val = 14695981039346656037UL;
+    unsigned char *ch;
+
+    for (ch = (unsigned char *)key; *ch != '\0'; ch++) {
+        val = ( val ^ *ch ) * 1099511628211UL;
+    }
+    return val;
+}
+
+int bench_strcmp(void *a, void *b) {
+    return strcmp((char *)a, (char *)b);
+}
+
+void bench_parse_args(int argc, char **argv, long *maxSize, long *maxThreads) {
+
+    if (argc > 1) {
+        *maxSize = atol(argv[1]);
+    }
+    if (argc > 2) {
+        *maxThreads = atol(argv[2]);
+    }
+    if (*maxThreads < 1L) {
+        *maxThreads = 1L;
+    }
+    if (*maxThreads > BENCH_MAX_THREADS) {
+        *maxThreads = BENCH_MAX_THREADS;
+    }
+}
@@ -0,0 +1,211 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2020 Cole Vikupitz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _CDS_BENCH_COMMON_H__
+#define _CDS_BENCH_COMMON_H__
+
+#include <pthread.h>
+#include <stdint.h>
+
+/**
+ * Shared utilities for the libcds benchmark executables.
+ *
+ * Each benchmark measures the wall time of a batch of operations for throughput (ns/op), and
+ * samples the latency of individual operations to produce p50/p99 figures. Key corpora are loaded
+ * from the text files under test/, one key per line.
+ */
+
+// Path to the large, random-line corpus (relative to the bench folder)
+#define BENCH_BIGFILE "../test/bigfile.txt"
+// Path to the natural-language corpus (relative to the bench folder)
+#define BENCH_BIBLE "../test/american-bible.txt"
+
+// Only every (BENCH_SAMPLE_MASK + 1)th operation has its latency sampled
+#define BENCH_SAMPLE_MASK 7L
+// Maximum number of worker threads used by the concurrent benchmarks
+#define BENCH_MAX_THREADS 8
+
+/**
+ * A collection of latency samples (in nanoseconds) recorded during a benchmark run.
+ */
+typedef struct {
+    long *samples;      // Array of recorded latencies
+    long len;           // Number of recorded latencies
+    long capacity;      // Capacity of the samples array
+} BenchSamples;
+
+// Number of bits of each latency kept by a BenchHistogram, bounding its relative error to 1/16
+#define BENCH_HIST_SUB_BITS 4
+// Number of buckets in a BenchHistogram, enough for every positive long
+#define BENCH_HIST_BUCKETS (64L << BENCH_HIST_SUB_BITS)
+
+/**
+ * A log-linear histogram of latencies (in nanoseconds), in the style of HdrHistogram. Each power of
+ * two is split into 2^BENCH_HIST_SUB_BITS buckets, so every latency is recorded at a fixed cost
+ * and in fixed space, and percentiles are reported to within a bucket's width.
+ */
+typedef struct {
+    long counts[BENCH_HIST_BUCKETS];    // Number of latencies recorded into each bucket
+    long total;         // Number of latencies recorded
+    long max;           // Largest latency recorded
+} BenchHistogram;
+
+/**
+ * A corpus of keys loaded from one of the test files.
+ */
+typedef struct {
+    char **keys;        // Array of keys, one per line of the file
+    long len;           // Number of keys loaded
+} BenchCorpus;
+
+/**
+ * Arguments handed to each worker thread of a concurrent benchmark.
+ */
+typedef struct {
+    void *instance;     // The structure under test
+    BenchCorpus *corpus;// The key corpus to draw keys from
+    long id;            // The worker's index, in [0, nthreads)
+    long nthreads;      // The total number of workers
+    long ops;           // Number of operations this worker should perform
+    BenchSamples lat;   // Latency samples recorded by this worker
+} BenchWorker;
+
+/**
+ * Returns the current value of the monotonic clock in nanoseconds.
+ */
+long bench_now(void);
+
+/**
+ * Loads at most `max` lines from the file at `path` into `corpus`, stripping the trailing
+ * newlines. If `max` is <= 0, the entire file is loaded. Exits the program if the file can't be
+ * read.
+ */
+void bench_corpus_load(BenchCorpus *corpus, const char *path, long max);
+
+/**
+ * Frees all of the keys held inside the corpus.
+ */
+void bench_corpus_free(BenchCorpus *corpus);
+
+/**
+ * Initializes the sample collection for at most `expected` samples.
+ */
+void bench_samples_init(BenchSamples *lat, long expected);
+
+/**
+ * Records the latency sample `ns` into the collection. Samples beyond the initial capacity are
+ * dropped.
+ */
+void bench_samples_add(BenchSamples *lat, long ns);
+
+/**
+ * Appends all of the samples from `src` into `dst`, then frees `src`.
+ */
+void bench_samples_merge(BenchSamples *dst, BenchSamples *src);
+
+/**
+ * Frees the sample collection.
+ */
+void bench_samples_free(BenchSamples *lat);
+
+/**
+ * Empties the histogram.
+ */
+void bench_histogram_init(BenchHistogram *hist);
+
+/**
+ * Records the latency `ns` into the histogram.
+ */
+void bench_histogram_record(BenchHistogram *hist, long ns);
+
+/**
+ * Adds all of the latencies recorded in `src` into `dst`.
+ */
+void bench_histogram_merge(BenchHistogram *dst, const BenchHistogram *src);
+
+/**
+ * Returns the `pct` percentile (in [0.0, 1.0]) of the recorded latencies, as the highest latency
+ * of the bucket it falls in. Returns 0 if the histogram is empty.
+ */
+long bench_histogram_percentile(const BenchHistogram *hist, double pct);
+
+/**
+ * Prints out a single benchmark result line for the operation `op` run on the structure `adt`.
+ * `elapsed` is the total wall time in nanoseconds spent performing `ops` operations, and `lat`
+ * holds the sampled latencies used for computing the percentiles (may be NULL).
+ */
+void bench_report(const char *adt, const char *op, long n, long nthreads, long ops, long elapsed,
+                  BenchSamples *lat);
+
+/**
+ * Runs `worker` across `nthreads` threads, each receiving its own BenchWorker with `ops`
+ * operations to perform, then reports the merged result. Returns the total elapsed time.
+ */
+long bench_run_threads(const char *adt, const char *op, long n, void *instance,
+                       BenchCorpus *corpus, long nthreads, long ops, void *(*worker)(void *));
+
+/**
+ * Hash function over C-string keys used by the hashing benchmarks.
+ */
+long bench_hash(void *key, long N);
+
+/**
+ * Full-width hash function over C-string keys used by the hashing benchmarks.
+ */
+uint64_t bench_hashCode(void *key);
+
+/**
+ * Comparator over C-string keys used by the benchmarks.
+ */
+int bench_strcmp(void *a, void *b);
+
+/**
+ * Parses the optional command line arguments `[maxSize] [maxThreads]` shared by all of the
+ * benchmark executables.
+ */
+void bench_parse_args(int argc, char **argv, long *maxSize, long *maxThreads);
+
+// Times the single statement `stmt`, recording into `lat` if the iteration `i` is sampled
+#define BENCH_TIMED(lat, i, stmt) { \
+    if (((i) & BENCH_SAMPLE_MASK) == 0L) { \
+        long _t0 = bench_now(); \
+        stmt; \
+        bench_samples_add((lat), bench_now() - _t0); \
+    } else { \
+        stmt; \
+    } \
+}
+
+// Like BENCH_TIMED, but records the sampled latency into the histogram `hist`
+#define BENCH_HIST_TIMED(hist, i, stmt) { \
+    if (((i) & BENCH_SAMPLE_MASK) == 0L) { \
+        long _t0 = bench_now(); \
+        stmt; \
+        bench_histogram_record((hist), bench_now() - _t0); \
+    } else { \
+        stmt; \
+    } \
+}
+
+#endif  /* _CDS_BENCH_COMMON_H__ */
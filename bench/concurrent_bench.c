@@ -0,0 +1,456 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2020 Cole Vikupitz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*
+ * Stress and scalability harness for the thread-safe ADTs.
+ *
+ * Each workload runs a mix of reads and writes over a shared instance, across 1 to `maxThreads`
+ * threads pinned to their own cores, and reports the throughput, its scaling over the single
+ * thread run, and latency percentiles from HdrHistogram-style histograms. Results are printed as
+ * text, CSV or JSON for regression tracking:
+ *
+ *     ./concurrent_bench [maxSize] [maxThreads] [-r readPercent]... [-n ops] [-f text|csv|json]
+ *                        [-u]
+ *
+ * `maxSize` is the number of distinct keys, `-r` may be repeated to run several mixes (90 and 50
+ * by default), `-n` is the number of operations per run and `-u` leaves the threads unpinned.
+ * Building the library and this harness with CFLAGS="-g -O1 -fPIC -fsanitize=thread" turns the
+ * runs into a data race check over the thread-safe ADTs.
+ */
+
+#if defined(__linux__)
+#define _GNU_SOURCE
+#include <sched.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "bench_common.h"
+#include "ts_hash_map.h"
+#include "ts_queue.h"
+#include "ts_tree_map.h"
+
+// Maximum number of worker threads, and of read/write mixes per run
+#define MAX_THREADS 64
+#define MAX_MIXES 8
+
+// Output formats of the results
+#define FORMAT_TEXT 0
+#define FORMAT_CSV 1
+#define FORMAT_JSON 2
+
+/*
+ * A workload over one of the thread-safe ADTs. Reads and writes draw their keys from the first
+ * `range` keys of the corpus.
+ */
+typedef struct {
+    const char *adt;                            // Name of the ADT under test
+    void *(*create)(BenchCorpus *, long);       // Creates and populates an instance
+    void (*read)(void *, void *);               // Performs a read of the key
+    void (*write)(void *, void *, long);        // Performs the i-th write, of the key
+    void (*destroy)(void *);                    // Destroys the instance
+} Workload;
+
+/*
+ * State of each worker thread.
+ */
+typedef struct {
+    const Workload *workload;
+    void *instance;
+    BenchCorpus *corpus;
+    pthread_barrier_t *start;   // Released once every worker is ready
+    long id;
+    long ops;                   // Number of operations to perform
+    long range;                 // Number of keys operated on
+    long readPercent;           // Share of the operations that are reads
+    long began;                 // Clock reading as the worker started its operations
+    long ended;                 // Clock reading as the worker finished them
+    BenchHistogram hist;        // Latencies of this worker's sampled operations
+} Worker;
+
+/*
+ * Options of the harness.
+ */
+typedef struct {
+    long maxSize;
+    long maxThreads;
+    long ops;
+    long mixes[MAX_MIXES];
+    int nmixes;
+    int format;
+    int pin;
+} Options;
+
+// Whether a result has been printed yet, to separate the JSON records
+static int printed = 0;
+
+/*
+ * ConcurrentQueue workload: reads poll the head, writes add to the tail.
+ */
+static void *createQueue(BenchCorpus *corpus, long range) {
+
+    ConcurrentQueue *queue;
+    long i;
+
+    if (ts_queue_new(&queue) != OK) {
+        exit(1);
+    }
+    for (i = 0L; i < range; i++) {
+        (void)ts_queue_add(queue, corpus->keys[i]);
+    }
+    return queue;
+}
+
+static void readQueue(void *instance, void *key) {
+    void *first;
+    (void)key;
+    (void)ts_queue_poll((ConcurrentQueue *)instance, &first);
+}
+
+static void writeQueue(void *instance, void *key, long i) {
+    (void)i;
+    (void)ts_queue_add((ConcurrentQueue *)instance, key);
+}
+
+static void destroyQueue(void *instance) {
+    ts_queue_destroy((ConcurrentQueue *)instance, NULL);
+}
+
+/*
+ * ConcurrentHashMap workload: reads get a key, writes alternate between putting and removing one,
+ * keeping the map at about half of the keys.
+ */
+static void *createHashMap(BenchCorpus *corpus, long range) {
+
+    ConcurrentHashMap *map;
+    void *prev;
+    long i;
+
+    if (ts_hashmap_new(&map, bench_hash, bench_strcmp, 0L, 0.0, NULL) != OK) {
+        exit(1);
+    }
+    for (i = 0L; i < range; i += 2L) {
+        (void)ts_hashmap_put(map, corpus->keys[i], corpus->keys[i], &prev);
+    }
+    return map;
+}
+
+static void readHashMap(void *instance, void *key) {
+    void *value;
+    (void)ts_hashmap_get((ConcurrentHashMap *)instance, key, &value);
+}
+
+static void writeHashMap(void *instance, void *key, long i) {
+    void *value;
+    if ((i & 1L) == 0L) {
+        (void)ts_hashmap_put((ConcurrentHashMap *)instance, key, key, &value);
+    } else {
+        (void)ts_hashmap_remove((ConcurrentHashMap *)instance, key, &value);
+    }
+}
+
+static void destroyHashMap(void *instance) {
+    ts_hashmap_destroy((ConcurrentHashMap *)instance, NULL);
+}
+
+/*
+ * ConcurrentTreeMap workload, with the same operations as the ConcurrentHashMap's.
+ */
+static void *createTreeMap(BenchCorpus *corpus, long range) {
+
+    ConcurrentTreeMap *tree;
+    void *prev;
+    long i;
+
+    if (ts_treemap_new(&tree, bench_strcmp, NULL) != OK) {
+        exit(1);
+    }
+    for (i = 0L; i < range; i += 2L) {
+        (void)ts_treemap_put(tree, corpus->keys[i], corpus->keys[i], &prev);
+    }
+    return tree;
+}
+
+static void readTreeMap(void *instance, void *key) {
+    void *value;
+    (void)ts_treemap_get((ConcurrentTreeMap *)instance, key, &value);
+}
+
+static void writeTreeMap(void *instance, void *key, long i) {
+    void *value;
+    if ((i & 1L) == 0L) {
+        (void)ts_treemap_put((ConcurrentTreeMap *)instance, key, key, &value);
+    } else {
+        (void)ts_treemap_remove((ConcurrentTreeMap *)instance, key, &value);
+    }
+}
+
+static void destroyTreeMap(void *instance) {
+    ts_treemap_destroy((ConcurrentTreeMap *)instance, NULL);
+}
+
+// The workloads run by the harness
+static const Workload workloads[] = {
+    { "ConcurrentQueue", createQueue, readQueue, writeQueue, destroyQueue },
+    { "ConcurrentHashMap", createHashMap, readHashMap, writeHashMap, destroyHashMap },
+    { "ConcurrentTreeMap", createTreeMap, readTreeMap, writeTreeMap, destroyTreeMap },
+};
+#define NWORKLOADS 3
+
+/*
+ * Pins the thread to the core picked by `id`, wrapping around the online cores. Pinning is only
+ * supported on Linux, and is skipped elsewhere.
+ */
+static void pinThread(pthread_t thread, long id) {
+#if defined(__linux__)
+    cpu_set_t set;
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    CPU_ZERO(&set);
+    CPU_SET((int)(id % (( cores > 0L ) ? cores : 1L)), &set);
+    (void)pthread_setaffinity_np(thread, sizeof(set), &set);
+#else
+    (void)thread;
+    (void)id;
+#endif
+}
+
+/*
+ * Worker routine performing its share of the mix, with keys and operations drawn from its own
+ * xorshift generator so that the workers don't share any state besides the instance.
+ */
+static void *worker(void *arg) {
+
+    Worker *w = (Worker *)arg;
+    uint64_t x = 0x9E3779B97F4A7C15UL * (uint64_t)(w->id + 1L);
+    long i, writes = 0L;
+
+    pthread_barrier_wait(w->start);
+    w->began = bench_now();
+    for (i = 0L; i < w->ops; i++) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        void *key = w->corpus->keys[(long)((x >> 8) % (uint64_t)w->range)];
+        if ((long)(x % 100UL) < w->readPercent) {
+            BENCH_HIST_TIMED(&(w->hist), i, w->workload->read(w->instance, key));
+        } else {
+            BENCH_HIST_TIMED(&(w->hist), i, w->workload->write(w->instance, key, writes++));
+        }
+    }
+    w->ended = bench_now();
+    return NULL;
+}
+
+/*
+ * Prints the result of a run in the chosen format.
+ */
+static void report(const Options *opts, const char *adt, long readPercent, long nthreads,
+                   long ops, long elapsed, double speedup, const BenchHistogram *hist) {
+
+    double opsPerSec = ( elapsed == 0L ) ? 0.0 : ( (double)ops * 1e9 / (double)elapsed );
+    long p50 = bench_histogram_percentile(hist, 0.50);
+    long p90 = bench_histogram_percentile(hist, 0.90);
+    long p99 = bench_histogram_percentile(hist, 0.99);
+    long p999 = bench_histogram_percentile(hist, 0.999);
+
+    switch (opts->format) {
+    case FORMAT_CSV:
+        fprintf(stdout, "%s,%ld,%ld,%ld,%ld,%.0f,%.2f,%ld,%ld,%ld,%ld,%ld\n", adt, readPercent,
+                nthreads, ops, elapsed, opsPerSec, speedup, p50, p90, p99, p999, hist->max);
+        break;
+    case FORMAT_JSON:
+        fprintf(stdout, "%s\n  {\"adt\": \"%s\", \"readPercent\": %ld, \"threads\": %ld, "
+                "\"ops\": %ld, \"elapsedNs\": %ld, \"opsPerSec\": %.0f, \"speedup\": %.2f, "
+                "\"p50Ns\": %ld, \"p90Ns\": %ld, \"p99Ns\": %ld, \"p999Ns\": %ld, \"maxNs\": %ld}",
+                ( printed != 0 ) ? "," : "", adt, readPercent, nthreads, ops, elapsed, opsPerSec,
+                speedup, p50, p90, p99, p999, hist->max);
+        break;
+    default:
+        fprintf(stdout, "%-20s read%%=%-4ld threads=%-3ld ops/s=%-11.0f speedup=%-6.2f p50=%-7ld "
+                "p90=%-7ld p99=%-7ld p999=%-8ld max=%ld\n", adt, readPercent, nthreads, opsPerSec,
+                speedup, p50, p90, p99, p999, hist->max);
+        break;
+    }
+    printed = 1;
+    fflush(stdout);
+}
+
+/*
+ * Runs the workload with the read percentage across `nthreads` threads on a fresh instance,
+ * merging the workers' latencies into `hist`. Returns the elapsed time in nanoseconds, from the
+ * first worker starting to the last one finishing.
+ */
+static long run(const Options *opts, const Workload *workload, BenchCorpus *corpus,
+                long readPercent, long nthreads, BenchHistogram *hist) {
+
+    pthread_t threads[MAX_THREADS];
+    pthread_barrier_t start;
+    Worker *workers;
+    void *instance;
+    long i, began, ended;
+
+    workers = (Worker *)malloc(sizeof(Worker) * (size_t)nthreads);
+    if (workers == NULL) {
+        exit(1);
+    }
+    instance = workload->create(corpus, opts->maxSize);
+    pthread_barrier_init(&start, NULL, (unsigned)nthreads + 1U);
+    for (i = 0L; i < nthreads; i++) {
+        workers[i].workload = workload;
+        workers[i].instance = instance;
+        workers[i].corpus = corpus;
+        workers[i].start = &start;
+        workers[i].id = i;
+        workers[i].ops = opts->ops / nthreads;
+        workers[i].range = opts->maxSize;
+        workers[i].readPercent = readPercent;
+        bench_histogram_init(&(workers[i].hist));
+        pthread_create(&threads[i], NULL, worker, &workers[i]);
+        if (opts->pin != 0) {
+            pinThread(threads[i], i);
+        }
+    }
+
+    pthread_barrier_wait(&start);
+    for (i = 0L; i < nthreads; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    bench_histogram_init(hist);
+    began = workers[0].began;
+    ended = workers[0].ended;
+    for (i = 0L; i < nthreads; i++) {
+        bench_histogram_merge(hist, &(workers[i].hist));
+        began = ( workers[i].began < began ) ? workers[i].began : began;
+        ended = ( workers[i].ended > ended ) ? workers[i].ended : ended;
+    }
+    pthread_barrier_destroy(&start);
+    workload->destroy(instance);
+    free(workers);
+
+    return ended - began;
+}
+
+/*
+ * Runs the workload with the read percentage across 1 to `maxThreads` threads, doubling the count
+ * each time and finishing with `maxThreads` itself.
+ */
+static void scale(const Options *opts, const Workload *workload, BenchCorpus *corpus,
+                  long readPercent) {
+
+    BenchHistogram *hist = (BenchHistogram *)malloc(sizeof(BenchHistogram));
+    double throughput, base = 0.0;
+    long t, elapsed, ops;
+
+    if (hist == NULL) {
+        exit(1);
+    }
+    for (t = 1L; t <= opts->maxThreads; t = ( t < opts->maxThreads && t * 2L > opts->maxThreads )
+                                            ? opts->maxThreads : t * 2L) {
+        elapsed = run(opts, workload, corpus, readPercent, t, hist);
+        // The speedup compares throughputs, as the thread count may not divide the operations
+        ops = (opts->ops / t) * t;
+        throughput = ( elapsed == 0L ) ? 0.0 : ( (double)ops / (double)elapsed );
+        if (t == 1L) {
+            base = throughput;
+        }
+        report(opts, workload->adt, readPercent, t, ops, elapsed,
+               ( base == 0.0 ) ? 0.0 : ( throughput / base ), hist);
+    }
+    free(hist);
+}
+
+/*
+ * Parses the command line: the positional `[maxSize] [maxThreads]` shared with the other
+ * benchmarks, followed by the options of the harness.
+ */
+static void parseArgs(int argc, char **argv, Options *opts) {
+
+    int i, positional = 0;
+
+    for (i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-u") == 0) {
+            opts->pin = 0;
+        } else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc && opts->nmixes < MAX_MIXES) {
+            long pct = atol(argv[++i]);
+            opts->mixes[opts->nmixes++] = ( pct < 0L ) ? 0L : ( pct > 100L ) ? 100L : pct;
+        } else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            opts->ops = atol(argv[++i]);
+        } else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+            i++;
+            opts->format = ( strcmp(argv[i], "csv") == 0 ) ? FORMAT_CSV
+                         : ( strcmp(argv[i], "json") == 0 ) ? FORMAT_JSON : FORMAT_TEXT;
+        } else if (argv[i][0] != '-' && positional == 0) {
+            opts->maxSize = atol(argv[i]);
+            positional++;
+        } else if (argv[i][0] != '-' && positional == 1) {
+            opts->maxThreads = atol(argv[i]);
+            positional++;
+        } else {
+            fprintf(stderr, "Usage: %s [maxSize] [maxThreads] [-r readPercent]... [-n ops] "
+                    "[-f text|csv|json] [-u]\n", argv[0]);
+            exit(1);
+        }
+    }
+    if (opts->nmixes == 0) {
+        opts->mixes[opts->nmixes++] = 90L;
+        opts->mixes[opts->nmixes++] = 50L;
+    }
+    opts->maxThreads = ( opts->maxThreads < 1L ) ? 1L
+                     : ( opts->maxThreads > MAX_THREADS ) ? MAX_THREADS : opts->maxThreads;
+    opts->ops = ( opts->ops < 0L ) ? 0L : opts->ops;
+}
+
+int main(int argc, char **argv) {
+
+    BenchCorpus corpus;
+    Options opts = { 100000L, BENCH_MAX_THREADS, 1000000L, {0L}, 0, FORMAT_TEXT, 1 };
+    int i, m;
+
+    parseArgs(argc, argv, &opts);
+    bench_corpus_load(&corpus, BENCH_BIGFILE, 0L);
+    if (opts.maxSize < 1L || opts.maxSize > corpus.len) {
+        opts.maxSize = corpus.len;
+    }
+
+    if (opts.format == FORMAT_CSV) {
+        fprintf(stdout, "adt,readPercent,threads,ops,elapsedNs,opsPerSec,speedup,p50Ns,p90Ns,"
+                "p99Ns,p999Ns,maxNs\n");
+    } else if (opts.format == FORMAT_JSON) {
+        fprintf(stdout, "[");
+    }
+    for (i = 0; i < NWORKLOADS; i++) {
+        for (m = 0; m < opts.nmixes; m++) {
+            scale(&opts, &workloads[i], &corpus, opts.mixes[m]);
+        }
+    }
+    if (opts.format == FORMAT_JSON) {
+        fprintf(stdout, "\n]\n");
+    }
+    bench_corpus_free(&corpus);
+
+    return 0;
+}
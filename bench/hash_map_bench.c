@@ -0,0 +1,173 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2020 Cole Vikupitz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "bench_common.h"
+#include "hash_map.h"
+#include "ts_hash_map.h"
+
+/*
+ * Benchmarks the single-threaded put/get/remove paths of the empty HashMap `map` over the first
+ * `n` keys, then destroys the map.
+ */
+static void benchHashMap(const char *adt, HashMap *map, BenchCorpus *corpus, long n) {
+
+    BenchSamples lat;
+    void *prev;
+    long i, start;
+
+    bench_samples_init(&lat, n);
+    start = bench_now();
+    for (i = 0L; i < n; i++) {
+        BENCH_TIMED(&lat, i, (void)hashmap_put(map, corpus->keys[i], corpus->keys[i], &prev));
+    }
+    bench_report(adt, "put", n, 1L, n, bench_now() - start, &lat);
+
+    lat.len = 0L;
+    start = bench_now();
+    for (i = 0L; i < n; i++) {
+        BENCH_TIMED(&lat, i, (void)hashmap_get(map, corpus->keys[i], &prev));
+    }
+    bench_report(adt, "get", n, 1L, n, bench_now() - start, &lat);
+
+    lat.len = 0L;
+    start = bench_now();
+    for (i = 0L; i < n; i++) {
+        BENCH_TIMED(&lat, i, (void)hashmap_remove(map, corpus->keys[i], &prev));
+    }
+    bench_report(adt, "remove", n, 1L, n, bench_now() - start, &lat);
+
+    bench_samples_free(&lat);
+    hashmap_destroy(map, NULL);
+}
+
+// Size of the key range the concurrent workers operate over
+static long range;
+
+/*
+ * Worker routine performing a 90% get, 10% put mix on the ConcurrentHashMap.
+ */
+static void *mixedWorker(void *arg) {
+
+    BenchWorker *w = (BenchWorker *)arg;
+    ConcurrentHashMap *map = (ConcurrentHashMap *)w->instance;
+    void *prev;
+    long i, k;
+
+    for (i = 0L; i < w->ops; i++) {
+        k = ( (i * w->nthreads) + w->id ) % range;
+        if ((i % 10L) == 0L) {
+            BENCH_TIMED(&(w->lat), i, (void)ts_hashmap_put(map, w->corpus->keys[k],
+                                                           w->corpus->keys[k], &prev));
+        } else {
+            BENCH_TIMED(&(w->lat), i, (void)ts_hashmap_get(map, w->corpus->keys[k], &prev));
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Benchmarks the ConcurrentHashMap under a read-mostly mix across 1 to `maxThreads` threads.
+ */
+static void benchConcurrentHashMap(const char *adt, BenchCorpus *corpus, long n,
+                                   long maxThreads) {
+
+    ConcurrentHashMap *map;
+    BenchSamples lat;
+    void *prev;
+    long i, t, start;
+
+    if (ts_hashmap_new(&map, bench_hash, bench_strcmp, 0L, 0.0, NULL) != OK) {
+        exit(1);
+    }
+
+    bench_samples_init(&lat, n);
+    start = bench_now();
+    for (i = 0L; i < n; i++) {
+        BENCH_TIMED(&lat, i, (void)ts_hashmap_put(map, corpus->keys[i], corpus->keys[i], &prev));
+    }
+    bench_report(adt, "put", n, 1L, n, bench_now() - start, &lat);
+    bench_samples_free(&lat);
+
+    range = n;
+    for (t = 1L; t <= maxThreads; t *= 2L) {
+        (void)bench_run_threads(adt, "get90/put10", n, map, corpus, t, n, mixedWorker);
+    }
+    ts_hashmap_destroy(map, NULL);
+}
+
+// The benchmarked map sizes
+static long sizes[] = { 1000L, 10000L, 100000L, 240000L };
+#define NSIZES 4
+
+/*
+ * Runs the single-threaded benchmarks over each of the HashMap engines.
+ */
+static void benchHashMaps(const char *corpusName, BenchCorpus *corpus, long n) {
+
+    HashMap *map;
+    char adt[64];
+
+    sprintf(adt, "HashMap[%s]", corpusName);
+    if (hashmap_new(&map, bench_hash, bench_strcmp, 0L, 0.0, NULL) != OK) {
+        exit(1);
+    }
+    benchHashMap(adt, map, corpus, n);
+
+    sprintf(adt, "HashMap(fullHash)[%s]", corpusName);
+    if (hashmap_newFullHash(&map, bench_hashCode, bench_strcmp, 0L, 0.0, NULL) != OK) {
+        exit(1);
+    }
+    benchHashMap(adt, map, corpus, n);
+
+    sprintf(adt, "HashMap(flat)[%s]", corpusName);
+    if (hashmap_newFlat(&map, bench_hashCode, bench_strcmp, 0L, 0.0, NULL) != OK) {
+        exit(1);
+    }
+    benchHashMap(adt, map, corpus, n);
+}
+
+int main(int argc, char **argv) {
+
+    BenchCorpus corpus;
+    long maxSize = 240000L, maxThreads = BENCH_MAX_THREADS;
+    int i;
+
+    bench_parse_args(argc, argv, &maxSize, &maxThreads);
+
+    bench_corpus_load(&corpus, BENCH_BIGFILE, maxSize);
+    for (i = 0; i < NSIZES && sizes[i] <= corpus.len; i++) {
+        benchHashMaps("bigfile", &corpus, sizes[i]);
+        benchConcurrentHashMap("ConcurrentHashMap[bigfile]", &corpus, sizes[i], maxThreads);
+    }
+    bench_corpus_free(&corpus);
+
+    bench_corpus_load(&corpus, BENCH_BIBLE, maxSize);
+    benchHashMaps("bible", &corpus, corpus.len);
+    benchConcurrentHashMap("ConcurrentHashMap[bible]", &corpus, corpus.len, maxThreads);
+    bench_corpus_free(&corpus);
+
+    return 0;
+}
@@ -0,0 +1,160 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2020 Cole Vikupitz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include "bench_common.h"
+#include "heap.h"
+#include "ts_heap.h"
+
+/*
+ * Comparator for the heap's long elements.
+ */
+static int longCmp(void *a, void *b) {
+
+    long x = *(long *)a, y = *(long *)b;
+    return ( x < y ) ? -1 : ( x > y );
+}
+
+// Array of pseudo-random priorities inserted into the heaps
+static long *items;
+
+/*
+ * Fills the priority array with `n` pseudo-random values.
+ */
+static void generateItems(long n) {
+
+    unsigned long x = 88172645463325252UL;
+    long i;
+
+    items = (long *)malloc(n * sizeof(long));
+    if (items == NULL) {
+        exit(1);
+    }
+    for (i = 0L; i < n; i++) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        items[i] = (long)(x >> 1);
+    }
+}
+
+/*
+ * Benchmarks the single-threaded insert/poll paths of the Heap with `n` items.
+ */
+static void benchHeap(long n) {
+
+    Heap *heap;
+    BenchSamples lat;
+    void *min;
+    long i, start;
+
+    if (heap_new(&heap, 0L, longCmp) != OK) {
+        exit(1);
+    }
+
+    bench_samples_init(&lat, n);
+    start = bench_now();
+    for (i = 0L; i < n; i++) {
+        BENCH_TIMED(&lat, i, (void)heap_insert(heap, &items[i]));
+    }
+    bench_report("Heap", "insert", n, 1L, n, bench_now() - start, &lat);
+
+    lat.len = 0L;
+    start = bench_now();
+    for (i = 0L; i < n; i++) {
+        BENCH_TIMED(&lat, i, (void)heap_poll(heap, &min));
+    }
+    bench_report("Heap", "poll", n, 1L, n, bench_now() - start, &lat);
+
+    bench_samples_free(&lat);
+    heap_destroy(heap, NULL);
+}
+
+// Total number of items the concurrent workers draw from
+static long range;
+
+/*
+ * Worker routine alternating inserts and polls on the ConcurrentHeap.
+ */
+static void *mixedWorker(void *arg) {
+
+    BenchWorker *w = (BenchWorker *)arg;
+    ConcurrentHeap *heap = (ConcurrentHeap *)w->instance;
+    void *min;
+    long i;
+
+    for (i = 0L; i < w->ops; i++) {
+        if ((i & 1L) == 0L) {
+            BENCH_TIMED(&(w->lat), i, (void)ts_heap_insert(heap,
+                        &items[((i * w->nthreads) + w->id) % range]));
+        } else {
+            BENCH_TIMED(&(w->lat), i, (void)ts_heap_poll(heap, &min));
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Benchmarks the ConcurrentHeap with a half-full heap of `n` items across 1 to `maxThreads`
+ * threads.
+ */
+static void benchConcurrentHeap(long n, long maxThreads) {
+
+    ConcurrentHeap *heap;
+    long i, t;
+
+    if (ts_heap_new(&heap, 0L, longCmp) != OK) {
+        exit(1);
+    }
+    for (i = 0L; i < n / 2L; i++) {
+        (void)ts_heap_insert(heap, &items[i]);
+    }
+
+    range = n;
+    for (t = 1L; t <= maxThreads; t *= 2L) {
+        (void)bench_run_threads("ConcurrentHeap", "insert50/poll50", n, heap, NULL, t, n,
+                                mixedWorker);
+    }
+    ts_heap_destroy(heap, NULL);
+}
+
+// The benchmarked heap sizes
+static long sizes[] = { 1000L, 100000L, 1000000L };
+#define NSIZES 3
+
+int main(int argc, char **argv) {
+
+    long maxSize = 1000000L, maxThreads = BENCH_MAX_THREADS;
+    int i;
+
+    bench_parse_args(argc, argv, &maxSize, &maxThreads);
+    generateItems(maxSize);
+    for (i = 0; i < NSIZES && sizes[i] <= maxSize; i++) {
+        benchHeap(sizes[i]);
+        benchConcurrentHeap(sizes[i], maxThreads);
+    }
+    free(items);
+
+    return 0;
+}
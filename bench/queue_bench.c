@@ -0,0 +1,229 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2020 Cole Vikupitz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include "bench_common.h"
+#include "queue.h"
+#include "ts_queue.h"
+#include "lf_queue.h"
+#include "ts_bounded_queue.h"
+#include "ring_queue.h"
+
+/*
+ * Benchmarks the single-threaded add/poll paths of the Queue with `n` items.
+ */
+static void benchQueue(BenchCorpus *corpus, long n) {
+
+    Queue *queue;
+    BenchSamples lat;
+    void *first;
+    long i, start;
+
+    if (queue_new(&queue) != OK) {
+        exit(1);
+    }
+
+    bench_samples_init(&lat, n);
+    start = bench_now();
+    for (i = 0L; i < n; i++) {
+        BENCH_TIMED(&lat, i, (void)queue_add(queue, corpus->keys[i % corpus->len]));
+    }
+    bench_report("Queue", "add", n, 1L, n, bench_now() - start, &lat);
+
+    lat.len = 0L;
+    start = bench_now();
+    for (i = 0L; i < n; i++) {
+        BENCH_TIMED(&lat, i, (void)queue_poll(queue, &first));
+    }
+    bench_report("Queue", "poll", n, 1L, n, bench_now() - start, &lat);
+
+    bench_samples_free(&lat);
+    queue_destroy(queue, NULL);
+}
+
+/*
+ * Worker routine alternating adds and polls on the ConcurrentQueue.
+ */
+static void *mixedWorker(void *arg) {
+
+    BenchWorker *w = (BenchWorker *)arg;
+    ConcurrentQueue *queue = (ConcurrentQueue *)w->instance;
+    void *first;
+    long i;
+
+    for (i = 0L; i < w->ops; i++) {
+        if ((i & 1L) == 0L) {
+            BENCH_TIMED(&(w->lat), i, (void)ts_queue_add(queue,
+                        w->corpus->keys[i % w->corpus->len]));
+        } else {
+            BENCH_TIMED(&(w->lat), i, (void)ts_queue_poll(queue, &first));
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Benchmarks the ConcurrentQueue across 1 to `maxThreads` threads.
+ */
+static void benchConcurrentQueue(BenchCorpus *corpus, long n, long maxThreads) {
+
+    ConcurrentQueue *queue;
+    long t;
+
+    if (ts_queue_new(&queue) != OK) {
+        exit(1);
+    }
+    for (t = 1L; t <= maxThreads; t *= 2L) {
+        (void)bench_run_threads("ConcurrentQueue", "add50/poll50", n, queue, corpus, t, n,
+                                mixedWorker);
+    }
+    ts_queue_destroy(queue, NULL);
+}
+
+/*
+ * Worker routine alternating adds and polls on the ConcurrentBoundedQueue.
+ */
+static void *boundedWorker(void *arg) {
+
+    BenchWorker *w = (BenchWorker *)arg;
+    ConcurrentBoundedQueue *queue = (ConcurrentBoundedQueue *)w->instance;
+    void *first;
+    long i;
+
+    for (i = 0L; i < w->ops; i++) {
+        if ((i & 1L) == 0L) {
+            BENCH_TIMED(&(w->lat), i, (void)ts_boundedqueue_add(queue,
+                        w->corpus->keys[i % w->corpus->len]));
+        } else {
+            BENCH_TIMED(&(w->lat), i, (void)ts_boundedqueue_poll(queue, &first));
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Worker routine alternating adds and polls on a multi-producer/multi-consumer RingQueue.
+ */
+static void *ringWorker(void *arg) {
+
+    BenchWorker *w = (BenchWorker *)arg;
+    RingQueue *queue = (RingQueue *)w->instance;
+    void *first;
+    long i;
+
+    for (i = 0L; i < w->ops; i++) {
+        if ((i & 1L) == 0L) {
+            BENCH_TIMED(&(w->lat), i, (void)ringqueue_add(queue,
+                        w->corpus->keys[i % w->corpus->len]));
+        } else {
+            BENCH_TIMED(&(w->lat), i, (void)ringqueue_poll(queue, &first));
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Benchmarks the lock-based ConcurrentBoundedQueue against the lock-free RingQueue across 1 to
+ * `maxThreads` threads.
+ */
+static void benchRingQueue(BenchCorpus *corpus, long n, long maxThreads) {
+
+    ConcurrentBoundedQueue *bounded;
+    RingQueue *ring;
+    long t;
+
+    if (ts_boundedqueue_new(&bounded, 1024L) != OK || ringqueue_newMpmc(&ring, 1024L) != OK) {
+        exit(1);
+    }
+    for (t = 1L; t <= maxThreads; t *= 2L) {
+        (void)bench_run_threads("ConcurrentBoundedQueue", "add50/poll50", n, bounded, corpus, t,
+                                n, boundedWorker);
+        (void)bench_run_threads("RingQueue(MPMC)", "add50/poll50", n, ring, corpus, t, n,
+                                ringWorker);
+    }
+    ts_boundedqueue_destroy(bounded, NULL);
+    ringqueue_destroy(ring, NULL);
+}
+
+/*
+ * Worker routine alternating adds and polls on the LockFreeQueue.
+ */
+static void *lockFreeWorker(void *arg) {
+
+    BenchWorker *w = (BenchWorker *)arg;
+    LockFreeQueue *queue = (LockFreeQueue *)w->instance;
+    void *first;
+    long i;
+
+    for (i = 0L; i < w->ops; i++) {
+        if ((i & 1L) == 0L) {
+            BENCH_TIMED(&(w->lat), i, (void)lf_queue_add(queue,
+                        w->corpus->keys[i % w->corpus->len]));
+        } else {
+            BENCH_TIMED(&(w->lat), i, (void)lf_queue_poll(queue, &first));
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Benchmarks the LockFreeQueue across 1 to `maxThreads` threads.
+ */
+static void benchLockFreeQueue(BenchCorpus *corpus, long n, long maxThreads) {
+
+    LockFreeQueue *queue;
+    long t;
+
+    if (lf_queue_new(&queue) != OK) {
+        exit(1);
+    }
+    for (t = 1L; t <= maxThreads; t *= 2L) {
+        (void)bench_run_threads("LockFreeQueue", "add50/poll50", n, queue, corpus, t, n,
+                                lockFreeWorker);
+    }
+    lf_queue_destroy(queue, NULL);
+}
+
+// The benchmarked queue sizes
+static long sizes[] = { 1000L, 100000L, 1000000L };
+#define NSIZES 3
+
+int main(int argc, char **argv) {
+
+    BenchCorpus corpus;
+    long maxSize = 1000000L, maxThreads = BENCH_MAX_THREADS;
+    int i;
+
+    bench_parse_args(argc, argv, &maxSize, &maxThreads);
+    bench_corpus_load(&corpus, BENCH_BIBLE, 0L);
+    for (i = 0; i < NSIZES && sizes[i] <= maxSize; i++) {
+        benchQueue(&corpus, sizes[i]);
+        benchConcurrentQueue(&corpus, sizes[i], maxThreads);
+        benchLockFreeQueue(&corpus, sizes[i], maxThreads);
+        benchRingQueue(&corpus, sizes[i], maxThreads);
+    }
+    bench_corpus_free(&corpus);
+
+    return 0;
+}
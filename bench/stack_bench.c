@@ -0,0 +1,161 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2020 Cole Vikupitz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include "bench_common.h"
+#include "stack.h"
+#include "ts_stack.h"
+#include "lf_stack.h"
+
+/*
+ * Benchmarks the single-threaded push/pop paths of the Stack with `n` items.
+ */
+static void benchStack(BenchCorpus *corpus, long n) {
+
+    Stack *stack;
+    BenchSamples lat;
+    void *top;
+    long i, start;
+
+    if (stack_new(&stack) != OK) {
+        exit(1);
+    }
+
+    bench_samples_init(&lat, n);
+    start = bench_now();
+    for (i = 0L; i < n; i++) {
+        BENCH_TIMED(&lat, i, (void)stack_push(stack, corpus->keys[i % corpus->len]));
+    }
+    bench_report("Stack", "push", n, 1L, n, bench_now() - start, &lat);
+
+    lat.len = 0L;
+    start = bench_now();
+    for (i = 0L; i < n; i++) {
+        BENCH_TIMED(&lat, i, (void)stack_pop(stack, &top));
+    }
+    bench_report("Stack", "pop", n, 1L, n, bench_now() - start, &lat);
+
+    bench_samples_free(&lat);
+    stack_destroy(stack, NULL);
+}
+
+/*
+ * Worker routine alternating pushes and pops on the ConcurrentStack.
+ */
+static void *mixedWorker(void *arg) {
+
+    BenchWorker *w = (BenchWorker *)arg;
+    ConcurrentStack *stack = (ConcurrentStack *)w->instance;
+    void *top;
+    long i;
+
+    for (i = 0L; i < w->ops; i++) {
+        if ((i & 1L) == 0L) {
+            BENCH_TIMED(&(w->lat), i, (void)ts_stack_push(stack,
+                        w->corpus->keys[i % w->corpus->len]));
+        } else {
+            BENCH_TIMED(&(w->lat), i, (void)ts_stack_pop(stack, &top));
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Benchmarks the ConcurrentStack across 1 to `maxThreads` threads.
+ */
+static void benchConcurrentStack(BenchCorpus *corpus, long n, long maxThreads) {
+
+    ConcurrentStack *stack;
+    long t;
+
+    if (ts_stack_new(&stack) != OK) {
+        exit(1);
+    }
+    for (t = 1L; t <= maxThreads; t *= 2L) {
+        (void)bench_run_threads("ConcurrentStack", "push50/pop50", n, stack, corpus, t, n,
+                                mixedWorker);
+    }
+    ts_stack_destroy(stack, NULL);
+}
+
+/*
+ * Worker routine alternating pushes and pops on the LockFreeStack.
+ */
+static void *lockFreeWorker(void *arg) {
+
+    BenchWorker *w = (BenchWorker *)arg;
+    LockFreeStack *stack = (LockFreeStack *)w->instance;
+    void *top;
+    long i;
+
+    for (i = 0L; i < w->ops; i++) {
+        if ((i & 1L) == 0L) {
+            BENCH_TIMED(&(w->lat), i, (void)lf_stack_push(stack,
+                        w->corpus->keys[i % w->corpus->len]));
+        } else {
+            BENCH_TIMED(&(w->lat), i, (void)lf_stack_pop(stack, &top));
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Benchmarks the LockFreeStack across 1 to `maxThreads` threads.
+ */
+static void benchLockFreeStack(BenchCorpus *corpus, long n, long maxThreads) {
+
+    LockFreeStack *stack;
+    long t;
+
+    if (lf_stack_new(&stack) != OK) {
+        exit(1);
+    }
+    for (t = 1L; t <= maxThreads; t *= 2L) {
+        (void)bench_run_threads("LockFreeStack", "push50/pop50", n, stack, corpus, t, n,
+                                lockFreeWorker);
+    }
+    lf_stack_destroy(stack, NULL);
+}
+
+// The benchmarked stack sizes
+static long sizes[] = { 1000L, 100000L, 1000000L };
+#define NSIZES 3
+
+int main(int argc, char **argv) {
+
+    BenchCorpus corpus;
+    long maxSize = 1000000L, maxThreads = BENCH_MAX_THREADS;
+    int i;
+
+    bench_parse_args(argc, argv, &maxSize, &maxThreads);
+    bench_corpus_load(&corpus, BENCH_BIBLE, 0L);
+    for (i = 0; i < NSIZES && sizes[i] <= maxSize; i++) {
+        benchStack(&corpus, sizes[i]);
+        benchConcurrentStack(&corpus, sizes[i], maxThreads);
+        benchLockFreeStack(&corpus, sizes[i], maxThreads);
+    }
+    bench_corpus_free(&corpus);
+
+    return 0;
+}
@@ -0,0 +1,183 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2020 Cole Vikupitz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include "bench_common.h"
+#include "string_builder.h"
+#include "ts_string_builder.h"
+
+// Number of searches performed over the builder, since each one may scan the whole builder
+#define NSEARCHES 64L
+// Number of insertions performed at the middle of the builder, since each one is linear
+#define NINSERTS 1000L
+
+/*
+ * Benchmarks the single-threaded append/indexOf/insert/toString paths of the StringBuilder with
+ * the first `n` lines of the corpus.
+ */
+static void benchStringBuilder(const char *adt, BenchCorpus *corpus, long n) {
+
+    StringBuilder *sb;
+    BenchSamples lat;
+    char *str;
+    long i, start, len;
+
+    if (string_builder_new(&sb, 0L, 0.0f, NULL) != OK) {
+        exit(1);
+    }
+
+    bench_samples_init(&lat, n);
+    start = bench_now();
+    for (i = 0L; i < n; i++) {
+        BENCH_TIMED(&lat, i, (void)string_builder_appendStr(sb, corpus->keys[i]));
+    }
+    bench_report(adt, "appendStr", n, 1L, n, bench_now() - start, &lat);
+
+    lat.len = 0L;
+    start = bench_now();
+    for (i = 0L; i < n; i++) {
+        BENCH_TIMED(&lat, i, (void)string_builder_appendLong(sb, i * 7919L));
+    }
+    bench_report(adt, "appendLong", n, 1L, n, bench_now() - start, &lat);
+
+    // Searches for keys spread evenly over the builder, all latencies are sampled
+    lat.len = 0L;
+    start = bench_now();
+    for (i = 0L; i < NSEARCHES; i++) {
+        BENCH_TIMED(&lat, 0L, (void)string_builder_indexOf(sb,
+                    corpus->keys[(i * n) / NSEARCHES]));
+    }
+    bench_report(adt, "indexOf", n, 1L, NSEARCHES, bench_now() - start, &lat);
+
+    lat.len = 0L;
+    len = string_builder_length(sb);
+    start = bench_now();
+    for (i = 0L; i < NINSERTS; i++) {
+        BENCH_TIMED(&lat, i, (void)string_builder_insertStr(sb, len / 2L,
+                    corpus->keys[i % n]));
+    }
+    bench_report(adt, "insertStr(mid)", n, 1L, NINSERTS, bench_now() - start, &lat);
+
+    lat.len = 0L;
+    start = bench_now();
+    BENCH_TIMED(&lat, 0L, if (string_builder_toString(sb, &str) == OK) { free(str); });
+    bench_report(adt, "toString", n, 1L, 1L, bench_now() - start, &lat);
+
+    bench_samples_free(&lat);
+    string_builder_destroy(sb);
+}
+
+/*
+ * Worker routine appending lines of the corpus into the ConcurrentStringBuilder.
+ */
+static void *appendWorker(void *arg) {
+
+    BenchWorker *w = (BenchWorker *)arg;
+    ConcurrentStringBuilder *sb = (ConcurrentStringBuilder *)w->instance;
+    long i;
+
+    for (i = 0L; i < w->ops; i++) {
+        BENCH_TIMED(&(w->lat), i, (void)ts_string_builder_appendStr(sb,
+                    w->corpus->keys[((i * w->nthreads) + w->id) % w->corpus->len]));
+    }
+    return NULL;
+}
+
+/*
+ * Benchmarks concurrent appends into a ConcurrentStringBuilder across 1 to `maxThreads` threads.
+ */
+static void benchConcurrentStringBuilder(const char *adt, BenchCorpus *corpus, long n,
+                                         long maxThreads) {
+
+    ConcurrentStringBuilder *sb;
+    long t;
+
+    for (t = 1L; t <= maxThreads; t *= 2L) {
+        if (ts_string_builder_new(&sb, 0L, 0.0f, NULL) != OK) {
+            exit(1);
+        }
+        (void)bench_run_threads(adt, "appendStr", n, sb, corpus, t, n, appendWorker);
+        ts_string_builder_destroy(sb);
+    }
+}
+
+/*
+ * Benchmarks loading the whole file at `path` into a builder, read with string_builder_appendFile()
+ * and mapped with string_builder_newMapped(), then scanning it once for a missing string.
+ */
+static void benchLoadFile(const char *adt, const char *path) {
+
+    StringBuilder *sb;
+    BenchSamples lat;
+    long start;
+
+    bench_samples_init(&lat, 1L);
+    if (string_builder_new(&sb, 0L, 0.0f, NULL) != OK) {
+        exit(1);
+    }
+    start = bench_now();
+    BENCH_TIMED(&lat, 0L, (void)string_builder_appendFile(sb, path));
+    bench_report(adt, "appendFile", 1L, 1L, 1L, bench_now() - start, &lat);
+    string_builder_destroy(sb);
+
+    lat.len = 0L;
+    start = bench_now();
+    BENCH_TIMED(&lat, 0L, if (string_builder_newMapped(&sb, path) == OK) {
+        (void)string_builder_indexOf(sb, "\x01");
+        string_builder_destroy(sb);
+    });
+    bench_report(adt, "newMapped+indexOf", 1L, 1L, 1L, bench_now() - start, &lat);
+    bench_samples_free(&lat);
+}
+
+// The benchmarked number of lines
+static long sizes[] = { 1000L, 10000L, 100000L };
+#define NSIZES 3
+
+int main(int argc, char **argv) {
+
+    BenchCorpus corpus;
+    long maxSize = 100000L, maxThreads = BENCH_MAX_THREADS;
+    int i;
+
+    bench_parse_args(argc, argv, &maxSize, &maxThreads);
+
+    bench_corpus_load(&corpus, BENCH_BIGFILE, maxSize);
+    for (i = 0; i < NSIZES && sizes[i] <= corpus.len; i++) {
+        benchStringBuilder("StringBuilder[bigfile]", &corpus, sizes[i]);
+        benchConcurrentStringBuilder("ConcurrentStringBuilder[bigfile]", &corpus, sizes[i],
+                                     maxThreads);
+    }
+    bench_corpus_free(&corpus);
+
+    benchLoadFile("StringBuilder[bigfile]", BENCH_BIGFILE);
+
+    bench_corpus_load(&corpus, BENCH_BIBLE, maxSize);
+    benchStringBuilder("StringBuilder[bible]", &corpus, corpus.len);
+    benchConcurrentStringBuilder("ConcurrentStringBuilder[bible]", &corpus, corpus.len,
+                                 maxThreads);
+    bench_corpus_free(&corpus);
+
+    return 0;
+}
@@ -0,0 +1,158 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2020 Cole Vikupitz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include "bench_common.h"
+#include "tree_map.h"
+#include "ts_tree_map.h"
+
+/*
+ * Benchmarks the single-threaded put/get/ceiling/pollFirst paths of the TreeMap over the first
+ * `n` keys.
+ */
+static void benchTreeMap(const char *adt, BenchCorpus *corpus, long n) {
+
+    TreeMap *tree;
+    TmEntry *entry;
+    BenchSamples lat;
+    void *prev, *key;
+    long i, start;
+
+    if (treemap_new(&tree, bench_strcmp, NULL) != OK) {
+        exit(1);
+    }
+
+    bench_samples_init(&lat, n);
+    start = bench_now();
+    for (i = 0L; i < n; i++) {
+        BENCH_TIMED(&lat, i, (void)treemap_put(tree, corpus->keys[i], corpus->keys[i], &prev));
+    }
+    bench_report(adt, "put", n, 1L, n, bench_now() - start, &lat);
+
+    lat.len = 0L;
+    start = bench_now();
+    for (i = 0L; i < n; i++) {
+        BENCH_TIMED(&lat, i, (void)treemap_get(tree, corpus->keys[i], &prev));
+    }
+    bench_report(adt, "get", n, 1L, n, bench_now() - start, &lat);
+
+    lat.len = 0L;
+    start = bench_now();
+    for (i = 0L; i < n; i++) {
+        BENCH_TIMED(&lat, i, (void)treemap_ceiling(tree, corpus->keys[i], &entry));
+    }
+    bench_report(adt, "ceiling", n, 1L, n, bench_now() - start, &lat);
+
+    lat.len = 0L;
+    start = bench_now();
+    for (i = 0L; i < n; i++) {
+        BENCH_TIMED(&lat, i, (void)treemap_pollFirst(tree, &key, &prev));
+    }
+    bench_report(adt, "pollFirst", n, 1L, n, bench_now() - start, &lat);
+
+    bench_samples_free(&lat);
+    treemap_destroy(tree, NULL);
+}
+
+// Size of the key range the concurrent workers operate over
+static long range;
+
+/*
+ * Worker routine performing a 90% get, 10% put mix on the ConcurrentTreeMap.
+ */
+static void *mixedWorker(void *arg) {
+
+    BenchWorker *w = (BenchWorker *)arg;
+    ConcurrentTreeMap *tree = (ConcurrentTreeMap *)w->instance;
+    void *prev;
+    long i, k;
+
+    for (i = 0L; i < w->ops; i++) {
+        k = ( (i * w->nthreads) + w->id ) % range;
+        if ((i % 10L) == 0L) {
+            BENCH_TIMED(&(w->lat), i, (void)ts_treemap_put(tree, w->corpus->keys[k],
+                                                           w->corpus->keys[k], &prev));
+        } else {
+            BENCH_TIMED(&(w->lat), i, (void)ts_treemap_get(tree, w->corpus->keys[k], &prev));
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Benchmarks the ConcurrentTreeMap under a read-mostly mix across 1 to `maxThreads` threads.
+ */
+static void benchConcurrentTreeMap(const char *adt, BenchCorpus *corpus, long n,
+                                   long maxThreads) {
+
+    ConcurrentTreeMap *tree;
+    BenchSamples lat;
+    void *prev;
+    long i, t, start;
+
+    if (ts_treemap_new(&tree, bench_strcmp, NULL) != OK) {
+        exit(1);
+    }
+
+    bench_samples_init(&lat, n);
+    start = bench_now();
+    for (i = 0L; i < n; i++) {
+        BENCH_TIMED(&lat, i, (void)ts_treemap_put(tree, corpus->keys[i], corpus->keys[i], &prev));
+    }
+    bench_report(adt, "put", n, 1L, n, bench_now() - start, &lat);
+    bench_samples_free(&lat);
+
+    range = n;
+    for (t = 1L; t <= maxThreads; t *= 2L) {
+        (void)bench_run_threads(adt, "get90/put10", n, tree, corpus, t, n, mixedWorker);
+    }
+    ts_treemap_destroy(tree, NULL);
+}
+
+// The benchmarked map sizes
+static long sizes[] = { 1000L, 10000L, 100000L, 240000L };
+#define NSIZES 4
+
+int main(int argc, char **argv) {
+
+    BenchCorpus corpus;
+    long maxSize = 240000L, maxThreads = BENCH_MAX_THREADS;
+    int i;
+
+    bench_parse_args(argc, argv, &maxSize, &maxThreads);
+
+    bench_corpus_load(&corpus, BENCH_BIGFILE, maxSize);
+    for (i = 0; i < NSIZES && sizes[i] <= corpus.len; i++) {
+        benchTreeMap("TreeMap[bigfile]", &corpus, sizes[i]);
+        benchConcurrentTreeMap("ConcurrentTreeMap[bigfile]", &corpus, sizes[i], maxThreads);
+    }
+    bench_corpus_free(&corpus);
+
+    bench_corpus_load(&corpus, BENCH_BIBLE, maxSize);
+    benchTreeMap("TreeMap[bible]", &corpus, corpus.len);
+    benchConcurrentTreeMap("ConcurrentTreeMap[bible]", &corpus, corpus.len, maxThreads);
+    bench_corpus_free(&corpus);
+
+    return 0;
+}
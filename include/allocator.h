@@ -0,0 +1,175 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2020 Cole Vikupitz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef _CDS_ALLOCATOR_H__
+#define _CDS_ALLOCATOR_H__
+
+#include <stddef.h>
+
+/**
+ * Interface for the pluggable allocators of the ADTs.
+ *
+ * Every ADT can be created with an allocator (see the *_newWithAllocator() functions), through
+ * which it then allocates and frees its struct, its buffers, its nodes and its entries. Routing a
+ * structure to an arena, a NUMA-local heap or a per-request bump allocator only takes wrapping the
+ * allocator's functions in a CdsAllocator; structures created without one use malloc(), realloc()
+ * and free().
+ *
+ * Memory handed over to the caller, such as the Array returned by the toArray() methods and the
+ * items of iterators, is always allocated with malloc(), so it may still be released with free()
+ * or FREE_ARRAY() whatever allocator the structure was created with.
+ *
+ * Besides the default allocator, allocator_largePages() provides one for structures with very large
+ * flat arrays, such as the data of an ArrayList, Heap or BoundedQueue, or the buckets of a HashMap.
+ */
+typedef struct {
+    void *(*alloc)(size_t size, void *context);                 // Allocates `size` bytes
+    void *(*realloc)(void *ptr, size_t size, void *context);    // Resizes a block to `size` bytes
+    void (*free)(void *ptr, void *context);                     // Frees a block, if not NULL
+    void *context;                                              // Passed along to each function
+} CdsAllocator;
+
+/**
+ * Counters of the calls made through the allocators of every ADT, filled in by allocator_stats().
+ * They cost an atomic increment per call, and are only maintained when the library is compiled
+ * with CDS_ALLOC_STATS defined; otherwise they remain 0.
+ */
+typedef struct {
+    long allocs;            // Number of blocks allocated
+    long reallocs;          // Number of blocks resized
+    long frees;             // Number of blocks freed
+    long bytes;             // Total number of bytes requested by allocations and resizes
+} AllocStats;
+
+/**
+ * Returns the default allocator, which calls malloc(), realloc() and free().
+ *
+ * Params:
+ *    None
+ * Returns:
+ *    The default allocator.
+ */
+const CdsAllocator *allocator_default(void);
+
+// Flag for allocator_largePages(): locks the large blocks into memory with mlock()
+#define LARGE_PAGES_LOCKED  0x1
+// Flag for allocator_largePages(): backs the large blocks with explicit huge pages (MAP_HUGETLB)
+#define LARGE_PAGES_HUGETLB 0x2
+
+/**
+ * Returns an allocator backing large blocks with their own memory mappings, for structures whose
+ * flat arrays hold hundreds of millions of slots, where TLB misses dominate random accesses. Blocks
+ * of 2MB or more are mapped with mmap() and the kernel is asked to back them with transparent huge
+ * pages (with madvise()), so a single TLB entry covers 2MB instead of 4KB. Growing such a block
+ * remaps it with mremap(), which moves the pages over rather than copying them. Smaller blocks,
+ * such as the structures themselves and their nodes, are still allocated with malloc().
+ *
+ * With LARGE_PAGES_HUGETLB, large blocks are first mapped from the explicit huge page pool (see
+ * /proc/sys/vm/nr_hugepages), falling back to transparent huge pages if the pool has too few free
+ * pages. With LARGE_PAGES_LOCKED, large blocks are locked into memory with mlock() so they are
+ * never paged out, for latency critical deployments; allocating or growing a block that cannot be
+ * locked (see RLIMIT_MEMLOCK) then fails. On platforms without mremap() or huge pages, large blocks
+ * are copied to grow them, or backed by ordinary pages.
+ *
+ * Params:
+ *    flags - LARGE_PAGES_LOCKED and LARGE_PAGES_HUGETLB, or'ed together, or 0 for neither.
+ * Returns:
+ *    The large page allocator.
+ */
+const CdsAllocator *allocator_largePages(int flags);
+
+/**
+ * Allocates `size` bytes through `allocator`.
+ *
+ * Params:
+ *    allocator - The allocator to use.
+ *    size - The number of bytes to allocate.
+ * Returns:
+ *    The new block, or NULL if memory could not be allocated.
+ */
+void *allocator_alloc(const CdsAllocator *allocator, size_t size);
+
+/**
+ * Resizes the block `ptr`, previously allocated through `allocator`, to `size` bytes.
+ *
+ * Params:
+ *    allocator - The allocator to use.
+ *    ptr - The block to resize, or NULL to allocate a new one.
+ *    size - The new size of the block, in bytes.
+ * Returns:
+ *    The resized block, or NULL if memory could not be allocated (`ptr` is then left intact).
+ */
+void *allocator_realloc(const CdsAllocator *allocator, void *ptr, size_t size);
+
+/**
+ * Resizes the block `ptr`, previously allocated through `allocator`, to hold an array of `n`
+ * members of `size` bytes each, failing rather than overflowing if the array is too large. If `ptr`
+ * is NULL, a new block is allocated instead.
+ *
+ * Params:
+ *    allocator - The allocator to use.
+ *    ptr - The block to resize, or NULL to allocate a new one.
+ *    n - The number of members in the array.
+ *    size - The size of each member, in bytes.
+ * Returns:
+ *    The resized block, or NULL if the array is too large or memory could not be allocated (`ptr`
+ *    is then left intact).
+ */
+void *allocator_reallocArray(const CdsAllocator *allocator, void *ptr, size_t n, size_t size);
+
+/**
+ * Frees the block `ptr`, previously allocated through `allocator`. Nothing is done if `ptr` is
+ * NULL.
+ *
+ * Params:
+ *    allocator - The allocator to use.
+ *    ptr - The block to free.
+ * Returns:
+ *    None
+ */
+void allocator_free(const CdsAllocator *allocator, void *ptr);
+
+/**
+ * Stores the counters of the calls made through every allocator since the start of the process
+ * (or the last call to allocator_resetStats()) into `*stats`.
+ *
+ * Params:
+ *    stats - The AllocStats to fill in.
+ * Returns:
+ *    None
+ */
+void allocator_stats(AllocStats *stats);
+
+/**
+ * Resets the counters reported by allocator_stats() to 0.
+ *
+ * Params:
+ *    None
+ * Returns:
+ *    None
+ */
+void allocator_resetStats(void);
+
+#endif  /* _CDS_ALLOCATOR_H__ */
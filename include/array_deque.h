@@ -0,0 +1,363 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2020 Cole Vikupitz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _CDS_ARRAYDEQUE_H__
+#define _CDS_ARRAYDEQUE_H__
+
+#include "allocator.h"
+#include "cds_common.h"
+#include "cursor.h"
+#include "iterator.h"
+
+/**
+ * Interface for the ArrayDeque ADT.
+ *
+ * The ArrayDeque class is a double ended queue of elements stored in a resizable circular array.
+ * Elements may be added or removed at either end in constant time, and, unlike the LinkedList,
+ * any element may also be fetched or replaced by its index in constant time. Inserting or removing
+ * in the middle only shifts the elements on the shorter side of the index.
+ *
+ * Modeled after the Java 7 ArrayDeque interface, with the indexed methods of the List interface.
+ */
+typedef struct arraydeque ArrayDeque;
+
+/**
+ * Constructs a new array deque instance with the specified starting capacity, then stores the new
+ * instance into `*deque`. The capacity is rounded up to the next power of two; if the capacity
+ * given is <= 0, a default capacity is assigned.
+ *
+ * Params:
+ *    deque - The pointer address to store the new ArrayDeque instance.
+ *    capacity - The default capacity of the deque.
+ * Returns:
+ *    OK - ArrayDeque was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status arraydeque_new(ArrayDeque **deque, long capacity);
+
+/**
+ * Creates a new deque instance whose struct and array are allocated through `allocator`, then
+ * stores the new instance into `*deque`.
+ *
+ * Params:
+ *    deque - The pointer address to store the new ArrayDeque instance.
+ *    capacity - The default capacity of the deque.
+ *    allocator - The allocator to use, which must outlive the deque. If NULL, the default
+ *                allocator will be used.
+ * Returns:
+ *    OK - ArrayDeque was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the allocator.
+ */
+Status arraydeque_newWithAllocator(ArrayDeque **deque, long capacity,
+                                   const CdsAllocator *allocator);
+
+/**
+ * Inserts the specified element at the front of the deque.
+ *
+ * Params:
+ *    deque - The deque to operate on.
+ *    item - The element to insert.
+ * Returns:
+ *    OK - Operation was successful.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status arraydeque_addFirst(ArrayDeque *deque, void *item);
+
+/**
+ * Inserts the specified element at the end of the deque.
+ *
+ * Params:
+ *    deque - The deque to operate on.
+ *    item - The element to insert.
+ * Returns:
+ *    OK - Operation was successful.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status arraydeque_addLast(ArrayDeque *deque, void *item);
+
+/**
+ * Inserts the specified element at the specified position in the deque. Elements on the shorter
+ * side of `i` are shifted by one position to make room.
+ *
+ * Params:
+ *    deque - The deque to operate on.
+ *    i - The index at which the specified element is to be inserted.
+ *    item - The element to be inserted.
+ * Returns:
+ *    OK - Operation was successful.
+ *    INVALID_INDEX - Index given is invalid:
+ *       1.) `i` < 0
+ *       2.) `i` > size
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status arraydeque_insert(ArrayDeque *deque, long i, void *item);
+
+/**
+ * Retrieves, but does not remove, the first element of the deque.
+ *
+ * Params:
+ *    deque - The deque to operate on.
+ *    first - The pointer address to store the retrieved element into.
+ * Returns:
+ *    OK - Operation was successful.
+ *    STRUCT_EMPTY - Deque is currently empty.
+ */
+Status arraydeque_first(ArrayDeque *deque, void **first);
+
+/**
+ * Retrieves, but does not remove, the last element of the deque.
+ *
+ * Params:
+ *    deque - The deque to operate on.
+ *    last - The pointer address to store the retrieved element into.
+ * Returns:
+ *    OK - Operation was successful.
+ *    STRUCT_EMPTY - Deque is currently empty.
+ */
+Status arraydeque_last(ArrayDeque *deque, void **last);
+
+/**
+ * Returns the element at the specified position in the deque.
+ *
+ * Params:
+ *    deque - The deque to operate on.
+ *    i - The index of the element to retrieve.
+ *    item - The pointer address to store the retrieved element into.
+ * Returns:
+ *    OK - Operation was successful.
+ *    STRUCT_EMPTY - Deque is currently empty.
+ *    INVALID_INDEX - Index given is invalid:
+ *       1.) `i` < 0
+ *       2.) `i` >= size
+ */
+Status arraydeque_get(ArrayDeque *deque, long i, void **item);
+
+/**
+ * Replaces the element at the specified position in the deque with the specified element.
+ *
+ * Params:
+ *    deque - The deque to operate on.
+ *    i - The index of the element to replace.
+ *    item - The element to be stored at the specified position.
+ *    previous - The pointer address to store the element previously at the specified
+ *               position.
+ * Returns:
+ *    OK - Operation was successful.
+ *    STRUCT_EMPTY - Deque is currently empty.
+ *    INVALID_INDEX - Index given is invalid:
+ *       1.) `i` < 0
+ *       2.) `i` >= size
+ */
+Status arraydeque_set(ArrayDeque *deque, long i, void *item, void **previous);
+
+/**
+ * Retrieves and removes the first element of the deque.
+ *
+ * Params:
+ *    deque - The deque to operate on.
+ *    first - The pointer address to store the removed element into.
+ * Returns:
+ *    OK - Operation was successful.
+ *    STRUCT_EMPTY - Deque is currently empty.
+ */
+Status arraydeque_removeFirst(ArrayDeque *deque, void **first);
+
+/**
+ * Retrieves and removes the last element of the deque.
+ *
+ * Params:
+ *    deque - The deque to operate on.
+ *    last - The pointer address to store the removed element into.
+ * Returns:
+ *    OK - Operation was successful.
+ *    STRUCT_EMPTY - Deque is currently empty.
+ */
+Status arraydeque_removeLast(ArrayDeque *deque, void **last);
+
+/**
+ * Removes the element at the specified position in the deque. Elements on the shorter side of `i`
+ * are shifted by one position to fill the gap.
+ *
+ * Params:
+ *    deque - The deque to operate on.
+ *    i - The index of the element to be removed.
+ *    item - The pointer address to store the element that was removed from the deque.
+ * Returns:
+ *    OK - Operation was successful.
+ *    STRUCT_EMPTY - Deque is currently empty.
+ *    INVALID_INDEX - Index given is invalid:
+ *       1.) `i` < 0
+ *       2.) `i` >= size
+ */
+Status arraydeque_remove(ArrayDeque *deque, long i, void **item);
+
+/**
+ * Increases the capacity of the deque, if necessary, to ensure that it can hold at least the
+ * number of elements specified by the minimum capacity argument.
+ *
+ * Params:
+ *    deque - The deque to operate on.
+ *    capacity - The desired minimum capacity.
+ * Returns:
+ *    OK - Operation was successful.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status arraydeque_ensureCapacity(ArrayDeque *deque, long capacity);
+
+/**
+ * Removes all elements from the deque. If `destructor` is not NULL, it will be invoked on each
+ * element in the deque after being removed.
+ *
+ * Params:
+ *    deque - The deque to operate on.
+ *    destructor - Function to operate on each element after removal.
+ * Returns:
+ *    None
+ */
+void arraydeque_clear(ArrayDeque *deque, void (*destructor)(void *));
+
+/**
+ * Returns the number of elements in the deque.
+ *
+ * Params:
+ *    deque - The deque to operate on.
+ * Returns:
+ *    The deque's current size.
+ */
+long arraydeque_size(ArrayDeque *deque);
+
+/**
+ * Returns the deque's current capacity, that is, the maximum number of elements it can hold
+ * before resizing is required.
+ *
+ * Params:
+ *    deque - The deque to operate on.
+ * Returns:
+ *    The deque's current capacity.
+ */
+long arraydeque_capacity(ArrayDeque *deque);
+
+/**
+ * Returns TRUE if the deque contains no elements, FALSE if otherwise.
+ *
+ * Params:
+ *    deque - The deque to operate on.
+ * Returns:
+ *    TRUE if the deque is empty, FALSE if not.
+ */
+Boolean arraydeque_isEmpty(ArrayDeque *deque);
+
+/**
+ * Allocates and generates an array containing all of the deque's elements in proper sequence
+ * (from first to last element), then stores the array into `*array`. Caller is responsible for
+ * freeing the array when finished.
+ *
+ * Params:
+ *    deque - The deque to operate on.
+ *    array - Address where the new array will be stored.
+ * Returns:
+ *    OK - Operation was successful.
+ *    STRUCT_EMPTY - Deque is currently empty.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status arraydeque_toArray(ArrayDeque *deque, Array **array);
+
+/**
+ * Creates an Iterator instance to iterate over the deque's elements in proper sequence (from first
+ * to last element), then stores the iterator into `*iter`. Caller is responsible for destroying
+ * the iterator instance when finished.
+ *
+ * Params:
+ *    deque - The deque to operate on.
+ *    iter - Address where the new iterator will be stored.
+ * Returns:
+ *    OK - Operation was successful.
+ *    STRUCT_EMPTY - Deque is currently empty.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status arraydeque_iterator(ArrayDeque *deque, Iterator **iter);
+
+/**
+ * Initializes `cursor` to walk over the deque's elements from first to last, without copying
+ * them. The elements are then fetched with arraydeque_cursorNext(); see cursor.h for details.
+ *
+ * Params:
+ *    deque - The deque to operate on.
+ *    cursor - The cursor to initialize.
+ * Returns:
+ *    None
+ */
+void arraydeque_cursor(ArrayDeque *deque, Cursor *cursor);
+
+/**
+ * Advances the cursor to the next element of the deque, and stores it into `*next`.
+ *
+ * Params:
+ *    cursor - The cursor to operate on.
+ *    next - The pointer address to store the next element into.
+ * Returns:
+ *    OK - Next element was returned.
+ *    ITER_END - The cursor has already visited every element.
+ *    CONCURRENT_MODIFICATION - The deque was modified after creating the cursor.
+ */
+Status arraydeque_cursorNext(Cursor *cursor, void **next);
+
+/**
+ * Applies `action` to each element of the deque from first to last, passing it the element and
+ * `context`. The walk stops as soon as `action` returns FALSE. Nothing is copied or allocated, and
+ * `action` must not modify the deque while it is walked.
+ *
+ * Params:
+ *    deque - The deque to operate on.
+ *    action - Function applied to each element, returning FALSE to stop the walk.
+ *    context - Argument passed along to each call of `action`, may be NULL.
+ * Returns:
+ *    TRUE if `action` was applied to every element, FALSE if it stopped the walk early.
+ */
+Boolean arraydeque_forEach(ArrayDeque *deque, Boolean (*action)(void *, void *), void *context);
+
+/**
+ * Returns the number of bytes of memory held by the deque: the deque itself and its ring buffer,
+ * not counting the elements themselves.
+ *
+ * Params:
+ *    deque - The deque to operate on.
+ * Returns:
+ *    The deque's memory usage, in bytes.
+ */
+long arraydeque_memoryUsage(ArrayDeque *deque);
+
+/**
+ * Destroys the deque instance by freeing all of its reserved memory. If `destructor` is not NULL,
+ * it will be invoked on each element before the deque is destroyed.
+ *
+ * Params:
+ *    deque - The deque to destroy.
+ *    destructor - Function to operate on each element prior to deque destruction.
+ * Returns:
+ *    None
+ */
+void arraydeque_destroy(ArrayDeque *deque, void (*destructor)(void *));
+
+#endif  /* _CDS_ARRAYDEQUE_H__ */
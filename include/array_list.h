@@ -25,7 +25,9 @@
 #ifndef _CDS_ARRAYLIST_H__
 #define _CDS_ARRAYLIST_H__
 
+#include "allocator.h"
 #include "cds_common.h"
+#include "cursor.h"
 #include "iterator.h"
 
 /**
@@ -37,6 +39,16 @@
  */
 typedef struct arraylist ArrayList;
 
+/**
+ * Interface for the FrozenArray ADT.
+ *
+ * A FrozenArray is a read-only snapshot of an array list's elements, sorted and laid out in
+ * Eytzinger (breadth-first search tree) order, so that lookups walk down the array's first cache
+ * lines instead of jumping across the whole of it. Being read-only, it may be shared between any
+ * number of threads without locking.
+ */
+typedef struct frozen_array FrozenArray;
+
 /**
  * Constructs a new array list instance with the specified starting capacity, then stores the new
  * instance into `*list`. If the capacity given is <= 0, a default capacity is assigned.
@@ -50,6 +62,22 @@ typedef struct arraylist ArrayList;
  */
 Status arraylist_new(ArrayList **list, long capacity);
 
+/**
+ * Creates a new arraylist instance whose struct and array are allocated through `allocator`, then
+ * stores the new instance into `*list`.
+ *
+ * Params:
+ *    list - The pointer address to store the new ArrayList instance.
+ *    capacity - The default capacity of the arraylist.
+ *    allocator - The allocator to use, which must outlive the arraylist. If NULL, the default
+ *                allocator will be used.
+ * Returns:
+ *    OK - ArrayList was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the allocator.
+ */
+Status arraylist_newWithAllocator(ArrayList **list, long capacity,
+                                  const CdsAllocator *allocator);
+
 /**
  * Appends the specified element to the end of the array list.
  *
@@ -80,6 +108,41 @@ Status arraylist_add(ArrayList *list, void *item);
  */
 Status arraylist_insert(ArrayList *list, long i, void *item);
 
+/**
+ * Appends the `n` elements in the array `items` to the end of the array list, in order. The
+ * list's capacity is checked and extended at most once for the whole batch.
+ *
+ * Params:
+ *    list - The array list to operate on.
+ *    items - The array of elements to be appended.
+ *    n - The number of elements in `items`.
+ * Returns:
+ *    OK - Operation was successful.
+ *    INVALID_INDEX - `n` is negative.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status arraylist_addAll(ArrayList *list, void **items, long n);
+
+/**
+ * Inserts the `n` elements in the array `items` into the array list, in order, starting at the
+ * specified position. Shifts the element currently at that position (if any) and any subsequent
+ * elements to the right (adds `n` to their indices), moving them only once.
+ *
+ * Params:
+ *    list - The array list to operate on.
+ *    i - The index at which the first element is to be inserted.
+ *    items - The array of elements to be inserted.
+ *    n - The number of elements in `items`.
+ * Returns:
+ *    OK - Operation was successful.
+ *    INVALID_INDEX - Index or count given is invalid:
+ *       1.) `i` < 0
+ *       2.) `i` > size
+ *       3.) `n` < 0
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status arraylist_insertAll(ArrayList *list, long i, void **items, long n);
+
 /**
  * Returns the element at the specified position in the array list.
  *
@@ -131,6 +194,172 @@ Status arraylist_set(ArrayList *list, long i, void *item, void **previous);
  */
 Status arraylist_remove(ArrayList *list, long i, void **item);
 
+/**
+ * Removes the elements from index `from`, inclusive, to index `to`, exclusive, from the array list.
+ * Shifts any subsequent elements to the left (subtracts `to - from` from their indices), moving
+ * them only once. If `destructor` is not NULL, it will be invoked on each element after removal.
+ *
+ * Params:
+ *    list - The array list to operate on.
+ *    from - The index of the first element to be removed.
+ *    to - The index after the last element to be removed.
+ *    destructor - Function to operate on each element after removal.
+ * Returns:
+ *    OK - Operation was successful.
+ *    STRUCT_EMPTY - Array list is currently empty.
+ *    INVALID_INDEX - Range given is invalid:
+ *       1.) `from` < 0
+ *       2.) `to` > size
+ *       3.) `from` > `to`
+ */
+Status arraylist_removeRange(ArrayList *list, long from, long to, void (*destructor)(void *));
+
+/**
+ * Removes every element of the array list for which `predicate` returns TRUE, keeping the order of
+ * the remaining elements. The list is compacted in a single pass, moving each run of remaining
+ * elements at once. If `destructor` is not NULL, it will be invoked on each element after removal.
+ *
+ * Params:
+ *    list - The array list to operate on.
+ *    predicate - Function returning TRUE for the elements to remove.
+ *    destructor - Function to operate on each element after removal.
+ * Returns:
+ *    The number of elements removed.
+ */
+long arraylist_removeIf(ArrayList *list, Boolean (*predicate)(void *),
+                        void (*destructor)(void *));
+
+/**
+ * Sorts the elements of the array list in place into ascending order, as defined by `comparator`.
+ * The list is sorted with an introsort: a quicksort that switches over to a heap sort if its
+ * partitions keep coming out lopsided, so its worst case stays at O(n log n), and that leaves
+ * short runs to an insertion sort. The sort is not stable; use arraylist_stableSort() for that.
+ *
+ * The comparator takes two elements `a` and `b`, and must return 0 when a == b, <0 when a < b,
+ * and >0 when a > b.
+ *
+ * Params:
+ *    list - The array list to operate on.
+ *    comparator - Function comparing two elements.
+ * Returns:
+ *    OK - Operation was successful.
+ */
+Status arraylist_sort(ArrayList *list, int (*comparator)(void *, void *));
+
+/**
+ * Sorts the elements of the array list into ascending order, as defined by `comparator`, keeping
+ * equal elements in the order they appeared in. The list is merge sorted through a temporary
+ * buffer as large as the list, and runs that are already in order are not merged again, so a
+ * sorted or nearly sorted list is handled in close to linear time.
+ *
+ * Params:
+ *    list - The array list to operate on.
+ *    comparator - Function comparing two elements.
+ * Returns:
+ *    OK - Operation was successful.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap; the list is unchanged.
+ */
+Status arraylist_stableSort(ArrayList *list, int (*comparator)(void *, void *));
+
+/**
+ * Sorts the elements of the array list into ascending order, as defined by `comparator`, using up
+ * to `nthreads` threads (64 at most). The list is split into one run per thread, each sorted as
+ * with arraylist_sort(), after which the runs are merged pairwise, also in parallel, through a
+ * temporary buffer as large as the list. Each thread is given at least 16K elements, so a smaller
+ * list, or an `nthreads` <= 1, is simply sorted on the calling thread. The sort is not stable, and
+ * `comparator` must be safe to call from several threads at once.
+ *
+ * Params:
+ *    list - The array list to operate on.
+ *    comparator - Function comparing two elements.
+ *    nthreads - The most threads to sort with, including the calling thread.
+ * Returns:
+ *    OK - Operation was successful.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap; the list is unchanged.
+ */
+Status arraylist_parallelSort(ArrayList *list, int (*comparator)(void *, void *), int nthreads);
+
+/**
+ * Returns the index of the first element of the sorted array list that does not compare less than
+ * `key`, or the list's size if every element does. The list must be sorted in ascending order by
+ * `comparator` (see arraylist_sort()); the search is a branchless binary search.
+ *
+ * Params:
+ *    list - The array list to operate on.
+ *    key - The element to search for.
+ *    comparator - Function comparing two elements.
+ * Returns:
+ *    The index of the lower bound of `key`.
+ */
+long arraylist_lowerBound(ArrayList *list, void *key, int (*comparator)(void *, void *));
+
+/**
+ * Returns the index of the first element of the sorted array list that compares greater than
+ * `key`, or the list's size if none does. The list must be sorted in ascending order by
+ * `comparator` (see arraylist_sort()); the search is a branchless binary search.
+ *
+ * Params:
+ *    list - The array list to operate on.
+ *    key - The element to search for.
+ *    comparator - Function comparing two elements.
+ * Returns:
+ *    The index of the upper bound of `key`.
+ */
+long arraylist_upperBound(ArrayList *list, void *key, int (*comparator)(void *, void *));
+
+/**
+ * Searches the sorted array list for an element equal to `key`, and stores the index of the first
+ * one found into `*index`; if there is none, the index where `key` would be inserted is stored
+ * instead. The list must be sorted in ascending order by `comparator` (see arraylist_sort()).
+ *
+ * Params:
+ *    list - The array list to operate on.
+ *    key - The element to search for.
+ *    comparator - Function comparing two elements.
+ *    index - The pointer address to store the index into.
+ * Returns:
+ *    OK - An element equal to `key` was found.
+ *    NOT_FOUND - The list has no element equal to `key`.
+ */
+Status arraylist_binarySearch(ArrayList *list, void *key, int (*comparator)(void *, void *),
+                              long *index);
+
+/**
+ * Inserts the element into the sorted array list at the position that keeps it sorted, after any
+ * elements equal to it. The position is found by a binary search, and the following elements are
+ * shifted over once. The list must be sorted in ascending order by `comparator`.
+ *
+ * Params:
+ *    list - The array list to operate on.
+ *    item - The element to be inserted.
+ *    comparator - Function comparing two elements.
+ * Returns:
+ *    OK - Operation was successful.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status arraylist_insertSorted(ArrayList *list, void *item, int (*comparator)(void *, void *));
+
+/**
+ * Sets the growth factor of the array list, that is, the percentage of its capacity to add
+ * whenever it becomes full. The percentage is expressed as a float in the range (0.0, 1.0], as
+ * with the string builder's growth factor; the default of 1.0 doubles the capacity. A smaller
+ * factor wastes less memory on a very large array list, at the cost of resizing it more often. If
+ * the factor given is outside of that range, the default factor is assigned.
+ *
+ * Whatever the factor, the array list is always grown enough for the elements being added, and
+ * never past the largest array that can be addressed. Arrays of 2MB or more are rounded up to whole
+ * 2MB pages; if the library is compiled with CDS_HUGE_PAGES defined, the kernel is also asked to
+ * back them with transparent huge pages (with madvise()). An array list created with the allocator
+ * from allocator_largePages() gets huge pages without that flag, and grows without being copied.
+ *
+ * Params:
+ *    list - The array list to operate on.
+ *    growthFactor - The percentage to increase the capacity when resizing is needed.
+ * Returns:
+ *    None
+ */
+void arraylist_setGrowthFactor(ArrayList *list, float growthFactor);
+
 /**
  * Increases the capacity of the array list, if necessary, to ensure that it can hold at least the
  * number of elements specified by the minimum capacity argument.
@@ -229,6 +458,159 @@ Status arraylist_toArray(ArrayList *list, Array **array);
  */
 Status arraylist_iterator(ArrayList *list, Iterator **iter);
 
+/**
+ * Initializes `cursor` to walk over the array list's elements from first to last, without copying
+ * them. The elements are then fetched with arraylist_cursorNext(); see cursor.h for details.
+ *
+ * Params:
+ *    list - The array list to operate on.
+ *    cursor - The cursor to initialize.
+ * Returns:
+ *    None
+ */
+void arraylist_cursor(ArrayList *list, Cursor *cursor);
+
+/**
+ * Advances the cursor to the next element of the array list, and stores it into `*next`.
+ *
+ * Params:
+ *    cursor - The cursor to operate on.
+ *    next - The pointer address to store the next element into.
+ * Returns:
+ *    OK - Next element was returned.
+ *    ITER_END - The cursor has already visited every element.
+ *    CONCURRENT_MODIFICATION - The array list was modified after creating the cursor.
+ */
+Status arraylist_cursorNext(Cursor *cursor, void **next);
+
+/**
+ * Applies `action` to each element of the array list from first to last, passing it the element and
+ * `context`. The walk stops as soon as `action` returns FALSE. Nothing is copied or allocated, and
+ * `action` must not modify the array list while it is walked.
+ *
+ * Params:
+ *    list - The array list to operate on.
+ *    action - Function applied to each element, returning FALSE to stop the walk.
+ *    context - Argument passed along to each call of `action`, may be NULL.
+ * Returns:
+ *    TRUE if `action` was applied to every element, FALSE if it stopped the walk early.
+ */
+Boolean arraylist_forEach(ArrayList *list, Boolean (*action)(void *, void *), void *context);
+
+/**
+ * Applies `action` to each element of the array list, passing it the element and `context`, using
+ * up to `nthreads` threads (64 at most). The list is split into one even range of indices per
+ * thread, each given at least 16K elements, so a smaller list, or an `nthreads` <= 1, is walked on
+ * the calling thread. The ranges are walked concurrently in no particular order, and once `action`
+ * returns FALSE every thread stops at its next element. `action` must be safe to call from several
+ * threads at once, and must not modify the array list.
+ *
+ * Params:
+ *    list - The array list to operate on.
+ *    nthreads - The most threads to walk with, including the calling thread.
+ *    action - Function applied to each element, returning FALSE to stop the walk.
+ *    context - Argument passed along to each call of `action`, may be NULL.
+ * Returns:
+ *    TRUE if `action` was applied to every element, FALSE if it stopped the walk early.
+ */
+Boolean arraylist_parallelForEach(ArrayList *list, int nthreads, Boolean (*action)(void *, void *),
+                                  void *context);
+
+/**
+ * Reduces the elements of the array list to a single result using up to `nthreads` threads, split
+ * as with arraylist_parallelForEach(). Each thread folds its range in index order, calling
+ * `reducer` with its result so far (NULL for the range's first element), the element and
+ * `context`, and keeping what it returns. The ranges' results are then merged in index order on
+ * the calling thread, calling `combiner` with the result so far, the next range's result and
+ * `context`. `reducer` must be safe to call from several threads at once, and neither function may
+ * modify the array list.
+ *
+ * Params:
+ *    list - The array list to operate on.
+ *    nthreads - The most threads to reduce with, including the calling thread.
+ *    reducer - Function folding an element into a range's result.
+ *    combiner - Function merging two ranges' results.
+ *    context - Argument passed along to each call of `reducer` and `combiner`, may be NULL.
+ * Returns:
+ *    The reduced result, or NULL if the array list is empty.
+ */
+void *arraylist_parallelReduce(ArrayList *list, int nthreads,
+                               void *(*reducer)(void *, void *, void *),
+                               void *(*combiner)(void *, void *, void *), void *context);
+
+/**
+ * Constructs a new frozen array holding the elements of the array list, sorted in ascending order
+ * by `comparator`, then stores the new instance into `*frozen`. The list itself is left as it
+ * was; later changes to it are not reflected in the frozen array.
+ *
+ * Params:
+ *    frozen - The pointer address to store the new FrozenArray instance.
+ *    list - The array list whose elements to freeze.
+ *    comparator - Function comparing two elements, also used by the lookups.
+ * Returns:
+ *    OK - FrozenArray was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status frozenarray_new(FrozenArray **frozen, ArrayList *list,
+                       int (*comparator)(void *, void *));
+
+/**
+ * Retrieves the element of the frozen array equal to `key`, and stores it into `*item`. If the
+ * array holds several equal elements, the first of them in sorted order is returned.
+ *
+ * Params:
+ *    frozen - The frozen array to operate on.
+ *    key - The element to search for.
+ *    item - The pointer address to store the element into.
+ * Returns:
+ *    OK - An element equal to `key` was found.
+ *    NOT_FOUND - The frozen array has no element equal to `key`.
+ */
+Status frozenarray_get(FrozenArray *frozen, void *key, void **item);
+
+/**
+ * Returns TRUE if the frozen array holds an element equal to `key`, FALSE if not.
+ *
+ * Params:
+ *    frozen - The frozen array to operate on.
+ *    key - The element to search for.
+ * Returns:
+ *    TRUE if an element equal to `key` was found, FALSE if not.
+ */
+Boolean frozenarray_contains(FrozenArray *frozen, void *key);
+
+/**
+ * Returns the number of elements in the frozen array.
+ *
+ * Params:
+ *    frozen - The frozen array to operate on.
+ * Returns:
+ *    The frozen array's size.
+ */
+long frozenarray_size(FrozenArray *frozen);
+
+/**
+ * Destroys the frozen array instance by freeing all of its reserved memory. The elements
+ * themselves still belong to their array list, and are left untouched.
+ *
+ * Params:
+ *    frozen - The frozen array to destroy.
+ * Returns:
+ *    None
+ */
+void frozenarray_destroy(FrozenArray *frozen);
+
+/**
+ * Returns the number of bytes of memory held by the array list: the list itself and its array,
+ * unused capacity included, not counting the elements themselves.
+ *
+ * Params:
+ *    list - The array list to operate on.
+ * Returns:
+ *    The array list's memory usage, in bytes.
+ */
+long arraylist_memoryUsage(ArrayList *list);
+
 /**
  * Destroys the array list instance by freeing all of its reserved memory. If `destructor` is not
  * NULL, it will be invoked on each element before the arraylist is destroyed.
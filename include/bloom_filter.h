@@ -0,0 +1,150 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2020 Cole Vikupitz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef _CDS_BLOOM_FILTER_H__
+#define _CDS_BLOOM_FILTER_H__
+
+#include <stdint.h>
+#include "cds_common.h"
+
+/**
+ * Interface for the BloomFilter ADT.
+ *
+ * The BloomFilter class represents a probabilistic set: it answers whether an element might have
+ * been added, with no false negatives and a tunable rate of false positives, in a few bits per
+ * element rather than the tens of bytes a HashSet entry takes. It is meant to sit in front of an
+ * expensive lookup and reject most of the misses before they reach it. Elements cannot be removed
+ * or enumerated, and the filter does not keep the elements themselves.
+ *
+ * The filter is a split block Bloom filter: the bits are grouped into 256-bit blocks, each within a
+ * single cache line, and an element sets one bit in each of the eight 32-bit words of the one
+ * block its hash code picks. Adding or probing an element therefore touches a single cache line,
+ * and the probe tests all eight words at once with SIMD instructions where available.
+ *
+ * Elements are hashed with a seeded, full-width hash function, the same convention as
+ * hashset_newSeeded(), so the built-in functions from hashing.h can be used directly.
+ */
+typedef struct bloom_filter BloomFilter;
+
+/**
+ * Creates a new, empty filter sized to hold `expected` elements with a false positive rate of
+ * about `fpp`, then stores the new instance into `*filter`. If the number of elements specified is
+ * <= 0, a default of 1024 is assigned; if the rate specified is not between 0.0 and 1.0, a default
+ * of 1% is assigned. Rates below about 0.004% are capped at 32 bits per element. The filter keeps
+ * working past `expected` elements, though its false positive rate then climbs. A fresh random
+ * seed is drawn and passed to every call of `hash`.
+ *
+ * Params:
+ *    filter - The pointer address to store the new BloomFilter instance.
+ *    hash - The seeded hashing function for computing the elements' hash codes.
+ *    expected - The number of elements the filter is sized for.
+ *    fpp - The false positive rate the filter is sized for.
+ * Returns:
+ *    OK - BloomFilter was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status bloomfilter_new(BloomFilter **filter, uint64_t (*hash)(void *, uint64_t), long expected,
+                       double fpp);
+
+/**
+ * Creates a new, empty filter with the same size, hash function and seed as `other`, then stores
+ * the new instance into `*filter`. Only filters created alike can be merged.
+ *
+ * Params:
+ *    filter - The pointer address to store the new BloomFilter instance.
+ *    other - The filter to copy the layout of.
+ * Returns:
+ *    OK - BloomFilter was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status bloomfilter_newLike(BloomFilter **filter, BloomFilter *other);
+
+/**
+ * Adds the element `item` to the filter.
+ *
+ * Params:
+ *    filter - The filter to operate on.
+ *    item - The element to add.
+ * Returns:
+ *    None
+ */
+void bloomfilter_add(BloomFilter *filter, void *item);
+
+/**
+ * Returns TRUE if the element `item` might have been added to the filter, FALSE if it certainly
+ * was not.
+ *
+ * Params:
+ *    filter - The filter to operate on.
+ *    item - The element to probe for.
+ * Returns:
+ *    FALSE if the element was never added, TRUE if it may have been.
+ */
+Boolean bloomfilter_mightContain(BloomFilter *filter, void *item);
+
+/**
+ * Merges the filter `other` into `filter`, which then reports every element added to either as
+ * possibly present, exactly as if they had all been added to `filter`. The filters must have been
+ * created alike, through bloomfilter_newLike().
+ *
+ * Params:
+ *    filter - The filter to merge into.
+ *    other - The filter to merge from, which is left unchanged.
+ * Returns:
+ *    TRUE if the filters were merged, FALSE if they were not created alike.
+ */
+Boolean bloomfilter_merge(BloomFilter *filter, BloomFilter *other);
+
+/**
+ * Removes every element from the filter.
+ *
+ * Params:
+ *    filter - The filter to operate on.
+ * Returns:
+ *    None
+ */
+void bloomfilter_clear(BloomFilter *filter);
+
+/**
+ * Returns the number of bytes of memory held by the filter, its bit array included.
+ *
+ * Params:
+ *    filter - The filter to operate on.
+ * Returns:
+ *    The filter's memory usage, in bytes.
+ */
+long bloomfilter_memoryUsage(BloomFilter *filter);
+
+/**
+ * Destroys the filter instance by freeing all of its reserved memory.
+ *
+ * Params:
+ *    filter - The filter to destroy.
+ * Returns:
+ *    None
+ */
+void bloomfilter_destroy(BloomFilter *filter);
+
+#endif  /* _CDS_BLOOM_FILTER_H__ */
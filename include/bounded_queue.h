@@ -25,7 +25,9 @@
 #ifndef _CDS_BOUNDED_QUEUE_H__
 #define _CDS_BOUNDED_QUEUE_H__
 
+#include "allocator.h"
 #include "cds_common.h"
+#include "cursor.h"
 #include "iterator.h"
 
 /**
@@ -51,6 +53,22 @@ typedef struct bounded_queue BoundedQueue;
  */
 Status boundedqueue_new(BoundedQueue **queue, long capacity);
 
+/**
+ * Creates a new queue instance whose struct and array are allocated through `allocator`, then
+ * stores the new instance into `*queue`.
+ *
+ * Params:
+ *    queue - The pointer address to store the new BoundedQueue instance.
+ *    capacity - The queue's upper-bound capacity.
+ *    allocator - The allocator to use, which must outlive the queue. If NULL, the default
+ *                allocator will be used.
+ * Returns:
+ *    OK - BoundedQueue was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the allocator.
+ */
+Status boundedqueue_newWithAllocator(BoundedQueue **queue, long capacity,
+                                     const CdsAllocator *allocator);
+
 /**
  * Inserts the specified element into the queue.
  *
@@ -170,6 +188,56 @@ Status boundedqueue_toArray(BoundedQueue *queue, Array **array);
  */
 Status boundedqueue_iterator(BoundedQueue *queue, Iterator **iter);
 
+/**
+ * Initializes `cursor` to walk over the queue's elements from front to back, without copying them.
+ * The elements are then fetched with boundedqueue_cursorNext(); see cursor.h for details.
+ *
+ * Params:
+ *    queue - The queue to operate on.
+ *    cursor - The cursor to initialize.
+ * Returns:
+ *    None
+ */
+void boundedqueue_cursor(BoundedQueue *queue, Cursor *cursor);
+
+/**
+ * Advances the cursor to the next element of the queue, and stores it into `*next`.
+ *
+ * Params:
+ *    cursor - The cursor to operate on.
+ *    next - The pointer address to store the next element into.
+ * Returns:
+ *    OK - Next element was returned.
+ *    ITER_END - The cursor has already visited every element.
+ *    CONCURRENT_MODIFICATION - The queue was modified after creating the cursor.
+ */
+Status boundedqueue_cursorNext(Cursor *cursor, void **next);
+
+/**
+ * Applies `action` to each element of the queue from front to back, passing it the element and
+ * `context`. The walk stops as soon as `action` returns FALSE. Nothing is copied or allocated, and
+ * `action` must not modify the queue while it is walked.
+ *
+ * Params:
+ *    queue - The queue to operate on.
+ *    action - Function applied to each element, returning FALSE to stop the walk.
+ *    context - Argument passed along to each call of `action`, may be NULL.
+ * Returns:
+ *    TRUE if `action` was applied to every element, FALSE if it stopped the walk early.
+ */
+Boolean boundedqueue_forEach(BoundedQueue *queue, Boolean (*action)(void *, void *), void *context);
+
+/**
+ * Returns the number of bytes of memory held by the queue: the queue itself and its array, not
+ * counting the elements themselves.
+ *
+ * Params:
+ *    queue - The queue to operate on.
+ * Returns:
+ *    The queue's memory usage, in bytes.
+ */
+long boundedqueue_memoryUsage(BoundedQueue *queue);
+
 /**
  * Destroys the queue instance by freeing all of its reserved memory. If `destructor` is not NULL,
  * it will be invoked on each element before the queue is destroyed.
@@ -25,7 +25,9 @@
 #ifndef _CDS_BOUNDED_STACK_H__
 #define _CDS_BOUNDED_STACK_H__
 
+#include "allocator.h"
 #include "cds_common.h"
+#include "cursor.h"
 #include "iterator.h"
 
 /**
@@ -51,6 +53,22 @@ typedef struct bounded_stack BoundedStack;
  */
 Status boundedstack_new(BoundedStack **stack, long capacity);
 
+/**
+ * Creates a new stack instance whose struct and array are allocated through `allocator`, then
+ * stores the new instance into `*stack`.
+ *
+ * Params:
+ *    stack - The pointer address to store the new BoundedStack instance.
+ *    capacity - The stack's upper-bound capacity.
+ *    allocator - The allocator to use, which must outlive the stack. If NULL, the default
+ *                allocator will be used.
+ * Returns:
+ *    OK - BoundedStack was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the allocator.
+ */
+Status boundedstack_newWithAllocator(BoundedStack **stack, long capacity,
+                                     const CdsAllocator *allocator);
+
 /**
  * Pushes the specified element onto the stack.
  *
@@ -169,6 +187,56 @@ Status boundedstack_toArray(BoundedStack *stack, Array **array);
  */
 Status boundedstack_iterator(BoundedStack *stack, Iterator **iter);
 
+/**
+ * Initializes `cursor` to walk over the stack's elements from top to bottom, without copying them.
+ * The elements are then fetched with boundedstack_cursorNext(); see cursor.h for details.
+ *
+ * Params:
+ *    stack - The stack to operate on.
+ *    cursor - The cursor to initialize.
+ * Returns:
+ *    None
+ */
+void boundedstack_cursor(BoundedStack *stack, Cursor *cursor);
+
+/**
+ * Advances the cursor to the next element of the stack, and stores it into `*next`.
+ *
+ * Params:
+ *    cursor - The cursor to operate on.
+ *    next - The pointer address to store the next element into.
+ * Returns:
+ *    OK - Next element was returned.
+ *    ITER_END - The cursor has already visited every element.
+ *    CONCURRENT_MODIFICATION - The stack was modified after creating the cursor.
+ */
+Status boundedstack_cursorNext(Cursor *cursor, void **next);
+
+/**
+ * Applies `action` to each element of the stack from top to bottom, passing it the element and
+ * `context`. The walk stops as soon as `action` returns FALSE. Nothing is copied or allocated, and
+ * `action` must not modify the stack while it is walked.
+ *
+ * Params:
+ *    stack - The stack to operate on.
+ *    action - Function applied to each element, returning FALSE to stop the walk.
+ *    context - Argument passed along to each call of `action`, may be NULL.
+ * Returns:
+ *    TRUE if `action` was applied to every element, FALSE if it stopped the walk early.
+ */
+Boolean boundedstack_forEach(BoundedStack *stack, Boolean (*action)(void *, void *), void *context);
+
+/**
+ * Returns the number of bytes of memory held by the stack: the stack itself and its array, not
+ * counting the elements themselves.
+ *
+ * Params:
+ *    stack - The stack to operate on.
+ * Returns:
+ *    The stack's memory usage, in bytes.
+ */
+long boundedstack_memoryUsage(BoundedStack *stack);
+
 /**
  * Destroys the stack instance by freeing all of its reserved memory. If `destructor` is not NULL,
  * it will be invoked on each element before the stack is destroyed.
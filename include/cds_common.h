@@ -114,7 +114,20 @@ typedef enum {
      * failed during instantiation, additions, resizing, or any other operation that requires
      * allocating heap memory.
      */
-    ALLOC_FAILURE = 9
+    ALLOC_FAILURE = 9,
+
+    /**
+     * Status reserved for the cursorNext() methods. Indicates that the data structure being walked
+     * by the cursor was structurally modified (i.e. an element was added or removed) after the
+     * cursor was created, so the cursor can no longer be advanced.
+     */
+    CONCURRENT_MODIFICATION = 10,
+
+    /**
+     * A system call on a file or file descriptor (i.e. open(), read(), write(), etc.) has failed.
+     * The reason for the failure is left in `errno`.
+     */
+    IO_FAILURE = 11
 
 } Status;
 
@@ -133,6 +146,54 @@ typedef struct {
     long len;           // The length of the array of elements
 } Array;
 
+/**
+ * A link of a doubly-linked list, the node type of the LinkedList and CircularList ADTs.
+ *
+ * The handle-returning operations of these lists hand out the link holding the element they
+ * added, which then serves to remove, move or insert next to that element in constant time. The
+ * link stays valid until its element is removed from the list, and its `data` member may be read
+ * or updated directly.
+ *
+ * Intrusive lists allocate no links at all: instead, the caller embeds a ListLink in its own
+ * struct and links that in, saving an allocation per element. The link's members are then managed
+ * by the list for as long as it is linked in.
+ */
+typedef struct list_link {
+    struct list_link *next;     // Pointer to the next link
+    struct list_link *prev;     // Pointer to the previous link
+    void *data;                 // Pointer to hold the element
+} ListLink;
+
+// Number of bins in the chain length histogram of HashStats, the last bin also counts longer chains
+#define HASH_STATS_BINS 16
+
+/**
+ * A structure reporting on the layout and history of a hash table, filled in by the stats()
+ * methods of the HashMap and HashSet ADTs. A table whose hash function distributes its keys well
+ * keeps its chains short, so a growing `maxChain` or a histogram with a long tail are the first
+ * signs of a degraded hash function.
+ *
+ * For flat hashmaps, which have no chains, the chain lengths are instead the number of groups of
+ * slots probed to find each entry, counted over the entries rather than the buckets.
+ *
+ * The lookup and probe counters cost an extra atomic increment per probe, and are only maintained
+ * when the library is compiled with CDS_HASH_PROBE_STATS defined; otherwise they remain 0.
+ */
+typedef struct {
+    long capacity;                      // Number of buckets (or slots, if flat)
+    long size;                          // Number of entries held
+    double load;                        // The real load, size / capacity
+    long usedBuckets;                   // Number of non-empty buckets (or live slots, if flat)
+    long maxChain;                      // Length of the longest chain
+    double meanChain;                   // Mean length of the non-empty chains
+    long histogram[HASH_STATS_BINS];    // Number of chains of each length, starting from 0
+    long tombstones;                    // Number of deleted slots awaiting reuse, if flat
+    long resizes;                       // Number of resizes performed since creation
+    long resizeNanos;                   // Total time spent resizing, in nanoseconds
+    long lookups;                       // Number of lookups, if compiled with CDS_HASH_PROBE_STATS
+    long probes;                        // Number of entries (or groups) the lookups examined
+} HashStats;
+
 /**
  * Macro used for deallocating the specified Array* item.
  *
@@ -0,0 +1,152 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2020 Cole Vikupitz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef _CDS_STATS_H__
+#define _CDS_STATS_H__
+
+#include <stdint.h>
+#include <stdio.h>
+
+/**
+ * Latency instrumentation of the ADTs' core operations.
+ *
+ * When the library is compiled with CDS_OP_STATS defined, each of the operations and internal
+ * events below times itself with the CPU's timestamp counter (or the monotonic clock on other
+ * architectures) and records the duration into a log-linear histogram of the calling thread, so
+ * threads never contend on the counters. Each power of two of a histogram is split into 8
+ * buckets, so percentiles are reported to within 12.5%. The operations of the thread-safe ADTs
+ * are recorded through the sequential ADTs they wrap, lock waits excluded.
+ *
+ * The internal events, a hashmap resize, a treemap rebalance after an insertion and an arraylist
+ * or heap growing its array, are what stalls a single operation; their histograms tell whether a
+ * tail latency of an operation comes from one of them.
+ *
+ * Without CDS_OP_STATS, nothing is recorded and the hooks compile away.
+ */
+
+/**
+ * The instrumented operations and events.
+ */
+typedef enum {
+    CDS_PROBE_HASHMAP_PUT = 0,      // hashmap_put()
+    CDS_PROBE_HASHMAP_GET,          // hashmap_get()
+    CDS_PROBE_TREEMAP_PUT,          // treemap_put()
+    CDS_PROBE_TREEMAP_GET,          // treemap_get()
+    CDS_PROBE_HEAP_INSERT,          // heap_insert()
+    CDS_PROBE_HEAP_POLL,            // heap_poll()
+    CDS_PROBE_QUEUE_POLL,           // queue_poll()
+    CDS_PROBE_ARRAYLIST_INSERT,     // arraylist_insert()
+    CDS_EVENT_HASHMAP_RESIZE,       // A hashmap resizing its table
+    CDS_EVENT_TREEMAP_REBALANCE,    // A red-black treemap rebalancing after an insertion
+    CDS_EVENT_ARRAYLIST_GROW,       // An arraylist growing its array
+    CDS_EVENT_HEAP_GROW,            // A heap growing its array
+    CDS_PROBES                      // Number of probes
+} CdsProbe;
+
+/**
+ * Summary of the durations recorded by a probe, filled in by cds_stats_get().
+ */
+typedef struct {
+    long count;             // Number of durations recorded
+    double meanNanos;       // Mean duration
+    long p50Nanos;          // Median duration
+    long p90Nanos;          // 90th percentile duration
+    long p99Nanos;          // 99th percentile duration
+    long p999Nanos;         // 99.9th percentile duration
+    long maxNanos;          // Longest duration
+} CdsOpStats;
+
+/**
+ * Returns the current reading of the monotonic clock in nanoseconds, the time source of the hooks
+ * on architectures without a timestamp counter.
+ *
+ * Params:
+ *    None
+ * Returns:
+ *    The monotonic clock's reading.
+ */
+uint64_t cds_stats_clock(void);
+
+// Reads the time source of the hooks, in ticks
+#if defined(__x86_64__) || defined(__i386__)
+#define CDS_STATS_TICKS()  ( (uint64_t)__builtin_ia32_rdtsc() )
+#else
+#define CDS_STATS_TICKS()  cds_stats_clock()
+#endif
+
+/**
+ * Records a duration of `ticks` for the probe into the calling thread's histogram. This is the
+ * function behind the hooks, which may also be called directly to time other operations.
+ *
+ * Params:
+ *    probe - The probe to record into.
+ *    ticks - The duration, as a difference of CDS_STATS_TICKS() readings.
+ * Returns:
+ *    None
+ */
+void cds_stats_record(CdsProbe probe, uint64_t ticks);
+
+/**
+ * Stores the summary of the durations recorded by the probe across every thread into `*stats`.
+ * Threads still recording may be partially counted.
+ *
+ * Params:
+ *    probe - The probe to summarize.
+ *    stats - The CdsOpStats to fill in.
+ * Returns:
+ *    None
+ */
+void cds_stats_get(CdsProbe probe, CdsOpStats *stats);
+
+/**
+ * Prints the summary of every probe that recorded a duration to `out`, one line per probe.
+ *
+ * Params:
+ *    out - The stream to print to.
+ * Returns:
+ *    None
+ */
+void cds_stats_dump(FILE *out);
+
+/**
+ * Discards every duration recorded so far.
+ *
+ * Params:
+ *    None
+ * Returns:
+ *    None
+ */
+void cds_stats_reset(void);
+
+// Hooks timing the code between them into a probe, compiled only with CDS_OP_STATS
+#ifdef CDS_OP_STATS
+#define CDS_STATS_BEGIN()  uint64_t _cdsStatsStart = CDS_STATS_TICKS()
+#define CDS_STATS_END(probe)  cds_stats_record((probe), CDS_STATS_TICKS() - _cdsStatsStart)
+#else
+#define CDS_STATS_BEGIN()
+#define CDS_STATS_END(probe)
+#endif
+
+#endif  /* _CDS_STATS_H__ */
@@ -26,6 +26,8 @@
 #define _CDS_CIRCULAR_LIST_H__
 
 #include "cds_common.h"
+#include "cursor.h"
+#include "node_pool.h"
 #include "iterator.h"
 
 /**
@@ -48,6 +50,51 @@ typedef struct circular_list CircularList;
  */
 Status circularlist_new(CircularList **list);
 
+/**
+ * Creates a new circular list instance whose nodes are allocated from `pool`, then stores the new instance
+ * into `*list`. The pool may be shared with other ADTs and must outlive the circular list; nodes are
+ * returned to it as elements are removed. If `pool` is NULL, a private pool is used instead, the
+ * same as circularlist_new().
+ *
+ * Params:
+ *    list - The pointer address to store the new CircularList instance.
+ *    pool - The pool to allocate the nodes from, or NULL.
+ * Returns:
+ *    OK - CircularList was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status circularlist_newWithPool(CircularList **list, NodePool *pool);
+
+/**
+ * Creates a new circular list instance whose struct and nodes are allocated through `allocator`,
+ * then stores the new instance into `*list`. The nodes come from a private pool backed by the
+ * allocator.
+ *
+ * Params:
+ *    list - The pointer address to store the new CircularList instance.
+ *    allocator - The allocator to use, which must outlive the circular list. If NULL, the default
+ *                allocator will be used.
+ * Returns:
+ *    OK - CircularList was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the allocator.
+ */
+Status circularlist_newWithAllocator(CircularList **list, const CdsAllocator *allocator);
+
+/**
+ * Creates a new intrusive circular list instance, then stores the new instance into `*list`. An
+ * intrusive list allocates no nodes: the caller embeds a ListLink in each of its own structs and
+ * links it in with circularlist_linkFirst(), circularlist_linkLast() or circularlist_linkAfter(),
+ * and the link is simply unlinked again once its element is removed. The allocating add and insert
+ * operations, and the handle-returning ones, must not be used on an intrusive list.
+ *
+ * Params:
+ *    list - The pointer address to store the new CircularList instance.
+ * Returns:
+ *    OK - CircularList was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status circularlist_newIntrusive(CircularList **list);
+
 /**
  * Inserts the specified element into the front of the circular list.
  *
@@ -195,6 +242,136 @@ Status circularlist_removeLast(CircularList *list, void **last);
  */
 Status circularlist_remove(CircularList *list, long i, void **item);
 
+/**
+ * Inserts the specified element into the front of the circular list, and stores the link holding
+ * it into `*handle`, if `handle` is not NULL. The handle stays valid until the element is removed.
+ *
+ * Params:
+ *    list - The circular list to operate on.
+ *    item - The element to insert.
+ *    handle - The pointer address to store the element's link into, may be NULL.
+ * Returns:
+ *    OK - Operation was successful.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status circularlist_addFirstHandle(CircularList *list, void *item, ListLink **handle);
+
+/**
+ * Inserts the specified element to the end of the circular list, and stores the link holding it
+ * into `*handle`, if `handle` is not NULL. The handle stays valid until the element is removed.
+ *
+ * Params:
+ *    list - The circular list to operate on.
+ *    item - The element to insert.
+ *    handle - The pointer address to store the element's link into, may be NULL.
+ * Returns:
+ *    OK - Operation was successful.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status circularlist_addLastHandle(CircularList *list, void *item, ListLink **handle);
+
+/**
+ * Inserts the specified element right after the element held by `handle`, in constant time, and
+ * stores the link holding the new element into `*inserted`, if `inserted` is not NULL.
+ *
+ * Params:
+ *    list - The circular list to operate on.
+ *    handle - The link of the element to insert after, which must be in the list.
+ *    item - The element to insert.
+ *    inserted - The pointer address to store the new element's link into, may be NULL.
+ * Returns:
+ *    OK - Operation was successful.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status circularlist_insertAfter(CircularList *list, ListLink *handle, void *item,
+                                ListLink **inserted);
+
+/**
+ * Removes the element held by `handle` from the circular list in constant time, and returns it.
+ * The handle is no longer valid afterwards, unless the list is intrusive, in which case the
+ * caller's link may be linked in again.
+ *
+ * Params:
+ *    list - The circular list to operate on.
+ *    handle - The link of the element to remove, which must be in the list.
+ * Returns:
+ *    The removed element.
+ */
+void *circularlist_removeHandle(CircularList *list, ListLink *handle);
+
+/**
+ * Moves the element held by `handle` to the front of the circular list in constant time.
+ *
+ * Params:
+ *    list - The circular list to operate on.
+ *    handle - The link of the element to move, which must be in the list.
+ * Returns:
+ *    None
+ */
+void circularlist_moveToFront(CircularList *list, ListLink *handle);
+
+/**
+ * Moves the element held by `handle` to the end of the circular list in constant time.
+ *
+ * Params:
+ *    list - The circular list to operate on.
+ *    handle - The link of the element to move, which must be in the list.
+ * Returns:
+ *    None
+ */
+void circularlist_moveToBack(CircularList *list, ListLink *handle);
+
+/**
+ * Returns the link holding the first element of the circular list, NULL if the list is empty. The
+ * other links are reached through the links' `next` and `prev` members, which wrap around.
+ *
+ * Params:
+ *    list - The circular list to operate on.
+ * Returns:
+ *    The first element's link, or NULL.
+ */
+ListLink *circularlist_firstHandle(CircularList *list);
+
+/**
+ * Links the caller's link `link` into the front of an intrusive circular list, holding `item`. The
+ * link must not be in any list already.
+ *
+ * Params:
+ *    list - The intrusive circular list to operate on.
+ *    link - The link to insert, usually embedded in the struct `item` points to.
+ *    item - The element the link is to hold.
+ * Returns:
+ *    None
+ */
+void circularlist_linkFirst(CircularList *list, ListLink *link, void *item);
+
+/**
+ * Links the caller's link `link` into the end of an intrusive circular list, holding `item`. The
+ * link must not be in any list already.
+ *
+ * Params:
+ *    list - The intrusive circular list to operate on.
+ *    link - The link to insert, usually embedded in the struct `item` points to.
+ *    item - The element the link is to hold.
+ * Returns:
+ *    None
+ */
+void circularlist_linkLast(CircularList *list, ListLink *link, void *item);
+
+/**
+ * Links the caller's link `link` into an intrusive circular list right after the link `position`,
+ * holding `item`. The link must not be in any list already.
+ *
+ * Params:
+ *    list - The intrusive circular list to operate on.
+ *    position - The link to insert after, which must be in the list.
+ *    link - The link to insert, usually embedded in the struct `item` points to.
+ *    item - The element the link is to hold.
+ * Returns:
+ *    None
+ */
+void circularlist_linkAfter(CircularList *list, ListLink *position, ListLink *link, void *item);
+
 /**
  * Rotates the elements in the circular list forward, such that, the first item is moved to the
  * back, and the next element becomes the front. If the list is currently empty, no rotations are
@@ -281,6 +458,57 @@ Status circularlist_toArray(CircularList *list, Array **array);
  */
 Status circularlist_iterator(CircularList *list, Iterator **iter);
 
+/**
+ * Initializes `cursor` to walk over the circular list's elements from the head onwards, without
+ * copying them. The elements are then fetched with circularlist_cursorNext(); see cursor.h for
+ * details.
+ *
+ * Params:
+ *    list - The circular list to operate on.
+ *    cursor - The cursor to initialize.
+ * Returns:
+ *    None
+ */
+void circularlist_cursor(CircularList *list, Cursor *cursor);
+
+/**
+ * Advances the cursor to the next element of the circular list, and stores it into `*next`.
+ *
+ * Params:
+ *    cursor - The cursor to operate on.
+ *    next - The pointer address to store the next element into.
+ * Returns:
+ *    OK - Next element was returned.
+ *    ITER_END - The cursor has already visited every element.
+ *    CONCURRENT_MODIFICATION - The circular list was modified after creating the cursor.
+ */
+Status circularlist_cursorNext(Cursor *cursor, void **next);
+
+/**
+ * Applies `action` to each element of the circular list from the head onwards, passing it the
+ * element and `context`. The walk stops as soon as `action` returns FALSE. Nothing is copied or
+ * allocated, and `action` must not modify the circular list while it is walked.
+ *
+ * Params:
+ *    list - The circular list to operate on.
+ *    action - Function applied to each element, returning FALSE to stop the walk.
+ *    context - Argument passed along to each call of `action`, may be NULL.
+ * Returns:
+ *    TRUE if `action` was applied to every element, FALSE if it stopped the walk early.
+ */
+Boolean circularlist_forEach(CircularList *list, Boolean (*action)(void *, void *), void *context);
+
+/**
+ * Returns the number of bytes of memory held by the circular list: the list itself and its nodes,
+ * not counting the elements themselves.
+ *
+ * Params:
+ *    list - The circular list to operate on.
+ * Returns:
+ *    The circular list's memory usage, in bytes.
+ */
+long circularlist_memoryUsage(CircularList *list);
+
 /**
  * Destroys the circular list instance by freeing all of its reserved memory. If `destructor` is not
  * NULL, it will be invoked on each element before the circular list is destroyed.
@@ -0,0 +1,240 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2020 Cole Vikupitz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _CDS_COW_ARRAYLIST_H__
+#define _CDS_COW_ARRAYLIST_H__
+
+#include "array_list.h"
+#include "cds_common.h"
+#include "ts_lock.h"
+
+/**
+ * Interface for the copy-on-write ArrayList ADT.
+ *
+ * The CopyOnWriteArrayList class is a thread-safe array list for data that is read constantly but
+ * rarely changed, such as configuration or routing tables. The list is a sequence of immutable
+ * versions: every write copies the current version, applies the change to the copy, and publishes
+ * the copy with a single atomic store. Readers never lock, they simply read whichever version is
+ * current, so cow_arraylist_get() is wait-free. Writes cost a full copy and are serialized by a
+ * lock, so changes should be batched with cow_arraylist_addAll() where possible.
+ *
+ * Superseded versions are reclaimed through epoch-based reclamation (see epoch.h), once no reader
+ * can still be reading them. The items themselves are shared between versions, so an item removed
+ * or replaced by a write may still be in use by readers of an older version; free it through
+ * epoch_retire() instead of directly.
+ */
+typedef struct cow_arraylist CopyOnWriteArrayList;
+
+/**
+ * Constructs a new copy-on-write array list instance with the specified starting capacity, then
+ * stores the new instance into `*list`. If the capacity given is <= 0, a default capacity is
+ * assigned.
+ *
+ * Params:
+ *    list - The pointer address to store the new CopyOnWriteArrayList instance.
+ *    capacity - The default capacity of the arraylist.
+ * Returns:
+ *    OK - CopyOnWriteArrayList was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status cow_arraylist_new(CopyOnWriteArrayList **list, long capacity);
+
+/**
+ * Publishes a new version of the arraylist with the specified item appended to its end.
+ *
+ * Params:
+ *    list - The arraylist to operate on.
+ *    item - The item to append.
+ * Returns:
+ *    OK - Operation was successful.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status cow_arraylist_add(CopyOnWriteArrayList *list, void *item);
+
+/**
+ * Publishes a new version of the arraylist with the `n` items from `items` appended to its end, in
+ * order. Readers see either none of the items or all of them.
+ *
+ * Params:
+ *    list - The arraylist to operate on.
+ *    items - The items to append.
+ *    n - The number of items to append.
+ * Returns:
+ *    OK - Operation was successful.
+ *    INVALID_INDEX - `n` is negative.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status cow_arraylist_addAll(CopyOnWriteArrayList *list, void **items, long n);
+
+/**
+ * Publishes a new version of the arraylist with the specified item inserted at index `i`, shifting
+ * the items from `i` onwards one place to the right.
+ *
+ * Params:
+ *    list - The arraylist to operate on.
+ *    i - The index to insert the item at.
+ *    item - The item to insert.
+ * Returns:
+ *    OK - Operation was successful.
+ *    INVALID_INDEX - Index given is out of bounds.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status cow_arraylist_insert(CopyOnWriteArrayList *list, long i, void *item);
+
+/**
+ * Retrieves the item at index `i` of the current version, and stores it into `*item`. Takes no
+ * lock.
+ *
+ * Params:
+ *    list - The arraylist to operate on.
+ *    i - The index of the item to retrieve.
+ *    item - The pointer address to store the item into.
+ * Returns:
+ *    OK - Operation was successful.
+ *    STRUCT_EMPTY - ArrayList is currently empty.
+ *    INVALID_INDEX - Index given is out of bounds.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status cow_arraylist_get(CopyOnWriteArrayList *list, long i, void **item);
+
+/**
+ * Publishes a new version of the arraylist with the item at index `i` replaced by `item`, and
+ * stores the replaced item into `*previous`.
+ *
+ * Params:
+ *    list - The arraylist to operate on.
+ *    i - The index of the item to replace.
+ *    item - The new item.
+ *    previous - The pointer address to store the replaced item into.
+ * Returns:
+ *    OK - Operation was successful.
+ *    STRUCT_EMPTY - ArrayList is currently empty.
+ *    INVALID_INDEX - Index given is out of bounds.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status cow_arraylist_set(CopyOnWriteArrayList *list, long i, void *item, void **previous);
+
+/**
+ * Publishes a new version of the arraylist without the item at index `i`, and stores the removed
+ * item into `*item`.
+ *
+ * Params:
+ *    list - The arraylist to operate on.
+ *    i - The index of the item to remove.
+ *    item - The pointer address to store the removed item into.
+ * Returns:
+ *    OK - Operation was successful.
+ *    STRUCT_EMPTY - ArrayList is currently empty.
+ *    INVALID_INDEX - Index given is out of bounds.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status cow_arraylist_remove(CopyOnWriteArrayList *list, long i, void **item);
+
+/**
+ * Publishes a new, empty version of the arraylist. If `destructor` is not NULL, each of the
+ * cleared items is retired to it, so it is only invoked once no reader can still be using them.
+ *
+ * Params:
+ *    list - The arraylist to operate on.
+ *    destructor - Function to de-allocate each cleared item, or NULL.
+ * Returns:
+ *    OK - Operation was successful.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status cow_arraylist_clear(CopyOnWriteArrayList *list, void (*destructor)(void *));
+
+/**
+ * Returns the number of items in the current version of the arraylist.
+ *
+ * Params:
+ *    list - The arraylist to operate on.
+ * Returns:
+ *    The arraylist's current size, or -1 if the calling thread's epoch record could not be
+ *    allocated.
+ */
+long cow_arraylist_size(CopyOnWriteArrayList *list);
+
+/**
+ * Returns TRUE if the current version of the arraylist is empty, FALSE if otherwise.
+ *
+ * Params:
+ *    list - The arraylist to operate on.
+ * Returns:
+ *    TRUE if the arraylist is empty, FALSE if not.
+ */
+Boolean cow_arraylist_isEmpty(CopyOnWriteArrayList *list);
+
+/**
+ * Stores the current version of the arraylist into `*snapshot`, and keeps it from being reclaimed
+ * until the calling thread calls cow_arraylist_release(). The snapshot is an ordinary ArrayList
+ * that may be read with any of the arraylist_ functions that do not modify it, and will not change
+ * however many writes are published in the meantime. The thread must not block while holding it.
+ *
+ * Params:
+ *    list - The arraylist to operate on.
+ *    snapshot - The pointer address to store the current version into.
+ * Returns:
+ *    OK - Operation was successful.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status cow_arraylist_acquire(CopyOnWriteArrayList *list, ArrayList **snapshot);
+
+/**
+ * Releases the snapshot acquired with cow_arraylist_acquire(), after which the calling thread must
+ * no longer read it.
+ *
+ * Params:
+ *    list - The arraylist the snapshot was acquired from.
+ * Returns:
+ *    None
+ */
+void cow_arraylist_release(CopyOnWriteArrayList *list);
+
+/**
+ * Fills in `stats` with how contended the arraylist's write lock has been since the arraylist was
+ * created. Readers never take the lock, so only writes are counted. The counters remain 0 unless
+ * the library is compiled with CDS_LOCK_STATS defined.
+ *
+ * Params:
+ *    list - The arraylist to operate on.
+ *    stats - The stats to fill in.
+ * Returns:
+ *    None
+ */
+void cow_arraylist_lockStats(CopyOnWriteArrayList *list, LockStats *stats);
+
+/**
+ * Destroys the arraylist instance by freeing all of its reserved memory. If `destructor` is not
+ * NULL, it will be invoked on each item of the current version. No other thread may be using the
+ * arraylist, though older versions may still be reclaimed afterwards.
+ *
+ * Params:
+ *    list - The arraylist to destroy.
+ *    destructor - Function to de-allocate each item, or NULL.
+ * Returns:
+ *    None
+ */
+void cow_arraylist_destroy(CopyOnWriteArrayList *list, void (*destructor)(void *));
+
+#endif  /* _CDS_COW_ARRAYLIST_H__ */
@@ -0,0 +1,237 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2020 Cole Vikupitz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _CDS_COW_HASHMAP_H__
+#define _CDS_COW_HASHMAP_H__
+
+#include "cds_common.h"
+#include "hash_map.h"
+#include "ts_lock.h"
+
+/**
+ * Interface for the copy-on-write HashMap ADT.
+ *
+ * The CopyOnWriteHashMap class is a thread-safe hashmap for lookup tables that are rebuilt rarely
+ * and read constantly, such as feature flags or routing tables. Each write builds a fresh copy of
+ * the table with the change applied and swaps it in atomically; lookups read whichever table is
+ * current without taking any lock, and never see a write half-applied. Since every write pays for
+ * a full copy, batches of pairs should go through cow_hashmap_putAll().
+ *
+ * A table that has been swapped out is freed through epoch-based reclamation (see epoch.h) once
+ * the last lookup that may be reading it has finished. The same applies to the keys: a removed key
+ * is only handed to the key destructor once no lookup can still be comparing against it. Values
+ * are left to the caller, who should free removed or replaced values through epoch_retire().
+ */
+typedef struct cow_hashmap CopyOnWriteHashMap;
+
+/**
+ * Constructs a new copy-on-write hashmap instance, then stores the new instance into `*map`. The
+ * parameters are the same as for hashmap_new(), and every version of the table is built with them.
+ *
+ * Params:
+ *    map - The pointer address to store the new CopyOnWriteHashMap instance.
+ *    hash - The hashing function the map will use to compute the bucket placement.
+ *    keyComparator - Function for comparing two keys in the hashmap.
+ *    capacity - The hashmap's starting capacity.
+ *    loadFactor - The hashmap's assigned load factor.
+ *    keyDestructor - Function for de-allocating the hashmap's keys.
+ * Returns:
+ *    OK - CopyOnWriteHashMap was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status cow_hashmap_new(CopyOnWriteHashMap **map, long (*hash)(void *, long),
+                       int (*keyComparator)(void *, void *), long capacity, double loadFactor,
+                       void (*keyDestructor)(void *));
+
+/**
+ * Publishes a new version of the hashmap with the specified value associated with the specified
+ * key. If the hashmap previously contained a mapping for the key, the old value is replaced, and
+ * stored into `*previous`.
+ *
+ * Params:
+ *    map - The hashmap to operate on.
+ *    key - The key with which the specified value is to be associated.
+ *    value - The value to be associated with the specified key.
+ *    previous - The pointer address to store the previous value into.
+ * Returns:
+ *    INSERTED - Entry was inserted.
+ *    REPLACED - Entry was updated in the hashmap, and the old entry was stored into `*previous` due
+ *               to the key already existing.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status cow_hashmap_put(CopyOnWriteHashMap *map, void *key, void *value, void **previous);
+
+/**
+ * Publishes a new version of the hashmap with each of the `n` keys in `keys` associated with the
+ * value at the same index in `values`, as if by calling hashmap_putAll() on a copy. Readers see
+ * either none of the pairs or all of them. If `previous` is not NULL, the value replaced by the
+ * i-th pair is stored into `previous[i]` (or NULL if its key was newly inserted).
+ *
+ * Params:
+ *    map - The hashmap to operate on.
+ *    keys - The array of keys to insert.
+ *    values - The array of values to associate with the keys.
+ *    n - The number of key-value pairs.
+ *    previous - Array of `n` slots to store the replaced values into, or NULL.
+ * Returns:
+ *    OK - Operation was successful.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap; none of the pairs were
+ *                    inserted.
+ */
+Status cow_hashmap_putAll(CopyOnWriteHashMap *map, void **keys, void **values, long n,
+                          void **previous);
+
+/**
+ * Returns TRUE if the current version of the hashmap contains a mapping for the specified key,
+ * FALSE if not. Takes no lock.
+ *
+ * Params:
+ *    map - The hashmap to operate on.
+ *    key - The key whose presence in the hashmap is to be tested.
+ * Returns:
+ *    TRUE if a mapping exists with the key, FALSE if not.
+ */
+Boolean cow_hashmap_containsKey(CopyOnWriteHashMap *map, void *key);
+
+/**
+ * Retrieves the value to which the specified key is mapped in the current version of the hashmap,
+ * then stores the result into `*value`. Takes no lock.
+ *
+ * Params:
+ *    map - The hashmap to operate on.
+ *    key - The key whose associated value is to be returned.
+ *    value - The pointer address to store the retrieved value into.
+ * Returns:
+ *    OK - Operation was successful.
+ *    STRUCT_EMPTY - HashMap is currently empty.
+ *    NOT_FOUND - Entry with the specified key was not found.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status cow_hashmap_get(CopyOnWriteHashMap *map, void *key, void **value);
+
+/**
+ * Publishes a new version of the hashmap without the mapping for the specified key, and stores the
+ * removed value into `*value`.
+ *
+ * Params:
+ *    map - The hashmap to operate on.
+ *    key - The key whose mapping is to be removed from the hashmap.
+ *    value - The pointer address to store the removed value into.
+ * Returns:
+ *    OK - Operation was successful.
+ *    STRUCT_EMPTY - HashMap is currently empty.
+ *    NOT_FOUND - Entry with the specified key was not found.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status cow_hashmap_remove(CopyOnWriteHashMap *map, void *key, void **value);
+
+/**
+ * Publishes a new, empty version of the hashmap. The cleared keys are retired to the key
+ * destructor, and if `valueDestructor` is not NULL, the cleared values to it.
+ *
+ * Params:
+ *    map - The hashmap to operate on.
+ *    valueDestructor - Function to de-allocate each cleared value, or NULL.
+ * Returns:
+ *    OK - Operation was successful.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status cow_hashmap_clear(CopyOnWriteHashMap *map, void (*valueDestructor)(void *));
+
+/**
+ * Returns the number of entries in the current version of the hashmap.
+ *
+ * Params:
+ *    map - The hashmap to operate on.
+ * Returns:
+ *    The hashmap's current size, or -1 if the calling thread's epoch record could not be
+ *    allocated.
+ */
+long cow_hashmap_size(CopyOnWriteHashMap *map);
+
+/**
+ * Returns TRUE if the current version of the hashmap contains no entries, FALSE if otherwise.
+ *
+ * Params:
+ *    map - The hashmap to operate on.
+ * Returns:
+ *    TRUE if the hashmap is empty, FALSE if not.
+ */
+Boolean cow_hashmap_isEmpty(CopyOnWriteHashMap *map);
+
+/**
+ * Stores the current version of the hashmap into `*snapshot`, and keeps it from being reclaimed
+ * until the calling thread calls cow_hashmap_release(). The snapshot is an ordinary HashMap that
+ * may be read with any of the hashmap_ functions that do not modify it, such as hashmap_getAll()
+ * or hashmap_forEach(), and will not change in the meantime. The thread must not block while
+ * holding it.
+ *
+ * Params:
+ *    map - The hashmap to operate on.
+ *    snapshot - The pointer address to store the current version into.
+ * Returns:
+ *    OK - Operation was successful.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status cow_hashmap_acquire(CopyOnWriteHashMap *map, HashMap **snapshot);
+
+/**
+ * Releases the snapshot acquired with cow_hashmap_acquire(), after which the calling thread must
+ * no longer read it.
+ *
+ * Params:
+ *    map - The hashmap the snapshot was acquired from.
+ * Returns:
+ *    None
+ */
+void cow_hashmap_release(CopyOnWriteHashMap *map);
+
+/**
+ * Fills in `stats` with how contended the hashmap's write lock has been since the hashmap was
+ * created. Lookups never take the lock, so only writes are counted. The counters remain 0 unless
+ * the library is compiled with CDS_LOCK_STATS defined.
+ *
+ * Params:
+ *    map - The hashmap to operate on.
+ *    stats - The stats to fill in.
+ * Returns:
+ *    None
+ */
+void cow_hashmap_lockStats(CopyOnWriteHashMap *map, LockStats *stats);
+
+/**
+ * Destroys the hashmap instance by freeing all of its reserved memory. Each key of the current
+ * version is passed to the key destructor, and each value to `valueDestructor` if it is not NULL.
+ * No other thread may be using the hashmap, though older versions may still be reclaimed
+ * afterwards.
+ *
+ * Params:
+ *    map - The hashmap to destroy.
+ *    valueDestructor - Function to de-allocate each value, or NULL.
+ * Returns:
+ *    None
+ */
+void cow_hashmap_destroy(CopyOnWriteHashMap *map, void (*valueDestructor)(void *));
+
+#endif  /* _CDS_COW_HASHMAP_H__ */
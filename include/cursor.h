@@ -0,0 +1,74 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2020 Cole Vikupitz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef _CDS_CURSOR_H__
+#define _CDS_CURSOR_H__
+
+#include "cds_common.h"
+
+/**
+ * Interface for the Cursor ADT.
+ *
+ * A cursor over the elements of a data structure, returned from all of the cursor() methods.
+ *
+ * Unlike the Iterator, a cursor does not copy the structure's elements; it walks the live
+ * structure, so creating one costs no allocations and stopping a scan early costs nothing. The
+ * struct is declared here so that cursors may be allocated on the stack:
+ *
+ *    Cursor cursor;
+ *    void *item;
+ *    arraylist_cursor(list, &cursor);
+ *    while (arraylist_cursorNext(&cursor, &item) == OK) {
+ *        ...
+ *    }
+ *
+ * Cursors are fail-fast: each structure counts its structural modifications (insertions, removals,
+ * clears, resizes, etc.), and once the structure is modified after the cursor was created, the
+ * structure's cursorNext() method returns CONCURRENT_MODIFICATION instead of an element. Cursors do
+ * not need to be destroyed, and their members should not be accessed directly.
+ *
+ * The ordered structures also provide range cursors (such as treemap_subMap()), which find the
+ * first element of the range with a single search and then stop before the first element past it.
+ */
+typedef struct cursor {
+    void *adt;          // The structure being walked
+    void *node;         // The next node to visit, for node based structures
+    long index;         // The next index to visit, for array based structures
+    long remaining;     // The number of elements left to visit (at most, for range cursors)
+    long modCount;      // The structure's modification count when the cursor was created
+    void *end;          // The element to stop before, for range cursors (NULL to walk to the end)
+} Cursor;
+
+/**
+ * Returns TRUE if the cursor has more elements to visit, FALSE if not.
+ *
+ * Params:
+ *    cursor - The cursor to operate on.
+ * Returns:
+ *    TRUE if the cursor has more elements, FALSE if not.
+ */
+Boolean cursor_hasNext(Cursor *cursor);
+
+#endif  /* _CDS_CURSOR_H__ */
@@ -0,0 +1,95 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2020 Cole Vikupitz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _CDS_EPOCH_H__
+#define _CDS_EPOCH_H__
+
+#include "cds_common.h"
+
+/**
+ * Interface for epoch-based reclamation, the safe memory reclamation scheme behind the ADTs whose
+ * readers never lock (the ConcurrentSkipListMap).
+ *
+ * Hazard pointers (see hazard.h) protect one node at a time, which suits the lock-free stack and
+ * queue, but not structures whose operations hold on to many nodes at once. Instead, a thread
+ * wraps each operation in epoch_enter() and epoch_exit(), and may then read any node it finds in
+ * the structure until it exits. A node that was unlinked from the structure is retired instead of
+ * freed, and is only reclaimed once every thread that was inside an operation when it was retired
+ * has exited it.
+ *
+ * The scheme keeps a global epoch, which is advanced once every thread inside an operation has
+ * observed the current one; a node retired in some epoch is reclaimed two epochs later. Every
+ * thread gets a record the first time it enters; the record is handed back for reuse when the
+ * thread exits, and any nodes it retired that are not yet reclaimed are passed on to the others.
+ *
+ * A thread that stays inside an operation holds up the reclamation of every node retired from
+ * then on, so operations must not block while inside.
+ */
+typedef struct epoch_record EpochRecord;
+
+/**
+ * Returns the calling thread's epoch record, registering one on the first call.
+ *
+ * Params:
+ *    None
+ * Returns:
+ *    The calling thread's record, or NULL if one could not be allocated.
+ */
+EpochRecord *epoch_acquire(void);
+
+/**
+ * Enters an operation on the calling thread's record. No node retired from now on will be
+ * reclaimed until the matching epoch_exit(). Calls may nest, only the outermost pair counts.
+ *
+ * Params:
+ *    record - The calling thread's epoch record.
+ * Returns:
+ *    None
+ */
+void epoch_enter(EpochRecord *record);
+
+/**
+ * Exits an operation entered with epoch_enter(), after which the thread must no longer read any
+ * node it found during the operation.
+ *
+ * Params:
+ *    record - The calling thread's epoch record.
+ * Returns:
+ *    None
+ */
+void epoch_exit(EpochRecord *record);
+
+/**
+ * Retires the node `ptr`, which must already be unreachable from its shared structure. The node is
+ * handed to `reclaim` once every thread that may still be reading it has exited its operation.
+ *
+ * Params:
+ *    ptr - The node to retire.
+ *    reclaim - The function that frees the node.
+ * Returns:
+ *    None
+ */
+void epoch_retire(void *ptr, void (*reclaim)(void *));
+
+#endif  /* _CDS_EPOCH_H__ */
@@ -25,7 +25,11 @@
 #ifndef _CDS_HASHMAP_H__
 #define _CDS_HASHMAP_H__
 
+#include <stdint.h>
+#include "allocator.h"
 #include "cds_common.h"
+#include "cursor.h"
+#include "hashing.h"
 #include "iterator.h"
 
 /**
@@ -45,10 +49,22 @@ typedef struct hm_entry HmEntry;
  */
 typedef struct hashmap HashMap;
 
+/**
+ * Declaration for the FrozenHashMap ADT.
+ *
+ * An immutable map built once from a HashMap by hashmap_freeze(), for maps that are only read
+ * after being filled. The keys are placed by a minimal perfect hash (hash and displace, as in
+ * CHD), so the keys and values sit in two contiguous arrays with no empty slots, and a lookup
+ * computes a single slot and compares a single key, with no chains or probe sequences to walk.
+ */
+typedef struct frozen_hashmap FrozenHashMap;
+
 /**
  * Constructs a new hashmap instance with the specified starting capacity and load factor, then
  * stores the new instance into `*map`. If the capacity specified is <= 0, a default capacity is
- * assigned. If the load factor specified is <= 0.0, a default load factor is assigned.
+ * assigned. If the load factor specified is <= 0.0, a default load factor is assigned. The table
+ * doubles as soon as an insertion would take its size past capacity * load factor, and halves once
+ * removals drain it below a quarter of that, though never below the starting capacity.
  *
  * The hash function specified should return an index number such that hash(obj, N) will return the
  * hashed value of 'obj' in an array of size N. For example, if using char * keys, you might define
@@ -86,6 +102,220 @@ typedef struct hashmap HashMap;
 Status hashmap_new(HashMap **map, long (*hash)(void *, long), int (*keyComparator)(void *, void *),
                    long capacity, double loadFactor, void (*keyDestructor)(void *));
 
+/**
+ * Constructs a new hashmap instance the same as hashmap_new(), except that its struct, buckets and
+ * entries are allocated through `allocator`.
+ *
+ * Params:
+ *    map - The pointer address to store the new HashMap instance.
+ *    hash - The hashing function the map will use to compute the bucket placement.
+ *    keyComparator - Function for comparing two keys in the hashmap.
+ *    capacity - The hashmap's starting capacity.
+ *    loadFactor - The hashmap's assigned load factor.
+ *    keyDestructor - Function for de-allocating the hashmap's keys.
+ *    allocator - The allocator to use, which must outlive the hashmap. If NULL, the default
+ *                allocator will be used.
+ * Returns:
+ *    OK - HashMap was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the allocator.
+ */
+Status hashmap_newWithAllocator(HashMap **map, long (*hash)(void *, long),
+                                int (*keyComparator)(void *, void *), long capacity,
+                                double loadFactor, void (*keyDestructor)(void *),
+                                const CdsAllocator *allocator);
+
+/**
+ * Constructs a new hashmap instance with the specified starting capacity and load factor, then
+ * stores the new instance into `*map`. If the capacity specified is <= 0, a default capacity is
+ * assigned. If the load factor specified is <= 0.0, a default load factor is assigned.
+ *
+ * Unlike hashmap_new(), the hash function specified should return the full-width hash code of the
+ * key, independent of the number of buckets. The hashmap caches each key's hash code inside its
+ * entry, so the hash function is invoked exactly once per insertion and lookup, and never again
+ * when the hashmap is resized. Keys are only compared when their hash codes are equal. For
+ * example, if using char * keys, you might define a hash function like this:
+ *
+ *    uint64_t hash(void *a) {
+ *        uint64_t val = 14695981039346656037UL;
+ *        char *ch;
+ *        for (ch = (char *)a; *ch != '\0'; ch++)
+ *            val = (val ^ (unsigned char)*ch) * 1099511628211UL;
+ *        return val;
+ *    }
+ *
+ * The capacity of the hashmap is rounded up to the nearest power of 2. The comparator and key
+ * destructor functions are the same as with hashmap_new().
+ *
+ * Params:
+ *    map - The pointer address to store the new HashMap instance.
+ *    hash - The hashing function for computing the keys' hash codes.
+ *    keyComparator - Function for comparing two keys in the hashmap.
+ *    capacity - The hashmap's starting capacity.
+ *    loadFactor - The hashmap's assigned load factor.
+ *    keyDestructor - Function for de-allocating the hashmap's keys.
+ * Returns:
+ *    OK - HashMap was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status hashmap_newFullHash(HashMap **map, uint64_t (*hash)(void *),
+                           int (*keyComparator)(void *, void *), long capacity, double loadFactor,
+                           void (*keyDestructor)(void *));
+
+/**
+ * Constructs a new hashmap instance backed by a flat, open-addressing table with the specified
+ * starting capacity and load factor, then stores the new instance into `*map`. If the capacity
+ * specified is <= 0, a default capacity is assigned. If the load factor specified is <= 0.0, a
+ * default load factor is assigned.
+ *
+ * Rather than allocating an entry per mapping and chaining them into buckets, the entries are
+ * stored inline in one contiguous array of slots. Each slot is guarded by a control byte holding 7
+ * bits of the key's hash code, and lookups scan the control bytes 16 at a time (with SSE2 when
+ * available), only comparing keys whose control bytes and hash codes match. Insertions do not
+ * allocate unless the table needs to grow. The load factor is capped at 0.875.
+ *
+ * The hash function, comparator and key destructor are the same as with hashmap_newFullHash().
+ * All other hashmap functions work the same for both engines, with one exception: since entries
+ * live inline in the table, `HmEntry*` values obtained from entryArray() or iterator() are only
+ * valid until the next insertion or removal.
+ *
+ * Params:
+ *    map - The pointer address to store the new HashMap instance.
+ *    hash - The hashing function for computing the keys' hash codes.
+ *    keyComparator - Function for comparing two keys in the hashmap.
+ *    capacity - The hashmap's starting capacity.
+ *    loadFactor - The hashmap's assigned load factor.
+ *    keyDestructor - Function for de-allocating the hashmap's keys.
+ * Returns:
+ *    OK - HashMap was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status hashmap_newFlat(HashMap **map, uint64_t (*hash)(void *), int (*keyComparator)(void *, void *),
+                       long capacity, double loadFactor, void (*keyDestructor)(void *));
+
+/**
+ * Constructs a new hashmap instance with a seeded, full-width hash function and the specified
+ * starting capacity and load factor, then stores the new instance into `*map`. If the capacity
+ * specified is <= 0, a default capacity is assigned. If the load factor specified is <= 0.0, a
+ * default load factor is assigned.
+ *
+ * The hashmap works like one created with hashmap_newFullHash(), except that it draws a random
+ * seed when created and passes it to every call of the hash function, so the placement of keys
+ * cannot be predicted (or attacked) from outside. The built-in functions from hashing.h can be
+ * used directly, such as:
+ *
+ *    hashmap_newSeeded(&map, hashing_string, hashing_compareString, 0L, 0.0, NULL);
+ *
+ * Params:
+ *    map - The pointer address to store the new HashMap instance.
+ *    hash - The seeded hashing function for computing the keys' hash codes.
+ *    keyComparator - Function for comparing two keys in the hashmap.
+ *    capacity - The hashmap's starting capacity.
+ *    loadFactor - The hashmap's assigned load factor.
+ *    keyDestructor - Function for de-allocating the hashmap's keys.
+ * Returns:
+ *    OK - HashMap was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status hashmap_newSeeded(HashMap **map, uint64_t (*hash)(void *, uint64_t),
+                         int (*keyComparator)(void *, void *), long capacity, double loadFactor,
+                         void (*keyDestructor)(void *));
+
+/**
+ * Constructs a new hashmap instance backed by a flat, open-addressing table with a seeded hash
+ * function, then stores the new instance into `*map`. The hashmap combines the engine of
+ * hashmap_newFlat() with the per-map random seed of hashmap_newSeeded().
+ *
+ * Params:
+ *    map - The pointer address to store the new HashMap instance.
+ *    hash - The seeded hashing function for computing the keys' hash codes.
+ *    keyComparator - Function for comparing two keys in the hashmap.
+ *    capacity - The hashmap's starting capacity.
+ *    loadFactor - The hashmap's assigned load factor.
+ *    keyDestructor - Function for de-allocating the hashmap's keys.
+ * Returns:
+ *    OK - HashMap was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status hashmap_newFlatSeeded(HashMap **map, uint64_t (*hash)(void *, uint64_t),
+                             int (*keyComparator)(void *, void *), long capacity,
+                             double loadFactor, void (*keyDestructor)(void *));
+
+/**
+ * Constructs a new hashmap instance tuned for holding only a handful of entries, then stores the
+ * new instance into `*map`. If the load factor specified is <= 0.0, a default load factor is
+ * assigned.
+ *
+ * Up to 8 entries are stored inline, in the same allocation as the hashmap itself, so a small
+ * hashmap costs a single allocation no matter how many entries it holds. Lookups scan the cached
+ * hash codes of the entries linearly, only comparing keys whose hash codes match. Inserting a 9th
+ * entry promotes the hashmap, transparently and for good, to a flat table like one created with
+ * hashmap_newFlatSeeded(), which then grows and shrinks following its load factor.
+ *
+ * The hash function, comparator and key destructor are the same as with hashmap_newSeeded(). As
+ * with the flat engine, `HmEntry*` values obtained from entryArray() or iterator() are only valid
+ * until the next insertion or removal.
+ *
+ * Params:
+ *    map - The pointer address to store the new HashMap instance.
+ *    hash - The seeded hashing function for computing the keys' hash codes.
+ *    keyComparator - Function for comparing two keys in the hashmap.
+ *    loadFactor - The load factor assigned to the hashmap once promoted.
+ *    keyDestructor - Function for de-allocating the hashmap's keys.
+ * Returns:
+ *    OK - HashMap was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status hashmap_newSmall(HashMap **map, uint64_t (*hash)(void *, uint64_t),
+                        int (*keyComparator)(void *, void *), double loadFactor,
+                        void (*keyDestructor)(void *));
+
+/**
+ * Enables or disables incremental resizing for the hashmap. By default the hashmap rehashes all of
+ * its entries into the larger array of buckets at once, which stalls the insertion that triggered
+ * the resize for time proportional to the hashmap's size. With incremental resizing enabled, the
+ * hashmap keeps both arrays of buckets while resizing, and each following insertion or removal
+ * moves a small, bounded number of buckets over, keeping the latency of every operation flat.
+ * Lookups search both arrays while a resize is in progress, but never modify the hashmap.
+ *
+ * Disabling incremental resizing completes any resize that is in progress. This setting has no
+ * effect on hashmaps created with hashmap_newFlat().
+ *
+ * Params:
+ *    map - The hashmap to operate on.
+ *    incremental - TRUE to resize incrementally, FALSE to resize all at once.
+ * Returns:
+ *    None
+ */
+void hashmap_setIncrementalResize(HashMap *map, Boolean incremental);
+
+/**
+ * Increases the capacity of the hashmap, if necessary, so that it can hold at least `n` entries
+ * under its load factor. The table is resized at most once, so loading the entries afterwards
+ * causes no intermediate doublings. The hashmap will not shrink below the reserved capacity as
+ * entries are removed, until hashmap_shrinkToFit() is called.
+ *
+ * Params:
+ *    map - The hashmap to operate on.
+ *    n - The number of entries to reserve room for.
+ * Returns:
+ *    OK - Operation was successful.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status hashmap_reserve(HashMap *map, long n);
+
+/**
+ * Shrinks the capacity of the hashmap to the smallest that holds its current entries under its
+ * load factor, releasing the rest of the table. Also drops any capacity that was reserved with
+ * hashmap_reserve().
+ *
+ * Params:
+ *    map - The hashmap to operate on.
+ * Returns:
+ *    OK - Operation was successful.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status hashmap_shrinkToFit(HashMap *map);
+
 /**
  * Associates the specified value with the specified key in the hashmap. If the hashmap previously
  * contained a mapping for the key, the old value is replaced, and stored into `*previous`.
@@ -142,6 +372,75 @@ Status hashmap_get(HashMap *map, void *key, void **value);
  */
 Status hashmap_remove(HashMap *map, void *key, void **value);
 
+/**
+ * Associates each of the `n` keys in `keys` with the value at the same index in `values`, as if by
+ * calling hashmap_put() on each pair in order. The table is grown once up front to fit the whole
+ * batch, and each key's bucket is prefetched while the keys before it are being inserted. If
+ * `previous` is not NULL, the value replaced by the i-th pair is stored into `previous[i]` (or
+ * NULL if its key was newly inserted).
+ *
+ * Params:
+ *    map - The hashmap to operate on.
+ *    keys - The array of keys to insert.
+ *    values - The array of values to associate with the keys.
+ *    n - The number of key-value pairs.
+ *    previous - Array of `n` slots to store the replaced values into, or NULL.
+ * Returns:
+ *    OK - Operation was successful.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap; the pairs before the one that
+ *                    failed were inserted.
+ */
+Status hashmap_putAll(HashMap *map, void **keys, void **values, long n, void **previous);
+
+/**
+ * Fetches the values to which each of the `n` keys in `keys` are mapped, and stores them into
+ * `values` at the same indices (or NULL if the key is not present). Each key's bucket is
+ * prefetched while the keys before it are being looked up.
+ *
+ * Params:
+ *    map - The hashmap to operate on.
+ *    keys - The array of keys to look up.
+ *    values - Array of `n` slots to store the fetched values into.
+ *    n - The number of keys.
+ * Returns:
+ *    The number of keys that were found in the hashmap.
+ */
+long hashmap_getAll(HashMap *map, void **keys, void **values, long n);
+
+/**
+ * Fetches the values to which each of the `n` keys in `keys` are mapped, and stores them into
+ * `values` at the same indices (or NULL if the key is not present). Unlike hashmap_getAll(), the
+ * keys are looked up in groups: every key in a group is hashed and its bucket prefetched before
+ * any of them is probed, so the cache misses of the whole group overlap. If `statuses` is not
+ * NULL, the result of each individual lookup is stored into it as hashmap_get() would return it.
+ *
+ * Params:
+ *    map - The hashmap to operate on.
+ *    keys - The array of keys to look up.
+ *    n - The number of keys.
+ *    values - Array of `n` slots to store the fetched values into.
+ *    statuses - Array of `n` slots to store each lookup's status into (OK, NOT_FOUND, or
+ *               STRUCT_EMPTY), or NULL.
+ * Returns:
+ *    The number of keys that were found in the hashmap.
+ */
+long hashmap_getMany(HashMap *map, void **keys, long n, void **values, Status *statuses);
+
+/**
+ * Removes the mappings for each of the `n` keys in `keys` from the hashmap if present. If `values`
+ * is not NULL, the value removed for the i-th key is stored into `values[i]` (or NULL if the key
+ * was not present).
+ *
+ * Params:
+ *    map - The hashmap to operate on.
+ *    keys - The array of keys whose mappings are to be removed.
+ *    values - Array of `n` slots to store the removed values into, or NULL.
+ *    n - The number of keys.
+ * Returns:
+ *    The number of mappings that were removed.
+ */
+long hashmap_removeAll(HashMap *map, void **keys, void **values, long n);
+
 /**
  * Removes all elements from the hashmap. If `destructor` is not NULL, it will be invoked on each
  * element in the hashmap after being removed.
@@ -174,6 +473,20 @@ long hashmap_size(HashMap *map);
  */
 Boolean hashmap_isEmpty(HashMap *map);
 
+/**
+ * Reports on the layout of the hashmap and its history into `*stats`: its capacity, size and real
+ * load, the histogram, mean and maximum of its chain lengths, and the number of resizes and time
+ * spent on them. Walks every bucket, so this takes time proportional to the hashmap's capacity. See
+ * HashStats for the meaning of each field.
+ *
+ * Params:
+ *    map - The hashmap to operate on.
+ *    stats - The HashStats to fill in.
+ * Returns:
+ *    None
+ */
+void hashmap_stats(HashMap *map, HashStats *stats);
+
 /**
  * Allocates and generates an array containing all of the hashmap's keys in no particular order,
  * then stores the array into `*keys`. Caller is responsible for freeing the array when finished.
@@ -203,6 +516,23 @@ Status hashmap_keyArray(HashMap *map, Array **keys);
  */
 Status hashmap_entryArray(HashMap *map, Array **entries);
 
+/**
+ * Allocates and generates an array containing copies of all the hashmap's entries in no particular
+ * order, then stores the array into `*entries`. Unlike hashmap_entryArray(), the `HmEntry*` items
+ * are private copies held in the same allocation as the array, so they remain valid after the
+ * hashmap is modified or destroyed. Caller is responsible for freeing the array with FREE_ARRAY()
+ * when finished; the keys and values themselves are not copied.
+ *
+ * Params:
+ *    map - The hashmap to operate on.
+ *    entries - Address where the entry copies will be stored.
+ * Returns:
+ *    OK - Operation was successful.
+ *    STRUCT_EMPTY - HashMap is currently empty.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status hashmap_entrySnapshot(HashMap *map, Array **entries);
+
 /**
  * Creates an Iterator instance to iterate over the the hashmap's elements in no particular order,
  * then stores the iterator into `*iter`. Note that the items being iterated over are 'HmEntry*'
@@ -218,6 +548,217 @@ Status hashmap_entryArray(HashMap *map, Array **entries);
  */
 Status hashmap_iterator(HashMap *map, Iterator **iter);
 
+/**
+ * Initializes `cursor` to walk over the hashmap's entries in no particular order, without copying
+ * them (the items visited are `HmEntry*` values). The entries are then fetched with
+ * hashmap_cursorNext(); see cursor.h for details.
+ *
+ * Params:
+ *    map - The hashmap to operate on.
+ *    cursor - The cursor to initialize.
+ * Returns:
+ *    None
+ */
+void hashmap_cursor(HashMap *map, Cursor *cursor);
+
+/**
+ * Advances the cursor to the next entry of the hashmap, and stores it into `*next`.
+ *
+ * Params:
+ *    cursor - The cursor to operate on.
+ *    next - The pointer address to store the next entry into.
+ * Returns:
+ *    OK - Next entry was returned.
+ *    ITER_END - The cursor has already visited every entry.
+ *    CONCURRENT_MODIFICATION - The hashmap was modified after creating the cursor.
+ */
+Status hashmap_cursorNext(Cursor *cursor, void **next);
+
+/**
+ * Applies `action` to each entry of the hashmap in no particular order, passing it the entry's key,
+ * its value and `context`. The walk stops as soon as `action` returns FALSE. Nothing is copied or
+ * allocated, and `action` must not modify the hashmap while it is walked.
+ *
+ * Params:
+ *    map - The hashmap to operate on.
+ *    action - Function applied to each entry, returning FALSE to stop the walk.
+ *    context - Argument passed along to each call of `action`, may be NULL.
+ * Returns:
+ *    TRUE if `action` was applied to every entry, FALSE if it stopped the walk early.
+ */
+Boolean hashmap_forEach(HashMap *map, Boolean (*action)(void *, void *, void *), void *context);
+
+/**
+ * Applies `action` to each entry of the hashmap, passing it the entry's key, its value and
+ * `context`, using up to `nthreads` threads (64 at most). The map's buckets (or slots) are split
+ * into one even range per thread, and each thread is given at least 16K entries, so a smaller map,
+ * or an `nthreads` <= 1, is walked on the calling thread. The ranges are walked concurrently in no
+ * particular order, and once `action` returns FALSE every thread stops at its next entry. `action`
+ * must be safe to call from several threads at once, and must not modify the hashmap.
+ *
+ * Params:
+ *    map - The hashmap to operate on.
+ *    nthreads - The most threads to walk with, including the calling thread.
+ *    action - Function applied to each entry, returning FALSE to stop the walk.
+ *    context - Argument passed along to each call of `action`, may be NULL.
+ * Returns:
+ *    TRUE if `action` was applied to every entry, FALSE if it stopped the walk early.
+ */
+Boolean hashmap_parallelForEach(HashMap *map, int nthreads,
+                                Boolean (*action)(void *, void *, void *), void *context);
+
+/**
+ * Reduces the entries of the hashmap to a single result using up to `nthreads` threads, split as
+ * with hashmap_parallelForEach(). Each thread folds its range, calling `reducer` with its result so
+ * far (NULL for the range's first entry), the entry's key, its value and `context`, and keeping
+ * what it returns. The results of the ranges holding any entries are then merged on the calling
+ * thread, calling `combiner` with the result so far, the next range's result and `context`.
+ * `reducer` must be safe to call from several threads at once, and neither function may modify
+ * the hashmap.
+ *
+ * Params:
+ *    map - The hashmap to operate on.
+ *    nthreads - The most threads to reduce with, including the calling thread.
+ *    reducer - Function folding an entry into a range's result.
+ *    combiner - Function merging two ranges' results.
+ *    context - Argument passed along to each call of `reducer` and `combiner`, may be NULL.
+ * Returns:
+ *    The reduced result, or NULL if the hashmap is empty.
+ */
+void *hashmap_parallelReduce(HashMap *map, int nthreads,
+                             void *(*reducer)(void *, void *, void *, void *),
+                             void *(*combiner)(void *, void *, void *), void *context);
+
+/**
+ * Writes the hashmap's entries out to the file descriptor `fd`, starting at its current offset, as
+ * a snapshot (see snapshot.h) that hashmap_loadFrom() reads back, or snapshot_open() maps for
+ * read-only lookups. Each key and value is turned into bytes by `keySerializer` and
+ * `valueSerializer`, whose contract is described in snapshot.h.
+ *
+ * Params:
+ *    map - The hashmap to operate on.
+ *    fd - The file descriptor to write the snapshot to, a regular file open for writing.
+ *    keySerializer - Function serializing each key.
+ *    valueSerializer - Function serializing each value.
+ * Returns:
+ *    OK - Operation was successful.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ *    IO_FAILURE - A write to the file failed.
+ */
+Status hashmap_saveTo(HashMap *map, int fd, long (*keySerializer)(void *, void *, long),
+                      long (*valueSerializer)(void *, void *, long));
+
+/**
+ * Maps the snapshot starting at the current offset of the file descriptor `fd` into memory and
+ * inserts each of its records into the hashmap, turning their bytes back into keys and values with
+ * `keyDeserializer` and `valueDeserializer`. The table is grown once up front to fit every record.
+ * Records whose key is already present replace the current value, which is passed to
+ * `valueDestructor` (if not NULL) along with the duplicate key being passed to the hashmap's key
+ * destructor. If loading fails partway, the records loaded so far are kept.
+ *
+ * Params:
+ *    map - The hashmap to operate on.
+ *    fd - The file descriptor to read the snapshot from.
+ *    keyDeserializer - Function turning key bytes back into a key, NULL if allocation fails.
+ *    valueDeserializer - Function turning value bytes back into a value, NULL if allocation fails.
+ *    valueDestructor - Function to operate on each replaced value, may be NULL.
+ * Returns:
+ *    OK - Operation was successful.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ *    IO_FAILURE - The file could not be mapped, or does not hold a complete, well-formed snapshot
+ *                 (`errno` is then set to EINVAL).
+ */
+Status hashmap_loadFrom(HashMap *map, int fd, void *(*keyDeserializer)(const void *, long),
+                        void *(*valueDeserializer)(const void *, long),
+                        void (*valueDestructor)(void *));
+
+/**
+ * Builds an immutable frozen hashmap out of the hashmap's entries, then stores the new instance
+ * into `*frozen`. The entries are moved rather than copied: on success the hashmap is left empty
+ * (and may still be used), and the frozen hashmap takes over its key destructor. The frozen
+ * hashmap hashes keys with the hashmap's own hash function, whose results need not be unique;
+ * keys sharing a hash code with another key are kept aside and found by a binary search instead.
+ *
+ * Params:
+ *    map - The hashmap to freeze.
+ *    frozen - The pointer address to store the new FrozenHashMap instance.
+ * Returns:
+ *    OK - FrozenHashMap was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap; the hashmap is left as is.
+ */
+Status hashmap_freeze(HashMap *map, FrozenHashMap **frozen);
+
+/**
+ * Fetches the value to which the specified key is mapped in the frozen hashmap, and stores the
+ * result into `*value`.
+ *
+ * Params:
+ *    frozen - The frozen hashmap to operate on.
+ *    key - The key whose associated value is to be returned.
+ *    value - The pointer address to store the fetched value into.
+ * Returns:
+ *    OK - Operation was successful.
+ *    NOT_FOUND - Entry with the specified key was not found.
+ */
+Status frozenhashmap_get(FrozenHashMap *frozen, void *key, void **value);
+
+/**
+ * Returns TRUE if the frozen hashmap contains a mapping for the specified key, FALSE if otherwise.
+ *
+ * Params:
+ *    frozen - The frozen hashmap to operate on.
+ *    key - The key to search for.
+ * Returns:
+ *    TRUE if a mapping exists with the key, FALSE if not.
+ */
+Boolean frozenhashmap_containsKey(FrozenHashMap *frozen, void *key);
+
+/**
+ * Returns the number of entries in the frozen hashmap.
+ *
+ * Params:
+ *    frozen - The frozen hashmap to operate on.
+ * Returns:
+ *    The frozen hashmap's size.
+ */
+long frozenhashmap_size(FrozenHashMap *frozen);
+
+/**
+ * Returns the number of bytes of memory held by the frozen hashmap: the frozen hashmap itself, its
+ * displacement table and its arrays of hash codes, keys and values, not counting the keys and
+ * values themselves.
+ *
+ * Params:
+ *    frozen - The frozen hashmap to operate on.
+ * Returns:
+ *    The frozen hashmap's memory usage, in bytes.
+ */
+long frozenhashmap_memoryUsage(FrozenHashMap *frozen);
+
+/**
+ * Destroys the frozen hashmap instance by freeing all of its reserved memory. The key destructor
+ * taken over from the hashmap is invoked on each key, and if `valueDestructor` is not NULL, it will
+ * be invoked on each value.
+ *
+ * Params:
+ *    frozen - The frozen hashmap to destroy.
+ *    valueDestructor - Function to operate on each entry value prior to destruction.
+ * Returns:
+ *    None
+ */
+void frozenhashmap_destroy(FrozenHashMap *frozen, void (*valueDestructor)(void *));
+
+/**
+ * Returns the number of bytes of memory held by the hashmap: the hashmap itself, its buckets or
+ * slots and its entries, not counting the keys and values.
+ *
+ * Params:
+ *    map - The hashmap to operate on.
+ * Returns:
+ *    The hashmap's memory usage, in bytes.
+ */
+long hashmap_memoryUsage(HashMap *map);
+
 /**
  * Destroys the hashmap instance by freeing all of its reserved memory. If `destructor` is not NULL,
  * it will be invoked on each element before the hashmap is destroyed.
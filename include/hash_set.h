@@ -25,7 +25,11 @@
 #ifndef _CDS_HASHSET_H__
 #define _CDS_HASHSET_H__
 
+#include <stdint.h>
+#include "allocator.h"
 #include "cds_common.h"
+#include "cursor.h"
+#include "hashing.h"
 #include "iterator.h"
 
 /**
@@ -40,7 +44,9 @@ typedef struct hashset HashSet;
 /**
  * Constructs a new hashset instance with the specified starting capacity and load factor, then
  * stores the new instance into `*set`. If the capacity specified is <= 0, a default capacity is
- * assigned. If the load factor specified is <= 0.0, a default load factor is assigned.
+ * assigned. If the load factor specified is <= 0.0, a default load factor is assigned. The table
+ * doubles as soon as an insertion would take its size past capacity * load factor, and halves once
+ * removals drain it below a quarter of that, though never below the starting capacity.
  *
  * The hash function specified should return an index number such that hash(obj, N) will return the
  * hashed value of `obj` in an array of size N.
@@ -61,6 +67,119 @@ typedef struct hashset HashSet;
 Status hashset_new(HashSet **set, long (*hash)(void *, long), int (*comparator)(void *, void *),
                    long capacity, double loadFactor);
 
+/**
+ * Constructs a new hashset instance the same as hashset_new(), except that its struct, buckets and
+ * entries are allocated through `allocator`.
+ *
+ * Params:
+ *    set - The pointer address to store the new HashSet instance.
+ *    hash - Function to hash the values inside the hashset.
+ *    comparator - Function for comparing two items in the hashset.
+ *    capacity - The hashset's starting capacity.
+ *    loadFactor - The hashset's assigned load factor.
+ *    allocator - The allocator to use, which must outlive the hashset. If NULL, the default
+ *                allocator will be used.
+ * Returns:
+ *    OK - HashSet was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the allocator.
+ */
+Status hashset_newWithAllocator(HashSet **set, long (*hash)(void *, long),
+                                int (*comparator)(void *, void *), long capacity, double loadFactor,
+                                const CdsAllocator *allocator);
+
+/**
+ * Constructs a new hashset instance with a seeded, full-width hash function and the specified
+ * starting capacity and load factor, then stores the new instance into `*set`. If the capacity
+ * specified is <= 0, a default capacity is assigned. If the load factor specified is <= 0.0, a
+ * default load factor is assigned.
+ *
+ * The hashset draws a random seed when created and passes it to every call of the hash function,
+ * so the placement of elements cannot be predicted (or attacked) from outside. The hash function
+ * returns a 64-bit hash code, from which the bucket index is masked, so the capacity is rounded up
+ * to a power of 2. The built-in functions from hashing.h can be used directly, such as:
+ *
+ *    hashset_newSeeded(&set, hashing_string, hashing_compareString, 0L, 0.0);
+ *
+ * Params:
+ *    set - The pointer address to store the new HashSet instance.
+ *    hash - The seeded hashing function for computing the elements' hash codes.
+ *    comparator - Function for comparing two elements in the hashset.
+ *    capacity - The hashset's starting capacity.
+ *    loadFactor - The hashset's assigned load factor.
+ * Returns:
+ *    OK - HashSet was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status hashset_newSeeded(HashSet **set, uint64_t (*hash)(void *, uint64_t),
+                         int (*comparator)(void *, void *), long capacity, double loadFactor);
+
+/**
+ * Constructs a new hashset instance tuned for holding only a handful of elements, then stores the
+ * new instance into `*set`. If the load factor specified is <= 0.0, a default load factor is
+ * assigned.
+ *
+ * Up to 8 elements are stored inline, in the same allocation as the hashset itself, and lookups
+ * compare against each of them in turn without hashing. Adding a 9th element promotes the hashset,
+ * transparently and for good, to an array of buckets like one created with hashset_newSeeded().
+ *
+ * Params:
+ *    set - The pointer address to store the new HashSet instance.
+ *    hash - The seeded hashing function for computing the elements' hash codes once promoted.
+ *    comparator - Function for comparing two elements in the hashset.
+ *    loadFactor - The load factor assigned to the hashset once promoted.
+ * Returns:
+ *    OK - HashSet was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status hashset_newSmall(HashSet **set, uint64_t (*hash)(void *, uint64_t),
+                        int (*comparator)(void *, void *), double loadFactor);
+
+/**
+ * Enables or disables incremental resizing for the hashset. By default the hashset rehashes all of
+ * its elements into the larger array of buckets at once, which stalls the insertion that triggered
+ * the resize for time proportional to the hashset's size. With incremental resizing enabled, the
+ * hashset keeps both arrays of buckets while resizing, and each following insertion or removal
+ * moves a small, bounded number of buckets over. Lookups search both arrays while a resize is in
+ * progress, but never modify the hashset.
+ *
+ * Disabling incremental resizing completes any resize that is in progress.
+ *
+ * Params:
+ *    set - The hashset to operate on.
+ *    incremental - TRUE to resize incrementally, FALSE to resize all at once.
+ * Returns:
+ *    None
+ */
+void hashset_setIncrementalResize(HashSet *set, Boolean incremental);
+
+/**
+ * Increases the capacity of the hashset, if necessary, so that it can hold at least `n` elements
+ * under its load factor. The table is resized at most once, so loading the elements afterwards
+ * causes no intermediate doublings. The hashset will not shrink below the reserved capacity as
+ * elements are removed, until hashset_shrinkToFit() is called.
+ *
+ * Params:
+ *    set - The hashset to operate on.
+ *    n - The number of elements to reserve room for.
+ * Returns:
+ *    OK - Operation was successful.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status hashset_reserve(HashSet *set, long n);
+
+/**
+ * Shrinks the capacity of the hashset to the smallest that holds its current elements under its
+ * load factor, releasing the rest of the table. Also drops any capacity that was reserved with
+ * hashset_reserve().
+ *
+ * Params:
+ *    set - The hashset to operate on.
+ * Returns:
+ *    OK - Operation was successful.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status hashset_shrinkToFit(HashSet *set);
+
 /**
  * Adds the specified element to the hashset if it is not already present.
  *
@@ -85,6 +204,22 @@ Status hashset_add(HashSet *set, void *item);
  */
 Boolean hashset_contains(HashSet *set, void *item);
 
+/**
+ * Checks whether each of the `n` elements in `items` is present in the hashset, and stores the
+ * answers into `results` at the same indices. The elements are looked up in groups: every element
+ * in a group is hashed and its bucket prefetched before any of them is probed, so the cache misses
+ * of the whole group overlap.
+ *
+ * Params:
+ *    set - The hashset to operate on.
+ *    items - The array of elements to look up.
+ *    n - The number of elements.
+ *    results - Array of `n` slots to store TRUE or FALSE into for each element.
+ * Returns:
+ *    The number of elements that are present in the hashset.
+ */
+long hashset_containsMany(HashSet *set, void **items, long n, Boolean *results);
+
 /**
  * Removes the specified element from the hashset if it is present. If `destructor` is not NULL, it
  * will be invoked on the element after removal.
@@ -100,6 +235,83 @@ Boolean hashset_contains(HashSet *set, void *item);
  */
 Status hashset_remove(HashSet *set, void *item, void (*destructor)(void *));
 
+/**
+ * Adds each of the `n` elements in `items` into the hashset, as if by calling hashset_add() on each
+ * of them in order; elements already present are skipped. The table is grown once up front to fit
+ * the whole batch, and each element's bucket is prefetched while the elements before it are being
+ * added.
+ *
+ * Params:
+ *    set - The hashset to operate on.
+ *    items - The array of elements to add.
+ *    n - The number of elements.
+ * Returns:
+ *    OK - Operation was successful.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap; the elements before the one
+ *                    that failed were added.
+ */
+Status hashset_addAll(HashSet *set, void **items, long n);
+
+/**
+ * Removes each of the `n` elements in `items` from the hashset if present. If `destructor` is not
+ * NULL, it will be invoked on each element removed.
+ *
+ * Params:
+ *    set - The hashset to operate on.
+ *    items - The array of elements to remove.
+ *    n - The number of elements.
+ *    destructor - Function to operate on each element after removal.
+ * Returns:
+ *    The number of elements that were removed.
+ */
+long hashset_removeAll(HashSet *set, void **items, long n, void (*destructor)(void *));
+
+/**
+ * Creates a new hashset holding every element found in either `a` or `b`, then stores the new
+ * instance into `*result`. The result is sized up front and hashes and compares its elements the
+ * same way as `a`, whose functions must also suit the elements of `b`. It shares the elements of
+ * both hashsets rather than copying them (taking those of `a` for the elements in both), so it
+ * should be destroyed with a NULL destructor.
+ *
+ * Params:
+ *    a - The first hashset.
+ *    b - The second hashset.
+ *    result - The pointer address to store the new HashSet instance.
+ * Returns:
+ *    OK - Operation was successful.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status hashset_union(HashSet *a, HashSet *b, HashSet **result);
+
+/**
+ * Creates a new hashset holding the elements of `a` that are also found in `b`, then stores the
+ * new instance into `*result`. Only the smaller of the two hashsets is walked, looking its elements
+ * up in the larger one. The result shares the elements of `a`, see hashset_union().
+ *
+ * Params:
+ *    a - The first hashset.
+ *    b - The second hashset.
+ *    result - The pointer address to store the new HashSet instance.
+ * Returns:
+ *    OK - Operation was successful.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status hashset_intersect(HashSet *a, HashSet *b, HashSet **result);
+
+/**
+ * Creates a new hashset holding the elements of `a` that are not found in `b`, then stores the new
+ * instance into `*result`. The result shares the elements of `a`, see hashset_union().
+ *
+ * Params:
+ *    a - The first hashset.
+ *    b - The second hashset.
+ *    result - The pointer address to store the new HashSet instance.
+ * Returns:
+ *    OK - Operation was successful.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status hashset_difference(HashSet *a, HashSet *b, HashSet **result);
+
 /**
  * Removes all elements from the hashset. If `destructor` is not NULL, it will be invoked on each
  * element in the hashset after being removed.
@@ -132,6 +344,20 @@ long hashset_size(HashSet *set);
  */
 Boolean hashset_isEmpty(HashSet *set);
 
+/**
+ * Reports on the layout of the hashset and its history into `*stats`: its capacity, size and real
+ * load, the histogram, mean and maximum of its chain lengths, and the number of resizes and time
+ * spent on them. Walks every bucket, so this takes time proportional to the hashset's capacity. See
+ * HashStats for the meaning of each field.
+ *
+ * Params:
+ *    set - The hashset to operate on.
+ *    stats - The HashStats to fill in.
+ * Returns:
+ *    None
+ */
+void hashset_stats(HashSet *set, HashStats *stats);
+
 /**
  * Allocates and generates an array containing all of the hashset's elements in no particular order,
  * then stores the array into `*array`. Caller is responsible for freeing the array when finished.
@@ -160,6 +386,56 @@ Status hashset_toArray(HashSet *set, Array **array);
  */
 Status hashset_iterator(HashSet *set, Iterator **iter);
 
+/**
+ * Initializes `cursor` to walk over the hashset's elements in no particular order, without copying
+ * them. The elements are then fetched with hashset_cursorNext(); see cursor.h for details.
+ *
+ * Params:
+ *    set - The hashset to operate on.
+ *    cursor - The cursor to initialize.
+ * Returns:
+ *    None
+ */
+void hashset_cursor(HashSet *set, Cursor *cursor);
+
+/**
+ * Advances the cursor to the next element of the hashset, and stores it into `*next`.
+ *
+ * Params:
+ *    cursor - The cursor to operate on.
+ *    next - The pointer address to store the next element into.
+ * Returns:
+ *    OK - Next element was returned.
+ *    ITER_END - The cursor has already visited every element.
+ *    CONCURRENT_MODIFICATION - The hashset was modified after creating the cursor.
+ */
+Status hashset_cursorNext(Cursor *cursor, void **next);
+
+/**
+ * Applies `action` to each element of the hashset in no particular order, passing it the element
+ * and `context`. The walk stops as soon as `action` returns FALSE. Nothing is copied or allocated,
+ * and `action` must not modify the hashset while it is walked.
+ *
+ * Params:
+ *    set - The hashset to operate on.
+ *    action - Function applied to each element, returning FALSE to stop the walk.
+ *    context - Argument passed along to each call of `action`, may be NULL.
+ * Returns:
+ *    TRUE if `action` was applied to every element, FALSE if it stopped the walk early.
+ */
+Boolean hashset_forEach(HashSet *set, Boolean (*action)(void *, void *), void *context);
+
+/**
+ * Returns the number of bytes of memory held by the hashset: the hashset itself, its buckets and
+ * its entries, not counting the elements themselves.
+ *
+ * Params:
+ *    set - The hashset to operate on.
+ * Returns:
+ *    The hashset's memory usage, in bytes.
+ */
+long hashset_memoryUsage(HashSet *set);
+
 /**
  * Destroys the hashset instance by freeing all of its reserved memory. If `destructor` is not NULL,
  * it will be invoked on each element before the hashset is destroyed.
@@ -0,0 +1,149 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2020 Cole Vikupitz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef _CDS_HASHING_H__
+#define _CDS_HASHING_H__
+
+#include <stdint.h>
+
+/**
+ * Interface for the built-in hash functions and their matching comparators.
+ *
+ * The hash functions take a seed alongside the key, and are meant to be passed to the seeded
+ * constructors of the HashMap and HashSet ADTs (see hashmap_newSeeded() and hashset_newSeeded()),
+ * which draw a fresh random seed for every instance. An adversary who does not know the seed
+ * cannot pick keys that collide, which keeps chains short even when the keys are chosen by an
+ * untrusted party (HashDoS).
+ *
+ * Byte strings are hashed with wyhash, which reads the input eight bytes at a time and passes the
+ * SMHasher suite; integers are hashed with a 64-bit multiply-xorshift mixer, where every input bit
+ * affects every output bit.
+ */
+
+/**
+ * Returns a fresh random seed, read from the system's entropy source where one is available.
+ * Otherwise the seed is mixed from the time, the address space layout and a counter, so two
+ * calls never return the same seed within a process.
+ *
+ * Params:
+ *    None
+ * Returns:
+ *    The new seed.
+ */
+uint64_t hashing_seed(void);
+
+/**
+ * Mixes the 64-bit integer `x` so that every bit of the input affects every bit of the output.
+ * The mixer is a bijection, so distinct inputs never collide.
+ *
+ * Params:
+ *    x - The integer to mix.
+ * Returns:
+ *    The mixed integer.
+ */
+uint64_t hashing_mix64(uint64_t x);
+
+/**
+ * Hashes the `len` bytes starting at `data` using the seed `seed`.
+ *
+ * Params:
+ *    data - The bytes to hash.
+ *    len - The number of bytes to hash.
+ *    seed - The seed to hash with.
+ * Returns:
+ *    The 64-bit hash code of the bytes.
+ */
+uint64_t hashing_bytes(const void *data, long len, uint64_t seed);
+
+/**
+ * Hashes the NUL-terminated string `key` using the seed `seed`. Pair with
+ * hashing_compareString().
+ *
+ * Params:
+ *    key - The string (char *) to hash.
+ *    seed - The seed to hash with.
+ * Returns:
+ *    The 64-bit hash code of the string.
+ */
+uint64_t hashing_string(void *key, uint64_t seed);
+
+/**
+ * Hashes the long integer that `key` points to using the seed `seed`. Pair with
+ * hashing_compareLong().
+ *
+ * Params:
+ *    key - Pointer to the long to hash.
+ *    seed - The seed to hash with.
+ * Returns:
+ *    The 64-bit hash code of the integer.
+ */
+uint64_t hashing_long(void *key, uint64_t seed);
+
+/**
+ * Hashes the pointer `key` itself using the seed `seed`, for keys compared by identity or integers
+ * stored directly in the pointer. Pair with hashing_comparePointer().
+ *
+ * Params:
+ *    key - The pointer to hash.
+ *    seed - The seed to hash with.
+ * Returns:
+ *    The 64-bit hash code of the pointer.
+ */
+uint64_t hashing_pointer(void *key, uint64_t seed);
+
+/**
+ * Compares the NUL-terminated strings `a` and `b` the way strcmp() does.
+ *
+ * Params:
+ *    a - The first string (char *).
+ *    b - The second string (char *).
+ * Returns:
+ *    0 if the strings are equal, < 0 if `a` orders before `b`, > 0 if after.
+ */
+int hashing_compareString(void *a, void *b);
+
+/**
+ * Compares the long integers that `a` and `b` point to.
+ *
+ * Params:
+ *    a - Pointer to the first long.
+ *    b - Pointer to the second long.
+ * Returns:
+ *    0 if the integers are equal, -1 if `*a` < `*b`, 1 if `*a` > `*b`.
+ */
+int hashing_compareLong(void *a, void *b);
+
+/**
+ * Compares the pointers `a` and `b` themselves.
+ *
+ * Params:
+ *    a - The first pointer.
+ *    b - The second pointer.
+ * Returns:
+ *    0 if the pointers are equal, -1 if `a` < `b`, 1 if `a` > `b`.
+ */
+int hashing_comparePointer(void *a, void *b);
+
+#endif  /* _CDS_HASHING_H__ */
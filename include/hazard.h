@@ -0,0 +1,108 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2020 Cole Vikupitz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _CDS_HAZARD_H__
+#define _CDS_HAZARD_H__
+
+#include "cds_common.h"
+
+/**
+ * Interface for hazard pointers, the safe memory reclamation scheme behind the lock-free ADTs
+ * (LockFreeStack and LockFreeQueue).
+ *
+ * A thread that is about to dereference a node it found in a shared structure first publishes the
+ * node's address in one of its hazard slots. A node that was unlinked from the structure is
+ * retired instead of freed, and is only reclaimed once no thread's hazard slot points to it. This
+ * makes it safe to free nodes that other threads may still be reading, and rules out the ABA
+ * problem for any node a thread holds a hazard on.
+ *
+ * Every thread gets a record of HAZARD_SLOTS slots the first time it calls hazard_acquire(); the
+ * record is handed back for reuse when the thread exits, and any nodes it retired that are still
+ * in use are passed on to the other threads to reclaim.
+ */
+typedef struct hazard_record HazardRecord;
+
+// The number of hazard slots each thread has
+#define HAZARD_SLOTS 2
+
+/**
+ * Returns the calling thread's hazard record, registering one on the first call.
+ *
+ * Params:
+ *    None
+ * Returns:
+ *    The calling thread's record, or NULL if one could not be allocated.
+ */
+HazardRecord *hazard_acquire(void);
+
+/**
+ * Loads the pointer stored at `*src` and protects it in the hazard slot `slot` of `record`,
+ * retrying until the protected pointer is still the one stored at `*src`. Once this returns, the
+ * pointed-to node will not be reclaimed until the slot is cleared or reused.
+ *
+ * Params:
+ *    record - The calling thread's hazard record.
+ *    slot - The slot to protect the pointer in, from 0 to HAZARD_SLOTS - 1.
+ *    src - The shared location to load the pointer from.
+ * Returns:
+ *    The protected pointer, which may be NULL.
+ */
+void *hazard_protect(HazardRecord *record, int slot, void **src);
+
+/**
+ * Publishes the pointer `ptr` in the hazard slot `slot` of `record`. The caller is responsible for
+ * checking afterwards that `ptr` is still reachable from the shared structure.
+ *
+ * Params:
+ *    record - The calling thread's hazard record.
+ *    slot - The slot to publish the pointer in, from 0 to HAZARD_SLOTS - 1.
+ *    ptr - The pointer to publish, or NULL to clear the slot.
+ * Returns:
+ *    None
+ */
+void hazard_set(HazardRecord *record, int slot, void *ptr);
+
+/**
+ * Clears every hazard slot of `record`.
+ *
+ * Params:
+ *    record - The calling thread's hazard record.
+ * Returns:
+ *    None
+ */
+void hazard_clear(HazardRecord *record);
+
+/**
+ * Retires the node `ptr`, which must already be unreachable from its shared structure. The node is
+ * handed to `reclaim` once no thread holds a hazard on it.
+ *
+ * Params:
+ *    ptr - The node to retire.
+ *    reclaim - The function that frees the node.
+ * Returns:
+ *    None
+ */
+void hazard_retire(void *ptr, void (*reclaim)(void *));
+
+#endif  /* _CDS_HAZARD_H__ */
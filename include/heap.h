@@ -25,7 +25,9 @@
 #ifndef _CDS_HEAP_H__
 #define _CDS_HEAP_H__
 
+#include "allocator.h"
 #include "cds_common.h"
+#include "cursor.h"
 #include "iterator.h"
 
 /**
@@ -39,6 +41,13 @@
  */
 typedef struct heap Heap;
 
+/**
+ * A handle to an element inserted with heap_insertHandle(), used to update or remove the element
+ * wherever it has moved to within the heap. A handle stays valid until its element is polled or
+ * removed, or the heap is cleared; handles of removed elements are then reused.
+ */
+typedef long HeapHandle;
+
 /**
  * Constructs a new empty heap instance with the specified capacity, then stores the new instance
  * into `*heap`. If the capacity given is <= 0, a default capacity is assigned. The capacity is the
@@ -57,6 +66,80 @@ typedef struct heap Heap;
  */
 Status heap_new(Heap **heap, long capacity, int (*comparator)(void *, void *));
 
+/**
+ * Constructs a new empty heap instance the same as heap_new(), except that each node of the heap
+ * has `arity` children instead of 2. If the arity given is < 2, a binary heap is created. A wider
+ * heap is shallower, so heap_poll() visits fewer levels; the array is also aligned so that, with
+ * an arity of 8, all children of a node share a single cache line. This suits large heaps that
+ * outgrow the CPU caches, at the cost of a few more comparisons per level.
+ *
+ * Params:
+ *    heap - The pointer address to store the new Heap instance.
+ *    capacity - The heap's starting capacity.
+ *    arity - The number of children of each node.
+ *    comparator - Function for comparing two items in the heap.
+ * Returns:
+ *    OK - Heap was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status heap_newWithArity(Heap **heap, long capacity, long arity,
+                         int (*comparator)(void *, void *));
+
+/**
+ * Constructs a new empty heap instance the same as heap_newWithArity(), except that its struct,
+ * array and handle tables are allocated through `allocator`.
+ *
+ * Params:
+ *    heap - The pointer address to store the new Heap instance.
+ *    capacity - The heap's starting capacity.
+ *    arity - The number of children of each node.
+ *    comparator - Function for comparing two items in the heap.
+ *    allocator - The allocator to use, which must outlive the heap. If NULL, the default allocator
+ *                will be used.
+ * Returns:
+ *    OK - Heap was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the allocator.
+ */
+Status heap_newWithAllocator(Heap **heap, long capacity, long arity,
+                             int (*comparator)(void *, void *), const CdsAllocator *allocator);
+
+/**
+ * Constructs a new heap instance holding the `n` elements of `items`, then stores the new instance
+ * into `*heap`. The array is sized for the elements once, and they are heapified in place in O(n)
+ * time, rather than being inserted one at a time. The array `items` is not kept by the heap.
+ *
+ * Params:
+ *    heap - The pointer address to store the new Heap instance.
+ *    items - The elements to add.
+ *    n - The number of elements in `items`.
+ *    comparator - Function for comparing two items in the heap.
+ * Returns:
+ *    OK - Heap was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status heap_fromArray(Heap **heap, void **items, long n, int (*comparator)(void *, void *));
+
+/**
+ * Sets the growth factor of the heap, that is, the percentage of its capacity to add whenever it
+ * becomes full. The percentage is expressed as a float in the range (0.0, 1.0], as with the string
+ * builder's growth factor; the default of 1.0 doubles the capacity. A smaller factor wastes less
+ * memory on a very large heap, at the cost of resizing it more often. If the factor given is
+ * outside of that range, the default factor is assigned.
+ *
+ * Whatever the factor, the heap is always grown enough for the elements being added, and never past
+ * the largest array that can be addressed. Arrays of 2MB or more are rounded up to whole 2MB pages;
+ * if the library is compiled with CDS_HUGE_PAGES defined, the kernel is also asked to back them
+ * with transparent huge pages (with madvise()). A heap created with the allocator from
+ * allocator_largePages() gets huge pages without that flag, and grows without being copied.
+ *
+ * Params:
+ *    heap - The heap to operate on.
+ *    growthFactor - The percentage to increase the capacity when resizing is needed.
+ * Returns:
+ *    None
+ */
+void heap_setGrowthFactor(Heap *heap, float growthFactor);
+
 /**
  * Inserts the specified element into the heap.
  *
@@ -69,6 +152,38 @@ Status heap_new(Heap **heap, long capacity, int (*comparator)(void *, void *));
  */
 Status heap_insert(Heap *heap, void *item);
 
+/**
+ * Inserts the `n` elements of `items` into the heap. The capacity is grown at most once for the
+ * whole batch, and a batch large enough relative to the heap rebuilds it in linear time instead of
+ * inserting each element on its own. If the allocation fails, the heap is left unchanged.
+ *
+ * Params:
+ *    heap - The heap to operate on.
+ *    items - The elements to add.
+ *    n - The number of elements in `items`.
+ * Returns:
+ *    OK - Operation was successful.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status heap_insertAll(Heap *heap, void **items, long n);
+
+/**
+ * Moves every element of the heap `src` into the heap `dst`, leaving `src` empty. The elements are
+ * added as a batch, the same as heap_insertAll(): `dst` grows at most once, and when `src` is large
+ * relative to `dst` the two are combined by rebuilding `dst` in linear time, rather than polling
+ * each element from one heap and inserting it into the other. Both heaps should order their
+ * elements with the same comparator. Any handles into `src` are released; handles into `dst` stay
+ * valid. If the allocation fails, both heaps are left unchanged.
+ *
+ * Params:
+ *    dst - The heap to add the elements to.
+ *    src - The heap to take the elements from.
+ * Returns:
+ *    OK - Operation was successful.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status heap_merge(Heap *dst, Heap *src);
+
 /**
  * Retrieves, but does not remove, the top of heap, and stores the element into `*min`.
  *
@@ -93,6 +208,51 @@ Status heap_peek(Heap *heap, void **min);
  */
 Status heap_poll(Heap *heap, void **min);
 
+/**
+ * Inserts the specified element into the heap, the same as heap_insert(), and stores a handle to it
+ * into `*handle`. The heap tracks the position of every handled element as it moves, so it can be
+ * updated with heap_update() or removed with heap_removeHandle() in O(log n), instead of being
+ * inserted again as a duplicate.
+ *
+ * Params:
+ *    heap - The heap to operate on.
+ *    item - The element to add.
+ *    handle - The pointer address to store the element's handle into.
+ * Returns:
+ *    OK - Operation was successful.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status heap_insertHandle(Heap *heap, void *item, HeapHandle *handle);
+
+/**
+ * Replaces the element with the handle `handle` by `item`, then moves it up or down to where its
+ * priority now belongs. To re-prioritize an element that was changed in place, pass the same
+ * element as `item`; the element must not be changed while it is in the heap otherwise.
+ *
+ * Params:
+ *    heap - The heap to operate on.
+ *    handle - The handle of the element to update.
+ *    item - The element to store under the handle.
+ * Returns:
+ *    OK - Operation was successful.
+ *    NOT_FOUND - The handle does not belong to an element in the heap.
+ */
+Status heap_update(Heap *heap, HeapHandle handle, void *item);
+
+/**
+ * Removes the element with the handle `handle` from the heap, wherever it is, and stores it into
+ * `*item`. The handle is then released.
+ *
+ * Params:
+ *    heap - The heap to operate on.
+ *    handle - The handle of the element to remove.
+ *    item - The pointer address to store the removed element into.
+ * Returns:
+ *    OK - Operation was successful.
+ *    NOT_FOUND - The handle does not belong to an element in the heap.
+ */
+Status heap_removeHandle(Heap *heap, HeapHandle handle, void **item);
+
 /**
  * Removes all elements from the heap. If `destructor` is not NULL, it will be invoked on each
  * element in the heap after being removed.
@@ -155,6 +315,56 @@ Status heap_toArray(Heap *heap, Array **array);
  */
 Status heap_iterator(Heap *heap, Iterator **iter);
 
+/**
+ * Initializes `cursor` to walk over the heap's elements in no particular order, without copying
+ * them. The elements are then fetched with heap_cursorNext(); see cursor.h for details.
+ *
+ * Params:
+ *    heap - The heap to operate on.
+ *    cursor - The cursor to initialize.
+ * Returns:
+ *    None
+ */
+void heap_cursor(Heap *heap, Cursor *cursor);
+
+/**
+ * Advances the cursor to the next element of the heap, and stores it into `*next`.
+ *
+ * Params:
+ *    cursor - The cursor to operate on.
+ *    next - The pointer address to store the next element into.
+ * Returns:
+ *    OK - Next element was returned.
+ *    ITER_END - The cursor has already visited every element.
+ *    CONCURRENT_MODIFICATION - The heap was modified after creating the cursor.
+ */
+Status heap_cursorNext(Cursor *cursor, void **next);
+
+/**
+ * Applies `action` to each element of the heap in no particular order, passing it the element and
+ * `context`. The walk stops as soon as `action` returns FALSE. Nothing is copied or allocated, and
+ * `action` must not modify the heap while it is walked.
+ *
+ * Params:
+ *    heap - The heap to operate on.
+ *    action - Function applied to each element, returning FALSE to stop the walk.
+ *    context - Argument passed along to each call of `action`, may be NULL.
+ * Returns:
+ *    TRUE if `action` was applied to every element, FALSE if it stopped the walk early.
+ */
+Boolean heap_forEach(Heap *heap, Boolean (*action)(void *, void *), void *context);
+
+/**
+ * Returns the number of bytes of memory held by the heap: the heap itself, its array and the
+ * tables backing any handles, not counting the elements themselves.
+ *
+ * Params:
+ *    heap - The heap to operate on.
+ * Returns:
+ *    The heap's memory usage, in bytes.
+ */
+long heap_memoryUsage(Heap *heap);
+
 /**
  * Destroys the heap instance by freeing all of its reserved memory. If `destructor` is not NULL, it
  * will be invoked on each element before the heap is destroyed.
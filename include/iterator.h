@@ -26,6 +26,7 @@
 #define _CDS_ITERATOR_H__
 
 #include "cds_common.h"
+#include "cursor.h"
 
 /**
  * Interface for the Iterator ADT.
@@ -38,6 +39,25 @@
  * items contained in the iterator represent the structure's current state. Any changes made to the
  * structure after creating the iterator will not be reflected.
  *
+ * Iterators may also be lazy: iterator_fromCursor() walks a live structure through its cursor, and
+ * the adaptors iterator_filter(), iterator_map(), iterator_limit() and iterator_concat() wrap other
+ * iterators, fetching each element from their source only when it is asked for. Adaptors can be
+ * chained into a pipeline, such as taking the first 100 values of a hash map that match a
+ * predicate, without copying the structure or any intermediate results:
+ *
+ *    Iterator *iter, *matches, *top;
+ *    hashmap_cursor(map, &cursor);
+ *    iterator_fromCursor(&iter, &cursor, hashmap_cursorNext);
+ *    iterator_filter(&matches, iter, predicate, context);
+ *    iterator_limit(&top, matches, 100L);
+ *    while (iterator_next(top, &item) == OK) {
+ *        ...
+ *    }
+ *    iterator_destroy(top);
+ *
+ * An adaptor takes ownership of the iterators it wraps, and destroys them along with itself; if
+ * creating the adaptor fails, they are left to the caller.
+ *
  * Modeled after the Java 7 Iterator interface.
  */
 typedef struct iterator Iterator;
@@ -57,7 +77,89 @@ typedef struct iterator Iterator;
 Status iterator_new(Iterator **iter, void **items, long len);
 
 /**
- * Returns TRUE if the iteration has more elements, FALSE if not.
+ * Creates a new lazy iterator walking a structure through `cursor`, then assigns the new iterator
+ * instance to `*iter`. Each element is fetched with `cursorNext`, which must be the cursorNext()
+ * method of the structure the cursor was created for (such as arraylist_cursorNext()). The cursor
+ * is copied into the iterator. Like the cursor, the iterator is fail-fast: once the structure is
+ * modified, iterator_next() returns CONCURRENT_MODIFICATION.
+ *
+ * Params:
+ *    iter - The pointer address to store the new Iterator into.
+ *    cursor - The cursor to walk the structure with.
+ *    cursorNext - Function to advance the cursor with.
+ * Returns:
+ *    OK - Iterator was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status iterator_fromCursor(Iterator **iter, Cursor *cursor,
+                           Status (*cursorNext)(Cursor *, void **));
+
+/**
+ * Creates a new lazy iterator over the elements of `source` for which `predicate` returns TRUE,
+ * then assigns the new iterator instance to `*iter`. The predicate is invoked with each element
+ * and `context`, as the elements are fetched.
+ *
+ * Params:
+ *    iter - The pointer address to store the new Iterator into.
+ *    source - The iterator to take the elements from.
+ *    predicate - Function deciding whether to keep an element.
+ *    context - The context to invoke `predicate` with.
+ * Returns:
+ *    OK - Iterator was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status iterator_filter(Iterator **iter, Iterator *source, Boolean (*predicate)(void *, void *),
+                       void *context);
+
+/**
+ * Creates a new lazy iterator over the results of `mapper` applied to each element of `source`,
+ * then assigns the new iterator instance to `*iter`. The mapper is invoked with each element and
+ * `context`, as the elements are fetched.
+ *
+ * Params:
+ *    iter - The pointer address to store the new Iterator into.
+ *    source - The iterator to take the elements from.
+ *    mapper - Function transforming an element.
+ *    context - The context to invoke `mapper` with.
+ * Returns:
+ *    OK - Iterator was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status iterator_map(Iterator **iter, Iterator *source, void *(*mapper)(void *, void *),
+                    void *context);
+
+/**
+ * Creates a new lazy iterator over at most the first `max` elements of `source`, then assigns the
+ * new iterator instance to `*iter`. No element past the first `max` is ever fetched from `source`.
+ *
+ * Params:
+ *    iter - The pointer address to store the new Iterator into.
+ *    source - The iterator to take the elements from.
+ *    max - The largest number of elements to take.
+ * Returns:
+ *    OK - Iterator was successfully created.
+ *    INVALID_INDEX - `max` is negative.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status iterator_limit(Iterator **iter, Iterator *source, long max);
+
+/**
+ * Creates a new lazy iterator over the elements of `first` followed by the elements of `second`,
+ * then assigns the new iterator instance to `*iter`.
+ *
+ * Params:
+ *    iter - The pointer address to store the new Iterator into.
+ *    first - The iterator to take the elements from first.
+ *    second - The iterator to take the elements from once `first` is exhausted.
+ * Returns:
+ *    OK - Iterator was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status iterator_concat(Iterator **iter, Iterator *first, Iterator *second);
+
+/**
+ * Returns TRUE if the iteration has more elements, FALSE if not. A lazy iterator fetches its next
+ * element ahead to find out; if that fails, FALSE is returned and iterator_next() reports why.
  *
  * Params:
  *    iter - The iterator to operate on.
@@ -75,9 +177,39 @@ Boolean iterator_hasNext(Iterator *iter);
  * Returns:
  *    OK - Next iteration item was returned.
  *    ITER_END - The current iteration has already ended.
+ *    CONCURRENT_MODIFICATION - The structure walked by a cursor was modified since its creation.
  */
 Status iterator_next(Iterator *iter, void **next);
 
+/**
+ * Returns the number of elements the iterator has yet to return. For a lazy iterator, this is at
+ * most the number of elements its sources have left, as elements filtered out or behind a range
+ * cursor's end are not known until they are fetched.
+ *
+ * Params:
+ *    iter - The iterator to operate on.
+ * Returns:
+ *    The number of remaining elements.
+ */
+long iterator_remaining(Iterator *iter);
+
+/**
+ * Splits the elements the iterator has yet to return into two disjoint halves: the first half is
+ * handed over to a new iterator, stored into `*prefix`, while `iter` keeps the second half. The
+ * halves share the iterator's snapshot rather than copying it, so splitting is cheap, and either
+ * half may be split again. Each half may then be walked and destroyed on a different thread; the
+ * snapshot is freed once every iterator sharing it has been destroyed.
+ *
+ * Params:
+ *    iter - The iterator to operate on.
+ *    prefix - The pointer address to store the iterator over the first half into.
+ * Returns:
+ *    OK - Iterator was successfully split.
+ *    ITER_END - Fewer than two elements remain, or the iterator is lazy, so it was not split.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status iterator_trySplit(Iterator *iter, Iterator **prefix);
+
 /**
  * Destroys the iterator instance by freeing all of its reserved memory.
  *
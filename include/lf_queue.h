@@ -0,0 +1,118 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2020 Cole Vikupitz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _CDS_LF_QUEUE_H__
+#define _CDS_LF_QUEUE_H__
+
+#include "cds_common.h"
+
+/**
+ * Interface for the lock-free Queue ADT.
+ *
+ * The LockFreeQueue class represents an unbounded first-in-first-out (FIFO) queue of objects that
+ * may be shared by any number of threads without taking a lock (a Michael-Scott queue). Producers
+ * only contend on the tail and consumers only on the head, which are kept on separate cache lines;
+ * a thread that is preempted midway through an add is helped along by the others. Polled nodes are
+ * reclaimed through hazard pointers (see hazard.h).
+ *
+ * Unlike the ConcurrentQueue, the queue cannot be locked, iterated over or measured, since those
+ * operations would need a consistent view of every element at once.
+ */
+typedef struct lf_queue LockFreeQueue;
+
+/**
+ * Creates a new queue instance, then stores the new instance into `*queue`.
+ *
+ * Params:
+ *    queue - The pointer address to store the new LockFreeQueue instance.
+ * Returns:
+ *    OK - Queue was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status lf_queue_new(LockFreeQueue **queue);
+
+/**
+ * Inserts the specified element into the back of the queue.
+ *
+ * Params:
+ *    queue - The queue to operate on.
+ *    item - The item to be inserted into the queue.
+ * Returns:
+ *    OK - Operation was successful.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status lf_queue_add(LockFreeQueue *queue, void *item);
+
+/**
+ * Retrieves, but does not remove, the first element from the queue and stores the result into
+ * `*first`.
+ *
+ * Params:
+ *    queue - The queue to operate on.
+ *    first - The pointer address to store the first element into.
+ * Returns:
+ *    OK - Operation was successful.
+ *    STRUCT_EMPTY - Queue is currently empty.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status lf_queue_peek(LockFreeQueue *queue, void **first);
+
+/**
+ * Removes the first element from the queue and stores the result into `*first`.
+ *
+ * Params:
+ *    queue - The queue to operate on.
+ *    first - The pointer address to store the removed first element into.
+ * Returns:
+ *    OK - Operation was successful.
+ *    STRUCT_EMPTY - Queue is currently empty.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status lf_queue_poll(LockFreeQueue *queue, void **first);
+
+/**
+ * Returns TRUE if the queue is currently empty, FALSE if not. While other threads are adding or
+ * polling, the result is only a snapshot that may already be out of date.
+ *
+ * Params:
+ *    queue - The queue to operate on.
+ * Returns:
+ *    TRUE if the queue is empty, FALSE if not.
+ */
+Boolean lf_queue_isEmpty(LockFreeQueue *queue);
+
+/**
+ * Destroys the queue instance by freeing all of its reserved memory. If `destructor` is not NULL,
+ * it will be invoked on each element before the queue is destroyed. Must only be called once no
+ * other thread uses the queue.
+ *
+ * Params:
+ *    queue - The queue to destroy.
+ *    destructor - Function to operate on each element prior to queue destruction.
+ * Returns:
+ *    None
+ */
+void lf_queue_destroy(LockFreeQueue *queue, void (*destructor)(void *));
+
+#endif  /* _CDS_LF_QUEUE_H__ */
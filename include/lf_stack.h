@@ -0,0 +1,117 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2020 Cole Vikupitz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _CDS_LF_STACK_H__
+#define _CDS_LF_STACK_H__
+
+#include "cds_common.h"
+
+/**
+ * Interface for the lock-free Stack ADT.
+ *
+ * The LockFreeStack class represents an unbounded last-in-first-out (LIFO) stack of objects that
+ * may be shared by any number of threads without taking a lock (a Treiber stack). Every push and
+ * pop swings the top of the stack with a single compare-and-swap, so a thread that is preempted
+ * never holds up the others. Popped nodes are reclaimed through hazard pointers (see hazard.h).
+ *
+ * Unlike the ConcurrentStack, the stack cannot be locked, iterated over or measured, since those
+ * operations would need a consistent view of every element at once.
+ */
+typedef struct lf_stack LockFreeStack;
+
+/**
+ * Creates a new stack instance, then stores the new instance into `*stack`.
+ *
+ * Params:
+ *    stack - The pointer address to store the new LockFreeStack instance.
+ * Returns:
+ *    OK - Stack was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status lf_stack_new(LockFreeStack **stack);
+
+/**
+ * Pushes the specified item onto the top of the stack.
+ *
+ * Params:
+ *    stack - The stack to operate on.
+ *    item - The item to push onto the stack.
+ * Returns:
+ *    OK - Operation was successful.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status lf_stack_push(LockFreeStack *stack, void *item);
+
+/**
+ * Retrieves, but does not remove, the top element of the stack, and stores the result into
+ * `*top`.
+ *
+ * Params:
+ *    stack - The stack to operate on.
+ *    top - The pointer address to store the top element into.
+ * Returns:
+ *    OK - Operation was successful.
+ *    STRUCT_EMPTY - Stack is currently empty.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status lf_stack_peek(LockFreeStack *stack, void **top);
+
+/**
+ * Removes the top element of the stack, and stores the result into `*top`.
+ *
+ * Params:
+ *    stack - The stack to operate on.
+ *    top - The pointer address to store the removed element into.
+ * Returns:
+ *    OK - Operation was successful.
+ *    STRUCT_EMPTY - Stack is currently empty.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status lf_stack_pop(LockFreeStack *stack, void **top);
+
+/**
+ * Returns TRUE if the stack is currently empty, FALSE if not. While other threads are pushing or
+ * popping, the result is only a snapshot that may already be out of date.
+ *
+ * Params:
+ *    stack - The stack to operate on.
+ * Returns:
+ *    TRUE if the stack is empty, FALSE if not.
+ */
+Boolean lf_stack_isEmpty(LockFreeStack *stack);
+
+/**
+ * Destroys the stack instance by freeing all of its reserved memory. If `destructor` is not NULL,
+ * it will be invoked on each element before the stack is destroyed. Must only be called once no
+ * other thread uses the stack.
+ *
+ * Params:
+ *    stack - The stack to destroy.
+ *    destructor - Function to operate on each element prior to stack destruction.
+ * Returns:
+ *    None
+ */
+void lf_stack_destroy(LockFreeStack *stack, void (*destructor)(void *));
+
+#endif  /* _CDS_LF_STACK_H__ */
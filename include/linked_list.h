@@ -26,6 +26,8 @@
 #define _CDS_LINKEDLIST_H__
 
 #include "cds_common.h"
+#include "cursor.h"
+#include "node_pool.h"
 #include "iterator.h"
 
 /**
@@ -49,6 +51,65 @@ typedef struct linkedlist LinkedList;
  */
 Status linkedlist_new(LinkedList **list);
 
+/**
+ * Creates a new linked list instance whose nodes are allocated from `pool`, then stores the new instance
+ * into `*list`. The pool may be shared with other ADTs and must outlive the linked list; nodes are
+ * returned to it as elements are removed. If `pool` is NULL, a private pool is used instead, the
+ * same as linkedlist_new().
+ *
+ * Params:
+ *    list - The pointer address to store the new LinkedList instance.
+ *    pool - The pool to allocate the nodes from, or NULL.
+ * Returns:
+ *    OK - LinkedList was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status linkedlist_newWithPool(LinkedList **list, NodePool *pool);
+
+/**
+ * Creates a new linked list instance whose struct and nodes are allocated through `allocator`, then
+ * stores the new instance into `*list`. The nodes come from a private pool backed by the allocator.
+ *
+ * Params:
+ *    list - The pointer address to store the new LinkedList instance.
+ *    allocator - The allocator to use, which must outlive the linked list. If NULL, the default
+ *                allocator will be used.
+ * Returns:
+ *    OK - LinkedList was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the allocator.
+ */
+Status linkedlist_newWithAllocator(LinkedList **list, const CdsAllocator *allocator);
+
+/**
+ * Creates a new unrolled linked list instance, then stores the new instance into `*list`. Instead of
+ * one node per element, the elements are stored in chunks of up to 32, which cuts the memory used
+ * per element from a whole node to little more than a pointer. Indexed operations such as get(),
+ * set(), insert() and remove() skip over a whole chunk per step, and traversals walk contiguous
+ * memory. Adding or removing at either end remains O(1).
+ *
+ * Params:
+ *    list - The pointer address to store the new LinkedList instance.
+ * Returns:
+ *    OK - LinkedList was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status linkedlist_newUnrolled(LinkedList **list);
+
+/**
+ * Creates a new intrusive linked list instance, then stores the new instance into `*list`. An
+ * intrusive list allocates no nodes: the caller embeds a ListLink in each of its own structs and
+ * links it in with linkedlist_linkFirst(), linkedlist_linkLast() or linkedlist_linkAfter(), and
+ * the link is simply unlinked again once its element is removed. The allocating add and insert
+ * operations, and the handle-returning ones, must not be used on an intrusive list.
+ *
+ * Params:
+ *    list - The pointer address to store the new LinkedList instance.
+ * Returns:
+ *    OK - LinkedList was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status linkedlist_newIntrusive(LinkedList **list);
+
 /**
  * Inserts the specified element at the beginning of the linked list.
  *
@@ -193,6 +254,170 @@ Status linkedlist_removeLast(LinkedList *list, void **last);
  */
 Status linkedlist_remove(LinkedList *list, long i, void **item);
 
+/**
+ * Inserts the specified element at the beginning of the linked list, and stores the link holding
+ * it into `*handle`, if `handle` is not NULL. The handle stays valid until the element is removed.
+ * Handles are not supported by unrolled lists.
+ *
+ * Params:
+ *    list - The linked list to operate on.
+ *    item - The element to insert.
+ *    handle - The pointer address to store the element's link into, may be NULL.
+ * Returns:
+ *    OK - Operation was successful.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status linkedlist_addFirstHandle(LinkedList *list, void *item, ListLink **handle);
+
+/**
+ * Inserts the specified element at the end of the linked list, and stores the link holding it into
+ * `*handle`, if `handle` is not NULL. The handle stays valid until the element is removed. Handles
+ * are not supported by unrolled lists.
+ *
+ * Params:
+ *    list - The linked list to operate on.
+ *    item - The element to insert.
+ *    handle - The pointer address to store the element's link into, may be NULL.
+ * Returns:
+ *    OK - Operation was successful.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status linkedlist_addLastHandle(LinkedList *list, void *item, ListLink **handle);
+
+/**
+ * Inserts the specified element right after the element held by `handle`, in constant time, and
+ * stores the link holding the new element into `*inserted`, if `inserted` is not NULL.
+ *
+ * Params:
+ *    list - The linked list to operate on.
+ *    handle - The link of the element to insert after, which must be in the list.
+ *    item - The element to insert.
+ *    inserted - The pointer address to store the new element's link into, may be NULL.
+ * Returns:
+ *    OK - Operation was successful.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status linkedlist_insertAfter(LinkedList *list, ListLink *handle, void *item, ListLink **inserted);
+
+/**
+ * Removes the element held by `handle` from the linked list in constant time, and returns it. The
+ * handle is no longer valid afterwards, unless the list is intrusive, in which case the caller's
+ * link may be linked in again.
+ *
+ * Params:
+ *    list - The linked list to operate on.
+ *    handle - The link of the element to remove, which must be in the list.
+ * Returns:
+ *    The removed element.
+ */
+void *linkedlist_removeHandle(LinkedList *list, ListLink *handle);
+
+/**
+ * Moves the element held by `handle` to the beginning of the linked list in constant time.
+ *
+ * Params:
+ *    list - The linked list to operate on.
+ *    handle - The link of the element to move, which must be in the list.
+ * Returns:
+ *    None
+ */
+void linkedlist_moveToFront(LinkedList *list, ListLink *handle);
+
+/**
+ * Moves the element held by `handle` to the end of the linked list in constant time.
+ *
+ * Params:
+ *    list - The linked list to operate on.
+ *    handle - The link of the element to move, which must be in the list.
+ * Returns:
+ *    None
+ */
+void linkedlist_moveToBack(LinkedList *list, ListLink *handle);
+
+/**
+ * Returns the link holding the first element of the linked list, NULL if the list is empty.
+ *
+ * Params:
+ *    list - The linked list to operate on.
+ * Returns:
+ *    The first element's link, or NULL.
+ */
+ListLink *linkedlist_firstHandle(LinkedList *list);
+
+/**
+ * Returns the link holding the last element of the linked list, NULL if the list is empty.
+ *
+ * Params:
+ *    list - The linked list to operate on.
+ * Returns:
+ *    The last element's link, or NULL.
+ */
+ListLink *linkedlist_lastHandle(LinkedList *list);
+
+/**
+ * Returns the link holding the element after the one held by `handle`, NULL if `handle` holds the
+ * last element.
+ *
+ * Params:
+ *    list - The linked list to operate on.
+ *    handle - A link in the list.
+ * Returns:
+ *    The next element's link, or NULL.
+ */
+ListLink *linkedlist_nextHandle(LinkedList *list, ListLink *handle);
+
+/**
+ * Returns the link holding the element before the one held by `handle`, NULL if `handle` holds the
+ * first element.
+ *
+ * Params:
+ *    list - The linked list to operate on.
+ *    handle - A link in the list.
+ * Returns:
+ *    The previous element's link, or NULL.
+ */
+ListLink *linkedlist_prevHandle(LinkedList *list, ListLink *handle);
+
+/**
+ * Links the caller's link `link` into the beginning of an intrusive linked list, holding `item`.
+ * The link must not be in any list already.
+ *
+ * Params:
+ *    list - The intrusive linked list to operate on.
+ *    link - The link to insert, usually embedded in the struct `item` points to.
+ *    item - The element the link is to hold.
+ * Returns:
+ *    None
+ */
+void linkedlist_linkFirst(LinkedList *list, ListLink *link, void *item);
+
+/**
+ * Links the caller's link `link` into the end of an intrusive linked list, holding `item`. The
+ * link must not be in any list already.
+ *
+ * Params:
+ *    list - The intrusive linked list to operate on.
+ *    link - The link to insert, usually embedded in the struct `item` points to.
+ *    item - The element the link is to hold.
+ * Returns:
+ *    None
+ */
+void linkedlist_linkLast(LinkedList *list, ListLink *link, void *item);
+
+/**
+ * Links the caller's link `link` into an intrusive linked list right after the link `position`,
+ * holding `item`. The link must not be in any list already.
+ *
+ * Params:
+ *    list - The intrusive linked list to operate on.
+ *    position - The link to insert after, which must be in the list.
+ *    link - The link to insert, usually embedded in the struct `item` points to.
+ *    item - The element the link is to hold.
+ * Returns:
+ *    None
+ */
+void linkedlist_linkAfter(LinkedList *list, ListLink *position, ListLink *link, void *item);
+
 /**
  * Removes all elements from the linked list. If `destructor` is not NULL, it will be invoked on
  * each element in the linked list after being removed.
@@ -255,6 +480,56 @@ Status linkedlist_toArray(LinkedList *list, Array **array);
  */
 Status linkedlist_iterator(LinkedList *list, Iterator **iter);
 
+/**
+ * Initializes `cursor` to walk over the linked list's elements from first to last, without copying
+ * them. The elements are then fetched with linkedlist_cursorNext(); see cursor.h for details.
+ *
+ * Params:
+ *    list - The linked list to operate on.
+ *    cursor - The cursor to initialize.
+ * Returns:
+ *    None
+ */
+void linkedlist_cursor(LinkedList *list, Cursor *cursor);
+
+/**
+ * Advances the cursor to the next element of the linked list, and stores it into `*next`.
+ *
+ * Params:
+ *    cursor - The cursor to operate on.
+ *    next - The pointer address to store the next element into.
+ * Returns:
+ *    OK - Next element was returned.
+ *    ITER_END - The cursor has already visited every element.
+ *    CONCURRENT_MODIFICATION - The linked list was modified after creating the cursor.
+ */
+Status linkedlist_cursorNext(Cursor *cursor, void **next);
+
+/**
+ * Applies `action` to each element of the linked list from first to last, passing it the element
+ * and `context`. The walk stops as soon as `action` returns FALSE. Nothing is copied or allocated,
+ * and `action` must not modify the linked list while it is walked.
+ *
+ * Params:
+ *    list - The linked list to operate on.
+ *    action - Function applied to each element, returning FALSE to stop the walk.
+ *    context - Argument passed along to each call of `action`, may be NULL.
+ * Returns:
+ *    TRUE if `action` was applied to every element, FALSE if it stopped the walk early.
+ */
+Boolean linkedlist_forEach(LinkedList *list, Boolean (*action)(void *, void *), void *context);
+
+/**
+ * Returns the number of bytes of memory held by the linked list: the list itself and its nodes or
+ * chunks, not counting the elements themselves.
+ *
+ * Params:
+ *    list - The linked list to operate on.
+ * Returns:
+ *    The linked list's memory usage, in bytes.
+ */
+long linkedlist_memoryUsage(LinkedList *list);
+
 /**
  * Destroys the linked list instance by freeing all of its reserved memory. If `destructor` is not
  * NULL, it will be invoked on each element before the linked list is destroyed.
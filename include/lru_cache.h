@@ -0,0 +1,273 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2020 Cole Vikupitz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef _CDS_LRU_CACHE_H__
+#define _CDS_LRU_CACHE_H__
+
+#include <stdint.h>
+#include "cds_common.h"
+
+/**
+ * Interface for the LruCache ADT.
+ *
+ * The LruCache class represents a bounded map that evicts its least recently used entries to make
+ * room for new ones. Each entry is linked both into a chain of the hash table and into the
+ * recency list, so a lookup moves its entry to the front of the list, and an eviction unlinks the
+ * entry at the back, in constant time without searching the list.
+ *
+ * The cache is bounded by a number of entries, a total charge (such as a byte budget, where each
+ * entry is charged its size when put), or both. Entries evicted to stay within the bounds are
+ * handed to an eviction listener, if one is set, before their key is destroyed.
+ *
+ * Optionally, new keys may be admitted by frequency (as in TinyLFU): the cache then counts how
+ * often every key is requested, hits or misses, in a compact sketch of 4-bit counters that are
+ * halved periodically so that old popularity fades. Once the cache is full, a new key is only
+ * admitted if it has been requested more often than the entry it would evict, which keeps a burst
+ * of one-off keys from flushing out the entries that are requested over and over.
+ *
+ * Keys are hashed with a seeded, full-width hash function, the same convention as
+ * hashset_newSeeded(), so the built-in functions from hashing.h can be used directly.
+ */
+typedef struct lru_cache LruCache;
+
+/**
+ * A structure reporting how well the cache has served its lookups, filled in by lrucache_stats().
+ */
+typedef struct {
+    long hits;              // Number of lookups that found their key
+    long misses;            // Number of lookups that did not
+    long evictions;         // Number of entries evicted to stay within the bounds
+    long rejections;        // Number of new entries turned away by frequency admission
+} CacheStats;
+
+/**
+ * Creates a new, empty cache holding at most `capacity` entries, then stores the new instance into
+ * `*cache`. If the capacity specified is <= 0, the number of entries is unbounded, and the cache
+ * should be bounded by a charge with lrucache_setChargeLimit() instead.
+ *
+ * The key destructor function should be a function that performs any de-allocation needed on the
+ * cache's keys (if applicable). This function will be invoked on the entry's key once it is
+ * evicted or removed, or the cache is cleared or destroyed. If no de-allocation or destructor for
+ * the custom keys is required, you may pass NULL as this parameter.
+ *
+ * Params:
+ *    cache - The pointer address to store the new LruCache instance.
+ *    hash - The seeded hashing function for computing the keys' hash codes.
+ *    keyComparator - Function for comparing two keys in the cache.
+ *    capacity - The largest number of entries the cache holds.
+ *    keyDestructor - Function for de-allocating the cache's keys.
+ * Returns:
+ *    OK - LruCache was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status lrucache_new(LruCache **cache, uint64_t (*hash)(void *, uint64_t),
+                    int (*keyComparator)(void *, void *), long capacity,
+                    void (*keyDestructor)(void *));
+
+/**
+ * Bounds the total charge of the cache's entries to `limit`, evicting the least recently used
+ * entries right away if the entries already exceed it. If the limit specified is <= 0, the total
+ * charge is unbounded, which is the default.
+ *
+ * Params:
+ *    cache - The cache to operate on.
+ *    limit - The largest total charge of the cache's entries.
+ * Returns:
+ *    None
+ */
+void lrucache_setChargeLimit(LruCache *cache, long limit);
+
+/**
+ * Sets the function invoked on every entry evicted to stay within the cache's bounds, passing it
+ * the entry's key, its value and `context`, before the key is destroyed. The listener takes over
+ * the value. Entries removed, replaced, cleared or destroyed are not passed to the listener.
+ *
+ * Params:
+ *    cache - The cache to operate on.
+ *    listener - Function invoked on each evicted entry, or NULL for none.
+ *    context - Argument passed along to each call of `listener`, may be NULL.
+ * Returns:
+ *    None
+ */
+void lrucache_setEvictionListener(LruCache *cache, void (*listener)(void *, void *, void *),
+                                  void *context);
+
+/**
+ * Turns frequency admission on or off. While on, a new key that would need an entry evicted is
+ * only admitted if it has been requested more often than that entry.
+ *
+ * Params:
+ *    cache - The cache to operate on.
+ *    enabled - TRUE to admit new keys by frequency, FALSE to admit every key.
+ * Returns:
+ *    OK - Operation was successful.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status lrucache_setFrequencyAdmission(LruCache *cache, Boolean enabled);
+
+/**
+ * Associates `value` with `key` in the cache, charging the entry `charge` towards the charge
+ * limit, and makes it the most recently used entry. If the cache previously contained a mapping
+ * for the key, the old value is replaced and stored into `*previous`, and the key passed in is
+ * left to the caller. Least recently used entries are then evicted as needed to stay within the
+ * bounds.
+ *
+ * Params:
+ *    cache - The cache to operate on.
+ *    key - The key with which the specified value is to be associated.
+ *    value - The value to be associated with the specified key.
+ *    charge - The entry's charge towards the charge limit, such as its size in bytes.
+ *    previous - The pointer address to store the previous value into.
+ * Returns:
+ *    INSERTED - Entry was inserted.
+ *    REPLACED - Entry was updated in the cache, and the old value was stored into `*previous`.
+ *    STRUCT_FULL - Entry was not inserted, as its charge alone exceeds the charge limit, or it was
+ *                  turned away by frequency admission; the key and value are left to the caller.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status lrucache_put(LruCache *cache, void *key, void *value, long charge, void **previous);
+
+/**
+ * Fetches the value to which the specified key is mapped, stores the result into `*value`, and
+ * makes the entry the most recently used one.
+ *
+ * Params:
+ *    cache - The cache to operate on.
+ *    key - The key whose associated value is to be returned.
+ *    value - The pointer address to store the fetched value into.
+ * Returns:
+ *    OK - Operation was successful.
+ *    NOT_FOUND - Entry with the specified key was not found.
+ */
+Status lrucache_get(LruCache *cache, void *key, void **value);
+
+/**
+ * Fetches the value to which the specified key is mapped and stores the result into `*value`,
+ * without making the entry more recently used or counting the lookup.
+ *
+ * Params:
+ *    cache - The cache to operate on.
+ *    key - The key whose associated value is to be returned.
+ *    value - The pointer address to store the fetched value into.
+ * Returns:
+ *    OK - Operation was successful.
+ *    NOT_FOUND - Entry with the specified key was not found.
+ */
+Status lrucache_peek(LruCache *cache, void *key, void **value);
+
+/**
+ * Returns TRUE if the cache contains a mapping for the specified key, FALSE if otherwise, without
+ * making the entry more recently used.
+ *
+ * Params:
+ *    cache - The cache to operate on.
+ *    key - The key to search for.
+ * Returns:
+ *    TRUE if a mapping exists with the key, FALSE if not.
+ */
+Boolean lrucache_containsKey(LruCache *cache, void *key);
+
+/**
+ * Removes the mapping for the specified key from the cache if present, and stores its value into
+ * `*value`.
+ *
+ * Params:
+ *    cache - The cache to operate on.
+ *    key - The key whose mapping is to be removed from the cache.
+ *    value - The pointer address to store the removed value into.
+ * Returns:
+ *    OK - Operation was successful.
+ *    NOT_FOUND - Entry with the specified key was not found.
+ */
+Status lrucache_remove(LruCache *cache, void *key, void **value);
+
+/**
+ * Returns the number of entries in the cache.
+ *
+ * Params:
+ *    cache - The cache to operate on.
+ * Returns:
+ *    The cache's size.
+ */
+long lrucache_size(LruCache *cache);
+
+/**
+ * Returns the total charge of the entries in the cache.
+ *
+ * Params:
+ *    cache - The cache to operate on.
+ * Returns:
+ *    The cache's total charge.
+ */
+long lrucache_charge(LruCache *cache);
+
+/**
+ * Fills in `stats` with the number of hits, misses, evictions and rejections since the cache was
+ * created.
+ *
+ * Params:
+ *    cache - The cache to operate on.
+ *    stats - The stats to fill in.
+ * Returns:
+ *    None
+ */
+void lrucache_stats(LruCache *cache, CacheStats *stats);
+
+/**
+ * Removes all the entries from the cache. If `valueDestructor` is not NULL, it will be invoked on
+ * each value removed.
+ *
+ * Params:
+ *    cache - The cache to operate on.
+ *    valueDestructor - Function to operate on each entry value, may be NULL.
+ * Returns:
+ *    None
+ */
+void lrucache_clear(LruCache *cache, void (*valueDestructor)(void *));
+
+/**
+ * Returns the number of bytes of memory held by the cache: the cache itself, its buckets, its
+ * entries and its frequency sketch, not counting the keys and values.
+ *
+ * Params:
+ *    cache - The cache to operate on.
+ * Returns:
+ *    The cache's memory usage, in bytes.
+ */
+long lrucache_memoryUsage(LruCache *cache);
+
+/**
+ * Destroys the cache instance by freeing all of its reserved memory. If `valueDestructor` is not
+ * NULL, it will be invoked on each value before the cache is destroyed.
+ *
+ * Params:
+ *    cache - The cache to destroy.
+ *    valueDestructor - Function to operate on each entry value prior to destruction.
+ * Returns:
+ *    None
+ */
+void lrucache_destroy(LruCache *cache, void (*valueDestructor)(void *));
+
+#endif  /* _CDS_LRU_CACHE_H__ */
@@ -0,0 +1,122 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2020 Cole Vikupitz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef _CDS_MERGE_ITERATOR_H__
+#define _CDS_MERGE_ITERATOR_H__
+
+#include "array_list.h"
+#include "cds_common.h"
+#include "iterator.h"
+
+/**
+ * Interface for the MergeIterator ADT.
+ *
+ * A k-way merge over several inputs that are each already sorted, such as per-shard results or
+ * log segments, yielding all of their elements as one sorted sequence. The inputs are read lazily,
+ * one element at a time, so merging costs no more memory than one element per input.
+ *
+ * The inputs are arranged as the leaves of a loser tree (a tournament tree recording the loser of
+ * each match): the smallest head element wins the tournament, and after it is taken only the
+ * matches on its own path to the root are replayed. Taking an element therefore costs about log2(k)
+ * comparisons, where a binary heap of cursors needs about twice that (one comparison between the
+ * children and one with the parent at each level). Elements that compare equal come out in the
+ * order of their inputs, so the merge is stable.
+ *
+ * The merge iterator neither copies nor destroys its inputs; they must outlive it. Lists are walked
+ * with cursors, so a list modified during the merge makes mergeiterator_next() fail with
+ * CONCURRENT_MODIFICATION.
+ */
+typedef struct merge_iterator MergeIterator;
+
+/**
+ * Constructs a new merge iterator over the `k` sorted iterators of `inputs`, then stores the new
+ * instance into `*iter`. The array `inputs` is not kept by the merge iterator.
+ *
+ * Params:
+ *    iter - The pointer address to store the new MergeIterator instance.
+ *    inputs - The iterators to merge, each already sorted by `comparator`.
+ *    k - The number of iterators in `inputs`.
+ *    comparator - Function for comparing two elements.
+ * Returns:
+ *    OK - MergeIterator was successfully created.
+ *    INVALID_INDEX - `k` is negative.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status mergeiterator_new(MergeIterator **iter, Iterator **inputs, long k,
+                         int (*comparator)(void *, void *));
+
+/**
+ * Constructs a new merge iterator over the `k` sorted array lists of `lists`, then stores the new
+ * instance into `*iter`. The lists are walked in place with cursors, without copying them. The
+ * array `lists` is not kept by the merge iterator.
+ *
+ * Params:
+ *    iter - The pointer address to store the new MergeIterator instance.
+ *    lists - The array lists to merge, each already sorted by `comparator`.
+ *    k - The number of array lists in `lists`.
+ *    comparator - Function for comparing two elements.
+ * Returns:
+ *    OK - MergeIterator was successfully created.
+ *    INVALID_INDEX - `k` is negative.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status mergeiterator_newFromLists(MergeIterator **iter, ArrayList **lists, long k,
+                                  int (*comparator)(void *, void *));
+
+/**
+ * Returns TRUE if any of the inputs has more elements, FALSE if not.
+ *
+ * Params:
+ *    iter - The merge iterator to operate on.
+ * Returns:
+ *    TRUE if the merge has more elements, FALSE if not.
+ */
+Boolean mergeiterator_hasNext(MergeIterator *iter);
+
+/**
+ * Takes the least of the inputs' next elements, and stores it into `*next`.
+ *
+ * Params:
+ *    iter - The merge iterator to operate on.
+ *    next - The pointer address to store the next element into.
+ * Returns:
+ *    OK - Next element was returned.
+ *    ITER_END - Every input has been exhausted.
+ *    CONCURRENT_MODIFICATION - One of the array lists was modified during the merge.
+ */
+Status mergeiterator_next(MergeIterator *iter, void **next);
+
+/**
+ * Destroys the merge iterator instance by freeing all of its reserved memory. The inputs are not
+ * destroyed.
+ *
+ * Params:
+ *    iter - The merge iterator to destroy.
+ * Returns:
+ *    None
+ */
+void mergeiterator_destroy(MergeIterator *iter);
+
+#endif  /* _CDS_MERGE_ITERATOR_H__ */
@@ -0,0 +1,153 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2020 Cole Vikupitz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef _CDS_NODE_POOL_H__
+#define _CDS_NODE_POOL_H__
+
+#include <stddef.h>
+#include "allocator.h"
+#include "cds_common.h"
+
+/**
+ * Interface for the NodePool ADT.
+ *
+ * A slab allocator for the small, fixed-size nodes used by the linked ADTs (Stack, Queue,
+ * LinkedList, CircularList, TreeMap and TreeSet). Nodes are carved out of large slabs and recycled
+ * through per-size free lists, so pushing and popping elements no longer calls malloc() and free()
+ * for every element. Every linked ADT owns a private pool by default; a pool can also be created
+ * explicitly and passed to several ADTs at construction (see the *_newWithPool() functions), in
+ * which case it acts as a shared arena that outlives them.
+ *
+ * Memory is only returned to the heap when the pool is reset or destroyed. A pool created with
+ * nodepool_new() must not be used from several threads at once, except through the locks of the
+ * thread-safe ADTs that share it. A pool created with nodepool_newConcurrent() may be shared
+ * freely: each thread keeps a small cache of free nodes, so most allocations take no lock.
+ */
+typedef struct node_pool NodePool;
+
+/**
+ * Creates a new, empty node pool, then stores the new pool into `*pool`.
+ *
+ * Params:
+ *    pool - The pointer address to store the new NodePool into.
+ *    nodesPerSlab - The largest number of nodes carved out of a single slab. If 0 or less, a
+ *                   default will be used.
+ * Returns:
+ *    OK - NodePool was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status nodepool_new(NodePool **pool, long nodesPerSlab);
+
+/**
+ * Creates a new, empty node pool that allocates its slabs through `allocator`, then stores the new
+ * pool into `*pool`.
+ *
+ * Params:
+ *    pool - The pointer address to store the new NodePool into.
+ *    nodesPerSlab - The largest number of nodes carved out of a single slab. If 0 or less, a
+ *                   default will be used.
+ *    allocator - The allocator to use, which must outlive the pool. If NULL, the default allocator
+ *                will be used.
+ * Returns:
+ *    OK - NodePool was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the allocator.
+ */
+Status nodepool_newWithAllocator(NodePool **pool, long nodesPerSlab,
+                                 const CdsAllocator *allocator);
+
+/**
+ * Creates a new, empty node pool that may be used by several threads at once, then stores the new
+ * pool into `*pool`.
+ *
+ * Params:
+ *    pool - The pointer address to store the new NodePool into.
+ *    nodesPerSlab - The largest number of nodes carved out of a single slab. If 0 or less, a
+ *                   default will be used.
+ * Returns:
+ *    OK - NodePool was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status nodepool_newConcurrent(NodePool **pool, long nodesPerSlab);
+
+/**
+ * Allocates a node of `size` bytes from the pool. Sizes larger than the pool's largest size class
+ * are served by the pool's allocator instead.
+ *
+ * Params:
+ *    pool - The pool to allocate from.
+ *    size - The size of the node in bytes.
+ * Returns:
+ *    The new node, or NULL if memory could not be allocated.
+ */
+void *nodepool_alloc(NodePool *pool, size_t size);
+
+/**
+ * Returns the node `node`, previously allocated from the pool with the same `size`, back to the
+ * pool for reuse.
+ *
+ * Params:
+ *    pool - The pool to return the node to.
+ *    node - The node to free.
+ *    size - The size the node was allocated with.
+ * Returns:
+ *    None
+ */
+void nodepool_free(NodePool *pool, void *node, size_t size);
+
+/**
+ * Returns the number of bytes held by the pool: the pool itself and every slab it has allocated,
+ * whether the slab's nodes are in use, free or never handed out yet. Concurrent pools may be
+ * queried while other threads use them, in which case the result is only approximate.
+ *
+ * Params:
+ *    pool - The pool to operate on.
+ * Returns:
+ *    The pool's memory usage, in bytes.
+ */
+long nodepool_memoryUsage(NodePool *pool);
+
+/**
+ * Frees every slab held by the pool at once, returning the pool to its initial empty state. Every
+ * node allocated from the pool becomes invalid, so this must only be called once none of them are
+ * in use, and (for concurrent pools) while no other thread is using the pool.
+ *
+ * Params:
+ *    pool - The pool to reset.
+ * Returns:
+ *    None
+ */
+void nodepool_reset(NodePool *pool);
+
+/**
+ * Destroys the pool by freeing all of its reserved memory, including every node allocated from it.
+ *
+ * Params:
+ *    pool - The pool to destroy.
+ * Returns:
+ *    None
+ */
+void nodepool_destroy(NodePool *pool);
+
+#endif  /* _CDS_NODE_POOL_H__ */
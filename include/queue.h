@@ -26,6 +26,8 @@
 #define _CDS_QUEUE_H__
 
 #include "cds_common.h"
+#include "cursor.h"
+#include "node_pool.h"
 #include "iterator.h"
 
 /**
@@ -50,6 +52,51 @@ typedef struct queue Queue;
  */
 Status queue_new(Queue **queue);
 
+/**
+ * Creates a new queue instance whose nodes are allocated from `pool`, then stores the new instance
+ * into `*queue`. The pool may be shared with other ADTs and must outlive the queue; nodes are
+ * returned to it as elements are removed. If `pool` is NULL, a private pool is used instead, the
+ * same as queue_new().
+ *
+ * Params:
+ *    queue - The pointer address to store the new Queue instance.
+ *    pool - The pool to allocate the nodes from, or NULL.
+ * Returns:
+ *    OK - Queue was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status queue_newWithPool(Queue **queue, NodePool *pool);
+
+/**
+ * Creates a new queue instance whose struct and nodes are allocated through `allocator`, then
+ * stores the new instance into `*queue`. The nodes come from a private pool backed by the
+ * allocator.
+ *
+ * Params:
+ *    queue - The pointer address to store the new Queue instance.
+ *    allocator - The allocator to use, which must outlive the queue. If NULL, the default
+ *                allocator will be used.
+ * Returns:
+ *    OK - Queue was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the allocator.
+ */
+Status queue_newWithAllocator(Queue **queue, const CdsAllocator *allocator);
+
+/**
+ * Creates a new unrolled queue instance, then stores the new instance into `*queue`. Instead of one
+ * node per element, the elements are stored in chunks of 32, which cuts the memory used per
+ * element from a whole node to little more than a pointer, and lets traversals walk contiguous
+ * memory. Adds and polls remain O(1); one emptied chunk is kept for reuse, so a queue whose size
+ * stays steady does not allocate at all.
+ *
+ * Params:
+ *    queue - The pointer address to store the new Queue instance.
+ * Returns:
+ *    OK - Queue was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status queue_newUnrolled(Queue **queue);
+
 /**
  * Inserts the specified element into the queue.
  *
@@ -62,6 +109,21 @@ Status queue_new(Queue **queue);
  */
 Status queue_add(Queue *queue, void *item);
 
+/**
+ * Adds the `n` elements in the array `items` to the tail of the queue, in order. The batch is
+ * linked into the queue at once, so either every element is added or, on failure, none is.
+ *
+ * Params:
+ *    queue - The queue to operate on.
+ *    items - The array of elements to add.
+ *    n - The number of elements in `items`.
+ * Returns:
+ *    OK - Operation was successful.
+ *    INVALID_INDEX - `n` is negative.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status queue_addAll(Queue *queue, void **items, long n);
+
 /**
  * Retrieves, but does not remove, the first element from the queue and stores the result into
  * `*first`.
@@ -87,6 +149,20 @@ Status queue_peek(Queue *queue, void **first);
  */
 Status queue_poll(Queue *queue, void **first);
 
+/**
+ * Removes up to `max` elements from the front of the queue, storing them in FIFO order into
+ * `items`, which must have room for `max` elements. An unrolled queue copies them out a chunk at a
+ * time.
+ *
+ * Params:
+ *    queue - The queue to operate on.
+ *    items - The array to store the removed elements into.
+ *    max - The maximum number of elements to remove.
+ * Returns:
+ *    The number of elements removed and stored into `items`.
+ */
+long queue_pollMany(Queue *queue, void **items, long max);
+
 /**
  * Removes all elements from the queue. If `destructor` is not NULL, it will be invoked on each
  * element in the queue after being removed.
@@ -149,6 +225,56 @@ Status queue_toArray(Queue *queue, Array **array);
  */
 Status queue_iterator(Queue *queue, Iterator **iter);
 
+/**
+ * Initializes `cursor` to walk over the queue's elements from front to back, without copying them.
+ * The elements are then fetched with queue_cursorNext(); see cursor.h for details.
+ *
+ * Params:
+ *    queue - The queue to operate on.
+ *    cursor - The cursor to initialize.
+ * Returns:
+ *    None
+ */
+void queue_cursor(Queue *queue, Cursor *cursor);
+
+/**
+ * Advances the cursor to the next element of the queue, and stores it into `*next`.
+ *
+ * Params:
+ *    cursor - The cursor to operate on.
+ *    next - The pointer address to store the next element into.
+ * Returns:
+ *    OK - Next element was returned.
+ *    ITER_END - The cursor has already visited every element.
+ *    CONCURRENT_MODIFICATION - The queue was modified after creating the cursor.
+ */
+Status queue_cursorNext(Cursor *cursor, void **next);
+
+/**
+ * Applies `action` to each element of the queue from front to back, passing it the element and
+ * `context`. The walk stops as soon as `action` returns FALSE. Nothing is copied or allocated, and
+ * `action` must not modify the queue while it is walked.
+ *
+ * Params:
+ *    queue - The queue to operate on.
+ *    action - Function applied to each element, returning FALSE to stop the walk.
+ *    context - Argument passed along to each call of `action`, may be NULL.
+ * Returns:
+ *    TRUE if `action` was applied to every element, FALSE if it stopped the walk early.
+ */
+Boolean queue_forEach(Queue *queue, Boolean (*action)(void *, void *), void *context);
+
+/**
+ * Returns the number of bytes of memory held by the queue: the queue itself and its nodes or
+ * chunks, not counting the elements themselves.
+ *
+ * Params:
+ *    queue - The queue to operate on.
+ * Returns:
+ *    The queue's memory usage, in bytes.
+ */
+long queue_memoryUsage(Queue *queue);
+
 /**
  * Destroys the queue instance by freeing all of its reserved memory. If `destructor` is not NULL,
  * it will be invoked on each element before the queue is destroyed.
@@ -0,0 +1,272 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2020 Cole Vikupitz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef _CDS_RADIX_TREE_H__
+#define _CDS_RADIX_TREE_H__
+
+#include "cds_common.h"
+
+/**
+ * Interface for the RadixTree ADT.
+ *
+ * A radix tree is a sorted map keyed by byte strings, such as paths and URLs, whose keys are
+ * ordered lexicographically byte by byte, a key that is a prefix of another ordering first. Unlike
+ * a TreeMap comparing whole keys at every level, a radix tree branches on one byte of the key at a
+ * time, so a lookup costs time proportional to the key's length rather than to the log of the
+ * number of keys times the key's length, and keys sharing long prefixes store them only once.
+ * Every key within a prefix forms a single subtree, so prefix queries are answered directly.
+ *
+ * This implementation is an adaptive radix tree (ART): each inner node grows from 4 to 16, 48 and
+ * 256 children, and shrinks back, as its number of children changes, and chains of single-child
+ * nodes are collapsed into a compressed prefix. The tree keeps its own copy of every key; values
+ * are stored as given.
+ */
+typedef struct radix_tree RadixTree;
+
+/**
+ * Constructs a new, empty radix tree, then stores the new instance into `*tree`.
+ *
+ * Params:
+ *    tree - The pointer address to store the new RadixTree instance.
+ * Returns:
+ *    OK - RadixTree was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status radixtree_new(RadixTree **tree);
+
+/**
+ * Associates the specified key with the specified value in the radix tree. If the tree already
+ * contains the key, the old value is replaced, and stored into `*previous`. The key is copied.
+ *
+ * Params:
+ *    tree - The radix tree to operate on.
+ *    key - The key's bytes.
+ *    length - The number of bytes in the key.
+ *    value - The value to associate with the key.
+ *    previous - The pointer address to store the replaced value into.
+ * Returns:
+ *    INSERTED - Key and value was inserted.
+ *    REPLACED - Value was updated in the radix tree, and the old value was stored into
+ *               `*previous` due to the key already existing.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status radixtree_put(RadixTree *tree, const void *key, long length, void *value,
+                     void **previous);
+
+/**
+ * Returns TRUE if the radix tree contains the specified key, FALSE if not.
+ *
+ * Params:
+ *    tree - The radix tree to operate on.
+ *    key - The key's bytes.
+ *    length - The number of bytes in the key.
+ * Returns:
+ *    TRUE if the key exists, FALSE if not.
+ */
+Boolean radixtree_containsKey(RadixTree *tree, const void *key, long length);
+
+/**
+ * Retrieves the value associated with the specified key, then stores it into `*value`.
+ *
+ * Params:
+ *    tree - The radix tree to operate on.
+ *    key - The key's bytes.
+ *    length - The number of bytes in the key.
+ *    value - The pointer address to store the value into.
+ * Returns:
+ *    OK - Operation was successful.
+ *    NOT_FOUND - The key does not exist in the radix tree.
+ */
+Status radixtree_get(RadixTree *tree, const void *key, long length, void **value);
+
+/**
+ * Removes the key and its value from the radix tree, storing the value into `*value`.
+ *
+ * Params:
+ *    tree - The radix tree to operate on.
+ *    key - The key's bytes.
+ *    length - The number of bytes in the key.
+ *    value - The pointer address to store the removed value into.
+ * Returns:
+ *    OK - Operation was successful.
+ *    NOT_FOUND - The key does not exist in the radix tree.
+ */
+Status radixtree_remove(RadixTree *tree, const void *key, long length, void **value);
+
+/**
+ * Fetches the first (least) key currently in the radix tree, storing the tree's copy of it into
+ * `*firstKey` and its length into `*firstLength`. The copy stays valid until the key is removed.
+ *
+ * Params:
+ *    tree - The radix tree to operate on.
+ *    firstKey - The pointer address to store the first key into.
+ *    firstLength - The pointer address to store the first key's length into.
+ * Returns:
+ *    OK - Operation was successful.
+ *    STRUCT_EMPTY - RadixTree is currently empty.
+ */
+Status radixtree_firstKey(RadixTree *tree, const void **firstKey, long *firstLength);
+
+/**
+ * Fetches the last (greatest) key currently in the radix tree, storing the tree's copy of it into
+ * `*lastKey` and its length into `*lastLength`. The copy stays valid until the key is removed.
+ *
+ * Params:
+ *    tree - The radix tree to operate on.
+ *    lastKey - The pointer address to store the last key into.
+ *    lastLength - The pointer address to store the last key's length into.
+ * Returns:
+ *    OK - Operation was successful.
+ *    STRUCT_EMPTY - RadixTree is currently empty.
+ */
+Status radixtree_lastKey(RadixTree *tree, const void **lastKey, long *lastLength);
+
+/**
+ * Fetches the greatest key in the radix tree less than or equal to the given key, storing the
+ * tree's copy of it into `*floorKey` and its length into `*floorLength`.
+ *
+ * Params:
+ *    tree - The radix tree to operate on.
+ *    key - The key's bytes.
+ *    length - The number of bytes in the key.
+ *    floorKey - The pointer address to store the floor key into.
+ *    floorLength - The pointer address to store the floor key's length into.
+ * Returns:
+ *    OK - Operation was successful.
+ *    STRUCT_EMPTY - RadixTree is currently empty.
+ *    NOT_FOUND - No floor key exists.
+ */
+Status radixtree_floorKey(RadixTree *tree, const void *key, long length, const void **floorKey,
+                          long *floorLength);
+
+/**
+ * Fetches the least key in the radix tree greater than or equal to the given key, storing the
+ * tree's copy of it into `*ceilingKey` and its length into `*ceilingLength`.
+ *
+ * Params:
+ *    tree - The radix tree to operate on.
+ *    key - The key's bytes.
+ *    length - The number of bytes in the key.
+ *    ceilingKey - The pointer address to store the ceiling key into.
+ *    ceilingLength - The pointer address to store the ceiling key's length into.
+ * Returns:
+ *    OK - Operation was successful.
+ *    STRUCT_EMPTY - RadixTree is currently empty.
+ *    NOT_FOUND - No ceiling key exists.
+ */
+Status radixtree_ceilingKey(RadixTree *tree, const void *key, long length,
+                            const void **ceilingKey, long *ceilingLength);
+
+/**
+ * Applies `action` to each entry of the radix tree in ascending order of their keys, passing it
+ * the entry's key, the key's length, its value and `context`. The walk stops as soon as `action`
+ * returns FALSE. Nothing is copied or allocated, and `action` must not modify the radix tree while
+ * it is walked.
+ *
+ * Params:
+ *    tree - The radix tree to operate on.
+ *    action - Function applied to each entry, returning FALSE to stop the walk.
+ *    context - Argument passed along to each call of `action`, may be NULL.
+ * Returns:
+ *    TRUE if `action` was applied to every entry, FALSE if it stopped the walk early.
+ */
+Boolean radixtree_forEach(RadixTree *tree, Boolean (*action)(const void *, long, void *, void *),
+                          void *context);
+
+/**
+ * Applies `action` to each entry of the radix tree whose key starts with the specified prefix, in
+ * ascending order of their keys, in the same way as radixtree_forEach(). Finding the first such key
+ * takes time proportional to the prefix's length, however many keys the tree holds.
+ *
+ * Params:
+ *    tree - The radix tree to operate on.
+ *    prefix - The prefix's bytes.
+ *    length - The number of bytes in the prefix; 0 walks the whole tree.
+ *    action - Function applied to each entry, returning FALSE to stop the walk.
+ *    context - Argument passed along to each call of `action`, may be NULL.
+ * Returns:
+ *    TRUE if `action` was applied to every entry with the prefix, FALSE if it stopped the walk
+ *    early.
+ */
+Boolean radixtree_forEachPrefix(RadixTree *tree, const void *prefix, long length,
+                                Boolean (*action)(const void *, long, void *, void *),
+                                void *context);
+
+/**
+ * Returns the number of key-value mappings in the radix tree.
+ *
+ * Params:
+ *    tree - The radix tree to operate on.
+ * Returns:
+ *    The number of mappings in the radix tree.
+ */
+long radixtree_size(RadixTree *tree);
+
+/**
+ * Returns TRUE if the radix tree contains no mappings, FALSE if otherwise.
+ *
+ * Params:
+ *    tree - The radix tree to operate on.
+ * Returns:
+ *    TRUE if the radix tree is empty, FALSE if not.
+ */
+Boolean radixtree_isEmpty(RadixTree *tree);
+
+/**
+ * Removes all key-value mappings from the radix tree. If `valueDestructor` is not NULL, it will be
+ * invoked on each value in the tree after being removed.
+ *
+ * Params:
+ *    tree - The radix tree to operate on.
+ *    valueDestructor - Function to operate on each value after removal.
+ * Returns:
+ *    None
+ */
+void radixtree_clear(RadixTree *tree, void (*valueDestructor)(void *));
+
+/**
+ * Returns the total number of bytes of heap memory held by the radix tree, including its nodes
+ * and the copies of its keys. The memory held by the values is not counted.
+ *
+ * Params:
+ *    tree - The radix tree to operate on.
+ * Returns:
+ *    The radix tree's memory usage, in bytes.
+ */
+long radixtree_memoryUsage(RadixTree *tree);
+
+/**
+ * Destroys the radix tree instance by freeing all of its reserved memory. If `valueDestructor` is
+ * not NULL, it will be invoked on each value in the tree after being removed.
+ *
+ * Params:
+ *    tree - The radix tree to destroy.
+ *    valueDestructor - Function to operate on each value after removal.
+ * Returns:
+ *    None
+ */
+void radixtree_destroy(RadixTree *tree, void (*valueDestructor)(void *));
+
+#endif  /* _CDS_RADIX_TREE_H__ */
@@ -0,0 +1,144 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2020 Cole Vikupitz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _CDS_RING_QUEUE_H__
+#define _CDS_RING_QUEUE_H__
+
+#include "cds_common.h"
+
+/**
+ * Interface for the RingQueue ADT.
+ *
+ * The RingQueue class represents a bounded first-in-first-out (FIFO) queue of objects that may be
+ * shared between threads without any lock. Like the BoundedQueue, the elements are stored in a
+ * circular array; its capacity is rounded up to a power of two, and the producers' and consumers'
+ * indices are kept on separate cache lines so that the two sides do not contend with each other.
+ *
+ * A queue created with ringqueue_newSpsc() is wait-free, but supports only a single producer
+ * thread and a single consumer thread at a time. A queue created with ringqueue_newMpmc() is
+ * lock-free and may be used by any number of producers and consumers; every slot carries a
+ * sequence number that tells the threads whether the slot is ready to be written or read.
+ *
+ * Neither queue ever blocks; ringqueue_add() fails when full and ringqueue_poll() fails when
+ * empty. ringqueue_destroy() must only be called once no other thread uses the queue.
+ */
+typedef struct ring_queue RingQueue;
+
+/**
+ * Creates a new single-producer/single-consumer ring queue, then stores the new instance into
+ * `*queue`. The capacity is rounded up to the next power of two; if <= 0, a default capacity is
+ * assigned.
+ *
+ * Params:
+ *    queue - The pointer address to store the new RingQueue instance.
+ *    capacity - The queue's upper-bound capacity.
+ * Returns:
+ *    OK - Queue was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status ringqueue_newSpsc(RingQueue **queue, long capacity);
+
+/**
+ * Creates a new multi-producer/multi-consumer ring queue, then stores the new instance into
+ * `*queue`. The capacity is rounded up to the next power of two; if <= 0, a default capacity is
+ * assigned.
+ *
+ * Params:
+ *    queue - The pointer address to store the new RingQueue instance.
+ *    capacity - The queue's upper-bound capacity.
+ * Returns:
+ *    OK - Queue was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status ringqueue_newMpmc(RingQueue **queue, long capacity);
+
+/**
+ * Inserts the specified element into the queue.
+ *
+ * Params:
+ *    queue - The queue to operate on.
+ *    item - The item to be inserted into the queue.
+ * Returns:
+ *    OK - Operation was successful.
+ *    STRUCT_FULL - Failed as the queue is currently full.
+ */
+Status ringqueue_add(RingQueue *queue, void *item);
+
+/**
+ * Removes the first element from the queue and stores the result into `*first`.
+ *
+ * Params:
+ *    queue - The queue to operate on.
+ *    first - The pointer address to store the removed first element into.
+ * Returns:
+ *    OK - Operation was successful.
+ *    STRUCT_EMPTY - Queue is currently empty.
+ */
+Status ringqueue_poll(RingQueue *queue, void **first);
+
+/**
+ * Returns the number of elements in the queue. While other threads are adding or polling, the
+ * result is only a snapshot that may already be out of date.
+ *
+ * Params:
+ *    queue - The queue to operate on.
+ * Returns:
+ *    The queue's current size.
+ */
+long ringqueue_size(RingQueue *queue);
+
+/**
+ * Returns the queue's capacity, which is always a power of two.
+ *
+ * Params:
+ *    queue - The queue to operate on.
+ * Returns:
+ *    The queue's capacity.
+ */
+long ringqueue_capacity(RingQueue *queue);
+
+/**
+ * Returns TRUE if the queue is empty, FALSE if not. Like ringqueue_size(), this is only a
+ * snapshot while other threads are using the queue.
+ *
+ * Params:
+ *    queue - The queue to operate on.
+ * Returns:
+ *    TRUE if the queue is empty, FALSE if not.
+ */
+Boolean ringqueue_isEmpty(RingQueue *queue);
+
+/**
+ * Destroys the queue instance by freeing all of its reserved memory. If `destructor` is not NULL,
+ * it will be invoked on each element still in the queue before the queue is destroyed.
+ *
+ * Params:
+ *    queue - The queue to destroy.
+ *    destructor - Function to operate on each element prior to queue destruction.
+ * Returns:
+ *    None
+ */
+void ringqueue_destroy(RingQueue *queue, void (*destructor)(void *));
+
+#endif  /* _CDS_RING_QUEUE_H__ */
@@ -0,0 +1,370 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2020 Cole Vikupitz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _CDS_SKIP_LIST_MAP_H__
+#define _CDS_SKIP_LIST_MAP_H__
+
+#include "cds_common.h"
+
+/**
+ * Interface for the ConcurrentSkipListMap ADT.
+ *
+ * The ConcurrentSkipListMap class represents a sorted map of key-value pairs that may be shared by
+ * any number of threads, with the same navigation operations as the TreeMap. Where the
+ * ConcurrentTreeMap serializes every write behind one lock, the map is a skip list (a lazy skip
+ * list) with a small spin lock in each node: an insertion or removal only locks the nodes just
+ * before the one it links or unlinks, so writes to different parts of the map proceed in
+ * parallel. Lookups and navigation take no lock at all.
+ *
+ * Removed nodes are reclaimed through epoch-based reclamation (see epoch.h), so a key handed to the
+ * key destructor is never one another thread may still be comparing against. The keys and values
+ * returned by lookups are not protected, however: if another thread may remove the entry, the
+ * caller must not rely on them outliving that removal.
+ *
+ * Unlike the TreeMap, the map cannot be iterated over in bulk, since that would need a consistent
+ * view of every entry at once. Its size is exact when no writes are in progress.
+ */
+typedef struct skip_list_map ConcurrentSkipListMap;
+
+/**
+ * Creates a new, empty skip list map, then stores the new instance into `*map`.
+ *
+ * Params:
+ *    map - The pointer address to store the new ConcurrentSkipListMap instance.
+ *    keyComparator - Function for comparing two keys in the map.
+ *    keyDestructor - Function for de-allocating the map's keys.
+ * Returns:
+ *    OK - ConcurrentSkipListMap was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status skiplistmap_new(ConcurrentSkipListMap **map, int (*keyComparator)(void *, void *),
+                       void (*keyDestructor)(void *));
+
+/**
+ * Associates the specified value with the specified key in the map. If the map previously
+ * contained a mapping for the key, the old value is replaced, and stored into `*previous`.
+ *
+ * Params:
+ *    map - The map to operate on.
+ *    key - The key with which the specified value is to be associated.
+ *    value - The value to be associated with the specified key.
+ *    previous - The pointer address to store the previous value into.
+ * Returns:
+ *    INSERTED - Key and value was inserted.
+ *    REPLACED - Value was updated in the map, and the old value was stored into `*previous` due to
+ *               the key already existing.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status skiplistmap_put(ConcurrentSkipListMap *map, void *key, void *value, void **previous);
+
+/**
+ * Retrieves the value to which the specified key is mapped, then stores the result into `*value`.
+ *
+ * Params:
+ *    map - The map to operate on.
+ *    key - The key whose associated value is to be returned.
+ *    value - The pointer address to store the retrieved value into.
+ * Returns:
+ *    OK - Operation was successful.
+ *    NOT_FOUND - The map contains no mapping for the key.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status skiplistmap_get(ConcurrentSkipListMap *map, void *key, void **value);
+
+/**
+ * Returns TRUE if the map contains a mapping for the specified key, FALSE if not.
+ *
+ * Params:
+ *    map - The map to operate on.
+ *    key - The key whose presence in the map is to be tested.
+ * Returns:
+ *    TRUE if a mapping exists with the key, FALSE if not.
+ */
+Boolean skiplistmap_containsKey(ConcurrentSkipListMap *map, void *key);
+
+/**
+ * Fetches the first (least) key currently in the map, then stores the result into `*firstKey`.
+ *
+ * Params:
+ *    map - The map to operate on.
+ *    firstKey - The pointer address to store the first key into.
+ * Returns:
+ *    OK - Operation was successful.
+ *    STRUCT_EMPTY - Map is currently empty.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status skiplistmap_firstKey(ConcurrentSkipListMap *map, void **firstKey);
+
+/**
+ * Fetches the first (least) entry currently in the map, then stores its key and value into
+ * `*firstKey` and `*firstValue`, respectively.
+ *
+ * Params:
+ *    map - The map to operate on.
+ *    firstKey - The pointer address to store the first key into.
+ *    firstValue - The pointer address to store the first value into.
+ * Returns:
+ *    OK - Operation was successful.
+ *    STRUCT_EMPTY - Map is currently empty.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status skiplistmap_first(ConcurrentSkipListMap *map, void **firstKey, void **firstValue);
+
+/**
+ * Fetches the last (greatest) key currently in the map, then stores the result into `*lastKey`.
+ *
+ * Params:
+ *    map - The map to operate on.
+ *    lastKey - The pointer address to store the last key into.
+ * Returns:
+ *    OK - Operation was successful.
+ *    STRUCT_EMPTY - Map is currently empty.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status skiplistmap_lastKey(ConcurrentSkipListMap *map, void **lastKey);
+
+/**
+ * Fetches the last (greatest) entry currently in the map, then stores its key and value into
+ * `*lastKey` and `*lastValue`, respectively.
+ *
+ * Params:
+ *    map - The map to operate on.
+ *    lastKey - The pointer address to store the last key into.
+ *    lastValue - The pointer address to store the last value into.
+ * Returns:
+ *    OK - Operation was successful.
+ *    STRUCT_EMPTY - Map is currently empty.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status skiplistmap_last(ConcurrentSkipListMap *map, void **lastKey, void **lastValue);
+
+/**
+ * Fetches the greatest key in the map less than or equal to the given key, then stores the result
+ * into `*floorKey`.
+ *
+ * Params:
+ *    map - The map to operate on.
+ *    key - The key to match.
+ *    floorKey - The pointer address to store the floor key into.
+ * Returns:
+ *    OK - Operation was successful.
+ *    NOT_FOUND - No floor key exists.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status skiplistmap_floorKey(ConcurrentSkipListMap *map, void *key, void **floorKey);
+
+/**
+ * Fetches the greatest entry in the map whose key is less than or equal to the given key, then
+ * stores its key and value into `*floorKey` and `*floorValue`, respectively.
+ *
+ * Params:
+ *    map - The map to operate on.
+ *    key - The key to match.
+ *    floorKey - The pointer address to store the floor key into.
+ *    floorValue - The pointer address to store the floor value into.
+ * Returns:
+ *    OK - Operation was successful.
+ *    NOT_FOUND - No floor entry exists.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status skiplistmap_floor(ConcurrentSkipListMap *map, void *key, void **floorKey,
+                         void **floorValue);
+
+/**
+ * Fetches the least key in the map greater than or equal to the given key, then stores the result
+ * into `*ceilingKey`.
+ *
+ * Params:
+ *    map - The map to operate on.
+ *    key - The key to match.
+ *    ceilingKey - The pointer address to store the ceiling key into.
+ * Returns:
+ *    OK - Operation was successful.
+ *    NOT_FOUND - No ceiling key exists.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status skiplistmap_ceilingKey(ConcurrentSkipListMap *map, void *key, void **ceilingKey);
+
+/**
+ * Fetches the least entry in the map whose key is greater than or equal to the given key, then
+ * stores its key and value into `*ceilingKey` and `*ceilingValue`, respectively.
+ *
+ * Params:
+ *    map - The map to operate on.
+ *    key - The key to match.
+ *    ceilingKey - The pointer address to store the ceiling key into.
+ *    ceilingValue - The pointer address to store the ceiling value into.
+ * Returns:
+ *    OK - Operation was successful.
+ *    NOT_FOUND - No ceiling entry exists.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status skiplistmap_ceiling(ConcurrentSkipListMap *map, void *key, void **ceilingKey,
+                           void **ceilingValue);
+
+/**
+ * Fetches the greatest key in the map strictly less than the given key, then stores the result
+ * into `*lowerKey`.
+ *
+ * Params:
+ *    map - The map to operate on.
+ *    key - The key to match.
+ *    lowerKey - The pointer address to store the lower key into.
+ * Returns:
+ *    OK - Operation was successful.
+ *    NOT_FOUND - No lower key exists.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status skiplistmap_lowerKey(ConcurrentSkipListMap *map, void *key, void **lowerKey);
+
+/**
+ * Fetches the greatest entry in the map whose key is strictly less than the given key, then stores
+ * its key and value into `*lowerKey` and `*lowerValue`, respectively.
+ *
+ * Params:
+ *    map - The map to operate on.
+ *    key - The key to match.
+ *    lowerKey - The pointer address to store the lower key into.
+ *    lowerValue - The pointer address to store the lower value into.
+ * Returns:
+ *    OK - Operation was successful.
+ *    NOT_FOUND - No lower entry exists.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status skiplistmap_lower(ConcurrentSkipListMap *map, void *key, void **lowerKey,
+                         void **lowerValue);
+
+/**
+ * Fetches the least key in the map strictly greater than the given key, then stores the result
+ * into `*higherKey`.
+ *
+ * Params:
+ *    map - The map to operate on.
+ *    key - The key to match.
+ *    higherKey - The pointer address to store the higher key into.
+ * Returns:
+ *    OK - Operation was successful.
+ *    NOT_FOUND - No higher key exists.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status skiplistmap_higherKey(ConcurrentSkipListMap *map, void *key, void **higherKey);
+
+/**
+ * Fetches the least entry in the map whose key is strictly greater than the given key, then stores
+ * its key and value into `*higherKey` and `*higherValue`, respectively.
+ *
+ * Params:
+ *    map - The map to operate on.
+ *    key - The key to match.
+ *    higherKey - The pointer address to store the higher key into.
+ *    higherValue - The pointer address to store the higher value into.
+ * Returns:
+ *    OK - Operation was successful.
+ *    NOT_FOUND - No higher entry exists.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status skiplistmap_higher(ConcurrentSkipListMap *map, void *key, void **higherKey,
+                          void **higherValue);
+
+/**
+ * Retrieves and removes the first (least) entry from the map, then stores the removed key and
+ * value into `*firstKey` and `*firstValue`, respectively. The key is handed over to the caller and
+ * is not passed to the key destructor.
+ *
+ * Params:
+ *    map - The map to operate on.
+ *    firstKey - The pointer address to store the removed first key into.
+ *    firstValue - The pointer address to store the removed first value into.
+ * Returns:
+ *    OK - Operation was successful.
+ *    STRUCT_EMPTY - Map is currently empty.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status skiplistmap_pollFirst(ConcurrentSkipListMap *map, void **firstKey, void **firstValue);
+
+/**
+ * Retrieves and removes the last (greatest) entry from the map, then stores the removed key and
+ * value into `*lastKey` and `*lastValue`, respectively. The key is handed over to the caller and
+ * is not passed to the key destructor.
+ *
+ * Params:
+ *    map - The map to operate on.
+ *    lastKey - The pointer address to store the removed last key into.
+ *    lastValue - The pointer address to store the removed last value into.
+ * Returns:
+ *    OK - Operation was successful.
+ *    STRUCT_EMPTY - Map is currently empty.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status skiplistmap_pollLast(ConcurrentSkipListMap *map, void **lastKey, void **lastValue);
+
+/**
+ * Removes the mapping for this key from the map if present, storing the removed value into
+ * `*value`. The key is passed to the key destructor once no other thread can still be reading it.
+ *
+ * Params:
+ *    map - The map to operate on.
+ *    key - The key whose mapping is to be removed from the map.
+ *    value - The pointer address to store the removed value into.
+ * Returns:
+ *    OK - Operation was successful.
+ *    NOT_FOUND - Entry with the specified key was not found.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status skiplistmap_remove(ConcurrentSkipListMap *map, void *key, void **value);
+
+/**
+ * Returns the number of entries in the map.
+ *
+ * Params:
+ *    map - The map to operate on.
+ * Returns:
+ *    The map's current size.
+ */
+long skiplistmap_size(ConcurrentSkipListMap *map);
+
+/**
+ * Returns TRUE if the map contains no entries, FALSE if otherwise.
+ *
+ * Params:
+ *    map - The map to operate on.
+ * Returns:
+ *    TRUE if the map is empty, FALSE if not.
+ */
+Boolean skiplistmap_isEmpty(ConcurrentSkipListMap *map);
+
+/**
+ * Destroys the map instance by freeing all of its reserved memory. Every key is passed to the key
+ * destructor, and every value to `valueDestructor` if it is not NULL. No other thread may be using
+ * the map, though nodes removed earlier may still be reclaimed afterwards.
+ *
+ * Params:
+ *    map - The map to destroy.
+ *    valueDestructor - Function to de-allocate each value, or NULL.
+ * Returns:
+ *    None
+ */
+void skiplistmap_destroy(ConcurrentSkipListMap *map, void (*valueDestructor)(void *));
+
+#endif  /* _CDS_SKIP_LIST_MAP_H__ */
@@ -0,0 +1,198 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2020 Cole Vikupitz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _CDS_SNAPSHOT_H__
+#define _CDS_SNAPSHOT_H__
+
+#include "cds_common.h"
+
+/**
+ * Interface for map snapshots, the binary on-disk format written by hashmap_saveTo() and
+ * treemap_saveTo().
+ *
+ * A snapshot holds the serialized key-value pairs of a map, followed by a table of their offsets
+ * and an open-addressing hash index over the key bytes, all of it laid out so that the file can be
+ * mapped into memory and used in place. Loading a map back from a snapshot then costs one pass
+ * over the mapped records with the table presized up front (see hashmap_loadFrom() and
+ * treemap_loadFrom()), rather than a parse and a put per line of text. A snapshot may also be
+ * opened read-only with snapshot_open(), which serves lookups straight from the mapping without
+ * deserializing anything.
+ *
+ * Keys and values are turned into bytes by serializer functions of the form:
+ *
+ *    long serialize(void *item, void *buffer, long capacity);
+ *
+ * which write the item's bytes into `buffer` if they fit in `capacity` bytes, and return the
+ * number of bytes the item needs either way; the writer retries with a larger buffer if needed.
+ * Deserializers of the form `void *deserialize(const void *bytes, long len)` turn them back into
+ * items, returning NULL if the item could not be allocated.
+ *
+ * Every record starts on an 8-byte boundary, as do the key and value bytes in it. Integers are
+ * stored in the native byte order, so snapshots only open on machines with the same byte order as
+ * the one that wrote them; any other snapshot is rejected as malformed.
+ */
+typedef struct snapshot Snapshot;
+
+/**
+ * Declaration for the snapshot writer, which streams the records of a snapshot out to a file.
+ */
+typedef struct snapshot_writer SnapshotWriter;
+
+/**
+ * Creates a writer for a new snapshot starting at the current offset of the file descriptor `fd`,
+ * which must refer to a regular file open for writing, then stores it into `*writer`.
+ *
+ * Params:
+ *    writer - The pointer address to store the new SnapshotWriter instance.
+ *    fd - The file descriptor to write the snapshot to.
+ *    keySerializer - Function serializing each key.
+ *    valueSerializer - Function serializing each value.
+ *    sorted - TRUE if the records will be added in ascending key order, FALSE if not.
+ * Returns:
+ *    OK - SnapshotWriter was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ *    IO_FAILURE - The current offset of `fd` could not be read, or a write to it failed.
+ */
+Status snapshot_writerNew(SnapshotWriter **writer, int fd,
+                          long (*keySerializer)(void *, void *, long),
+                          long (*valueSerializer)(void *, void *, long), Boolean sorted);
+
+/**
+ * Serializes the pair `key` and `value` and appends it as the next record of the snapshot. Once a
+ * call fails, every later call fails the same way, as does snapshot_writerFinish().
+ *
+ * Params:
+ *    writer - The snapshot writer to operate on.
+ *    key - The key to write.
+ *    value - The value to write.
+ * Returns:
+ *    OK - Operation was successful.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ *    IO_FAILURE - A write to the file failed.
+ */
+Status snapshot_writerAdd(SnapshotWriter *writer, void *key, void *value);
+
+/**
+ * Writes out the offset table, the hash index and the header of the snapshot, then destroys the
+ * writer. The header is written last, so a snapshot that was not finished is never mistaken for a
+ * complete one. The writer is destroyed whether or not the call succeeds.
+ *
+ * Params:
+ *    writer - The snapshot writer to finish.
+ * Returns:
+ *    OK - Operation was successful.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ *    IO_FAILURE - A write to the file failed.
+ */
+Status snapshot_writerFinish(SnapshotWriter *writer);
+
+/**
+ * Maps the snapshot starting at the current offset of the file descriptor `fd` into memory,
+ * read-only, then stores the new instance into `*snapshot`. The descriptor may be closed
+ * afterwards; the mapping stays valid until snapshot_close().
+ *
+ * Params:
+ *    snapshot - The pointer address to store the new Snapshot instance.
+ *    fd - The file descriptor to map the snapshot from.
+ * Returns:
+ *    OK - Snapshot was successfully opened.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ *    IO_FAILURE - The file could not be mapped, or does not hold a complete, well-formed snapshot
+ *                 (`errno` is then set to EINVAL).
+ */
+Status snapshot_open(Snapshot **snapshot, int fd);
+
+/**
+ * Returns the number of records in the snapshot.
+ *
+ * Params:
+ *    snapshot - The snapshot to operate on.
+ * Returns:
+ *    The number of records.
+ */
+long snapshot_size(Snapshot *snapshot);
+
+/**
+ * Returns TRUE if the snapshot's records are in ascending key order, as written by
+ * treemap_saveTo(), FALSE if not.
+ *
+ * Params:
+ *    snapshot - The snapshot to operate on.
+ * Returns:
+ *    TRUE if the records are sorted, FALSE if not.
+ */
+Boolean snapshot_isSorted(Snapshot *snapshot);
+
+/**
+ * Looks up the record whose key bytes equal the `keyLen` bytes at `key` through the snapshot's
+ * hash index, then stores a pointer to its value bytes into `*value` and their length into
+ * `*valueLen`. The bytes are read straight from the mapping and remain valid until
+ * snapshot_close().
+ *
+ * Params:
+ *    snapshot - The snapshot to operate on.
+ *    key - The serialized key to look up.
+ *    keyLen - The length of the serialized key.
+ *    value - The pointer address to store the value bytes into.
+ *    valueLen - The pointer address to store the length of the value bytes into.
+ * Returns:
+ *    OK - Operation was successful.
+ *    NOT_FOUND - No record has the key.
+ */
+Status snapshot_get(Snapshot *snapshot, const void *key, long keyLen, const void **value,
+                    long *valueLen);
+
+/**
+ * Fetches the `i`-th record of the snapshot, in the order the records were written, storing
+ * pointers to its key and value bytes and their lengths into `*key`, `*keyLen`, `*value` and
+ * `*valueLen`. The bytes remain valid until snapshot_close().
+ *
+ * Params:
+ *    snapshot - The snapshot to operate on.
+ *    i - The index of the record to fetch.
+ *    key - The pointer address to store the key bytes into.
+ *    keyLen - The pointer address to store the length of the key bytes into.
+ *    value - The pointer address to store the value bytes into.
+ *    valueLen - The pointer address to store the length of the value bytes into.
+ * Returns:
+ *    OK - Operation was successful.
+ *    INVALID_INDEX - Index given is invalid:
+ *       1.) `i` < 0
+ *       2.) `i` >= size
+ *    IO_FAILURE - The record lies outside the snapshot (`errno` is then set to EINVAL).
+ */
+Status snapshot_entry(Snapshot *snapshot, long i, const void **key, long *keyLen,
+                      const void **value, long *valueLen);
+
+/**
+ * Unmaps the snapshot and frees the instance.
+ *
+ * Params:
+ *    snapshot - The snapshot to close.
+ * Returns:
+ *    None
+ */
+void snapshot_close(Snapshot *snapshot);
+
+#endif  /* _CDS_SNAPSHOT_H__ */
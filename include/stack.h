@@ -26,6 +26,8 @@
 #define _CDS_STACK_H__
 
 #include "cds_common.h"
+#include "cursor.h"
+#include "node_pool.h"
 #include "iterator.h"
 
 /**
@@ -50,6 +52,36 @@ typedef struct stack Stack;
  */
 Status stack_new(Stack **stack);
 
+/**
+ * Creates a new stack instance whose nodes are allocated from `pool`, then stores the new instance
+ * into `*stack`. The pool may be shared with other ADTs and must outlive the stack; nodes are
+ * returned to it as elements are removed. If `pool` is NULL, a private pool is used instead, the
+ * same as stack_new().
+ *
+ * Params:
+ *    stack - The pointer address to store the new Stack instance.
+ *    pool - The pool to allocate the nodes from, or NULL.
+ * Returns:
+ *    OK - Stack was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status stack_newWithPool(Stack **stack, NodePool *pool);
+
+/**
+ * Creates a new stack instance whose struct and nodes are allocated through `allocator`, then
+ * stores the new instance into `*stack`. The nodes come from a private pool backed by the
+ * allocator.
+ *
+ * Params:
+ *    stack - The pointer address to store the new Stack instance.
+ *    allocator - The allocator to use, which must outlive the stack. If NULL, the default
+ *                allocator will be used.
+ * Returns:
+ *    OK - Stack was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the allocator.
+ */
+Status stack_newWithAllocator(Stack **stack, const CdsAllocator *allocator);
+
 /**
  * Pushes the specified element onto the stack.
  *
@@ -62,6 +94,22 @@ Status stack_new(Stack **stack);
  */
 Status stack_push(Stack *stack, void *item);
 
+/**
+ * Pushes the `n` elements in the array `items` onto the stack, in order, leaving `items[n - 1]` on
+ * top. The batch is linked onto the stack at once, so either every element is pushed or, on
+ * failure, none is.
+ *
+ * Params:
+ *    stack - The stack to operate on.
+ *    items - The array of elements to push.
+ *    n - The number of elements in `items`.
+ * Returns:
+ *    OK - Operation was successful.
+ *    INVALID_INDEX - `n` is negative.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status stack_pushAll(Stack *stack, void **items, long n);
+
 /**
  * Retrieves, but does not remove, the top element from the stack and stores the result into `*top`.
  *
@@ -86,6 +134,19 @@ Status stack_peek(Stack *stack, void **top);
  */
 Status stack_pop(Stack *stack, void **top);
 
+/**
+ * Pops up to `max` elements off the stack, storing them in LIFO order into `items` (the former
+ * top first), which must have room for `max` elements.
+ *
+ * Params:
+ *    stack - The stack to operate on.
+ *    items - The array to store the popped elements into.
+ *    max - The maximum number of elements to pop.
+ * Returns:
+ *    The number of elements popped and stored into `items`.
+ */
+long stack_popMany(Stack *stack, void **items, long max);
+
 /**
  * Removes all elements from the stack. If `destructor` is not NULL, it will be invoked on each
  * element in the stack after being removed.
@@ -148,6 +209,56 @@ Status stack_toArray(Stack *stack, Array **array);
  */
 Status stack_iterator(Stack *stack, Iterator **iter);
 
+/**
+ * Initializes `cursor` to walk over the stack's elements from top to bottom, without copying them.
+ * The elements are then fetched with stack_cursorNext(); see cursor.h for details.
+ *
+ * Params:
+ *    stack - The stack to operate on.
+ *    cursor - The cursor to initialize.
+ * Returns:
+ *    None
+ */
+void stack_cursor(Stack *stack, Cursor *cursor);
+
+/**
+ * Advances the cursor to the next element of the stack, and stores it into `*next`.
+ *
+ * Params:
+ *    cursor - The cursor to operate on.
+ *    next - The pointer address to store the next element into.
+ * Returns:
+ *    OK - Next element was returned.
+ *    ITER_END - The cursor has already visited every element.
+ *    CONCURRENT_MODIFICATION - The stack was modified after creating the cursor.
+ */
+Status stack_cursorNext(Cursor *cursor, void **next);
+
+/**
+ * Applies `action` to each element of the stack from top to bottom, passing it the element and
+ * `context`. The walk stops as soon as `action` returns FALSE. Nothing is copied or allocated, and
+ * `action` must not modify the stack while it is walked.
+ *
+ * Params:
+ *    stack - The stack to operate on.
+ *    action - Function applied to each element, returning FALSE to stop the walk.
+ *    context - Argument passed along to each call of `action`, may be NULL.
+ * Returns:
+ *    TRUE if `action` was applied to every element, FALSE if it stopped the walk early.
+ */
+Boolean stack_forEach(Stack *stack, Boolean (*action)(void *, void *), void *context);
+
+/**
+ * Returns the number of bytes of memory held by the stack: the stack itself and its nodes, not
+ * counting the elements themselves.
+ *
+ * Params:
+ *    stack - The stack to operate on.
+ * Returns:
+ *    The stack's memory usage, in bytes.
+ */
+long stack_memoryUsage(Stack *stack);
+
 /**
  * Destroys the stack instance by freeing all of its reserved memory. If `destructor` is not NULL,
  * it will be invoked on each element before the stack is destroyed.
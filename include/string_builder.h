@@ -25,6 +25,8 @@
 #ifndef _CDS_STRING_BUILDER_H__
 #define _CDS_STRING_BUILDER_H__
 
+#include <sys/uio.h>
+#include "allocator.h"
 #include "cds_common.h"
 
 /**
@@ -34,6 +36,13 @@
  * construct strings by appending and inserting string elements into the sequence. Other functions
  * such as string searching, subsequences, removals, reversing, and others are also provided.
  *
+ * A builder created with string_builder_new() keeps its characters in one contiguous buffer, so
+ * that inserting or deleting near the front moves the rest of the string. A builder created with
+ * string_builder_newRope() instead holds them in a balanced tree of fixed-size chunks (a rope),
+ * where the same edits only touch the chunks around the given index, in O(log n) time. The full
+ * API is available for both; the rope's characters are only copied into one string on
+ * string_builder_toString() (or when extracting a substring).
+ *
  * Modeled after the Java 11 StringBuilder interface.
  */
 typedef struct string_builder StringBuilder;
@@ -53,6 +62,10 @@ typedef struct string_builder StringBuilder;
  *           = 25
  * If the growth factor given is outside of the specified range, a default factor is assigned.
  *
+ * Builders with a capacity of up to 47 characters keep them in a buffer inside the builder itself,
+ * saving the separate allocation, and start out with the full 47; the characters move to the heap
+ * the first time they outgrow it.
+ *
  * Caller may also provide a string in which the builder will be initialized with its contents, or
  * NULL to create a builder instance with no content. If an initialization string is provided,
  * caller must ensure that `str` is null-terminated (if not, undefined behavior or errors may
@@ -69,6 +82,65 @@ typedef struct string_builder StringBuilder;
  */
 Status string_builder_new(StringBuilder **builder, long capacity, float growthFactor, char *str);
 
+/**
+ * Constructs a new string builder instance the same as string_builder_new(), except that its
+ * struct and heap buffer are allocated through `allocator`. Strings handed back to the caller, such
+ * as from string_builder_toString() or string_builder_detach(), are still allocated with malloc().
+ *
+ * Params:
+ *    builder - The pointer address to store the new StringBuilder instance.
+ *    capacity - The initial capacity of the string builder.
+ *    growthFactor - The percentage to increase the capacity when resizing is needed.
+ *    str - The initial contents to provide the builder, or NULL for an empty builder.
+ *    allocator - The allocator to use, which must outlive the builder. If NULL, the default
+ *                allocator will be used.
+ * Returns:
+ *    OK - StringBuilder was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the allocator.
+ */
+Status string_builder_newWithAllocator(StringBuilder **builder, long capacity, float growthFactor,
+                                       char *str, const CdsAllocator *allocator);
+
+/**
+ * Constructs a new string builder instance backed by a rope, then stores the new instance into
+ * `*builder`. The characters are held in chunks of a balanced tree instead of one buffer, so that
+ * inserts, deletions, and replacements anywhere in a large builder run in O(log n) time, at the
+ * cost of slower random access by index. The builder's capacity grows and shrinks with the chunks
+ * allocated, and string_builder_trimToSize() repacks the characters into as few chunks as
+ * possible.
+ *
+ * Caller may also provide a null-terminated string in which the builder will be initialized with
+ * its contents, or NULL to create a builder instance with no content.
+ *
+ * Params:
+ *    builder - The pointer address to store the new StringBuilder instance.
+ *    str - The initial contents to provide the builder, or NULL for an empty builder.
+ * Returns:
+ *    OK - StringBuilder was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status string_builder_newRope(StringBuilder **builder, char *str);
+
+/**
+ * Constructs a new string builder instance holding the contents of the file at `path`, mapped
+ * straight into memory instead of read, then stores the new instance into `*builder`. The file is
+ * mapped privately: its pages are only read in from disk as they are first accessed, and changes
+ * made to the builder are never written back to the file. This makes it cheap to scan very large
+ * files with the searching functions, or to write them out with string_builder_writeTo().
+ *
+ * The builder starts out full, so the first call that needs to grow (or trim) it copies the
+ * characters over to a buffer on the heap, after which it works like any other builder.
+ *
+ * Params:
+ *    builder - The pointer address to store the new StringBuilder instance.
+ *    path - The path of the regular file to map.
+ * Returns:
+ *    OK - StringBuilder was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory, or to reserve the address space.
+ *    IO_FAILURE - The file could not be opened or mapped, or is not a regular file.
+ */
+Status string_builder_newMapped(StringBuilder **builder, const char *path);
+
 /**
  * Appends the character `ch` to the builder.
  *
@@ -95,6 +167,22 @@ Status string_builder_appendChar(StringBuilder *builder, char ch);
  */
 Status string_builder_appendStr(StringBuilder *builder, char *str);
 
+/**
+ * Appends the `len` characters starting at `bytes` to the builder. Unlike appendStr(), the length
+ * is supplied by the caller rather than computed from a null terminator, so callers that already
+ * know the length of their strings avoid scanning them again. The characters are copied as is.
+ *
+ * Params:
+ *    builder - The string builder to operate on.
+ *    bytes - The characters to append.
+ *    len - The number of characters to append.
+ * Returns:
+ *    OK - Operation was successful.
+ *    INVALID_INDEX - `len` < 0.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status string_builder_appendBytes(StringBuilder *builder, const char *bytes, long len);
+
 /**
  * Appends the string representation of the boolean `b` to the builder.
  *
@@ -234,6 +322,57 @@ Status string_builder_appendStrSubSequence(StringBuilder *builder, char *str, in
  */
 Status string_builder_appendStrBuilder(StringBuilder *builder, StringBuilder *other);
 
+/**
+ * Appends each of the `count` strings in the array `strs` to the builder, in order. The builder is
+ * grown once up front for the whole batch, rather than as each string is appended. As with
+ * string_builder_appendStr(), a NULL string is appended as "null".
+ *
+ * Params:
+ *    builder - The string builder to operate on.
+ *    strs - The array of strings to append.
+ *    count - The number of strings in `strs`.
+ * Returns:
+ *    OK - Operation was successful.
+ *    INVALID_INDEX - `count` < 0.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status string_builder_appendAll(StringBuilder *builder, char **strs, long count);
+
+/**
+ * Makes sure that there's room for at least `len` more characters at the end of the builder, then
+ * stores a pointer to that room into `*tail` and the number of characters it holds into `*room`.
+ * The caller may write up to `*room` characters there directly (i.e. with snprintf() or read()),
+ * then add them to the builder with string_builder_commitTail(). The room is only valid until the
+ * builder is next modified by any other function, and its characters are not part of the builder
+ * until committed.
+ *
+ * Params:
+ *    builder - The string builder to operate on.
+ *    len - The number of characters to make room for.
+ *    tail - The pointer address to store the start of the room into.
+ *    room - The pointer address to store the size of the room into.
+ * Returns:
+ *    OK - Operation was successful.
+ *    INVALID_INDEX - `len` < 0.
+ *    STRUCT_FULL - The builder is rope-backed, so it has no contiguous room to hand out.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status string_builder_reserveTail(StringBuilder *builder, long len, char **tail, long *room);
+
+/**
+ * Adds the first `len` characters written into the room handed out by string_builder_reserveTail()
+ * to the end of the builder.
+ *
+ * Params:
+ *    builder - The string builder to operate on.
+ *    len - The number of characters written into the room.
+ * Returns:
+ *    OK - Operation was successful.
+ *    INVALID_INDEX - `len` < 0, or is larger than the room left after the builder's end.
+ *    STRUCT_FULL - The builder is rope-backed.
+ */
+Status string_builder_commitTail(StringBuilder *builder, long len);
+
 /**
  * Inserts the string representation of the character `ch` into this sequence at the specified index
  * `offset`.
@@ -271,6 +410,26 @@ Status string_builder_insertChar(StringBuilder *builder, long offset, char ch);
  */
 Status string_builder_insertStr(StringBuilder *builder, long offset, char *str);
 
+/**
+ * Inserts the `len` characters starting at `bytes` into the builder at the index `offset`. Unlike
+ * insertStr(), the length is supplied by the caller rather than computed from a null terminator.
+ * The characters are copied as is.
+ *
+ * Params:
+ *    builder - The string builder to operate on.
+ *    offset - The offset where to perform the insert.
+ *    bytes - The characters to insert.
+ *    len - The number of characters to insert.
+ * Returns:
+ *    OK - Operation was successful.
+ *    INVALID_INDEX - Index was invalid:
+ *       1.) `offset` < 0
+ *       2.) `offset` > length()
+ *       3.) `len` < 0
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status string_builder_insertBytes(StringBuilder *builder, long offset, const char *bytes, long len);
+
 /**
  * Inserts the string representation of the boolean `b` into this sequence at the specified index
  * `offset`.
@@ -780,6 +939,156 @@ long string_builder_capacity(StringBuilder *builder);
  */
 Status string_builder_toString(StringBuilder *builder, char **result);
 
+/**
+ * Returns a read-only view of the string builder's characters without copying them, and stores
+ * the builder's length into `*len`. The characters are null-terminated, but may also contain null
+ * characters of their own. The view is only valid until the builder is next modified or
+ * destroyed. A rope-backed builder does not hold its characters in one place, so NULL is returned
+ * for it instead; use string_builder_segments() to read those without a copy.
+ *
+ * Params:
+ *    builder - The string builder to operate on.
+ *    len - The pointer address to store the builder's length into.
+ * Returns:
+ *    A pointer to the builder's characters, or NULL if the builder is rope-backed.
+ */
+const char *string_builder_data(StringBuilder *builder, long *len);
+
+/**
+ * Exports the string builder's characters as a list of contiguous segments, in order, without
+ * copying them. Up to `max` segments are stored into the array `segments`, ready to be passed to
+ * writev(); the number of segments needed for the whole builder is returned, so calling with a
+ * `max` of 0 gives the size of the array to allocate. A contiguous builder has a single segment
+ * (none if empty), and a rope-backed builder has one segment per chunk. As with
+ * string_builder_data(), the segments are only valid until the builder is next modified or
+ * destroyed.
+ *
+ * Params:
+ *    builder - The string builder to operate on.
+ *    segments - The array where the segments are stored.
+ *    max - The maximum number of segments to store into `segments`.
+ * Returns:
+ *    The number of segments that make up the builder's characters.
+ */
+long string_builder_segments(StringBuilder *builder, struct iovec *segments, long max);
+
+/**
+ * Appends up to `max` characters read from the file descriptor `fd` to the builder, or all of them
+ * until the end of the input if `max` is < 0. The characters are read straight into the builder's
+ * buffer; if `fd` refers to a regular file, the room for the rest of the file is reserved once up
+ * front, so that even a large file is loaded without any resizing along the way.
+ *
+ * Params:
+ *    builder - The string builder to operate on.
+ *    fd - The file descriptor to read from.
+ *    max - The maximum number of characters to read, or < 0 to read until the end.
+ * Returns:
+ *    OK - Operation was successful.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ *    IO_FAILURE - A read from `fd` failed; the characters read before the failure are kept.
+ */
+Status string_builder_appendFromFd(StringBuilder *builder, int fd, long max);
+
+/**
+ * Appends the complete contents of the file at `path` to the builder, as with
+ * string_builder_appendFromFd().
+ *
+ * Params:
+ *    builder - The string builder to operate on.
+ *    path - The path of the file to read.
+ * Returns:
+ *    OK - Operation was successful.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ *    IO_FAILURE - The file could not be opened or read.
+ */
+Status string_builder_appendFile(StringBuilder *builder, const char *path);
+
+/**
+ * Writes the builder's characters out to the file descriptor `fd` without copying them, retrying
+ * after partial writes until all of them are written. A rope-backed builder's chunks are gathered
+ * and written with as few calls to writev() as possible.
+ *
+ * Params:
+ *    builder - The string builder to operate on.
+ *    fd - The file descriptor to write to.
+ * Returns:
+ *    OK - Operation was successful.
+ *    IO_FAILURE - A write to `fd` failed.
+ */
+Status string_builder_writeTo(StringBuilder *builder, int fd);
+
+/**
+ * Hands the string builder's buffer over to the caller without copying it, storing it into
+ * `*result`, and resets the builder to the empty string. The string is null-terminated, and is the
+ * caller's responsibility to free() when no longer needed. A rope-backed builder's chunks are
+ * joined into a newly allocated string instead, and freed; the same goes for the characters of a
+ * builder mapped from a file, which is then unmapped, for short strings still held in the
+ * builder's own buffer, and for a buffer from an allocator other than the default.
+ *
+ * Params:
+ *    builder - The string builder to operate on.
+ *    result - The pointer address to store the builder's string into.
+ * Returns:
+ *    OK - Operation was successful.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap; the builder is unchanged.
+ */
+Status string_builder_detach(StringBuilder *builder, char **result);
+
+/**
+ * Acquires an empty string builder from the calling thread's cache of released builders, and
+ * stores it into `*builder`. A builder taken from the cache keeps the buffer it had when it was
+ * released, so code that builds many short-lived strings doesn't allocate anything once the cache
+ * is warm. If the cache is empty, a new builder is created as with string_builder_new() and the
+ * default capacity and growth factor.
+ *
+ * Params:
+ *    builder - The pointer address to store the StringBuilder instance.
+ * Returns:
+ *    OK - StringBuilder was successfully acquired.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status string_builder_acquire(StringBuilder **builder);
+
+/**
+ * Releases the string builder into the calling thread's cache, for a later call to
+ * string_builder_acquire() on the same thread. The builder is cleared, and a buffer larger than
+ * CDS_BUILDER_POOL_CAPACITY (64K characters by default) is shrunk back down to that capacity, so
+ * that an outlier doesn't tie up its memory. If the cache already holds CDS_BUILDER_POOL_SIZE (8
+ * by default) builders, or the builder is backed by a rope or a mapped file, it's destroyed
+ * instead. Either way, the builder must not be used again by the caller.
+ *
+ * The builders left in a thread's cache are destroyed when the thread exits; both limits may be
+ * changed when compiling the library, i.e. DEFINES=-DCDS_BUILDER_POOL_SIZE=32.
+ *
+ * Params:
+ *    builder - The string builder to release.
+ * Returns:
+ *    None
+ */
+void string_builder_release(StringBuilder *builder);
+
+/**
+ * Destroys the builders held in the calling thread's cache, freeing their memory right away
+ * instead of when the thread exits.
+ *
+ * Params:
+ *    None
+ * Returns:
+ *    None
+ */
+void string_builder_freePool(void);
+
+/**
+ * Returns the number of bytes of memory held by the string builder: the builder itself and its
+ * buffer, mapping or rope chunks, not counting the elements themselves.
+ *
+ * Params:
+ *    builder - The string builder to operate on.
+ * Returns:
+ *    The string builder's memory usage, in bytes.
+ */
+long string_builder_memoryUsage(StringBuilder *builder);
+
 /**
  * Destroys the string builder instance by freeing all of its reserved memory.
  *
@@ -0,0 +1,219 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2020 Cole Vikupitz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef _CDS_TIMER_WHEEL_H__
+#define _CDS_TIMER_WHEEL_H__
+
+#include <stdint.h>
+#include "cds_common.h"
+
+/**
+ * Interface for the TimerWheel ADT.
+ *
+ * A timer wheel schedules items to expire at deadlines measured in ticks of some monotonic clock,
+ * such as milliseconds. Unlike a Heap ordered by deadline, scheduling and cancelling a timer both
+ * take constant time, which suits timeouts that are mostly cancelled before they ever fire.
+ *
+ * The wheel is hierarchical: four levels of 64 slots each, the first level covering the next 64
+ * ticks one tick per slot, and each following level 64 times coarser than the last. A timer is
+ * kept in the slot of the lowest level its deadline falls within, and moves down to finer levels
+ * as the clock advances towards it. Each slot is an intrusive CircularList the timers are linked
+ * into. Deadlines too far in the future for the wheel, more than 2^24 ticks away, are parked in a
+ * Heap instead, and move into the wheel once the clock gets close enough to them.
+ *
+ * The wheel never reads a clock itself: its time only moves when timerwheel_advance() is called.
+ */
+typedef struct timer_wheel TimerWheel;
+
+/**
+ * A handle to a timer scheduled with timerwheel_schedule(), used to cancel or reschedule it. Once
+ * the timer has fired or been cancelled, the handle is stale, and using it is detected and reported
+ * as NOT_FOUND for as long as the wheel exists, even if the timer's memory went to a newer timer.
+ */
+typedef struct {
+    struct wheel_timer *timer;  // The timer's memory
+    uint64_t sequence;          // The number the timer was scheduled under
+} TimerHandle;
+
+/**
+ * Constructs a new, empty timer wheel whose clock starts at `now`, then stores the new instance
+ * into `*wheel`.
+ *
+ * Params:
+ *    wheel - The pointer address to store the new TimerWheel instance.
+ *    now - The current time, in ticks.
+ * Returns:
+ *    OK - TimerWheel was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status timerwheel_new(TimerWheel **wheel, uint64_t now);
+
+/**
+ * Schedules `item` to expire at the specified deadline. A deadline that is not after the wheel's
+ * current time expires on the next call to timerwheel_advance().
+ *
+ * Params:
+ *    wheel - The timer wheel to operate on.
+ *    deadline - The time the item expires at, in ticks.
+ *    item - The item to expire.
+ *    handle - The pointer address to store the new timer's handle into, may be NULL if the timer
+ *             will never be cancelled.
+ * Returns:
+ *    OK - Operation was successful.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status timerwheel_schedule(TimerWheel *wheel, uint64_t deadline, void *item, TimerHandle *handle);
+
+/**
+ * Moves a pending timer to a new deadline in constant time (unless either deadline lies beyond the
+ * wheel's range), without allocating a new handle.
+ *
+ * Params:
+ *    wheel - The timer wheel to operate on.
+ *    handle - The handle of the timer to move.
+ *    deadline - The new time the timer expires at, in ticks.
+ * Returns:
+ *    OK - Operation was successful.
+ *    NOT_FOUND - The timer has already fired or been cancelled.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap; the timer keeps its previous
+ *                    deadline.
+ */
+Status timerwheel_reschedule(TimerWheel *wheel, TimerHandle handle, uint64_t deadline);
+
+/**
+ * Cancels a pending timer in constant time (unless its deadline lies beyond the wheel's range),
+ * and stores its item into `*item`. The handle is stale afterwards.
+ *
+ * Params:
+ *    wheel - The timer wheel to operate on.
+ *    handle - The handle of the timer to cancel.
+ *    item - The pointer address to store the cancelled timer's item into.
+ * Returns:
+ *    OK - Operation was successful.
+ *    NOT_FOUND - The timer has already fired or been cancelled.
+ */
+Status timerwheel_cancel(TimerWheel *wheel, TimerHandle handle, void **item);
+
+/**
+ * Advances the wheel's clock to `now`, expiring every timer whose deadline is no later than `now`.
+ * Each expired timer is removed from the wheel, then `expire` is invoked with its item, its
+ * deadline, and `context`. Timers expiring in the same call are not expired in any particular
+ * order. The callback may schedule and cancel timers; those it schedules for a time no later than
+ * `now` expire on the next call. If `now` is earlier than the wheel's current time, the clock is
+ * left where it is, and only the timers already due are expired.
+ *
+ * The work done is proportional to the number of timers expired or moved down a level, not to the
+ * number of ticks advanced.
+ *
+ * Params:
+ *    wheel - The timer wheel to operate on.
+ *    now - The current time, in ticks.
+ *    expire - Function invoked on each expired timer, may be NULL.
+ *    context - Argument passed along to `expire`.
+ * Returns:
+ *    The number of timers expired.
+ */
+long timerwheel_advance(TimerWheel *wheel, uint64_t now,
+                        void (*expire)(void *, uint64_t, void *), void *context);
+
+/**
+ * Retrieves the earliest deadline among the pending timers, which may already have passed, so a
+ * caller may sleep until then.
+ *
+ * Params:
+ *    wheel - The timer wheel to operate on.
+ *    deadline - The pointer address to store the earliest deadline into.
+ * Returns:
+ *    OK - Operation was successful.
+ *    STRUCT_EMPTY - No timers are pending.
+ */
+Status timerwheel_nextDeadline(TimerWheel *wheel, uint64_t *deadline);
+
+/**
+ * Returns the wheel's current time, as last set by timerwheel_new() or timerwheel_advance().
+ *
+ * Params:
+ *    wheel - The timer wheel to operate on.
+ * Returns:
+ *    The current time, in ticks.
+ */
+uint64_t timerwheel_now(TimerWheel *wheel);
+
+/**
+ * Returns the number of pending timers in the timer wheel.
+ *
+ * Params:
+ *    wheel - The timer wheel to operate on.
+ * Returns:
+ *    The number of pending timers.
+ */
+long timerwheel_size(TimerWheel *wheel);
+
+/**
+ * Returns TRUE if the timer wheel has no pending timers, FALSE if otherwise.
+ *
+ * Params:
+ *    wheel - The timer wheel to operate on.
+ * Returns:
+ *    TRUE if the timer wheel is empty, FALSE if not.
+ */
+Boolean timerwheel_isEmpty(TimerWheel *wheel);
+
+/**
+ * Cancels every pending timer, making all handles stale. If `destructor` is not NULL, it will be
+ * invoked on each cancelled timer's item.
+ *
+ * Params:
+ *    wheel - The timer wheel to operate on.
+ *    destructor - Function to operate on each item after its timer is cancelled.
+ * Returns:
+ *    None
+ */
+void timerwheel_clear(TimerWheel *wheel, void (*destructor)(void *));
+
+/**
+ * Returns the total number of bytes of heap memory held by the timer wheel, including its slots,
+ * timers and overflow heap. The memory held by the items themselves is not counted.
+ *
+ * Params:
+ *    wheel - The timer wheel to operate on.
+ * Returns:
+ *    The timer wheel's memory usage, in bytes.
+ */
+long timerwheel_memoryUsage(TimerWheel *wheel);
+
+/**
+ * Destroys the timer wheel instance by freeing all of its reserved memory. If `destructor` is not
+ * NULL, it will be invoked on the item of each pending timer.
+ *
+ * Params:
+ *    wheel - The timer wheel to destroy.
+ *    destructor - Function to operate on each item of the pending timers.
+ * Returns:
+ *    None
+ */
+void timerwheel_destroy(TimerWheel *wheel, void (*destructor)(void *));
+
+#endif  /* _CDS_TIMER_WHEEL_H__ */
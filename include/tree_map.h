@@ -26,6 +26,8 @@
 #define _CDS_TREEMAP_H__
 
 #include "cds_common.h"
+#include "cursor.h"
+#include "node_pool.h"
 #include "iterator.h"
 
 /**
@@ -33,6 +35,9 @@
  *
  * This ADT stores the key-value pairings in the TreeMap ADT and are provided back to the caller
  * from invocations to toArray() and iterator().
+ *
+ * Entries live inside the treemap's nodes, so a `TmEntry*` handle stays valid until its entry is
+ * removed from the treemap (or the treemap is cleared or destroyed).
  */
 typedef struct tm_entry TmEntry;
 
@@ -69,6 +74,79 @@ typedef struct treemap TreeMap;
 Status treemap_new(TreeMap **tree, int (*keyComparator)(void *, void *),
                    void (*keyDestructor)(void *));
 
+/**
+ * Creates a new treemap instance whose nodes are allocated from `pool`, then stores the new instance
+ * into `*tree`. The pool may be shared with other ADTs and must outlive the treemap. If
+ * `pool` is NULL, a private pool is used instead, the same as treemap_new().
+ *
+ * Params:
+ *    tree - The pointer address to store the new TreeMap instance.
+ *    keyComparator - Function for comparing two keys in the treemap.
+ *    keyDestructor - Function for de-allocating the treemap's keys.
+ *    pool - The pool to allocate the nodes from, or NULL.
+ * Returns:
+ *    OK - TreeMap was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status treemap_newWithPool(TreeMap **tree, int (*keyComparator)(void *, void *),
+                           void (*keyDestructor)(void *), NodePool *pool);
+
+/**
+ * Creates a new treemap instance whose struct and nodes are allocated through `allocator`, then
+ * stores the new instance into `*tree`. The nodes come from a private pool backed by the allocator.
+ *
+ * Params:
+ *    tree - The pointer address to store the new TreeMap instance.
+ *    keyComparator - Function for comparing two keys in the treemap.
+ *    keyDestructor - Function for de-allocating the treemap's keys.
+ *    allocator - The allocator to use, which must outlive the treemap. If NULL, the default
+ *                allocator will be used.
+ * Returns:
+ *    OK - TreeMap was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the allocator.
+ */
+Status treemap_newWithAllocator(TreeMap **tree, int (*keyComparator)(void *, void *),
+                                void (*keyDestructor)(void *), const CdsAllocator *allocator);
+
+/**
+ * Creates a new treemap instance holding the `n` entries `keys[i]` -> `values[i]`, then stores the
+ * new instance into `*tree`. The keys must already be sorted in strictly ascending order by
+ * `keyComparator` (this is not checked), which lets the tree be built balanced and colored in a
+ * single linear pass, with no searches or rotations. If `values` is NULL, every value is NULL. The
+ * arrays themselves are not kept by the treemap.
+ *
+ * Params:
+ *    tree - The pointer address to store the new TreeMap instance.
+ *    keyComparator - Function for comparing two keys in the treemap.
+ *    keyDestructor - Function for de-allocating the treemap's keys.
+ *    keys - The sorted keys to insert.
+ *    values - The values to map each key to, or NULL.
+ *    n - The number of entries to insert.
+ * Returns:
+ *    OK - TreeMap was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status treemap_fromSorted(TreeMap **tree, int (*keyComparator)(void *, void *),
+                          void (*keyDestructor)(void *), void **keys, void **values, long n);
+
+/**
+ * Creates a new treemap instance backed by a B+-tree instead of a red-black tree, then stores the
+ * new instance into `*tree`. Entries are kept sorted in wide leaves chained in key order, so
+ * lookups and ordered traversals touch far fewer cache lines. Unlike the red-black tree, entries
+ * move between leaves as the tree changes, so any TmEntry handle obtained from it is only valid
+ * until the next insertion or removal.
+ *
+ * Params:
+ *    tree - The pointer address to store the new TreeMap instance.
+ *    keyComparator - Function for comparing two keys in the treemap.
+ *    keyDestructor - Function for de-allocating the treemap's keys.
+ * Returns:
+ *    OK - TreeMap was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status treemap_newBTree(TreeMap **tree, int (*keyComparator)(void *, void *),
+                        void (*keyDestructor)(void *));
+
 /**
  * Associates the specified value with the specified key in the treemap. If the treemap previously
  * contained a mapping for the key, the old value is replaced, and stored into `*previous`.
@@ -281,6 +359,53 @@ Boolean treemap_containsKey(TreeMap *tree, void *key);
  */
 Status treemap_get(TreeMap *tree, void *key, void **value);
 
+/**
+ * Fetches the entry with the `k`-th smallest key in the treemap (counting from 0), and stores it
+ * into `*entry`. Each node of the red-black tree tracks the size of its subtree, so this takes a
+ * single descent; on the B+-tree engine, the leaves are walked instead.
+ *
+ * Params:
+ *    tree - The treemap to operate on.
+ *    k - The rank of the entry to fetch.
+ *    entry - The pointer address to store the entry into.
+ * Returns:
+ *    OK - Operation was successful.
+ *    STRUCT_EMPTY - TreeMap is currently empty.
+ *    INVALID_INDEX - Rank given is invalid:
+ *       1.) `k` < 0
+ *       2.) `k` >= size
+ */
+Status treemap_select(TreeMap *tree, long k, TmEntry **entry);
+
+/**
+ * Returns the number of keys in the treemap that are less than `key`, which is also the rank that
+ * treemap_select() fetches `key` at if it is present.
+ *
+ * Params:
+ *    tree - The treemap to operate on.
+ *    key - The key to rank.
+ * Returns:
+ *    The number of keys less than `key`.
+ */
+long treemap_rank(TreeMap *tree, void *key);
+
+/**
+ * Returns the number of keys in the treemap that range from `fromKey` to `toKey`, each bound
+ * included if its flag is TRUE. The keys are counted without being visited, so this is cheaper
+ * than walking the range with treemap_subMap().
+ *
+ * Params:
+ *    tree - The treemap to operate on.
+ *    fromKey - The low endpoint of the range.
+ *    fromInclusive - TRUE if `fromKey` belongs to the range, FALSE if not.
+ *    toKey - The high endpoint of the range.
+ *    toInclusive - TRUE if `toKey` belongs to the range, FALSE if not.
+ * Returns:
+ *    The number of keys within the range.
+ */
+long treemap_countRange(TreeMap *tree, void *fromKey, Boolean fromInclusive, void *toKey,
+                        Boolean toInclusive);
+
 /**
  * Retrieves and removes the first (least) entry from the treemap, then stores the removed key and
  * value into `*firstKey` and `*firstValue`, respectively.
@@ -323,6 +448,53 @@ Status treemap_pollLast(TreeMap *tree, void **lastKey, void **lastValue);
  */
 Status treemap_remove(TreeMap *tree, void *key, void **value);
 
+/**
+ * Associates each of the `n` keys in `keys` with the value at the same index in `values`, as if by
+ * calling treemap_put() on each pair in order. If `previous` is not NULL, the value replaced by the
+ * i-th pair is stored into `previous[i]` (or NULL if its key was newly inserted).
+ *
+ * Params:
+ *    tree - The treemap to operate on.
+ *    keys - The array of keys to insert.
+ *    values - The array of values to associate with the keys.
+ *    n - The number of key-value pairs.
+ *    previous - Array of `n` slots to store the replaced values into, or NULL.
+ * Returns:
+ *    OK - Operation was successful.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap; the pairs before the one that
+ *                    failed were inserted.
+ */
+Status treemap_putAll(TreeMap *tree, void **keys, void **values, long n, void **previous);
+
+/**
+ * Fetches the values to which each of the `n` keys in `keys` are mapped, and stores them into
+ * `values` at the same indices (or NULL if the key is not present).
+ *
+ * Params:
+ *    tree - The treemap to operate on.
+ *    keys - The array of keys to look up.
+ *    values - Array of `n` slots to store the fetched values into.
+ *    n - The number of keys.
+ * Returns:
+ *    The number of keys that were found in the treemap.
+ */
+long treemap_getAll(TreeMap *tree, void **keys, void **values, long n);
+
+/**
+ * Removes the mappings for each of the `n` keys in `keys` from the treemap if present. If `values`
+ * is not NULL, the value removed for the i-th key is stored into `values[i]` (or NULL if the key
+ * was not present).
+ *
+ * Params:
+ *    tree - The treemap to operate on.
+ *    keys - The array of keys whose mappings are to be removed.
+ *    values - Array of `n` slots to store the removed values into, or NULL.
+ *    n - The number of keys.
+ * Returns:
+ *    The number of mappings that were removed.
+ */
+long treemap_removeAll(TreeMap *tree, void **keys, void **values, long n);
+
 /**
  * Removes all elements from the treemap. If `valueDestructor` is not NULL, it will be invoked on
  * each element in the treemap after being removed.
@@ -386,6 +558,24 @@ Status treemap_keyArray(TreeMap *tree, Array **keys);
  */
 Status treemap_entryArray(TreeMap *tree, Array **entries);
 
+/**
+ * Allocates and generates an array containing copies of all the treemap's entries in proper
+ * sequence (defined by the key comparator, from least to greatest), then stores the array into
+ * `*entries`. Unlike treemap_entryArray(), the `TmEntry*` items are private copies held in the
+ * same allocation as the array, so they remain valid after the treemap is modified or destroyed.
+ * Caller is responsible for freeing the array with FREE_ARRAY() when finished; the keys and values
+ * themselves are not copied.
+ *
+ * Params:
+ *    tree - The treemap to operate on.
+ *    entries - Address where the entry copies will be stored.
+ * Returns:
+ *    OK - Operation was successful.
+ *    STRUCT_EMPTY - TreeMap is currently empty.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status treemap_entrySnapshot(TreeMap *tree, Array **entries);
+
 /**
  * Creates an Iterator instance to iterate over the treemap's elements in proper sequence (defined
  * by the key's comparator, from least to greatest), then stores the iterator into `*iter`. Note
@@ -402,6 +592,193 @@ Status treemap_entryArray(TreeMap *tree, Array **entries);
  */
 Status treemap_iterator(TreeMap *tree, Iterator **iter);
 
+/**
+ * Initializes `cursor` to walk over the treemap's entries in ascending order, without copying them
+ * (the items visited are `TmEntry*` values). The entries are then fetched with treemap_cursorNext();
+ * see cursor.h for details.
+ *
+ * Params:
+ *    tree - The treemap to operate on.
+ *    cursor - The cursor to initialize.
+ * Returns:
+ *    None
+ */
+void treemap_cursor(TreeMap *tree, Cursor *cursor);
+
+/**
+ * Initializes `cursor` to walk, in ascending order, over the treemap's entries whose keys range
+ * from `fromKey` to `toKey`, each bound included if its flag is TRUE. Only the first entry is
+ * searched for; the rest are reached by walking forward, so short range scans cost one descent.
+ * A NULL key leaves that side of the range open. The entries are then fetched with
+ * treemap_cursorNext(); see cursor.h for details.
+ *
+ * Params:
+ *    tree - The treemap to operate on.
+ *    fromKey - The low endpoint of the range.
+ *    fromInclusive - TRUE if `fromKey` belongs to the range, FALSE if not.
+ *    toKey - The high endpoint of the range.
+ *    toInclusive - TRUE if `toKey` belongs to the range, FALSE if not.
+ *    cursor - The cursor to initialize.
+ * Returns:
+ *    None
+ */
+void treemap_subMap(TreeMap *tree, void *fromKey, Boolean fromInclusive, void *toKey,
+                    Boolean toInclusive, Cursor *cursor);
+
+/**
+ * Initializes `cursor` to walk over the treemap's entries whose keys are less than (or if
+ * `inclusive` is TRUE, equal to) `toKey`, the same as treemap_subMap() with no low endpoint.
+ *
+ * Params:
+ *    tree - The treemap to operate on.
+ *    toKey - The high endpoint of the range.
+ *    inclusive - TRUE if `toKey` belongs to the range, FALSE if not.
+ *    cursor - The cursor to initialize.
+ * Returns:
+ *    None
+ */
+void treemap_headMap(TreeMap *tree, void *toKey, Boolean inclusive, Cursor *cursor);
+
+/**
+ * Initializes `cursor` to walk over the treemap's entries whose keys are greater than (or if
+ * `inclusive` is TRUE, equal to) `fromKey`, the same as treemap_subMap() with no high endpoint.
+ *
+ * Params:
+ *    tree - The treemap to operate on.
+ *    fromKey - The low endpoint of the range.
+ *    inclusive - TRUE if `fromKey` belongs to the range, FALSE if not.
+ *    cursor - The cursor to initialize.
+ * Returns:
+ *    None
+ */
+void treemap_tailMap(TreeMap *tree, void *fromKey, Boolean inclusive, Cursor *cursor);
+
+/**
+ * Advances the cursor to the next entry of the treemap, and stores it into `*next`.
+ *
+ * Params:
+ *    cursor - The cursor to operate on.
+ *    next - The pointer address to store the next entry into.
+ * Returns:
+ *    OK - Next entry was returned.
+ *    ITER_END - The cursor has already visited every entry.
+ *    CONCURRENT_MODIFICATION - The treemap was modified after creating the cursor.
+ */
+Status treemap_cursorNext(Cursor *cursor, void **next);
+
+/**
+ * Applies `action` to each entry of the treemap in ascending order of their keys, passing it the
+ * entry's key, its value and `context`. The walk stops as soon as `action` returns FALSE. Nothing
+ * is copied or allocated, and `action` must not modify the treemap while it is walked.
+ *
+ * Params:
+ *    tree - The treemap to operate on.
+ *    action - Function applied to each entry, returning FALSE to stop the walk.
+ *    context - Argument passed along to each call of `action`, may be NULL.
+ * Returns:
+ *    TRUE if `action` was applied to every entry, FALSE if it stopped the walk early.
+ */
+Boolean treemap_forEach(TreeMap *tree, Boolean (*action)(void *, void *, void *), void *context);
+
+/**
+ * Applies `action` to each entry of the treemap, passing it the entry's key, its value and
+ * `context`, using up to `nthreads` threads (64 at most). The entries are split into one even run
+ * of consecutive keys per thread, each run starting at the entry of its rank, and each thread is
+ * given at least 16K entries, so a smaller treemap, or an `nthreads` <= 1, is walked on the calling
+ * thread. Each run is walked in ascending order but the runs are walked concurrently, and once
+ * `action` returns FALSE every thread stops at its next entry. `action` must be safe to call from
+ * several threads at once, and must not modify the treemap.
+ *
+ * Params:
+ *    tree - The treemap to operate on.
+ *    nthreads - The most threads to walk with, including the calling thread.
+ *    action - Function applied to each entry, returning FALSE to stop the walk.
+ *    context - Argument passed along to each call of `action`, may be NULL.
+ * Returns:
+ *    TRUE if `action` was applied to every entry, FALSE if it stopped the walk early.
+ */
+Boolean treemap_parallelForEach(TreeMap *tree, int nthreads,
+                                Boolean (*action)(void *, void *, void *), void *context);
+
+/**
+ * Reduces the entries of the treemap to a single result using up to `nthreads` threads, split as
+ * with treemap_parallelForEach(). Each thread folds its run in ascending order, calling `reducer`
+ * with its result so far (NULL for the run's first entry), the entry's key, its value and
+ * `context`, and keeping what it returns. The runs' results are then merged in ascending order on
+ * the calling thread, calling `combiner` with the result so far, the next run's result and
+ * `context`. `reducer` must be safe to call from several threads at once, and neither function may
+ * modify the treemap.
+ *
+ * Params:
+ *    tree - The treemap to operate on.
+ *    nthreads - The most threads to reduce with, including the calling thread.
+ *    reducer - Function folding an entry into a run's result.
+ *    combiner - Function merging two runs' results.
+ *    context - Argument passed along to each call of `reducer` and `combiner`, may be NULL.
+ * Returns:
+ *    The reduced result, or NULL if the treemap is empty.
+ */
+void *treemap_parallelReduce(TreeMap *tree, int nthreads,
+                             void *(*reducer)(void *, void *, void *, void *),
+                             void *(*combiner)(void *, void *, void *), void *context);
+
+/**
+ * Writes the treemap's entries out to the file descriptor `fd`, starting at its current offset, as
+ * a snapshot (see snapshot.h) in ascending key order, which treemap_loadFrom() reads back, or
+ * snapshot_open() maps for read-only lookups. Each key and value is turned into bytes by
+ * `keySerializer` and `valueSerializer`, whose contract is described in snapshot.h.
+ *
+ * Params:
+ *    tree - The treemap to operate on.
+ *    fd - The file descriptor to write the snapshot to, a regular file open for writing.
+ *    keySerializer - Function serializing each key.
+ *    valueSerializer - Function serializing each value.
+ * Returns:
+ *    OK - Operation was successful.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ *    IO_FAILURE - A write to the file failed.
+ */
+Status treemap_saveTo(TreeMap *tree, int fd, long (*keySerializer)(void *, void *, long),
+                      long (*valueSerializer)(void *, void *, long));
+
+/**
+ * Maps the snapshot starting at the current offset of the file descriptor `fd` into memory and
+ * inserts each of its records into the treemap, turning their bytes back into keys and values with
+ * `keyDeserializer` and `valueDeserializer`. If the treemap is empty, red-black, and the snapshot's
+ * keys turn out to be in strictly ascending order (as written by treemap_saveTo()), the tree is
+ * built balanced in one linear pass as with treemap_fromSorted(); otherwise each record is put in
+ * turn. Records whose key is already present replace the current value, which is passed to
+ * `valueDestructor` (if not NULL) along with the duplicate key being passed to the treemap's key
+ * destructor. If loading fails partway, the records put so far are kept, while a tree being built
+ * in one pass is left empty.
+ *
+ * Params:
+ *    tree - The treemap to operate on.
+ *    fd - The file descriptor to read the snapshot from.
+ *    keyDeserializer - Function turning key bytes back into a key, NULL if allocation fails.
+ *    valueDeserializer - Function turning value bytes back into a value, NULL if allocation fails.
+ *    valueDestructor - Function to operate on each replaced value, may be NULL.
+ * Returns:
+ *    OK - Operation was successful.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ *    IO_FAILURE - The file could not be mapped, or does not hold a complete, well-formed snapshot
+ *                 (`errno` is then set to EINVAL).
+ */
+Status treemap_loadFrom(TreeMap *tree, int fd, void *(*keyDeserializer)(const void *, long),
+                        void *(*valueDeserializer)(const void *, long),
+                        void (*valueDestructor)(void *));
+
+/**
+ * Returns the number of bytes of memory held by the treemap: the treemap itself and its nodes,
+ * not counting the keys and values.
+ *
+ * Params:
+ *    tree - The treemap to operate on.
+ * Returns:
+ *    The treemap's memory usage, in bytes.
+ */
+long treemap_memoryUsage(TreeMap *tree);
+
 /**
  * Destroys the treemap instance by freeing all of its reserved memory. If `valueDestructor` is not
  * NULL, it will be invoked on each entry's value before the treemap is destroyed.
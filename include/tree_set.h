@@ -26,6 +26,8 @@
 #define _CDS_TREESET_H__
 
 #include "cds_common.h"
+#include "cursor.h"
+#include "node_pool.h"
 #include "iterator.h"
 
 /**
@@ -54,6 +56,54 @@ typedef struct treeset TreeSet;
  */
 Status treeset_new(TreeSet **tree, int (*comparator)(void *, void *));
 
+/**
+ * Creates a new treeset instance whose nodes are allocated from `pool`, then stores the new instance
+ * into `*tree`. The pool may be shared with other ADTs and must outlive the treeset. If
+ * `pool` is NULL, a private pool is used instead, the same as treeset_new().
+ *
+ * Params:
+ *    tree - The pointer address to store the new TreeSet instance.
+ *    comparator - Function for comparing two items in the treeset.
+ *    pool - The pool to allocate the nodes from, or NULL.
+ * Returns:
+ *    OK - TreeSet was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status treeset_newWithPool(TreeSet **tree, int (*comparator)(void *, void *), NodePool *pool);
+
+/**
+ * Creates a new treeset instance whose struct and nodes are allocated through `allocator`, then
+ * stores the new instance into `*tree`. The nodes come from a private pool backed by the allocator.
+ *
+ * Params:
+ *    tree - The pointer address to store the new TreeSet instance.
+ *    comparator - Function for comparing two items in the treeset.
+ *    allocator - The allocator to use, which must outlive the treeset. If NULL, the default
+ *                allocator will be used.
+ * Returns:
+ *    OK - TreeSet was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the allocator.
+ */
+Status treeset_newWithAllocator(TreeSet **tree, int (*comparator)(void *, void *),
+                                const CdsAllocator *allocator);
+
+/**
+ * Creates a new treeset instance holding the `n` items in `items`, then stores the new instance
+ * into `*tree`. The items must already be sorted in strictly ascending order by `comparator` (this
+ * is not checked), which lets the tree be built balanced and colored in a single linear pass, with
+ * no searches or rotations. The array itself is not kept by the treeset.
+ *
+ * Params:
+ *    tree - The pointer address to store the new TreeSet instance.
+ *    comparator - Function for comparing two items in the treeset.
+ *    items - The sorted items to insert.
+ *    n - The number of items to insert.
+ * Returns:
+ *    OK - TreeSet was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status treeset_fromSorted(TreeSet **tree, int (*comparator)(void *, void *), void **items, long n);
+
 /**
  * Adds the specified element to the treeset if it is not already present.
  *
@@ -204,6 +254,83 @@ Status treeset_pollLast(TreeSet *tree, void **last);
  */
 Status treeset_remove(TreeSet *tree, void *item, void (*destructor)(void *));
 
+/**
+ * Adds each of the `n` elements in `items` into the treeset, as if by calling treeset_add() on each
+ * of them in order; elements already present are skipped.
+ *
+ * Params:
+ *    tree - The treeset to operate on.
+ *    items - The array of elements to add.
+ *    n - The number of elements.
+ * Returns:
+ *    OK - Operation was successful.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap; the elements before the one
+ *                    that failed were added.
+ */
+Status treeset_addAll(TreeSet *tree, void **items, long n);
+
+/**
+ * Removes each of the `n` elements in `items` from the treeset if present. If `destructor` is not
+ * NULL, it will be invoked on each element removed.
+ *
+ * Params:
+ *    tree - The treeset to operate on.
+ *    items - The array of elements to remove.
+ *    n - The number of elements.
+ *    destructor - Function to operate on each element after removal.
+ * Returns:
+ *    The number of elements that were removed.
+ */
+long treeset_removeAll(TreeSet *tree, void **items, long n, void (*destructor)(void *));
+
+/**
+ * Creates a new treeset holding every element found in either `a` or `b`, then stores the new
+ * instance into `*result`. Both treesets are walked in order side by side, and the result is built
+ * balanced in a single pass, so this takes O(n + m) time. The result uses the comparator of `a`,
+ * which must order both treesets the same way, and shares their elements rather than copying them
+ * (taking those of `a` for the elements in both), so it should be destroyed with a NULL destructor.
+ *
+ * Params:
+ *    a - The first treeset.
+ *    b - The second treeset.
+ *    result - The pointer address to store the new TreeSet instance.
+ * Returns:
+ *    OK - Operation was successful.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status treeset_union(TreeSet *a, TreeSet *b, TreeSet **result);
+
+/**
+ * Creates a new treeset holding the elements of `a` that are also found in `b`, then stores the
+ * new instance into `*result`. Takes O(n + m) time like treeset_union(), or O(n log m) if one
+ * treeset is much smaller than the other, as its elements are then looked up in the larger one.
+ * The result shares the elements of `a`, see treeset_union().
+ *
+ * Params:
+ *    a - The first treeset.
+ *    b - The second treeset.
+ *    result - The pointer address to store the new TreeSet instance.
+ * Returns:
+ *    OK - Operation was successful.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status treeset_intersect(TreeSet *a, TreeSet *b, TreeSet **result);
+
+/**
+ * Creates a new treeset holding the elements of `a` that are not found in `b`, then stores the new
+ * instance into `*result`. Takes O(n + m) time like treeset_union(), or O(n log m) if `a` is much
+ * smaller than `b`. The result shares the elements of `a`, see treeset_union().
+ *
+ * Params:
+ *    a - The first treeset.
+ *    b - The second treeset.
+ *    result - The pointer address to store the new TreeSet instance.
+ * Returns:
+ *    OK - Operation was successful.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status treeset_difference(TreeSet *a, TreeSet *b, TreeSet **result);
+
 /**
  * Removes all elements from the treeset. If `destructor` is not NULL, it will be invoked on each
  * element in the treeset after being removed.
@@ -266,6 +393,104 @@ Status treeset_toArray(TreeSet *tree, Array **array);
  */
 Status treeset_iterator(TreeSet *tree, Iterator **iter);
 
+/**
+ * Initializes `cursor` to walk over the treeset's elements in ascending order, without copying
+ * them. The elements are then fetched with treeset_cursorNext(); see cursor.h for details.
+ *
+ * Params:
+ *    tree - The treeset to operate on.
+ *    cursor - The cursor to initialize.
+ * Returns:
+ *    None
+ */
+void treeset_cursor(TreeSet *tree, Cursor *cursor);
+
+/**
+ * Initializes `cursor` to walk, in ascending order, over the treeset's elements ranging from
+ * `fromItem` to `toItem`, each bound included if its flag is TRUE. Only the first element is
+ * searched for; the rest are reached by walking forward, so short range scans cost one descent.
+ * A NULL item leaves that side of the range open. The elements are then fetched with
+ * treeset_cursorNext(); see cursor.h for details.
+ *
+ * Params:
+ *    tree - The treeset to operate on.
+ *    fromItem - The low endpoint of the range.
+ *    fromInclusive - TRUE if `fromItem` belongs to the range, FALSE if not.
+ *    toItem - The high endpoint of the range.
+ *    toInclusive - TRUE if `toItem` belongs to the range, FALSE if not.
+ *    cursor - The cursor to initialize.
+ * Returns:
+ *    None
+ */
+void treeset_subSet(TreeSet *tree, void *fromItem, Boolean fromInclusive, void *toItem,
+                    Boolean toInclusive, Cursor *cursor);
+
+/**
+ * Initializes `cursor` to walk over the treeset's elements less than (or if `inclusive` is TRUE,
+ * equal to) `toItem`, the same as treeset_subSet() with no low endpoint.
+ *
+ * Params:
+ *    tree - The treeset to operate on.
+ *    toItem - The high endpoint of the range.
+ *    inclusive - TRUE if `toItem` belongs to the range, FALSE if not.
+ *    cursor - The cursor to initialize.
+ * Returns:
+ *    None
+ */
+void treeset_headSet(TreeSet *tree, void *toItem, Boolean inclusive, Cursor *cursor);
+
+/**
+ * Initializes `cursor` to walk over the treeset's elements greater than (or if `inclusive` is TRUE,
+ * equal to) `fromItem`, the same as treeset_subSet() with no high endpoint.
+ *
+ * Params:
+ *    tree - The treeset to operate on.
+ *    fromItem - The low endpoint of the range.
+ *    inclusive - TRUE if `fromItem` belongs to the range, FALSE if not.
+ *    cursor - The cursor to initialize.
+ * Returns:
+ *    None
+ */
+void treeset_tailSet(TreeSet *tree, void *fromItem, Boolean inclusive, Cursor *cursor);
+
+/**
+ * Advances the cursor to the next element of the treeset, and stores it into `*next`.
+ *
+ * Params:
+ *    cursor - The cursor to operate on.
+ *    next - The pointer address to store the next element into.
+ * Returns:
+ *    OK - Next element was returned.
+ *    ITER_END - The cursor has already visited every element.
+ *    CONCURRENT_MODIFICATION - The treeset was modified after creating the cursor.
+ */
+Status treeset_cursorNext(Cursor *cursor, void **next);
+
+/**
+ * Applies `action` to each element of the treeset in ascending order, passing it the element and
+ * `context`. The walk stops as soon as `action` returns FALSE. Nothing is copied or allocated, and
+ * `action` must not modify the treeset while it is walked.
+ *
+ * Params:
+ *    tree - The treeset to operate on.
+ *    action - Function applied to each element, returning FALSE to stop the walk.
+ *    context - Argument passed along to each call of `action`, may be NULL.
+ * Returns:
+ *    TRUE if `action` was applied to every element, FALSE if it stopped the walk early.
+ */
+Boolean treeset_forEach(TreeSet *tree, Boolean (*action)(void *, void *), void *context);
+
+/**
+ * Returns the number of bytes of memory held by the treeset: the treeset itself and its nodes,
+ * not counting the elements themselves.
+ *
+ * Params:
+ *    tree - The treeset to operate on.
+ * Returns:
+ *    The treeset's memory usage, in bytes.
+ */
+long treeset_memoryUsage(TreeSet *tree);
+
 /**
  * Destroys the treeset instance by freeing all of its reserved memory. If `destructor` is not NULL,
  * it will be invoked on each element before the treeset is destroyed.
@@ -0,0 +1,399 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2020 Cole Vikupitz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _CDS_TS_ARRAYDEQUE_H__
+#define _CDS_TS_ARRAYDEQUE_H__
+
+#include "cds_common.h"
+#include "ts_lock.h"
+#include "ts_iterator.h"
+
+/**
+ * Interface for the thread-safe ArrayDeque ADT.
+ *
+ * The ArrayDeque class is a double ended queue of elements stored in a resizable circular array.
+ * Elements may be added or removed at either end in constant time, and, unlike the LinkedList,
+ * any element may also be fetched or replaced by its index in constant time. Inserting or removing
+ * in the middle only shifts the elements on the shorter side of the index.
+ *
+ * Modeled after the Java 7 ArrayDeque interface, with the indexed methods of the List interface.
+ */
+typedef struct ts_arraydeque ConcurrentArrayDeque;
+
+/**
+ * Constructs a new array deque instance with the specified starting capacity, then stores the new
+ * instance into `*deque`. The capacity is rounded up to the next power of two; if the capacity
+ * given is <= 0, a default capacity is assigned.
+ *
+ * Params:
+ *    deque - The pointer address to store the new ArrayDeque instance.
+ *    capacity - The default capacity of the deque.
+ * Returns:
+ *    OK - ArrayDeque was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status ts_arraydeque_new(ConcurrentArrayDeque **deque, long capacity);
+
+/**
+ * Locks the deque, providing exclusive access to the calling thread. Caller is responsible for
+ * unlocking the deque to allow other threads access.
+ *
+ * Params:
+ *    deque - The deque to operate on.
+ * Returns:
+ *    None
+ */
+void ts_arraydeque_lock(ConcurrentArrayDeque *deque);
+
+/**
+ * Unlocks the deque, releasing the exclusive access from the calling thread.
+ *
+ * Params:
+ *    deque - The deque to operate on.
+ * Returns:
+ *    None
+ */
+void ts_arraydeque_unlock(ConcurrentArrayDeque *deque);
+
+/**
+ * Locks the deque for reading, providing shared access to the calling thread. If the deque was
+ * created under the LOCK_RWLOCK or LOCK_BIASED policy, other threads may also read from the deque
+ * at the same time; otherwise this is the same as ts_arraydeque_lock(). Caller is responsible for
+ * unlocking the deque, and must not modify it while holding only the read lock.
+ *
+ * Params:
+ *    deque - The deque to operate on.
+ * Returns:
+ *    None
+ */
+void ts_arraydeque_lockRead(ConcurrentArrayDeque *deque);
+
+/**
+ * Locks the deque for writing, providing exclusive access to the calling thread. This is the same
+ * as ts_arraydeque_lock(). Caller is responsible for unlocking the deque to allow other threads
+ * access.
+ *
+ * Params:
+ *    deque - The deque to operate on.
+ * Returns:
+ *    None
+ */
+void ts_arraydeque_lockWrite(ConcurrentArrayDeque *deque);
+
+/**
+ * Inserts the specified element at the front of the deque.
+ *
+ * Params:
+ *    deque - The deque to operate on.
+ *    item - The element to insert.
+ * Returns:
+ *    OK - Operation was successful.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status ts_arraydeque_addFirst(ConcurrentArrayDeque *deque, void *item);
+
+/**
+ * Inserts the specified element at the end of the deque.
+ *
+ * Params:
+ *    deque - The deque to operate on.
+ *    item - The element to insert.
+ * Returns:
+ *    OK - Operation was successful.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status ts_arraydeque_addLast(ConcurrentArrayDeque *deque, void *item);
+
+/**
+ * Inserts the specified element at the specified position in the deque. Elements on the shorter
+ * side of `i` are shifted by one position to make room.
+ *
+ * Params:
+ *    deque - The deque to operate on.
+ *    i - The index at which the specified element is to be inserted.
+ *    item - The element to be inserted.
+ * Returns:
+ *    OK - Operation was successful.
+ *    INVALID_INDEX - Index given is invalid:
+ *       1.) `i` < 0
+ *       2.) `i` > size
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status ts_arraydeque_insert(ConcurrentArrayDeque *deque, long i, void *item);
+
+/**
+ * Retrieves, but does not remove, the first element of the deque.
+ *
+ * Params:
+ *    deque - The deque to operate on.
+ *    first - The pointer address to store the retrieved element into.
+ * Returns:
+ *    OK - Operation was successful.
+ *    STRUCT_EMPTY - Deque is currently empty.
+ */
+Status ts_arraydeque_first(ConcurrentArrayDeque *deque, void **first);
+
+/**
+ * Retrieves, but does not remove, the last element of the deque.
+ *
+ * Params:
+ *    deque - The deque to operate on.
+ *    last - The pointer address to store the retrieved element into.
+ * Returns:
+ *    OK - Operation was successful.
+ *    STRUCT_EMPTY - Deque is currently empty.
+ */
+Status ts_arraydeque_last(ConcurrentArrayDeque *deque, void **last);
+
+/**
+ * Returns the element at the specified position in the deque.
+ *
+ * Params:
+ *    deque - The deque to operate on.
+ *    i - The index of the element to retrieve.
+ *    item - The pointer address to store the retrieved element into.
+ * Returns:
+ *    OK - Operation was successful.
+ *    STRUCT_EMPTY - Deque is currently empty.
+ *    INVALID_INDEX - Index given is invalid:
+ *       1.) `i` < 0
+ *       2.) `i` >= size
+ */
+Status ts_arraydeque_get(ConcurrentArrayDeque *deque, long i, void **item);
+
+/**
+ * Replaces the element at the specified position in the deque with the specified element.
+ *
+ * Params:
+ *    deque - The deque to operate on.
+ *    i - The index of the element to replace.
+ *    item - The element to be stored at the specified position.
+ *    previous - The pointer address to store the element previously at the specified
+ *               position.
+ * Returns:
+ *    OK - Operation was successful.
+ *    STRUCT_EMPTY - Deque is currently empty.
+ *    INVALID_INDEX - Index given is invalid:
+ *       1.) `i` < 0
+ *       2.) `i` >= size
+ */
+Status ts_arraydeque_set(ConcurrentArrayDeque *deque, long i, void *item, void **previous);
+
+/**
+ * Retrieves and removes the first element of the deque.
+ *
+ * Params:
+ *    deque - The deque to operate on.
+ *    first - The pointer address to store the removed element into.
+ * Returns:
+ *    OK - Operation was successful.
+ *    STRUCT_EMPTY - Deque is currently empty.
+ */
+Status ts_arraydeque_removeFirst(ConcurrentArrayDeque *deque, void **first);
+
+/**
+ * Retrieves and removes the last element of the deque.
+ *
+ * Params:
+ *    deque - The deque to operate on.
+ *    last - The pointer address to store the removed element into.
+ * Returns:
+ *    OK - Operation was successful.
+ *    STRUCT_EMPTY - Deque is currently empty.
+ */
+Status ts_arraydeque_removeLast(ConcurrentArrayDeque *deque, void **last);
+
+/**
+ * Removes the element at the specified position in the deque. Elements on the shorter side of `i`
+ * are shifted by one position to fill the gap.
+ *
+ * Params:
+ *    deque - The deque to operate on.
+ *    i - The index of the element to be removed.
+ *    item - The pointer address to store the element that was removed from the deque.
+ * Returns:
+ *    OK - Operation was successful.
+ *    STRUCT_EMPTY - Deque is currently empty.
+ *    INVALID_INDEX - Index given is invalid:
+ *       1.) `i` < 0
+ *       2.) `i` >= size
+ */
+Status ts_arraydeque_remove(ConcurrentArrayDeque *deque, long i, void **item);
+
+/**
+ * Increases the capacity of the deque, if necessary, to ensure that it can hold at least the
+ * number of elements specified by the minimum capacity argument.
+ *
+ * Params:
+ *    deque - The deque to operate on.
+ *    capacity - The desired minimum capacity.
+ * Returns:
+ *    OK - Operation was successful.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status ts_arraydeque_ensureCapacity(ConcurrentArrayDeque *deque, long capacity);
+
+/**
+ * Removes all elements from the deque. If `destructor` is not NULL, it will be invoked on each
+ * element in the deque after being removed.
+ *
+ * Params:
+ *    deque - The deque to operate on.
+ *    destructor - Function to operate on each element after removal.
+ * Returns:
+ *    None
+ */
+void ts_arraydeque_clear(ConcurrentArrayDeque *deque, void (*destructor)(void *));
+
+/**
+ * Returns the number of elements in the deque.
+ *
+ * Params:
+ *    deque - The deque to operate on.
+ * Returns:
+ *    The deque's current size.
+ */
+long ts_arraydeque_size(ConcurrentArrayDeque *deque);
+
+/**
+ * Returns the deque's current capacity, that is, the maximum number of elements it can hold
+ * before resizing is required.
+ *
+ * Params:
+ *    deque - The deque to operate on.
+ * Returns:
+ *    The deque's current capacity.
+ */
+long ts_arraydeque_capacity(ConcurrentArrayDeque *deque);
+
+/**
+ * Returns TRUE if the deque contains no elements, FALSE if otherwise.
+ *
+ * Params:
+ *    deque - The deque to operate on.
+ * Returns:
+ *    TRUE if the deque is empty, FALSE if not.
+ */
+Boolean ts_arraydeque_isEmpty(ConcurrentArrayDeque *deque);
+
+/**
+ * Allocates and generates an array containing all of the deque's elements in proper sequence
+ * (from first to last element), then stores the array into `*array`. Caller is responsible for
+ * freeing the array when finished.
+ *
+ * Params:
+ *    deque - The deque to operate on.
+ *    array - Address where the new array will be stored.
+ * Returns:
+ *    OK - Operation was successful.
+ *    STRUCT_EMPTY - Deque is currently empty.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status ts_arraydeque_toArray(ConcurrentArrayDeque *deque, Array **array);
+
+/**
+ * Creates an Iterator instance to iterate over the deque's elements in proper sequence (from first
+ * to last element), then stores the iterator into `*iter`. Caller is responsible for destroying
+ * the iterator instance when finished.
+ *
+ * Params:
+ *    deque - The deque to operate on.
+ *    iter - Address where the new iterator will be stored.
+ * Returns:
+ *    OK - Operation was successful.
+ *    STRUCT_EMPTY - Deque is currently empty.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status ts_arraydeque_iterator(ConcurrentArrayDeque *deque, ConcurrentIterator **iter);
+
+/**
+ * Applies `action` to each element of the deque from first to last, passing it the element and
+ * `context`. The walk stops as soon as `action` returns FALSE. The deque stays locked for reading
+ * throughout the walk and nothing is allocated, so `action` must neither modify the deque nor call
+ * back into it.
+ *
+ * Params:
+ *    deque - The deque to operate on.
+ *    action - Function applied to each element, returning FALSE to stop the walk.
+ *    context - Argument passed along to each call of `action`, may be NULL.
+ * Returns:
+ *    TRUE if `action` was applied to every element, FALSE if it stopped the walk early.
+ */
+Boolean ts_arraydeque_forEach(ConcurrentArrayDeque *deque, Boolean (*action)(void *, void *),
+                              void *context);
+
+/**
+ * Creates an Iterator instance over a snapshot of the deque's elements in proper sequence (from
+ * first to last element), then stores the iterator into `*iter`. Unlike ts_arraydeque_iterator(),
+ * the lock is released as soon as the snapshot has been taken, so writers are not blocked while
+ * the caller iterates; changes made afterwards are not reflected. The items themselves are shared
+ * with the deque, so they must not be freed while iterating. Caller is responsible for destroying
+ * the iterator instance when finished.
+ *
+ * Params:
+ *    deque - The deque to operate on.
+ *    iter - Address where the new iterator will be stored.
+ * Returns:
+ *    OK - Operation was successful.
+ *    STRUCT_EMPTY - Deque is currently empty.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status ts_arraydeque_snapshot(ConcurrentArrayDeque *deque, ConcurrentIterator **iter);
+
+/**
+ * Returns the number of bytes of memory held by the deque: the deque itself, its lock and the
+ * deque it wraps, not counting the elements themselves.
+ *
+ * Params:
+ *    deque - The deque to operate on.
+ * Returns:
+ *    The deque's memory usage, in bytes.
+ */
+long ts_arraydeque_memoryUsage(ConcurrentArrayDeque *deque);
+
+/**
+ * Fills in `stats` with how contended the deque's lock has been since the deque was created. The
+ * counters remain 0 unless the library is compiled with CDS_LOCK_STATS defined.
+ *
+ * Params:
+ *    deque - The deque to operate on.
+ *    stats - The stats to fill in.
+ * Returns:
+ *    None
+ */
+void ts_arraydeque_lockStats(ConcurrentArrayDeque *deque, LockStats *stats);
+
+/**
+ * Destroys the deque instance by freeing all of its reserved memory. If `destructor` is not NULL,
+ * it will be invoked on each element before the deque is destroyed.
+ *
+ * Params:
+ *    deque - The deque to destroy.
+ *    destructor - Function to operate on each element prior to deque destruction.
+ * Returns:
+ *    None
+ */
+void ts_arraydeque_destroy(ConcurrentArrayDeque *deque, void (*destructor)(void *));
+
+#endif  /* _CDS_TS_ARRAYDEQUE_H__ */
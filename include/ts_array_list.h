@@ -26,6 +26,7 @@
 #define _CDS_TS_ARRAYLIST_H__
 
 #include "cds_common.h"
+#include "ts_lock.h"
 #include "ts_iterator.h"
 
 /**
@@ -71,6 +72,31 @@ void ts_arraylist_lock(ConcurrentArrayList *list);
  */
 void ts_arraylist_unlock(ConcurrentArrayList *list);
 
+/**
+ * Locks the arraylist for reading, providing shared access to the calling thread. If the arraylist
+ * was created under the LOCK_RWLOCK or LOCK_BIASED policy, other threads may also read from the
+ * arraylist at the same time; otherwise this is the same as ts_arraylist_lock(). Caller is
+ * responsible for unlocking the arraylist, and must not modify it while holding only the read lock.
+ *
+ * Params:
+ *    list - The arraylist to operate on.
+ * Returns:
+ *    None
+ */
+void ts_arraylist_lockRead(ConcurrentArrayList *list);
+
+/**
+ * Locks the arraylist for writing, providing exclusive access to the calling thread. This is the
+ * same as ts_arraylist_lock(). Caller is responsible for unlocking the arraylist to allow other
+ * threads access.
+ *
+ * Params:
+ *    list - The arraylist to operate on.
+ * Returns:
+ *    None
+ */
+void ts_arraylist_lockWrite(ConcurrentArrayList *list);
+
 /**
  * Appends the specified element to the end of the array list.
  *
@@ -101,6 +127,41 @@ Status ts_arraylist_add(ConcurrentArrayList *list, void *item);
  */
 Status ts_arraylist_insert(ConcurrentArrayList *list, long i, void *item);
 
+/**
+ * Appends the `n` elements in the array `items` to the end of the array list, in order. The
+ * list's capacity is checked and extended at most once for the whole batch.
+ *
+ * Params:
+ *    list - The array list to operate on.
+ *    items - The array of elements to be appended.
+ *    n - The number of elements in `items`.
+ * Returns:
+ *    OK - Operation was successful.
+ *    INVALID_INDEX - `n` is negative.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status ts_arraylist_addAll(ConcurrentArrayList *list, void **items, long n);
+
+/**
+ * Inserts the `n` elements in the array `items` into the array list, in order, starting at the
+ * specified position. Shifts the element currently at that position (if any) and any subsequent
+ * elements to the right (adds `n` to their indices), moving them only once.
+ *
+ * Params:
+ *    list - The array list to operate on.
+ *    i - The index at which the first element is to be inserted.
+ *    items - The array of elements to be inserted.
+ *    n - The number of elements in `items`.
+ * Returns:
+ *    OK - Operation was successful.
+ *    INVALID_INDEX - Index or count given is invalid:
+ *       1.) `i` < 0
+ *       2.) `i` > size
+ *       3.) `n` < 0
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status ts_arraylist_insertAll(ConcurrentArrayList *list, long i, void **items, long n);
+
 /**
  * Returns the element at the specified position in the array list.
  *
@@ -152,6 +213,176 @@ Status ts_arraylist_set(ConcurrentArrayList *list, long i, void *item, void **pr
  */
 Status ts_arraylist_remove(ConcurrentArrayList *list, long i, void **item);
 
+/**
+ * Removes the elements from index `from`, inclusive, to index `to`, exclusive, from the array list.
+ * Shifts any subsequent elements to the left (subtracts `to - from` from their indices), moving
+ * them only once. If `destructor` is not NULL, it will be invoked on each element after removal.
+ *
+ * Params:
+ *    list - The array list to operate on.
+ *    from - The index of the first element to be removed.
+ *    to - The index after the last element to be removed.
+ *    destructor - Function to operate on each element after removal.
+ * Returns:
+ *    OK - Operation was successful.
+ *    STRUCT_EMPTY - Array list is currently empty.
+ *    INVALID_INDEX - Range given is invalid:
+ *       1.) `from` < 0
+ *       2.) `to` > size
+ *       3.) `from` > `to`
+ */
+Status ts_arraylist_removeRange(ConcurrentArrayList *list, long from, long to,
+                                void (*destructor)(void *));
+
+/**
+ * Removes every element of the array list for which `predicate` returns TRUE, keeping the order of
+ * the remaining elements. The list is compacted in a single pass, moving each run of remaining
+ * elements at once. If `destructor` is not NULL, it will be invoked on each element after removal.
+ *
+ * Params:
+ *    list - The array list to operate on.
+ *    predicate - Function returning TRUE for the elements to remove.
+ *    destructor - Function to operate on each element after removal.
+ * Returns:
+ *    The number of elements removed.
+ */
+long ts_arraylist_removeIf(ConcurrentArrayList *list, Boolean (*predicate)(void *),
+                           void (*destructor)(void *));
+
+/**
+ * Sorts the elements of the array list in place into ascending order, as defined by `comparator`.
+ * The list is sorted with an introsort: a quicksort that switches over to a heap sort if its
+ * partitions keep coming out lopsided, so its worst case stays at O(n log n), and that leaves
+ * short runs to an insertion sort. The sort is not stable; use ts_arraylist_stableSort() for that.
+ *
+ * The comparator takes two elements `a` and `b`, and must return 0 when a == b, <0 when a < b,
+ * and >0 when a > b.
+ *
+ * Params:
+ *    list - The array list to operate on.
+ *    comparator - Function comparing two elements.
+ * Returns:
+ *    OK - Operation was successful.
+ */
+Status ts_arraylist_sort(ConcurrentArrayList *list, int (*comparator)(void *, void *));
+
+/**
+ * Sorts the elements of the array list into ascending order, as defined by `comparator`, keeping
+ * equal elements in the order they appeared in. The list is merge sorted through a temporary
+ * buffer as large as the list, and runs that are already in order are not merged again, so a
+ * sorted or nearly sorted list is handled in close to linear time.
+ *
+ * Params:
+ *    list - The array list to operate on.
+ *    comparator - Function comparing two elements.
+ * Returns:
+ *    OK - Operation was successful.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap; the list is unchanged.
+ */
+Status ts_arraylist_stableSort(ConcurrentArrayList *list, int (*comparator)(void *, void *));
+
+/**
+ * Sorts the elements of the array list into ascending order, as defined by `comparator`, using up
+ * to `nthreads` threads (64 at most). The list is split into one run per thread, each sorted as
+ * with ts_arraylist_sort(), after which the runs are merged pairwise, also in parallel, through a
+ * temporary buffer as large as the list. Each thread is given at least 16K elements, so a smaller
+ * list, or an `nthreads` <= 1, is simply sorted on the calling thread. The sort is not stable, and
+ * `comparator` must be safe to call from several threads at once.
+ *
+ * Params:
+ *    list - The array list to operate on.
+ *    comparator - Function comparing two elements.
+ *    nthreads - The most threads to sort with, including the calling thread.
+ * Returns:
+ *    OK - Operation was successful.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap; the list is unchanged.
+ */
+Status ts_arraylist_parallelSort(ConcurrentArrayList *list, int (*comparator)(void *, void *),
+                                 int nthreads);
+
+/**
+ * Returns the index of the first element of the sorted array list that does not compare less than
+ * `key`, or the list's size if every element does. The list must be sorted in ascending order by
+ * `comparator` (see ts_arraylist_sort()); the search is a branchless binary search.
+ *
+ * Params:
+ *    list - The array list to operate on.
+ *    key - The element to search for.
+ *    comparator - Function comparing two elements.
+ * Returns:
+ *    The index of the lower bound of `key`.
+ */
+long ts_arraylist_lowerBound(ConcurrentArrayList *list, void *key,
+                             int (*comparator)(void *, void *));
+
+/**
+ * Returns the index of the first element of the sorted array list that compares greater than
+ * `key`, or the list's size if none does. The list must be sorted in ascending order by
+ * `comparator` (see ts_arraylist_sort()); the search is a branchless binary search.
+ *
+ * Params:
+ *    list - The array list to operate on.
+ *    key - The element to search for.
+ *    comparator - Function comparing two elements.
+ * Returns:
+ *    The index of the upper bound of `key`.
+ */
+long ts_arraylist_upperBound(ConcurrentArrayList *list, void *key,
+                             int (*comparator)(void *, void *));
+
+/**
+ * Searches the sorted array list for an element equal to `key`, and stores the index of the first
+ * one found into `*index`; if there is none, the index where `key` would be inserted is stored
+ * instead. The list must be sorted in ascending order by `comparator` (see ts_arraylist_sort()).
+ *
+ * Params:
+ *    list - The array list to operate on.
+ *    key - The element to search for.
+ *    comparator - Function comparing two elements.
+ *    index - The pointer address to store the index into.
+ * Returns:
+ *    OK - An element equal to `key` was found.
+ *    NOT_FOUND - The list has no element equal to `key`.
+ */
+Status ts_arraylist_binarySearch(ConcurrentArrayList *list, void *key,
+                                 int (*comparator)(void *, void *), long *index);
+
+/**
+ * Inserts the element into the sorted array list at the position that keeps it sorted, after any
+ * elements equal to it. The position is found by a binary search, and the following elements are
+ * shifted over once. The list must be sorted in ascending order by `comparator`.
+ *
+ * Params:
+ *    list - The array list to operate on.
+ *    item - The element to be inserted.
+ *    comparator - Function comparing two elements.
+ * Returns:
+ *    OK - Operation was successful.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status ts_arraylist_insertSorted(ConcurrentArrayList *list, void *item,
+                                 int (*comparator)(void *, void *));
+
+/**
+ * Sets the growth factor of the array list, that is, the percentage of its capacity to add
+ * whenever it becomes full. The percentage is expressed as a float in the range (0.0, 1.0], as
+ * with the string builder's growth factor; the default of 1.0 doubles the capacity. A smaller
+ * factor wastes less memory on a very large array list, at the cost of resizing it more often. If
+ * the factor given is outside of that range, the default factor is assigned.
+ *
+ * Whatever the factor, the array list is always grown enough for the elements being added, and
+ * never past the largest array that can be addressed. Arrays of 2MB or more are rounded up to whole
+ * 2MB pages; if the library is compiled with CDS_HUGE_PAGES defined, the kernel is also asked to
+ * back them with transparent huge pages (with madvise()).
+ *
+ * Params:
+ *    list - The array list to operate on.
+ *    growthFactor - The percentage to increase the capacity when resizing is needed.
+ * Returns:
+ *    None
+ */
+void ts_arraylist_setGrowthFactor(ConcurrentArrayList *list, float growthFactor);
+
 /**
  * Increases the capacity of the array list, if necessary, to ensure that it can hold at least the
  * number of elements specified by the minimum capacity argument.
@@ -250,6 +481,97 @@ Status ts_arraylist_toArray(ConcurrentArrayList *list, Array **array);
  */
 Status ts_arraylist_iterator(ConcurrentArrayList *list, ConcurrentIterator **iter);
 
+/**
+ * Applies `action` to each element of the array list from first to last, passing it the element and
+ * `context`. The walk stops as soon as `action` returns FALSE. The array list stays locked for
+ * reading throughout the walk and nothing is allocated, so `action` must neither modify the array
+ * list nor call back into it.
+ *
+ * Params:
+ *    list - The array list to operate on.
+ *    action - Function applied to each element, returning FALSE to stop the walk.
+ *    context - Argument passed along to each call of `action`, may be NULL.
+ * Returns:
+ *    TRUE if `action` was applied to every element, FALSE if it stopped the walk early.
+ */
+Boolean ts_arraylist_forEach(ConcurrentArrayList *list, Boolean (*action)(void *, void *),
+                             void *context);
+
+/**
+ * Applies `action` to each element of the array list using up to `nthreads` threads, as with
+ * arraylist_parallelForEach(). The array list stays locked for reading throughout the walk, so
+ * `action` must neither modify the array list nor call back into it.
+ *
+ * Params:
+ *    list - The array list to operate on.
+ *    nthreads - The most threads to walk with, including the calling thread.
+ *    action - Function applied to each element, returning FALSE to stop the walk.
+ *    context - Argument passed along to each call of `action`, may be NULL.
+ * Returns:
+ *    TRUE if `action` was applied to every element, FALSE if it stopped the walk early.
+ */
+Boolean ts_arraylist_parallelForEach(ConcurrentArrayList *list, int nthreads,
+                                     Boolean (*action)(void *, void *), void *context);
+
+/**
+ * Reduces the elements of the array list to a single result using up to `nthreads` threads, as
+ * with arraylist_parallelReduce(). The array list stays locked for reading throughout, so neither
+ * `reducer` nor `combiner` may modify the array list or call back into it.
+ *
+ * Params:
+ *    list - The array list to operate on.
+ *    nthreads - The most threads to reduce with, including the calling thread.
+ *    reducer - Function folding an element into a range's result.
+ *    combiner - Function merging two ranges' results.
+ *    context - Argument passed along to each call of `reducer` and `combiner`, may be NULL.
+ * Returns:
+ *    The reduced result, or NULL if the array list is empty.
+ */
+void *ts_arraylist_parallelReduce(ConcurrentArrayList *list, int nthreads,
+                                  void *(*reducer)(void *, void *, void *),
+                                  void *(*combiner)(void *, void *, void *), void *context);
+
+/**
+ * Creates an Iterator instance over a snapshot of the list's elements in proper sequence (from
+ * first to last element), then stores the iterator into `*iter`. Unlike ts_arraylist_iterator(),
+ * the lock is released as soon as the snapshot has been taken, so writers are not blocked while
+ * the caller iterates; changes made afterwards are not reflected. The items themselves are shared
+ * with the list, so they must not be freed while iterating. Caller is responsible for destroying
+ * the iterator instance when finished.
+ *
+ * Params:
+ *    list - The array list to operate on.
+ *    iter - Address where the new iterator will be stored.
+ * Returns:
+ *    OK - Operation was successful.
+ *    STRUCT_EMPTY - Array list is currently empty.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status ts_arraylist_snapshot(ConcurrentArrayList *list, ConcurrentIterator **iter);
+
+/**
+ * Returns the number of bytes of memory held by the array list: the array list itself, its lock
+ * and the array list it wraps, not counting the elements themselves.
+ *
+ * Params:
+ *    list - The array list to operate on.
+ * Returns:
+ *    The array list's memory usage, in bytes.
+ */
+long ts_arraylist_memoryUsage(ConcurrentArrayList *list);
+
+/**
+ * Fills in `stats` with how contended the array list's lock has been since the array list was
+ * created. The counters remain 0 unless the library is compiled with CDS_LOCK_STATS defined.
+ *
+ * Params:
+ *    list - The array list to operate on.
+ *    stats - The stats to fill in.
+ * Returns:
+ *    None
+ */
+void ts_arraylist_lockStats(ConcurrentArrayList *list, LockStats *stats);
+
 /**
  * Destroys the array list instance by freeing all of its reserved memory. If `destructor` is not
  * NULL, it will be invoked on each element before the arraylist is destroyed.
@@ -26,6 +26,7 @@
 #define _CDS_TS_BOUNDED_QUEUE_H__
 
 #include "cds_common.h"
+#include "ts_lock.h"
 #include "ts_iterator.h"
 
 /**
@@ -72,6 +73,31 @@ void ts_boundedqueue_lock(ConcurrentBoundedQueue *queue);
  */
 void ts_boundedqueue_unlock(ConcurrentBoundedQueue *queue);
 
+/**
+ * Locks the queue for reading, providing shared access to the calling thread. If the queue was
+ * created under the LOCK_RWLOCK or LOCK_BIASED policy, other threads may also read from the queue
+ * at the same time; otherwise this is the same as ts_boundedqueue_lock(). Caller is responsible for
+ * unlocking the queue, and must not modify it while holding only the read lock.
+ *
+ * Params:
+ *    queue - The queue to operate on.
+ * Returns:
+ *    None
+ */
+void ts_boundedqueue_lockRead(ConcurrentBoundedQueue *queue);
+
+/**
+ * Locks the queue for writing, providing exclusive access to the calling thread. This is the same
+ * as ts_boundedqueue_lock(). Caller is responsible for unlocking the queue to allow other threads
+ * access.
+ *
+ * Params:
+ *    queue - The queue to operate on.
+ * Returns:
+ *    None
+ */
+void ts_boundedqueue_lockWrite(ConcurrentBoundedQueue *queue);
+
 /**
  * Inserts the specified element into the queue.
  *
@@ -84,6 +110,35 @@ void ts_boundedqueue_unlock(ConcurrentBoundedQueue *queue);
  */
 Status ts_boundedqueue_add(ConcurrentBoundedQueue *queue, void *item);
 
+/**
+ * Inserts the specified element into the queue, blocking the calling thread until space becomes
+ * available if the queue is full. The blocked thread sleeps rather than spins, and does not hold
+ * the queue's lock while waiting. The caller must not hold the queue's lock (see
+ * ts_boundedqueue_lock()) when calling this, otherwise no other thread can make room.
+ *
+ * Params:
+ *    queue - The queue to operate on.
+ *    item - The item to be inserted into the queue.
+ * Returns:
+ *    OK - Operation was successful.
+ */
+Status ts_boundedqueue_put(ConcurrentBoundedQueue *queue, void *item);
+
+/**
+ * Inserts the specified element into the queue, blocking the calling thread for at most `timeout`
+ * milliseconds for space to become available if the queue is full. A `timeout` <= 0 does not
+ * block, behaving like ts_boundedqueue_add(). The caller must not hold the queue's lock.
+ *
+ * Params:
+ *    queue - The queue to operate on.
+ *    item - The item to be inserted into the queue.
+ *    timeout - The maximum number of milliseconds to wait.
+ * Returns:
+ *    OK - Operation was successful.
+ *    STRUCT_FULL - The queue remained full until the timeout elapsed.
+ */
+Status ts_boundedqueue_putTimed(ConcurrentBoundedQueue *queue, void *item, long timeout);
+
 /**
  * Retrieves, but does not remove, the first element from the queue and stores the result into
  * `*first`.
@@ -109,6 +164,51 @@ Status ts_boundedqueue_peek(ConcurrentBoundedQueue *queue, void **first);
  */
 Status ts_boundedqueue_poll(ConcurrentBoundedQueue *queue, void **first);
 
+/**
+ * Removes the first element from the queue and stores the result into `*first`, blocking the
+ * calling thread until an element becomes available if the queue is empty. The blocked thread
+ * sleeps rather than spins, and does not hold the queue's lock while waiting. The caller must not
+ * hold the queue's lock (see ts_boundedqueue_lock()) when calling this, otherwise no other thread
+ * can add an element.
+ *
+ * Params:
+ *    queue - The queue to operate on.
+ *    first - The pointer address to store the removed first element into.
+ * Returns:
+ *    OK - Operation was successful.
+ */
+Status ts_boundedqueue_take(ConcurrentBoundedQueue *queue, void **first);
+
+/**
+ * Removes the first element from the queue and stores the result into `*first`, blocking the
+ * calling thread for at most `timeout` milliseconds for an element to become available if the
+ * queue is empty. A `timeout` <= 0 does not block, behaving like ts_boundedqueue_poll(). The caller
+ * must not hold the queue's lock.
+ *
+ * Params:
+ *    queue - The queue to operate on.
+ *    first - The pointer address to store the removed first element into.
+ *    timeout - The maximum number of milliseconds to wait.
+ * Returns:
+ *    OK - Operation was successful.
+ *    STRUCT_EMPTY - The queue remained empty until the timeout elapsed.
+ */
+Status ts_boundedqueue_takeTimed(ConcurrentBoundedQueue *queue, void **first, long timeout);
+
+/**
+ * Removes up to `max` elements from the front of the queue in a single lock acquisition, storing
+ * them in FIFO order into `items`, which must have room for `max` elements. Does not block; pair it
+ * with ts_boundedqueue_take() to collect a batch of elements on every wakeup.
+ *
+ * Params:
+ *    queue - The queue to operate on.
+ *    items - The array to store the removed elements into.
+ *    max - The maximum number of elements to remove.
+ * Returns:
+ *    The number of elements removed and stored into `items`.
+ */
+long ts_boundedqueue_drainTo(ConcurrentBoundedQueue *queue, void **items, long max);
+
 /**
  * Removes all elements from the queue. If `destructor` is not NULL, it will be invoked on each
  * element in the queue after being removed.
@@ -191,6 +291,63 @@ Status ts_boundedqueue_toArray(ConcurrentBoundedQueue *queue, Array **array);
  */
 Status ts_boundedqueue_iterator(ConcurrentBoundedQueue *queue, ConcurrentIterator **iter);
 
+/**
+ * Applies `action` to each element of the queue from front to back, passing it the element and
+ * `context`. The walk stops as soon as `action` returns FALSE. The queue stays locked for reading
+ * throughout the walk and nothing is allocated, so `action` must neither modify the queue nor call
+ * back into it.
+ *
+ * Params:
+ *    queue - The queue to operate on.
+ *    action - Function applied to each element, returning FALSE to stop the walk.
+ *    context - Argument passed along to each call of `action`, may be NULL.
+ * Returns:
+ *    TRUE if `action` was applied to every element, FALSE if it stopped the walk early.
+ */
+Boolean ts_boundedqueue_forEach(ConcurrentBoundedQueue *queue, Boolean (*action)(void *, void *),
+                                void *context);
+
+/**
+ * Creates an Iterator instance over a snapshot of the queue's elements in proper sequence (from
+ * first to last element), then stores the iterator into `*iter`. Unlike
+ * ts_boundedqueue_iterator(), the lock is released as soon as the snapshot has been taken, so
+ * writers are not blocked while the caller iterates; changes made afterwards are not reflected.
+ * The items themselves are shared with the queue, so they must not be freed while iterating.
+ * Caller is responsible for destroying the iterator instance when finished.
+ *
+ * Params:
+ *    queue - The queue to operate on.
+ *    iter - Address where the new iterator will be stored.
+ * Returns:
+ *    OK - Operation was successful.
+ *    STRUCT_EMPTY - Queue is currently empty.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status ts_boundedqueue_snapshot(ConcurrentBoundedQueue *queue, ConcurrentIterator **iter);
+
+/**
+ * Returns the number of bytes of memory held by the queue: the queue itself, its lock and the
+ * queue it wraps, not counting the elements themselves.
+ *
+ * Params:
+ *    queue - The queue to operate on.
+ * Returns:
+ *    The queue's memory usage, in bytes.
+ */
+long ts_boundedqueue_memoryUsage(ConcurrentBoundedQueue *queue);
+
+/**
+ * Fills in `stats` with how contended the queue's lock has been since the queue was created. The
+ * counters remain 0 unless the library is compiled with CDS_LOCK_STATS defined.
+ *
+ * Params:
+ *    queue - The queue to operate on.
+ *    stats - The stats to fill in.
+ * Returns:
+ *    None
+ */
+void ts_boundedqueue_lockStats(ConcurrentBoundedQueue *queue, LockStats *stats);
+
 /**
  * Destroys the queue instance by freeing all of its reserved memory. If `destructor` is not NULL,
  * it will be invoked on each element before the queue is destroyed.
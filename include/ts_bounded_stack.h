@@ -26,6 +26,7 @@
 #define _CDS_TS_BOUNDED_STACK_H__
 
 #include "cds_common.h"
+#include "ts_lock.h"
 #include "ts_iterator.h"
 
 /**
@@ -72,6 +73,31 @@ void ts_boundedstack_lock(ConcurrentBoundedStack *stack);
  */
 void ts_boundedstack_unlock(ConcurrentBoundedStack *stack);
 
+/**
+ * Locks the stack for reading, providing shared access to the calling thread. If the stack was
+ * created under the LOCK_RWLOCK or LOCK_BIASED policy, other threads may also read from the stack
+ * at the same time; otherwise this is the same as ts_boundedstack_lock(). Caller is responsible for
+ * unlocking the stack, and must not modify it while holding only the read lock.
+ *
+ * Params:
+ *    stack - The stack to operate on.
+ * Returns:
+ *    None
+ */
+void ts_boundedstack_lockRead(ConcurrentBoundedStack *stack);
+
+/**
+ * Locks the stack for writing, providing exclusive access to the calling thread. This is the same
+ * as ts_boundedstack_lock(). Caller is responsible for unlocking the stack to allow other threads
+ * access.
+ *
+ * Params:
+ *    stack - The stack to operate on.
+ * Returns:
+ *    None
+ */
+void ts_boundedstack_lockWrite(ConcurrentBoundedStack *stack);
+
 /**
  * Pushes the specified element onto the stack.
  *
@@ -190,6 +216,63 @@ Status ts_boundedstack_toArray(ConcurrentBoundedStack *stack, Array **array);
  */
 Status ts_boundedstack_iterator(ConcurrentBoundedStack *stack, ConcurrentIterator **iter);
 
+/**
+ * Applies `action` to each element of the stack from top to bottom, passing it the element and
+ * `context`. The walk stops as soon as `action` returns FALSE. The stack stays locked for reading
+ * throughout the walk and nothing is allocated, so `action` must neither modify the stack nor call
+ * back into it.
+ *
+ * Params:
+ *    stack - The stack to operate on.
+ *    action - Function applied to each element, returning FALSE to stop the walk.
+ *    context - Argument passed along to each call of `action`, may be NULL.
+ * Returns:
+ *    TRUE if `action` was applied to every element, FALSE if it stopped the walk early.
+ */
+Boolean ts_boundedstack_forEach(ConcurrentBoundedStack *stack, Boolean (*action)(void *, void *),
+                                void *context);
+
+/**
+ * Creates an Iterator instance over a snapshot of the stack's elements in proper sequence (from
+ * top to bottom element), then stores the iterator into `*iter`. Unlike
+ * ts_boundedstack_iterator(), the lock is released as soon as the snapshot has been taken, so
+ * writers are not blocked while the caller iterates; changes made afterwards are not reflected.
+ * The items themselves are shared with the stack, so they must not be freed while iterating.
+ * Caller is responsible for destroying the iterator instance when finished.
+ *
+ * Params:
+ *    stack - The stack to operate on.
+ *    iter - Address where the new iterator will be stored.
+ * Returns:
+ *    OK - Operation was successful.
+ *    STRUCT_EMPTY - Stack is currently empty.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status ts_boundedstack_snapshot(ConcurrentBoundedStack *stack, ConcurrentIterator **iter);
+
+/**
+ * Returns the number of bytes of memory held by the stack: the stack itself, its lock and the
+ * stack it wraps, not counting the elements themselves.
+ *
+ * Params:
+ *    stack - The stack to operate on.
+ * Returns:
+ *    The stack's memory usage, in bytes.
+ */
+long ts_boundedstack_memoryUsage(ConcurrentBoundedStack *stack);
+
+/**
+ * Fills in `stats` with how contended the stack's lock has been since the stack was created. The
+ * counters remain 0 unless the library is compiled with CDS_LOCK_STATS defined.
+ *
+ * Params:
+ *    stack - The stack to operate on.
+ *    stats - The stats to fill in.
+ * Returns:
+ *    None
+ */
+void ts_boundedstack_lockStats(ConcurrentBoundedStack *stack, LockStats *stats);
+
 /**
  * Destroys the stack instance by freeing all of its reserved memory. If `destructor` is not NULL,
  * it will be invoked on each element before the stack is destroyed.
@@ -26,6 +26,7 @@
 #define _CDS_TS_CIRCULAR_LIST_H__
 
 #include "cds_common.h"
+#include "ts_lock.h"
 #include "ts_iterator.h"
 
 /**
@@ -48,6 +49,21 @@ typedef struct ts_circular_list ConcurrentCircularList;
  */
 Status ts_circularlist_new(ConcurrentCircularList **list);
 
+/**
+ * Creates a new circular list instance whose nodes are allocated from `pool`, then stores the new instance
+ * into `*list`. The pool may be shared with other ADTs and must outlive the circular list. A pool shared
+ * by ADTs used from different threads must be created with nodepool_newConcurrent(). If `pool` is
+ * NULL, a private pool is used instead, the same as ts_circularlist_new().
+ *
+ * Params:
+ *    list - The pointer address to store the new CircularList instance.
+ *    pool - The pool to allocate the nodes from, or NULL.
+ * Returns:
+ *    OK - CircularList was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status ts_circularlist_newWithPool(ConcurrentCircularList **list, NodePool *pool);
+
 /**
  * Locks the circular list, providing exclusive access to the calling thread. Caller is responsible
  * for unlocking the list to allow other threads access.
@@ -69,6 +85,32 @@ void ts_circularlist_lock(ConcurrentCircularList *list);
  */
 void ts_circularlist_unlock(ConcurrentCircularList *list);
 
+/**
+ * Locks the circular list for reading, providing shared access to the calling thread. If the
+ * circular list was created under the LOCK_RWLOCK or LOCK_BIASED policy, other threads may also
+ * read from the circular list at the same time; otherwise this is the same as
+ * ts_circularlist_lock(). Caller is responsible for unlocking the circular list, and must not
+ * modify it while holding only the read lock.
+ *
+ * Params:
+ *    list - The circular list to operate on.
+ * Returns:
+ *    None
+ */
+void ts_circularlist_lockRead(ConcurrentCircularList *list);
+
+/**
+ * Locks the circular list for writing, providing exclusive access to the calling thread. This is
+ * the same as ts_circularlist_lock(). Caller is responsible for unlocking the circular list to
+ * allow other threads access.
+ *
+ * Params:
+ *    list - The circular list to operate on.
+ * Returns:
+ *    None
+ */
+void ts_circularlist_lockWrite(ConcurrentCircularList *list);
+
 /**
  * Inserts the specified element into the front of the circular list.
  *
@@ -302,6 +344,63 @@ Status ts_circularlist_toArray(ConcurrentCircularList *list, Array **array);
  */
 Status ts_circularlist_iterator(ConcurrentCircularList *list, ConcurrentIterator **iter);
 
+/**
+ * Applies `action` to each element of the circular list from the head onwards, passing it the
+ * element and `context`. The walk stops as soon as `action` returns FALSE. The circular list stays
+ * locked for reading throughout the walk and nothing is allocated, so `action` must neither modify
+ * the circular list nor call back into it.
+ *
+ * Params:
+ *    list - The circular list to operate on.
+ *    action - Function applied to each element, returning FALSE to stop the walk.
+ *    context - Argument passed along to each call of `action`, may be NULL.
+ * Returns:
+ *    TRUE if `action` was applied to every element, FALSE if it stopped the walk early.
+ */
+Boolean ts_circularlist_forEach(ConcurrentCircularList *list, Boolean (*action)(void *, void *),
+                                void *context);
+
+/**
+ * Creates an Iterator instance over a snapshot of the list's elements in proper sequence (from
+ * first to last element), then stores the iterator into `*iter`. Unlike
+ * ts_circularlist_iterator(), the lock is released as soon as the snapshot has been taken, so
+ * writers are not blocked while the caller iterates; changes made afterwards are not reflected.
+ * The items themselves are shared with the list, so they must not be freed while iterating. Caller
+ * is responsible for destroying the iterator instance when finished.
+ *
+ * Params:
+ *    list - The circular list to operate on.
+ *    iter - Address where the new iterator will be stored.
+ * Returns:
+ *    OK - Operation was successful.
+ *    STRUCT_EMPTY - Circular list is currently empty.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status ts_circularlist_snapshot(ConcurrentCircularList *list, ConcurrentIterator **iter);
+
+/**
+ * Returns the number of bytes of memory held by the circular list: the circular list itself, its
+ * lock and the circular list it wraps, not counting the elements themselves.
+ *
+ * Params:
+ *    list - The circular list to operate on.
+ * Returns:
+ *    The circular list's memory usage, in bytes.
+ */
+long ts_circularlist_memoryUsage(ConcurrentCircularList *list);
+
+/**
+ * Fills in `stats` with how contended the circular list's lock has been since the circular list was
+ * created. The counters remain 0 unless the library is compiled with CDS_LOCK_STATS defined.
+ *
+ * Params:
+ *    list - The circular list to operate on.
+ *    stats - The stats to fill in.
+ * Returns:
+ *    None
+ */
+void ts_circularlist_lockStats(ConcurrentCircularList *list, LockStats *stats);
+
 /**
  * Destroys the circular list instance by freeing all of its reserved memory. If `destructor` is not
  * NULL, it will be invoked on each element before the circular list is destroyed.
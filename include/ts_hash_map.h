@@ -28,13 +28,20 @@
 #include "cds_common.h"
 #include "hash_map.h"
 #include "ts_iterator.h"
+#include "ts_lock.h"
 
 /**
  * Declaration for the thread-safe HashMap ADT.
  *
  * Hashmap based implementation; holds elements based on key-value pairings.
  *
- * Modeled after the Java 7 HashMap interface.
+ * The keys are split across a fixed number of lock stripes, each an independent hashmap with its
+ * own lock, so threads operating on keys in different stripes proceed in parallel. Operations over
+ * the whole hashmap (size, clear, arrays, iterators) and ts_hashmap_lock() acquire every stripe.
+ * Lookups only lock their stripe for reading; under the LOCK_BIASED policy (see ts_lock.h), they
+ * don't write to the stripe's lock at all, which suits hashmaps that are rarely modified.
+ *
+ * Modeled after the Java 7 ConcurrentHashMap interface.
  */
 typedef struct ts_hashmap ConcurrentHashMap;
 
@@ -80,9 +87,124 @@ Status ts_hashmap_new(ConcurrentHashMap **map, long (*hash)(void *, long),
         int (*keyComparator)(void *, void *), long capacity, double loadFactor,
         void (*keyDestructor)(void *));
 
+/**
+ * Constructs a new hashmap instance with the specified starting capacity and load factor, then
+ * stores the new instance into `*map`. If the capacity specified is <= 0, a default capacity is
+ * assigned. If the load factor specified is <= 0.0, a default load factor is assigned.
+ *
+ * Unlike ts_hashmap_new(), the hash function specified should return the full-width hash code of the
+ * key, independent of the number of buckets. The hashmap caches each key's hash code inside its
+ * entry, so the hash function is invoked exactly once per insertion and lookup, and never again
+ * when the hashmap is resized. Keys are only compared when their hash codes are equal. For
+ * example, if using char * keys, you might define a hash function like this:
+ *
+ *    uint64_t hash(void *a) {
+ *        uint64_t val = 14695981039346656037UL;
+ *        char *ch;
+ *        for (ch = (char *)a; *ch != '\0'; ch++)
+ *            val = (val ^ (unsigned char)*ch) * 1099511628211UL;
+ *        return val;
+ *    }
+ *
+ * The capacity of the hashmap is rounded up to the nearest power of 2. The comparator and key
+ * destructor functions are the same as with ts_hashmap_new().
+ *
+ * Params:
+ *    map - The pointer address to store the new HashMap instance.
+ *    hash - The hashing function for computing the keys' hash codes.
+ *    keyComparator - Function for comparing two keys in the hashmap.
+ *    capacity - The hashmap's starting capacity.
+ *    loadFactor - The hashmap's assigned load factor.
+ *    keyDestructor - Function for de-allocating the hashmap's keys.
+ * Returns:
+ *    OK - HashMap was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status ts_hashmap_newFullHash(ConcurrentHashMap **map, uint64_t (*hash)(void *),
+        int (*keyComparator)(void *, void *), long capacity, double loadFactor,
+        void (*keyDestructor)(void *));
+
+/**
+ * Constructs a new hashmap instance backed by a flat, open-addressing table with the specified
+ * starting capacity and load factor, then stores the new instance into `*map`. If the capacity
+ * specified is <= 0, a default capacity is assigned. If the load factor specified is <= 0.0, a
+ * default load factor is assigned.
+ *
+ * Rather than allocating an entry per mapping and chaining them into buckets, the entries are
+ * stored inline in one contiguous array of slots. Each slot is guarded by a control byte holding 7
+ * bits of the key's hash code, and lookups scan the control bytes 16 at a time (with SSE2 when
+ * available), only comparing keys whose control bytes and hash codes match. Insertions do not
+ * allocate unless the table needs to grow. The load factor is capped at 0.875.
+ *
+ * The hash function, comparator and key destructor are the same as with ts_hashmap_newFullHash().
+ * All other hashmap functions work the same for both engines, with one exception: since entries
+ * live inline in the table, `HmEntry*` values obtained from entryArray() or iterator() are only
+ * valid until the next insertion or removal.
+ *
+ * Params:
+ *    map - The pointer address to store the new HashMap instance.
+ *    hash - The hashing function for computing the keys' hash codes.
+ *    keyComparator - Function for comparing two keys in the hashmap.
+ *    capacity - The hashmap's starting capacity.
+ *    loadFactor - The hashmap's assigned load factor.
+ *    keyDestructor - Function for de-allocating the hashmap's keys.
+ * Returns:
+ *    OK - HashMap was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status ts_hashmap_newFlat(ConcurrentHashMap **map, uint64_t (*hash)(void *),
+        int (*keyComparator)(void *, void *), long capacity, double loadFactor,
+        void (*keyDestructor)(void *));
+
+/**
+ * Constructs a new hashmap instance with a seeded, full-width hash function and the specified
+ * starting capacity and load factor, then stores the new instance into `*map`. If the capacity
+ * specified is <= 0, a default capacity is assigned. If the load factor specified is <= 0.0, a
+ * default load factor is assigned.
+ *
+ * The hashmap works like one created with ts_hashmap_newFullHash(), except that random seeds are
+ * drawn when it is created, one for choosing each key's stripe and one per stripe, and passed to
+ * every call of the hash function (see hashmap_newSeeded()).
+ *
+ * Params:
+ *    map - The pointer address to store the new HashMap instance.
+ *    hash - The seeded hashing function for computing the keys' hash codes.
+ *    keyComparator - Function for comparing two keys in the hashmap.
+ *    capacity - The hashmap's starting capacity.
+ *    loadFactor - The hashmap's assigned load factor.
+ *    keyDestructor - Function for de-allocating the hashmap's keys.
+ * Returns:
+ *    OK - HashMap was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status ts_hashmap_newSeeded(ConcurrentHashMap **map, uint64_t (*hash)(void *, uint64_t),
+                            int (*keyComparator)(void *, void *), long capacity,
+                            double loadFactor, void (*keyDestructor)(void *));
+
+/**
+ * Constructs a new hashmap instance backed by flat, open-addressing tables with a seeded hash
+ * function, then stores the new instance into `*map`. The hashmap combines the engine of
+ * ts_hashmap_newFlat() with the random seeds of ts_hashmap_newSeeded().
+ *
+ * Params:
+ *    map - The pointer address to store the new HashMap instance.
+ *    hash - The seeded hashing function for computing the keys' hash codes.
+ *    keyComparator - Function for comparing two keys in the hashmap.
+ *    capacity - The hashmap's starting capacity.
+ *    loadFactor - The hashmap's assigned load factor.
+ *    keyDestructor - Function for de-allocating the hashmap's keys.
+ * Returns:
+ *    OK - HashMap was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status ts_hashmap_newFlatSeeded(ConcurrentHashMap **map, uint64_t (*hash)(void *, uint64_t),
+                                int (*keyComparator)(void *, void *), long capacity,
+                                double loadFactor, void (*keyDestructor)(void *));
+
 /**
  * Locks the hashmap, providing exclusive access to the calling thread. Caller is responsible for
- * unlocking the hashmap to allow other threads access.
+ * unlocking the hashmap to allow other threads access. This acquires every lock stripe, and is as
+ * costly as any other operation on the whole hashmap.
  *
  * Params:
  *    map - The hashmap to operate on.
@@ -101,6 +223,77 @@ void ts_hashmap_lock(ConcurrentHashMap *map);
  */
 void ts_hashmap_unlock(ConcurrentHashMap *map);
 
+/**
+ * Locks the hashmap for reading, providing shared access to the calling thread. If the hashmap was
+ * created under the LOCK_RWLOCK or LOCK_BIASED policy, other threads may also read from the hashmap
+ * at the same time; otherwise this is the same as ts_hashmap_lock(). Caller is responsible for
+ * unlocking the hashmap, and must not modify it while holding only the read lock.
+ *
+ * Params:
+ *    map - The hashmap to operate on.
+ * Returns:
+ *    None
+ */
+void ts_hashmap_lockRead(ConcurrentHashMap *map);
+
+/**
+ * Locks the hashmap for writing, providing exclusive access to the calling thread. This is the same
+ * as ts_hashmap_lock(). Caller is responsible for unlocking the hashmap to allow other threads
+ * access.
+ *
+ * Params:
+ *    map - The hashmap to operate on.
+ * Returns:
+ *    None
+ */
+void ts_hashmap_lockWrite(ConcurrentHashMap *map);
+
+/**
+ * Enables or disables incremental resizing for the hashmap. By default the hashmap rehashes all of
+ * its entries into the larger array of buckets at once while holding the lock, which stalls every
+ * thread accessing the hashmap for time proportional to the hashmap's size. With incremental
+ * resizing enabled, the hashmap keeps both arrays of buckets while resizing, and each following
+ * insertion or removal moves a small, bounded number of buckets over, keeping the latency of every
+ * operation flat.
+ * Lookups search both arrays while a resize is in progress, but never modify the hashmap.
+ *
+ * Disabling incremental resizing completes any resize that is in progress. This setting has no
+ * effect on hashmaps created with ts_hashmap_newFlat().
+ *
+ * Params:
+ *    map - The hashmap to operate on.
+ *    incremental - TRUE to resize incrementally, FALSE to resize all at once.
+ * Returns:
+ *    None
+ */
+void ts_hashmap_setIncrementalResize(ConcurrentHashMap *map, Boolean incremental);
+
+/**
+ * Increases the capacity of the hashmap, if necessary, so that it can hold at least `n` entries
+ * under its load factor without intermediate doublings. The room is spread evenly across the
+ * stripes, so a stripe that receives more than its share of the entries may still resize once.
+ *
+ * Params:
+ *    map - The hashmap to operate on.
+ *    n - The number of entries to reserve room for.
+ * Returns:
+ *    OK - Operation was successful.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status ts_hashmap_reserve(ConcurrentHashMap *map, long n);
+
+/**
+ * Shrinks the capacity of the hashmap to the smallest that holds its current entries under its
+ * load factor, and drops any capacity that was reserved with ts_hashmap_reserve().
+ *
+ * Params:
+ *    map - The hashmap to operate on.
+ * Returns:
+ *    OK - Operation was successful.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status ts_hashmap_shrinkToFit(ConcurrentHashMap *map);
+
 /**
  * Associates the specified value with the specified key in the hashmap. If the hashmap previously
  * contained a mapping for the key, the old value is replaced, and stored into `*previous`.
@@ -157,6 +350,57 @@ Status ts_hashmap_get(ConcurrentHashMap *map, void *key, void **value);
  */
 Status ts_hashmap_remove(ConcurrentHashMap *map, void *key, void **value);
 
+/**
+ * Associates each of the `n` keys in `keys` with the value at the same index in `values`, as if by
+ * calling ts_hashmap_put() on each pair in order. The keys are first grouped by stripe, and each
+ * stripe is locked only once while its share of the batch is inserted with hashmap_putAll(); the
+ * batch as a whole is not atomic. If `previous` is not NULL, the value replaced by the i-th pair is
+ * stored into `previous[i]` (or NULL if its key was newly inserted).
+ *
+ * Params:
+ *    map - The hashmap to operate on.
+ *    keys - The array of keys to insert.
+ *    values - The array of values to associate with the keys.
+ *    n - The number of key-value pairs.
+ *    previous - Array of `n` slots to store the replaced values into, or NULL.
+ * Returns:
+ *    OK - Operation was successful.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap; some of the pairs may not
+ *                    have been inserted.
+ */
+Status ts_hashmap_putAll(ConcurrentHashMap *map, void **keys, void **values, long n,
+                         void **previous);
+
+/**
+ * Fetches the values to which each of the `n` keys in `keys` are mapped, and stores them into
+ * `values` at the same indices (or NULL if the key is not present). Each stripe is locked only
+ * once for reading while its share of the keys is looked up.
+ *
+ * Params:
+ *    map - The hashmap to operate on.
+ *    keys - The array of keys to look up.
+ *    values - Array of `n` slots to store the fetched values into.
+ *    n - The number of keys.
+ * Returns:
+ *    The number of keys that were found in the hashmap.
+ */
+long ts_hashmap_getAll(ConcurrentHashMap *map, void **keys, void **values, long n);
+
+/**
+ * Removes the mappings for each of the `n` keys in `keys` from the hashmap if present. Each stripe
+ * is locked only once while its share of the keys is removed. If `values` is not NULL, the value
+ * removed for the i-th key is stored into `values[i]` (or NULL if the key was not present).
+ *
+ * Params:
+ *    map - The hashmap to operate on.
+ *    keys - The array of keys whose mappings are to be removed.
+ *    values - Array of `n` slots to store the removed values into, or NULL.
+ *    n - The number of keys.
+ * Returns:
+ *    The number of mappings that were removed.
+ */
+long ts_hashmap_removeAll(ConcurrentHashMap *map, void **keys, void **values, long n);
+
 /**
  * Removes all elements from the hashmap. If `destructor` is not NULL, it will be invoked on each
  * element in the hashmap after being removed.
@@ -189,6 +433,19 @@ long ts_hashmap_size(ConcurrentHashMap *map);
  */
 Boolean ts_hashmap_isEmpty(ConcurrentHashMap *map);
 
+/**
+ * Reports on the layout of the hashmap and its history into `*stats`, the same as
+ * hashmap_stats(). The stripes are sampled one after another, each under its own lock, and their
+ * figures combined.
+ *
+ * Params:
+ *    map - The hashmap to operate on.
+ *    stats - The HashStats to fill in.
+ * Returns:
+ *    None
+ */
+void ts_hashmap_stats(ConcurrentHashMap *map, HashStats *stats);
+
 /**
  * Allocates and generates an array containing all of the hashmap's keys in no particular order,
  * then stores the array into `*keys`. Caller is responsible for freeing the array when finished.
@@ -233,6 +490,103 @@ Status ts_hashmap_entryArray(ConcurrentHashMap *map, Array **entries);
  */
 Status ts_hashmap_iterator(ConcurrentHashMap *map, ConcurrentIterator **iter);
 
+/**
+ * Applies `action` to each entry of the hashmap in no particular order, passing it the entry's key,
+ * its value and `context`. The walk stops as soon as `action` returns FALSE. The hashmap stays
+ * locked for reading throughout the walk and nothing is allocated, so `action` must neither modify
+ * the hashmap nor call back into it.
+ *
+ * Params:
+ *    map - The hashmap to operate on.
+ *    action - Function applied to each entry, returning FALSE to stop the walk.
+ *    context - Argument passed along to each call of `action`, may be NULL.
+ * Returns:
+ *    TRUE if `action` was applied to every entry, FALSE if it stopped the walk early.
+ */
+Boolean ts_hashmap_forEach(ConcurrentHashMap *map, Boolean (*action)(void *, void *, void *),
+                           void *context);
+
+/**
+ * Applies `action` to each entry of the hashmap using up to `nthreads` threads, passing it the
+ * entry's key, its value and `context`. The stripes are split into one even range per thread (so
+ * at most 64 threads are used), and each thread is given at least 16K entries, so a smaller map,
+ * or an `nthreads` <= 1, is walked on the calling thread. The ranges are walked concurrently in no
+ * particular order, and once `action` returns FALSE every thread stops at its next entry. Every
+ * stripe stays locked for reading throughout the walk, so `action` must be safe to call from
+ * several threads at once, and must neither modify the hashmap nor call back into it.
+ *
+ * Params:
+ *    map - The hashmap to operate on.
+ *    nthreads - The most threads to walk with, including the calling thread.
+ *    action - Function applied to each entry, returning FALSE to stop the walk.
+ *    context - Argument passed along to each call of `action`, may be NULL.
+ * Returns:
+ *    TRUE if `action` was applied to every entry, FALSE if it stopped the walk early.
+ */
+Boolean ts_hashmap_parallelForEach(ConcurrentHashMap *map, int nthreads,
+                                   Boolean (*action)(void *, void *, void *), void *context);
+
+/**
+ * Reduces the entries of the hashmap to a single result using up to `nthreads` threads, split as
+ * with ts_hashmap_parallelForEach() and folded as with hashmap_parallelReduce(). Every stripe stays
+ * locked for reading throughout, so neither `reducer` nor `combiner` may modify the hashmap or
+ * call back into it.
+ *
+ * Params:
+ *    map - The hashmap to operate on.
+ *    nthreads - The most threads to reduce with, including the calling thread.
+ *    reducer - Function folding an entry into a range's result.
+ *    combiner - Function merging two ranges' results.
+ *    context - Argument passed along to each call of `reducer` and `combiner`, may be NULL.
+ * Returns:
+ *    The reduced result, or NULL if the hashmap is empty.
+ */
+void *ts_hashmap_parallelReduce(ConcurrentHashMap *map, int nthreads,
+                                void *(*reducer)(void *, void *, void *, void *),
+                                void *(*combiner)(void *, void *, void *), void *context);
+
+/**
+ * Creates an Iterator instance over a snapshot of the hashmap's entries in no particular order,
+ * then stores the iterator into `*iter`. Unlike ts_hashmap_iterator(), the stripe locks are
+ * released as soon as the snapshot has been taken, so writers are not blocked while the caller
+ * iterates; changes made afterwards are not reflected. Note that the items being iterated over are
+ * `HmEntry*` copies, which stay valid after the hashmap is modified. Caller is responsible for
+ * destroying the iterator instance when finished.
+ *
+ * Params:
+ *    map - The hashmap to operate on.
+ *    iter - Address where the new iterator will be stored.
+ * Returns:
+ *    OK - Operation was successful.
+ *    STRUCT_EMPTY - HashMap is currently empty.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status ts_hashmap_snapshot(ConcurrentHashMap *map, ConcurrentIterator **iter);
+
+/**
+ * Returns the number of bytes of memory held by the hashmap: the hashmap itself, its stripes and
+ * the hashmap of each stripe, not counting the keys and values.
+ *
+ * Params:
+ *    map - The hashmap to operate on.
+ * Returns:
+ *    The hashmap's memory usage, in bytes.
+ */
+long ts_hashmap_memoryUsage(ConcurrentHashMap *map);
+
+/**
+ * Fills in `stats` with how contended the hashmap's locks have been since the hashmap was created,
+ * summing the counters of every stripe's lock. The counters remain 0 unless the library is
+ * compiled with CDS_LOCK_STATS defined.
+ *
+ * Params:
+ *    map - The hashmap to operate on.
+ *    stats - The stats to fill in.
+ * Returns:
+ *    None
+ */
+void ts_hashmap_lockStats(ConcurrentHashMap *map, LockStats *stats);
+
 /**
  * Destroys the hashmap instance by freeing all of its reserved memory. If `destructor` is not NULL,
  * it will be invoked on each element before the hashmap is destroyed.
@@ -25,7 +25,10 @@
 #ifndef _CDS_TS_HASHSET_H__
 #define _CDS_TS_HASHSET_H__
 
+#include <stdint.h>
 #include "cds_common.h"
+#include "hashing.h"
+#include "ts_lock.h"
 #include "ts_iterator.h"
 
 /**
@@ -33,6 +36,11 @@
  *
  * Set based implementation; holds a collection of elements with no duplicates.
  *
+ * The elements are split across a fixed number of lock stripes, as with the thread-safe hashmap,
+ * each an independent hashset with its own lock, so threads operating on elements in different
+ * stripes proceed in parallel. Operations over the whole hashset (size, clear, arrays, iterators)
+ * and ts_hashset_lock() acquire every stripe.
+ *
  * Modeled after the Java 7 HashSet interface.
  */
 typedef struct ts_hashset ConcurrentHashSet;
@@ -61,6 +69,26 @@ typedef struct ts_hashset ConcurrentHashSet;
 Status ts_hashset_new(ConcurrentHashSet **set, long (*hash)(void *, long),
                       int (*comparator)(void *, void *), long capacity, double loadFactor);
 
+/**
+ * Constructs a new hashset instance with a seeded, full-width hash function and the specified
+ * starting capacity and load factor, then stores the new instance into `*set`. The hashset draws a
+ * random seed when created, the same as hashset_newSeeded(). If the capacity specified is <= 0, a
+ * default capacity is assigned. If the load factor specified is <= 0.0, a default load factor is
+ * assigned.
+ *
+ * Params:
+ *    set - The pointer address to store the new HashSet instance.
+ *    hash - The seeded hashing function for computing the elements' hash codes.
+ *    comparator - Function for comparing two items in the hashset.
+ *    capacity - The hashset's starting capacity.
+ *    loadFactor - The hashset's assigned load factor.
+ * Returns:
+ *    OK - HashSet was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status ts_hashset_newSeeded(ConcurrentHashSet **set, uint64_t (*hash)(void *, uint64_t),
+                            int (*comparator)(void *, void *), long capacity, double loadFactor);
+
 /**
  * Locks the hashset, providing exclusive access to the calling thread. Caller is responsible for
  * unlocking the hashset to allow other threads access.
@@ -82,6 +110,74 @@ void ts_hashset_lock(ConcurrentHashSet *set);
  */
 void ts_hashset_unlock(ConcurrentHashSet *set);
 
+/**
+ * Locks the hashset for reading, providing shared access to the calling thread. If the hashset was
+ * created under the LOCK_RWLOCK or LOCK_BIASED policy, other threads may also read from the hashset
+ * at the same time; otherwise this is the same as ts_hashset_lock(). Caller is responsible for
+ * unlocking the hashset, and must not modify it while holding only the read lock.
+ *
+ * Params:
+ *    set - The hashset to operate on.
+ * Returns:
+ *    None
+ */
+void ts_hashset_lockRead(ConcurrentHashSet *set);
+
+/**
+ * Locks the hashset for writing, providing exclusive access to the calling thread. This is the same
+ * as ts_hashset_lock(). Caller is responsible for unlocking the hashset to allow other threads
+ * access.
+ *
+ * Params:
+ *    set - The hashset to operate on.
+ * Returns:
+ *    None
+ */
+void ts_hashset_lockWrite(ConcurrentHashSet *set);
+
+/**
+ * Enables or disables incremental resizing for the hashset. By default the hashset rehashes all of
+ * its elements into the larger array of buckets at once, which stalls the insertion that triggered
+ * the resize for time proportional to the hashset's size. With incremental resizing enabled, the
+ * hashset keeps both arrays of buckets while resizing, and each following insertion or removal
+ * moves a small, bounded number of buckets over. Lookups search both arrays while a resize is in
+ * progress, but never modify the hashset.
+ *
+ * Disabling incremental resizing completes any resize that is in progress.
+ *
+ * Params:
+ *    set - The hashset to operate on.
+ *    incremental - TRUE to resize incrementally, FALSE to resize all at once.
+ * Returns:
+ *    None
+ */
+void ts_hashset_setIncrementalResize(ConcurrentHashSet *set, Boolean incremental);
+
+/**
+ * Increases the capacity of the hashset, if necessary, so that it can hold at least `n` elements
+ * under its load factor without intermediate doublings.
+ *
+ * Params:
+ *    set - The hashset to operate on.
+ *    n - The number of elements to reserve room for.
+ * Returns:
+ *    OK - Operation was successful.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status ts_hashset_reserve(ConcurrentHashSet *set, long n);
+
+/**
+ * Shrinks the capacity of the hashset to the smallest that holds its current elements under its
+ * load factor, and drops any capacity that was reserved with ts_hashset_reserve().
+ *
+ * Params:
+ *    set - The hashset to operate on.
+ * Returns:
+ *    OK - Operation was successful.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status ts_hashset_shrinkToFit(ConcurrentHashSet *set);
+
 /**
  * Adds the specified element to the hashset if it is not already present.
  *
@@ -121,6 +217,58 @@ Boolean ts_hashset_contains(ConcurrentHashSet *set, void *item);
  */
 Status ts_hashset_remove(ConcurrentHashSet *set, void *item, void (*destructor)(void *));
 
+/**
+ * Adds each of the `n` elements in `items` into the hashset, as if by calling ts_hashset_add() on
+ * each of them in order; elements already present are skipped. The elements are first grouped by
+ * stripe, and each stripe is locked only once while its share of the batch is added with
+ * hashset_addAll(); the batch as a whole is not atomic.
+ *
+ * Params:
+ *    set - The hashset to operate on.
+ *    items - The array of elements to add.
+ *    n - The number of elements.
+ * Returns:
+ *    OK - Operation was successful.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap; some of the elements may not
+ *                    have been added.
+ */
+Status ts_hashset_addAll(ConcurrentHashSet *set, void **items, long n);
+
+/**
+ * Adds each of the `n` elements in `items` into the hashset using up to `nthreads` threads, for
+ * building a hashset from a large array. Each thread takes an even, contiguous share of `items`,
+ * hashes and groups it by stripe without holding any lock, then adds it as with
+ * ts_hashset_addAll(), starting from a different stripe than the other threads. Batches too small
+ * to be worth splitting are added on the calling thread. Elements already present are skipped;
+ * which of several equal elements in `items` ends up in the hashset is unspecified.
+ *
+ * Params:
+ *    set - The hashset to operate on.
+ *    items - The array of elements to add.
+ *    n - The number of elements.
+ *    nthreads - The most threads to add with, including the calling thread.
+ * Returns:
+ *    OK - Operation was successful.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap; some of the elements may not
+ *                    have been added.
+ */
+Status ts_hashset_addAllParallel(ConcurrentHashSet *set, void **items, long n, int nthreads);
+
+/**
+ * Removes each of the `n` elements in `items` from the hashset if present. Each stripe is locked
+ * only once while its share of the elements is removed. If `destructor` is not NULL, it will be
+ * invoked on each element removed.
+ *
+ * Params:
+ *    set - The hashset to operate on.
+ *    items - The array of elements to remove.
+ *    n - The number of elements.
+ *    destructor - Function to operate on each element after removal.
+ * Returns:
+ *    The number of elements that were removed.
+ */
+long ts_hashset_removeAll(ConcurrentHashSet *set, void **items, long n, void (*destructor)(void *));
+
 /**
  * Removes all elements from the hashset. If `destructor` is not NULL, it will be invoked on each
  * element in the hashset after being removed.
@@ -153,6 +301,17 @@ long ts_hashset_size(ConcurrentHashSet *set);
  */
 Boolean ts_hashset_isEmpty(ConcurrentHashSet *set);
 
+/**
+ * Reports on the layout of the hashset and its history into `*stats`, the same as hashset_stats().
+ *
+ * Params:
+ *    set - The hashset to operate on.
+ *    stats - The HashStats to fill in.
+ * Returns:
+ *    None
+ */
+void ts_hashset_stats(ConcurrentHashSet *set, HashStats *stats);
+
 /**
  * Allocates and generates an array containing all of the hashset's elements in no particular order,
  * then stores the array into `*array`. Caller is responsible for freeing the array when finished.
@@ -181,6 +340,62 @@ Status ts_hashset_toArray(ConcurrentHashSet *set, Array **array);
  */
 Status ts_hashset_iterator(ConcurrentHashSet *set, ConcurrentIterator **iter);
 
+/**
+ * Applies `action` to each element of the hashset in no particular order, passing it the element
+ * and `context`. The walk stops as soon as `action` returns FALSE. The hashset stays locked for
+ * reading throughout the walk and nothing is allocated, so `action` must neither modify the hashset
+ * nor call back into it.
+ *
+ * Params:
+ *    set - The hashset to operate on.
+ *    action - Function applied to each element, returning FALSE to stop the walk.
+ *    context - Argument passed along to each call of `action`, may be NULL.
+ * Returns:
+ *    TRUE if `action` was applied to every element, FALSE if it stopped the walk early.
+ */
+Boolean ts_hashset_forEach(ConcurrentHashSet *set, Boolean (*action)(void *, void *),
+                           void *context);
+
+/**
+ * Creates an Iterator instance over a snapshot of the set's elements in no particular order, then
+ * stores the iterator into `*iter`. Unlike ts_hashset_iterator(), the lock is released as soon as
+ * the snapshot has been taken, so writers are not blocked while the caller iterates; changes made
+ * afterwards are not reflected. The items themselves are shared with the set, so they must not be
+ * freed while iterating. Caller is responsible for destroying the iterator instance when finished.
+ *
+ * Params:
+ *    set - The hashset to operate on.
+ *    iter - Address where the new iterator will be stored.
+ * Returns:
+ *    OK - Operation was successful.
+ *    STRUCT_EMPTY - HashSet is currently empty.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status ts_hashset_snapshot(ConcurrentHashSet *set, ConcurrentIterator **iter);
+
+/**
+ * Returns the number of bytes of memory held by the hashset: the hashset itself, its lock and the
+ * hashset it wraps, not counting the elements themselves.
+ *
+ * Params:
+ *    set - The hashset to operate on.
+ * Returns:
+ *    The hashset's memory usage, in bytes.
+ */
+long ts_hashset_memoryUsage(ConcurrentHashSet *set);
+
+/**
+ * Fills in `stats` with how contended the hashset's lock has been since the hashset was created.
+ * The counters remain 0 unless the library is compiled with CDS_LOCK_STATS defined.
+ *
+ * Params:
+ *    set - The hashset to operate on.
+ *    stats - The stats to fill in.
+ * Returns:
+ *    None
+ */
+void ts_hashset_lockStats(ConcurrentHashSet *set, LockStats *stats);
+
 /**
  * Destroys the hashset instance by freeing all of its reserved memory. If `destructor` is not NULL,
  * it will be invoked on each element before the hashset is destroyed.
@@ -26,6 +26,7 @@
 #define _CDS_TS_HEAP_H__
 
 #include "cds_common.h"
+#include "ts_lock.h"
 #include "ts_iterator.h"
 
 /**
@@ -57,6 +58,38 @@ typedef struct ts_heap ConcurrentHeap;
  */
 Status ts_heap_new(ConcurrentHeap **heap, long capacity, int (*comparator)(void *, void *));
 
+/**
+ * Constructs a new empty heap instance whose nodes have `arity` children, then stores the new
+ * instance into `*heap`. See heap_newWithArity() for details.
+ *
+ * Params:
+ *    heap - The pointer address to store the new Heap instance.
+ *    capacity - The heap's starting capacity.
+ *    arity - The number of children of each node.
+ *    comparator - Function for comparing two items in the heap.
+ * Returns:
+ *    OK - Heap was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status ts_heap_newWithArity(ConcurrentHeap **heap, long capacity, long arity,
+                            int (*comparator)(void *, void *));
+
+/**
+ * Constructs a new heap instance holding the `n` elements of `items`, then stores the new instance
+ * into `*heap`. See heap_fromArray() for details.
+ *
+ * Params:
+ *    heap - The pointer address to store the new Heap instance.
+ *    items - The elements to add.
+ *    n - The number of elements in `items`.
+ *    comparator - Function for comparing two items in the heap.
+ * Returns:
+ *    OK - Heap was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status ts_heap_fromArray(ConcurrentHeap **heap, void **items, long n,
+                         int (*comparator)(void *, void *));
+
 /**
  * Locks the heap, providing exclusive access to the calling thread. Caller is responsible for
  * unlocking the heap to allow other threads access.
@@ -78,6 +111,50 @@ void ts_heap_lock(ConcurrentHeap *heap);
  */
 void ts_heap_unlock(ConcurrentHeap *heap);
 
+/**
+ * Locks the heap for reading, providing shared access to the calling thread. If the heap was
+ * created under the LOCK_RWLOCK or LOCK_BIASED policy, other threads may also read from the heap at
+ * the same time; otherwise this is the same as ts_heap_lock(). Caller is responsible for unlocking
+ * the heap, and must not modify it while holding only the read lock.
+ *
+ * Params:
+ *    heap - The heap to operate on.
+ * Returns:
+ *    None
+ */
+void ts_heap_lockRead(ConcurrentHeap *heap);
+
+/**
+ * Locks the heap for writing, providing exclusive access to the calling thread. This is the same as
+ * ts_heap_lock(). Caller is responsible for unlocking the heap to allow other threads access.
+ *
+ * Params:
+ *    heap - The heap to operate on.
+ * Returns:
+ *    None
+ */
+void ts_heap_lockWrite(ConcurrentHeap *heap);
+
+/**
+ * Sets the growth factor of the heap, that is, the percentage of its capacity to add whenever it
+ * becomes full. The percentage is expressed as a float in the range (0.0, 1.0], as with the string
+ * builder's growth factor; the default of 1.0 doubles the capacity. A smaller factor wastes less
+ * memory on a very large heap, at the cost of resizing it more often. If the factor given is
+ * outside of that range, the default factor is assigned.
+ *
+ * Whatever the factor, the heap is always grown enough for the elements being added, and never past
+ * the largest array that can be addressed. Arrays of 2MB or more are rounded up to whole 2MB pages;
+ * if the library is compiled with CDS_HUGE_PAGES defined, the kernel is also asked to back them
+ * with transparent huge pages (with madvise()).
+ *
+ * Params:
+ *    heap - The heap to operate on.
+ *    growthFactor - The percentage to increase the capacity when resizing is needed.
+ * Returns:
+ *    None
+ */
+void ts_heap_setGrowthFactor(ConcurrentHeap *heap, float growthFactor);
+
 /**
  * Inserts the specified element into the heap.
  *
@@ -90,6 +167,34 @@ void ts_heap_unlock(ConcurrentHeap *heap);
  */
 Status ts_heap_insert(ConcurrentHeap *heap, void *item);
 
+/**
+ * Inserts the `n` elements of `items` into the heap while holding the lock once for the whole
+ * batch. See heap_insertAll() for details.
+ *
+ * Params:
+ *    heap - The heap to operate on.
+ *    items - The elements to add.
+ *    n - The number of elements in `items`.
+ * Returns:
+ *    OK - Operation was successful.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status ts_heap_insertAll(ConcurrentHeap *heap, void **items, long n);
+
+/**
+ * Moves every element of the heap `src` into the heap `dst`, leaving `src` empty, while holding
+ * the locks of both heaps. The locks are always taken in the same order, so two threads merging
+ * the same pair of heaps in opposite directions cannot deadlock. See heap_merge() for details.
+ *
+ * Params:
+ *    dst - The heap to add the elements to.
+ *    src - The heap to take the elements from.
+ * Returns:
+ *    OK - Operation was successful.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status ts_heap_merge(ConcurrentHeap *dst, ConcurrentHeap *src);
+
 /**
  * Retrieves, but does not remove, the top of heap, and stores the element into `*min`.
  *
@@ -114,6 +219,48 @@ Status ts_heap_peek(ConcurrentHeap *heap, void **min);
  */
 Status ts_heap_poll(ConcurrentHeap *heap, void **min);
 
+/**
+ * Inserts the specified element into the heap, and stores a handle to it into `*handle`. See
+ * heap_insertHandle() for details.
+ *
+ * Params:
+ *    heap - The heap to operate on.
+ *    item - The element to add.
+ *    handle - The pointer address to store the element's handle into.
+ * Returns:
+ *    OK - Operation was successful.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status ts_heap_insertHandle(ConcurrentHeap *heap, void *item, HeapHandle *handle);
+
+/**
+ * Replaces the element with the handle `handle` by `item`, then moves it to where its priority now
+ * belongs. See heap_update() for details.
+ *
+ * Params:
+ *    heap - The heap to operate on.
+ *    handle - The handle of the element to update.
+ *    item - The element to store under the handle.
+ * Returns:
+ *    OK - Operation was successful.
+ *    NOT_FOUND - The handle does not belong to an element in the heap.
+ */
+Status ts_heap_update(ConcurrentHeap *heap, HeapHandle handle, void *item);
+
+/**
+ * Removes the element with the handle `handle` from the heap, and stores it into `*item`. See
+ * heap_removeHandle() for details.
+ *
+ * Params:
+ *    heap - The heap to operate on.
+ *    handle - The handle of the element to remove.
+ *    item - The pointer address to store the removed element into.
+ * Returns:
+ *    OK - Operation was successful.
+ *    NOT_FOUND - The handle does not belong to an element in the heap.
+ */
+Status ts_heap_removeHandle(ConcurrentHeap *heap, HeapHandle handle, void **item);
+
 /**
  * Removes all elements from the heap. If `destructor` is not NULL, it will be invoked on each
  * element in the heap after being removed.
@@ -176,6 +323,62 @@ Status ts_heap_toArray(ConcurrentHeap *heap, Array **array);
  */
 Status ts_heap_iterator(ConcurrentHeap *heap, ConcurrentIterator **iter);
 
+/**
+ * Applies `action` to each element of the heap in no particular order, passing it the element and
+ * `context`. The walk stops as soon as `action` returns FALSE. The heap stays locked for reading
+ * throughout the walk and nothing is allocated, so `action` must neither modify the heap nor call
+ * back into it.
+ *
+ * Params:
+ *    heap - The heap to operate on.
+ *    action - Function applied to each element, returning FALSE to stop the walk.
+ *    context - Argument passed along to each call of `action`, may be NULL.
+ * Returns:
+ *    TRUE if `action` was applied to every element, FALSE if it stopped the walk early.
+ */
+Boolean ts_heap_forEach(ConcurrentHeap *heap, Boolean (*action)(void *, void *), void *context);
+
+/**
+ * Creates an Iterator instance over a snapshot of the heap's elements in proper sequence (through
+ * a breadth-first traversal), then stores the iterator into `*iter`. Unlike ts_heap_iterator(),
+ * the lock is released as soon as the snapshot has been taken, so writers are not blocked while
+ * the caller iterates; changes made afterwards are not reflected. The items themselves are shared
+ * with the heap, so they must not be freed while iterating. Caller is responsible for destroying
+ * the iterator instance when finished.
+ *
+ * Params:
+ *    heap - The heap to operate on.
+ *    iter - Address where the new iterator will be stored.
+ * Returns:
+ *    OK - Operation was successful.
+ *    STRUCT_EMPTY - Heap is currently empty.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status ts_heap_snapshot(ConcurrentHeap *heap, ConcurrentIterator **iter);
+
+/**
+ * Returns the number of bytes of memory held by the heap: the heap itself, its lock and the heap
+ * it wraps, not counting the elements themselves.
+ *
+ * Params:
+ *    heap - The heap to operate on.
+ * Returns:
+ *    The heap's memory usage, in bytes.
+ */
+long ts_heap_memoryUsage(ConcurrentHeap *heap);
+
+/**
+ * Fills in `stats` with how contended the heap's lock has been since the heap was created. The
+ * counters remain 0 unless the library is compiled with CDS_LOCK_STATS defined.
+ *
+ * Params:
+ *    heap - The heap to operate on.
+ *    stats - The stats to fill in.
+ * Returns:
+ *    None
+ */
+void ts_heap_lockStats(ConcurrentHeap *heap, LockStats *stats);
+
 /**
  * Destroys the heap instance by freeing all of its reserved memory. If `destructor` is not NULL, it
  * will be invoked on each element before the heap is destroyed.
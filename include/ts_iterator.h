@@ -58,6 +58,39 @@ typedef struct ts_iterator ConcurrentIterator;
  */
 Status ts_iterator_new(ConcurrentIterator **iter, pthread_mutex_t *lock, void **items, long len);
 
+/**
+ * Creates a new iterator instance for the given array of items, then assigns the new iterator
+ * instance to `*iter`. Unlike ts_iterator_new(), the ADT being iterated over may be guarded by more
+ * than one lock; `release(arg)` is invoked to unlock all of them once the iterator is destroyed.
+ *
+ * Params:
+ *    iter - The pointer address to store the new Iterator into.
+ *    release - Function that unlocks the ADT being iterated over.
+ *    arg - The argument to invoke `release` with.
+ *    items - The array of items to iterate through.
+ *    len - The length of the array.
+ * Returns:
+ *    OK - Iterator was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status ts_iterator_newWithRelease(ConcurrentIterator **iter, void (*release)(void *), void *arg,
+                                  void **items, long len);
+
+/**
+ * Creates a new iterator instance for the given array of items, then assigns the new iterator
+ * instance to `*iter`. The iterator holds no lock on the ADT it was created from, so `items` must
+ * already be a complete snapshot that no longer depends on the ADT's lock.
+ *
+ * Params:
+ *    iter - The pointer address to store the new Iterator into.
+ *    items - The array of items to iterate through.
+ *    len - The length of the array.
+ * Returns:
+ *    OK - Iterator was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status ts_iterator_newSnapshot(ConcurrentIterator **iter, void **items, long len);
+
 /**
  * Returns TRUE if the iteration has more elements, FALSE if not.
  *
@@ -80,6 +113,35 @@ Boolean ts_iterator_hasNext(ConcurrentIterator *iter);
  */
 Status ts_iterator_next(ConcurrentIterator *iter, void **next);
 
+/**
+ * Returns the number of elements the iterator has yet to return.
+ *
+ * Params:
+ *    iter - The iterator to operate on.
+ * Returns:
+ *    The number of remaining elements.
+ */
+long ts_iterator_remaining(ConcurrentIterator *iter);
+
+/**
+ * Splits the elements the iterator has yet to return into two disjoint halves: the first half is
+ * handed over to a new iterator, stored into `*prefix`, while `iter` keeps the second half. The
+ * halves share the iterator's items rather than copying them, and either half may be split again.
+ * Each half may then be walked and destroyed on a different thread. The items, and any locks the
+ * iterator holds on its ADT, are only released once every iterator sharing them has been
+ * destroyed; for an iterator holding locks, the last of them must be destroyed by the thread that
+ * created the original iterator.
+ *
+ * Params:
+ *    iter - The iterator to operate on.
+ *    prefix - The pointer address to store the iterator over the first half into.
+ * Returns:
+ *    OK - Iterator was successfully split.
+ *    ITER_END - Fewer than two elements remain, so the iterator was not split.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status ts_iterator_trySplit(ConcurrentIterator *iter, ConcurrentIterator **prefix);
+
 /**
  * Destroys the iterator instance by freeing all of its reserved memory.
  *
@@ -26,6 +26,7 @@
 #define _CDS_TS_LINKEDLIST_H__
 
 #include "cds_common.h"
+#include "ts_lock.h"
 #include "ts_iterator.h"
 
 /**
@@ -49,6 +50,33 @@ typedef struct ts_linkedlist ConcurrentLinkedList;
  */
 Status ts_linkedlist_new(ConcurrentLinkedList **list);
 
+/**
+ * Creates a new linked list instance whose nodes are allocated from `pool`, then stores the new instance
+ * into `*list`. The pool may be shared with other ADTs and must outlive the linked list. A pool shared
+ * by ADTs used from different threads must be created with nodepool_newConcurrent(). If `pool` is
+ * NULL, a private pool is used instead, the same as ts_linkedlist_new().
+ *
+ * Params:
+ *    list - The pointer address to store the new LinkedList instance.
+ *    pool - The pool to allocate the nodes from, or NULL.
+ * Returns:
+ *    OK - LinkedList was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status ts_linkedlist_newWithPool(ConcurrentLinkedList **list, NodePool *pool);
+
+/**
+ * Creates a new unrolled linked list instance, storing its elements in chunks of up to 32 rather
+ * than one node each (see linkedlist_newUnrolled()), then stores the new instance into `*list`.
+ *
+ * Params:
+ *    list - The pointer address to store the new LinkedList instance.
+ * Returns:
+ *    OK - LinkedList was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status ts_linkedlist_newUnrolled(ConcurrentLinkedList **list);
+
 /**
  * Locks the linked list, providing exclusive access to the calling thread. Caller is responsible
  * for unlocking the linked list to allow other threads access.
@@ -70,6 +98,32 @@ void ts_linkedlist_lock(ConcurrentLinkedList *list);
  */
 void ts_linkedlist_unlock(ConcurrentLinkedList *list);
 
+/**
+ * Locks the linked list for reading, providing shared access to the calling thread. If the linked
+ * list was created under the LOCK_RWLOCK or LOCK_BIASED policy, other threads may also read from
+ * the linked list at the same time; otherwise this is the same as ts_linkedlist_lock(). Caller is
+ * responsible for unlocking the linked list, and must not modify it while holding only the read
+ * lock.
+ *
+ * Params:
+ *    list - The linked list to operate on.
+ * Returns:
+ *    None
+ */
+void ts_linkedlist_lockRead(ConcurrentLinkedList *list);
+
+/**
+ * Locks the linked list for writing, providing exclusive access to the calling thread. This is the
+ * same as ts_linkedlist_lock(). Caller is responsible for unlocking the linked list to allow other
+ * threads access.
+ *
+ * Params:
+ *    list - The linked list to operate on.
+ * Returns:
+ *    None
+ */
+void ts_linkedlist_lockWrite(ConcurrentLinkedList *list);
+
 /**
  * Inserts the specified element at the beginning of the linked list.
  *
@@ -277,6 +331,63 @@ Status ts_linkedlist_toArray(ConcurrentLinkedList *list, Array **array);
  */
 Status ts_linkedlist_iterator(ConcurrentLinkedList *list, ConcurrentIterator **iter);
 
+/**
+ * Applies `action` to each element of the linked list from first to last, passing it the element
+ * and `context`. The walk stops as soon as `action` returns FALSE. The linked list stays locked for
+ * reading throughout the walk and nothing is allocated, so `action` must neither modify the linked
+ * list nor call back into it.
+ *
+ * Params:
+ *    list - The linked list to operate on.
+ *    action - Function applied to each element, returning FALSE to stop the walk.
+ *    context - Argument passed along to each call of `action`, may be NULL.
+ * Returns:
+ *    TRUE if `action` was applied to every element, FALSE if it stopped the walk early.
+ */
+Boolean ts_linkedlist_forEach(ConcurrentLinkedList *list, Boolean (*action)(void *, void *),
+                              void *context);
+
+/**
+ * Creates an Iterator instance over a snapshot of the list's elements in proper sequence (from
+ * first to last element), then stores the iterator into `*iter`. Unlike ts_linkedlist_iterator(),
+ * the lock is released as soon as the snapshot has been taken, so writers are not blocked while
+ * the caller iterates; changes made afterwards are not reflected. The items themselves are shared
+ * with the list, so they must not be freed while iterating. Caller is responsible for destroying
+ * the iterator instance when finished.
+ *
+ * Params:
+ *    list - The linked list to operate on.
+ *    iter - Address where the new iterator will be stored.
+ * Returns:
+ *    OK - Operation was successful.
+ *    STRUCT_EMPTY - Linked list is currently empty.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status ts_linkedlist_snapshot(ConcurrentLinkedList *list, ConcurrentIterator **iter);
+
+/**
+ * Returns the number of bytes of memory held by the linked list: the linked list itself, its lock
+ * and the linked list it wraps, not counting the elements themselves.
+ *
+ * Params:
+ *    list - The linked list to operate on.
+ * Returns:
+ *    The linked list's memory usage, in bytes.
+ */
+long ts_linkedlist_memoryUsage(ConcurrentLinkedList *list);
+
+/**
+ * Fills in `stats` with how contended the linked list's lock has been since the linked list was
+ * created. The counters remain 0 unless the library is compiled with CDS_LOCK_STATS defined.
+ *
+ * Params:
+ *    list - The linked list to operate on.
+ *    stats - The stats to fill in.
+ * Returns:
+ *    None
+ */
+void ts_linkedlist_lockStats(ConcurrentLinkedList *list, LockStats *stats);
+
 /**
  * Destroys the linked list instance by freeing all of its reserved memory. If `destructor` is not
  * NULL, it will be invoked on each element before the linked list is destroyed.
@@ -0,0 +1,271 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2020 Cole Vikupitz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef _CDS_TS_LOCK_H__
+#define _CDS_TS_LOCK_H__
+
+#include <pthread.h>
+#include <stddef.h>
+#include "cds_common.h"
+
+// The size of a cache line, may be overridden at compile time for other architectures
+#ifndef CDS_CACHE_LINE
+#define CDS_CACHE_LINE 64
+#endif
+
+/**
+ * Attribute aligning a struct (or member) to a cache line, which also pads the struct's size to a
+ * multiple of the line. The thread-safe ADTs use it so that the locks of ADTs allocated next to
+ * each other, or the stripes of one ADT, never share a line and bounce it between cores.
+ */
+#define CACHE_ALIGNED __attribute__((aligned(CDS_CACHE_LINE)))
+
+/**
+ * Declaration for the lock used by the thread-safe ADTs. Every thread-safe ADT is guarded by one of
+ * these locks, created with the lock policy that was the calling thread's default when the ADT was
+ * constructed. Under the default LOCK_MUTEX policy the lock is a recursive mutex, and read and
+ * write acquisitions behave the same. Under the LOCK_RWLOCK policy the lock is a reader-writer
+ * lock: operations that only read from the ADT acquire it shared, so they run in parallel with each
+ * other, while operations that modify the ADT acquire it exclusively.
+ *
+ * The remaining policies are exclusive like LOCK_MUTEX, but suit short critical sections better:
+ * - LOCK_NORMAL uses a normal, non-recursive mutex, which is cheaper to acquire and release.
+ * - LOCK_SPIN spins for a short while when the lock is held, and only then parks the thread on a
+ *   futex (or, outside Linux, yields the CPU between tries); most operations on an ADT take less
+ *   time than the system call does.
+ * - LOCK_TICKET hands the lock out in the order the threads asked for it, so that no thread
+ *   starves under heavy contention. Waiting threads spin (yielding the CPU between spins), so it
+ *   is best kept to as many threads as there are cores.
+ *
+ * The LOCK_BIASED policy is a reader-writer lock like LOCK_RWLOCK, tuned for ADTs that are read
+ * far more often than they are modified, such as lookup tables. Readers don't write to the lock
+ * at all: each one publishes itself in a slot of a table shared by every lock, picked by hashing
+ * the thread and the lock, so that readers on different cores (or sockets) never contend on a
+ * cache line. A writer turns the bias off, then waits for the readers in the table to finish;
+ * readers that find the bias off (or their slot taken) use the reader-writer lock instead. The
+ * bias is turned back on by a reader once enough time has passed since the last writer, in
+ * proportion to how long that writer waited, so that frequent writers keep it off.
+ *
+ * Every policy is re-entrant: a thread holding the lock for writing may acquire it again for
+ * reading or writing, and a thread holding it for reading may acquire it again for reading. The
+ * policies other than LOCK_MUTEX track the thread holding the lock instead of relying on a
+ * recursive mutex. Under LOCK_RWLOCK, a thread holding the lock only for reading must NOT attempt
+ * to acquire it for writing (i.e. modify the ADT while holding a read lock or an iterator), as it
+ * will deadlock.
+ */
+typedef enum {
+    LOCK_MUTEX = 0,     // Recursive mutex, the default
+    LOCK_RWLOCK = 1,    // Reader-writer lock
+    LOCK_NORMAL = 2,    // Normal mutex
+    LOCK_SPIN = 3,      // Spins, then parks on a futex
+    LOCK_TICKET = 4,    // Ticket lock, granted in arrival order
+    LOCK_BIASED = 5     // Reader-writer lock whose readers don't write to it
+} LockPolicy;
+
+/**
+ * Struct for the lock; declared here so that it can be embedded into the thread-safe ADTs. Its
+ * members should not be accessed directly.
+ */
+typedef struct ts_lock {
+    LockPolicy policy;              // The policy the lock was created with
+    union {
+        pthread_mutex_t mutex;      // The lock under LOCK_MUTEX and LOCK_NORMAL
+        pthread_rwlock_t rwlock;    // The lock under LOCK_RWLOCK and LOCK_BIASED
+        int futex;                  // The lock under LOCK_SPIN: 0 free, 1 held, 2 waited on
+        struct {
+            unsigned int next;      // The next ticket to hand out under LOCK_TICKET
+            unsigned int serving;   // The ticket now holding the lock
+        } ticket;
+    } u;
+    pthread_t owner;                // Thread holding the lock exclusively, if `depth` > 0
+    long depth;                     // Number of exclusive acquisitions held by `owner`
+    int bias;                       // Non-zero while readers may skip the rwlock, if LOCK_BIASED
+    long inhibitUntil;              // Time before which the bias stays off after a writer
+    long acquisitions;              // The counters of LockStats, if compiled with CDS_LOCK_STATS
+    long contended;
+    long waitNanos;
+    long holdNanos;
+    long holds;                     // Exclusive acquisitions held, only the outermost is timed
+    long heldSince;                 // When the outermost exclusive acquisition was made
+} TsLock;
+
+/**
+ * A structure reporting how contended a thread-safe ADT's lock is, filled in by the lockStats()
+ * methods of the thread-safe ADTs. A high share of contended acquisitions, or a wait time growing
+ * faster than the hold time, marks an ADT worth striping or replacing with a lock-free one.
+ *
+ * Hold times count the lock held exclusively: under LOCK_MUTEX every acquisition, under
+ * LOCK_RWLOCK only acquisitions for writing, as readers share the lock. Re-entrant acquisitions
+ * are timed as part of the outermost one. Under LOCK_BIASED, the reads that skip the lock aren't
+ * counted, as counting them would write to the lock.
+ *
+ * The counters cost a try-lock and two clock reads per acquisition, and are only maintained when
+ * the library is compiled with CDS_LOCK_STATS defined; otherwise they remain 0. When compiled with
+ * it and <sys/sdt.h> is available, every acquisition also fires the USDT probe
+ * cds:lock__acquired(lock, waitNanos), and every release of an exclusive hold fires
+ * cds:lock__released(lock, holdNanos), for tracing with perf or bpftrace.
+ */
+typedef struct {
+    long acquisitions;      // Number of times the lock was acquired
+    long contended;         // Number of acquisitions that found the lock held and had to wait
+    long waitNanos;         // Total time spent waiting for the lock, in nanoseconds
+    long holdNanos;         // Total time the lock was held exclusively, in nanoseconds
+} LockStats;
+
+/**
+ * Sets the lock policy used by thread-safe ADTs constructed by the calling thread from now on.
+ * ADTs that were already constructed keep the policy they were created with.
+ *
+ * Params:
+ *    policy - The lock policy to use.
+ * Returns:
+ *    None
+ */
+void ts_lock_setDefaultPolicy(LockPolicy policy);
+
+/**
+ * Returns the lock policy used by thread-safe ADTs constructed by the calling thread.
+ *
+ * Params:
+ *    None
+ * Returns:
+ *    The calling thread's default lock policy.
+ */
+LockPolicy ts_lock_getDefaultPolicy(void);
+
+/**
+ * Sets the NUMA node that thread-safe ADTs constructed by the calling thread from now on are
+ * allocated on, or -1 to leave their placement to the kernel (the default, which places memory on
+ * the node of the thread that first writes to it). The node is only a preference: if it can't be
+ * honoured, or the system has no NUMA support, the memory comes from any node.
+ *
+ * Only the thread-safe ADT itself, holding its lock (or locks), is placed; the ADT it wraps still
+ * follows the kernel's placement. Binding memory to a node works on whole pages, so each ADT takes
+ * up at least one page while a node is set.
+ *
+ * Params:
+ *    node - The NUMA node to allocate on, from 0 to 63, or -1 for none.
+ * Returns:
+ *    None
+ */
+void ts_lock_setDefaultNode(int node);
+
+/**
+ * Returns the NUMA node that thread-safe ADTs constructed by the calling thread are allocated on,
+ * or -1 if their placement is left to the kernel.
+ *
+ * Params:
+ *    None
+ * Returns:
+ *    The calling thread's default NUMA node.
+ */
+int ts_lock_getDefaultNode(void);
+
+/**
+ * Allocates `size` bytes aligned to a cache line, padded to a whole number of lines, and placed on
+ * the calling thread's default NUMA node, if any. Used by the thread-safe ADTs to allocate
+ * themselves; the memory is released with free().
+ *
+ * Params:
+ *    size - The number of bytes to allocate.
+ * Returns:
+ *    The allocated memory, or NULL if the allocation fails.
+ */
+void *ts_lock_alloc(size_t size);
+
+/**
+ * Initializes the lock with the calling thread's default lock policy.
+ *
+ * Params:
+ *    lock - The lock to initialize.
+ * Returns:
+ *    None
+ */
+void ts_lock_init(TsLock *lock);
+
+/**
+ * Acquires the lock for reading, blocking until it is available.
+ *
+ * Params:
+ *    lock - The lock to operate on.
+ * Returns:
+ *    None
+ */
+void ts_lock_read(TsLock *lock);
+
+/**
+ * Acquires the lock for writing, blocking until it is available.
+ *
+ * Params:
+ *    lock - The lock to operate on.
+ * Returns:
+ *    None
+ */
+void ts_lock_write(TsLock *lock);
+
+/**
+ * Releases one acquisition of the lock held by the calling thread, either for reading or writing.
+ *
+ * Params:
+ *    lock - The lock to operate on.
+ * Returns:
+ *    None
+ */
+void ts_lock_unlock(TsLock *lock);
+
+/**
+ * Same as ts_lock_unlock(), taking the lock as a `void *` so that it may be handed to
+ * ts_iterator_newWithRelease().
+ *
+ * Params:
+ *    lock - The lock to operate on.
+ * Returns:
+ *    None
+ */
+void ts_lock_release(void *lock);
+
+/**
+ * Fills in `stats` with the counters of the lock, which are all 0 unless the library is compiled
+ * with CDS_LOCK_STATS defined.
+ *
+ * Params:
+ *    lock - The lock to operate on.
+ *    stats - The stats to fill in.
+ * Returns:
+ *    None
+ */
+void ts_lock_stats(TsLock *lock, LockStats *stats);
+
+/**
+ * Destroys the lock. The lock must not be held by any thread.
+ *
+ * Params:
+ *    lock - The lock to destroy.
+ * Returns:
+ *    None
+ */
+void ts_lock_destroy(TsLock *lock);
+
+#endif  /* _CDS_TS_LOCK_H__ */
@@ -0,0 +1,255 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2020 Cole Vikupitz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef _CDS_TS_LRU_CACHE_H__
+#define _CDS_TS_LRU_CACHE_H__
+
+#include <stdint.h>
+#include "cds_common.h"
+#include "lru_cache.h"
+#include "ts_lock.h"
+
+/**
+ * Declaration for the thread-safe LruCache ADT.
+ *
+ * The keys are split across a fixed number of shards, each an independent LruCache with its own
+ * lock, its own recency list and its share of the capacity and charge limit. Since every lookup
+ * reorders its shard's recency list, lookups lock their shard for writing; threads requesting keys
+ * in different shards still proceed in parallel. Eviction is therefore least recently used within
+ * each shard, which approximates the whole cache's recency order for well spread keys. Eviction
+ * listeners run while their shard is locked, and must not call back into the cache.
+ */
+typedef struct ts_lru_cache ConcurrentLruCache;
+
+/**
+ * Creates a new, empty cache holding about `capacity` entries, dividing the capacity evenly among
+ * the shards, then stores the new instance into `*cache`. If the capacity specified is <= 0, the
+ * number of entries is unbounded. See lrucache_new() for the remaining parameters.
+ *
+ * Params:
+ *    cache - The pointer address to store the new ConcurrentLruCache instance.
+ *    hash - The seeded hashing function for computing the keys' hash codes.
+ *    keyComparator - Function for comparing two keys in the cache.
+ *    capacity - The largest number of entries the cache holds.
+ *    keyDestructor - Function for de-allocating the cache's keys.
+ * Returns:
+ *    OK - ConcurrentLruCache was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status ts_lrucache_new(ConcurrentLruCache **cache, uint64_t (*hash)(void *, uint64_t),
+                       int (*keyComparator)(void *, void *), long capacity,
+                       void (*keyDestructor)(void *));
+
+/**
+ * Bounds the total charge of the cache's entries to about `limit`, dividing it evenly among the
+ * shards. See lrucache_setChargeLimit().
+ *
+ * Params:
+ *    cache - The cache to operate on.
+ *    limit - The largest total charge of the cache's entries.
+ * Returns:
+ *    None
+ */
+void ts_lrucache_setChargeLimit(ConcurrentLruCache *cache, long limit);
+
+/**
+ * Sets the function invoked on every entry evicted to stay within the cache's bounds. See
+ * lrucache_setEvictionListener().
+ *
+ * Params:
+ *    cache - The cache to operate on.
+ *    listener - Function invoked on each evicted entry, or NULL for none.
+ *    context - Argument passed along to each call of `listener`, may be NULL.
+ * Returns:
+ *    None
+ */
+void ts_lrucache_setEvictionListener(ConcurrentLruCache *cache,
+                                     void (*listener)(void *, void *, void *), void *context);
+
+/**
+ * Turns frequency admission on or off in every shard. See lrucache_setFrequencyAdmission().
+ *
+ * Params:
+ *    cache - The cache to operate on.
+ *    enabled - TRUE to admit new keys by frequency, FALSE to admit every key.
+ * Returns:
+ *    OK - Operation was successful.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status ts_lrucache_setFrequencyAdmission(ConcurrentLruCache *cache, Boolean enabled);
+
+/**
+ * Associates `value` with `key` in the cache. See lrucache_put().
+ *
+ * Params:
+ *    cache - The cache to operate on.
+ *    key - The key with which the specified value is to be associated.
+ *    value - The value to be associated with the specified key.
+ *    charge - The entry's charge towards the charge limit, such as its size in bytes.
+ *    previous - The pointer address to store the previous value into.
+ * Returns:
+ *    INSERTED - Entry was inserted.
+ *    REPLACED - Entry was updated in the cache, and the old value was stored into `*previous`.
+ *    STRUCT_FULL - Entry was not inserted, as its charge alone exceeds its shard's charge limit, or
+ *                  it was turned away by frequency admission.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status ts_lrucache_put(ConcurrentLruCache *cache, void *key, void *value, long charge,
+                       void **previous);
+
+/**
+ * Fetches the value to which the specified key is mapped, and makes the entry the most recently
+ * used one in its shard. See lrucache_get().
+ *
+ * Params:
+ *    cache - The cache to operate on.
+ *    key - The key whose associated value is to be returned.
+ *    value - The pointer address to store the fetched value into.
+ * Returns:
+ *    OK - Operation was successful.
+ *    NOT_FOUND - Entry with the specified key was not found.
+ */
+Status ts_lrucache_get(ConcurrentLruCache *cache, void *key, void **value);
+
+/**
+ * Fetches the value to which the specified key is mapped, locking its shard only for reading. See
+ * lrucache_peek().
+ *
+ * Params:
+ *    cache - The cache to operate on.
+ *    key - The key whose associated value is to be returned.
+ *    value - The pointer address to store the fetched value into.
+ * Returns:
+ *    OK - Operation was successful.
+ *    NOT_FOUND - Entry with the specified key was not found.
+ */
+Status ts_lrucache_peek(ConcurrentLruCache *cache, void *key, void **value);
+
+/**
+ * Returns TRUE if the cache contains a mapping for the specified key, FALSE if otherwise.
+ *
+ * Params:
+ *    cache - The cache to operate on.
+ *    key - The key to search for.
+ * Returns:
+ *    TRUE if a mapping exists with the key, FALSE if not.
+ */
+Boolean ts_lrucache_containsKey(ConcurrentLruCache *cache, void *key);
+
+/**
+ * Removes the mapping for the specified key from the cache if present, and stores its value into
+ * `*value`.
+ *
+ * Params:
+ *    cache - The cache to operate on.
+ *    key - The key whose mapping is to be removed from the cache.
+ *    value - The pointer address to store the removed value into.
+ * Returns:
+ *    OK - Operation was successful.
+ *    NOT_FOUND - Entry with the specified key was not found.
+ */
+Status ts_lrucache_remove(ConcurrentLruCache *cache, void *key, void **value);
+
+/**
+ * Returns the number of entries in the cache.
+ *
+ * Params:
+ *    cache - The cache to operate on.
+ * Returns:
+ *    The cache's size.
+ */
+long ts_lrucache_size(ConcurrentLruCache *cache);
+
+/**
+ * Returns the total charge of the entries in the cache.
+ *
+ * Params:
+ *    cache - The cache to operate on.
+ * Returns:
+ *    The cache's total charge.
+ */
+long ts_lrucache_charge(ConcurrentLruCache *cache);
+
+/**
+ * Fills in `stats` with the number of hits, misses, evictions and rejections since the cache was
+ * created, summed over every shard.
+ *
+ * Params:
+ *    cache - The cache to operate on.
+ *    stats - The stats to fill in.
+ * Returns:
+ *    None
+ */
+void ts_lrucache_stats(ConcurrentLruCache *cache, CacheStats *stats);
+
+/**
+ * Removes all the entries from the cache. If `valueDestructor` is not NULL, it will be invoked on
+ * each value removed.
+ *
+ * Params:
+ *    cache - The cache to operate on.
+ *    valueDestructor - Function to operate on each entry value, may be NULL.
+ * Returns:
+ *    None
+ */
+void ts_lrucache_clear(ConcurrentLruCache *cache, void (*valueDestructor)(void *));
+
+/**
+ * Returns the number of bytes of memory held by the cache, summed over every shard, not counting
+ * the keys and values.
+ *
+ * Params:
+ *    cache - The cache to operate on.
+ * Returns:
+ *    The cache's memory usage, in bytes.
+ */
+long ts_lrucache_memoryUsage(ConcurrentLruCache *cache);
+
+/**
+ * Fills in `stats` with how contended the cache's locks have been since the cache was created,
+ * summing the counters of every shard's lock. The counters remain 0 unless the library is compiled
+ * with CDS_LOCK_STATS defined.
+ *
+ * Params:
+ *    cache - The cache to operate on.
+ *    stats - The stats to fill in.
+ * Returns:
+ *    None
+ */
+void ts_lrucache_lockStats(ConcurrentLruCache *cache, LockStats *stats);
+
+/**
+ * Destroys the cache instance by freeing all of its reserved memory. If `valueDestructor` is not
+ * NULL, it will be invoked on each value before the cache is destroyed.
+ *
+ * Params:
+ *    cache - The cache to destroy.
+ *    valueDestructor - Function to operate on each entry value prior to destruction.
+ * Returns:
+ *    None
+ */
+void ts_lrucache_destroy(ConcurrentLruCache *cache, void (*valueDestructor)(void *));
+
+#endif  /* _CDS_TS_LRU_CACHE_H__ */
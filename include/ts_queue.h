@@ -26,6 +26,8 @@
 #define _CDS_TS_QUEUE_H__
 
 #include "cds_common.h"
+#include "node_pool.h"
+#include "ts_lock.h"
 #include "ts_iterator.h"
 
 /**
@@ -50,6 +52,33 @@ typedef struct ts_queue ConcurrentQueue;
  */
 Status ts_queue_new(ConcurrentQueue **queue);
 
+/**
+ * Creates a new queue instance whose nodes are allocated from `pool`, then stores the new instance
+ * into `*queue`. The pool may be shared with other ADTs and must outlive the queue. A pool shared
+ * by ADTs used from different threads must be created with nodepool_newConcurrent(). If `pool` is
+ * NULL, a private pool is used instead, the same as ts_queue_new().
+ *
+ * Params:
+ *    queue - The pointer address to store the new Queue instance.
+ *    pool - The pool to allocate the nodes from, or NULL.
+ * Returns:
+ *    OK - Queue was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status ts_queue_newWithPool(ConcurrentQueue **queue, NodePool *pool);
+
+/**
+ * Creates a new unrolled queue instance, storing its elements in chunks of 32 rather than one node
+ * each (see queue_newUnrolled()), then stores the new instance into `*queue`.
+ *
+ * Params:
+ *    queue - The pointer address to store the new Queue instance.
+ * Returns:
+ *    OK - Queue was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status ts_queue_newUnrolled(ConcurrentQueue **queue);
+
 /**
  * Locks the queue, providing exclusive access to the calling thread. Caller is responsible for
  * unlocking the queue to allow other threads access.
@@ -71,6 +100,30 @@ void ts_queue_lock(ConcurrentQueue *queue);
  */
 void ts_queue_unlock(ConcurrentQueue *queue);
 
+/**
+ * Locks the queue for reading, providing shared access to the calling thread. If the queue was
+ * created under the LOCK_RWLOCK or LOCK_BIASED policy, other threads may also read from the queue
+ * at the same time; otherwise this is the same as ts_queue_lock(). Caller is responsible for
+ * unlocking the queue, and must not modify it while holding only the read lock.
+ *
+ * Params:
+ *    queue - The queue to operate on.
+ * Returns:
+ *    None
+ */
+void ts_queue_lockRead(ConcurrentQueue *queue);
+
+/**
+ * Locks the queue for writing, providing exclusive access to the calling thread. This is the same
+ * as ts_queue_lock(). Caller is responsible for unlocking the queue to allow other threads access.
+ *
+ * Params:
+ *    queue - The queue to operate on.
+ * Returns:
+ *    None
+ */
+void ts_queue_lockWrite(ConcurrentQueue *queue);
+
 /**
  * Inserts the specified element into the queue.
  *
@@ -83,6 +136,21 @@ void ts_queue_unlock(ConcurrentQueue *queue);
  */
 Status ts_queue_add(ConcurrentQueue *queue, void *item);
 
+/**
+ * Adds the `n` elements in the array `items` to the tail of the queue, in order, in a single lock
+ * acquisition. Either every element is added or, on failure, none is.
+ *
+ * Params:
+ *    queue - The queue to operate on.
+ *    items - The array of elements to add.
+ *    n - The number of elements in `items`.
+ * Returns:
+ *    OK - Operation was successful.
+ *    INVALID_INDEX - `n` is negative.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status ts_queue_addAll(ConcurrentQueue *queue, void **items, long n);
+
 /**
  * Retrieves, but does not remove, the first element from the queue and stores the result into
  * `*first`.
@@ -108,6 +176,19 @@ Status ts_queue_peek(ConcurrentQueue *queue, void **first);
  */
 Status ts_queue_poll(ConcurrentQueue *queue, void **first);
 
+/**
+ * Removes up to `max` elements from the front of the queue in a single lock acquisition, storing
+ * them in FIFO order into `items`, which must have room for `max` elements.
+ *
+ * Params:
+ *    queue - The queue to operate on.
+ *    items - The array to store the removed elements into.
+ *    max - The maximum number of elements to remove.
+ * Returns:
+ *    The number of elements removed and stored into `items`.
+ */
+long ts_queue_pollMany(ConcurrentQueue *queue, void **items, long max);
+
 /**
  * Removes all elements from the queue. If `destructor` is not NULL, it will be invoked on each
  * element in the queue after being removed.
@@ -170,6 +251,62 @@ Status ts_queue_toArray(ConcurrentQueue *queue, Array **array);
  */
 Status ts_queue_iterator(ConcurrentQueue *queue, ConcurrentIterator **iter);
 
+/**
+ * Applies `action` to each element of the queue from front to back, passing it the element and
+ * `context`. The walk stops as soon as `action` returns FALSE. The queue stays locked for reading
+ * throughout the walk and nothing is allocated, so `action` must neither modify the queue nor call
+ * back into it.
+ *
+ * Params:
+ *    queue - The queue to operate on.
+ *    action - Function applied to each element, returning FALSE to stop the walk.
+ *    context - Argument passed along to each call of `action`, may be NULL.
+ * Returns:
+ *    TRUE if `action` was applied to every element, FALSE if it stopped the walk early.
+ */
+Boolean ts_queue_forEach(ConcurrentQueue *queue, Boolean (*action)(void *, void *), void *context);
+
+/**
+ * Creates an Iterator instance over a snapshot of the queue's elements in proper sequence (from
+ * first to last element), then stores the iterator into `*iter`. Unlike ts_queue_iterator(), the
+ * lock is released as soon as the snapshot has been taken, so writers are not blocked while the
+ * caller iterates; changes made afterwards are not reflected. The items themselves are shared with
+ * the queue, so they must not be freed while iterating. Caller is responsible for destroying the
+ * iterator instance when finished.
+ *
+ * Params:
+ *    queue - The queue to operate on.
+ *    iter - Address where the new iterator will be stored.
+ * Returns:
+ *    OK - Operation was successful.
+ *    STRUCT_EMPTY - Queue is currently empty.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status ts_queue_snapshot(ConcurrentQueue *queue, ConcurrentIterator **iter);
+
+/**
+ * Returns the number of bytes of memory held by the queue: the queue itself, its lock and the
+ * queue it wraps, not counting the elements themselves.
+ *
+ * Params:
+ *    queue - The queue to operate on.
+ * Returns:
+ *    The queue's memory usage, in bytes.
+ */
+long ts_queue_memoryUsage(ConcurrentQueue *queue);
+
+/**
+ * Fills in `stats` with how contended the queue's lock has been since the queue was created. The
+ * counters remain 0 unless the library is compiled with CDS_LOCK_STATS defined.
+ *
+ * Params:
+ *    queue - The queue to operate on.
+ *    stats - The stats to fill in.
+ * Returns:
+ *    None
+ */
+void ts_queue_lockStats(ConcurrentQueue *queue, LockStats *stats);
+
 /**
  * Destroys the queue instance by freeing all of its reserved memory. If `destructor` is not NULL,
  * it will be invoked on each element before the queue is destroyed.
@@ -26,6 +26,8 @@
 #define _CDS_TS_STACK_H__
 
 #include "cds_common.h"
+#include "node_pool.h"
+#include "ts_lock.h"
 #include "ts_iterator.h"
 
 /**
@@ -50,6 +52,21 @@ typedef struct ts_stack ConcurrentStack;
  */
 Status ts_stack_new(ConcurrentStack **stack);
 
+/**
+ * Creates a new stack instance whose nodes are allocated from `pool`, then stores the new instance
+ * into `*stack`. The pool may be shared with other ADTs and must outlive the stack. A pool shared
+ * by ADTs used from different threads must be created with nodepool_newConcurrent(). If `pool` is
+ * NULL, a private pool is used instead, the same as ts_stack_new().
+ *
+ * Params:
+ *    stack - The pointer address to store the new Stack instance.
+ *    pool - The pool to allocate the nodes from, or NULL.
+ * Returns:
+ *    OK - Stack was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status ts_stack_newWithPool(ConcurrentStack **stack, NodePool *pool);
+
 /**
  * Locks the stack, providing exclusive access to the calling thread. Caller is responsible for
  * unlocking the stack to allow other threads access.
@@ -71,6 +88,30 @@ void ts_stack_lock(ConcurrentStack *stack);
  */
 void ts_stack_unlock(ConcurrentStack *stack);
 
+/**
+ * Locks the stack for reading, providing shared access to the calling thread. If the stack was
+ * created under the LOCK_RWLOCK or LOCK_BIASED policy, other threads may also read from the stack
+ * at the same time; otherwise this is the same as ts_stack_lock(). Caller is responsible for
+ * unlocking the stack, and must not modify it while holding only the read lock.
+ *
+ * Params:
+ *    stack - The stack to operate on.
+ * Returns:
+ *    None
+ */
+void ts_stack_lockRead(ConcurrentStack *stack);
+
+/**
+ * Locks the stack for writing, providing exclusive access to the calling thread. This is the same
+ * as ts_stack_lock(). Caller is responsible for unlocking the stack to allow other threads access.
+ *
+ * Params:
+ *    stack - The stack to operate on.
+ * Returns:
+ *    None
+ */
+void ts_stack_lockWrite(ConcurrentStack *stack);
+
 /**
  * Pushes the specified element onto the stack.
  *
@@ -83,6 +124,22 @@ void ts_stack_unlock(ConcurrentStack *stack);
  */
 Status ts_stack_push(ConcurrentStack *stack, void *item);
 
+/**
+ * Pushes the `n` elements in the array `items` onto the stack, in order, in a single lock
+ * acquisition, leaving `items[n - 1]` on top. Either every element is pushed or, on failure, none
+ * is.
+ *
+ * Params:
+ *    stack - The stack to operate on.
+ *    items - The array of elements to push.
+ *    n - The number of elements in `items`.
+ * Returns:
+ *    OK - Operation was successful.
+ *    INVALID_INDEX - `n` is negative.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status ts_stack_pushAll(ConcurrentStack *stack, void **items, long n);
+
 /**
  * Retrieves, but does not remove, the top element from the stack and stores the result into `*top`.
  *
@@ -107,6 +164,19 @@ Status ts_stack_peek(ConcurrentStack *stack, void **top);
  */
 Status ts_stack_pop(ConcurrentStack *stack, void **top);
 
+/**
+ * Pops up to `max` elements off the stack in a single lock acquisition, storing them in LIFO order
+ * into `items` (the former top first), which must have room for `max` elements.
+ *
+ * Params:
+ *    stack - The stack to operate on.
+ *    items - The array to store the popped elements into.
+ *    max - The maximum number of elements to pop.
+ * Returns:
+ *    The number of elements popped and stored into `items`.
+ */
+long ts_stack_popMany(ConcurrentStack *stack, void **items, long max);
+
 /**
  * Removes all elements from the stack. If `destructor` is not NULL, it will be invoked on each
  * element in the stack after being removed.
@@ -169,6 +239,62 @@ Status ts_stack_toArray(ConcurrentStack *stack, Array **array);
  */
 Status ts_stack_iterator(ConcurrentStack *stack, ConcurrentIterator **iter);
 
+/**
+ * Applies `action` to each element of the stack from top to bottom, passing it the element and
+ * `context`. The walk stops as soon as `action` returns FALSE. The stack stays locked for reading
+ * throughout the walk and nothing is allocated, so `action` must neither modify the stack nor call
+ * back into it.
+ *
+ * Params:
+ *    stack - The stack to operate on.
+ *    action - Function applied to each element, returning FALSE to stop the walk.
+ *    context - Argument passed along to each call of `action`, may be NULL.
+ * Returns:
+ *    TRUE if `action` was applied to every element, FALSE if it stopped the walk early.
+ */
+Boolean ts_stack_forEach(ConcurrentStack *stack, Boolean (*action)(void *, void *), void *context);
+
+/**
+ * Creates an Iterator instance over a snapshot of the stack's elements in proper sequence (from
+ * top to bottom element), then stores the iterator into `*iter`. Unlike ts_stack_iterator(), the
+ * lock is released as soon as the snapshot has been taken, so writers are not blocked while the
+ * caller iterates; changes made afterwards are not reflected. The items themselves are shared with
+ * the stack, so they must not be freed while iterating. Caller is responsible for destroying the
+ * iterator instance when finished.
+ *
+ * Params:
+ *    stack - The stack to operate on.
+ *    iter - Address where the new iterator will be stored.
+ * Returns:
+ *    OK - Operation was successful.
+ *    STRUCT_EMPTY - Stack is currently empty.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status ts_stack_snapshot(ConcurrentStack *stack, ConcurrentIterator **iter);
+
+/**
+ * Returns the number of bytes of memory held by the stack: the stack itself, its lock and the
+ * stack it wraps, not counting the elements themselves.
+ *
+ * Params:
+ *    stack - The stack to operate on.
+ * Returns:
+ *    The stack's memory usage, in bytes.
+ */
+long ts_stack_memoryUsage(ConcurrentStack *stack);
+
+/**
+ * Fills in `stats` with how contended the stack's lock has been since the stack was created. The
+ * counters remain 0 unless the library is compiled with CDS_LOCK_STATS defined.
+ *
+ * Params:
+ *    stack - The stack to operate on.
+ *    stats - The stats to fill in.
+ * Returns:
+ *    None
+ */
+void ts_stack_lockStats(ConcurrentStack *stack, LockStats *stats);
+
 /**
  * Destroys the stack instance by freeing all of its reserved memory. If `destructor` is not NULL,
  * it will be invoked on each element before the stack is destroyed.
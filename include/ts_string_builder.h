@@ -26,6 +26,7 @@
 #define _CDS_TS_STRING_BUILDER_H__
 
 #include "cds_common.h"
+#include "ts_lock.h"
 
 /**
  * Interface for the thread safe StringBuilder ADT.
@@ -70,6 +71,20 @@ typedef struct ts_string_builder ConcurrentStringBuilder;
 Status ts_string_builder_new(ConcurrentStringBuilder **builder, long capacity, float growthFactor,
                              char *str);
 
+/**
+ * Constructs a new string builder instance backed by a rope, then stores the new instance into
+ * `*builder`. The characters are held in chunks of a balanced tree instead of one buffer, so that
+ * inserts, deletions, and replacements anywhere in a large builder run in O(log n) time.
+ *
+ * Params:
+ *    builder - The pointer address to store the new StringBuilder instance.
+ *    str - The initial contents to provide the builder, or NULL for an empty builder.
+ * Returns:
+ *    OK - StringBuilder was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status ts_string_builder_newRope(ConcurrentStringBuilder **builder, char *str);
+
 /**
  * Locks the string builder, providing exclusive access to the calling thread. Caller is responsible
  * for unlocking the string builder to allow other threads access.
@@ -91,6 +106,32 @@ void ts_string_builder_lock(ConcurrentStringBuilder *builder);
  */
 void ts_string_builder_unlock(ConcurrentStringBuilder *builder);
 
+/**
+ * Locks the string builder for reading, providing shared access to the calling thread. If the
+ * string builder was created under the LOCK_RWLOCK or LOCK_BIASED policy, other threads may also
+ * read from the string builder at the same time; otherwise this is the same as
+ * ts_string_builder_lock(). Caller is responsible for unlocking the string builder, and must not
+ * modify it while holding only the read lock.
+ *
+ * Params:
+ *    builder - The string builder to operate on.
+ * Returns:
+ *    None
+ */
+void ts_string_builder_lockRead(ConcurrentStringBuilder *builder);
+
+/**
+ * Locks the string builder for writing, providing exclusive access to the calling thread. This is
+ * the same as ts_string_builder_lock(). Caller is responsible for unlocking the string builder to
+ * allow other threads access.
+ *
+ * Params:
+ *    builder - The string builder to operate on.
+ * Returns:
+ *    None
+ */
+void ts_string_builder_lockWrite(ConcurrentStringBuilder *builder);
+
 /**
  * Appends the character `ch` to the builder.
  *
@@ -117,6 +158,22 @@ Status ts_string_builder_appendChar(ConcurrentStringBuilder *builder, char ch);
  */
 Status ts_string_builder_appendStr(ConcurrentStringBuilder *builder, char *str);
 
+/**
+ * Appends the `len` characters starting at `bytes` to the builder. Unlike appendStr(), the length
+ * is supplied by the caller rather than computed from a null terminator, so callers that already
+ * know the length of their strings avoid scanning them again. The characters are copied as is.
+ *
+ * Params:
+ *    builder - The string builder to operate on.
+ *    bytes - The characters to append.
+ *    len - The number of characters to append.
+ * Returns:
+ *    OK - Operation was successful.
+ *    INVALID_INDEX - `len` < 0.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status ts_string_builder_appendBytes(ConcurrentStringBuilder *builder, const char *bytes, long len);
+
 /**
  * Appends the string representation of the boolean `b` to the builder.
  *
@@ -259,6 +316,46 @@ Status ts_string_builder_appendStrSubSequence(ConcurrentStringBuilder *builder,
 Status ts_string_builder_appendStrBuilder(ConcurrentStringBuilder *builder,
                                           ConcurrentStringBuilder *other);
 
+/**
+ * Appends each of the `count` strings in the array `strs` to the builder, in order, under a single
+ * acquisition of the lock. The builder is grown once up front for the whole batch. As with
+ * ts_string_builder_appendStr(), a NULL string is appended as "null".
+ *
+ * Params:
+ *    builder - The string builder to operate on.
+ *    strs - The array of strings to append.
+ *    count - The number of strings in `strs`.
+ * Returns:
+ *    OK - Operation was successful.
+ *    INVALID_INDEX - `count` < 0.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status ts_string_builder_appendAll(ConcurrentStringBuilder *builder, char **strs, long count);
+
+/**
+ * Appends the `len` characters at `bytes` to the builder, usually without taking the lock. The
+ * builder keeps a window of spare room after its end; each shared append reserves its own range
+ * of the window with an atomic compare-and-swap and copies its characters in, so that any number
+ * of threads may append at once. Only when the window is full (or was closed by another
+ * operation) does the append take the lock, growing the builder and opening a larger window.
+ *
+ * The characters of concurrent shared appends land in the order their ranges were reserved, each
+ * one whole. They are added to the builder by the next other operation on it, which takes the
+ * lock for writing to do so; under LOCK_RWLOCK, a thread that already holds the builder for
+ * reading must therefore not call its other functions while shared appends may be pending.
+ *
+ * Params:
+ *    builder - The string builder to operate on.
+ *    bytes - The characters to append.
+ *    len - The number of characters to append.
+ * Returns:
+ *    OK - Operation was successful.
+ *    INVALID_INDEX - `len` < 0.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status ts_string_builder_appendShared(ConcurrentStringBuilder *builder, const char *bytes,
+                                      long len);
+
 /**
  * Inserts the string representation of the character `ch` into this sequence at the specified index
  * `offset`.
@@ -296,6 +393,27 @@ Status ts_string_builder_insertChar(ConcurrentStringBuilder *builder, long offse
  */
 Status ts_string_builder_insertStr(ConcurrentStringBuilder *builder, long offset, char *str);
 
+/**
+ * Inserts the `len` characters starting at `bytes` into the builder at the index `offset`. Unlike
+ * insertStr(), the length is supplied by the caller rather than computed from a null terminator.
+ * The characters are copied as is.
+ *
+ * Params:
+ *    builder - The string builder to operate on.
+ *    offset - The offset where to perform the insert.
+ *    bytes - The characters to insert.
+ *    len - The number of characters to insert.
+ * Returns:
+ *    OK - Operation was successful.
+ *    INVALID_INDEX - Index was invalid:
+ *       1.) `offset` < 0
+ *       2.) `offset` > length()
+ *       3.) `len` < 0
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status ts_string_builder_insertBytes(ConcurrentStringBuilder *builder, long offset,
+                                     const char *bytes, long len);
+
 /**
  * Inserts the string representation of the boolean `b` into this sequence at the specified index
  * `offset`.
@@ -807,6 +925,89 @@ long ts_string_builder_capacity(ConcurrentStringBuilder *builder);
  */
 Status ts_string_builder_toString(ConcurrentStringBuilder *builder, char **result);
 
+/**
+ * Appends up to `max` characters read from the file descriptor `fd` to the builder, or all of them
+ * until the end of the input if `max` is < 0. The characters are read straight into the builder's
+ * buffer; if `fd` refers to a regular file, the room for the rest of the file is reserved once up
+ * front. The builder stays locked for the whole read.
+ *
+ * Params:
+ *    builder - The string builder to operate on.
+ *    fd - The file descriptor to read from.
+ *    max - The maximum number of characters to read, or < 0 to read until the end.
+ * Returns:
+ *    OK - Operation was successful.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ *    IO_FAILURE - A read from `fd` failed; the characters read before the failure are kept.
+ */
+Status ts_string_builder_appendFromFd(ConcurrentStringBuilder *builder, int fd, long max);
+
+/**
+ * Appends the complete contents of the file at `path` to the builder, as with
+ * ts_string_builder_appendFromFd().
+ *
+ * Params:
+ *    builder - The string builder to operate on.
+ *    path - The path of the file to read.
+ * Returns:
+ *    OK - Operation was successful.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ *    IO_FAILURE - The file could not be opened or read.
+ */
+Status ts_string_builder_appendFile(ConcurrentStringBuilder *builder, const char *path);
+
+/**
+ * Writes the builder's characters out to the file descriptor `fd` without copying them, retrying
+ * after partial writes until all of them are written. Other readers may use the builder during
+ * the write, but writers must wait for it to finish.
+ *
+ * Params:
+ *    builder - The string builder to operate on.
+ *    fd - The file descriptor to write to.
+ * Returns:
+ *    OK - Operation was successful.
+ *    IO_FAILURE - A write to `fd` failed.
+ */
+Status ts_string_builder_writeTo(ConcurrentStringBuilder *builder, int fd);
+
+/**
+ * Hands the string builder's buffer over to the caller without copying it, storing it into
+ * `*result`, and resets the builder to the empty string with a default capacity. The string is
+ * null-terminated, and is the caller's responsibility to free() when no longer needed. A
+ * rope-backed builder's chunks are joined into a newly allocated string instead, and freed.
+ *
+ * Params:
+ *    builder - The string builder to operate on.
+ *    result - The pointer address to store the builder's string into.
+ * Returns:
+ *    OK - Operation was successful.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap; the builder is unchanged.
+ */
+Status ts_string_builder_detach(ConcurrentStringBuilder *builder, char **result);
+
+/**
+ * Returns the number of bytes of memory held by the string builder: the string builder itself,
+ * its lock and the string builder it wraps, not counting the elements themselves.
+ *
+ * Params:
+ *    builder - The string builder to operate on.
+ * Returns:
+ *    The string builder's memory usage, in bytes.
+ */
+long ts_string_builder_memoryUsage(ConcurrentStringBuilder *builder);
+
+/**
+ * Fills in `stats` with how contended the string builder's lock has been since the string builder
+ * was created. The counters remain 0 unless the library is compiled with CDS_LOCK_STATS defined.
+ *
+ * Params:
+ *    builder - The string builder to operate on.
+ *    stats - The stats to fill in.
+ * Returns:
+ *    None
+ */
+void ts_string_builder_lockStats(ConcurrentStringBuilder *builder, LockStats *stats);
+
 /**
  * Destroys the string builder instance by freeing all of its reserved memory.
  *
@@ -0,0 +1,209 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2020 Cole Vikupitz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef _CDS_TS_TIMER_WHEEL_H__
+#define _CDS_TS_TIMER_WHEEL_H__
+
+#include <stdint.h>
+#include "cds_common.h"
+#include "timer_wheel.h"
+#include "ts_lock.h"
+
+/**
+ * Declaration for the thread-safe TimerWheel ADT.
+ *
+ * Every operation locks the whole wheel, as advancing the clock touches timers of every level.
+ * Timers expired by ts_timerwheel_advance() are taken out of the wheel under the lock, but their
+ * callbacks run after it has been released, so the callbacks may schedule and cancel timers, and
+ * other threads may keep using the wheel while they run. Since a handle to a timer that has fired
+ * or been cancelled is reported as stale, threads racing to cancel a timer against its expiry see
+ * exactly one of them succeed.
+ */
+typedef struct ts_timer_wheel ConcurrentTimerWheel;
+
+/**
+ * Constructs a new, empty timer wheel whose clock starts at `now`, then stores the new instance
+ * into `*wheel`.
+ *
+ * Params:
+ *    wheel - The pointer address to store the new ConcurrentTimerWheel instance.
+ *    now - The current time, in ticks.
+ * Returns:
+ *    OK - ConcurrentTimerWheel was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status ts_timerwheel_new(ConcurrentTimerWheel **wheel, uint64_t now);
+
+/**
+ * Schedules `item` to expire at the specified deadline. See timerwheel_schedule().
+ *
+ * Params:
+ *    wheel - The timer wheel to operate on.
+ *    deadline - The time the item expires at, in ticks.
+ *    item - The item to expire.
+ *    handle - The pointer address to store the new timer's handle into, may be NULL if the timer
+ *             will never be cancelled.
+ * Returns:
+ *    OK - Operation was successful.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status ts_timerwheel_schedule(ConcurrentTimerWheel *wheel, uint64_t deadline, void *item,
+                              TimerHandle *handle);
+
+/**
+ * Moves a pending timer to a new deadline. See timerwheel_reschedule().
+ *
+ * Params:
+ *    wheel - The timer wheel to operate on.
+ *    handle - The handle of the timer to move.
+ *    deadline - The new time the timer expires at, in ticks.
+ * Returns:
+ *    OK - Operation was successful.
+ *    NOT_FOUND - The timer has already fired or been cancelled.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap; the timer keeps its previous
+ *                    deadline.
+ */
+Status ts_timerwheel_reschedule(ConcurrentTimerWheel *wheel, TimerHandle handle,
+                                uint64_t deadline);
+
+/**
+ * Cancels a pending timer, and stores its item into `*item`. See timerwheel_cancel().
+ *
+ * Params:
+ *    wheel - The timer wheel to operate on.
+ *    handle - The handle of the timer to cancel.
+ *    item - The pointer address to store the cancelled timer's item into.
+ * Returns:
+ *    OK - Operation was successful.
+ *    NOT_FOUND - The timer has already fired or been cancelled.
+ */
+Status ts_timerwheel_cancel(ConcurrentTimerWheel *wheel, TimerHandle handle, void **item);
+
+/**
+ * Advances the wheel's clock to `now`, expiring every timer whose deadline is no later than `now`.
+ * The expired timers are removed from the wheel while it is locked, then `expire` is invoked with
+ * each one's item, deadline and `context` once the lock is released. See timerwheel_advance().
+ *
+ * Params:
+ *    wheel - The timer wheel to operate on.
+ *    now - The current time, in ticks.
+ *    expire - Function invoked on each expired timer, may be NULL.
+ *    context - Argument passed along to `expire`.
+ * Returns:
+ *    The number of timers expired.
+ */
+long ts_timerwheel_advance(ConcurrentTimerWheel *wheel, uint64_t now,
+                           void (*expire)(void *, uint64_t, void *), void *context);
+
+/**
+ * Retrieves the earliest deadline among the pending timers. See timerwheel_nextDeadline().
+ *
+ * Params:
+ *    wheel - The timer wheel to operate on.
+ *    deadline - The pointer address to store the earliest deadline into.
+ * Returns:
+ *    OK - Operation was successful.
+ *    STRUCT_EMPTY - No timers are pending.
+ */
+Status ts_timerwheel_nextDeadline(ConcurrentTimerWheel *wheel, uint64_t *deadline);
+
+/**
+ * Returns the wheel's current time, as last set by ts_timerwheel_new() or ts_timerwheel_advance().
+ *
+ * Params:
+ *    wheel - The timer wheel to operate on.
+ * Returns:
+ *    The current time, in ticks.
+ */
+uint64_t ts_timerwheel_now(ConcurrentTimerWheel *wheel);
+
+/**
+ * Returns the number of pending timers in the timer wheel.
+ *
+ * Params:
+ *    wheel - The timer wheel to operate on.
+ * Returns:
+ *    The number of pending timers.
+ */
+long ts_timerwheel_size(ConcurrentTimerWheel *wheel);
+
+/**
+ * Returns TRUE if the timer wheel has no pending timers, FALSE if otherwise.
+ *
+ * Params:
+ *    wheel - The timer wheel to operate on.
+ * Returns:
+ *    TRUE if the timer wheel is empty, FALSE if not.
+ */
+Boolean ts_timerwheel_isEmpty(ConcurrentTimerWheel *wheel);
+
+/**
+ * Cancels every pending timer, making all handles stale. If `destructor` is not NULL, it will be
+ * invoked on each cancelled timer's item.
+ *
+ * Params:
+ *    wheel - The timer wheel to operate on.
+ *    destructor - Function to operate on each item after its timer is cancelled.
+ * Returns:
+ *    None
+ */
+void ts_timerwheel_clear(ConcurrentTimerWheel *wheel, void (*destructor)(void *));
+
+/**
+ * Returns the total number of bytes of heap memory held by the timer wheel. See
+ * timerwheel_memoryUsage().
+ *
+ * Params:
+ *    wheel - The timer wheel to operate on.
+ * Returns:
+ *    The timer wheel's memory usage, in bytes.
+ */
+long ts_timerwheel_memoryUsage(ConcurrentTimerWheel *wheel);
+
+/**
+ * Fills in `stats` with how contended the wheel's lock has been since the wheel was created. The
+ * counters remain 0 unless the library is compiled with CDS_LOCK_STATS defined.
+ *
+ * Params:
+ *    wheel - The timer wheel to operate on.
+ *    stats - The stats to fill in.
+ * Returns:
+ *    None
+ */
+void ts_timerwheel_lockStats(ConcurrentTimerWheel *wheel, LockStats *stats);
+
+/**
+ * Destroys the timer wheel instance by freeing all of its reserved memory. If `destructor` is not
+ * NULL, it will be invoked on the item of each pending timer.
+ *
+ * Params:
+ *    wheel - The timer wheel to destroy.
+ *    destructor - Function to operate on each item of the pending timers.
+ * Returns:
+ *    None
+ */
+void ts_timerwheel_destroy(ConcurrentTimerWheel *wheel, void (*destructor)(void *));
+
+#endif  /* _CDS_TS_TIMER_WHEEL_H__ */
@@ -26,6 +26,7 @@
 #define _CDS_TS_TREEMAP_H__
 
 #include "cds_common.h"
+#include "ts_lock.h"
 #include "tree_map.h"
 #include "ts_iterator.h"
 
@@ -36,6 +37,10 @@
  * stored keys based on their natural ordering defined through a comparator provided at construction
  * time. Provides self-balancing capabilities for even distribution.
  *
+ * Lookups only lock the treemap for reading. A treemap that is read far more often than it is
+ * modified is best created under the LOCK_BIASED policy (see ts_lock.h), so that lookups from
+ * many threads don't contend on the lock.
+ *
  * Modeled after the Java 7 TreeMap interface.
  */
 typedef struct ts_treemap ConcurrentTreeMap;
@@ -62,6 +67,40 @@ typedef struct ts_treemap ConcurrentTreeMap;
 Status ts_treemap_new(ConcurrentTreeMap **tree, int (*keyComparator)(void *, void *),
                       void (*keyDestructor)(void *));
 
+/**
+ * Creates a new treemap instance whose nodes are allocated from `pool`, then stores the new instance
+ * into `*tree`. The pool may be shared with other ADTs and must outlive the treemap. A pool shared by ADTs used
+ * from different threads must be created with nodepool_newConcurrent(). If
+ * `pool` is NULL, a private pool is used instead, the same as ts_treemap_new().
+ *
+ * Params:
+ *    tree - The pointer address to store the new TreeMap instance.
+ *    keyComparator - Function for comparing two keys in the treemap.
+ *    keyDestructor - Function for de-allocating the treemap's keys.
+ *    pool - The pool to allocate the nodes from, or NULL.
+ * Returns:
+ *    OK - TreeMap was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status ts_treemap_newWithPool(ConcurrentTreeMap **tree, int (*keyComparator)(void *, void *),
+                              void (*keyDestructor)(void *), NodePool *pool);
+
+/**
+ * Creates a new treemap instance backed by a B+-tree, then stores the new instance into `*tree`.
+ * See treemap_newBTree() for how it differs from the red-black tree; entry handles are only valid
+ * until the next insertion or removal, so use ts_treemap_snapshot() to walk it while others write.
+ *
+ * Params:
+ *    tree - The pointer address to store the new TreeMap instance.
+ *    keyComparator - Function for comparing two keys in the treemap.
+ *    keyDestructor - Function for de-allocating the treemap's keys.
+ * Returns:
+ *    OK - TreeMap was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status ts_treemap_newBTree(ConcurrentTreeMap **tree, int (*keyComparator)(void *, void *),
+                           void (*keyDestructor)(void *));
+
 /**
  * Locks the treemap, providing exclusive access to the calling thread. Caller is responsible for
  * unlocking the treemap to allow other threads access.
@@ -83,6 +122,31 @@ void ts_treemap_lock(ConcurrentTreeMap *tree);
  */
 void ts_treemap_unlock(ConcurrentTreeMap *tree);
 
+/**
+ * Locks the treemap for reading, providing shared access to the calling thread. If the treemap was
+ * created under the LOCK_RWLOCK or LOCK_BIASED policy, other threads may also read from the treemap
+ * at the same time; otherwise this is the same as ts_treemap_lock(). Caller is responsible for
+ * unlocking the treemap, and must not modify it while holding only the read lock.
+ *
+ * Params:
+ *    tree - The treemap to operate on.
+ * Returns:
+ *    None
+ */
+void ts_treemap_lockRead(ConcurrentTreeMap *tree);
+
+/**
+ * Locks the treemap for writing, providing exclusive access to the calling thread. This is the same
+ * as ts_treemap_lock(). Caller is responsible for unlocking the treemap to allow other threads
+ * access.
+ *
+ * Params:
+ *    tree - The treemap to operate on.
+ * Returns:
+ *    None
+ */
+void ts_treemap_lockWrite(ConcurrentTreeMap *tree);
+
 /**
  * Associates the specified value with the specified key in the treemap. If the treemap previously
  * contained a mapping for the key, the old value is replaced, and stored into `*previous`.
@@ -337,6 +401,56 @@ Status ts_treemap_pollLast(ConcurrentTreeMap *tree, void **lastKey, void **lastV
  */
 Status ts_treemap_remove(ConcurrentTreeMap *tree, void *key, void **value);
 
+/**
+ * Associates each of the `n` keys in `keys` with the value at the same index in `values`, as if by
+ * calling treemap_put() on each pair in order, while holding the lock only once. If `previous` is
+ * not NULL, the value replaced by the i-th pair is stored into `previous[i]` (or NULL if its key
+ * was newly inserted).
+ *
+ * Params:
+ *    tree - The treemap to operate on.
+ *    keys - The array of keys to insert.
+ *    values - The array of values to associate with the keys.
+ *    n - The number of key-value pairs.
+ *    previous - Array of `n` slots to store the replaced values into, or NULL.
+ * Returns:
+ *    OK - Operation was successful.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap; the pairs before the one that
+ *                    failed were inserted.
+ */
+Status ts_treemap_putAll(ConcurrentTreeMap *tree, void **keys, void **values, long n,
+                         void **previous);
+
+/**
+ * Fetches the values to which each of the `n` keys in `keys` are mapped while holding the read
+ * lock only once, and stores them into `values` at the same indices (or NULL if the key is not
+ * present).
+ *
+ * Params:
+ *    tree - The treemap to operate on.
+ *    keys - The array of keys to look up.
+ *    values - Array of `n` slots to store the fetched values into.
+ *    n - The number of keys.
+ * Returns:
+ *    The number of keys that were found in the treemap.
+ */
+long ts_treemap_getAll(ConcurrentTreeMap *tree, void **keys, void **values, long n);
+
+/**
+ * Removes the mappings for each of the `n` keys in `keys` from the treemap if present, while
+ * holding the lock only once. If `values` is not NULL, the value removed for the i-th key is stored
+ * into `values[i]` (or NULL if the key was not present).
+ *
+ * Params:
+ *    tree - The treemap to operate on.
+ *    keys - The array of keys whose mappings are to be removed.
+ *    values - Array of `n` slots to store the removed values into, or NULL.
+ *    n - The number of keys.
+ * Returns:
+ *    The number of mappings that were removed.
+ */
+long ts_treemap_removeAll(ConcurrentTreeMap *tree, void **keys, void **values, long n);
+
 /**
  * Removes all elements from the treemap. If `valueDestructor` is not NULL, it will be invoked on
  * each element in the treemap after being removed.
@@ -416,6 +530,98 @@ Status ts_treemap_entryArray(ConcurrentTreeMap *tree, Array **entries);
  */
 Status ts_treemap_iterator(ConcurrentTreeMap *tree, ConcurrentIterator **iter);
 
+/**
+ * Applies `action` to each entry of the treemap in ascending order of their keys, passing it the
+ * entry's key, its value and `context`. The walk stops as soon as `action` returns FALSE. The
+ * treemap stays locked for reading throughout the walk and nothing is allocated, so `action` must
+ * neither modify the treemap nor call back into it.
+ *
+ * Params:
+ *    tree - The treemap to operate on.
+ *    action - Function applied to each entry, returning FALSE to stop the walk.
+ *    context - Argument passed along to each call of `action`, may be NULL.
+ * Returns:
+ *    TRUE if `action` was applied to every entry, FALSE if it stopped the walk early.
+ */
+Boolean ts_treemap_forEach(ConcurrentTreeMap *tree, Boolean (*action)(void *, void *, void *),
+                           void *context);
+
+/**
+ * Applies `action` to each entry of the treemap using up to `nthreads` threads, as with
+ * treemap_parallelForEach(). The treemap stays locked for reading throughout the walk, so `action`
+ * must neither modify the treemap nor call back into it.
+ *
+ * Params:
+ *    tree - The treemap to operate on.
+ *    nthreads - The most threads to walk with, including the calling thread.
+ *    action - Function applied to each entry, returning FALSE to stop the walk.
+ *    context - Argument passed along to each call of `action`, may be NULL.
+ * Returns:
+ *    TRUE if `action` was applied to every entry, FALSE if it stopped the walk early.
+ */
+Boolean ts_treemap_parallelForEach(ConcurrentTreeMap *tree, int nthreads,
+                                   Boolean (*action)(void *, void *, void *), void *context);
+
+/**
+ * Reduces the entries of the treemap to a single result using up to `nthreads` threads, as with
+ * treemap_parallelReduce(). The treemap stays locked for reading throughout, so neither `reducer`
+ * nor `combiner` may modify the treemap or call back into it.
+ *
+ * Params:
+ *    tree - The treemap to operate on.
+ *    nthreads - The most threads to reduce with, including the calling thread.
+ *    reducer - Function folding an entry into a run's result.
+ *    combiner - Function merging two runs' results.
+ *    context - Argument passed along to each call of `reducer` and `combiner`, may be NULL.
+ * Returns:
+ *    The reduced result, or NULL if the treemap is empty.
+ */
+void *ts_treemap_parallelReduce(ConcurrentTreeMap *tree, int nthreads,
+                                void *(*reducer)(void *, void *, void *, void *),
+                                void *(*combiner)(void *, void *, void *), void *context);
+
+/**
+ * Creates an Iterator instance over a snapshot of the treemap's elements in proper sequence
+ * (defined by the key's comparator, from least to greatest), then stores the iterator into
+ * `*iter`. Unlike ts_treemap_iterator(), the lock is released as soon as the snapshot has been
+ * taken, so writers are not blocked while the caller iterates; changes made afterwards are not
+ * reflected. Note that the items being iterated over are `TmEntry*` copies, which stay valid after
+ * the treemap is modified. Caller is responsible for destroying the iterator instance when
+ * finished.
+ *
+ * Params:
+ *    tree - The treemap to operate on.
+ *    iter - Address where the new iterator will be stored.
+ * Returns:
+ *    OK - Operation was successful.
+ *    STRUCT_EMPTY - TreeMap is currently empty.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status ts_treemap_snapshot(ConcurrentTreeMap *tree, ConcurrentIterator **iter);
+
+/**
+ * Returns the number of bytes of memory held by the treemap: the treemap itself, its lock and the
+ * treemap it wraps, not counting the keys and values.
+ *
+ * Params:
+ *    tree - The treemap to operate on.
+ * Returns:
+ *    The treemap's memory usage, in bytes.
+ */
+long ts_treemap_memoryUsage(ConcurrentTreeMap *tree);
+
+/**
+ * Fills in `stats` with how contended the treemap's lock has been since the treemap was created.
+ * The counters remain 0 unless the library is compiled with CDS_LOCK_STATS defined.
+ *
+ * Params:
+ *    tree - The treemap to operate on.
+ *    stats - The stats to fill in.
+ * Returns:
+ *    None
+ */
+void ts_treemap_lockStats(ConcurrentTreeMap *tree, LockStats *stats);
+
 /**
  * Destroys the treemap instance by freeing all of its reserved memory. If `valueDestructor` is not
  * NULL, it will be invoked on each entry's value before the treemap is destroyed.
@@ -26,6 +26,7 @@
 #define _CDS_TS_TREESET_H__
 
 #include "cds_common.h"
+#include "ts_lock.h"
 #include "ts_iterator.h"
 
 /**
@@ -54,6 +55,23 @@ typedef struct ts_treeset ConcurrentTreeSet;
  */
 Status ts_treeset_new(ConcurrentTreeSet **tree, int (*comparator)(void *, void *));
 
+/**
+ * Creates a new treeset instance whose nodes are allocated from `pool`, then stores the new instance
+ * into `*tree`. The pool may be shared with other ADTs and must outlive the treeset. A pool shared by ADTs used
+ * from different threads must be created with nodepool_newConcurrent(). If
+ * `pool` is NULL, a private pool is used instead, the same as ts_treeset_new().
+ *
+ * Params:
+ *    tree - The pointer address to store the new TreeSet instance.
+ *    comparator - Function for comparing two items in the treeset.
+ *    pool - The pool to allocate the nodes from, or NULL.
+ * Returns:
+ *    OK - TreeSet was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status ts_treeset_newWithPool(ConcurrentTreeSet **tree, int (*comparator)(void *, void *),
+                              NodePool *pool);
+
 /**
  * Locks the treeset, providing exclusive access to the calling thread. Caller is responsible for
  * unlocking the treeset to allow other threads access.
@@ -75,6 +93,31 @@ void ts_treeset_lock(ConcurrentTreeSet *tree);
  */
 void ts_treeset_unlock(ConcurrentTreeSet *tree);
 
+/**
+ * Locks the treeset for reading, providing shared access to the calling thread. If the treeset was
+ * created under the LOCK_RWLOCK or LOCK_BIASED policy, other threads may also read from the treeset
+ * at the same time; otherwise this is the same as ts_treeset_lock(). Caller is responsible for
+ * unlocking the treeset, and must not modify it while holding only the read lock.
+ *
+ * Params:
+ *    tree - The tree to operate on.
+ * Returns:
+ *    None
+ */
+void ts_treeset_lockRead(ConcurrentTreeSet *tree);
+
+/**
+ * Locks the treeset for writing, providing exclusive access to the calling thread. This is the same
+ * as ts_treeset_lock(). Caller is responsible for unlocking the treeset to allow other threads
+ * access.
+ *
+ * Params:
+ *    tree - The tree to operate on.
+ * Returns:
+ *    None
+ */
+void ts_treeset_lockWrite(ConcurrentTreeSet *tree);
+
 /**
  * Adds the specified element to the treeset if it is not already present.
  *
@@ -225,6 +268,36 @@ Status ts_treeset_pollLast(ConcurrentTreeSet *tree, void **last);
  */
 Status ts_treeset_remove(ConcurrentTreeSet *tree, void *item, void (*destructor)(void *));
 
+/**
+ * Adds each of the `n` elements in `items` into the treeset, as if by calling treeset_add() on each
+ * of them in order while holding the lock only once; elements already present are skipped.
+ *
+ * Params:
+ *    tree - The treeset to operate on.
+ *    items - The array of elements to add.
+ *    n - The number of elements.
+ * Returns:
+ *    OK - Operation was successful.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap; the elements before the one
+ *                    that failed were added.
+ */
+Status ts_treeset_addAll(ConcurrentTreeSet *tree, void **items, long n);
+
+/**
+ * Removes each of the `n` elements in `items` from the treeset if present, while holding the lock
+ * only once. If `destructor` is not NULL, it will be invoked on each element removed.
+ *
+ * Params:
+ *    tree - The treeset to operate on.
+ *    items - The array of elements to remove.
+ *    n - The number of elements.
+ *    destructor - Function to operate on each element after removal.
+ * Returns:
+ *    The number of elements that were removed.
+ */
+long ts_treeset_removeAll(ConcurrentTreeSet *tree, void **items, long n,
+                          void (*destructor)(void *));
+
 /**
  * Removes all elements from the treeset. If `destructor` is not NULL, it will be invoked on each
  * element in the treeset after being removed.
@@ -287,6 +360,63 @@ Status ts_treeset_toArray(ConcurrentTreeSet *tree, Array **array);
  */
 Status ts_treeset_iterator(ConcurrentTreeSet *tree, ConcurrentIterator **iter);
 
+/**
+ * Applies `action` to each element of the treeset in ascending order, passing it the element and
+ * `context`. The walk stops as soon as `action` returns FALSE. The treeset stays locked for reading
+ * throughout the walk and nothing is allocated, so `action` must neither modify the treeset nor
+ * call back into it.
+ *
+ * Params:
+ *    tree - The treeset to operate on.
+ *    action - Function applied to each element, returning FALSE to stop the walk.
+ *    context - Argument passed along to each call of `action`, may be NULL.
+ * Returns:
+ *    TRUE if `action` was applied to every element, FALSE if it stopped the walk early.
+ */
+Boolean ts_treeset_forEach(ConcurrentTreeSet *tree, Boolean (*action)(void *, void *),
+                           void *context);
+
+/**
+ * Creates an Iterator instance over a snapshot of the treeset's elements in proper sequence
+ * (defined by the comparator, from least to greatest), then stores the iterator into `*iter`.
+ * Unlike ts_treeset_iterator(), the lock is released as soon as the snapshot has been taken, so
+ * writers are not blocked while the caller iterates; changes made afterwards are not reflected.
+ * The items themselves are shared with the treeset, so they must not be freed while iterating.
+ * Caller is responsible for destroying the iterator instance when finished.
+ *
+ * Params:
+ *    tree - The treeset to operate on.
+ *    iter - Address where the new iterator will be stored.
+ * Returns:
+ *    OK - Operation was successful.
+ *    STRUCT_EMPTY - TreeSet is currently empty.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status ts_treeset_snapshot(ConcurrentTreeSet *tree, ConcurrentIterator **iter);
+
+/**
+ * Returns the number of bytes of memory held by the treeset: the treeset itself, its lock and the
+ * treeset it wraps, not counting the elements themselves.
+ *
+ * Params:
+ *    tree - The treeset to operate on.
+ * Returns:
+ *    The treeset's memory usage, in bytes.
+ */
+long ts_treeset_memoryUsage(ConcurrentTreeSet *tree);
+
+/**
+ * Fills in `stats` with how contended the treeset's lock has been since the treeset was created.
+ * The counters remain 0 unless the library is compiled with CDS_LOCK_STATS defined.
+ *
+ * Params:
+ *    tree - The treeset to operate on.
+ *    stats - The stats to fill in.
+ * Returns:
+ *    None
+ */
+void ts_treeset_lockStats(ConcurrentTreeSet *tree, LockStats *stats);
+
 /**
  * Destroys the treeset instance by freeing all of its reserved memory. If `destructor` is not NULL,
  * it will be invoked on each element before the treeset is destroyed.
@@ -0,0 +1,174 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2020 Cole Vikupitz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef _CDS_TYPED_ARRAY_LIST_H__
+#define _CDS_TYPED_ARRAY_LIST_H__
+
+#include <stdlib.h>
+#include <string.h>
+#include "cds_common.h"
+
+/**
+ * Generator for typed ArrayList ADTs.
+ *
+ * ArrayList stores every element as a `void *`, so a list of integers or small structs has to box
+ * each element and chase a pointer to read it back. CDS_DEFINE_ARRAYLIST(name, T) instead expands
+ * into a list type `name` that stores its elements of type `T` by value in one contiguous array,
+ * along with a family of `static inline` functions operating on it. Being defined entirely in the
+ * header, every call can be inlined by the compiler at the call site.
+ *
+ * The macro must be expanded at most once per name within a translation unit, at file scope. The
+ * generated functions mirror their ArrayList counterparts:
+ *
+ *    Status name_new(name **list, long capacity);
+ *    Status name_add(name *list, T item);
+ *    Status name_insert(name *list, long i, T item);
+ *    Status name_get(name *list, long i, T *item);
+ *    Status name_set(name *list, long i, T item, T *previous);
+ *    Status name_remove(name *list, long i, T *item);
+ *    T *name_array(name *list);
+ *    long name_size(name *list);
+ *    Boolean name_isEmpty(name *list);
+ *    void name_clear(name *list);
+ *    long name_memoryUsage(name *list);
+ *    void name_destroy(name *list);
+ *
+ * Each returns the same statuses as the matching arraylist_*() function. name_array() returns the
+ * backing array itself, which stays valid until the list is next modified. The `previous` and
+ * `item` parameters of set() and remove() may be NULL if the old element is not wanted.
+ */
+#define CDS_DEFINE_ARRAYLIST(name, T)                                                              \
+                                                                                                   \
+typedef struct name {                                                                              \
+    T *data;                                                                                       \
+    long size;                                                                                     \
+    long capacity;                                                                                 \
+} name;                                                                                            \
+                                                                                                   \
+static inline Status name##_new(name **list, long capacity) {                                      \
+    name *temp = (name *)malloc(sizeof(name));                                                     \
+    if (temp == NULL)                                                                              \
+        return ALLOC_FAILURE;                                                                      \
+    if (capacity <= 0)                                                                             \
+        capacity = 16L;                                                                            \
+    temp->data = (T *)malloc(sizeof(T) * capacity);                                                \
+    if (temp->data == NULL) {                                                                      \
+        free(temp);                                                                                \
+        return ALLOC_FAILURE;                                                                      \
+    }                                                                                              \
+    temp->size = 0L;                                                                               \
+    temp->capacity = capacity;                                                                     \
+    *list = temp;                                                                                  \
+    return OK;                                                                                     \
+}                                                                                                  \
+                                                                                                   \
+static inline Status name##__grow(name *list) {                                                    \
+    if (list->size == list->capacity) {                                                            \
+        long cap = list->capacity * 2;                                                             \
+        T *data = (T *)realloc(list->data, sizeof(T) * cap);                                       \
+        if (data == NULL)                                                                          \
+            return ALLOC_FAILURE;                                                                  \
+        list->data = data;                                                                         \
+        list->capacity = cap;                                                                      \
+    }                                                                                              \
+    return OK;                                                                                     \
+}                                                                                                  \
+                                                                                                   \
+static inline Status name##_add(name *list, T item) {                                              \
+    if (list->size == list->capacity && name##__grow(list) != OK)                                  \
+        return ALLOC_FAILURE;                                                                      \
+    list->data[list->size++] = item;                                                               \
+    return OK;                                                                                     \
+}                                                                                                  \
+                                                                                                   \
+static inline Status name##_insert(name *list, long i, T item) {                                   \
+    if (i < 0L || i > list->size)                                                                  \
+        return INVALID_INDEX;                                                                      \
+    if (list->size == list->capacity && name##__grow(list) != OK)                                  \
+        return ALLOC_FAILURE;                                                                      \
+    memmove(list->data + i + 1, list->data + i, sizeof(T) * (list->size - i));                     \
+    list->data[i] = item;                                                                          \
+    list->size++;                                                                                  \
+    return OK;                                                                                     \
+}                                                                                                  \
+                                                                                                   \
+static inline Status name##_get(name *list, long i, T *item) {                                     \
+    if (list->size == 0L)                                                                          \
+        return STRUCT_EMPTY;                                                                       \
+    if (i < 0L || i >= list->size)                                                                 \
+        return INVALID_INDEX;                                                                      \
+    *item = list->data[i];                                                                         \
+    return OK;                                                                                     \
+}                                                                                                  \
+                                                                                                   \
+static inline Status name##_set(name *list, long i, T item, T *previous) {                         \
+    if (list->size == 0L)                                                                          \
+        return STRUCT_EMPTY;                                                                       \
+    if (i < 0L || i >= list->size)                                                                 \
+        return INVALID_INDEX;                                                                      \
+    if (previous != NULL)                                                                          \
+        *previous = list->data[i];                                                                 \
+    list->data[i] = item;                                                                          \
+    return OK;                                                                                     \
+}                                                                                                  \
+                                                                                                   \
+static inline Status name##_remove(name *list, long i, T *item) {                                  \
+    if (list->size == 0L)                                                                          \
+        return STRUCT_EMPTY;                                                                       \
+    if (i < 0L || i >= list->size)                                                                 \
+        return INVALID_INDEX;                                                                      \
+    if (item != NULL)                                                                              \
+        *item = list->data[i];                                                                     \
+    list->size--;                                                                                  \
+    memmove(list->data + i, list->data + i + 1, sizeof(T) * (list->size - i));                     \
+    return OK;                                                                                     \
+}                                                                                                  \
+                                                                                                   \
+static inline T *name##_array(name *list) {                                                        \
+    return list->data;                                                                             \
+}                                                                                                  \
+                                                                                                   \
+static inline long name##_size(name *list) {                                                       \
+    return list->size;                                                                             \
+}                                                                                                  \
+                                                                                                   \
+static inline Boolean name##_isEmpty(name *list) {                                                 \
+    return ( list->size == 0L ) ? TRUE : FALSE;                                                    \
+}                                                                                                  \
+                                                                                                   \
+static inline void name##_clear(name *list) {                                                      \
+    list->size = 0L;                                                                               \
+}                                                                                                  \
+                                                                                                   \
+static inline long name##_memoryUsage(name *list) {                                                \
+    return (long)(sizeof(name) + sizeof(T) * list->capacity);                                      \
+}                                                                                                  \
+                                                                                                   \
+static inline void name##_destroy(name *list) {                                                    \
+    free(list->data);                                                                              \
+    free(list);                                                                                    \
+}
+
+#endif  /* _CDS_TYPED_ARRAY_LIST_H__ */
@@ -0,0 +1,232 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2020 Cole Vikupitz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef _CDS_TYPED_HASH_MAP_H__
+#define _CDS_TYPED_HASH_MAP_H__
+
+#include <stdint.h>
+#include <stdlib.h>
+#include "cds_common.h"
+
+/**
+ * Generator for typed HashMap ADTs.
+ *
+ * HashMap stores every key and value as a `void *` and reaches its hash and key comparator through
+ * function pointers, so a map from `long` to `long` pays for boxing both, a pointer chase per
+ * probe and two indirect calls per lookup. CDS_DEFINE_HASHMAP(name, K, V, hashfn, eqfn) instead
+ * expands into a map type `name` storing its keys of type `K` and values of type `V` by value,
+ * along with a family of `static inline` functions operating on it. `hashfn` and `eqfn` are called
+ * directly as `hashfn(key)` and `eqfn(a, b)` on values of type `K`, so they may be static inline
+ * functions or macros. `hashfn` returns an integer hash code of the key, which is further mixed by
+ * the map, so a plain identity hash works well for integer keys. `eqfn` returns nonzero if the two
+ * keys are equal.
+ *
+ * The entries live in a single open-addressed table probed linearly, where each slot caches the
+ * mixed hash code of its key so that most mismatches are rejected without calling `eqfn`. Removals
+ * shift the following entries of the probe run back instead of leaving tombstones, so lookups
+ * never degrade after heavy churn. The table doubles once it is three quarters full.
+ *
+ * The macro must be expanded at most once per name within a translation unit, at file scope. The
+ * generated functions mirror their HashMap counterparts:
+ *
+ *    Status name_new(name **map, long capacity);
+ *    Status name_put(name *map, K key, V value, V *previous);
+ *    Boolean name_containsKey(name *map, K key);
+ *    Status name_get(name *map, K key, V *value);
+ *    Status name_remove(name *map, K key, V *value);
+ *    Boolean name_forEach(name *map, Boolean (*action)(K, V, void *), void *context);
+ *    long name_size(name *map);
+ *    Boolean name_isEmpty(name *map);
+ *    void name_clear(name *map);
+ *    long name_memoryUsage(name *map);
+ *    void name_destroy(name *map);
+ *
+ * Each returns the same statuses as the matching hashmap_*() function. The `capacity` given to
+ * new() is the number of entries the map can hold before its first resize; if 0 or less, a default
+ * is used. The `previous` and `value` parameters of put() and remove() may be NULL if the old value
+ * is not wanted. forEach() stops early and returns FALSE as soon as the action returns FALSE.
+ */
+#define CDS_DEFINE_HASHMAP(name, K, V, hashfn, eqfn)                                               \
+                                                                                                   \
+typedef struct name##Slot {                                                                        \
+    uint64_t code;                                                                                 \
+    K key;                                                                                         \
+    V value;                                                                                       \
+} name##Slot;                                                                                      \
+                                                                                                   \
+typedef struct name {                                                                              \
+    name##Slot *slots;                                                                             \
+    long size;                                                                                     \
+    long mask;                                                                                     \
+    int shift;                                                                                     \
+} name;                                                                                            \
+                                                                                                   \
+/* Mixes the key's hash; its top bits pick the home slot and its low bit marks the slot in use */  \
+static inline uint64_t name##__code(K key) {                                                       \
+    return ((uint64_t)(hashfn(key)) * 0x9e3779b97f4a7c15UL) | 1UL;                                 \
+}                                                                                                  \
+                                                                                                   \
+static inline Status name##__alloc(name *map, int bits) {                                          \
+    map->slots = (name##Slot *)calloc(1UL << bits, sizeof(name##Slot));                            \
+    if (map->slots == NULL)                                                                        \
+        return ALLOC_FAILURE;                                                                      \
+    map->mask = (1L << bits) - 1;                                                                  \
+    map->shift = 64 - bits;                                                                        \
+    return OK;                                                                                     \
+}                                                                                                  \
+                                                                                                   \
+static inline Status name##_new(name **map, long capacity) {                                       \
+    name *temp = (name *)malloc(sizeof(name));                                                     \
+    int bits = 3;                                                                                  \
+    if (temp == NULL)                                                                              \
+        return ALLOC_FAILURE;                                                                      \
+    if (capacity <= 0L)                                                                            \
+        capacity = 12L;                                                                            \
+    while ((1L << bits) * 3 < capacity * 4)                                                        \
+        bits++;                                                                                    \
+    if (name##__alloc(temp, bits) != OK) {                                                         \
+        free(temp);                                                                                \
+        return ALLOC_FAILURE;                                                                      \
+    }                                                                                              \
+    temp->size = 0L;                                                                               \
+    *map = temp;                                                                                   \
+    return OK;                                                                                     \
+}                                                                                                  \
+                                                                                                   \
+static inline long name##__find(name *map, K key, uint64_t code) {                                 \
+    long i = (long)(code >> map->shift);                                                           \
+    while (map->slots[i].code != 0UL) {                                                            \
+        if (map->slots[i].code == code && eqfn(key, map->slots[i].key))                            \
+            return i;                                                                              \
+        i = (i + 1) & map->mask;                                                                   \
+    }                                                                                              \
+    return ~i;                                                                                     \
+}                                                                                                  \
+                                                                                                   \
+static inline Status name##__grow(name *map) {                                                     \
+    name##Slot *old = map->slots;                                                                  \
+    long i, j, n = map->mask + 1;                                                                  \
+    if (name##__alloc(map, 65 - map->shift) != OK) {                                               \
+        map->slots = old;                                                                          \
+        return ALLOC_FAILURE;                                                                      \
+    }                                                                                              \
+    for (i = 0L; i < n; i++) {                                                                     \
+        if (old[i].code == 0UL)                                                                    \
+            continue;                                                                              \
+        for (j = (long)(old[i].code >> map->shift); map->slots[j].code != 0UL; )                   \
+            j = (j + 1) & map->mask;                                                               \
+        map->slots[j] = old[i];                                                                    \
+    }                                                                                              \
+    free(old);                                                                                     \
+    return OK;                                                                                     \
+}                                                                                                  \
+                                                                                                   \
+static inline Status name##_put(name *map, K key, V value, V *previous) {                          \
+    uint64_t code = name##__code(key);                                                             \
+    long i = name##__find(map, key, code);                                                         \
+    if (i >= 0L) {                                                                                 \
+        if (previous != NULL)                                                                      \
+            *previous = map->slots[i].value;                                                       \
+        map->slots[i].value = value;                                                               \
+        return REPLACED;                                                                           \
+    }                                                                                              \
+    if ((map->size + 1) * 4 > (map->mask + 1) * 3) {                                               \
+        if (name##__grow(map) != OK)                                                               \
+            return ALLOC_FAILURE;                                                                  \
+        i = name##__find(map, key, code);                                                          \
+    }                                                                                              \
+    i = ~i;                                                                                        \
+    map->slots[i].code = code;                                                                     \
+    map->slots[i].key = key;                                                                       \
+    map->slots[i].value = value;                                                                   \
+    map->size++;                                                                                   \
+    return INSERTED;                                                                               \
+}                                                                                                  \
+                                                                                                   \
+static inline Boolean name##_containsKey(name *map, K key) {                                       \
+    return ( name##__find(map, key, name##__code(key)) >= 0L ) ? TRUE : FALSE;                     \
+}                                                                                                  \
+                                                                                                   \
+static inline Status name##_get(name *map, K key, V *value) {                                      \
+    long i = name##__find(map, key, name##__code(key));                                            \
+    if (i < 0L)                                                                                    \
+        return NOT_FOUND;                                                                          \
+    *value = map->slots[i].value;                                                                  \
+    return OK;                                                                                     \
+}                                                                                                  \
+                                                                                                   \
+static inline Status name##_remove(name *map, K key, V *value) {                                   \
+    long i = name##__find(map, key, name##__code(key)), j;                                         \
+    if (i < 0L)                                                                                    \
+        return NOT_FOUND;                                                                          \
+    if (value != NULL)                                                                             \
+        *value = map->slots[i].value;                                                              \
+    /* Pull back every later entry of the run that may legally occupy the emptied slot */          \
+    for (j = (i + 1) & map->mask; map->slots[j].code != 0UL; j = (j + 1) & map->mask) {            \
+        long home = (long)(map->slots[j].code >> map->shift);                                      \
+        if (((j - home) & map->mask) >= ((j - i) & map->mask)) {                                   \
+            map->slots[i] = map->slots[j];                                                         \
+            i = j;                                                                                 \
+        }                                                                                          \
+    }                                                                                              \
+    map->slots[i].code = 0UL;                                                                      \
+    map->size--;                                                                                   \
+    return OK;                                                                                     \
+}                                                                                                  \
+                                                                                                   \
+static inline Boolean name##_forEach(name *map, Boolean (*action)(K, V, void *),                   \
+                                     void *context) {                                              \
+    long i;                                                                                        \
+    for (i = 0L; i <= map->mask; i++)                                                              \
+        if (map->slots[i].code != 0UL && !action(map->slots[i].key, map->slots[i].value, context)) \
+            return FALSE;                                                                          \
+    return TRUE;                                                                                   \
+}                                                                                                  \
+                                                                                                   \
+static inline long name##_size(name *map) {                                                        \
+    return map->size;                                                                              \
+}                                                                                                  \
+                                                                                                   \
+static inline Boolean name##_isEmpty(name *map) {                                                  \
+    return ( map->size == 0L ) ? TRUE : FALSE;                                                     \
+}                                                                                                  \
+                                                                                                   \
+static inline void name##_clear(name *map) {                                                       \
+    long i;                                                                                        \
+    for (i = 0L; i <= map->mask; i++)                                                              \
+        map->slots[i].code = 0UL;                                                                  \
+    map->size = 0L;                                                                                \
+}                                                                                                  \
+                                                                                                   \
+static inline long name##_memoryUsage(name *map) {                                                 \
+    return (long)(sizeof(name) + sizeof(name##Slot) * (map->mask + 1));                            \
+}                                                                                                  \
+                                                                                                   \
+static inline void name##_destroy(name *map) {                                                     \
+    free(map->slots);                                                                              \
+    free(map);                                                                                     \
+}
+
+#endif  /* _CDS_TYPED_HASH_MAP_H__ */
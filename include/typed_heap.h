@@ -0,0 +1,151 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2020 Cole Vikupitz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef _CDS_TYPED_HEAP_H__
+#define _CDS_TYPED_HEAP_H__
+
+#include <stdlib.h>
+#include "cds_common.h"
+
+/**
+ * Generator for typed Heap ADTs.
+ *
+ * Heap stores every element as a `void *` and orders them through a comparator function pointer,
+ * which the compiler cannot inline into the sift loops. CDS_DEFINE_HEAP(name, T, cmpfn) instead
+ * expands into a binary min-heap type `name` storing elements of type `T` by value, along with a
+ * family of `static inline` functions operating on it. `cmpfn` is called directly as
+ * `cmpfn(a, b)` on two values of type `T`, so it may be a static inline function or a macro; it
+ * should return 0 when a == b, <0 when a < b, and >0 when a > b. The head of the heap is the least
+ * element with respect to this ordering.
+ *
+ * The macro must be expanded at most once per name within a translation unit, at file scope. The
+ * generated functions mirror their Heap counterparts:
+ *
+ *    Status name_new(name **heap, long capacity);
+ *    Status name_insert(name *heap, T item);
+ *    Status name_peek(name *heap, T *item);
+ *    Status name_poll(name *heap, T *item);
+ *    long name_size(name *heap);
+ *    Boolean name_isEmpty(name *heap);
+ *    void name_clear(name *heap);
+ *    long name_memoryUsage(name *heap);
+ *    void name_destroy(name *heap);
+ *
+ * Each returns the same statuses as the matching heap_*() function.
+ */
+#define CDS_DEFINE_HEAP(name, T, cmpfn)                                                            \
+                                                                                                   \
+typedef struct name {                                                                              \
+    T *data;                                                                                       \
+    long size;                                                                                     \
+    long capacity;                                                                                 \
+} name;                                                                                            \
+                                                                                                   \
+static inline Status name##_new(name **heap, long capacity) {                                      \
+    name *temp = (name *)malloc(sizeof(name));                                                     \
+    if (temp == NULL)                                                                              \
+        return ALLOC_FAILURE;                                                                      \
+    if (capacity <= 0)                                                                             \
+        capacity = 16L;                                                                            \
+    temp->data = (T *)malloc(sizeof(T) * capacity);                                                \
+    if (temp->data == NULL) {                                                                      \
+        free(temp);                                                                                \
+        return ALLOC_FAILURE;                                                                      \
+    }                                                                                              \
+    temp->size = 0L;                                                                               \
+    temp->capacity = capacity;                                                                     \
+    *heap = temp;                                                                                  \
+    return OK;                                                                                     \
+}                                                                                                  \
+                                                                                                   \
+static inline Status name##_insert(name *heap, T item) {                                           \
+    long i, parent;                                                                                \
+    if (heap->size == heap->capacity) {                                                            \
+        long cap = heap->capacity * 2;                                                             \
+        T *data = (T *)realloc(heap->data, sizeof(T) * cap);                                       \
+        if (data == NULL)                                                                          \
+            return ALLOC_FAILURE;                                                                  \
+        heap->data = data;                                                                         \
+        heap->capacity = cap;                                                                      \
+    }                                                                                              \
+    /* Sift the hole up from the end, then drop the item into it */                                \
+    for (i = heap->size++; i > 0L; i = parent) {                                                   \
+        parent = (i - 1) / 2;                                                                      \
+        if (cmpfn(item, heap->data[parent]) >= 0)                                                  \
+            break;                                                                                 \
+        heap->data[i] = heap->data[parent];                                                        \
+    }                                                                                              \
+    heap->data[i] = item;                                                                          \
+    return OK;                                                                                     \
+}                                                                                                  \
+                                                                                                   \
+static inline Status name##_peek(name *heap, T *item) {                                            \
+    if (heap->size == 0L)                                                                          \
+        return STRUCT_EMPTY;                                                                       \
+    *item = heap->data[0];                                                                         \
+    return OK;                                                                                     \
+}                                                                                                  \
+                                                                                                   \
+static inline Status name##_poll(name *heap, T *item) {                                            \
+    long i, child;                                                                                 \
+    T last;                                                                                        \
+    if (heap->size == 0L)                                                                          \
+        return STRUCT_EMPTY;                                                                       \
+    *item = heap->data[0];                                                                         \
+    last = heap->data[--heap->size];                                                               \
+    /* Sift the hole down from the root, then drop the last item into it */                        \
+    for (i = 0L; (child = 2 * i + 1) < heap->size; i = child) {                                    \
+        if (child + 1 < heap->size && cmpfn(heap->data[child + 1], heap->data[child]) < 0)         \
+            child++;                                                                               \
+        if (cmpfn(last, heap->data[child]) <= 0)                                                   \
+            break;                                                                                 \
+        heap->data[i] = heap->data[child];                                                         \
+    }                                                                                              \
+    heap->data[i] = last;                                                                          \
+    return OK;                                                                                     \
+}                                                                                                  \
+                                                                                                   \
+static inline long name##_size(name *heap) {                                                       \
+    return heap->size;                                                                             \
+}                                                                                                  \
+                                                                                                   \
+static inline Boolean name##_isEmpty(name *heap) {                                                 \
+    return ( heap->size == 0L ) ? TRUE : FALSE;                                                    \
+}                                                                                                  \
+                                                                                                   \
+static inline void name##_clear(name *heap) {                                                      \
+    heap->size = 0L;                                                                               \
+}                                                                                                  \
+                                                                                                   \
+static inline long name##_memoryUsage(name *heap) {                                                \
+    return (long)(sizeof(name) + sizeof(T) * heap->capacity);                                      \
+}                                                                                                  \
+                                                                                                   \
+static inline void name##_destroy(name *heap) {                                                    \
+    free(heap->data);                                                                              \
+    free(heap);                                                                                    \
+}
+
+#endif  /* _CDS_TYPED_HEAP_H__ */
@@ -0,0 +1,346 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2020 Cole Vikupitz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef _CDS_TYPED_TREE_MAP_H__
+#define _CDS_TYPED_TREE_MAP_H__
+
+#include <stdlib.h>
+#include "cds_common.h"
+#include "node_pool.h"
+
+/**
+ * Generator for typed TreeMap ADTs.
+ *
+ * TreeMap stores every key and value as a `void *` and compares keys through a function pointer on
+ * every step of a search. CDS_DEFINE_TREEMAP(name, K, V, cmpfn) instead expands into a sorted map
+ * type `name` storing its keys of type `K` and values of type `V` by value inside the tree nodes,
+ * along with a family of `static inline` functions operating on it. `cmpfn` is called directly as
+ * `cmpfn(a, b)` on two values of type `K`, so it may be a static inline function or a macro; it
+ * should return 0 when a == b, <0 when a < b, and >0 when a > b.
+ *
+ * The tree is an AA tree, a red-black tree variant whose simpler rebalancing fits in a few small
+ * functions. Its nodes are carved out of a private NodePool, so programs using this header must
+ * still link against the library.
+ *
+ * The macro must be expanded at most once per name within a translation unit, at file scope. The
+ * generated functions mirror their TreeMap counterparts:
+ *
+ *    Status name_new(name **tree);
+ *    Status name_put(name *tree, K key, V value, V *previous);
+ *    Boolean name_containsKey(name *tree, K key);
+ *    Status name_get(name *tree, K key, V *value);
+ *    Status name_remove(name *tree, K key, V *value);
+ *    Status name_firstKey(name *tree, K *firstKey);
+ *    Status name_lastKey(name *tree, K *lastKey);
+ *    Status name_floorKey(name *tree, K key, K *floorKey);
+ *    Status name_ceilingKey(name *tree, K key, K *ceilingKey);
+ *    Boolean name_forEach(name *tree, Boolean (*action)(K, V, void *), void *context);
+ *    long name_size(name *tree);
+ *    Boolean name_isEmpty(name *tree);
+ *    void name_clear(name *tree);
+ *    long name_memoryUsage(name *tree);
+ *    void name_destroy(name *tree);
+ *
+ * Each returns the same statuses as the matching treemap_*() function. The `previous` and `value`
+ * parameters of put() and remove() may be NULL if the old value is not wanted. forEach() visits the
+ * entries in ascending key order, and stops early and returns FALSE as soon as the action returns
+ * FALSE.
+ */
+#define CDS_DEFINE_TREEMAP(name, K, V, cmpfn)                                                      \
+                                                                                                   \
+typedef struct name##Node {                                                                        \
+    struct name##Node *left;                                                                       \
+    struct name##Node *right;                                                                      \
+    long level;                                                                                    \
+    K key;                                                                                         \
+    V value;                                                                                       \
+} name##Node;                                                                                      \
+                                                                                                   \
+typedef struct name {                                                                              \
+    name##Node *root;                                                                              \
+    NodePool *pool;                                                                                \
+    long size;                                                                                     \
+} name;                                                                                            \
+                                                                                                   \
+static inline Status name##_new(name **tree) {                                                     \
+    name *temp = (name *)malloc(sizeof(name));                                                     \
+    if (temp == NULL)                                                                              \
+        return ALLOC_FAILURE;                                                                      \
+    if (nodepool_new(&temp->pool, 0L) != OK) {                                                     \
+        free(temp);                                                                                \
+        return ALLOC_FAILURE;                                                                      \
+    }                                                                                              \
+    temp->root = NULL;                                                                             \
+    temp->size = 0L;                                                                               \
+    *tree = temp;                                                                                  \
+    return OK;                                                                                     \
+}                                                                                                  \
+                                                                                                   \
+/* Rotates right to remove a horizontal left link */                                               \
+static inline name##Node *name##__skew(name##Node *node) {                                         \
+    name##Node *left = node->left;                                                                 \
+    if (left == NULL || left->level != node->level)                                                \
+        return node;                                                                               \
+    node->left = left->right;                                                                      \
+    left->right = node;                                                                            \
+    return left;                                                                                   \
+}                                                                                                  \
+                                                                                                   \
+/* Rotates left and promotes the middle node to remove two consecutive horizontal right links */   \
+static inline name##Node *name##__split(name##Node *node) {                                        \
+    name##Node *right = node->right;                                                               \
+    if (right == NULL || right->right == NULL || right->right->level != node->level)               \
+        return node;                                                                               \
+    node->right = right->left;                                                                     \
+    right->left = node;                                                                            \
+    right->level++;                                                                                \
+    return right;                                                                                  \
+}                                                                                                  \
+                                                                                                   \
+static inline name##Node *name##__insert(name *tree, name##Node *node, K key, V value,             \
+                                         V *previous, Status *status) {                            \
+    int cmp;                                                                                       \
+    if (node == NULL) {                                                                            \
+        node = (name##Node *)nodepool_alloc(tree->pool, sizeof(name##Node));                       \
+        if (node == NULL) {                                                                        \
+            *status = ALLOC_FAILURE;                                                               \
+            return NULL;                                                                           \
+        }                                                                                          \
+        node->left = node->right = NULL;                                                           \
+        node->level = 1L;                                                                          \
+        node->key = key;                                                                           \
+        node->value = value;                                                                       \
+        tree->size++;                                                                              \
+        *status = INSERTED;                                                                        \
+        return node;                                                                               \
+    }                                                                                              \
+    cmp = cmpfn(key, node->key);                                                                   \
+    if (cmp == 0) {                                                                                \
+        if (previous != NULL)                                                                      \
+            *previous = node->value;                                                               \
+        node->value = value;                                                                       \
+        *status = REPLACED;                                                                        \
+        return node;                                                                               \
+    }                                                                                              \
+    if (cmp < 0)                                                                                   \
+        node->left = name##__insert(tree, node->left, key, value, previous, status);               \
+    else                                                                                           \
+        node->right = name##__insert(tree, node->right, key, value, previous, status);             \
+    return name##__split(name##__skew(node));                                                      \
+}                                                                                                  \
+                                                                                                   \
+static inline Status name##_put(name *tree, K key, V value, V *previous) {                         \
+    Status status;                                                                                 \
+    tree->root = name##__insert(tree, tree->root, key, value, previous, &status);                  \
+    return status;                                                                                 \
+}                                                                                                  \
+                                                                                                   \
+static inline name##Node *name##__find(name *tree, K key) {                                        \
+    name##Node *node = tree->root;                                                                 \
+    while (node != NULL) {                                                                         \
+        int cmp = cmpfn(key, node->key);                                                           \
+        if (cmp == 0)                                                                              \
+            break;                                                                                 \
+        node = (cmp < 0) ? node->left : node->right;                                               \
+    }                                                                                              \
+    return node;                                                                                   \
+}                                                                                                  \
+                                                                                                   \
+static inline Boolean name##_containsKey(name *tree, K key) {                                      \
+    return ( name##__find(tree, key) != NULL ) ? TRUE : FALSE;                                     \
+}                                                                                                  \
+                                                                                                   \
+static inline Status name##_get(name *tree, K key, V *value) {                                     \
+    name##Node *node = name##__find(tree, key);                                                    \
+    if (node == NULL)                                                                              \
+        return NOT_FOUND;                                                                          \
+    *value = node->value;                                                                          \
+    return OK;                                                                                     \
+}                                                                                                  \
+                                                                                                   \
+static inline name##Node *name##__delete(name *tree, name##Node *node, K key, V *value,            \
+                                         Boolean *found) {                                         \
+    name##Node *other;                                                                             \
+    long level;                                                                                    \
+    int cmp;                                                                                       \
+    if (node == NULL)                                                                              \
+        return NULL;                                                                               \
+    cmp = cmpfn(key, node->key);                                                                   \
+    if (cmp < 0) {                                                                                 \
+        node->left = name##__delete(tree, node->left, key, value, found);                          \
+    } else if (cmp > 0) {                                                                          \
+        node->right = name##__delete(tree, node->right, key, value, found);                        \
+    } else {                                                                                       \
+        V scratch;                                                                                 \
+        *found = TRUE;                                                                             \
+        if (value != NULL)                                                                         \
+            *value = node->value;                                                                  \
+        if (node->left == NULL && node->right == NULL) {                                           \
+            nodepool_free(tree->pool, node, sizeof(name##Node));                                   \
+            tree->size--;                                                                          \
+            return NULL;                                                                           \
+        }                                                                                          \
+        /* Overwrite the entry with its in-order neighbor, then delete that leaf-level node */     \
+        if (node->left == NULL) {                                                                  \
+            for (other = node->right; other->left != NULL; other = other->left)                    \
+                ;                                                                                  \
+            node->key = other->key;                                                                \
+            node->value = other->value;                                                            \
+            node->right = name##__delete(tree, node->right, other->key, &scratch, found);          \
+        } else {                                                                                   \
+            for (other = node->left; other->right != NULL; other = other->right)                   \
+                ;                                                                                  \
+            node->key = other->key;                                                                \
+            node->value = other->value;                                                            \
+            node->left = name##__delete(tree, node->left, other->key, &scratch, found);            \
+        }                                                                                          \
+    }                                                                                              \
+    /* Lower the level if a child fell two below it, then restore the AA invariants */             \
+    level = ((node->left != NULL && node->right != NULL)                                           \
+        ? ((node->left->level < node->right->level) ? node->left->level : node->right->level)      \
+        : 0L) + 1L;                                                                                \
+    if (level < node->level) {                                                                     \
+        node->level = level;                                                                       \
+        if (node->right != NULL && level < node->right->level)                                     \
+            node->right->level = level;                                                            \
+    }                                                                                              \
+    node = name##__skew(node);                                                                     \
+    if (node->right != NULL) {                                                                     \
+        node->right = name##__skew(node->right);                                                   \
+        if (node->right->right != NULL)                                                            \
+            node->right->right = name##__skew(node->right->right);                                 \
+    }                                                                                              \
+    node = name##__split(node);                                                                    \
+    if (node->right != NULL)                                                                       \
+        node->right = name##__split(node->right);                                                  \
+    return node;                                                                                   \
+}                                                                                                  \
+                                                                                                   \
+static inline Status name##_remove(name *tree, K key, V *value) {                                  \
+    Boolean found = FALSE;                                                                         \
+    tree->root = name##__delete(tree, tree->root, key, value, &found);                             \
+    return ( found ) ? OK : NOT_FOUND;                                                             \
+}                                                                                                  \
+                                                                                                   \
+static inline Status name##_firstKey(name *tree, K *firstKey) {                                    \
+    name##Node *node = tree->root;                                                                 \
+    if (node == NULL)                                                                              \
+        return STRUCT_EMPTY;                                                                       \
+    while (node->left != NULL)                                                                     \
+        node = node->left;                                                                         \
+    *firstKey = node->key;                                                                         \
+    return OK;                                                                                     \
+}                                                                                                  \
+                                                                                                   \
+static inline Status name##_lastKey(name *tree, K *lastKey) {                                      \
+    name##Node *node = tree->root;                                                                 \
+    if (node == NULL)                                                                              \
+        return STRUCT_EMPTY;                                                                       \
+    while (node->right != NULL)                                                                    \
+        node = node->right;                                                                        \
+    *lastKey = node->key;                                                                          \
+    return OK;                                                                                     \
+}                                                                                                  \
+                                                                                                   \
+static inline Status name##_floorKey(name *tree, K key, K *floorKey) {                             \
+    name##Node *node = tree->root, *best = NULL;                                                   \
+    if (node == NULL)                                                                              \
+        return STRUCT_EMPTY;                                                                       \
+    while (node != NULL) {                                                                         \
+        int cmp = cmpfn(key, node->key);                                                           \
+        if (cmp == 0) {                                                                            \
+            best = node;                                                                           \
+            break;                                                                                 \
+        }                                                                                          \
+        if (cmp > 0)                                                                               \
+            best = node;                                                                           \
+        node = (cmp < 0) ? node->left : node->right;                                               \
+    }                                                                                              \
+    if (best == NULL)                                                                              \
+        return NOT_FOUND;                                                                          \
+    *floorKey = best->key;                                                                         \
+    return OK;                                                                                     \
+}                                                                                                  \
+                                                                                                   \
+static inline Status name##_ceilingKey(name *tree, K key, K *ceilingKey) {                         \
+    name##Node *node = tree->root, *best = NULL;                                                   \
+    if (node == NULL)                                                                              \
+        return STRUCT_EMPTY;                                                                       \
+    while (node != NULL) {                                                                         \
+        int cmp = cmpfn(key, node->key);                                                           \
+        if (cmp == 0) {                                                                            \
+            best = node;                                                                           \
+            break;                                                                                 \
+        }                                                                                          \
+        if (cmp < 0)                                                                               \
+            best = node;                                                                           \
+        node = (cmp < 0) ? node->left : node->right;                                               \
+    }                                                                                              \
+    if (best == NULL)                                                                              \
+        return NOT_FOUND;                                                                          \
+    *ceilingKey = best->key;                                                                       \
+    return OK;                                                                                     \
+}                                                                                                  \
+                                                                                                   \
+static inline Boolean name##__walk(name##Node *node, Boolean (*action)(K, V, void *),              \
+                                    void *context) {                                               \
+    for (; node != NULL; node = node->right) {                                                     \
+        if (!name##__walk(node->left, action, context))                                            \
+            return FALSE;                                                                          \
+        if (!action(node->key, node->value, context))                                              \
+            return FALSE;                                                                          \
+    }                                                                                              \
+    return TRUE;                                                                                   \
+}                                                                                                  \
+                                                                                                   \
+static inline Boolean name##_forEach(name *tree, Boolean (*action)(K, V, void *),                  \
+                                     void *context) {                                              \
+    return name##__walk(tree->root, action, context);                                              \
+}                                                                                                  \
+                                                                                                   \
+static inline long name##_size(name *tree) {                                                       \
+    return tree->size;                                                                             \
+}                                                                                                  \
+                                                                                                   \
+static inline Boolean name##_isEmpty(name *tree) {                                                 \
+    return ( tree->size == 0L ) ? TRUE : FALSE;                                                    \
+}                                                                                                  \
+                                                                                                   \
+static inline void name##_clear(name *tree) {                                                      \
+    nodepool_reset(tree->pool);                                                                    \
+    tree->root = NULL;                                                                             \
+    tree->size = 0L;                                                                               \
+}                                                                                                  \
+                                                                                                   \
+static inline long name##_memoryUsage(name *tree) {                                                \
+    return (long)sizeof(name) + nodepool_memoryUsage(tree->pool);                                  \
+}                                                                                                  \
+                                                                                                   \
+static inline void name##_destroy(name *tree) {                                                    \
+    nodepool_destroy(tree->pool);                                                                  \
+    free(tree);                                                                                    \
+}
+
+#endif  /* _CDS_TYPED_TREE_MAP_H__ */
@@ -0,0 +1,131 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2020 Cole Vikupitz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _CDS_WORK_DEQUE_H__
+#define _CDS_WORK_DEQUE_H__
+
+#include "cds_common.h"
+
+/**
+ * Interface for the WorkDeque ADT.
+ *
+ * The WorkDeque class represents an unbounded double-ended queue of tasks for work-stealing
+ * schedulers (a Chase-Lev deque). Each deque has a single owner thread that pushes and pops tasks
+ * at the bottom in last-in-first-out order, while any number of other threads may concurrently
+ * steal the oldest tasks from the top. The owner's operations take no lock and only contend with
+ * thieves when one task is left; thieves race each other with a single compare-and-swap.
+ *
+ * Like the BoundedQueue, the tasks are stored in a circular array, which the owner doubles in size
+ * whenever it fills up. The arrays outgrown are kept until the deque is destroyed, since a thief
+ * may still be reading from one; their total size never exceeds that of the current array.
+ */
+typedef struct work_deque WorkDeque;
+
+/**
+ * Creates a new, empty deque instance, then stores the new instance into `*deque`. The initial
+ * capacity is rounded up to the next power of two; if <= 0, a default capacity is assigned.
+ *
+ * Params:
+ *    deque - The pointer address to store the new WorkDeque instance.
+ *    capacity - The deque's initial capacity.
+ * Returns:
+ *    OK - Deque was successfully created.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status workdeque_new(WorkDeque **deque, long capacity);
+
+/**
+ * Pushes the specified task onto the bottom of the deque. Must only be called by the owner.
+ *
+ * Params:
+ *    deque - The deque to operate on.
+ *    item - The task to push onto the deque.
+ * Returns:
+ *    OK - Operation was successful.
+ *    ALLOC_FAILURE - Failed to allocate enough memory from the heap.
+ */
+Status workdeque_push(WorkDeque *deque, void *item);
+
+/**
+ * Removes the task at the bottom of the deque, the one most recently pushed, and stores the result
+ * into `*item`. Must only be called by the owner.
+ *
+ * Params:
+ *    deque - The deque to operate on.
+ *    item - The pointer address to store the removed task into.
+ * Returns:
+ *    OK - Operation was successful.
+ *    STRUCT_EMPTY - Deque is currently empty, or its last task was just stolen.
+ */
+Status workdeque_pop(WorkDeque *deque, void **item);
+
+/**
+ * Removes the task at the top of the deque, the oldest one, and stores the result into `*item`.
+ * May be called by any thread.
+ *
+ * Params:
+ *    deque - The deque to operate on.
+ *    item - The pointer address to store the stolen task into.
+ * Returns:
+ *    OK - Operation was successful.
+ *    STRUCT_EMPTY - Deque is currently empty.
+ */
+Status workdeque_steal(WorkDeque *deque, void **item);
+
+/**
+ * Returns the number of tasks in the deque. While other threads are using the deque, the result
+ * is only a snapshot that may already be out of date.
+ *
+ * Params:
+ *    deque - The deque to operate on.
+ * Returns:
+ *    The deque's current size.
+ */
+long workdeque_size(WorkDeque *deque);
+
+/**
+ * Returns TRUE if the deque is currently empty, FALSE if not. Like workdeque_size(), this is only
+ * a snapshot while other threads are using the deque.
+ *
+ * Params:
+ *    deque - The deque to operate on.
+ * Returns:
+ *    TRUE if the deque is empty, FALSE if not.
+ */
+Boolean workdeque_isEmpty(WorkDeque *deque);
+
+/**
+ * Destroys the deque instance by freeing all of its reserved memory. If `destructor` is not NULL,
+ * it will be invoked on each task still in the deque before the deque is destroyed. Must only be
+ * called once no other thread uses the deque.
+ *
+ * Params:
+ *    deque - The deque to destroy.
+ *    destructor - Function to operate on each task prior to deque destruction.
+ * Returns:
+ *    None
+ */
+void workdeque_destroy(WorkDeque *deque, void (*destructor)(void *));
+
+#endif  /* _CDS_WORK_DEQUE_H__ */
@@ -0,0 +1,262 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2020 Cole Vikupitz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#if defined(__linux__)
+#define _GNU_SOURCE
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "allocator.h"
+
+static void *_libc_alloc(size_t size, void *context) {
+    (void)context;
+    return malloc(size);
+}
+
+static void *_libc_realloc(void *ptr, size_t size, void *context) {
+    (void)context;
+    return realloc(ptr, size);
+}
+
+static void _libc_free(void *ptr, void *context) {
+    (void)context;
+    free(ptr);
+}
+
+// The allocator used by structures created without one
+static const CdsAllocator libcAllocator = { _libc_alloc, _libc_realloc, _libc_free, NULL };
+
+// Blocks at least this large (in bytes) get their own mapping from the large page allocators
+#define HUGE_PAGE ( 2UL * 1024UL * 1024UL )
+// The bytes reserved in front of a mapped block, a whole cache line so the block stays aligned
+#define MAP_HEADER 64UL
+
+/**
+ * The header in front of every block of the large page allocators, right before the block.
+ */
+typedef struct {
+    size_t mapped;      // The length of the block's mapping, or 0 if allocated with malloc()
+    size_t size;        // The size of the block, in bytes
+} Header;
+
+// Returns the header of the large page allocators' block `ptr`
+#define HEADER(ptr)  ( (Header *)(ptr) - 1 )
+
+/**
+ * Maps a new block of `size` bytes for a large page allocator with the flags `flags`, returning the
+ * block, or NULL if failed (mapping or locking error).
+ */
+static void *_map(size_t size, int flags) {
+
+    size_t page = (size_t)sysconf(_SC_PAGESIZE), length = size + MAP_HEADER;
+    char *area = MAP_FAILED;
+
+#ifdef MAP_HUGETLB
+    // Explicit huge pages come in whole huge pages only
+    if ((flags & LARGE_PAGES_HUGETLB) != 0) {
+        size_t huge = ( length + HUGE_PAGE - 1 ) & ~(HUGE_PAGE - 1);
+        area = (char *)mmap(NULL, huge, PROT_READ | PROT_WRITE,
+                            MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        length = ( area == MAP_FAILED ) ? length : huge;
+    }
+#endif
+    if (area == MAP_FAILED) {
+        length = ( length + page - 1 ) & ~(page - 1);
+        area = (char *)mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+                            -1, 0);
+        if (area == MAP_FAILED) {
+            return NULL;
+        }
+#ifdef MADV_HUGEPAGE
+        // Failures are harmless, the block is then backed by ordinary pages
+        (void)madvise(area, length, MADV_HUGEPAGE);
+#endif
+    }
+
+    if ((flags & LARGE_PAGES_LOCKED) != 0 && mlock(area, length) != 0) {
+        munmap(area, length);
+        return NULL;
+    }
+    Header *header = HEADER(area + MAP_HEADER);
+    header->mapped = length;
+    header->size = size;
+
+    return area + MAP_HEADER;
+}
+
+static void *_large_alloc(size_t size, void *context) {
+
+    if (size >= HUGE_PAGE) {
+        return _map(size, *(const int *)context);
+    }
+
+    // Small blocks are left to malloc(), behind a header marking them as such
+    Header *header = (Header *)malloc(sizeof(Header) + size);
+    if (header == NULL) {
+        return NULL;
+    }
+    header->mapped = 0UL;
+    header->size = size;
+
+    return header + 1;
+}
+
+static void _large_free(void *ptr, void *context) {
+
+    (void)context;
+    Header *header = HEADER(ptr);
+    if (header->mapped == 0UL) {
+        free(header);
+    } else {
+        munmap((char *)ptr - MAP_HEADER, header->mapped);
+    }
+}
+
+static void *_large_realloc(void *ptr, size_t size, void *context) {
+
+    Header *header = HEADER(ptr);
+    void *temp;
+
+    // Small blocks stay with malloc() until they become large
+    if (header->mapped == 0UL && size < HUGE_PAGE) {
+        if ((header = (Header *)realloc(header, sizeof(Header) + size)) == NULL) {
+            return NULL;
+        }
+        header->size = size;
+        return header + 1;
+    }
+
+#ifdef MREMAP_MAYMOVE
+    /*
+     * Remapping moves the pages of a mapped block over without copying them. The new pages keep
+     * the mapping's advice and lock (the kernel fails the call if they cannot be locked); explicit
+     * huge page mappings are only resized by whole huge pages.
+     */
+    if (header->mapped != 0UL) {
+        size_t page = (size_t)sysconf(_SC_PAGESIZE), length = size + MAP_HEADER;
+        size_t align = ( header->mapped % HUGE_PAGE == 0UL ) ? HUGE_PAGE : page;
+        length = ( length + align - 1 ) & ~(align - 1);
+        char *area = (char *)mremap((char *)ptr - MAP_HEADER, header->mapped, length,
+                                    MREMAP_MAYMOVE);
+        if (area != MAP_FAILED) {
+            header = HEADER(area + MAP_HEADER);
+            header->mapped = length;
+            header->size = size;
+            return area + MAP_HEADER;
+        }
+    }
+#endif
+
+    // Otherwise the block is copied into a new one
+    if ((temp = _large_alloc(size, context)) == NULL) {
+        return NULL;
+    }
+    memcpy(temp, ptr, ( header->size < size ) ? header->size : size);
+    _large_free(ptr, context);
+
+    return temp;
+}
+
+// The flags of each large page allocator, passed along as their context
+static const int largeFlags[] = { 0, LARGE_PAGES_LOCKED, LARGE_PAGES_HUGETLB,
+                                  LARGE_PAGES_LOCKED | LARGE_PAGES_HUGETLB };
+
+// The large page allocators, one for each combination of flags
+static const CdsAllocator largeAllocators[] = {
+    { _large_alloc, _large_realloc, _large_free, (void *)&largeFlags[0] },
+    { _large_alloc, _large_realloc, _large_free, (void *)&largeFlags[1] },
+    { _large_alloc, _large_realloc, _large_free, (void *)&largeFlags[2] },
+    { _large_alloc, _large_realloc, _large_free, (void *)&largeFlags[3] }
+};
+
+// The counters reported by allocator_stats()
+static AllocStats counters;
+
+#ifdef CDS_ALLOC_STATS
+#define COUNT(field, n)  __atomic_add_fetch(&(counters.field), (long)(n), __ATOMIC_RELAXED)
+#else
+#define COUNT(field, n)
+#endif
+
+const CdsAllocator *allocator_default(void) {
+    return &libcAllocator;
+}
+
+const CdsAllocator *allocator_largePages(int flags) {
+    return &largeAllocators[flags & ( LARGE_PAGES_LOCKED | LARGE_PAGES_HUGETLB )];
+}
+
+void *allocator_alloc(const CdsAllocator *allocator, size_t size) {
+
+    COUNT(allocs, 1L);
+    COUNT(bytes, size);
+    return (*(allocator->alloc))(size, allocator->context);
+}
+
+void *allocator_realloc(const CdsAllocator *allocator, void *ptr, size_t size) {
+
+    COUNT(reallocs, 1L);
+    COUNT(bytes, size);
+    return (*(allocator->realloc))(ptr, size, allocator->context);
+}
+
+void *allocator_reallocArray(const CdsAllocator *allocator, void *ptr, size_t n, size_t size) {
+
+    size_t bytes;
+
+    if (__builtin_mul_overflow(n, size, &bytes)) {
+        return NULL;
+    }
+
+    return ( ptr == NULL ) ? allocator_alloc(allocator, bytes)
+                           : allocator_realloc(allocator, ptr, bytes);
+}
+
+void allocator_free(const CdsAllocator *allocator, void *ptr) {
+
+    if (ptr != NULL) {
+        COUNT(frees, 1L);
+        (*(allocator->free))(ptr, allocator->context);
+    }
+}
+
+void allocator_stats(AllocStats *stats) {
+
+    stats->allocs = __atomic_load_n(&(counters.allocs), __ATOMIC_RELAXED);
+    stats->reallocs = __atomic_load_n(&(counters.reallocs), __ATOMIC_RELAXED);
+    stats->frees = __atomic_load_n(&(counters.frees), __ATOMIC_RELAXED);
+    stats->bytes = __atomic_load_n(&(counters.bytes), __ATOMIC_RELAXED);
+}
+
+void allocator_resetStats(void) {
+
+    __atomic_store_n(&(counters.allocs), 0L, __ATOMIC_RELAXED);
+    __atomic_store_n(&(counters.reallocs), 0L, __ATOMIC_RELAXED);
+    __atomic_store_n(&(counters.frees), 0L, __ATOMIC_RELAXED);
+    __atomic_store_n(&(counters.bytes), 0L, __ATOMIC_RELAXED);
+}
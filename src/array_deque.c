@@ -0,0 +1,513 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2020 Cole Vikupitz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "array_deque.h"
+
+/**
+ * Struct for the array deque ADT.
+ *
+ * The elements are stored in a circular array whose capacity is always a power of two, so that a
+ * logical index is mapped onto its slot with a single mask rather than a division.
+ */
+struct arraydeque {
+    void **data;        // The circular array of elements
+    long head;          // The slot holding the first element
+    long size;          // The deque's current size
+    long mask;          // The deque's current capacity, less one
+    long modCount;      // Number of structural modifications made
+    const CdsAllocator *allocator;  // Allocates the struct and the array
+};
+
+// The default capacity to assign when the capacity give is invalid
+#define DEFAULT_CAPACITY 16L
+
+// Macro used to validate the given index `i` for an array of size `N`
+#define VALIDATE_INDEX(i, N) ( ( 0L <= (i) && (i) < (N) ) ? TRUE : FALSE )
+// Macro to check if the deque is currently empty
+#define IS_EMPTY(x)  ( ((x)->size == 0L) ? TRUE : FALSE )
+// Macro used to fetch the slot holding the element at index `i` of the deque `x`
+#define SLOT(x, i)  ( (x)->data[((x)->head + (i)) & (x)->mask] )
+
+/**
+ * Helper method to round the capacity `capacity` up to the next power of two.
+ */
+static long _round_capacity(long capacity) {
+
+    long cap = 1L;
+    while (cap < capacity) {
+        cap <<= 1;
+    }
+
+    return cap;
+}
+
+Status arraydeque_newWithAllocator(ArrayDeque **deque, long capacity,
+                                   const CdsAllocator *allocator) {
+
+    if (allocator == NULL) {
+        allocator = allocator_default();
+    }
+
+    // Allocate the struct, check for allocation failures
+    ArrayDeque *temp = (ArrayDeque *)allocator_alloc(allocator, sizeof(ArrayDeque));
+    if (temp == NULL) {
+        return ALLOC_FAILURE;
+    }
+
+    // Set up capacity, allocate the array
+    long cap = _round_capacity(( capacity <= 0L ) ? DEFAULT_CAPACITY : capacity);
+    void **array = (void **)allocator_reallocArray(allocator, NULL, cap, sizeof(void *));
+    if (array == NULL) {
+        allocator_free(allocator, temp);
+        return ALLOC_FAILURE;
+    }
+    memset(array, 0, cap * sizeof(void *));
+
+    // Initializes the remainder of struct members
+    temp->data = array;
+    temp->head = 0L;
+    temp->size = 0L;
+    temp->mask = cap - 1L;
+    temp->modCount = 0L;
+    temp->allocator = allocator;
+    *deque = temp;
+
+    return OK;
+}
+
+Status arraydeque_new(ArrayDeque **deque, long capacity) {
+    return arraydeque_newWithAllocator(deque, capacity, NULL);
+}
+
+/**
+ * Copies the `n` elements of the deque `deque` starting at index `i` into the array `items`, as
+ * at most two runs. This is used to both resize the deque and to generate its array.
+ */
+static void _copy_out(ArrayDeque *deque, long i, long n, void **items) {
+
+    long start = (deque->head + i) & deque->mask;
+    long run = (deque->mask + 1L) - start;
+
+    if (run >= n) {
+        memcpy(items, deque->data + start, n * sizeof(void *));
+    } else {
+        memcpy(items, deque->data + start, run * sizeof(void *));
+        memcpy(items + run, deque->data, (n - run) * sizeof(void *));
+    }
+}
+
+/**
+ * Helper method to resize the deque `deque` to the new specified capacity `newCapacity`, which
+ * must be a power of two no smaller than its size. The elements are unwrapped into the new array
+ * so that the first element lands in slot 0. Returns TRUE if successful, FALSE if not (allocation
+ * error).
+ */
+static Boolean _resize(ArrayDeque *deque, long newCapacity) {
+
+    void **temp = (void **)allocator_reallocArray(deque->allocator, NULL, newCapacity,
+                                                  sizeof(void *));
+    if (temp == NULL) {
+        return FALSE;
+    }
+    memset(temp, 0, newCapacity * sizeof(void *));
+
+    // Move the elements into the new array
+    _copy_out(deque, 0L, deque->size, temp);
+    allocator_free(deque->allocator, deque->data);
+    deque->data = temp;
+    deque->head = 0L;
+    deque->mask = newCapacity - 1L;
+    deque->modCount++;
+
+    return TRUE;
+}
+
+/**
+ * Helper method to make room for one more element in the deque `deque`, doubling its capacity if
+ * it is currently full. Returns TRUE if successful, FALSE if not (allocation error).
+ */
+static Boolean _ensure_room(ArrayDeque *deque) {
+
+    if (deque->size <= deque->mask) {
+        return TRUE;
+    }
+
+    return _resize(deque, (deque->mask + 1L) * 2L);
+}
+
+Status arraydeque_addFirst(ArrayDeque *deque, void *item) {
+
+    // Check the capacity, extend if needed
+    if (_ensure_room(deque) == FALSE) {
+        return ALLOC_FAILURE;
+    }
+    // Step the head back a slot, store the item there
+    deque->head = (deque->head - 1L) & deque->mask;
+    deque->data[deque->head] = item;
+    deque->size++;
+    deque->modCount++;
+
+    return OK;
+}
+
+Status arraydeque_addLast(ArrayDeque *deque, void *item) {
+
+    // Check the capacity, extend if needed
+    if (_ensure_room(deque) == FALSE) {
+        return ALLOC_FAILURE;
+    }
+    // Store the item in the slot just past the last element
+    SLOT(deque, deque->size) = item;
+    deque->size++;
+    deque->modCount++;
+
+    return OK;
+}
+
+Status arraydeque_insert(ArrayDeque *deque, long i, void *item) {
+
+    long j;
+
+    // Checks if the index is valid
+    if (VALIDATE_INDEX(i, deque->size + 1) == FALSE) {
+        return INVALID_INDEX;
+    }
+    // Check the capacity, extend if needed
+    if (_ensure_room(deque) == FALSE) {
+        return ALLOC_FAILURE;
+    }
+
+    if (i < deque->size / 2L) {
+        // Closer to the front, shift the first `i` elements back a slot
+        deque->head = (deque->head - 1L) & deque->mask;
+        for (j = 0L; j < i; j++) {
+            SLOT(deque, j) = SLOT(deque, j + 1L);
+        }
+    } else {
+        // Closer to the end, shift the elements from `i` onwards up a slot
+        for (j = deque->size; j > i; j--) {
+            SLOT(deque, j) = SLOT(deque, j - 1L);
+        }
+    }
+    SLOT(deque, i) = item;
+    deque->size++;
+    deque->modCount++;
+
+    return OK;
+}
+
+Status arraydeque_first(ArrayDeque *deque, void **first) {
+
+    // Checks if the deque is currently empty
+    if (IS_EMPTY(deque) == TRUE) {
+        return STRUCT_EMPTY;
+    }
+    *first = deque->data[deque->head];
+
+    return OK;
+}
+
+Status arraydeque_last(ArrayDeque *deque, void **last) {
+
+    // Checks if the deque is currently empty
+    if (IS_EMPTY(deque) == TRUE) {
+        return STRUCT_EMPTY;
+    }
+    *last = SLOT(deque, deque->size - 1L);
+
+    return OK;
+}
+
+Status arraydeque_get(ArrayDeque *deque, long i, void **item) {
+
+    // Checks if the deque is currently empty
+    if (IS_EMPTY(deque) == TRUE) {
+        return STRUCT_EMPTY;
+    }
+    // Checks if the index is valid
+    if (VALIDATE_INDEX(i, deque->size) == FALSE) {
+        return INVALID_INDEX;
+    }
+    *item = SLOT(deque, i);
+
+    return OK;
+}
+
+Status arraydeque_set(ArrayDeque *deque, long i, void *item, void **previous) {
+
+    // Checks if the deque is currently empty
+    if (IS_EMPTY(deque) == TRUE) {
+        return STRUCT_EMPTY;
+    }
+    // Checks if the index is valid
+    if (VALIDATE_INDEX(i, deque->size) == FALSE) {
+        return INVALID_INDEX;
+    }
+
+    // Replaces the old item with the new one
+    *previous = SLOT(deque, i);
+    SLOT(deque, i) = item;
+
+    return OK;
+}
+
+Status arraydeque_removeFirst(ArrayDeque *deque, void **first) {
+
+    // Checks if the deque is currently empty
+    if (IS_EMPTY(deque) == TRUE) {
+        return STRUCT_EMPTY;
+    }
+
+    // Takes the item, steps the head forward a slot
+    *first = deque->data[deque->head];
+    deque->data[deque->head] = NULL;
+    deque->head = (deque->head + 1L) & deque->mask;
+    deque->size--;
+    deque->modCount++;
+
+    return OK;
+}
+
+Status arraydeque_removeLast(ArrayDeque *deque, void **last) {
+
+    // Checks if the deque is currently empty
+    if (IS_EMPTY(deque) == TRUE) {
+        return STRUCT_EMPTY;
+    }
+
+    // Takes the item from the last slot
+    deque->size--;
+    *last = SLOT(deque, deque->size);
+    SLOT(deque, deque->size) = NULL;
+    deque->modCount++;
+
+    return OK;
+}
+
+Status arraydeque_remove(ArrayDeque *deque, long i, void **item) {
+
+    long j;
+
+    // Checks if the deque is currently empty
+    if (IS_EMPTY(deque) == TRUE) {
+        return STRUCT_EMPTY;
+    }
+    // Checks if the index is valid
+    if (VALIDATE_INDEX(i, deque->size) == FALSE) {
+        return INVALID_INDEX;
+    }
+
+    *item = SLOT(deque, i);
+    if (i < deque->size / 2L) {
+        // Closer to the front, shift the first `i` elements up a slot
+        for (j = i; j > 0L; j--) {
+            SLOT(deque, j) = SLOT(deque, j - 1L);
+        }
+        deque->data[deque->head] = NULL;
+        deque->head = (deque->head + 1L) & deque->mask;
+    } else {
+        // Closer to the end, shift the elements after `i` back a slot
+        for (j = i; j < deque->size - 1L; j++) {
+            SLOT(deque, j) = SLOT(deque, j + 1L);
+        }
+        SLOT(deque, deque->size - 1L) = NULL;
+    }
+    deque->size--;
+    deque->modCount++;
+
+    return OK;
+}
+
+Status arraydeque_ensureCapacity(ArrayDeque *deque, long capacity) {
+
+    // Only extend if capacity < newCapacity
+    if (deque->mask + 1L < capacity) {
+        if (_resize(deque, _round_capacity(capacity)) == FALSE) {
+            return ALLOC_FAILURE;
+        }
+    }
+
+    return OK;
+}
+
+/**
+ * Helper method to clear out the deque `deque` of all its elements, applying the destructor
+ * method `destructor` on each element (or if NULL, nothing will be done to the elements).
+ */
+static void _clear_deque(ArrayDeque *deque, void (*destructor)(void *)) {
+
+    long i;
+    for (i = 0L; i < deque->size; i++) {
+        if (destructor != NULL) {
+            (*destructor)(SLOT(deque, i));
+        }
+        SLOT(deque, i) = NULL;
+    }
+}
+
+void arraydeque_clear(ArrayDeque *deque, void (*destructor)(void *)) {
+    _clear_deque(deque, destructor);
+    deque->head = 0L;
+    deque->size = 0L;
+    deque->modCount++;
+}
+
+long arraydeque_size(ArrayDeque *deque) {
+    return deque->size;
+}
+
+long arraydeque_capacity(ArrayDeque *deque) {
+    return deque->mask + 1L;
+}
+
+Boolean arraydeque_isEmpty(ArrayDeque *deque) {
+    return IS_EMPTY(deque);
+}
+
+/**
+ * Helper method to generate an array representation of the deque. Returns the allocated array
+ * with the populated elements, or NULL if failed (allocation error).
+ */
+static void **_generate_array(ArrayDeque *deque) {
+
+    // Allocates memory for the array
+    void **items = (void **)malloc(deque->size * sizeof(void *));
+    if (items == NULL) {
+        return NULL;
+    }
+    // Populates the array with the deque's items
+    _copy_out(deque, 0L, deque->size, items);
+
+    return items;
+}
+
+Status arraydeque_toArray(ArrayDeque *deque, Array **array) {
+
+    // Do not create the array if currently empty
+    if (IS_EMPTY(deque) == TRUE) {
+        return STRUCT_EMPTY;
+    }
+
+    // Generate the array of deque items
+    void **items = _generate_array(deque);
+    if (items == NULL) {
+        return ALLOC_FAILURE;
+    }
+
+    // Allocate memory for the array struct
+    Array *temp = (Array *)malloc(sizeof(Array));
+    if (temp == NULL) {
+        free(items);
+        return ALLOC_FAILURE;
+    }
+
+    // Initializes the remaining struct members
+    temp->items = items;
+    temp->len = deque->size;
+    *array = temp;
+
+    return OK;
+}
+
+Status arraydeque_iterator(ArrayDeque *deque, Iterator **iter) {
+
+    Iterator *temp = NULL;
+
+    // Checks if the deque is currently empty
+    if (IS_EMPTY(deque) == TRUE) {
+        return STRUCT_EMPTY;
+    }
+
+    // Generates the array of items for iterator
+    void **items = _generate_array(deque);
+    if (items == NULL) {
+        return ALLOC_FAILURE;
+    }
+
+    // Creates a new iterator with the items
+    Status status = iterator_new(&temp, items, deque->size);
+    if (status != OK) {
+        free(items);
+        return status;
+    }
+    *iter = temp;
+
+    return OK;
+}
+
+void arraydeque_cursor(ArrayDeque *deque, Cursor *cursor) {
+    cursor->adt = deque;
+    cursor->node = NULL;
+    cursor->index = 0L;
+    cursor->remaining = deque->size;
+    cursor->modCount = deque->modCount;
+    cursor->end = NULL;
+}
+
+Status arraydeque_cursorNext(Cursor *cursor, void **next) {
+
+    ArrayDeque *deque = (ArrayDeque *)cursor->adt;
+
+    // Fails fast if the deque was modified since creating the cursor
+    if (deque->modCount != cursor->modCount) {
+        return CONCURRENT_MODIFICATION;
+    }
+    // Checks if every element was visited
+    if (cursor->remaining == 0L) {
+        return ITER_END;
+    }
+
+    // Fetches the item, advances to the next index
+    *next = SLOT(deque, cursor->index);
+    cursor->index = cursor->index + 1L;
+    cursor->remaining--;
+
+    return OK;
+}
+
+Boolean arraydeque_forEach(ArrayDeque *deque, Boolean (*action)(void *, void *), void *context) {
+
+    long i;
+
+    for (i = 0L; i < deque->size; i++) {
+        if ((*action)(SLOT(deque, i), context) == FALSE) {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+long arraydeque_memoryUsage(ArrayDeque *deque) {
+
+    return (long)( sizeof(ArrayDeque) + ( ( deque->mask + 1L ) * sizeof(void *) ) );
+}
+
+void arraydeque_destroy(ArrayDeque *deque, void (*destructor)(void *)) {
+    _clear_deque(deque, destructor);
+    allocator_free(deque->allocator, deque->data);
+    allocator_free(deque->allocator, deque);
+}
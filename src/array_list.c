@@ -22,8 +22,13 @@
  * SOFTWARE.
  */
 
+#include <pthread.h>
+#include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
 #include "array_list.h"
+#include "cds_stats.h"
 
 /**
  * Struct for the array list ADT.
@@ -31,44 +36,71 @@
 struct arraylist {
     void **data;        // The list of elements
     long size;          // The arraylist's current size
+    long modCount;      // Number of structural modifications made
     long capacity;      // The arraylist's current capacity
+    float growthFactor; // The growth factor to apply when expanding the list's capacity
+    const CdsAllocator *allocator;  // Allocates the struct, the array and the sorts' scratch
+};
+
+/**
+ * Struct for a frozen sorted array.
+ */
+struct frozen_array {
+    void **items;                           // The items in Eytzinger order, from index 1
+    long size;                              // The number of items
+    int (*comparator)(void *, void *);      // Function comparing the items
 };
 
 // The default capacity to assign when the capacity give is invalid
 #define DEFAULT_CAPACITY 10L
-
-Status arraylist_new(ArrayList **list, long capacity) {
+// The default growth factor, doubling the capacity whenever the list becomes full
+#define DEFAULT_GROWTH_FACTOR 1.0f
+// The maximum capacity allowed, beyond which the array's size in bytes would overflow
+#define MAX_CAPACITY ( (long)( PTRDIFF_MAX / sizeof(void *) ) )
+// Arrays at least this large (in bytes) grow in whole huge pages
+#define HUGE_PAGE ( 2L * 1024L * 1024L )
+
+Status arraylist_newWithAllocator(ArrayList **list, long capacity,
+                                  const CdsAllocator *allocator) {
+
+    if (allocator == NULL) {
+        allocator = allocator_default();
+    }
 
     // Allocate the struct, check for allocation failures
-    ArrayList *temp = (ArrayList *)malloc(sizeof(ArrayList));
+    ArrayList *temp = (ArrayList *)allocator_alloc(allocator, sizeof(ArrayList));
     if (temp == NULL) {
         return ALLOC_FAILURE;
     }
 
     // Set up capacity, initialize the reminaing struct members
     long cap = ( capacity <= 0L ) ? DEFAULT_CAPACITY : capacity;
-    size_t bytes = (cap * sizeof(void *));
-    void **array = (void **)malloc(bytes);
+    void **array = ( cap > MAX_CAPACITY ) ? NULL
+                 : (void **)allocator_reallocArray(allocator, NULL, cap, sizeof(void *));
 
     // Checks for allocation failures
     if (array == NULL) {
-        free(temp);
+        allocator_free(allocator, temp);
         return ALLOC_FAILURE;
     }
 
     // Initializes the remainder of struct members
-    long i;
-    for (i = 0L; i < cap; i++) {
-        array[i] = NULL;
-    }
+    // The slots past the size are never read, so they're left unfilled
     temp->data = array;
     temp->size = 0L;
+    temp->modCount = 0L;
     temp->capacity = cap;
+    temp->growthFactor = DEFAULT_GROWTH_FACTOR;
+    temp->allocator = allocator;
     *list = temp;
 
     return OK;
 }
 
+Status arraylist_new(ArrayList **list, long capacity) {
+    return arraylist_newWithAllocator(list, capacity, NULL);
+}
+
 // Macro used to validate the given index `i` for an array of size `N`
 #define VALIDATE_INDEX(i, N) ( ( 0L <= (i) && (i) < (N) ) ? TRUE : FALSE )
 // Macro to check if the list is currently empty
@@ -81,38 +113,78 @@ Status arraylist_new(ArrayList **list, long capacity) {
 static Boolean _ensure_capacity(ArrayList *list, long newCapacity) {
 
     Boolean status = FALSE;
-    size_t bytes = ( newCapacity * sizeof(void *) );
-    void **temp = (void **)realloc(list->data, bytes);
+    void **temp = (void **)allocator_reallocArray(list->allocator, list->data, newCapacity,
+                                                  sizeof(void *));
 
     if (temp != NULL) {
-        // Update attributes after extension
+        // Update attributes after extension, the new slots are left as they are
         list->data = temp;
-        long i;
-        for (i = list->capacity; i < newCapacity; i++) {
-            list->data[i] = NULL;
-        }
         list->capacity = newCapacity;
         status = TRUE;
+#if defined(CDS_HUGE_PAGES) && defined(MADV_HUGEPAGE)
+        // Asks for huge pages over the whole pages inside a large array, failures are harmless
+        size_t bytes = ( newCapacity * sizeof(void *) );
+        if (bytes >= (size_t)( 2L * HUGE_PAGE )) {
+            uintptr_t start = ( (uintptr_t)temp + HUGE_PAGE - 1 ) & ~((uintptr_t)HUGE_PAGE - 1);
+            uintptr_t end = ( (uintptr_t)temp + bytes ) & ~((uintptr_t)HUGE_PAGE - 1);
+            (void)madvise((void *)start, end - start, MADV_HUGEPAGE);
+        }
+#endif
     }
 
     return status;
 }
 
+/**
+ * Helper method to make room for `n` more elements in the arraylist `list`, growing its capacity
+ * at most once. The capacity grows by the list's growth factor, or to fit the whole batch if that
+ * needs more; a large array is also rounded up to whole huge pages. Returns TRUE if successful,
+ * FALSE if not (allocation error, or the list would grow past the maximum capacity).
+ */
+static Boolean _make_room(ArrayList *list, long n) {
+
+    long needed, grown, growth, perPage = ( HUGE_PAGE / (long)sizeof(void *) );
+
+    if (n <= list->capacity - list->size) {
+        return TRUE;
+    }
+    if (n > MAX_CAPACITY - list->size) {
+        return FALSE;
+    }
+
+    needed = list->size + n;
+    growth = (long)( (double)list->capacity * list->growthFactor );
+    growth = ( growth < 1L ) ? 1L : growth;
+    grown = ( growth > MAX_CAPACITY - list->capacity ) ? MAX_CAPACITY : list->capacity + growth;
+    grown = ( grown < needed ) ? needed : grown;
+    if (grown >= perPage && grown <= MAX_CAPACITY - perPage) {
+        grown = ( ( grown + perPage - 1L ) / perPage ) * perPage;
+    }
+
+    CDS_STATS_BEGIN();
+    Boolean grew = _ensure_capacity(list, grown);
+    CDS_STATS_END(CDS_EVENT_ARRAYLIST_GROW);
+
+    return grew;
+}
+
 Status arraylist_add(ArrayList *list, void *item) {
 
     // Check the capacity, extends if needed
-    if (list->size == list->capacity) {
-        if (_ensure_capacity(list, list->capacity * 2) == FALSE) {
-            return ALLOC_FAILURE;
-        }
+    if (list->size == list->capacity && _make_room(list, 1L) == FALSE) {
+        return ALLOC_FAILURE;
     }
     // Append the new item to the arraylist
     list->data[list->size++] = item;
+    list->modCount++;
 
     return OK;
 }
 
-Status arraylist_insert(ArrayList *list, long i, void *item) {
+/**
+ * Inserts the item at the index, the body of arraylist_insert().
+ */
+static Status _insert(ArrayList *list, long i, void *item) {
 
     // Checks if the index is valid
     if (VALIDATE_INDEX(i, list->size + 1) == FALSE) {
@@ -120,20 +192,53 @@ Status arraylist_insert(ArrayList *list, long i, void *item) {
     }
 
     // Check the capacity, extend if needed
-    if (list->size == list->capacity) {
-        if (_ensure_capacity(list, list->capacity * 2) == FALSE) {
-            return ALLOC_FAILURE;
-        }
+    if (list->size == list->capacity && _make_room(list, 1L) == FALSE) {
+        return ALLOC_FAILURE;
     }
 
     // Shift items to make room for insertion
-    long j;
-    for (j = list->size; j > i; j--) {
-        list->data[j] = list->data[j - 1];
-    }
+    memmove(list->data + i + 1, list->data + i, ( list->size - i ) * sizeof(void *));
     // Insert data into new index
     list->data[i] = item;
     list->size++;
+    list->modCount++;
+
+    return OK;
+}
+
+Status arraylist_insert(ArrayList *list, long i, void *item) {
+
+    CDS_STATS_BEGIN();
+    Status status = _insert(list, i, item);
+    CDS_STATS_END(CDS_PROBE_ARRAYLIST_INSERT);
+
+    return status;
+}
+
+Status arraylist_addAll(ArrayList *list, void **items, long n) {
+    return arraylist_insertAll(list, list->size, items, n);
+}
+
+Status arraylist_insertAll(ArrayList *list, long i, void **items, long n) {
+
+    // Checks if the index and count are valid
+    if (VALIDATE_INDEX(i, list->size + 1) == FALSE || n < 0L) {
+        return INVALID_INDEX;
+    }
+    if (n == 0L) {
+        return OK;
+    }
+
+    // Check the capacity once for the whole batch, extend if needed
+    if (_make_room(list, n) == FALSE) {
+        return ALLOC_FAILURE;
+    }
+
+    // Shift items once to make room, then copy the batch into the gap
+    memmove(list->data + i + n, list->data + i, ( list->size - i ) * sizeof(void *));
+    memcpy(list->data + i, items, n * sizeof(void *));
+    list->size += n;
+    list->modCount++;
 
     return OK;
 }
@@ -187,20 +292,576 @@ Status arraylist_remove(ArrayList *list, long i, void **item) {
     // Retrieve removed item, saves to pointer
     *item = list->data[i];
     // Shift items to fill gap after removal
-    long j;
-    for (j = i; j < list->size - 1; j++) {
-        list->data[j] = list->data[j + 1];
+    memmove(list->data + i, list->data + i + 1, ( list->size - i - 1 ) * sizeof(void *));
+    list->data[--list->size] = NULL;
+    list->modCount++;
+
+    return OK;
+}
+
+Status arraylist_removeRange(ArrayList *list, long from, long to, void (*destructor)(void *)) {
+
+    // Checks if the list is currently empty
+    if (IS_EMPTY(list) == TRUE) {
+        return STRUCT_EMPTY;
+    }
+    // Checks if the range is valid
+    if (from < 0L || to > list->size || from > to) {
+        return INVALID_INDEX;
+    }
+    if (from == to) {
+        return OK;
+    }
+
+    long i;
+    if (destructor != NULL) {
+        for (i = from; i < to; i++) {
+            (*destructor)(list->data[i]);
+        }
+    }
+    // Shift items once to fill the gap, then clear out the vacated slots
+    memmove(list->data + from, list->data + to, ( list->size - to ) * sizeof(void *));
+    for (i = list->size - ( to - from ); i < list->size; i++) {
+        list->data[i] = NULL;
+    }
+    list->size -= ( to - from );
+    list->modCount++;
+
+    return OK;
+}
+
+long arraylist_removeIf(ArrayList *list, Boolean (*predicate)(void *),
+                        void (*destructor)(void *)) {
+
+    long i = 0L, kept = 0L, start;
+
+    while (i < list->size) {
+        // Skips the elements to remove
+        if ((*predicate)(list->data[i]) == TRUE) {
+            if (destructor != NULL) {
+                (*destructor)(list->data[i]);
+            }
+            i++;
+            continue;
+        }
+        // Moves the following run of elements to keep down in one go
+        start = i++;
+        while (i < list->size && (*predicate)(list->data[i]) == FALSE) {
+            i++;
+        }
+        if (kept != start) {
+            memmove(list->data + kept, list->data + start, ( i - start ) * sizeof(void *));
+        }
+        kept += ( i - start );
+    }
+
+    long removed = list->size - kept;
+    if (removed != 0L) {
+        for (i = kept; i < list->size; i++) {
+            list->data[i] = NULL;
+        }
+        list->size = kept;
+        list->modCount++;
+    }
+
+    return removed;
+}
+
+// Runs no longer than this are sorted by insertion
+#define INSERTION_THRESHOLD 16L
+// Runs longer than this take their pivot from nine items instead of three
+#define NINTHER_THRESHOLD 128L
+// Parallel sorts and walks give each thread at least this many elements, smaller lists are handled
+// by the calling thread alone
+#define MIN_PARALLEL_RUN 16384L
+// The most threads a parallel sort or walk uses
+#define MAX_THREADS 64
+
+/**
+ * Sorts `items[lo..hi)` with an insertion sort, which is also stable.
+ */
+static void _insertion_sort(void **items, long lo, long hi, int (*comparator)(void *, void *)) {
+
+    long i, j;
+    void *item;
+
+    for (i = lo + 1L; i < hi; i++) {
+        item = items[i];
+        for (j = i; j > lo && (*comparator)(items[j - 1], item) > 0; j--) {
+            items[j] = items[j - 1];
+        }
+        items[j] = item;
+    }
+}
+
+/**
+ * Swaps the items at positions `i` and `j`.
+ */
+static void _swap(void **items, long i, long j) {
+
+    void *temp = items[i];
+    items[i] = items[j];
+    items[j] = temp;
+}
+
+/**
+ * Restores the max-heap order of the heap `items[lo..lo+n)` below the position `i`.
+ */
+static void _sift_down(void **items, long lo, long i, long n, int (*comparator)(void *, void *)) {
+
+    void *item = items[lo + i];
+    long child;
+
+    while ((child = ( 2L * i ) + 1L) < n) {
+        if (child + 1L < n && (*comparator)(items[lo + child], items[lo + child + 1L]) < 0) {
+            child++;
+        }
+        if ((*comparator)(item, items[lo + child]) >= 0) {
+            break;
+        }
+        items[lo + i] = items[lo + child];
+        i = child;
+    }
+    items[lo + i] = item;
+}
+
+/**
+ * Sorts `items[lo..hi)` with a heap sort, used once quicksort partitions badly too often.
+ */
+static void _heap_sort(void **items, long lo, long hi, int (*comparator)(void *, void *)) {
+
+    long n = hi - lo, i;
+
+    for (i = ( n / 2L ) - 1L; i >= 0L; i--) {
+        _sift_down(items, lo, i, n, comparator);
+    }
+    for (i = n - 1L; i > 0L; i--) {
+        _swap(items, lo, lo + i);
+        _sift_down(items, lo, 0L, i, comparator);
+    }
+}
+
+/**
+ * Returns whichever of the positions `a`, `b` and `c` holds the median of the three items.
+ */
+static long _median(void **items, long a, long b, long c, int (*comparator)(void *, void *)) {
+
+    if ((*comparator)(items[a], items[b]) < 0) {
+        if ((*comparator)(items[b], items[c]) < 0) {
+            return b;
+        }
+        return ( (*comparator)(items[a], items[c]) < 0 ) ? c : a;
+    }
+    if ((*comparator)(items[a], items[c]) < 0) {
+        return a;
+    }
+    return ( (*comparator)(items[b], items[c]) < 0 ) ? c : b;
+}
+
+/**
+ * Sorts `items[lo..hi)` with an introsort: a quicksort on the median of three (or nine), which
+ * falls back to a heap sort after `depth` levels, and leaves short runs to insertion sort.
+ */
+static void _intro_sort(void **items, long lo, long hi, int depth,
+                        int (*comparator)(void *, void *)) {
+
+    long mid, i, j;
+    void *pivot;
+
+    while (hi - lo > INSERTION_THRESHOLD) {
+        if (depth-- == 0) {
+            _heap_sort(items, lo, hi, comparator);
+            return;
+        }
+
+        // The pivot is the median of three items, or of three such medians on longer runs
+        mid = lo + ( ( hi - lo ) / 2L );
+        if (hi - lo > NINTHER_THRESHOLD) {
+            long step = ( hi - lo ) / 8L;
+            mid = _median(items, _median(items, lo, lo + step, lo + ( 2L * step ), comparator),
+                          _median(items, mid - step, mid, mid + step, comparator),
+                          _median(items, hi - 1L - ( 2L * step ), hi - 1L - step, hi - 1L,
+                                  comparator),
+                          comparator);
+        } else {
+            mid = _median(items, lo, mid, hi - 1L, comparator);
+        }
+        pivot = items[mid];
+
+        // Hoare partition, items equal to the pivot are split evenly between both sides
+        i = lo;
+        j = hi - 1L;
+        while (i <= j) {
+            while ((*comparator)(items[i], pivot) < 0) {
+                i++;
+            }
+            while ((*comparator)(items[j], pivot) > 0) {
+                j--;
+            }
+            if (i <= j) {
+                _swap(items, i, j);
+                i++;
+                j--;
+            }
+        }
+
+        // Recurses into the smaller side, so the stack stays logarithmic
+        if (j + 1L - lo < hi - i) {
+            _intro_sort(items, lo, j + 1L, depth, comparator);
+            lo = i;
+        } else {
+            _intro_sort(items, i, hi, depth, comparator);
+            hi = j + 1L;
+        }
+    }
+    _insertion_sort(items, lo, hi, comparator);
+}
+
+/**
+ * Returns the depth introsort allows before falling back, twice the logarithm of `n`.
+ */
+static int _depth_limit(long n) {
+
+    int depth = 0;
+    while (n > 1L) {
+        n >>= 1;
+        depth += 2;
+    }
+    return depth;
+}
+
+/**
+ * Merges the sorted runs `src[lo..mid)` and `src[mid..hi)` into `dest[lo..hi)`, taking from the
+ * left run on ties so that the merge is stable.
+ */
+static void _merge(void **src, void **dest, long lo, long mid, long hi,
+                   int (*comparator)(void *, void *)) {
+
+    long i = lo, j = mid, k = lo;
+
+    while (i < mid && j < hi) {
+        dest[k++] = ( (*comparator)(src[j], src[i]) < 0 ) ? src[j++] : src[i++];
+    }
+    memcpy(dest + k, src + i, ( mid - i ) * sizeof(void *));
+    memcpy(dest + k + ( mid - i ), src + j, ( hi - j ) * sizeof(void *));
+}
+
+/**
+ * Stable merge sort of `items[lo..hi)`, using `scratch` (as large as `items`) to merge into.
+ * Runs that are already in order are left as they are, so presorted input is handled in linear
+ * time.
+ */
+static void _merge_sort(void **items, void **scratch, long lo, long hi,
+                        int (*comparator)(void *, void *)) {
+
+    if (hi - lo <= INSERTION_THRESHOLD) {
+        _insertion_sort(items, lo, hi, comparator);
+        return;
+    }
+
+    long mid = lo + ( ( hi - lo ) / 2L );
+    _merge_sort(items, scratch, lo, mid, comparator);
+    _merge_sort(items, scratch, mid, hi, comparator);
+    if ((*comparator)(items[mid - 1L], items[mid]) <= 0) {
+        return;
+    }
+    memcpy(scratch + lo, items + lo, ( hi - lo ) * sizeof(void *));
+    _merge(scratch, items, lo, mid, hi, comparator);
+}
+
+Status arraylist_sort(ArrayList *list, int (*comparator)(void *, void *)) {
+
+    _intro_sort(list->data, 0L, list->size, _depth_limit(list->size), comparator);
+    list->modCount++;
+
+    return OK;
+}
+
+Status arraylist_stableSort(ArrayList *list, int (*comparator)(void *, void *)) {
+
+    if (list->size > INSERTION_THRESHOLD) {
+        void **scratch = (void **)allocator_alloc(list->allocator, list->size * sizeof(void *));
+        if (scratch == NULL) {
+            return ALLOC_FAILURE;
+        }
+        _merge_sort(list->data, scratch, 0L, list->size, comparator);
+        allocator_free(list->allocator, scratch);
+    } else {
+        _insertion_sort(list->data, 0L, list->size, comparator);
+    }
+    list->modCount++;
+
+    return OK;
+}
+
+/**
+ * One thread's share of a parallel sort: either sorting a run in place, or merging two sorted
+ * runs from `src` into `dest`.
+ */
+typedef struct {
+    void **src;                             // The items to sort, or the runs to merge
+    void **dest;                            // Where the merged runs are stored, unused to sort
+    long lo, mid, hi;                       // The bounds of the run(s) to operate on
+    int (*comparator)(void *, void *);      // Function comparing the items
+} SortTask;
+
+/**
+ * Thread routine sorting the run described by the SortTask `arg`.
+ */
+static void *_sort_task(void *arg) {
+
+    SortTask *task = (SortTask *)arg;
+    _intro_sort(task->src, task->lo, task->hi, _depth_limit(task->hi - task->lo),
+                task->comparator);
+    return NULL;
+}
+
+/**
+ * Thread routine merging the runs described by the SortTask `arg`.
+ */
+static void *_merge_task(void *arg) {
+
+    SortTask *task = (SortTask *)arg;
+    if (task->mid == task->hi) {
+        // A run without a partner this round is carried over as is
+        memcpy(task->dest + task->lo, task->src + task->lo,
+               ( task->hi - task->lo ) * sizeof(void *));
+    } else {
+        _merge(task->src, task->dest, task->lo, task->mid, task->hi, task->comparator);
+    }
+    return NULL;
+}
+
+/**
+ * Runs `routine` over each of the `n` tasks, `size` bytes apiece, the calling thread taking the
+ * last one. A task whose thread couldn't be started is run by the caller instead.
+ */
+static void _run_tasks(void *tasks, size_t size, int n, void *(*routine)(void *)) {
+
+    pthread_t threads[MAX_THREADS];
+    Boolean started[MAX_THREADS];
+    void *task;
+    int i;
+
+    for (i = 0; i < n - 1; i++) {
+        task = (char *)tasks + i * size;
+        started[i] = ( pthread_create(&threads[i], NULL, routine, task) == 0 ) ? TRUE : FALSE;
+        if (started[i] == FALSE) {
+            (void)(*routine)(task);
+        }
+    }
+    (void)(*routine)((char *)tasks + ( n - 1 ) * size);
+    for (i = 0; i < n - 1; i++) {
+        if (started[i] == TRUE) {
+            pthread_join(threads[i], NULL);
+        }
+    }
+}
+
+Status arraylist_parallelSort(ArrayList *list, int (*comparator)(void *, void *), int nthreads) {
+
+    SortTask tasks[MAX_THREADS];
+    long bounds[MAX_THREADS + 1];
+    void **src = list->data, **dest, **scratch;
+    int runs, i, j;
+
+    // Each thread is given a run worth the cost of starting it
+    if (nthreads > MAX_THREADS) {
+        nthreads = MAX_THREADS;
+    }
+    if ((long)nthreads > list->size / MIN_PARALLEL_RUN) {
+        nthreads = (int)( list->size / MIN_PARALLEL_RUN );
+    }
+    if (nthreads <= 1) {
+        return arraylist_sort(list, comparator);
+    }
+    scratch = (void **)allocator_alloc(list->allocator, list->size * sizeof(void *));
+    if (scratch == NULL) {
+        return ALLOC_FAILURE;
+    }
+
+    // Sorts an even share of the list on each thread
+    for (i = 0; i <= nthreads; i++) {
+        bounds[i] = ( list->size * i ) / nthreads;
+    }
+    for (i = 0; i < nthreads; i++) {
+        tasks[i].src = src;
+        tasks[i].lo = bounds[i];
+        tasks[i].hi = bounds[i + 1];
+        tasks[i].comparator = comparator;
+    }
+    _run_tasks(tasks, sizeof(SortTask), nthreads, _sort_task);
+
+    // Merges the runs pairwise, in parallel, back and forth between the list and the scratch
+    dest = scratch;
+    for (runs = nthreads; runs > 1; runs = ( runs + 1 ) / 2) {
+        for (i = 0, j = 0; i < runs; i += 2, j++) {
+            tasks[j].src = src;
+            tasks[j].dest = dest;
+            tasks[j].lo = bounds[i];
+            tasks[j].mid = ( i + 1 < runs ) ? bounds[i + 1] : bounds[runs];
+            tasks[j].hi = ( i + 2 < runs ) ? bounds[i + 2] : bounds[runs];
+            tasks[j].comparator = comparator;
+            bounds[j] = bounds[i];
+        }
+        bounds[j] = list->size;
+        _run_tasks(tasks, sizeof(SortTask), j, _merge_task);
+        dest = src;
+        src = tasks[0].dest;
+    }
+
+    // The merged list ends up in whichever buffer was written last
+    if (src != list->data) {
+        memcpy(list->data, src, list->size * sizeof(void *));
+    }
+    allocator_free(list->allocator, scratch);
+    list->modCount++;
+
+    return OK;
+}
+
+/**
+ * Branchless binary search over the sorted `items[0..n)`, returning the index of the first item
+ * for which comparator(item, key) >= `strict`: the lower bound of `key` when `strict` is 0, the
+ * upper bound when it is 1. Each step only narrows the range by half, without branching on the
+ * comparison, so the loop runs the same number of times wherever the key falls.
+ */
+static long _bound(void **items, long n, void *key, int (*comparator)(void *, void *),
+                   int strict) {
+
+    long base = 0L, half;
+
+    if (n == 0L) {
+        return 0L;
+    }
+    while (n > 1L) {
+        half = n / 2L;
+        base = ( (*comparator)(items[base + half], key) < strict ) ? base + half : base;
+        n -= half;
+    }
+    return base + ( ( (*comparator)(items[base], key) < strict ) ? 1L : 0L );
+}
+
+long arraylist_lowerBound(ArrayList *list, void *key, int (*comparator)(void *, void *)) {
+    return _bound(list->data, list->size, key, comparator, 0);
+}
+
+long arraylist_upperBound(ArrayList *list, void *key, int (*comparator)(void *, void *)) {
+    return _bound(list->data, list->size, key, comparator, 1);
+}
+
+Status arraylist_binarySearch(ArrayList *list, void *key, int (*comparator)(void *, void *),
+                              long *index) {
+
+    long i = _bound(list->data, list->size, key, comparator, 0);
+
+    // The lower bound is the first match, if any, and otherwise where the key would go
+    *index = i;
+    if (i == list->size || (*comparator)(list->data[i], key) != 0) {
+        return NOT_FOUND;
+    }
+
+    return OK;
+}
+
+Status arraylist_insertSorted(ArrayList *list, void *item, int (*comparator)(void *, void *)) {
+    // Inserting after any equal items keeps them in insertion order
+    return arraylist_insert(list, _bound(list->data, list->size, item, comparator, 1), item);
+}
+
+// Number of item pointers in a cache line, the search prefetches this many levels below
+#define EYTZINGER_BLOCK ( 64L / (long)sizeof(void *) )
+
+/**
+ * Lays out the sorted `sorted[i..]` into the subtree at position `k` of the Eytzinger array
+ * `layout[1..n]`, where the children of position k are at 2k and 2k + 1. Returns the index of the
+ * next item of `sorted` to place.
+ */
+static long _eytzinger(void **sorted, void **layout, long i, long k, long n) {
+
+    if (k <= n) {
+        i = _eytzinger(sorted, layout, i, 2L * k, n);
+        layout[k] = sorted[i++];
+        i = _eytzinger(sorted, layout, i, ( 2L * k ) + 1L, n);
+    }
+    return i;
+}
+
+Status frozenarray_new(FrozenArray **frozen, ArrayList *list,
+                       int (*comparator)(void *, void *)) {
+
+    // The struct and its items are allocated together
+    size_t bytes = sizeof(FrozenArray) + ( ( list->size + 1L ) * sizeof(void *) );
+    FrozenArray *temp = (FrozenArray *)malloc(bytes);
+    void **sorted;
+
+    if (temp == NULL) {
+        return ALLOC_FAILURE;
+    }
+    if ((sorted = (void **)malloc(( list->size + 1L ) * sizeof(void *))) == NULL) {
+        free(temp);
+        return ALLOC_FAILURE;
+    }
+    memcpy(sorted, list->data, list->size * sizeof(void *));
+
+    // Sorts a copy of the list, then lays it out level by level as an implicit search tree
+    temp->items = (void **)(temp + 1);
+    temp->items[0] = NULL;
+    temp->size = list->size;
+    temp->comparator = comparator;
+    _intro_sort(sorted, 0L, list->size, _depth_limit(list->size), comparator);
+    (void)_eytzinger(sorted, temp->items, 0L, 1L, list->size);
+    free(sorted);
+    *frozen = temp;
+
+    return OK;
+}
+
+Status frozenarray_get(FrozenArray *frozen, void *key, void **item) {
+
+    void **items = frozen->items;
+    long n = frozen->size, k = 1L;
+
+    // Descends the implicit tree without branching, fetching the cache line a few levels down
+    while (k <= n) {
+        __builtin_prefetch(items + ( ( k * EYTZINGER_BLOCK <= n ) ? k * EYTZINGER_BLOCK : 0L ));
+        k = ( 2L * k ) + ( ( (*(frozen->comparator))(items[k], key) < 0 ) ? 1L : 0L );
+    }
+    // Backs out of the trailing right turns, landing on the lower bound of the key (if any)
+    k >>= __builtin_ffsl(~k);
+
+    if (k == 0L || (*(frozen->comparator))(items[k], key) != 0) {
+        return NOT_FOUND;
     }
-    list->data[list->size--] = NULL;
+    *item = items[k];
 
     return OK;
 }
 
+Boolean frozenarray_contains(FrozenArray *frozen, void *key) {
+
+    void *item;
+    return ( frozenarray_get(frozen, key, &item) == OK ) ? TRUE : FALSE;
+}
+
+long frozenarray_size(FrozenArray *frozen) {
+    return frozen->size;
+}
+
+void frozenarray_destroy(FrozenArray *frozen) {
+    free(frozen);
+}
+
+void arraylist_setGrowthFactor(ArrayList *list, float growthFactor) {
+    list->growthFactor = ( 0.0f < growthFactor ) && ( growthFactor <= 1.0f ) ?
+                         growthFactor : DEFAULT_GROWTH_FACTOR;
+}
+
 Status arraylist_ensureCapacity(ArrayList *list, long capacity) {
 
     // Only extend if capacity < newCapacity
     if (list->capacity < capacity) {
-        if (_ensure_capacity(list, capacity) == FALSE) {
+        if (capacity > MAX_CAPACITY || _ensure_capacity(list, capacity) == FALSE) {
             return ALLOC_FAILURE;
         }
     }
@@ -243,6 +904,7 @@ static void _clear_list(ArrayList *list, void (*destructor)(void *)) {
 void arraylist_clear(ArrayList *list, void (*destructor)(void *)) {
     _clear_list(list, destructor);
     list->size = 0L;
+    list->modCount++;
 }
 
 long arraylist_size(ArrayList *list) {
@@ -336,8 +998,159 @@ Status arraylist_iterator(ArrayList *list, Iterator **iter) {
     return OK;
 }
 
+void arraylist_cursor(ArrayList *list, Cursor *cursor) {
+    cursor->adt = list;
+    cursor->node = NULL;
+    cursor->index = 0L;
+    cursor->remaining = list->size;
+    cursor->modCount = list->modCount;
+}
+
+Status arraylist_cursorNext(Cursor *cursor, void **next) {
+
+    ArrayList *list = (ArrayList *)cursor->adt;
+
+    // Fails fast if the arraylist was modified since creating the cursor
+    if (list->modCount != cursor->modCount) {
+        return CONCURRENT_MODIFICATION;
+    }
+    // Checks if every element was visited
+    if (cursor->remaining == 0L) {
+        return ITER_END;
+    }
+
+    // Fetches the item, advances to the next index
+    *next = list->data[cursor->index];
+    cursor->index = cursor->index + 1L;
+    cursor->remaining--;
+
+    return OK;
+}
+
+Boolean arraylist_forEach(ArrayList *list, Boolean (*action)(void *, void *), void *context) {
+
+    long i;
+
+    for (i = 0L; i < list->size; i++) {
+        if ((*action)(list->data[i], context) == FALSE) {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+/**
+ * One thread's share of a parallel walk: the elements `items[lo..hi)`, either handed to `action`
+ * or folded into `partial` through `reducer`.
+ */
+typedef struct {
+    void **items;                               // The list's elements
+    long lo, hi;                                // The bounds of the share to walk
+    Boolean (*action)(void *, void *);          // Function applied to each element, or NULL
+    void *(*reducer)(void *, void *, void *);   // Function folding each element, or NULL
+    void *context;                              // Argument passed along to each call
+    void *partial;                              // The share's folded result
+    int *stop;                                  // Raised once any action asks the walk to stop
+} WalkTask;
+
+/**
+ * Thread routine walking the share of the list described by the WalkTask `arg`.
+ */
+static void *_walk_task(void *arg) {
+
+    WalkTask *task = (WalkTask *)arg;
+    long i;
+
+    if (task->reducer != NULL) {
+        for (i = task->lo; i < task->hi; i++) {
+            task->partial = (*task->reducer)(task->partial, task->items[i], task->context);
+        }
+        return NULL;
+    }
+    for (i = task->lo; i < task->hi && __atomic_load_n(task->stop, __ATOMIC_RELAXED) == 0; i++) {
+        if ((*task->action)(task->items[i], task->context) == FALSE) {
+            __atomic_store_n(task->stop, 1, __ATOMIC_RELAXED);
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * Splits the list into even shares, one per thread (bounded as for arraylist_parallelSort()), and
+ * walks each share with `action` or `reducer`. Returns the number of shares, now filled in `tasks`.
+ */
+static int _parallel_walk(ArrayList *list, int nthreads, Boolean (*action)(void *, void *),
+                          void *(*reducer)(void *, void *, void *), void *context, int *stop,
+                          WalkTask *tasks) {
+
+    int i;
+
+    if (nthreads > MAX_THREADS) {
+        nthreads = MAX_THREADS;
+    }
+    if ((long)nthreads > list->size / MIN_PARALLEL_RUN) {
+        nthreads = (int)( list->size / MIN_PARALLEL_RUN );
+    }
+    if (nthreads < 1) {
+        nthreads = 1;
+    }
+
+    for (i = 0; i < nthreads; i++) {
+        tasks[i].items = list->data;
+        tasks[i].lo = ( list->size * i ) / nthreads;
+        tasks[i].hi = ( list->size * ( i + 1 ) ) / nthreads;
+        tasks[i].action = action;
+        tasks[i].reducer = reducer;
+        tasks[i].context = context;
+        tasks[i].partial = NULL;
+        tasks[i].stop = stop;
+    }
+    _run_tasks(tasks, sizeof(WalkTask), nthreads, _walk_task);
+
+    return nthreads;
+}
+
+Boolean arraylist_parallelForEach(ArrayList *list, int nthreads, Boolean (*action)(void *, void *),
+                                  void *context) {
+
+    WalkTask tasks[MAX_THREADS];
+    int stop = 0;
+
+    (void)_parallel_walk(list, nthreads, action, NULL, context, &stop, tasks);
+
+    return ( stop == 0 ) ? TRUE : FALSE;
+}
+
+void *arraylist_parallelReduce(ArrayList *list, int nthreads,
+                               void *(*reducer)(void *, void *, void *),
+                               void *(*combiner)(void *, void *, void *), void *context) {
+
+    WalkTask tasks[MAX_THREADS];
+    void *result;
+    int n, i, stop = 0;
+
+    // Combines the shares' results in list order; every share holds at least one element
+    if (list->size == 0L) {
+        return NULL;
+    }
+    n = _parallel_walk(list, nthreads, NULL, reducer, context, &stop, tasks);
+    result = tasks[0].partial;
+    for (i = 1; i < n; i++) {
+        result = (*combiner)(result, tasks[i].partial, context);
+    }
+
+    return result;
+}
+
+long arraylist_memoryUsage(ArrayList *list) {
+
+    return (long)( sizeof(ArrayList) + ( list->capacity * sizeof(void *) ) );
+}
+
 void arraylist_destroy(ArrayList *list, void (*destructor)(void *)) {
     _clear_list(list, destructor);
-    free(list->data);
-    free(list);
+    allocator_free(list->allocator, list->data);
+    allocator_free(list->allocator, list);
 }
@@ -0,0 +1,210 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2020 Cole Vikupitz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#include "bloom_filter.h"
+#include "hashing.h"
+
+#define CACHE_LINE 64
+// Number of 32-bit words in a block, each of which gets one bit per element
+#define BLOCK_WORDS 8
+// Default number of elements and false positive rate to size the filter for
+#define DEFAULT_EXPECTED 1024L
+#define DEFAULT_FPP 0.01
+
+/**
+ * A block of the filter: 256 bits, one of them set in each word per element added.
+ */
+typedef struct {
+    uint32_t words[BLOCK_WORDS];
+} Block;
+
+/**
+ * Struct for the BloomFilter ADT.
+ */
+struct bloom_filter {
+    uint64_t (*hash)(void *, uint64_t); // Function for computing the elements' hash codes
+    uint64_t seed;                      // The seed passed to `hash`
+    Block *blocks;                      // The filter's blocks, aligned to a cache line
+    long nblocks;                       // Number of blocks
+};
+
+// Odd multipliers picking each word's bit out of the low half of a hash code
+static const uint32_t SALTS[BLOCK_WORDS] = {
+    0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+    0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U
+};
+
+// False positive rate of a filter given 4, 6, ..., 32 bits per element, accounting for the uneven
+// spread of the elements over the blocks
+static const double RATES[] = {
+    3.26e-1, 9.93e-2, 3.32e-2, 1.26e-2, 5.42e-3, 2.56e-3, 1.32e-3, 7.23e-4, 4.20e-4, 2.56e-4,
+    1.63e-4, 1.07e-4, 7.27e-5, 5.06e-5, 3.61e-5
+};
+#define NRATES ( (long)( sizeof(RATES) / sizeof(RATES[0]) ) )
+
+/**
+ * Allocates a filter with `nblocks` blocks, all of them cleared. Returns NULL if allocation fails.
+ */
+static BloomFilter *_new_filter(uint64_t (*hash)(void *, uint64_t), uint64_t seed, long nblocks) {
+
+    BloomFilter *temp = (BloomFilter *)malloc(sizeof(BloomFilter));
+
+    if (temp == NULL) {
+        return NULL;
+    }
+    if (posix_memalign((void **)&temp->blocks, CACHE_LINE, nblocks * sizeof(Block)) != 0) {
+        free(temp);
+        return NULL;
+    }
+    memset(temp->blocks, 0, nblocks * sizeof(Block));
+    temp->hash = hash;
+    temp->seed = seed;
+    temp->nblocks = nblocks;
+
+    return temp;
+}
+
+Status bloomfilter_new(BloomFilter **filter, uint64_t (*hash)(void *, uint64_t), long expected,
+                       double fpp) {
+
+    BloomFilter *temp;
+    long bits, i;
+
+    expected = ( expected > 0L ) ? expected : DEFAULT_EXPECTED;
+    fpp = ( fpp > 0.0 && fpp < 1.0 ) ? fpp : DEFAULT_FPP;
+
+    // Takes the fewest bits per element reaching the rate, up to 32
+    for (i = 0L; i < NRATES - 1L && RATES[i] > fpp; i++)
+        ;
+    bits = 4L + 2L * i;
+    temp = _new_filter(hash, hashing_seed(),
+                       ( expected * bits + 8L * (long)sizeof(Block) - 1L ) / (8L * sizeof(Block)));
+    if (temp == NULL) {
+        return ALLOC_FAILURE;
+    }
+    *filter = temp;
+
+    return OK;
+}
+
+Status bloomfilter_newLike(BloomFilter **filter, BloomFilter *other) {
+
+    BloomFilter *temp = _new_filter(other->hash, other->seed, other->nblocks);
+
+    if (temp == NULL) {
+        return ALLOC_FAILURE;
+    }
+    *filter = temp;
+
+    return OK;
+}
+
+/**
+ * Hashes the element `item`, returning the block it maps to and storing the bit it sets in each of
+ * the block's words into `mask`.
+ */
+static Block *_probe(BloomFilter *filter, void *item, uint32_t *mask) {
+
+    uint64_t code = hashing_mix64(filter->hash(item, filter->seed));
+    uint32_t key = (uint32_t)code;
+    int i;
+
+    for (i = 0; i < BLOCK_WORDS; i++) {
+        mask[i] = 1U << ( ( key * SALTS[i] ) >> 27 );
+    }
+    // Maps the high half onto the blocks with a multiply rather than a division
+    return &(filter->blocks[( ( code >> 32 ) * (uint64_t)filter->nblocks ) >> 32]);
+}
+
+void bloomfilter_add(BloomFilter *filter, void *item) {
+
+    uint32_t mask[BLOCK_WORDS];
+    Block *block = _probe(filter, item, mask);
+    int i;
+
+    for (i = 0; i < BLOCK_WORDS; i++) {
+        block->words[i] |= mask[i];
+    }
+}
+
+Boolean bloomfilter_mightContain(BloomFilter *filter, void *item) {
+
+    uint32_t mask[BLOCK_WORDS];
+    Block *block = _probe(filter, item, mask);
+
+#if defined(__SSE2__)
+    // Tests the two halves of the block against the mask at once
+    __m128i lo = _mm_load_si128((const __m128i *)&(block->words[0]));
+    __m128i hi = _mm_load_si128((const __m128i *)&(block->words[4]));
+    __m128i maskLo = _mm_loadu_si128((const __m128i *)&(mask[0]));
+    __m128i maskHi = _mm_loadu_si128((const __m128i *)&(mask[4]));
+    lo = _mm_cmpeq_epi32(_mm_and_si128(lo, maskLo), maskLo);
+    hi = _mm_cmpeq_epi32(_mm_and_si128(hi, maskHi), maskHi);
+    return ( _mm_movemask_epi8(_mm_and_si128(lo, hi)) == 0xFFFF ) ? TRUE : FALSE;
+#else
+    int i;
+
+    for (i = 0; i < BLOCK_WORDS; i++) {
+        if ((block->words[i] & mask[i]) == 0U) {
+            return FALSE;
+        }
+    }
+    return TRUE;
+#endif
+}
+
+Boolean bloomfilter_merge(BloomFilter *filter, BloomFilter *other) {
+
+    uint32_t *into = (uint32_t *)filter->blocks, *from = (uint32_t *)other->blocks;
+    long i;
+
+    if (filter->hash != other->hash || filter->seed != other->seed ||
+            filter->nblocks != other->nblocks) {
+        return FALSE;
+    }
+    for (i = 0L; i < filter->nblocks * BLOCK_WORDS; i++) {
+        into[i] |= from[i];
+    }
+
+    return TRUE;
+}
+
+void bloomfilter_clear(BloomFilter *filter) {
+    memset(filter->blocks, 0, filter->nblocks * sizeof(Block));
+}
+
+long bloomfilter_memoryUsage(BloomFilter *filter) {
+    return (long)( sizeof(BloomFilter) + filter->nblocks * sizeof(Block) );
+}
+
+void bloomfilter_destroy(BloomFilter *filter) {
+    free(filter->blocks);
+    free(filter);
+}
@@ -32,16 +32,23 @@ struct bounded_queue {
     void **data;        // Array of the queue's elements
     long front;         // Index of the queue's front element
     long size;          // The queue's current size
+    long modCount;      // Number of structural modifications made
     long capacity;      // The queue's capacity
+    const CdsAllocator *allocator;  // Allocates the struct and the array
 };
 
 // The default capacity to assign when the capacity give is invalid
 #define DEFAULT_CAPACITY 16L
 
-Status boundedqueue_new(BoundedQueue **queue, long capacity) {
+Status boundedqueue_newWithAllocator(BoundedQueue **queue, long capacity,
+                                     const CdsAllocator *allocator) {
+
+    if (allocator == NULL) {
+        allocator = allocator_default();
+    }
 
     // Allocate the struct, check for allocation failures
-    BoundedQueue *temp = (BoundedQueue *)malloc(sizeof(BoundedQueue));
+    BoundedQueue *temp = (BoundedQueue *)allocator_alloc(allocator, sizeof(BoundedQueue));
     if (temp == NULL) {
         return ALLOC_FAILURE;
     }
@@ -49,11 +56,11 @@ Status boundedqueue_new(BoundedQueue **queue, long capacity) {
     // Sets up capacity, sets up reminaing struct members
     long cap = ( capacity <= 0L ) ? DEFAULT_CAPACITY : capacity;
     size_t bytes = (cap * sizeof(void *));
-    void **array = (void **)malloc(bytes);
+    void **array = (void **)allocator_alloc(allocator, bytes);
 
     // Checks for allocation failures
     if (array == NULL) {
-        free(temp);
+        allocator_free(allocator, temp);
         return ALLOC_FAILURE;
     }
 
@@ -65,12 +72,18 @@ Status boundedqueue_new(BoundedQueue **queue, long capacity) {
     temp->data = array;
     temp->front = 0L;
     temp->size = 0L;
+    temp->modCount = 0L;
     temp->capacity = cap;
+    temp->allocator = allocator;
     *queue = temp;
 
     return OK;
 }
 
+Status boundedqueue_new(BoundedQueue **queue, long capacity) {
+    return boundedqueue_newWithAllocator(queue, capacity, NULL);
+}
+
 // Macro to check if the queue `q` is currently empty
 #define IS_EMPTY(q) ( ((q)->size == 0L) ? TRUE : FALSE )
 // Macro to check if the queue `q` is currently full
@@ -87,6 +100,7 @@ Status boundedqueue_add(BoundedQueue *queue, void *item) {
     long index = ( queue->front + queue->size ) % queue->capacity;
     queue->data[index] = item;
     queue->size++;
+    queue->modCount++;
 
     return OK;
 }
@@ -116,6 +130,7 @@ Status boundedqueue_poll(BoundedQueue *queue, void **front) {
     queue->data[queue->front] = NULL;
     queue->front = (queue->front + 1) % queue->capacity;
     queue->size--;
+    queue->modCount++;
 
     return OK;
 }
@@ -139,6 +154,7 @@ void boundedqueue_clear(BoundedQueue *queue, void (*destructor)(void *)) {
     _clear_queue(queue, destructor);
     queue->front = 0L;
     queue->size = 0L;
+    queue->modCount++;
 }
 
 long boundedqueue_size(BoundedQueue *queue) {
@@ -236,8 +252,59 @@ Status boundedqueue_iterator(BoundedQueue *queue, Iterator **iter) {
     return OK;
 }
 
+void boundedqueue_cursor(BoundedQueue *queue, Cursor *cursor) {
+    cursor->adt = queue;
+    cursor->node = NULL;
+    cursor->index = queue->front;
+    cursor->remaining = queue->size;
+    cursor->modCount = queue->modCount;
+}
+
+Status boundedqueue_cursorNext(Cursor *cursor, void **next) {
+
+    BoundedQueue *queue = (BoundedQueue *)cursor->adt;
+
+    // Fails fast if the queue was modified since creating the cursor
+    if (queue->modCount != cursor->modCount) {
+        return CONCURRENT_MODIFICATION;
+    }
+    // Checks if every element was visited
+    if (cursor->remaining == 0L) {
+        return ITER_END;
+    }
+
+    // Fetches the item, advances to the next index, wrapping around
+    *next = queue->data[cursor->index];
+    cursor->index = ( cursor->index + 1L ) % queue->capacity;
+    cursor->remaining--;
+
+    return OK;
+}
+
+Boolean boundedqueue_forEach(BoundedQueue *queue, Boolean (*action)(void *, void *), void *context) {
+
+    long i, index = queue->front;
+
+    for (i = 0L; i < queue->size; i++) {
+        if ((*action)(queue->data[index], context) == FALSE) {
+            return FALSE;
+        }
+        // Wraps around to the start of the array without a division
+        if (++index == queue->capacity) {
+            index = 0L;
+        }
+    }
+
+    return TRUE;
+}
+
+long boundedqueue_memoryUsage(BoundedQueue *queue) {
+
+    return (long)( sizeof(BoundedQueue) + ( queue->capacity * sizeof(void *) ) );
+}
+
 void boundedqueue_destroy(BoundedQueue *queue, void (*destructor)(void *)) {
     _clear_queue(queue, destructor);
-    free(queue->data);
-    free(queue);
+    allocator_free(queue->allocator, queue->data);
+    allocator_free(queue->allocator, queue);
 }
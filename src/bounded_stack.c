@@ -31,16 +31,23 @@
 struct bounded_stack {
     void **data;        // Array of the stack's elements
     long size;          // The stack's current size
+    long modCount;      // Number of structural modifications made
     long capacity;      // The stack's capacity
+    const CdsAllocator *allocator;  // Allocates the struct and the array
 };
 
 // The default capacity to assign when the capacity given is invalid
 #define DEFAULT_CAPACITY 16L
 
-Status boundedstack_new(BoundedStack **stack, long capacity) {
+Status boundedstack_newWithAllocator(BoundedStack **stack, long capacity,
+                                     const CdsAllocator *allocator) {
+
+    if (allocator == NULL) {
+        allocator = allocator_default();
+    }
 
     // Allocate the struct, check for allocation failures
-    BoundedStack *temp = (BoundedStack *)malloc(sizeof(BoundedStack));
+    BoundedStack *temp = (BoundedStack *)allocator_alloc(allocator, sizeof(BoundedStack));
     if (temp == NULL) {
         return ALLOC_FAILURE;
     }
@@ -48,11 +55,11 @@ Status boundedstack_new(BoundedStack **stack, long capacity) {
     // Initialize capacity, sets up remaining structure members
     long cap = ( capacity <= 0L ) ? DEFAULT_CAPACITY : capacity;
     size_t bytes = (cap * sizeof(void *));
-    void **array = (void **)malloc(bytes);
+    void **array = (void **)allocator_alloc(allocator, bytes);
 
     // Check for allocation failures
     if (array == NULL) {
-        free(temp);
+        allocator_free(allocator, temp);
         return ALLOC_FAILURE;
     }
 
@@ -63,12 +70,18 @@ Status boundedstack_new(BoundedStack **stack, long capacity) {
     }
     temp->data = array;
     temp->size = 0L;
+    temp->modCount = 0L;
     temp->capacity = cap;
+    temp->allocator = allocator;
     *stack = temp;
 
     return OK;
 }
 
+Status boundedstack_new(BoundedStack **stack, long capacity) {
+    return boundedstack_newWithAllocator(stack, capacity, NULL);
+}
+
 // Macro to check if the stack `s` is currently empty
 #define IS_EMPTY(s) ( ((s)->size == 0L) ? TRUE : FALSE )
 // Macro to check if the stack `s` is currently full
@@ -82,6 +95,7 @@ Status boundedstack_push(BoundedStack *stack, void *item) {
     }
     // Inserts item into the stack
     stack->data[stack->size++] = item;
+    stack->modCount++;
 
     return OK;
 }
@@ -107,6 +121,7 @@ Status boundedstack_pop(BoundedStack *stack, void **top) {
     // Removes the item, saves into pointer
     *top = stack->data[stack->size - 1];
     stack->data[--stack->size] = NULL;
+    stack->modCount++;
 
     return OK;
 }
@@ -129,6 +144,7 @@ static void _clear_stack(BoundedStack *stack, void (*destructor)(void *)) {
 void boundedstack_clear(BoundedStack *stack, void (*destructor)(void *)) {
     _clear_stack(stack, destructor);
     stack->size = 0L;
+    stack->modCount++;
 }
 
 long boundedstack_size(BoundedStack *stack) {
@@ -226,8 +242,55 @@ Status boundedstack_iterator(BoundedStack *stack, Iterator **iter) {
     return OK;
 }
 
+void boundedstack_cursor(BoundedStack *stack, Cursor *cursor) {
+    cursor->adt = stack;
+    cursor->node = NULL;
+    cursor->index = stack->size - 1L;
+    cursor->remaining = stack->size;
+    cursor->modCount = stack->modCount;
+}
+
+Status boundedstack_cursorNext(Cursor *cursor, void **next) {
+
+    BoundedStack *stack = (BoundedStack *)cursor->adt;
+
+    // Fails fast if the stack was modified since creating the cursor
+    if (stack->modCount != cursor->modCount) {
+        return CONCURRENT_MODIFICATION;
+    }
+    // Checks if every element was visited
+    if (cursor->remaining == 0L) {
+        return ITER_END;
+    }
+
+    // Fetches the item, advances down to the next index
+    *next = stack->data[cursor->index];
+    cursor->index = cursor->index - 1L;
+    cursor->remaining--;
+
+    return OK;
+}
+
+Boolean boundedstack_forEach(BoundedStack *stack, Boolean (*action)(void *, void *), void *context) {
+
+    long i;
+
+    for (i = stack->size - 1L; i >= 0L; i--) {
+        if ((*action)(stack->data[i], context) == FALSE) {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+long boundedstack_memoryUsage(BoundedStack *stack) {
+
+    return (long)( sizeof(BoundedStack) + ( stack->capacity * sizeof(void *) ) );
+}
+
 void boundedstack_destroy(BoundedStack *stack, void (*destructor)(void *)) {
     _clear_stack(stack, destructor);
-    free(stack->data);
-    free(stack);
+    allocator_free(stack->allocator, stack->data);
+    allocator_free(stack->allocator, stack);
 }
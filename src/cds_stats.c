@@ -0,0 +1,309 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2020 Cole Vikupitz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "cds_stats.h"
+
+// Number of bits of each duration kept by the histograms, and the number of buckets they need
+#define SUB_BITS 3
+#define BUCKETS (64 << SUB_BITS)
+
+/**
+ * The histograms of a thread. Only the owning thread writes to them, with relaxed atomic stores so
+ * that other threads may read them at any time. The block of an exited thread is handed over to
+ * the next thread needing one, keeping its durations.
+ */
+typedef struct thread_stats {
+    long counts[CDS_PROBES][BUCKETS];   // Number of durations recorded into each bucket
+    uint64_t sums[CDS_PROBES];          // Total of the durations, in ticks
+    uint64_t maxes[CDS_PROBES];         // Longest duration, in ticks
+    int inUse;                          // TRUE while a thread owns the block
+    struct thread_stats *next;          // The next block in the registry
+} ThreadStats;
+
+// Names of the probes, as printed by cds_stats_dump()
+static const char *names[CDS_PROBES] = {
+    "hashmap_put", "hashmap_get", "treemap_put", "treemap_get", "heap_insert", "heap_poll",
+    "queue_poll", "arraylist_insert", "hashmap_resize", "treemap_rebalance", "arraylist_grow",
+    "heap_grow"
+};
+
+// Registry of every thread's block, guarded by the lock
+static pthread_mutex_t registryLock = PTHREAD_MUTEX_INITIALIZER;
+static ThreadStats *registry = NULL;
+
+// Releases a thread's block on its exit
+static pthread_key_t exitKey;
+static pthread_once_t exitKeyOnce = PTHREAD_ONCE_INIT;
+
+// The block of the calling thread
+static __thread ThreadStats *local = NULL;
+
+// Readings of both clocks when the first block was created, to convert ticks into nanoseconds
+static uint64_t originTicks = 0UL;
+static uint64_t originNanos = 0UL;
+
+uint64_t cds_stats_clock(void) {
+
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ( (uint64_t)ts.tv_sec * 1000000000UL ) + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * Hands the block of an exiting thread back to the registry.
+ */
+static void _release(void *block) {
+    __atomic_store_n(&(((ThreadStats *)block)->inUse), 0, __ATOMIC_RELEASE);
+}
+
+static void _create_exit_key(void) {
+    (void)pthread_key_create(&exitKey, _release);
+}
+
+/**
+ * Returns the block of the calling thread, claiming a released one or creating one on its first
+ * call. Returns NULL if a block could not be allocated.
+ */
+static ThreadStats *_local_block(void) {
+
+    ThreadStats *block;
+
+    if (local != NULL) {
+        return local;
+    }
+    pthread_once(&exitKeyOnce, _create_exit_key);
+
+    pthread_mutex_lock(&registryLock);
+    for (block = registry; block != NULL; block = block->next) {
+        if (__atomic_load_n(&(block->inUse), __ATOMIC_ACQUIRE) == 0) {
+            break;
+        }
+    }
+    if (block == NULL && (block = (ThreadStats *)calloc(1, sizeof(ThreadStats))) != NULL) {
+        if (registry == NULL) {
+            originTicks = CDS_STATS_TICKS();
+            originNanos = cds_stats_clock();
+        }
+        block->next = registry;
+        __atomic_store_n(&registry, block, __ATOMIC_RELEASE);
+    }
+    if (block != NULL) {
+        __atomic_store_n(&(block->inUse), 1, __ATOMIC_RELAXED);
+    }
+    pthread_mutex_unlock(&registryLock);
+
+    if (block != NULL) {
+        (void)pthread_setspecific(exitKey, block);
+    }
+    local = block;
+    return block;
+}
+
+/**
+ * Returns the bucket the duration falls into.
+ */
+static long _bucket(uint64_t ticks) {
+
+    int magnitude;
+
+    if (ticks < (1UL << SUB_BITS)) {
+        return (long)ticks;
+    }
+    // Keep the leading bits of the duration, below its magnitude
+    magnitude = 63 - __builtin_clzl(ticks);
+    return ((long)(magnitude - SUB_BITS + 1) << SUB_BITS) +
+           (long)((ticks >> (magnitude - SUB_BITS)) & ((1UL << SUB_BITS) - 1UL));
+}
+
+/**
+ * Returns the longest duration that falls into the bucket.
+ */
+static uint64_t _highest(long bucket) {
+
+    long shift;
+    uint64_t sub;
+
+    if (bucket < (1L << SUB_BITS)) {
+        return (uint64_t)bucket;
+    }
+    shift = (bucket >> SUB_BITS) - 1L;
+    sub = (uint64_t)bucket & ((1UL << SUB_BITS) - 1UL);
+    return (((1UL << SUB_BITS) + sub + 1UL) << shift) - 1UL;
+}
+
+void cds_stats_record(CdsProbe probe, uint64_t ticks) {
+
+    ThreadStats *block = _local_block();
+    long *count;
+
+    if (block == NULL || (int)probe < 0 || (int)probe >= (int)CDS_PROBES) {
+        return;
+    }
+    // The owning thread is the only writer, so increments need no atomic read-modify-writes
+    count = &(block->counts[probe][_bucket(ticks)]);
+    __atomic_store_n(count, __atomic_load_n(count, __ATOMIC_RELAXED) + 1L, __ATOMIC_RELAXED);
+    __atomic_store_n(&(block->sums[probe]),
+                     __atomic_load_n(&(block->sums[probe]), __ATOMIC_RELAXED) + ticks,
+                     __ATOMIC_RELAXED);
+    if (ticks > __atomic_load_n(&(block->maxes[probe]), __ATOMIC_RELAXED)) {
+        __atomic_store_n(&(block->maxes[probe]), ticks, __ATOMIC_RELAXED);
+    }
+}
+
+/**
+ * Returns the number of nanoseconds per tick of the time source, measured against the monotonic
+ * clock since the first block was created, or over a short spin if that was too recent.
+ */
+static double _nanos_per_tick(void) {
+
+#if defined(__x86_64__) || defined(__i386__)
+    uint64_t ticks, nanos, startTicks = originTicks, startNanos = originNanos;
+
+    if (cds_stats_clock() - startNanos < 10000000UL) {
+        startTicks = CDS_STATS_TICKS();
+        startNanos = cds_stats_clock();
+        while (cds_stats_clock() - startNanos < 10000000UL)
+            ;
+    }
+    ticks = CDS_STATS_TICKS() - startTicks;
+    nanos = cds_stats_clock() - startNanos;
+    return ( ticks == 0UL ) ? 1.0 : ( (double)nanos / (double)ticks );
+#else
+    return 1.0;
+#endif
+}
+
+/**
+ * Fills in the summary of the probe, converting ticks with `scale` nanoseconds per tick.
+ */
+static void _summarize(CdsProbe probe, double scale, CdsOpStats *stats) {
+
+    ThreadStats *block;
+    long counts[BUCKETS];
+    uint64_t sum = 0UL, max = 0UL;
+    long i, seen, ranks[4], *percentiles[4];
+    const double pcts[4] = { 0.50, 0.90, 0.99, 0.999 };
+    int p;
+
+    memset(stats, 0, sizeof(CdsOpStats));
+    memset(counts, 0, sizeof(counts));
+    for (block = __atomic_load_n(&registry, __ATOMIC_ACQUIRE); block != NULL;
+            block = block->next) {
+        for (i = 0L; i < BUCKETS; i++) {
+            long n = __atomic_load_n(&(block->counts[probe][i]), __ATOMIC_RELAXED);
+            counts[i] += n;
+            stats->count += n;
+        }
+        sum += __atomic_load_n(&(block->sums[probe]), __ATOMIC_RELAXED);
+        uint64_t blockMax = __atomic_load_n(&(block->maxes[probe]), __ATOMIC_RELAXED);
+        max = ( blockMax > max ) ? blockMax : max;
+    }
+    if (stats->count == 0L) {
+        return;
+    }
+
+    // Each percentile is the longest duration of the bucket holding its rank
+    percentiles[0] = &(stats->p50Nanos);
+    percentiles[1] = &(stats->p90Nanos);
+    percentiles[2] = &(stats->p99Nanos);
+    percentiles[3] = &(stats->p999Nanos);
+    for (p = 0; p < 4; p++) {
+        ranks[p] = (long)(pcts[p] * (double)stats->count + 0.999999);
+        ranks[p] = ( ranks[p] < 1L ) ? 1L : ranks[p];
+    }
+    for (i = 0L, seen = 0L, p = 0; i < BUCKETS && p < 4; i++) {
+        seen += counts[i];
+        while (p < 4 && seen >= ranks[p]) {
+            uint64_t highest = ( _highest(i) < max ) ? _highest(i) : max;
+            *(percentiles[p++]) = (long)((double)highest * scale);
+        }
+    }
+    stats->meanNanos = (double)sum * scale / (double)stats->count;
+    stats->maxNanos = (long)((double)max * scale);
+}
+
+void cds_stats_get(CdsProbe probe, CdsOpStats *stats) {
+
+    if ((int)probe < 0 || (int)probe >= (int)CDS_PROBES) {
+        memset(stats, 0, sizeof(CdsOpStats));
+        return;
+    }
+    pthread_mutex_lock(&registryLock);
+    _summarize(probe, _nanos_per_tick(), stats);
+    pthread_mutex_unlock(&registryLock);
+}
+
+void cds_stats_dump(FILE *out) {
+
+    CdsOpStats stats;
+    double scale;
+    int probe, printed = 0;
+
+    pthread_mutex_lock(&registryLock);
+    scale = _nanos_per_tick();
+    for (probe = 0; probe < CDS_PROBES; probe++) {
+        _summarize((CdsProbe)probe, scale, &stats);
+        if (stats.count == 0L) {
+            continue;
+        }
+        fprintf(out, "%-18s count=%-10ld mean=%-9.1f p50=%-8ld p90=%-8ld p99=%-8ld p999=%-8ld "
+                "max=%ld (ns)\n", names[probe], stats.count, stats.meanNanos, stats.p50Nanos,
+                stats.p90Nanos, stats.p99Nanos, stats.p999Nanos, stats.maxNanos);
+        printed = 1;
+    }
+    pthread_mutex_unlock(&registryLock);
+
+    if (printed == 0) {
+#ifdef CDS_OP_STATS
+        fprintf(out, "No operations recorded\n");
+#else
+        fprintf(out, "No operations recorded, the library must be compiled with CDS_OP_STATS\n");
+#endif
+    }
+    fflush(out);
+}
+
+void cds_stats_reset(void) {
+
+    ThreadStats *block;
+    long i;
+    int probe;
+
+    pthread_mutex_lock(&registryLock);
+    for (block = registry; block != NULL; block = block->next) {
+        for (probe = 0; probe < CDS_PROBES; probe++) {
+            for (i = 0L; i < BUCKETS; i++) {
+                __atomic_store_n(&(block->counts[probe][i]), 0L, __ATOMIC_RELAXED);
+            }
+            __atomic_store_n(&(block->sums[probe]), 0UL, __ATOMIC_RELAXED);
+            __atomic_store_n(&(block->maxes[probe]), 0UL, __ATOMIC_RELAXED);
+        }
+    }
+    pthread_mutex_unlock(&registryLock);
+}
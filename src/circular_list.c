@@ -26,13 +26,10 @@
 #include "circular_list.h"
 
 /**
- * Struct for a node inside the circular list.
+ * Struct for a node inside the circular list, which is the public ListLink so that nodes can be
+ * handed out as handles.
  */
-typedef struct node {
-    struct node *next;      // Pointer to the next node
-    struct node *prev;      // Pointer to the previous node
-    void *data;             // Pointer to hold the element
-} Node;
+typedef ListLink Node;
 
 /**
  * Struct for the circular list ADT.
@@ -40,24 +37,66 @@ typedef struct node {
 struct circular_list {
     Node *head;         // Points to the list's head node
     long size;          // The list's current size
+    NodePool *pool;     // Allocates the nodes
+    Boolean ownsPool;   // TRUE if `pool` is private to the circular list
+    Boolean intrusive;  // TRUE if the nodes are embedded in the elements, `pool` is NULL
+    const CdsAllocator *allocator;  // Allocates the struct and, if private, the pool
+    long modCount;      // Number of structural modifications made
 };
 
-Status circularlist_new(CircularList **list) {
+/**
+ * Helper method to create a new circular list whose nodes come from `pool`, or from a private pool
+ * allocated through `allocator` if NULL (the default allocator, if also NULL). Intrusive lists
+ * allocate no nodes, and have no pool at all.
+ */
+static Status _new_list(CircularList **list, NodePool *pool, const CdsAllocator *allocator,
+                        Boolean intrusive) {
+
+    if (allocator == NULL) {
+        allocator = allocator_default();
+    }
 
     // Allocates the struct, checks for allocation failure
-    CircularList *temp = (CircularList *)malloc(sizeof(CircularList));
+    CircularList *temp = (CircularList *)allocator_alloc(allocator, sizeof(CircularList));
     if (temp == NULL) {
         return ALLOC_FAILURE;
     }
 
+    // Creates a private pool for the nodes unless one was provided
+    temp->ownsPool = ( pool == NULL && intrusive == FALSE ) ? TRUE : FALSE;
+    temp->intrusive = intrusive;
+    if (temp->ownsPool == TRUE && nodepool_newWithAllocator(&pool, 0L, allocator) != OK) {
+        allocator_free(allocator, temp);
+        return ALLOC_FAILURE;
+    }
+    temp->pool = pool;
+    temp->allocator = allocator;
+
     // Initializes the remaining struct members
     temp->head = NULL;
     temp->size = 0L;
+    temp->modCount = 0L;
     *list = temp;
 
     return OK;
 }
 
+Status circularlist_newWithPool(CircularList **list, NodePool *pool) {
+    return _new_list(list, pool, NULL, FALSE);
+}
+
+Status circularlist_newWithAllocator(CircularList **list, const CdsAllocator *allocator) {
+    return _new_list(list, NULL, allocator, FALSE);
+}
+
+Status circularlist_newIntrusive(CircularList **list) {
+    return _new_list(list, NULL, NULL, TRUE);
+}
+
+Status circularlist_new(CircularList **list) {
+    return circularlist_newWithPool(list, NULL);
+}
+
 // Macro used to validate the given index `i` in a list of size `N`
 #define INDEX_VALID(i, N) ( ( 0L <= (i) && (i) < (N) ) ? TRUE : FALSE )
 // Macro to check if the list `li` is currently empty
@@ -129,10 +168,20 @@ static void _unlink_node(Node *node) {
     prev->next = next;
 }
 
+/**
+ * Returns the node `node`, just unlinked, to the list's pool, unless the caller owns it.
+ */
+static void _release_node(CircularList *list, Node *node) {
+
+    if (list->intrusive == FALSE) {
+        nodepool_free(list->pool, node, sizeof(Node));
+    }
+}
+
 Status circularlist_addFirst(CircularList *list, void *item) {
 
     // Allocates the node for insertion
-    Node *node = (Node *)malloc(sizeof(Node));
+    Node *node = (Node *)nodepool_alloc(list->pool, sizeof(Node));
     if (node == NULL) {
         return ALLOC_FAILURE;
     }
@@ -142,6 +191,7 @@ Status circularlist_addFirst(CircularList *list, void *item) {
     _link_nodes(node, TAIL(list), list->head);
     list->head = node;
     list->size++;
+    list->modCount++;
 
     return OK;
 }
@@ -149,7 +199,7 @@ Status circularlist_addFirst(CircularList *list, void *item) {
 Status circularlist_addLast(CircularList *list, void *item) {
 
     // Allocates the node for insertion
-    Node *node = (Node *)malloc(sizeof(Node));
+    Node *node = (Node *)nodepool_alloc(list->pool, sizeof(Node));
     if (node == NULL) {
         return ALLOC_FAILURE;
     }
@@ -159,6 +209,7 @@ Status circularlist_addLast(CircularList *list, void *item) {
     _link_nodes(node, TAIL(list), list->head);
     list->head = node->next;
     list->size++;
+    list->modCount++;
 
     return OK;
 }
@@ -179,7 +230,7 @@ Status circularlist_insert(CircularList *list, long i, void *item) {
     }
 
     // Allocates the node for insertion
-    Node *node = (Node *)malloc(sizeof(Node));
+    Node *node = (Node *)nodepool_alloc(list->pool, sizeof(Node));
     if (node == NULL) {
         return ALLOC_FAILURE;
     }
@@ -189,6 +240,7 @@ Status circularlist_insert(CircularList *list, long i, void *item) {
     Node *temp = _fetch_node(list, i);
     _link_nodes(node, temp->prev, temp);
     list->size++;
+    list->modCount++;
 
     return OK;
 }
@@ -267,7 +319,8 @@ Status circularlist_removeFirst(CircularList *list, void **first) {
     list->head = ( IS_EMPTY(list) == FALSE ) ? temp->next : NULL;
     *first = temp->data;
     _unlink_node(temp);
-    free(temp);
+    _release_node(list, temp);
+    list->modCount++;
 
     return OK;
 }
@@ -284,7 +337,8 @@ Status circularlist_removeLast(CircularList *list, void **last) {
     Node *temp = TAIL(list);
     *last = temp->data;
     _unlink_node(temp);
-    free(temp);
+    _release_node(list, temp);
+    list->modCount++;
 
     return OK;
 }
@@ -313,21 +367,130 @@ Status circularlist_remove(CircularList *list, long i, void **item) {
     Node *temp = _fetch_node(list, i);
     *item = temp->data;
     _unlink_node(temp);
-    free(temp);
+    _release_node(list, temp);
     list->size--;
+    list->modCount++;
+
+    return OK;
+}
+
+/**
+ * Links the node `node`, holding `item`, in right after `prev`, or as the only node if the list is
+ * empty. Makes the node the head if `head` is TRUE.
+ */
+static void _link_after(CircularList *list, Node *prev, Node *node, void *item, Boolean head) {
+
+    node->data = item;
+    _link_nodes(node, prev, ( prev != NULL ) ? prev->next : NULL);
+    if (head == TRUE || list->head == NULL) {
+        list->head = node;
+    }
+    list->size++;
+    list->modCount++;
+}
+
+/**
+ * Allocates a node holding `item` and links it in right after `prev`, storing the node into
+ * `*handle` if `handle` is not NULL.
+ */
+static Status _add_node(CircularList *list, Node *prev, void *item, Boolean head,
+                        ListLink **handle) {
+
+    Node *node = (Node *)nodepool_alloc(list->pool, sizeof(Node));
+    if (node == NULL) {
+        return ALLOC_FAILURE;
+    }
+
+    _link_after(list, prev, node, item, head);
+    if (handle != NULL) {
+        *handle = node;
+    }
 
     return OK;
 }
 
+Status circularlist_addFirstHandle(CircularList *list, void *item, ListLink **handle) {
+    return _add_node(list, TAIL(list), item, TRUE, handle);
+}
+
+Status circularlist_addLastHandle(CircularList *list, void *item, ListLink **handle) {
+    return _add_node(list, TAIL(list), item, FALSE, handle);
+}
+
+Status circularlist_insertAfter(CircularList *list, ListLink *handle, void *item,
+                                ListLink **inserted) {
+    return _add_node(list, handle, item, FALSE, inserted);
+}
+
+void *circularlist_removeHandle(CircularList *list, ListLink *handle) {
+
+    void *item = handle->data;
+
+    list->size--;
+    if (list->head == handle) {
+        list->head = ( IS_EMPTY(list) == FALSE ) ? handle->next : NULL;
+    }
+    _unlink_node(handle);
+    _release_node(list, handle);
+    list->modCount++;
+
+    return item;
+}
+
+void circularlist_moveToFront(CircularList *list, ListLink *handle) {
+
+    // Moving the tail to the front is a rotation, no relinking needed
+    if (handle != list->head) {
+        if (handle != TAIL(list)) {
+            _unlink_node(handle);
+            _link_nodes(handle, TAIL(list), list->head);
+        }
+        list->head = handle;
+        list->modCount++;
+    }
+}
+
+void circularlist_moveToBack(CircularList *list, ListLink *handle) {
+
+    // Moving the head to the back is a rotation, no relinking needed
+    if (handle != TAIL(list)) {
+        if (handle == list->head) {
+            list->head = handle->next;
+        } else {
+            _unlink_node(handle);
+            _link_nodes(handle, TAIL(list), list->head);
+        }
+        list->modCount++;
+    }
+}
+
+ListLink *circularlist_firstHandle(CircularList *list) {
+    return list->head;
+}
+
+void circularlist_linkFirst(CircularList *list, ListLink *link, void *item) {
+    _link_after(list, TAIL(list), link, item, TRUE);
+}
+
+void circularlist_linkLast(CircularList *list, ListLink *link, void *item) {
+    _link_after(list, TAIL(list), link, item, FALSE);
+}
+
+void circularlist_linkAfter(CircularList *list, ListLink *position, ListLink *link, void *item) {
+    _link_after(list, position, link, item, FALSE);
+}
+
 void circularlist_rotateForward(CircularList *list) {
     if (IS_EMPTY(list) == FALSE) {
         list->head = list->head->next;
+        list->modCount++;
     }
 }
 
 void circularlist_rotateBackward(CircularList *list) {
     if (IS_EMPTY(list) == FALSE) {
         list->head = list->head->prev;
+        list->modCount++;
     }
 }
 
@@ -340,20 +503,36 @@ static void _clear_list(CircularList *list, void (*destructor)(void *)) {
     Node *curr = list->head, *next = NULL;
     long i;
 
+    // A private pool releases every node at once, so nodes are only visited for the destructor
+    if (list->ownsPool == TRUE && destructor == NULL) {
+        nodepool_reset(list->pool);
+        return;
+    }
+    // The caller owns the nodes of an intrusive list, which are simply dropped
+    if (list->intrusive == TRUE && destructor == NULL) {
+        return;
+    }
+
     for (i = 0L; i < list->size; i++) {
         next = curr->next;
         if (destructor != NULL) {
             (*destructor)(curr->data);
         }
-        free(curr);
+        if (list->ownsPool == FALSE && list->intrusive == FALSE) {
+            nodepool_free(list->pool, curr, sizeof(Node));
+        }
         curr = next;
     }
+    if (list->ownsPool == TRUE) {
+        nodepool_reset(list->pool);
+    }
 }
 
 void circularlist_clear(CircularList *list, void (*destructor)(void *)) {
     _clear_list(list, destructor);
     list->head = NULL;
     list->size = 0L;
+    list->modCount++;
 }
 
 long circularlist_size(CircularList *list) {
@@ -445,7 +624,67 @@ Status circularlist_iterator(CircularList *list, Iterator **iter) {
     return OK;
 }
 
+void circularlist_cursor(CircularList *list, Cursor *cursor) {
+    cursor->adt = list;
+    cursor->node = list->head;
+    cursor->index = 0L;
+    cursor->remaining = list->size;
+    cursor->modCount = list->modCount;
+}
+
+Status circularlist_cursorNext(Cursor *cursor, void **next) {
+
+    CircularList *list = (CircularList *)cursor->adt;
+    Node *node = (Node *)cursor->node;
+
+    // Fails fast if the list was modified since creating the cursor
+    if (list->modCount != cursor->modCount) {
+        return CONCURRENT_MODIFICATION;
+    }
+    // Checks if every element was visited
+    if (cursor->remaining == 0L) {
+        return ITER_END;
+    }
+
+    // Fetches the item, advances to the next node
+    *next = node->data;
+    cursor->node = node->next;
+    cursor->remaining--;
+
+    return OK;
+}
+
+Boolean circularlist_forEach(CircularList *list, Boolean (*action)(void *, void *), void *context) {
+
+    Node *node = list->head;
+    long i;
+
+    for (i = 0L; i < list->size; i++) {
+        if ((*action)(node->data, context) == FALSE) {
+            return FALSE;
+        }
+        node = node->next;
+    }
+
+    return TRUE;
+}
+
+long circularlist_memoryUsage(CircularList *list) {
+
+    // A private pool is charged in full, a shared one only for the nodes in use
+    long nodes = ( list->ownsPool == TRUE ) ? nodepool_memoryUsage(list->pool)
+                                            : list->size * (long)sizeof(Node);
+    if (list->intrusive == TRUE) {
+        nodes = 0L;
+    }
+
+    return (long)sizeof(CircularList) + nodes;
+}
+
 void circularlist_destroy(CircularList *list, void (*destructor)(void *)) {
     _clear_list(list, destructor);
-    free(list);
+    if (list->ownsPool == TRUE) {
+        nodepool_destroy(list->pool);
+    }
+    allocator_free(list->allocator, list);
 }
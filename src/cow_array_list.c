@@ -0,0 +1,277 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2020 Cole Vikupitz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include "cow_array_list.h"
+#include "epoch.h"
+
+/**
+ * Struct for the copy-on-write arraylist.
+ */
+struct cow_arraylist {
+    TsLock lock;                        // Serializes the writers
+    long capacity;                      // The capacity each version starts out with
+    ArrayList *current CACHE_ALIGNED;   // The published version, on a line away from the lock
+} CACHE_ALIGNED;
+
+// Macro used for locking the arraylist `li` for writing
+#define LOCK(li)    ts_lock_write( &((li)->lock) )
+// Macro used for unlocking the arraylist `li`
+#define UNLOCK(li)  ts_lock_unlock( &((li)->lock) )
+
+/**
+ * Appends the item `item` onto the arraylist `context`, stopping if that fails.
+ */
+static Boolean _copy_item(void *item, void *context) {
+    return ( arraylist_add((ArrayList *)context, item) == OK ) ? TRUE : FALSE;
+}
+
+/**
+ * Reclaims a superseded version, leaving its items to the newer versions.
+ */
+static void _reclaim_version(void *version) {
+    arraylist_destroy((ArrayList *)version, NULL);
+}
+
+/**
+ * Locks the arraylist `list` for writing and copies its current version into `*copy`, with room
+ * for `extra` more items. The lock is released again if the copy fails.
+ */
+static Status _begin_write(CopyOnWriteArrayList *list, long extra, ArrayList **copy) {
+
+    ArrayList *current;
+    Status status;
+
+    LOCK(list);
+    current = list->current;
+    status = arraylist_new(copy, list->capacity);
+    if (status == OK) {
+        status = arraylist_ensureCapacity(*copy, arraylist_size(current) + extra);
+        if (status == OK && arraylist_forEach(current, _copy_item, *copy) == FALSE) {
+            status = ALLOC_FAILURE;
+        }
+        if (status != OK) {
+            arraylist_destroy(*copy, NULL);
+        }
+    }
+    if (status != OK) {
+        UNLOCK(list);
+    }
+
+    return status;
+}
+
+/**
+ * Publishes `copy` as the current version of the arraylist `list` if the write applied to it
+ * returned `status` OK, retiring the version it supersedes, then unlocks the arraylist. Otherwise
+ * the copy is discarded. Returns `status`.
+ */
+static Status _end_write(CopyOnWriteArrayList *list, ArrayList *copy, Status status) {
+
+    ArrayList *previous = list->current;
+
+    if (status == OK) {
+        __atomic_store_n(&(list->current), copy, __ATOMIC_RELEASE);
+        epoch_retire(previous, _reclaim_version);
+    } else {
+        arraylist_destroy(copy, NULL);
+    }
+    UNLOCK(list);
+
+    return status;
+}
+
+Status cow_arraylist_new(CopyOnWriteArrayList **list, long capacity) {
+
+    CopyOnWriteArrayList *temp;
+    Status status;
+
+    // Allocates memory for the arraylist
+    temp = (CopyOnWriteArrayList *)ts_lock_alloc(sizeof(CopyOnWriteArrayList));
+    if (temp == NULL) {
+        return ALLOC_FAILURE;
+    }
+
+    // Creates the first, empty version
+    status = arraylist_new(&(temp->current), capacity);
+    if (status != OK) {
+        free(temp);
+        return status;
+    }
+
+    // Creates the lock with the calling thread's default lock policy
+    ts_lock_init(&(temp->lock));
+    temp->capacity = capacity;
+    *list = temp;
+
+    return OK;
+}
+
+Status cow_arraylist_add(CopyOnWriteArrayList *list, void *item) {
+
+    ArrayList *copy;
+    Status status = _begin_write(list, 1L, &copy);
+    if (status == OK) {
+        status = _end_write(list, copy, arraylist_add(copy, item));
+    }
+
+    return status;
+}
+
+Status cow_arraylist_addAll(CopyOnWriteArrayList *list, void **items, long n) {
+
+    ArrayList *copy;
+    Status status;
+
+    if (n < 0L) {
+        return INVALID_INDEX;
+    }
+    status = _begin_write(list, n, &copy);
+    if (status == OK) {
+        status = _end_write(list, copy, arraylist_addAll(copy, items, n));
+    }
+
+    return status;
+}
+
+Status cow_arraylist_insert(CopyOnWriteArrayList *list, long i, void *item) {
+
+    ArrayList *copy;
+    Status status = _begin_write(list, 1L, &copy);
+    if (status == OK) {
+        status = _end_write(list, copy, arraylist_insert(copy, i, item));
+    }
+
+    return status;
+}
+
+Status cow_arraylist_get(CopyOnWriteArrayList *list, long i, void **item) {
+
+    ArrayList *snapshot;
+    Status status = cow_arraylist_acquire(list, &snapshot);
+    if (status == OK) {
+        status = arraylist_get(snapshot, i, item);
+        cow_arraylist_release(list);
+    }
+
+    return status;
+}
+
+Status cow_arraylist_set(CopyOnWriteArrayList *list, long i, void *item, void **previous) {
+
+    ArrayList *copy;
+    Status status = _begin_write(list, 0L, &copy);
+    if (status == OK) {
+        status = _end_write(list, copy, arraylist_set(copy, i, item, previous));
+    }
+
+    return status;
+}
+
+Status cow_arraylist_remove(CopyOnWriteArrayList *list, long i, void **item) {
+
+    ArrayList *copy;
+    Status status = _begin_write(list, 0L, &copy);
+    if (status == OK) {
+        status = _end_write(list, copy, arraylist_remove(copy, i, item));
+    }
+
+    return status;
+}
+
+/**
+ * Retires the cleared item `item` to the destructor `context`.
+ */
+static Boolean _retire_item(void *item, void *context) {
+    epoch_retire(item, (void (*)(void *))context);
+    return TRUE;
+}
+
+Status cow_arraylist_clear(CopyOnWriteArrayList *list, void (*destructor)(void *)) {
+
+    ArrayList *copy, *previous;
+    Status status;
+
+    // Nothing needs copying, the new version starts out empty
+    LOCK(list);
+    previous = list->current;
+    status = arraylist_new(&copy, list->capacity);
+    if (status == OK) {
+        __atomic_store_n(&(list->current), copy, __ATOMIC_RELEASE);
+        if (destructor != NULL) {
+            (void)arraylist_forEach(previous, _retire_item, (void *)destructor);
+        }
+        epoch_retire(previous, _reclaim_version);
+    }
+    UNLOCK(list);
+
+    return status;
+}
+
+long cow_arraylist_size(CopyOnWriteArrayList *list) {
+
+    ArrayList *snapshot;
+    long size = -1L;
+
+    if (cow_arraylist_acquire(list, &snapshot) == OK) {
+        size = arraylist_size(snapshot);
+        cow_arraylist_release(list);
+    }
+
+    return size;
+}
+
+Boolean cow_arraylist_isEmpty(CopyOnWriteArrayList *list) {
+    return ( cow_arraylist_size(list) == 0L ) ? TRUE : FALSE;
+}
+
+Status cow_arraylist_acquire(CopyOnWriteArrayList *list, ArrayList **snapshot) {
+
+    EpochRecord *record = epoch_acquire();
+    if (record == NULL) {
+        return ALLOC_FAILURE;
+    }
+    epoch_enter(record);
+    *snapshot = __atomic_load_n(&(list->current), __ATOMIC_ACQUIRE);
+
+    return OK;
+}
+
+void cow_arraylist_release(CopyOnWriteArrayList *list) {
+    (void)list;
+    epoch_exit(epoch_acquire());
+}
+
+void cow_arraylist_lockStats(CopyOnWriteArrayList *list, LockStats *stats) {
+    ts_lock_stats(&(list->lock), stats);
+}
+
+void cow_arraylist_destroy(CopyOnWriteArrayList *list, void (*destructor)(void *)) {
+
+    LOCK(list);
+    arraylist_destroy(list->current, destructor);
+    UNLOCK(list);
+    ts_lock_destroy(&(list->lock));
+    free(list);
+}
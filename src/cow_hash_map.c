@@ -0,0 +1,364 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2020 Cole Vikupitz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include "cow_hash_map.h"
+#include "epoch.h"
+
+/**
+ * Struct for the copy-on-write hashmap.
+ */
+struct cow_hashmap {
+    TsLock lock;                        // Serializes the writers
+    long (*hash)(void *, long);         // The hash function each version is built with
+    int (*keyCmp)(void *, void *);      // The key comparator
+    long capacity;                      // The capacity each version starts out with
+    double loadFactor;                  // The load factor of each version
+    void (*keyDestructor)(void *);      // The key destructor, applied once keys are reclaimed
+    HashMap *current CACHE_ALIGNED;     // The published version, on a line away from the lock
+} CACHE_ALIGNED;
+
+// Macro used for locking the hashmap `m` for writing
+#define LOCK(m)    ts_lock_write( &((m)->lock) )
+// Macro used for unlocking the hashmap `m`
+#define UNLOCK(m)  ts_lock_unlock( &((m)->lock) )
+
+/**
+ * State passed along while copying the entries of one version into the next.
+ */
+typedef struct {
+    HashMap *copy;                      // The version being built
+    int (*keyCmp)(void *, void *);      // The key comparator
+    Boolean skipping;                   // TRUE if the entry with the key `skip` is left out
+    void *skip;                         // The key of the entry left out
+    void *key;                          // The stored key of the entry left out, once found
+    void *value;                        // The value of the entry left out, once found
+} CopyContext;
+
+/**
+ * Inserts the entry `key` and `value` into the version being built in `context`, unless it is the
+ * entry being left out. Stops if the insertion fails.
+ */
+static Boolean _copy_entry(void *key, void *value, void *context) {
+
+    CopyContext *ctx = (CopyContext *)context;
+    void *previous;
+
+    if (ctx->skipping == TRUE && ctx->keyCmp(key, ctx->skip) == 0) {
+        ctx->key = key;
+        ctx->value = value;
+        return TRUE;
+    }
+
+    return ( hashmap_put(ctx->copy, key, value, &previous) != ALLOC_FAILURE ) ? TRUE : FALSE;
+}
+
+/**
+ * Reclaims a superseded version, leaving its keys and values to the newer versions.
+ */
+static void _reclaim_version(void *version) {
+    hashmap_destroy((HashMap *)version, NULL);
+}
+
+/**
+ * Copies the current version of the hashmap `map` into `ctx->copy`, with room for `extra` more
+ * entries and without the entry `ctx->skip` if `ctx->skipping` is TRUE. Must be called under the
+ * write lock.
+ */
+static Status _copy_version(CopyOnWriteHashMap *map, long extra, CopyContext *ctx) {
+
+    // Keys are owned by the wrapper, so the versions themselves never destroy them
+    Status status = hashmap_new(&(ctx->copy), map->hash, map->keyCmp, map->capacity,
+                                map->loadFactor, NULL);
+    if (status != OK) {
+        return status;
+    }
+    status = hashmap_reserve(ctx->copy, hashmap_size(map->current) + extra);
+    if (status == OK && hashmap_forEach(map->current, _copy_entry, ctx) == FALSE) {
+        status = ALLOC_FAILURE;
+    }
+    if (status != OK) {
+        hashmap_destroy(ctx->copy, NULL);
+    }
+
+    return status;
+}
+
+/**
+ * Publishes `copy` as the current version of the hashmap `map`, retiring the version it
+ * supersedes. Must be called under the write lock.
+ */
+static void _publish(CopyOnWriteHashMap *map, HashMap *copy) {
+
+    HashMap *previous = map->current;
+
+    __atomic_store_n(&(map->current), copy, __ATOMIC_RELEASE);
+    epoch_retire(previous, _reclaim_version);
+}
+
+/**
+ * Initializes the copy state `ctx`, leaving out nothing.
+ */
+static void _init_context(CopyOnWriteHashMap *map, CopyContext *ctx) {
+    ctx->copy = NULL;
+    ctx->keyCmp = map->keyCmp;
+    ctx->skipping = FALSE;
+    ctx->skip = NULL;
+    ctx->key = NULL;
+    ctx->value = NULL;
+}
+
+Status cow_hashmap_new(CopyOnWriteHashMap **map, long (*hash)(void *, long),
+                       int (*keyComparator)(void *, void *), long capacity, double loadFactor,
+                       void (*keyDestructor)(void *)) {
+
+    CopyOnWriteHashMap *temp;
+    Status status;
+
+    // Allocates memory for the hashmap
+    temp = (CopyOnWriteHashMap *)ts_lock_alloc(sizeof(CopyOnWriteHashMap));
+    if (temp == NULL) {
+        return ALLOC_FAILURE;
+    }
+
+    // Creates the first, empty version
+    status = hashmap_new(&(temp->current), hash, keyComparator, capacity, loadFactor, NULL);
+    if (status != OK) {
+        free(temp);
+        return status;
+    }
+
+    // Creates the lock with the calling thread's default lock policy
+    ts_lock_init(&(temp->lock));
+    temp->hash = hash;
+    temp->keyCmp = keyComparator;
+    temp->capacity = capacity;
+    temp->loadFactor = loadFactor;
+    temp->keyDestructor = keyDestructor;
+    *map = temp;
+
+    return OK;
+}
+
+Status cow_hashmap_put(CopyOnWriteHashMap *map, void *key, void *value, void **previous) {
+
+    CopyContext ctx;
+    Status status;
+
+    LOCK(map);
+    _init_context(map, &ctx);
+    status = _copy_version(map, 1L, &ctx);
+    if (status == OK) {
+        status = hashmap_put(ctx.copy, key, value, previous);
+        if (status == ALLOC_FAILURE) {
+            hashmap_destroy(ctx.copy, NULL);
+        } else {
+            _publish(map, ctx.copy);
+        }
+    }
+    UNLOCK(map);
+
+    return status;
+}
+
+Status cow_hashmap_putAll(CopyOnWriteHashMap *map, void **keys, void **values, long n,
+                          void **previous) {
+
+    CopyContext ctx;
+    Status status;
+
+    LOCK(map);
+    _init_context(map, &ctx);
+    status = _copy_version(map, n, &ctx);
+    if (status == OK) {
+        status = hashmap_putAll(ctx.copy, keys, values, n, previous);
+        if (status != OK) {
+            hashmap_destroy(ctx.copy, NULL);
+        } else {
+            _publish(map, ctx.copy);
+        }
+    }
+    UNLOCK(map);
+
+    return status;
+}
+
+Boolean cow_hashmap_containsKey(CopyOnWriteHashMap *map, void *key) {
+
+    HashMap *snapshot;
+    Boolean found = FALSE;
+
+    if (cow_hashmap_acquire(map, &snapshot) == OK) {
+        found = hashmap_containsKey(snapshot, key);
+        cow_hashmap_release(map);
+    }
+
+    return found;
+}
+
+Status cow_hashmap_get(CopyOnWriteHashMap *map, void *key, void **value) {
+
+    HashMap *snapshot;
+    Status status = cow_hashmap_acquire(map, &snapshot);
+    if (status == OK) {
+        status = hashmap_get(snapshot, key, value);
+        cow_hashmap_release(map);
+    }
+
+    return status;
+}
+
+Status cow_hashmap_remove(CopyOnWriteHashMap *map, void *key, void **value) {
+
+    CopyContext ctx;
+    Status status;
+
+    LOCK(map);
+    if (hashmap_isEmpty(map->current) == TRUE) {
+        UNLOCK(map);
+        return STRUCT_EMPTY;
+    }
+    if (hashmap_containsKey(map->current, key) == FALSE) {
+        UNLOCK(map);
+        return NOT_FOUND;
+    }
+
+    // Copies every entry but the removed one, which also finds the stored key to retire
+    _init_context(map, &ctx);
+    ctx.skipping = TRUE;
+    ctx.skip = key;
+    status = _copy_version(map, 0L, &ctx);
+    if (status == OK) {
+        _publish(map, ctx.copy);
+        if (map->keyDestructor != NULL) {
+            epoch_retire(ctx.key, map->keyDestructor);
+        }
+        *value = ctx.value;
+    }
+    UNLOCK(map);
+
+    return status;
+}
+
+/**
+ * Retires the cleared entry `key` and `value` to the key destructor and the value destructor
+ * passed in `context`.
+ */
+static Boolean _retire_entry(void *key, void *value, void *context) {
+
+    void (**destructors)(void *) = (void (**)(void *))context;
+
+    if (destructors[0] != NULL) {
+        epoch_retire(key, destructors[0]);
+    }
+    if (destructors[1] != NULL) {
+        epoch_retire(value, destructors[1]);
+    }
+
+    return TRUE;
+}
+
+Status cow_hashmap_clear(CopyOnWriteHashMap *map, void (*valueDestructor)(void *)) {
+
+    void (*destructors[2])(void *) = { map->keyDestructor, valueDestructor };
+    HashMap *copy, *previous;
+    Status status;
+
+    // Nothing needs copying, the new version starts out empty
+    LOCK(map);
+    previous = map->current;
+    status = hashmap_new(&copy, map->hash, map->keyCmp, map->capacity, map->loadFactor, NULL);
+    if (status == OK) {
+        _publish(map, copy);
+        (void)hashmap_forEach(previous, _retire_entry, destructors);
+    }
+    UNLOCK(map);
+
+    return status;
+}
+
+long cow_hashmap_size(CopyOnWriteHashMap *map) {
+
+    HashMap *snapshot;
+    long size = -1L;
+
+    if (cow_hashmap_acquire(map, &snapshot) == OK) {
+        size = hashmap_size(snapshot);
+        cow_hashmap_release(map);
+    }
+
+    return size;
+}
+
+Boolean cow_hashmap_isEmpty(CopyOnWriteHashMap *map) {
+    return ( cow_hashmap_size(map) == 0L ) ? TRUE : FALSE;
+}
+
+Status cow_hashmap_acquire(CopyOnWriteHashMap *map, HashMap **snapshot) {
+
+    EpochRecord *record = epoch_acquire();
+    if (record == NULL) {
+        return ALLOC_FAILURE;
+    }
+    epoch_enter(record);
+    *snapshot = __atomic_load_n(&(map->current), __ATOMIC_ACQUIRE);
+
+    return OK;
+}
+
+void cow_hashmap_release(CopyOnWriteHashMap *map) {
+    (void)map;
+    epoch_exit(epoch_acquire());
+}
+
+void cow_hashmap_lockStats(CopyOnWriteHashMap *map, LockStats *stats) {
+    ts_lock_stats(&(map->lock), stats);
+}
+
+/**
+ * Destroys the key `key` with the key destructor passed in `context`.
+ */
+static Boolean _destroy_key(void *key, void *value, void *context) {
+
+    void (**destructors)(void *) = (void (**)(void *))context;
+
+    (void)value;
+    (*(destructors[0]))(key);
+
+    return TRUE;
+}
+
+void cow_hashmap_destroy(CopyOnWriteHashMap *map, void (*valueDestructor)(void *)) {
+
+    void (*destructors[1])(void *) = { map->keyDestructor };
+
+    LOCK(map);
+    if (map->keyDestructor != NULL) {
+        (void)hashmap_forEach(map->current, _destroy_key, destructors);
+    }
+    hashmap_destroy(map->current, valueDestructor);
+    UNLOCK(map);
+    ts_lock_destroy(&(map->lock));
+    free(map);
+}
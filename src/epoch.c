@@ -0,0 +1,307 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2020 Cole Vikupitz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <pthread.h>
+#include "epoch.h"
+
+// The size of a cache line, records are padded to one so that threads do not share lines
+#define CACHE_LINE 64
+
+// The number of nodes a thread retires between its attempts to advance the epoch
+#define ADVANCE_THRESHOLD 64L
+#define RETIRED_INIT_CAPACITY 64L
+// The number of limbo lists each record keeps, one for each epoch whose nodes may still be read
+#define LIMBO_LISTS 3
+
+/**
+ * A node waiting to be reclaimed.
+ */
+typedef struct {
+    void *ptr;                  // The retired node
+    void (*reclaim)(void *);    // The function that frees the node
+} Retired;
+
+/**
+ * A list of nodes retired in the same epoch.
+ */
+typedef struct {
+    Retired *items;             // The retired nodes
+    long len;                   // The number of retired nodes
+    long capacity;              // The capacity of `items`
+    long epoch;                 // The epoch the nodes were retired in
+} RetiredList;
+
+/**
+ * Struct for a thread's epoch record.
+ */
+struct epoch_record {
+    long epoch;                     // The global epoch observed on entering the outermost operation
+    long depth;                     // The number of nested operations entered, 0 if outside
+    int active;                     // 1 while the record is owned by a live thread
+    RetiredList limbo[LIMBO_LISTS]; // The nodes retired by the owning thread, by epoch
+    long pending;                   // The number of nodes retired since the last advance attempt
+    struct epoch_record *next;      // The next record in the registry
+} __attribute__((aligned(CACHE_LINE)));
+
+// The global epoch, only ever incremented
+static long globalEpoch = 0L;
+
+// Registry of every record ever allocated; records are reused but never freed
+static EpochRecord *records = NULL;
+
+// The calling thread's record
+static __thread EpochRecord *self = NULL;
+
+// Key used only to release a thread's record once the thread exits
+static pthread_key_t recordKey;
+static pthread_once_t recordKeyOnce = PTHREAD_ONCE_INIT;
+
+// Nodes left behind by exited threads, reclaimed two epochs after the last one was orphaned
+static pthread_mutex_t orphanLock = PTHREAD_MUTEX_INITIALIZER;
+static RetiredList orphans = { NULL, 0L, 0L, 0L };
+static long orphanCount = 0L;
+
+/**
+ * Appends the node `ptr` onto the list `list`, growing it if needed.
+ */
+static Boolean _append(RetiredList *list, void *ptr, void (*reclaim)(void *)) {
+
+    if (list->len == list->capacity) {
+        long cap = ( list->capacity == 0L ) ? RETIRED_INIT_CAPACITY : list->capacity * 2L;
+        Retired *items = (Retired *)realloc(list->items, cap * sizeof(Retired));
+        if (items == NULL) {
+            return FALSE;
+        }
+        list->items = items;
+        list->capacity = cap;
+    }
+    list->items[list->len].ptr = ptr;
+    list->items[list->len].reclaim = reclaim;
+    list->len++;
+
+    return TRUE;
+}
+
+/**
+ * Reclaims every node on the list `list`, leaving it empty.
+ */
+static void _reclaim(RetiredList *list) {
+
+    long i;
+    for (i = 0L; i < list->len; i++) {
+        (*(list->items[i].reclaim))(list->items[i].ptr);
+    }
+    list->len = 0L;
+}
+
+/**
+ * Hands the node `ptr`, retired in the epoch `epoch`, over to the orphans. If even that fails, the
+ * node is leaked rather than freed while it may still be in use.
+ */
+static void _orphan(void *ptr, void (*reclaim)(void *), long epoch) {
+
+    pthread_mutex_lock(&orphanLock);
+    if (_append(&orphans, ptr, reclaim) == TRUE && epoch > orphans.epoch) {
+        orphans.epoch = epoch;
+    }
+    __atomic_store_n(&orphanCount, orphans.len, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&orphanLock);
+}
+
+/**
+ * Advances the global epoch, unless some thread inside an operation has yet to observe it.
+ */
+static void _try_advance(void) {
+
+    EpochRecord *r;
+    long epoch = __atomic_load_n(&globalEpoch, __ATOMIC_SEQ_CST);
+
+    for (r = __atomic_load_n(&records, __ATOMIC_ACQUIRE); r != NULL; r = r->next) {
+        if (__atomic_load_n(&(r->depth), __ATOMIC_SEQ_CST) != 0L &&
+                __atomic_load_n(&(r->epoch), __ATOMIC_SEQ_CST) != epoch) {
+            return;
+        }
+    }
+    __atomic_compare_exchange_n(&globalEpoch, &epoch, epoch + 1L, FALSE, __ATOMIC_SEQ_CST,
+                                __ATOMIC_RELAXED);
+}
+
+/**
+ * Reclaims the nodes retired by the owner of `record`, and the orphans, that were retired at
+ * least two epochs ago. Threads inside an operation have all observed at least the previous
+ * epoch, so none of them can still be reading those nodes.
+ */
+static void _collect(EpochRecord *record) {
+
+    long epoch = __atomic_load_n(&globalEpoch, __ATOMIC_SEQ_CST);
+    int i;
+
+    for (i = 0; i < LIMBO_LISTS; i++) {
+        if (record->limbo[i].len > 0L && record->limbo[i].epoch + 2L <= epoch) {
+            _reclaim(&(record->limbo[i]));
+        }
+    }
+
+    // Reclaims the orphans, unless someone else is already doing it
+    if (__atomic_load_n(&orphanCount, __ATOMIC_RELAXED) > 0L &&
+            pthread_mutex_trylock(&orphanLock) == 0) {
+        if (orphans.epoch + 2L <= epoch) {
+            _reclaim(&orphans);
+            __atomic_store_n(&orphanCount, 0L, __ATOMIC_RELAXED);
+        }
+        pthread_mutex_unlock(&orphanLock);
+    }
+}
+
+/**
+ * Releases the record of an exiting thread, passing its unreclaimed nodes on to the others.
+ */
+static void _release(void *arg) {
+
+    EpochRecord *record = (EpochRecord *)arg;
+    long i;
+    int k;
+
+    __atomic_store_n(&(record->depth), 0L, __ATOMIC_RELEASE);
+    _try_advance();
+    _collect(record);
+    for (k = 0; k < LIMBO_LISTS; k++) {
+        RetiredList *list = &(record->limbo[k]);
+        for (i = 0L; i < list->len; i++) {
+            _orphan(list->items[i].ptr, list->items[i].reclaim, list->epoch);
+        }
+        free(list->items);
+        list->items = NULL;
+        list->len = 0L;
+        list->capacity = 0L;
+    }
+    self = NULL;
+    __atomic_store_n(&(record->active), 0, __ATOMIC_RELEASE);
+}
+
+/**
+ * Creates the key used to release a thread's record once it exits.
+ */
+static void _make_key(void) {
+    pthread_key_create(&recordKey, _release);
+}
+
+EpochRecord *epoch_acquire(void) {
+
+    EpochRecord *record;
+    int expected;
+    int k;
+
+    if (self != NULL) {
+        return self;
+    }
+    pthread_once(&recordKeyOnce, _make_key);
+
+    // Reuses a record released by an exited thread if there is one
+    for (record = __atomic_load_n(&records, __ATOMIC_ACQUIRE); record != NULL;
+            record = record->next) {
+        expected = 0;
+        if (__atomic_load_n(&(record->active), __ATOMIC_RELAXED) == 0 &&
+                __atomic_compare_exchange_n(&(record->active), &expected, 1, FALSE,
+                                            __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+            break;
+        }
+    }
+
+    // Otherwise registers a new one
+    if (record == NULL) {
+        if (posix_memalign((void **)&record, CACHE_LINE, sizeof(EpochRecord)) != 0) {
+            return NULL;
+        }
+        record->epoch = 0L;
+        record->depth = 0L;
+        record->active = 1;
+        for (k = 0; k < LIMBO_LISTS; k++) {
+            record->limbo[k].items = NULL;
+            record->limbo[k].len = 0L;
+            record->limbo[k].capacity = 0L;
+            record->limbo[k].epoch = 0L;
+        }
+        record->next = __atomic_load_n(&records, __ATOMIC_RELAXED);
+        while (!__atomic_compare_exchange_n(&records, &(record->next), record, TRUE,
+                                            __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+            ;
+    }
+
+    record->pending = 0L;
+    pthread_setspecific(recordKey, record);
+    self = record;
+
+    return record;
+}
+
+void epoch_enter(EpochRecord *record) {
+
+    if (record->depth > 0L) {
+        record->depth++;
+        return;
+    }
+
+    // Publishes the epoch before reading any node, so that no advance can miss the thread
+    __atomic_store_n(&(record->epoch), __atomic_load_n(&globalEpoch, __ATOMIC_SEQ_CST),
+                     __ATOMIC_SEQ_CST);
+    __atomic_store_n(&(record->depth), 1L, __ATOMIC_SEQ_CST);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+void epoch_exit(EpochRecord *record) {
+    __atomic_store_n(&(record->depth), record->depth - 1L, __ATOMIC_RELEASE);
+}
+
+void epoch_retire(void *ptr, void (*reclaim)(void *)) {
+
+    EpochRecord *record = epoch_acquire();
+    RetiredList *list;
+    long epoch;
+
+    // Orders the unlinking of the node before the reading of the epoch it is retired in
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    epoch = __atomic_load_n(&globalEpoch, __ATOMIC_SEQ_CST);
+    if (record == NULL) {
+        _orphan(ptr, reclaim, epoch);
+        return;
+    }
+
+    // A list last used LIMBO_LISTS or more epochs ago holds nodes no thread can still be reading
+    list = &(record->limbo[epoch % LIMBO_LISTS]);
+    if (list->epoch != epoch) {
+        _reclaim(list);
+        list->epoch = epoch;
+    }
+    if (_append(list, ptr, reclaim) == FALSE) {
+        _orphan(ptr, reclaim, epoch);
+    }
+
+    if (++(record->pending) >= ADVANCE_THRESHOLD) {
+        record->pending = 0L;
+        _try_advance();
+        _collect(record);
+    }
+}
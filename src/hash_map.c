@@ -22,32 +22,98 @@
  * SOFTWARE.
  */
 
+#include <pthread.h>
+#include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#include "cds_stats.h"
 #include "hash_map.h"
+#include "node_pool.h"
+#include "snapshot.h"
 
 /**
  * Struct for the hashmap entry ADT.
  */
 struct hm_entry {
     HmEntry *next;      // Pointer to the next bucket
+    uint64_t hash;      // The key's cached hash code (0 if the map uses bucket index hashing)
     void *key;          // The entry's associated key
     void *value;        // The entry's associated value
 };
 
+// Number of entries a small hashmap holds inline before it is promoted to a flat table
+#define SMALL_CAPACITY 8L
+
+/**
+ * Struct for the inline storage of a small hashmap, allocated in the same block as the map itself.
+ * The hash codes are kept apart from the entries so that a lookup scans a single cache line.
+ */
+typedef struct {
+    uint64_t codes[SMALL_CAPACITY];     // Hash codes of the entries, in the same order
+    HmEntry entries[SMALL_CAPACITY];    // The entries, packed at the front
+} SmallTable;
+
 /**
  * Struct for the hashmap ADT.
  */
 struct hashmap {
     long (*hash)(void *, long);         // Hashing function for computing bucket placement
+    uint64_t (*hashCode)(void *);       // Full-width hashing function, NULL if `hash` is used
+    uint64_t (*seededHash)(void *, uint64_t);   // Seeded full-width hashing function, or NULL
+    uint64_t seed;                      // The seed passed to `seededHash`, drawn per map
     int (*keyCmp)(void *, void *);      // Function for comparing keys in the map
     void (*keyDxn)(void *);             // Function for destroying hashmap keys
     HmEntry **buckets;                  // Array of buckets containing the entries
+    HmEntry **oldBuckets;               // Buckets still being rehashed, NULL if not resizing
+    long oldCapacity;                   // Number of buckets in `oldBuckets`
+    long rehashIndex;                   // Index of the next bucket in `oldBuckets` to rehash
+    Boolean incremental;                // TRUE if resizing is spread across the next insertions
+    NodePool *pool;                     // Private pool of the chained entries, NULL otherwise
+    int8_t *ctrl;                       // Control bytes of the flat engine, NULL if chained
+    HmEntry *slots;                     // Inline entry slots of the flat engine
+    long tombstones;                    // Number of deleted slots in the flat engine
+    SmallTable *small;                  // Inline storage while small, NULL once promoted
     long size;                          // The hashmap's current size
+    long modCount;                      // Number of structural modifications made
     long capacity;                      // The hashmap's current capacity
-    long changes;                       // Number of changes since last trigger
-    double load;                        // The hashmap's current load
+    long minCapacity;                   // The capacity the hashmap never shrinks below
+    long threshold;                     // Size the hashmap grows at, from its load factor
     double loadFactor;                  // The hashmap's load factor
-    double delta;                       // Increment applied for every insertion/deletion
+    long resizes;                       // Number of resizes performed
+    long resizeNanos;                   // Total time spent resizing, in nanoseconds
+    long lookups;                       // Number of lookups, if counting probes
+    long probes;                        // Number of entries (or groups) examined by lookups
+    size_t structBytes;                 // Size of the map's own block, inline table included
+    const CdsAllocator *allocator;      // Allocates the struct, the table and the entry pool
+};
+
+/**
+ * Struct for the frozen hashmap ADT. Each slot holds the entry with one of the distinct hash codes,
+ * placed by the minimal perfect hash; entries whose hash code repeats one already placed are kept
+ * aside, sorted by hash code.
+ */
+struct frozen_hashmap {
+    long (*hash)(void *, long);         // Hashing function of the hashmap frozen, or NULL
+    uint64_t (*hashCode)(void *);       // Full-width hashing function, or NULL
+    uint64_t (*seededHash)(void *, uint64_t);   // Seeded full-width hashing function, or NULL
+    uint64_t seed;                      // The seed passed to `seededHash`
+    int (*keyCmp)(void *, void *);      // Function for comparing keys
+    void (*keyDxn)(void *);             // Function for destroying keys
+    uint64_t salt;                      // Salt mixed into the hash codes by the perfect hash
+    long buckets;                       // Number of buckets in the displacement table
+    uint32_t *displacements;            // The displacement pair (d0, d1) of each bucket
+    long slots;                         // Number of slots, one per distinct hash code
+    uint64_t *codes;                    // The hash code of each slot's key
+    void **keys;                        // The key of each slot
+    void **values;                      // The value of each slot
+    long extras;                        // Number of entries kept aside
+    uint64_t *extraCodes;               // The hash codes of the entries kept aside, ascending
+    void **extraKeys;                   // The keys of the entries kept aside
+    void **extraValues;                 // The values of the entries kept aside
 };
 
 // Default capacity to assign when capacity supplied is invalid
@@ -56,65 +122,329 @@ struct hashmap {
 #define DEFAULT_LOADFACTOR 0.75
 // Maximum amount of buckets map can hold at once
 #define MAX_CAPACITY 147483647L
+// Number of chained entries carved out of each slab of the entry pool
+#define ENTRIES_PER_SLAB 1024L
+
+// Maximum amount of buckets a map using full-width hash codes can hold (must be a power of 2)
+#define MAX_POW2_CAPACITY 134217728L
+// Number of control bytes probed at once by the flat engine
+#define GROUP_WIDTH 16L
+// Highest load factor the flat engine allows, leaving room for empty slots to end probing
+#define MAX_FLAT_LOADFACTOR 0.875
+// Control byte marking an empty slot in the flat engine
+#define CTRL_EMPTY ( (int8_t)-128 )
+// Control byte marking a deleted slot in the flat engine
+#define CTRL_DELETED ( (int8_t)-2 )
+
+// Macro to check if the map `m` uses the flat, open-addressing engine
+#define IS_FLAT(m)  ( ((m)->ctrl != NULL) ? TRUE : FALSE )
+// Macro to check if the map `m` is small, holding its entries inline and scanning them linearly
+#define IS_SMALL(m)  ( ((m)->small != NULL) ? TRUE : FALSE )
+// Macro to check if the map `m` chains its entries into an array of buckets
+#define IS_CHAINED(m)  ( ((m)->buckets != NULL) ? TRUE : FALSE )
+// Macro to check if the map `m` caches full hash codes and masks its bucket indecies out of them
+#define USES_CODES(m)  ( ((m)->hashCode != NULL || (m)->seededHash != NULL) ? TRUE : FALSE )
+// Macro returning the most buckets the map `m` can hold; maps masking their hash codes stay pow2
+#define CAPACITY_LIMIT(m)  ( (USES_CODES(m) == TRUE) ? MAX_POW2_CAPACITY : MAX_CAPACITY )
+
+// Macro to add `n` to the probe counter `c` of the map `m`, only when counting probes
+#ifdef CDS_HASH_PROBE_STATS
+#define COUNT_PROBES(m, c, n)  (void)__atomic_add_fetch(&((m)->c), (n), __ATOMIC_RELAXED)
+#else
+#define COUNT_PROBES(m, c, n)
+#endif
+// Returns the control byte tag stored for the hash code `c`
+#define TAG(c)  ( (int8_t)( (c) & 0x7FUL ) )
+// Returns the first group probed for the hash code `c`, given the number of groups `n`
+#define FIRST_GROUP(c, n)  ( (long)( ( (c) >> 7 ) & (uint64_t)( (n) - 1L ) ) )
 
-Status hashmap_new(HashMap **map, long (*hash)(void *, long), int (*keyComparator)(void *, void *),
-                  long capacity, double loadFactor, void (*keyDestructor)(void *)) {
+/**
+ * Returns the number of entries a hashmap with the capacity `cap` and the load factor `loadFactor`
+ * holds before it grows, which is always at least one.
+ */
+static long _threshold(double loadFactor, long cap) {
+    long threshold = (long)(loadFactor * (double)cap);
+    return ( threshold < 1L ) ? 1L : threshold;
+}
+
+/**
+ * The engines a hashmap can be created with.
+ */
+typedef enum {
+    ENGINE_CHAINED,     // Entries are allocated one by one and chained into buckets
+    ENGINE_FLAT,        // Entries are stored inline in an open-addressing table
+    ENGINE_SMALL        // Entries are stored inline in the map, promoted to ENGINE_FLAT when full
+} Engine;
+
+/**
+ * Helper method to allocate and initialize a new hashmap with the specified attributes, then store
+ * the new instance into `*map`. Exactly one of `hash`, `hashCode` or `seededHash` is to be
+ * non-NULL, and the flat and small engines may only be selected with one of the full-width ones.
+ * Everything is allocated through `allocator`, or the default allocator if NULL.
+ */
+static Status _new_map(HashMap **map, long (*hash)(void *, long), uint64_t (*hashCode)(void *),
+                       uint64_t (*seededHash)(void *, uint64_t),
+                       int (*keyComparator)(void *, void *), long capacity, double loadFactor,
+                       void (*keyDestructor)(void *), Engine engine,
+                       const CdsAllocator *allocator) {
+
+    HmEntry **buckets = NULL, *slots = NULL;
+    NodePool *pool = NULL;
+    int8_t *ctrl = NULL;
+    Boolean flat = ( engine != ENGINE_CHAINED ) ? TRUE : FALSE;
+
+    if (allocator == NULL) {
+        allocator = allocator_default();
+    }
 
     // Allocates the struct, checks for allocation failure
-    HashMap *temp = (HashMap *)malloc(sizeof(HashMap));
+    // Small maps keep their inline storage right behind the struct, in the same allocation
+    size_t bytes = sizeof(HashMap) + ( ( engine == ENGINE_SMALL ) ? sizeof(SmallTable) : 0 );
+    HashMap *temp = (HashMap *)allocator_alloc(allocator, bytes);
     if (temp == NULL) {
         return ALLOC_FAILURE;
     }
 
     // Initializes the remaining struct members
     long cap = ( capacity <= 0L ) ? DEFAULT_CAPACITY : capacity;
-    if (cap > MAX_CAPACITY) {
+    if (engine == ENGINE_SMALL) {
+        cap = SMALL_CAPACITY;
+    } else if (hashCode != NULL || seededHash != NULL) {
+        // Bucket indecies are masked out of the hash codes, round up to the next power of 2
+        long pow2 = ( flat == TRUE ) ? GROUP_WIDTH : 1L;
+        while (pow2 < cap && pow2 < MAX_POW2_CAPACITY) {
+            pow2 *= 2L;
+        }
+        cap = pow2;
+    } else if (cap > MAX_CAPACITY) {
         cap = MAX_CAPACITY;
     }
     double ldf = ( loadFactor < 0.000001 ) ? DEFAULT_LOADFACTOR : loadFactor;
-    size_t bytes = (cap * sizeof(HmEntry *));
-    HmEntry **buckets = (HmEntry **)malloc(bytes);
+    if (flat == TRUE && ldf > MAX_FLAT_LOADFACTOR) {
+        ldf = MAX_FLAT_LOADFACTOR;
+    }
 
-    // Checks for allocation failures
-    if (buckets == NULL) {
-        free(temp);
-        return ALLOC_FAILURE;
+    // Small maps allocate neither buckets nor slots until they are promoted
+    if (engine == ENGINE_FLAT) {
+        // Flat engine stores the entries inline, guarded by one control byte per slot
+        ctrl = (int8_t *)allocator_alloc(allocator, cap * sizeof(int8_t));
+        slots = (HmEntry *)allocator_alloc(allocator, cap * sizeof(HmEntry));
+        if (ctrl == NULL || slots == NULL) {
+            allocator_free(allocator, ctrl);
+            allocator_free(allocator, slots);
+            allocator_free(allocator, temp);
+            return ALLOC_FAILURE;
+        }
+        memset(ctrl, CTRL_EMPTY, cap * sizeof(int8_t));
+    } else if (engine == ENGINE_CHAINED) {
+        buckets = (HmEntry **)allocator_alloc(allocator, cap * sizeof(HmEntry *));
+
+        // Checks for allocation failures
+        // The entries come from a private pool, so clearing the map can release them all at once
+        if (buckets == NULL ||
+            nodepool_newWithAllocator(&pool, ENTRIES_PER_SLAB, allocator) != OK) {
+            allocator_free(allocator, buckets);
+            allocator_free(allocator, temp);
+            return ALLOC_FAILURE;
+        }
+        // Need to nullify each entry in array
+        long i;
+        for (i = 0L; i < cap; i++) {
+            buckets[i] = NULL;
+        }
     }
 
     // Initializes the remaining struct members
     temp->hash = hash;
+    temp->hashCode = hashCode;
+    temp->seededHash = seededHash;
+    temp->seed = ( seededHash != NULL ) ? hashing_seed() : 0UL;
     temp->keyCmp = keyComparator;
     temp->keyDxn = keyDestructor;
     temp->buckets = buckets;
+    temp->oldBuckets = NULL;
+    temp->oldCapacity = 0L;
+    temp->rehashIndex = 0L;
+    temp->incremental = FALSE;
+    temp->pool = pool;
+    temp->ctrl = ctrl;
+    temp->slots = slots;
+    temp->tombstones = 0L;
+    temp->small = ( engine == ENGINE_SMALL ) ? (SmallTable *)(temp + 1) : NULL;
+    temp->structBytes = bytes;
+    temp->allocator = allocator;
     temp->size = 0L;
+    temp->modCount = 0L;
     temp->capacity = cap;
-    temp->changes = 0L;
-    temp->load = 0.0;
+    temp->minCapacity = cap;
+    temp->threshold = ( engine == ENGINE_SMALL ) ? SMALL_CAPACITY : _threshold(ldf, cap);
     temp->loadFactor = ldf;
-    temp->delta = ( 1.0 / (double)cap );
-    // Need to nullify each entry in array
-    long i;
-    for (i = 0L; i < cap; i++) {
-        temp->buckets[i] = NULL;
-    }
+    temp->resizes = 0L;
+    temp->resizeNanos = 0L;
+    temp->lookups = 0L;
+    temp->probes = 0L;
     *map = temp;
 
     return OK;
 }
 
+Status hashmap_new(HashMap **map, long (*hash)(void *, long), int (*keyComparator)(void *, void *),
+                  long capacity, double loadFactor, void (*keyDestructor)(void *)) {
+    return _new_map(map, hash, NULL, NULL, keyComparator, capacity, loadFactor, keyDestructor,
+                    ENGINE_CHAINED, NULL);
+}
+
+Status hashmap_newWithAllocator(HashMap **map, long (*hash)(void *, long),
+                                int (*keyComparator)(void *, void *), long capacity,
+                                double loadFactor, void (*keyDestructor)(void *),
+                                const CdsAllocator *allocator) {
+    return _new_map(map, hash, NULL, NULL, keyComparator, capacity, loadFactor, keyDestructor,
+                    ENGINE_CHAINED, allocator);
+}
+
+Status hashmap_newFullHash(HashMap **map, uint64_t (*hash)(void *),
+                           int (*keyComparator)(void *, void *), long capacity, double loadFactor,
+                           void (*keyDestructor)(void *)) {
+    return _new_map(map, NULL, hash, NULL, keyComparator, capacity, loadFactor, keyDestructor,
+                    ENGINE_CHAINED, NULL);
+}
+
+Status hashmap_newFlat(HashMap **map, uint64_t (*hash)(void *), int (*keyComparator)(void *, void *),
+                       long capacity, double loadFactor, void (*keyDestructor)(void *)) {
+    return _new_map(map, NULL, hash, NULL, keyComparator, capacity, loadFactor, keyDestructor,
+                    ENGINE_FLAT, NULL);
+}
+
+Status hashmap_newSeeded(HashMap **map, uint64_t (*hash)(void *, uint64_t),
+                         int (*keyComparator)(void *, void *), long capacity, double loadFactor,
+                         void (*keyDestructor)(void *)) {
+    return _new_map(map, NULL, NULL, hash, keyComparator, capacity, loadFactor, keyDestructor,
+                    ENGINE_CHAINED, NULL);
+}
+
+Status hashmap_newFlatSeeded(HashMap **map, uint64_t (*hash)(void *, uint64_t),
+                             int (*keyComparator)(void *, void *), long capacity,
+                             double loadFactor, void (*keyDestructor)(void *)) {
+    return _new_map(map, NULL, NULL, hash, keyComparator, capacity, loadFactor, keyDestructor,
+                    ENGINE_FLAT, NULL);
+}
+
+Status hashmap_newSmall(HashMap **map, uint64_t (*hash)(void *, uint64_t),
+                        int (*keyComparator)(void *, void *), double loadFactor,
+                        void (*keyDestructor)(void *)) {
+    return _new_map(map, NULL, NULL, hash, keyComparator, SMALL_CAPACITY, loadFactor,
+                    keyDestructor, ENGINE_SMALL, NULL);
+}
+
+/**
+ * Computes and returns the hash code of `key` to be cached in its entry. Maps using the bucket
+ * index hashing function do not cache anything, so 0 is returned. The user's hash code is mixed so
+ * that the low bits used for masking depend on all of the hash code's bits.
+ */
+static uint64_t _hash_code(HashMap *map, void *key) {
+
+    uint64_t code;
+
+    if (map->seededHash != NULL) {
+        code = map->seededHash(key, map->seed);
+    } else if (map->hashCode != NULL) {
+        code = map->hashCode(key);
+    } else {
+        return 0UL;
+    }
+    code ^= ( code >> 33 );
+    code *= 0xff51afd7ed558ccdUL;
+    code ^= ( code >> 33 );
+    return code;
+}
+
+/**
+ * Returns the index of the bucket in an array of `cap` buckets where the key `key`, whose hash code
+ * computed from _hash_code() is `code`, is to be placed.
+ */
+static long _bucket_index(HashMap *map, void *key, uint64_t code, long cap) {
+
+    if (USES_CODES(map) == TRUE) {
+        return (long)( code & (uint64_t)(cap - 1L) );
+    }
+    return map->hash(key, cap);
+}
+
+/**
+ * Struct holding the hash code and bucket index of a key, computed ahead of the key's lookup so
+ * that batch operations can prefetch its bucket while the previous keys are being processed.
+ */
+typedef struct {
+    uint64_t code;      // The key's hash code, computed from _hash_code()
+    long index;         // The key's bucket index (or first slot probed, if flat)
+    long capacity;      // The map's capacity when the index was computed
+} HashHint;
+
+/**
+ * Computes the hash code and bucket index of the key `key`, and stores them into `*hint`.
+ */
+static void _hash_key(HashMap *map, void *key, HashHint *hint) {
+
+    hint->code = _hash_code(map, key);
+    hint->capacity = map->capacity;
+    if (IS_FLAT(map) == TRUE) {
+        hint->index = FIRST_GROUP(hint->code, map->capacity / GROUP_WIDTH) * GROUP_WIDTH;
+    } else {
+        hint->index = _bucket_index(map, key, hint->code, map->capacity);
+    }
+}
+
+static HmEntry *_flat_fetch_entry(HashMap *map, void *key, uint64_t code);
+static HmEntry *_small_fetch_entry(HashMap *map, void *key, uint64_t code);
+
 /**
- * Fetches the entry from `map` given the key `key` and returns it. Also stores its index in the
- * internal array into `*index`. Returns NULL if no such entry with the key exists.
+ * Fetches the entry from `map` given the key `key`, which was hashed into `hint`, and returns it.
+ * Also stores the bucket holding the entry into `*bucket` (or if not found, the bucket where the
+ * key is to be inserted). Returns NULL if no such entry with the key exists.
  */
-static HmEntry *_fetch_entry(HashMap *map, void *key, long *index) {
+static HmEntry *_fetch_hashed(HashMap *map, void *key, HashHint *hint, HmEntry ***bucket) {
 
     HmEntry *temp;
-    long i = map->hash(key, map->capacity);
-    *index = i;
+    long i;
+    uint64_t hash = hint->code;
+
+    COUNT_PROBES(map, lookups, 1L);
+    // Flat maps probe their control bytes instead
+    if (IS_FLAT(map) == TRUE) {
+        *bucket = NULL;
+        return _flat_fetch_entry(map, key, hash);
+    }
+    if (IS_SMALL(map) == TRUE) {
+        *bucket = NULL;
+        return _small_fetch_entry(map, key, hash);
+    }
+
+    // While resizing, keys in buckets that have not been moved over yet remain in the old array
+    if (map->oldBuckets != NULL) {
+        i = _bucket_index(map, key, hash, map->oldCapacity);
+        if (i >= map->rehashIndex) {
+            for (temp = map->oldBuckets[i]; temp != NULL; temp = temp->next) {
+                COUNT_PROBES(map, probes, 1L);
+                if (temp->hash == hash && map->keyCmp(key, temp->key) == 0) {
+                    *bucket = &(map->oldBuckets[i]);
+                    return temp;
+                }
+            }
+        }
+    }
 
-    // Traverses down to bucket with key
+    // The index is stale if the map has resized since the key was hashed
+    if (hint->capacity != map->capacity) {
+        hint->index = _bucket_index(map, key, hash, map->capacity);
+        hint->capacity = map->capacity;
+    }
+    i = hint->index;
+    *bucket = &(map->buckets[i]);
+
+    // Traverses down to bucket with key, only comparing keys whose hash codes match
     for (temp = map->buckets[i]; temp != NULL; temp = temp->next) {
-        if (map->keyCmp(key, temp->key) == 0) {
+        COUNT_PROBES(map, probes, 1L);
+        if (temp->hash == hash && map->keyCmp(key, temp->key) == 0) {
             break;
         }
     }
@@ -122,12 +452,28 @@ static HmEntry *_fetch_entry(HashMap *map, void *key, long *index) {
 }
 
 /**
- * Allocates and returns a new hashmap entry ADT with the key-value pairing `key` and `value`.
+ * Fetches the entry from `map` given the key `key` and returns it. Also stores the bucket holding
+ * the entry into `*bucket` (or if not found, the bucket where the key is to be inserted), and the
+ * key's hash code into `*code`. Returns NULL if no such entry with the key exists.
+ */
+static HmEntry *_fetch_entry(HashMap *map, void *key, HmEntry ***bucket, uint64_t *code) {
+
+    HashHint hint;
+
+    _hash_key(map, key, &hint);
+    *code = hint.code;
+    return _fetch_hashed(map, key, &hint, bucket);
+}
+
+/**
+ * Allocates and returns a new hashmap entry ADT from the pool of `map`, with the key-value pairing
+ * `key` and `value`, and the key's hash code `code`.
  */
-static HmEntry *_malloc_entry(char *key, void *value) {
+static HmEntry *_malloc_entry(HashMap *map, char *key, void *value, uint64_t code) {
 
-    HmEntry *entry = (HmEntry *)malloc(sizeof(HmEntry));
+    HmEntry *entry = (HmEntry *)nodepool_alloc(map->pool, sizeof(HmEntry));
     if (entry != NULL) {
+        entry->hash = code;
         entry->key = key;
         entry->value = value;
         entry->next = NULL;
@@ -137,325 +483,2046 @@ static HmEntry *_malloc_entry(char *key, void *value) {
 }
 
 /**
- * Resizes the hashmap by doubling its capacity once its loadfactor is reached.
+ * Allocates and returns an array of `cap` empty buckets for `map`, or NULL if allocation fails.
  */
-static void _resize_map(HashMap *map) {
+static HmEntry **_alloc_buckets(HashMap *map, long cap) {
 
-    HmEntry **buckets, *temp, *next;
-    size_t bytes;
-    long i, index, cap = ( map->capacity * 2 );
+    size_t bytes = (cap * sizeof(HmEntry *));
+    HmEntry **buckets = (HmEntry **)allocator_alloc(map->allocator, bytes);
+    if (buckets != NULL) {
+        long i;
+        for (i = 0L; i < cap; i++) {
+            buckets[i] = NULL;
+        }
+    }
+
+    return buckets;
+}
+
+/**
+ * Moves every entry in the old bucket `i` over into the current array of buckets.
+ */
+static void _rehash_bucket(HashMap *map, long i) {
+
+    HmEntry *temp, *next;
+    long index;
+
+    // Maps with cached hash codes only need to re-mask, and never call the user's hash again
+    temp = map->oldBuckets[i];
+    while (temp != NULL) {
+        next = temp->next;
+        index = _bucket_index(map, temp->key, temp->hash, map->capacity);
+        temp->next = map->buckets[index];
+        map->buckets[index] = temp;
+        temp = next;
+    }
+    map->oldBuckets[i] = NULL;
+}
+
+/**
+ * Returns the current time of the monotonic clock, in nanoseconds.
+ */
+static long _now_nanos(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ( ts.tv_sec * 1000000000L ) + ts.tv_nsec;
+}
+
+// Number of old buckets moved per insertion or removal during an incremental resize
+#define REHASH_STEPS 4L
+// Maximum number of empty old buckets skipped over per rehashed bucket
+#define REHASH_EMPTY_VISITS 10L
+
+/**
+ * Performs one step of an incremental resize, moving at most `steps` non-empty old buckets over
+ * into the current array of buckets. Once every old bucket has been moved, the old array is freed.
+ */
+static void _rehash_step(HashMap *map, long steps) {
+
+    long visits = ( steps * REHASH_EMPTY_VISITS ), start = _now_nanos();
+
+    // Entries change buckets, which invalidates any cursors
+    map->modCount++;
+
+    while (steps > 0L && map->rehashIndex < map->oldCapacity) {
+        if (map->oldBuckets[map->rehashIndex] != NULL) {
+            _rehash_bucket(map, map->rehashIndex);
+            steps--;
+        } else if (--visits == 0L) {
+            break;
+        }
+        map->rehashIndex++;
+    }
+
+    // Resize is complete, release the old buckets
+    if (map->rehashIndex == map->oldCapacity) {
+        allocator_free(map->allocator, map->oldBuckets);
+        map->oldBuckets = NULL;
+        map->oldCapacity = 0L;
+        map->rehashIndex = 0L;
+    }
+    map->resizeNanos += ( _now_nanos() - start );
+}
+
+/**
+ * Finishes the incremental resize currently in progress, if any.
+ */
+static void _rehash_all(HashMap *map) {
+
+    if (map->oldBuckets != NULL) {
+        _rehash_step(map, map->oldCapacity);
+    }
+}
+
+/**
+ * Resizes the hashmap to `cap` buckets, normally double its capacity once its loadfactor is
+ * reached. If the map resizes incrementally, the entries are left in the old buckets and moved over
+ * by later operations.
+ */
+static void _resize_map(HashMap *map, long cap) {
+
+    HmEntry **buckets;
+    long start;
+    CDS_STATS_BEGIN();
+
+    // Only one resize may be in progress at a time
+    _rehash_all(map);
+    start = _now_nanos();
 
     // Do not extend if absolute max capacity is reached
-    if (cap > MAX_CAPACITY) {
+    if (USES_CODES(map) == TRUE) {
+        if (cap > MAX_POW2_CAPACITY) {
+            return;
+        }
+    } else if (cap > MAX_CAPACITY) {
         cap = MAX_CAPACITY;
     }
     // Allocate the new array of buckets
-    bytes = (cap * sizeof(HmEntry *));
-    buckets = (HmEntry **)malloc(bytes);
+    buckets = _alloc_buckets(map, cap);
     if (buckets == NULL) {
         return;
     }
-    for (i = 0L; i < cap; i++) {
-        buckets[i] = NULL;
-    }
+
+    // Keep the current buckets around as the old buckets to rehash from
+    map->oldBuckets = map->buckets;
+    map->oldCapacity = map->capacity;
+    map->rehashIndex = 0L;
+    map->buckets = buckets;
+    map->capacity = cap;
+    map->resizeNanos += ( _now_nanos() - start );
 
     // After resize, need to rehash all existing entries into new indecies
-    for (i = 0L; i < map->capacity; i++) {
-        temp = map->buckets[i];
-        while (temp != NULL) {
-            next = temp->next;
-            index = map->hash(temp->key, cap);
-            temp->next = buckets[index];
-            buckets[index] = temp;
-            temp = next;
-        }
+    if (map->incremental == FALSE) {
+        _rehash_all(map);
     }
 
     // Update the hashmap attributes after resize
-    free(map->buckets);
-    map->buckets = buckets;
-    map->capacity = cap;
-    map->delta = ( 1.0 / (double)cap );
-    map->changes = 0L;
-    map->load /= 2.0;
+    map->threshold = _threshold(map->loadFactor, cap);
+    map->resizes++;
+    map->modCount++;
+    CDS_STATS_END(CDS_EVENT_HASHMAP_RESIZE);
 }
 
-// Default trigger: check load factor after this many map changes
-#define TRIGGER 100L
-
-// Macro to check if the map `m` is currently empty
-#define IS_EMPTY(m)  ( ((m)->size == 0L) ? TRUE : FALSE )
-
-Status hashmap_put(HashMap *map, void *key, void *value, void **previous) {
-
-    Status status;
-
-    // Checks the load factor, resize when needed
-    if (map->changes >= TRIGGER) {
-        map->changes = 0L;
-        if (map->load >= map->loadFactor && map->capacity < MAX_CAPACITY) {
-            _resize_map(map);
+/**
+ * Returns a bitmask of the slots in the group of control bytes `group` whose control byte equals
+ * `tag`, where bit i is set if slot i matches.
+ */
+static uint32_t _group_match(const int8_t *group, int8_t tag) {
+#if defined(__SSE2__)
+    __m128i ctrl = _mm_loadu_si128((const __m128i *)group);
+    return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(tag)));
+#else
+    uint32_t mask = 0U;
+    long i;
+    for (i = 0L; i < GROUP_WIDTH; i++) {
+        if (group[i] == tag) {
+            mask |= ( 1U << i );
         }
     }
+    return mask;
+#endif
+}
 
+/**
+ * Returns a bitmask of the slots in the group of control bytes `group` that are either empty or
+ * deleted, where bit i is set if slot i is available.
+ */
+static uint32_t _group_match_available(const int8_t *group) {
+#if defined(__SSE2__)
+    __m128i ctrl = _mm_loadu_si128((const __m128i *)group);
+    return (uint32_t)_mm_movemask_epi8(ctrl);
+#else
+    uint32_t mask = 0U;
     long i;
-    HmEntry *temp = _fetch_entry(map, key, &i);
-    if (temp != NULL) {
-        // Entry already exists, replace the existing entry
-        *previous = temp->value;
-        temp->value = value;
-        map->changes++;
-        status = REPLACED;
-    } else {
-        // Otherwise, allocate and insert the new entry
-        HmEntry *entry = _malloc_entry(key, value);
-        if (entry != NULL) {
-            // Add bucket into targeted index
-            entry->next = map->buckets[i];
-            map->buckets[i] = entry;
-            map->changes++;
-            map->load += map->delta;
-            map->size++;
-            status = INSERTED;
-        } else {
-            status = ALLOC_FAILURE;
+    for (i = 0L; i < GROUP_WIDTH; i++) {
+        if (group[i] < 0) {
+            mask |= ( 1U << i );
         }
     }
-
-    return status;
+    return mask;
+#endif
 }
 
-Boolean hashmap_containsKey(HashMap *map, void *key) {
-    long i;
-    return ( _fetch_entry(map, key, &i) != NULL ) ? TRUE : FALSE;
+/**
+ * Fetches the entry from the flat map `map` given the key `key` and its hash code `code`, and
+ * returns it. Probing advances one group of control bytes at a time, and ends at the first group
+ * that has an empty slot. Returns NULL if no such entry with the key exists.
+ */
+static HmEntry *_flat_fetch_entry(HashMap *map, void *key, uint64_t code) {
+
+    long ngroups = ( map->capacity / GROUP_WIDTH ), step;
+    long g = FIRST_GROUP(code, ngroups);
+    int8_t tag = TAG(code);
+    uint32_t bits;
+
+    for (step = 1L; step <= ngroups; step++) {
+        int8_t *group = &(map->ctrl[g * GROUP_WIDTH]);
+        COUNT_PROBES(map, probes, 1L);
+        // Only compare the keys in slots whose tags and hash codes both match
+        for (bits = _group_match(group, tag); bits != 0U; bits &= ( bits - 1U )) {
+            HmEntry *entry = &(map->slots[(g * GROUP_WIDTH) + __builtin_ctz(bits)]);
+            if (entry->hash == code && map->keyCmp(key, entry->key) == 0) {
+                return entry;
+            }
+        }
+        if (_group_match(group, CTRL_EMPTY) != 0U) {
+            break;
+        }
+        // Triangular probing visits each group exactly once for power of 2 group counts
+        g = ( ( g + step ) & ( ngroups - 1L ) );
+    }
+
+    return NULL;
 }
 
-Status hashmap_get(HashMap *map, void *key, void **value) {
+/**
+ * Returns the index of the first available (empty or deleted) slot along the probe sequence of the
+ * hash code `code` in the control bytes `ctrl` holding `cap` slots, or -1 if the table is full.
+ */
+static long _flat_find_slot(int8_t *ctrl, long cap, uint64_t code) {
 
-    // Checks if the map is currently empty
-    if (IS_EMPTY(map) == TRUE) {
-        return STRUCT_EMPTY;
-    }
+    long ngroups = ( cap / GROUP_WIDTH ), step;
+    long g = FIRST_GROUP(code, ngroups);
+    uint32_t bits;
 
-    // Fetches the node with the specified key
-    long index;
-    HmEntry *temp = _fetch_entry(map, key, &index);
-    if (temp == NULL) {
-        return NOT_FOUND;
+    for (step = 1L; step <= ngroups; step++) {
+        bits = _group_match_available(&(ctrl[g * GROUP_WIDTH]));
+        if (bits != 0U) {
+            return ( g * GROUP_WIDTH ) + __builtin_ctz(bits);
+        }
+        g = ( ( g + step ) & ( ngroups - 1L ) );
     }
-    // Retrieves the value, saves into pointer
-    *value = temp->value;
 
-    return OK;
+    return -1L;
 }
 
-Status hashmap_remove(HashMap *map, void *key, void **value) {
+/**
+ * Rehashes all of the flat map's entries into a table of `cap` slots, dropping all tombstones.
+ * Returns TRUE if successful, FALSE if allocation fails (the map is left untouched).
+ */
+static Boolean _flat_rehash(HashMap *map, long cap) {
+
+    HmEntry *slots;
+    int8_t *ctrl;
+    long i, j, start = _now_nanos();
+
+    // Allocate the new table, all slots start out empty
+    ctrl = (int8_t *)allocator_alloc(map->allocator, cap * sizeof(int8_t));
+    slots = (HmEntry *)allocator_alloc(map->allocator, cap * sizeof(HmEntry));
+    if (ctrl == NULL || slots == NULL) {
+        allocator_free(map->allocator, ctrl);
+        allocator_free(map->allocator, slots);
+        return FALSE;
+    }
+    memset(ctrl, CTRL_EMPTY, cap * sizeof(int8_t));
 
-    // Checks if the map is currently empty
-    if (IS_EMPTY(map) == TRUE) {
-        return STRUCT_EMPTY;
+    // Moves each live entry over using its cached hash code, no key comparisons are needed
+    for (i = 0L; i < map->capacity; i++) {
+        if (map->ctrl[i] >= 0) {
+            j = _flat_find_slot(ctrl, cap, map->slots[i].hash);
+            ctrl[j] = map->ctrl[i];
+            slots[j] = map->slots[i];
+        }
     }
 
-    // Fetches the node with the specified key
+    // Update the hashmap attributes after the rehash
+    allocator_free(map->allocator, map->ctrl);
+    allocator_free(map->allocator, map->slots);
+    map->ctrl = ctrl;
+    map->slots = slots;
+    map->capacity = cap;
+    map->threshold = _threshold(map->loadFactor, cap);
+    map->tombstones = 0L;
+    map->resizes++;
+    map->resizeNanos += ( _now_nanos() - start );
+    map->modCount++;
+
+    return TRUE;
+}
+
+/**
+ * Inserts or replaces the mapping `key` -> `value` in the flat map `map`, where `code` is the key's
+ * hash code, with the same semantics as hashmap_put().
+ */
+static Status _flat_put(HashMap *map, void *key, uint64_t code, void *value, void **previous) {
+
+    HmEntry *entry = _flat_fetch_entry(map, key, code);
     long i;
-    HmEntry *temp = _fetch_entry(map, key, &i);
-    if (temp == NULL) {
-        return NOT_FOUND;
+
+    if (entry != NULL) {
+        // Entry already exists, replace the existing entry
+        *previous = entry->value;
+        entry->value = value;
+        return REPLACED;
     }
 
-    // Fetch the node with the key's entry
-    HmEntry *prev = NULL, *curr = map->buckets[i];
-    while (curr != temp) {
-        prev = curr;
-        curr = curr->next;
+    // Grow once the occupied slots (including tombstones) reach the load factor
+    // If most of them are tombstones, rehashing in place is enough to reclaim them
+    if (map->size + map->tombstones + 1L > map->threshold) {
+        long cap = map->capacity;
+        if (map->size + 1L > map->threshold / 2L) {
+            cap *= 2L;
+        }
+        if (cap <= MAX_POW2_CAPACITY) {
+            if (_flat_rehash(map, cap) == FALSE) {
+                return ALLOC_FAILURE;
+            }
+        } else if (map->size + map->tombstones + 1L > map->capacity) {
+            return ALLOC_FAILURE;
+        }
     }
 
-    // Relink nodes so that entry is removed
-    if (prev == NULL) {
-        map->buckets[i] = temp->next;
-    } else {
-        prev->next = temp->next;
+    i = _flat_find_slot(map->ctrl, map->capacity, code);
+    if (i < 0L) {
+        return ALLOC_FAILURE;
+    }
+    if (map->ctrl[i] == CTRL_DELETED) {
+        map->tombstones--;
     }
+    map->ctrl[i] = TAG(code);
+    map->slots[i].next = NULL;
+    map->slots[i].hash = code;
+    map->slots[i].key = key;
+    map->slots[i].value = value;
+    map->size++;
+    map->modCount++;
+
+    return INSERTED;
+}
 
-    // Free allocated node and attributes
-    *value = temp->value;
-    if (map->keyDxn != NULL) {
-        (*map->keyDxn)(temp->key);
+/**
+ * Removes the entry `entry` from the flat map `map`. The slot is marked empty if its group still
+ * has an empty slot (no probe could have continued past it), otherwise it becomes a tombstone.
+ */
+static void _flat_remove_entry(HashMap *map, HmEntry *entry) {
+
+    long i = ( entry - map->slots );
+    int8_t *group = &(map->ctrl[i - ( i % GROUP_WIDTH )]);
+
+    if (_group_match(group, CTRL_EMPTY) != 0U) {
+        map->ctrl[i] = CTRL_EMPTY;
+    } else {
+        map->ctrl[i] = CTRL_DELETED;
+        map->tombstones++;
     }
-    free(temp);
-    map->changes++;
-    map->load -= map->delta;
     map->size--;
-
-    return OK;
+    map->modCount++;
 }
 
+static long _fit_capacity(HashMap *map, long n);
+
 /**
- * Helper method to clear out the hashmap `map` of all its elements, applying the destructor method
- * `destructor` on each element (or if NULL, nothing will be done to the elements).
+ * Fetches the entry from the small map `map` given the key `key` and its hash code `code`, and
+ * returns it. The cached hash codes are scanned linearly, and keys are only compared when their
+ * hash codes match. Returns NULL if no such entry with the key exists.
  */
-static void _clear_map(HashMap *map, void (*valueDestructor)(void *)) {
+static HmEntry *_small_fetch_entry(HashMap *map, void *key, uint64_t code) {
 
-    HmEntry *temp, *next;
+    SmallTable *table = map->small;
     long i;
 
-    for (i = 0L; i < map->capacity; i++) {
-        temp = map->buckets[i];
-        while (temp != NULL) {
-            next = temp->next;
-            // Deallocate the node and attributes
+    for (i = 0L; i < map->size; i++) {
+        COUNT_PROBES(map, probes, 1L);
+        if (table->codes[i] == code && map->keyCmp(key, table->entries[i].key) == 0) {
+            return &(table->entries[i]);
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * Promotes the small map `map` to a flat table of `cap` slots, moving its entries over using their
+ * cached hash codes. Returns TRUE if successful, FALSE if allocation fails (the map stays small).
+ */
+static Boolean _small_promote(HashMap *map, long cap) {
+
+    SmallTable *table = map->small;
+    HmEntry *slots;
+    int8_t *ctrl;
+    long i, j, start = _now_nanos();
+
+    ctrl = (int8_t *)allocator_alloc(map->allocator, cap * sizeof(int8_t));
+    slots = (HmEntry *)allocator_alloc(map->allocator, cap * sizeof(HmEntry));
+    if (ctrl == NULL || slots == NULL) {
+        allocator_free(map->allocator, ctrl);
+        allocator_free(map->allocator, slots);
+        return FALSE;
+    }
+    memset(ctrl, CTRL_EMPTY, cap * sizeof(int8_t));
+    for (i = 0L; i < map->size; i++) {
+        j = _flat_find_slot(ctrl, cap, table->codes[i]);
+        ctrl[j] = TAG(table->codes[i]);
+        slots[j] = table->entries[i];
+    }
+
+    // The inline storage stays behind in the map's allocation, but is never used again
+    map->ctrl = ctrl;
+    map->slots = slots;
+    map->small = NULL;
+    map->capacity = cap;
+    map->minCapacity = GROUP_WIDTH;
+    map->threshold = _threshold(map->loadFactor, cap);
+    map->resizes++;
+    map->resizeNanos += ( _now_nanos() - start );
+    map->modCount++;
+
+    return TRUE;
+}
+
+/**
+ * Inserts or replaces the mapping `key` -> `value` in the small map `map`, where `code` is the
+ * key's hash code, with the same semantics as hashmap_put(). Inserting into a full map promotes it.
+ */
+static Status _small_put(HashMap *map, void *key, uint64_t code, void *value, void **previous) {
+
+    SmallTable *table = map->small;
+    HmEntry *entry = _small_fetch_entry(map, key, code);
+
+    if (entry != NULL) {
+        // Entry already exists, replace the existing entry
+        *previous = entry->value;
+        entry->value = value;
+        return REPLACED;
+    }
+
+    if (map->size == SMALL_CAPACITY) {
+        if (_small_promote(map, _fit_capacity(map, map->size + 1L)) == FALSE) {
+            return ALLOC_FAILURE;
+        }
+        return _flat_put(map, key, code, value, previous);
+    }
+
+    // Appends the new entry behind the others
+    entry = &(table->entries[map->size]);
+    entry->next = NULL;
+    entry->hash = code;
+    entry->key = key;
+    entry->value = value;
+    table->codes[map->size] = code;
+    map->size++;
+    map->modCount++;
+
+    return INSERTED;
+}
+
+/**
+ * Removes the entry `entry` from the small map `map`, moving the last entry into its place so the
+ * entries stay packed at the front.
+ */
+static void _small_remove_entry(HashMap *map, HmEntry *entry) {
+
+    SmallTable *table = map->small;
+    long i = ( entry - table->entries ), last = ( map->size - 1L );
+
+    if (i != last) {
+        table->entries[i] = table->entries[last];
+        table->codes[i] = table->codes[last];
+    }
+    map->size--;
+    map->modCount++;
+}
+
+/**
+ * Returns the next live entry of the hashmap `map` after `prev`, which resides in the bucket (or
+ * slot) `*index`, and updates `*index` accordingly. Passing a NULL `prev` and an index of -1 yields
+ * the first entry. Returns NULL once all entries have been visited. While resizing, indecies past
+ * the map's capacity refer to the buckets that have yet to be moved out of the old array.
+ */
+static HmEntry *_next_entry(HashMap *map, HmEntry *prev, long *index) {
+
+    long i = *index;
+
+    if (IS_SMALL(map) == TRUE) {
+        if (++i < map->size) {
+            *index = i;
+            return &(map->small->entries[i]);
+        }
+    } else if (IS_FLAT(map) == TRUE) {
+        for (i++; i < map->capacity; i++) {
+            if (map->ctrl[i] >= 0) {
+                *index = i;
+                return &(map->slots[i]);
+            }
+        }
+    } else {
+        if (prev != NULL && prev->next != NULL) {
+            return prev->next;
+        }
+        for (i++; i < map->capacity; i++) {
+            if (map->buckets[i] != NULL) {
+                *index = i;
+                return map->buckets[i];
+            }
+        }
+        for (; i < map->capacity + map->oldCapacity; i++) {
+            if (map->oldBuckets[i - map->capacity] != NULL) {
+                *index = i;
+                return map->oldBuckets[i - map->capacity];
+            }
+        }
+    }
+    *index = map->capacity + map->oldCapacity;
+
+    return NULL;
+}
+
+// Macro to check if the map `m` is currently empty
+#define IS_EMPTY(m)  ( ((m)->size == 0L) ? TRUE : FALSE )
+
+void hashmap_setIncrementalResize(HashMap *map, Boolean incremental) {
+
+    map->incremental = incremental;
+    if (incremental == FALSE) {
+        _rehash_all(map);
+    }
+}
+
+/**
+ * Inserts or replaces the mapping `key` -> `value` in the hashmap `map`, where the key was hashed
+ * into `hint`, with the same semantics as hashmap_put().
+ */
+static Status _put_hashed(HashMap *map, void *key, HashHint *hint, void *value, void **previous) {
+
+    Status status;
+
+    if (IS_FLAT(map) == TRUE) {
+        return _flat_put(map, key, hint->code, value, previous);
+    }
+    if (IS_SMALL(map) == TRUE) {
+        return _small_put(map, key, hint->code, value, previous);
+    }
+
+    // Moves along the incremental resize in progress
+    if (map->oldBuckets != NULL) {
+        _rehash_step(map, REHASH_STEPS);
+    }
+
+    HmEntry **bucket;
+    HmEntry *temp = _fetch_hashed(map, key, hint, &bucket);
+    if (temp != NULL) {
+        // Entry already exists, replace the existing entry
+        *previous = temp->value;
+        temp->value = value;
+        status = REPLACED;
+    } else {
+        // Grows the map before its size would exceed the load factor
+        if (map->size >= map->threshold && map->capacity < CAPACITY_LIMIT(map)) {
+            _resize_map(map, map->capacity * 2L);
+            (void)_fetch_hashed(map, key, hint, &bucket);
+        }
+        // Otherwise, allocate and insert the new entry
+        HmEntry *entry = _malloc_entry(map, key, value, hint->code);
+        if (entry != NULL) {
+            // Add bucket into targeted index
+            entry->next = *bucket;
+            *bucket = entry;
+            map->size++;
+            map->modCount++;
+            status = INSERTED;
+        } else {
+            status = ALLOC_FAILURE;
+        }
+    }
+
+    return status;
+}
+
+Status hashmap_put(HashMap *map, void *key, void *value, void **previous) {
+
+    HashHint hint;
+    CDS_STATS_BEGIN();
+
+    _hash_key(map, key, &hint);
+    Status status = _put_hashed(map, key, &hint, value, previous);
+    CDS_STATS_END(CDS_PROBE_HASHMAP_PUT);
+
+    return status;
+}
+
+Boolean hashmap_containsKey(HashMap *map, void *key) {
+    HmEntry **bucket;
+    uint64_t code;
+    return ( _fetch_entry(map, key, &bucket, &code) != NULL ) ? TRUE : FALSE;
+}
+
+/**
+ * Looks up the value of the key, the body of hashmap_get().
+ */
+static Status _get_value(HashMap *map, void *key, void **value) {
+
+    // Checks if the map is currently empty
+    if (IS_EMPTY(map) == TRUE) {
+        return STRUCT_EMPTY;
+    }
+
+    // Fetches the node with the specified key
+    HmEntry **bucket;
+    uint64_t code;
+    HmEntry *temp = _fetch_entry(map, key, &bucket, &code);
+    if (temp == NULL) {
+        return NOT_FOUND;
+    }
+    // Retrieves the value, saves into pointer
+    *value = temp->value;
+
+    return OK;
+}
+
+Status hashmap_get(HashMap *map, void *key, void **value) {
+
+    CDS_STATS_BEGIN();
+    Status status = _get_value(map, key, value);
+    CDS_STATS_END(CDS_PROBE_HASHMAP_GET);
+
+    return status;
+}
+
+/**
+ * Halves the capacity of the hashmap `map` once its size has drained below a quarter of its
+ * threshold, so a map that spikes and drains does not keep holding its peak-size table. The map
+ * never shrinks below the capacity it was created with.
+ */
+static void _shrink_map(HashMap *map) {
+
+    long cap = ( map->capacity / 2L );
+
+    if (map->size >= map->threshold / 4L || cap < map->minCapacity) {
+        return;
+    }
+    if (IS_FLAT(map) == TRUE) {
+        (void)_flat_rehash(map, cap);
+    } else {
+        _resize_map(map, cap);
+    }
+}
+
+/**
+ * Removes the mapping for the key `key`, which was hashed into `hint`, from the non-empty hashmap
+ * `map`, with the same semantics as hashmap_remove().
+ */
+static Status _remove_hashed(HashMap *map, void *key, HashHint *hint, void **value) {
+
+    // Moves along the incremental resize in progress
+    if (map->oldBuckets != NULL) {
+        _rehash_step(map, REHASH_STEPS);
+    }
+
+    // Fetches the node with the specified key
+    HmEntry **bucket;
+    HmEntry *temp = _fetch_hashed(map, key, hint, &bucket);
+    if (temp == NULL) {
+        return NOT_FOUND;
+    }
+
+    // Flat and small maps only need to release the slot
+    if (IS_FLAT(map) == TRUE || IS_SMALL(map) == TRUE) {
+        *value = temp->value;
+        if (map->keyDxn != NULL) {
+            (*map->keyDxn)(temp->key);
+        }
+        if (IS_SMALL(map) == TRUE) {
+            _small_remove_entry(map, temp);
+        } else {
+            _flat_remove_entry(map, temp);
+            _shrink_map(map);
+        }
+        return OK;
+    }
+
+    // Fetch the node with the key's entry
+    HmEntry *prev = NULL, *curr = *bucket;
+    while (curr != temp) {
+        prev = curr;
+        curr = curr->next;
+    }
+
+    // Relink nodes so that entry is removed
+    if (prev == NULL) {
+        *bucket = temp->next;
+    } else {
+        prev->next = temp->next;
+    }
+
+    // Free allocated node and attributes
+    *value = temp->value;
+    if (map->keyDxn != NULL) {
+        (*map->keyDxn)(temp->key);
+    }
+    nodepool_free(map->pool, temp, sizeof(HmEntry));
+    map->size--;
+    map->modCount++;
+    _shrink_map(map);
+
+    return OK;
+}
+
+Status hashmap_remove(HashMap *map, void *key, void **value) {
+
+    HashHint hint;
+
+    // Checks if the map is currently empty
+    if (IS_EMPTY(map) == TRUE) {
+        return STRUCT_EMPTY;
+    }
+
+    _hash_key(map, key, &hint);
+    return _remove_hashed(map, key, &hint, value);
+}
+
+// Number of keys that batch operations hash and prefetch ahead of the key being processed
+#define PREFETCH_DISTANCE 8L
+
+/**
+ * Hashes the key `key` into `*hint` ahead of its lookup, and prefetches the bucket (or the group of
+ * control bytes and slots) the lookup will start from.
+ */
+static void _prefetch_key(HashMap *map, void *key, HashHint *hint) {
+
+    _hash_key(map, key, hint);
+    if (IS_FLAT(map) == TRUE) {
+        __builtin_prefetch(&(map->ctrl[hint->index]));
+        __builtin_prefetch(&(map->slots[hint->index]));
+    } else if (IS_CHAINED(map) == TRUE) {
+        __builtin_prefetch(&(map->buckets[hint->index]));
+    }
+}
+
+/**
+ * Starts the prefetch window `hints` of a batch operation over the `n` keys in `keys`, prefetching
+ * the first PREFETCH_DISTANCE keys.
+ */
+static void _start_window(HashMap *map, void **keys, long n, HashHint *hints) {
+
+    long i;
+    for (i = 0L; i < n && i < PREFETCH_DISTANCE; i++) {
+        _prefetch_key(map, keys[i], &(hints[i]));
+    }
+}
+
+/**
+ * Takes the hint of the `i`th key out of the prefetch window `hints` into `*hint`, and refills its
+ * place with the key PREFETCH_DISTANCE places further along. Chained maps also prefetch the first
+ * entry in the bucket of the key halfway along the window, whose bucket has arrived by now.
+ */
+static void _advance_window(HashMap *map, void **keys, long n, long i, HashHint *hints,
+                            HashHint *hint) {
+
+    long slot = ( i % PREFETCH_DISTANCE ), j;
+
+    *hint = hints[slot];
+    if (i + PREFETCH_DISTANCE < n) {
+        _prefetch_key(map, keys[i + PREFETCH_DISTANCE], &(hints[slot]));
+    }
+    j = ( i + PREFETCH_DISTANCE / 2L );
+    if (IS_CHAINED(map) == TRUE && j < n) {
+        HashHint *ahead = &(hints[j % PREFETCH_DISTANCE]);
+        if (ahead->capacity == map->capacity) {
+            __builtin_prefetch(map->buckets[ahead->index]);
+        }
+    }
+}
+
+/**
+ * Returns the smallest capacity the hashmap `map` can take on while holding `n` entries under its
+ * load factor, which is always a power of two (of at least one group, if flat) for the maps that
+ * mask their hash codes.
+ */
+static long _fit_capacity(HashMap *map, long n) {
+
+    long cap, limit = CAPACITY_LIMIT(map);
+
+    if (USES_CODES(map) == TRUE) {
+        // Small maps are always promoted to a flat table
+        cap = ( IS_FLAT(map) == TRUE || IS_SMALL(map) == TRUE ) ? GROUP_WIDTH : 1L;
+        while (n > _threshold(map->loadFactor, cap) && cap < limit) {
+            cap *= 2L;
+        }
+    } else {
+        cap = (long)((double)n / map->loadFactor);
+        cap = ( cap < 1L ) ? 1L : ( cap > limit ) ? limit : cap;
+        while (n > _threshold(map->loadFactor, cap) && cap < limit) {
+            cap++;
+        }
+    }
+
+    return cap;
+}
+
+/**
+ * Grows the hashmap `map` so that `n` more entries fit under its load factor with at most one
+ * resize, rather than doubling repeatedly along the way.
+ */
+static Status _reserve(HashMap *map, long n) {
+
+    long cap = _fit_capacity(map, map->size + n);
+
+    if (IS_SMALL(map) == TRUE) {
+        // Small maps only need promoting once the entries no longer fit inline
+        if (map->size + n > SMALL_CAPACITY && _small_promote(map, cap) == FALSE) {
+            return ALLOC_FAILURE;
+        }
+    } else if (IS_FLAT(map) == TRUE) {
+        // Rehashing also drops the tombstones, which count against the load factor
+        if (cap > map->capacity || map->size + n + map->tombstones > map->threshold) {
+            if (_flat_rehash(map, ( cap > map->capacity ) ? cap : map->capacity) == FALSE) {
+                return ALLOC_FAILURE;
+            }
+        }
+    } else if (cap > map->capacity) {
+        _resize_map(map, cap);
+        if (map->capacity != cap) {
+            return ALLOC_FAILURE;
+        }
+    }
+
+    return OK;
+}
+
+Status hashmap_reserve(HashMap *map, long n) {
+
+    Status status = _reserve(map, ( n > map->size ) ? n - map->size : 0L);
+
+    // The reserved capacity must survive removals until the map is explicitly shrunk
+    if (status == OK && map->capacity > map->minCapacity) {
+        map->minCapacity = map->capacity;
+    }
+
+    return status;
+}
+
+Status hashmap_shrinkToFit(HashMap *map) {
+
+    long cap = _fit_capacity(map, map->size);
+
+    // Small maps already hold no spare storage of their own
+    if (IS_SMALL(map) == TRUE) {
+        return OK;
+    }
+    map->minCapacity = cap;
+    if (IS_FLAT(map) == TRUE) {
+        if (cap < map->capacity || map->tombstones > 0L) {
+            if (_flat_rehash(map, ( cap < map->capacity ) ? cap : map->capacity) == FALSE) {
+                return ALLOC_FAILURE;
+            }
+        }
+    } else if (cap < map->capacity) {
+        _resize_map(map, cap);
+        if (map->capacity != cap) {
+            return ALLOC_FAILURE;
+        }
+    }
+
+    return OK;
+}
+
+Status hashmap_putAll(HashMap *map, void **keys, void **values, long n, void **previous) {
+
+    HashHint hints[PREFETCH_DISTANCE], hint;
+    void *replaced;
+    long i;
+
+    // Sizes the table for the whole batch up front, as if none of its keys were present yet. This
+    // is only a head start: a failed reservation leaves the map as it was, and each put below still
+    // grows the map or reports ALLOC_FAILURE itself, so a batch of mostly known keys still fits
+    (void)_reserve(map, n);
+    _start_window(map, keys, n, hints);
+
+    for (i = 0L; i < n; i++) {
+        _advance_window(map, keys, n, i, hints, &hint);
+        replaced = NULL;
+        if (_put_hashed(map, keys[i], &hint, values[i], &replaced) == ALLOC_FAILURE) {
+            return ALLOC_FAILURE;
+        }
+        if (previous != NULL) {
+            previous[i] = replaced;
+        }
+    }
+
+    return OK;
+}
+
+long hashmap_getAll(HashMap *map, void **keys, void **values, long n) {
+
+    HashHint hints[PREFETCH_DISTANCE], hint;
+    HmEntry **bucket, *temp;
+    long i, found = 0L;
+
+    // Nothing to look up if the map is empty
+    if (IS_EMPTY(map) == TRUE) {
+        for (i = 0L; i < n; i++) {
+            values[i] = NULL;
+        }
+        return 0L;
+    }
+
+    _start_window(map, keys, n, hints);
+    for (i = 0L; i < n; i++) {
+        _advance_window(map, keys, n, i, hints, &hint);
+        temp = _fetch_hashed(map, keys[i], &hint, &bucket);
+        if (temp != NULL) {
+            values[i] = temp->value;
+            found++;
+        } else {
+            values[i] = NULL;
+        }
+    }
+
+    return found;
+}
+
+/**
+ * Number of keys hashed and prefetched together by hashmap_getMany() before any of them is probed.
+ */
+#define LOOKUP_GROUP 16L
+
+long hashmap_getMany(HashMap *map, void **keys, long n, void **values, Status *statuses) {
+
+    HashHint hints[LOOKUP_GROUP];
+    HmEntry **bucket, *temp;
+    long i, j, count, found = 0L;
+
+    // Nothing to look up if the map is empty
+    if (IS_EMPTY(map) == TRUE) {
+        for (i = 0L; i < n; i++) {
+            values[i] = NULL;
+            if (statuses != NULL) {
+                statuses[i] = STRUCT_EMPTY;
+            }
+        }
+        return 0L;
+    }
+
+    for (i = 0L; i < n; i += LOOKUP_GROUP) {
+        count = ( n - i < LOOKUP_GROUP ) ? n - i : LOOKUP_GROUP;
+
+        // First pass hashes the whole group and issues a prefetch for every bucket
+        for (j = 0L; j < count; j++) {
+            _prefetch_key(map, keys[i + j], &(hints[j]));
+        }
+        // Chained maps then prefetch the head of each chain, whose bucket has arrived by now
+        if (IS_CHAINED(map) == TRUE) {
+            for (j = 0L; j < count; j++) {
+                __builtin_prefetch(map->buckets[hints[j].index]);
+            }
+        }
+        // Only then are the keys probed, by which point their memory is mostly in cache
+        for (j = 0L; j < count; j++) {
+            temp = _fetch_hashed(map, keys[i + j], &(hints[j]), &bucket);
+            if (temp != NULL) {
+                values[i + j] = temp->value;
+                found++;
+            } else {
+                values[i + j] = NULL;
+            }
+            if (statuses != NULL) {
+                statuses[i + j] = ( temp != NULL ) ? OK : NOT_FOUND;
+            }
+        }
+    }
+
+    return found;
+}
+
+long hashmap_removeAll(HashMap *map, void **keys, void **values, long n) {
+
+    HashHint hints[PREFETCH_DISTANCE], hint;
+    void *value;
+    long i, removed = 0L;
+
+    _start_window(map, keys, n, hints);
+    for (i = 0L; i < n; i++) {
+        _advance_window(map, keys, n, i, hints, &hint);
+        value = NULL;
+        if (IS_EMPTY(map) == FALSE && _remove_hashed(map, keys[i], &hint, &value) == OK) {
+            removed++;
+        }
+        if (values != NULL) {
+            values[i] = value;
+        }
+    }
+
+    return removed;
+}
+
+/**
+ * Helper method to clear out the hashmap `map` of all its elements, applying the destructor method
+ * `destructor` on each element (or if NULL, nothing will be done to the elements).
+ */
+static void _clear_map(HashMap *map, void (*valueDestructor)(void *)) {
+
+    HmEntry *temp, *next;
+    long i;
+
+    if (IS_SMALL(map) == TRUE) {
+        for (i = 0L; i < map->size; i++) {
+            temp = &(map->small->entries[i]);
+            if (map->keyDxn != NULL) {
+                (*map->keyDxn)(temp->key);
+            }
+            if (valueDestructor != NULL) {
+                (*valueDestructor)(temp->value);
+            }
+        }
+        return;
+    }
+    if (IS_FLAT(map) == TRUE) {
+        for (i = 0L; i < map->capacity; i++) {
+            if (map->ctrl[i] >= 0) {
+                if (map->keyDxn != NULL) {
+                    (*map->keyDxn)(map->slots[i].key);
+                }
+                if (valueDestructor != NULL) {
+                    (*valueDestructor)(map->slots[i].value);
+                }
+            }
+        }
+        memset(map->ctrl, CTRL_EMPTY, map->capacity * sizeof(int8_t));
+        map->tombstones = 0L;
+        return;
+    }
+
+    // Without destructors to apply, every entry is released at once and the buckets are emptied
+    if (map->keyDxn == NULL && valueDestructor == NULL) {
+        nodepool_reset(map->pool);
+        allocator_free(map->allocator, map->oldBuckets);
+        map->oldBuckets = NULL;
+        map->oldCapacity = 0L;
+        map->rehashIndex = 0L;
+        memset(map->buckets, 0, map->capacity * sizeof(HmEntry *));
+        return;
+    }
+
+    // No point moving the old entries over just to free them
+    _rehash_all(map);
+    for (i = 0L; i < map->capacity; i++) {
+        temp = map->buckets[i];
+        while (temp != NULL) {
+            next = temp->next;
+            // Deallocate the node and attributes
             if (map->keyDxn != NULL) {
                 (*map->keyDxn)(temp->key);
             }
-            if (valueDestructor != NULL) {
-                (*valueDestructor)(temp->value);
+            if (valueDestructor != NULL) {
+                (*valueDestructor)(temp->value);
+            }
+            temp = next;
+        }
+        map->buckets[i] = NULL;
+    }
+    nodepool_reset(map->pool);
+}
+
+void hashmap_clear(HashMap *map, void (*valueDestructor)(void *)) {
+    _clear_map(map, valueDestructor);
+    map->size = 0L;
+    map->modCount++;
+}
+
+long hashmap_size(HashMap *map) {
+    return map->size;
+}
+
+Boolean hashmap_isEmpty(HashMap *map) {
+    return IS_EMPTY(map);
+}
+
+/**
+ * Records a chain of length `len` into the histogram and chain totals of `stats`.
+ */
+static void _record_chain(HashStats *stats, long len, long *total) {
+
+    stats->histogram[( len < HASH_STATS_BINS ) ? len : HASH_STATS_BINS - 1]++;
+    if (len > 0L) {
+        stats->usedBuckets++;
+        *total += len;
+    }
+    if (len > stats->maxChain) {
+        stats->maxChain = len;
+    }
+}
+
+void hashmap_stats(HashMap *map, HashStats *stats) {
+
+    HmEntry *temp;
+    long i, len, total = 0L;
+
+    memset(stats, 0, sizeof(HashStats));
+    stats->capacity = map->capacity;
+    stats->size = map->size;
+    stats->load = ( (double)map->size / (double)map->capacity );
+    stats->tombstones = map->tombstones;
+    stats->resizes = map->resizes;
+    stats->resizeNanos = map->resizeNanos;
+    stats->lookups = map->lookups;
+    stats->probes = map->probes;
+
+    if (IS_SMALL(map) == TRUE) {
+        // Lookups scan the entries in order, so each one is found after as many probes as its rank
+        for (i = 0L; i < map->size; i++) {
+            _record_chain(stats, i + 1L, &total);
+        }
+    } else if (IS_FLAT(map) == TRUE) {
+        // Counts the groups each live entry's lookup probes, starting from its first group
+        long ngroups = ( map->capacity / GROUP_WIDTH ), g, target;
+        for (i = 0L; i < map->capacity; i++) {
+            if (map->ctrl[i] < 0) {
+                continue;
+            }
+            g = FIRST_GROUP(map->slots[i].hash, ngroups);
+            target = ( i / GROUP_WIDTH );
+            for (len = 1L; g != target && len < ngroups; len++) {
+                g = ( ( g + len ) & ( ngroups - 1L ) );
+            }
+            _record_chain(stats, len, &total);
+        }
+    } else {
+        for (i = 0L; i < map->capacity; i++) {
+            for (len = 0L, temp = map->buckets[i]; temp != NULL; temp = temp->next) {
+                len++;
+            }
+            _record_chain(stats, len, &total);
+        }
+        // Buckets not yet moved out of the old array still hold their chains
+        for (i = map->rehashIndex; i < map->oldCapacity; i++) {
+            for (len = 0L, temp = map->oldBuckets[i]; temp != NULL; temp = temp->next) {
+                len++;
+            }
+            if (len > 0L) {
+                _record_chain(stats, len, &total);
+            }
+        }
+    }
+    stats->meanChain = ( stats->usedBuckets == 0L ) ? 0.0 : (double)total / stats->usedBuckets;
+}
+
+Status hashmap_keyArray(HashMap *map, Array **keys) {
+
+    HmEntry *temp = NULL;
+    long i, j = 0L;
+    size_t bytes;
+    void **items = NULL;
+
+    // Does not create the array if empty
+    if (IS_EMPTY(map) == TRUE) {
+        return STRUCT_EMPTY;
+    }
+
+    // Allocates memory for the array struct
+    Array *array = (Array *)malloc(sizeof(Array));
+    if (array == NULL) {
+        return ALLOC_FAILURE;
+    }
+
+    // Allocates memory for the array
+    bytes = ( map->size * sizeof(void *) );
+    items = (void **)malloc(bytes);
+    if (items == NULL) {
+        free(array);
+        return ALLOC_FAILURE;
+    }
+
+    // Populates the array with hashmap entries
+    i = -1L;
+    for (temp = _next_entry(map, NULL, &i); temp != NULL; temp = _next_entry(map, temp, &i)) {
+        items[j++] = temp->key;
+    }
+    array->items = items;
+    array->len = map->size;
+    *keys = array;
+
+    return OK;
+}
+
+/**
+ * Helper method to generate an array representation of the hashmap. Returns the allocated array
+ * with the populated elements, or NULL if failed (allocation error).
+ */
+static HmEntry **_generate_entry_array(HashMap *map) {
+
+    HmEntry *temp = NULL, **array = NULL;
+    long i, j = 0L;
+    size_t bytes;
+
+    // Allocates memory for the array
+    bytes = ( map->size * sizeof(HmEntry *) );
+    array = (HmEntry **)malloc(bytes);
+    if (array == NULL) {
+        return NULL;
+    }
+
+    // Populates the array with hashmap entries
+    i = -1L;
+    for (temp = _next_entry(map, NULL, &i); temp != NULL; temp = _next_entry(map, temp, &i)) {
+        array[j++] = temp;
+    }
+
+    return array;
+}
+
+Status hashmap_entryArray(HashMap *map, Array **entries) {
+
+    // Does not create array if currently empty
+    if (IS_EMPTY(map) == TRUE) {
+        return STRUCT_EMPTY;
+    }
+
+    // Generates the array of hashmap entries
+    HmEntry **items = _generate_entry_array(map);
+    if (items == NULL) {
+        return ALLOC_FAILURE;
+    }
+
+    // Allocates memory for the array struct
+    Array *temp = (Array *)malloc(sizeof(Array));
+    if (temp == NULL) {
+        free(items);
+        return ALLOC_FAILURE;
+    }
+
+    // Initializes the remaining struct members
+    temp->items = (void **)items;
+    temp->len = map->size;
+    *entries = temp;
+
+    return OK;
+}
+
+Status hashmap_entrySnapshot(HashMap *map, Array **entries) {
+
+    HmEntry **items, *copies;
+    size_t offset;
+    long j;
+
+    // Does not create array if currently empty
+    if (IS_EMPTY(map) == TRUE) {
+        return STRUCT_EMPTY;
+    }
+
+    // Allocates the pointer array and the entry copies as one block, so FREE_ARRAY releases both
+    offset = ( map->size * sizeof(HmEntry *) );
+    offset = ( ( offset + sizeof(HmEntry) - 1 ) / sizeof(HmEntry) ) * sizeof(HmEntry);
+    Array *temp = (Array *)malloc(sizeof(Array));
+    if (temp == NULL) {
+        return ALLOC_FAILURE;
+    }
+    HmEntry **live = _generate_entry_array(map);
+    if (live == NULL) {
+        free(temp);
+        return ALLOC_FAILURE;
+    }
+    items = (HmEntry **)malloc(offset + ( map->size * sizeof(HmEntry) ));
+    if (items == NULL) {
+        free(live);
+        free(temp);
+        return ALLOC_FAILURE;
+    }
+
+    // Copies each live entry into the block, detached from the hashmap
+    copies = (HmEntry *)((char *)items + offset);
+    for (j = 0L; j < map->size; j++) {
+        copies[j] = *(live[j]);
+        items[j] = &(copies[j]);
+        items[j]->next = NULL;
+    }
+    free(live);
+
+    // Initializes the remaining struct members
+    temp->items = (void **)items;
+    temp->len = map->size;
+    *entries = temp;
+
+    return OK;
+}
+
+Status hashmap_iterator(HashMap *map, Iterator **iter) {
+
+    Iterator *temp = NULL;
+
+    // Does not create array if currently empty
+    if (IS_EMPTY(map) == TRUE) {
+        return STRUCT_EMPTY;
+    }
+
+    // Generates the array of stack items for iterator
+    HmEntry **items = _generate_entry_array(map);
+    if (items == NULL) {
+        return ALLOC_FAILURE;
+    }
+
+    // Creates a new iterator with the stack items
+    Status status = iterator_new(&temp, (void **)items, map->size);
+    if (status != OK) {
+        free(items);
+        return status;
+    }
+    *iter = temp;
+
+    return OK;
+}
+
+void hashmap_cursor(HashMap *map, Cursor *cursor) {
+    cursor->adt = map;
+    cursor->index = -1L;
+    cursor->node = _next_entry(map, NULL, &(cursor->index));
+    cursor->remaining = map->size;
+    cursor->modCount = map->modCount;
+}
+
+Status hashmap_cursorNext(Cursor *cursor, void **next) {
+
+    HashMap *map = (HashMap *)cursor->adt;
+    HmEntry *entry = (HmEntry *)cursor->node;
+
+    // Fails fast if the hashmap was modified since creating the cursor
+    if (map->modCount != cursor->modCount) {
+        return CONCURRENT_MODIFICATION;
+    }
+    // Checks if every entry was visited
+    if (cursor->remaining == 0L) {
+        return ITER_END;
+    }
+
+    // Fetches the entry, advances to the next live entry
+    *next = entry;
+    cursor->node = _next_entry(map, entry, &(cursor->index));
+    cursor->remaining--;
+
+    return OK;
+}
+
+Boolean hashmap_forEach(HashMap *map, Boolean (*action)(void *, void *, void *), void *context) {
+
+    HmEntry *entry;
+    long i;
+
+    // Small maps hold their entries inline, flat maps in the slots marked live by their control bytes
+    if (IS_SMALL(map) == TRUE) {
+        for (i = 0L; i < map->size; i++) {
+            entry = &(map->small->entries[i]);
+            if ((*action)(entry->key, entry->value, context) == FALSE) {
+                return FALSE;
+            }
+        }
+        return TRUE;
+    }
+    if (IS_FLAT(map) == TRUE) {
+        for (i = 0L; i < map->capacity; i++) {
+            if (map->ctrl[i] >= 0 && (*action)(map->slots[i].key, map->slots[i].value,
+                                               context) == FALSE) {
+                return FALSE;
+            }
+        }
+        return TRUE;
+    }
+
+    // Chained maps walk each bucket, then the buckets an incremental resize has yet to move
+    for (i = 0L; i < map->capacity + map->oldCapacity; i++) {
+        entry = ( i < map->capacity ) ? map->buckets[i] : map->oldBuckets[i - map->capacity];
+        for (; entry != NULL; entry = entry->next) {
+            if ((*action)(entry->key, entry->value, context) == FALSE) {
+                return FALSE;
+            }
+        }
+    }
+
+    return TRUE;
+}
+
+// Parallel walks give each thread at least this many entries, smaller maps are walked in place
+#define MIN_PARALLEL_RUN 16384L
+// The most threads a parallel walk uses
+#define MAX_THREADS 64
+
+/**
+ * One thread's share of a parallel walk: the entries in slots or buckets `[lo..hi)`, counting any
+ * buckets an incremental resize has yet to move after the current ones, either handed to `action`
+ * or folded into `partial` through `reducer`.
+ */
+typedef struct {
+    HashMap *map;                                       // The hashmap being walked
+    long lo, hi;                                        // The bounds of the share to walk
+    Boolean (*action)(void *, void *, void *);          // Function applied to each entry, or NULL
+    void *(*reducer)(void *, void *, void *, void *);   // Function folding each entry, or NULL
+    void *context;                                      // Argument passed along to each call
+    void *partial;                                      // The share's folded result
+    long visited;                                       // Number of entries the share walked
+    int *stop;                                          // Raised once any action asks to stop
+} WalkTask;
+
+/**
+ * Hands `entry` to the walk described by `task`, returning FALSE once the walk should stop.
+ */
+static Boolean _walk_entry(WalkTask *task, HmEntry *entry) {
+
+    task->visited++;
+    if (task->reducer != NULL) {
+        task->partial = (*task->reducer)(task->partial, entry->key, entry->value, task->context);
+        return TRUE;
+    }
+    if ((*task->action)(entry->key, entry->value, task->context) == FALSE) {
+        __atomic_store_n(task->stop, 1, __ATOMIC_RELAXED);
+        return FALSE;
+    }
+
+    return ( __atomic_load_n(task->stop, __ATOMIC_RELAXED) == 0 ) ? TRUE : FALSE;
+}
+
+/**
+ * Thread routine walking the share of the map described by the WalkTask `arg`.
+ */
+static void *_walk_task(void *arg) {
+
+    WalkTask *task = (WalkTask *)arg;
+    HashMap *map = task->map;
+    HmEntry *entry;
+    long i;
+
+    for (i = task->lo; i < task->hi; i++) {
+        if (IS_SMALL(map) == TRUE) {
+            if (_walk_entry(task, &(map->small->entries[i])) == FALSE) {
+                break;
+            }
+        } else if (IS_FLAT(map) == TRUE) {
+            if (map->ctrl[i] >= 0 && _walk_entry(task, &(map->slots[i])) == FALSE) {
+                break;
+            }
+        } else {
+            entry = ( i < map->capacity ) ? map->buckets[i] : map->oldBuckets[i - map->capacity];
+            for (; entry != NULL; entry = entry->next) {
+                if (_walk_entry(task, entry) == FALSE) {
+                    return NULL;
+                }
             }
-            free(temp);
-            temp = next;
         }
-        map->buckets[i] = NULL;
     }
-}
 
-void hashmap_clear(HashMap *map, void (*valueDestructor)(void *)) {
-    _clear_map(map, valueDestructor);
-    map->size = 0L;
-    map->changes = 0L;
-    map->load = 0.0;
+    return NULL;
 }
 
-long hashmap_size(HashMap *map) {
-    return map->size;
+/**
+ * Splits the map's slots or buckets into even ranges, one per thread, and walks each range with
+ * `action` or `reducer`. Returns the number of ranges, now filled in `tasks`.
+ */
+static int _parallel_walk(HashMap *map, int nthreads, Boolean (*action)(void *, void *, void *),
+                          void *(*reducer)(void *, void *, void *, void *), void *context,
+                          int *stop, WalkTask *tasks) {
+
+    pthread_t threads[MAX_THREADS];
+    Boolean started[MAX_THREADS];
+    long span;
+    int i;
+
+    if (nthreads > MAX_THREADS) {
+        nthreads = MAX_THREADS;
+    }
+    if ((long)nthreads > map->size / MIN_PARALLEL_RUN) {
+        nthreads = (int)( map->size / MIN_PARALLEL_RUN );
+    }
+    if (nthreads < 1) {
+        nthreads = 1;
+    }
+
+    // Small maps are walked by entry, flat maps by slot and chained maps by bucket
+    if (IS_SMALL(map) == TRUE) {
+        span = map->size;
+    } else if (IS_FLAT(map) == TRUE) {
+        span = map->capacity;
+    } else {
+        span = map->capacity + map->oldCapacity;
+    }
+    for (i = 0; i < nthreads; i++) {
+        tasks[i].map = map;
+        tasks[i].lo = ( span * i ) / nthreads;
+        tasks[i].hi = ( span * ( i + 1 ) ) / nthreads;
+        tasks[i].action = action;
+        tasks[i].reducer = reducer;
+        tasks[i].context = context;
+        tasks[i].partial = NULL;
+        tasks[i].visited = 0L;
+        tasks[i].stop = stop;
+    }
+
+    // The calling thread takes the last range, as well as any whose thread couldn't be started
+    for (i = 0; i < nthreads - 1; i++) {
+        started[i] = TRUE;
+        if (pthread_create(&threads[i], NULL, _walk_task, &tasks[i]) != 0) {
+            started[i] = FALSE;
+            (void)_walk_task(&tasks[i]);
+        }
+    }
+    (void)_walk_task(&tasks[nthreads - 1]);
+    for (i = 0; i < nthreads - 1; i++) {
+        if (started[i] == TRUE) {
+            pthread_join(threads[i], NULL);
+        }
+    }
+
+    return nthreads;
 }
 
-Boolean hashmap_isEmpty(HashMap *map) {
-    return IS_EMPTY(map);
+Boolean hashmap_parallelForEach(HashMap *map, int nthreads,
+                                Boolean (*action)(void *, void *, void *), void *context) {
+
+    WalkTask tasks[MAX_THREADS];
+    int stop = 0;
+
+    (void)_parallel_walk(map, nthreads, action, NULL, context, &stop, tasks);
+
+    return ( stop == 0 ) ? TRUE : FALSE;
 }
 
-Status hashmap_keyArray(HashMap *map, Array **keys) {
+void *hashmap_parallelReduce(HashMap *map, int nthreads,
+                             void *(*reducer)(void *, void *, void *, void *),
+                             void *(*combiner)(void *, void *, void *), void *context) {
 
-    HmEntry *temp = NULL;
-    long i, j = 0L;
-    size_t bytes;
-    void **items = NULL;
+    WalkTask tasks[MAX_THREADS];
+    void *result = NULL;
+    Boolean first = TRUE;
+    int n, i, stop = 0;
 
-    // Does not create the array if empty
-    if (IS_EMPTY(map) == TRUE) {
-        return STRUCT_EMPTY;
+    // Ranges that held no entries have no result to combine
+    n = _parallel_walk(map, nthreads, NULL, reducer, context, &stop, tasks);
+    for (i = 0; i < n; i++) {
+        if (tasks[i].visited == 0L) {
+            continue;
+        }
+        result = ( first == TRUE ) ? tasks[i].partial
+                                   : (*combiner)(result, tasks[i].partial, context);
+        first = FALSE;
     }
 
-    // Allocates memory for the array struct
-    Array *array = (Array *)malloc(sizeof(Array));
-    if (array == NULL) {
-        return ALLOC_FAILURE;
+    return result;
+}
+
+/**
+ * Appends the entry `key` -> `value` to the snapshot writer `writer`, stopping the walk on failure.
+ */
+static Boolean _save_entry(void *key, void *value, void *writer) {
+    return ( snapshot_writerAdd((SnapshotWriter *)writer, key, value) == OK ) ? TRUE : FALSE;
+}
+
+Status hashmap_saveTo(HashMap *map, int fd, long (*keySerializer)(void *, void *, long),
+                      long (*valueSerializer)(void *, void *, long)) {
+
+    SnapshotWriter *writer;
+    Status status;
+
+    status = snapshot_writerNew(&writer, fd, keySerializer, valueSerializer, FALSE);
+    if (status != OK) {
+        return status;
     }
+    // A failed record is remembered by the writer, and reported when it is finished
+    (void)hashmap_forEach(map, _save_entry, writer);
 
-    // Allocates memory for the array
-    bytes = ( map->size * sizeof(void *) );
-    items = (void **)malloc(bytes);
-    if (array == NULL) {
-        free(array);
-        return ALLOC_FAILURE;
+    return snapshot_writerFinish(writer);
+}
+
+Status hashmap_loadFrom(HashMap *map, int fd, void *(*keyDeserializer)(const void *, long),
+                        void *(*valueDeserializer)(const void *, long),
+                        void (*valueDestructor)(void *)) {
+
+    Snapshot *snapshot;
+    const void *keyBytes, *valueBytes;
+    void *key, *value, *previous;
+    long keyLen, valueLen, i, n;
+    Status status;
+
+    if ((status = snapshot_open(&snapshot, fd)) != OK) {
+        return status;
     }
 
-    // Populates the array with hashmap entries
-    for (i = 0L; i < map->capacity; i++) {
-        for (temp = map->buckets[i]; temp != NULL; temp = temp->next) {
-            items[j++] = temp->key;
+    // Sizes the table for every record up front
+    n = snapshot_size(snapshot);
+    (void)_reserve(map, n);
+
+    for (i = 0L; i < n; i++) {
+        status = snapshot_entry(snapshot, i, &keyBytes, &keyLen, &valueBytes, &valueLen);
+        if (status != OK) {
+            break;
+        }
+        key = (*keyDeserializer)(keyBytes, keyLen);
+        value = ( key != NULL ) ? (*valueDeserializer)(valueBytes, valueLen) : NULL;
+        status = ( value != NULL ) ? hashmap_put(map, key, value, &previous) : ALLOC_FAILURE;
+        if (status == REPLACED) {
+            // The map keeps the key it holds, so the duplicate goes along with the old value
+            if (map->keyDxn != NULL) {
+                (*map->keyDxn)(key);
+            }
+            if (valueDestructor != NULL) {
+                (*valueDestructor)(previous);
+            }
+        } else if (status == ALLOC_FAILURE) {
+            if (key != NULL && map->keyDxn != NULL) {
+                (*map->keyDxn)(key);
+            }
+            if (value != NULL && valueDestructor != NULL) {
+                (*valueDestructor)(value);
+            }
+            break;
         }
+        status = OK;
     }
-    array->items = items;
-    array->len = map->size;
-    *keys = array;
+    snapshot_close(snapshot);
 
-    return OK;
+    return status;
 }
 
+// Average number of hash codes per bucket of a frozen hashmap's displacement table
+#define FROZEN_BUCKET_SIZE 4L
+// Number of first displacements tried for a bucket before the perfect hash is salted anew
+#define FROZEN_MAX_D0 64UL
+
 /**
- * Helper method to generate an array representation of the hashmap. Returns the allocated array
- * with the populated elements, or NULL if failed (allocation error).
+ * An entry of the hashmap being frozen, along with its hash code.
  */
-static HmEntry **_generate_entry_array(HashMap *map) {
+typedef struct {
+    uint64_t code;      // The key's hash code, from _frozen_code()
+    void *key;          // The entry's key
+    void *value;        // The entry's value
+} FrozenEntry;
 
-    HmEntry *temp = NULL, **array = NULL;
-    long i, j = 0L;
-    size_t bytes;
+/**
+ * Scratch space for placing the distinct hash codes of a frozen hashmap.
+ */
+typedef struct {
+    uint64_t *h1;       // Start of the slot sequence of each code, grouped by bucket
+    uint64_t *h2;       // Step of the slot sequence of each code, grouped by bucket
+    long *starts;       // Index of each bucket's first code in `h1` and `h2`, then one past the end
+    long *next;         // Next index to fill in each bucket while grouping the codes
+    uint8_t *taken;     // Whether each slot has been claimed yet
+} FrozenScratch;
 
-    // Allocates memory for the array
-    bytes = ( map->size * sizeof(HmEntry *) );
-    array = (HmEntry **)malloc(bytes);
-    if (array == NULL) {
-        return NULL;
+/**
+ * Returns the hash code of the key `key`, from the hash function of the hashmap `frozen` was frozen
+ * from.
+ */
+static uint64_t _frozen_code(FrozenHashMap *frozen, void *key) {
+
+    if (frozen->seededHash != NULL) {
+        return frozen->seededHash(key, frozen->seed);
     }
+    if (frozen->hashCode != NULL) {
+        return frozen->hashCode(key);
+    }
+    return (uint64_t)frozen->hash(key, MAX_CAPACITY);
+}
 
-    // Populates the array with hashmap entries
-    for (i = 0L; i < map->capacity; i++) {
-        for (temp = map->buckets[i]; temp != NULL; temp = temp->next) {
-            array[j++] = temp;
+/**
+ * Mixes the hash code `code` with `salt`, spreading every bit of both over the result.
+ */
+static uint64_t _frozen_mix(uint64_t code, uint64_t salt) {
+
+    code ^= salt;
+    code ^= ( code >> 33 );
+    code *= 0xff51afd7ed558ccdUL;
+    code ^= ( code >> 33 );
+    code *= 0xc4ceb9fe1a85ec53UL;
+    code ^= ( code >> 33 );
+    return code;
+}
+
+/**
+ * Computes the bucket of the hash code `code` into `*bucket`, and the start `*h1` and step `*h2` of
+ * its slot sequence: the code lands in slot (h1 + d0 * h2 + d1) mod slots, where (d0, d1) is the
+ * bucket's displacement pair.
+ */
+static void _frozen_hashes(FrozenHashMap *frozen, uint64_t code, long *bucket, uint64_t *h1,
+                           uint64_t *h2) {
+
+    uint64_t a = _frozen_mix(code, frozen->salt), b = _frozen_mix(code, ~frozen->salt);
+
+    *bucket = (long)( a % (uint64_t)frozen->buckets );
+    *h1 = b % (uint64_t)frozen->slots;
+    *h2 = ( frozen->slots > 1L ) ? ( a >> 32 ) % (uint64_t)( frozen->slots - 1L ) + 1UL : 0UL;
+}
+
+/**
+ * Returns the slot of the hash code `code` in the frozen hashmap.
+ */
+static long _frozen_slot(FrozenHashMap *frozen, uint64_t code) {
+
+    const uint32_t *pair;
+    uint64_t h1, h2;
+    long bucket;
+
+    _frozen_hashes(frozen, code, &bucket, &h1, &h2);
+    pair = &(frozen->displacements[2L * bucket]);
+    return (long)( ( h1 + pair[0] * h2 + pair[1] ) % (uint64_t)frozen->slots );
+}
+
+/**
+ * Searches for a displacement pair placing every hash code of the bucket `b` into a free slot, and
+ * claims those slots. Returns FALSE if there is none among the pairs tried.
+ */
+static Boolean _frozen_place_bucket(FrozenHashMap *frozen, FrozenScratch *scratch, long b) {
+
+    uint64_t n = (uint64_t)frozen->slots, d0, d1, *h1 = scratch->h1, *h2 = scratch->h2;
+    long lo = scratch->starts[b], hi = scratch->starts[b + 1L], i, j;
+
+    // Codes sharing a whole slot sequence can never be told apart with this salt
+    for (i = lo; i < hi; i++) {
+        for (j = i + 1L; j < hi; j++) {
+            if (h1[i] == h1[j] && h2[i] == h2[j]) {
+                return FALSE;
+            }
         }
     }
 
-    return array;
+    for (d0 = 0UL; d0 < FROZEN_MAX_D0; d0++) {
+        for (d1 = 0UL; d1 < n; d1++) {
+            for (i = lo; i < hi && scratch->taken[( h1[i] + d0 * h2[i] + d1 ) % n] == 0; i++) {
+                scratch->taken[( h1[i] + d0 * h2[i] + d1 ) % n] = 1;
+            }
+            if (i == hi) {
+                frozen->displacements[2L * b] = (uint32_t)d0;
+                frozen->displacements[2L * b + 1L] = (uint32_t)d1;
+                return TRUE;
+            }
+            // Releases the slots claimed before the collision
+            for (j = lo; j < i; j++) {
+                scratch->taken[( h1[j] + d0 * h2[j] + d1 ) % n] = 0;
+            }
+        }
+    }
+
+    return FALSE;
 }
 
-Status hashmap_entryArray(HashMap *map, Array **entries) {
+/**
+ * Builds the displacement table of the frozen hashmap over its distinct hash codes, held in
+ * `frozen->codes`, with the current salt. Buckets are placed from the largest down, while the
+ * table is still empty enough to fit them; single codes then go straight into the free slots that
+ * remain. Returns FALSE if some bucket could not be placed.
+ */
+static Boolean _frozen_place(FrozenHashMap *frozen, FrozenScratch *scratch) {
 
-    // Does not create array if currently empty
-    if (IS_EMPTY(map) == TRUE) {
-        return STRUCT_EMPTY;
+    uint64_t h1, h2;
+    long i, b, bucket, size, maxSize = 0L, slot = 0L;
+
+    memset(scratch->starts, 0, ( frozen->buckets + 1L ) * sizeof(long));
+    memset(scratch->taken, 0, frozen->slots * sizeof(uint8_t));
+    memset(frozen->displacements, 0, 2L * frozen->buckets * sizeof(uint32_t));
+
+    // Groups the codes by bucket
+    for (i = 0L; i < frozen->slots; i++) {
+        _frozen_hashes(frozen, frozen->codes[i], &bucket, &h1, &h2);
+        scratch->starts[bucket + 1L]++;
+    }
+    for (b = 0L; b < frozen->buckets; b++) {
+        if (scratch->starts[b + 1L] > maxSize) {
+            maxSize = scratch->starts[b + 1L];
+        }
+        scratch->starts[b + 1L] += scratch->starts[b];
+        scratch->next[b] = scratch->starts[b];
+    }
+    for (i = 0L; i < frozen->slots; i++) {
+        _frozen_hashes(frozen, frozen->codes[i], &bucket, &h1, &h2);
+        scratch->h1[scratch->next[bucket]] = h1;
+        scratch->h2[scratch->next[bucket]++] = h2;
     }
 
-    // Generates the array of hashmap entries
-    HmEntry **items = _generate_entry_array(map);
-    if (items == NULL) {
+    for (size = maxSize; size >= 2L; size--) {
+        for (b = 0L; b < frozen->buckets; b++) {
+            if (scratch->starts[b + 1L] - scratch->starts[b] == size &&
+                    _frozen_place_bucket(frozen, scratch, b) == FALSE) {
+                return FALSE;
+            }
+        }
+    }
+    for (b = 0L; b < frozen->buckets; b++) {
+        if (scratch->starts[b + 1L] - scratch->starts[b] == 1L) {
+            while (scratch->taken[slot] != 0) {
+                slot++;
+            }
+            scratch->taken[slot] = 1;
+            h1 = scratch->h1[scratch->starts[b]];
+            frozen->displacements[2L * b + 1L] =
+                (uint32_t)( ( (uint64_t)slot + (uint64_t)frozen->slots - h1 ) % frozen->slots );
+        }
+    }
+
+    return TRUE;
+}
+
+/**
+ * The entries collected from the hashmap being frozen.
+ */
+typedef struct {
+    FrozenHashMap *frozen;  // The frozen hashmap being built
+    FrozenEntry *entries;   // The entries collected so far
+    long count;             // Number of entries collected
+} FreezeContext;
+
+/**
+ * Collects the entry `key` -> `value` into the FreezeContext `context`.
+ */
+static Boolean _collect_entry(void *key, void *value, void *context) {
+
+    FreezeContext *freeze = (FreezeContext *)context;
+    FrozenEntry *entry = &(freeze->entries[freeze->count++]);
+
+    entry->code = _frozen_code(freeze->frozen, key);
+    entry->key = key;
+    entry->value = value;
+    return TRUE;
+}
+
+/**
+ * Compares the hash codes of the FrozenEntry `a` and `b`, for qsort().
+ */
+static int _compare_codes(const void *a, const void *b) {
+
+    uint64_t x = ((const FrozenEntry *)a)->code, y = ((const FrozenEntry *)b)->code;
+
+    return ( x < y ) ? -1 : ( x > y ) ? 1 : 0;
+}
+
+/**
+ * Frees the frozen hashmap `frozen` and its arrays, leaving the keys and values alone.
+ */
+static void _free_frozen(FrozenHashMap *frozen) {
+    free(frozen->displacements);
+    free(frozen->codes);
+    free(frozen->keys);
+    free(frozen->values);
+    free(frozen->extraCodes);
+    free(frozen->extraKeys);
+    free(frozen->extraValues);
+    free(frozen);
+}
+
+Status hashmap_freeze(HashMap *map, FrozenHashMap **frozen) {
+
+    FrozenHashMap *temp;
+    FreezeContext context;
+    FrozenScratch scratch;
+    void (*keyDxn)(void *);
+    long i, m = 0L, extras = 0L, n = ( map->size > 0L ) ? map->size : 1L;
+
+    temp = (FrozenHashMap *)calloc(1, sizeof(FrozenHashMap));
+    context.entries = (FrozenEntry *)malloc(n * sizeof(FrozenEntry));
+    if (temp == NULL || context.entries == NULL) {
+        free(temp);
+        free(context.entries);
         return ALLOC_FAILURE;
     }
+    temp->hash = map->hash;
+    temp->hashCode = map->hashCode;
+    temp->seededHash = map->seededHash;
+    temp->seed = map->seed;
+    temp->keyCmp = map->keyCmp;
+    temp->keyDxn = map->keyDxn;
+
+    // Collects the entries sorted by hash code, so that repeated codes end up side by side
+    context.frozen = temp;
+    context.count = 0L;
+    (void)hashmap_forEach(map, _collect_entry, &context);
+    qsort(context.entries, context.count, sizeof(FrozenEntry), _compare_codes);
+    for (i = 0L; i < context.count; i++) {
+        if (i == 0L || context.entries[i].code != context.entries[i - 1L].code) {
+            m++;
+        }
+    }
+    temp->slots = m;
+    temp->extras = context.count - m;
+    temp->buckets = m / FROZEN_BUCKET_SIZE + 1L;
+
+    temp->displacements = (uint32_t *)malloc(2L * temp->buckets * sizeof(uint32_t));
+    // Arrays are never allocated empty, so that NULL only ever means an allocation failure
+    n = ( m > 0L ) ? m : 1L;
+    extras = ( temp->extras > 0L ) ? temp->extras : 1L;
+    temp->codes = (uint64_t *)malloc(n * sizeof(uint64_t));
+    temp->keys = (void **)malloc(n * sizeof(void *));
+    temp->values = (void **)malloc(n * sizeof(void *));
+    temp->extraCodes = (uint64_t *)malloc(extras * sizeof(uint64_t));
+    temp->extraKeys = (void **)malloc(extras * sizeof(void *));
+    temp->extraValues = (void **)malloc(extras * sizeof(void *));
+    scratch.h1 = (uint64_t *)malloc(n * sizeof(uint64_t));
+    scratch.h2 = (uint64_t *)malloc(n * sizeof(uint64_t));
+    scratch.starts = (long *)malloc(( temp->buckets + 1L ) * sizeof(long));
+    scratch.next = (long *)malloc(temp->buckets * sizeof(long));
+    scratch.taken = (uint8_t *)malloc(n * sizeof(uint8_t));
+    if (temp->displacements == NULL || temp->codes == NULL || temp->keys == NULL ||
+            temp->values == NULL || temp->extraCodes == NULL || temp->extraKeys == NULL ||
+            temp->extraValues == NULL || scratch.h1 == NULL || scratch.h2 == NULL ||
+            scratch.starts == NULL || scratch.next == NULL || scratch.taken == NULL) {
+        _free_frozen(temp);
+        temp = NULL;
+    }
 
-    // Allocates memory for the array struct
-    Array *temp = (Array *)malloc(sizeof(Array));
+    if (temp != NULL && m > 0L) {
+        extras = 0L;
+        for (i = 0L, m = 0L; i < context.count; i++) {
+            if (i == 0L || context.entries[i].code != context.entries[i - 1L].code) {
+                temp->codes[m++] = context.entries[i].code;
+            }
+        }
+        // Each salt gives every code fresh hashes, so some salt always tells the codes apart
+        while (_frozen_place(temp, &scratch) == FALSE) {
+            temp->salt++;
+        }
+        // Moves each entry into its slot, or aside if another entry already took its code
+        for (i = 0L; i < context.count; i++) {
+            FrozenEntry *entry = &(context.entries[i]);
+            if (i == 0L || entry->code != context.entries[i - 1L].code) {
+                long slot = _frozen_slot(temp, entry->code);
+                temp->codes[slot] = entry->code;
+                temp->keys[slot] = entry->key;
+                temp->values[slot] = entry->value;
+            } else {
+                temp->extraCodes[extras] = entry->code;
+                temp->extraKeys[extras] = entry->key;
+                temp->extraValues[extras++] = entry->value;
+            }
+        }
+    }
+    free(scratch.h1);
+    free(scratch.h2);
+    free(scratch.starts);
+    free(scratch.next);
+    free(scratch.taken);
+    free(context.entries);
     if (temp == NULL) {
-        free(items);
         return ALLOC_FAILURE;
     }
 
-    // Initializes the remaining struct members
-    temp->items = (void **)items;
-    temp->len = map->size;
-    *entries = temp;
+    // The entries now belong to the frozen hashmap, so the keys outlive the hashmap's clearing
+    keyDxn = map->keyDxn;
+    map->keyDxn = NULL;
+    hashmap_clear(map, NULL);
+    map->keyDxn = keyDxn;
+    *frozen = temp;
 
     return OK;
 }
 
-Status hashmap_iterator(HashMap *map, Iterator **iter) {
+/**
+ * Fetches the entry with the key `key` from the frozen hashmap, storing its value into `*value`.
+ * Returns FALSE if there is none.
+ */
+static Boolean _frozen_fetch(FrozenHashMap *frozen, void *key, void **value) {
 
-    Iterator *temp = NULL;
+    uint64_t code;
+    long slot, lo, hi, mid;
 
-    // Does not create array if currently empty
-    if (IS_EMPTY(map) == TRUE) {
-        return STRUCT_EMPTY;
+    if (frozen->slots == 0L) {
+        return FALSE;
+    }
+    code = _frozen_code(frozen, key);
+    slot = _frozen_slot(frozen, code);
+    if (frozen->codes[slot] == code && frozen->keyCmp(frozen->keys[slot], key) == 0) {
+        *value = frozen->values[slot];
+        return TRUE;
     }
 
-    // Generates the array of stack items for iterator
-    HmEntry **items = _generate_entry_array(map);
-    if (items == NULL) {
-        return ALLOC_FAILURE;
+    // Only keys sharing the hash code of the slot's key can have been kept aside
+    if (frozen->extras == 0L || frozen->codes[slot] != code) {
+        return FALSE;
+    }
+    for (lo = 0L, hi = frozen->extras; lo < hi; ) {
+        mid = lo + ( hi - lo ) / 2L;
+        if (frozen->extraCodes[mid] < code) {
+            lo = mid + 1L;
+        } else {
+            hi = mid;
+        }
+    }
+    for (; lo < frozen->extras && frozen->extraCodes[lo] == code; lo++) {
+        if (frozen->keyCmp(frozen->extraKeys[lo], key) == 0) {
+            *value = frozen->extraValues[lo];
+            return TRUE;
+        }
     }
 
-    // Creates a new iterator with the stack items
-    Status status = iterator_new(&temp, (void **)items, map->size);
-    if (status != OK) {
-        free(items);
-        return status;
+    return FALSE;
+}
+
+Status frozenhashmap_get(FrozenHashMap *frozen, void *key, void **value) {
+    return ( _frozen_fetch(frozen, key, value) == TRUE ) ? OK : NOT_FOUND;
+}
+
+Boolean frozenhashmap_containsKey(FrozenHashMap *frozen, void *key) {
+    void *value;
+    return _frozen_fetch(frozen, key, &value);
+}
+
+long frozenhashmap_size(FrozenHashMap *frozen) {
+    return frozen->slots + frozen->extras;
+}
+
+long frozenhashmap_memoryUsage(FrozenHashMap *frozen) {
+
+    long entry = (long)( sizeof(uint64_t) + 2L * sizeof(void *) );
+
+    return (long)sizeof(FrozenHashMap) + 2L * frozen->buckets * (long)sizeof(uint32_t) +
+           ( frozen->slots + frozen->extras ) * entry;
+}
+
+void frozenhashmap_destroy(FrozenHashMap *frozen, void (*valueDestructor)(void *)) {
+
+    long i;
+
+    for (i = 0L; i < frozen->slots + frozen->extras; i++) {
+        void *key = ( i < frozen->slots ) ? frozen->keys[i] : frozen->extraKeys[i - frozen->slots];
+        void *value = ( i < frozen->slots ) ? frozen->values[i]
+                                            : frozen->extraValues[i - frozen->slots];
+        if (frozen->keyDxn != NULL) {
+            (*frozen->keyDxn)(key);
+        }
+        if (valueDestructor != NULL) {
+            (*valueDestructor)(value);
+        }
     }
-    *iter = temp;
+    _free_frozen(frozen);
+}
 
-    return OK;
+long hashmap_memoryUsage(HashMap *map) {
+
+    long bytes = (long)map->structBytes;
+
+    if (IS_FLAT(map) == TRUE) {
+        bytes += map->capacity * (long)( sizeof(int8_t) + sizeof(HmEntry) );
+    } else if (IS_CHAINED(map) == TRUE) {
+        bytes += ( map->capacity + map->oldCapacity ) * (long)sizeof(HmEntry *);
+    }
+    if (map->pool != NULL) {
+        bytes += nodepool_memoryUsage(map->pool);
+    }
+
+    return bytes;
 }
 
 void hashmap_destroy(HashMap *map, void (*valueDestructor)(void *)) {
     _clear_map(map, valueDestructor);
-    free(map->buckets);
-    free(map);
+    if (map->pool != NULL) {
+        nodepool_destroy(map->pool);
+    }
+    allocator_free(map->allocator, map->oldBuckets);
+    allocator_free(map->allocator, map->buckets);
+    allocator_free(map->allocator, map->ctrl);
+    allocator_free(map->allocator, map->slots);
+    allocator_free(map->allocator, map);
 }
 
 void *hmentry_getKey(HmEntry *entry) {
@@ -23,7 +23,10 @@
  */
 
 #include <stdlib.h>
+#include <string.h>
+#include <time.h>
 #include "hash_set.h"
+#include "node_pool.h"
 
 /**
  * Struct for an entry in the HashSet ADT.
@@ -38,14 +41,28 @@ typedef struct hs_entry {
  */
 struct hashset {
     long (*hash)(void *, long);     // Hashing function for hashset items
+    uint64_t (*seededHash)(void *, uint64_t);   // Seeded hashing function, NULL if `hash` is used
+    uint64_t seed;                  // The seed passed to `seededHash`, drawn per set
     int (*cmp)(void *, void *);     // Comparator function for hashset items
-    HsEntry **buckets;              // Array of buckets containing the elements
+    HsEntry **buckets;              // Array of buckets containing the elements, NULL while small
+    HsEntry *small;                 // Inline entries while small, NULL once promoted
+    HsEntry **oldBuckets;           // Buckets still being rehashed, NULL if not resizing
+    long oldCapacity;               // Number of buckets in `oldBuckets`
+    long rehashIndex;               // Index of the next bucket in `oldBuckets` to rehash
+    Boolean incremental;            // TRUE if resizing is spread across the next insertions
+    NodePool *pool;                 // Private pool the chained entries are allocated from
     long size;                      // The hashset's current size
+    long modCount;                  // Number of structural modifications made
     long capacity;                  // The hashset's current capacity
-    long changes;                   // Number of changes since last trigger
-    double load;                    // The hashset's current load
+    long minCapacity;               // The capacity the hashset never shrinks below
+    long threshold;                 // Size the hashset grows at, from its load factor
     double loadFactor;              // The hashset's load factor
-    double delta;                   // Increment applied for every insertion/deletion
+    long resizes;                   // Number of resizes performed
+    long resizeNanos;               // Total time spent resizing, in nanoseconds
+    long lookups;                   // Number of lookups, if counting probes
+    long probes;                    // Number of entries examined by lookups
+    size_t structBytes;             // Size of the set's own block, inline entries included
+    const CdsAllocator *allocator;  // Allocates the struct, the buckets and the entry pool
 };
 
 // Default capacity to use if capacity supplied is invalid
@@ -54,64 +71,231 @@ struct hashset {
 #define DEFAULT_LOADFACTOR 0.75
 // Maximum amount of buckets set can hold at once
 #define MAX_CAPACITY 147483647L
+// Number of chained entries carved out of each slab of the entry pool
+#define ENTRIES_PER_SLAB 1024L
+// Maximum amount of buckets a seeded set can hold, which must be a power of 2
+#define MAX_POW2_CAPACITY 134217728L
+// Number of elements a small set holds inline before it is promoted to an array of buckets
+#define SMALL_CAPACITY 8L
 
-Status hashset_new(HashSet **set, long (*hash)(void *, long), int (*comparator)(void *, void *),
-                   long capacity, double loadFactor) {
+// Macro returning the most buckets the set `s` can hold; seeded sets mask their bucket indecies
+#define CAPACITY_LIMIT(s)  ( ((s)->seededHash != NULL) ? MAX_POW2_CAPACITY : MAX_CAPACITY )
+// Macro to check if the set `s` is small, holding its elements inline and scanning them linearly
+#define IS_SMALL(s)  ( ((s)->small != NULL) ? TRUE : FALSE )
+
+// Macro to add `n` to the probe counter `c` of the set `s`, only when counting probes
+#ifdef CDS_HASH_PROBE_STATS
+#define COUNT_PROBES(s, c, n)  (void)__atomic_add_fetch(&((s)->c), (n), __ATOMIC_RELAXED)
+#else
+#define COUNT_PROBES(s, c, n)
+#endif
+
+/**
+ * Returns the number of items a hashset with the capacity `cap` and the load factor `loadFactor`
+ * holds before it grows, which is always at least one.
+ */
+static long _threshold(double loadFactor, long cap) {
+    long threshold = (long)(loadFactor * (double)cap);
+    return ( threshold < 1L ) ? 1L : threshold;
+}
+
+/**
+ * Helper method to allocate and initialize a new hashset with the specified attributes, then store
+ * the new instance into `*set`. Exactly one of `hash` or `seededHash` is to be non-NULL. If `small`
+ * is TRUE, the set starts out holding its elements inline rather than in an array of buckets.
+ * Everything is allocated through `allocator`, or the default allocator if NULL.
+ */
+static Status _new_set(HashSet **set, long (*hash)(void *, long),
+                       uint64_t (*seededHash)(void *, uint64_t), int (*comparator)(void *, void *),
+                       long capacity, double loadFactor, Boolean small,
+                       const CdsAllocator *allocator) {
+
+    if (allocator == NULL) {
+        allocator = allocator_default();
+    }
 
     // Allocate the struct, check for allocation failure
-    HashSet *temp = (HashSet *)malloc(sizeof(HashSet));
+    // Small sets keep their inline entries right behind the struct, in the same allocation
+    size_t bytes = sizeof(HashSet) + ( ( small == TRUE ) ? SMALL_CAPACITY * sizeof(HsEntry) : 0 );
+    HashSet *temp = (HashSet *)allocator_alloc(allocator, bytes);
     if (temp == NULL) {
         return ALLOC_FAILURE;
     }
+    // The entries come from a private pool, so clearing the set can release them all at once
+    NodePool *pool;
+    if (nodepool_newWithAllocator(&pool, ENTRIES_PER_SLAB, allocator) != OK) {
+        allocator_free(allocator, temp);
+        return ALLOC_FAILURE;
+    }
 
     // Initialize the remaining struct memebers
     long cap = ( capacity <= 0L ) ? DEFAULT_CAPACITY : capacity;
-    if (cap > MAX_CAPACITY) {
+    if (small == TRUE) {
+        cap = SMALL_CAPACITY;
+    } else if (seededHash != NULL) {
+        // Bucket indecies are masked out of the hash codes, round up to the next power of 2
+        long pow2 = 1L;
+        while (pow2 < cap && pow2 < MAX_POW2_CAPACITY) {
+            pow2 *= 2L;
+        }
+        cap = pow2;
+    } else if (cap > MAX_CAPACITY) {
         cap = MAX_CAPACITY;
     }
     double ldf = ( loadFactor < 0.000001 ) ? DEFAULT_LOADFACTOR : loadFactor;
-    size_t bytes = (cap * sizeof(HsEntry *));
-    HsEntry **buckets = (HsEntry **)malloc(bytes);
+    HsEntry **buckets = NULL;
+    if (small == FALSE) {
+        buckets = (HsEntry **)allocator_alloc(allocator, cap * sizeof(HsEntry *));
 
-    // Checks for allocation failures
-    if (buckets == NULL) {
-        free(temp);
-        return ALLOC_FAILURE;
+        // Checks for allocation failures
+        if (buckets == NULL) {
+            nodepool_destroy(pool);
+            allocator_free(allocator, temp);
+            return ALLOC_FAILURE;
+        }
+        // Need to nullify each entry in array
+        long i;
+        for (i = 0L; i < cap; i++) {
+            buckets[i] = NULL;
+        }
     }
 
     // Initializes the remaining struct members
     temp->hash = hash;
+    temp->seededHash = seededHash;
+    temp->seed = ( seededHash != NULL ) ? hashing_seed() : 0UL;
     temp->cmp = comparator;
     temp->buckets = buckets;
+    temp->small = ( small == TRUE ) ? (HsEntry *)(temp + 1) : NULL;
+    temp->structBytes = bytes;
+    temp->allocator = allocator;
+    temp->oldBuckets = NULL;
+    temp->oldCapacity = 0L;
+    temp->rehashIndex = 0L;
+    temp->incremental = FALSE;
+    temp->pool = pool;
     temp->size = 0L;
+    temp->modCount = 0L;
     temp->capacity = cap;
-    temp->changes = 0L;
-    temp->load = 0.0;
+    temp->minCapacity = cap;
+    temp->threshold = ( small == TRUE ) ? SMALL_CAPACITY : _threshold(ldf, cap);
     temp->loadFactor = ldf;
-    temp->delta = ( 1.0 / (double)cap );
-    // Need to nullify each entry in array
-    long i;
-    for (i = 0L; i < cap; i++) {
-        temp->buckets[i] = NULL;
-    }
+    temp->resizes = 0L;
+    temp->resizeNanos = 0L;
+    temp->lookups = 0L;
+    temp->probes = 0L;
     *set = temp;
 
     return OK;
 }
 
+Status hashset_new(HashSet **set, long (*hash)(void *, long), int (*comparator)(void *, void *),
+                   long capacity, double loadFactor) {
+    return _new_set(set, hash, NULL, comparator, capacity, loadFactor, FALSE, NULL);
+}
+
+Status hashset_newWithAllocator(HashSet **set, long (*hash)(void *, long),
+                                int (*comparator)(void *, void *), long capacity, double loadFactor,
+                                const CdsAllocator *allocator) {
+    return _new_set(set, hash, NULL, comparator, capacity, loadFactor, FALSE, allocator);
+}
+
+Status hashset_newSeeded(HashSet **set, uint64_t (*hash)(void *, uint64_t),
+                         int (*comparator)(void *, void *), long capacity, double loadFactor) {
+    return _new_set(set, NULL, hash, comparator, capacity, loadFactor, FALSE, NULL);
+}
+
+Status hashset_newSmall(HashSet **set, uint64_t (*hash)(void *, uint64_t),
+                        int (*comparator)(void *, void *), double loadFactor) {
+    return _new_set(set, NULL, hash, comparator, SMALL_CAPACITY, loadFactor, TRUE, NULL);
+}
+
 /**
- * Fetches the entry from `set` with the item `item` from the set and returns it. Also stores the
- * index location in the internal array where the entry is located into `*index`. Returns NULL if
- * no such entry exists.
+ * Returns the index of the bucket in an array of `cap` buckets where the item `item` is to be
+ * placed. Seeded hash codes are mixed so that the low bits masked out depend on all of their bits.
  */
-static HsEntry *_fetch_entry(HashSet *set, void *item, long *index) {
+static long _bucket_index(HashSet *set, void *item, long cap) {
+
+    if (set->seededHash != NULL) {
+        uint64_t code = set->seededHash(item, set->seed);
+        code ^= ( code >> 33 );
+        code *= 0xff51afd7ed558ccdUL;
+        code ^= ( code >> 33 );
+        return (long)( code & (uint64_t)(cap - 1L) );
+    }
+    return set->hash(item, cap);
+}
+
+/**
+ * Struct holding the bucket index of an item, computed ahead of the item's lookup so that batch
+ * operations can prefetch its bucket while the previous items are being processed.
+ */
+typedef struct {
+    long index;         // The item's bucket index
+    long capacity;      // The set's capacity when the index was computed
+} HashHint;
+
+/**
+ * Computes the bucket index of the item `item`, and stores it into `*hint`. Small sets are not
+ * hashed at all, and their hints are left stale so that they are recomputed once promoted.
+ */
+static void _hash_item(HashSet *set, void *item, HashHint *hint) {
+
+    if (IS_SMALL(set) == TRUE) {
+        hint->index = 0L;
+        hint->capacity = 0L;
+        return;
+    }
+    hint->index = _bucket_index(set, item, set->capacity);
+    hint->capacity = set->capacity;
+}
+
+/**
+ * Fetches the entry from `set` with the item `item`, which was hashed into `hint`, and returns it.
+ * Also stores the bucket where the entry is located into `*bucket` (or if not found, the bucket
+ * where the item is to be inserted). Returns NULL if no such entry exists.
+ */
+static HsEntry *_fetch_hashed(HashSet *set, void *item, HashHint *hint, HsEntry ***bucket) {
 
     HsEntry *temp;
-    long i = set->hash(item, set->capacity);
-    *index = i;
+    long i;
+
+    COUNT_PROBES(set, lookups, 1L);
+    // Small sets scan their inline entries in order
+    if (IS_SMALL(set) == TRUE) {
+        *bucket = NULL;
+        for (i = 0L; i < set->size; i++) {
+            COUNT_PROBES(set, probes, 1L);
+            if (!set->cmp(item, set->small[i].payload)) {
+                return &(set->small[i]);
+            }
+        }
+        return NULL;
+    }
+    // While resizing, items in buckets that have not been moved over yet remain in the old array
+    if (set->oldBuckets != NULL) {
+        i = _bucket_index(set, item, set->oldCapacity);
+        if (i >= set->rehashIndex) {
+            for (temp = set->oldBuckets[i]; temp != NULL; temp = temp->next) {
+                COUNT_PROBES(set, probes, 1L);
+                if (!set->cmp(item, temp->payload)) {
+                    *bucket = &(set->oldBuckets[i]);
+                    return temp;
+                }
+            }
+        }
+    }
+
+    // The index is stale if the set has resized since the item was hashed
+    if (hint->capacity != set->capacity) {
+        _hash_item(set, item, hint);
+    }
+    i = hint->index;
+    *bucket = &(set->buckets[i]);
 
     // Traverse down to bucket with item
     for (temp = set->buckets[i]; temp != NULL; temp = temp->next) {
+        COUNT_PROBES(set, probes, 1L);
         if (!set->cmp(item, temp->payload)) {
             break;
         }
@@ -120,11 +304,24 @@ static HsEntry *_fetch_entry(HashSet *set, void *item, long *index) {
 }
 
 /**
- * Allocates and returns a new hashset entry ADT.
+ * Fetches the entry from `set` with the item `item` from the set and returns it. Also stores the
+ * bucket where the entry is located into `*bucket` (or if not found, the bucket where the item is to
+ * be inserted). Returns NULL if no such entry exists.
  */
-static HsEntry *_malloc_entry(void *item) {
+static HsEntry *_fetch_entry(HashSet *set, void *item, HsEntry ***bucket) {
+
+    HashHint hint;
 
-    HsEntry *entry = (HsEntry *)malloc(sizeof(HsEntry));
+    _hash_item(set, item, &hint);
+    return _fetch_hashed(set, item, &hint, bucket);
+}
+
+/**
+ * Allocates and returns a new hashset entry ADT from the pool of the set `set`.
+ */
+static HsEntry *_malloc_entry(HashSet *set, void *item) {
+
+    HsEntry *entry = (HsEntry *)nodepool_alloc(set->pool, sizeof(HsEntry));
     if (entry != NULL) {
         entry->payload = item;
         entry->next = NULL;
@@ -134,20 +331,104 @@ static HsEntry *_malloc_entry(void *item) {
 }
 
 /**
- * Resizes the hashset by doubling its capacity once its load factor is reached.
+ * Moves every entry in the old bucket `i` over into the current array of buckets.
  */
-static void _resize_set(HashSet *set) {
+static void _rehash_bucket(HashSet *set, long i) {
+
+    HsEntry *temp, *next;
+    long index;
 
-    HsEntry **buckets, *temp, *next;
+    temp = set->oldBuckets[i];
+    while (temp != NULL) {
+        next = temp->next;
+        index = _bucket_index(set, temp->payload, set->capacity);
+        temp->next = set->buckets[index];
+        set->buckets[index] = temp;
+        temp = next;
+    }
+    set->oldBuckets[i] = NULL;
+}
+
+/**
+ * Returns the current time of the monotonic clock, in nanoseconds.
+ */
+static long _now_nanos(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ( ts.tv_sec * 1000000000L ) + ts.tv_nsec;
+}
+
+// Number of old buckets moved per insertion or removal during an incremental resize
+#define REHASH_STEPS 4L
+// Maximum number of empty old buckets skipped over per rehashed bucket
+#define REHASH_EMPTY_VISITS 10L
+
+/**
+ * Performs one step of an incremental resize, moving at most `steps` non-empty old buckets over
+ * into the current array of buckets. Once every old bucket has been moved, the old array is freed.
+ */
+static void _rehash_step(HashSet *set, long steps) {
+
+    long visits = ( steps * REHASH_EMPTY_VISITS ), start = _now_nanos();
+
+    // Entries change buckets, which invalidates any cursors
+    set->modCount++;
+
+    while (steps > 0L && set->rehashIndex < set->oldCapacity) {
+        if (set->oldBuckets[set->rehashIndex] != NULL) {
+            _rehash_bucket(set, set->rehashIndex);
+            steps--;
+        } else if (--visits == 0L) {
+            break;
+        }
+        set->rehashIndex++;
+    }
+
+    // Resize is complete, release the old buckets
+    if (set->rehashIndex == set->oldCapacity) {
+        allocator_free(set->allocator, set->oldBuckets);
+        set->oldBuckets = NULL;
+        set->oldCapacity = 0L;
+        set->rehashIndex = 0L;
+    }
+    set->resizeNanos += ( _now_nanos() - start );
+}
+
+/**
+ * Finishes the incremental resize currently in progress, if any.
+ */
+static void _rehash_all(HashSet *set) {
+
+    if (set->oldBuckets != NULL) {
+        _rehash_step(set, set->oldCapacity);
+    }
+}
+
+/**
+ * Resizes the hashset to `cap` buckets, normally double its capacity once its load factor is
+ * reached. If the set resizes incrementally, the entries are left in the old buckets and moved over
+ * by later operations.
+ */
+static void _resize_set(HashSet *set, long cap) {
+
+    HsEntry **buckets;
     size_t bytes;
-    long i, index, cap = (set->capacity * 2);
+    long i, start;
+
+    // Only one resize may be in progress at a time
+    _rehash_all(set);
+    start = _now_nanos();
 
     // Allocates the new array of buckets
-    if (cap > MAX_CAPACITY) {
+    if (set->seededHash != NULL) {
+        if (cap > MAX_POW2_CAPACITY) {
+            return;
+        }
+    } else if (cap > MAX_CAPACITY) {
         cap = MAX_CAPACITY;
     }
     bytes = (cap * sizeof(HsEntry *));
-    buckets = (HsEntry **)malloc(bytes);
+    buckets = (HsEntry **)allocator_alloc(set->allocator, bytes);
     if (buckets == NULL) {
         return;
     }
@@ -155,57 +436,128 @@ static void _resize_set(HashSet *set) {
         buckets[i] = NULL;
     }
 
+    // Keep the current buckets around as the old buckets to rehash from
+    set->oldBuckets = set->buckets;
+    set->oldCapacity = set->capacity;
+    set->rehashIndex = 0L;
+    set->buckets = buckets;
+    set->capacity = cap;
+    set->resizeNanos += ( _now_nanos() - start );
+
     // After resizing, need to rehash all entries into new indecies
-    for (i = 0L; i < set->capacity; i++) {
-        temp = set->buckets[i];
-        while (temp != NULL) {
-            next = temp->next;
-            index = set->hash(temp->payload, cap);
-            temp->next = buckets[index];
-            buckets[index] = temp;
-            temp = next;
-        }
+    if (set->incremental == FALSE) {
+        _rehash_all(set);
     }
 
     // Updates hashset attributes after resize
-    free(set->buckets);
+    set->threshold = _threshold(set->loadFactor, cap);
+    set->resizes++;
+    set->modCount++;
+}
+
+static long _fit_capacity(HashSet *set, long n);
+
+/**
+ * Promotes the small set `set` to an array of `cap` buckets, allocating an entry for each of its
+ * elements. Returns TRUE if successful, FALSE if allocation fails (the set stays small).
+ */
+static Boolean _small_promote(HashSet *set, long cap) {
+
+    HsEntry **buckets, *entry, *next;
+    long i, index, start = _now_nanos();
+
+    buckets = (HsEntry **)allocator_alloc(set->allocator, cap * sizeof(HsEntry *));
+    if (buckets == NULL) {
+        return FALSE;
+    }
+    for (i = 0L; i < cap; i++) {
+        buckets[i] = NULL;
+    }
+    for (i = 0L; i < set->size; i++) {
+        entry = _malloc_entry(set, set->small[i].payload);
+        if (entry == NULL) {
+            // Releases the entries allocated so far, leaving the set as it was
+            for (index = 0L; index < cap; index++) {
+                for (entry = buckets[index]; entry != NULL; entry = next) {
+                    next = entry->next;
+                    nodepool_free(set->pool, entry, sizeof(HsEntry));
+                }
+            }
+            allocator_free(set->allocator, buckets);
+            return FALSE;
+        }
+        index = _bucket_index(set, entry->payload, cap);
+        entry->next = buckets[index];
+        buckets[index] = entry;
+    }
+
+    // The inline entries stay behind in the set's allocation, but are never used again
     set->buckets = buckets;
+    set->small = NULL;
     set->capacity = cap;
-    set->delta = ( 1.0 / (double)cap );
-    set->changes = 0L;
-    set->load /= 2.0;
+    set->minCapacity = _fit_capacity(set, SMALL_CAPACITY + 1L);
+    set->threshold = _threshold(set->loadFactor, cap);
+    set->resizes++;
+    set->resizeNanos += ( _now_nanos() - start );
+    set->modCount++;
+
+    return TRUE;
 }
 
-// Default trigger: check load factor after this many changes
-#define TRIGGER 100L
+void hashset_setIncrementalResize(HashSet *set, Boolean incremental) {
+
+    set->incremental = incremental;
+    if (incremental == FALSE) {
+        _rehash_all(set);
+    }
+}
 
 // Macro to check if the map `m` is currently empty
 #define IS_EMPTY(m)  ( ((m)->size == 0L) ? TRUE : FALSE )
 
-Status hashset_add(HashSet *set, void *item) {
+/**
+ * Adds the item `item`, which was hashed into `hint`, into the hashset `set`, with the same
+ * semantics as hashset_add().
+ */
+static Status _add_hashed(HashSet *set, void *item, HashHint *hint) {
 
     Status status;
 
-    // Check load factor, resize when needed
-    if (set->changes >= TRIGGER) {
-        set->changes = 0L;
-        if (set->load >= set->loadFactor && set->capacity < MAX_CAPACITY) {
-            _resize_set(set);
-        }
+    // Moves along the incremental resize in progress
+    if (set->oldBuckets != NULL) {
+        _rehash_step(set, REHASH_STEPS);
     }
 
-    long i;
-    HsEntry *temp = _fetch_entry(set, item, &i);
+    HsEntry **bucket;
+    HsEntry *temp = _fetch_hashed(set, item, hint, &bucket);
+    if (temp == NULL && IS_SMALL(set) == TRUE) {
+        // Appends the new element behind the others, or promotes the set once they are full
+        if (set->size < SMALL_CAPACITY) {
+            set->small[set->size].next = NULL;
+            set->small[set->size].payload = item;
+            set->size++;
+            set->modCount++;
+            return OK;
+        }
+        if (_small_promote(set, _fit_capacity(set, set->size + 1L)) == FALSE) {
+            return ALLOC_FAILURE;
+        }
+        (void)_fetch_hashed(set, item, hint, &bucket);
+    }
     if (temp == NULL) {
+        // Grows the set before its size would exceed the load factor
+        if (set->size >= set->threshold && set->capacity < CAPACITY_LIMIT(set)) {
+            _resize_set(set, set->capacity * 2L);
+            (void)_fetch_hashed(set, item, hint, &bucket);
+        }
         // Allocates and insert new entry
-        HsEntry *entry = _malloc_entry(item);
+        HsEntry *entry = _malloc_entry(set, item);
         if (entry != NULL) {
             // Adds the new element into the set
-            entry->next = set->buckets[i];
-            set->buckets[i] = entry;
-            set->changes++;
-            set->load += set->delta;
+            entry->next = *bucket;
+            *bucket = entry;
             set->size++;
+            set->modCount++;
             status = OK;
         } else {
             status = ALLOC_FAILURE;
@@ -217,34 +569,58 @@ Status hashset_add(HashSet *set, void *item) {
     return status;
 }
 
+Status hashset_add(HashSet *set, void *item) {
+
+    HashHint hint;
+
+    _hash_item(set, item, &hint);
+    return _add_hashed(set, item, &hint);
+}
+
 Boolean hashset_contains(HashSet *set, void *item) {
-    long i;
-    return ( _fetch_entry(set, item, &i) != NULL ) ? TRUE : FALSE;
+    HsEntry **bucket;
+    return ( _fetch_entry(set, item, &bucket) != NULL ) ? TRUE : FALSE;
 }
 
-Status hashset_remove(HashSet *set, void *item, void (*destructor)(void *)) {
+/**
+ * Removes the item `item`, which was hashed into `hint`, from the non-empty hashset `set`, with
+ * the same semantics as hashset_remove().
+ */
+static Status _remove_hashed(HashSet *set, void *item, HashHint *hint,
+                             void (*destructor)(void *)) {
 
-    // Checks if the set is currently empty
-    if (IS_EMPTY(set) == TRUE) {
-        return STRUCT_EMPTY;
+    // Moves along the incremental resize in progress
+    if (set->oldBuckets != NULL) {
+        _rehash_step(set, REHASH_STEPS);
     }
 
-    long i;
-    HsEntry *temp = _fetch_entry(set, item, &i);
+    HsEntry **bucket;
+    HsEntry *temp = _fetch_hashed(set, item, hint, &bucket);
     // Entry is not present
     if (temp == NULL) {
         return NOT_FOUND;
     }
 
+    // Small sets move their last entry into the removed entry's place
+    if (IS_SMALL(set) == TRUE) {
+        if (destructor != NULL) {
+            (*destructor)(temp->payload);
+        }
+        *temp = set->small[set->size - 1L];
+        set->size--;
+        set->modCount++;
+        return OK;
+    }
+
     // Fetches the entry from the hashset
-    HsEntry *prev = NULL, *curr = set->buckets[i];
+    HsEntry *prev = NULL, *curr = *bucket;
     while (curr != temp) {
         prev = curr;
         curr = curr->next;
     }
     // Unlinks the bucket item from the set
     if (prev == NULL) {
-        set->buckets[i] = temp->next;
+        *bucket = temp->next;
     } else {
         prev->next = temp->next;
     }
@@ -253,14 +629,225 @@ Status hashset_remove(HashSet *set, void *item, void (*destructor)(void *)) {
     if (destructor != NULL) {
         (*destructor)(temp->payload);
     }
-    free(temp);
-    set->changes++;
-    set->load -= set->delta;
+    nodepool_free(set->pool, temp, sizeof(HsEntry));
     set->size--;
+    set->modCount++;
+
+    // Halves the table once the set has drained below a quarter of its threshold
+    if (set->size < set->threshold / 4L && set->capacity / 2L >= set->minCapacity) {
+        _resize_set(set, set->capacity / 2L);
+    }
 
     return OK;
 }
 
+Status hashset_remove(HashSet *set, void *item, void (*destructor)(void *)) {
+
+    HashHint hint;
+
+    // Checks if the set is currently empty
+    if (IS_EMPTY(set) == TRUE) {
+        return STRUCT_EMPTY;
+    }
+
+    _hash_item(set, item, &hint);
+    return _remove_hashed(set, item, &hint, destructor);
+}
+
+// Number of items that batch operations hash and prefetch ahead of the item being processed
+#define PREFETCH_DISTANCE 8L
+
+/**
+ * Hashes the item `item` into `*hint` ahead of its lookup, and prefetches its bucket.
+ */
+static void _prefetch_item(HashSet *set, void *item, HashHint *hint) {
+    _hash_item(set, item, hint);
+    if (IS_SMALL(set) == FALSE) {
+        __builtin_prefetch(&(set->buckets[hint->index]));
+    }
+}
+
+/**
+ * Starts the prefetch window `hints` of a batch operation over the `n` items in `items`,
+ * prefetching the first PREFETCH_DISTANCE items.
+ */
+static void _start_window(HashSet *set, void **items, long n, HashHint *hints) {
+
+    long i;
+    for (i = 0L; i < n && i < PREFETCH_DISTANCE; i++) {
+        _prefetch_item(set, items[i], &(hints[i]));
+    }
+}
+
+/**
+ * Takes the hint of the `i`th item out of the prefetch window `hints` into `*hint`, and refills
+ * its place with the item PREFETCH_DISTANCE places further along. The first entry in the bucket of
+ * the item halfway along the window, whose bucket has arrived by now, is prefetched as well.
+ */
+static void _advance_window(HashSet *set, void **items, long n, long i, HashHint *hints,
+                            HashHint *hint) {
+
+    long slot = ( i % PREFETCH_DISTANCE ), j;
+
+    *hint = hints[slot];
+    if (i + PREFETCH_DISTANCE < n) {
+        _prefetch_item(set, items[i + PREFETCH_DISTANCE], &(hints[slot]));
+    }
+    j = ( i + PREFETCH_DISTANCE / 2L );
+    if (j < n && hints[j % PREFETCH_DISTANCE].capacity == set->capacity) {
+        __builtin_prefetch(set->buckets[hints[j % PREFETCH_DISTANCE].index]);
+    }
+}
+
+/**
+ * Number of items hashed and prefetched together by hashset_containsMany() before any of them is
+ * probed.
+ */
+#define LOOKUP_GROUP 16L
+
+long hashset_containsMany(HashSet *set, void **items, long n, Boolean *results) {
+
+    HashHint hints[LOOKUP_GROUP];
+    HsEntry **bucket, *temp;
+    long i, j, count, found = 0L;
+
+    for (i = 0L; i < n; i += LOOKUP_GROUP) {
+        count = ( n - i < LOOKUP_GROUP ) ? n - i : LOOKUP_GROUP;
+
+        // First pass hashes the whole group and issues a prefetch for every bucket
+        for (j = 0L; j < count; j++) {
+            _prefetch_item(set, items[i + j], &(hints[j]));
+        }
+        // Then prefetches the head of each chain, whose bucket has arrived by now
+        for (j = 0L; j < count && IS_SMALL(set) == FALSE; j++) {
+            __builtin_prefetch(set->buckets[hints[j].index]);
+        }
+        // Only then are the items probed, by which point their memory is mostly in cache
+        for (j = 0L; j < count; j++) {
+            temp = _fetch_hashed(set, items[i + j], &(hints[j]), &bucket);
+            results[i + j] = ( temp != NULL ) ? TRUE : FALSE;
+            if (temp != NULL) {
+                found++;
+            }
+        }
+    }
+
+    return found;
+}
+
+/**
+ * Returns the smallest capacity the hashset `set` can take on while holding `n` items under its
+ * load factor, which is always a power of two for seeded sets.
+ */
+static long _fit_capacity(HashSet *set, long n) {
+
+    long cap, limit = CAPACITY_LIMIT(set);
+
+    if (set->seededHash != NULL) {
+        cap = 1L;
+        while (n > _threshold(set->loadFactor, cap) && cap < limit) {
+            cap *= 2L;
+        }
+    } else {
+        cap = (long)((double)n / set->loadFactor);
+        cap = ( cap < 1L ) ? 1L : ( cap > limit ) ? limit : cap;
+        while (n > _threshold(set->loadFactor, cap) && cap < limit) {
+            cap++;
+        }
+    }
+
+    return cap;
+}
+
+/**
+ * Grows the hashset `set` so that `n` more items fit under its load factor with at most one
+ * resize, rather than doubling repeatedly along the way.
+ */
+static Status _reserve(HashSet *set, long n) {
+
+    long cap = _fit_capacity(set, set->size + n);
+
+    if (IS_SMALL(set) == TRUE) {
+        // Small sets only need promoting once the elements no longer fit inline
+        if (set->size + n > SMALL_CAPACITY && _small_promote(set, cap) == FALSE) {
+            return ALLOC_FAILURE;
+        }
+    } else if (cap > set->capacity) {
+        _resize_set(set, cap);
+        if (set->capacity != cap) {
+            return ALLOC_FAILURE;
+        }
+    }
+
+    return OK;
+}
+
+Status hashset_reserve(HashSet *set, long n) {
+
+    Status status = _reserve(set, ( n > set->size ) ? n - set->size : 0L);
+
+    // The reserved capacity must survive removals until the set is explicitly shrunk
+    if (status == OK && set->capacity > set->minCapacity) {
+        set->minCapacity = set->capacity;
+    }
+
+    return status;
+}
+
+Status hashset_shrinkToFit(HashSet *set) {
+
+    long cap = _fit_capacity(set, set->size);
+
+    // Small sets already hold no spare storage of their own
+    if (IS_SMALL(set) == TRUE) {
+        return OK;
+    }
+    set->minCapacity = cap;
+    if (cap < set->capacity) {
+        _resize_set(set, cap);
+        if (set->capacity != cap) {
+            return ALLOC_FAILURE;
+        }
+    }
+
+    return OK;
+}
+
+Status hashset_addAll(HashSet *set, void **items, long n) {
+
+    HashHint hints[PREFETCH_DISTANCE], hint;
+    long i;
+
+    // Sizes the table for the whole batch up front
+    (void)_reserve(set, n);
+    _start_window(set, items, n, hints);
+
+    for (i = 0L; i < n; i++) {
+        _advance_window(set, items, n, i, hints, &hint);
+        if (_add_hashed(set, items[i], &hint) == ALLOC_FAILURE) {
+            return ALLOC_FAILURE;
+        }
+    }
+
+    return OK;
+}
+
+long hashset_removeAll(HashSet *set, void **items, long n, void (*destructor)(void *)) {
+
+    HashHint hints[PREFETCH_DISTANCE], hint;
+    long i, removed = 0L;
+
+    _start_window(set, items, n, hints);
+    for (i = 0L; i < n; i++) {
+        _advance_window(set, items, n, i, hints, &hint);
+        if (IS_EMPTY(set) == FALSE && _remove_hashed(set, items[i], &hint, destructor) == OK) {
+            removed++;
+        }
+    }
+
+    return removed;
+}
+
 /**
  * Helper method to clear out the hashset `set` of all its elements, applying the destructor method
  * `destructor` on each element (or if NULL, nothing will be done to the elements).
@@ -270,6 +857,26 @@ static void _clear_set(HashSet *set, void (*destructor)(void *)) {
     HsEntry *temp, *next;
     long i;
 
+    if (IS_SMALL(set) == TRUE) {
+        for (i = 0L; i < set->size && destructor != NULL; i++) {
+            (*destructor)(set->small[i].payload);
+        }
+        return;
+    }
+
+    // Without a destructor to apply, every entry is released at once and the buckets are emptied
+    if (destructor == NULL) {
+        nodepool_reset(set->pool);
+        allocator_free(set->allocator, set->oldBuckets);
+        set->oldBuckets = NULL;
+        set->oldCapacity = 0L;
+        set->rehashIndex = 0L;
+        memset(set->buckets, 0, set->capacity * sizeof(HsEntry *));
+        return;
+    }
+
+    // No point moving the old entries over just to free them
+    _rehash_all(set);
     for (i = 0L; i < set->capacity; i++) {
         temp = set->buckets[i];
         while (temp != NULL) {
@@ -278,18 +885,17 @@ static void _clear_set(HashSet *set, void (*destructor)(void *)) {
             if (destructor != NULL) {
                 (*destructor)(temp->payload);
             }
-            free(temp);
             temp = next;
         }
         set->buckets[i] = NULL;
     }
+    nodepool_reset(set->pool);
 }
 
 void hashset_clear(HashSet *set, void (*destructor)(void *)) {
     _clear_set(set, destructor);
     set->size = 0L;
-    set->changes = 0L;
-    set->load = 0.0;
+    set->modCount++;
 }
 
 long hashset_size(HashSet *set) {
@@ -300,6 +906,58 @@ Boolean hashset_isEmpty(HashSet *set) {
     return IS_EMPTY(set);
 }
 
+/**
+ * Records a chain of length `len` into the histogram and chain totals of `stats`.
+ */
+static void _record_chain(HashStats *stats, long len, long *total) {
+
+    stats->histogram[( len < HASH_STATS_BINS ) ? len : HASH_STATS_BINS - 1]++;
+    if (len > 0L) {
+        stats->usedBuckets++;
+        *total += len;
+    }
+    if (len > stats->maxChain) {
+        stats->maxChain = len;
+    }
+}
+
+void hashset_stats(HashSet *set, HashStats *stats) {
+
+    HsEntry *temp;
+    long i, len, total = 0L;
+
+    memset(stats, 0, sizeof(HashStats));
+    stats->capacity = set->capacity;
+    stats->size = set->size;
+    stats->load = ( (double)set->size / (double)set->capacity );
+    stats->resizes = set->resizes;
+    stats->resizeNanos = set->resizeNanos;
+    stats->lookups = set->lookups;
+    stats->probes = set->probes;
+
+    // Lookups in small sets scan the entries in order, finding each one after as many probes as
+    // its rank
+    for (i = 0L; i < set->size && IS_SMALL(set) == TRUE; i++) {
+        _record_chain(stats, i + 1L, &total);
+    }
+    for (i = 0L; i < set->capacity && IS_SMALL(set) == FALSE; i++) {
+        for (len = 0L, temp = set->buckets[i]; temp != NULL; temp = temp->next) {
+            len++;
+        }
+        _record_chain(stats, len, &total);
+    }
+    // Buckets not yet moved out of the old array still hold their chains
+    for (i = set->rehashIndex; i < set->oldCapacity; i++) {
+        for (len = 0L, temp = set->oldBuckets[i]; temp != NULL; temp = temp->next) {
+            len++;
+        }
+        if (len > 0L) {
+            _record_chain(stats, len, &total);
+        }
+    }
+    stats->meanChain = ( stats->usedBuckets == 0L ) ? 0.0 : (double)total / stats->usedBuckets;
+}
+
 /**
  * Helper method to generate an array representation of the hashset. Returns the allocated array
  * with the populated elements, or NULL if failed (allocation error).
@@ -318,12 +976,20 @@ static void **_generate_array(HashSet *set) {
         return NULL;
     }
 
-    // Populates the array with hashset entries
-    for (i = 0L; i < set->capacity; i++) {
+    // Populates the array with hashset entries, including those yet to be rehashed
+    for (i = 0L; i < set->size && IS_SMALL(set) == TRUE; i++) {
+        items[j++] = set->small[i].payload;
+    }
+    for (i = 0L; i < set->capacity && IS_SMALL(set) == FALSE; i++) {
         for (temp = set->buckets[i]; temp != NULL; temp = temp->next) {
             items[j++] = temp->payload;
         }
     }
+    for (i = 0L; i < set->oldCapacity; i++) {
+        for (temp = set->oldBuckets[i]; temp != NULL; temp = temp->next) {
+            items[j++] = temp->payload;
+        }
+    }
 
     return items;
 }
@@ -382,8 +1048,236 @@ Status hashset_iterator(HashSet *set, Iterator **iter) {
     return OK;
 }
 
+/**
+ * Returns the entry of the hashset `set` following `prev`, which resides in the bucket `*index`,
+ * and updates `*index` accordingly. Passing a NULL `prev` and an index of -1 yields the first
+ * entry. Returns NULL once all entries have been visited. While resizing, indecies past the set's
+ * capacity refer to the buckets that have yet to be moved out of the old array.
+ */
+static HsEntry *_next_entry(HashSet *set, HsEntry *prev, long *index) {
+
+    long i = *index;
+
+    if (IS_SMALL(set) == TRUE) {
+        if (++i < set->size) {
+            *index = i;
+            return &(set->small[i]);
+        }
+        *index = set->size;
+        return NULL;
+    }
+    if (prev != NULL && prev->next != NULL) {
+        return prev->next;
+    }
+    for (i++; i < set->capacity; i++) {
+        if (set->buckets[i] != NULL) {
+            *index = i;
+            return set->buckets[i];
+        }
+    }
+    for (; i < set->capacity + set->oldCapacity; i++) {
+        if (set->oldBuckets[i - set->capacity] != NULL) {
+            *index = i;
+            return set->oldBuckets[i - set->capacity];
+        }
+    }
+    *index = set->capacity + set->oldCapacity;
+
+    return NULL;
+}
+
+void hashset_cursor(HashSet *set, Cursor *cursor) {
+    cursor->adt = set;
+    cursor->index = -1L;
+    cursor->node = _next_entry(set, NULL, &(cursor->index));
+    cursor->remaining = set->size;
+    cursor->modCount = set->modCount;
+}
+
+Status hashset_cursorNext(Cursor *cursor, void **next) {
+
+    HashSet *set = (HashSet *)cursor->adt;
+    HsEntry *entry = (HsEntry *)cursor->node;
+
+    // Fails fast if the hashset was modified since creating the cursor
+    if (set->modCount != cursor->modCount) {
+        return CONCURRENT_MODIFICATION;
+    }
+    // Checks if every element was visited
+    if (cursor->remaining == 0L) {
+        return ITER_END;
+    }
+
+    // Fetches the element, advances to the next entry
+    *next = entry->payload;
+    cursor->node = _next_entry(set, entry, &(cursor->index));
+    cursor->remaining--;
+
+    return OK;
+}
+
+Boolean hashset_forEach(HashSet *set, Boolean (*action)(void *, void *), void *context) {
+
+    HsEntry *entry;
+    long i;
+
+    // Small sets hold their elements inline
+    if (IS_SMALL(set) == TRUE) {
+        for (i = 0L; i < set->size; i++) {
+            if ((*action)(set->small[i].payload, context) == FALSE) {
+                return FALSE;
+            }
+        }
+        return TRUE;
+    }
+
+    // Walks each bucket, then the buckets an incremental resize has yet to move
+    for (i = 0L; i < set->capacity + set->oldCapacity; i++) {
+        entry = ( i < set->capacity ) ? set->buckets[i] : set->oldBuckets[i - set->capacity];
+        for (; entry != NULL; entry = entry->next) {
+            if ((*action)(entry->payload, context) == FALSE) {
+                return FALSE;
+            }
+        }
+    }
+
+    return TRUE;
+}
+
+/**
+ * Context passed along while walking a hashset for one of the set operations.
+ */
+typedef struct {
+    HashSet *result;    // The hashset being built
+    HashSet *other;     // The hashset the walked elements are looked up in, NULL to keep them all
+    Boolean keep;       // TRUE to keep the elements found in `other`, FALSE to keep the others
+    Boolean ownCopy;    // TRUE to keep the copy held by `other` of each element found in it
+    Status status;      // Set to ALLOC_FAILURE if an element could not be added
+} SetOp;
+
+/**
+ * Adds the element `item` to the result of the set operation `context` if it is to be kept.
+ */
+static Boolean _set_op_element(void *item, void *context) {
+
+    SetOp *op = (SetOp *)context;
+    HsEntry **bucket, *entry;
+
+    if (op->other != NULL) {
+        entry = _fetch_entry(op->other, item, &bucket);
+        if (( entry != NULL ? TRUE : FALSE ) != op->keep) {
+            return TRUE;
+        }
+        if (entry != NULL && op->ownCopy == TRUE) {
+            item = entry->payload;
+        }
+    }
+    if (hashset_add(op->result, item) == ALLOC_FAILURE) {
+        op->status = ALLOC_FAILURE;
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/**
+ * Creates the empty hashset `*result` of a set operation on `set`, hashing and comparing alike,
+ * with room for `n` elements.
+ */
+static Status _set_op_result(HashSet *set, long n, HashSet **result) {
+
+    HashSet *temp;
+
+    Status status = _new_set(&temp, set->hash, set->seededHash, set->cmp, 0L, set->loadFactor,
+                             FALSE, set->allocator);
+    if (status != OK) {
+        return status;
+    }
+    if (_reserve(temp, n) != OK) {
+        hashset_destroy(temp, NULL);
+        return ALLOC_FAILURE;
+    }
+    *result = temp;
+
+    return OK;
+}
+
+/**
+ * Walks the hashset `set` into the result of the set operation `op`, destroying the result if an
+ * element could not be added.
+ */
+static Status _set_op_walk(HashSet *set, SetOp *op) {
+
+    hashset_forEach(set, _set_op_element, op);
+    if (op->status != OK) {
+        hashset_destroy(op->result, NULL);
+    }
+
+    return op->status;
+}
+
+Status hashset_union(HashSet *a, HashSet *b, HashSet **result) {
+
+    SetOp op = { NULL, NULL, FALSE, FALSE, OK };
+
+    // Starts from every element of `a`, then adds those of `b` that `a` lacks
+    Status status = _set_op_result(a, ( a->size > b->size ) ? a->size : b->size, &op.result);
+    if (status != OK || (status = _set_op_walk(a, &op)) != OK) {
+        return status;
+    }
+    op.other = a;
+    if ((status = _set_op_walk(b, &op)) != OK) {
+        return status;
+    }
+    *result = op.result;
+
+    return OK;
+}
+
+Status hashset_intersect(HashSet *a, HashSet *b, HashSet **result) {
+
+    // Walks the smaller hashset, looking its elements up in the larger one
+    HashSet *small = ( a->size <= b->size ) ? a : b;
+    SetOp op = { NULL, ( small == a ) ? b : a, TRUE, ( small == b ) ? TRUE : FALSE, OK };
+
+    Status status = _set_op_result(a, small->size, &op.result);
+    if (status != OK || (status = _set_op_walk(small, &op)) != OK) {
+        return status;
+    }
+    *result = op.result;
+
+    return OK;
+}
+
+Status hashset_difference(HashSet *a, HashSet *b, HashSet **result) {
+
+    SetOp op = { NULL, b, FALSE, FALSE, OK };
+
+    Status status = _set_op_result(a, a->size, &op.result);
+    if (status != OK || (status = _set_op_walk(a, &op)) != OK) {
+        return status;
+    }
+    *result = op.result;
+
+    return OK;
+}
+
+long hashset_memoryUsage(HashSet *set) {
+
+    long bytes = (long)set->structBytes;
+
+    // Counts the buckets an incremental resize has yet to move along with the current ones
+    if (set->buckets != NULL) {
+        bytes += ( set->capacity + set->oldCapacity ) * (long)sizeof(HsEntry *);
+    }
+
+    return bytes + nodepool_memoryUsage(set->pool);
+}
+
 void hashset_destroy(HashSet *set, void (*destructor)(void *)) {
     _clear_set(set, destructor);
-    free(set->buckets);
-    free(set);
+    nodepool_destroy(set->pool);
+    allocator_free(set->allocator, set->oldBuckets);
+    allocator_free(set->allocator, set->buckets);
+    allocator_free(set->allocator, set);
 }
@@ -0,0 +1,198 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2020 Cole Vikupitz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <fcntl.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "hashing.h"
+
+// Secret constants of wyhash, each an odd 64-bit value with 32 bits set
+static const uint64_t WYP[4] = {
+    0xa0761d6478bd642fUL, 0xe7037ed1a0b428dbUL, 0x8ebc6af09c88c6e3UL, 0x589965cc75374cc3UL
+};
+
+// Number of seeds handed out so far, mixed into every seed
+static uint64_t seedCount = 0UL;
+
+uint64_t hashing_seed(void) {
+
+    uint64_t seed = 0UL, local;
+    int fd;
+
+    // Reads the seed from the system's entropy source if possible
+    fd = open("/dev/urandom", O_RDONLY);
+    if (fd >= 0) {
+        if (read(fd, &seed, sizeof(seed)) != (ssize_t)sizeof(seed)) {
+            seed = 0UL;
+        }
+        close(fd);
+    }
+
+    // Always mixes in the time, a stack address and the counter, so seeds stay distinct either way
+    seed ^= hashing_mix64((uint64_t)time(NULL) ^ ( (uint64_t)clock() << 32 ));
+    seed ^= hashing_mix64((uint64_t)(uintptr_t)&local);
+    seed ^= hashing_mix64(__atomic_add_fetch(&seedCount, 1UL, __ATOMIC_RELAXED) * WYP[0]);
+
+    return seed;
+}
+
+uint64_t hashing_mix64(uint64_t x) {
+
+    x ^= ( x >> 32 );
+    x *= 0xd6e8feb86659fd93UL;
+    x ^= ( x >> 32 );
+    x *= 0xd6e8feb86659fd93UL;
+    x ^= ( x >> 32 );
+
+    return x;
+}
+
+/**
+ * Multiplies `*a` by `*b` into a 128-bit product, storing the low half into `*a` and the high
+ * half into `*b`.
+ */
+static inline void _mum(uint64_t *a, uint64_t *b) {
+#if defined(__SIZEOF_INT128__)
+    __uint128_t r = *a;
+    r *= *b;
+    *a = (uint64_t)r;
+    *b = (uint64_t)( r >> 64 );
+#else
+    uint64_t ha = ( *a >> 32 ), hb = ( *b >> 32 ), la = (uint32_t)*a, lb = (uint32_t)*b;
+    uint64_t rh = ( ha * hb ), rm0 = ( ha * lb ), rm1 = ( hb * la ), rl = ( la * lb );
+    uint64_t t = ( rl + ( rm0 << 32 ) ), c = ( t < rl );
+    uint64_t lo = ( t + ( rm1 << 32 ) );
+    c += ( lo < t );
+    *a = lo;
+    *b = ( rh + ( rm0 >> 32 ) + ( rm1 >> 32 ) + c );
+#endif
+}
+
+/**
+ * Returns the xor of the two halves of the 128-bit product of `a` and `b`.
+ */
+static inline uint64_t _mix(uint64_t a, uint64_t b) {
+    _mum(&a, &b);
+    return ( a ^ b );
+}
+
+/**
+ * Reads 8 bytes starting at `p` as an unaligned integer.
+ */
+static inline uint64_t _read8(const uint8_t *p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+/**
+ * Reads 4 bytes starting at `p` as an unaligned integer.
+ */
+static inline uint64_t _read4(const uint8_t *p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+/**
+ * Reads the first, middle and last of the `k` (1 to 3) bytes starting at `p` into one integer.
+ */
+static inline uint64_t _read3(const uint8_t *p, long k) {
+    return ( ((uint64_t)p[0]) << 16 ) | ( ((uint64_t)p[k >> 1]) << 8 ) | p[k - 1];
+}
+
+uint64_t hashing_bytes(const void *data, long len, uint64_t seed) {
+
+    const uint8_t *p = (const uint8_t *)data;
+    uint64_t a, b;
+    long i = len;
+
+    seed ^= _mix(seed ^ WYP[0], WYP[1]);
+    if (len <= 16L) {
+        // Short inputs are read as (possibly overlapping) words from both ends
+        if (len >= 4L) {
+            a = ( _read4(p) << 32 ) | _read4(p + ( (len >> 3) << 2 ));
+            b = ( _read4(p + len - 4) << 32 ) | _read4(p + len - 4 - ( (len >> 3) << 2 ));
+        } else if (len > 0L) {
+            a = _read3(p, len);
+            b = 0UL;
+        } else {
+            a = b = 0UL;
+        }
+    } else {
+        // Long inputs are consumed 48 bytes at a time over three independent lanes
+        if (i > 48L) {
+            uint64_t see1 = seed, see2 = seed;
+            do {
+                seed = _mix(_read8(p) ^ WYP[1], _read8(p + 8) ^ seed);
+                see1 = _mix(_read8(p + 16) ^ WYP[2], _read8(p + 24) ^ see1);
+                see2 = _mix(_read8(p + 32) ^ WYP[3], _read8(p + 40) ^ see2);
+                p += 48;
+                i -= 48L;
+            } while (i > 48L);
+            seed ^= ( see1 ^ see2 );
+        }
+        while (i > 16L) {
+            seed = _mix(_read8(p) ^ WYP[1], _read8(p + 8) ^ seed);
+            p += 16;
+            i -= 16L;
+        }
+        a = _read8(p + i - 16);
+        b = _read8(p + i - 8);
+    }
+
+    a ^= WYP[1];
+    b ^= seed;
+    _mum(&a, &b);
+
+    return _mix(a ^ WYP[0] ^ (uint64_t)len, b ^ WYP[1]);
+}
+
+uint64_t hashing_string(void *key, uint64_t seed) {
+    return hashing_bytes(key, (long)strlen((const char *)key), seed);
+}
+
+uint64_t hashing_long(void *key, uint64_t seed) {
+    return hashing_mix64((uint64_t)*(long *)key ^ seed);
+}
+
+uint64_t hashing_pointer(void *key, uint64_t seed) {
+    return hashing_mix64((uint64_t)(uintptr_t)key ^ seed);
+}
+
+int hashing_compareString(void *a, void *b) {
+    return strcmp((const char *)a, (const char *)b);
+}
+
+int hashing_compareLong(void *a, void *b) {
+
+    long x = *(long *)a, y = *(long *)b;
+    return ( x < y ) ? -1 : ( x > y ) ? 1 : 0;
+}
+
+int hashing_comparePointer(void *a, void *b) {
+    return ( a < b ) ? -1 : ( a > b ) ? 1 : 0;
+}
@@ -0,0 +1,302 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2020 Cole Vikupitz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "hazard.h"
+
+// The size of a cache line, records are padded to one so that threads do not share lines
+#define CACHE_LINE 64
+
+// The least number of retired nodes a thread collects before it scans the hazards
+#define SCAN_THRESHOLD 64L
+#define RETIRED_INIT_CAPACITY 64L
+
+/**
+ * A node waiting to be reclaimed.
+ */
+typedef struct {
+    void *ptr;                  // The retired node
+    void (*reclaim)(void *);    // The function that frees the node
+} Retired;
+
+/**
+ * A list of retired nodes.
+ */
+typedef struct {
+    Retired *items;             // The retired nodes
+    long len;                   // The number of retired nodes
+    long capacity;              // The capacity of `items`
+} RetiredList;
+
+/**
+ * Struct for a thread's hazard record.
+ */
+struct hazard_record {
+    void *slots[HAZARD_SLOTS];  // The thread's published hazards
+    int active;                 // 1 while the record is owned by a live thread
+    RetiredList retired;        // The nodes retired by the owning thread
+    long limit;                 // The number of retired nodes that triggers the next scan
+    struct hazard_record *next; // The next record in the registry
+} __attribute__((aligned(CACHE_LINE)));
+
+// Registry of every record ever allocated; records are reused but never freed
+static HazardRecord *records = NULL;
+
+// The calling thread's record
+static __thread HazardRecord *self = NULL;
+
+// Key used only to release a thread's record once the thread exits
+static pthread_key_t recordKey;
+static pthread_once_t recordKeyOnce = PTHREAD_ONCE_INIT;
+
+// Nodes left behind by exited threads that were still in use, adopted by the next scan
+static pthread_mutex_t orphanLock = PTHREAD_MUTEX_INITIALIZER;
+static RetiredList orphans = { NULL, 0L, 0L };
+static long orphanCount = 0L;
+
+/**
+ * Appends the node `ptr` onto the list `list`, growing it if needed.
+ */
+static Boolean _append(RetiredList *list, void *ptr, void (*reclaim)(void *)) {
+
+    if (list->len == list->capacity) {
+        long cap = ( list->capacity == 0L ) ? RETIRED_INIT_CAPACITY : list->capacity * 2L;
+        Retired *items = (Retired *)realloc(list->items, cap * sizeof(Retired));
+        if (items == NULL) {
+            return FALSE;
+        }
+        list->items = items;
+        list->capacity = cap;
+    }
+    list->items[list->len].ptr = ptr;
+    list->items[list->len].reclaim = reclaim;
+    list->len++;
+
+    return TRUE;
+}
+
+/**
+ * Hands the node `ptr` over to the orphans. If even that fails, the node is leaked rather than
+ * freed while it may still be in use.
+ */
+static void _orphan(void *ptr, void (*reclaim)(void *)) {
+
+    pthread_mutex_lock(&orphanLock);
+    (void)_append(&orphans, ptr, reclaim);
+    __atomic_store_n(&orphanCount, orphans.len, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&orphanLock);
+}
+
+/**
+ * Comparator for sorting and searching the collected hazards.
+ */
+static int _compare(const void *x, const void *y) {
+
+    uintptr_t a = (uintptr_t)*((void **)x);
+    uintptr_t b = (uintptr_t)*((void **)y);
+
+    return ( a < b ) ? -1 : ( a > b );
+}
+
+/**
+ * Reclaims every node retired by the owner of `record` that no thread holds a hazard on.
+ */
+static void _scan(HazardRecord *record) {
+
+    HazardRecord *head, *r;
+    RetiredList *list = &(record->retired);
+    void **hazards, *ptr;
+    long i, j, n = 0L;
+    int k;
+
+    // Adopts the nodes left behind by exited threads, unless someone else is already doing it
+    if (__atomic_load_n(&orphanCount, __ATOMIC_RELAXED) > 0L &&
+            pthread_mutex_trylock(&orphanLock) == 0) {
+        while (orphans.len > 0L) {
+            Retired *o = &(orphans.items[orphans.len - 1L]);
+            if (_append(list, o->ptr, o->reclaim) == FALSE) {
+                break;
+            }
+            orphans.len--;
+        }
+        __atomic_store_n(&orphanCount, orphans.len, __ATOMIC_RELAXED);
+        pthread_mutex_unlock(&orphanLock);
+    }
+
+    // Orders the unlinking of the retired nodes before the reading of the hazards
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+    // Records are only ever pushed onto the head, so the list below `head` cannot change
+    head = __atomic_load_n(&records, __ATOMIC_ACQUIRE);
+    for (r = head; r != NULL; r = r->next) {
+        n += HAZARD_SLOTS;
+    }
+    hazards = (void **)malloc(n * sizeof(void *));
+    if (hazards == NULL) {
+        return;
+    }
+
+    n = 0L;
+    for (r = head; r != NULL; r = r->next) {
+        for (k = 0; k < HAZARD_SLOTS; k++) {
+            ptr = __atomic_load_n(&(r->slots[k]), __ATOMIC_SEQ_CST);
+            if (ptr != NULL) {
+                hazards[n++] = ptr;
+            }
+        }
+    }
+    qsort(hazards, n, sizeof(void *), _compare);
+
+    // Reclaims the nodes not found among the hazards, keeping the rest for the next scan
+    for (i = 0L, j = 0L; i < list->len; i++) {
+        ptr = list->items[i].ptr;
+        if (bsearch(&ptr, hazards, n, sizeof(void *), _compare) == NULL) {
+            (*(list->items[i].reclaim))(ptr);
+        } else {
+            list->items[j++] = list->items[i];
+        }
+    }
+    list->len = j;
+    free(hazards);
+
+    // Keeps the cost of a scan proportional to the number of nodes it can reclaim
+    record->limit = j + ( (2L * n > SCAN_THRESHOLD) ? 2L * n : SCAN_THRESHOLD );
+}
+
+/**
+ * Releases the record of an exiting thread, passing its unreclaimed nodes on to the others.
+ */
+static void _release(void *arg) {
+
+    HazardRecord *record = (HazardRecord *)arg;
+    long i;
+
+    hazard_clear(record);
+    _scan(record);
+    for (i = 0L; i < record->retired.len; i++) {
+        _orphan(record->retired.items[i].ptr, record->retired.items[i].reclaim);
+    }
+    free(record->retired.items);
+    record->retired.items = NULL;
+    record->retired.len = 0L;
+    record->retired.capacity = 0L;
+    self = NULL;
+    __atomic_store_n(&(record->active), 0, __ATOMIC_RELEASE);
+}
+
+/**
+ * Creates the key used to release a thread's record once it exits.
+ */
+static void _make_key(void) {
+    pthread_key_create(&recordKey, _release);
+}
+
+HazardRecord *hazard_acquire(void) {
+
+    HazardRecord *record;
+    int expected;
+    int k;
+
+    if (self != NULL) {
+        return self;
+    }
+    pthread_once(&recordKeyOnce, _make_key);
+
+    // Reuses a record released by an exited thread if there is one
+    for (record = __atomic_load_n(&records, __ATOMIC_ACQUIRE); record != NULL;
+            record = record->next) {
+        expected = 0;
+        if (__atomic_load_n(&(record->active), __ATOMIC_RELAXED) == 0 &&
+                __atomic_compare_exchange_n(&(record->active), &expected, 1, FALSE,
+                                            __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+            break;
+        }
+    }
+
+    // Otherwise registers a new one
+    if (record == NULL) {
+        if (posix_memalign((void **)&record, CACHE_LINE, sizeof(HazardRecord)) != 0) {
+            return NULL;
+        }
+        for (k = 0; k < HAZARD_SLOTS; k++) {
+            record->slots[k] = NULL;
+        }
+        record->active = 1;
+        record->retired.items = NULL;
+        record->retired.len = 0L;
+        record->retired.capacity = 0L;
+        record->next = __atomic_load_n(&records, __ATOMIC_RELAXED);
+        while (!__atomic_compare_exchange_n(&records, &(record->next), record, TRUE,
+                                            __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+            ;
+    }
+
+    record->limit = SCAN_THRESHOLD;
+    pthread_setspecific(recordKey, record);
+    self = record;
+
+    return record;
+}
+
+void *hazard_protect(HazardRecord *record, int slot, void **src) {
+
+    void *ptr, *check = __atomic_load_n(src, __ATOMIC_ACQUIRE);
+
+    // The pointer is safe once it is published and still reachable from `src` afterwards
+    do {
+        ptr = check;
+        __atomic_store_n(&(record->slots[slot]), ptr, __ATOMIC_SEQ_CST);
+        check = __atomic_load_n(src, __ATOMIC_SEQ_CST);
+    } while (ptr != check);
+
+    return ptr;
+}
+
+void hazard_set(HazardRecord *record, int slot, void *ptr) {
+    __atomic_store_n(&(record->slots[slot]), ptr, __ATOMIC_SEQ_CST);
+}
+
+void hazard_clear(HazardRecord *record) {
+
+    int k;
+
+    for (k = 0; k < HAZARD_SLOTS; k++) {
+        __atomic_store_n(&(record->slots[k]), NULL, __ATOMIC_RELEASE);
+    }
+}
+
+void hazard_retire(void *ptr, void (*reclaim)(void *)) {
+
+    HazardRecord *record = hazard_acquire();
+
+    if (record == NULL || _append(&(record->retired), ptr, reclaim) == FALSE) {
+        _orphan(ptr, reclaim);
+        return;
+    }
+    if (record->retired.len >= record->limit) {
+        _scan(record);
+    }
+}
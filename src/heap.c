@@ -22,7 +22,11 @@
  * SOFTWARE.
  */
 
+#include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include "cds_stats.h"
 #include "heap.h"
 
 /**
@@ -31,59 +35,109 @@
 struct heap {
     int (*cmp)(void *, void *);     // Function for comparing the heap's elements
     void **data;                    // Array of the heap elements
+    void **block;                   // The allocation holding `data`, which is aligned within it
     long size;                      // The heap's current size
+    long modCount;                  // Number of structural modifications made
     long capacity;                  // The heap's current capacity
+    float growthFactor;             // The growth factor to apply when expanding the capacity
+    long arity;                     // The number of children of each node
+    long *ids;                      // The handle of each element, or -1; NULL until handles are used
+    long *slots;                    // The position of each handle, or the next free handle
+    long slotCapacity;              // The capacity of `slots`
+    long slotCount;                 // The number of handles ever handed out from `slots`
+    long freeSlot;                  // The first free handle to reuse, or -1
+    const CdsAllocator *allocator;  // Allocates the struct, the array and the handle tables
 };
 
 // The default capacity to assign when the capacity give is invalid
 #define DEFAULT_CAPACITY 16L
+// The default arity to assign when the arity given is invalid
+#define DEFAULT_ARITY 2L
+// The cache line size that each group of siblings is aligned to
+#define CACHE_LINE 64
+// Extra slots allocated for `data` so it can be shifted into alignment within its block
+#define SLACK ( (long)( CACHE_LINE / sizeof(void *) ) - 1L )
+// The default growth factor, doubling the capacity whenever the heap becomes full
+#define DEFAULT_GROWTH_FACTOR 1.0f
+// The maximum capacity allowed, beyond which the array's size in bytes would overflow
+#define MAX_CAPACITY ( (long)( PTRDIFF_MAX / sizeof(void *) ) - SLACK )
+// Arrays at least this large (in bytes) grow in whole huge pages
+#define HUGE_PAGE ( 2L * 1024L * 1024L )
 
-Status heap_new(Heap **heap, long capacity, int (*comparator)(void *, void *)) {
+/**
+ * Returns the address within the allocation `block` to store the heap's array at. The children of
+ * a node always start at an index that is 1 more than a multiple of the arity, so the array is
+ * shifted for index 1 to start a cache line; with arity 8, every group of siblings then shares
+ * exactly one cache line.
+ */
+static void **_align(void **block) {
+
+    uintptr_t first = (uintptr_t)(block + 1);
+    uintptr_t aligned = ( first + CACHE_LINE - 1 ) & ~((uintptr_t)CACHE_LINE - 1);
+    return (void **)aligned - 1;
+}
+
+Status heap_newWithAllocator(Heap **heap, long capacity, long arity,
+                             int (*comparator)(void *, void *), const CdsAllocator *allocator) {
+
+    if (allocator == NULL) {
+        allocator = allocator_default();
+    }
 
     // Allocate the struct, check for allocation failure
-    Heap *temp = (Heap *)malloc(sizeof(Heap));
+    Heap *temp = (Heap *)allocator_alloc(allocator, sizeof(Heap));
     if (temp == NULL) {
         return ALLOC_FAILURE;
     }
 
     // Evaluate the capacity, initialize the remaining members
     long cap = (capacity <= 0L) ? DEFAULT_CAPACITY : capacity;
-    size_t bytes = (cap * sizeof(void *));
-    void **array = (void **)malloc(bytes);
+    void **block = ( cap > MAX_CAPACITY ) ? NULL :
+                   (void **)allocator_reallocArray(allocator, NULL, cap + SLACK, sizeof(void *));
 
     // Checks for allocation failures
-    if (array == NULL) {
-        free(heap);
+    if (block == NULL) {
+        allocator_free(allocator, temp);
         return ALLOC_FAILURE;
     }
 
     // Initializes the remainder of struct members
-    long i;
-    for (i = 0L; i < cap; i++) {
-        array[i] = NULL;
-    }
-    temp->data = array;
+    // The slots past the size are never read, so they're left unfilled
+    temp->data = _align(block);
+    temp->block = block;
     temp->size = 0L;
+    temp->modCount = 0L;
     temp->capacity = cap;
+    temp->growthFactor = DEFAULT_GROWTH_FACTOR;
+    temp->arity = ( arity < 2L ) ? DEFAULT_ARITY : arity;
+    temp->ids = NULL;
+    temp->slots = NULL;
+    temp->slotCapacity = 0L;
+    temp->slotCount = 0L;
+    temp->freeSlot = -1L;
     temp->cmp = comparator;
+    temp->allocator = allocator;
     *heap = temp;
 
     return OK;
 }
 
-// Returns the left child index of `i`
-#define LEFT_CHILD(i)    ( ( 2 * (i) ) + 1 )
-// Returns the right child index of `i`
-#define RIGHT_CHILD(i)   ( ( 2 * (i) ) + 2 )
+Status heap_newWithArity(Heap **heap, long capacity, long arity,
+                         int (*comparator)(void *, void *)) {
+    return heap_newWithAllocator(heap, capacity, arity, comparator, NULL);
+}
+
+Status heap_new(Heap **heap, long capacity, int (*comparator)(void *, void *)) {
+    return heap_newWithArity(heap, capacity, DEFAULT_ARITY, comparator);
+}
+
+// Returns the first child index of `i`
+#define FIRST_CHILD(i)   ( ( heap->arity * (i) ) + 1 )
 // Returns the parent index of `i`
-#define PARENT(i)        ( ( (i) - 1 ) / 2 )
+#define PARENT(i)        ( ( (i) - 1 ) / heap->arity )
 
-// Returns TRUE if `i` has a left child index in array of size `N`, FALSE if not
-#define HAS_LEFT(i, N)    ( ( (LEFT_CHILD(i)) < (N) ) ? TRUE : FALSE )
-// Returns TRUE if i has a right child index in array of size `N`, FALSE if not
-#define HAS_RIGHT(i, N)   ( ( (RIGHT_CHILD(i)) < (N) ) ? TRUE : FALSE )
 // Returns TRUE if `i` has a parent index, FALSE if not
-#define HAS_PARENT(i)     ( ( (PARENT(i)) >= 0 ) ? TRUE : FALSE )
+#define HAS_PARENT(i)     ( ( (i) > 0 ) ? TRUE : FALSE )
 
 // Macro for comparing heap items given the indecies `x` and `y`; used for readability
 #define CMP(x, y)         ( (*heap->cmp)(heap->data[x], heap->data[y]) )
@@ -92,90 +146,259 @@ Status heap_new(Heap **heap, long capacity, int (*comparator)(void *, void *)) {
 #define IS_EMPTY(h)  ( ((h)->size == 0L) ? TRUE : FALSE )
 
 /**
- * Swaps two elements in the array of items given the two indecies `i` and `j`.
+ * Records that the element at the index `i` of the heap `heap` has moved there, if it has a handle.
+ */
+static void _track(Heap *heap, long i) {
+
+    if (heap->ids != NULL && heap->ids[i] >= 0L) {
+        heap->slots[heap->ids[i]] = i;
+    }
+}
+
+/**
+ * Swaps two elements in the array of items given the two indecies `i` and `j`, keeping the
+ * positions of their handles (if any) up to date.
  */
-static void _swap(void **data, long i, long j) {
-    void *temp = data[i];
-    data[i] = data[j];
-    data[j] = temp;
+static void _swap(Heap *heap, long i, long j) {
+
+    void *temp = heap->data[i];
+    heap->data[i] = heap->data[j];
+    heap->data[j] = temp;
+    if (heap->ids != NULL) {
+        long id = heap->ids[i];
+        heap->ids[i] = heap->ids[j];
+        heap->ids[j] = id;
+        _track(heap, i);
+        _track(heap, j);
+    }
 }
 
 /**
- * Updates the heap via heapifying upwards. Needs to be done after an insertion.
+ * Updates the heap via heapifying upwards from the index `index`. Needs to be done after an
+ * insertion.
  */
-static void _upheap(Heap *heap) {
+static void _upheap(Heap *heap, long index) {
 
-    long index = ( heap->size - 1 );
     while (HAS_PARENT(index) == TRUE && CMP(PARENT(index), index) > 0) {
         // Swaps the lesser items towards the top of the heap
-        _swap(heap->data, PARENT(index), index);
+        _swap(heap, PARENT(index), index);
         index = PARENT(index);
     }
 }
 
 /**
- * Updates the heap via heapifying downwards. Needs to be done after a deletion.
+ * Updates the heap via heapifying downwards from the index `index`. Needs to be done after a
+ * deletion.
  */
-static void _downheap(Heap *heap) {
+static void _downheap(Heap *heap, long index) {
 
-    long index = 0L;
-    while (HAS_LEFT(index, heap->size) == TRUE) {
-        long childIndex = LEFT_CHILD(index);
-        // Advance downwards while lesser items are below
-        if (HAS_RIGHT(index, heap->size) == TRUE && CMP(RIGHT_CHILD(index), LEFT_CHILD(index)) < 0)
-        {
-            childIndex = RIGHT_CHILD(index);
+    long child, last, childIndex;
+
+    while (FIRST_CHILD(index) < heap->size) {
+        // Finds the least of the children, which sit next to each other in the array
+        childIndex = FIRST_CHILD(index);
+        last = childIndex + heap->arity;
+        if (last > heap->size) {
+            last = heap->size;
+        }
+        for (child = childIndex + 1L; child < last; child++) {
+            if (CMP(child, childIndex) < 0) {
+                childIndex = child;
+            }
         }
 
+        // Advance downwards while lesser items are below
         if (CMP(index, childIndex) < 0) {
             break;
         }
         // Swaps the greater items towards the bottom of the heap
-        _swap(heap->data, index, childIndex);
+        _swap(heap, index, childIndex);
         index = childIndex;
     }
 }
 
 /**
- * Doubles the heap's capacity; returns TRUE if successful, FALSE if not.
+ * Resizes the heap's capacity to `newCapacity`; returns TRUE if successful, FALSE if not.
  */
-static Boolean _ensure_capacity(Heap *heap) {
+static Boolean _resize(Heap *heap, long newCapacity) {
 
     Boolean status = FALSE;
-    long newCapacity = heap->capacity * 2;
-    size_t bytes = ( newCapacity * sizeof(void *) );
-    void **temp = realloc(heap->data, bytes);
+    long shift = ( heap->data - heap->block );
+
+    // Grows the handles alongside the elements, if in use
+    if (heap->ids != NULL) {
+        long *ids = (long *)allocator_reallocArray(heap->allocator, heap->ids, newCapacity,
+                                                   sizeof(long));
+        if (ids == NULL) {
+            return FALSE;
+        }
+        heap->ids = ids;
+    }
+    void **temp = (void **)allocator_reallocArray(heap->allocator, heap->block,
+                                                  newCapacity + SLACK, sizeof(void *));
 
     if (temp != NULL) {
-        // Update the heap's properties
-        heap->data = temp;
-        long i;
-        for (i = heap->size; i < newCapacity; i++) {
-            heap->data[i] = NULL;
+        // Update the heap's properties, moving the items if the new block aligns differently
+        // The new slots are left as they are
+        heap->block = temp;
+        heap->data = _align(temp);
+        if (heap->data != temp + shift) {
+            memmove(heap->data, temp + shift, heap->size * sizeof(void *));
         }
         heap->capacity = newCapacity;
         status = TRUE;
+#if defined(CDS_HUGE_PAGES) && defined(MADV_HUGEPAGE)
+        // Asks for huge pages over the whole pages inside a large array, failures are harmless
+        size_t bytes = ( (newCapacity + SLACK) * sizeof(void *) );
+        if (bytes >= (size_t)( 2L * HUGE_PAGE )) {
+            uintptr_t start = ( (uintptr_t)temp + HUGE_PAGE - 1 ) & ~((uintptr_t)HUGE_PAGE - 1);
+            uintptr_t end = ( (uintptr_t)temp + bytes ) & ~((uintptr_t)HUGE_PAGE - 1);
+            (void)madvise((void *)start, end - start, MADV_HUGEPAGE);
+        }
+#endif
     }
 
     return status;
 }
 
-Status heap_insert(Heap *heap, void *item) {
+/**
+ * Makes room for `n` more elements in the heap, growing its capacity at most once. The capacity
+ * grows by the heap's growth factor, or to fit all `n` elements if that needs more; a large array
+ * is also rounded up to whole huge pages. Returns TRUE if successful, FALSE if not (allocation
+ * error, or the heap would grow past the maximum capacity).
+ */
+static Boolean _ensure_capacity(Heap *heap, long n) {
 
-    // Checks the capacity, extend if needed
-    if (heap->size == heap->capacity) {
-        if (_ensure_capacity(heap) == FALSE) {
-            return ALLOC_FAILURE;
+    long needed, grown, growth, perPage = ( HUGE_PAGE / (long)sizeof(void *) );
+
+    if (n <= heap->capacity - heap->size) {
+        return TRUE;
+    }
+    if (n > MAX_CAPACITY - heap->size) {
+        return FALSE;
+    }
+
+    needed = heap->size + n;
+    growth = (long)( (double)heap->capacity * heap->growthFactor );
+    growth = ( growth < 1L ) ? 1L : growth;
+    grown = ( growth > MAX_CAPACITY - heap->capacity ) ? MAX_CAPACITY : heap->capacity + growth;
+    grown = ( grown < needed ) ? needed : grown;
+    if (grown >= perPage && grown <= MAX_CAPACITY - perPage) {
+        grown = ( ( grown + perPage - 1L ) / perPage ) * perPage;
+    }
+
+    CDS_STATS_BEGIN();
+    Boolean resized = _resize(heap, grown);
+    CDS_STATS_END(CDS_EVENT_HEAP_GROW);
+
+    return resized;
+}
+
+/**
+ * Restores the heap property over the whole array with Floyd's bottom-up heapify, sifting down
+ * each parent from the last one to the root. This takes O(n) comparisons instead of O(n log n).
+ */
+static void _heapify(Heap *heap) {
+
+    long i;
+    for (i = PARENT(heap->size - 1); i >= 0L; i--) {
+        _downheap(heap, i);
+    }
+}
+
+Status heap_fromArray(Heap **heap, void **items, long n, int (*comparator)(void *, void *)) {
+
+    Heap *temp;
+
+    // Creates the heap with room for every item up front
+    Status status = heap_new(&temp, n, comparator);
+    if (status != OK) {
+        return status;
+    }
+
+    // Copies the items over as they are, then heapifies them in place
+    if (n > 0L) {
+        memcpy(temp->data, items, n * sizeof(void *));
+        temp->size = n;
+        _heapify(temp);
+    }
+    *heap = temp;
+
+    return OK;
+}
+
+Status heap_insertAll(Heap *heap, void **items, long n) {
+
+    long i, depth = 0L, total = heap->size + n;
+
+    if (n <= 0L) {
+        return OK;
+    }
+
+    // Grows the capacity once to fit the whole batch
+    if (_ensure_capacity(heap, n) == FALSE) {
+        return ALLOC_FAILURE;
+    }
+    memcpy(&(heap->data[heap->size]), items, n * sizeof(void *));
+    if (heap->ids != NULL) {
+        for (i = heap->size; i < total; i++) {
+            heap->ids[i] = -1L;
+        }
+    }
+
+    // Sifts each item up (O(n log size)), unless rebuilding the heap (O(size + n)) is cheaper
+    for (i = total; i > 1L; i /= 2L) {
+        depth++;
+    }
+    if (n * depth > 2L * total) {
+        heap->size = total;
+        _heapify(heap);
+    } else {
+        for (i = 0L; i < n; i++) {
+            heap->size++;
+            _upheap(heap, heap->size - 1);
         }
     }
+    heap->modCount++;
 
+    return OK;
+}
+
+void heap_setGrowthFactor(Heap *heap, float growthFactor) {
+    heap->growthFactor = ( 0.0f < growthFactor ) && ( growthFactor <= 1.0f ) ?
+                         growthFactor : DEFAULT_GROWTH_FACTOR;
+}
+
+/**
+ * Adds the item to the heap, the body of heap_insert().
+ */
+static Status _insert(Heap *heap, void *item) {
+
+    // Checks the capacity, extend if needed
+    if (heap->size == heap->capacity && _ensure_capacity(heap, 1L) == FALSE) {
+        return ALLOC_FAILURE;
+    }
+
+    if (heap->ids != NULL) {
+        heap->ids[heap->size] = -1L;
+    }
     heap->data[heap->size++] = item;
     // Upheap to update the heap
-    _upheap(heap);
+    _upheap(heap, heap->size - 1);
+    heap->modCount++;
 
     return OK;
 }
 
+Status heap_insert(Heap *heap, void *item) {
+
+    CDS_STATS_BEGIN();
+    Status status = _insert(heap, item);
+    CDS_STATS_END(CDS_PROBE_HEAP_INSERT);
+
+    return status;
+}
+
 Status heap_peek(Heap *heap, void **min) {
 
     // Checks if the heap is empty
@@ -188,7 +411,51 @@ Status heap_peek(Heap *heap, void **min) {
     return OK;
 }
 
-Status heap_poll(Heap *heap, void **min) {
+/**
+ * Moves the element at the index `index` up or down the heap, whichever restores the heap
+ * property. Needs to be done after the element at `index` was replaced.
+ */
+static void _sift(Heap *heap, long index) {
+
+    if (HAS_PARENT(index) == TRUE && CMP(PARENT(index), index) > 0) {
+        _upheap(heap, index);
+    } else {
+        _downheap(heap, index);
+    }
+}
+
+/**
+ * Removes the element at the index `index` from the heap, freeing its handle (if any), by moving
+ * the last element into its place.
+ */
+static void _remove_at(Heap *heap, long index) {
+
+    long last = heap->size - 1;
+
+    // Returns the handle to the free list
+    if (heap->ids != NULL && heap->ids[index] >= 0L) {
+        heap->slots[heap->ids[index]] = heap->freeSlot;
+        heap->freeSlot = heap->ids[index];
+    }
+
+    // Fills the hole with the last element, then moves that element into place
+    heap->data[index] = heap->data[last];
+    heap->data[last] = NULL;
+    heap->size--;
+    if (index < heap->size) {
+        if (heap->ids != NULL) {
+            heap->ids[index] = heap->ids[last];
+            _track(heap, index);
+        }
+        _sift(heap, index);
+    }
+    heap->modCount++;
+}
+
+/**
+ * Removes the heap's least item, the body of heap_poll().
+ */
+static Status _poll(Heap *heap, void **min) {
 
     // Checks if the heap is empty
     if (IS_EMPTY(heap) == TRUE) {
@@ -197,10 +464,110 @@ Status heap_poll(Heap *heap, void **min) {
 
     // Retrieves the min item, saves into pointer
     *min = heap->data[0];
-    heap->data[0] = heap->data[heap->size - 1];
-    heap->data[--heap->size] = NULL;
-    // Downheap to update the heap
-    _downheap(heap);
+    _remove_at(heap, 0L);
+
+    return OK;
+}
+
+Status heap_poll(Heap *heap, void **min) {
+
+    CDS_STATS_BEGIN();
+    Status status = _poll(heap, min);
+    CDS_STATS_END(CDS_PROBE_HEAP_POLL);
+
+    return status;
+}
+
+Status heap_insertHandle(Heap *heap, void *item, HeapHandle *handle) {
+
+    long id;
+
+    // Creates the handle index on first use, marking every element already present as unhandled
+    if (heap->ids == NULL) {
+        long *ids = (long *)allocator_reallocArray(heap->allocator, NULL, heap->capacity,
+                                                   sizeof(long));
+        if (ids == NULL) {
+            return ALLOC_FAILURE;
+        }
+        // Slots past the size are set as elements are added
+        for (id = 0L; id < heap->size; id++) {
+            ids[id] = -1L;
+        }
+        heap->ids = ids;
+    }
+
+    // Reserves a handle, reusing a freed one if possible
+    if (heap->freeSlot < 0L && heap->slotCount == heap->slotCapacity) {
+        long newCapacity = ( heap->slotCapacity == 0L ) ? DEFAULT_CAPACITY : heap->slotCapacity * 2;
+        long *slots = (long *)allocator_reallocArray(heap->allocator, heap->slots, newCapacity,
+                                                     sizeof(long));
+        if (slots == NULL) {
+            return ALLOC_FAILURE;
+        }
+        heap->slots = slots;
+        heap->slotCapacity = newCapacity;
+    }
+    if (heap->size == heap->capacity && _ensure_capacity(heap, 1L) == FALSE) {
+        return ALLOC_FAILURE;
+    }
+    if (heap->freeSlot >= 0L) {
+        id = heap->freeSlot;
+        heap->freeSlot = heap->slots[id];
+    } else {
+        id = heap->slotCount++;
+    }
+
+    // Inserts the item the same as heap_insert(), tracking its position under the handle
+    heap->data[heap->size] = item;
+    heap->ids[heap->size] = id;
+    heap->slots[id] = heap->size;
+    heap->size++;
+    _upheap(heap, heap->size - 1);
+    heap->modCount++;
+    *handle = id;
+
+    return OK;
+}
+
+/**
+ * Returns the position of the element with the handle `handle`, or -1 if the handle is not live.
+ */
+static long _find_handle(Heap *heap, HeapHandle handle) {
+
+    if (heap->ids == NULL || handle < 0L || handle >= heap->slotCount) {
+        return -1L;
+    }
+    long index = heap->slots[handle];
+    if (index < 0L || index >= heap->size || heap->ids[index] != handle) {
+        return -1L;
+    }
+
+    return index;
+}
+
+Status heap_update(Heap *heap, HeapHandle handle, void *item) {
+
+    // Finds the element, replaces it, and moves it to where its new priority belongs
+    long index = _find_handle(heap, handle);
+    if (index < 0L) {
+        return NOT_FOUND;
+    }
+    heap->data[index] = item;
+    _sift(heap, index);
+    heap->modCount++;
+
+    return OK;
+}
+
+Status heap_removeHandle(Heap *heap, HeapHandle handle, void **item) {
+
+    // Finds the element, then removes it from wherever it sits in the heap
+    long index = _find_handle(heap, handle);
+    if (index < 0L) {
+        return NOT_FOUND;
+    }
+    *item = heap->data[index];
+    _remove_at(heap, index);
 
     return OK;
 }
@@ -217,12 +584,37 @@ static void _clear_heap(Heap *heap, void (*destructor)(void *)) {
             (*destructor)(heap->data[i]);
         }
         heap->data[i] = NULL;
+        if (heap->ids != NULL) {
+            heap->ids[i] = -1L;
+        }
     }
+
+    // Every handle is released at once
+    heap->slotCount = 0L;
+    heap->freeSlot = -1L;
 }
 
 void heap_clear(Heap *heap, void (*destructor)(void *)) {
     _clear_heap(heap, destructor);
     heap->size = 0;
+    heap->modCount++;
+}
+
+Status heap_merge(Heap *dst, Heap *src) {
+
+    // Merging a heap into itself has nothing to move
+    if (dst == src || IS_EMPTY(src) == TRUE) {
+        return OK;
+    }
+
+    Status status = heap_insertAll(dst, src->data, src->size);
+    if (status == OK) {
+        _clear_heap(src, NULL);
+        src->size = 0L;
+        src->modCount++;
+    }
+
+    return status;
 }
 
 long heap_size(Heap *heap) {
@@ -312,8 +704,63 @@ Status heap_iterator(Heap *heap, Iterator **iter) {
     return OK;
 }
 
+void heap_cursor(Heap *heap, Cursor *cursor) {
+    cursor->adt = heap;
+    cursor->node = NULL;
+    cursor->index = 0L;
+    cursor->remaining = heap->size;
+    cursor->modCount = heap->modCount;
+}
+
+Status heap_cursorNext(Cursor *cursor, void **next) {
+
+    Heap *heap = (Heap *)cursor->adt;
+
+    // Fails fast if the heap was modified since creating the cursor
+    if (heap->modCount != cursor->modCount) {
+        return CONCURRENT_MODIFICATION;
+    }
+    // Checks if every element was visited
+    if (cursor->remaining == 0L) {
+        return ITER_END;
+    }
+
+    // Fetches the item, advances to the next index
+    *next = heap->data[cursor->index];
+    cursor->index = cursor->index + 1L;
+    cursor->remaining--;
+
+    return OK;
+}
+
+Boolean heap_forEach(Heap *heap, Boolean (*action)(void *, void *), void *context) {
+
+    long i;
+
+    for (i = 0L; i < heap->size; i++) {
+        if ((*action)(heap->data[i], context) == FALSE) {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+long heap_memoryUsage(Heap *heap) {
+
+    long bytes = (long)( sizeof(Heap) + ( ( heap->capacity + SLACK ) * sizeof(void *) ) );
+
+    if (heap->ids != NULL) {
+        bytes += heap->capacity * (long)sizeof(long);
+    }
+
+    return bytes + ( heap->slotCapacity * (long)sizeof(long) );
+}
+
 void heap_destroy(Heap *heap, void (*destructor)(void *)) {
     _clear_heap(heap, destructor);
-    free(heap->data);
-    free(heap);
+    allocator_free(heap->allocator, heap->block);
+    allocator_free(heap->allocator, heap->ids);
+    allocator_free(heap->allocator, heap->slots);
+    allocator_free(heap->allocator, heap);
 }
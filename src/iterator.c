@@ -25,51 +25,315 @@
 #include <stdlib.h>
 #include "iterator.h"
 
+/**
+ * The kinds of iterators, a snapshot over an array or one of the lazy iterators.
+ */
+typedef enum {
+    SNAPSHOT,           // Iterates over the array `items`
+    CURSOR,             // Walks a structure with `cursor`
+    FILTER,             // Skips the elements of `source` rejected by `predicate`
+    MAP,                // Transforms the elements of `source` with `mapper`
+    LIMIT,              // Takes up to `len` elements of `source`
+    CONCAT              // Takes the elements of `source`, then of `second`
+} Kind;
+
 /**
  * The struct for the Iterator ADT .
  */
 struct iterator {
     void **items;       // The collection of elements to iterate
-    long next;          // Index to next element in iteration
-    long len;           // The total number of elements */
+    long next;          // Index to next element in iteration (elements taken, for a limit)
+    long len;           // Index past the last element to iterate (the maximum, for a limit)
+    long *refs;         // Number of iterators sharing `items` once split, NULL if never split
+    Kind kind;          // The kind of iterator
+    Iterator *source;   // The iterator being adapted, NULL if not an adaptor
+    Iterator *second;   // The iterator concatenated after `source`, NULL if not a concatenation
+    Boolean (*predicate)(void *, void *);       // Function keeping elements, for a filter
+    void *(*mapper)(void *, void *);            // Function transforming elements, for a map
+    void *context;                              // The context to invoke the function with
+    Status (*cursorNext)(Cursor *, void **);    // Function advancing `cursor`
+    Cursor cursor;      // The cursor walking a structure
+    Boolean fetched;    // TRUE if the next element was fetched ahead by iterator_hasNext()
+    Status ahead;       // The status of the element fetched ahead
+    void *item;         // The element fetched ahead
 };
 
+/**
+ * Allocates an iterator of the kind `kind`, with no elements, source or functions; returns the
+ * new instance, or NULL if failed (allocation error).
+ */
+static Iterator *_alloc(Kind kind) {
+
+    Iterator *temp = (Iterator *)malloc(sizeof(Iterator));
+    if (temp == NULL) {
+        return NULL;
+    }
+
+    temp->items = NULL;
+    temp->next = 0L;
+    temp->len = 0L;
+    temp->refs = NULL;
+    temp->kind = kind;
+    temp->source = NULL;
+    temp->second = NULL;
+    temp->predicate = NULL;
+    temp->mapper = NULL;
+    temp->context = NULL;
+    temp->cursorNext = NULL;
+    temp->fetched = FALSE;
+    temp->ahead = ITER_END;
+    temp->item = NULL;
+
+    return temp;
+}
+
 Status iterator_new(Iterator **iter, void **items, long len) {
 
     // Allocate memory for the struct, check for malloc() errors
-    Iterator *temp = (Iterator *)malloc(sizeof(Iterator));
+    Iterator *temp = _alloc(SNAPSHOT);
     if (temp == NULL) {
         return ALLOC_FAILURE;
     }
 
     // Initialize the rest of iterator members
     temp->items = items;
-    temp->next = 0L;
     temp->len = len;
     *iter = temp;
 
     return OK;
 }
 
+Status iterator_fromCursor(Iterator **iter, Cursor *cursor,
+                           Status (*cursorNext)(Cursor *, void **)) {
+
+    Iterator *temp = _alloc(CURSOR);
+    if (temp == NULL) {
+        return ALLOC_FAILURE;
+    }
+
+    temp->cursor = *cursor;
+    temp->cursorNext = cursorNext;
+    *iter = temp;
+
+    return OK;
+}
+
+Status iterator_filter(Iterator **iter, Iterator *source, Boolean (*predicate)(void *, void *),
+                       void *context) {
+
+    Iterator *temp = _alloc(FILTER);
+    if (temp == NULL) {
+        return ALLOC_FAILURE;
+    }
+
+    temp->source = source;
+    temp->predicate = predicate;
+    temp->context = context;
+    *iter = temp;
+
+    return OK;
+}
+
+Status iterator_map(Iterator **iter, Iterator *source, void *(*mapper)(void *, void *),
+                    void *context) {
+
+    Iterator *temp = _alloc(MAP);
+    if (temp == NULL) {
+        return ALLOC_FAILURE;
+    }
+
+    temp->source = source;
+    temp->mapper = mapper;
+    temp->context = context;
+    *iter = temp;
+
+    return OK;
+}
+
+Status iterator_limit(Iterator **iter, Iterator *source, long max) {
+
+    if (max < 0L) {
+        return INVALID_INDEX;
+    }
+    Iterator *temp = _alloc(LIMIT);
+    if (temp == NULL) {
+        return ALLOC_FAILURE;
+    }
+
+    temp->source = source;
+    temp->len = max;
+    *iter = temp;
+
+    return OK;
+}
+
+Status iterator_concat(Iterator **iter, Iterator *first, Iterator *second) {
+
+    Iterator *temp = _alloc(CONCAT);
+    if (temp == NULL) {
+        return ALLOC_FAILURE;
+    }
+
+    temp->source = first;
+    temp->second = second;
+    *iter = temp;
+
+    return OK;
+}
+
+/**
+ * Fetches the next element of the iterator `iter` from its array or its sources, into `*next`.
+ */
+static Status _fetch(Iterator *iter, void **next) {
+
+    Status status;
+    void *item;
+
+    switch (iter->kind) {
+    case CURSOR:
+        return (*iter->cursorNext)(&(iter->cursor), next);
+    case FILTER:
+        // Skips over the elements rejected by the predicate
+        while ((status = iterator_next(iter->source, &item)) == OK) {
+            if ((*iter->predicate)(item, iter->context) == TRUE) {
+                *next = item;
+                break;
+            }
+        }
+        return status;
+    case MAP:
+        if ((status = iterator_next(iter->source, &item)) == OK) {
+            *next = (*iter->mapper)(item, iter->context);
+        }
+        return status;
+    case LIMIT:
+        // Never fetches past the limit from the source
+        if (iter->next == iter->len) {
+            return ITER_END;
+        }
+        if ((status = iterator_next(iter->source, next)) == OK) {
+            iter->next++;
+        }
+        return status;
+    case CONCAT:
+        status = iterator_next(iter->source, next);
+        return ( status == ITER_END ) ? iterator_next(iter->second, next) : status;
+    default:
+        // Return status is the current iteration has already ended
+        if (iter->next == iter->len) {
+            return ITER_END;
+        }
+        // Advances to next item in iteration
+        *next = iter->items[iter->next++];
+        return OK;
+    }
+}
+
 Boolean iterator_hasNext(Iterator *iter) {
 
-    return ( iter->next < iter->len ) ? TRUE : FALSE;
+    if (iter->kind == SNAPSHOT) {
+        return ( iter->next < iter->len ) ? TRUE : FALSE;
+    }
+
+    // A lazy iterator only knows once it has fetched the next element
+    if (iter->fetched == FALSE) {
+        iter->ahead = _fetch(iter, &(iter->item));
+        iter->fetched = TRUE;
+    }
+    return ( iter->ahead == OK ) ? TRUE : FALSE;
 }
 
 Status iterator_next(Iterator *iter, void **next) {
 
-    // Return status is the current iteration has already ended
-    if (iter->next == iter->len) {
+    // Hands out the element fetched ahead, if any
+    if (iter->fetched == TRUE) {
+        iter->fetched = FALSE;
+        if (iter->ahead == OK) {
+            *next = iter->item;
+        }
+        return iter->ahead;
+    }
+
+    return _fetch(iter, next);
+}
+
+long iterator_remaining(Iterator *iter) {
+
+    long first, second, ahead = ( iter->fetched == TRUE && iter->ahead == OK ) ? 1L : 0L;
+
+    switch (iter->kind) {
+    case CURSOR:
+        return iter->cursor.remaining + ahead;
+    case FILTER:
+    case MAP:
+        return iterator_remaining(iter->source) + ahead;
+    case LIMIT:
+        first = iterator_remaining(iter->source);
+        second = iter->len - iter->next;
+        return ( ( first < second ) ? first : second ) + ahead;
+    case CONCAT:
+        first = iterator_remaining(iter->source);
+        second = iterator_remaining(iter->second);
+        return first + second + ahead;
+    default:
+        return iter->len - iter->next;
+    }
+}
+
+Status iterator_trySplit(Iterator *iter, Iterator **prefix) {
+
+    long mid = iter->next + ( iter->len - iter->next ) / 2L;
+
+    // Checks if there are enough elements left to split, lazy iterators are never split
+    if (iter->kind != SNAPSHOT || mid == iter->next) {
         return ITER_END;
     }
-    // Advances to next item in iteration
-    *next = iter->items[iter->next++];
+
+    // The first split starts counting the iterators sharing the items
+    Iterator *temp = _alloc(SNAPSHOT);
+    if (temp == NULL) {
+        return ALLOC_FAILURE;
+    }
+    if (iter->refs == NULL) {
+        if ((iter->refs = (long *)malloc(sizeof(long))) == NULL) {
+            free(temp);
+            return ALLOC_FAILURE;
+        }
+        *(iter->refs) = 1L;
+    }
+    __atomic_add_fetch(iter->refs, 1L, __ATOMIC_RELAXED);
+
+    // Hands the first half over to the new iterator, keeps the second
+    temp->items = iter->items;
+    temp->next = iter->next;
+    temp->len = mid;
+    temp->refs = iter->refs;
+    iter->next = mid;
+    *prefix = temp;
 
     return OK;
 }
 
 void iterator_destroy(Iterator *iter) {
 
-    free(iter->items);
+    // An adaptor destroys the iterators it wraps
+    if (iter->kind != SNAPSHOT) {
+        if (iter->source != NULL) {
+            iterator_destroy(iter->source);
+        }
+        if (iter->second != NULL) {
+            iterator_destroy(iter->second);
+        }
+        free(iter);
+        return;
+    }
+
+    // The items are freed along with the last of the iterators sharing them
+    if (iter->refs == NULL) {
+        free(iter->items);
+    } else if (__atomic_sub_fetch(iter->refs, 1L, __ATOMIC_ACQ_REL) == 0L) {
+        free(iter->items);
+        free(iter->refs);
+    }
     free(iter);
 }
@@ -0,0 +1,211 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2020 Cole Vikupitz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include "lf_queue.h"
+#include "hazard.h"
+
+// The size of a cache line, the head and the tail are kept on lines of their own
+#define CACHE_LINE 64
+#define ALIGNED __attribute__((aligned(CACHE_LINE)))
+
+/**
+ * A node of the queue.
+ */
+typedef struct lf_node {
+    void *item;                 // The node's item, unused by the dummy node
+    struct lf_node *next;       // The node behind it, NULL at the back of the queue
+} LfNode;
+
+/**
+ * Struct for the lock-free queue ADT. The head always points to a dummy node, whose successor
+ * holds the first element; the tail points to the last node or, briefly, the one before it.
+ */
+struct lf_queue {
+    ALIGNED LfNode *head;       // The dummy node in front of the first element
+    ALIGNED LfNode *tail;       // The last node, or lagging one behind it
+    ALIGNED char end;           // Pads the struct so no other allocation shares the last line
+};
+
+Status lf_queue_new(LockFreeQueue **queue) {
+
+    LockFreeQueue *temp;
+    LfNode *dummy;
+
+    if (posix_memalign((void **)&temp, CACHE_LINE, sizeof(LockFreeQueue)) != 0) {
+        return ALLOC_FAILURE;
+    }
+    dummy = (LfNode *)malloc(sizeof(LfNode));
+    if (dummy == NULL) {
+        free(temp);
+        return ALLOC_FAILURE;
+    }
+
+    dummy->item = NULL;
+    dummy->next = NULL;
+    temp->head = dummy;
+    temp->tail = dummy;
+    *queue = temp;
+
+    return OK;
+}
+
+Status lf_queue_add(LockFreeQueue *queue, void *item) {
+
+    HazardRecord *record = hazard_acquire();
+    LfNode *node, *tail, *next;
+
+    node = (LfNode *)malloc(sizeof(LfNode));
+    if (record == NULL || node == NULL) {
+        free(node);
+        return ALLOC_FAILURE;
+    }
+    node->item = item;
+    node->next = NULL;
+
+    while (TRUE) {
+        tail = (LfNode *)hazard_protect(record, 0, (void **)&(queue->tail));
+        next = __atomic_load_n(&(tail->next), __ATOMIC_ACQUIRE);
+        if (next == NULL) {
+            // Links the node behind the last one, then tries to swing the tail onto it
+            if (__atomic_compare_exchange_n(&(tail->next), &next, node, FALSE,
+                                            __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+                __atomic_compare_exchange_n(&(queue->tail), &tail, node, FALSE,
+                                            __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+                break;
+            }
+        } else {
+            // The tail is lagging behind, helps the other producer finish first
+            __atomic_compare_exchange_n(&(queue->tail), &tail, next, FALSE,
+                                        __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+        }
+    }
+    hazard_clear(record);
+
+    return OK;
+}
+
+/**
+ * Protects the dummy node in hazard slot 0 and the first element's node in slot 1, storing them
+ * into `*head` and `*next`. Returns FALSE if the queue is empty.
+ */
+static Boolean _protect_front(LockFreeQueue *queue, HazardRecord *record,
+                              LfNode **head, LfNode **next) {
+
+    do {
+        *head = (LfNode *)hazard_protect(record, 0, (void **)&(queue->head));
+        *next = __atomic_load_n(&((*head)->next), __ATOMIC_ACQUIRE);
+        hazard_set(record, 1, *next);
+        // The node behind the head is only safe to use while the head has not moved on
+    } while (*head != __atomic_load_n(&(queue->head), __ATOMIC_SEQ_CST));
+
+    return ( *next != NULL ) ? TRUE : FALSE;
+}
+
+Status lf_queue_peek(LockFreeQueue *queue, void **first) {
+
+    HazardRecord *record = hazard_acquire();
+    LfNode *head, *next;
+    Status status = STRUCT_EMPTY;
+
+    if (record == NULL) {
+        return ALLOC_FAILURE;
+    }
+    if (_protect_front(queue, record, &head, &next) == TRUE) {
+        *first = next->item;
+        status = OK;
+    }
+    hazard_clear(record);
+
+    return status;
+}
+
+Status lf_queue_poll(LockFreeQueue *queue, void **first) {
+
+    HazardRecord *record = hazard_acquire();
+    LfNode *head, *tail, *next;
+    void *item;
+
+    if (record == NULL) {
+        return ALLOC_FAILURE;
+    }
+
+    while (TRUE) {
+        if (_protect_front(queue, record, &head, &next) == FALSE) {
+            hazard_clear(record);
+            return STRUCT_EMPTY;
+        }
+        tail = __atomic_load_n(&(queue->tail), __ATOMIC_ACQUIRE);
+        if (head == tail) {
+            // The tail is lagging behind the node being polled, moves it on before the head
+            __atomic_compare_exchange_n(&(queue->tail), &tail, next, FALSE,
+                                        __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+            continue;
+        }
+
+        // The first element's node becomes the new dummy
+        item = next->item;
+        if (__atomic_compare_exchange_n(&(queue->head), &head, next, FALSE,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+            break;
+        }
+    }
+    hazard_clear(record);
+
+    *first = item;
+    hazard_retire(head, free);
+
+    return OK;
+}
+
+Boolean lf_queue_isEmpty(LockFreeQueue *queue) {
+
+    HazardRecord *record = hazard_acquire();
+    LfNode *head, *next;
+    Boolean isEmpty;
+
+    if (record == NULL) {
+        return TRUE;
+    }
+    isEmpty = ( _protect_front(queue, record, &head, &next) == TRUE ) ? FALSE : TRUE;
+    hazard_clear(record);
+
+    return isEmpty;
+}
+
+void lf_queue_destroy(LockFreeQueue *queue, void (*destructor)(void *)) {
+
+    LfNode *node = queue->head->next, *next;
+
+    free(queue->head);
+    while (node != NULL) {
+        next = node->next;
+        if (destructor != NULL) {
+            (*destructor)(node->item);
+        }
+        free(node);
+        node = next;
+    }
+    free(queue);
+}
@@ -0,0 +1,138 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2020 Cole Vikupitz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include "lf_stack.h"
+#include "hazard.h"
+
+// The size of a cache line, the top of the stack is kept on a line of its own
+#define CACHE_LINE 64
+
+/**
+ * A node of the stack.
+ */
+typedef struct lf_node {
+    void *item;                 // The node's item
+    struct lf_node *next;       // The node below it, fixed once the node is pushed
+} LfNode;
+
+/**
+ * Struct for the lock-free stack ADT.
+ */
+struct lf_stack {
+    LfNode *top;                // The top of the stack
+} __attribute__((aligned(CACHE_LINE)));
+
+Status lf_stack_new(LockFreeStack **stack) {
+
+    LockFreeStack *temp;
+
+    if (posix_memalign((void **)&temp, CACHE_LINE, sizeof(LockFreeStack)) != 0) {
+        return ALLOC_FAILURE;
+    }
+    temp->top = NULL;
+    *stack = temp;
+
+    return OK;
+}
+
+Status lf_stack_push(LockFreeStack *stack, void *item) {
+
+    LfNode *node = (LfNode *)malloc(sizeof(LfNode));
+    if (node == NULL) {
+        return ALLOC_FAILURE;
+    }
+
+    // No hazard is needed, the old top is never dereferenced
+    node->item = item;
+    node->next = __atomic_load_n(&(stack->top), __ATOMIC_RELAXED);
+    while (!__atomic_compare_exchange_n(&(stack->top), &(node->next), node, TRUE,
+                                        __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+        ;
+
+    return OK;
+}
+
+Status lf_stack_peek(LockFreeStack *stack, void **top) {
+
+    HazardRecord *record = hazard_acquire();
+    LfNode *node;
+
+    if (record == NULL) {
+        return ALLOC_FAILURE;
+    }
+
+    node = (LfNode *)hazard_protect(record, 0, (void **)&(stack->top));
+    if (node == NULL) {
+        return STRUCT_EMPTY;
+    }
+    *top = node->item;
+    hazard_clear(record);
+
+    return OK;
+}
+
+Status lf_stack_pop(LockFreeStack *stack, void **top) {
+
+    HazardRecord *record = hazard_acquire();
+    LfNode *node;
+
+    if (record == NULL) {
+        return ALLOC_FAILURE;
+    }
+
+    // The hazard keeps the top from being freed and reused (ABA) while its `next` is read
+    do {
+        node = (LfNode *)hazard_protect(record, 0, (void **)&(stack->top));
+        if (node == NULL) {
+            return STRUCT_EMPTY;
+        }
+    } while (!__atomic_compare_exchange_n(&(stack->top), &node, node->next, TRUE,
+                                          __ATOMIC_ACQUIRE, __ATOMIC_RELAXED));
+    hazard_clear(record);
+
+    *top = node->item;
+    hazard_retire(node, free);
+
+    return OK;
+}
+
+Boolean lf_stack_isEmpty(LockFreeStack *stack) {
+    return ( __atomic_load_n(&(stack->top), __ATOMIC_ACQUIRE) == NULL ) ? TRUE : FALSE;
+}
+
+void lf_stack_destroy(LockFreeStack *stack, void (*destructor)(void *)) {
+
+    LfNode *node = stack->top, *next;
+
+    while (node != NULL) {
+        next = node->next;
+        if (destructor != NULL) {
+            (*destructor)(node->item);
+        }
+        free(node);
+        node = next;
+    }
+    free(stack);
+}
@@ -23,16 +23,31 @@
  */
 
 #include <stdlib.h>
+#include <string.h>
 #include "linked_list.h"
 
 /**
- * Struct for a node inside the linked list.
+ * Struct for a node inside the linked list, which is the public ListLink so that nodes can be
+ * handed out as handles.
  */
-typedef struct node {
-    struct node *next;      // Pointer to the next node
-    struct node *prev;      // Pointer to the previous node
-    void *data;             // Pointer to hold the element
-} Node;
+typedef ListLink Node;
+
+// The number of elements each chunk of an unrolled list can hold
+#define CHUNK_LEN 32L
+// Chunks holding fewer elements than this after a removal are merged with their successor
+#define CHUNK_MERGE ( CHUNK_LEN / 4L )
+
+/**
+ * Struct for a chunk of an unrolled linked list, holding up to CHUNK_LEN consecutive elements at
+ * items[start] to items[start + count - 1].
+ */
+typedef struct chunk {
+    struct chunk *next;     // Pointer to the next chunk
+    struct chunk *prev;     // Pointer to the previous chunk
+    long start;             // Index of the chunk's first element inside `items`
+    long count;             // Number of elements in the chunk
+    void *items[CHUNK_LEN]; // The chunk's elements
+} Chunk;
 
 /**
  * Struct for the linked list ADT.
@@ -41,21 +56,52 @@ struct linkedlist {
     Node head;              // Sentinel node for the list's head
     Node tail;              // Sentinel node for the list's tail
     long size;              // The linked list's current size
+    NodePool *pool;         // Allocates the nodes
+    Boolean ownsPool;       // TRUE if `pool` is private to the linked list
+    Boolean intrusive;      // TRUE if the nodes are embedded in the elements, `pool` is NULL
+    const CdsAllocator *allocator;  // Allocates the struct and, if private, the pool
+    long modCount;          // Number of structural modifications made
+    Boolean unrolled;       // TRUE if the elements are stored in chunks rather than nodes
+    Chunk *first;           // The first chunk, in unrolled mode
+    Chunk *last;            // The last chunk, in unrolled mode
 };
 
+// Macro to check if the list `li` stores its elements in chunks
+#define IS_UNROLLED(li)  ( (li)->unrolled )
+
 // Macro that provides the address of the head sentinel node of list `li`
 #define HEADER(li)  (&((li)->head))
 // Macro that provides the address of the tail sentinel node of list `li`
 #define TRAILER(li) (&((li)->tail))
 
-Status linkedlist_new(LinkedList **list) {
+/**
+ * Helper method to create a new linked list whose nodes come from `pool`, or from a private pool
+ * allocated through `allocator` if NULL (the default allocator, if also NULL). Intrusive lists
+ * allocate no nodes, and have no pool at all.
+ */
+static Status _new_list(LinkedList **list, NodePool *pool, const CdsAllocator *allocator,
+                        Boolean intrusive) {
+
+    if (allocator == NULL) {
+        allocator = allocator_default();
+    }
 
     // Allocates the struct, checks for allocation failure
-    LinkedList *temp = (LinkedList *)malloc(sizeof(LinkedList));
+    LinkedList *temp = (LinkedList *)allocator_alloc(allocator, sizeof(LinkedList));
     if (temp == NULL) {
         return ALLOC_FAILURE;
     }
 
+    // Creates a private pool for the nodes unless one was provided
+    temp->ownsPool = ( pool == NULL && intrusive == FALSE ) ? TRUE : FALSE;
+    temp->intrusive = intrusive;
+    if (temp->ownsPool == TRUE && nodepool_newWithAllocator(&pool, 0L, allocator) != OK) {
+        allocator_free(allocator, temp);
+        return ALLOC_FAILURE;
+    }
+    temp->pool = pool;
+    temp->allocator = allocator;
+
     // Initializes the remaining struct members
     HEADER(temp)->data = NULL;
     HEADER(temp)->next = TRAILER(temp);
@@ -64,11 +110,41 @@ Status linkedlist_new(LinkedList **list) {
     TRAILER(temp)->next = NULL;
     TRAILER(temp)->prev = HEADER(temp);
     temp->size = 0L;
+    temp->modCount = 0L;
+    temp->unrolled = FALSE;
+    temp->first = NULL;
+    temp->last = NULL;
     *list = temp;
 
     return OK;
 }
 
+Status linkedlist_newWithPool(LinkedList **list, NodePool *pool) {
+    return _new_list(list, pool, NULL, FALSE);
+}
+
+Status linkedlist_newWithAllocator(LinkedList **list, const CdsAllocator *allocator) {
+    return _new_list(list, NULL, allocator, FALSE);
+}
+
+Status linkedlist_newIntrusive(LinkedList **list) {
+    return _new_list(list, NULL, NULL, TRUE);
+}
+
+Status linkedlist_new(LinkedList **list) {
+    return linkedlist_newWithPool(list, NULL);
+}
+
+Status linkedlist_newUnrolled(LinkedList **list) {
+
+    Status status = linkedlist_newWithPool(list, NULL);
+    if (status == OK) {
+        (*list)->unrolled = TRUE;
+    }
+
+    return status;
+}
+
 // Macro used to validate the given index `i` in a list of length `N`
 #define INDEX_VALID(i, N) ( ( 0L <= (i) && (i) < (N) ) ? TRUE : FALSE )
 // Macro to check if the list `li` is currently empty
@@ -128,10 +204,232 @@ static void _unlink_nodes(Node *node) {
     prev->next = next;
 }
 
+/**
+ * Returns the node `node`, just unlinked, to the list's pool, unless the caller owns it.
+ */
+static void _release_node(LinkedList *list, Node *node) {
+
+    if (list->intrusive == FALSE) {
+        nodepool_free(list->pool, node, sizeof(Node));
+    }
+}
+
+/**
+ * Allocates a new, empty chunk and links it in between `prev` and `next`, either of which may be
+ * NULL at the ends of the list. Its elements will start at `start`.
+ */
+static Chunk *_ul_new_chunk(LinkedList *list, Chunk *prev, Chunk *next, long start) {
+
+    Chunk *chunk = (Chunk *)allocator_alloc(list->allocator, sizeof(Chunk));
+    if (chunk == NULL) {
+        return NULL;
+    }
+
+    chunk->start = start;
+    chunk->count = 0L;
+    chunk->prev = prev;
+    chunk->next = next;
+    if (prev == NULL) {
+        list->first = chunk;
+    } else {
+        prev->next = chunk;
+    }
+    if (next == NULL) {
+        list->last = chunk;
+    } else {
+        next->prev = chunk;
+    }
+
+    return chunk;
+}
+
+/**
+ * Unlinks the chunk `chunk` from the list and frees it.
+ */
+static void _ul_free_chunk(LinkedList *list, Chunk *chunk) {
+
+    if (chunk->prev == NULL) {
+        list->first = chunk->next;
+    } else {
+        chunk->prev->next = chunk->next;
+    }
+    if (chunk->next == NULL) {
+        list->last = chunk->prev;
+    } else {
+        chunk->next->prev = chunk->prev;
+    }
+    allocator_free(list->allocator, chunk);
+}
+
+/**
+ * Fetches the chunk holding the element at index `index`, storing the element's offset inside the
+ * chunk into `*offset`. Walks from whichever end is closer, skipping a whole chunk per step.
+ */
+static Chunk *_ul_fetch_chunk(LinkedList *list, long index, long *offset) {
+
+    Chunk *chunk;
+    long pos;
+
+    if (index <= list->size / 2L) {
+        for (chunk = list->first; index >= chunk->count; chunk = chunk->next) {
+            index -= chunk->count;
+        }
+        *offset = index;
+    } else {
+        pos = list->size;
+        for (chunk = list->last; index < pos - chunk->count; chunk = chunk->prev) {
+            pos -= chunk->count;
+        }
+        *offset = index - (pos - chunk->count);
+    }
+
+    return chunk;
+}
+
+/**
+ * Inserts `item` into the chunk `chunk`, which is not full, at offset `offset`. Shifts whichever
+ * side of the offset has room to move, so at most half a chunk is moved.
+ */
+static void _ul_insert_into(Chunk *chunk, long offset, void *item) {
+
+    void **base = &(chunk->items[chunk->start]);
+    Boolean roomAfter = ( chunk->start + chunk->count < CHUNK_LEN ) ? TRUE : FALSE;
+
+    if (roomAfter == TRUE && (chunk->start == 0L || offset >= chunk->count / 2L)) {
+        memmove(&(base[offset + 1L]), &(base[offset]), (chunk->count - offset) * sizeof(void *));
+    } else {
+        memmove(&(base[-1]), base, offset * sizeof(void *));
+        chunk->start--;
+    }
+    chunk->items[chunk->start + offset] = item;
+    chunk->count++;
+}
+
+/**
+ * Inserts `item` into the unrolled list `list` at index `index`, where 0 <= index <= size.
+ */
+static Status _ul_insert(LinkedList *list, long index, void *item) {
+
+    Chunk *chunk, *split;
+    long offset, half;
+
+    if (list->first == NULL) {
+        // Edge case: the list is empty, starts the first chunk
+        chunk = _ul_new_chunk(list, NULL, NULL, 0L);
+        offset = 0L;
+    } else if (index == list->size) {
+        // Appends to the last chunk, or a new chunk filled from its front
+        chunk = list->last;
+        offset = chunk->count;
+        if (chunk->count == CHUNK_LEN) {
+            chunk = _ul_new_chunk(list, chunk, NULL, 0L);
+            offset = 0L;
+        }
+    } else if (index == 0L) {
+        // Prepends to the first chunk, or a new chunk filled from its back
+        chunk = list->first;
+        offset = 0L;
+        if (chunk->count == CHUNK_LEN) {
+            chunk = _ul_new_chunk(list, NULL, chunk, CHUNK_LEN);
+        }
+    } else {
+        // Splits a full chunk in two, moving its upper half into a new chunk
+        chunk = _ul_fetch_chunk(list, index, &offset);
+        if (chunk->count == CHUNK_LEN) {
+            split = _ul_new_chunk(list, chunk, chunk->next, 0L);
+            if (split == NULL) {
+                return ALLOC_FAILURE;
+            }
+            half = CHUNK_LEN / 2L;
+            memcpy(split->items, &(chunk->items[chunk->start + half]),
+                   (CHUNK_LEN - half) * sizeof(void *));
+            split->count = CHUNK_LEN - half;
+            chunk->count = half;
+            if (offset > half) {
+                chunk = split;
+                offset -= half;
+            }
+        }
+    }
+    if (chunk == NULL) {
+        return ALLOC_FAILURE;
+    }
+
+    _ul_insert_into(chunk, offset, item);
+    list->size++;
+    list->modCount++;
+
+    return OK;
+}
+
+/**
+ * Removes the element at index `index` from the unrolled list `list` into `*item`, releasing its
+ * chunk once emptied, or merging it into its successor once sparse enough.
+ */
+static void _ul_remove(LinkedList *list, long index, void **item) {
+
+    Chunk *chunk, *next;
+    void **base;
+    long offset;
+
+    if (index == 0L) {
+        chunk = list->first;
+        offset = 0L;
+    } else if (index == list->size - 1L) {
+        chunk = list->last;
+        offset = chunk->count - 1L;
+    } else {
+        chunk = _ul_fetch_chunk(list, index, &offset);
+    }
+
+    // Closes the gap from whichever side is shorter
+    base = &(chunk->items[chunk->start]);
+    *item = base[offset];
+    if (offset < chunk->count / 2L) {
+        memmove(&(base[1]), base, offset * sizeof(void *));
+        chunk->start++;
+    } else {
+        memmove(&(base[offset]), &(base[offset + 1L]),
+                (chunk->count - offset - 1L) * sizeof(void *));
+    }
+    chunk->count--;
+    list->size--;
+    list->modCount++;
+
+    if (chunk->count == 0L) {
+        _ul_free_chunk(list, chunk);
+        return;
+    }
+    next = chunk->next;
+    if (chunk->count < CHUNK_MERGE && next != NULL && chunk->count + next->count <= CHUNK_LEN) {
+        memmove(chunk->items, &(chunk->items[chunk->start]), chunk->count * sizeof(void *));
+        memcpy(&(chunk->items[chunk->count]), &(next->items[next->start]),
+               next->count * sizeof(void *));
+        chunk->start = 0L;
+        chunk->count += next->count;
+        _ul_free_chunk(list, next);
+    }
+}
+
+/**
+ * Returns the address of the element at index `index` of the unrolled list `list`.
+ */
+static void **_ul_slot(LinkedList *list, long index) {
+
+    long offset;
+    Chunk *chunk = _ul_fetch_chunk(list, index, &offset);
+
+    return &(chunk->items[chunk->start + offset]);
+}
+
 Status linkedlist_addFirst(LinkedList *list, void *item) {
 
+    if (IS_UNROLLED(list) == TRUE) {
+        return _ul_insert(list, 0L, item);
+    }
+
     // Allocates the node for insertion
-    Node *node = (Node *)malloc(sizeof(Node));
+    Node *node = (Node *)nodepool_alloc(list->pool, sizeof(Node));
     if (node == NULL) {
         return ALLOC_FAILURE;
     }
@@ -140,14 +438,19 @@ Status linkedlist_addFirst(LinkedList *list, void *item) {
     node->data = item;
     _link_nodes(node, HEADER(list), HEADER(list)->next);
     list->size++;
+    list->modCount++;
 
     return OK;
 }
 
 Status linkedlist_addLast(LinkedList *list, void *item) {
 
+    if (IS_UNROLLED(list) == TRUE) {
+        return _ul_insert(list, list->size, item);
+    }
+
     // Allocates the node for insertion
-    Node *node = (Node *)malloc(sizeof(Node));
+    Node *node = (Node *)nodepool_alloc(list->pool, sizeof(Node));
     if (node == NULL) {
         return ALLOC_FAILURE;
     }
@@ -156,6 +459,7 @@ Status linkedlist_addLast(LinkedList *list, void *item) {
     node->data = item;
     _link_nodes(node, TRAILER(list)->prev, TRAILER(list));
     list->size++;
+    list->modCount++;
 
     return OK;
 }
@@ -174,9 +478,12 @@ Status linkedlist_insert(LinkedList *list, long i, void *item) {
         // Same operation as addLast()
         return linkedlist_addLast(list, item);
     }
+    if (IS_UNROLLED(list) == TRUE) {
+        return _ul_insert(list, i, item);
+    }
 
     // Allocates the node for insertion
-    Node *node = (Node *)malloc(sizeof(Node));
+    Node *node = (Node *)nodepool_alloc(list->pool, sizeof(Node));
     if (node == NULL) {
         return ALLOC_FAILURE;
     }
@@ -186,6 +493,7 @@ Status linkedlist_insert(LinkedList *list, long i, void *item) {
     Node *temp = _fetch_node(list, i);
     _link_nodes(node, temp->prev, temp);
     list->size++;
+    list->modCount++;
 
     return OK;
 }
@@ -197,6 +505,10 @@ Status linkedlist_first(LinkedList *list, void **first) {
         return STRUCT_EMPTY;
     }
     // Fetches the first item, stores into pointer
+    if (IS_UNROLLED(list) == TRUE) {
+        *first = list->first->items[list->first->start];
+        return OK;
+    }
     *first = HEADER(list)->next->data;
 
     return OK;
@@ -209,6 +521,10 @@ Status linkedlist_last(LinkedList *list, void **last) {
         return STRUCT_EMPTY;
     }
     // Fetches the last item, stores into pointer
+    if (IS_UNROLLED(list) == TRUE) {
+        *last = list->last->items[list->last->start + list->last->count - 1L];
+        return OK;
+    }
     *last = TRAILER(list)->prev->data;
 
     return OK;
@@ -226,6 +542,10 @@ Status linkedlist_get(LinkedList *list, long i, void **item) {
     }
 
     // Fetches the item at the index, stores into pointer
+    if (IS_UNROLLED(list) == TRUE) {
+        *item = *(_ul_slot(list, i));
+        return OK;
+    }
     Node *temp = _fetch_node(list, i);
     *item = temp->data;
 
@@ -244,6 +564,12 @@ Status linkedlist_set(LinkedList *list, long i, void *item, void **previous) {
     }
 
     // Retrieve the node, swaps with new element
+    if (IS_UNROLLED(list) == TRUE) {
+        void **slot = _ul_slot(list, i);
+        *previous = *slot;
+        *slot = item;
+        return OK;
+    }
     Node *temp = _fetch_node(list, i);
     *previous = temp->data;
     temp->data = item;
@@ -259,11 +585,16 @@ Status linkedlist_removeFirst(LinkedList *list, void **first) {
     }
 
     // Fetches the first node, unlinks from list
+    if (IS_UNROLLED(list) == TRUE) {
+        _ul_remove(list, 0L, first);
+        return OK;
+    }
     Node *temp = HEADER(list)->next;
     *first = temp->data;
     _unlink_nodes(temp);
-    free(temp);
+    _release_node(list, temp);
     list->size--;
+    list->modCount++;
 
     return OK;
 }
@@ -276,11 +607,16 @@ Status linkedlist_removeLast(LinkedList *list, void **last) {
     }
 
     // Fetches the last node, unlinks from list
+    if (IS_UNROLLED(list) == TRUE) {
+        _ul_remove(list, list->size - 1L, last);
+        return OK;
+    }
     Node *temp = TRAILER(list)->prev;
     *last = temp->data;
     _unlink_nodes(temp);
-    free(temp);
+    _release_node(list, temp);
     list->size--;
+    list->modCount++;
 
     return OK;
 }
@@ -306,15 +642,123 @@ Status linkedlist_remove(LinkedList *list, long i, void **item) {
     }
 
     // Fetch the node to be removed, unlink from list
+    if (IS_UNROLLED(list) == TRUE) {
+        _ul_remove(list, i, item);
+        return OK;
+    }
     Node *temp = _fetch_node(list, i);
     *item = temp->data;
     _unlink_nodes(temp);
-    free(temp);
+    _release_node(list, temp);
     list->size--;
+    list->modCount++;
 
     return OK;
 }
 
+/**
+ * Allocates a node holding `item` and links it in between `prev` and `next`, storing the node into
+ * `*handle` if `handle` is not NULL.
+ */
+static Status _add_node(LinkedList *list, Node *prev, Node *next, void *item, ListLink **handle) {
+
+    Node *node = (Node *)nodepool_alloc(list->pool, sizeof(Node));
+    if (node == NULL) {
+        return ALLOC_FAILURE;
+    }
+
+    node->data = item;
+    _link_nodes(node, prev, next);
+    list->size++;
+    list->modCount++;
+    if (handle != NULL) {
+        *handle = node;
+    }
+
+    return OK;
+}
+
+Status linkedlist_addFirstHandle(LinkedList *list, void *item, ListLink **handle) {
+    return _add_node(list, HEADER(list), HEADER(list)->next, item, handle);
+}
+
+Status linkedlist_addLastHandle(LinkedList *list, void *item, ListLink **handle) {
+    return _add_node(list, TRAILER(list)->prev, TRAILER(list), item, handle);
+}
+
+Status linkedlist_insertAfter(LinkedList *list, ListLink *handle, void *item, ListLink **inserted) {
+    return _add_node(list, handle, handle->next, item, inserted);
+}
+
+void *linkedlist_removeHandle(LinkedList *list, ListLink *handle) {
+
+    void *item = handle->data;
+
+    _unlink_nodes(handle);
+    _release_node(list, handle);
+    list->size--;
+    list->modCount++;
+
+    return item;
+}
+
+void linkedlist_moveToFront(LinkedList *list, ListLink *handle) {
+
+    if (HEADER(list)->next != handle) {
+        _unlink_nodes(handle);
+        _link_nodes(handle, HEADER(list), HEADER(list)->next);
+        list->modCount++;
+    }
+}
+
+void linkedlist_moveToBack(LinkedList *list, ListLink *handle) {
+
+    if (TRAILER(list)->prev != handle) {
+        _unlink_nodes(handle);
+        _link_nodes(handle, TRAILER(list)->prev, TRAILER(list));
+        list->modCount++;
+    }
+}
+
+ListLink *linkedlist_firstHandle(LinkedList *list) {
+    return ( IS_EMPTY(list) == FALSE ) ? HEADER(list)->next : NULL;
+}
+
+ListLink *linkedlist_lastHandle(LinkedList *list) {
+    return ( IS_EMPTY(list) == FALSE ) ? TRAILER(list)->prev : NULL;
+}
+
+ListLink *linkedlist_nextHandle(LinkedList *list, ListLink *handle) {
+    return ( handle->next != TRAILER(list) ) ? handle->next : NULL;
+}
+
+ListLink *linkedlist_prevHandle(LinkedList *list, ListLink *handle) {
+    return ( handle->prev != HEADER(list) ) ? handle->prev : NULL;
+}
+
+/**
+ * Links the caller's node `link`, holding `item`, in between `prev` and `next`.
+ */
+static void _link_intrusive(LinkedList *list, Node *prev, Node *next, ListLink *link, void *item) {
+
+    link->data = item;
+    _link_nodes(link, prev, next);
+    list->size++;
+    list->modCount++;
+}
+
+void linkedlist_linkFirst(LinkedList *list, ListLink *link, void *item) {
+    _link_intrusive(list, HEADER(list), HEADER(list)->next, link, item);
+}
+
+void linkedlist_linkLast(LinkedList *list, ListLink *link, void *item) {
+    _link_intrusive(list, TRAILER(list)->prev, TRAILER(list), link, item);
+}
+
+void linkedlist_linkAfter(LinkedList *list, ListLink *position, ListLink *link, void *item) {
+    _link_intrusive(list, position, position->next, link, item);
+}
+
 /**
  * Helper method to clear out the linked list `list` of all its elements, applying the destructor
  * method `destructor` on each element (or if NULL, nothing will be done to the elements).
@@ -322,16 +766,46 @@ Status linkedlist_remove(LinkedList *list, long i, void **item) {
 static void _clear_list(LinkedList *list, void (*destructor)(void *)) {
 
     Node *curr = HEADER(list)->next, *next = NULL;
+    Chunk *chunk, *after;
     long i;
 
+    // Chunks are freed one by one, visiting the elements they hold for the destructor
+    if (IS_UNROLLED(list) == TRUE) {
+        for (chunk = list->first; chunk != NULL; chunk = after) {
+            after = chunk->next;
+            for (i = 0L; destructor != NULL && i < chunk->count; i++) {
+                (*destructor)(chunk->items[chunk->start + i]);
+            }
+            allocator_free(list->allocator, chunk);
+        }
+        list->first = NULL;
+        list->last = NULL;
+        return;
+    }
+
+    // A private pool releases every node at once, so nodes are only visited for the destructor
+    if (list->ownsPool == TRUE && destructor == NULL) {
+        nodepool_reset(list->pool);
+        return;
+    }
+    // The caller owns the nodes of an intrusive list, which are simply dropped
+    if (list->intrusive == TRUE && destructor == NULL) {
+        return;
+    }
+
     for (i = 0L ; i < list->size; i++) {
         next = curr->next;
         if (destructor != NULL) {
             (*destructor)(curr->data);
         }
-        free(curr);
+        if (list->ownsPool == FALSE && list->intrusive == FALSE) {
+            nodepool_free(list->pool, curr, sizeof(Node));
+        }
         curr = next;
     }
+    if (list->ownsPool == TRUE) {
+        nodepool_reset(list->pool);
+    }
 }
 
 void linkedlist_clear(LinkedList *list, void (*destructor)(void *)) {
@@ -340,6 +814,7 @@ void linkedlist_clear(LinkedList *list, void (*destructor)(void *)) {
     HEADER(list)->next = TRAILER(list);
     TRAILER(list)->prev = HEADER(list);
     list->size = 0L;
+    list->modCount++;
 }
 
 long linkedlist_size(LinkedList *list) {
@@ -368,7 +843,15 @@ static void **_generate_list(LinkedList *list) {
         return NULL;
     }
 
-    // Populates the array with linked list items
+    // Populates the array with linked list items, a whole chunk at a time when unrolled
+    if (IS_UNROLLED(list) == TRUE) {
+        Chunk *chunk;
+        for (chunk = list->first; chunk != NULL; chunk = chunk->next) {
+            memcpy(&(items[i]), &(chunk->items[chunk->start]), chunk->count * sizeof(void *));
+            i += chunk->count;
+        }
+        return items;
+    }
     for (temp = HEADER(list)->next; temp != TRAILER(list); temp = temp->next) {
         items[i++] = temp->data;
     }
@@ -430,7 +913,96 @@ Status linkedlist_iterator(LinkedList *list, Iterator **iter) {
     return OK;
 }
 
+void linkedlist_cursor(LinkedList *list, Cursor *cursor) {
+    cursor->adt = list;
+    cursor->node = ( IS_UNROLLED(list) == TRUE ) ? (void *)list->first : (void *)HEADER(list)->next;
+    cursor->index = 0L;
+    cursor->remaining = list->size;
+    cursor->modCount = list->modCount;
+}
+
+Status linkedlist_cursorNext(Cursor *cursor, void **next) {
+
+    LinkedList *list = (LinkedList *)cursor->adt;
+    Node *node = (Node *)cursor->node;
+
+    // Fails fast if the list was modified since creating the cursor
+    if (list->modCount != cursor->modCount) {
+        return CONCURRENT_MODIFICATION;
+    }
+    // Checks if every element was visited
+    if (cursor->remaining == 0L) {
+        return ITER_END;
+    }
+
+    // Fetches the item, advances to the next slot of the chunk or the next node
+    if (IS_UNROLLED(list) == TRUE) {
+        Chunk *chunk = (Chunk *)cursor->node;
+        *next = chunk->items[chunk->start + cursor->index++];
+        if (cursor->index == chunk->count) {
+            cursor->node = chunk->next;
+            cursor->index = 0L;
+        }
+    } else {
+        *next = node->data;
+        cursor->node = node->next;
+    }
+    cursor->remaining--;
+
+    return OK;
+}
+
+Boolean linkedlist_forEach(LinkedList *list, Boolean (*action)(void *, void *), void *context) {
+
+    Chunk *chunk;
+    Node *node;
+    long i;
+
+    // Unrolled lists walk the occupied slots of each chunk in turn
+    if (IS_UNROLLED(list) == TRUE) {
+        for (chunk = list->first; chunk != NULL; chunk = chunk->next) {
+            for (i = 0L; i < chunk->count; i++) {
+                if ((*action)(chunk->items[chunk->start + i], context) == FALSE) {
+                    return FALSE;
+                }
+            }
+        }
+        return TRUE;
+    }
+
+    for (node = HEADER(list)->next, i = 0L; i < list->size; node = node->next, i++) {
+        if ((*action)(node->data, context) == FALSE) {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+long linkedlist_memoryUsage(LinkedList *list) {
+
+    long bytes = (long)sizeof(LinkedList);
+    Chunk *chunk;
+
+    // Unrolled lists are charged for their chunks, the others for their nodes
+    if (IS_UNROLLED(list) == TRUE) {
+        for (chunk = list->first; chunk != NULL; chunk = chunk->next) {
+            bytes += (long)sizeof(Chunk);
+        }
+    } else if (list->ownsPool == FALSE && list->intrusive == FALSE) {
+        bytes += list->size * (long)sizeof(Node);
+    }
+    if (list->ownsPool == TRUE) {
+        bytes += nodepool_memoryUsage(list->pool);
+    }
+
+    return bytes;
+}
+
 void linkedlist_destroy(LinkedList *list, void (*destructor)(void *)) {
     _clear_list(list, destructor);
-    free(list);
+    if (list->ownsPool == TRUE) {
+        nodepool_destroy(list->pool);
+    }
+    allocator_free(list->allocator, list);
 }
@@ -0,0 +1,535 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2020 Cole Vikupitz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+#include "lru_cache.h"
+#include "hashing.h"
+#include "node_pool.h"
+
+/**
+ * Struct for an entry in the LruCache ADT, linked both into a bucket chain and the recency list.
+ */
+typedef struct lru_entry {
+    struct lru_entry *chain;    // Pointer to the next entry in the same bucket
+    struct lru_entry *prev;     // Pointer to the more recently used entry, NULL at the front
+    struct lru_entry *next;     // Pointer to the less recently used entry, NULL at the back
+    uint64_t code;              // The key's full hash code
+    void *key;                  // Points to the entry's key
+    void *value;                // Points to the entry's value
+    long charge;                // The entry's charge towards the charge limit
+} LruEntry;
+
+/**
+ * The struct for the LruCache ADT.
+ */
+struct lru_cache {
+    uint64_t (*hash)(void *, uint64_t);     // Seeded hashing function for the keys
+    uint64_t seed;                  // The seed passed to `hash`, drawn per cache
+    int (*cmp)(void *, void *);     // Comparator function for the keys
+    void (*keyDxn)(void *);         // Destructor function for the keys
+    void (*listener)(void *, void *, void *);   // Invoked on each evicted entry, may be NULL
+    void *context;                  // Argument passed along to `listener`
+    LruEntry **buckets;             // Array of bucket chains, its length a power of 2
+    long nBuckets;                  // Number of buckets in `buckets`
+    LruEntry *front;                // The most recently used entry, NULL if empty
+    LruEntry *back;                 // The least recently used entry, NULL if empty
+    NodePool *pool;                 // Private pool the entries are allocated from
+    long size;                      // Number of entries in the cache
+    long capacity;                  // Largest number of entries, <= 0 if unbounded
+    long charge;                    // Total charge of the entries
+    long chargeLimit;               // Largest total charge, <= 0 if unbounded
+    uint64_t *sketch;               // Words of 16 4-bit frequency counters, NULL if admitting all
+    long sketchMask;                // Number of words in `sketch` less one
+    long additions;                 // Counters incremented since the sketch was last halved
+    long samplePeriod;              // Number of additions the sketch is halved after
+    CacheStats stats;               // Hits, misses, evictions and rejections so far
+};
+
+// Number of buckets a cache without a capacity starts with
+#define DEFAULT_BUCKETS 16L
+// Maximum amount of buckets a cache holds, which must be a power of 2
+#define MAX_BUCKETS 134217728L
+// Number of entries carved out of each slab of the entry pool
+#define ENTRIES_PER_SLAB 1024L
+// Fewest words of counters a frequency sketch holds
+#define MIN_SKETCH_WORDS 64L
+// Number of counters hashed to for each key in the frequency sketch
+#define SKETCH_DEPTH 4
+// Number of additions per counter word after which the sketch is halved
+#define SAMPLE_FACTOR 10L
+
+// Macro to fetch the bucket chain a hash code `c` falls into in the cache `ch`
+#define BUCKET(ch, c)  ( (ch)->buckets[(long)((c) & (uint64_t)((ch)->nBuckets - 1L))] )
+// Macro to check if the cache `ch` holds more entries or charge than its bounds allow
+#define OVER_BOUNDS(ch)  ( (((ch)->capacity > 0L && (ch)->size > (ch)->capacity) || \
+        ((ch)->chargeLimit > 0L && (ch)->charge > (ch)->chargeLimit)) ? TRUE : FALSE )
+
+/**
+ * Returns the smallest power of 2 no less than `n`, and no more than `max`.
+ */
+static long _pow2(long n, long max) {
+
+    long pow2 = 1L;
+
+    while (pow2 < n && pow2 < max) {
+        pow2 *= 2L;
+    }
+    return pow2;
+}
+
+Status lrucache_new(LruCache **cache, uint64_t (*hash)(void *, uint64_t),
+                    int (*keyComparator)(void *, void *), long capacity,
+                    void (*keyDestructor)(void *)) {
+
+    LruCache *temp;
+    long nBuckets;
+
+    // Allocates memory for the cache
+    temp = (LruCache *)malloc(sizeof(LruCache));
+    if (temp == NULL) {
+        return ALLOC_FAILURE;
+    }
+
+    // Sizes the table to hold a full cache without growing, at a load factor of 3/4
+    nBuckets = ( capacity > 0L ) ? _pow2(capacity + capacity / 3L, MAX_BUCKETS) : DEFAULT_BUCKETS;
+    temp->buckets = (LruEntry **)calloc((size_t)nBuckets, sizeof(LruEntry *));
+    if (temp->buckets == NULL) {
+        free(temp);
+        return ALLOC_FAILURE;
+    }
+    if (nodepool_new(&temp->pool, ENTRIES_PER_SLAB) != OK) {
+        free(temp->buckets);
+        free(temp);
+        return ALLOC_FAILURE;
+    }
+
+    // Initializes the remaining struct members
+    temp->hash = hash;
+    temp->seed = hashing_seed();
+    temp->cmp = keyComparator;
+    temp->keyDxn = keyDestructor;
+    temp->listener = NULL;
+    temp->context = NULL;
+    temp->nBuckets = nBuckets;
+    temp->front = NULL;
+    temp->back = NULL;
+    temp->size = 0L;
+    temp->capacity = capacity;
+    temp->charge = 0L;
+    temp->chargeLimit = 0L;
+    temp->sketch = NULL;
+    temp->sketchMask = 0L;
+    temp->additions = 0L;
+    temp->samplePeriod = 0L;
+    memset(&temp->stats, 0, sizeof(CacheStats));
+    *cache = temp;
+
+    return OK;
+}
+
+/**
+ * Unlinks the entry `entry` from the recency list of the cache.
+ */
+static void _unlink(LruCache *cache, LruEntry *entry) {
+
+    if (entry->prev != NULL) {
+        entry->prev->next = entry->next;
+    } else {
+        cache->front = entry->next;
+    }
+    if (entry->next != NULL) {
+        entry->next->prev = entry->prev;
+    } else {
+        cache->back = entry->prev;
+    }
+}
+
+/**
+ * Links the entry `entry` into the front of the recency list of the cache.
+ */
+static void _link_front(LruCache *cache, LruEntry *entry) {
+
+    entry->prev = NULL;
+    entry->next = cache->front;
+    if (cache->front != NULL) {
+        cache->front->prev = entry;
+    } else {
+        cache->back = entry;
+    }
+    cache->front = entry;
+}
+
+/**
+ * Finds the entry mapping the key `key` with the hash code `code`, returns NULL if not found.
+ */
+static LruEntry *_find(LruCache *cache, void *key, uint64_t code) {
+
+    LruEntry *entry;
+
+    for (entry = BUCKET(cache, code); entry != NULL; entry = entry->chain) {
+        if (entry->code == code && (*cache->cmp)(entry->key, key) == 0) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Unlinks the entry `entry` from its bucket chain, then releases it back to the entry pool.
+ */
+static void _release(LruCache *cache, LruEntry *entry) {
+
+    LruEntry **link = &BUCKET(cache, entry->code);
+
+    while (*link != entry) {
+        link = &(*link)->chain;
+    }
+    *link = entry->chain;
+    _unlink(cache, entry);
+    cache->size--;
+    cache->charge -= entry->charge;
+    nodepool_free(cache->pool, entry, sizeof(LruEntry));
+}
+
+/**
+ * Evicts the least recently used entries until the cache is within its bounds, never evicting the
+ * entry `keep`, which may be NULL.
+ */
+static void _evict(LruCache *cache, LruEntry *keep) {
+
+    LruEntry *victim;
+    void *key, *value;
+
+    while (OVER_BOUNDS(cache) == TRUE && cache->back != NULL && cache->back != keep) {
+        victim = cache->back;
+        key = victim->key;
+        value = victim->value;
+        _release(cache, victim);
+        cache->stats.evictions++;
+        if (cache->listener != NULL) {
+            (*cache->listener)(key, value, cache->context);
+        }
+        if (cache->keyDxn != NULL) {
+            (*cache->keyDxn)(key);
+        }
+    }
+}
+
+/**
+ * Doubles the number of buckets of the cache, rehashing every entry by its stored hash code. The
+ * cache keeps working with longer chains if the larger table cannot be allocated.
+ */
+static void _grow(LruCache *cache) {
+
+    long nBuckets = cache->nBuckets * 2L, index;
+    LruEntry **buckets, *entry;
+
+    buckets = (LruEntry **)calloc((size_t)nBuckets, sizeof(LruEntry *));
+    if (buckets == NULL) {
+        return;
+    }
+    for (entry = cache->front; entry != NULL; entry = entry->next) {
+        index = (long)(entry->code & (uint64_t)(nBuckets - 1L));
+        entry->chain = buckets[index];
+        buckets[index] = entry;
+    }
+    free(cache->buckets);
+    cache->buckets = buckets;
+    cache->nBuckets = nBuckets;
+}
+
+/**
+ * Returns the hash code of the key `code` picks its `i`th counter of the frequency sketch with.
+ */
+static uint64_t _sketch_hash(uint64_t code, int i) {
+    return hashing_mix64(code + (uint64_t)(i + 1) * 0x9e3779b97f4a7c15UL);
+}
+
+/**
+ * Returns the estimated number of times the key with the hash code `code` was requested, as the
+ * smallest of its counters in the frequency sketch.
+ */
+static int _sketch_frequency(LruCache *cache, uint64_t code) {
+
+    uint64_t h, word;
+    int i, count, frequency = 15;
+
+    for (i = 0; i < SKETCH_DEPTH; i++) {
+        h = _sketch_hash(code, i);
+        word = cache->sketch[(long)(h & (uint64_t)cache->sketchMask)];
+        count = (int)((word >> (((h >> 32) & 15UL) * 4UL)) & 15UL);
+        if (count < frequency) {
+            frequency = count;
+        }
+    }
+    return frequency;
+}
+
+/**
+ * Counts a request for the key with the hash code `code` in the frequency sketch, incrementing
+ * each of its counters that is not saturated. Once enough counters were incremented, every counter
+ * is halved so that the sketch favours recent popularity.
+ */
+static void _sketch_increment(LruCache *cache, uint64_t code) {
+
+    uint64_t h, shift, *word;
+    Boolean added = FALSE;
+    long j;
+    int i;
+
+    for (i = 0; i < SKETCH_DEPTH; i++) {
+        h = _sketch_hash(code, i);
+        word = &cache->sketch[(long)(h & (uint64_t)cache->sketchMask)];
+        shift = ((h >> 32) & 15UL) * 4UL;
+        if (((*word >> shift) & 15UL) < 15UL) {
+            *word += 1UL << shift;
+            added = TRUE;
+        }
+    }
+    if (added == TRUE && ++cache->additions >= cache->samplePeriod) {
+        for (j = 0L; j <= cache->sketchMask; j++) {
+            cache->sketch[j] = (cache->sketch[j] >> 1) & 0x7777777777777777UL;
+        }
+        cache->additions /= 2L;
+    }
+}
+
+void lrucache_setChargeLimit(LruCache *cache, long limit) {
+
+    cache->chargeLimit = limit;
+    _evict(cache, NULL);
+}
+
+void lrucache_setEvictionListener(LruCache *cache, void (*listener)(void *, void *, void *),
+                                  void *context) {
+
+    cache->listener = listener;
+    cache->context = context;
+}
+
+Status lrucache_setFrequencyAdmission(LruCache *cache, Boolean enabled) {
+
+    uint64_t *sketch;
+    long entries, words;
+
+    if (enabled == FALSE) {
+        free(cache->sketch);
+        cache->sketch = NULL;
+        return OK;
+    }
+    if (cache->sketch != NULL) {
+        return OK;
+    }
+
+    // Allocates one word of 16 counters per entry the cache holds, as in TinyLFU
+    entries = ( cache->capacity > 0L ) ? cache->capacity : cache->size;
+    words = _pow2(( entries > MIN_SKETCH_WORDS ) ? entries : MIN_SKETCH_WORDS, MAX_BUCKETS);
+    sketch = (uint64_t *)calloc((size_t)words, sizeof(uint64_t));
+    if (sketch == NULL) {
+        return ALLOC_FAILURE;
+    }
+    cache->sketch = sketch;
+    cache->sketchMask = words - 1L;
+    cache->additions = 0L;
+    cache->samplePeriod = words * SAMPLE_FACTOR;
+
+    return OK;
+}
+
+Status lrucache_put(LruCache *cache, void *key, void *value, long charge, void **previous) {
+
+    LruEntry *entry;
+    uint64_t code;
+    Boolean full;
+
+    if (cache->chargeLimit > 0L && charge > cache->chargeLimit) {
+        return STRUCT_FULL;
+    }
+    code = (*cache->hash)(key, cache->seed);
+    if (cache->sketch != NULL) {
+        _sketch_increment(cache, code);
+    }
+
+    // Replaces the value of an existing entry, which becomes the most recently used
+    entry = _find(cache, key, code);
+    if (entry != NULL) {
+        *previous = entry->value;
+        entry->value = value;
+        cache->charge += charge - entry->charge;
+        entry->charge = charge;
+        if (entry != cache->front) {
+            _unlink(cache, entry);
+            _link_front(cache, entry);
+        }
+        _evict(cache, entry);
+        return REPLACED;
+    }
+
+    // Only admits a new key over the entry it would evict if it is the more frequently requested
+    if (cache->sketch != NULL && cache->back != NULL) {
+        full = ( (cache->capacity > 0L && cache->size >= cache->capacity) ||
+                 (cache->chargeLimit > 0L && cache->charge + charge > cache->chargeLimit) )
+                 ? TRUE : FALSE;
+        if (full == TRUE &&
+                _sketch_frequency(cache, code) <= _sketch_frequency(cache, cache->back->code)) {
+            cache->stats.rejections++;
+            return STRUCT_FULL;
+        }
+    }
+
+    // Allocates the new entry and links it in as the most recently used
+    entry = (LruEntry *)nodepool_alloc(cache->pool, sizeof(LruEntry));
+    if (entry == NULL) {
+        return ALLOC_FAILURE;
+    }
+    entry->code = code;
+    entry->key = key;
+    entry->value = value;
+    entry->charge = charge;
+    entry->chain = BUCKET(cache, code);
+    BUCKET(cache, code) = entry;
+    _link_front(cache, entry);
+    cache->size++;
+    cache->charge += charge;
+
+    if (cache->size > cache->nBuckets - cache->nBuckets / 4L && cache->nBuckets < MAX_BUCKETS) {
+        _grow(cache);
+    }
+    _evict(cache, entry);
+
+    return INSERTED;
+}
+
+Status lrucache_get(LruCache *cache, void *key, void **value) {
+
+    LruEntry *entry;
+    uint64_t code;
+
+    code = (*cache->hash)(key, cache->seed);
+    if (cache->sketch != NULL) {
+        _sketch_increment(cache, code);
+    }
+    entry = _find(cache, key, code);
+    if (entry == NULL) {
+        cache->stats.misses++;
+        return NOT_FOUND;
+    }
+    cache->stats.hits++;
+    if (entry != cache->front) {
+        _unlink(cache, entry);
+        _link_front(cache, entry);
+    }
+    *value = entry->value;
+
+    return OK;
+}
+
+Status lrucache_peek(LruCache *cache, void *key, void **value) {
+
+    LruEntry *entry = _find(cache, key, (*cache->hash)(key, cache->seed));
+
+    if (entry == NULL) {
+        return NOT_FOUND;
+    }
+    *value = entry->value;
+
+    return OK;
+}
+
+Boolean lrucache_containsKey(LruCache *cache, void *key) {
+    return ( _find(cache, key, (*cache->hash)(key, cache->seed)) != NULL ) ? TRUE : FALSE;
+}
+
+Status lrucache_remove(LruCache *cache, void *key, void **value) {
+
+    LruEntry *entry = _find(cache, key, (*cache->hash)(key, cache->seed));
+    void *temp;
+
+    if (entry == NULL) {
+        return NOT_FOUND;
+    }
+    temp = entry->key;
+    *value = entry->value;
+    _release(cache, entry);
+    if (cache->keyDxn != NULL) {
+        (*cache->keyDxn)(temp);
+    }
+
+    return OK;
+}
+
+long lrucache_size(LruCache *cache) {
+    return cache->size;
+}
+
+long lrucache_charge(LruCache *cache) {
+    return cache->charge;
+}
+
+void lrucache_stats(LruCache *cache, CacheStats *stats) {
+    *stats = cache->stats;
+}
+
+void lrucache_clear(LruCache *cache, void (*valueDestructor)(void *)) {
+
+    LruEntry *entry;
+
+    for (entry = cache->front; entry != NULL; entry = entry->next) {
+        if (cache->keyDxn != NULL) {
+            (*cache->keyDxn)(entry->key);
+        }
+        if (valueDestructor != NULL) {
+            (*valueDestructor)(entry->value);
+        }
+    }
+
+    // Every entry came from the private pool, so they are all released at once
+    nodepool_reset(cache->pool);
+    memset(cache->buckets, 0, (size_t)cache->nBuckets * sizeof(LruEntry *));
+    cache->front = NULL;
+    cache->back = NULL;
+    cache->size = 0L;
+    cache->charge = 0L;
+}
+
+long lrucache_memoryUsage(LruCache *cache) {
+
+    long bytes = (long)sizeof(LruCache) + cache->nBuckets * (long)sizeof(LruEntry *);
+
+    if (cache->sketch != NULL) {
+        bytes += (cache->sketchMask + 1L) * (long)sizeof(uint64_t);
+    }
+    return bytes + nodepool_memoryUsage(cache->pool);
+}
+
+void lrucache_destroy(LruCache *cache, void (*valueDestructor)(void *)) {
+
+    lrucache_clear(cache, valueDestructor);
+    nodepool_destroy(cache->pool);
+    free(cache->sketch);
+    free(cache->buckets);
+    free(cache);
+}
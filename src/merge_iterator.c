@@ -0,0 +1,224 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2020 Cole Vikupitz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <stdlib.h>
+#include "merge_iterator.h"
+
+/**
+ * One of the merge's inputs, and the element it has to offer next.
+ */
+typedef struct source {
+    Iterator *iter;             // The iterator to read from, NULL if reading from `cursor`
+    Cursor cursor;              // The cursor over the array list to read from
+    void *head;                 // The input's next element
+    Boolean live;               // TRUE if `head` holds an element, FALSE once the input is spent
+} Source;
+
+/**
+ * Struct for the merge iterator ADT.
+ */
+struct merge_iterator {
+    int (*cmp)(void *, void *);     // Function for comparing the inputs' elements
+    long k;                         // The number of inputs
+    long *tree;                     // The loser of each match, the overall winner in `tree[0]`
+    Source *sources;                // The inputs, the leaves of the tree
+};
+
+/**
+ * Fetches the next element of the input `s` into its head. Returns OK if the input was advanced or
+ * has ended, or the status of the failing cursor.
+ */
+static Status _pull(Source *s) {
+
+    Status status = ( s->iter != NULL ) ? iterator_next(s->iter, &(s->head)) :
+                                          arraylist_cursorNext(&(s->cursor), &(s->head));
+
+    s->live = ( status == OK ) ? TRUE : FALSE;
+    return ( status == ITER_END ) ? OK : status;
+}
+
+/**
+ * Returns TRUE if the input `a` wins its match against the input `b`, that is, if its head is the
+ * lesser of the two. A spent input loses every match, and ties go to the earlier input.
+ */
+static Boolean _beats(MergeIterator *iter, long a, long b) {
+
+    Source *x = &(iter->sources[a]), *y = &(iter->sources[b]);
+    int cmp;
+
+    if (x->live == FALSE || y->live == FALSE) {
+        return x->live;
+    }
+    cmp = (*iter->cmp)(x->head, y->head);
+    return ( cmp < 0 || ( cmp == 0 && a < b ) ) ? TRUE : FALSE;
+}
+
+/**
+ * Plays out the matches of the subtree rooted at the position `p`, recording the loser of each;
+ * returns the subtree's winner. Positions 1 to k - 1 are the matches, and the position k + i is
+ * the leaf of the input i.
+ */
+static long _play(MergeIterator *iter, long p) {
+
+    if (p >= iter->k) {
+        return p - iter->k;
+    }
+
+    long left = _play(iter, 2L * p), right = _play(iter, 2L * p + 1L);
+    Boolean leftWins = _beats(iter, left, right);
+    iter->tree[p] = ( leftWins == TRUE ) ? right : left;
+    return ( leftWins == TRUE ) ? left : right;
+}
+
+/**
+ * Allocates a merge iterator over `k` inputs, with every input left unset. Returns the new
+ * instance, or NULL if failed (allocation error).
+ */
+static MergeIterator *_alloc(long k, int (*comparator)(void *, void *)) {
+
+    // Allocates the struct, the tree and the inputs together, with at least one slot each
+    long slots = ( k > 0L ) ? k : 1L;
+    MergeIterator *temp = (MergeIterator *)malloc(sizeof(MergeIterator) +
+                                                  slots * ( sizeof(Source) + sizeof(long) ));
+    if (temp == NULL) {
+        return NULL;
+    }
+
+    temp->cmp = comparator;
+    temp->k = k;
+    temp->sources = (Source *)(temp + 1);
+    temp->tree = (long *)(temp->sources + slots);
+    temp->tree[0] = 0L;
+    temp->sources[0].live = FALSE;
+
+    return temp;
+}
+
+/**
+ * Reads the first element of every input of `iter` and plays the initial tournament. Returns OK
+ * if successful, or the status of a failing cursor (the iterator is then freed).
+ */
+static Status _start(MergeIterator *iter) {
+
+    long i;
+    Status status;
+
+    for (i = 0L; i < iter->k; i++) {
+        if ((status = _pull(&(iter->sources[i]))) != OK) {
+            free(iter);
+            return status;
+        }
+    }
+    if (iter->k > 0L) {
+        iter->tree[0] = _play(iter, 1L);
+    }
+
+    return OK;
+}
+
+Status mergeiterator_new(MergeIterator **iter, Iterator **inputs, long k,
+                         int (*comparator)(void *, void *)) {
+
+    long i;
+
+    if (k < 0L) {
+        return INVALID_INDEX;
+    }
+    MergeIterator *temp = _alloc(k, comparator);
+    if (temp == NULL) {
+        return ALLOC_FAILURE;
+    }
+    for (i = 0L; i < k; i++) {
+        temp->sources[i].iter = inputs[i];
+    }
+
+    Status status = _start(temp);
+    if (status == OK) {
+        *iter = temp;
+    }
+
+    return status;
+}
+
+Status mergeiterator_newFromLists(MergeIterator **iter, ArrayList **lists, long k,
+                                  int (*comparator)(void *, void *)) {
+
+    long i;
+
+    if (k < 0L) {
+        return INVALID_INDEX;
+    }
+    MergeIterator *temp = _alloc(k, comparator);
+    if (temp == NULL) {
+        return ALLOC_FAILURE;
+    }
+    for (i = 0L; i < k; i++) {
+        temp->sources[i].iter = NULL;
+        arraylist_cursor(lists[i], &(temp->sources[i].cursor));
+    }
+
+    Status status = _start(temp);
+    if (status == OK) {
+        *iter = temp;
+    }
+
+    return status;
+}
+
+Boolean mergeiterator_hasNext(MergeIterator *iter) {
+    return iter->sources[iter->tree[0]].live;
+}
+
+Status mergeiterator_next(MergeIterator *iter, void **next) {
+
+    long p, loser, winner = iter->tree[0];
+    Source *s = &(iter->sources[winner]);
+
+    // The overall winner is spent only once every input is
+    if (s->live == FALSE) {
+        return ITER_END;
+    }
+    *next = s->head;
+    Status status = _pull(s);
+    if (status != OK) {
+        return status;
+    }
+
+    // Replays the matches on the winner's path to the root, against the losers stored there
+    for (p = ( winner + iter->k ) / 2L; p > 0L; p /= 2L) {
+        loser = iter->tree[p];
+        if (_beats(iter, loser, winner) == TRUE) {
+            iter->tree[p] = winner;
+            winner = loser;
+        }
+    }
+    iter->tree[0] = winner;
+
+    return OK;
+}
+
+void mergeiterator_destroy(MergeIterator *iter) {
+    free(iter);
+}
@@ -0,0 +1,447 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2020 Cole Vikupitz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <stdlib.h>
+#include <pthread.h>
+#include "node_pool.h"
+
+// Nodes are grouped into size classes that are multiples of GRANULE bytes
+#define GRANULE 8
+#define CLASSES 16
+#define LARGEST_NODE ( CLASSES * GRANULE )
+
+// Slabs start small and double in length up to the pool's nodesPerSlab
+#define FIRST_SLAB_LEN 8L
+#define DEFAULT_NODES_PER_SLAB 256L
+
+// Bounds on the number of free nodes a thread caches per size class
+#define CACHE_LIMIT 64L
+#define CACHE_BATCH 32L
+
+/**
+ * A free node, linked into one of the free lists.
+ */
+typedef struct free_node {
+    struct free_node *next;     // The next free node
+} FreeNode;
+
+/**
+ * Header of a slab of nodes; padded so the nodes that follow it stay 16-byte aligned.
+ */
+typedef struct slab {
+    struct slab *next;          // The next slab owned by the pool
+    size_t pad;                 // Unused, keeps the header 16 bytes wide
+} Slab;
+
+/**
+ * The free list and slab state for one size class.
+ */
+typedef struct size_class {
+    FreeNode *free;             // Nodes that were freed and can be reused
+    char *bump;                 // Next never-used node inside the newest slab
+    long left;                  // Number of never-used nodes left inside the newest slab
+    long slabLen;               // Number of nodes to carve out of the next slab
+} SizeClass;
+
+/**
+ * Struct for the node pool ADT.
+ */
+struct node_pool {
+    SizeClass classes[CLASSES]; // The size classes
+    Slab *slabs;                // Every slab allocated by the pool
+    long slabBytes;             // Total size of the slabs, in bytes
+    const CdsAllocator *allocator;  // Allocates the pool, its slabs and its oversized nodes
+    long maxSlabLen;            // The largest number of nodes carved out of a slab
+    Boolean concurrent;         // TRUE if the pool may be used by several threads at once
+    pthread_mutex_t lock;       // Guards the size classes of a concurrent pool
+    unsigned long id;           // Identifies the pool's current generation of nodes to the caches
+    struct node_pool *next;     // The next live concurrent pool in the registry
+};
+
+/**
+ * The free nodes a thread has cached from a concurrent pool.
+ */
+typedef struct thread_cache {
+    unsigned long id;           // The id of the pool the nodes belong to, or 0 if none
+    FreeNode *head[CLASSES];    // The cached nodes per size class
+    long count[CLASSES];        // The number of cached nodes per size class
+} ThreadCache;
+
+// The calling thread's cache of free nodes
+static __thread ThreadCache cache;
+
+// Key used only to flush a thread's cache back to its pool once the thread exits
+static pthread_key_t cacheKey;
+static pthread_once_t cacheKeyOnce = PTHREAD_ONCE_INIT;
+
+// Registry of the live concurrent pools, so that a cache is never flushed into a destroyed pool
+static pthread_mutex_t registryLock = PTHREAD_MUTEX_INITIALIZER;
+static NodePool *registry = NULL;
+static unsigned long lastId = 0UL;
+
+/**
+ * Resets the size classes of `pool` to their empty state.
+ */
+static void _init_classes(NodePool *pool) {
+
+    long i, first = ( pool->maxSlabLen < FIRST_SLAB_LEN ) ? pool->maxSlabLen : FIRST_SLAB_LEN;
+
+    for (i = 0L; i < CLASSES; i++) {
+        pool->classes[i].free = NULL;
+        pool->classes[i].bump = NULL;
+        pool->classes[i].left = 0L;
+        pool->classes[i].slabLen = first;
+    }
+}
+
+/**
+ * Assigns a fresh id to the concurrent pool `pool`. Caller must hold the registry lock.
+ */
+static void _assign_id(NodePool *pool) {
+    pool->id = ++lastId;
+}
+
+/**
+ * Creates a new pool with the specified slab length and allocator (the default one if NULL),
+ * registering it if `concurrent` is TRUE.
+ */
+static Status _new_pool(NodePool **pool, long nodesPerSlab, Boolean concurrent,
+                        const CdsAllocator *allocator) {
+
+    // Allocates the struct, check for allocation failure
+    if (allocator == NULL) {
+        allocator = allocator_default();
+    }
+    NodePool *temp = (NodePool *)allocator_alloc(allocator, sizeof(NodePool));
+    if (temp == NULL) {
+        return ALLOC_FAILURE;
+    }
+
+    // Initializes the remaining struct members
+    temp->slabs = NULL;
+    temp->slabBytes = 0L;
+    temp->allocator = allocator;
+    temp->maxSlabLen = ( nodesPerSlab <= 0L ) ? DEFAULT_NODES_PER_SLAB : nodesPerSlab;
+    temp->concurrent = concurrent;
+    temp->id = 0UL;
+    temp->next = NULL;
+    _init_classes(temp);
+    if (concurrent == TRUE) {
+        pthread_mutex_init(&(temp->lock), NULL);
+        pthread_mutex_lock(&registryLock);
+        _assign_id(temp);
+        temp->next = registry;
+        registry = temp;
+        pthread_mutex_unlock(&registryLock);
+    }
+    *pool = temp;
+
+    return OK;
+}
+
+Status nodepool_new(NodePool **pool, long nodesPerSlab) {
+    return _new_pool(pool, nodesPerSlab, FALSE, NULL);
+}
+
+Status nodepool_newWithAllocator(NodePool **pool, long nodesPerSlab,
+                                 const CdsAllocator *allocator) {
+    return _new_pool(pool, nodesPerSlab, FALSE, allocator);
+}
+
+Status nodepool_newConcurrent(NodePool **pool, long nodesPerSlab) {
+    return _new_pool(pool, nodesPerSlab, TRUE, NULL);
+}
+
+/**
+ * Returns the size class index for nodes of `size` bytes.
+ */
+static long _class_of(size_t size) {
+    return ( size <= GRANULE ) ? 0L : (long)( ( size - 1 ) / GRANULE );
+}
+
+/**
+ * Takes a node out of the size class `index` of `pool`, carving a new slab if needed. Caller must
+ * hold the pool's lock if it is concurrent.
+ */
+static void *_class_alloc(NodePool *pool, long index) {
+
+    SizeClass *sizeClass = &(pool->classes[index]);
+    size_t nodeSize = (size_t)( ( index + 1 ) * GRANULE );
+    FreeNode *node;
+    void *temp;
+
+    // Reuses a freed node if there is one
+    if (sizeClass->free != NULL) {
+        node = sizeClass->free;
+        sizeClass->free = node->next;
+        return node;
+    }
+
+    // Allocates a new slab once the newest one is used up
+    if (sizeClass->left == 0L) {
+        size_t bytes = sizeof(Slab) + ( sizeClass->slabLen * nodeSize );
+        Slab *slab = (Slab *)allocator_alloc(pool->allocator, bytes);
+        if (slab == NULL) {
+            return NULL;
+        }
+        slab->next = pool->slabs;
+        pool->slabs = slab;
+        __atomic_add_fetch(&(pool->slabBytes), (long)bytes, __ATOMIC_RELAXED);
+        sizeClass->bump = (char *)(slab + 1);
+        sizeClass->left = sizeClass->slabLen;
+        sizeClass->slabLen *= 2L;
+        if (sizeClass->slabLen > pool->maxSlabLen) {
+            sizeClass->slabLen = pool->maxSlabLen;
+        }
+    }
+
+    // Carves the next node out of the slab
+    temp = sizeClass->bump;
+    sizeClass->bump += nodeSize;
+    sizeClass->left--;
+
+    return temp;
+}
+
+/**
+ * Pushes `node` onto the size class `index` of `pool`. Caller must hold the pool's lock if it is
+ * concurrent.
+ */
+static void _class_free(NodePool *pool, long index, void *node) {
+
+    FreeNode *temp = (FreeNode *)node;
+
+    temp->next = pool->classes[index].free;
+    pool->classes[index].free = temp;
+}
+
+/**
+ * Returns every node cached by the calling thread to the pool they came from, or drops them if
+ * that pool was destroyed or reset since they were cached.
+ */
+static void _flush_cache(void) {
+
+    NodePool *pool;
+    FreeNode *node;
+    long i;
+
+    if (cache.id == 0UL) {
+        return;
+    }
+
+    // Looks up the pool under the registry lock, so it cannot be destroyed while flushing
+    pthread_mutex_lock(&registryLock);
+    for (pool = registry; pool != NULL && pool->id != cache.id; pool = pool->next)
+        ;
+    if (pool != NULL) {
+        pthread_mutex_lock(&(pool->lock));
+        for (i = 0L; i < CLASSES; i++) {
+            while (cache.head[i] != NULL) {
+                node = cache.head[i];
+                cache.head[i] = node->next;
+                _class_free(pool, i, node);
+            }
+        }
+        pthread_mutex_unlock(&(pool->lock));
+    }
+    pthread_mutex_unlock(&registryLock);
+
+    // Empties the cache
+    for (i = 0L; i < CLASSES; i++) {
+        cache.head[i] = NULL;
+        cache.count[i] = 0L;
+    }
+    cache.id = 0UL;
+}
+
+/**
+ * Flushes the cache of a thread that is exiting.
+ */
+static void _exit_thread(void *arg) {
+    (void)arg;
+    _flush_cache();
+}
+
+/**
+ * Creates the key used to flush a thread's cache on exit.
+ */
+static void _make_key(void) {
+    pthread_key_create(&cacheKey, _exit_thread);
+}
+
+/**
+ * Hands the calling thread's cache over to the concurrent pool `pool`.
+ */
+static void _adopt_cache(NodePool *pool) {
+    _flush_cache();
+    cache.id = pool->id;
+    pthread_once(&cacheKeyOnce, _make_key);
+    pthread_setspecific(cacheKey, &cache);
+}
+
+/**
+ * Allocates a node of the size class `index` from the concurrent pool `pool`, refilling the
+ * calling thread's cache with a batch of nodes when it runs dry.
+ */
+static void *_concurrent_alloc(NodePool *pool, long index) {
+
+    FreeNode *node;
+    void *temp;
+    long i;
+
+    if (cache.id != pool->id) {
+        _adopt_cache(pool);
+    }
+    if (cache.head[index] != NULL) {
+        node = cache.head[index];
+        cache.head[index] = node->next;
+        cache.count[index]--;
+        return node;
+    }
+
+    // Takes one node for the caller, and a batch more for the cache
+    pthread_mutex_lock(&(pool->lock));
+    temp = _class_alloc(pool, index);
+    for (i = 1L; temp != NULL && i < CACHE_BATCH; i++) {
+        node = (FreeNode *)_class_alloc(pool, index);
+        if (node == NULL) {
+            break;
+        }
+        node->next = cache.head[index];
+        cache.head[index] = node;
+        cache.count[index]++;
+    }
+    pthread_mutex_unlock(&(pool->lock));
+
+    return temp;
+}
+
+/**
+ * Frees `node` of the size class `index` into the concurrent pool `pool`, moving a batch of nodes
+ * from the calling thread's cache back to the pool when it is full.
+ */
+static void _concurrent_free(NodePool *pool, long index, void *node) {
+
+    FreeNode *temp;
+    long i;
+
+    if (cache.id != pool->id) {
+        _adopt_cache(pool);
+    }
+    if (cache.count[index] == CACHE_LIMIT) {
+        pthread_mutex_lock(&(pool->lock));
+        for (i = 0L; i < CACHE_BATCH; i++) {
+            temp = cache.head[index];
+            cache.head[index] = temp->next;
+            _class_free(pool, index, temp);
+        }
+        pthread_mutex_unlock(&(pool->lock));
+        cache.count[index] -= CACHE_BATCH;
+    }
+
+    // Caches the node for the thread's next allocation
+    temp = (FreeNode *)node;
+    temp->next = cache.head[index];
+    cache.head[index] = temp;
+    cache.count[index]++;
+}
+
+void *nodepool_alloc(NodePool *pool, size_t size) {
+
+    // Nodes larger than every size class go straight to the heap
+    if (size > LARGEST_NODE) {
+        return allocator_alloc(pool->allocator, size);
+    }
+
+    if (pool->concurrent == TRUE) {
+        return _concurrent_alloc(pool, _class_of(size));
+    }
+    return _class_alloc(pool, _class_of(size));
+}
+
+void nodepool_free(NodePool *pool, void *node, size_t size) {
+
+    // Nodes larger than every size class came straight from the heap
+    if (size > LARGEST_NODE) {
+        allocator_free(pool->allocator, node);
+        return;
+    }
+
+    if (pool->concurrent == TRUE) {
+        _concurrent_free(pool, _class_of(size), node);
+    } else {
+        _class_free(pool, _class_of(size), node);
+    }
+}
+
+/**
+ * Frees every slab allocated by `pool`.
+ */
+static void _free_slabs(NodePool *pool) {
+
+    Slab *curr = pool->slabs, *next = NULL;
+
+    while (curr != NULL) {
+        next = curr->next;
+        allocator_free(pool->allocator, curr);
+        curr = next;
+    }
+    pool->slabs = NULL;
+    __atomic_store_n(&(pool->slabBytes), 0L, __ATOMIC_RELAXED);
+}
+
+long nodepool_memoryUsage(NodePool *pool) {
+    return (long)sizeof(NodePool) + __atomic_load_n(&(pool->slabBytes), __ATOMIC_RELAXED);
+}
+
+void nodepool_reset(NodePool *pool) {
+
+    _free_slabs(pool);
+    _init_classes(pool);
+
+    // A new id makes every thread drop the nodes it cached from the freed slabs
+    if (pool->concurrent == TRUE) {
+        pthread_mutex_lock(&registryLock);
+        _assign_id(pool);
+        pthread_mutex_unlock(&registryLock);
+    }
+}
+
+void nodepool_destroy(NodePool *pool) {
+
+    NodePool **link;
+
+    // Unregisters the pool, so that no thread flushes its cache into it anymore
+    if (pool->concurrent == TRUE) {
+        pthread_mutex_lock(&registryLock);
+        for (link = &registry; *link != pool; link = &((*link)->next))
+            ;
+        *link = pool->next;
+        pthread_mutex_unlock(&registryLock);
+        pthread_mutex_destroy(&(pool->lock));
+    }
+    _free_slabs(pool);
+    allocator_free(pool->allocator, pool);
+}
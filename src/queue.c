@@ -23,6 +23,8 @@
  */
 
 #include <stdlib.h>
+#include <string.h>
+#include "cds_stats.h"
 #include "queue.h"
 
 /**
@@ -33,6 +35,17 @@ typedef struct node {
     void *data;             // Pointer that holds the element
 } Node;
 
+// The number of elements held by each chunk of an unrolled queue
+#define CHUNK_LEN 32
+
+/**
+ * Struct for a chunk of an unrolled queue, holding up to CHUNK_LEN consecutive elements.
+ */
+typedef struct chunk {
+    struct chunk *next;     // Points to the next chunk
+    void *items[CHUNK_LEN]; // The chunk's elements
+} Chunk;
+
 /**
  * The struct for the queue ADT.
  */
@@ -40,32 +53,155 @@ struct queue {
     Node *head;             // Pointer to the queue's head
     Node *tail;             // Pointer to the queue's tail
     long size;              // The queue's current size
+    NodePool *pool;         // Allocates the nodes
+    Boolean ownsPool;       // TRUE if `pool` is private to the queue
+    const CdsAllocator *allocator;  // Allocates the struct and, if private, the pool
+    long modCount;          // Number of structural modifications made
+    Boolean unrolled;       // TRUE if the elements are stored in chunks rather than nodes
+    Chunk *first;           // The chunk holding the head, in unrolled mode
+    Chunk *last;            // The chunk holding the tail, in unrolled mode
+    long headIndex;         // Index of the head inside `first`
+    long tailIndex;         // Index past the tail inside `last`
+    Chunk *spare;           // An emptied chunk kept for reuse, so a steady FIFO never allocates
 };
 
-Status queue_new(Queue **queue) {
+// Macro to check if the queue `q` stores its elements in chunks
+#define IS_UNROLLED(q)  ( (q)->unrolled )
+
+/**
+ * Helper method to create a new queue whose nodes come from `pool`, or from a private pool
+ * allocated through `allocator` if NULL (the default allocator, if also NULL).
+ */
+static Status _new_queue(Queue **queue, NodePool *pool, const CdsAllocator *allocator) {
+
+    if (allocator == NULL) {
+        allocator = allocator_default();
+    }
 
     // Allocate the struct, check for allocation failures
-    Queue *temp = (Queue *)malloc(sizeof(Queue));
+    Queue *temp = (Queue *)allocator_alloc(allocator, sizeof(Queue));
     if (temp == NULL) {
         return ALLOC_FAILURE;
     }
 
+    // Creates a private pool for the nodes unless one was provided
+    temp->ownsPool = ( pool == NULL ) ? TRUE : FALSE;
+    if (pool == NULL && nodepool_newWithAllocator(&pool, 0L, allocator) != OK) {
+        allocator_free(allocator, temp);
+        return ALLOC_FAILURE;
+    }
+    temp->pool = pool;
+    temp->allocator = allocator;
+
     // Initializes the remaining struct members
     temp->head = NULL;
     temp->tail = NULL;
     temp->size = 0L;
+    temp->modCount = 0L;
+    temp->unrolled = FALSE;
+    temp->first = NULL;
+    temp->last = NULL;
+    temp->headIndex = 0L;
+    temp->tailIndex = 0L;
+    temp->spare = NULL;
     *queue = temp;
 
     return OK;
 }
 
+Status queue_newWithPool(Queue **queue, NodePool *pool) {
+    return _new_queue(queue, pool, NULL);
+}
+
+Status queue_newWithAllocator(Queue **queue, const CdsAllocator *allocator) {
+    return _new_queue(queue, NULL, allocator);
+}
+
+Status queue_new(Queue **queue) {
+    return queue_newWithPool(queue, NULL);
+}
+
+Status queue_newUnrolled(Queue **queue) {
+
+    Status status = queue_newWithPool(queue, NULL);
+    if (status == OK) {
+        (*queue)->unrolled = TRUE;
+    }
+
+    return status;
+}
+
 // Macro to check if the queue `q` is currently empty
 #define IS_EMPTY(q)  ( ((q)->size == 0L) ? TRUE : FALSE )
 
+/**
+ * Adds `item` to the tail of the unrolled queue `queue`, starting a new chunk if the last is full.
+ */
+static Status _ul_add(Queue *queue, void *item) {
+
+    Chunk *chunk;
+
+    if (queue->last == NULL || queue->tailIndex == CHUNK_LEN) {
+        // Takes the spare chunk if there is one, otherwise allocates a new one
+        chunk = queue->spare;
+        if (chunk != NULL) {
+            queue->spare = NULL;
+        } else if ((chunk = (Chunk *)allocator_alloc(queue->allocator, sizeof(Chunk))) == NULL) {
+            return ALLOC_FAILURE;
+        }
+        chunk->next = NULL;
+
+        if (queue->last == NULL) {
+            queue->first = chunk;
+            queue->headIndex = 0L;
+        } else {
+            queue->last->next = chunk;
+        }
+        queue->last = chunk;
+        queue->tailIndex = 0L;
+    }
+
+    queue->last->items[queue->tailIndex++] = item;
+    queue->size++;
+    queue->modCount++;
+
+    return OK;
+}
+
+/**
+ * Removes the head of the unrolled queue `queue` into `*first`, releasing its chunk once emptied.
+ */
+static void _ul_poll(Queue *queue, void **first) {
+
+    Chunk *chunk = queue->first;
+
+    *first = chunk->items[queue->headIndex++];
+    queue->size--;
+    queue->modCount++;
+
+    if (queue->headIndex == CHUNK_LEN || IS_EMPTY(queue) == TRUE) {
+        queue->first = chunk->next;
+        queue->headIndex = 0L;
+        if (queue->first == NULL) {
+            queue->last = NULL;
+        }
+        // Keeps one emptied chunk around for the next one the tail will need
+        if (queue->spare == NULL) {
+            queue->spare = chunk;
+        } else {
+            allocator_free(queue->allocator, chunk);
+        }
+    }
+}
+
 Status queue_add(Queue *queue, void *item) {
 
+    if (IS_UNROLLED(queue) == TRUE) {
+        return _ul_add(queue, item);
+    }
+
     // Allocate the node for item insertion
-    Node *node = (Node *)malloc(sizeof(Node));
+    Node *node = (Node *)nodepool_alloc(queue->pool, sizeof(Node));
     if (node == NULL) {
         return ALLOC_FAILURE;
     }
@@ -81,6 +217,113 @@ Status queue_add(Queue *queue, void *item) {
     }
     queue->tail = node;
     queue->size++;
+    queue->modCount++;
+
+    return OK;
+}
+
+/**
+ * Appends the `n` items to the unrolled queue `queue`. The chunks the batch needs beyond the room
+ * left in the last one are all allocated first, so that the queue is left untouched on failure.
+ */
+static Status _ul_addAll(Queue *queue, void **items, long n) {
+
+    Chunk *chunks = NULL, *chunk;
+    long room, needed, count;
+
+    room = ( queue->last == NULL ) ? 0L : CHUNK_LEN - queue->tailIndex;
+    needed = ( n <= room ) ? 0L : ( n - room + CHUNK_LEN - 1L ) / CHUNK_LEN;
+
+    // Gathers the new chunks into a chain, starting with the spare chunk if there is one
+    for (count = 0L; count < needed; count++) {
+        chunk = queue->spare;
+        if (chunk != NULL) {
+            queue->spare = NULL;
+        } else if ((chunk = (Chunk *)allocator_alloc(queue->allocator, sizeof(Chunk))) == NULL) {
+            while (chunks != NULL) {
+                chunk = chunks->next;
+                allocator_free(queue->allocator, chunks);
+                chunks = chunk;
+            }
+            return ALLOC_FAILURE;
+        }
+        chunk->next = chunks;
+        chunks = chunk;
+    }
+
+    // Fills the last chunk, then each of the new chunks in turn
+    while (n > 0L) {
+        if (queue->last == NULL || queue->tailIndex == CHUNK_LEN) {
+            chunk = chunks;
+            chunks = chunks->next;
+            chunk->next = NULL;
+            if (queue->last == NULL) {
+                queue->first = chunk;
+                queue->headIndex = 0L;
+            } else {
+                queue->last->next = chunk;
+            }
+            queue->last = chunk;
+            queue->tailIndex = 0L;
+        }
+        count = CHUNK_LEN - queue->tailIndex;
+        count = ( n < count ) ? n : count;
+        memcpy(queue->last->items + queue->tailIndex, items, count * sizeof(void *));
+        queue->tailIndex += count;
+        queue->size += count;
+        items += count;
+        n -= count;
+    }
+    queue->modCount++;
+
+    return OK;
+}
+
+Status queue_addAll(Queue *queue, void **items, long n) {
+
+    Node *first = NULL, *last = NULL, *node;
+    long i;
+
+    if (n < 0L) {
+        return INVALID_INDEX;
+    }
+    if (n == 0L) {
+        return OK;
+    }
+    if (IS_UNROLLED(queue) == TRUE) {
+        return _ul_addAll(queue, items, n);
+    }
+
+    // Links the batch into a chain of its own, so the queue is left untouched on failure
+    for (i = 0L; i < n; i++) {
+        node = (Node *)nodepool_alloc(queue->pool, sizeof(Node));
+        if (node == NULL) {
+            while (first != NULL) {
+                node = first->next;
+                nodepool_free(queue->pool, first, sizeof(Node));
+                first = node;
+            }
+            return ALLOC_FAILURE;
+        }
+        node->next = NULL;
+        node->data = items[i];
+        if (first == NULL) {
+            first = node;
+        } else {
+            last->next = node;
+        }
+        last = node;
+    }
+
+    // Splices the whole chain onto the tail at once
+    if (IS_EMPTY(queue) == TRUE) {
+        queue->head = first;
+    } else {
+        queue->tail->next = first;
+    }
+    queue->tail = last;
+    queue->size += n;
+    queue->modCount++;
 
     return OK;
 }
@@ -92,17 +335,28 @@ Status queue_peek(Queue *queue, void **first) {
         return STRUCT_EMPTY;
     }
     // Extract the element, saves to pointer
-    *first = queue->head->data;
+    if (IS_UNROLLED(queue) == TRUE) {
+        *first = queue->first->items[queue->headIndex];
+    } else {
+        *first = queue->head->data;
+    }
 
     return OK;
 }
 
-Status queue_poll(Queue *queue, void **first) {
+/**
+ * Removes the queue's first item, the body of queue_poll().
+ */
+static Status _poll(Queue *queue, void **first) {
 
     // Checks if the queue is empty
     if (IS_EMPTY(queue) == TRUE) {
         return STRUCT_EMPTY;
     }
+    if (IS_UNROLLED(queue) == TRUE) {
+        _ul_poll(queue, first);
+        return OK;
+    }
 
     // Unlink the head node from the queue
     Node *temp = queue->head;
@@ -115,11 +369,63 @@ Status queue_poll(Queue *queue, void **first) {
     }
     // Free the allocated node's struct
     *first = temp->data;
-    free(temp);
+    nodepool_free(queue->pool, temp, sizeof(Node));
+    queue->modCount++;
 
     return OK;
 }
 
+Status queue_poll(Queue *queue, void **first) {
+
+    CDS_STATS_BEGIN();
+    Status status = _poll(queue, first);
+    CDS_STATS_END(CDS_PROBE_QUEUE_POLL);
+
+    return status;
+}
+
+long queue_pollMany(Queue *queue, void **items, long max) {
+
+    Node *temp;
+    long count, n, removed;
+
+    removed = ( max < queue->size ) ? max : queue->size;
+    if (removed <= 0L) {
+        return 0L;
+    }
+
+    if (IS_UNROLLED(queue) == TRUE) {
+        // Copies out whole runs of each chunk, releasing the chunks emptied along the way
+        for (n = removed; n > 0L; n -= count) {
+            count = ( queue->first == queue->last ) ? queue->tailIndex - queue->headIndex
+                                                     : CHUNK_LEN - queue->headIndex;
+            count = ( n < count ) ? n : count;
+            memcpy(items, queue->first->items + queue->headIndex, count * sizeof(void *));
+            items += count;
+            // Polls the run's last element, which also takes care of releasing the chunk
+            queue->headIndex += count - 1L;
+            queue->size -= count - 1L;
+            _ul_poll(queue, items - 1);
+        }
+        return removed;
+    }
+
+    // Unlinks the nodes one by one, but updates the queue's attributes only once
+    for (n = 0L; n < removed; n++) {
+        temp = queue->head;
+        queue->head = temp->next;
+        items[n] = temp->data;
+        nodepool_free(queue->pool, temp, sizeof(Node));
+    }
+    queue->size -= removed;
+    if (IS_EMPTY(queue) == TRUE) {
+        queue->tail = NULL;
+    }
+    queue->modCount++;
+
+    return removed;
+}
+
 /**
  * Helper method to clear out the queue `queue` of all its elements, applying the destructor method
  * `destructor` on each element (or if NULL, nothing will be done to the elements).
@@ -127,7 +433,35 @@ Status queue_poll(Queue *queue, void **first) {
 static void _clear_queue(Queue *queue, void (*destructor)(void *)) {
 
     Node *curr = queue->head, *next = NULL;
-    long i;
+    Chunk *chunk, *after;
+    long i, index;
+
+    // Chunks are freed one by one, visiting the elements they hold for the destructor
+    if (IS_UNROLLED(queue) == TRUE) {
+        index = queue->headIndex;
+        for (chunk = queue->first; chunk != NULL; chunk = after) {
+            after = chunk->next;
+            if (destructor != NULL) {
+                long end = ( after == NULL ) ? queue->tailIndex : CHUNK_LEN;
+                for (i = index; i < end; i++) {
+                    (*destructor)(chunk->items[i]);
+                }
+            }
+            allocator_free(queue->allocator, chunk);
+            index = 0L;
+        }
+        queue->first = NULL;
+        queue->last = NULL;
+        queue->headIndex = 0L;
+        queue->tailIndex = 0L;
+        return;
+    }
+
+    // A private pool releases every node at once, so nodes are only visited for the destructor
+    if (queue->ownsPool == TRUE && destructor == NULL) {
+        nodepool_reset(queue->pool);
+        return;
+    }
 
     for (i = 0L; i < queue->size; i++) {
         next = curr->next;
@@ -135,9 +469,14 @@ static void _clear_queue(Queue *queue, void (*destructor)(void *)) {
         if (destructor != NULL) {
             (*destructor)(curr->data);
         }
-        free(curr);
+        if (queue->ownsPool == FALSE) {
+            nodepool_free(queue->pool, curr, sizeof(Node));
+        }
         curr = next;
     }
+    if (queue->ownsPool == TRUE) {
+        nodepool_reset(queue->pool);
+    }
 }
 
 void queue_clear(Queue *queue, void (*destructor)(void *)) {
@@ -146,6 +485,7 @@ void queue_clear(Queue *queue, void (*destructor)(void *)) {
     queue->head = NULL;
     queue->tail = NULL;
     queue->size = 0L;
+    queue->modCount++;
 }
 
 long queue_size(Queue *queue) {
@@ -174,7 +514,18 @@ static void **_generate_array(Queue *queue) {
         return NULL;
     }
 
-    // Populates the array with the queue items
+    // Populates the array with the queue items, a whole run at a time when unrolled
+    if (IS_UNROLLED(queue) == TRUE) {
+        Chunk *chunk;
+        long index = queue->headIndex, end;
+        for (chunk = queue->first; chunk != NULL; chunk = chunk->next) {
+            end = ( chunk->next == NULL ) ? queue->tailIndex : CHUNK_LEN;
+            memcpy(&(items[i]), &(chunk->items[index]), (end - index) * sizeof(void *));
+            i += end - index;
+            index = 0L;
+        }
+        return items;
+    }
     for (temp = queue->head; temp != NULL; temp = temp->next) {
         items[i++] = temp->data;
     }
@@ -236,7 +587,102 @@ Status queue_iterator(Queue *queue, Iterator **iter) {
     return OK;
 }
 
+void queue_cursor(Queue *queue, Cursor *cursor) {
+    cursor->adt = queue;
+    cursor->node = ( IS_UNROLLED(queue) == TRUE ) ? (void *)queue->first : (void *)queue->head;
+    cursor->index = ( IS_UNROLLED(queue) == TRUE ) ? queue->headIndex : 0L;
+    cursor->remaining = queue->size;
+    cursor->modCount = queue->modCount;
+}
+
+Status queue_cursorNext(Cursor *cursor, void **next) {
+
+    Queue *queue = (Queue *)cursor->adt;
+    Node *node = (Node *)cursor->node;
+
+    // Fails fast if the queue was modified since creating the cursor
+    if (queue->modCount != cursor->modCount) {
+        return CONCURRENT_MODIFICATION;
+    }
+    // Checks if every element was visited
+    if (cursor->remaining == 0L) {
+        return ITER_END;
+    }
+
+    // Fetches the item, advances to the next slot of the chunk or the next node
+    if (IS_UNROLLED(queue) == TRUE) {
+        Chunk *chunk = (Chunk *)cursor->node;
+        *next = chunk->items[cursor->index++];
+        if (cursor->index == CHUNK_LEN) {
+            cursor->node = chunk->next;
+            cursor->index = 0L;
+        }
+    } else {
+        *next = node->data;
+        cursor->node = node->next;
+    }
+    cursor->remaining--;
+
+    return OK;
+}
+
+Boolean queue_forEach(Queue *queue, Boolean (*action)(void *, void *), void *context) {
+
+    Chunk *chunk = queue->first;
+    Node *node;
+    long i, index = queue->headIndex;
+
+    // Unrolled queues walk the slots of each chunk, starting from the head's slot
+    if (IS_UNROLLED(queue) == TRUE) {
+        for (i = 0L; i < queue->size; i++) {
+            if ((*action)(chunk->items[index], context) == FALSE) {
+                return FALSE;
+            }
+            if (++index == CHUNK_LEN) {
+                chunk = chunk->next;
+                index = 0L;
+            }
+        }
+        return TRUE;
+    }
+
+    for (node = queue->head; node != NULL; node = node->next) {
+        if ((*action)(node->data, context) == FALSE) {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+long queue_memoryUsage(Queue *queue) {
+
+    long bytes = (long)sizeof(Queue);
+    Chunk *chunk;
+
+    // Unrolled queues are charged for their chunks, the spare one included, the others for nodes
+    if (IS_UNROLLED(queue) == TRUE) {
+        for (chunk = queue->first; chunk != NULL; chunk = chunk->next) {
+            bytes += (long)sizeof(Chunk);
+        }
+        if (queue->spare != NULL) {
+            bytes += (long)sizeof(Chunk);
+        }
+    } else if (queue->ownsPool == FALSE) {
+        bytes += queue->size * (long)sizeof(Node);
+    }
+    if (queue->ownsPool == TRUE) {
+        bytes += nodepool_memoryUsage(queue->pool);
+    }
+
+    return bytes;
+}
+
 void queue_destroy(Queue *queue, void (*destructor)(void *)) {
     _clear_queue(queue, destructor);
-    free(queue);
+    allocator_free(queue->allocator, queue->spare);
+    if (queue->ownsPool == TRUE) {
+        nodepool_destroy(queue->pool);
+    }
+    allocator_free(queue->allocator, queue);
 }
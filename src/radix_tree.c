@@ -0,0 +1,1055 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2020 Cole Vikupitz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "radix_tree.h"
+#include "node_pool.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/**
+ * Struct for a leaf of the RadixTree ADT, holding an entry and its own copy of the key.
+ */
+typedef struct art_leaf {
+    void *value;                // Points to the entry's value
+    long length;                // Number of bytes in the key
+    unsigned char key[];        // The key's bytes
+} Leaf;
+
+// Largest number of prefix bytes stored in an inner node; longer prefixes are read from a leaf
+#define MAX_PREFIX 10
+
+/**
+ * Header shared by the inner nodes of every size.
+ */
+typedef struct art_node {
+    uint8_t type;               // NODE4, NODE16, NODE48 or NODE256
+    uint16_t count;             // Number of children
+    uint32_t prefixLen;         // Number of bytes in the compressed prefix below the parent
+    unsigned char prefix[MAX_PREFIX];   // The prefix's first bytes
+    Leaf *terminal;             // The entry whose key ends right after the prefix, NULL if none
+} ArtNode;
+
+/**
+ * Inner node types, holding up to 4, 16, 48 and 256 children respectively. The children of the two
+ * smaller nodes are kept sorted by their bytes; a Node48 maps each byte to a child slot.
+ */
+typedef struct {
+    ArtNode header;
+    unsigned char keys[4];
+    ArtNode *children[4];
+} Node4;
+
+typedef struct {
+    ArtNode header;
+    unsigned char keys[16];
+    ArtNode *children[16];
+} Node16;
+
+typedef struct {
+    ArtNode header;
+    unsigned char index[256];   // Child slot of each byte plus one, 0 if the byte has no child
+    ArtNode *children[48];
+} Node48;
+
+typedef struct {
+    ArtNode header;
+    ArtNode *children[256];
+} Node256;
+
+/**
+ * The struct for the RadixTree ADT.
+ */
+struct radix_tree {
+    ArtNode *root;              // The root, a tagged leaf if the tree holds a single key
+    NodePool *pool;             // Private pool the nodes and leaves are allocated from
+    long size;                  // Number of entries in the tree
+    long bytes;                 // Total size of the nodes and leaves
+};
+
+// Types of the inner nodes
+#define NODE4 0
+#define NODE16 1
+#define NODE48 2
+#define NODE256 3
+
+// Child pointers to leaves are tagged in their lowest bit, to tell them apart from inner nodes
+#define IS_LEAF(n)    ( ((uintptr_t)(n) & 1UL) != 0UL )
+#define TO_LEAF(n)    ( (Leaf *)((uintptr_t)(n) & ~1UL) )
+#define FROM_LEAF(l)  ( (ArtNode *)((uintptr_t)(l) | 1UL) )
+
+// Macro to fetch the smaller of two lengths
+#define MIN(a, b)  ( ((a) < (b)) ? (a) : (b) )
+
+// Sizes of the inner node types, indexed by type
+static const size_t NODE_SIZES[] = {sizeof(Node4), sizeof(Node16), sizeof(Node48),
+                                    sizeof(Node256)};
+
+/**
+ * Allocates a new leaf holding a copy of the key, returning NULL on allocation failure.
+ */
+static Leaf *_new_leaf(RadixTree *tree, const unsigned char *key, long length, void *value) {
+
+    Leaf *leaf = (Leaf *)nodepool_alloc(tree->pool, sizeof(Leaf) + (size_t)length);
+    if (leaf != NULL) {
+        leaf->value = value;
+        leaf->length = length;
+        memcpy(leaf->key, key, (size_t)length);
+        tree->bytes += (long)(sizeof(Leaf) + (size_t)length);
+    }
+    return leaf;
+}
+
+static void _free_leaf(RadixTree *tree, Leaf *leaf) {
+    tree->bytes -= (long)(sizeof(Leaf) + (size_t)leaf->length);
+    nodepool_free(tree->pool, leaf, sizeof(Leaf) + (size_t)leaf->length);
+}
+
+/**
+ * Allocates a new, empty inner node of the type, returning NULL on allocation failure.
+ */
+static ArtNode *_new_node(RadixTree *tree, uint8_t type) {
+
+    ArtNode *node = (ArtNode *)nodepool_alloc(tree->pool, NODE_SIZES[type]);
+    if (node != NULL) {
+        memset(node, 0, NODE_SIZES[type]);
+        node->type = type;
+        tree->bytes += (long)NODE_SIZES[type];
+    }
+    return node;
+}
+
+static void _free_node(RadixTree *tree, ArtNode *node) {
+    tree->bytes -= (long)NODE_SIZES[node->type];
+    nodepool_free(tree->pool, node, NODE_SIZES[node->type]);
+}
+
+/**
+ * Returns TRUE if the leaf's key is exactly the given key.
+ */
+static Boolean _leaf_matches(Leaf *leaf, const unsigned char *key, long length) {
+    return ( leaf->length == length && memcmp(leaf->key, key, (size_t)length) == 0 ) ? TRUE : FALSE;
+}
+
+/**
+ * Compares the leaf's key to the given key lexicographically, a prefix ordering first.
+ */
+static int _leaf_compare(Leaf *leaf, const unsigned char *key, long length) {
+    int cmp = memcmp(leaf->key, key, (size_t)MIN(leaf->length, length));
+    if (cmp != 0) {
+        return cmp;
+    }
+    return ( leaf->length > length ) - ( leaf->length < length );
+}
+
+/**
+ * Returns the address of the node's child under the byte, NULL if there is none.
+ */
+static ArtNode **_find_child(ArtNode *node, unsigned char c) {
+
+    int i;
+
+    switch (node->type) {
+    case NODE4: {
+        Node4 *n = (Node4 *)node;
+        for (i = 0; i < node->count; i++) {
+            if (n->keys[i] == c) {
+                return &(n->children[i]);
+            }
+        }
+        return NULL;
+    }
+    case NODE16: {
+        Node16 *n = (Node16 *)node;
+#if defined(__SSE2__)
+        __m128i keys = _mm_loadu_si128((const __m128i *)n->keys);
+        int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(keys, _mm_set1_epi8((char)c)));
+        mask &= (1 << node->count) - 1;
+        return ( mask != 0 ) ? &(n->children[__builtin_ctz((unsigned)mask)]) : NULL;
+#else
+        for (i = 0; i < node->count; i++) {
+            if (n->keys[i] == c) {
+                return &(n->children[i]);
+            }
+        }
+        return NULL;
+#endif
+    }
+    case NODE48: {
+        Node48 *n = (Node48 *)node;
+        return ( n->index[c] != 0 ) ? &(n->children[n->index[c] - 1]) : NULL;
+    }
+    default: {
+        Node256 *n = (Node256 *)node;
+        return ( n->children[c] != NULL ) ? &(n->children[c]) : NULL;
+    }
+    }
+}
+
+/**
+ * Returns the node's child under the least byte greater than `c` (which may be -1), storing the
+ * byte into `*byte`. Returns NULL if there is no such child.
+ */
+static ArtNode *_next_child(ArtNode *node, int c, int *byte) {
+
+    int i;
+
+    switch (node->type) {
+    case NODE4:
+    case NODE16: {
+        // Both keep their keys sorted, and share the layout of their keys and children
+        unsigned char *keys = ( node->type == NODE4 ) ? ((Node4 *)node)->keys
+                                                      : ((Node16 *)node)->keys;
+        ArtNode **children = ( node->type == NODE4 ) ? ((Node4 *)node)->children
+                                                     : ((Node16 *)node)->children;
+        for (i = 0; i < node->count; i++) {
+            if (keys[i] > c) {
+                *byte = keys[i];
+                return children[i];
+            }
+        }
+        return NULL;
+    }
+    case NODE48: {
+        Node48 *n = (Node48 *)node;
+        for (i = c + 1; i < 256; i++) {
+            if (n->index[i] != 0) {
+                *byte = i;
+                return n->children[n->index[i] - 1];
+            }
+        }
+        return NULL;
+    }
+    default: {
+        Node256 *n = (Node256 *)node;
+        for (i = c + 1; i < 256; i++) {
+            if (n->children[i] != NULL) {
+                *byte = i;
+                return n->children[i];
+            }
+        }
+        return NULL;
+    }
+    }
+}
+
+/**
+ * Returns the node's child under the greatest byte less than `c` (which may be 256). Returns NULL
+ * if there is no such child.
+ */
+static ArtNode *_prev_child(ArtNode *node, int c) {
+
+    int i;
+
+    switch (node->type) {
+    case NODE4:
+    case NODE16: {
+        unsigned char *keys = ( node->type == NODE4 ) ? ((Node4 *)node)->keys
+                                                      : ((Node16 *)node)->keys;
+        ArtNode **children = ( node->type == NODE4 ) ? ((Node4 *)node)->children
+                                                     : ((Node16 *)node)->children;
+        for (i = node->count - 1; i >= 0; i--) {
+            if (keys[i] < c) {
+                return children[i];
+            }
+        }
+        return NULL;
+    }
+    case NODE48: {
+        Node48 *n = (Node48 *)node;
+        for (i = c - 1; i >= 0; i--) {
+            if (n->index[i] != 0) {
+                return n->children[n->index[i] - 1];
+            }
+        }
+        return NULL;
+    }
+    default: {
+        Node256 *n = (Node256 *)node;
+        for (i = c - 1; i >= 0; i--) {
+            if (n->children[i] != NULL) {
+                return n->children[i];
+            }
+        }
+        return NULL;
+    }
+    }
+}
+
+/**
+ * Returns the leaf with the least key under the node, which may itself be a tagged leaf.
+ */
+static Leaf *_minimum(ArtNode *node) {
+
+    int byte;
+
+    while (IS_LEAF(node) == FALSE) {
+        if (node->terminal != NULL) {
+            return node->terminal;
+        }
+        node = _next_child(node, -1, &byte);
+    }
+    return TO_LEAF(node);
+}
+
+/**
+ * Returns the leaf with the greatest key under the node, which may itself be a tagged leaf.
+ */
+static Leaf *_maximum(ArtNode *node) {
+
+    while (IS_LEAF(node) == FALSE) {
+        ArtNode *last = _prev_child(node, 256);
+        if (last == NULL) {
+            return node->terminal;
+        }
+        node = last;
+    }
+    return TO_LEAF(node);
+}
+
+/**
+ * Returns the bytes of the node's whole prefix, which starts at `depth` in the keys below it. Only
+ * the first bytes are stored in the node; all of them are found in any key below it.
+ */
+static const unsigned char *_full_prefix(ArtNode *node, long depth) {
+    if (node->prefixLen <= MAX_PREFIX) {
+        return node->prefix;
+    }
+    return _minimum(node)->key + depth;
+}
+
+/**
+ * Adds the child under the byte to the node, replacing the node referenced by `ref` by a larger
+ * one if it is full.
+ */
+static Status _add_child(RadixTree *tree, ArtNode **ref, ArtNode *node, unsigned char c,
+                         ArtNode *child) {
+
+    ArtNode *grown;
+    int i, pos;
+
+    switch (node->type) {
+    case NODE4:
+    case NODE16: {
+        unsigned char *keys = ( node->type == NODE4 ) ? ((Node4 *)node)->keys
+                                                      : ((Node16 *)node)->keys;
+        ArtNode **children = ( node->type == NODE4 ) ? ((Node4 *)node)->children
+                                                     : ((Node16 *)node)->children;
+        int capacity = ( node->type == NODE4 ) ? 4 : 16;
+        if (node->count < capacity) {
+            // Shift the greater keys up to keep them sorted
+            for (pos = 0; pos < node->count && keys[pos] < c; pos++)
+                ;
+            memmove(keys + pos + 1, keys + pos, (size_t)(node->count - pos));
+            memmove(children + pos + 1, children + pos,
+                    sizeof(ArtNode *) * (size_t)(node->count - pos));
+            keys[pos] = c;
+            children[pos] = child;
+            node->count++;
+            return OK;
+        }
+        grown = _new_node(tree, node->type + 1);
+        if (grown == NULL) {
+            return ALLOC_FAILURE;
+        }
+        memcpy(grown, node, sizeof(ArtNode));
+        grown->type = node->type + 1;
+        if (node->type == NODE4) {
+            memcpy(((Node16 *)grown)->keys, keys, 4);
+            memcpy(((Node16 *)grown)->children, children, sizeof(ArtNode *) * 4);
+        } else {
+            for (i = 0; i < 16; i++) {
+                ((Node48 *)grown)->index[keys[i]] = (unsigned char)(i + 1);
+                ((Node48 *)grown)->children[i] = children[i];
+            }
+        }
+        break;
+    }
+    case NODE48: {
+        Node48 *n = (Node48 *)node;
+        if (node->count < 48) {
+            for (pos = 0; n->children[pos] != NULL; pos++)
+                ;
+            n->children[pos] = child;
+            n->index[c] = (unsigned char)(pos + 1);
+            node->count++;
+            return OK;
+        }
+        grown = _new_node(tree, NODE256);
+        if (grown == NULL) {
+            return ALLOC_FAILURE;
+        }
+        memcpy(grown, node, sizeof(ArtNode));
+        grown->type = NODE256;
+        for (i = 0; i < 256; i++) {
+            if (n->index[i] != 0) {
+                ((Node256 *)grown)->children[i] = n->children[n->index[i] - 1];
+            }
+        }
+        break;
+    }
+    default:
+        ((Node256 *)node)->children[c] = child;
+        node->count++;
+        return OK;
+    }
+
+    // Swap the full node for the larger one, which has room for the child
+    *ref = grown;
+    _free_node(tree, node);
+    return _add_child(tree, ref, grown, c, child);
+}
+
+/**
+ * Removes the child under the byte from the node, replacing the node referenced by `ref` by a
+ * smaller one if it has become sparse. Shrinking below the point of growing avoids thrashing
+ * between two sizes. The smaller node is allocated first, so the node is kept if that fails.
+ */
+static void _remove_child(RadixTree *tree, ArtNode **ref, ArtNode *node, unsigned char c) {
+
+    ArtNode *shrunk = NULL;
+    int i, pos;
+
+    switch (node->type) {
+    case NODE4:
+    case NODE16: {
+        unsigned char *keys = ( node->type == NODE4 ) ? ((Node4 *)node)->keys
+                                                      : ((Node16 *)node)->keys;
+        ArtNode **children = ( node->type == NODE4 ) ? ((Node4 *)node)->children
+                                                     : ((Node16 *)node)->children;
+        for (pos = 0; keys[pos] != c; pos++)
+            ;
+        memmove(keys + pos, keys + pos + 1, (size_t)(node->count - pos - 1));
+        memmove(children + pos, children + pos + 1,
+                sizeof(ArtNode *) * (size_t)(node->count - pos - 1));
+        node->count--;
+        if (node->type == NODE16 && node->count == 3 &&
+                (shrunk = _new_node(tree, NODE4)) != NULL) {
+            memcpy(shrunk, node, sizeof(ArtNode));
+            shrunk->type = NODE4;
+            memcpy(((Node4 *)shrunk)->keys, keys, 3);
+            memcpy(((Node4 *)shrunk)->children, children, sizeof(ArtNode *) * 3);
+        }
+        break;
+    }
+    case NODE48: {
+        Node48 *n = (Node48 *)node;
+        n->children[n->index[c] - 1] = NULL;
+        n->index[c] = 0;
+        node->count--;
+        if (node->count == 12 && (shrunk = _new_node(tree, NODE16)) != NULL) {
+            memcpy(shrunk, node, sizeof(ArtNode));
+            shrunk->type = NODE16;
+            for (i = 0, pos = 0; i < 256; i++) {
+                if (n->index[i] != 0) {
+                    ((Node16 *)shrunk)->keys[pos] = (unsigned char)i;
+                    ((Node16 *)shrunk)->children[pos++] = n->children[n->index[i] - 1];
+                }
+            }
+        }
+        break;
+    }
+    default: {
+        Node256 *n = (Node256 *)node;
+        n->children[c] = NULL;
+        node->count--;
+        if (node->count == 37 && (shrunk = _new_node(tree, NODE48)) != NULL) {
+            memcpy(shrunk, node, sizeof(ArtNode));
+            shrunk->type = NODE48;
+            for (i = 0, pos = 0; i < 256; i++) {
+                if (n->children[i] != NULL) {
+                    ((Node48 *)shrunk)->index[i] = (unsigned char)(pos + 1);
+                    ((Node48 *)shrunk)->children[pos++] = n->children[i];
+                }
+            }
+        }
+        break;
+    }
+    }
+
+    if (shrunk != NULL) {
+        *ref = shrunk;
+        _free_node(tree, node);
+    }
+}
+
+/**
+ * Replaces the node referenced by `ref` by its only entry, once a removal has left it with one.
+ * A remaining child node absorbs the node's prefix and the byte leading to it into its own.
+ */
+static void _collapse(RadixTree *tree, ArtNode **ref) {
+
+    ArtNode *node = *ref, *child;
+    int byte;
+    uint32_t len;
+
+    if (node->count + (( node->terminal != NULL ) ? 1 : 0) != 1) {
+        return;
+    }
+    if (node->count == 0) {
+        *ref = FROM_LEAF(node->terminal);
+        _free_node(tree, node);
+        return;
+    }
+
+    child = _next_child(node, -1, &byte);
+    if (IS_LEAF(child) == FALSE) {
+        unsigned char prefix[MAX_PREFIX];
+        len = MIN(node->prefixLen, MAX_PREFIX);
+        memcpy(prefix, node->prefix, len);
+        if (len < MAX_PREFIX) {
+            prefix[len++] = (unsigned char)byte;
+        }
+        if (len < MAX_PREFIX) {
+            memcpy(prefix + len, child->prefix, MIN(child->prefixLen, MAX_PREFIX - len));
+        }
+        memcpy(child->prefix, prefix, MAX_PREFIX);
+        child->prefixLen += node->prefixLen + 1;
+    }
+    *ref = child;
+    _free_node(tree, node);
+}
+
+/**
+ * Links the leaf into a new node whose prefix ends at `depth`: as its terminal if the key ends
+ * there, or as a child under its next byte otherwise.
+ */
+static void _attach(RadixTree *tree, ArtNode *node, Leaf *leaf, long depth) {
+    if (leaf->length == depth) {
+        node->terminal = leaf;
+    } else {
+        _add_child(tree, &node, node, leaf->key[depth], FROM_LEAF(leaf));
+    }
+}
+
+/**
+ * Inserts the key under the node referenced by `ref`, whose keys agree with it up to `depth`.
+ */
+static Status _insert(RadixTree *tree, ArtNode **ref, const unsigned char *key, long length,
+                      long depth, void *value, void **previous) {
+
+    ArtNode *node = *ref, *split;
+    Leaf *leaf;
+    long i;
+
+    // An empty spot simply takes a new leaf
+    if (node == NULL) {
+        leaf = _new_leaf(tree, key, length, value);
+        if (leaf == NULL) {
+            return ALLOC_FAILURE;
+        }
+        *ref = FROM_LEAF(leaf);
+        return INSERTED;
+    }
+
+    // A leaf with another key is split into a node branching where the two keys part
+    if (IS_LEAF(node) == TRUE) {
+        Leaf *other = TO_LEAF(node);
+        if (_leaf_matches(other, key, length) == TRUE) {
+            *previous = other->value;
+            other->value = value;
+            return REPLACED;
+        }
+        leaf = _new_leaf(tree, key, length, value);
+        split = _new_node(tree, NODE4);
+        if (leaf == NULL || split == NULL) {
+            if (leaf != NULL) {
+                _free_leaf(tree, leaf);
+            }
+            if (split != NULL) {
+                _free_node(tree, split);
+            }
+            return ALLOC_FAILURE;
+        }
+        for (i = depth; i < other->length && i < length && other->key[i] == key[i]; i++)
+            ;
+        split->prefixLen = (uint32_t)(i - depth);
+        memcpy(split->prefix, key + depth, MIN(split->prefixLen, MAX_PREFIX));
+        _attach(tree, split, other, i);
+        _attach(tree, split, leaf, i);
+        *ref = split;
+        return INSERTED;
+    }
+
+    // A node whose prefix the key leaves is split where they part
+    if (node->prefixLen > 0) {
+        const unsigned char *prefix = _full_prefix(node, depth);
+        for (i = 0; i < node->prefixLen && depth + i < length && prefix[i] == key[depth + i]; i++)
+            ;
+        if (i < node->prefixLen) {
+            leaf = _new_leaf(tree, key, length, value);
+            split = _new_node(tree, NODE4);
+            if (leaf == NULL || split == NULL) {
+                if (leaf != NULL) {
+                    _free_leaf(tree, leaf);
+                }
+                if (split != NULL) {
+                    _free_node(tree, split);
+                }
+                return ALLOC_FAILURE;
+            }
+            split->prefixLen = (uint32_t)i;
+            memcpy(split->prefix, prefix, MIN(split->prefixLen, MAX_PREFIX));
+            unsigned char byte = prefix[i];
+            node->prefixLen -= (uint32_t)(i + 1);
+            memmove(node->prefix, prefix + i + 1, MIN(node->prefixLen, MAX_PREFIX));
+            _add_child(tree, &split, split, byte, node);
+            _attach(tree, split, leaf, depth + i);
+            *ref = split;
+            return INSERTED;
+        }
+        depth += node->prefixLen;
+    }
+
+    // The key either ends at this node, or continues into one of its children
+    if (depth == length) {
+        if (node->terminal != NULL) {
+            *previous = node->terminal->value;
+            node->terminal->value = value;
+            return REPLACED;
+        }
+        leaf = _new_leaf(tree, key, length, value);
+        if (leaf == NULL) {
+            return ALLOC_FAILURE;
+        }
+        node->terminal = leaf;
+        return INSERTED;
+    }
+    ArtNode **child = _find_child(node, key[depth]);
+    if (child != NULL) {
+        return _insert(tree, child, key, length, depth + 1, value, previous);
+    }
+    leaf = _new_leaf(tree, key, length, value);
+    if (leaf == NULL) {
+        return ALLOC_FAILURE;
+    }
+    if (_add_child(tree, ref, node, key[depth], FROM_LEAF(leaf)) != OK) {
+        _free_leaf(tree, leaf);
+        return ALLOC_FAILURE;
+    }
+    return INSERTED;
+}
+
+/**
+ * Unlinks the key from under the node referenced by `ref`, returning its leaf, or NULL if the key
+ * is not in the tree. Only the bytes of the prefixes stored in the nodes are compared on the way
+ * down; the leaf's key is compared in full at the end.
+ */
+static Leaf *_delete(RadixTree *tree, ArtNode **ref, const unsigned char *key, long length,
+                     long depth) {
+
+    ArtNode *node = *ref, **child;
+    Leaf *leaf;
+
+    if (IS_LEAF(node) == TRUE) {
+        leaf = TO_LEAF(node);
+        if (_leaf_matches(leaf, key, length) == FALSE) {
+            return NULL;
+        }
+        *ref = NULL;
+        return leaf;
+    }
+
+    if (node->prefixLen > 0) {
+        if (depth + node->prefixLen > length ||
+                memcmp(node->prefix, key + depth, MIN(node->prefixLen, MAX_PREFIX)) != 0) {
+            return NULL;
+        }
+        depth += node->prefixLen;
+    }
+
+    if (depth == length) {
+        leaf = node->terminal;
+        if (leaf == NULL || _leaf_matches(leaf, key, length) == FALSE) {
+            return NULL;
+        }
+        node->terminal = NULL;
+        _collapse(tree, ref);
+        return leaf;
+    }
+
+    child = _find_child(node, key[depth]);
+    if (child == NULL) {
+        return NULL;
+    }
+    if (IS_LEAF(*child) == FALSE) {
+        return _delete(tree, child, key, length, depth + 1);
+    }
+    leaf = TO_LEAF(*child);
+    if (_leaf_matches(leaf, key, length) == FALSE) {
+        return NULL;
+    }
+    _remove_child(tree, ref, node, key[depth]);
+    _collapse(tree, ref);
+    return leaf;
+}
+
+/**
+ * Finds the leaf holding the key, NULL if there is none.
+ */
+static Leaf *_search(RadixTree *tree, const unsigned char *key, long length) {
+
+    ArtNode *node = tree->root, **child;
+    long depth = 0L;
+
+    while (node != NULL) {
+        if (IS_LEAF(node) == TRUE) {
+            return ( _leaf_matches(TO_LEAF(node), key, length) == TRUE ) ? TO_LEAF(node) : NULL;
+        }
+        if (node->prefixLen > 0) {
+            if (depth + node->prefixLen > length ||
+                    memcmp(node->prefix, key + depth, MIN(node->prefixLen, MAX_PREFIX)) != 0) {
+                return NULL;
+            }
+            depth += node->prefixLen;
+        }
+        if (depth == length) {
+            Leaf *leaf = node->terminal;
+            return ( leaf != NULL && _leaf_matches(leaf, key, length) == TRUE ) ? leaf : NULL;
+        }
+        child = _find_child(node, key[depth++]);
+        node = ( child != NULL ) ? *child : NULL;
+    }
+    return NULL;
+}
+
+/**
+ * Returns the leaf under the node with the least key no less than the given key, where the keys
+ * under the node agree with it up to `depth`. Returns NULL if there is none.
+ */
+static Leaf *_ceiling(ArtNode *node, const unsigned char *key, long length, long depth) {
+
+    ArtNode **child, *next;
+    Leaf *leaf;
+    long i;
+    int byte;
+
+    if (IS_LEAF(node) == TRUE) {
+        return ( _leaf_compare(TO_LEAF(node), key, length) >= 0 ) ? TO_LEAF(node) : NULL;
+    }
+
+    // Where the prefix parts from the key decides for the whole subtree
+    const unsigned char *prefix = _full_prefix(node, depth);
+    for (i = 0L; i < node->prefixLen; i++) {
+        if (depth + i == length) {
+            return _minimum(node);
+        }
+        if (prefix[i] != key[depth + i]) {
+            return ( prefix[i] > key[depth + i] ) ? _minimum(node) : NULL;
+        }
+    }
+    depth += node->prefixLen;
+
+    // The terminal holds the key itself; every other key below is longer
+    if (depth == length) {
+        return ( node->terminal != NULL ) ? node->terminal : _minimum(node);
+    }
+    child = _find_child(node, key[depth]);
+    if (child != NULL && (leaf = _ceiling(*child, key, length, depth + 1)) != NULL) {
+        return leaf;
+    }
+    next = _next_child(node, key[depth], &byte);
+    return ( next != NULL ) ? _minimum(next) : NULL;
+}
+
+/**
+ * Returns the leaf under the node with the greatest key no greater than the given key, where the
+ * keys under the node agree with it up to `depth`. Returns NULL if there is none.
+ */
+static Leaf *_floor(ArtNode *node, const unsigned char *key, long length, long depth) {
+
+    ArtNode **child, *prev;
+    Leaf *leaf;
+    long i;
+
+    if (IS_LEAF(node) == TRUE) {
+        return ( _leaf_compare(TO_LEAF(node), key, length) <= 0 ) ? TO_LEAF(node) : NULL;
+    }
+
+    const unsigned char *prefix = _full_prefix(node, depth);
+    for (i = 0L; i < node->prefixLen; i++) {
+        if (depth + i == length) {
+            return NULL;
+        }
+        if (prefix[i] != key[depth + i]) {
+            return ( prefix[i] < key[depth + i] ) ? _maximum(node) : NULL;
+        }
+    }
+    depth += node->prefixLen;
+
+    // The terminal is the key or a prefix of it, so it precedes the key's children
+    if (depth == length) {
+        return node->terminal;
+    }
+    child = _find_child(node, key[depth]);
+    if (child != NULL && (leaf = _floor(*child, key, length, depth + 1)) != NULL) {
+        return leaf;
+    }
+    prev = _prev_child(node, key[depth]);
+    return ( prev != NULL ) ? _maximum(prev) : node->terminal;
+}
+
+/**
+ * Applies `action` to every entry under the node in ascending order of their keys, stopping as
+ * soon as it returns FALSE.
+ */
+static Boolean _walk(ArtNode *node, Boolean (*action)(const void *, long, void *, void *),
+                     void *context) {
+
+    ArtNode *child;
+    int byte = -1;
+
+    if (IS_LEAF(node) == TRUE) {
+        Leaf *leaf = TO_LEAF(node);
+        return action(leaf->key, leaf->length, leaf->value, context);
+    }
+    if (node->terminal != NULL &&
+            action(node->terminal->key, node->terminal->length, node->terminal->value,
+                   context) == FALSE) {
+        return FALSE;
+    }
+    while ((child = _next_child(node, byte, &byte)) != NULL) {
+        if (_walk(child, action, context) == FALSE) {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+/**
+ * Frees every node and leaf under the node, invoking `valueDestructor` on the values if not NULL.
+ */
+static void _free_subtree(RadixTree *tree, ArtNode *node, void (*valueDestructor)(void *)) {
+
+    ArtNode *child;
+    int byte = -1;
+
+    if (IS_LEAF(node) == TRUE) {
+        if (valueDestructor != NULL) {
+            valueDestructor(TO_LEAF(node)->value);
+        }
+        _free_leaf(tree, TO_LEAF(node));
+        return;
+    }
+    if (node->terminal != NULL) {
+        _free_subtree(tree, FROM_LEAF(node->terminal), valueDestructor);
+    }
+    while ((child = _next_child(node, byte, &byte)) != NULL) {
+        _free_subtree(tree, child, valueDestructor);
+    }
+    _free_node(tree, node);
+}
+
+Status radixtree_new(RadixTree **tree) {
+
+    // Allocate the struct, check for allocation failure
+    RadixTree *temp = (RadixTree *)malloc(sizeof(RadixTree));
+    if (temp == NULL) {
+        return ALLOC_FAILURE;
+    }
+    if (nodepool_new(&(temp->pool), 0L) != OK) {
+        free(temp);
+        return ALLOC_FAILURE;
+    }
+
+    // Initialize the remaining struct members
+    temp->root = NULL;
+    temp->size = 0L;
+    temp->bytes = 0L;
+    *tree = temp;
+
+    return OK;
+}
+
+Status radixtree_put(RadixTree *tree, const void *key, long length, void *value,
+                     void **previous) {
+
+    Status status = _insert(tree, &(tree->root), (const unsigned char *)key, length, 0L, value,
+                            previous);
+    if (status == INSERTED) {
+        tree->size++;
+    }
+
+    return status;
+}
+
+Boolean radixtree_containsKey(RadixTree *tree, const void *key, long length) {
+    return ( _search(tree, (const unsigned char *)key, length) != NULL ) ? TRUE : FALSE;
+}
+
+Status radixtree_get(RadixTree *tree, const void *key, long length, void **value) {
+
+    Leaf *leaf = _search(tree, (const unsigned char *)key, length);
+    if (leaf == NULL) {
+        return NOT_FOUND;
+    }
+    *value = leaf->value;
+
+    return OK;
+}
+
+Status radixtree_remove(RadixTree *tree, const void *key, long length, void **value) {
+
+    if (tree->root == NULL) {
+        return NOT_FOUND;
+    }
+    Leaf *leaf = _delete(tree, &(tree->root), (const unsigned char *)key, length, 0L);
+    if (leaf == NULL) {
+        return NOT_FOUND;
+    }
+
+    *value = leaf->value;
+    _free_leaf(tree, leaf);
+    tree->size--;
+
+    return OK;
+}
+
+Status radixtree_firstKey(RadixTree *tree, const void **firstKey, long *firstLength) {
+
+    if (tree->root == NULL) {
+        return STRUCT_EMPTY;
+    }
+    Leaf *leaf = _minimum(tree->root);
+    *firstKey = leaf->key;
+    *firstLength = leaf->length;
+
+    return OK;
+}
+
+Status radixtree_lastKey(RadixTree *tree, const void **lastKey, long *lastLength) {
+
+    if (tree->root == NULL) {
+        return STRUCT_EMPTY;
+    }
+    Leaf *leaf = _maximum(tree->root);
+    *lastKey = leaf->key;
+    *lastLength = leaf->length;
+
+    return OK;
+}
+
+Status radixtree_floorKey(RadixTree *tree, const void *key, long length, const void **floorKey,
+                          long *floorLength) {
+
+    if (tree->root == NULL) {
+        return STRUCT_EMPTY;
+    }
+    Leaf *leaf = _floor(tree->root, (const unsigned char *)key, length, 0L);
+    if (leaf == NULL) {
+        return NOT_FOUND;
+    }
+    *floorKey = leaf->key;
+    *floorLength = leaf->length;
+
+    return OK;
+}
+
+Status radixtree_ceilingKey(RadixTree *tree, const void *key, long length,
+                            const void **ceilingKey, long *ceilingLength) {
+
+    if (tree->root == NULL) {
+        return STRUCT_EMPTY;
+    }
+    Leaf *leaf = _ceiling(tree->root, (const unsigned char *)key, length, 0L);
+    if (leaf == NULL) {
+        return NOT_FOUND;
+    }
+    *ceilingKey = leaf->key;
+    *ceilingLength = leaf->length;
+
+    return OK;
+}
+
+Boolean radixtree_forEach(RadixTree *tree, Boolean (*action)(const void *, long, void *, void *),
+                          void *context) {
+    return ( tree->root == NULL ) ? TRUE : _walk(tree->root, action, context);
+}
+
+Boolean radixtree_forEachPrefix(RadixTree *tree, const void *prefix, long length,
+                                Boolean (*action)(const void *, long, void *, void *),
+                                void *context) {
+
+    const unsigned char *bytes = (const unsigned char *)prefix, *nodePrefix;
+    ArtNode *node = tree->root, **child;
+    long depth = 0L, i;
+
+    // Descend to the subtree holding exactly the keys that start with the prefix
+    while (node != NULL) {
+        if (IS_LEAF(node) == TRUE) {
+            Leaf *leaf = TO_LEAF(node);
+            if (leaf->length < length || memcmp(leaf->key, bytes, (size_t)length) != 0) {
+                return TRUE;
+            }
+            return action(leaf->key, leaf->length, leaf->value, context);
+        }
+        nodePrefix = _full_prefix(node, depth);
+        for (i = 0L; i < node->prefixLen && depth + i < length; i++) {
+            if (nodePrefix[i] != bytes[depth + i]) {
+                return TRUE;
+            }
+        }
+        depth += node->prefixLen;
+        if (depth >= length) {
+            return _walk(node, action, context);
+        }
+        child = _find_child(node, bytes[depth++]);
+        node = ( child != NULL ) ? *child : NULL;
+    }
+
+    return TRUE;
+}
+
+long radixtree_size(RadixTree *tree) {
+    return tree->size;
+}
+
+Boolean radixtree_isEmpty(RadixTree *tree) {
+    return ( tree->size == 0L ) ? TRUE : FALSE;
+}
+
+void radixtree_clear(RadixTree *tree, void (*valueDestructor)(void *)) {
+
+    if (tree->root != NULL) {
+        _free_subtree(tree, tree->root, valueDestructor);
+    }
+    tree->root = NULL;
+    tree->size = 0L;
+}
+
+long radixtree_memoryUsage(RadixTree *tree) {
+    return (long)sizeof(RadixTree) + tree->bytes;
+}
+
+void radixtree_destroy(RadixTree *tree, void (*valueDestructor)(void *)) {
+
+    radixtree_clear(tree, valueDestructor);
+    nodepool_destroy(tree->pool);
+    free(tree);
+}
@@ -0,0 +1,265 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2020 Cole Vikupitz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include "ring_queue.h"
+
+// The size of a cache line, which the producers' and consumers' indices are kept apart by
+#define CACHE_LINE 64
+#define ALIGNED __attribute__((aligned(CACHE_LINE)))
+
+// The default capacity to assign when the capacity given is invalid
+#define DEFAULT_CAPACITY 16L
+
+/**
+ * A slot of the multi-producer/multi-consumer ring. A slot at ring position `pos` may be written
+ * once its sequence equals `pos`, and read once its sequence equals `pos + 1`.
+ */
+typedef struct {
+    unsigned long seq;          // The slot's sequence number
+    void *item;                 // The item stored in the slot
+} Slot;
+
+/**
+ * Struct for the ring queue ADT. The fields written by the producers and by the consumers each get
+ * a cache line of their own.
+ */
+struct ring_queue {
+    void **data;                // The items of a single-producer/single-consumer ring
+    Slot *slots;                // The slots of a multi-producer/multi-consumer ring
+    unsigned long mask;         // The capacity minus one, maps a position to its index
+    Boolean multi;              // TRUE if the ring is multi-producer/multi-consumer
+    ALIGNED unsigned long tail; // The position the next item is added at
+    unsigned long headCache;    // The producer's last-seen copy of `head` (single producer only)
+    ALIGNED unsigned long head; // The position the next item is polled from
+    unsigned long tailCache;    // The consumer's last-seen copy of `tail` (single consumer only)
+    ALIGNED char end;           // Pads the struct so no other allocation shares the last line
+};
+
+/**
+ * Allocates a new ring queue of at least `capacity` elements.
+ */
+static Status _new_queue(RingQueue **queue, long capacity, Boolean multi) {
+
+    RingQueue *temp;
+    unsigned long i, cap = 1UL;
+    unsigned long wanted = ( capacity <= 0L ) ? DEFAULT_CAPACITY : capacity;
+
+    // Rounds the capacity up to the next power of two
+    while (cap < wanted) {
+        cap <<= 1;
+    }
+
+    if (posix_memalign((void **)&temp, CACHE_LINE, sizeof(RingQueue)) != 0) {
+        return ALLOC_FAILURE;
+    }
+
+    temp->data = NULL;
+    temp->slots = NULL;
+    if (multi == TRUE) {
+        temp->slots = (Slot *)malloc(cap * sizeof(Slot));
+        if (temp->slots != NULL) {
+            for (i = 0UL; i < cap; i++) {
+                temp->slots[i].seq = i;
+            }
+        }
+    } else {
+        temp->data = (void **)malloc(cap * sizeof(void *));
+    }
+    if (temp->slots == NULL && temp->data == NULL) {
+        free(temp);
+        return ALLOC_FAILURE;
+    }
+
+    temp->mask = cap - 1UL;
+    temp->multi = multi;
+    temp->tail = 0UL;
+    temp->headCache = 0UL;
+    temp->head = 0UL;
+    temp->tailCache = 0UL;
+    *queue = temp;
+
+    return OK;
+}
+
+Status ringqueue_newSpsc(RingQueue **queue, long capacity) {
+    return _new_queue(queue, capacity, FALSE);
+}
+
+Status ringqueue_newMpmc(RingQueue **queue, long capacity) {
+    return _new_queue(queue, capacity, TRUE);
+}
+
+/**
+ * Adds `item` to a single-producer ring; only ever called by the one producer thread.
+ */
+static Status _spsc_add(RingQueue *queue, void *item) {
+
+    unsigned long tail = __atomic_load_n(&(queue->tail), __ATOMIC_RELAXED);
+
+    // Only re-reads the consumer's index, and its cache line, when the ring looks full
+    if (tail - queue->headCache > queue->mask) {
+        queue->headCache = __atomic_load_n(&(queue->head), __ATOMIC_ACQUIRE);
+        if (tail - queue->headCache > queue->mask) {
+            return STRUCT_FULL;
+        }
+    }
+
+    queue->data[tail & queue->mask] = item;
+    __atomic_store_n(&(queue->tail), tail + 1UL, __ATOMIC_RELEASE);
+
+    return OK;
+}
+
+/**
+ * Polls an item from a single-consumer ring; only ever called by the one consumer thread.
+ */
+static Status _spsc_poll(RingQueue *queue, void **first) {
+
+    unsigned long head = __atomic_load_n(&(queue->head), __ATOMIC_RELAXED);
+
+    // Only re-reads the producer's index, and its cache line, when the ring looks empty
+    if (head == queue->tailCache) {
+        queue->tailCache = __atomic_load_n(&(queue->tail), __ATOMIC_ACQUIRE);
+        if (head == queue->tailCache) {
+            return STRUCT_EMPTY;
+        }
+    }
+
+    *first = queue->data[head & queue->mask];
+    __atomic_store_n(&(queue->head), head + 1UL, __ATOMIC_RELEASE);
+
+    return OK;
+}
+
+/**
+ * Adds `item` to a multi-producer ring by claiming the slot at `tail`.
+ */
+static Status _mpmc_add(RingQueue *queue, void *item) {
+
+    unsigned long pos = __atomic_load_n(&(queue->tail), __ATOMIC_RELAXED);
+    Slot *slot;
+    long diff;
+
+    while (TRUE) {
+        slot = &(queue->slots[pos & queue->mask]);
+        diff = (long)(__atomic_load_n(&(slot->seq), __ATOMIC_ACQUIRE) - pos);
+        if (diff == 0L) {
+            // The slot is free, claims it unless another producer got there first
+            if (__atomic_compare_exchange_n(&(queue->tail), &pos, pos + 1UL, TRUE,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (diff < 0L) {
+            // The slot still holds the item from one lap ago, the ring is full
+            return STRUCT_FULL;
+        } else {
+            // Another producer claimed the slot, retries at the new tail
+            pos = __atomic_load_n(&(queue->tail), __ATOMIC_RELAXED);
+        }
+    }
+
+    // Publishes the item to the consumers
+    slot->item = item;
+    __atomic_store_n(&(slot->seq), pos + 1UL, __ATOMIC_RELEASE);
+
+    return OK;
+}
+
+/**
+ * Polls an item from a multi-consumer ring by claiming the slot at `head`.
+ */
+static Status _mpmc_poll(RingQueue *queue, void **first) {
+
+    unsigned long pos = __atomic_load_n(&(queue->head), __ATOMIC_RELAXED);
+    Slot *slot;
+    long diff;
+
+    while (TRUE) {
+        slot = &(queue->slots[pos & queue->mask]);
+        diff = (long)(__atomic_load_n(&(slot->seq), __ATOMIC_ACQUIRE) - (pos + 1UL));
+        if (diff == 0L) {
+            // The slot holds an item, claims it unless another consumer got there first
+            if (__atomic_compare_exchange_n(&(queue->head), &pos, pos + 1UL, TRUE,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (diff < 0L) {
+            // The slot has not been written since the last lap, the ring is empty
+            return STRUCT_EMPTY;
+        } else {
+            // Another consumer claimed the slot, retries at the new head
+            pos = __atomic_load_n(&(queue->head), __ATOMIC_RELAXED);
+        }
+    }
+
+    // Hands the slot back to the producers for the next lap
+    *first = slot->item;
+    __atomic_store_n(&(slot->seq), pos + queue->mask + 1UL, __ATOMIC_RELEASE);
+
+    return OK;
+}
+
+Status ringqueue_add(RingQueue *queue, void *item) {
+    return ( queue->multi == TRUE ) ? _mpmc_add(queue, item) : _spsc_add(queue, item);
+}
+
+Status ringqueue_poll(RingQueue *queue, void **first) {
+    return ( queue->multi == TRUE ) ? _mpmc_poll(queue, first) : _spsc_poll(queue, first);
+}
+
+long ringqueue_size(RingQueue *queue) {
+
+    // Reads the head first, so a concurrent poll cannot make the size negative
+    unsigned long head = __atomic_load_n(&(queue->head), __ATOMIC_ACQUIRE);
+    unsigned long tail = __atomic_load_n(&(queue->tail), __ATOMIC_ACQUIRE);
+    long size = (long)(tail - head);
+
+    if (size < 0L) {
+        return 0L;
+    }
+    return ( size > (long)queue->mask ) ? (long)queue->mask + 1L : size;
+}
+
+long ringqueue_capacity(RingQueue *queue) {
+    return (long)queue->mask + 1L;
+}
+
+Boolean ringqueue_isEmpty(RingQueue *queue) {
+    return ( ringqueue_size(queue) == 0L ) ? TRUE : FALSE;
+}
+
+void ringqueue_destroy(RingQueue *queue, void (*destructor)(void *)) {
+
+    void *item;
+
+    if (destructor != NULL) {
+        while (ringqueue_poll(queue, &item) == OK) {
+            (*destructor)(item);
+        }
+    }
+    free(queue->data);
+    free(queue->slots);
+    free(queue);
+}
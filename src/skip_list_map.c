@@ -0,0 +1,745 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2020 Cole Vikupitz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <sched.h>
+#include "skip_list_map.h"
+#include "epoch.h"
+
+// The size of a cache line, the size counter is kept on a line of its own
+#define CACHE_LINE 64
+
+// The maximum number of levels a node may have; at one in four nodes promoted per level, enough
+// for billions of entries
+#define MAX_LEVEL 16
+
+// The number of times a thread spins on a node's lock before yielding the processor
+#define SPIN_LIMIT 128
+
+#if defined(__x86_64__) || defined(__i386__)
+#define CPU_RELAX() __builtin_ia32_pause()
+#else
+#define CPU_RELAX() __asm__ __volatile__("" ::: "memory")
+#endif
+
+/**
+ * A node of the skip list.
+ */
+typedef struct sl_node {
+    void *key;                  // The node's key
+    void *value;                // The node's value
+    void (*keyDestructor)(void *);  // Destroys the key once the node is reclaimed, or NULL
+    int lock;                   // Spin lock guarding the node's links and value
+    int marked;                 // Set once the node is being removed
+    int linked;                 // Set once the node is linked on every one of its levels
+    int height;                 // The number of levels the node is linked on
+    struct sl_node *next[];     // The next node on each level
+} SlNode;
+
+/**
+ * Struct for the skip list map ADT.
+ */
+struct skip_list_map {
+    SlNode *head;               // The sentinel before the first node, as tall as MAX_LEVEL
+    int (*cmp)(void *, void *); // The key comparator
+    void (*keyDestructor)(void *);  // The key destructor
+    int levels;                 // The height of the tallest node ever inserted
+    long size __attribute__((aligned(CACHE_LINE)));    // The number of entries
+} __attribute__((aligned(CACHE_LINE)));
+
+// Seed of the calling thread's level generator
+static __thread unsigned long seed = 0UL;
+
+/**
+ * Picks the height of a new node, promoting it one level further with a probability of 1/4.
+ */
+static int _random_level(void) {
+
+    int level = 1;
+
+    if (seed == 0UL) {
+        seed = (unsigned long)&seed | 1UL;
+    }
+    seed ^= seed << 13;
+    seed ^= seed >> 7;
+    seed ^= seed << 17;
+    while (level < MAX_LEVEL && (seed >> (2 * level) & 3UL) == 0UL) {
+        level++;
+    }
+
+    return level;
+}
+
+/**
+ * Allocates a new node with `height` levels.
+ */
+static SlNode *_new_node(void *key, void *value, int height) {
+
+    SlNode *node = (SlNode *)malloc(sizeof(SlNode) + height * sizeof(SlNode *));
+    if (node != NULL) {
+        node->key = key;
+        node->value = value;
+        node->keyDestructor = NULL;
+        node->lock = 0;
+        node->marked = 0;
+        node->linked = 0;
+        node->height = height;
+    }
+
+    return node;
+}
+
+/**
+ * Reclaims a removed node, destroying its key first if the key was not handed to the caller.
+ */
+static void _reclaim_node(void *ptr) {
+
+    SlNode *node = (SlNode *)ptr;
+    if (node->keyDestructor != NULL) {
+        (*(node->keyDestructor))(node->key);
+    }
+    free(node);
+}
+
+/**
+ * Locks the node `node`, spinning briefly before yielding.
+ */
+static void _lock(SlNode *node) {
+
+    int spins = 0;
+    while (__atomic_exchange_n(&(node->lock), 1, __ATOMIC_ACQUIRE)) {
+        while (__atomic_load_n(&(node->lock), __ATOMIC_RELAXED)) {
+            if (++spins < SPIN_LIMIT) {
+                CPU_RELAX();
+            } else {
+                sched_yield();
+            }
+        }
+    }
+}
+
+/**
+ * Unlocks the node `node`.
+ */
+static void _unlock(SlNode *node) {
+    __atomic_store_n(&(node->lock), 0, __ATOMIC_RELEASE);
+}
+
+/**
+ * Unlocks the distinct predecessors on levels 0 to `highest`. A node is the predecessor on a run of
+ * consecutive levels, so each is unlocked once.
+ */
+static void _unlock_preds(SlNode **preds, int highest) {
+
+    SlNode *prev = NULL;
+    int level;
+
+    for (level = 0; level <= highest; level++) {
+        if (preds[level] != prev) {
+            _unlock(preds[level]);
+            prev = preds[level];
+        }
+    }
+}
+
+/**
+ * Returns TRUE if `node` is fully linked and not being removed, FALSE if not.
+ */
+static Boolean _is_live(SlNode *node) {
+    return ( __atomic_load_n(&(node->linked), __ATOMIC_ACQUIRE) &&
+             !__atomic_load_n(&(node->marked), __ATOMIC_ACQUIRE) ) ? TRUE : FALSE;
+}
+
+/**
+ * Searches for the key `key`, storing the last node before it and the first node not before it on
+ * each level into `preds` and `succs`. Returns the highest level on which a node with the key was
+ * found, or -1 if none was.
+ */
+static int _find(ConcurrentSkipListMap *map, void *key, SlNode **preds, SlNode **succs) {
+
+    SlNode *pred = map->head, *curr;
+    int top = __atomic_load_n(&(map->levels), __ATOMIC_ACQUIRE);
+    int found = -1, level, cmp;
+
+    for (level = MAX_LEVEL - 1; level >= top; level--) {
+        preds[level] = pred;
+        succs[level] = NULL;
+    }
+    for (level = top - 1; level >= 0; level--) {
+        curr = __atomic_load_n(&(pred->next[level]), __ATOMIC_ACQUIRE);
+        cmp = -1;
+        while (curr != NULL && (cmp = map->cmp(curr->key, key)) < 0) {
+            pred = curr;
+            curr = __atomic_load_n(&(pred->next[level]), __ATOMIC_ACQUIRE);
+        }
+        if (found == -1 && curr != NULL && cmp == 0) {
+            found = level;
+        }
+        preds[level] = pred;
+        succs[level] = curr;
+    }
+
+    return found;
+}
+
+/**
+ * Returns the last node whose key is less than `key` (or equal to it, if `inclusive` is TRUE), or
+ * the head if there is none. The node returned may have been removed since.
+ */
+static SlNode *_last_before(ConcurrentSkipListMap *map, void *key, Boolean inclusive) {
+
+    SlNode *pred = map->head, *curr;
+    int bound = ( inclusive == TRUE ) ? 1 : 0;
+    int level;
+
+    for (level = __atomic_load_n(&(map->levels), __ATOMIC_ACQUIRE) - 1; level >= 0; level--) {
+        curr = __atomic_load_n(&(pred->next[level]), __ATOMIC_ACQUIRE);
+        while (curr != NULL && map->cmp(curr->key, key) < bound) {
+            pred = curr;
+            curr = __atomic_load_n(&(pred->next[level]), __ATOMIC_ACQUIRE);
+        }
+    }
+
+    return pred;
+}
+
+/**
+ * Returns the first live node after `node` on the bottom level, or NULL if there is none.
+ */
+static SlNode *_next_live(SlNode *node) {
+
+    SlNode *curr = __atomic_load_n(&(node->next[0]), __ATOMIC_ACQUIRE);
+    while (curr != NULL && _is_live(curr) == FALSE) {
+        curr = __atomic_load_n(&(curr->next[0]), __ATOMIC_ACQUIRE);
+    }
+
+    return curr;
+}
+
+/**
+ * Returns the last live node whose key is less than `key` (or equal to it, if `inclusive` is
+ * TRUE), or NULL if there is none. A list cannot be walked backwards, so if the node found is
+ * being inserted or removed, the search waits for that to finish and starts over.
+ */
+static SlNode *_floor_node(ConcurrentSkipListMap *map, void *key, Boolean inclusive) {
+
+    SlNode *node;
+    while ((node = _last_before(map, key, inclusive)) != map->head && _is_live(node) == FALSE) {
+        CPU_RELAX();
+    }
+
+    return ( node == map->head ) ? NULL : node;
+}
+
+/**
+ * Returns the last live node in the map, or NULL if there is none, the same way as _floor_node().
+ */
+static SlNode *_last_node(ConcurrentSkipListMap *map) {
+
+    SlNode *pred, *curr;
+    int level;
+
+    while (TRUE) {
+        pred = map->head;
+        for (level = __atomic_load_n(&(map->levels), __ATOMIC_ACQUIRE) - 1; level >= 0; level--) {
+            while ((curr = __atomic_load_n(&(pred->next[level]), __ATOMIC_ACQUIRE)) != NULL) {
+                pred = curr;
+            }
+        }
+        if (pred == map->head) {
+            return NULL;
+        }
+        if (_is_live(pred) == TRUE) {
+            return pred;
+        }
+        CPU_RELAX();
+    }
+}
+
+/**
+ * Removes the node with the key `key`, storing its value into `*value`. If `target` is not NULL,
+ * only that node may be removed; if `handOver` is TRUE, the key is left to the caller instead of
+ * the key destructor. Must be called inside an epoch.
+ */
+static Status _remove(ConcurrentSkipListMap *map, void *key, SlNode *target, Boolean handOver,
+                      void **value) {
+
+    SlNode *preds[MAX_LEVEL], *succs[MAX_LEVEL];
+    SlNode *victim = NULL, *pred, *prev;
+    Boolean valid;
+    int found, level, highest;
+
+    while (TRUE) {
+        found = _find(map, key, preds, succs);
+
+        // Claims the node by marking it, unless it is not yet fully linked or already claimed
+        if (victim == NULL) {
+            if (found == -1) {
+                return NOT_FOUND;
+            }
+            victim = succs[found];
+            if ((target != NULL && victim != target) ||
+                    __atomic_load_n(&(victim->linked), __ATOMIC_ACQUIRE) == 0 ||
+                    victim->height - 1 != found ||
+                    __atomic_load_n(&(victim->marked), __ATOMIC_ACQUIRE) != 0) {
+                return NOT_FOUND;
+            }
+            _lock(victim);
+            if (victim->marked != 0) {
+                _unlock(victim);
+                return NOT_FOUND;
+            }
+            __atomic_store_n(&(victim->marked), 1, __ATOMIC_RELEASE);
+        }
+
+        // Locks the predecessors bottom-up, checking that each still points at the victim
+        highest = -1;
+        valid = TRUE;
+        prev = NULL;
+        for (level = 0; valid == TRUE && level < victim->height; level++) {
+            pred = preds[level];
+            if (pred != prev) {
+                _lock(pred);
+                highest = level;
+                prev = pred;
+            }
+            valid = ( __atomic_load_n(&(pred->marked), __ATOMIC_ACQUIRE) == 0 &&
+                      pred->next[level] == victim ) ? TRUE : FALSE;
+        }
+        if (valid == FALSE) {
+            _unlock_preds(preds, highest);
+            continue;
+        }
+
+        for (level = victim->height - 1; level >= 0; level--) {
+            __atomic_store_n(&(preds[level]->next[level]), victim->next[level], __ATOMIC_RELEASE);
+        }
+        *value = victim->value;
+        victim->keyDestructor = ( handOver == TRUE ) ? NULL : map->keyDestructor;
+        _unlock(victim);
+        _unlock_preds(preds, highest);
+        __atomic_fetch_sub(&(map->size), 1L, __ATOMIC_RELAXED);
+        epoch_retire(victim, _reclaim_node);
+
+        return OK;
+    }
+}
+
+/**
+ * Removes the node `node` found by a poll, handing its key and value over to the caller. Returns
+ * TRUE if this thread removed it, FALSE if another thread got there first.
+ */
+static Boolean _poll(ConcurrentSkipListMap *map, SlNode *node, void **key, void **value) {
+
+    if (_remove(map, node->key, node, TRUE, value) != OK) {
+        return FALSE;
+    }
+    *key = node->key;
+
+    return TRUE;
+}
+
+Status skiplistmap_new(ConcurrentSkipListMap **map, int (*keyComparator)(void *, void *),
+                       void (*keyDestructor)(void *)) {
+
+    ConcurrentSkipListMap *temp;
+    SlNode *head;
+    int level;
+
+    if (posix_memalign((void **)&temp, CACHE_LINE, sizeof(ConcurrentSkipListMap)) != 0) {
+        return ALLOC_FAILURE;
+    }
+    head = _new_node(NULL, NULL, MAX_LEVEL);
+    if (head == NULL) {
+        free(temp);
+        return ALLOC_FAILURE;
+    }
+    for (level = 0; level < MAX_LEVEL; level++) {
+        head->next[level] = NULL;
+    }
+    head->linked = 1;
+
+    temp->head = head;
+    temp->cmp = keyComparator;
+    temp->keyDestructor = keyDestructor;
+    temp->levels = 1;
+    temp->size = 0L;
+    *map = temp;
+
+    return OK;
+}
+
+Status skiplistmap_put(ConcurrentSkipListMap *map, void *key, void *value, void **previous) {
+
+    EpochRecord *record = epoch_acquire();
+    SlNode *preds[MAX_LEVEL], *succs[MAX_LEVEL];
+    SlNode *node, *pred, *succ, *prev;
+    Boolean valid;
+    int height = _random_level();
+    int levels, found, level, highest;
+
+    if (record == NULL) {
+        return ALLOC_FAILURE;
+    }
+
+    // Raises the height searched by every operation before the node can be linked that high
+    levels = __atomic_load_n(&(map->levels), __ATOMIC_RELAXED);
+    while (levels < height && !__atomic_compare_exchange_n(&(map->levels), &levels, height, TRUE,
+                                                           __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+        ;
+
+    epoch_enter(record);
+    while (TRUE) {
+        found = _find(map, key, preds, succs);
+
+        // Replaces the value of an existing node, unless it is being removed
+        if (found != -1) {
+            node = succs[found];
+            if (__atomic_load_n(&(node->marked), __ATOMIC_ACQUIRE) != 0) {
+                CPU_RELAX();
+                continue;
+            }
+            while (__atomic_load_n(&(node->linked), __ATOMIC_ACQUIRE) == 0) {
+                CPU_RELAX();
+            }
+            _lock(node);
+            if (node->marked != 0) {
+                _unlock(node);
+                continue;
+            }
+            *previous = node->value;
+            __atomic_store_n(&(node->value), value, __ATOMIC_RELEASE);
+            _unlock(node);
+            epoch_exit(record);
+            return REPLACED;
+        }
+
+        // Locks the predecessors bottom-up, checking that nothing was linked in between
+        highest = -1;
+        valid = TRUE;
+        prev = NULL;
+        for (level = 0; valid == TRUE && level < height; level++) {
+            pred = preds[level];
+            succ = succs[level];
+            if (pred != prev) {
+                _lock(pred);
+                highest = level;
+                prev = pred;
+            }
+            // The successor is not locked, so its mark may be set by a remover at any time
+            valid = ( __atomic_load_n(&(pred->marked), __ATOMIC_ACQUIRE) == 0 &&
+                      (succ == NULL || __atomic_load_n(&(succ->marked), __ATOMIC_ACQUIRE) == 0) &&
+                      pred->next[level] == succ ) ? TRUE : FALSE;
+        }
+        if (valid == FALSE) {
+            _unlock_preds(preds, highest);
+            continue;
+        }
+
+        node = _new_node(key, value, height);
+        if (node == NULL) {
+            _unlock_preds(preds, highest);
+            epoch_exit(record);
+            return ALLOC_FAILURE;
+        }
+        for (level = 0; level < height; level++) {
+            node->next[level] = succs[level];
+        }
+        for (level = 0; level < height; level++) {
+            __atomic_store_n(&(preds[level]->next[level]), node, __ATOMIC_RELEASE);
+        }
+        __atomic_store_n(&(node->linked), 1, __ATOMIC_RELEASE);
+        _unlock_preds(preds, highest);
+        __atomic_fetch_add(&(map->size), 1L, __ATOMIC_RELAXED);
+        epoch_exit(record);
+
+        return INSERTED;
+    }
+}
+
+Status skiplistmap_get(ConcurrentSkipListMap *map, void *key, void **value) {
+
+    EpochRecord *record = epoch_acquire();
+    SlNode *node;
+    Status status = NOT_FOUND;
+
+    if (record == NULL) {
+        return ALLOC_FAILURE;
+    }
+
+    epoch_enter(record);
+    node = _next_live(_last_before(map, key, FALSE));
+    if (node != NULL && map->cmp(node->key, key) == 0) {
+        *value = __atomic_load_n(&(node->value), __ATOMIC_ACQUIRE);
+        status = OK;
+    }
+    epoch_exit(record);
+
+    return status;
+}
+
+Boolean skiplistmap_containsKey(ConcurrentSkipListMap *map, void *key) {
+
+    void *value;
+    return ( skiplistmap_get(map, key, &value) == OK ) ? TRUE : FALSE;
+}
+
+Status skiplistmap_firstKey(ConcurrentSkipListMap *map, void **firstKey) {
+
+    void *value;
+    return skiplistmap_first(map, firstKey, &value);
+}
+
+Status skiplistmap_first(ConcurrentSkipListMap *map, void **firstKey, void **firstValue) {
+
+    EpochRecord *record = epoch_acquire();
+    SlNode *node;
+
+    if (record == NULL) {
+        return ALLOC_FAILURE;
+    }
+
+    epoch_enter(record);
+    node = _next_live(map->head);
+    if (node != NULL) {
+        *firstKey = node->key;
+        *firstValue = __atomic_load_n(&(node->value), __ATOMIC_ACQUIRE);
+    }
+    epoch_exit(record);
+
+    return ( node != NULL ) ? OK : STRUCT_EMPTY;
+}
+
+Status skiplistmap_lastKey(ConcurrentSkipListMap *map, void **lastKey) {
+
+    void *value;
+    return skiplistmap_last(map, lastKey, &value);
+}
+
+Status skiplistmap_last(ConcurrentSkipListMap *map, void **lastKey, void **lastValue) {
+
+    EpochRecord *record = epoch_acquire();
+    SlNode *node;
+
+    if (record == NULL) {
+        return ALLOC_FAILURE;
+    }
+
+    epoch_enter(record);
+    node = _last_node(map);
+    if (node != NULL) {
+        *lastKey = node->key;
+        *lastValue = __atomic_load_n(&(node->value), __ATOMIC_ACQUIRE);
+    }
+    epoch_exit(record);
+
+    return ( node != NULL ) ? OK : STRUCT_EMPTY;
+}
+
+Status skiplistmap_floorKey(ConcurrentSkipListMap *map, void *key, void **floorKey) {
+
+    void *value;
+    return skiplistmap_floor(map, key, floorKey, &value);
+}
+
+Status skiplistmap_floor(ConcurrentSkipListMap *map, void *key, void **floorKey,
+                         void **floorValue) {
+
+    EpochRecord *record = epoch_acquire();
+    SlNode *node;
+
+    if (record == NULL) {
+        return ALLOC_FAILURE;
+    }
+
+    epoch_enter(record);
+    node = _floor_node(map, key, TRUE);
+    if (node != NULL) {
+        *floorKey = node->key;
+        *floorValue = __atomic_load_n(&(node->value), __ATOMIC_ACQUIRE);
+    }
+    epoch_exit(record);
+
+    return ( node != NULL ) ? OK : NOT_FOUND;
+}
+
+Status skiplistmap_ceilingKey(ConcurrentSkipListMap *map, void *key, void **ceilingKey) {
+
+    void *value;
+    return skiplistmap_ceiling(map, key, ceilingKey, &value);
+}
+
+Status skiplistmap_ceiling(ConcurrentSkipListMap *map, void *key, void **ceilingKey,
+                           void **ceilingValue) {
+
+    EpochRecord *record = epoch_acquire();
+    SlNode *node;
+
+    if (record == NULL) {
+        return ALLOC_FAILURE;
+    }
+
+    epoch_enter(record);
+    node = _next_live(_last_before(map, key, FALSE));
+    if (node != NULL) {
+        *ceilingKey = node->key;
+        *ceilingValue = __atomic_load_n(&(node->value), __ATOMIC_ACQUIRE);
+    }
+    epoch_exit(record);
+
+    return ( node != NULL ) ? OK : NOT_FOUND;
+}
+
+Status skiplistmap_lowerKey(ConcurrentSkipListMap *map, void *key, void **lowerKey) {
+
+    void *value;
+    return skiplistmap_lower(map, key, lowerKey, &value);
+}
+
+Status skiplistmap_lower(ConcurrentSkipListMap *map, void *key, void **lowerKey,
+                         void **lowerValue) {
+
+    EpochRecord *record = epoch_acquire();
+    SlNode *node;
+
+    if (record == NULL) {
+        return ALLOC_FAILURE;
+    }
+
+    epoch_enter(record);
+    node = _floor_node(map, key, FALSE);
+    if (node != NULL) {
+        *lowerKey = node->key;
+        *lowerValue = __atomic_load_n(&(node->value), __ATOMIC_ACQUIRE);
+    }
+    epoch_exit(record);
+
+    return ( node != NULL ) ? OK : NOT_FOUND;
+}
+
+Status skiplistmap_higherKey(ConcurrentSkipListMap *map, void *key, void **higherKey) {
+
+    void *value;
+    return skiplistmap_higher(map, key, higherKey, &value);
+}
+
+Status skiplistmap_higher(ConcurrentSkipListMap *map, void *key, void **higherKey,
+                          void **higherValue) {
+
+    EpochRecord *record = epoch_acquire();
+    SlNode *node;
+
+    if (record == NULL) {
+        return ALLOC_FAILURE;
+    }
+
+    epoch_enter(record);
+    node = _next_live(_last_before(map, key, TRUE));
+    if (node != NULL) {
+        *higherKey = node->key;
+        *higherValue = __atomic_load_n(&(node->value), __ATOMIC_ACQUIRE);
+    }
+    epoch_exit(record);
+
+    return ( node != NULL ) ? OK : NOT_FOUND;
+}
+
+Status skiplistmap_pollFirst(ConcurrentSkipListMap *map, void **firstKey, void **firstValue) {
+
+    EpochRecord *record = epoch_acquire();
+    SlNode *node;
+
+    if (record == NULL) {
+        return ALLOC_FAILURE;
+    }
+
+    // Retries until it removes a first node itself, or finds the map empty
+    epoch_enter(record);
+    while ((node = _next_live(map->head)) != NULL &&
+            _poll(map, node, firstKey, firstValue) == FALSE)
+        ;
+    epoch_exit(record);
+
+    return ( node != NULL ) ? OK : STRUCT_EMPTY;
+}
+
+Status skiplistmap_pollLast(ConcurrentSkipListMap *map, void **lastKey, void **lastValue) {
+
+    EpochRecord *record = epoch_acquire();
+    SlNode *node;
+
+    if (record == NULL) {
+        return ALLOC_FAILURE;
+    }
+
+    epoch_enter(record);
+    while ((node = _last_node(map)) != NULL && _poll(map, node, lastKey, lastValue) == FALSE)
+        ;
+    epoch_exit(record);
+
+    return ( node != NULL ) ? OK : STRUCT_EMPTY;
+}
+
+Status skiplistmap_remove(ConcurrentSkipListMap *map, void *key, void **value) {
+
+    EpochRecord *record = epoch_acquire();
+    Status status;
+
+    if (record == NULL) {
+        return ALLOC_FAILURE;
+    }
+
+    epoch_enter(record);
+    status = _remove(map, key, NULL, FALSE, value);
+    epoch_exit(record);
+
+    return status;
+}
+
+long skiplistmap_size(ConcurrentSkipListMap *map) {
+    return __atomic_load_n(&(map->size), __ATOMIC_RELAXED);
+}
+
+Boolean skiplistmap_isEmpty(ConcurrentSkipListMap *map) {
+    return ( skiplistmap_size(map) == 0L ) ? TRUE : FALSE;
+}
+
+void skiplistmap_destroy(ConcurrentSkipListMap *map, void (*valueDestructor)(void *)) {
+
+    SlNode *node = map->head->next[0], *next;
+
+    while (node != NULL) {
+        next = node->next[0];
+        if (map->keyDestructor != NULL) {
+            (*(map->keyDestructor))(node->key);
+        }
+        if (valueDestructor != NULL) {
+            (*valueDestructor)(node->value);
+        }
+        free(node);
+        node = next;
+    }
+    free(map->head);
+    free(map);
+}
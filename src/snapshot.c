@@ -0,0 +1,493 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2020 Cole Vikupitz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "hashing.h"
+#include "snapshot.h"
+
+// Identifies a snapshot, and the version of its format
+#define MAGIC "CDSSNAP"
+#define VERSION 1U
+// Header flag set when the records are in ascending key order
+#define FLAG_SORTED 1U
+
+// The size of the writer's output buffer
+#define BUFFER_SIZE 1048576L
+#define RECORD_INIT_CAPACITY 256L
+#define OFFSETS_INIT_CAPACITY 1024L
+
+// Rounds `n` up to the next multiple of 8
+#define ALIGN8(n) ( ((n) + 7L) & ~7L )
+
+/**
+ * The header at the start of every snapshot. All positions are relative to the header's start.
+ */
+typedef struct {
+    char magic[8];              // MAGIC, null-terminated
+    uint32_t version;           // VERSION, which also tells the byte order apart
+    uint32_t flags;             // FLAG_SORTED, or 0
+    uint64_t count;             // The number of records
+    uint64_t seed;              // The seed the key bytes are hashed with
+    uint64_t slots;             // The number of slots in the hash index, a power of two
+    uint64_t offsetsPos;        // The position of the offset table
+    uint64_t indexPos;          // The position of the hash index
+    uint64_t length;            // The length of the whole snapshot
+} Header;
+
+/**
+ * A record's lengths, followed by its key and value bytes, each padded to 8 bytes.
+ */
+typedef struct {
+    uint64_t keyLen;            // The length of the key bytes
+    uint64_t valueLen;          // The length of the value bytes
+} RecordHeader;
+
+/**
+ * A slot of the hash index.
+ */
+typedef struct {
+    uint64_t hash;              // The hash of the record's key bytes
+    uint64_t record;            // The record's index plus one, 0 if the slot is empty
+} Slot;
+
+/**
+ * Struct for the snapshot writer.
+ */
+struct snapshot_writer {
+    int fd;                                         // The file being written
+    off_t base;                                     // The file offset of the snapshot's header
+    uint64_t position;                              // The position of the next record
+    long (*keySer)(void *, void *, long);           // The key serializer
+    long (*valueSer)(void *, void *, long);         // The value serializer
+    uint32_t flags;                                 // The header flags
+    uint64_t seed;                                  // The seed the key bytes are hashed with
+    char *buffer;                                   // Output not yet written to the file
+    long len;                                       // The number of bytes in `buffer`
+    char *record;                                   // The record being serialized
+    long recordCap;                                 // The capacity of `record`
+    uint64_t *offsets;                              // The position of each record
+    uint64_t *hashes;                               // The hash of each record's key bytes
+    long count;                                     // The number of records
+    long offsetsCap;                                // The capacity of `offsets` and `hashes`
+    Status status;                                  // The first failure, sticky, or OK
+};
+
+/**
+ * Struct for a mapped snapshot.
+ */
+struct snapshot {
+    char *area;                 // The mapping, from the start of the file
+    size_t mapped;              // The length of the mapping
+    const char *base;           // The snapshot's header within the mapping
+    const Header *header;       // The header
+    const uint64_t *offsets;    // The offset table
+    const Slot *index;          // The hash index
+};
+
+/**
+ * Writes all `len` bytes of `data` to `fd` at its current offset, retrying after partial writes.
+ */
+static Boolean _write_all(int fd, const char *data, long len) {
+
+    ssize_t n;
+
+    while (len > 0L) {
+        n = write(fd, data, (size_t)len);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return FALSE;
+        }
+        data += n;
+        len -= (long)n;
+    }
+
+    return TRUE;
+}
+
+/**
+ * Appends the `len` bytes at `data` to the writer's output, flushing the buffered output first if
+ * they do not fit, and bypassing the buffer altogether if they never would.
+ */
+static Status _append(SnapshotWriter *writer, const char *data, long len) {
+
+    if (writer->len + len > BUFFER_SIZE) {
+        if (_write_all(writer->fd, writer->buffer, writer->len) == FALSE) {
+            return IO_FAILURE;
+        }
+        writer->len = 0L;
+    }
+    if (len > BUFFER_SIZE) {
+        return ( _write_all(writer->fd, data, len) == TRUE ) ? OK : IO_FAILURE;
+    }
+    memcpy(writer->buffer + writer->len, data, len);
+    writer->len += len;
+
+    return OK;
+}
+
+/**
+ * Makes room for `n` bytes in the writer's record buffer.
+ */
+static Status _reserve_record(SnapshotWriter *writer, long n) {
+
+    char *record;
+    long cap = writer->recordCap;
+
+    if (n <= cap) {
+        return OK;
+    }
+    while (cap < n) {
+        cap *= 2L;
+    }
+    record = (char *)realloc(writer->record, cap);
+    if (record == NULL) {
+        return ALLOC_FAILURE;
+    }
+    writer->record = record;
+    writer->recordCap = cap;
+
+    return OK;
+}
+
+/**
+ * Serializes `item` with `serializer` into the writer's record buffer at `at`, padded to 8 bytes
+ * with zeros, and stores its unpadded length into `*len`.
+ */
+static Status _serialize(SnapshotWriter *writer, long (*serializer)(void *, void *, long),
+                         void *item, long at, long *len) {
+
+    long n = serializer(item, writer->record + at, writer->recordCap - at);
+
+    // Retries once the buffer has room for the whole item, padding included
+    if (at + ALIGN8(n) > writer->recordCap) {
+        if (_reserve_record(writer, at + ALIGN8(n)) != OK) {
+            return ALLOC_FAILURE;
+        }
+        n = serializer(item, writer->record + at, writer->recordCap - at);
+    }
+    memset(writer->record + at + n, 0, ALIGN8(n) - n);
+    *len = n;
+
+    return OK;
+}
+
+Status snapshot_writerNew(SnapshotWriter **writer, int fd,
+                          long (*keySerializer)(void *, void *, long),
+                          long (*valueSerializer)(void *, void *, long), Boolean sorted) {
+
+    SnapshotWriter *temp;
+    Header header;
+    off_t base;
+
+    if ((base = lseek(fd, 0, SEEK_CUR)) < 0) {
+        return IO_FAILURE;
+    }
+    temp = (SnapshotWriter *)malloc(sizeof(SnapshotWriter));
+    if (temp == NULL) {
+        return ALLOC_FAILURE;
+    }
+    temp->buffer = (char *)malloc(BUFFER_SIZE);
+    temp->record = (char *)malloc(RECORD_INIT_CAPACITY);
+    temp->offsets = (uint64_t *)malloc(OFFSETS_INIT_CAPACITY * sizeof(uint64_t));
+    temp->hashes = (uint64_t *)malloc(OFFSETS_INIT_CAPACITY * sizeof(uint64_t));
+    if (temp->buffer == NULL || temp->record == NULL || temp->offsets == NULL ||
+            temp->hashes == NULL) {
+        free(temp->buffer);
+        free(temp->record);
+        free(temp->offsets);
+        free(temp->hashes);
+        free(temp);
+        return ALLOC_FAILURE;
+    }
+
+    temp->fd = fd;
+    temp->base = base;
+    temp->position = sizeof(Header);
+    temp->keySer = keySerializer;
+    temp->valueSer = valueSerializer;
+    temp->flags = ( sorted == TRUE ) ? FLAG_SORTED : 0U;
+    temp->seed = hashing_seed();
+    temp->len = 0L;
+    temp->recordCap = RECORD_INIT_CAPACITY;
+    temp->count = 0L;
+    temp->offsetsCap = OFFSETS_INIT_CAPACITY;
+
+    // Leaves a blank header in place, filled in once the snapshot is finished
+    memset(&header, 0, sizeof(Header));
+    temp->status = _append(temp, (const char *)&header, (long)sizeof(Header));
+    *writer = temp;
+
+    return OK;
+}
+
+Status snapshot_writerAdd(SnapshotWriter *writer, void *key, void *value) {
+
+    RecordHeader *record;
+    uint64_t *offsets, *hashes;
+    long at = (long)sizeof(RecordHeader), keyLen, valueLen, cap;
+
+    if (writer->status != OK) {
+        return writer->status;
+    }
+
+    // Grows the offset table along with the records
+    if (writer->count == writer->offsetsCap) {
+        cap = writer->offsetsCap * 2L;
+        offsets = (uint64_t *)realloc(writer->offsets, cap * sizeof(uint64_t));
+        if (offsets != NULL) {
+            writer->offsets = offsets;
+        }
+        hashes = (uint64_t *)realloc(writer->hashes, cap * sizeof(uint64_t));
+        if (hashes != NULL) {
+            writer->hashes = hashes;
+        }
+        if (offsets == NULL || hashes == NULL) {
+            return writer->status = ALLOC_FAILURE;
+        }
+        writer->offsetsCap = cap;
+    }
+
+    // Builds the whole record before appending it to the output
+    if ((writer->status = _serialize(writer, writer->keySer, key, at, &keyLen)) != OK) {
+        return writer->status;
+    }
+    at += ALIGN8(keyLen);
+    if ((writer->status = _serialize(writer, writer->valueSer, value, at, &valueLen)) != OK) {
+        return writer->status;
+    }
+    at += ALIGN8(valueLen);
+    record = (RecordHeader *)writer->record;
+    record->keyLen = (uint64_t)keyLen;
+    record->valueLen = (uint64_t)valueLen;
+    if ((writer->status = _append(writer, writer->record, at)) != OK) {
+        return writer->status;
+    }
+
+    writer->hashes[writer->count] = hashing_bytes(writer->record + sizeof(RecordHeader), keyLen,
+                                                  writer->seed);
+    writer->offsets[writer->count++] = writer->position;
+    writer->position += (uint64_t)at;
+
+    return OK;
+}
+
+/**
+ * Frees the writer `writer`.
+ */
+static void _free_writer(SnapshotWriter *writer) {
+    free(writer->buffer);
+    free(writer->record);
+    free(writer->offsets);
+    free(writer->hashes);
+    free(writer);
+}
+
+Status snapshot_writerFinish(SnapshotWriter *writer) {
+
+    Status status = writer->status;
+    Header header;
+    Slot *index = NULL;
+    uint64_t slots = 1UL, mask, i, j;
+
+    // Sizes the hash index to at most half full, so probe sequences stay short
+    while (slots < 2UL * (uint64_t)writer->count) {
+        slots *= 2UL;
+    }
+    if (status == OK && (index = (Slot *)calloc(slots, sizeof(Slot))) == NULL) {
+        status = ALLOC_FAILURE;
+    }
+    if (status == OK) {
+        mask = slots - 1UL;
+        for (i = 0UL; i < (uint64_t)writer->count; i++) {
+            for (j = writer->hashes[i] & mask; index[j].record != 0UL; j = (j + 1UL) & mask)
+                ;
+            index[j].hash = writer->hashes[i];
+            index[j].record = i + 1UL;
+        }
+
+        memcpy(header.magic, MAGIC, sizeof(header.magic));
+        header.version = VERSION;
+        header.flags = writer->flags;
+        header.count = (uint64_t)writer->count;
+        header.seed = writer->seed;
+        header.slots = slots;
+        header.offsetsPos = writer->position;
+        header.indexPos = header.offsetsPos + writer->count * sizeof(uint64_t);
+        header.length = header.indexPos + slots * sizeof(Slot);
+
+        // The header goes in last, so an unfinished snapshot never passes as a complete one
+        if (_append(writer, (const char *)writer->offsets,
+                    writer->count * (long)sizeof(uint64_t)) != OK ||
+                _append(writer, (const char *)index, (long)(slots * sizeof(Slot))) != OK ||
+                _write_all(writer->fd, writer->buffer, writer->len) == FALSE ||
+                pwrite(writer->fd, &header, sizeof(Header), writer->base) !=
+                (ssize_t)sizeof(Header)) {
+            status = IO_FAILURE;
+        }
+    }
+    free(index);
+    _free_writer(writer);
+
+    return status;
+}
+
+/**
+ * Fetches the `i`-th record of the snapshot, checking that it lies within the snapshot. Returns
+ * FALSE if it does not.
+ */
+static Boolean _record(Snapshot *snapshot, uint64_t i, const void **key, long *keyLen,
+                       const void **value, long *valueLen) {
+
+    uint64_t length = snapshot->header->length, offset = snapshot->offsets[i];
+    const RecordHeader *record;
+
+    if (offset % 8UL != 0UL || offset > length - sizeof(RecordHeader)) {
+        return FALSE;
+    }
+    record = (const RecordHeader *)(snapshot->base + offset);
+    offset += sizeof(RecordHeader);
+    if (record->keyLen > length - offset ||
+            record->valueLen > length - offset - ALIGN8(record->keyLen) ||
+            ALIGN8(record->keyLen) > length - offset) {
+        return FALSE;
+    }
+    *key = snapshot->base + offset;
+    *keyLen = (long)record->keyLen;
+    *value = snapshot->base + offset + ALIGN8(record->keyLen);
+    *valueLen = (long)record->valueLen;
+
+    return TRUE;
+}
+
+Status snapshot_open(Snapshot **snapshot, int fd) {
+
+    Snapshot *temp;
+    struct stat info;
+    const Header *header;
+    off_t base;
+    uint64_t available;
+
+    if ((base = lseek(fd, 0, SEEK_CUR)) < 0 || fstat(fd, &info) != 0) {
+        return IO_FAILURE;
+    }
+    if (S_ISREG(info.st_mode) == 0 || info.st_size < base + (off_t)sizeof(Header)) {
+        errno = EINVAL;
+        return IO_FAILURE;
+    }
+    temp = (Snapshot *)malloc(sizeof(Snapshot));
+    if (temp == NULL) {
+        return ALLOC_FAILURE;
+    }
+
+    // Maps the file from its start, which is always page aligned, and hints that it will be read
+    temp->mapped = (size_t)info.st_size;
+    temp->area = (char *)mmap(NULL, temp->mapped, PROT_READ, MAP_SHARED, fd, 0);
+    if (temp->area == MAP_FAILED) {
+        free(temp);
+        return IO_FAILURE;
+    }
+    (void)madvise(temp->area, temp->mapped, MADV_WILLNEED);
+
+    // Checks that the header is complete and everything it points to lies within the file
+    temp->base = temp->area + base;
+    header = (const Header *)temp->base;
+    available = (uint64_t)(info.st_size - base);
+    if (base % 8 != 0 || memcmp(header->magic, MAGIC, sizeof(header->magic)) != 0 ||
+            header->version != VERSION || header->length > available ||
+            header->slots == 0UL || (header->slots & (header->slots - 1UL)) != 0UL ||
+            header->count >= header->slots || header->offsetsPos % 8UL != 0UL ||
+            header->offsetsPos > header->length ||
+            header->count > (header->length - header->offsetsPos) / sizeof(uint64_t) ||
+            header->indexPos != header->offsetsPos + header->count * sizeof(uint64_t) ||
+            header->slots > (header->length - header->indexPos) / sizeof(Slot)) {
+        munmap(temp->area, temp->mapped);
+        free(temp);
+        errno = EINVAL;
+        return IO_FAILURE;
+    }
+    temp->header = header;
+    temp->offsets = (const uint64_t *)(temp->base + header->offsetsPos);
+    temp->index = (const Slot *)(temp->base + header->indexPos);
+    *snapshot = temp;
+
+    return OK;
+}
+
+long snapshot_size(Snapshot *snapshot) {
+    return (long)snapshot->header->count;
+}
+
+Boolean snapshot_isSorted(Snapshot *snapshot) {
+    return ( (snapshot->header->flags & FLAG_SORTED) != 0U ) ? TRUE : FALSE;
+}
+
+Status snapshot_get(Snapshot *snapshot, const void *key, long keyLen, const void **value,
+                    long *valueLen) {
+
+    uint64_t hash = hashing_bytes(key, keyLen, snapshot->header->seed);
+    uint64_t mask = snapshot->header->slots - 1UL, i, n, record;
+    const void *found;
+    long foundLen;
+
+    // Probes linearly from the key's slot until an empty slot, which a written index always has;
+    // a damaged one may not, so the probe never visits more slots than the index holds
+    i = hash & mask;
+    for (n = 0UL; n < snapshot->header->slots && (record = snapshot->index[i].record) != 0UL; n++) {
+        if (snapshot->index[i].hash == hash && record <= snapshot->header->count &&
+                _record(snapshot, record - 1UL, &found, &foundLen, value, valueLen) == TRUE &&
+                foundLen == keyLen && memcmp(found, key, keyLen) == 0) {
+            return OK;
+        }
+        i = (i + 1UL) & mask;
+    }
+
+    return NOT_FOUND;
+}
+
+Status snapshot_entry(Snapshot *snapshot, long i, const void **key, long *keyLen,
+                      const void **value, long *valueLen) {
+
+    if (i < 0L || i >= (long)snapshot->header->count) {
+        return INVALID_INDEX;
+    }
+    if (_record(snapshot, (uint64_t)i, key, keyLen, value, valueLen) == FALSE) {
+        errno = EINVAL;
+        return IO_FAILURE;
+    }
+
+    return OK;
+}
+
+void snapshot_close(Snapshot *snapshot) {
+    munmap(snapshot->area, snapshot->mapped);
+    free(snapshot);
+}
@@ -39,31 +39,65 @@ typedef struct node {
 struct stack {
     Node *top;              // Pointer to the top element of the stack
     long size;              // The stack's current size
+    NodePool *pool;         // Allocates the nodes
+    Boolean ownsPool;       // TRUE if `pool` is private to the stack
+    const CdsAllocator *allocator;  // Allocates the struct and, if private, the pool
+    long modCount;          // Number of structural modifications made
 };
 
-Status stack_new(Stack **stack) {
+/**
+ * Helper method to create a new stack whose nodes come from `pool`, or from a private pool
+ * allocated through `allocator` if NULL (the default allocator, if also NULL).
+ */
+static Status _new_stack(Stack **stack, NodePool *pool, const CdsAllocator *allocator) {
+
+    if (allocator == NULL) {
+        allocator = allocator_default();
+    }
 
     // Allocates the struct, check for allocation failure
-    Stack *temp = (Stack *)malloc(sizeof(Stack));
+    Stack *temp = (Stack *)allocator_alloc(allocator, sizeof(Stack));
     if (temp == NULL) {
         return ALLOC_FAILURE;
     }
 
+    // Creates a private pool for the nodes unless one was provided
+    temp->ownsPool = ( pool == NULL ) ? TRUE : FALSE;
+    if (pool == NULL && nodepool_newWithAllocator(&pool, 0L, allocator) != OK) {
+        allocator_free(allocator, temp);
+        return ALLOC_FAILURE;
+    }
+    temp->pool = pool;
+    temp->allocator = allocator;
+
     // Initializes the stack's struct members
     temp->top = NULL;
     temp->size = 0L;
+    temp->modCount = 0L;
     *stack = temp;
 
     return OK;
 }
 
+Status stack_newWithPool(Stack **stack, NodePool *pool) {
+    return _new_stack(stack, pool, NULL);
+}
+
+Status stack_newWithAllocator(Stack **stack, const CdsAllocator *allocator) {
+    return _new_stack(stack, NULL, allocator);
+}
+
+Status stack_new(Stack **stack) {
+    return stack_newWithPool(stack, NULL);
+}
+
 // Macro to check if the stack `s` is currently empty
 #define IS_EMPTY(s)  ( ((s)->size == 0L) ? TRUE : FALSE )
 
 Status stack_push(Stack *stack, void *item) {
 
     // Generate node for pushing item
-    Node *node = (Node *)malloc(sizeof(Node));
+    Node *node = (Node *)nodepool_alloc(stack->pool, sizeof(Node));
     if (node == NULL) {
         return ALLOC_FAILURE;
     }
@@ -73,6 +107,40 @@ Status stack_push(Stack *stack, void *item) {
     node->data = item;
     stack->top = node;
     stack->size++;
+    stack->modCount++;
+
+    return OK;
+}
+
+Status stack_pushAll(Stack *stack, void **items, long n) {
+
+    Node *top = stack->top, *node;
+    long i;
+
+    if (n < 0L) {
+        return INVALID_INDEX;
+    }
+
+    // Builds the new top of the stack on its own, so the stack is left untouched on failure
+    for (i = 0L; i < n; i++) {
+        node = (Node *)nodepool_alloc(stack->pool, sizeof(Node));
+        if (node == NULL) {
+            while (top != stack->top) {
+                node = top->next;
+                nodepool_free(stack->pool, top, sizeof(Node));
+                top = node;
+            }
+            return ALLOC_FAILURE;
+        }
+        node->next = top;
+        node->data = items[i];
+        top = node;
+    }
+
+    // Publishes the whole batch at once
+    stack->top = top;
+    stack->size += n;
+    stack->modCount++;
 
     return OK;
 }
@@ -101,12 +169,35 @@ Status stack_pop(Stack *stack, void **top) {
     stack->top = temp->next;
     *top = temp->data;
     // Free the allocated node
-    free(temp);
+    nodepool_free(stack->pool, temp, sizeof(Node));
     stack->size--;
+    stack->modCount++;
 
     return OK;
 }
 
+long stack_popMany(Stack *stack, void **items, long max) {
+
+    Node *temp;
+    long i, popped = ( max < stack->size ) ? max : stack->size;
+
+    if (popped <= 0L) {
+        return 0L;
+    }
+
+    // Unlinks the nodes one by one, but updates the stack's attributes only once
+    for (i = 0L; i < popped; i++) {
+        temp = stack->top;
+        stack->top = temp->next;
+        items[i] = temp->data;
+        nodepool_free(stack->pool, temp, sizeof(Node));
+    }
+    stack->size -= popped;
+    stack->modCount++;
+
+    return popped;
+}
+
 /**
  * Helper method to clear out the stack `stack` of all its elements, applying the destructor method
  * `destructor` on each element (or if NULL, nothing will be done to the elements).
@@ -116,21 +207,33 @@ static void _clear_stack(Stack *stack, void (*destructor)(void *)) {
     Node *curr = stack->top, *next = NULL;
     long i;
 
+    // A private pool releases every node at once, so nodes are only visited for the destructor
+    if (stack->ownsPool == TRUE && destructor == NULL) {
+        nodepool_reset(stack->pool);
+        return;
+    }
+
     for (i = 0L; i < stack->size; i++) {
         next = curr->next;
         // Free all allocated memory
         if (destructor != NULL) {
             (*destructor)(curr->data);
         }
-        free(curr);
+        if (stack->ownsPool == FALSE) {
+            nodepool_free(stack->pool, curr, sizeof(Node));
+        }
         curr = next;
     }
+    if (stack->ownsPool == TRUE) {
+        nodepool_reset(stack->pool);
+    }
 }
 
 void stack_clear(Stack *stack, void (*destructor)(void *)) {
     _clear_stack(stack, destructor);
     stack->top = NULL;
     stack->size = 0L;
+    stack->modCount++;
 }
 
 long stack_size(Stack *stack) {
@@ -221,7 +324,62 @@ Status stack_iterator(Stack *stack, Iterator **iter) {
     return OK;
 }
 
+void stack_cursor(Stack *stack, Cursor *cursor) {
+    cursor->adt = stack;
+    cursor->node = stack->top;
+    cursor->index = 0L;
+    cursor->remaining = stack->size;
+    cursor->modCount = stack->modCount;
+}
+
+Status stack_cursorNext(Cursor *cursor, void **next) {
+
+    Stack *stack = (Stack *)cursor->adt;
+    Node *node = (Node *)cursor->node;
+
+    // Fails fast if the stack was modified since creating the cursor
+    if (stack->modCount != cursor->modCount) {
+        return CONCURRENT_MODIFICATION;
+    }
+    // Checks if every element was visited
+    if (cursor->remaining == 0L) {
+        return ITER_END;
+    }
+
+    // Fetches the item, advances to the next node
+    *next = node->data;
+    cursor->node = node->next;
+    cursor->remaining--;
+
+    return OK;
+}
+
+Boolean stack_forEach(Stack *stack, Boolean (*action)(void *, void *), void *context) {
+
+    Node *node;
+
+    for (node = stack->top; node != NULL; node = node->next) {
+        if ((*action)(node->data, context) == FALSE) {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+long stack_memoryUsage(Stack *stack) {
+
+    // A private pool is charged in full, a shared one only for the nodes in use
+    long nodes = ( stack->ownsPool == TRUE ) ? nodepool_memoryUsage(stack->pool)
+                                             : stack->size * (long)sizeof(Node);
+
+    return (long)sizeof(Stack) + nodes;
+}
+
 void stack_destroy(Stack *stack, void (*destructor)(void *)) {
     _clear_stack(stack, destructor);
-    free(stack);
+    if (stack->ownsPool == TRUE) {
+        nodepool_destroy(stack->pool);
+    }
+    allocator_free(stack->allocator, stack);
 }
@@ -22,18 +22,57 @@
  * SOFTWARE.
  */
 
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <limits.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 #include "string_builder.h"
 
+// The number of characters held by each chunk of a rope-backed builder
+#define ROPE_CHUNK 512L
+
+/**
+ * A chunk of a rope-backed builder. The chunks form a treap ordered by their position in the text,
+ * where every node also stores the number of characters in its subtree; the chunks are linked
+ * together in order as well, so that they may be walked without going through the tree.
+ */
+typedef struct rope_node {
+    struct rope_node *left;     // The subtree of the chunks before this one
+    struct rope_node *right;    // The subtree of the chunks after this one
+    struct rope_node *prev;     // The chunk right before this one in the text
+    struct rope_node *next;     // The chunk right after this one in the text
+    long size;                  // The total number of characters in this subtree
+    long len;                   // The number of characters held by this chunk
+    uint32_t priority;          // Random heap priority that keeps the treap balanced
+    char text[ROPE_CHUNK];      // The chunk's characters, not null-terminated
+} RopeNode;
+
 struct string_builder {
     char *str;              // The inner string builder
     long index;             // Index of the next character to add, same as current size
     long capacity;          // The builder's current capacity (including the null terminator)
     float growthFactor;     // The growth factor to apply when expanding builder capacity
+    Boolean chunked;        // TRUE if the characters are held by the rope instead of `str`
+    RopeNode *rope;         // Root of the tree of chunks if chunked, NULL when empty
+    uint64_t seed;          // State for drawing the rope chunks' priorities
+    long mapped;            // Size of the mapping that holds `str` if mapped from a file, else 0
+    const CdsAllocator *allocator;  // Allocates the struct, the heap buffer and the rope chunks
+    char small[48];         // Holds the characters in place of a heap buffer while they fit
 };
 
+// The largest capacity held in the builder's own buffer before moving to the heap
+#define INLINE_CAPACITY ( (long)sizeof(((StringBuilder *)0)->small) - 1L )
+
 // The default capacity to assign when the capacity give is invalid
 #define DEFAULT_CAPACITY 16L
 // The maximum capacity allowed (to avoid builder overflow)
@@ -57,10 +96,7 @@ struct string_builder {
  * Local method to compute the length of the specified string `str`.
  */
 static int _get_str_length(char *str) {
-
-    char *ch;
-    for (ch = str; *ch != '\0'; ch++); // Navigate to end of string
-    return ch - str;
+    return (int)strlen(str);
 }
 
 /**
@@ -72,22 +108,48 @@ static Boolean _ensure_capacity(StringBuilder *builder, long newCapacity) {
 
     Boolean expanding = newCapacity > builder->capacity ? TRUE : FALSE;
     size_t bytes = ( ( newCapacity + 1 ) * sizeof(char) );
+    long keep = ( builder->index < newCapacity ) ? builder->index : newCapacity;
     char *temp;
 
-    // Attempts to reallocate the builder, returning false if fails
-    if ((temp = (char *)realloc(builder->str, bytes)) == NULL) {
-        return FALSE;
+    if (builder->str == builder->small) {
+        if (newCapacity <= INLINE_CAPACITY) {
+            // Still fits in the builder's own buffer, nothing to allocate
+            temp = builder->small;
+        } else {
+            // Outgrew the builder's own buffer, so the characters are moved over to the heap
+            if ((temp = (char *)allocator_alloc(builder->allocator, bytes)) == NULL) {
+                return FALSE;
+            }
+            memcpy(temp, builder->small, keep * sizeof(char));
+            temp[keep] = '\0';
+        }
+    } else if (builder->mapped > 0L) {
+        // A mapped file can't be resized, so its characters are moved over to the heap first
+        if ((temp = (char *)allocator_alloc(builder->allocator, bytes)) == NULL) {
+            return FALSE;
+        }
+        memcpy(temp, builder->str, keep * sizeof(char));
+        temp[keep] = '\0';
+        munmap(builder->str, builder->mapped);
+        builder->mapped = 0L;
+    } else if (newCapacity <= INLINE_CAPACITY) {
+        // Shrunk small enough to move back into the builder's own buffer
+        memcpy(builder->small, builder->str, keep * sizeof(char));
+        builder->small[keep] = '\0';
+        allocator_free(builder->allocator, builder->str);
+        temp = builder->small;
+    } else {
+        // Attempts to reallocate the builder, returning false if fails
+        temp = (char *)allocator_realloc(builder->allocator, builder->str, bytes);
+        if (temp == NULL) {
+            return FALSE;
+        }
     }
 
     // Update attributes after extension
+    // The new bytes are left as is, only the characters up to the terminator are ever read
     builder->str = temp;
-    if (expanding == TRUE) {
-        long i;
-        for (i = builder->capacity; i < newCapacity + 1; i++) {
-            // Need to add null terminators in all new bytes
-            builder->str[i] = '\0';
-        }
-    } else {
+    if (expanding == FALSE) {
         builder->str[newCapacity] = '\0';
         builder->index = newCapacity;
     }
@@ -102,7 +164,7 @@ static Boolean _ensure_capacity(StringBuilder *builder, long newCapacity) {
  * does not need expanding, and a value of -1 means that the builder cannot accomodate the string
  * length, even with resizing (due to long overflowing).
  */
-static long _compute_next_capacity_increase(StringBuilder *builder, int strLen) {
+static long _compute_next_capacity_increase(StringBuilder *builder, long strLen) {
 
     long increment = 0L;
     long bufferRemaining = builder->capacity - builder->index;
@@ -139,45 +201,570 @@ static long _compute_next_capacity_increase(StringBuilder *builder, int strLen)
 }
 
 /**
- * Local method to insert the specified string `str` into the builder, starting at index `offset` in
- * the builder.
+ * Returns the number of characters held by the rope subtree rooted at `node`.
  */
-static Status _insert_str(StringBuilder *builder, long offset, char *str) {
+static long _rope_size(RopeNode *node) {
+    return ( node != NULL ) ? node->size : 0L;
+}
+
+/**
+ * Recomputes the subtree size of `node` from its children and its own chunk.
+ */
+static void _rope_update(RopeNode *node) {
+    node->size = ( _rope_size(node->left) + node->len + _rope_size(node->right) );
+}
+
+/**
+ * Allocates a new, empty rope chunk for the builder and draws its random priority. Returns the new
+ * node, or NULL if allocation fails.
+ */
+static RopeNode *_rope_new_node(StringBuilder *builder) {
+
+    RopeNode *node = (RopeNode *)allocator_alloc(builder->allocator, sizeof(RopeNode));
+    if (node == NULL) {
+        return NULL;
+    }
+
+    // Steps the builder's xorshift generator for the priority
+    builder->seed ^= ( builder->seed << 13 );
+    builder->seed ^= ( builder->seed >> 7 );
+    builder->seed ^= ( builder->seed << 17 );
+    node->left = node->right = node->prev = node->next = NULL;
+    node->size = 0L;
+    node->len = 0L;
+    node->priority = (uint32_t)( builder->seed >> 32 );
+    builder->capacity += ROPE_CHUNK;
+
+    return node;
+}
+
+/**
+ * Frees the rope chunk `node`, which must already be detached from the builder's tree.
+ */
+static void _rope_free_node(StringBuilder *builder, RopeNode *node) {
+    builder->capacity -= ROPE_CHUNK;
+    allocator_free(builder->allocator, node);
+}
+
+/**
+ * Returns the first chunk of the rope rooted at `node`, or NULL if empty.
+ */
+static RopeNode *_rope_first(RopeNode *node) {
+    for (; node != NULL && node->left != NULL; node = node->left);
+    return node;
+}
+
+/**
+ * Returns the last chunk of the rope rooted at `node`, or NULL if empty.
+ */
+static RopeNode *_rope_last(RopeNode *node) {
+    for (; node != NULL && node->right != NULL; node = node->right);
+    return node;
+}
+
+/**
+ * Joins the ropes `a` and `b` into one, the characters of `a` coming first, and returns the new
+ * root. The chunks' list links are left as they are.
+ */
+static RopeNode *_rope_merge(RopeNode *a, RopeNode *b) {
+
+    if (a == NULL) {
+        return b;
+    } else if (b == NULL) {
+        return a;
+    }
 
-    char *ch;
-    int len = _get_str_length(str);
-    long i, increment = _compute_next_capacity_increase(builder, len);
+    if (a->priority >= b->priority) {
+        a->right = _rope_merge(a->right, b);
+        _rope_update(a);
+        return a;
+    }
+    b->left = _rope_merge(a, b->left);
+    _rope_update(b);
+    return b;
+}
+
+/**
+ * Splits the rope rooted at `node` into the chunks holding its first `k` characters, stored into
+ * `*left`, and the chunks holding the rest, stored into `*right`. If `k` falls in the middle of a
+ * chunk, the chunk's tail is moved into `*spare`, which is then set to NULL.
+ */
+static void _rope_split(RopeNode *node, long k, RopeNode **spare, RopeNode **left,
+                        RopeNode **right) {
+
+    if (node == NULL) {
+        *left = *right = NULL;
+        return;
+    }
+
+    long leftSize = _rope_size(node->left);
+    if (k <= leftSize) {
+        _rope_split(node->left, k, spare, left, &(node->left));
+        _rope_update(node);
+        *right = node;
+    } else if (k >= leftSize + node->len) {
+        _rope_split(node->right, k - leftSize - node->len, spare, &(node->right), right);
+        _rope_update(node);
+        *left = node;
+    } else {
+        // Moves the characters past `k` into the spare chunk, placed right after this one
+        RopeNode *tail = *spare;
+        long at = ( k - leftSize );
+        *spare = NULL;
+        tail->len = ( node->len - at );
+        tail->size = tail->len;
+        memcpy(tail->text, node->text + at, tail->len * sizeof(char));
+        node->len = at;
+        tail->prev = node;
+        tail->next = node->next;
+        if (node->next != NULL) {
+            node->next->prev = tail;
+        }
+        node->next = tail;
+
+        *right = _rope_merge(tail, node->right);
+        node->right = NULL;
+        _rope_update(node);
+        *left = node;
+    }
+}
+
+/**
+ * Finds the chunk where characters are inserted at index `offset`, storing the index within the
+ * chunk into `*local`, and adds `delta` to the size of every subtree on the way down. At the
+ * boundary between two chunks, the one ending there is picked. Returns NULL if the rope is empty.
+ */
+static RopeNode *_rope_find_insert(RopeNode *node, long offset, long *local, long delta) {
+
+    while (node != NULL) {
+        long leftSize = _rope_size(node->left);
+        node->size += delta;
+        if (node->left != NULL && offset <= leftSize) {
+            node = node->left;
+        } else if (offset - leftSize <= node->len) {
+            *local = ( offset - leftSize );
+            return node;
+        } else {
+            offset -= ( leftSize + node->len );
+            node = node->right;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * Finds the chunk holding the character at index `i`, storing its index within the chunk into
+ * `*local`. Returns NULL if `i` lies past the end of the rope.
+ */
+static RopeNode *_rope_find_char(RopeNode *node, long i, long *local) {
+
+    while (node != NULL) {
+        long leftSize = _rope_size(node->left);
+        if (i < leftSize) {
+            node = node->left;
+        } else if (i - leftSize < node->len) {
+            *local = ( i - leftSize );
+            return node;
+        } else {
+            i -= ( leftSize + node->len );
+            node = node->right;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * Frees every chunk in the list starting at `node`.
+ */
+static void _rope_free_chunks(StringBuilder *builder, RopeNode *node) {
+
+    RopeNode *next;
+    for (; node != NULL; node = next) {
+        next = node->next;
+        _rope_free_node(builder, node);
+    }
+}
+
+/**
+ * Builds a standalone rope out of the `len` characters at `bytes`, filling each chunk, and stores
+ * its root into `*root`. If `bytes` is NULL, the characters are all set to `fill` instead. Returns
+ * FALSE if allocation fails, in which case nothing is built.
+ */
+static Boolean _rope_build(StringBuilder *builder, const char *bytes, char fill, long len,
+                           RopeNode **root) {
+
+    RopeNode *tree = NULL, *last = NULL, *node;
+    long n;
+
+    for (; len > 0L; len -= n) {
+        if ((node = _rope_new_node(builder)) == NULL) {
+            _rope_free_chunks(builder, _rope_first(tree));
+            return FALSE;
+        }
+        n = ( len < ROPE_CHUNK ) ? len : ROPE_CHUNK;
+        if (bytes != NULL) {
+            memcpy(node->text, bytes, n * sizeof(char));
+            bytes += n;
+        } else {
+            memset(node->text, fill, n * sizeof(char));
+        }
+        node->len = n;
+        node->size = n;
+        node->prev = last;
+        if (last != NULL) {
+            last->next = node;
+        }
+        last = node;
+        tree = _rope_merge(tree, node);
+    }
+    *root = tree;
+
+    return TRUE;
+}
+
+/**
+ * Inserts the `len` characters at `bytes` (or `len` copies of `fill` if NULL) into the rope-backed
+ * builder at index `offset`. Characters that fit into the chunk at `offset` are added in place,
+ * otherwise new chunks are spliced into the tree.
+ */
+static Status _rope_insert(StringBuilder *builder, long offset, const char *bytes, char fill,
+                           long len) {
+
+    RopeNode *node, *spare, *middle, *left, *right, *before, *after;
+    long local = 0L;
+
+    if (ADD_OVERFLOWS(builder->index, len) == TRUE) {
+        return ALLOC_FAILURE;
+    }
+    if (len == 0L) {
+        return OK;
+    }
+
+    // Shifts the few characters after `offset` in its chunk, if there's still room in there
+    node = _rope_find_insert(builder->rope, offset, &local, 0L);
+    if (node != NULL && node->len + len <= ROPE_CHUNK) {
+        _rope_find_insert(builder->rope, offset, &local, len);
+        memmove(node->text + local + len, node->text + local, ( node->len - local ) * sizeof(char));
+        if (bytes != NULL) {
+            memcpy(node->text + local, bytes, len * sizeof(char));
+        } else {
+            memset(node->text + local, fill, len * sizeof(char));
+        }
+        node->len += len;
+        builder->index += len;
+        return OK;
+    }
+
+    // Otherwise builds the new chunks first, so that nothing changes if allocation fails
+    if ((spare = _rope_new_node(builder)) == NULL) {
+        return ALLOC_FAILURE;
+    }
+    if (_rope_build(builder, bytes, fill, len, &middle) == FALSE) {
+        _rope_free_node(builder, spare);
+        return ALLOC_FAILURE;
+    }
+
+    // Cuts the rope at `offset` and links the new chunks in between the two halves
+    _rope_split(builder->rope, offset, &spare, &left, &right);
+    if (spare != NULL) {
+        _rope_free_node(builder, spare);
+    }
+    before = _rope_last(left);
+    after = _rope_first(right);
+    node = _rope_first(middle);
+    node->prev = before;
+    if (before != NULL) {
+        before->next = node;
+    }
+    node = _rope_last(middle);
+    node->next = after;
+    if (after != NULL) {
+        after->prev = node;
+    }
+
+    builder->rope = _rope_merge(_rope_merge(left, middle), right);
+    builder->index += len;
+
+    return OK;
+}
+
+/**
+ * Removes the characters from index `start` (inclusive) to `end` (exclusive) from the rope rooted
+ * at `node`, trimming the chunks at either end in place and freeing the ones emptied. Returns the
+ * new root of the rope.
+ */
+static RopeNode *_rope_erase(StringBuilder *builder, RopeNode *node, long start, long end) {
+
+    if (node == NULL || start >= end) {
+        return node;
+    }
+
+    long leftSize = _rope_size(node->left);
+    long nodeEnd = ( leftSize + node->len );
+
+    // Only descends into the subtrees that overlap the range
+    if (start < leftSize) {
+        node->left = _rope_erase(builder, node->left, start, ( end < leftSize ) ? end : leftSize);
+    }
+    if (end > nodeEnd) {
+        long from = ( start > nodeEnd ) ? start : nodeEnd;
+        node->right = _rope_erase(builder, node->right, from - nodeEnd, end - nodeEnd);
+    }
+
+    // Cuts out the part of the range held by this chunk
+    long from = ( ( start > leftSize ) ? start : leftSize ) - leftSize;
+    long to = ( ( end < nodeEnd ) ? end : nodeEnd ) - leftSize;
+    if (from < to) {
+        memmove(node->text + from, node->text + to, ( node->len - to ) * sizeof(char));
+        node->len -= ( to - from );
+        if (node->len == 0L) {
+            // The chunk is now empty, so unlink it and join its two subtrees
+            RopeNode *rest = _rope_merge(node->left, node->right);
+            if (node->prev != NULL) {
+                node->prev->next = node->next;
+            }
+            if (node->next != NULL) {
+                node->next->prev = node->prev;
+            }
+            _rope_free_node(builder, node);
+            return rest;
+        }
+    }
+    _rope_update(node);
+
+    return node;
+}
+
+/**
+ * Copies the characters of the rope-backed builder from index `start` (inclusive) to `end`
+ * (exclusive) into `dst`, walking the chunks in order.
+ */
+static void _rope_read(StringBuilder *builder, long start, long end, char *dst) {
+
+    long local = 0L, n;
+    RopeNode *node = _rope_find_char(builder->rope, start, &local);
+
+    for (; node != NULL && start < end; node = node->next, local = 0L) {
+        n = ( node->len - local );
+        if (n > end - start) {
+            n = ( end - start );
+        }
+        memcpy(dst, node->text + local, n * sizeof(char));
+        dst += n;
+        start += n;
+    }
+}
+
+/**
+ * Overwrites the characters of the rope-backed builder starting at index `start` with the `len`
+ * characters at `bytes`, which must all lie within the builder.
+ */
+static void _rope_write(StringBuilder *builder, long start, const char *bytes, long len) {
+
+    long local = 0L, n;
+    RopeNode *node = _rope_find_char(builder->rope, start, &local);
+
+    for (; node != NULL && len > 0L; node = node->next, local = 0L) {
+        n = ( node->len - local );
+        if (n > len) {
+            n = len;
+        }
+        memcpy(node->text + local, bytes, n * sizeof(char));
+        bytes += n;
+        len -= n;
+    }
+}
+
+/**
+ * Returns TRUE if the `subLen` characters of `sub` appear in the rope starting at index `local` of
+ * the chunk `node`, continuing into the following chunks as needed.
+ */
+static Boolean _rope_matches(RopeNode *node, long local, const char *sub, long subLen) {
+
+    long n;
+    for (; node != NULL; node = node->next, local = 0L) {
+        n = ( node->len - local );
+        if (n > subLen) {
+            n = subLen;
+        }
+        if (memcmp(node->text + local, sub, n * sizeof(char)) != 0) {
+            return FALSE;
+        }
+        sub += n;
+        if ((subLen -= n) == 0L) {
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+/**
+ * Searches the rope-backed builder for the first occurence of `sub` (of length `subLen` > 0) from
+ * the valid index `start`. Returns its index, or -1 if not found.
+ */
+static long _rope_search_first(StringBuilder *builder, char *sub, long subLen, long start) {
+
+    long local = 0L, pos, i;
+    long last = ( builder->index - subLen );
+    RopeNode *node = _rope_find_char(builder->rope, start, &local);
+    const char *hit;
+
+    // Jumps between the chunks' occurrences of the first character, then checks the rest
+    for (pos = start - local; node != NULL; pos += node->len, node = node->next, local = 0L) {
+        while (local < node->len &&
+               (hit = memchr(node->text + local, sub[0], node->len - local)) != NULL) {
+            i = ( hit - node->text );
+            if (pos + i > last) {
+                return -1L;
+            }
+            if (_rope_matches(node, i, sub, subLen) == TRUE) {
+                return ( pos + i );
+            }
+            local = ( i + 1L );
+        }
+    }
+
+    return -1L;
+}
+
+/**
+ * Searches the rope-backed builder for the last occurence of `sub` (of length `subLen` > 0) that
+ * starts at or before index `high`. Returns its index, or -1 if not found.
+ */
+static long _rope_search_last(StringBuilder *builder, char *sub, long subLen, long high) {
+
+    long local = 0L, pos;
+    RopeNode *node;
+
+    if (high < 0L) {
+        return -1L;
+    }
+
+    // Walks the chunks backwards, checking the rest wherever the first character matches
+    node = _rope_find_char(builder->rope, high, &local);
+    for (pos = high - local; node != NULL; ) {
+        for (; local >= 0L; local--) {
+            if (node->text[local] == sub[0] && _rope_matches(node, local, sub, subLen) == TRUE) {
+                return ( pos + local );
+            }
+        }
+        if ((node = node->prev) != NULL) {
+            pos -= node->len;
+            local = ( node->len - 1L );
+        }
+    }
+
+    return -1L;
+}
+
+/**
+ * Reverses the rope rooted at `node` in place by mirroring the tree, the chunk list, and the
+ * characters of every chunk.
+ */
+static void _rope_reverse(RopeNode *node) {
+
+    RopeNode *temp;
+    long head, tail;
+    char ch;
+
+    if (node == NULL) {
+        return;
+    }
+
+    temp = node->left;
+    node->left = node->right;
+    node->right = temp;
+    temp = node->prev;
+    node->prev = node->next;
+    node->next = temp;
+    for (head = 0L, tail = node->len - 1L; head < tail; head++, tail--) {
+        ch = node->text[head];
+        node->text[head] = node->text[tail];
+        node->text[tail] = ch;
+    }
+
+    _rope_reverse(node->left);
+    _rope_reverse(node->right);
+}
+
+/**
+ * Frees every chunk of the rope-backed builder, leaving it empty.
+ */
+static void _rope_clear(StringBuilder *builder) {
+
+    _rope_free_chunks(builder, _rope_first(builder->rope));
+    builder->rope = NULL;
+    builder->index = 0L;
+}
+
+/**
+ * Local method to insert the `len` characters at `bytes` into the builder, starting at index
+ * `offset` in the builder. The characters may come from the builder itself.
+ */
+static Status _insert_bytes(StringBuilder *builder, long offset, const char *bytes, long len) {
+
+    if (builder->chunked == TRUE) {
+        return _rope_insert(builder, offset, bytes, '\0', len);
+    }
+
+    char *copy = NULL;
+    long increment = _compute_next_capacity_increase(builder, len);
 
     if (increment < 0L) {
         // Cannot expand for string, return allocation error
         return ALLOC_FAILURE;
-    } else if (increment > 0L) {
-        // Attempt to expand the builder for new string
-        if (_ensure_capacity(builder, builder->capacity + increment) == FALSE) {
+    }
+    if (len == 0L) {
+        return OK;
+    }
+
+    // Characters from the builder itself would move underneath the copy, so set them aside first
+    if (bytes >= builder->str && bytes <= builder->str + builder->capacity) {
+        if ((copy = (char *)malloc(len * sizeof(char))) == NULL) {
             return ALLOC_FAILURE;
         }
+        memcpy(copy, bytes, len * sizeof(char));
+        bytes = copy;
     }
-
-    // If offset < length, need to shift characters over `len` spaces to right to fit in string
-    if (offset < builder->index) {
-        for (i = builder->index - 1; i >= offset; i--) {
-            builder->str[i + len] = builder->str[i];
+    if (increment > 0L) {
+        // Attempt to expand the builder for new string
+        if (_ensure_capacity(builder, builder->capacity + increment) == FALSE) {
+            free(copy);
+            return ALLOC_FAILURE;
         }
     }
 
-    // Insert characters into builder starting at index `offset`
-    for (i = offset, ch = str; *ch != '\0'; ch++, i++) {
-        builder->str[i] = *ch;
-    }
+    // Shifts the characters after `offset` (and the terminator) over `len` spaces to the right
+    memmove(builder->str + offset + len, builder->str + offset,
+            ( builder->index - offset + 1 ) * sizeof(char));
+    memcpy(builder->str + offset, bytes, len * sizeof(char));
     builder->index += len;
+    free(copy);
 
     return OK;
 }
 
+/**
+ * Local method to insert the specified string `str` into the builder, starting at index `offset` in
+ * the builder.
+ */
+static Status _insert_str(StringBuilder *builder, long offset, char *str) {
+    return _insert_bytes(builder, offset, str, (long)strlen(str));
+}
+
 Status string_builder_new(StringBuilder **builder, long capacity, float growthFactor, char *str) {
+    return string_builder_newWithAllocator(builder, capacity, growthFactor, str, NULL);
+}
+
+Status string_builder_newWithAllocator(StringBuilder **builder, long capacity, float growthFactor,
+                                       char *str, const CdsAllocator *allocator) {
 
     // Allocate the struct, check for allocation failures
-    StringBuilder *temp = (StringBuilder *)malloc(sizeof(StringBuilder));
+    allocator = ( allocator != NULL ) ? allocator : allocator_default();
+    StringBuilder *temp = (StringBuilder *)allocator_alloc(allocator, sizeof(StringBuilder));
     if (temp == NULL) {
         return ALLOC_FAILURE;
     }
@@ -189,32 +776,37 @@ Status string_builder_new(StringBuilder **builder, long capacity, float growthFa
         cap = MAX_CAPACITY;
     }
 
-    // Allocates the inner string builder, return error if fails
+    // Allocates the inner string builder unless it fits in the struct, return error if fails
     size_t bytes = ( ( cap + 1 ) * sizeof(char) );
-    char *innerBuffer = (char *)malloc(bytes);
+    char *innerBuffer = ( cap <= INLINE_CAPACITY ) ? temp->small :
+                        (char *)allocator_alloc(allocator, bytes);
     if (innerBuffer == NULL) {
-        free(temp);
+        allocator_free(allocator, temp);
         return ALLOC_FAILURE;
     }
 
-    // Fills up the empty builder with null terminators
-    long i;
-    for (i = 0L; i < cap + 1; i++) {
-        innerBuffer[i] = '\0';
-    }
+    // The builder starts out as the empty string
+    innerBuffer[0] = '\0';
 
     // Initialize remaining struct properties
     temp->str = innerBuffer;
     temp->index = 0L;
-    temp->capacity = cap;
+    temp->capacity = ( innerBuffer == temp->small ) ? INLINE_CAPACITY : cap;
     temp->growthFactor = ( 0.0f < growthFactor ) && ( growthFactor <= 1.0f ) ?
                          growthFactor : DEFAULT_GROWTH_FACTOR;
+    temp->chunked = FALSE;
+    temp->rope = NULL;
+    temp->seed = 0UL;
+    temp->mapped = 0L;
+    temp->allocator = allocator;
 
     // If an initial string is provided, append it to the builder
     if (str != NULL) {
         if (_insert_str(temp, 0L, str) != OK) {
-            free(temp->str);
-            free(temp);
+            if (temp->str != temp->small) {
+                allocator_free(allocator, temp->str);
+            }
+            allocator_free(allocator, temp);
             return ALLOC_FAILURE;
         }
     }
@@ -223,6 +815,121 @@ Status string_builder_new(StringBuilder **builder, long capacity, float growthFa
     return OK;
 }
 
+Status string_builder_newRope(StringBuilder **builder, char *str) {
+
+    StringBuilder *temp = (StringBuilder *)allocator_alloc(allocator_default(),
+                                                           sizeof(StringBuilder));
+    if (temp == NULL) {
+        return ALLOC_FAILURE;
+    }
+
+    // The builder starts out with no chunks, the capacity counts the characters they can hold
+    temp->str = NULL;
+    temp->index = 0L;
+    temp->capacity = 0L;
+    temp->growthFactor = DEFAULT_GROWTH_FACTOR;
+    temp->chunked = TRUE;
+    temp->rope = NULL;
+    temp->seed = ( (uint64_t)(uintptr_t)temp ^ 0x9E3779B97F4A7C15UL ) | 1UL;
+    temp->mapped = 0L;
+    temp->allocator = allocator_default();
+
+    // If an initial string is provided, append it to the builder
+    if (str != NULL) {
+        if (_insert_str(temp, 0L, str) != OK) {
+            allocator_free(temp->allocator, temp);
+            return ALLOC_FAILURE;
+        }
+    }
+    *builder = temp;
+
+    return OK;
+}
+
+Status string_builder_newMapped(StringBuilder **builder, const char *path) {
+
+    StringBuilder *temp;
+    struct stat info;
+    char *area;
+    long size;
+    int fd;
+
+    if ((fd = open(path, O_RDONLY)) < 0) {
+        return IO_FAILURE;
+    }
+    if (fstat(fd, &info) != 0 || S_ISREG(info.st_mode) == 0) {
+        close(fd);
+        return IO_FAILURE;
+    }
+    if ((temp = (StringBuilder *)allocator_alloc(allocator_default(),
+                                                 sizeof(StringBuilder))) == NULL) {
+        close(fd);
+        return ALLOC_FAILURE;
+    }
+
+    /*
+     * Reserves an anonymous area one byte larger than the file, then maps the file over its start.
+     * The byte past the file's end is then always there, and reads as the null terminator. Both
+     * are private mappings, so any change made to the builder is never written back to the file.
+     */
+    size = (long)info.st_size;
+    area = (char *)mmap(NULL, size + 1L, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1,
+                        0);
+    if (area == MAP_FAILED) {
+        close(fd);
+        allocator_free(allocator_default(), temp);
+        return ALLOC_FAILURE;
+    }
+    if (size > 0L && mmap(area, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, 0)
+                     == MAP_FAILED) {
+        munmap(area, size + 1L);
+        close(fd);
+        allocator_free(allocator_default(), temp);
+        return IO_FAILURE;
+    }
+    close(fd);
+
+    // The mapping works as a buffer that's full, the first resize copies it to the heap
+    temp->str = area;
+    temp->index = size;
+    temp->capacity = size;
+    temp->growthFactor = DEFAULT_GROWTH_FACTOR;
+    temp->chunked = FALSE;
+    temp->rope = NULL;
+    temp->seed = 0UL;
+    temp->mapped = ( size + 1L );
+    temp->allocator = allocator_default();
+    *builder = temp;
+
+    return OK;
+}
+
+/**
+ * Local method to insert the contents of builder `other` into the builder at index `offset`. A
+ * rope-backed builder's characters are copied out first, as they are not held contiguously.
+ */
+static Status _insert_builder(StringBuilder *builder, long offset, StringBuilder *other) {
+
+    if (other == NULL) {
+        // For null object, will use string literal "null"
+        return _insert_str(builder, offset, "null");
+    } else if (other->chunked == FALSE) {
+        // Inserting a builder into itself is handled by the insert, which copies the characters
+        return _insert_bytes(builder, offset, other->str, other->index);
+    }
+
+    char *copy;
+    Status status;
+    if ((copy = (char *)malloc(( other->index + 1 ) * sizeof(char))) == NULL) {
+        return ALLOC_FAILURE;
+    }
+    _rope_read(other, 0L, other->index, copy);
+    status = _insert_bytes(builder, offset, copy, other->index);
+    free(copy);
+
+    return status;
+}
+
 Status string_builder_appendChar(StringBuilder *builder, char ch) {
 
     char str[] = { ch, '\0' };
@@ -235,6 +942,14 @@ Status string_builder_appendStr(StringBuilder *builder, char *str) {
     return _insert_str(builder, builder->index, temp);
 }
 
+Status string_builder_appendBytes(StringBuilder *builder, const char *bytes, long len) {
+
+    if (len < 0L) {
+        return INVALID_INDEX;
+    }
+    return _insert_bytes(builder, builder->index, bytes, len);
+}
+
 Status string_builder_appendBoolean(StringBuilder *builder, Boolean b) {
 
     char *str = ( b == TRUE ) ? "true" : "false";
@@ -243,60 +958,140 @@ Status string_builder_appendBoolean(StringBuilder *builder, Boolean b) {
 
 // The size of the temporary builder where non-string conversion results are placed
 #define BUFFER_SIZE 1024
+// Number of characters needed to format any long in decimal, including the sign
+#define LONG_DIGITS 20
+// Numbers with a larger magnitude are formatted by sprintf(), the rest fit into 64 bits scaled
+#define MAX_FAST_DOUBLE 9.0e12
+// The number of fractional digits written for floats and doubles, as with "%f"
+#define FRACTION_DIGITS 6
+// The scale applied to floats and doubles to turn their fractional digits into an integer
+#define FRACTION_SCALE 1000000U
+
+// The decimal digits of every number from 00 to 99, so that two digits are written per lookup
+static const char DIGIT_PAIRS[] =
+    "0001020304050607080910111213141516171819"
+    "2021222324252627282930313233343536373839"
+    "4041424344454647484950515253545556575859"
+    "6061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
 
-Status string_builder_appendShort(StringBuilder *builder, short s) {
+/**
+ * Formats the decimal digits of `value` backwards into the buffer ending at `end`, two digits at a
+ * time, and returns a pointer to the first character written.
+ */
+static char *_format_unsigned(unsigned long value, char *end) {
 
-    char temp[BUFFER_SIZE];
-    sprintf(temp, "%hd", s);
-    return _insert_str(builder, builder->index, temp);
+    while (value >= 100UL) {
+        unsigned long pair = ( value % 100UL );
+        value /= 100UL;
+        *--end = DIGIT_PAIRS[( pair * 2UL ) + 1UL];
+        *--end = DIGIT_PAIRS[pair * 2UL];
+    }
+    if (value >= 10UL) {
+        *--end = DIGIT_PAIRS[( value * 2UL ) + 1UL];
+        *--end = DIGIT_PAIRS[value * 2UL];
+    } else {
+        *--end = (char)( '0' + value );
+    }
+
+    return end;
 }
 
-Status string_builder_appendInt(StringBuilder *builder, int i) {
+/**
+ * Inserts the decimal representation of `value` into the builder at index `offset`, the same as
+ * formatting it with "%ld".
+ */
+static Status _insert_long(StringBuilder *builder, long offset, long value) {
+
+    char buffer[LONG_DIGITS + 1];
+    char *end = ( buffer + sizeof(buffer) );
+    // Negating in unsigned arithmetic also handles LONG_MIN
+    unsigned long magnitude = (unsigned long)value;
+    if (value < 0L) {
+        magnitude = ( 0UL - magnitude );
+    }
+    char *start = _format_unsigned(magnitude, end);
 
-    char temp[BUFFER_SIZE];
-    sprintf(temp, "%d", i);
-    return _insert_str(builder, builder->index, temp);
+    if (value < 0L) {
+        *--start = '-';
+    }
+    return _insert_bytes(builder, offset, start, end - start);
 }
 
-Status string_builder_appendLong(StringBuilder *builder, long l) {
+/**
+ * Inserts the decimal representation of `value` into the builder at index `offset`, exactly as
+ * formatting it with "%f" would. Finite values of moderate magnitude are decomposed into their
+ * binary significand and exponent and scaled by 10^6 in 128-bit arithmetic, then rounded half to
+ * even, so the digits are exact without going through sprintf(). Other values fall back to it.
+ */
+static Status _insert_double(StringBuilder *builder, long offset, double value) {
 
-    char temp[BUFFER_SIZE];
-    sprintf(temp, "%ld", l);
-    return _insert_str(builder, builder->index, temp);
-}
+    char buffer[BUFFER_SIZE];
+    uint64_t bits, significand, scaled;
+    int exponent;
 
-Status string_builder_appendFloat(StringBuilder *builder, float f) {
+    // NaNs, infinities and large magnitudes are left to sprintf()
+    if (value != value || value >= MAX_FAST_DOUBLE || value <= -MAX_FAST_DOUBLE) {
+        sprintf(buffer, "%f", value);
+        return _insert_str(builder, offset, buffer);
+    }
 
-    char temp[BUFFER_SIZE];
-    sprintf(temp, "%f", f);
-    return _insert_str(builder, builder->index, temp);
+    // Splits the value into significand * 2^exponent
+    memcpy(&bits, &value, sizeof(uint64_t));
+    exponent = (int)( ( bits >> 52 ) & 0x7FFUL );
+    significand = ( bits & 0xFFFFFFFFFFFFFUL );
+    if (exponent == 0) {
+        exponent = -1074;
+    } else {
+        significand |= ( 1UL << 52 );
+        exponent -= 1075;
+    }
+
+    // Scales by 10^6 exactly, then rounds off the bits below the binary point, half to even
+    unsigned __int128 product = ( (unsigned __int128)significand * FRACTION_SCALE );
+    if (exponent >= 0) {
+        scaled = (uint64_t)( product << exponent );
+    } else if (exponent > -100) {
+        unsigned __int128 half = ( (unsigned __int128)1 << ( -exponent - 1 ) );
+        unsigned __int128 rest = ( product & ( ( half << 1 ) - 1 ) );
+        scaled = (uint64_t)( product >> -exponent );
+        if (rest > half || ( rest == half && ( scaled & 1UL ) != 0UL )) {
+            scaled++;
+        }
+    } else {
+        // The product is below 2^73, so its value is far below one half
+        scaled = 0UL;
+    }
+
+    // Writes the fraction (with its leading zeros) and the integer part, backwards
+    char *end = ( buffer + sizeof(buffer) ), *start = ( end - FRACTION_DIGITS );
+    _format_unsigned(( scaled % FRACTION_SCALE ) + FRACTION_SCALE, end);
+    *--start = '.';
+    start = _format_unsigned(scaled / FRACTION_SCALE, start);
+    if (( bits >> 63 ) != 0UL) {
+        *--start = '-';
+    }
+    return _insert_bytes(builder, offset, start, end - start);
 }
 
-Status string_builder_appendDouble(StringBuilder *builder, double d) {
+Status string_builder_appendShort(StringBuilder *builder, short s) {
+    return _insert_long(builder, builder->index, s);
+}
 
-    char temp[BUFFER_SIZE];
-    sprintf(temp, "%lf", d);
-    return _insert_str(builder, builder->index, temp);
+Status string_builder_appendInt(StringBuilder *builder, int i) {
+    return _insert_long(builder, builder->index, i);
 }
 
-/**
- * Helper method to load the specified buffer `dest` with a substring of `src`, index-based,
- * starting from `dstBegin` (inclusive) to `dstEnd` (exclusive). The char array `dest` is assumed
- * to be large enough to store the results.
- */
-static void _load_substring_to_buffer(char *src, char dest[], long dstBegin, long dstEnd) {
+Status string_builder_appendLong(StringBuilder *builder, long l) {
+    return _insert_long(builder, builder->index, l);
+}
 
-    // For null strings, will use the string literal "null"
-    if (src == NULL) {
-        src = "null";
-    }
+Status string_builder_appendFloat(StringBuilder *builder, float f) {
+    return _insert_double(builder, builder->index, f);
+}
 
-    // Copies substring characters into buffer
-    long i, j, subLen = ( dstEnd - dstBegin );
-    for (i = 0, j = dstBegin; i < subLen; i++, j++) {
-        dest[i] = src[j];
-    }
-    dest[i] = '\0';
+Status string_builder_appendDouble(StringBuilder *builder, double d) {
+    return _insert_double(builder, builder->index, d);
 }
 
 Status string_builder_appendSubStr(StringBuilder *builder, char *str, int start, int end) {
@@ -306,9 +1101,7 @@ Status string_builder_appendSubStr(StringBuilder *builder, char *str, int start,
     int strLen = _get_str_length(str);
     VALIDATE_INDEX_RANGE(start, end, strLen);
 
-    char temp[(end - start) + 1];
-    _load_substring_to_buffer(str, temp, start, end);
-    return _insert_str(builder, builder->index, temp);
+    return _insert_bytes(builder, builder->index, str + start, end - start);
 }
 
 Status string_builder_appendStrSubSequence(StringBuilder *builder, char *str, int offset, int len) {
@@ -316,32 +1109,84 @@ Status string_builder_appendStrSubSequence(StringBuilder *builder, char *str, in
     int strLen = _get_str_length(str);
     VALIDATE_INDEX_RANGE(offset, offset + len, strLen);
 
-    char temp[len + 1];
-    _load_substring_to_buffer(str, temp, offset, offset + len);
-    return _insert_str(builder, builder->index, temp);
+    return _insert_bytes(builder, builder->index, str + offset, len);
 }
 
 Status string_builder_appendStrBuilder(StringBuilder *builder, StringBuilder *other) {
+    return _insert_builder(builder, builder->index, other);
+}
 
-    if (other == NULL) {
-        // For null object, will use string literal "null"
-        return _insert_str(builder, builder->index, "null");
-    } else if (other->index == 0) {
-        // If other builder is empty, then do nothing
-        return OK;
-    } else if (builder == other) {
-        /*
-         * If both instances are equal, need to copy builder's contents to array and add that to the
-         * builder. Step is needed as the loop inside the insert string helper method will loop
-         * infinitely.
-         */
-        char buffer[other->index];
-        _load_substring_to_buffer(other->str, buffer, 0, other->index);
-        return _insert_str(builder, builder->index, buffer);
-    } else {
-        // If both instances are different and not empty, append as normal
-        return _insert_str(builder, builder->index, other->str);
+/**
+ * Helper method to grow the contiguous builder, if needed, so that there's room for `len` more
+ * characters after its end. Returns TRUE if successful, FALSE if allocation fails.
+ */
+static Boolean _reserve_room(StringBuilder *builder, long len) {
+
+    long increment = _compute_next_capacity_increase(builder, len);
+    if (increment < 0L) {
+        return FALSE;
+    }
+    return ( increment == 0L ) ? TRUE : _ensure_capacity(builder, builder->capacity + increment);
+}
+
+Status string_builder_appendAll(StringBuilder *builder, char **strs, long count) {
+
+    long i, total = 0L, len;
+    Status status;
+
+    if (count < 0L) {
+        return INVALID_INDEX;
+    }
+
+    // Grows the builder once for the whole batch, then appends each string into the room left
+    for (i = 0L; i < count; i++) {
+        len = ( strs[i] != NULL ) ? (long)strlen(strs[i]) : 4L;
+        if (ADD_OVERFLOWS(total, len) == TRUE) {
+            return ALLOC_FAILURE;
+        }
+        total += len;
+    }
+    if (builder->chunked == FALSE && _reserve_room(builder, total) == FALSE) {
+        return ALLOC_FAILURE;
+    }
+    for (i = 0L; i < count; i++) {
+        if ((status = string_builder_appendStr(builder, strs[i])) != OK) {
+            return status;
+        }
+    }
+
+    return OK;
+}
+
+Status string_builder_reserveTail(StringBuilder *builder, long len, char **tail, long *room) {
+
+    if (len < 0L) {
+        return INVALID_INDEX;
+    } else if (builder->chunked == TRUE) {
+        // The rope's characters never sit in one contiguous buffer
+        return STRUCT_FULL;
+    }
+
+    if (_reserve_room(builder, len) == FALSE) {
+        return ALLOC_FAILURE;
+    }
+    *tail = ( builder->str + builder->index );
+    *room = ( builder->capacity - builder->index );
+
+    return OK;
+}
+
+Status string_builder_commitTail(StringBuilder *builder, long len) {
+
+    if (builder->chunked == TRUE) {
+        return STRUCT_FULL;
+    } else if (len < 0L || len > builder->capacity - builder->index) {
+        return INVALID_INDEX;
     }
+    builder->index += len;
+    builder->str[builder->index] = '\0';
+
+    return OK;
 }
 
 Status string_builder_insertChar(StringBuilder *builder, long offset, char ch) {
@@ -358,6 +1203,16 @@ Status string_builder_insertStr(StringBuilder *builder, long offset, char *str)
     return _insert_str(builder, offset, temp);
 }
 
+Status string_builder_insertBytes(StringBuilder *builder, long offset, const char *bytes,
+                                  long len) {
+
+    VALIDATE_INDEX(offset, builder->index);
+    if (len < 0L) {
+        return INVALID_INDEX;
+    }
+    return _insert_bytes(builder, offset, bytes, len);
+}
+
 Status string_builder_insertBoolean(StringBuilder *builder, long offset, Boolean b) {
 
     VALIDATE_INDEX(offset, builder->index);
@@ -368,41 +1223,31 @@ Status string_builder_insertBoolean(StringBuilder *builder, long offset, Boolean
 Status string_builder_insertShort(StringBuilder *builder, long offset, short s) {
 
     VALIDATE_INDEX(offset, builder->index);
-    char temp[BUFFER_SIZE];
-    sprintf(temp, "%hd", s);
-    return _insert_str(builder, offset, temp);
+    return _insert_long(builder, offset, s);
 }
 
 Status string_builder_insertInt(StringBuilder *builder, long offset, int i) {
 
     VALIDATE_INDEX(offset, builder->index);
-    char temp[BUFFER_SIZE];
-    sprintf(temp, "%d", i);
-    return _insert_str(builder, offset, temp);
+    return _insert_long(builder, offset, i);
 }
 
 Status string_builder_insertLong(StringBuilder *builder, long offset, long l) {
 
     VALIDATE_INDEX(offset, builder->index);
-    char temp[BUFFER_SIZE];
-    sprintf(temp, "%ld", l);
-    return _insert_str(builder, offset, temp);
+    return _insert_long(builder, offset, l);
 }
 
 Status string_builder_insertFloat(StringBuilder *builder, long offset, float f) {
 
     VALIDATE_INDEX(offset, builder->index);
-    char temp[BUFFER_SIZE];
-    sprintf(temp, "%f", f);
-    return _insert_str(builder, offset, temp);
+    return _insert_double(builder, offset, f);
 }
 
 Status string_builder_insertDouble(StringBuilder *builder, long offset, double d) {
 
     VALIDATE_INDEX(offset, builder->index);
-    char temp[BUFFER_SIZE];
-    sprintf(temp, "%lf", d);
-    return _insert_str(builder, offset, temp);
+    return _insert_double(builder, offset, d);
 }
 
 Status string_builder_insertSubStr(StringBuilder *builder, long offset, char *str, int start,
@@ -412,9 +1257,7 @@ Status string_builder_insertSubStr(StringBuilder *builder, long offset, char *st
     int strLen = _get_str_length(str);
     VALIDATE_INDEX_RANGE(start, end, strLen);
 
-    char temp[(end - start) + 1];
-    _load_substring_to_buffer(str, temp, start, end);
-    return _insert_str(builder, offset, temp);
+    return _insert_bytes(builder, offset, str + start, end - start);
 }
 
 Status string_builder_insertStrSubSequence(StringBuilder *builder, long index, char *str,
@@ -424,34 +1267,13 @@ Status string_builder_insertStrSubSequence(StringBuilder *builder, long index, c
     int strLen = _get_str_length(str);
     VALIDATE_INDEX_RANGE(offset, offset + len, strLen);
 
-    char temp[len + 1];
-    _load_substring_to_buffer(str, temp, offset, offset + len);
-    return _insert_str(builder, index, temp);
+    return _insert_bytes(builder, index, str + offset, len);
 }
 
 Status string_builder_insertStrBuilder(StringBuilder *builder, long offset, StringBuilder *other) {
 
     VALIDATE_INDEX(offset, builder->index);
-
-    if (other == NULL) {
-        // For null object, will use string literal "null"
-        return _insert_str(builder, offset, "null");
-    } else if (other->index == 0) {
-        // If other builder is empty, then do nothing
-        return OK;
-    } else if (builder == other) {
-        /*
-         * If both instances are equal, need to copy builder's contents to array and add that to the
-         * builder. Step is needed as the loop inside the insert string helper method will loop
-         * infinitely.
-         */
-        char buffer[other->index];
-        _load_substring_to_buffer(other->str, buffer, 0, other->index);
-        return _insert_str(builder, offset, buffer);
-    } else {
-        // If both instances are different and not empty, append as normal
-        return _insert_str(builder, offset, other->str);
-    }
+    return _insert_builder(builder, offset, other);
 }
 
 /**
@@ -459,11 +1281,7 @@ Status string_builder_insertStrBuilder(StringBuilder *builder, long offset, Stri
  * `end` (exlcusive). By nullify, the characters are set to null terminators.
  */
 static void _scrub_char_builder(char *buffer, long start, long end) {
-
-    long i;
-    for (i = start; i < end; i++) {
-        buffer[i] = '\0';
-    }
+    memset(buffer + start, '\0', ( end - start ) * sizeof(char));
 }
 
 /**
@@ -477,15 +1295,15 @@ static Status _delete_substring(StringBuilder *builder, long start, long end) {
     if (builder->index == 0L) {
         return STRUCT_EMPTY;
     }
-
-    long i;
-    long delta = end - start;
-    for (i = end; i < builder->index; i++) {
-        // Shifts all characters in buffer over to left
-        builder->str[i - delta] = builder->str[i];
+    if (builder->chunked == TRUE) {
+        builder->rope = _rope_erase(builder, builder->rope, start, end);
+        builder->index -= ( end - start );
+        return OK;
     }
 
-    _scrub_char_builder(builder->str, builder->index - delta, builder->index);
+    // Shifts the characters after `end` (and the terminator) over to the left
+    long delta = end - start;
+    memmove(builder->str + start, builder->str + end, ( builder->index - end + 1 ) * sizeof(char));
     builder->index -= delta;
 
     return OK;
@@ -509,17 +1327,16 @@ Status string_builder_replace(StringBuilder *builder, long start, long end, char
      */
     if (strLen > diff) {
         subLen = strLen - diff;
-        char subStr[subLen + 1];
-        _load_substring_to_buffer(str, subStr, 0, subLen);
-        if (_insert_str(builder, start, subStr) != OK) {
+        if (_insert_bytes(builder, start, str, subLen) != OK) {
             return ALLOC_FAILURE;
         }
     }
 
     // Replace the remaining characters in the specified range with the given string
-    long i, j;
-    for (i = ( start + subLen ), j = subLen; j < strLen; i++, j++) {
-        builder->str[i] = str[j];
+    if (builder->chunked == TRUE) {
+        _rope_write(builder, start + subLen, str + subLen, strLen - subLen);
+    } else {
+        memcpy(builder->str + start + subLen, str + subLen, ( strLen - subLen ) * sizeof(char));
     }
 
     return OK;
@@ -528,48 +1345,45 @@ Status string_builder_replace(StringBuilder *builder, long start, long end, char
 Status string_builder_charAt(StringBuilder *builder, long i, char *result) {
 
     VALIDATE_INDEX(i, builder->index - 1);
-    *result = builder->str[i];
+    if (builder->chunked == TRUE) {
+        long local = 0L;
+        RopeNode *node = _rope_find_char(builder->rope, i, &local);
+        *result = node->text[local];
+    } else {
+        *result = builder->str[i];
+    }
     return OK;
 }
 
 /**
- * Helper method to extract a substring from the builder `builder`, index-based, starting from index
- * `start` (inclusive) and ending at `end` (exclusive). Substring is loaded into `dst` from the
- * starting index `dstBegin`. Additonal parameter `allocate` is given to indicate whether `dstBegin`
- * will be allocated from the heap or not. If set to TRUE, it will, otherwise `dst` is assumed to be
- * a char array big enough to hold the result.
- *
- * Returns OK if successful, INVALID_INDEX if one of the indecies given is invalid, or ALLOC_FAILURE
- * if any allocation fails.
+ * Helper method to copy the characters of the builder from index `start` (inclusive) to `end`
+ * (exclusive) into the array `dst`, which is assumed to be big enough to hold them.
  */
-static Status _get_substring(StringBuilder *builder, long start, long end, char *dst, int dstBegin,
-                             Boolean allocate) {
+static void _copy_chars(StringBuilder *builder, long start, long end, char *dst) {
 
-    if (start < 0 || end < 0 || end > builder->index || start > end || dstBegin < 0) {
-        return INVALID_INDEX;
+    if (builder->chunked == TRUE) {
+        _rope_read(builder, start, end, dst);
+    } else {
+        memcpy(dst, builder->str + start, ( end - start ) * sizeof(char));
     }
+}
 
-    char *temp;
-    int strLen = ( end - start ) + 1;
-    if (allocate == TRUE) {
-        // If allocation set to true, will allocate char array from heap
-        int i;
-        if ((temp = (char *)malloc(strLen)) == NULL) {
-            return ALLOC_FAILURE;
-        }
-        for (i = 0; i < strLen; i++) {
-            // Need to nullify all characters in string
-            temp[i] = '\0';
-        }
-        dst = temp;
-    }
+/**
+ * Helper method to extract a substring from the builder `builder`, index-based, starting from index
+ * `start` (inclusive) and ending at `end` (exclusive). The substring is allocated from the heap
+ * and stored into `*result`.
+ *
+ * Returns OK if successful, or ALLOC_FAILURE if the allocation fails.
+ */
+static Status _get_substring(StringBuilder *builder, long start, long end, char **result) {
 
-    long i;
-    int j;
-    for (i = start, j = dstBegin; i < end; i++, j++) {
-        // Copies substring into the destination array
-        dst[j] = builder->str[i];
+    char *temp;
+    if ((temp = (char *)malloc(( end - start + 1 ) * sizeof(char))) == NULL) {
+        return ALLOC_FAILURE;
     }
+    _copy_chars(builder, start, end, temp);
+    temp[end - start] = '\0';
+    *result = temp;
 
     return OK;
 }
@@ -577,13 +1391,13 @@ static Status _get_substring(StringBuilder *builder, long start, long end, char
 Status string_builder_substring(StringBuilder *builder, long start, char **result) {
 
     VALIDATE_INDEX(start, builder->index);
-    return _get_substring(builder, start, builder->index, *result, 0, TRUE);
+    return _get_substring(builder, start, builder->index, result);
 }
 
 Status string_builder_subsequence(StringBuilder *builder, long start, long end, char **result) {
 
     VALIDATE_INDEX_RANGE(start, end, builder->index);
-    return _get_substring(builder, start, end, *result, 0, TRUE);
+    return _get_substring(builder, start, end, result);
 }
 
 Status string_builder_getChars(StringBuilder *builder, long srcBegin, long srcEnd, char dst[],
@@ -593,13 +1407,18 @@ Status string_builder_getChars(StringBuilder *builder, long srcBegin, long srcEn
         return INVALID_INDEX;
     }
     VALIDATE_INDEX_RANGE(srcBegin, srcEnd, builder->index);
-    return _get_substring(builder, srcBegin, srcEnd, dst, dstBegin, FALSE);
+    _copy_chars(builder, srcBegin, srcEnd, dst + dstBegin);
+    return OK;
 }
 
 Status string_builder_setCharAt(StringBuilder *builder, long index, char ch) {
 
     VALIDATE_INDEX(index, builder->index - 1);
-    builder->str[index] = ch;
+    if (builder->chunked == TRUE) {
+        _rope_write(builder, index, &ch, 1L);
+    } else {
+        builder->str[index] = ch;
+    }
     return OK;
 }
 
@@ -611,50 +1430,56 @@ Status string_builder_setLength(StringBuilder *builder, long len, char padding)
     } else if (len == builder->index) {
         // If length given equals current length, don't need to do anything
         return OK;
+    } else if (builder->chunked == TRUE) {
+        // Chunks are trimmed or padded in place, never reallocating the rest of the rope
+        if (len < builder->index) {
+            builder->rope = _rope_erase(builder, builder->rope, len, builder->index);
+            builder->index = len;
+            return OK;
+        }
+        return _rope_insert(builder, builder->index, NULL, padding, len - builder->index);
     }
 
-    Boolean shrink = ( len < builder->index ) ? TRUE : FALSE;
-    if (_ensure_capacity(builder, len) == FALSE) {
+    // Only grows the buffer when needed, a shorter builder keeps its capacity for later appends
+    if (len > builder->capacity && _ensure_capacity(builder, len) == FALSE) {
         return ALLOC_FAILURE;
     }
 
-    if (shrink) {
-        // Need to append null terminator at end if shrinking
-        builder->str[len] = '\0';
-    } else {
-        long i;
-        for (i = builder->index; i < len; i++) {
-            builder->str[i] = padding;
-        }
-        builder->str[i] = '\0';
+    if (len > builder->index) {
+        memset(builder->str + builder->index, padding, ( len - builder->index ) * sizeof(char));
     }
+    builder->str[len] = '\0';
     builder->index = len;
 
     return OK;
 }
 
+// Number of candidate positions filtered at once when searching for a substring
+#define SCAN_WIDTH 16L
+
 /**
- * Helper method to perform a forward string comparison between `src` and `subStr`. Returns TRUE if
- * the strings match, FALSE if not. In addition, the number of characters that are compared between
- * the two strings before result is calculated is also stored in `compared`.
+ * Returns a bitmask of the SCAN_WIDTH positions starting at `str` where the substring `sub` of
+ * length `subLen` may begin, judging by its first and last characters only; bit i is set if both
+ * `str[i]` and `str[i + subLen - 1]` match. The caller must ensure that all of the characters read
+ * lie within the builder.
  */
-static Boolean _compare_str_forward(char *str, char *subStr, int subLen, int *compared) {
-
-    int i;
-    char *c1, *c2;
-
-    /*
-     * Loops through both strings, comparing each character until one of the following conditions
-     * are met:
-     *   1.) The characters in both strings don't match
-     *   2.) We reach the end of the first string
-     *   3.) We reach the end of the substring
-     */
-    for (i = 0, c1 = str, c2 = subStr; *c1 != '\0' && *c2 != '\0' && *c1 == *c2; c1++, c2++, i++);
-    *compared = i;
-
-    // String is a match if number of characters compared equals the substring's length
-    return i == subLen ? TRUE : FALSE;
+static uint32_t _candidate_mask(const char *str, const char *sub, long subLen) {
+#if defined(__SSE2__)
+    __m128i first = _mm_loadu_si128((const __m128i *)str);
+    __m128i last = _mm_loadu_si128((const __m128i *)(str + subLen - 1));
+    __m128i match = _mm_and_si128(_mm_cmpeq_epi8(first, _mm_set1_epi8(sub[0])),
+                                  _mm_cmpeq_epi8(last, _mm_set1_epi8(sub[subLen - 1])));
+    return (uint32_t)_mm_movemask_epi8(match);
+#else
+    uint32_t mask = 0U;
+    long i;
+    for (i = 0L; i < SCAN_WIDTH; i++) {
+        if (str[i] == sub[0] && str[i + subLen - 1] == sub[subLen - 1]) {
+            mask |= ( 1U << i );
+        }
+    }
+    return mask;
+#endif
 }
 
 /**
@@ -670,31 +1495,39 @@ static long _search_first_occurrence(StringBuilder *builder, char *sub, long sta
         return -1L;
     }
 
-    long i;
-    int compared;
-    int subLen = _get_str_length(sub);
-    if (subLen == 0) {
+    long i, j, subLen = (long)strlen(sub);
+    uint32_t bits;
+    if (subLen == 0L) {
         // Base case - substring is empty, so return the starting index
         return start;
     }
     if (start < 0) {
         start = 0;
     }
+    if (builder->chunked == TRUE) {
+        return _rope_search_first(builder, sub, subLen, start);
+    }
 
-    // Loop through the string, starting from first character
-    for (i = start; i < builder->index; i++) {
-        // Characters match, starts a search in the string
-        if (builder->str[i] == sub[0]) {
-            Boolean matched = _compare_str_forward(builder->str + i, sub, subLen, &compared);
-            if (matched == TRUE) {
-                // Return starting index of substring if match is found
-                return i;
-            } else {
-                // If not a match, can skip over these searched characters to save some work
-                i += compared;
+    // The last index a match can start at, so that it still fits inside the builder
+    char *str = builder->str;
+    long last = ( builder->index - subLen );
+
+    // Filters a block of candidates at a time, only comparing those whose first and last
+    // characters both match
+    for (i = start; i + SCAN_WIDTH - 1L <= last; i += SCAN_WIDTH) {
+        for (bits = _candidate_mask(str + i, sub, subLen); bits != 0U; bits &= ( bits - 1U )) {
+            j = ( i + __builtin_ctz(bits) );
+            if (memcmp(str + j, sub, subLen) == 0) {
+                return j;
             }
         }
     }
+    // Checks the few candidates left over, one at a time
+    for (; i <= last; i++) {
+        if (str[i] == sub[0] && memcmp(str + i, sub, subLen) == 0) {
+            return i;
+        }
+    }
 
     return -1L;
 }
@@ -709,34 +1542,6 @@ long string_builder_indexOfFrom(StringBuilder *builder, char *str, long fromInde
     return _search_first_occurrence(builder, str, fromIndex);
 }
 
-/**
- * Helper method to perform a backwards string comparison between `src` and `subStr`. To better
- * assist with backwards comparison, caller should provide `strIdx` being the last index of `str`,
- * and `subLen` being the length of `subStr`. Returns TRUE if the strings match, FALSE if not. In
- * addition, the number of characters that are compared between the two strings before result is
- * calculated is also stored in `compared`.
- */
-static Boolean _compare_str_backward(char *str, long strIdx, char *subStr, int subLen,
-                                     int *compared) {
-
-    int i;
-    int subIdx = subLen - 1;
-
-    /*
-     * Loops through both strings backwards, comparing each character until one of the following
-     * conditions are met:
-     *   1.) The characters in both strings don't match
-     *   2.) We reach the start of the first string
-     *   3.) We reach the start of the substring
-     */
-    for (i = 0; ( str[strIdx] == subStr[subIdx] ) && ( strIdx >= 0 ) && ( subIdx >= 0 );
-        i++, strIdx--, subIdx--);
-    *compared = i;
-
-    // String is a match if number of characters compared equals the substring's length
-    return i == subLen ? TRUE : FALSE;
-}
-
 /**
  * Helper method to search the string builder `builder` for the last occurence of the substring
  * `sub`, starting from index `start`. Returns the starting index in builder where last occurence
@@ -750,10 +1555,9 @@ static long _search_last_occurrence(StringBuilder *builder, char *sub, long star
         return -1L;
     }
 
-    long i;
-    int compared;
-    int subLen = _get_str_length(sub);
-    if (subLen == 0) {
+    long i, j, subLen = (long)strlen(sub);
+    uint32_t bits;
+    if (subLen == 0L) {
         // Base case - substring is empty, so return the starting index
         return start;
     }
@@ -762,18 +1566,28 @@ static long _search_last_occurrence(StringBuilder *builder, char *sub, long star
         start = builder->index - 1;
     }
 
-    // Loop through the string, starting from last character
-    for (i = start; i >= 0; i--) {
-        // Characters match, starts a search in the string
-        if (builder->str[i] == sub[subLen - 1]) {
-            Boolean matched = _compare_str_backward(builder->str, i, sub, subLen, &compared);
-            if (matched == TRUE) {
-                // Return starting index of substring if match is found
-                return ( i - subLen + 1 );
-            } else {
-                // If not a match, can skip over these searched characters to save some work
-                i -= compared;
+    // A match must end by index `start`, so the last index it can start at is `high`
+    char *str = builder->str;
+    long high = ( start - subLen + 1L );
+    if (builder->chunked == TRUE) {
+        return _rope_search_last(builder, sub, subLen, high);
+    }
+
+    // Filters a block of candidates at a time from the back, checking the highest ones first
+    for (i = high - SCAN_WIDTH + 1L; i >= 0L; i -= SCAN_WIDTH) {
+        for (bits = _candidate_mask(str + i, sub, subLen); bits != 0U; ) {
+            int bit = ( 31 - __builtin_clz(bits) );
+            j = ( i + bit );
+            if (memcmp(str + j, sub, subLen) == 0) {
+                return j;
             }
+            bits &= ~( 1U << bit );
+        }
+    }
+    // Checks the few candidates left over at the front, one at a time
+    for (j = i + SCAN_WIDTH - 1L; j >= 0L; j--) {
+        if (str[j] == sub[0] && memcmp(str + j, sub, subLen) == 0) {
+            return j;
         }
     }
 
@@ -790,6 +1604,21 @@ long string_builder_lastIndexOfFrom(StringBuilder *builder, char *str, long from
     return _search_last_occurrence(builder, str, fromIndex);
 }
 
+/**
+ * Helper method to read the next character of the builder through the cursor given by the chunk
+ * `*node` and the index `*pos`, advancing the cursor. Once past the end, the null terminator is
+ * returned.
+ */
+static char _next_char(StringBuilder *builder, RopeNode **node, long *pos) {
+
+    if (builder->chunked == FALSE) {
+        return ( *pos < builder->index ) ? builder->str[(*pos)++] : '\0';
+    }
+    for (; *node != NULL && *pos == (*node)->len; *node = (*node)->next, *pos = 0L);
+
+    return ( *node != NULL ) ? (*node)->text[(*pos)++] : '\0';
+}
+
 int string_builder_compareTo(StringBuilder *builder, StringBuilder *other) {
 
     // If both builders are same object, they are equal by definition
@@ -797,18 +1626,32 @@ int string_builder_compareTo(StringBuilder *builder, StringBuilder *other) {
         return 0;
     }
 
+    if (builder->chunked == TRUE || other->chunked == TRUE) {
+        // Walks the two builders' characters with cursors, as in the loop below
+        RopeNode *nodeA = _rope_first(builder->rope), *nodeB = _rope_first(other->rope);
+        long posA = 0L, posB = 0L;
+        char chA, chB;
+        do {
+            chA = _next_char(builder, &nodeA, &posA);
+            chB = _next_char(other, &nodeB, &posB);
+        } while (( chA != '\0' ) && ( chB != '\0' ) && ( chA == chB ));
+        return chA - chB;
+    }
+
     /*
      * Proceed through both strings comparing characters at same index in both until either:
      *   1.) characters aren't equal
      *   2.) we reach end of `builder`
      *   3.) we reach end of `other`
-     * Then take difference of the next characters to get lexographical difference.
+     * Then take difference of the next characters to get lexographical difference. The lengths
+     * bound the loop rather than the terminators, as the room past the end may be written to by
+     * a reservation (see string_builder_reserveTail()).
      */
-    char *a, *b;
-    for (a = builder->str, b = other->str; ( *a != '\0' ) && ( *b != '\0' ) && ( *a == *b );
-         a++, b++);
+    char *a = builder->str, *b = other->str;
+    long i, n = ( builder->index < other->index ) ? builder->index : other->index;
+    for (i = 0L; ( i < n ) && ( a[i] != '\0' ) && ( a[i] == b[i] ); i++);
 
-    return *a - *b;
+    return ( ( i < builder->index ) ? a[i] : '\0' ) - ( ( i < other->index ) ? b[i] : '\0' );
 }
 
 Status string_builder_delete(StringBuilder *builder, long start, long end) {
@@ -827,6 +1670,22 @@ void string_builder_reverse(StringBuilder *builder) {
 
     char temp;
     long head, tail;
+    uint64_t front, back;
+
+    if (builder->chunked == TRUE) {
+        _rope_reverse(builder->rope);
+        return;
+    }
+
+    // Swaps eight characters from each end at a time, reversing each word with a byte swap
+    for (head = 0, tail = builder->index - 8; tail - head >= 8; head += 8, tail -= 8) {
+        memcpy(&front, builder->str + head, sizeof(uint64_t));
+        memcpy(&back, builder->str + tail, sizeof(uint64_t));
+        front = __builtin_bswap64(front);
+        back = __builtin_bswap64(back);
+        memcpy(builder->str + head, &back, sizeof(uint64_t));
+        memcpy(builder->str + tail, &front, sizeof(uint64_t));
+    }
 
     /*
      * Performs a loop through the builder, one character pointing at the start and another at the
@@ -834,7 +1693,7 @@ void string_builder_reverse(StringBuilder *builder) {
      * index and the last char to the previous index. Loops until the two characters intersect or
      * pass each each other.
      */
-    for (head = 0, tail = builder->index - 1; head < tail; head++, tail--) {
+    for (tail += 7; head < tail; head++, tail--) {
         temp = builder->str[head];
         builder->str[head] = builder->str[tail];
         builder->str[tail] = temp;
@@ -843,6 +1702,11 @@ void string_builder_reverse(StringBuilder *builder) {
 
 Status string_builder_ensureCapacity(StringBuilder *builder, long capacity) {
 
+    // Chunks are only allocated as the characters arrive, so there's nothing to reserve
+    if (builder->chunked == TRUE) {
+        return OK;
+    }
+
     // Only extend if capacity < newCapacity
     if (capacity > MAX_CAPACITY) {
         capacity = MAX_CAPACITY;
@@ -865,6 +1729,24 @@ Status string_builder_trimToSize(StringBuilder *builder) {
         return STRUCT_EMPTY;
     }
 
+    if (builder->chunked == TRUE) {
+        // Repacks the characters into as few chunks as possible
+        RopeNode *packed;
+        char *copy;
+        if ((copy = (char *)malloc(builder->index * sizeof(char))) == NULL) {
+            return ALLOC_FAILURE;
+        }
+        _rope_read(builder, 0L, builder->index, copy);
+        if (_rope_build(builder, copy, '\0', builder->index, &packed) == FALSE) {
+            free(copy);
+            return ALLOC_FAILURE;
+        }
+        _rope_free_chunks(builder, _rope_first(builder->rope));
+        builder->rope = packed;
+        free(copy);
+        return OK;
+    }
+
     // Only trim size down if there's still capacity leftover
     if (builder->index != builder->capacity) {
         if (_ensure_capacity(builder, builder->index) == FALSE) {
@@ -877,7 +1759,18 @@ Status string_builder_trimToSize(StringBuilder *builder) {
 
 void string_builder_clear(StringBuilder *builder) {
 
+    if (builder->chunked == TRUE) {
+        _rope_clear(builder);
+        return;
+    }
+    if (builder->mapped > 0L) {
+        // Scrubbing would copy every page of the file, the mapping is simply reused as the buffer
+        builder->str[0] = '\0';
+        builder->index = 0L;
+        return;
+    }
     _scrub_char_builder(builder->str, 0L, builder->index);
+    builder->index = 0L;
 }
 
 long string_builder_length(StringBuilder *builder) {
@@ -893,16 +1786,14 @@ long string_builder_capacity(StringBuilder *builder) {
 Status string_builder_toString(StringBuilder *builder, char **result) {
 
     Status status = OK;
-    long i;
     char *str;
     size_t bytes = ( ( builder->index + 1 ) * sizeof(char) );
 
     // Allocate memory for the string, copying over the builder if successful
+    // A rope-backed builder is only ever made contiguous here, from its chunks in order
     if ((str = (char *)malloc(bytes)) != NULL) {
-        for (i = 0; i < builder->index; i++) {
-            str[i] = builder->str[i];
-        }
-        str[i] = '\0';
+        _copy_chars(builder, 0L, builder->index, str);
+        str[builder->index] = '\0';
         *result = str;
     } else {
         status = ALLOC_FAILURE;
@@ -911,9 +1802,353 @@ Status string_builder_toString(StringBuilder *builder, char **result) {
     return status;
 }
 
+const char *string_builder_data(StringBuilder *builder, long *len) {
+
+    *len = builder->index;
+    return ( builder->chunked == TRUE ) ? NULL : builder->str;
+}
+
+long string_builder_segments(StringBuilder *builder, struct iovec *segments, long max) {
+
+    long count = 0L;
+
+    if (builder->chunked == FALSE) {
+        // The whole builder is one segment, unless it's empty
+        if (builder->index == 0L) {
+            return 0L;
+        }
+        if (max > 0L) {
+            segments[0].iov_base = builder->str;
+            segments[0].iov_len = builder->index;
+        }
+        return 1L;
+    }
+
+    // Each chunk of the rope makes up a segment, the ones past `max` only counted
+    RopeNode *node;
+    for (node = _rope_first(builder->rope); node != NULL; node = node->next, count++) {
+        if (count < max) {
+            segments[count].iov_base = node->text;
+            segments[count].iov_len = node->len;
+        }
+    }
+
+    return count;
+}
+
+// The number of characters read at a time into a rope, or when the input's size is not known
+#define READ_SIZE 65536L
+
+Status string_builder_appendFromFd(StringBuilder *builder, int fd, long max) {
+
+    struct stat info;
+    char *buffer = NULL;
+    long remaining = ( max < 0L ) ? MAX_CAPACITY : max;
+    long want, size;
+    ssize_t n;
+
+    if (builder->chunked == TRUE) {
+        if ((buffer = (char *)malloc(READ_SIZE * sizeof(char))) == NULL) {
+            return ALLOC_FAILURE;
+        }
+    } else if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode)) {
+        /*
+         * Reserves room for the rest of a regular file up front, so that it is read straight into
+         * the buffer without any resizing. One more character is reserved when the file is read to
+         * its end, as the last read must find the end of the file.
+         */
+        off_t pos = lseek(fd, 0, SEEK_CUR);
+        size = ( (long)info.st_size - ( ( pos > 0 ) ? (long)pos : 0L ) );
+        size = ( size > remaining ) ? remaining : ( size + 1L );
+        if (size > 0L && builder->capacity - builder->index < size) {
+            if (ADD_OVERFLOWS(builder->index, size) == TRUE ||
+                _ensure_capacity(builder, builder->index + size) == FALSE) {
+                return ALLOC_FAILURE;
+            }
+        }
+    }
+
+    while (remaining > 0L) {
+        if (builder->chunked == TRUE) {
+            // Rope chunks are filled from a buffer, as the read would otherwise span chunks
+            want = ( remaining < READ_SIZE ) ? remaining : READ_SIZE;
+            n = read(fd, buffer, want);
+            if (n > 0 && _rope_insert(builder, builder->index, buffer, '\0', n) != OK) {
+                free(buffer);
+                return ALLOC_FAILURE;
+            }
+        } else {
+            if (builder->index == builder->capacity) {
+                // Out of room, so grows by at least another read's worth of characters
+                want = ( remaining < READ_SIZE ) ? remaining : READ_SIZE;
+                long increment = _compute_next_capacity_increase(builder, want);
+                if (increment < 0L ||
+                    _ensure_capacity(builder, builder->capacity + increment) == FALSE) {
+                    return ALLOC_FAILURE;
+                }
+            }
+            want = ( builder->capacity - builder->index );
+            want = ( want < remaining ) ? want : remaining;
+            if ((n = read(fd, builder->str + builder->index, want)) > 0) {
+                builder->index += n;
+                builder->str[builder->index] = '\0';
+            }
+        }
+
+        if (n == 0) {
+            break;
+        } else if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            free(buffer);
+            return IO_FAILURE;
+        }
+        remaining -= n;
+    }
+    free(buffer);
+
+    return OK;
+}
+
+Status string_builder_appendFile(StringBuilder *builder, const char *path) {
+
+    Status status;
+    int fd;
+
+    if ((fd = open(path, O_RDONLY)) < 0) {
+        return IO_FAILURE;
+    }
+    status = string_builder_appendFromFd(builder, fd, -1L);
+    close(fd);
+
+    return status;
+}
+
+// The number of segments handed to each call of writev()
+#define WRITE_SEGMENTS 64
+
+/**
+ * Writes out all of the `count` segments in `segments` to the descriptor `fd`, calling writev()
+ * again after a partial write for the rest. Returns TRUE if successful, FALSE if a write fails.
+ */
+static Boolean _write_segments(int fd, struct iovec *segments, int count) {
+
+    ssize_t n;
+
+    while (count > 0) {
+        if ((n = writev(fd, segments, count)) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return FALSE;
+        }
+
+        // Skips over the segments written in full, then over the part written of the next one
+        for (; count > 0 && (size_t)n >= segments->iov_len; count--, segments++) {
+            n -= segments->iov_len;
+        }
+        if (count > 0) {
+            segments->iov_base = (char *)segments->iov_base + n;
+            segments->iov_len -= n;
+        }
+    }
+
+    return TRUE;
+}
+
+Status string_builder_writeTo(StringBuilder *builder, int fd) {
+
+    struct iovec segments[WRITE_SEGMENTS];
+    RopeNode *node;
+    int count;
+
+    if (builder->chunked == FALSE) {
+        segments[0].iov_base = builder->str;
+        segments[0].iov_len = builder->index;
+        return ( _write_segments(fd, segments, ( builder->index > 0L ) ? 1 : 0) == TRUE ) ?
+               OK : IO_FAILURE;
+    }
+
+    // Gathers the rope's chunks into batches, each written with a single call
+    for (node = _rope_first(builder->rope); node != NULL; ) {
+        for (count = 0; node != NULL && count < WRITE_SEGMENTS; node = node->next, count++) {
+            segments[count].iov_base = node->text;
+            segments[count].iov_len = node->len;
+        }
+        if (_write_segments(fd, segments, count) == FALSE) {
+            return IO_FAILURE;
+        }
+    }
+
+    return OK;
+}
+
+/**
+ * Frees the builder's contiguous buffer, or unmaps it if it was mapped from a file.
+ */
+static void _release_buffer(StringBuilder *builder) {
+
+    if (builder->mapped > 0L) {
+        munmap(builder->str, builder->mapped);
+        builder->mapped = 0L;
+    } else if (builder->str != builder->small) {
+        allocator_free(builder->allocator, builder->str);
+    }
+}
+
+Status string_builder_detach(StringBuilder *builder, char **result) {
+
+    char *str;
+
+    if (builder->chunked == TRUE) {
+        // The chunks have to be joined into one string, after which they are no longer needed
+        if (string_builder_toString(builder, &str) != OK) {
+            return ALLOC_FAILURE;
+        }
+        _rope_clear(builder);
+        *result = str;
+        return OK;
+    }
+
+    if (builder->mapped > 0L || builder->str == builder->small ||
+        builder->allocator != allocator_default()) {
+        // A mapped file, the builder's own buffer or one from another allocator can't be handed
+        // to free(), so the characters are copied out instead
+        if (string_builder_toString(builder, result) != OK) {
+            return ALLOC_FAILURE;
+        }
+        _release_buffer(builder);
+    } else {
+        // The buffer is always null-terminated, so it is handed over as is
+        *result = builder->str;
+    }
+
+    // The builder starts over in its own buffer
+    builder->small[0] = '\0';
+    builder->str = builder->small;
+    builder->index = 0L;
+    builder->capacity = INLINE_CAPACITY;
+
+    return OK;
+}
+
+// The number of released builders each thread keeps around for reuse
+#ifndef CDS_BUILDER_POOL_SIZE
+#define CDS_BUILDER_POOL_SIZE 8
+#endif
+// The largest capacity a pooled builder keeps, larger buffers are cut back down when released
+#ifndef CDS_BUILDER_POOL_CAPACITY
+#define CDS_BUILDER_POOL_CAPACITY 65536L
+#endif
+
+/**
+ * A thread's cache of released builders.
+ */
+typedef struct {
+    StringBuilder *items[CDS_BUILDER_POOL_SIZE];    // The builders ready to be acquired again
+    int len;                                        // The number of builders held
+} BuilderPool;
+
+// The calling thread's cache of builders, created on its first release
+static __thread BuilderPool *localPool = NULL;
+// Key whose destructor frees a thread's cache when the thread exits
+static pthread_key_t poolKey;
+static pthread_once_t poolKeyOnce = PTHREAD_ONCE_INIT;
+
+/**
+ * Destroys every builder in the cache `pool`, then the cache itself.
+ */
+static void _free_pool(void *pool) {
+
+    BuilderPool *temp = (BuilderPool *)pool;
+    while (temp->len > 0) {
+        string_builder_destroy(temp->items[--(temp->len)]);
+    }
+    free(temp);
+}
+
+/**
+ * Creates the key used to free the threads' caches on exit.
+ */
+static void _create_pool_key(void) {
+    (void)pthread_key_create(&poolKey, _free_pool);
+}
+
+Status string_builder_acquire(StringBuilder **builder) {
+
+    // Reuses a builder released earlier by this thread, along with its buffer
+    if (localPool != NULL && localPool->len > 0) {
+        *builder = localPool->items[--(localPool->len)];
+        return OK;
+    }
+    return string_builder_new(builder, 0L, 0.0f, NULL);
+}
+
+void string_builder_release(StringBuilder *builder) {
+
+    // Only contiguous builders on the heap are kept, and only up to the cache's size
+    if (localPool == NULL && builder->chunked == FALSE && builder->mapped == 0L) {
+        pthread_once(&poolKeyOnce, _create_pool_key);
+        if ((localPool = (BuilderPool *)malloc(sizeof(BuilderPool))) != NULL) {
+            localPool->len = 0;
+            (void)pthread_setspecific(poolKey, localPool);
+        }
+    }
+    if (localPool == NULL || localPool->len == CDS_BUILDER_POOL_SIZE ||
+        builder->chunked == TRUE || builder->mapped > 0L) {
+        string_builder_destroy(builder);
+        return;
+    }
+
+    string_builder_clear(builder);
+    if (builder->capacity > CDS_BUILDER_POOL_CAPACITY) {
+        // Outlier buffers are cut back down instead of being hoarded by the thread
+        if (_ensure_capacity(builder, CDS_BUILDER_POOL_CAPACITY) == FALSE) {
+            string_builder_destroy(builder);
+            return;
+        }
+        builder->index = 0L;
+        builder->str[0] = '\0';
+    }
+    builder->growthFactor = DEFAULT_GROWTH_FACTOR;
+    localPool->items[(localPool->len)++] = builder;
+}
+
+void string_builder_freePool(void) {
+
+    if (localPool != NULL) {
+        (void)pthread_setspecific(poolKey, NULL);
+        _free_pool(localPool);
+        localPool = NULL;
+    }
+}
+
+long string_builder_memoryUsage(StringBuilder *builder) {
+
+    long bytes = (long)sizeof(StringBuilder);
+
+    // A chunked builder's capacity counts the characters of its chunks
+    if (builder->chunked == TRUE) {
+        return bytes + ( builder->capacity / ROPE_CHUNK ) * (long)sizeof(RopeNode);
+    }
+    if (builder->mapped > 0L) {
+        return bytes + builder->mapped;
+    }
+
+    return ( builder->str != builder->small ) ? bytes + builder->capacity : bytes;
+}
+
 void string_builder_destroy(StringBuilder *builder) {
 
-    _scrub_char_builder(builder->str, 0, builder->index);
-    free(builder->str);
-    free(builder);
+    if (builder->chunked == TRUE) {
+        _rope_clear(builder);
+        allocator_free(builder->allocator, builder);
+        return;
+    }
+    if (builder->mapped == 0L) {
+        _scrub_char_builder(builder->str, 0, builder->index);
+    }
+    _release_buffer(builder);
+    allocator_free(builder->allocator, builder);
 }
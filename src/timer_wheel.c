@@ -0,0 +1,454 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2020 Cole Vikupitz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <stdlib.h>
+#include "timer_wheel.h"
+#include "circular_list.h"
+#include "heap.h"
+#include "node_pool.h"
+
+/**
+ * Struct for a timer in the TimerWheel ADT, linked into a list or held in the overflow heap.
+ */
+typedef struct wheel_timer {
+    ListLink link;              // Links the timer into its list, holding the timer itself
+    CircularList *list;         // The list the timer is linked into, NULL if in the overflow heap
+    int level;                  // The wheel level of the timer's slot, or -1 if in no slot
+    int slot;                   // The index of the timer's slot within its level
+    HeapHandle handle;          // The timer's handle in the overflow heap, if held there
+    uint64_t deadline;          // The time the timer expires at
+    void *item;                 // Points to the timer's item
+    uint64_t sequence;          // The number the timer was scheduled under, 0 once freed
+} WheelTimer;
+
+// Number of bits of the deadline each level of the wheel resolves
+#define SLOT_BITS 6
+// Number of slots in each level of the wheel
+#define SLOTS (1 << SLOT_BITS)
+// Number of levels in the wheel
+#define LEVELS 4
+// Number of timers carved out of each slab of the timer pool
+#define TIMERS_PER_SLAB 1024L
+
+/**
+ * The struct for the TimerWheel ADT.
+ */
+struct timer_wheel {
+    CircularList *slots[LEVELS][SLOTS];     // The wheel's slots, each an intrusive list of timers
+    uint64_t occupied[LEVELS];      // Bitmaps of the non-empty slots of each level
+    CircularList *overdue;          // Timers scheduled for a time that had already passed
+    CircularList *due;              // Timers being expired by the running timerwheel_advance()
+    Heap *overflow;                 // Timers whose deadlines lie beyond the wheel's range
+    NodePool *pool;                 // Private pool the timers are allocated from
+    uint64_t now;                   // The wheel's current time
+    uint64_t sequence;              // The number the last timer was scheduled under
+    long size;                      // Number of pending timers
+};
+
+// Macro to fetch the index of the slot a time `t` falls into on level `l`
+#define SLOT_OF(t, l)  ( (int)(((t) >> ((l) * SLOT_BITS)) & (SLOTS - 1)) )
+// Macro to check if the handle `h` still refers to a pending timer
+#define PENDING(h)  ( ((h).timer != NULL && (h).timer->sequence == (h).sequence) ? TRUE : FALSE )
+
+/**
+ * Orders the timers in the overflow heap by their deadlines.
+ */
+static int _compare_deadlines(void *a, void *b) {
+    uint64_t x = ((WheelTimer *)a)->deadline, y = ((WheelTimer *)b)->deadline;
+    return ( x > y ) - ( x < y );
+}
+
+/**
+ * Returns the wheel level a deadline belongs on at the time `now`: the level of the highest bit the
+ * two differ in, so that every timer of a level expires after all the timers of the levels below
+ * it. Returns -1 if the deadline has already passed, or LEVELS or more if it is beyond the wheel.
+ */
+static int _level_of(uint64_t deadline, uint64_t now) {
+    if (deadline <= now) {
+        return -1;
+    }
+    return (63 - __builtin_clzl(deadline ^ now)) / SLOT_BITS;
+}
+
+/**
+ * Files the unfiled timer under its deadline relative to the wheel's current time, into `late` if
+ * the deadline has already passed.
+ */
+static Status _place(TimerWheel *wheel, WheelTimer *timer, CircularList *late) {
+
+    int level = _level_of(timer->deadline, wheel->now);
+
+    timer->level = -1;
+    if (level < 0) {
+        timer->list = late;
+        circularlist_linkLast(late, &timer->link, timer);
+        return OK;
+    }
+    if (level >= LEVELS) {
+        timer->list = NULL;
+        return heap_insertHandle(wheel->overflow, timer, &timer->handle);
+    }
+
+    timer->level = level;
+    timer->slot = SLOT_OF(timer->deadline, level);
+    timer->list = wheel->slots[level][timer->slot];
+    circularlist_linkLast(timer->list, &timer->link, timer);
+    wheel->occupied[level] |= 1UL << timer->slot;
+    return OK;
+}
+
+/**
+ * Takes the timer out of wherever it is filed.
+ */
+static void _unplace(TimerWheel *wheel, WheelTimer *timer) {
+
+    void *item;
+
+    if (timer->list == NULL) {
+        heap_removeHandle(wheel->overflow, timer->handle, &item);
+        return;
+    }
+    circularlist_removeHandle(timer->list, &timer->link);
+    if (timer->level >= 0 && circularlist_isEmpty(timer->list) == TRUE) {
+        wheel->occupied[timer->level] &= ~(1UL << timer->slot);
+    }
+}
+
+/**
+ * Returns the unfiled timer to the pool, leaving its handles stale.
+ */
+static void _free_timer(TimerWheel *wheel, WheelTimer *timer) {
+    timer->sequence = 0UL;
+    nodepool_free(wheel->pool, timer, sizeof(WheelTimer));
+    wheel->size--;
+}
+
+/**
+ * Unfiles every timer of the list, and files it again relative to the wheel's current time.
+ */
+static void _cascade(TimerWheel *wheel, CircularList *list) {
+
+    ListLink *link;
+
+    while ((link = circularlist_firstHandle(list)) != NULL) {
+        circularlist_removeHandle(list, link);
+        _place(wheel, (WheelTimer *)link->data, wheel->due);
+    }
+}
+
+/**
+ * Frees every timer of the list, invoking `destructor` on their items if not NULL.
+ */
+static void _free_list(TimerWheel *wheel, CircularList *list, void (*destructor)(void *)) {
+
+    ListLink *link;
+
+    while ((link = circularlist_firstHandle(list)) != NULL) {
+        WheelTimer *timer = (WheelTimer *)circularlist_removeHandle(list, link);
+        if (destructor != NULL) {
+            destructor(timer->item);
+        }
+        _free_timer(wheel, timer);
+    }
+}
+
+/**
+ * Frees the wheel's lists, heap and pool, each of which may not have been allocated.
+ */
+static void _free_wheel(TimerWheel *wheel) {
+
+    int i, j;
+
+    for (i = 0; i < LEVELS; i++) {
+        for (j = 0; j < SLOTS; j++) {
+            if (wheel->slots[i][j] != NULL) {
+                circularlist_destroy(wheel->slots[i][j], NULL);
+            }
+        }
+    }
+    if (wheel->overdue != NULL) {
+        circularlist_destroy(wheel->overdue, NULL);
+    }
+    if (wheel->due != NULL) {
+        circularlist_destroy(wheel->due, NULL);
+    }
+    if (wheel->overflow != NULL) {
+        heap_destroy(wheel->overflow, NULL);
+    }
+    if (wheel->pool != NULL) {
+        nodepool_destroy(wheel->pool);
+    }
+    free(wheel);
+}
+
+Status timerwheel_new(TimerWheel **wheel, uint64_t now) {
+
+    int i, j;
+    Status status = OK;
+
+    // Allocate the struct zeroed, so a partly built wheel can be freed
+    TimerWheel *temp = (TimerWheel *)calloc(1, sizeof(TimerWheel));
+    if (temp == NULL) {
+        return ALLOC_FAILURE;
+    }
+
+    // Create the slots, the other lists, the overflow heap and the timer pool
+    for (i = 0; i < LEVELS && status == OK; i++) {
+        for (j = 0; j < SLOTS && status == OK; j++) {
+            status = circularlist_newIntrusive(&(temp->slots[i][j]));
+        }
+    }
+    if (status != OK || circularlist_newIntrusive(&(temp->overdue)) != OK ||
+            circularlist_newIntrusive(&(temp->due)) != OK ||
+            heap_new(&(temp->overflow), 0L, _compare_deadlines) != OK ||
+            nodepool_new(&(temp->pool), TIMERS_PER_SLAB) != OK) {
+        _free_wheel(temp);
+        return ALLOC_FAILURE;
+    }
+
+    temp->now = now;
+    *wheel = temp;
+
+    return OK;
+}
+
+Status timerwheel_schedule(TimerWheel *wheel, uint64_t deadline, void *item, TimerHandle *handle) {
+
+    // Allocate the timer from the pool, check for allocation failure
+    WheelTimer *timer = (WheelTimer *)nodepool_alloc(wheel->pool, sizeof(WheelTimer));
+    if (timer == NULL) {
+        return ALLOC_FAILURE;
+    }
+
+    // File the timer under its deadline
+    timer->deadline = deadline;
+    timer->item = item;
+    if (_place(wheel, timer, wheel->overdue) != OK) {
+        nodepool_free(wheel->pool, timer, sizeof(WheelTimer));
+        return ALLOC_FAILURE;
+    }
+    timer->sequence = ++(wheel->sequence);
+    wheel->size++;
+
+    if (handle != NULL) {
+        handle->timer = timer;
+        handle->sequence = timer->sequence;
+    }
+
+    return OK;
+}
+
+Status timerwheel_reschedule(TimerWheel *wheel, TimerHandle handle, uint64_t deadline) {
+
+    WheelTimer *timer = handle.timer;
+    uint64_t previous;
+
+    if (PENDING(handle) == FALSE) {
+        return NOT_FOUND;
+    }
+
+    // A timer staying in the overflow heap is simply moved within it
+    previous = timer->deadline;
+    timer->deadline = deadline;
+    if (timer->list == NULL && _level_of(deadline, wheel->now) >= LEVELS) {
+        return heap_update(wheel->overflow, timer->handle, timer);
+    }
+
+    _unplace(wheel, timer);
+    if (_place(wheel, timer, wheel->overdue) != OK) {
+        // Only filing into the heap can fail, so the timer came from a slot and can go back there
+        timer->deadline = previous;
+        _place(wheel, timer, wheel->overdue);
+        return ALLOC_FAILURE;
+    }
+
+    return OK;
+}
+
+Status timerwheel_cancel(TimerWheel *wheel, TimerHandle handle, void **item) {
+
+    if (PENDING(handle) == FALSE) {
+        return NOT_FOUND;
+    }
+
+    _unplace(wheel, handle.timer);
+    *item = handle.timer->item;
+    _free_timer(wheel, handle.timer);
+
+    return OK;
+}
+
+long timerwheel_advance(TimerWheel *wheel, uint64_t now,
+                        void (*expire)(void *, uint64_t, void *), void *context) {
+
+    uint64_t then = wheel->now, pending;
+    long expired = 0L;
+    ListLink *link;
+    void *top;
+    int level, slot;
+
+    // Timers scheduled late expire along with the others
+    _cascade(wheel, wheel->overdue);
+
+    if (now > then) {
+        wheel->now = now;
+
+        // Refile the slots the clock has passed on each level, each one coarser than the last
+        for (level = 0; level < LEVELS; level++) {
+            if ((then >> (level * SLOT_BITS)) == (now >> (level * SLOT_BITS))) {
+                break;
+            }
+            // Within the same span of the level above, only the slots up to now's are passed
+            if ((then >> ((level + 1) * SLOT_BITS)) == (now >> ((level + 1) * SLOT_BITS))) {
+                pending = ((2UL << SLOT_OF(now, level)) - 1UL) &
+                          ~((2UL << SLOT_OF(then, level)) - 1UL);
+            } else {
+                pending = ~0UL;
+            }
+            pending &= wheel->occupied[level];
+            wheel->occupied[level] &= ~pending;
+            while (pending != 0UL) {
+                slot = __builtin_ctzl(pending);
+                pending &= pending - 1UL;
+                _cascade(wheel, wheel->slots[level][slot]);
+            }
+        }
+
+        // Move the overflow timers the wheel's range now reaches into the wheel
+        while (heap_peek(wheel->overflow, &top) == OK &&
+                _level_of(((WheelTimer *)top)->deadline, now) < LEVELS) {
+            heap_poll(wheel->overflow, &top);
+            _place(wheel, (WheelTimer *)top, wheel->due);
+        }
+    }
+
+    // Expire the due timers, each taken out first so the callback may use the wheel
+    while ((link = circularlist_firstHandle(wheel->due)) != NULL) {
+        WheelTimer *timer = (WheelTimer *)circularlist_removeHandle(wheel->due, link);
+        void *item = timer->item;
+        uint64_t deadline = timer->deadline;
+        _free_timer(wheel, timer);
+        expired++;
+        if (expire != NULL) {
+            expire(item, deadline, context);
+        }
+    }
+
+    return expired;
+}
+
+Status timerwheel_nextDeadline(TimerWheel *wheel, uint64_t *deadline) {
+
+    ListLink *link, *first;
+    void *top;
+    int level;
+
+    if (wheel->size == 0L) {
+        return STRUCT_EMPTY;
+    }
+
+    // Overdue timers come first, otherwise the lowest occupied slot of the lowest level
+    CircularList *list = ( circularlist_isEmpty(wheel->overdue) == FALSE ) ? wheel->overdue : NULL;
+    for (level = 0; level < LEVELS && list == NULL; level++) {
+        if (wheel->occupied[level] != 0UL) {
+            list = wheel->slots[level][__builtin_ctzl(wheel->occupied[level])];
+        }
+    }
+    if (list == NULL) {
+        heap_peek(wheel->overflow, &top);
+        *deadline = ((WheelTimer *)top)->deadline;
+        return OK;
+    }
+
+    // Timers in coarser slots still expire at different times within the slot
+    first = circularlist_firstHandle(list);
+    *deadline = ((WheelTimer *)first->data)->deadline;
+    for (link = first->next; link != first; link = link->next) {
+        if (((WheelTimer *)link->data)->deadline < *deadline) {
+            *deadline = ((WheelTimer *)link->data)->deadline;
+        }
+    }
+
+    return OK;
+}
+
+uint64_t timerwheel_now(TimerWheel *wheel) {
+    return wheel->now;
+}
+
+long timerwheel_size(TimerWheel *wheel) {
+    return wheel->size;
+}
+
+Boolean timerwheel_isEmpty(TimerWheel *wheel) {
+    return ( wheel->size == 0L ) ? TRUE : FALSE;
+}
+
+void timerwheel_clear(TimerWheel *wheel, void (*destructor)(void *)) {
+
+    int level, slot;
+    void *top;
+
+    for (level = 0; level < LEVELS; level++) {
+        while (wheel->occupied[level] != 0UL) {
+            slot = __builtin_ctzl(wheel->occupied[level]);
+            wheel->occupied[level] &= wheel->occupied[level] - 1UL;
+            _free_list(wheel, wheel->slots[level][slot], destructor);
+        }
+    }
+    _free_list(wheel, wheel->overdue, destructor);
+    _free_list(wheel, wheel->due, destructor);
+    while (heap_poll(wheel->overflow, &top) == OK) {
+        if (destructor != NULL) {
+            destructor(((WheelTimer *)top)->item);
+        }
+        _free_timer(wheel, (WheelTimer *)top);
+    }
+}
+
+long timerwheel_memoryUsage(TimerWheel *wheel) {
+
+    long bytes = (long)sizeof(TimerWheel) + nodepool_memoryUsage(wheel->pool) +
+                 heap_memoryUsage(wheel->overflow);
+    int i, j;
+
+    for (i = 0; i < LEVELS; i++) {
+        for (j = 0; j < SLOTS; j++) {
+            bytes += circularlist_memoryUsage(wheel->slots[i][j]);
+        }
+    }
+
+    return bytes + circularlist_memoryUsage(wheel->overdue) +
+           circularlist_memoryUsage(wheel->due);
+}
+
+void timerwheel_destroy(TimerWheel *wheel, void (*destructor)(void *)) {
+
+    // Only items need visiting, the timers themselves go with the pool
+    if (destructor != NULL) {
+        timerwheel_clear(wheel, destructor);
+    }
+    _free_wheel(wheel);
+}
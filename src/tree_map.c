@@ -22,7 +22,11 @@
  * SOFTWARE.
  */
 
+#include <pthread.h>
 #include <stdlib.h>
+#include <string.h>
+#include "cds_stats.h"
+#include "snapshot.h"
 #include "tree_map.h"
 
 /**
@@ -41,9 +45,57 @@ typedef struct node {
     struct node *left;          // Pointer to the left child node
     struct node *right;         // Pointer to the right child node
     char color;                 // The node's current color (RED or BLACK)
-    TmEntry *entry;             // Pointer to the treemap entry
+    long count;                 // Number of nodes in the subtree rooted at this node
+    TmEntry entry;              // The treemap entry, stored inline; handed out as `&entry`
 } Node;
 
+// Largest number of entries held by a B+-tree leaf
+#define LEAF_MAX 32
+// Smallest number of entries held by a B+-tree leaf other than the root
+#define LEAF_MIN ( LEAF_MAX / 2 )
+// Largest number of children of a B+-tree inner node
+#define INNER_MAX 32
+// Smallest number of keys held by a B+-tree inner node other than the root
+#define INNER_MIN ( INNER_MAX / 2 - 1 )
+// Deepest path through a B+-tree; wide nodes keep real trees far shallower
+#define MAX_DEPTH 32
+
+/**
+ * Header shared by the leaf and inner nodes of the B+-tree engine.
+ */
+typedef struct bt_node {
+    Boolean leaf;                       // TRUE if the node is a BtLeaf, FALSE if a BtInner
+    int count;                          // Number of entries in a leaf, or of keys in an inner node
+} BtNode;
+
+/**
+ * Struct for a leaf of the B+-tree engine, holding the entries inline.
+ */
+typedef struct bt_leaf {
+    BtNode header;                      // The node's header
+    struct bt_leaf *prev;               // The previous leaf in key order
+    struct bt_leaf *next;               // The next leaf in key order
+    TmEntry entries[LEAF_MAX + 1];      // The sorted entries, with room for one before splitting
+} BtLeaf;
+
+/**
+ * Struct for an inner node of the B+-tree engine. Each key `keys[i]` is the smallest key stored
+ * under `children[i + 1]`, so separators never outlive the entries they were copied from.
+ */
+typedef struct bt_inner {
+    BtNode header;                      // The node's header
+    void *keys[INNER_MAX];              // The separator keys, with room for one before splitting
+    BtNode *children[INNER_MAX + 1];    // The children, with room for one before splitting
+} BtInner;
+
+/**
+ * One step of a path from the root of the B+-tree down to a leaf.
+ */
+typedef struct {
+    BtInner *node;                      // The inner node passed through
+    int index;                          // The index of the child descended into
+} BtStep;
+
 /*
  * Struct for the treemap ADT.
  */
@@ -52,6 +104,13 @@ struct treemap {
     void (*keyDxn)(void *);             // Function for destroying treemap keys
     Node *root;                         // Pointer to the tree's root node
     long size;                          // The treemap's current size
+    NodePool *pool;                     // Allocates the nodes
+    Boolean ownsPool;                   // TRUE if `pool` is private to the treemap
+    const CdsAllocator *allocator;      // Allocates the struct, the B+-tree nodes and private pool
+    long modCount;                      // Number of structural modifications made
+    BtNode *btRoot;                     // Root of the B+-tree engine, or NULL if red-black
+    BtLeaf *btHead;                     // First leaf of the B+-tree engine
+    BtLeaf *btTail;                     // Last leaf of the B+-tree engine
 };
 
 /*
@@ -68,57 +127,612 @@ typedef struct {
 #define BLACK 1
 // Macro for evaluating the color of the given node `n`
 #define COLOR(n) ( ( (n) != NULL ) ? n->color : BLACK )
+// Macro for evaluating the size of the subtree rooted at the given node `n`
+#define COUNT(n) ( ( (n) != NULL ) ? (n)->count : 0L )
 
-Status treemap_new(TreeMap **tree, int (*keyComparator)(void *, void *),
-                   void (*keyDestructor)(void *)) {
+/**
+ * Helper method to create a new treemap whose nodes come from `pool`, or from a private pool
+ * allocated through `allocator` if NULL (the default allocator, if also NULL).
+ */
+static Status _new_tree(TreeMap **tree, int (*keyComparator)(void *, void *),
+                        void (*keyDestructor)(void *), NodePool *pool,
+                        const CdsAllocator *allocator) {
+
+    if (allocator == NULL) {
+        allocator = allocator_default();
+    }
 
     // Allocate the struct, check for allocation failures
-    TreeMap *temp = (TreeMap *)malloc(sizeof(TreeMap));
+    TreeMap *temp = (TreeMap *)allocator_alloc(allocator, sizeof(TreeMap));
     if (temp == NULL) {
         return ALLOC_FAILURE;
     }
 
+    // Creates a private pool for the nodes unless one was provided
+    temp->ownsPool = ( pool == NULL ) ? TRUE : FALSE;
+    if (pool == NULL && nodepool_newWithAllocator(&pool, 0L, allocator) != OK) {
+        allocator_free(allocator, temp);
+        return ALLOC_FAILURE;
+    }
+    temp->pool = pool;
+    temp->allocator = allocator;
+
     // Initialize remaining struct members
     temp->keyCmp = keyComparator;
     temp->keyDxn = keyDestructor;
     temp->root = NULL;
     temp->size = 0L;
+    temp->modCount = 0L;
+    temp->btRoot = NULL;
+    temp->btHead = NULL;
+    temp->btTail = NULL;
     *tree = temp;
 
     return OK;
 }
 
+Status treemap_newWithPool(TreeMap **tree, int (*keyComparator)(void *, void *),
+                           void (*keyDestructor)(void *), NodePool *pool) {
+    return _new_tree(tree, keyComparator, keyDestructor, pool, NULL);
+}
+
+Status treemap_newWithAllocator(TreeMap **tree, int (*keyComparator)(void *, void *),
+                                void (*keyDestructor)(void *), const CdsAllocator *allocator) {
+    return _new_tree(tree, keyComparator, keyDestructor, NULL, allocator);
+}
+
+Status treemap_new(TreeMap **tree, int (*keyComparator)(void *, void *),
+                   void (*keyDestructor)(void *)) {
+    return treemap_newWithPool(tree, keyComparator, keyDestructor, NULL);
+}
+
 // Macro to check if the treemap `t` is currently empty
 #define IS_EMPTY(t)  ( ((t)->size == 0L) ? TRUE : FALSE )
+// Macros to view the B+-tree node `n` as a leaf or as an inner node
+#define LEAF(n)   ( (BtLeaf *)(n) )
+#define INNER(n)  ( (BtInner *)(n) )
+// Macro to check if the treemap `t` uses the B+-tree engine
+#define IS_BTREE(t)  ( ((t)->btRoot != NULL) ? TRUE : FALSE )
 
 /**
- * Allocates and returns a new node for the treemap with the key-value pairing `key` and `value`.
+ * Allocates and returns a new, empty B+-tree leaf for `tree` if `leaf` is TRUE or inner node if
+ * FALSE, or NULL if the allocation failed.
  */
-static Node *_malloc_node(void *key, void *value) {
+static BtNode *_bt_new_node(TreeMap *tree, Boolean leaf) {
 
-    // Allocate memory for the tree node
-    Node *node = (Node *)malloc(sizeof(Node));
+    size_t bytes = ( leaf == TRUE ) ? sizeof(BtLeaf) : sizeof(BtInner);
+    BtNode *node = (BtNode *)allocator_alloc(tree->allocator, bytes);
     if (node != NULL) {
-        // Allocate memory for the entry
-        TmEntry *entry = (TmEntry *)malloc(sizeof(TmEntry));
-        if (entry != NULL) {
-            // Initializes the node and entry members
-            node->parent = NULL;
-            node->left = NULL;
-            node->right = NULL;
-            node->color = RED;
-            entry->key = key;
-            entry->value = value;
-            node->entry = entry;
+        node->leaf = leaf;
+        node->count = 0;
+        if (leaf == TRUE) {
+            LEAF(node)->prev = NULL;
+            LEAF(node)->next = NULL;
+        }
+    }
+
+    return node;
+}
+
+Status treemap_newBTree(TreeMap **tree, int (*keyComparator)(void *, void *),
+                        void (*keyDestructor)(void *)) {
+
+    TreeMap *temp;
+    BtNode *root;
+
+    // Creates the treemap, then swaps in an empty leaf as the root
+    Status status = treemap_new(&temp, keyComparator, keyDestructor);
+    if (status != OK) {
+        return status;
+    }
+    root = _bt_new_node(temp, TRUE);
+    if (root == NULL) {
+        treemap_destroy(temp, NULL);
+        return ALLOC_FAILURE;
+    }
+    temp->btRoot = root;
+    temp->btHead = LEAF(root);
+    temp->btTail = LEAF(root);
+    *tree = temp;
+
+    return OK;
+}
+
+/**
+ * Binary searches the leaf `leaf` for the key `key`. Returns the index of the first entry whose
+ * key is not less than `key`, and sets `*found` to TRUE if that entry's key equals `key`.
+ */
+static int _bt_search_leaf(TreeMap *tree, BtLeaf *leaf, void *key, Boolean *found) {
+
+    int low = 0, high = leaf->header.count, mid, cmp;
+
+    *found = FALSE;
+    while (low < high) {
+        mid = ( low + high ) / 2;
+        cmp = (*tree->keyCmp)(key, leaf->entries[mid].key);
+        if (cmp == 0) {
+            *found = TRUE;
+            return mid;
+        }
+        if (cmp < 0) {
+            high = mid;
+        } else {
+            low = mid + 1;
+        }
+    }
+
+    return low;
+}
+
+/**
+ * Binary searches the inner node `inner`, returning the index of the child whose subtree would
+ * hold the key `key`.
+ */
+static int _bt_search_inner(TreeMap *tree, BtInner *inner, void *key) {
+
+    int low = 0, high = inner->header.count, mid;
+
+    while (low < high) {
+        mid = ( low + high ) / 2;
+        if ((*tree->keyCmp)(key, inner->keys[mid]) < 0) {
+            high = mid;
+        } else {
+            low = mid + 1;
+        }
+    }
+
+    return low;
+}
+
+/**
+ * Descends the B+-tree of `tree` to the leaf that holds (or would hold) the key `key`. If `path`
+ * is not NULL, each inner node passed through is recorded there and `*depth` is set to their count.
+ */
+static BtLeaf *_bt_find_leaf(TreeMap *tree, void *key, BtStep *path, int *depth) {
+
+    BtNode *node = tree->btRoot;
+    int d = 0, i;
+
+    while (node->leaf == FALSE) {
+        i = _bt_search_inner(tree, INNER(node), key);
+        if (path != NULL) {
+            path[d].node = INNER(node);
+            path[d].index = i;
+        }
+        d++;
+        node = INNER(node)->children[i];
+    }
+    if (depth != NULL) {
+        *depth = d;
+    }
+
+    return LEAF(node);
+}
+
+/**
+ * Returns the smallest key stored in the B+-tree subtree rooted at `node`.
+ */
+static void *_bt_first_key(BtNode *node) {
+
+    while (node->leaf == FALSE) {
+        node = INNER(node)->children[0];
+    }
+    return LEAF(node)->entries[0].key;
+}
+
+/**
+ * Returns the last entry of the leaf before `leaf`, or NULL if there is none.
+ */
+static TmEntry *_bt_prev_entry(BtLeaf *leaf) {
+    leaf = leaf->prev;
+    return ( leaf != NULL ) ? &(leaf->entries[leaf->header.count - 1]) : NULL;
+}
+
+/**
+ * Returns the first entry of the leaf after `leaf`, or NULL if there is none.
+ */
+static TmEntry *_bt_next_entry(BtLeaf *leaf) {
+    leaf = leaf->next;
+    return ( leaf != NULL ) ? &(leaf->entries[0]) : NULL;
+}
+
+/**
+ * Returns the entry of the B+-tree with the key `key` (if `exact` is TRUE), or the entry nearest
+ * to `key` in the direction given by `below` and `inclusive` otherwise; NULL if there is none.
+ */
+static TmEntry *_bt_search(TreeMap *tree, void *key, Boolean exact, Boolean below,
+                           Boolean inclusive) {
+
+    Boolean found;
+    BtLeaf *leaf = _bt_find_leaf(tree, key, NULL, NULL);
+    int i = _bt_search_leaf(tree, leaf, key, &found);
+
+    if (found == TRUE && ( exact == TRUE || inclusive == TRUE )) {
+        return &(leaf->entries[i]);
+    }
+    if (exact == TRUE) {
+        return NULL;
+    }
+    if (below == TRUE) {
+        // Entry i is the first one not below the key, so the answer precedes it
+        return ( i > 0 ) ? &(leaf->entries[i - 1]) : _bt_prev_entry(leaf);
+    }
+    // Skips past the key itself for a strict upper bound
+    if (found == TRUE) {
+        i++;
+    }
+    return ( i < leaf->header.count ) ? &(leaf->entries[i]) : _bt_next_entry(leaf);
+}
+
+/**
+ * Inserts or replaces the mapping `key` -> `value` in the B+-tree of `tree`, with the same
+ * semantics as treemap_put().
+ */
+static Status _bt_put(TreeMap *tree, void *key, void *value, void **previous) {
+
+    BtStep path[MAX_DEPTH];
+    BtNode *spare[MAX_DEPTH + 2], *child;
+    BtInner *parent, *sibling, *root;
+    BtLeaf *right;
+    Boolean found;
+    void *separator;
+    int depth, d, i, at, mid, needed = 0, used = 1;
+
+    // Replaces the value if the key is already mapped
+    BtLeaf *leaf = _bt_find_leaf(tree, key, path, &depth);
+    i = _bt_search_leaf(tree, leaf, key, &found);
+    if (found == TRUE) {
+        *previous = leaf->entries[i].value;
+        leaf->entries[i].value = value;
+        return REPLACED;
+    }
+
+    // Allocates every node the insertion splits off up front, so failures leave the tree intact
+    if (leaf->header.count == LEAF_MAX) {
+        needed = 1;
+        for (d = depth - 1; d >= 0 && path[d].node->header.count == INNER_MAX - 1; d--) {
+            needed++;
+        }
+        if (d < 0) {
+            needed++;
+        }
+    }
+    for (d = 0; d < needed; d++) {
+        spare[d] = _bt_new_node(tree, ( d == 0 ) ? TRUE : FALSE);
+        if (spare[d] == NULL) {
+            while (d > 0) {
+                allocator_free(tree->allocator, spare[--d]);
+            }
+            return ALLOC_FAILURE;
+        }
+    }
+
+    // Inserts the entry into the leaf
+    memmove(&(leaf->entries[i + 1]), &(leaf->entries[i]),
+            ( leaf->header.count - i ) * sizeof(TmEntry));
+    leaf->entries[i].key = key;
+    leaf->entries[i].value = value;
+    leaf->header.count++;
+    tree->size++;
+    tree->modCount++;
+    if (needed == 0) {
+        return INSERTED;
+    }
+
+    // Splits the overflowing leaf in half, linking the upper half in after it
+    right = LEAF(spare[0]);
+    mid = leaf->header.count / 2;
+    right->header.count = leaf->header.count - mid;
+    memcpy(right->entries, &(leaf->entries[mid]), right->header.count * sizeof(TmEntry));
+    leaf->header.count = mid;
+    right->prev = leaf;
+    right->next = leaf->next;
+    if (leaf->next != NULL) {
+        leaf->next->prev = right;
+    } else {
+        tree->btTail = right;
+    }
+    leaf->next = right;
+    child = (BtNode *)right;
+    separator = right->entries[0].key;
+
+    // Adds the new child to each parent, splitting the parents that overflow on the way up
+    for (d = depth - 1; d >= 0; d--) {
+        parent = path[d].node;
+        at = path[d].index;
+        memmove(&(parent->keys[at + 1]), &(parent->keys[at]),
+                ( parent->header.count - at ) * sizeof(void *));
+        memmove(&(parent->children[at + 2]), &(parent->children[at + 1]),
+                ( parent->header.count - at ) * sizeof(BtNode *));
+        parent->keys[at] = separator;
+        parent->children[at + 1] = child;
+        parent->header.count++;
+        if (parent->header.count < INNER_MAX) {
+            return INSERTED;
+        }
+
+        // The middle key moves up, as it is the smallest key under the new sibling
+        sibling = INNER(spare[used++]);
+        mid = parent->header.count / 2;
+        separator = parent->keys[mid];
+        sibling->header.count = parent->header.count - mid - 1;
+        memcpy(sibling->keys, &(parent->keys[mid + 1]), sibling->header.count * sizeof(void *));
+        memcpy(sibling->children, &(parent->children[mid + 1]),
+               ( sibling->header.count + 1 ) * sizeof(BtNode *));
+        parent->header.count = mid;
+        child = (BtNode *)sibling;
+    }
+
+    // The root was split, so the tree grows by one level
+    root = INNER(spare[used]);
+    root->header.count = 1;
+    root->keys[0] = separator;
+    root->children[0] = tree->btRoot;
+    root->children[1] = child;
+    tree->btRoot = (BtNode *)root;
+
+    return INSERTED;
+}
+
+/**
+ * Moves the last entry or child of the B+-tree node `left` to the front of its right neighbor
+ * `node`.
+ */
+static void _bt_borrow_left(BtNode *left, BtNode *node) {
+
+    if (node->leaf == TRUE) {
+        memmove(&(LEAF(node)->entries[1]), LEAF(node)->entries, node->count * sizeof(TmEntry));
+        LEAF(node)->entries[0] = LEAF(left)->entries[left->count - 1];
+    } else {
+        memmove(&(INNER(node)->keys[1]), INNER(node)->keys, node->count * sizeof(void *));
+        memmove(&(INNER(node)->children[1]), INNER(node)->children,
+                ( node->count + 1 ) * sizeof(BtNode *));
+        INNER(node)->children[0] = INNER(left)->children[left->count];
+        INNER(node)->keys[0] = _bt_first_key(INNER(node)->children[1]);
+    }
+    left->count--;
+    node->count++;
+}
+
+/**
+ * Moves the first entry or child of the B+-tree node `right` to the end of its left neighbor
+ * `node`.
+ */
+static void _bt_borrow_right(BtNode *node, BtNode *right) {
+
+    if (node->leaf == TRUE) {
+        LEAF(node)->entries[node->count] = LEAF(right)->entries[0];
+        memmove(LEAF(right)->entries, &(LEAF(right)->entries[1]),
+                ( right->count - 1 ) * sizeof(TmEntry));
+    } else {
+        INNER(node)->children[node->count + 1] = INNER(right)->children[0];
+        INNER(node)->keys[node->count] = _bt_first_key(INNER(right)->children[0]);
+        memmove(INNER(right)->keys, &(INNER(right)->keys[1]),
+                ( right->count - 1 ) * sizeof(void *));
+        memmove(INNER(right)->children, &(INNER(right)->children[1]),
+                right->count * sizeof(BtNode *));
+    }
+    node->count++;
+    right->count--;
+}
+
+/**
+ * Merges the child `index + 1` of the B+-tree inner node `parent` into the child `index`, then
+ * frees it and removes it from `parent`.
+ */
+static void _bt_merge(TreeMap *tree, BtInner *parent, int index) {
+
+    BtNode *left = parent->children[index], *right = parent->children[index + 1];
+
+    if (left->leaf == TRUE) {
+        memcpy(&(LEAF(left)->entries[left->count]), LEAF(right)->entries,
+               right->count * sizeof(TmEntry));
+        left->count += right->count;
+        LEAF(left)->next = LEAF(right)->next;
+        if (LEAF(right)->next != NULL) {
+            LEAF(right)->next->prev = LEAF(left);
         } else {
-            free(node);
-            node = NULL;
+            tree->btTail = LEAF(left);
+        }
+    } else {
+        INNER(left)->keys[left->count] = _bt_first_key(right);
+        memcpy(&(INNER(left)->keys[left->count + 1]), INNER(right)->keys,
+               right->count * sizeof(void *));
+        memcpy(&(INNER(left)->children[left->count + 1]), INNER(right)->children,
+               ( right->count + 1 ) * sizeof(BtNode *));
+        left->count += right->count + 1;
+    }
+    allocator_free(tree->allocator, right);
+
+    // Removes the merged child from the parent
+    memmove(&(parent->keys[index]), &(parent->keys[index + 1]),
+            ( parent->header.count - index - 1 ) * sizeof(void *));
+    memmove(&(parent->children[index + 1]), &(parent->children[index + 2]),
+            ( parent->header.count - index - 1 ) * sizeof(BtNode *));
+    parent->header.count--;
+}
+
+/**
+ * Refills the underflowing child `index` of the B+-tree inner node `parent` by borrowing from or
+ * merging with a sibling. Returns the index the child's contents end up at.
+ */
+static int _bt_rebalance(TreeMap *tree, BtInner *parent, int index) {
+
+    BtNode *node = parent->children[index];
+    BtNode *left = ( index > 0 ) ? parent->children[index - 1] : NULL;
+    BtNode *right = ( index < parent->header.count ) ? parent->children[index + 1] : NULL;
+    int min = ( node->leaf == TRUE ) ? LEAF_MIN : INNER_MIN;
+
+    if (left != NULL && left->count > min) {
+        _bt_borrow_left(left, node);
+        return index;
+    }
+    if (right != NULL && right->count > min) {
+        _bt_borrow_right(node, right);
+        return index;
+    }
+    if (left != NULL) {
+        _bt_merge(tree, parent, index - 1);
+        return index - 1;
+    }
+    _bt_merge(tree, parent, index);
+
+    return index;
+}
+
+/**
+ * Removes the entry with the key `key` from the B+-tree of `tree`, storing a copy of it into
+ * `*removed`. Returns OK, or NOT_FOUND if there is no such entry.
+ */
+static Status _bt_delete(TreeMap *tree, void *key, TmEntry *removed) {
+
+    BtStep path[MAX_DEPTH];
+    BtInner *parent;
+    BtNode *old, *child;
+    Boolean found;
+    int depth, d, i, min;
+
+    // Removes the entry from its leaf
+    BtLeaf *leaf = _bt_find_leaf(tree, key, path, &depth);
+    i = _bt_search_leaf(tree, leaf, key, &found);
+    if (found == FALSE) {
+        return NOT_FOUND;
+    }
+    *removed = leaf->entries[i];
+    memmove(&(leaf->entries[i]), &(leaf->entries[i + 1]),
+            ( leaf->header.count - i - 1 ) * sizeof(TmEntry));
+    leaf->header.count--;
+    tree->size--;
+    tree->modCount++;
+
+    // Rebalances each underflowing node on the way up, and refreshes the separators around it
+    for (d = depth - 1; d >= 0; d--) {
+        parent = path[d].node;
+        i = path[d].index;
+        child = parent->children[i];
+        min = ( child->leaf == TRUE ) ? LEAF_MIN : INNER_MIN;
+        if (child->count < min) {
+            i = _bt_rebalance(tree, parent, i);
+        }
+        if (i > 0) {
+            parent->keys[i - 1] = _bt_first_key(parent->children[i]);
+        }
+        if (i < parent->header.count) {
+            parent->keys[i] = _bt_first_key(parent->children[i + 1]);
+        }
+    }
+
+    // Shrinks the tree by one level once the root is left with a single child
+    if (tree->btRoot->leaf == FALSE && tree->btRoot->count == 0) {
+        old = tree->btRoot;
+        tree->btRoot = INNER(old)->children[0];
+        allocator_free(tree->allocator, old);
+    }
+
+    return OK;
+}
+
+/**
+ * Frees the inner nodes of the B+-tree subtree of `tree` rooted at `node`; the leaves are left
+ * alone.
+ */
+static void _bt_free_inner(TreeMap *tree, BtNode *node) {
+
+    int i;
+
+    if (node->leaf == TRUE) {
+        return;
+    }
+    for (i = 0; i <= node->count; i++) {
+        _bt_free_inner(tree, INNER(node)->children[i]);
+    }
+    allocator_free(tree->allocator, node);
+}
+
+/**
+ * Returns the number of bytes held by the nodes of the B+-tree subtree rooted at `node`.
+ */
+static long _bt_memory_usage(BtNode *node) {
+
+    long bytes;
+    int i;
+
+    if (node->leaf == TRUE) {
+        return (long)sizeof(BtLeaf);
+    }
+    bytes = (long)sizeof(BtInner);
+    for (i = 0; i <= node->count; i++) {
+        bytes += _bt_memory_usage(INNER(node)->children[i]);
+    }
+
+    return bytes;
+}
+
+/**
+ * Clears out the B+-tree of `tree`, applying `keyDxn` and `valueDxn` on each entry's key and value
+ * (or if NULL, nothing will be done). Every node is freed except the first leaf, which is left
+ * empty as the new root.
+ */
+static void _bt_clear(TreeMap *tree, void (*keyDxn)(void *), void (*valueDxn)(void *)) {
+
+    BtLeaf *leaf, *next;
+    int i;
+
+    // Frees the inner nodes first, as freeing them reads the leaves' headers
+    _bt_free_inner(tree, tree->btRoot);
+
+    // Destroys the entries and the leaves, walking the leaves in order
+    for (leaf = tree->btHead; leaf != NULL; leaf = next) {
+        for (i = 0; i < leaf->header.count; i++) {
+            if (keyDxn != NULL) {
+                (*keyDxn)(leaf->entries[i].key);
+            }
+            if (valueDxn != NULL) {
+                (*valueDxn)(leaf->entries[i].value);
+            }
+        }
+        next = leaf->next;
+        if (leaf != tree->btHead) {
+            allocator_free(tree->allocator, leaf);
         }
     }
 
+    // Resets the first leaf as the root
+    tree->btHead->header.count = 0;
+    tree->btHead->next = NULL;
+    tree->btRoot = (BtNode *)tree->btHead;
+    tree->btTail = tree->btHead;
+}
+
+/**
+ * Allocates and returns a new node for the treemap `tree` with the key-value pairing `key` and
+ * `value`.
+ */
+static Node *_malloc_node(TreeMap *tree, void *key, void *value) {
+
+    // Allocate memory for the tree node, which holds the entry as well
+    Node *node = (Node *)nodepool_alloc(tree->pool, sizeof(Node));
+    if (node != NULL) {
+        // Initializes the node and entry members
+        node->parent = NULL;
+        node->left = NULL;
+        node->right = NULL;
+        node->color = RED;
+        node->count = 1L;
+        node->entry.key = key;
+        node->entry.value = value;
+    }
+
     return node;
 }
 
+/**
+ * Returns the node `node`, along with its entry, back to the node pool of the treemap `tree`.
+ */
+static void _free_node(TreeMap *tree, Node *node) {
+    nodepool_free(tree->pool, node, sizeof(Node));
+}
+
 /**
  * Searches the tree for the key `item` and returns the node, or NULL if no such element exists.
  */
@@ -126,7 +740,7 @@ static Node *_find_node(TreeMap *tree, void *item) {
 
     Node *temp = tree->root;
     while (temp != NULL) {
-        int cmp = (*tree->keyCmp)(item, temp->entry->key);
+        int cmp = (*tree->keyCmp)(item, temp->entry.key);
         if (cmp == 0)  {
             break;  // Node is found
         }
@@ -162,6 +776,10 @@ static void _rotate_left(TreeMap *tree, Node *node) {
 
     temp->left = node;
     node->parent = temp;
+
+    // The rotated node takes over the subtree, whose size is unchanged
+    temp->count = node->count;
+    node->count = 1L + COUNT(node->left) + COUNT(node->right);
 }
 
 /**
@@ -190,6 +808,10 @@ static void _rotate_right(TreeMap *tree, Node *node) {
 
     temp->right = node;
     node->parent = temp;
+
+    // The rotated node takes over the subtree, whose size is unchanged
+    temp->count = node->count;
+    node->count = 1L + COUNT(node->left) + COUNT(node->right);
 }
 
 /**
@@ -200,11 +822,13 @@ static void _insert_node(TreeMap *tree, Node *node) {
     Node *temp = tree->root, *parent = NULL;
     int cmp = 0;
     tree->size++;
+    tree->modCount++;
 
-    // Traverse down to the NIL node where the node is to be placed
+    // Traverse down to the NIL node where the node is to be placed, growing each subtree passed
     while (temp != NULL) {
         parent = temp;
-        cmp = (*tree->keyCmp)(node->entry->key, temp->entry->key);
+        parent->count++;
+        cmp = (*tree->keyCmp)(node->entry.key, temp->entry.key);
         temp = ( cmp < 0 ) ? temp->left : temp->right;
     }
 
@@ -227,6 +851,8 @@ static void _insert_node(TreeMap *tree, Node *node) {
  */
 static void _insert_fix(TreeMap *tree, Node *node) {
 
+    CDS_STATS_BEGIN();
+
     // Rebalance needed only if the parent is red
     while (COLOR(node->parent) == RED && node->parent->parent != NULL) {
         if (node->parent == node->parent->parent->left) {
@@ -296,21 +922,29 @@ static void _insert_fix(TreeMap *tree, Node *node) {
 
     // Tree root node must always be black
     tree->root->color = BLACK;
+    CDS_STATS_END(CDS_EVENT_TREEMAP_REBALANCE);
 }
 
-Status treemap_put(TreeMap *tree, void *key, void *value, void **previous) {
+/**
+ * Inserts or replaces the key's entry, the body of treemap_put().
+ */
+static Status _put_entry(TreeMap *tree, void *key, void *value, void **previous) {
+
+    if (IS_BTREE(tree) == TRUE) {
+        return _bt_put(tree, key, value, previous);
+    }
 
     // Searches for the node with the specified key
     Node *node = _find_node(tree, key);
     if (node != NULL) {
         // Replaces the old value with the new value
-        *previous = node->entry->value;
-        node->entry->value = value;
+        *previous = node->entry.value;
+        node->entry.value = value;
         return REPLACED;
     }
 
     // Allocates memory for the new node
-    Node *temp = _malloc_node(key, value);
+    Node *temp = _malloc_node(tree, key, value);
     if (temp == NULL) {
         return ALLOC_FAILURE;
     }
@@ -322,50 +956,152 @@ Status treemap_put(TreeMap *tree, void *key, void *value, void **previous) {
     return INSERTED;
 }
 
-/**
- * Fetches and returns the node with the minimum value in the given subtree starting at node `node`.
- */
-static Node *_get_min(Node *node) {
+Status treemap_put(TreeMap *tree, void *key, void *value, void **previous) {
 
-    while (node->left != NULL) {
-        node = node->left;
-    }
-    return node;
+    CDS_STATS_BEGIN();
+    Status status = _put_entry(tree, key, value, previous);
+    CDS_STATS_END(CDS_PROBE_TREEMAP_PUT);
+
+    return status;
 }
 
-/*
- * Fetches and returns the node with the maximum value in the given subtree starting at node `node`.
+/**
+ * Builds a balanced subtree out of the sorted entries `keys[lo..hi]` and `values[lo..hi]` at the
+ * depth `depth` below `parent`, coloring every node black except those at the depth `redLevel`.
+ * Returns the subtree's root, or NULL if empty; `*status` is set to ALLOC_FAILURE on failures.
  */
-static Node *_get_max(Node *node) {
+static Node *_build_tree(TreeMap *tree, void **keys, void **values, long lo, long hi, int depth,
+                         int redLevel, Node *parent, Status *status) {
 
-    while (node->right != NULL) {
-        node = node->right;
+    if (lo > hi || *status != OK) {
+        return NULL;
+    }
+
+    // Allocates the middle entry first, so a partial tree stays linked up if an allocation fails
+    long mid = lo + ( hi - lo ) / 2;
+    Node *node = _malloc_node(tree, keys[mid], ( values != NULL ) ? values[mid] : NULL);
+    if (node == NULL) {
+        *status = ALLOC_FAILURE;
+        return NULL;
     }
+    node->parent = parent;
+    node->color = ( depth == redLevel ) ? RED : BLACK;
+    tree->size++;
+
+    // Builds the left and right halves as the subtrees
+    node->left = _build_tree(tree, keys, values, lo, mid - 1, depth + 1, redLevel, node, status);
+    node->right = _build_tree(tree, keys, values, mid + 1, hi, depth + 1, redLevel, node, status);
+    node->count = 1L + COUNT(node->left) + COUNT(node->right);
+
     return node;
 }
 
-Status treemap_firstKey(TreeMap *tree, void **firstKey) {
+/**
+ * Builds the empty red-black tree `tree` out of the `n` sorted entries in `keys` and `values`. On
+ * failure, the partial tree built so far is left linked up in `tree`.
+ */
+static Status _build_sorted(TreeMap *tree, void **keys, void **values, long n) {
 
-    // Checks if the tree is currently empty
-    if (IS_EMPTY(tree) == TRUE) {
-        return STRUCT_EMPTY;
+    Status status = OK;
+    long m;
+    int redLevel = 0;
+
+    // Only the deepest level of a perfectly balanced tree may be partially filled, painted red
+    for (m = n - 1L; m >= 0L; m = m / 2L - 1L) {
+        redLevel++;
     }
-    // Fetches the first key, saves into pointer
-    Node *node = _get_min(tree->root);
-    *firstKey = node->entry->key;
+    tree->root = _build_tree(tree, keys, values, 0L, n - 1L, 0, redLevel, NULL, &status);
 
-    return OK;
+    return status;
 }
 
-Status treemap_first(TreeMap *tree, TmEntry **first) {
+Status treemap_fromSorted(TreeMap **tree, int (*keyComparator)(void *, void *),
+                          void (*keyDestructor)(void *), void **keys, void **values, long n) {
+
+    TreeMap *temp;
+    Status status;
+
+    status = treemap_new(&temp, keyComparator, keyDestructor);
+    if (status != OK) {
+        return status;
+    }
+
+    status = _build_sorted(temp, keys, values, n);
+    if (status != OK) {
+        // The caller still owns the keys, so they are not destroyed with the partial tree
+        temp->keyDxn = NULL;
+        treemap_destroy(temp, NULL);
+        return status;
+    }
+    *tree = temp;
+
+    return OK;
+}
+
+/**
+ * Fetches and returns the node with the minimum value in the given subtree starting at node `node`.
+ */
+static Node *_get_min(Node *node) {
+
+    while (node->left != NULL) {
+        node = node->left;
+    }
+    return node;
+}
+
+/*
+ * Fetches and returns the node with the maximum value in the given subtree starting at node `node`.
+ */
+static Node *_get_max(Node *node) {
+
+    while (node->right != NULL) {
+        node = node->right;
+    }
+    return node;
+}
+
+/**
+ * Fetches and returns the entry with the smallest key in the non-empty treemap `tree`.
+ */
+static TmEntry *_first_entry(TreeMap *tree) {
+
+    if (IS_BTREE(tree) == TRUE) {
+        return &(tree->btHead->entries[0]);
+    }
+    return &(_get_min(tree->root)->entry);
+}
+
+/**
+ * Fetches and returns the entry with the largest key in the non-empty treemap `tree`.
+ */
+static TmEntry *_last_entry(TreeMap *tree) {
+
+    if (IS_BTREE(tree) == TRUE) {
+        return &(tree->btTail->entries[tree->btTail->header.count - 1]);
+    }
+    return &(_get_max(tree->root)->entry);
+}
+
+Status treemap_firstKey(TreeMap *tree, void **firstKey) {
+
+    // Checks if the tree is currently empty
+    if (IS_EMPTY(tree) == TRUE) {
+        return STRUCT_EMPTY;
+    }
+    // Fetches the first key, saves into pointer
+    *firstKey = _first_entry(tree)->key;
+
+    return OK;
+}
+
+Status treemap_first(TreeMap *tree, TmEntry **first) {
 
     // Checks if the tree is currently empty
     if (IS_EMPTY(tree) == TRUE) {
         return STRUCT_EMPTY;
     }
     // Fetches the first entry, saves into pointer
-    Node *node = _get_min(tree->root);
-    *first = node->entry;
+    *first = _first_entry(tree);
 
     return OK;
 }
@@ -377,8 +1113,7 @@ Status treemap_lastKey(TreeMap *tree, void **lastKey) {
         return STRUCT_EMPTY;
     }
     // Fetches the last key, saves into pointer
-    Node *node = _get_max(tree->root);
-    *lastKey = node->entry->key;
+    *lastKey = _last_entry(tree)->key;
 
     return OK;
 }
@@ -390,8 +1125,7 @@ Status treemap_last(TreeMap *tree, TmEntry **last) {
         return STRUCT_EMPTY;
     }
     // Fetches the last entry, saves into pointer
-    Node *node = _get_max(tree->root);
-    *last = node->entry;
+    *last = _last_entry(tree);
 
     return OK;
 }
@@ -406,7 +1140,7 @@ static Node *_get_floor_node(TreeMap *tree, void *item) {
     Node *current = tree->root;
 
     while (current != NULL) {
-        int cmp = (*tree->keyCmp)(item, current->entry->key);
+        int cmp = (*tree->keyCmp)(item, current->entry.key);
         if (cmp == 0) {
             // Value found, return as floor
             temp = current;
@@ -424,19 +1158,32 @@ static Node *_get_floor_node(TreeMap *tree, void *item) {
     return temp;
 }
 
+/**
+ * Fetches and returns the floor entry of the treemap `tree` with respect to the given item, or NULL
+ * if no such entry exists.
+ */
+static TmEntry *_get_floor_entry(TreeMap *tree, void *item) {
+
+    if (IS_BTREE(tree) == TRUE) {
+        return _bt_search(tree, item, FALSE, TRUE, TRUE);
+    }
+    Node *node = _get_floor_node(tree, item);
+    return ( node != NULL ) ? &(node->entry) : NULL;
+}
+
 Status treemap_floorKey(TreeMap *tree, void *key, void **floorKey) {
 
     // Checks if the tree is currently empty
     if (IS_EMPTY(tree) == TRUE) {
         return STRUCT_EMPTY;
     }
-    // Fetches the floor node
-    Node *node = _get_floor_node(tree, key);
-    if (node == NULL) {
+    // Fetches the floor entry
+    TmEntry *entry = _get_floor_entry(tree, key);
+    if (entry == NULL) {
         return NOT_FOUND;
     }
     // Extracts the floor key, saves into pointer
-    *floorKey = node->entry->key;
+    *floorKey = entry->key;
 
     return OK;
 }
@@ -447,13 +1194,13 @@ Status treemap_floor(TreeMap *tree, void *key, TmEntry **floor) {
     if (IS_EMPTY(tree) == TRUE) {
         return STRUCT_EMPTY;
     }
-    // Fetches the floor node
-    Node *node = _get_floor_node(tree, key);
-    if (node == NULL) {
+    // Fetches the floor entry
+    TmEntry *entry = _get_floor_entry(tree, key);
+    if (entry == NULL) {
         return NOT_FOUND;
     }
     // Extracts the floor entry, saves into pointer
-    *floor = node->entry;
+    *floor = entry;
 
     return OK;
 }
@@ -468,7 +1215,7 @@ static Node *_get_ceiling_node(TreeMap *tree, void *item) {
     Node *current = tree->root;
 
     while (current != NULL) {
-        int cmp = (*tree->keyCmp)(item, current->entry->key);
+        int cmp = (*tree->keyCmp)(item, current->entry.key);
         if (cmp == 0) {
             // Value found, return as ceiling
             temp = current;
@@ -486,19 +1233,32 @@ static Node *_get_ceiling_node(TreeMap *tree, void *item) {
     return temp;
 }
 
+/**
+ * Fetches and returns the ceiling entry of the treemap `tree` with respect to the given item, or NULL
+ * if no such entry exists.
+ */
+static TmEntry *_get_ceiling_entry(TreeMap *tree, void *item) {
+
+    if (IS_BTREE(tree) == TRUE) {
+        return _bt_search(tree, item, FALSE, FALSE, TRUE);
+    }
+    Node *node = _get_ceiling_node(tree, item);
+    return ( node != NULL ) ? &(node->entry) : NULL;
+}
+
 Status treemap_ceilingKey(TreeMap *tree, void *key, void **ceilingKey) {
 
     // Checks if the tree is currently empty
     if (IS_EMPTY(tree) == TRUE) {
         return STRUCT_EMPTY;
     }
-    // Fetches the ceiling node
-    Node *node = _get_ceiling_node(tree, key);
-    if (node == NULL) {
+    // Fetches the ceiling entry
+    TmEntry *entry = _get_ceiling_entry(tree, key);
+    if (entry == NULL) {
         return NOT_FOUND;
     }
     // Extracts the ceiling key, saves into pointer
-    *ceilingKey = node->entry->key;
+    *ceilingKey = entry->key;
 
     return OK;
 }
@@ -509,13 +1269,13 @@ Status treemap_ceiling(TreeMap *tree, void *key, TmEntry **ceiling) {
     if (IS_EMPTY(tree) == TRUE) {
         return STRUCT_EMPTY;
     }
-    // Fetches the ceiling node
-    Node *node = _get_ceiling_node(tree, key);
-    if (node == NULL) {
+    // Fetches the ceiling entry
+    TmEntry *entry = _get_ceiling_entry(tree, key);
+    if (entry == NULL) {
         return NOT_FOUND;
     }
     // Extracts the ceiling entry, saves into pointer
-    *ceiling = node->entry;
+    *ceiling = entry;
 
     return OK;
 }
@@ -530,7 +1290,7 @@ static Node *_get_lower_node(TreeMap *tree, void *item) {
     Node *current = tree->root;
 
     while (current != NULL) {
-        int cmp = (*tree->keyCmp)(item, current->entry->key);
+        int cmp = (*tree->keyCmp)(item, current->entry.key);
         if (cmp <= 0) {
             current = current->left;
         } else {
@@ -543,19 +1303,32 @@ static Node *_get_lower_node(TreeMap *tree, void *item) {
     return temp;
 }
 
+/**
+ * Fetches and returns the lower entry of the treemap `tree` with respect to the given item, or NULL
+ * if no such entry exists.
+ */
+static TmEntry *_get_lower_entry(TreeMap *tree, void *item) {
+
+    if (IS_BTREE(tree) == TRUE) {
+        return _bt_search(tree, item, FALSE, TRUE, FALSE);
+    }
+    Node *node = _get_lower_node(tree, item);
+    return ( node != NULL ) ? &(node->entry) : NULL;
+}
+
 Status treemap_lowerKey(TreeMap *tree, void *key, void **lowerKey) {
 
     // Checks if the tree is currently empty
     if (IS_EMPTY(tree) == TRUE) {
         return STRUCT_EMPTY;
     }
-    // Fetches the lower node
-    Node *node = _get_lower_node(tree, key);
-    if (node == NULL) {
+    // Fetches the lower entry
+    TmEntry *entry = _get_lower_entry(tree, key);
+    if (entry == NULL) {
         return NOT_FOUND;
     }
     // Extracts the lower key, saves into pointer
-    *lowerKey = node->entry->key;
+    *lowerKey = entry->key;
 
     return OK;
 }
@@ -566,13 +1339,13 @@ Status treemap_lower(TreeMap *tree, void *key, TmEntry **lower) {
     if (IS_EMPTY(tree) == TRUE) {
         return STRUCT_EMPTY;
     }
-    // Fetches the lower node
-    Node *node = _get_lower_node(tree, key);
-    if (node == NULL) {
+    // Fetches the lower entry
+    TmEntry *entry = _get_lower_entry(tree, key);
+    if (entry == NULL) {
         return NOT_FOUND;
     }
     // Extracts the lower entry, saves into pointer
-    *lower = node->entry;
+    *lower = entry;
 
     return OK;
 }
@@ -587,7 +1360,7 @@ static Node *_get_higher_node(TreeMap *tree, void *item) {
     Node *current = tree->root;
 
     while (current != NULL) {
-        int cmp = (*tree->keyCmp)(item, current->entry->key);
+        int cmp = (*tree->keyCmp)(item, current->entry.key);
         if (cmp >= 0) {
             current = current->right;
         } else {
@@ -600,19 +1373,32 @@ static Node *_get_higher_node(TreeMap *tree, void *item) {
     return temp;
 }
 
+/**
+ * Fetches and returns the higher entry of the treemap `tree` with respect to the given item, or NULL
+ * if no such entry exists.
+ */
+static TmEntry *_get_higher_entry(TreeMap *tree, void *item) {
+
+    if (IS_BTREE(tree) == TRUE) {
+        return _bt_search(tree, item, FALSE, FALSE, FALSE);
+    }
+    Node *node = _get_higher_node(tree, item);
+    return ( node != NULL ) ? &(node->entry) : NULL;
+}
+
 Status treemap_higherKey(TreeMap *tree, void *key, void **higherKey) {
 
     // Checks if the tree is currently empty
     if (IS_EMPTY(tree) == TRUE) {
         return STRUCT_EMPTY;
     }
-    // Fetches the higher node
-    Node *node = _get_higher_node(tree, key);
-    if (node == NULL) {
+    // Fetches the higher entry
+    TmEntry *entry = _get_higher_entry(tree, key);
+    if (entry == NULL) {
         return NOT_FOUND;
     }
     // Extracts the higher key, saves into pointer
-    *higherKey = node->entry->key;
+    *higherKey = entry->key;
 
     return OK;
 }
@@ -623,38 +1409,162 @@ Status treemap_higher(TreeMap *tree, void *key, TmEntry **higher) {
     if (IS_EMPTY(tree) == TRUE) {
         return STRUCT_EMPTY;
     }
-    // Fetches the higher node
-    Node *node = _get_higher_node(tree, key);
-    if (node == NULL) {
+    // Fetches the higher entry
+    TmEntry *entry = _get_higher_entry(tree, key);
+    if (entry == NULL) {
         return NOT_FOUND;
     }
     // Extracts the higher entry, saves into pointer
-    *higher = node->entry;
+    *higher = entry;
 
     return OK;
 }
 
+/**
+ * Searches the treemap `tree` for the key `item` and returns its entry, or NULL if no such element
+ * exists.
+ */
+static TmEntry *_find_entry(TreeMap *tree, void *item) {
+
+    if (IS_BTREE(tree) == TRUE) {
+        return _bt_search(tree, item, TRUE, FALSE, FALSE);
+    }
+    Node *node = _find_node(tree, item);
+    return ( node != NULL ) ? &(node->entry) : NULL;
+}
+
 Boolean treemap_containsKey(TreeMap *tree, void *key) {
-    return ( _find_node(tree, key) != NULL ) ? TRUE : FALSE;
+    return ( _find_entry(tree, key) != NULL ) ? TRUE : FALSE;
 }
 
-Status treemap_get(TreeMap *tree, void *key, void **value) {
+/**
+ * Looks up the value of the key, the body of treemap_get().
+ */
+static Status _get_value(TreeMap *tree, void *key, void **value) {
 
     // Checks if the tree is currently empty
     if (IS_EMPTY(tree) == TRUE) {
         return STRUCT_EMPTY;
     }
-    // Fetches the node with the specified key
-    Node *node = _find_node(tree, key);
-    if (node == NULL) {
+    // Fetches the entry with the specified key
+    TmEntry *entry = _find_entry(tree, key);
+    if (entry == NULL) {
         return NOT_FOUND;
     }
     // Retrieves the value, saves into pointer
-    *value = node->entry->value;
+    *value = entry->value;
 
     return OK;
 }
 
+Status treemap_get(TreeMap *tree, void *key, void **value) {
+
+    CDS_STATS_BEGIN();
+    Status status = _get_value(tree, key, value);
+    CDS_STATS_END(CDS_PROBE_TREEMAP_GET);
+
+    return status;
+}
+
+/**
+ * Returns the number of keys in the treemap `tree` that are less than (or if `inclusive` is TRUE,
+ * equal to) `key`. The red-black tree descends once, using the subtree sizes; the B+-tree counts
+ * the entries of each leaf before the one holding `key`.
+ */
+static long _count_below(TreeMap *tree, void *key, Boolean inclusive) {
+
+    long count = 0L;
+    int cmp;
+
+    if (IS_BTREE(tree) == TRUE) {
+        Boolean found;
+        BtLeaf *leaf, *target = _bt_find_leaf(tree, key, NULL, NULL);
+        int i = _bt_search_leaf(tree, target, key, &found);
+        for (leaf = tree->btHead; leaf != target; leaf = leaf->next) {
+            count += leaf->header.count;
+        }
+        return count + i + ( ( found == TRUE && inclusive == TRUE ) ? 1 : 0 );
+    }
+
+    Node *node = tree->root;
+    while (node != NULL) {
+        cmp = (*tree->keyCmp)(key, node->entry.key);
+        if (cmp == 0) {
+            // Every key in the left subtree is smaller
+            count += COUNT(node->left) + ( ( inclusive == TRUE ) ? 1L : 0L );
+            break;
+        }
+        if (cmp < 0) {
+            node = node->left;
+        } else {
+            // This node and its left subtree are all smaller
+            count += COUNT(node->left) + 1L;
+            node = node->right;
+        }
+    }
+
+    return count;
+}
+
+/**
+ * Returns the node holding the `k`th smallest key of the red-black tree, descending towards it
+ * by the subtree sizes. `k` must be a valid index.
+ */
+static Node *_select_node(TreeMap *tree, long k) {
+
+    Node *node = tree->root;
+    long left;
+
+    while ((left = COUNT(node->left)) != k) {
+        if (k < left) {
+            node = node->left;
+        } else {
+            k -= ( left + 1L );
+            node = node->right;
+        }
+    }
+
+    return node;
+}
+
+Status treemap_select(TreeMap *tree, long k, TmEntry **entry) {
+
+    // Checks if the tree is empty, or the index is out of bounds
+    if (IS_EMPTY(tree) == TRUE) {
+        return STRUCT_EMPTY;
+    }
+    if (k < 0L || k >= tree->size) {
+        return INVALID_INDEX;
+    }
+
+    if (IS_BTREE(tree) == TRUE) {
+        // Skips over whole leaves until reaching the one holding the entry
+        BtLeaf *leaf = tree->btHead;
+        while (k >= leaf->header.count) {
+            k -= leaf->header.count;
+            leaf = leaf->next;
+        }
+        *entry = &(leaf->entries[k]);
+        return OK;
+    }
+
+    *entry = &(_select_node(tree, k)->entry);
+
+    return OK;
+}
+
+long treemap_rank(TreeMap *tree, void *key) {
+    return _count_below(tree, key, FALSE);
+}
+
+long treemap_countRange(TreeMap *tree, void *fromKey, Boolean fromInclusive, void *toKey,
+                        Boolean toInclusive) {
+
+    long count = _count_below(tree, toKey, toInclusive) -
+                 _count_below(tree, fromKey, ( fromInclusive == TRUE ) ? FALSE : TRUE);
+    return ( count > 0L ) ? count : 0L;
+}
+
 /**
  * Performs recoloring and rotations on the tree after a deletion to ensure the red-black tree
  * properties are upheld.
@@ -757,6 +1667,7 @@ static void _delete_node(TreeMap *tree, Node *node, Node **src) {
 
     Node *splice, *child;
     tree->size--;
+    tree->modCount++;
 
     // Finds the node to be removed, swaps elements within predecessor
     if (node->left == NULL) {
@@ -771,15 +1682,18 @@ static void _delete_node(TreeMap *tree, Node *node, Node **src) {
             splice = splice->right;
         }
         child = splice->left;
-        node->entry->key = splice->entry->key;
-        node->entry->value = splice->entry->value;
+        node->entry.key = splice->entry.key;
+        node->entry.value = splice->entry.value;
     }
 
-    // Unlinks the node from the tree
-    Node *parent = splice->parent;
+    // Unlinks the node from the tree, shrinking each subtree above it
+    Node *parent = splice->parent, *ancestor;
     if (child != NULL) {
         child->parent = parent;
     }
+    for (ancestor = parent; ancestor != NULL; ancestor = ancestor->parent) {
+        ancestor->count--;
+    }
     if (parent == NULL) {
         tree->root = child;
         *src = splice;
@@ -806,16 +1720,22 @@ Status treemap_pollFirst(TreeMap *tree, void **firstKey, void **firstValue) {
     if (IS_EMPTY(tree) == TRUE) {
         return STRUCT_EMPTY;
     }
+    if (IS_BTREE(tree) == TRUE) {
+        TmEntry removed;
+        _bt_delete(tree, _first_entry(tree)->key, &removed);
+        *firstKey = removed.key;
+        *firstValue = removed.value;
+        return OK;
+    }
     // Retrieves the minimum node, saves the data into the pointers
     Node *node = _get_min(tree->root);
-    *firstKey = node->entry->key;
-    *firstValue = node->entry->value;
+    *firstKey = node->entry.key;
+    *firstValue = node->entry.value;
 
     // Removes the node from the tree, frees the allocated memory
     Node *temp;
     _delete_node(tree, node, &temp);
-    free(temp->entry);
-    free(temp);
+    _free_node(tree, temp);
 
     return OK;
 }
@@ -826,16 +1746,22 @@ Status treemap_pollLast(TreeMap *tree, void **lastKey, void **lastValue) {
     if (IS_EMPTY(tree) == TRUE) {
         return STRUCT_EMPTY;
     }
+    if (IS_BTREE(tree) == TRUE) {
+        TmEntry removed;
+        _bt_delete(tree, _last_entry(tree)->key, &removed);
+        *lastKey = removed.key;
+        *lastValue = removed.value;
+        return OK;
+    }
     // Retrieves the maximum node, saves the data into the pointers
     Node *node = _get_max(tree->root);
-    *lastKey = node->entry->key;
-    *lastValue = node->entry->value;
+    *lastKey = node->entry.key;
+    *lastValue = node->entry.value;
 
     // Removes the node from the tree, frees the allocated memory
     Node *temp;
     _delete_node(tree, node, &temp);
-    free(temp->entry);
-    free(temp);
+    _free_node(tree, temp);
 
     return OK;
 }
@@ -846,71 +1772,140 @@ Status treemap_remove(TreeMap *tree, void *key, void **value) {
     if (treemap_isEmpty(tree) == TRUE) {
         return STRUCT_EMPTY;
     }
+    if (IS_BTREE(tree) == TRUE) {
+        TmEntry removed;
+        if (_bt_delete(tree, key, &removed) != OK) {
+            return NOT_FOUND;
+        }
+        *value = removed.value;
+        if (tree->keyDxn != NULL) {
+            (*tree->keyDxn)(removed.key);
+        }
+        return OK;
+    }
     // Fetches the node from the tree, saves the value into the pointer
     Node *node = _find_node(tree, key);
     if (node == NULL) {
         return NOT_FOUND;
     }
-    *value = node->entry->value;
+    *value = node->entry.value;
 
     // Removes the node from the tree, frees the allocated memory
     Node *temp;
-    void *toDelete = node->entry->key;
+    void *toDelete = node->entry.key;
     _delete_node(tree, node, &temp);
     if (tree->keyDxn != NULL) {
         (*tree->keyDxn)(toDelete);
     }
-    free(temp->entry);
-    free(temp);
+    _free_node(tree, temp);
+
+    return OK;
+}
+
+Status treemap_putAll(TreeMap *tree, void **keys, void **values, long n, void **previous) {
+
+    void *replaced;
+    long i;
+
+    for (i = 0L; i < n; i++) {
+        replaced = NULL;
+        if (treemap_put(tree, keys[i], values[i], &replaced) == ALLOC_FAILURE) {
+            return ALLOC_FAILURE;
+        }
+        if (previous != NULL) {
+            previous[i] = replaced;
+        }
+    }
 
     return OK;
 }
 
+long treemap_getAll(TreeMap *tree, void **keys, void **values, long n) {
+
+    long i, found = 0L;
+
+    for (i = 0L; i < n; i++) {
+        if (treemap_get(tree, keys[i], &(values[i])) == OK) {
+            found++;
+        } else {
+            values[i] = NULL;
+        }
+    }
+
+    return found;
+}
+
+long treemap_removeAll(TreeMap *tree, void **keys, void **values, long n) {
+
+    void *value;
+    long i, removed = 0L;
+
+    for (i = 0L; i < n; i++) {
+        value = NULL;
+        if (treemap_remove(tree, keys[i], &value) == OK) {
+            removed++;
+        }
+        if (values != NULL) {
+            values[i] = value;
+        }
+    }
+
+    return removed;
+}
+
 /**
- * Clears out the treemap of all its elements via a post-order traversal, applying the destructor
- * method `keyDxn` on each element's key and `valueDxn` on each element's value (or if NULL, nothing
- * will be done to the key/value). Frees up all reserved memory back to the heap.
+ * Clears out the treemap of all its elements, applying the destructor method `keyDxn` on each
+ * element's key and `valueDxn` on each element's value (or if NULL, nothing will be done to the
+ * key/value). Returns all of the nodes back to the treemap's pool. The tree is torn down in place
+ * by right rotations, which needs neither a stack nor the parent links.
  */
-static void _clear_tree(Node *node, void (*keyDxn)(void *), void (*valueDxn)(void *)) {
+static void _clear_tree(TreeMap *tree, void (*keyDxn)(void *), void (*valueDxn)(void *)) {
 
-    Node *parent;
+    Node *node = tree->root, *left, *right;
 
+    if (IS_BTREE(tree) == TRUE) {
+        _bt_clear(tree, keyDxn, valueDxn);
+        return;
+    }
+
+    // A private pool releases every node at once, so nodes are only visited for the destructors
+    if (tree->ownsPool == TRUE && keyDxn == NULL && valueDxn == NULL) {
+        nodepool_reset(tree->pool);
+        return;
+    }
+
+    // Rotates each left child up until the node has none, so every node is visited exactly once
     while (node != NULL) {
-        parent = node->parent;
-        // Node is a leaf node, safe to delete
-        if (node->left == NULL && node->right == NULL) {
-            // Need to nullify parent's correct child node
-            if (parent != NULL) {
-                if (parent->left == node) {
-                    parent->left = NULL;
-                } else {
-                    parent->right = NULL;
-                }
-            }
-            // Destroys the node and its entry values
-            if (keyDxn != NULL) {
-                (*keyDxn)(node->entry->key);
-            }
-            if (valueDxn != NULL) {
-                (*valueDxn)(node->entry->value);
-            }
-            free(node->entry);
-            free(node);
-            node = parent;
-        } else if (node->left != NULL) {
-            // Left child exists, traverse left subtree
-            node = node->left;
-        } else {
-            // Right child exists, traverse right subtree
-            node = node->right;
+        if (node->left != NULL) {
+            left = node->left;
+            node->left = left->right;
+            left->right = node;
+            node = left;
+            continue;
+        }
+        // Node has no left subtree, destroy it and continue with its right subtree
+        right = node->right;
+        if (keyDxn != NULL) {
+            (*keyDxn)(node->entry.key);
         }
+        if (valueDxn != NULL) {
+            (*valueDxn)(node->entry.value);
+        }
+        if (tree->ownsPool == FALSE) {
+            _free_node(tree, node);
+        }
+        node = right;
+    }
+    if (tree->ownsPool == TRUE) {
+        nodepool_reset(tree->pool);
     }
 }
 
 void treemap_clear(TreeMap *tree, void (*valueDestructor)(void *)) {
-    _clear_tree(tree->root, tree->keyDxn, valueDestructor);
+    _clear_tree(tree, tree->keyDxn, valueDestructor);
     tree->root = NULL;
     tree->size = 0L;
+    tree->modCount++;
 }
 
 long treemap_size(TreeMap *tree) {
@@ -930,10 +1925,27 @@ static void _populate_key_array(TreeIter *iter, Node *node) {
         return;
     }
     _populate_key_array(iter, node->left);
-    iter->items[iter->next++] = node->entry->key;
+    iter->items[iter->next++] = node->entry.key;
     _populate_key_array(iter, node->right);
 }
 
+/**
+ * Populates the iteration with the keys (if `keys` is TRUE) or the entries of the B+-tree of
+ * `tree`, walking the leaves in order.
+ */
+static void _bt_populate_array(TreeIter *iter, TreeMap *tree, Boolean keys) {
+
+    BtLeaf *leaf;
+    int i;
+
+    for (leaf = tree->btHead; leaf != NULL; leaf = leaf->next) {
+        for (i = 0; i < leaf->header.count; i++) {
+            iter->items[iter->next++] = ( keys == TRUE ) ? leaf->entries[i].key
+                                                         : (void *)&(leaf->entries[i]);
+        }
+    }
+}
+
 Status treemap_keyArray(TreeMap *tree, Array **keys) {
 
     size_t bytes;
@@ -960,7 +1972,11 @@ Status treemap_keyArray(TreeMap *tree, Array **keys) {
 
     // Populates the iterator with the key, saves the results into pointer
     TreeIter iter = {items, 0L};
-    _populate_key_array(&iter, tree->root);
+    if (IS_BTREE(tree) == TRUE) {
+        _bt_populate_array(&iter, tree, TRUE);
+    } else {
+        _populate_key_array(&iter, tree->root);
+    }
     temp->items = iter.items;
     temp->len = tree->size;
     *keys = temp;
@@ -977,7 +1993,7 @@ static void _populate_entry_array(TreeIter *iter, Node *node) {
         return;
     }
     _populate_entry_array(iter, node->left);
-    iter->items[iter->next++] = node->entry;
+    iter->items[iter->next++] = &(node->entry);
     _populate_entry_array(iter, node->right);
 }
 
@@ -999,7 +2015,11 @@ static TmEntry **_generate_entry_array(TreeMap *tree) {
 
     // Collects the array of treemap entries
     TreeIter iter = {(void **)items, 0L};
-    _populate_entry_array(&iter, tree->root);
+    if (IS_BTREE(tree) == TRUE) {
+        _bt_populate_array(&iter, tree, FALSE);
+    } else {
+        _populate_entry_array(&iter, tree->root);
+    }
 
     return (TmEntry **)iter.items;
 }
@@ -1032,6 +2052,52 @@ Status treemap_entryArray(TreeMap *tree, Array **entries) {
     return OK;
 }
 
+Status treemap_entrySnapshot(TreeMap *tree, Array **entries) {
+
+    TmEntry **items, *copies;
+    size_t offset;
+    long j;
+
+    // Does not create array if currently empty
+    if (IS_EMPTY(tree) == TRUE) {
+        return STRUCT_EMPTY;
+    }
+
+    // Allocates the pointer array and the entry copies as one block, so FREE_ARRAY releases both
+    offset = ( tree->size * sizeof(TmEntry *) );
+    offset = ( ( offset + sizeof(TmEntry) - 1 ) / sizeof(TmEntry) ) * sizeof(TmEntry);
+    Array *temp = (Array *)malloc(sizeof(Array));
+    if (temp == NULL) {
+        return ALLOC_FAILURE;
+    }
+    TmEntry **live = _generate_entry_array(tree);
+    if (live == NULL) {
+        free(temp);
+        return ALLOC_FAILURE;
+    }
+    items = (TmEntry **)malloc(offset + ( tree->size * sizeof(TmEntry) ));
+    if (items == NULL) {
+        free(live);
+        free(temp);
+        return ALLOC_FAILURE;
+    }
+
+    // Copies each live entry into the block, detached from the treemap
+    copies = (TmEntry *)((char *)items + offset);
+    for (j = 0L; j < tree->size; j++) {
+        copies[j] = *(live[j]);
+        items[j] = &(copies[j]);
+    }
+    free(live);
+
+    // Initializes the remaining struct members
+    temp->items = (void **)items;
+    temp->len = tree->size;
+    *entries = temp;
+
+    return OK;
+}
+
 Status treemap_iterator(TreeMap *tree, Iterator **iter) {
 
     Iterator *temp = NULL;
@@ -1058,9 +2124,547 @@ Status treemap_iterator(TreeMap *tree, Iterator **iter) {
     return OK;
 }
 
+/**
+ * Returns the in-order successor of the node `node`, or NULL if `node` is the last node.
+ */
+static Node *_successor(Node *node) {
+
+    // Successor is the leftmost node of the right subtree, if any
+    if (node->right != NULL) {
+        return _get_min(node->right);
+    }
+    // Otherwise, it's the first ancestor whose left subtree holds the node
+    Node *parent = node->parent;
+    while (parent != NULL && node == parent->right) {
+        node = parent;
+        parent = parent->parent;
+    }
+
+    return parent;
+}
+
+void treemap_cursor(TreeMap *tree, Cursor *cursor) {
+    cursor->adt = tree;
+    if (IS_BTREE(tree) == TRUE) {
+        cursor->node = tree->btHead;
+    } else {
+        cursor->node = ( tree->root != NULL ) ? _get_min(tree->root) : NULL;
+    }
+    cursor->index = 0L;
+    cursor->remaining = tree->size;
+    cursor->modCount = tree->modCount;
+    cursor->end = NULL;
+}
+
+/**
+ * Returns the entry the cursor `cursor` over the treemap `tree` visits next, or NULL if it reached
+ * the end of the treemap.
+ */
+static TmEntry *_cursor_entry(TreeMap *tree, Cursor *cursor) {
+
+    if (cursor->node == NULL) {
+        return NULL;
+    }
+    if (IS_BTREE(tree) == TRUE) {
+        return &(((BtLeaf *)cursor->node)->entries[cursor->index]);
+    }
+    return &(((Node *)cursor->node)->entry);
+}
+
+/**
+ * Initializes `cursor` to walk over the entries of the treemap `tree` whose keys lie between
+ * `fromKey` and `toKey`, where a NULL bound leaves that side of the range open. The first entry is
+ * found with a single descent; the walk then stops before the first entry past `toKey`.
+ */
+static void _range_cursor(TreeMap *tree, void *fromKey, Boolean fromInclusive, void *toKey,
+                          Boolean toInclusive, Cursor *cursor) {
+
+    TmEntry *start;
+    Boolean found;
+    int i;
+
+    treemap_cursor(tree, cursor);
+    if (fromKey != NULL) {
+        if (IS_BTREE(tree) == TRUE) {
+            // Positions the cursor within the leaf that holds the lower bound
+            BtLeaf *leaf = _bt_find_leaf(tree, fromKey, NULL, NULL);
+            i = _bt_search_leaf(tree, leaf, fromKey, &found);
+            if (found == TRUE && fromInclusive == FALSE) {
+                i++;
+            }
+            if (i == leaf->header.count) {
+                leaf = leaf->next;
+                i = 0;
+            }
+            cursor->node = leaf;
+            cursor->index = (long)i;
+        } else if (fromInclusive == TRUE) {
+            cursor->node = _get_ceiling_node(tree, fromKey);
+        } else {
+            cursor->node = _get_higher_node(tree, fromKey);
+        }
+    }
+
+    // The walk ends before the first entry past the upper bound
+    start = _cursor_entry(tree, cursor);
+    if (start == NULL) {
+        cursor->remaining = 0L;
+    } else if (toKey != NULL) {
+        int cmp = (*tree->keyCmp)(start->key, toKey);
+        if (cmp > 0 || ( cmp == 0 && toInclusive == FALSE )) {
+            cursor->remaining = 0L;
+        }
+        cursor->end = ( toInclusive == TRUE ) ? _get_higher_entry(tree, toKey)
+                                              : _get_ceiling_entry(tree, toKey);
+    }
+}
+
+void treemap_subMap(TreeMap *tree, void *fromKey, Boolean fromInclusive, void *toKey,
+                    Boolean toInclusive, Cursor *cursor) {
+    _range_cursor(tree, fromKey, fromInclusive, toKey, toInclusive, cursor);
+}
+
+void treemap_headMap(TreeMap *tree, void *toKey, Boolean inclusive, Cursor *cursor) {
+    _range_cursor(tree, NULL, FALSE, toKey, inclusive, cursor);
+}
+
+void treemap_tailMap(TreeMap *tree, void *fromKey, Boolean inclusive, Cursor *cursor) {
+    _range_cursor(tree, fromKey, inclusive, NULL, FALSE, cursor);
+}
+
+Status treemap_cursorNext(Cursor *cursor, void **next) {
+
+    TreeMap *tree = (TreeMap *)cursor->adt;
+    Node *node = (Node *)cursor->node;
+
+    // Fails fast if the treemap was modified since creating the cursor
+    if (tree->modCount != cursor->modCount) {
+        return CONCURRENT_MODIFICATION;
+    }
+    // Checks if every entry was visited
+    if (cursor->remaining == 0L) {
+        return ITER_END;
+    }
+
+    // Fetches the entry, advances within the leaf or on to the next one
+    if (IS_BTREE(tree) == TRUE) {
+        BtLeaf *leaf = (BtLeaf *)cursor->node;
+        *next = &(leaf->entries[cursor->index++]);
+        if (cursor->index == leaf->header.count) {
+            cursor->node = leaf->next;
+            cursor->index = 0L;
+        }
+    } else {
+        // Fetches the entry, advances to the in-order successor
+        *next = &(node->entry);
+        cursor->node = _successor(node);
+    }
+
+    // A range cursor runs out once it reaches the end of its range or of the treemap
+    cursor->remaining--;
+    TmEntry *upcoming = _cursor_entry(tree, cursor);
+    if (upcoming == NULL || upcoming == cursor->end) {
+        cursor->remaining = 0L;
+    }
+
+    return OK;
+}
+
+Boolean treemap_forEach(TreeMap *tree, Boolean (*action)(void *, void *, void *), void *context) {
+
+    BtLeaf *leaf;
+    Node *node;
+    long i;
+
+    // The B+-tree engine walks its chain of leaves
+    if (IS_BTREE(tree) == TRUE) {
+        for (leaf = tree->btHead; leaf != NULL; leaf = leaf->next) {
+            for (i = 0L; i < leaf->header.count; i++) {
+                if ((*action)(leaf->entries[i].key, leaf->entries[i].value, context) == FALSE) {
+                    return FALSE;
+                }
+            }
+        }
+        return TRUE;
+    }
+
+    node = ( tree->root != NULL ) ? _get_min(tree->root) : NULL;
+    for (; node != NULL; node = _successor(node)) {
+        if ((*action)(node->entry.key, node->entry.value, context) == FALSE) {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+// Parallel walks give each thread at least this many entries, smaller trees are walked in place
+#define MIN_PARALLEL_RUN 16384L
+// The most threads a parallel walk uses
+#define MAX_THREADS 64
+
+/**
+ * One thread's share of a parallel walk: `count` entries in key order, starting from `node` (or
+ * from entry `index` of `leaf` in the B+-tree engine), either handed to `action` or folded into
+ * `partial` through `reducer`.
+ */
+typedef struct {
+    Node *node;                                         // The share's first node, if red-black
+    BtLeaf *leaf;                                       // The share's first leaf, if a B+-tree
+    int index;                                          // The share's first entry in `leaf`
+    long count;                                         // Number of entries in the share
+    Boolean (*action)(void *, void *, void *);          // Function applied to each entry, or NULL
+    void *(*reducer)(void *, void *, void *, void *);   // Function folding each entry, or NULL
+    void *context;                                      // Argument passed along to each call
+    void *partial;                                      // The share's folded result
+    int *stop;                                          // Raised once any action asks to stop
+} WalkTask;
+
+/**
+ * Hands `entry` to the walk described by `task`, returning FALSE once the walk should stop.
+ */
+static Boolean _walk_entry(WalkTask *task, TmEntry *entry) {
+
+    if (task->reducer != NULL) {
+        task->partial = (*task->reducer)(task->partial, entry->key, entry->value, task->context);
+        return TRUE;
+    }
+    if ((*task->action)(entry->key, entry->value, task->context) == FALSE) {
+        __atomic_store_n(task->stop, 1, __ATOMIC_RELAXED);
+        return FALSE;
+    }
+
+    return ( __atomic_load_n(task->stop, __ATOMIC_RELAXED) == 0 ) ? TRUE : FALSE;
+}
+
+/**
+ * Thread routine walking the share of the tree described by the WalkTask `arg`.
+ */
+static void *_walk_task(void *arg) {
+
+    WalkTask *task = (WalkTask *)arg;
+    BtLeaf *leaf = task->leaf;
+    Node *node = task->node;
+    long i;
+    int j = task->index;
+
+    for (i = 0L; i < task->count; i++) {
+        if (leaf != NULL) {
+            if (j == leaf->header.count) {
+                leaf = leaf->next;
+                j = 0;
+            }
+            if (_walk_entry(task, &(leaf->entries[j++])) == FALSE) {
+                break;
+            }
+        } else {
+            if (_walk_entry(task, &(node->entry)) == FALSE) {
+                break;
+            }
+            node = _successor(node);
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * Splits the tree into even runs of consecutive entries, one per thread, and walks each run with
+ * `action` or `reducer`. A red-black run starts at the node selected by its rank through the
+ * subtree sizes; B+-tree runs are found by skipping whole leaves along the leaf chain. Returns the
+ * number of runs, now filled in `tasks`.
+ */
+static int _parallel_walk(TreeMap *tree, int nthreads, Boolean (*action)(void *, void *, void *),
+                          void *(*reducer)(void *, void *, void *, void *), void *context,
+                          int *stop, WalkTask *tasks) {
+
+    pthread_t threads[MAX_THREADS];
+    Boolean started[MAX_THREADS];
+    BtLeaf *leaf = tree->btHead;
+    long lo, hi, skipped = 0L;
+    int i;
+
+    if (nthreads > MAX_THREADS) {
+        nthreads = MAX_THREADS;
+    }
+    if ((long)nthreads > tree->size / MIN_PARALLEL_RUN) {
+        nthreads = (int)( tree->size / MIN_PARALLEL_RUN );
+    }
+    if (nthreads < 1) {
+        nthreads = 1;
+    }
+
+    for (i = 0; i < nthreads; i++) {
+        lo = ( tree->size * i ) / nthreads;
+        hi = ( tree->size * ( i + 1 ) ) / nthreads;
+        tasks[i].node = NULL;
+        tasks[i].leaf = NULL;
+        tasks[i].index = 0;
+        tasks[i].count = hi - lo;
+        tasks[i].action = action;
+        tasks[i].reducer = reducer;
+        tasks[i].context = context;
+        tasks[i].partial = NULL;
+        tasks[i].stop = stop;
+        if (tasks[i].count == 0L) {
+            continue;
+        }
+        if (IS_BTREE(tree) == TRUE) {
+            while (lo - skipped >= leaf->header.count) {
+                skipped += leaf->header.count;
+                leaf = leaf->next;
+            }
+            tasks[i].leaf = leaf;
+            tasks[i].index = (int)( lo - skipped );
+        } else {
+            tasks[i].node = _select_node(tree, lo);
+        }
+    }
+
+    // The calling thread takes the last run, as well as any whose thread couldn't be started
+    for (i = 0; i < nthreads - 1; i++) {
+        started[i] = TRUE;
+        if (pthread_create(&threads[i], NULL, _walk_task, &tasks[i]) != 0) {
+            started[i] = FALSE;
+            (void)_walk_task(&tasks[i]);
+        }
+    }
+    (void)_walk_task(&tasks[nthreads - 1]);
+    for (i = 0; i < nthreads - 1; i++) {
+        if (started[i] == TRUE) {
+            pthread_join(threads[i], NULL);
+        }
+    }
+
+    return nthreads;
+}
+
+Boolean treemap_parallelForEach(TreeMap *tree, int nthreads,
+                                Boolean (*action)(void *, void *, void *), void *context) {
+
+    WalkTask tasks[MAX_THREADS];
+    int stop = 0;
+
+    (void)_parallel_walk(tree, nthreads, action, NULL, context, &stop, tasks);
+
+    return ( stop == 0 ) ? TRUE : FALSE;
+}
+
+void *treemap_parallelReduce(TreeMap *tree, int nthreads,
+                             void *(*reducer)(void *, void *, void *, void *),
+                             void *(*combiner)(void *, void *, void *), void *context) {
+
+    WalkTask tasks[MAX_THREADS];
+    void *result;
+    int n, i, stop = 0;
+
+    // Combines the runs' results in key order; every run holds at least one entry
+    if (IS_EMPTY(tree) == TRUE) {
+        return NULL;
+    }
+    n = _parallel_walk(tree, nthreads, NULL, reducer, context, &stop, tasks);
+    result = tasks[0].partial;
+    for (i = 1; i < n; i++) {
+        result = (*combiner)(result, tasks[i].partial, context);
+    }
+
+    return result;
+}
+
+/**
+ * Appends the entry `key` -> `value` to the snapshot writer `writer`, stopping the walk on failure.
+ */
+static Boolean _save_entry(void *key, void *value, void *writer) {
+    return ( snapshot_writerAdd((SnapshotWriter *)writer, key, value) == OK ) ? TRUE : FALSE;
+}
+
+Status treemap_saveTo(TreeMap *tree, int fd, long (*keySerializer)(void *, void *, long),
+                      long (*valueSerializer)(void *, void *, long)) {
+
+    SnapshotWriter *writer;
+    Status status;
+
+    status = snapshot_writerNew(&writer, fd, keySerializer, valueSerializer, TRUE);
+    if (status != OK) {
+        return status;
+    }
+    // A failed record is remembered by the writer, and reported when it is finished
+    (void)treemap_forEach(tree, _save_entry, writer);
+
+    return snapshot_writerFinish(writer);
+}
+
+/**
+ * Deserializes the `i`-th record of `snapshot` into `*key` and `*value`. Returns ALLOC_FAILURE,
+ * with nothing left allocated, if either could not be.
+ */
+static Status _load_entry(TreeMap *tree, Snapshot *snapshot, long i,
+                          void *(*keyDeserializer)(const void *, long),
+                          void *(*valueDeserializer)(const void *, long), void **key,
+                          void **value) {
+
+    const void *keyBytes, *valueBytes;
+    long keyLen, valueLen;
+    Status status;
+
+    status = snapshot_entry(snapshot, i, &keyBytes, &keyLen, &valueBytes, &valueLen);
+    if (status != OK) {
+        return status;
+    }
+    if ((*key = (*keyDeserializer)(keyBytes, keyLen)) == NULL) {
+        return ALLOC_FAILURE;
+    }
+    if ((*value = (*valueDeserializer)(valueBytes, valueLen)) == NULL) {
+        if (tree->keyDxn != NULL) {
+            (*tree->keyDxn)(*key);
+        }
+        return ALLOC_FAILURE;
+    }
+
+    return OK;
+}
+
+/**
+ * Builds the empty red-black tree `tree` in one pass out of the sorted snapshot `snapshot`, which
+ * holds `n` records. Sets `*sorted` to FALSE, with the tree left empty, if the keys turn out not
+ * to be strictly ascending.
+ */
+static Status _load_sorted(TreeMap *tree, Snapshot *snapshot, long n,
+                           void *(*keyDeserializer)(const void *, long),
+                           void *(*valueDeserializer)(const void *, long),
+                           void (*valueDestructor)(void *), Boolean *sorted) {
+
+    void **keys, **values;
+    Status status = OK;
+    long i, loaded;
+
+    keys = (void **)malloc(sizeof(void *) * n);
+    values = (void **)malloc(sizeof(void *) * n);
+    if (keys == NULL || values == NULL) {
+        free(keys);
+        free(values);
+        return ALLOC_FAILURE;
+    }
+
+    // Deserializes every record, checking the order against the treemap's own comparator
+    for (loaded = 0L; loaded < n && *sorted == TRUE; loaded++) {
+        status = _load_entry(tree, snapshot, loaded, keyDeserializer, valueDeserializer,
+                             &keys[loaded], &values[loaded]);
+        if (status != OK) {
+            break;
+        }
+        if (loaded > 0L && (*tree->keyCmp)(keys[loaded - 1L], keys[loaded]) >= 0) {
+            *sorted = FALSE;
+        }
+    }
+    if (status == OK && *sorted == TRUE) {
+        status = _build_sorted(tree, keys, values, n);
+        if (status != OK) {
+            // The entries are destroyed below, not with the partial tree
+            _clear_tree(tree, NULL, NULL);
+            tree->root = NULL;
+            tree->size = 0L;
+        }
+    }
+    if (status != OK || *sorted == FALSE) {
+        for (i = 0L; i < loaded; i++) {
+            if (tree->keyDxn != NULL) {
+                (*tree->keyDxn)(keys[i]);
+            }
+            if (valueDestructor != NULL) {
+                (*valueDestructor)(values[i]);
+            }
+        }
+    }
+    free(keys);
+    free(values);
+
+    return status;
+}
+
+Status treemap_loadFrom(TreeMap *tree, int fd, void *(*keyDeserializer)(const void *, long),
+                        void *(*valueDeserializer)(const void *, long),
+                        void (*valueDestructor)(void *)) {
+
+    Snapshot *snapshot;
+    void *key, *value, *previous;
+    Boolean sorted;
+    long i, n;
+    Status status;
+
+    if ((status = snapshot_open(&snapshot, fd)) != OK) {
+        return status;
+    }
+    n = snapshot_size(snapshot);
+
+    // An empty red-black tree is built balanced in one pass if the records are in order
+    sorted = snapshot_isSorted(snapshot);
+    if (n > 0L && sorted == TRUE && IS_EMPTY(tree) == TRUE && IS_BTREE(tree) == FALSE) {
+        status = _load_sorted(tree, snapshot, n, keyDeserializer, valueDeserializer,
+                              valueDestructor, &sorted);
+        if (status != OK || sorted == TRUE) {
+            tree->modCount++;
+            snapshot_close(snapshot);
+            return status;
+        }
+    }
+
+    for (i = 0L; i < n; i++) {
+        status = _load_entry(tree, snapshot, i, keyDeserializer, valueDeserializer, &key,
+                             &value);
+        if (status != OK) {
+            break;
+        }
+        status = treemap_put(tree, key, value, &previous);
+        if (status == REPLACED) {
+            // The tree keeps the key it holds, so the duplicate goes along with the old value
+            if (tree->keyDxn != NULL) {
+                (*tree->keyDxn)(key);
+            }
+            if (valueDestructor != NULL) {
+                (*valueDestructor)(previous);
+            }
+        } else if (status == ALLOC_FAILURE) {
+            if (tree->keyDxn != NULL) {
+                (*tree->keyDxn)(key);
+            }
+            if (valueDestructor != NULL) {
+                (*valueDestructor)(value);
+            }
+            break;
+        }
+        status = OK;
+    }
+    snapshot_close(snapshot);
+
+    return status;
+}
+
+long treemap_memoryUsage(TreeMap *tree) {
+
+    long nodes;
+
+    // B+-tree nodes are counted by walking the tree, red-black nodes come from the pool
+    if (IS_BTREE(tree) == TRUE) {
+        nodes = _bt_memory_usage(tree->btRoot);
+    } else if (tree->ownsPool == TRUE) {
+        nodes = nodepool_memoryUsage(tree->pool);
+    } else {
+        nodes = tree->size * (long)sizeof(Node);
+    }
+
+    return (long)sizeof(TreeMap) + nodes;
+}
+
 void treemap_destroy(TreeMap *tree, void (*valueDestructor)(void *)) {
-    _clear_tree(tree->root, tree->keyDxn, valueDestructor);
-    free(tree);
+    _clear_tree(tree, tree->keyDxn, valueDestructor);
+    if (IS_BTREE(tree) == TRUE) {
+        allocator_free(tree->allocator, tree->btRoot);
+    }
+    if (tree->ownsPool == TRUE) {
+        nodepool_destroy(tree->pool);
+    }
+    allocator_free(tree->allocator, tree);
 }
 
 void *tmentry_getKey(TmEntry *entry) {
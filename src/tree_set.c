@@ -43,6 +43,10 @@ struct treeset {
     int (*cmp)(void *, void *);     // Function for comparing elements in the tree
     Node *root;                     // Pointer to the tree's root node
     long size;                      // The treeset's current size
+    NodePool *pool;                 // Allocates the nodes
+    Boolean ownsPool;               // TRUE if `pool` is private to the treeset
+    const CdsAllocator *allocator;  // Allocates the struct and, if private, the pool
+    long modCount;                  // Number of structural modifications made
 };
 
 /**
@@ -60,33 +64,65 @@ typedef struct {
 // Macro for evaluating the color of the given node `n`
 #define COLOR(n) ( ( (n) != NULL ) ? n->color : BLACK )
 
-Status treeset_new(TreeSet **tree, int (*comparator)(void *, void *)) {
+/**
+ * Helper method to create a new treeset whose nodes come from `pool`, or from a private pool
+ * allocated through `allocator` if NULL (the default allocator, if also NULL).
+ */
+static Status _new_tree(TreeSet **tree, int (*comparator)(void *, void *), NodePool *pool,
+                        const CdsAllocator *allocator) {
+
+    if (allocator == NULL) {
+        allocator = allocator_default();
+    }
 
     // Allocate the struct, check for allocation failures
-    TreeSet *temp = (TreeSet *)malloc(sizeof(TreeSet));
+    TreeSet *temp = (TreeSet *)allocator_alloc(allocator, sizeof(TreeSet));
     if (temp == NULL) {
         return ALLOC_FAILURE;
     }
 
+    // Creates a private pool for the nodes unless one was provided
+    temp->ownsPool = ( pool == NULL ) ? TRUE : FALSE;
+    if (pool == NULL && nodepool_newWithAllocator(&pool, 0L, allocator) != OK) {
+        allocator_free(allocator, temp);
+        return ALLOC_FAILURE;
+    }
+    temp->pool = pool;
+    temp->allocator = allocator;
+
     // Initialize remaining struct members
     temp->cmp = comparator;
     temp->root = NULL;
     temp->size = 0L;
+    temp->modCount = 0L;
     *tree = temp;
 
     return OK;
 }
 
+Status treeset_newWithPool(TreeSet **tree, int (*comparator)(void *, void *), NodePool *pool) {
+    return _new_tree(tree, comparator, pool, NULL);
+}
+
+Status treeset_newWithAllocator(TreeSet **tree, int (*comparator)(void *, void *),
+                                const CdsAllocator *allocator) {
+    return _new_tree(tree, comparator, NULL, allocator);
+}
+
+Status treeset_new(TreeSet **tree, int (*comparator)(void *, void *)) {
+    return treeset_newWithPool(tree, comparator, NULL);
+}
+
 // Macro to check if the treeset `t` is currently empty
 #define IS_EMPTY(t)  ( ((t)->size == 0L) ? TRUE : FALSE )
 
 /**
- * Allocates and returns a new node for the treeset with the value `item`.
+ * Allocates and returns a new node for the treeset `tree` with the value `item`.
  */
-static Node *_malloc_node(void *item) {
+static Node *_malloc_node(TreeSet *tree, void *item) {
 
     // Allocates memory for the tree node
-    Node *node = (Node *)malloc(sizeof(Node));
+    Node *node = (Node *)nodepool_alloc(tree->pool, sizeof(Node));
     if (node != NULL) {
         // Initializes the tree node's members
         node->parent = NULL;
@@ -181,6 +217,7 @@ static void _insert_node(TreeSet *tree, Node *node) {
     Node *temp = tree->root, *parent = NULL;
     int cmp = 0;
     tree->size++;
+    tree->modCount++;
 
     // Traverse down to the NIL node where the node is to be placed
     while (temp != NULL) {
@@ -281,7 +318,7 @@ Status treeset_add(TreeSet *tree, void *item) {
     }
 
     // Allocates memory for the new node
-    Node *node = _malloc_node(item);
+    Node *node = _malloc_node(tree, item);
     if (node == NULL) {
         return ALLOC_FAILURE;
     }
@@ -293,6 +330,62 @@ Status treeset_add(TreeSet *tree, void *item) {
     return OK;
 }
 
+/**
+ * Builds a balanced subtree out of the sorted items `items[lo..hi]` at the depth `depth` below
+ * `parent`, coloring every node black except those at the depth `redLevel`. Returns the subtree's
+ * root, or NULL if empty; `*status` is set to ALLOC_FAILURE on failures.
+ */
+static Node *_build_tree(TreeSet *tree, void **items, long lo, long hi, int depth, int redLevel,
+                         Node *parent, Status *status) {
+
+    if (lo > hi || *status != OK) {
+        return NULL;
+    }
+
+    // Allocates the middle item first, so a partial tree stays linked up if an allocation fails
+    long mid = lo + ( hi - lo ) / 2;
+    Node *node = _malloc_node(tree, items[mid]);
+    if (node == NULL) {
+        *status = ALLOC_FAILURE;
+        return NULL;
+    }
+    node->parent = parent;
+    node->color = ( depth == redLevel ) ? RED : BLACK;
+    tree->size++;
+
+    // Builds the left and right halves as the subtrees
+    node->left = _build_tree(tree, items, lo, mid - 1, depth + 1, redLevel, node, status);
+    node->right = _build_tree(tree, items, mid + 1, hi, depth + 1, redLevel, node, status);
+
+    return node;
+}
+
+Status treeset_fromSorted(TreeSet **tree, int (*comparator)(void *, void *), void **items, long n) {
+
+    TreeSet *temp;
+    Status status;
+    long m;
+    int redLevel = 0;
+
+    status = treeset_new(&temp, comparator);
+    if (status != OK) {
+        return status;
+    }
+
+    // Only the deepest level of a perfectly balanced tree may be partially filled, painted red
+    for (m = n - 1L; m >= 0L; m = m / 2L - 1L) {
+        redLevel++;
+    }
+    temp->root = _build_tree(temp, items, 0L, n - 1L, 0, redLevel, NULL, &status);
+    if (status != OK) {
+        treeset_destroy(temp, NULL);
+        return status;
+    }
+    *tree = temp;
+
+    return OK;
+}
+
 Boolean treeset_contains(TreeSet *tree, void *item) {
     return ( _find_node(tree, item) != NULL ) ? TRUE : FALSE;
 }
@@ -576,6 +669,7 @@ static void _delete_node(TreeSet *tree, Node *node, Node **src) {
 
     Node *splice, *child;
     tree->size--;
+    tree->modCount++;
 
     // Finds the node to be removed, swaps elements within predecessor
     if (node->left == NULL) {
@@ -631,7 +725,7 @@ Status treeset_pollFirst(TreeSet *tree, void **first) {
     // Remove node from tree, free allocated memory
     Node *temp;
     _delete_node(tree, node, &temp);
-    free(temp);
+    nodepool_free(tree->pool, temp, sizeof(Node));
 
     return OK;
 }
@@ -649,7 +743,7 @@ Status treeset_pollLast(TreeSet *tree, void **last) {
     // Remove node from tree, free allocated memory
     Node *temp;
     _delete_node(tree, node, &temp);
-    free(temp);
+    nodepool_free(tree->pool, temp, sizeof(Node));
 
     return OK;
 }
@@ -673,51 +767,79 @@ Status treeset_remove(TreeSet *tree, void *item, void (*destructor)(void *)) {
     if (destructor != NULL) {
         (*destructor)(toDelete);
     }
-    free(temp);
+    nodepool_free(tree->pool, temp, sizeof(Node));
 
     return OK;
 }
 
+Status treeset_addAll(TreeSet *tree, void **items, long n) {
+
+    long i;
+    for (i = 0L; i < n; i++) {
+        if (treeset_add(tree, items[i]) == ALLOC_FAILURE) {
+            return ALLOC_FAILURE;
+        }
+    }
+
+    return OK;
+}
+
+long treeset_removeAll(TreeSet *tree, void **items, long n, void (*destructor)(void *)) {
+
+    long i, removed = 0L;
+    for (i = 0L; i < n; i++) {
+        if (treeset_remove(tree, items[i], destructor) == OK) {
+            removed++;
+        }
+    }
+
+    return removed;
+}
+
 /**
  * Helper method to clear out the treeset of all its elements, applying the destructor method
- * `destructor` on each element (or if NULL, nothing will be done to the elements).
+ * `destructor` on each element (or if NULL, nothing will be done to the elements). The tree is
+ * torn down in place by right rotations, which needs neither a stack nor the parent links.
  */
-static void _clear_tree(Node *node, void (*destructor)(void *)) {
+static void _clear_tree(TreeSet *tree, void (*destructor)(void *)) {
 
-    Node *parent;
+    Node *node = tree->root, *left, *right;
 
+    // A private pool releases every node at once, so nodes are only visited for the destructor
+    if (tree->ownsPool == TRUE && destructor == NULL) {
+        nodepool_reset(tree->pool);
+        return;
+    }
+
+    // Rotates each left child up until the node has none, so every node is visited exactly once
     while (node != NULL) {
-        parent = node->parent;
-        // Node is a leaf node, safe to delete
-        if (node->left == NULL && node->right == NULL) {
-            // Need to nullify parent's correct child node
-            if (parent != NULL) {
-                if (parent->left == node) {
-                    parent->left = NULL;
-                } else {
-                    parent->right = NULL;
-                }
-            }
-            // Deallocate node and stored item
-            if (*destructor != NULL) {
-                (*destructor)(node->data);
-            }
-            free(node);
-            node = parent;
-        } else if (node->left != NULL) {
-            // Left child exists, traverse left subtree
-            node = node->left;
-        } else {
-            // Right child exists, traverse right subtree
-            node = node->right;
+        if (node->left != NULL) {
+            left = node->left;
+            node->left = left->right;
+            left->right = node;
+            node = left;
+            continue;
+        }
+        // Node has no left subtree, destroy it and continue with its right subtree
+        right = node->right;
+        if (destructor != NULL) {
+            (*destructor)(node->data);
         }
+        if (tree->ownsPool == FALSE) {
+            nodepool_free(tree->pool, node, sizeof(Node));
+        }
+        node = right;
+    }
+    if (tree->ownsPool == TRUE) {
+        nodepool_reset(tree->pool);
     }
 }
 
 void treeset_clear(TreeSet *tree, void (*destructor)(void *)) {
-    _clear_tree(tree->root, destructor);
+    _clear_tree(tree, destructor);
     tree->root = NULL;
     tree->size = 0L;
+    tree->modCount++;
 }
 
 long treeset_size(TreeSet *tree) {
@@ -818,7 +940,250 @@ Status treeset_iterator(TreeSet *tree, Iterator **iter) {
     return OK;
 }
 
+/**
+ * Returns the in-order successor of the node `node`, or NULL if `node` is the last node.
+ */
+static Node *_successor(Node *node) {
+
+    // Successor is the leftmost node of the right subtree, if any
+    if (node->right != NULL) {
+        return _get_min(node->right);
+    }
+    // Otherwise, it's the first ancestor whose left subtree holds the node
+    Node *parent = node->parent;
+    while (parent != NULL && node == parent->right) {
+        node = parent;
+        parent = parent->parent;
+    }
+
+    return parent;
+}
+
+void treeset_cursor(TreeSet *tree, Cursor *cursor) {
+    cursor->adt = tree;
+    cursor->node = ( tree->root != NULL ) ? _get_min(tree->root) : NULL;
+    cursor->index = 0L;
+    cursor->remaining = tree->size;
+    cursor->modCount = tree->modCount;
+    cursor->end = NULL;
+}
+
+/**
+ * Fetches and returns the first node of the treeset `tree` whose element is greater than (or if
+ * `inclusive` is TRUE, equal to) `item`, or NULL if no such node exists.
+ */
+static Node *_get_bound_node(TreeSet *tree, void *item, Boolean inclusive) {
+
+    Node *temp = NULL;
+    Node *current = tree->root;
+
+    while (current != NULL) {
+        int cmp = (*tree->cmp)(item, current->data);
+        if (cmp > 0 || ( cmp == 0 && inclusive == FALSE )) {
+            current = current->right;
+        } else {
+            // Potential bound found
+            temp = current;
+            current = current->left;
+        }
+    }
+
+    return temp;
+}
+
+/**
+ * Initializes `cursor` to walk over the elements of the treeset `tree` between `fromItem` and
+ * `toItem`, where a NULL bound leaves that side of the range open. The first element is found with
+ * a single descent; the walk then stops before the first element past `toItem`.
+ */
+static void _range_cursor(TreeSet *tree, void *fromItem, Boolean fromInclusive, void *toItem,
+                          Boolean toInclusive, Cursor *cursor) {
+
+    Node *start;
+
+    treeset_cursor(tree, cursor);
+    if (fromItem != NULL) {
+        cursor->node = _get_bound_node(tree, fromItem, fromInclusive);
+    }
+
+    // The walk ends before the first element past the upper bound
+    start = (Node *)cursor->node;
+    if (start == NULL) {
+        cursor->remaining = 0L;
+    } else if (toItem != NULL) {
+        int cmp = (*tree->cmp)(start->data, toItem);
+        if (cmp > 0 || ( cmp == 0 && toInclusive == FALSE )) {
+            cursor->remaining = 0L;
+        }
+        cursor->end = _get_bound_node(tree, toItem, ( toInclusive == TRUE ) ? FALSE : TRUE);
+    }
+}
+
+void treeset_subSet(TreeSet *tree, void *fromItem, Boolean fromInclusive, void *toItem,
+                    Boolean toInclusive, Cursor *cursor) {
+    _range_cursor(tree, fromItem, fromInclusive, toItem, toInclusive, cursor);
+}
+
+void treeset_headSet(TreeSet *tree, void *toItem, Boolean inclusive, Cursor *cursor) {
+    _range_cursor(tree, NULL, FALSE, toItem, inclusive, cursor);
+}
+
+void treeset_tailSet(TreeSet *tree, void *fromItem, Boolean inclusive, Cursor *cursor) {
+    _range_cursor(tree, fromItem, inclusive, NULL, FALSE, cursor);
+}
+
+Status treeset_cursorNext(Cursor *cursor, void **next) {
+
+    TreeSet *tree = (TreeSet *)cursor->adt;
+    Node *node = (Node *)cursor->node;
+
+    // Fails fast if the treeset was modified since creating the cursor
+    if (tree->modCount != cursor->modCount) {
+        return CONCURRENT_MODIFICATION;
+    }
+    // Checks if every element was visited
+    if (cursor->remaining == 0L) {
+        return ITER_END;
+    }
+
+    // Fetches the element, advances to the in-order successor
+    *next = node->data;
+    cursor->node = _successor(node);
+
+    // A range cursor runs out once it reaches the end of its range or of the treeset
+    cursor->remaining--;
+    if (cursor->node == NULL || cursor->node == cursor->end) {
+        cursor->remaining = 0L;
+    }
+
+    return OK;
+}
+
+// Set operations probe the larger treeset rather than merge once it is this many times larger
+#define PROBE_RATIO 32L
+
+// Kinds of set operations performed by _set_op()
+#define OP_UNION 0
+#define OP_INTERSECT 1
+#define OP_DIFFERENCE 2
+
+/**
+ * Collects the elements of the union, intersection or difference (as per `op`) of the treesets `a`
+ * and `b` into an array in ascending order, by walking both trees in order side by side. If one
+ * treeset is much smaller than the other, its elements are instead looked up in the larger one, as
+ * a few searches cost less than a walk over the whole larger tree. The result is then built from
+ * the array in one linear pass, as treeset_fromSorted() does.
+ */
+static Status _set_op(TreeSet *a, TreeSet *b, int op, TreeSet **result) {
+
+    Node *x = ( a->root != NULL ) ? _get_min(a->root) : NULL;
+    Node *y = ( b->root != NULL ) ? _get_min(b->root) : NULL;
+    Node *node;
+    Boolean keep;
+    long n = 0L, cap;
+    int cmp;
+
+    // Allocates room for the largest possible result
+    if (op == OP_UNION) {
+        cap = a->size + b->size;
+    } else {
+        cap = ( op == OP_INTERSECT && b->size < a->size ) ? b->size : a->size;
+    }
+    void **items = (void **)malloc(( cap > 0L ? cap : 1L ) * sizeof(void *));
+    if (items == NULL) {
+        return ALLOC_FAILURE;
+    }
+
+    if (op != OP_UNION && a->size * PROBE_RATIO < b->size) {
+        // Looks each element of the small `a` up in `b`
+        keep = ( op == OP_INTERSECT ) ? TRUE : FALSE;
+        for (; x != NULL; x = _successor(x)) {
+            if (( _find_node(b, x->data) != NULL ? TRUE : FALSE ) == keep) {
+                items[n++] = x->data;
+            }
+        }
+    } else if (op == OP_INTERSECT && b->size * PROBE_RATIO < a->size) {
+        // Looks each element of the small `b` up in `a`, keeping the elements of `a`
+        for (; y != NULL; y = _successor(y)) {
+            node = _find_node(a, y->data);
+            if (node != NULL) {
+                items[n++] = node->data;
+            }
+        }
+    } else {
+        // Merges both trees, taking the element of `a` when both hold it
+        while (x != NULL && y != NULL) {
+            cmp = (*a->cmp)(x->data, y->data);
+            if (cmp < 0) {
+                if (op != OP_INTERSECT) {
+                    items[n++] = x->data;
+                }
+                x = _successor(x);
+            } else if (cmp > 0) {
+                if (op == OP_UNION) {
+                    items[n++] = y->data;
+                }
+                y = _successor(y);
+            } else {
+                if (op != OP_DIFFERENCE) {
+                    items[n++] = x->data;
+                }
+                x = _successor(x);
+                y = _successor(y);
+            }
+        }
+        for (; x != NULL && op != OP_INTERSECT; x = _successor(x)) {
+            items[n++] = x->data;
+        }
+        for (; y != NULL && op == OP_UNION; y = _successor(y)) {
+            items[n++] = y->data;
+        }
+    }
+
+    Status status = treeset_fromSorted(result, a->cmp, items, n);
+    free(items);
+
+    return status;
+}
+
+Status treeset_union(TreeSet *a, TreeSet *b, TreeSet **result) {
+    return _set_op(a, b, OP_UNION, result);
+}
+
+Status treeset_intersect(TreeSet *a, TreeSet *b, TreeSet **result) {
+    return _set_op(a, b, OP_INTERSECT, result);
+}
+
+Status treeset_difference(TreeSet *a, TreeSet *b, TreeSet **result) {
+    return _set_op(a, b, OP_DIFFERENCE, result);
+}
+
+Boolean treeset_forEach(TreeSet *tree, Boolean (*action)(void *, void *), void *context) {
+
+    Node *node = ( tree->root != NULL ) ? _get_min(tree->root) : NULL;
+
+    for (; node != NULL; node = _successor(node)) {
+        if ((*action)(node->data, context) == FALSE) {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+long treeset_memoryUsage(TreeSet *tree) {
+
+    // A private pool is charged in full, a shared one only for the nodes in use
+    long nodes = ( tree->ownsPool == TRUE ) ? nodepool_memoryUsage(tree->pool)
+                                            : tree->size * (long)sizeof(Node);
+
+    return (long)sizeof(TreeSet) + nodes;
+}
+
 void treeset_destroy(TreeSet *tree, void (*destructor)(void *)) {
-    _clear_tree(tree->root, destructor);
-    free(tree);
+    _clear_tree(tree, destructor);
+    if (tree->ownsPool == TRUE) {
+        nodepool_destroy(tree->pool);
+    }
+    allocator_free(tree->allocator, tree);
 }
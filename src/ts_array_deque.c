@@ -0,0 +1,308 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2020 Cole Vikupitz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include "array_deque.h"
+#include "ts_array_deque.h"
+#include "ts_lock.h"
+
+/**
+ * Struct for the thread-safe array deque.
+ */
+struct ts_arraydeque {
+    TsLock lock;                // The lock
+    ArrayDeque *instance;       // Internal instance of ArrayDeque
+} CACHE_ALIGNED;
+
+// Macro used for locking the deque `dq` for writing
+#define LOCK(dq)       ts_lock_write( &((dq)->lock) )
+// Macro used for locking the deque `dq` for reading
+#define READ_LOCK(dq)  ts_lock_read( &((dq)->lock) )
+// Macro used for unlocking the deque `dq`
+#define UNLOCK(dq)     ts_lock_unlock( &((dq)->lock) )
+
+Status ts_arraydeque_new(ConcurrentArrayDeque **deque, long capacity) {
+
+    ConcurrentArrayDeque *temp;
+    Status status;
+
+    // Allocates memory for the deque
+    temp = (ConcurrentArrayDeque *)ts_lock_alloc(sizeof(ConcurrentArrayDeque));
+    if (temp == NULL) {
+        return ALLOC_FAILURE;
+    }
+
+    // Creates new internal deque instance
+    status = arraydeque_new(&(temp->instance), capacity);
+    if (status != OK) {
+        free(temp);
+        return status;
+    }
+
+    // Creates the lock with the calling thread's default lock policy
+    ts_lock_init(&(temp->lock));
+    *deque = temp;
+
+    return OK;
+}
+
+void ts_arraydeque_lock(ConcurrentArrayDeque *deque) {
+    LOCK(deque);
+}
+
+void ts_arraydeque_unlock(ConcurrentArrayDeque *deque) {
+    UNLOCK(deque);
+}
+
+void ts_arraydeque_lockRead(ConcurrentArrayDeque *deque) {
+    READ_LOCK(deque);
+}
+
+void ts_arraydeque_lockWrite(ConcurrentArrayDeque *deque) {
+    LOCK(deque);
+}
+
+Status ts_arraydeque_addFirst(ConcurrentArrayDeque *deque, void *item) {
+
+    LOCK(deque);
+    Status status = arraydeque_addFirst(deque->instance, item);
+    UNLOCK(deque);
+
+    return status;
+}
+
+Status ts_arraydeque_addLast(ConcurrentArrayDeque *deque, void *item) {
+
+    LOCK(deque);
+    Status status = arraydeque_addLast(deque->instance, item);
+    UNLOCK(deque);
+
+    return status;
+}
+
+Status ts_arraydeque_insert(ConcurrentArrayDeque *deque, long i, void *item) {
+
+    LOCK(deque);
+    Status status = arraydeque_insert(deque->instance, i, item);
+    UNLOCK(deque);
+
+    return status;
+}
+
+Status ts_arraydeque_first(ConcurrentArrayDeque *deque, void **first) {
+
+    READ_LOCK(deque);
+    Status status = arraydeque_first(deque->instance, first);
+    UNLOCK(deque);
+
+    return status;
+}
+
+Status ts_arraydeque_last(ConcurrentArrayDeque *deque, void **last) {
+
+    READ_LOCK(deque);
+    Status status = arraydeque_last(deque->instance, last);
+    UNLOCK(deque);
+
+    return status;
+}
+
+Status ts_arraydeque_get(ConcurrentArrayDeque *deque, long i, void **item) {
+
+    READ_LOCK(deque);
+    Status status = arraydeque_get(deque->instance, i, item);
+    UNLOCK(deque);
+
+    return status;
+}
+
+Status ts_arraydeque_set(ConcurrentArrayDeque *deque, long i, void *item, void **previous) {
+
+    LOCK(deque);
+    Status status = arraydeque_set(deque->instance, i, item, previous);
+    UNLOCK(deque);
+
+    return status;
+}
+
+Status ts_arraydeque_removeFirst(ConcurrentArrayDeque *deque, void **first) {
+
+    LOCK(deque);
+    Status status = arraydeque_removeFirst(deque->instance, first);
+    UNLOCK(deque);
+
+    return status;
+}
+
+Status ts_arraydeque_removeLast(ConcurrentArrayDeque *deque, void **last) {
+
+    LOCK(deque);
+    Status status = arraydeque_removeLast(deque->instance, last);
+    UNLOCK(deque);
+
+    return status;
+}
+
+Status ts_arraydeque_remove(ConcurrentArrayDeque *deque, long i, void **item) {
+
+    LOCK(deque);
+    Status status = arraydeque_remove(deque->instance, i, item);
+    UNLOCK(deque);
+
+    return status;
+}
+
+Status ts_arraydeque_ensureCapacity(ConcurrentArrayDeque *deque, long capacity) {
+
+    LOCK(deque);
+    Status status = arraydeque_ensureCapacity(deque->instance, capacity);
+    UNLOCK(deque);
+
+    return status;
+}
+
+void ts_arraydeque_clear(ConcurrentArrayDeque *deque, void (*destructor)(void *)) {
+
+    LOCK(deque);
+    arraydeque_clear(deque->instance, destructor);
+    UNLOCK(deque);
+}
+
+long ts_arraydeque_size(ConcurrentArrayDeque *deque) {
+
+    READ_LOCK(deque);
+    long size = arraydeque_size(deque->instance);
+    UNLOCK(deque);
+
+    return size;
+}
+
+long ts_arraydeque_capacity(ConcurrentArrayDeque *deque) {
+
+    READ_LOCK(deque);
+    long capacity = arraydeque_capacity(deque->instance);
+    UNLOCK(deque);
+
+    return capacity;
+}
+
+Boolean ts_arraydeque_isEmpty(ConcurrentArrayDeque *deque) {
+
+    READ_LOCK(deque);
+    Boolean isEmpty = arraydeque_isEmpty(deque->instance);
+    UNLOCK(deque);
+
+    return isEmpty;
+}
+
+Status ts_arraydeque_toArray(ConcurrentArrayDeque *deque, Array **array) {
+
+    READ_LOCK(deque);
+    Status status = arraydeque_toArray(deque->instance, array);
+    UNLOCK(deque);
+
+    return status;
+}
+
+Status ts_arraydeque_iterator(ConcurrentArrayDeque *deque, ConcurrentIterator **iter) {
+
+    Array *array;
+    Status status;
+
+    // Creates the array of items and locks the instance
+    READ_LOCK(deque);
+    status = arraydeque_toArray(deque->instance, &array);
+    if (status != OK) {
+        UNLOCK(deque);
+        return status;
+    }
+
+    // Creates the iterator
+    status = ts_iterator_newWithRelease(iter, ts_lock_release, &(deque->lock),
+                                        array->items, array->len);
+    if (status != OK) {
+        FREE_ARRAY(array);
+        UNLOCK(deque);
+    } else {
+        free(array);
+    }
+
+    return status;
+}
+
+Boolean ts_arraydeque_forEach(ConcurrentArrayDeque *deque, Boolean (*action)(void *, void *),
+                              void *context) {
+
+    READ_LOCK(deque);
+    Boolean complete = arraydeque_forEach(deque->instance, action, context);
+    UNLOCK(deque);
+
+    return complete;
+}
+
+Status ts_arraydeque_snapshot(ConcurrentArrayDeque *deque, ConcurrentIterator **iter) {
+
+    Array *array;
+    Status status;
+
+    // Copies the items under the lock, then releases it right away
+    READ_LOCK(deque);
+    status = arraydeque_toArray(deque->instance, &array);
+    UNLOCK(deque);
+    if (status != OK) {
+        return status;
+    }
+
+    // Creates the iterator, which holds no lock while the caller iterates
+    status = ts_iterator_newSnapshot(iter, array->items, array->len);
+    if (status != OK) {
+        FREE_ARRAY(array);
+    } else {
+        free(array);
+    }
+
+    return status;
+}
+
+long ts_arraydeque_memoryUsage(ConcurrentArrayDeque *deque) {
+
+    READ_LOCK(deque);
+    long bytes = (long)sizeof(ConcurrentArrayDeque) + arraydeque_memoryUsage(deque->instance);
+    UNLOCK(deque);
+
+    return bytes;
+}
+
+void ts_arraydeque_lockStats(ConcurrentArrayDeque *deque, LockStats *stats) {
+    ts_lock_stats(&(deque->lock), stats);
+}
+
+void ts_arraydeque_destroy(ConcurrentArrayDeque *deque, void (*destructor)(void *)) {
+
+    LOCK(deque);
+    arraydeque_destroy(deque->instance, destructor);
+    UNLOCK(deque);
+    ts_lock_destroy(&(deque->lock));
+    free(deque);
+}
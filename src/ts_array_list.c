@@ -22,32 +22,33 @@
  * SOFTWARE.
  */
 
-#include <pthread.h>
 #include <stdlib.h>
 #include "array_list.h"
 #include "ts_array_list.h"
+#include "ts_lock.h"
 
 /**
  * Struct for the thread-safe arraylist.
  */
 struct ts_arraylist {
-    pthread_mutex_t lock;       // The lock
+    TsLock lock;                // The lock
     ArrayList *instance;        // Internal instance of ArrayList
-};
+} CACHE_ALIGNED;
 
-// Macro used for locking the arraylist `li`
-#define LOCK(li)    pthread_mutex_lock( &((li)->lock) )
+// Macro used for locking the arraylist `li` for writing
+#define LOCK(li)       ts_lock_write( &((li)->lock) )
+// Macro used for locking the arraylist `li` for reading
+#define READ_LOCK(li)  ts_lock_read( &((li)->lock) )
 // Macro used for unlocking the arraylist `li`
-#define UNLOCK(li)  pthread_mutex_unlock( &((li)->lock) )
+#define UNLOCK(li)     ts_lock_unlock( &((li)->lock) )
 
 Status ts_arraylist_new(ConcurrentArrayList **list, long capacity) {
 
     ConcurrentArrayList *temp;
     Status status;
-    pthread_mutexattr_t attr;
 
     // Allocates memory for the arraylist
-    temp = (ConcurrentArrayList *)malloc(sizeof(ConcurrentArrayList));
+    temp = (ConcurrentArrayList *)ts_lock_alloc(sizeof(ConcurrentArrayList));
     if (temp == NULL) {
         return ALLOC_FAILURE;
     }
@@ -59,11 +60,8 @@ Status ts_arraylist_new(ConcurrentArrayList **list, long capacity) {
         return status;
     }
 
-    // Create the pthread_mutex for locking
-    pthread_mutexattr_init(&attr);
-    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
-    pthread_mutex_init(&(temp->lock), &attr);
-    pthread_mutexattr_destroy(&attr);
+    // Creates the lock with the calling thread's default lock policy
+    ts_lock_init(&(temp->lock));
     *list = temp;
 
     return OK;
@@ -77,6 +75,14 @@ void ts_arraylist_unlock(ConcurrentArrayList *list) {
     UNLOCK(list);
 }
 
+void ts_arraylist_lockRead(ConcurrentArrayList *list) {
+    READ_LOCK(list);
+}
+
+void ts_arraylist_lockWrite(ConcurrentArrayList *list) {
+    LOCK(list);
+}
+
 Status ts_arraylist_add(ConcurrentArrayList *list, void *item) {
 
     LOCK(list);
@@ -95,9 +101,27 @@ Status ts_arraylist_insert(ConcurrentArrayList *list, long i, void *item) {
     return status;
 }
 
-Status ts_arraylist_get(ConcurrentArrayList *list, long i, void **item) {
+Status ts_arraylist_addAll(ConcurrentArrayList *list, void **items, long n) {
+
+    LOCK(list);
+    Status status = arraylist_addAll(list->instance, items, n);
+    UNLOCK(list);
+
+    return status;
+}
+
+Status ts_arraylist_insertAll(ConcurrentArrayList *list, long i, void **items, long n) {
 
     LOCK(list);
+    Status status = arraylist_insertAll(list->instance, i, items, n);
+    UNLOCK(list);
+
+    return status;
+}
+
+Status ts_arraylist_get(ConcurrentArrayList *list, long i, void **item) {
+
+    READ_LOCK(list);
     Status status = arraylist_get(list->instance, i, item);
     UNLOCK(list);
 
@@ -122,6 +146,101 @@ Status ts_arraylist_remove(ConcurrentArrayList *list, long i, void **item) {
     return status;
 }
 
+Status ts_arraylist_removeRange(ConcurrentArrayList *list, long from, long to,
+                                void (*destructor)(void *)) {
+
+    LOCK(list);
+    Status status = arraylist_removeRange(list->instance, from, to, destructor);
+    UNLOCK(list);
+
+    return status;
+}
+
+long ts_arraylist_removeIf(ConcurrentArrayList *list, Boolean (*predicate)(void *),
+                           void (*destructor)(void *)) {
+
+    LOCK(list);
+    long removed = arraylist_removeIf(list->instance, predicate, destructor);
+    UNLOCK(list);
+
+    return removed;
+}
+
+Status ts_arraylist_sort(ConcurrentArrayList *list, int (*comparator)(void *, void *)) {
+
+    LOCK(list);
+    Status status = arraylist_sort(list->instance, comparator);
+    UNLOCK(list);
+
+    return status;
+}
+
+Status ts_arraylist_stableSort(ConcurrentArrayList *list, int (*comparator)(void *, void *)) {
+
+    LOCK(list);
+    Status status = arraylist_stableSort(list->instance, comparator);
+    UNLOCK(list);
+
+    return status;
+}
+
+Status ts_arraylist_parallelSort(ConcurrentArrayList *list, int (*comparator)(void *, void *),
+                                 int nthreads) {
+
+    LOCK(list);
+    Status status = arraylist_parallelSort(list->instance, comparator, nthreads);
+    UNLOCK(list);
+
+    return status;
+}
+
+long ts_arraylist_lowerBound(ConcurrentArrayList *list, void *key,
+                             int (*comparator)(void *, void *)) {
+
+    READ_LOCK(list);
+    long index = arraylist_lowerBound(list->instance, key, comparator);
+    UNLOCK(list);
+
+    return index;
+}
+
+long ts_arraylist_upperBound(ConcurrentArrayList *list, void *key,
+                             int (*comparator)(void *, void *)) {
+
+    READ_LOCK(list);
+    long index = arraylist_upperBound(list->instance, key, comparator);
+    UNLOCK(list);
+
+    return index;
+}
+
+Status ts_arraylist_binarySearch(ConcurrentArrayList *list, void *key,
+                                 int (*comparator)(void *, void *), long *index) {
+
+    READ_LOCK(list);
+    Status status = arraylist_binarySearch(list->instance, key, comparator, index);
+    UNLOCK(list);
+
+    return status;
+}
+
+Status ts_arraylist_insertSorted(ConcurrentArrayList *list, void *item,
+                                 int (*comparator)(void *, void *)) {
+
+    LOCK(list);
+    Status status = arraylist_insertSorted(list->instance, item, comparator);
+    UNLOCK(list);
+
+    return status;
+}
+
+void ts_arraylist_setGrowthFactor(ConcurrentArrayList *list, float growthFactor) {
+
+    LOCK(list);
+    arraylist_setGrowthFactor(list->instance, growthFactor);
+    UNLOCK(list);
+}
+
 Status ts_arraylist_ensureCapacity(ConcurrentArrayList *list, long capacity) {
 
     LOCK(list);
@@ -149,7 +268,7 @@ void ts_arraylist_clear(ConcurrentArrayList *list, void (*destructor)(void *)) {
 
 long ts_arraylist_size(ConcurrentArrayList *list) {
 
-    LOCK(list);
+    READ_LOCK(list);
     long size = arraylist_size(list->instance);
     UNLOCK(list);
 
@@ -158,7 +277,7 @@ long ts_arraylist_size(ConcurrentArrayList *list) {
 
 long ts_arraylist_capacity(ConcurrentArrayList *list) {
 
-    LOCK(list);
+    READ_LOCK(list);
     long capacity = arraylist_capacity(list->instance);
     UNLOCK(list);
 
@@ -167,7 +286,7 @@ long ts_arraylist_capacity(ConcurrentArrayList *list) {
 
 Boolean ts_arraylist_isEmpty(ConcurrentArrayList *list) {
 
-    LOCK(list);
+    READ_LOCK(list);
     Boolean isEmpty = arraylist_isEmpty(list->instance);
     UNLOCK(list);
 
@@ -176,7 +295,7 @@ Boolean ts_arraylist_isEmpty(ConcurrentArrayList *list) {
 
 Status ts_arraylist_toArray(ConcurrentArrayList *list, Array **array) {
 
-    LOCK(list);
+    READ_LOCK(list);
     Status status = arraylist_toArray(list->instance, array);
     UNLOCK(list);
 
@@ -189,7 +308,7 @@ Status ts_arraylist_iterator(ConcurrentArrayList *list, ConcurrentIterator **ite
     Status status;
 
     // Creates the array of items and locks the instance
-    LOCK(list);
+    READ_LOCK(list);
     status = arraylist_toArray(list->instance, &array);
     if (status != OK) {
         UNLOCK(list);
@@ -197,7 +316,8 @@ Status ts_arraylist_iterator(ConcurrentArrayList *list, ConcurrentIterator **ite
     }
 
     // Creates the iterator
-    status = ts_iterator_new(iter, &(list->lock), array->items, array->len);
+    status = ts_iterator_newWithRelease(iter, ts_lock_release, &(list->lock),
+                                        array->items, array->len);
     if (status != OK) {
         FREE_ARRAY(array);
         UNLOCK(list);
@@ -208,11 +328,79 @@ Status ts_arraylist_iterator(ConcurrentArrayList *list, ConcurrentIterator **ite
     return status;
 }
 
+Boolean ts_arraylist_forEach(ConcurrentArrayList *list, Boolean (*action)(void *, void *),
+                             void *context) {
+
+    READ_LOCK(list);
+    Boolean complete = arraylist_forEach(list->instance, action, context);
+    UNLOCK(list);
+
+    return complete;
+}
+
+Boolean ts_arraylist_parallelForEach(ConcurrentArrayList *list, int nthreads,
+                                     Boolean (*action)(void *, void *), void *context) {
+
+    READ_LOCK(list);
+    Boolean complete = arraylist_parallelForEach(list->instance, nthreads, action, context);
+    UNLOCK(list);
+
+    return complete;
+}
+
+void *ts_arraylist_parallelReduce(ConcurrentArrayList *list, int nthreads,
+                                  void *(*reducer)(void *, void *, void *),
+                                  void *(*combiner)(void *, void *, void *), void *context) {
+
+    READ_LOCK(list);
+    void *result = arraylist_parallelReduce(list->instance, nthreads, reducer, combiner, context);
+    UNLOCK(list);
+
+    return result;
+}
+
+Status ts_arraylist_snapshot(ConcurrentArrayList *list, ConcurrentIterator **iter) {
+
+    Array *array;
+    Status status;
+
+    // Copies the items under the lock, then releases it right away
+    READ_LOCK(list);
+    status = arraylist_toArray(list->instance, &array);
+    UNLOCK(list);
+    if (status != OK) {
+        return status;
+    }
+
+    // Creates the iterator, which holds no lock while the caller iterates
+    status = ts_iterator_newSnapshot(iter, array->items, array->len);
+    if (status != OK) {
+        FREE_ARRAY(array);
+    } else {
+        free(array);
+    }
+
+    return status;
+}
+
+long ts_arraylist_memoryUsage(ConcurrentArrayList *list) {
+
+    READ_LOCK(list);
+    long bytes = (long)sizeof(ConcurrentArrayList) + arraylist_memoryUsage(list->instance);
+    UNLOCK(list);
+
+    return bytes;
+}
+
+void ts_arraylist_lockStats(ConcurrentArrayList *list, LockStats *stats) {
+    ts_lock_stats(&(list->lock), stats);
+}
+
 void ts_arraylist_destroy(ConcurrentArrayList *list, void (*destructor)(void *)) {
 
     LOCK(list);
     arraylist_destroy(list->instance, destructor);
     UNLOCK(list);
-    pthread_mutex_destroy(&(list->lock));
+    ts_lock_destroy(&(list->lock));
     free(list);
 }
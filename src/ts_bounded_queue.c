@@ -22,32 +22,154 @@
  * SOFTWARE.
  */
 
-#include <pthread.h>
 #include <stdlib.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
 #include "bounded_queue.h"
 #include "ts_bounded_queue.h"
+#include "ts_lock.h"
+
+/**
+ * A condition blocked producers or consumers wait on until the queue changes in their favor.
+ */
+typedef struct {
+    pthread_cond_t cond;        // Signaled when the condition may have become true
+    long waiters;               // Number of threads blocked (or about to block) on the condition
+    unsigned long epoch;        // Bumped on every signal, so a waiter can never miss one
+} Condition;
 
 /**
  * Struct for the thread-safe bounded queue.
  */
 struct ts_bounded_queue {
-    pthread_mutex_t lock;       // The lock
+    TsLock lock;                // The lock
     BoundedQueue *instance;     // Internal instance of BoundedQueue
-};
-
-// Macro used for locking the queue `q`
-#define LOCK(q)    pthread_mutex_lock( &((q)->lock) )
+    pthread_mutex_t waitLock;   // Mutex blocked threads sleep on, never held while taking `lock`
+    Condition notEmpty CACHE_ALIGNED;   // Waited on by consumers blocked on an empty queue
+    Condition notFull CACHE_ALIGNED;    // Waited on by producers blocked on a full queue
+} CACHE_ALIGNED;
+
+// Macro used for locking the queue `q` for writing
+#define LOCK(q)       ts_lock_write( &((q)->lock) )
+// Macro used for locking the queue `q` for reading
+#define READ_LOCK(q)  ts_lock_read( &((q)->lock) )
 // Macro used for unlocking the queue `q`
-#define UNLOCK(q)  pthread_mutex_unlock( &((q)->lock) )
+#define UNLOCK(q)     ts_lock_unlock( &((q)->lock) )
+
+/**
+ * Initializes the condition `c`, timing its waits against the monotonic clock.
+ */
+static void _condition_init(Condition *c) {
+
+    pthread_condattr_t attr;
+
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&(c->cond), &attr);
+    pthread_condattr_destroy(&attr);
+    c->waiters = 0L;
+    c->epoch = 0UL;
+}
+
+/**
+ * Wakes up one (or every, if `all` is TRUE) thread blocked on the condition `c`. This must be
+ * called after the change has been made, and costs a single atomic load when no one is waiting.
+ */
+static void _notify(ConcurrentBoundedQueue *queue, Condition *c, Boolean all) {
+
+    // A waiter registers itself before trying the queue, so if none is seen here, any waiter
+    // arriving later is guaranteed to observe the change once it takes the queue's lock
+    if (__atomic_load_n(&(c->waiters), __ATOMIC_SEQ_CST) == 0L) {
+        return;
+    }
+
+    pthread_mutex_lock(&(queue->waitLock));
+    __atomic_fetch_add(&(c->epoch), 1UL, __ATOMIC_SEQ_CST);
+    if (all == TRUE) {
+        pthread_cond_broadcast(&(c->cond));
+    } else {
+        pthread_cond_signal(&(c->cond));
+    }
+    pthread_mutex_unlock(&(queue->waitLock));
+}
+
+/**
+ * Attempts to add the item at `*item` into the queue without blocking.
+ */
+static Status _try_add(ConcurrentBoundedQueue *queue, void **item) {
+    return ts_boundedqueue_add(queue, *item);
+}
+
+/**
+ * Attempts to remove the first item of the queue into `*first` without blocking.
+ */
+static Status _try_poll(ConcurrentBoundedQueue *queue, void **first) {
+    return ts_boundedqueue_poll(queue, first);
+}
+
+/**
+ * Repeatedly invokes `attempt` on the queue, sleeping on the condition `c` between failures,
+ * until the attempt succeeds or `timeout` milliseconds have passed. If `timeout` is negative, waits
+ * indefinitely. Returns the status of the last attempt.
+ */
+static Status _await(ConcurrentBoundedQueue *queue, Condition *c,
+                     Status (*attempt)(ConcurrentBoundedQueue *, void **), void **arg,
+                     long timeout) {
+
+    struct timespec deadline;
+    unsigned long epoch;
+    Boolean expired = FALSE;
+
+    // Fast path, the queue is ready right away
+    Status status = attempt(queue, arg);
+    if (status == OK || timeout == 0L) {
+        return status;
+    }
+
+    if (timeout > 0L) {
+        clock_gettime(CLOCK_MONOTONIC, &deadline);
+        deadline.tv_sec += timeout / 1000L;
+        deadline.tv_nsec += (timeout % 1000L) * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+    }
+
+    // Registers as a waiter before retrying, so that the notifying thread will see us
+    __atomic_fetch_add(&(c->waiters), 1L, __ATOMIC_SEQ_CST);
+    while (TRUE) {
+        epoch = __atomic_load_n(&(c->epoch), __ATOMIC_SEQ_CST);
+        status = attempt(queue, arg);
+        if (status == OK || expired == TRUE) {
+            break;
+        }
+
+        // Sleeps until notified, the queue's lock is not held here so other threads can proceed
+        pthread_mutex_lock(&(queue->waitLock));
+        while (epoch == __atomic_load_n(&(c->epoch), __ATOMIC_SEQ_CST) && expired == FALSE) {
+            if (timeout < 0L) {
+                pthread_cond_wait(&(c->cond), &(queue->waitLock));
+            } else if (pthread_cond_timedwait(&(c->cond), &(queue->waitLock),
+                                              &deadline) == ETIMEDOUT) {
+                expired = TRUE;
+            }
+        }
+        pthread_mutex_unlock(&(queue->waitLock));
+    }
+    __atomic_fetch_sub(&(c->waiters), 1L, __ATOMIC_SEQ_CST);
+
+    return status;
+}
 
 Status ts_boundedqueue_new(ConcurrentBoundedQueue **queue, long capacity) {
 
     ConcurrentBoundedQueue *temp;
     Status status;
-    pthread_mutexattr_t attr;
 
     // Allocates memory for the queue
-    temp = (ConcurrentBoundedQueue *)malloc(sizeof(ConcurrentBoundedQueue));
+    temp = (ConcurrentBoundedQueue *)ts_lock_alloc(sizeof(ConcurrentBoundedQueue));
     if (temp == NULL) {
         return ALLOC_FAILURE;
     }
@@ -59,11 +181,11 @@ Status ts_boundedqueue_new(ConcurrentBoundedQueue **queue, long capacity) {
         return status;
     }
 
-    // Creates the pthread_mutex for locking
-    pthread_mutexattr_init(&attr);
-    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
-    pthread_mutex_init(&(temp->lock), &attr);
-    pthread_mutexattr_destroy(&attr);
+    // Creates the lock with the calling thread's default lock policy
+    ts_lock_init(&(temp->lock));
+    pthread_mutex_init(&(temp->waitLock), NULL);
+    _condition_init(&(temp->notEmpty));
+    _condition_init(&(temp->notFull));
     *queue = temp;
 
     return OK;
@@ -77,18 +199,37 @@ void ts_boundedqueue_unlock(ConcurrentBoundedQueue *queue) {
     UNLOCK(queue);
 }
 
+void ts_boundedqueue_lockRead(ConcurrentBoundedQueue *queue) {
+    READ_LOCK(queue);
+}
+
+void ts_boundedqueue_lockWrite(ConcurrentBoundedQueue *queue) {
+    LOCK(queue);
+}
+
 Status ts_boundedqueue_add(ConcurrentBoundedQueue *queue, void *item) {
 
     LOCK(queue);
     Status status = boundedqueue_add(queue->instance, item);
     UNLOCK(queue);
+    if (status == OK) {
+        _notify(queue, &(queue->notEmpty), FALSE);
+    }
 
     return status;
 }
 
+Status ts_boundedqueue_put(ConcurrentBoundedQueue *queue, void *item) {
+    return _await(queue, &(queue->notFull), _try_add, &item, -1L);
+}
+
+Status ts_boundedqueue_putTimed(ConcurrentBoundedQueue *queue, void *item, long timeout) {
+    return _await(queue, &(queue->notFull), _try_add, &item, (timeout < 0L) ? 0L : timeout);
+}
+
 Status ts_boundedqueue_peek(ConcurrentBoundedQueue *queue, void **first) {
 
-    LOCK(queue);
+    READ_LOCK(queue);
     Status status = boundedqueue_peek(queue->instance, first);
     UNLOCK(queue);
 
@@ -100,20 +241,51 @@ Status ts_boundedqueue_poll(ConcurrentBoundedQueue *queue, void **first) {
     LOCK(queue);
     Status status = boundedqueue_poll(queue->instance, first);
     UNLOCK(queue);
+    if (status == OK) {
+        _notify(queue, &(queue->notFull), FALSE);
+    }
 
     return status;
 }
 
+Status ts_boundedqueue_take(ConcurrentBoundedQueue *queue, void **first) {
+    return _await(queue, &(queue->notEmpty), _try_poll, first, -1L);
+}
+
+Status ts_boundedqueue_takeTimed(ConcurrentBoundedQueue *queue, void **first, long timeout) {
+    return _await(queue, &(queue->notEmpty), _try_poll, first, (timeout < 0L) ? 0L : timeout);
+}
+
+long ts_boundedqueue_drainTo(ConcurrentBoundedQueue *queue, void **items, long max) {
+
+    long count = 0L;
+
+    // Removes as many items as possible under a single lock acquisition
+    LOCK(queue);
+    while (count < max && boundedqueue_poll(queue->instance, &(items[count])) == OK) {
+        ++count;
+    }
+    UNLOCK(queue);
+
+    // Several slots may have opened up at once, so every blocked producer gets a chance
+    if (count > 0L) {
+        _notify(queue, &(queue->notFull), TRUE);
+    }
+
+    return count;
+}
+
 void ts_boundedqueue_clear(ConcurrentBoundedQueue *queue, void (*destructor)(void *)) {
 
     LOCK(queue);
     boundedqueue_clear(queue->instance, destructor);
     UNLOCK(queue);
+    _notify(queue, &(queue->notFull), TRUE);
 }
 
 long ts_boundedqueue_size(ConcurrentBoundedQueue *queue) {
 
-    LOCK(queue);
+    READ_LOCK(queue);
     long size = boundedqueue_size(queue->instance);
     UNLOCK(queue);
 
@@ -122,7 +294,7 @@ long ts_boundedqueue_size(ConcurrentBoundedQueue *queue) {
 
 long ts_boundedqueue_capacity(ConcurrentBoundedQueue *queue) {
 
-    LOCK(queue);
+    READ_LOCK(queue);
     long capacity = boundedqueue_capacity(queue->instance);
     UNLOCK(queue);
 
@@ -131,7 +303,7 @@ long ts_boundedqueue_capacity(ConcurrentBoundedQueue *queue) {
 
 Boolean ts_boundedqueue_isEmpty(ConcurrentBoundedQueue *queue) {
 
-    LOCK(queue);
+    READ_LOCK(queue);
     Boolean isEmpty = boundedqueue_isEmpty(queue->instance);
     UNLOCK(queue);
 
@@ -140,7 +312,7 @@ Boolean ts_boundedqueue_isEmpty(ConcurrentBoundedQueue *queue) {
 
 Boolean ts_boundedqueue_isFull(ConcurrentBoundedQueue *queue) {
 
-    LOCK(queue);
+    READ_LOCK(queue);
     Boolean isFull = boundedqueue_isFull(queue->instance);
     UNLOCK(queue);
 
@@ -149,7 +321,7 @@ Boolean ts_boundedqueue_isFull(ConcurrentBoundedQueue *queue) {
 
 Status ts_boundedqueue_toArray(ConcurrentBoundedQueue *queue, Array **array) {
 
-    LOCK(queue);
+    READ_LOCK(queue);
     Status status = boundedqueue_toArray(queue->instance, array);
     UNLOCK(queue);
 
@@ -162,7 +334,7 @@ Status ts_boundedqueue_iterator(ConcurrentBoundedQueue *queue, ConcurrentIterato
     Status status;
 
     // Creates the array of items and locks it
-    LOCK(queue);
+    READ_LOCK(queue);
     status = boundedqueue_toArray(queue->instance, &array);
     if (status != OK) {
         UNLOCK(queue);
@@ -170,7 +342,8 @@ Status ts_boundedqueue_iterator(ConcurrentBoundedQueue *queue, ConcurrentIterato
     }
 
     // Creates the iterator
-    status = ts_iterator_new(iter, &(queue->lock), array->items, array->len);
+    status = ts_iterator_newWithRelease(iter, ts_lock_release, &(queue->lock),
+                                        array->items, array->len);
     if (status != OK) {
         FREE_ARRAY(array);
         UNLOCK(queue);
@@ -181,11 +354,61 @@ Status ts_boundedqueue_iterator(ConcurrentBoundedQueue *queue, ConcurrentIterato
     return status;
 }
 
+Boolean ts_boundedqueue_forEach(ConcurrentBoundedQueue *queue, Boolean (*action)(void *, void *),
+                                void *context) {
+
+    READ_LOCK(queue);
+    Boolean complete = boundedqueue_forEach(queue->instance, action, context);
+    UNLOCK(queue);
+
+    return complete;
+}
+
+Status ts_boundedqueue_snapshot(ConcurrentBoundedQueue *queue, ConcurrentIterator **iter) {
+
+    Array *array;
+    Status status;
+
+    // Copies the items under the lock, then releases it right away
+    READ_LOCK(queue);
+    status = boundedqueue_toArray(queue->instance, &array);
+    UNLOCK(queue);
+    if (status != OK) {
+        return status;
+    }
+
+    // Creates the iterator, which holds no lock while the caller iterates
+    status = ts_iterator_newSnapshot(iter, array->items, array->len);
+    if (status != OK) {
+        FREE_ARRAY(array);
+    } else {
+        free(array);
+    }
+
+    return status;
+}
+
+long ts_boundedqueue_memoryUsage(ConcurrentBoundedQueue *queue) {
+
+    READ_LOCK(queue);
+    long bytes = (long)sizeof(ConcurrentBoundedQueue) + boundedqueue_memoryUsage(queue->instance);
+    UNLOCK(queue);
+
+    return bytes;
+}
+
+void ts_boundedqueue_lockStats(ConcurrentBoundedQueue *queue, LockStats *stats) {
+    ts_lock_stats(&(queue->lock), stats);
+}
+
 void ts_boundedqueue_destroy(ConcurrentBoundedQueue *queue, void (*destructor)(void *)) {
 
     LOCK(queue);
     boundedqueue_destroy(queue->instance, destructor);
     UNLOCK(queue);
-    pthread_mutex_destroy(&(queue->lock));
+    ts_lock_destroy(&(queue->lock));
+    pthread_cond_destroy(&(queue->notEmpty.cond));
+    pthread_cond_destroy(&(queue->notFull.cond));
+    pthread_mutex_destroy(&(queue->waitLock));
     free(queue);
 }
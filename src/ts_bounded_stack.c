@@ -22,32 +22,33 @@
  * SOFTWARE.
  */
 
-#include <pthread.h>
 #include <stdlib.h>
 #include "bounded_stack.h"
 #include "ts_bounded_stack.h"
+#include "ts_lock.h"
 
 /**
  * Struct for the thread-safe bounded stack.
  */
 struct ts_bounded_stack {
-    pthread_mutex_t lock;       // The lock
+    TsLock lock;                // The lock
     BoundedStack *instance;     // Internal instance of BoundedStack
-};
+} CACHE_ALIGNED;
 
-// Macro used for locking the stack `s`
-#define LOCK(s)    pthread_mutex_lock( &((s)->lock) )
+// Macro used for locking the stack `s` for writing
+#define LOCK(s)       ts_lock_write( &((s)->lock) )
+// Macro used for locking the stack `s` for reading
+#define READ_LOCK(s)  ts_lock_read( &((s)->lock) )
 // Macro used for unlocking the stack `s`
-#define UNLOCK(s)  pthread_mutex_unlock( &((s)->lock) )
+#define UNLOCK(s)     ts_lock_unlock( &((s)->lock) )
 
 Status ts_boundedstack_new(ConcurrentBoundedStack **stack, long capacity) {
 
     ConcurrentBoundedStack *temp;
     Status status;
-    pthread_mutexattr_t attr;
 
     // Allocates memory for the new stack
-    temp = (ConcurrentBoundedStack *)malloc(sizeof(ConcurrentBoundedStack));
+    temp = (ConcurrentBoundedStack *)ts_lock_alloc(sizeof(ConcurrentBoundedStack));
     if (temp == NULL) {
         return ALLOC_FAILURE;
     }
@@ -59,11 +60,8 @@ Status ts_boundedstack_new(ConcurrentBoundedStack **stack, long capacity) {
         return status;
     }
 
-    // Creates the pthread_mutex for locking
-    pthread_mutexattr_init(&attr);
-    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
-    pthread_mutex_init(&(temp->lock), &attr);
-    pthread_mutexattr_destroy(&attr);
+    // Creates the lock with the calling thread's default lock policy
+    ts_lock_init(&(temp->lock));
     *stack = temp;
 
     return OK;
@@ -77,6 +75,14 @@ void ts_boundedstack_unlock(ConcurrentBoundedStack *stack) {
     UNLOCK(stack);
 }
 
+void ts_boundedstack_lockRead(ConcurrentBoundedStack *stack) {
+    READ_LOCK(stack);
+}
+
+void ts_boundedstack_lockWrite(ConcurrentBoundedStack *stack) {
+    LOCK(stack);
+}
+
 Status ts_boundedstack_push(ConcurrentBoundedStack *stack, void *item) {
 
     LOCK(stack);
@@ -88,7 +94,7 @@ Status ts_boundedstack_push(ConcurrentBoundedStack *stack, void *item) {
 
 Status ts_boundedstack_peek(ConcurrentBoundedStack *stack, void **top) {
 
-    LOCK(stack);
+    READ_LOCK(stack);
     Status status = boundedstack_peek(stack->instance, top);
     UNLOCK(stack);
 
@@ -113,7 +119,7 @@ void ts_boundedstack_clear(ConcurrentBoundedStack *stack, void (*destructor)(voi
 
 long ts_boundedstack_size(ConcurrentBoundedStack *stack) {
 
-    LOCK(stack);
+    READ_LOCK(stack);
     long size = boundedstack_size(stack->instance);
     UNLOCK(stack);
 
@@ -122,7 +128,7 @@ long ts_boundedstack_size(ConcurrentBoundedStack *stack) {
 
 long ts_boundedstack_capacity(ConcurrentBoundedStack *stack) {
 
-    LOCK(stack);
+    READ_LOCK(stack);
     long capacity = boundedstack_capacity(stack->instance);
     UNLOCK(stack);
 
@@ -131,7 +137,7 @@ long ts_boundedstack_capacity(ConcurrentBoundedStack *stack) {
 
 Boolean ts_boundedstack_isEmpty(ConcurrentBoundedStack *stack) {
 
-    LOCK(stack);
+    READ_LOCK(stack);
     Boolean isEmpty = boundedstack_isEmpty(stack->instance);
     UNLOCK(stack);
 
@@ -140,7 +146,7 @@ Boolean ts_boundedstack_isEmpty(ConcurrentBoundedStack *stack) {
 
 Boolean ts_boundedstack_isFull(ConcurrentBoundedStack *stack) {
 
-    LOCK(stack);
+    READ_LOCK(stack);
     Boolean isFull = boundedstack_isFull(stack->instance);
     UNLOCK(stack);
 
@@ -149,7 +155,7 @@ Boolean ts_boundedstack_isFull(ConcurrentBoundedStack *stack) {
 
 Status ts_boundedstack_toArray(ConcurrentBoundedStack *stack, Array **array) {
 
-    LOCK(stack);
+    READ_LOCK(stack);
     Status status = boundedstack_toArray(stack->instance, array);
     UNLOCK(stack);
 
@@ -162,7 +168,7 @@ Status ts_boundedstack_iterator(ConcurrentBoundedStack *stack, ConcurrentIterato
     Status status;
 
     // Creates the array of items and locks it
-    LOCK(stack);
+    READ_LOCK(stack);
     status = boundedstack_toArray(stack->instance, &array);
     if (status != OK) {
         UNLOCK(stack);
@@ -170,7 +176,8 @@ Status ts_boundedstack_iterator(ConcurrentBoundedStack *stack, ConcurrentIterato
     }
 
     // Creates the iterator
-    status = ts_iterator_new(iter, &(stack->lock), array->items, array->len);
+    status = ts_iterator_newWithRelease(iter, ts_lock_release, &(stack->lock),
+                                        array->items, array->len);
     if (status != OK) {
         FREE_ARRAY(array);
         UNLOCK(stack);
@@ -181,11 +188,58 @@ Status ts_boundedstack_iterator(ConcurrentBoundedStack *stack, ConcurrentIterato
     return status;
 }
 
+Boolean ts_boundedstack_forEach(ConcurrentBoundedStack *stack, Boolean (*action)(void *, void *),
+                                void *context) {
+
+    READ_LOCK(stack);
+    Boolean complete = boundedstack_forEach(stack->instance, action, context);
+    UNLOCK(stack);
+
+    return complete;
+}
+
+Status ts_boundedstack_snapshot(ConcurrentBoundedStack *stack, ConcurrentIterator **iter) {
+
+    Array *array;
+    Status status;
+
+    // Copies the items under the lock, then releases it right away
+    READ_LOCK(stack);
+    status = boundedstack_toArray(stack->instance, &array);
+    UNLOCK(stack);
+    if (status != OK) {
+        return status;
+    }
+
+    // Creates the iterator, which holds no lock while the caller iterates
+    status = ts_iterator_newSnapshot(iter, array->items, array->len);
+    if (status != OK) {
+        FREE_ARRAY(array);
+    } else {
+        free(array);
+    }
+
+    return status;
+}
+
+long ts_boundedstack_memoryUsage(ConcurrentBoundedStack *stack) {
+
+    READ_LOCK(stack);
+    long bytes = (long)sizeof(ConcurrentBoundedStack) + boundedstack_memoryUsage(stack->instance);
+    UNLOCK(stack);
+
+    return bytes;
+}
+
+void ts_boundedstack_lockStats(ConcurrentBoundedStack *stack, LockStats *stats) {
+    ts_lock_stats(&(stack->lock), stats);
+}
+
 void ts_boundedstack_destroy(ConcurrentBoundedStack *stack, void (*destructor)(void *)) {
 
     LOCK(stack);
     boundedstack_destroy(stack->instance, destructor);
     UNLOCK(stack);
-    pthread_mutex_destroy(&(stack->lock));
+    ts_lock_destroy(&(stack->lock));
     free(stack);
 }
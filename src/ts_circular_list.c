@@ -22,53 +22,55 @@
  * SOFTWARE.
  */
 
-#include <pthread.h>
 #include <stdlib.h>
 #include "circular_list.h"
 #include "ts_circular_list.h"
+#include "ts_lock.h"
 
 /**
  * Struct for thread-safe circular list.
  */
 struct ts_circular_list {
-    pthread_mutex_t lock;       // The lock
+    TsLock lock;                // The lock
     CircularList *instance;     // Internal instance of CircularList
-};
+} CACHE_ALIGNED;
 
-// Macro used for locking the list `li`
-#define LOCK(li)    pthread_mutex_lock( &((li)->lock) )
+// Macro used for locking the list `li` for writing
+#define LOCK(li)       ts_lock_write( &((li)->lock) )
+// Macro used for locking the list `li` for reading
+#define READ_LOCK(li)  ts_lock_read( &((li)->lock) )
 // Macro used for unlocking the list `li`
-#define UNLOCK(li)  pthread_mutex_unlock( &((li)->lock) )
+#define UNLOCK(li)     ts_lock_unlock( &((li)->lock) )
 
-Status ts_circularlist_new(ConcurrentCircularList **list) {
+Status ts_circularlist_newWithPool(ConcurrentCircularList **list, NodePool *pool) {
 
     ConcurrentCircularList *temp;
     Status status;
-    pthread_mutexattr_t attr;
 
     // Allocates memory for the new list
-    temp = (ConcurrentCircularList *)malloc(sizeof(ConcurrentCircularList));
+    temp = (ConcurrentCircularList *)ts_lock_alloc(sizeof(ConcurrentCircularList));
     if (temp == NULL) {
         return ALLOC_FAILURE;
     }
 
     // Creates the internal list instance
-    status = circularlist_new(&(temp->instance));
+    status = circularlist_newWithPool(&(temp->instance), pool);
     if (status != OK) {
         free(temp);
         return status;
     }
 
-    // Creates the pthread_mutex for locking
-    pthread_mutexattr_init(&attr);
-    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
-    pthread_mutex_init(&(temp->lock), &attr);
-    pthread_mutexattr_destroy(&attr);
+    // Creates the lock with the calling thread's default lock policy
+    ts_lock_init(&(temp->lock));
     *list = temp;
 
     return OK;
 }
 
+Status ts_circularlist_new(ConcurrentCircularList **list) {
+    return ts_circularlist_newWithPool(list, NULL);
+}
+
 void ts_circularlist_lock(ConcurrentCircularList *list) {
     LOCK(list);
 }
@@ -77,6 +79,14 @@ void ts_circularlist_unlock(ConcurrentCircularList *list) {
     UNLOCK(list);
 }
 
+void ts_circularlist_lockRead(ConcurrentCircularList *list) {
+    READ_LOCK(list);
+}
+
+void ts_circularlist_lockWrite(ConcurrentCircularList *list) {
+    LOCK(list);
+}
+
 Status ts_circularlist_addFirst(ConcurrentCircularList *list, void *item) {
 
     LOCK(list);
@@ -106,7 +116,7 @@ Status ts_circularlist_insert(ConcurrentCircularList *list, long i, void *item)
 
 Status ts_circularlist_first(ConcurrentCircularList *list, void **first) {
 
-    LOCK(list);
+    READ_LOCK(list);
     Status status = circularlist_first(list->instance, first);
     UNLOCK(list);
 
@@ -115,7 +125,7 @@ Status ts_circularlist_first(ConcurrentCircularList *list, void **first) {
 
 Status ts_circularlist_last(ConcurrentCircularList *list, void **last) {
 
-    LOCK(list);
+    READ_LOCK(list);
     Status status = circularlist_last(list->instance, last);
     UNLOCK(list);
 
@@ -124,7 +134,7 @@ Status ts_circularlist_last(ConcurrentCircularList *list, void **last) {
 
 Status ts_circularlist_get(ConcurrentCircularList *list, long i, void **item) {
 
-    LOCK(list);
+    READ_LOCK(list);
     Status status = circularlist_get(list->instance, i, item);
     UNLOCK(list);
 
@@ -187,7 +197,7 @@ void ts_circularlist_clear(ConcurrentCircularList *list, void (*destructor)(void
 
 long ts_circularlist_size(ConcurrentCircularList *list) {
 
-    LOCK(list);
+    READ_LOCK(list);
     long size = circularlist_size(list->instance);
     UNLOCK(list);
 
@@ -196,7 +206,7 @@ long ts_circularlist_size(ConcurrentCircularList *list) {
 
 Boolean ts_circularlist_isEmpty(ConcurrentCircularList *list) {
 
-    LOCK(list);
+    READ_LOCK(list);
     Boolean isEmpty = circularlist_isEmpty(list->instance);
     UNLOCK(list);
 
@@ -205,7 +215,7 @@ Boolean ts_circularlist_isEmpty(ConcurrentCircularList *list) {
 
 Status ts_circularlist_toArray(ConcurrentCircularList *list, Array **array) {
 
-    LOCK(list);
+    READ_LOCK(list);
     Status status = circularlist_toArray(list->instance, array);
     UNLOCK(list);
 
@@ -218,7 +228,7 @@ Status ts_circularlist_iterator(ConcurrentCircularList *list, ConcurrentIterator
     Status status;
 
     // Creates the array of items and locks it
-    LOCK(list);
+    READ_LOCK(list);
     status = circularlist_toArray(list->instance, &array);
     if (status != OK) {
         UNLOCK(list);
@@ -226,7 +236,8 @@ Status ts_circularlist_iterator(ConcurrentCircularList *list, ConcurrentIterator
     }
 
     // Creates the iterator
-    status = ts_iterator_new(iter, &(list->lock), array->items, array->len);
+    status = ts_iterator_newWithRelease(iter, ts_lock_release, &(list->lock),
+                                        array->items, array->len);
     if (status != OK) {
         FREE_ARRAY(array);
         UNLOCK(list);
@@ -237,11 +248,58 @@ Status ts_circularlist_iterator(ConcurrentCircularList *list, ConcurrentIterator
     return status;
 }
 
+Boolean ts_circularlist_forEach(ConcurrentCircularList *list, Boolean (*action)(void *, void *),
+                                void *context) {
+
+    READ_LOCK(list);
+    Boolean complete = circularlist_forEach(list->instance, action, context);
+    UNLOCK(list);
+
+    return complete;
+}
+
+Status ts_circularlist_snapshot(ConcurrentCircularList *list, ConcurrentIterator **iter) {
+
+    Array *array;
+    Status status;
+
+    // Copies the items under the lock, then releases it right away
+    READ_LOCK(list);
+    status = circularlist_toArray(list->instance, &array);
+    UNLOCK(list);
+    if (status != OK) {
+        return status;
+    }
+
+    // Creates the iterator, which holds no lock while the caller iterates
+    status = ts_iterator_newSnapshot(iter, array->items, array->len);
+    if (status != OK) {
+        FREE_ARRAY(array);
+    } else {
+        free(array);
+    }
+
+    return status;
+}
+
+long ts_circularlist_memoryUsage(ConcurrentCircularList *list) {
+
+    READ_LOCK(list);
+    long bytes = (long)sizeof(ConcurrentCircularList) + circularlist_memoryUsage(list->instance);
+    UNLOCK(list);
+
+    return bytes;
+}
+
+void ts_circularlist_lockStats(ConcurrentCircularList *list, LockStats *stats) {
+    ts_lock_stats(&(list->lock), stats);
+}
+
 void ts_circularlist_destroy(ConcurrentCircularList *list, void (*destructor)(void *)) {
 
     LOCK(list);
     circularlist_destroy(list->instance, destructor);
     UNLOCK(list);
-    pthread_mutex_destroy(&(list->lock));
+    ts_lock_destroy(&(list->lock));
     free(list);
 }
@@ -24,159 +24,660 @@
 
 #include <pthread.h>
 #include <stdlib.h>
+#include <string.h>
 #include "hash_map.h"
 #include "ts_hash_map.h"
+#include "ts_lock.h"
+
+/**
+ * A single stripe of the thread-safe hashmap: a hashmap holding a fraction of the keys, and the
+ * lock guarding it. Each stripe has its cache line(s) to itself, so that threads locking
+ * neighbouring stripes don't contend on the line.
+ */
+typedef struct stripe {
+    TsLock lock;                // The lock
+    HashMap *instance;          // Internal instance of HashMap holding this stripe's keys
+} CACHE_ALIGNED Stripe;
 
 /**
  * Struct for the thread-safe hashmap.
+ *
+ * The keys are split across a fixed number of stripes, each stripe being an independent hashmap
+ * with its own lock. Operations on a single key only lock the stripe the key hashes to, so threads
+ * working on different stripes never contend; each stripe also resizes on its own while holding
+ * only its lock. Operations over the whole hashmap lock every stripe in ascending order.
  */
 struct ts_hashmap {
-    pthread_mutex_t lock;       // The lock
-    HashMap *instance;          // Internal instance of HashMap
-};
+    long (*hash)(void *, long);     // Hashing function for keys, if created with ts_hashmap_new()
+    uint64_t (*hashCode)(void *);   // Full-width hashing function for keys, otherwise
+    uint64_t (*seededHash)(void *, uint64_t);   // Seeded hashing function, if created seeded
+    uint64_t seed;                  // The seed used for choosing a key's stripe
+    Stripe *stripes;                // The array of stripes
+} CACHE_ALIGNED;
+
+// Number of stripes the keys are split across, must be a power of 2
+#define STRIPES 64L
+// Number of bits needed to index into the stripes
+#define STRIPE_BITS 6
+// Modulus passed to ts_hashmap_new() hash functions when choosing a key's stripe (a large prime)
+#define STRIPE_MODULUS 2147483629L
+
+// Parallel walks give each thread at least this many entries, smaller maps are walked in place
+#define MIN_PARALLEL_RUN 16384L
+
+// Macro used for locking the stripe `s` for writing
+#define LOCK(s)       ts_lock_write( &((s)->lock) )
+// Macro used for locking the stripe `s` for reading
+#define READ_LOCK(s)  ts_lock_read( &((s)->lock) )
+// Macro used for unlocking the stripe `s`
+#define UNLOCK(s)     ts_lock_unlock( &((s)->lock) )
 
-// Macro used for locking the map `hm`
-#define LOCK(hm)    pthread_mutex_lock( &((hm)->lock) )
-// Macro used for unlocking the map `hm`
-#define UNLOCK(hm)  pthread_mutex_unlock( &((hm)->lock) )
+/**
+ * Returns the stripe in `map` holding the key `key`. Uses different bits of the key's hash than
+ * the stripe's own hashmap does, so the keys in a stripe still spread over all of its buckets.
+ */
+static Stripe *_stripe_for(ConcurrentHashMap *map, void *key) {
 
-Status ts_hashmap_new(ConcurrentHashMap **map, long (*hash)(void *, long),
-                      int (*keyComparator)(void *, void *), long capacity, double loadFactor,
-                      void (*keyDestructor)(void *)) {
+    uint64_t code;
+
+    if (map->seededHash != NULL) {
+        code = map->seededHash(key, map->seed);
+    } else if (map->hashCode != NULL) {
+        code = map->hashCode(key);
+    } else {
+        code = (uint64_t)map->hash(key, STRIPE_MODULUS);
+    }
+    code *= 0x9e3779b97f4a7c15UL;
+
+    return &(map->stripes[code >> (64 - STRIPE_BITS)]);
+}
+
+/**
+ * Locks every stripe in `map` in ascending order, for writing if `write` is TRUE, or for reading.
+ */
+static void _lock_all(ConcurrentHashMap *map, Boolean write) {
+
+    long i;
+    for (i = 0L; i < STRIPES; i++) {
+        if (write == TRUE) {
+            LOCK(&(map->stripes[i]));
+        } else {
+            READ_LOCK(&(map->stripes[i]));
+        }
+    }
+}
+
+/**
+ * Unlocks every stripe in `map` in descending order.
+ */
+static void _unlock_all(ConcurrentHashMap *map) {
+
+    long i;
+    for (i = STRIPES - 1L; i >= 0L; i--) {
+        UNLOCK(&(map->stripes[i]));
+    }
+}
+
+/**
+ * Destroys the stripes of `map` that have been created so far, then frees `map` itself.
+ */
+static void _free_map(ConcurrentHashMap *map, void (*valueDestructor)(void *)) {
+
+    long i;
+    for (i = 0L; i < STRIPES; i++) {
+        if (map->stripes[i].instance != NULL) {
+            hashmap_destroy(map->stripes[i].instance, valueDestructor);
+            ts_lock_destroy(&(map->stripes[i].lock));
+        }
+    }
+    free(map->stripes);
+    free(map);
+}
+
+/**
+ * Helper method to allocate the thread-safe hashmap, then store the new instance into `*map`. The
+ * hashmap of each stripe is created using the constructor matching `hash`, `hashCode` and
+ * `seededHash`, flat if `flat` is TRUE. The starting capacity is divided among the stripes.
+ */
+static Status _new_map(ConcurrentHashMap **map, long (*hash)(void *, long),
+                       uint64_t (*hashCode)(void *), uint64_t (*seededHash)(void *, uint64_t),
+                       int (*keyComparator)(void *, void *), long capacity, double loadFactor,
+                       void (*keyDestructor)(void *), Boolean flat) {
 
     ConcurrentHashMap *temp;
-    Status status;
-    pthread_mutexattr_t attr;
+    Status status = OK;
+    long i, cap;
 
     // Allocates memory for the new hashmap
-    temp = (ConcurrentHashMap *)malloc(sizeof(ConcurrentHashMap));
+    temp = (ConcurrentHashMap *)ts_lock_alloc(sizeof(ConcurrentHashMap));
     if (temp == NULL) {
         return ALLOC_FAILURE;
     }
+    temp->stripes = (Stripe *)ts_lock_alloc(STRIPES * sizeof(Stripe));
+    if (temp->stripes == NULL) {
+        free(temp);
+        return ALLOC_FAILURE;
+    }
+    temp->hash = hash;
+    temp->hashCode = hashCode;
+    temp->seededHash = seededHash;
+    temp->seed = ( seededHash != NULL ) ? hashing_seed() : 0UL;
+    for (i = 0L; i < STRIPES; i++) {
+        temp->stripes[i].instance = NULL;
+    }
+
+    // Each stripe receives its share of the starting capacity, or the default one
+    cap = ( capacity <= 0L ) ? capacity : ( (capacity + STRIPES - 1L) / STRIPES );
+
+    // Creates the hashmap and lock of each stripe
+    for (i = 0L; i < STRIPES && status == OK; i++) {
+        if (seededHash != NULL && flat == TRUE) {
+            status = hashmap_newFlatSeeded(&(temp->stripes[i].instance), seededHash,
+                                           keyComparator, cap, loadFactor, keyDestructor);
+        } else if (seededHash != NULL) {
+            status = hashmap_newSeeded(&(temp->stripes[i].instance), seededHash, keyComparator,
+                                       cap, loadFactor, keyDestructor);
+        } else if (flat == TRUE) {
+            status = hashmap_newFlat(&(temp->stripes[i].instance), hashCode, keyComparator, cap,
+                                     loadFactor, keyDestructor);
+        } else if (hashCode != NULL) {
+            status = hashmap_newFullHash(&(temp->stripes[i].instance), hashCode, keyComparator,
+                                         cap, loadFactor, keyDestructor);
+        } else {
+            status = hashmap_new(&(temp->stripes[i].instance), hash, keyComparator, cap,
+                                 loadFactor, keyDestructor);
+        }
+        if (status == OK) {
+            ts_lock_init(&(temp->stripes[i].lock));
+        } else {
+            temp->stripes[i].instance = NULL;
+        }
+    }
 
-    // Creates the internal hashmap
-    status = hashmap_new(&(temp->instance), hash, keyComparator, capacity, loadFactor,
-                         keyDestructor);
+    // Cleans up the stripes created so far if any failed
     if (status != OK) {
-        free(temp);
+        _free_map(temp, NULL);
         return status;
     }
-
-    // Creates pthread_mutex for locking
-    pthread_mutexattr_init(&attr);
-    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
-    pthread_mutex_init(&(temp->lock), &attr);
-    pthread_mutexattr_destroy(&attr);
     *map = temp;
 
     return OK;
 }
 
+Status ts_hashmap_new(ConcurrentHashMap **map, long (*hash)(void *, long),
+                      int (*keyComparator)(void *, void *), long capacity, double loadFactor,
+                      void (*keyDestructor)(void *)) {
+    return _new_map(map, hash, NULL, NULL, keyComparator, capacity, loadFactor, keyDestructor,
+                    FALSE);
+}
+
+Status ts_hashmap_newFullHash(ConcurrentHashMap **map, uint64_t (*hash)(void *),
+                              int (*keyComparator)(void *, void *), long capacity,
+                              double loadFactor, void (*keyDestructor)(void *)) {
+    return _new_map(map, NULL, hash, NULL, keyComparator, capacity, loadFactor, keyDestructor,
+                    FALSE);
+}
+
+Status ts_hashmap_newFlat(ConcurrentHashMap **map, uint64_t (*hash)(void *),
+                          int (*keyComparator)(void *, void *), long capacity, double loadFactor,
+                          void (*keyDestructor)(void *)) {
+    return _new_map(map, NULL, hash, NULL, keyComparator, capacity, loadFactor, keyDestructor,
+                    TRUE);
+}
+
+Status ts_hashmap_newSeeded(ConcurrentHashMap **map, uint64_t (*hash)(void *, uint64_t),
+                            int (*keyComparator)(void *, void *), long capacity,
+                            double loadFactor, void (*keyDestructor)(void *)) {
+    return _new_map(map, NULL, NULL, hash, keyComparator, capacity, loadFactor, keyDestructor,
+                    FALSE);
+}
+
+Status ts_hashmap_newFlatSeeded(ConcurrentHashMap **map, uint64_t (*hash)(void *, uint64_t),
+                                int (*keyComparator)(void *, void *), long capacity,
+                                double loadFactor, void (*keyDestructor)(void *)) {
+    return _new_map(map, NULL, NULL, hash, keyComparator, capacity, loadFactor, keyDestructor,
+                    TRUE);
+}
+
 void ts_hashmap_lock(ConcurrentHashMap *map) {
-    LOCK(map);
+    _lock_all(map, TRUE);
 }
 
 void ts_hashmap_unlock(ConcurrentHashMap *map) {
-    UNLOCK(map);
+    _unlock_all(map);
+}
+
+void ts_hashmap_lockRead(ConcurrentHashMap *map) {
+    _lock_all(map, FALSE);
+}
+
+void ts_hashmap_lockWrite(ConcurrentHashMap *map) {
+    _lock_all(map, TRUE);
+}
+
+void ts_hashmap_setIncrementalResize(ConcurrentHashMap *map, Boolean incremental) {
+
+    long i;
+    for (i = 0L; i < STRIPES; i++) {
+        LOCK(&(map->stripes[i]));
+        hashmap_setIncrementalResize(map->stripes[i].instance, incremental);
+        UNLOCK(&(map->stripes[i]));
+    }
+}
+
+Status ts_hashmap_reserve(ConcurrentHashMap *map, long n) {
+
+    // Each stripe reserves room for its even share of the entries
+    long i, share = ( n + STRIPES - 1L ) / STRIPES;
+    Status status = OK;
+
+    for (i = 0L; i < STRIPES && status == OK; i++) {
+        LOCK(&(map->stripes[i]));
+        status = hashmap_reserve(map->stripes[i].instance, share);
+        UNLOCK(&(map->stripes[i]));
+    }
+
+    return status;
+}
+
+Status ts_hashmap_shrinkToFit(ConcurrentHashMap *map) {
+
+    long i;
+    Status status = OK;
+
+    for (i = 0L; i < STRIPES && status == OK; i++) {
+        LOCK(&(map->stripes[i]));
+        status = hashmap_shrinkToFit(map->stripes[i].instance);
+        UNLOCK(&(map->stripes[i]));
+    }
+
+    return status;
 }
 
 Status ts_hashmap_put(ConcurrentHashMap *map, void *key, void *value, void **previous) {
 
-    LOCK(map);
-    Status status = hashmap_put(map->instance, key, value, previous);
-    UNLOCK(map);
+    Stripe *stripe = _stripe_for(map, key);
+    LOCK(stripe);
+    Status status = hashmap_put(stripe->instance, key, value, previous);
+    UNLOCK(stripe);
 
     return status;
 }
 
 Boolean ts_hashmap_containsKey(ConcurrentHashMap *map, void *key) {
 
-    LOCK(map);
-    Boolean containsKey = hashmap_containsKey(map->instance, key);
-    UNLOCK(map);
+    Stripe *stripe = _stripe_for(map, key);
+    READ_LOCK(stripe);
+    Boolean containsKey = hashmap_containsKey(stripe->instance, key);
+    UNLOCK(stripe);
 
     return containsKey;
 }
 
 Status ts_hashmap_get(ConcurrentHashMap *map, void *key, void **value) {
 
-    LOCK(map);
-    Status status = hashmap_get(map->instance, key, value);
-    UNLOCK(map);
+    Stripe *stripe = _stripe_for(map, key);
+    READ_LOCK(stripe);
+    Status status = hashmap_get(stripe->instance, key, value);
+    UNLOCK(stripe);
 
     return status;
 }
 
 Status ts_hashmap_remove(ConcurrentHashMap *map, void *key, void **value) {
 
-    LOCK(map);
-    Status status = hashmap_remove(map->instance, key, value);
-    UNLOCK(map);
+    Stripe *stripe = _stripe_for(map, key);
+    LOCK(stripe);
+    Status status = hashmap_remove(stripe->instance, key, value);
+    UNLOCK(stripe);
+
+    return status;
+}
+
+/**
+ * Struct holding a batch of keys grouped by the stripe each key hashes to, so that a batch
+ * operation only locks each stripe once.
+ */
+typedef struct batch {
+    long starts[STRIPES + 1L];  // Where each stripe's keys start in the gathered arrays
+    long *order;                // Index of each gathered key in the caller's arrays
+    void **keys;                // The keys, gathered stripe by stripe
+    void **values;              // The values gathered along with the keys
+    void **out;                 // The per-key results, in the same order (initially NULL)
+} Batch;
+
+/**
+ * Groups the `n` keys in `keys` (and the values in `values`, if not NULL) by stripe into `batch`,
+ * keeping the keys of each stripe in their original order. Returns TRUE if successful, FALSE if
+ * not (allocation error).
+ */
+static Boolean _new_batch(ConcurrentHashMap *map, void **keys, void **values, long n,
+                          Batch *batch) {
+
+    long i, *stripeOf;
+
+    // Allocates the gathered arrays and each key's stripe as one block
+    stripeOf = (long *)malloc(n * ( 2L * sizeof(long) + 3L * sizeof(void *) ));
+    if (stripeOf == NULL) {
+        return FALSE;
+    }
+    batch->order = ( stripeOf + n );
+    batch->keys = (void **)( batch->order + n );
+    batch->values = ( batch->keys + n );
+    batch->out = ( batch->values + n );
+
+    // Counts the keys in each stripe, then turns the counts into starting offsets
+    for (i = 0L; i <= STRIPES; i++) {
+        batch->starts[i] = 0L;
+    }
+    for (i = 0L; i < n; i++) {
+        stripeOf[i] = ( _stripe_for(map, keys[i]) - map->stripes );
+        batch->starts[stripeOf[i] + 1L]++;
+    }
+    for (i = 1L; i <= STRIPES; i++) {
+        batch->starts[i] += batch->starts[i - 1L];
+    }
+
+    // Gathers the keys stripe by stripe, using the next offsets as cursors
+    for (i = 0L; i < n; i++) {
+        long j = batch->starts[stripeOf[i]]++;
+        batch->order[j] = i;
+        batch->keys[j] = keys[i];
+        batch->values[j] = ( values != NULL ) ? values[i] : NULL;
+        batch->out[j] = NULL;
+    }
+    for (i = STRIPES; i > 0L; i--) {
+        batch->starts[i] = batch->starts[i - 1L];
+    }
+    batch->starts[0] = 0L;
+
+    return TRUE;
+}
+
+/**
+ * Scatters the per-key results gathered in `batch` back into `out` in the caller's order (if `out`
+ * is not NULL), then frees the batch.
+ */
+static void _finish_batch(Batch *batch, long n, void **out) {
+
+    long i;
+    if (out != NULL) {
+        for (i = 0L; i < n; i++) {
+            out[batch->order[i]] = batch->out[i];
+        }
+    }
+    free(batch->order - n);
+}
+
+Status ts_hashmap_putAll(ConcurrentHashMap *map, void **keys, void **values, long n,
+                         void **previous) {
+
+    Batch batch;
+    Status status = OK;
+    long i, j, len;
+
+    if (n <= 0L) {
+        return OK;
+    }
+    if (_new_batch(map, keys, values, n, &batch) == FALSE) {
+        return ALLOC_FAILURE;
+    }
+
+    // Inserts each stripe's share of the batch while holding its lock only once
+    for (i = 0L; i < STRIPES && status == OK; i++) {
+        len = ( batch.starts[i + 1L] - batch.starts[i] );
+        if (len > 0L) {
+            j = batch.starts[i];
+            LOCK(&(map->stripes[i]));
+            status = hashmap_putAll(map->stripes[i].instance, &(batch.keys[j]),
+                                    &(batch.values[j]), len, &(batch.out[j]));
+            UNLOCK(&(map->stripes[i]));
+        }
+    }
+    _finish_batch(&batch, n, previous);
 
     return status;
 }
 
+long ts_hashmap_getAll(ConcurrentHashMap *map, void **keys, void **values, long n) {
+
+    Batch batch;
+    long i, j, len, found = 0L;
+
+    if (n <= 0L) {
+        return 0L;
+    }
+    // Falls back to looking up each key under its own lock if the batch cannot be allocated
+    if (_new_batch(map, keys, NULL, n, &batch) == FALSE) {
+        for (i = 0L; i < n; i++) {
+            if (ts_hashmap_get(map, keys[i], &(values[i])) == OK) {
+                found++;
+            } else {
+                values[i] = NULL;
+            }
+        }
+        return found;
+    }
+
+    for (i = 0L; i < STRIPES; i++) {
+        len = ( batch.starts[i + 1L] - batch.starts[i] );
+        if (len > 0L) {
+            j = batch.starts[i];
+            READ_LOCK(&(map->stripes[i]));
+            found += hashmap_getAll(map->stripes[i].instance, &(batch.keys[j]),
+                                    &(batch.out[j]), len);
+            UNLOCK(&(map->stripes[i]));
+        }
+    }
+    _finish_batch(&batch, n, values);
+
+    return found;
+}
+
+long ts_hashmap_removeAll(ConcurrentHashMap *map, void **keys, void **values, long n) {
+
+    Batch batch;
+    void *value;
+    long i, j, len, removed = 0L;
+
+    if (n <= 0L) {
+        return 0L;
+    }
+    // Falls back to removing each key under its own lock if the batch cannot be allocated
+    if (_new_batch(map, keys, NULL, n, &batch) == FALSE) {
+        for (i = 0L; i < n; i++) {
+            value = NULL;
+            if (ts_hashmap_remove(map, keys[i], &value) == OK) {
+                removed++;
+            }
+            if (values != NULL) {
+                values[i] = value;
+            }
+        }
+        return removed;
+    }
+
+    for (i = 0L; i < STRIPES; i++) {
+        len = ( batch.starts[i + 1L] - batch.starts[i] );
+        if (len > 0L) {
+            j = batch.starts[i];
+            LOCK(&(map->stripes[i]));
+            removed += hashmap_removeAll(map->stripes[i].instance, &(batch.keys[j]),
+                                         &(batch.out[j]), len);
+            UNLOCK(&(map->stripes[i]));
+        }
+    }
+    _finish_batch(&batch, n, values);
+
+    return removed;
+}
+
 void ts_hashmap_clear(ConcurrentHashMap *map, void (*valueDestructor)(void *)) {
 
-    LOCK(map);
-    hashmap_clear(map->instance, valueDestructor);
-    UNLOCK(map);
+    long i;
+
+    _lock_all(map, TRUE);
+    for (i = 0L; i < STRIPES; i++) {
+        hashmap_clear(map->stripes[i].instance, valueDestructor);
+    }
+    _unlock_all(map);
+}
+
+/**
+ * Returns the total number of entries held in the stripes of `map`. Caller must hold every stripe.
+ */
+static long _total_size(ConcurrentHashMap *map) {
+
+    long i, size = 0L;
+    for (i = 0L; i < STRIPES; i++) {
+        size += hashmap_size(map->stripes[i].instance);
+    }
+    return size;
 }
 
 long ts_hashmap_size(ConcurrentHashMap *map) {
 
-    LOCK(map);
-    long size = hashmap_size(map->instance);
-    UNLOCK(map);
+    _lock_all(map, FALSE);
+    long size = _total_size(map);
+    _unlock_all(map);
 
     return size;
 }
 
 Boolean ts_hashmap_isEmpty(ConcurrentHashMap *map) {
 
-    LOCK(map);
-    Boolean isEmpty = hashmap_isEmpty(map->instance);
-    UNLOCK(map);
+    _lock_all(map, FALSE);
+    Boolean isEmpty = ( _total_size(map) == 0L ) ? TRUE : FALSE;
+    _unlock_all(map);
 
     return isEmpty;
 }
 
+void ts_hashmap_stats(ConcurrentHashMap *map, HashStats *stats) {
+
+    HashStats part;
+    double total = 0.0;
+    long i, j;
+
+    // Each stripe is sampled under its own lock, so the totals are not a single snapshot
+    memset(stats, 0, sizeof(HashStats));
+    for (i = 0L; i < STRIPES; i++) {
+        READ_LOCK(&(map->stripes[i]));
+        hashmap_stats(map->stripes[i].instance, &part);
+        UNLOCK(&(map->stripes[i]));
+
+        stats->capacity += part.capacity;
+        stats->size += part.size;
+        stats->usedBuckets += part.usedBuckets;
+        stats->maxChain = ( part.maxChain > stats->maxChain ) ? part.maxChain : stats->maxChain;
+        for (j = 0L; j < HASH_STATS_BINS; j++) {
+            stats->histogram[j] += part.histogram[j];
+        }
+        stats->tombstones += part.tombstones;
+        stats->resizes += part.resizes;
+        stats->resizeNanos += part.resizeNanos;
+        stats->lookups += part.lookups;
+        stats->probes += part.probes;
+        total += ( part.meanChain * part.usedBuckets );
+    }
+    stats->load = ( (double)stats->size / (double)stats->capacity );
+    stats->meanChain = ( stats->usedBuckets == 0L ) ? 0.0 : total / stats->usedBuckets;
+}
+
+/**
+ * Generates an array of either the keys or the entries from every stripe in `map`, and stores it
+ * into `*array`. Caller must hold every stripe.
+ */
+static Status _generate_array(ConcurrentHashMap *map, Array **array, Boolean keys) {
+
+    Array *temp, *part;
+    Status status;
+    long i, j, len;
+
+    // Does not create the array if currently empty
+    len = _total_size(map);
+    if (len == 0L) {
+        return STRUCT_EMPTY;
+    }
+
+    // Allocates memory for the array
+    temp = (Array *)malloc(sizeof(Array));
+    if (temp == NULL) {
+        return ALLOC_FAILURE;
+    }
+    temp->items = (void **)malloc(len * sizeof(void *));
+    if (temp->items == NULL) {
+        free(temp);
+        return ALLOC_FAILURE;
+    }
+
+    // Populates the array with the contents of each non-empty stripe
+    temp->len = 0L;
+    for (i = 0L; i < STRIPES; i++) {
+        if (keys == TRUE) {
+            status = hashmap_keyArray(map->stripes[i].instance, &part);
+        } else {
+            status = hashmap_entryArray(map->stripes[i].instance, &part);
+        }
+        if (status == STRUCT_EMPTY) {
+            continue;
+        } else if (status != OK) {
+            FREE_ARRAY(temp)
+            return status;
+        }
+        for (j = 0L; j < part->len; j++) {
+            temp->items[temp->len++] = part->items[j];
+        }
+        FREE_ARRAY(part)
+    }
+    *array = temp;
+
+    return OK;
+}
+
 Status ts_hashmap_keyArray(ConcurrentHashMap *map, Array **keys) {
 
-    LOCK(map);
-    Status status = hashmap_keyArray(map->instance, keys);
-    UNLOCK(map);
+    _lock_all(map, FALSE);
+    Status status = _generate_array(map, keys, TRUE);
+    _unlock_all(map);
 
     return status;
 }
 
 Status ts_hashmap_entryArray(ConcurrentHashMap *map, Array **entries) {
 
-    LOCK(map);
-    Status status = hashmap_entryArray(map->instance, entries);
-    UNLOCK(map);
+    _lock_all(map, FALSE);
+    Status status = _generate_array(map, entries, FALSE);
+    _unlock_all(map);
 
     return status;
 }
 
+/**
+ * Releases every stripe of the hashmap `map` once its iterator is destroyed.
+ */
+static void _release_iterator(void *map) {
+    _unlock_all((ConcurrentHashMap *)map);
+}
+
 Status ts_hashmap_iterator(ConcurrentHashMap *map, ConcurrentIterator **iter) {
 
     Array *array;
     Status status;
 
     // Creates the array of items and locks it
-    LOCK(map);
-    status = hashmap_entryArray(map->instance, &array);
+    _lock_all(map, FALSE);
+    status = _generate_array(map, &array, FALSE);
     if (status != OK) {
-        UNLOCK(map);
+        _unlock_all(map);
         return status;
     }
 
-    // Creates the iterator
-    status = ts_iterator_new(iter, &(map->lock), array->items, array->len);
+    // Creates the iterator, which keeps every stripe locked until destroyed
+    status = ts_iterator_newWithRelease(iter, _release_iterator, map, array->items, array->len);
     if (status != OK) {
         FREE_ARRAY(array);
-        UNLOCK(map);
+        _unlock_all(map);
     } else {
         free(array);
     }
@@ -184,11 +685,273 @@ Status ts_hashmap_iterator(ConcurrentHashMap *map, ConcurrentIterator **iter) {
     return status;
 }
 
+Boolean ts_hashmap_forEach(ConcurrentHashMap *map, Boolean (*action)(void *, void *, void *),
+                           void *context) {
+
+    Boolean complete = TRUE;
+    long i;
+
+    // Every stripe stays locked for the whole walk, so it sees one consistent state of the map
+    _lock_all(map, FALSE);
+    for (i = 0L; i < STRIPES && complete == TRUE; i++) {
+        complete = hashmap_forEach(map->stripes[i].instance, action, context);
+    }
+    _unlock_all(map);
+
+    return complete;
+}
+
+/**
+ * One thread's share of a parallel walk: the stripes `[lo..hi)`, whose entries are either handed
+ * to `action` or folded into `partial` through `reducer`.
+ */
+typedef struct {
+    ConcurrentHashMap *map;                             // The hashmap being walked
+    long lo, hi;                                        // The bounds of the stripes to walk
+    Boolean (*action)(void *, void *, void *);          // Function applied to each entry, or NULL
+    void *(*reducer)(void *, void *, void *, void *);   // Function folding each entry, or NULL
+    void *context;                                      // Argument passed along to each call
+    void *partial;                                      // The share's folded result
+    long visited;                                       // Number of entries the share walked
+    int *stop;                                          // Raised once any action asks to stop
+} WalkTask;
+
+/**
+ * hashmap_forEach() action handing an entry to the walk described by the WalkTask `arg`.
+ */
+static Boolean _walk_entry(void *key, void *value, void *arg) {
+
+    WalkTask *task = (WalkTask *)arg;
+
+    task->visited++;
+    if (task->reducer != NULL) {
+        task->partial = (*task->reducer)(task->partial, key, value, task->context);
+        return TRUE;
+    }
+    if ((*task->action)(key, value, task->context) == FALSE) {
+        __atomic_store_n(task->stop, 1, __ATOMIC_RELAXED);
+        return FALSE;
+    }
+
+    return ( __atomic_load_n(task->stop, __ATOMIC_RELAXED) == 0 ) ? TRUE : FALSE;
+}
+
+/**
+ * Thread routine walking the stripes described by the WalkTask `arg`.
+ */
+static void *_walk_task(void *arg) {
+
+    WalkTask *task = (WalkTask *)arg;
+    long i;
+
+    for (i = task->lo; i < task->hi; i++) {
+        if (hashmap_forEach(task->map->stripes[i].instance, _walk_entry, task) == FALSE) {
+            break;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * Splits the stripes into even ranges, one per thread, and walks each range with `action` or
+ * `reducer`. Every stripe must already be locked. Returns the number of ranges, now in `tasks`.
+ */
+static int _parallel_walk(ConcurrentHashMap *map, int nthreads,
+                          Boolean (*action)(void *, void *, void *),
+                          void *(*reducer)(void *, void *, void *, void *), void *context,
+                          int *stop, WalkTask *tasks) {
+
+    pthread_t threads[STRIPES];
+    Boolean started[STRIPES];
+    long size = 0L;
+    int i;
+
+    for (i = 0; i < STRIPES; i++) {
+        size += hashmap_size(map->stripes[i].instance);
+    }
+    if ((long)nthreads > STRIPES) {
+        nthreads = (int)STRIPES;
+    }
+    if ((long)nthreads > size / MIN_PARALLEL_RUN) {
+        nthreads = (int)( size / MIN_PARALLEL_RUN );
+    }
+    if (nthreads < 1) {
+        nthreads = 1;
+    }
+
+    for (i = 0; i < nthreads; i++) {
+        tasks[i].map = map;
+        tasks[i].lo = ( STRIPES * i ) / nthreads;
+        tasks[i].hi = ( STRIPES * ( i + 1 ) ) / nthreads;
+        tasks[i].action = action;
+        tasks[i].reducer = reducer;
+        tasks[i].context = context;
+        tasks[i].partial = NULL;
+        tasks[i].visited = 0L;
+        tasks[i].stop = stop;
+    }
+
+    // The calling thread takes the last range, as well as any whose thread couldn't be started
+    for (i = 0; i < nthreads - 1; i++) {
+        started[i] = TRUE;
+        if (pthread_create(&threads[i], NULL, _walk_task, &tasks[i]) != 0) {
+            started[i] = FALSE;
+            (void)_walk_task(&tasks[i]);
+        }
+    }
+    (void)_walk_task(&tasks[nthreads - 1]);
+    for (i = 0; i < nthreads - 1; i++) {
+        if (started[i] == TRUE) {
+            pthread_join(threads[i], NULL);
+        }
+    }
+
+    return nthreads;
+}
+
+Boolean ts_hashmap_parallelForEach(ConcurrentHashMap *map, int nthreads,
+                                   Boolean (*action)(void *, void *, void *), void *context) {
+
+    WalkTask tasks[STRIPES];
+    int stop = 0;
+
+    _lock_all(map, FALSE);
+    (void)_parallel_walk(map, nthreads, action, NULL, context, &stop, tasks);
+    _unlock_all(map);
+
+    return ( stop == 0 ) ? TRUE : FALSE;
+}
+
+void *ts_hashmap_parallelReduce(ConcurrentHashMap *map, int nthreads,
+                                void *(*reducer)(void *, void *, void *, void *),
+                                void *(*combiner)(void *, void *, void *), void *context) {
+
+    WalkTask tasks[STRIPES];
+    void *result = NULL;
+    Boolean first = TRUE;
+    int n, i, stop = 0;
+
+    _lock_all(map, FALSE);
+    n = _parallel_walk(map, nthreads, NULL, reducer, context, &stop, tasks);
+
+    // Ranges that held no entries have no result to combine
+    for (i = 0; i < n; i++) {
+        if (tasks[i].visited == 0L) {
+            continue;
+        }
+        result = ( first == TRUE ) ? tasks[i].partial
+                                   : (*combiner)(result, tasks[i].partial, context);
+        first = FALSE;
+    }
+    _unlock_all(map);
+
+    return result;
+}
+
+/**
+ * Frees the per-stripe entry copies backing a snapshot iterator once it is destroyed. `blocks` is
+ * a NULL-terminated array of the blocks returned by hashmap_entrySnapshot().
+ */
+static void _release_snapshot(void *blocks) {
+
+    void **temp = (void **)blocks;
+    long i;
+
+    for (i = 0L; temp[i] != NULL; i++) {
+        free(temp[i]);
+    }
+    free(temp);
+}
+
+Status ts_hashmap_snapshot(ConcurrentHashMap *map, ConcurrentIterator **iter) {
+
+    Array *part;
+    void **items, **blocks;
+    Status status = OK;
+    long i, j, len, next = 0L, count = 0L;
+
+    // Allocates room for each stripe's block of entry copies, plus the terminator
+    blocks = (void **)malloc(( STRIPES + 1 ) * sizeof(void *));
+    if (blocks == NULL) {
+        return ALLOC_FAILURE;
+    }
+
+    // Copies the entries of every stripe under a consistent view, then releases the locks
+    _lock_all(map, FALSE);
+    len = _total_size(map);
+    if (len == 0L) {
+        _unlock_all(map);
+        free(blocks);
+        return STRUCT_EMPTY;
+    }
+    items = (void **)malloc(len * sizeof(void *));
+    if (items == NULL) {
+        _unlock_all(map);
+        free(blocks);
+        return ALLOC_FAILURE;
+    }
+    for (i = 0L; i < STRIPES; i++) {
+        status = hashmap_entrySnapshot(map->stripes[i].instance, &part);
+        if (status == STRUCT_EMPTY) {
+            status = OK;
+            continue;
+        } else if (status != OK) {
+            break;
+        }
+        for (j = 0L; j < part->len; j++) {
+            items[next++] = part->items[j];
+        }
+        blocks[count++] = part->items;
+        free(part);
+    }
+    blocks[count] = NULL;
+    _unlock_all(map);
+
+    // Creates the iterator, which holds no lock while the caller iterates
+    if (status == OK) {
+        status = ts_iterator_newWithRelease(iter, _release_snapshot, blocks, items, len);
+    }
+    if (status != OK) {
+        free(items);
+        _release_snapshot(blocks);
+    }
+
+    return status;
+}
+
+long ts_hashmap_memoryUsage(ConcurrentHashMap *map) {
+
+    long bytes = (long)( sizeof(ConcurrentHashMap) + ( STRIPES * sizeof(Stripe) ) );
+    long i;
+
+    _lock_all(map, FALSE);
+    for (i = 0L; i < STRIPES; i++) {
+        bytes += hashmap_memoryUsage(map->stripes[i].instance);
+    }
+    _unlock_all(map);
+
+    return bytes;
+}
+
+void ts_hashmap_lockStats(ConcurrentHashMap *map, LockStats *stats) {
+
+    LockStats stripe;
+    long i;
+
+    stats->acquisitions = stats->contended = stats->waitNanos = stats->holdNanos = 0L;
+    for (i = 0L; i < STRIPES; i++) {
+        ts_lock_stats(&(map->stripes[i].lock), &stripe);
+        stats->acquisitions += stripe.acquisitions;
+        stats->contended += stripe.contended;
+        stats->waitNanos += stripe.waitNanos;
+        stats->holdNanos += stripe.holdNanos;
+    }
+}
+
 void ts_hashmap_destroy(ConcurrentHashMap *map, void (*valueDestructor)(void *)) {
 
-    LOCK(map);
-    hashmap_destroy(map->instance, valueDestructor);
-    UNLOCK(map);
-    pthread_mutex_destroy(&(map->lock));
-    free(map);
+    _lock_all(map, TRUE);
+    _unlock_all(map);
+    _free_map(map, valueDestructor);
 }
@@ -22,141 +22,626 @@
  * SOFTWARE.
  */
 
+
 #include <pthread.h>
 #include <stdlib.h>
+#include <string.h>
 #include "hash_set.h"
 #include "ts_hash_set.h"
+#include "ts_lock.h"
+
+/**
+ * A single stripe of the thread-safe hashset: a hashset holding a fraction of the elements, and the
+ * lock guarding it. Each stripe has its cache line(s) to itself, so that threads locking
+ * neighbouring stripes don't contend on the line.
+ */
+typedef struct stripe {
+    TsLock lock;                // The lock
+    HashSet *instance;          // Internal instance of HashSet holding this stripe's elements
+} CACHE_ALIGNED Stripe;
 
 /**
  * Struct for the thread-safe hashset.
+ *
+ * The elements are split across a fixed number of stripes, the same as the thread-safe hashmap,
+ * each stripe being an independent hashset with its own lock. Operations on a single element only
+ * lock the stripe the element hashes to; operations over the whole hashset lock every stripe in
+ * ascending order.
  */
 struct ts_hashset {
-    pthread_mutex_t lock;       // The lock
-    HashSet *instance;          // Internal instance of HashSet
-};
+    long (*hash)(void *, long);     // Hashing function for items, if created with ts_hashset_new()
+    uint64_t (*seededHash)(void *, uint64_t);   // Seeded hashing function, if created seeded
+    uint64_t seed;                  // The seed used for choosing an element's stripe
+    Stripe *stripes;                // The array of stripes
+} CACHE_ALIGNED;
+
+// Number of stripes the elements are split across, must be a power of 2
+#define STRIPES 64L
+// Number of bits needed to index into the stripes
+#define STRIPE_BITS 6
+// Modulus passed to ts_hashset_new() hash functions when choosing an element's stripe
+#define STRIPE_MODULUS 2147483629L
+
+// Parallel builds give each thread at least this many elements, smaller batches are added in place
+#define MIN_PARALLEL_RUN 16384L
+
+// Macro used for locking the stripe `s` for writing
+#define LOCK(s)       ts_lock_write( &((s)->lock) )
+// Macro used for locking the stripe `s` for reading
+#define READ_LOCK(s)  ts_lock_read( &((s)->lock) )
+// Macro used for unlocking the stripe `s`
+#define UNLOCK(s)     ts_lock_unlock( &((s)->lock) )
 
-// Macro used for locking the set `hs`
-#define LOCK(hs)    pthread_mutex_lock( &((hs)->lock) )
-// Macro used for unlocking the set
-#define UNLOCK(hs)  pthread_mutex_unlock( &((hs)->lock) )
+/**
+ * Returns the index of the stripe in `set` holding the element `item`. Uses different bits of the
+ * element's hash than the stripe's own hashset does, so the elements in a stripe still spread over
+ * all of its buckets.
+ */
+static long _stripe_of(ConcurrentHashSet *set, void *item) {
 
-Status ts_hashset_new(ConcurrentHashSet **set, long (*hash)(void *, long),
-        int (*comparator)(void *, void *), long capacity, double loadFactor) {
+    uint64_t code;
+
+    if (set->seededHash != NULL) {
+        code = set->seededHash(item, set->seed);
+    } else {
+        code = (uint64_t)set->hash(item, STRIPE_MODULUS);
+    }
+    code *= 0x9e3779b97f4a7c15UL;
+
+    return (long)( code >> (64 - STRIPE_BITS) );
+}
+
+// Returns the stripe in the set `s` holding the element `item`
+#define STRIPE_FOR(s, item)  ( &((s)->stripes[_stripe_of((s), (item))]) )
+
+/**
+ * Locks every stripe in `set` in ascending order, for writing if `write` is TRUE, or for reading.
+ */
+static void _lock_all(ConcurrentHashSet *set, Boolean write) {
+
+    long i;
+    for (i = 0L; i < STRIPES; i++) {
+        if (write == TRUE) {
+            LOCK(&(set->stripes[i]));
+        } else {
+            READ_LOCK(&(set->stripes[i]));
+        }
+    }
+}
+
+/**
+ * Unlocks every stripe in `set` in descending order.
+ */
+static void _unlock_all(ConcurrentHashSet *set) {
+
+    long i;
+    for (i = STRIPES - 1L; i >= 0L; i--) {
+        UNLOCK(&(set->stripes[i]));
+    }
+}
+
+/**
+ * Destroys the stripes of `set` that have been created so far, then frees `set` itself.
+ */
+static void _free_set(ConcurrentHashSet *set, void (*destructor)(void *)) {
+
+    long i;
+    for (i = 0L; i < STRIPES; i++) {
+        if (set->stripes[i].instance != NULL) {
+            hashset_destroy(set->stripes[i].instance, destructor);
+            ts_lock_destroy(&(set->stripes[i].lock));
+        }
+    }
+    free(set->stripes);
+    free(set);
+}
+
+/**
+ * Helper method to allocate the thread-safe hashset, then store the new instance into `*set`. The
+ * hashset of each stripe is created seeded if `seededHash` is not NULL, otherwise with `hash`. The
+ * starting capacity is divided among the stripes.
+ */
+static Status _new_set(ConcurrentHashSet **set, long (*hash)(void *, long),
+                       uint64_t (*seededHash)(void *, uint64_t), int (*comparator)(void *, void *),
+                       long capacity, double loadFactor) {
 
     ConcurrentHashSet *temp;
-    Status status;
-    pthread_mutexattr_t attr;
+    Status status = OK;
+    long i, cap;
 
     // Allocates memory for the hashset
-    temp = (ConcurrentHashSet *)malloc(sizeof(ConcurrentHashSet));
+    temp = (ConcurrentHashSet *)ts_lock_alloc(sizeof(ConcurrentHashSet));
     if (temp == NULL) {
         return ALLOC_FAILURE;
     }
+    temp->stripes = (Stripe *)ts_lock_alloc(STRIPES * sizeof(Stripe));
+    if (temp->stripes == NULL) {
+        free(temp);
+        return ALLOC_FAILURE;
+    }
+    temp->hash = hash;
+    temp->seededHash = seededHash;
+    temp->seed = ( seededHash != NULL ) ? hashing_seed() : 0UL;
+    for (i = 0L; i < STRIPES; i++) {
+        temp->stripes[i].instance = NULL;
+    }
+
+    // Each stripe receives its share of the starting capacity, or the default one
+    cap = ( capacity <= 0L ) ? capacity : ( (capacity + STRIPES - 1L) / STRIPES );
+
+    // Creates the hashset and lock of each stripe
+    for (i = 0L; i < STRIPES && status == OK; i++) {
+        if (seededHash != NULL) {
+            status = hashset_newSeeded(&(temp->stripes[i].instance), seededHash, comparator, cap,
+                                       loadFactor);
+        } else {
+            status = hashset_new(&(temp->stripes[i].instance), hash, comparator, cap, loadFactor);
+        }
+        if (status == OK) {
+            ts_lock_init(&(temp->stripes[i].lock));
+        } else {
+            temp->stripes[i].instance = NULL;
+        }
+    }
 
-    // Creates internal instance of hashset
-    status = hashset_new(&(temp->instance), hash, comparator, capacity, loadFactor);
+    // Cleans up the stripes created so far if any failed
     if (status != OK) {
-        free(temp);
+        _free_set(temp, NULL);
         return status;
     }
-
-    // Creates pthread_mutex for locking
-    pthread_mutexattr_init(&attr);
-    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
-    pthread_mutex_init(&(temp->lock), &attr);
-    pthread_mutexattr_destroy(&attr);
     *set = temp;
 
     return OK;
 }
 
+Status ts_hashset_new(ConcurrentHashSet **set, long (*hash)(void *, long),
+        int (*comparator)(void *, void *), long capacity, double loadFactor) {
+    return _new_set(set, hash, NULL, comparator, capacity, loadFactor);
+}
+
+Status ts_hashset_newSeeded(ConcurrentHashSet **set, uint64_t (*hash)(void *, uint64_t),
+        int (*comparator)(void *, void *), long capacity, double loadFactor) {
+    return _new_set(set, NULL, hash, comparator, capacity, loadFactor);
+}
+
 void ts_hashset_lock(ConcurrentHashSet *set) {
-    LOCK(set);
+    _lock_all(set, TRUE);
 }
 
 void ts_hashset_unlock(ConcurrentHashSet *set) {
-    UNLOCK(set);
+    _unlock_all(set);
+}
+
+void ts_hashset_lockRead(ConcurrentHashSet *set) {
+    _lock_all(set, FALSE);
+}
+
+void ts_hashset_lockWrite(ConcurrentHashSet *set) {
+    _lock_all(set, TRUE);
+}
+
+void ts_hashset_setIncrementalResize(ConcurrentHashSet *set, Boolean incremental) {
+
+    long i;
+    for (i = 0L; i < STRIPES; i++) {
+        LOCK(&(set->stripes[i]));
+        hashset_setIncrementalResize(set->stripes[i].instance, incremental);
+        UNLOCK(&(set->stripes[i]));
+    }
+}
+
+Status ts_hashset_reserve(ConcurrentHashSet *set, long n) {
+
+    // Each stripe reserves room for its even share of the elements
+    long i, share = ( n + STRIPES - 1L ) / STRIPES;
+    Status status = OK;
+
+    for (i = 0L; i < STRIPES && status == OK; i++) {
+        LOCK(&(set->stripes[i]));
+        status = hashset_reserve(set->stripes[i].instance, share);
+        UNLOCK(&(set->stripes[i]));
+    }
+
+    return status;
+}
+
+Status ts_hashset_shrinkToFit(ConcurrentHashSet *set) {
+
+    long i;
+    Status status = OK;
+
+    for (i = 0L; i < STRIPES && status == OK; i++) {
+        LOCK(&(set->stripes[i]));
+        status = hashset_shrinkToFit(set->stripes[i].instance);
+        UNLOCK(&(set->stripes[i]));
+    }
+
+    return status;
 }
 
 Status ts_hashset_add(ConcurrentHashSet *set, void *item) {
 
-    LOCK(set);
-    Status status = hashset_add(set->instance, item);
-    UNLOCK(set);
+    Stripe *stripe = STRIPE_FOR(set, item);
+    LOCK(stripe);
+    Status status = hashset_add(stripe->instance, item);
+    UNLOCK(stripe);
 
     return status;
 }
 
 Boolean ts_hashset_contains(ConcurrentHashSet *set, void *item) {
 
-    LOCK(set);
-    Boolean contains = hashset_contains(set->instance, item);
-    UNLOCK(set);
+    Stripe *stripe = STRIPE_FOR(set, item);
+    READ_LOCK(stripe);
+    Boolean contains = hashset_contains(stripe->instance, item);
+    UNLOCK(stripe);
 
     return contains;
 }
 
 Status ts_hashset_remove(ConcurrentHashSet *set, void *item, void (*destructor)(void *)) {
 
-    LOCK(set);
-    Status status = hashset_remove(set->instance, item, destructor);
-    UNLOCK(set);
+    Stripe *stripe = STRIPE_FOR(set, item);
+    LOCK(stripe);
+    Status status = hashset_remove(stripe->instance, item, destructor);
+    UNLOCK(stripe);
 
     return status;
 }
 
+/**
+ * Gathers the `n` elements of `items` stripe by stripe into `gathered`, keeping the elements of
+ * each stripe in their original order, and stores where each stripe's elements start into
+ * `starts`. Returns TRUE if successful, FALSE if not (allocation error).
+ */
+static Boolean _gather(ConcurrentHashSet *set, void **items, long n, void **gathered,
+                       long starts[STRIPES + 1L]) {
+
+    long i;
+
+    // Remembers each element's stripe, so that each element is only hashed once
+    unsigned char *stripeOf = (unsigned char *)malloc(n);
+    if (stripeOf == NULL) {
+        return FALSE;
+    }
+
+    // Counts the elements in each stripe, then turns the counts into starting offsets
+    for (i = 0L; i <= STRIPES; i++) {
+        starts[i] = 0L;
+    }
+    for (i = 0L; i < n; i++) {
+        stripeOf[i] = (unsigned char)_stripe_of(set, items[i]);
+        starts[stripeOf[i] + 1L]++;
+    }
+    for (i = 1L; i <= STRIPES; i++) {
+        starts[i] += starts[i - 1L];
+    }
+
+    // Gathers the elements stripe by stripe, using the next offsets as cursors
+    for (i = 0L; i < n; i++) {
+        gathered[starts[stripeOf[i]]++] = items[i];
+    }
+    for (i = STRIPES; i > 0L; i--) {
+        starts[i] = starts[i - 1L];
+    }
+    starts[0] = 0L;
+    free(stripeOf);
+
+    return TRUE;
+}
+
+/**
+ * Adds the `n` elements of `items` into `set` while locking each stripe only once, starting from
+ * the stripe `first` and wrapping around, so that threads adding at the same time start on
+ * different stripes. Falls back to adding each element under its own lock if the batch cannot be
+ * gathered. Returns OK, or ALLOC_FAILURE if any element could not be added.
+ */
+static Status _add_batch(ConcurrentHashSet *set, void **items, long n, long first) {
+
+    long starts[STRIPES + 1L];
+    long i, s, len;
+    Status status = OK;
+
+    void **gathered = (void **)malloc(n * sizeof(void *));
+    if (gathered == NULL || _gather(set, items, n, gathered, starts) == FALSE) {
+        free(gathered);
+        for (i = 0L; i < n && status == OK; i++) {
+            status = ts_hashset_add(set, items[i]);
+            status = ( status == ALREADY_EXISTS ) ? OK : status;
+        }
+        return status;
+    }
+
+    for (i = 0L; i < STRIPES && status == OK; i++) {
+        s = ( first + i ) % STRIPES;
+        len = ( starts[s + 1L] - starts[s] );
+        if (len > 0L) {
+            LOCK(&(set->stripes[s]));
+            status = hashset_addAll(set->stripes[s].instance, &(gathered[starts[s]]), len);
+            UNLOCK(&(set->stripes[s]));
+        }
+    }
+    free(gathered);
+
+    return status;
+}
+
+Status ts_hashset_addAll(ConcurrentHashSet *set, void **items, long n) {
+
+    if (n <= 0L) {
+        return OK;
+    }
+    return _add_batch(set, items, n, 0L);
+}
+
+/**
+ * One thread's share of a parallel build: the elements `[lo..hi)` of `items`.
+ */
+typedef struct {
+    ConcurrentHashSet *set;     // The hashset being built
+    void **items;               // The elements being added
+    long lo, hi;                // The bounds of the share's elements
+    long first;                 // The stripe the share starts adding to
+    Status status;              // The result of adding the share
+} BuildTask;
+
+/**
+ * Thread routine adding the elements described by the BuildTask `arg`.
+ */
+static void *_build_task(void *arg) {
+
+    BuildTask *task = (BuildTask *)arg;
+    task->status = _add_batch(task->set, &(task->items[task->lo]), task->hi - task->lo,
+                              task->first);
+    return NULL;
+}
+
+Status ts_hashset_addAllParallel(ConcurrentHashSet *set, void **items, long n, int nthreads) {
+
+    BuildTask *tasks;
+    pthread_t *threads;
+    Boolean *started;
+    Status status = OK;
+    int i;
+
+    if (n <= 0L) {
+        return OK;
+    }
+    if ((long)nthreads > n / MIN_PARALLEL_RUN) {
+        nthreads = (int)( n / MIN_PARALLEL_RUN );
+    }
+    if (nthreads <= 1) {
+        return _add_batch(set, items, n, 0L);
+    }
+
+    // Falls back to adding the elements on the calling thread if the tasks cannot be allocated
+    tasks = (BuildTask *)malloc(nthreads * ( sizeof(BuildTask) + sizeof(pthread_t) +
+                                             sizeof(Boolean) ));
+    if (tasks == NULL) {
+        return _add_batch(set, items, n, 0L);
+    }
+    threads = (pthread_t *)( tasks + nthreads );
+    started = (Boolean *)( threads + nthreads );
+
+    // Each thread hashes and gathers an even share of the elements without holding any lock
+    for (i = 0; i < nthreads; i++) {
+        tasks[i].set = set;
+        tasks[i].items = items;
+        tasks[i].lo = ( n * i ) / nthreads;
+        tasks[i].hi = ( n * ( i + 1 ) ) / nthreads;
+        tasks[i].first = ( STRIPES * i ) / nthreads;
+        tasks[i].status = OK;
+    }
+
+    // The calling thread takes the last share, as well as any whose thread couldn't be started
+    for (i = 0; i < nthreads - 1; i++) {
+        started[i] = TRUE;
+        if (pthread_create(&threads[i], NULL, _build_task, &tasks[i]) != 0) {
+            started[i] = FALSE;
+            (void)_build_task(&tasks[i]);
+        }
+    }
+    (void)_build_task(&tasks[nthreads - 1]);
+    for (i = 0; i < nthreads; i++) {
+        if (i < nthreads - 1 && started[i] == TRUE) {
+            pthread_join(threads[i], NULL);
+        }
+        status = ( tasks[i].status != OK ) ? tasks[i].status : status;
+    }
+    free(tasks);
+
+    return status;
+}
+
+long ts_hashset_removeAll(ConcurrentHashSet *set, void **items, long n,
+                          void (*destructor)(void *)) {
+
+    long starts[STRIPES + 1L];
+    long i, len, removed = 0L;
+
+    if (n <= 0L) {
+        return 0L;
+    }
+
+    // Falls back to removing each element under its own lock if the batch cannot be gathered
+    void **gathered = (void **)malloc(n * sizeof(void *));
+    if (gathered == NULL || _gather(set, items, n, gathered, starts) == FALSE) {
+        free(gathered);
+        for (i = 0L; i < n; i++) {
+            if (ts_hashset_remove(set, items[i], destructor) == OK) {
+                removed++;
+            }
+        }
+        return removed;
+    }
+
+    for (i = 0L; i < STRIPES; i++) {
+        len = ( starts[i + 1L] - starts[i] );
+        if (len > 0L) {
+            LOCK(&(set->stripes[i]));
+            removed += hashset_removeAll(set->stripes[i].instance, &(gathered[starts[i]]), len,
+                                         destructor);
+            UNLOCK(&(set->stripes[i]));
+        }
+    }
+    free(gathered);
+
+    return removed;
+}
+
 void ts_hashset_clear(ConcurrentHashSet *set, void (*destructor)(void *)) {
 
-    LOCK(set);
-    hashset_clear(set->instance, destructor);
-    UNLOCK(set);
+    long i;
+
+    _lock_all(set, TRUE);
+    for (i = 0L; i < STRIPES; i++) {
+        hashset_clear(set->stripes[i].instance, destructor);
+    }
+    _unlock_all(set);
+}
+
+/**
+ * Returns the total number of elements held in the stripes of `set`. Caller must hold every stripe.
+ */
+static long _total_size(ConcurrentHashSet *set) {
+
+    long i, size = 0L;
+    for (i = 0L; i < STRIPES; i++) {
+        size += hashset_size(set->stripes[i].instance);
+    }
+    return size;
 }
 
 long ts_hashset_size(ConcurrentHashSet *set) {
 
-    LOCK(set);
-    long size = hashset_size(set->instance);
-    UNLOCK(set);
+    _lock_all(set, FALSE);
+    long size = _total_size(set);
+    _unlock_all(set);
 
     return size;
 }
 
 Boolean ts_hashset_isEmpty(ConcurrentHashSet *set) {
 
-    LOCK(set);
-    Boolean isEmpty = hashset_isEmpty(set->instance);
-    UNLOCK(set);
+    _lock_all(set, FALSE);
+    Boolean isEmpty = ( _total_size(set) == 0L ) ? TRUE : FALSE;
+    _unlock_all(set);
 
     return isEmpty;
 }
 
+void ts_hashset_stats(ConcurrentHashSet *set, HashStats *stats) {
+
+    HashStats part;
+    double total = 0.0;
+    long i, j;
+
+    // Each stripe is sampled under its own lock, so the totals are not a single snapshot
+    memset(stats, 0, sizeof(HashStats));
+    for (i = 0L; i < STRIPES; i++) {
+        READ_LOCK(&(set->stripes[i]));
+        hashset_stats(set->stripes[i].instance, &part);
+        UNLOCK(&(set->stripes[i]));
+
+        stats->capacity += part.capacity;
+        stats->size += part.size;
+        stats->usedBuckets += part.usedBuckets;
+        stats->maxChain = ( part.maxChain > stats->maxChain ) ? part.maxChain : stats->maxChain;
+        for (j = 0L; j < HASH_STATS_BINS; j++) {
+            stats->histogram[j] += part.histogram[j];
+        }
+        stats->tombstones += part.tombstones;
+        stats->resizes += part.resizes;
+        stats->resizeNanos += part.resizeNanos;
+        stats->lookups += part.lookups;
+        stats->probes += part.probes;
+        total += ( part.meanChain * part.usedBuckets );
+    }
+    stats->load = ( (double)stats->size / (double)stats->capacity );
+    stats->meanChain = ( stats->usedBuckets == 0L ) ? 0.0 : total / stats->usedBuckets;
+}
+
+/**
+ * Generates an array of the elements from every stripe in `set`, and stores it into `*array`.
+ * Caller must hold every stripe.
+ */
+static Status _generate_array(ConcurrentHashSet *set, Array **array) {
+
+    Array *temp, *part;
+    Status status;
+    long i, j, len;
+
+    // Does not create the array if currently empty
+    len = _total_size(set);
+    if (len == 0L) {
+        return STRUCT_EMPTY;
+    }
+
+    // Allocates memory for the array
+    temp = (Array *)malloc(sizeof(Array));
+    if (temp == NULL) {
+        return ALLOC_FAILURE;
+    }
+    temp->items = (void **)malloc(len * sizeof(void *));
+    if (temp->items == NULL) {
+        free(temp);
+        return ALLOC_FAILURE;
+    }
+
+    // Populates the array with the contents of each non-empty stripe
+    temp->len = 0L;
+    for (i = 0L; i < STRIPES; i++) {
+        status = hashset_toArray(set->stripes[i].instance, &part);
+        if (status == STRUCT_EMPTY) {
+            continue;
+        } else if (status != OK) {
+            FREE_ARRAY(temp)
+            return status;
+        }
+        for (j = 0L; j < part->len; j++) {
+            temp->items[temp->len++] = part->items[j];
+        }
+        FREE_ARRAY(part)
+    }
+    *array = temp;
+
+    return OK;
+}
+
 Status ts_hashset_toArray(ConcurrentHashSet *set, Array **array) {
 
-    LOCK(set);
-    Status status = hashset_toArray(set->instance, array);
-    UNLOCK(set);
+    _lock_all(set, FALSE);
+    Status status = _generate_array(set, array);
+    _unlock_all(set);
 
     return status;
 }
 
+/**
+ * Releases every stripe of the hashset `set` once its iterator is destroyed.
+ */
+static void _release_iterator(void *set) {
+    _unlock_all((ConcurrentHashSet *)set);
+}
+
 Status ts_hashset_iterator(ConcurrentHashSet *set, ConcurrentIterator **iter) {
 
     Array *array;
     Status status;
 
     // Creates array of items and locks it
-    LOCK(set);
-    status = hashset_toArray(set->instance, &array);
+    _lock_all(set, FALSE);
+    status = _generate_array(set, &array);
     if (status != OK) {
-        UNLOCK(set);
+        _unlock_all(set);
         return status;
     }
 
-    // Creates the iterator
-    status = ts_iterator_new(iter, &(set->lock), array->items, array->len);
+    // Creates the iterator, which keeps every stripe locked until destroyed
+    status = ts_iterator_newWithRelease(iter, _release_iterator, set, array->items, array->len);
     if (status != OK) {
         FREE_ARRAY(array);
-        UNLOCK(set);
+        _unlock_all(set);
     } else {
         free(array);
     }
@@ -164,11 +649,78 @@ Status ts_hashset_iterator(ConcurrentHashSet *set, ConcurrentIterator **iter) {
     return status;
 }
 
+Boolean ts_hashset_forEach(ConcurrentHashSet *set, Boolean (*action)(void *, void *),
+                           void *context) {
+
+    Boolean complete = TRUE;
+    long i;
+
+    // Every stripe stays locked for the whole walk, so it sees one consistent state of the set
+    _lock_all(set, FALSE);
+    for (i = 0L; i < STRIPES && complete == TRUE; i++) {
+        complete = hashset_forEach(set->stripes[i].instance, action, context);
+    }
+    _unlock_all(set);
+
+    return complete;
+}
+
+Status ts_hashset_snapshot(ConcurrentHashSet *set, ConcurrentIterator **iter) {
+
+    Array *array;
+    Status status;
+
+    // Copies the items under the locks, then releases them right away
+    _lock_all(set, FALSE);
+    status = _generate_array(set, &array);
+    _unlock_all(set);
+    if (status != OK) {
+        return status;
+    }
+
+    // Creates the iterator, which holds no lock while the caller iterates
+    status = ts_iterator_newSnapshot(iter, array->items, array->len);
+    if (status != OK) {
+        FREE_ARRAY(array);
+    } else {
+        free(array);
+    }
+
+    return status;
+}
+
+long ts_hashset_memoryUsage(ConcurrentHashSet *set) {
+
+    long bytes = (long)( sizeof(ConcurrentHashSet) + ( STRIPES * sizeof(Stripe) ) );
+    long i;
+
+    _lock_all(set, FALSE);
+    for (i = 0L; i < STRIPES; i++) {
+        bytes += hashset_memoryUsage(set->stripes[i].instance);
+    }
+    _unlock_all(set);
+
+    return bytes;
+}
+
+void ts_hashset_lockStats(ConcurrentHashSet *set, LockStats *stats) {
+
+    LockStats stripe;
+    long i;
+
+    stats->acquisitions = stats->contended = stats->waitNanos = stats->holdNanos = 0L;
+    for (i = 0L; i < STRIPES; i++) {
+        ts_lock_stats(&(set->stripes[i].lock), &stripe);
+        stats->acquisitions += stripe.acquisitions;
+        stats->contended += stripe.contended;
+        stats->waitNanos += stripe.waitNanos;
+        stats->holdNanos += stripe.holdNanos;
+    }
+}
+
 void ts_hashset_destroy(ConcurrentHashSet *set, void (*destructor)(void *)) {
 
-    LOCK(set);
-    hashset_destroy(set->instance, destructor);
-    UNLOCK(set);
-    pthread_mutex_destroy(&(set->lock));
-    free(set);
+    _lock_all(set, TRUE);
+    _unlock_all(set);
+    _free_set(set, destructor);
 }
@@ -22,48 +22,77 @@
  * SOFTWARE.
  */
 
-#include <pthread.h>
 #include <stdlib.h>
 #include "heap.h"
 #include "ts_heap.h"
+#include "ts_lock.h"
 
 /**
  * Struct for the thread-safe heap.
  */
 struct ts_heap {
-    pthread_mutex_t lock;       // The lock
+    TsLock lock;                // The lock
     Heap *instance;             // Internal instance of Heap
-};
+} CACHE_ALIGNED;
+
+// Macro used for locking the heap `h` for writing
+#define LOCK(h)       ts_lock_write( &((h)->lock) )
+// Macro used for locking the heap `h` for reading
+#define READ_LOCK(h)  ts_lock_read( &((h)->lock) )
+// Macro used for unlocking the heap `h`
+#define UNLOCK(h)     ts_lock_unlock( &((h)->lock) )
+
+Status ts_heap_newWithArity(ConcurrentHeap **heap, long capacity, long arity,
+        int (*comparator)(void *, void *))
+{
+    ConcurrentHeap *temp;
+    Status status;
 
-// Macro used for locking the heap `h`
-#define LOCK(h)    pthread_mutex_lock( &((h)->lock) )
-// Macro used for unlocking the heap
-#define UNLOCK(h)  pthread_mutex_unlock( &((h)->lock) )
+    // Allocates memory for the heap
+    temp = (ConcurrentHeap *)ts_lock_alloc(sizeof(ConcurrentHeap));
+    if (temp == NULL) {
+        return ALLOC_FAILURE;
+    }
+
+    // Creates the internal heap instance
+    status = heap_newWithArity(&(temp->instance), capacity, arity, comparator);
+    if (status != OK) {
+        free(temp);
+        return status;
+    }
+
+    // Creates the lock with the calling thread's default lock policy
+    ts_lock_init(&(temp->lock));
+    *heap = temp;
+
+    return OK;
+}
 
 Status ts_heap_new(ConcurrentHeap **heap, long capacity, int (*comparator)(void *, void *)) {
+    return ts_heap_newWithArity(heap, capacity, 2L, comparator);
+}
 
+Status ts_heap_fromArray(ConcurrentHeap **heap, void **items, long n,
+        int (*comparator)(void *, void *))
+{
     ConcurrentHeap *temp;
     Status status;
-    pthread_mutexattr_t attr;
 
     // Allocates memory for the heap
-    temp = (ConcurrentHeap *)malloc(sizeof(ConcurrentHeap));
+    temp = (ConcurrentHeap *)ts_lock_alloc(sizeof(ConcurrentHeap));
     if (temp == NULL) {
         return ALLOC_FAILURE;
     }
 
     // Creates the internal heap instance
-    status = heap_new(&(temp->instance), capacity, comparator);
+    status = heap_fromArray(&(temp->instance), items, n, comparator);
     if (status != OK) {
         free(temp);
         return status;
     }
 
-    // Creates the pthread_mutex for locking
-    pthread_mutexattr_init(&attr);
-    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
-    pthread_mutex_init(&(temp->lock), &attr);
-    pthread_mutexattr_destroy(&attr);
+    // Creates the lock with the calling thread's default lock policy
+    ts_lock_init(&(temp->lock));
     *heap = temp;
 
     return OK;
@@ -77,6 +106,21 @@ void ts_heap_unlock(ConcurrentHeap *heap) {
     UNLOCK(heap);
 }
 
+void ts_heap_lockRead(ConcurrentHeap *heap) {
+    READ_LOCK(heap);
+}
+
+void ts_heap_lockWrite(ConcurrentHeap *heap) {
+    LOCK(heap);
+}
+
+void ts_heap_setGrowthFactor(ConcurrentHeap *heap, float growthFactor) {
+
+    LOCK(heap);
+    heap_setGrowthFactor(heap->instance, growthFactor);
+    UNLOCK(heap);
+}
+
 Status ts_heap_insert(ConcurrentHeap *heap, void *item) {
 
     LOCK(heap);
@@ -86,9 +130,63 @@ Status ts_heap_insert(ConcurrentHeap *heap, void *item) {
     return status;
 }
 
-Status ts_heap_peek(ConcurrentHeap *heap, void **min) {
+Status ts_heap_insertAll(ConcurrentHeap *heap, void **items, long n) {
+
+    LOCK(heap);
+    Status status = heap_insertAll(heap->instance, items, n);
+    UNLOCK(heap);
+
+    return status;
+}
+
+Status ts_heap_merge(ConcurrentHeap *dst, ConcurrentHeap *src) {
+
+    if (dst == src) {
+        return OK;
+    }
+
+    // Locks the heaps in address order to avoid deadlocks
+    ConcurrentHeap *first = ( dst < src ) ? dst : src;
+    ConcurrentHeap *second = ( dst < src ) ? src : dst;
+    LOCK(first);
+    LOCK(second);
+    Status status = heap_merge(dst->instance, src->instance);
+    UNLOCK(second);
+    UNLOCK(first);
+
+    return status;
+}
+
+Status ts_heap_insertHandle(ConcurrentHeap *heap, void *item, HeapHandle *handle) {
+
+    LOCK(heap);
+    Status status = heap_insertHandle(heap->instance, item, handle);
+    UNLOCK(heap);
+
+    return status;
+}
+
+Status ts_heap_update(ConcurrentHeap *heap, HeapHandle handle, void *item) {
 
     LOCK(heap);
+    Status status = heap_update(heap->instance, handle, item);
+    UNLOCK(heap);
+
+    return status;
+}
+
+Status ts_heap_removeHandle(ConcurrentHeap *heap, HeapHandle handle, void **item) {
+
+    LOCK(heap);
+    Status status = heap_removeHandle(heap->instance, handle, item);
+    UNLOCK(heap);
+
+    return status;
+}
+
+Status ts_heap_peek(ConcurrentHeap *heap, void **min) {
+
+    READ_LOCK(heap);
     Status status = heap_peek(heap->instance, min);
     UNLOCK(heap);
 
@@ -113,7 +211,7 @@ void ts_heap_clear(ConcurrentHeap *heap, void (*destructor)(void *)) {
 
 long ts_heap_size(ConcurrentHeap *heap) {
 
-    LOCK(heap);
+    READ_LOCK(heap);
     long size = heap_size(heap->instance);
     UNLOCK(heap);
 
@@ -122,7 +220,7 @@ long ts_heap_size(ConcurrentHeap *heap) {
 
 Boolean ts_heap_isEmpty(ConcurrentHeap *heap) {
 
-    LOCK(heap);
+    READ_LOCK(heap);
     Boolean isEmpty = heap_isEmpty(heap->instance);
     UNLOCK(heap);
 
@@ -131,7 +229,7 @@ Boolean ts_heap_isEmpty(ConcurrentHeap *heap) {
 
 Status ts_heap_toArray(ConcurrentHeap *heap, Array **array) {
 
-    LOCK(heap);
+    READ_LOCK(heap);
     Status status = heap_toArray(heap->instance, array);
     UNLOCK(heap);
 
@@ -144,7 +242,7 @@ Status ts_heap_iterator(ConcurrentHeap *heap, ConcurrentIterator **iter) {
     Status status;
 
     // Creates the array of items and locks it
-    LOCK(heap);
+    READ_LOCK(heap);
     status = heap_toArray(heap->instance, &array);
     if (status != OK) {
         UNLOCK(heap);
@@ -152,7 +250,8 @@ Status ts_heap_iterator(ConcurrentHeap *heap, ConcurrentIterator **iter) {
     }
 
     // Creates the iterator
-    status = ts_iterator_new(iter, &(heap->lock), array->items, array->len);
+    status = ts_iterator_newWithRelease(iter, ts_lock_release, &(heap->lock),
+                                        array->items, array->len);
     if (status != OK) {
         FREE_ARRAY(array);
         UNLOCK(heap);
@@ -163,11 +262,57 @@ Status ts_heap_iterator(ConcurrentHeap *heap, ConcurrentIterator **iter) {
     return status;
 }
 
+Boolean ts_heap_forEach(ConcurrentHeap *heap, Boolean (*action)(void *, void *), void *context) {
+
+    READ_LOCK(heap);
+    Boolean complete = heap_forEach(heap->instance, action, context);
+    UNLOCK(heap);
+
+    return complete;
+}
+
+Status ts_heap_snapshot(ConcurrentHeap *heap, ConcurrentIterator **iter) {
+
+    Array *array;
+    Status status;
+
+    // Copies the items under the lock, then releases it right away
+    READ_LOCK(heap);
+    status = heap_toArray(heap->instance, &array);
+    UNLOCK(heap);
+    if (status != OK) {
+        return status;
+    }
+
+    // Creates the iterator, which holds no lock while the caller iterates
+    status = ts_iterator_newSnapshot(iter, array->items, array->len);
+    if (status != OK) {
+        FREE_ARRAY(array);
+    } else {
+        free(array);
+    }
+
+    return status;
+}
+
+long ts_heap_memoryUsage(ConcurrentHeap *heap) {
+
+    READ_LOCK(heap);
+    long bytes = (long)sizeof(ConcurrentHeap) + heap_memoryUsage(heap->instance);
+    UNLOCK(heap);
+
+    return bytes;
+}
+
+void ts_heap_lockStats(ConcurrentHeap *heap, LockStats *stats) {
+    ts_lock_stats(&(heap->lock), stats);
+}
+
 void ts_heap_destroy(ConcurrentHeap *heap, void (*destructor)(void *)) {
 
     LOCK(heap);
     heap_destroy(heap->instance, destructor);
     UNLOCK(heap);
-    pthread_mutex_destroy(&(heap->lock));
+    ts_lock_destroy(&(heap->lock));
     free(heap);
 }
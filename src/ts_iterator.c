@@ -29,10 +29,13 @@
  * Struct for the thread-safe iterator.
  */
 struct ts_iterator {
-    pthread_mutex_t *lock;      // The lock
+    pthread_mutex_t *lock;      // The lock, or NULL if the iterator holds none
+    void (*release)(void *);    // Releases the ADT's locks in place of `lock`, if not NULL
+    void *arg;                  // Argument passed on to `release`
     void **items;               // Array of iterable elements
     long next;                  // Index that points to next item in iteration
-    long len;                   // Total number of elements
+    long len;                   // Index past the last element to iterate
+    long *refs;                 // Iterators sharing `items` once split, NULL if never split
 };
 
 Status ts_iterator_new(ConcurrentIterator **iter, pthread_mutex_t *lock, void **items, long len) {
@@ -44,14 +47,33 @@ Status ts_iterator_new(ConcurrentIterator **iter, pthread_mutex_t *lock, void **
 
     // Initializes the remaining struct members
     temp->lock = lock;
+    temp->release = NULL;
+    temp->arg = NULL;
     temp->items = items;
     temp->next = 0L;
     temp->len = len;
+    temp->refs = NULL;
     *iter = temp;
 
     return OK;
 }
 
+Status ts_iterator_newWithRelease(ConcurrentIterator **iter, void (*release)(void *), void *arg,
+                                  void **items, long len) {
+
+    Status status = ts_iterator_new(iter, NULL, items, len);
+    if (status == OK) {
+        (*iter)->release = release;
+        (*iter)->arg = arg;
+    }
+
+    return status;
+}
+
+Status ts_iterator_newSnapshot(ConcurrentIterator **iter, void **items, long len) {
+    return ts_iterator_new(iter, NULL, items, len);
+}
+
 Boolean ts_iterator_hasNext(ConcurrentIterator *iter) {
     return ( iter->next < iter->len ) ? TRUE : FALSE;
 }
@@ -67,8 +89,53 @@ Status ts_iterator_next(ConcurrentIterator *iter, void **next) {
     return OK;
 }
 
+long ts_iterator_remaining(ConcurrentIterator *iter) {
+    return iter->len - iter->next;
+}
+
+Status ts_iterator_trySplit(ConcurrentIterator *iter, ConcurrentIterator **prefix) {
+
+    long mid = iter->next + ( iter->len - iter->next ) / 2L;
+
+    // Checks if there are enough elements left to split
+    if (mid == iter->next)
+        return ITER_END;
+
+    // The first split starts counting the iterators sharing the items
+    ConcurrentIterator *temp = (ConcurrentIterator *)malloc(sizeof(ConcurrentIterator));
+    if (temp == NULL)
+        return ALLOC_FAILURE;
+    if (iter->refs == NULL) {
+        if ((iter->refs = (long *)malloc(sizeof(long))) == NULL) {
+            free(temp);
+            return ALLOC_FAILURE;
+        }
+        *(iter->refs) = 1L;
+    }
+    __atomic_add_fetch(iter->refs, 1L, __ATOMIC_RELAXED);
+
+    // Hands the first half over to the new iterator, keeps the second
+    *temp = *iter;
+    temp->len = mid;
+    iter->next = mid;
+    *prefix = temp;
+
+    return OK;
+}
+
 void ts_iterator_destroy(ConcurrentIterator *iter) {
+
+    // The items and locks are released along with the last of the iterators sharing them
+    if (iter->refs != NULL && __atomic_sub_fetch(iter->refs, 1L, __ATOMIC_ACQ_REL) != 0L) {
+        free(iter);
+        return;
+    }
+    free(iter->refs);
     free(iter->items);
-    pthread_mutex_unlock(iter->lock);
+    if (iter->release != NULL) {
+        iter->release(iter->arg);
+    } else if (iter->lock != NULL) {
+        pthread_mutex_unlock(iter->lock);
+    }
     free(iter);
 }
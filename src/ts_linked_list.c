@@ -22,48 +22,75 @@
  * SOFTWARE.
  */
 
-#include <pthread.h>
 #include <stdlib.h>
 #include "linked_list.h"
 #include "ts_linked_list.h"
+#include "ts_lock.h"
 
 /**
  * Struct for the thread-safe linked list.
  */
 struct ts_linkedlist {
-    pthread_mutex_t lock;       // The lock
+    TsLock lock;                // The lock
     LinkedList *instance;       // Internal instance of LinkedList
-};
+} CACHE_ALIGNED;
 
-// Macro used for locking the list `li`
-#define LOCK(li)    pthread_mutex_lock( &((li)->lock) )
+// Macro used for locking the list `li` for writing
+#define LOCK(li)       ts_lock_write( &((li)->lock) )
+// Macro used for locking the list `li` for reading
+#define READ_LOCK(li)  ts_lock_read( &((li)->lock) )
 // Macro used for unlocking the list `li`
-#define UNLOCK(li)  pthread_mutex_unlock( &((li)->lock) )
+#define UNLOCK(li)     ts_lock_unlock( &((li)->lock) )
 
-Status ts_linkedlist_new(ConcurrentLinkedList **list) {
+Status ts_linkedlist_newWithPool(ConcurrentLinkedList **list, NodePool *pool) {
 
     ConcurrentLinkedList *temp;
     Status status;
-    pthread_mutexattr_t attr;
 
     // Allocates memory for the linkedlist
-    temp = (ConcurrentLinkedList *)malloc(sizeof(ConcurrentLinkedList));
+    temp = (ConcurrentLinkedList *)ts_lock_alloc(sizeof(ConcurrentLinkedList));
     if (temp == NULL) {
         return ALLOC_FAILURE;
     }
 
     // Creates internal instance of linked list
-    status = linkedlist_new(&(temp->instance));
+    status = linkedlist_newWithPool(&(temp->instance), pool);
+    if (status != OK) {
+        free(temp);
+        return status;
+    }
+
+    // Creates the lock with the calling thread's default lock policy
+    ts_lock_init(&(temp->lock));
+    *list = temp;
+
+    return OK;
+}
+
+Status ts_linkedlist_new(ConcurrentLinkedList **list) {
+    return ts_linkedlist_newWithPool(list, NULL);
+}
+
+Status ts_linkedlist_newUnrolled(ConcurrentLinkedList **list)
+{
+    ConcurrentLinkedList *temp;
+    Status status;
+
+    // Allocates memory for the new list
+    temp = (ConcurrentLinkedList *)ts_lock_alloc(sizeof(ConcurrentLinkedList));
+    if (temp == NULL) {
+        return ALLOC_FAILURE;
+    }
+
+    // Creates the internal list instance
+    status = linkedlist_newUnrolled(&(temp->instance));
     if (status != OK) {
         free(temp);
         return status;
     }
 
-    // Creates the pthread_mutex for locking
-    pthread_mutexattr_init(&attr);
-    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
-    pthread_mutex_init(&(temp->lock), &attr);
-    pthread_mutexattr_destroy(&attr);
+    // Creates the lock with the calling thread's default lock policy
+    ts_lock_init(&(temp->lock));
     *list = temp;
 
     return OK;
@@ -77,6 +104,14 @@ void ts_linkedlist_unlock(ConcurrentLinkedList *list) {
     UNLOCK(list);
 }
 
+void ts_linkedlist_lockRead(ConcurrentLinkedList *list) {
+    READ_LOCK(list);
+}
+
+void ts_linkedlist_lockWrite(ConcurrentLinkedList *list) {
+    LOCK(list);
+}
+
 Status ts_linkedlist_addFirst(ConcurrentLinkedList *list, void *item) {
 
     LOCK(list);
@@ -106,7 +141,7 @@ Status ts_linkedlist_insert(ConcurrentLinkedList *list, long i, void *item) {
 
 Status ts_linkedlist_first(ConcurrentLinkedList *list, void **first) {
 
-    LOCK(list);
+    READ_LOCK(list);
     Status status = linkedlist_first(list->instance, first);
     UNLOCK(list);
 
@@ -115,7 +150,7 @@ Status ts_linkedlist_first(ConcurrentLinkedList *list, void **first) {
 
 Status ts_linkedlist_last(ConcurrentLinkedList *list, void **last) {
 
-    LOCK(list);
+    READ_LOCK(list);
     Status status = linkedlist_last(list->instance, last);
     UNLOCK(list);
 
@@ -124,7 +159,7 @@ Status ts_linkedlist_last(ConcurrentLinkedList *list, void **last) {
 
 Status ts_linkedlist_get(ConcurrentLinkedList *list, long i, void **item) {
 
-    LOCK(list);
+    READ_LOCK(list);
     Status status = linkedlist_get(list->instance, i, item);
     UNLOCK(list);
 
@@ -176,7 +211,7 @@ void ts_linkedlist_clear(ConcurrentLinkedList *list, void (*destructor)(void *))
 
 long ts_linkedlist_size(ConcurrentLinkedList *list) {
 
-    LOCK(list);
+    READ_LOCK(list);
     long size = linkedlist_size(list->instance);
     UNLOCK(list);
 
@@ -185,7 +220,7 @@ long ts_linkedlist_size(ConcurrentLinkedList *list) {
 
 Boolean ts_linkedlist_isEmpty(ConcurrentLinkedList *list) {
 
-    LOCK(list);
+    READ_LOCK(list);
     Boolean isEmpty = linkedlist_isEmpty(list->instance);
     UNLOCK(list);
 
@@ -194,7 +229,7 @@ Boolean ts_linkedlist_isEmpty(ConcurrentLinkedList *list) {
 
 Status ts_linkedlist_toArray(ConcurrentLinkedList *list, Array **array) {
 
-    LOCK(list);
+    READ_LOCK(list);
     Status status = linkedlist_toArray(list->instance, array);
     UNLOCK(list);
 
@@ -207,7 +242,7 @@ Status ts_linkedlist_iterator(ConcurrentLinkedList *list, ConcurrentIterator **i
     Status status;
 
     // Creates the array of items and locks it
-    LOCK(list);
+    READ_LOCK(list);
     status = linkedlist_toArray(list->instance, &array);
     if (status != OK) {
         UNLOCK(list);
@@ -215,7 +250,8 @@ Status ts_linkedlist_iterator(ConcurrentLinkedList *list, ConcurrentIterator **i
     }
 
     // Creates the iterator
-    status = ts_iterator_new(iter, &(list->lock), array->items, array->len);
+    status = ts_iterator_newWithRelease(iter, ts_lock_release, &(list->lock),
+                                        array->items, array->len);
     if (status != OK) {
         FREE_ARRAY(array);
         UNLOCK(list);
@@ -226,11 +262,58 @@ Status ts_linkedlist_iterator(ConcurrentLinkedList *list, ConcurrentIterator **i
     return status;
 }
 
+Boolean ts_linkedlist_forEach(ConcurrentLinkedList *list, Boolean (*action)(void *, void *),
+                              void *context) {
+
+    READ_LOCK(list);
+    Boolean complete = linkedlist_forEach(list->instance, action, context);
+    UNLOCK(list);
+
+    return complete;
+}
+
+Status ts_linkedlist_snapshot(ConcurrentLinkedList *list, ConcurrentIterator **iter) {
+
+    Array *array;
+    Status status;
+
+    // Copies the items under the lock, then releases it right away
+    READ_LOCK(list);
+    status = linkedlist_toArray(list->instance, &array);
+    UNLOCK(list);
+    if (status != OK) {
+        return status;
+    }
+
+    // Creates the iterator, which holds no lock while the caller iterates
+    status = ts_iterator_newSnapshot(iter, array->items, array->len);
+    if (status != OK) {
+        FREE_ARRAY(array);
+    } else {
+        free(array);
+    }
+
+    return status;
+}
+
+long ts_linkedlist_memoryUsage(ConcurrentLinkedList *list) {
+
+    READ_LOCK(list);
+    long bytes = (long)sizeof(ConcurrentLinkedList) + linkedlist_memoryUsage(list->instance);
+    UNLOCK(list);
+
+    return bytes;
+}
+
+void ts_linkedlist_lockStats(ConcurrentLinkedList *list, LockStats *stats) {
+    ts_lock_stats(&(list->lock), stats);
+}
+
 void ts_linkedlist_destroy(ConcurrentLinkedList *list, void (*destructor)(void *)) {
 
     LOCK(list);
     linkedlist_destroy(list->instance, destructor);
     UNLOCK(list);
-    pthread_mutex_destroy(&(list->lock));
+    ts_lock_destroy(&(list->lock));
     free(list);
 }
@@ -0,0 +1,529 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2020 Cole Vikupitz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#if defined(__linux__)
+#include <linux/futex.h>
+#endif
+#include "ts_lock.h"
+
+// The USDT probes are only compiled in along with the lock stats, and where <sys/sdt.h> exists
+#if defined(CDS_LOCK_STATS) && defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define PROBE(name, lock, nanos)  DTRACE_PROBE2(cds, name, lock, nanos)
+#endif
+#endif
+#ifndef PROBE
+#define PROBE(name, lock, nanos)
+#endif
+
+// The lock policy for ADTs constructed by the current thread
+static __thread LockPolicy defaultPolicy = LOCK_MUTEX;
+// The NUMA node ADTs constructed by the current thread are allocated on, -1 if none
+static __thread int defaultNode = -1;
+
+// The mbind() policy preferring the given node, and the flag moving pages already placed elsewhere
+#define MPOL_PREFERRED 1
+#define MPOL_MF_MOVE ( 1 << 1 )
+// The highest NUMA node that can be set as a thread's default, plus one
+#define MAX_NODES 64
+
+// Number of times a thread checks a held LOCK_SPIN or LOCK_TICKET lock before it gives up the CPU
+#define SPIN_LIMIT 128
+
+// Number of slots in the table of biased readers, must be a power of 2
+#define READER_SLOTS 4096
+// Number of bits needed to index into the table of biased readers
+#define READER_BITS 12
+// Number of biased reads a thread may hold at once, further reads use the rwlock
+#define BIASED_HELD 8
+// How many times longer than the last writer waited for readers that the bias stays off
+#define BIAS_INHIBIT 9L
+
+// The table of biased readers: each slot holds the lock a reader is reading under, or NULL
+static TsLock *readers[READER_SLOTS] CACHE_ALIGNED;
+
+/**
+ * A biased read held by the calling thread.
+ */
+typedef struct {
+    TsLock *lock;       // The lock read under, NULL if the entry is unused
+    TsLock **slot;      // The slot of the table the thread holds for the lock
+    long depth;         // Number of re-entrant reads held
+} BiasedRead;
+
+// The biased reads held by the current thread
+static __thread BiasedRead biased[BIASED_HELD];
+
+// Macro hinting to the CPU that the thread is spinning, easing the wait on its sibling threads
+#if defined(__x86_64__) || defined(__i386__)
+#define CPU_RELAX()  __builtin_ia32_pause()
+#elif defined(__aarch64__)
+#define CPU_RELAX()  __asm__ __volatile__("yield")
+#else
+#define CPU_RELAX()
+#endif
+
+void ts_lock_setDefaultPolicy(LockPolicy policy) {
+    defaultPolicy = policy;
+}
+
+LockPolicy ts_lock_getDefaultPolicy(void) {
+    return defaultPolicy;
+}
+
+void ts_lock_setDefaultNode(int node) {
+    defaultNode = ( node >= 0 && node < MAX_NODES ) ? node : -1;
+}
+
+int ts_lock_getDefaultNode(void) {
+    return defaultNode;
+}
+
+void *ts_lock_alloc(size_t size) {
+
+    size_t align = CDS_CACHE_LINE;
+    size_t bytes = ( size + CDS_CACHE_LINE - 1 ) & ~((size_t)CDS_CACHE_LINE - 1);
+    void *ptr;
+
+    // Binding applies to whole pages, so the memory gets pages of its own to leave neighbours be
+    if (defaultNode >= 0) {
+        align = (size_t)sysconf(_SC_PAGESIZE);
+        bytes = ( bytes + align - 1 ) & ~(align - 1);
+    }
+    if (posix_memalign(&ptr, align, bytes) != 0) {
+        return NULL;
+    }
+
+#ifdef SYS_mbind
+    if (defaultNode >= 0) {
+        // The kernel reads one bit less than the mask holds; on failure the pages stay as they are
+        unsigned long mask = ( 1UL << defaultNode );
+        (void)syscall(SYS_mbind, ptr, bytes, MPOL_PREFERRED, &mask, 8UL * sizeof(mask) + 1UL,
+                      MPOL_MF_MOVE);
+    }
+#endif
+
+    return ptr;
+}
+
+void ts_lock_init(TsLock *lock) {
+
+    pthread_mutexattr_t attr;
+
+    lock->policy = defaultPolicy;
+    lock->depth = 0L;
+    lock->acquisitions = 0L;
+    lock->contended = 0L;
+    lock->waitNanos = 0L;
+    lock->holdNanos = 0L;
+    lock->holds = 0L;
+    lock->heldSince = 0L;
+    lock->bias = ( lock->policy == LOCK_BIASED ) ? 1 : 0;
+    lock->inhibitUntil = 0L;
+    if (lock->policy == LOCK_RWLOCK || lock->policy == LOCK_BIASED) {
+        pthread_rwlock_init(&(lock->u.rwlock), NULL);
+        return;
+    } else if (lock->policy == LOCK_NORMAL) {
+        pthread_mutex_init(&(lock->u.mutex), NULL);
+        return;
+    } else if (lock->policy == LOCK_SPIN) {
+        lock->u.futex = 0;
+        return;
+    } else if (lock->policy == LOCK_TICKET) {
+        lock->u.ticket.next = 0U;
+        lock->u.ticket.serving = 0U;
+        return;
+    }
+
+    // Creates the pthread_mutex for locking
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&(lock->u.mutex), &attr);
+    pthread_mutexattr_destroy(&attr);
+}
+
+/**
+ * Acquires the LOCK_SPIN lock `futex`, spinning while it is held, then sleeping on the futex until
+ * it is released. The lock is marked as waited on before sleeping, so that its release wakes one
+ * of the sleeping threads. Where there are no futexes, gives up the CPU between tries instead.
+ */
+static void _spin_lock(int *futex) {
+
+    int state, i;
+
+    for (i = 0; i < SPIN_LIMIT; i++) {
+        state = 0;
+        if (__atomic_load_n(futex, __ATOMIC_RELAXED) == 0 &&
+            __atomic_compare_exchange_n(futex, &state, 1, FALSE, __ATOMIC_ACQUIRE,
+                                        __ATOMIC_RELAXED)) {
+            return;
+        }
+        CPU_RELAX();
+    }
+#if defined(__linux__)
+    while (__atomic_exchange_n(futex, 2, __ATOMIC_ACQUIRE) != 0) {
+        syscall(SYS_futex, futex, FUTEX_WAIT_PRIVATE, 2, NULL, NULL, 0);
+    }
+#else
+    state = 0;
+    while (!__atomic_compare_exchange_n(futex, &state, 1, FALSE, __ATOMIC_ACQUIRE,
+                                        __ATOMIC_RELAXED)) {
+        sched_yield();
+        state = 0;
+    }
+#endif
+}
+
+/**
+ * Acquires the LOCK_TICKET lock `lock` by drawing the next ticket, then spinning until that ticket
+ * is served. The CPU is given up after every SPIN_LIMIT checks, in case the threads ahead in line
+ * are waiting for it.
+ */
+static void _ticket_lock(TsLock *lock) {
+
+    unsigned int ticket = __atomic_fetch_add(&(lock->u.ticket.next), 1U, __ATOMIC_RELAXED);
+    int spins = 0;
+
+    while (__atomic_load_n(&(lock->u.ticket.serving), __ATOMIC_ACQUIRE) != ticket) {
+        if (++spins == SPIN_LIMIT) {
+            sched_yield();
+            spins = 0;
+        } else {
+            CPU_RELAX();
+        }
+    }
+}
+
+#ifdef CDS_LOCK_STATS
+
+/**
+ * Tries to acquire `lock` exclusively without waiting, under any policy other than LOCK_MUTEX and
+ * LOCK_RWLOCK. Returns 0 if acquired, or EBUSY if the lock is held. Only used by the lock stats,
+ * to tell contended acquisitions apart.
+ */
+static int _try_exclusive(TsLock *lock) {
+
+    int state = 0;
+    unsigned int ticket;
+
+    if (lock->policy == LOCK_SPIN) {
+        return __atomic_compare_exchange_n(&(lock->u.futex), &state, 1, FALSE, __ATOMIC_ACQUIRE,
+                                           __ATOMIC_RELAXED) ? 0 : EBUSY;
+    } else if (lock->policy == LOCK_TICKET) {
+        // Only draws a ticket if it would be served right away
+        ticket = __atomic_load_n(&(lock->u.ticket.serving), __ATOMIC_RELAXED);
+        return __atomic_compare_exchange_n(&(lock->u.ticket.next), &ticket, ticket + 1U, FALSE,
+                                           __ATOMIC_ACQUIRE, __ATOMIC_RELAXED) ? 0 : EBUSY;
+    }
+    return pthread_mutex_trylock(&(lock->u.mutex));
+}
+
+#endif
+
+/**
+ * Acquires `lock` exclusively, under any policy other than LOCK_MUTEX and LOCK_RWLOCK.
+ */
+static void _lock_exclusive(TsLock *lock) {
+
+    if (lock->policy == LOCK_SPIN) {
+        _spin_lock(&(lock->u.futex));
+    } else if (lock->policy == LOCK_TICKET) {
+        _ticket_lock(lock);
+    } else {
+        pthread_mutex_lock(&(lock->u.mutex));
+    }
+}
+
+/**
+ * Releases `lock`, held exclusively under any policy other than LOCK_MUTEX and LOCK_RWLOCK.
+ */
+static void _unlock_exclusive(TsLock *lock) {
+
+    if (lock->policy == LOCK_SPIN) {
+        // Only a lock that was waited on needs the system call to wake a thread up
+        if (__atomic_exchange_n(&(lock->u.futex), 0, __ATOMIC_RELEASE) == 2) {
+#if defined(__linux__)
+            syscall(SYS_futex, &(lock->u.futex), FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+#endif
+        }
+    } else if (lock->policy == LOCK_TICKET) {
+        // Only the holder ever changes the ticket being served
+        __atomic_store_n(&(lock->u.ticket.serving), lock->u.ticket.serving + 1U,
+                         __ATOMIC_RELEASE);
+    } else {
+        pthread_mutex_unlock(&(lock->u.mutex));
+    }
+}
+
+/**
+ * Returns the current time of the monotonic clock, in nanoseconds.
+ */
+static long _now_nanos(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ( ts.tv_sec * 1000000000L ) + ts.tv_nsec;
+}
+
+#ifdef CDS_LOCK_STATS
+
+// Macro acquiring `lock` by calling `acquire` on `target`. The acquisition is counted as contended,
+// and its wait timed, if calling `try` on `target` first fails to acquire it.
+#define ACQUIRE(lock, try, acquire, target) do { \
+        long waited = 0L; \
+        if (try(target) != 0) { \
+            waited = _now_nanos(); \
+            acquire(target); \
+            waited = _now_nanos() - waited; \
+            __atomic_add_fetch(&((lock)->contended), 1L, __ATOMIC_RELAXED); \
+            __atomic_add_fetch(&((lock)->waitNanos), waited, __ATOMIC_RELAXED); \
+        } \
+        __atomic_add_fetch(&((lock)->acquisitions), 1L, __ATOMIC_RELAXED); \
+        PROBE(lock__acquired, lock, waited); \
+    } while (0)
+// Macro starting the hold time of `lock`, just acquired exclusively, unless it already was
+#define HOLD(lock) do { \
+        if ((lock)->holds++ == 0L) { \
+            (lock)->heldSince = _now_nanos(); \
+        } \
+    } while (0)
+// Macro adding to the hold time of `lock`, about to be released, once its outermost hold ends
+#define RELEASE(lock) do { \
+        if (--(lock)->holds == 0L) { \
+            long held = _now_nanos() - (lock)->heldSince; \
+            __atomic_add_fetch(&((lock)->holdNanos), held, __ATOMIC_RELAXED); \
+            PROBE(lock__released, lock, held); \
+        } \
+    } while (0)
+
+#else
+
+#define ACQUIRE(lock, try, acquire, target)  acquire(target)
+#define HOLD(lock)
+#define RELEASE(lock)
+
+#endif
+
+/**
+ * Returns TRUE if the calling thread currently holds `lock` exclusively (for writing, under
+ * LOCK_RWLOCK). Other threads may only ever observe `depth` as 0 or `owner` as some other thread,
+ * so no lock is needed.
+ */
+static Boolean _owns_write(TsLock *lock) {
+
+    if (__atomic_load_n(&(lock->depth), __ATOMIC_ACQUIRE) == 0L) {
+        return FALSE;
+    }
+    pthread_t owner = __atomic_load_n(&(lock->owner), __ATOMIC_RELAXED);
+    return pthread_equal(owner, pthread_self()) ? TRUE : FALSE;
+}
+
+/**
+ * Returns the calling thread's entry for its biased read under `lock`, or NULL if it holds none.
+ */
+static BiasedRead *_find_biased(TsLock *lock) {
+
+    int i;
+    for (i = 0; i < BIASED_HELD; i++) {
+        if (biased[i].lock == lock) {
+            return &(biased[i]);
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Acquires the LOCK_BIASED lock `lock` for reading. While the bias is on, the reader claims its
+ * slot in the table, then checks the bias again: a writer turns the bias off before it looks at
+ * the table, so either the writer sees the slot and waits, or the reader sees the bias off and
+ * backs out. Otherwise the reader takes the rwlock, turning the bias back on if it is due.
+ */
+static void _read_biased(TsLock *lock) {
+
+    BiasedRead *entry;
+    TsLock **slot, *expected = NULL;
+    uintptr_t code;
+
+    // Re-entrant reads only count, so they never wait on a writer waiting on the thread
+    if ((entry = _find_biased(lock)) != NULL) {
+        entry->depth++;
+        return;
+    }
+
+    // Pairs with the release below, so the reader sees what the last writer wrote before it
+    if (__atomic_load_n(&(lock->bias), __ATOMIC_ACQUIRE) != 0 &&
+        (entry = _find_biased(NULL)) != NULL) {
+        code = ( (uintptr_t)&biased ^ ( (uintptr_t)lock >> 6 ) ) * 0x9e3779b97f4a7c15UL;
+        slot = &(readers[code >> (64 - READER_BITS)]);
+        if (__atomic_compare_exchange_n(slot, &expected, lock, FALSE, __ATOMIC_SEQ_CST,
+                                        __ATOMIC_RELAXED)) {
+            if (__atomic_load_n(&(lock->bias), __ATOMIC_SEQ_CST) != 0) {
+                entry->lock = lock;
+                entry->slot = slot;
+                entry->depth = 1L;
+                return;
+            }
+            __atomic_store_n(slot, NULL, __ATOMIC_RELEASE);
+        }
+    }
+
+    ACQUIRE(lock, pthread_rwlock_tryrdlock, pthread_rwlock_rdlock, &(lock->u.rwlock));
+    if (__atomic_load_n(&(lock->bias), __ATOMIC_RELAXED) == 0 &&
+        _now_nanos() >= __atomic_load_n(&(lock->inhibitUntil), __ATOMIC_RELAXED)) {
+        // No writer holds the rwlock while it is read, so the bias is safe to turn on; the release
+        // passes on the last writer's changes, which this reader has seen, to the biased readers
+        __atomic_store_n(&(lock->bias), 1, __ATOMIC_RELEASE);
+    }
+}
+
+/**
+ * Turns off the bias of the LOCK_BIASED lock `lock`, held for writing by the calling thread, and
+ * waits for the biased readers to finish. The bias then stays off for BIAS_INHIBIT times as long
+ * as the wait took.
+ */
+static void _revoke_bias(TsLock *lock) {
+
+    long i, start;
+
+    if (__atomic_load_n(&(lock->bias), __ATOMIC_RELAXED) == 0) {
+        return;
+    }
+    __atomic_store_n(&(lock->bias), 0, __ATOMIC_SEQ_CST);
+    start = _now_nanos();
+    for (i = 0L; i < READER_SLOTS; i++) {
+        while (__atomic_load_n(&(readers[i]), __ATOMIC_SEQ_CST) == lock) {
+            CPU_RELAX();
+        }
+    }
+    i = _now_nanos();
+    __atomic_store_n(&(lock->inhibitUntil), i + ( i - start ) * BIAS_INHIBIT, __ATOMIC_RELAXED);
+}
+
+/**
+ * Releases one biased read of `lock` held by the calling thread, freeing its slot once the
+ * outermost read is released. Returns FALSE if the thread holds no biased read of `lock`.
+ */
+static Boolean _release_biased(TsLock *lock) {
+
+    BiasedRead *entry = _find_biased(lock);
+    if (entry == NULL) {
+        return FALSE;
+    }
+    if (--(entry->depth) == 0L) {
+        __atomic_store_n(entry->slot, NULL, __ATOMIC_RELEASE);
+        entry->lock = NULL;
+    }
+    return TRUE;
+}
+
+void ts_lock_read(TsLock *lock) {
+
+    if (lock->policy == LOCK_MUTEX) {
+        ACQUIRE(lock, pthread_mutex_trylock, pthread_mutex_lock, &(lock->u.mutex));
+        HOLD(lock);
+    } else if (_owns_write(lock) == TRUE) {
+        // Writers reading the ADT just re-enter their write lock
+        __atomic_fetch_add(&(lock->depth), 1L, __ATOMIC_RELAXED);
+    } else if (lock->policy == LOCK_RWLOCK) {
+        ACQUIRE(lock, pthread_rwlock_tryrdlock, pthread_rwlock_rdlock, &(lock->u.rwlock));
+    } else if (lock->policy == LOCK_BIASED) {
+        _read_biased(lock);
+    } else {
+        // The other policies are exclusive, so reads are writes
+        ts_lock_write(lock);
+    }
+}
+
+void ts_lock_write(TsLock *lock) {
+
+    if (lock->policy == LOCK_MUTEX) {
+        ACQUIRE(lock, pthread_mutex_trylock, pthread_mutex_lock, &(lock->u.mutex));
+        HOLD(lock);
+    } else if (_owns_write(lock) == TRUE) {
+        __atomic_fetch_add(&(lock->depth), 1L, __ATOMIC_RELAXED);
+    } else {
+        if (lock->policy == LOCK_RWLOCK || lock->policy == LOCK_BIASED) {
+            ACQUIRE(lock, pthread_rwlock_trywrlock, pthread_rwlock_wrlock, &(lock->u.rwlock));
+            _revoke_bias(lock);
+        } else {
+            ACQUIRE(lock, _try_exclusive, _lock_exclusive, lock);
+        }
+        HOLD(lock);
+        __atomic_store_n(&(lock->owner), pthread_self(), __ATOMIC_RELAXED);
+        __atomic_store_n(&(lock->depth), 1L, __ATOMIC_RELEASE);
+    }
+}
+
+void ts_lock_unlock(TsLock *lock) {
+
+    if (lock->policy == LOCK_MUTEX) {
+        RELEASE(lock);
+        pthread_mutex_unlock(&(lock->u.mutex));
+    } else if (_owns_write(lock) == TRUE) {
+        // Only releases the lock once every re-entrant acquisition is released
+        if (lock->depth == 1L) {
+            RELEASE(lock);
+            __atomic_store_n(&(lock->depth), 0L, __ATOMIC_RELEASE);
+            if (lock->policy == LOCK_RWLOCK || lock->policy == LOCK_BIASED) {
+                pthread_rwlock_unlock(&(lock->u.rwlock));
+            } else {
+                _unlock_exclusive(lock);
+            }
+        } else {
+            __atomic_fetch_sub(&(lock->depth), 1L, __ATOMIC_RELAXED);
+        }
+    } else if (lock->policy != LOCK_BIASED || _release_biased(lock) == FALSE) {
+        pthread_rwlock_unlock(&(lock->u.rwlock));
+    }
+}
+
+void ts_lock_release(void *lock) {
+    ts_lock_unlock((TsLock *)lock);
+}
+
+void ts_lock_stats(TsLock *lock, LockStats *stats) {
+
+    stats->acquisitions = __atomic_load_n(&(lock->acquisitions), __ATOMIC_RELAXED);
+    stats->contended = __atomic_load_n(&(lock->contended), __ATOMIC_RELAXED);
+    stats->waitNanos = __atomic_load_n(&(lock->waitNanos), __ATOMIC_RELAXED);
+    stats->holdNanos = __atomic_load_n(&(lock->holdNanos), __ATOMIC_RELAXED);
+}
+
+void ts_lock_destroy(TsLock *lock) {
+
+    if (lock->policy == LOCK_RWLOCK || lock->policy == LOCK_BIASED) {
+        pthread_rwlock_destroy(&(lock->u.rwlock));
+    } else if (lock->policy == LOCK_MUTEX || lock->policy == LOCK_NORMAL) {
+        pthread_mutex_destroy(&(lock->u.mutex));
+    }
+}
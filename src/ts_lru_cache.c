@@ -0,0 +1,308 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2020 Cole Vikupitz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <stdlib.h>
+#include "hashing.h"
+#include "lru_cache.h"
+#include "ts_lru_cache.h"
+#include "ts_lock.h"
+
+/**
+ * A single shard of the thread-safe cache: a cache holding a fraction of the keys, and the lock
+ * guarding it. Each shard has its cache line(s) to itself, so that threads locking neighbouring
+ * shards don't contend on the line.
+ */
+typedef struct shard {
+    TsLock lock;                // The lock
+    LruCache *instance;         // Internal instance of LruCache holding this shard's keys
+} CACHE_ALIGNED Shard;
+
+/**
+ * Struct for the thread-safe cache.
+ */
+struct ts_lru_cache {
+    uint64_t (*hash)(void *, uint64_t);     // Seeded hashing function for the keys
+    uint64_t seed;                  // The seed used for choosing a key's shard
+    Shard *shards;                  // The array of shards
+} CACHE_ALIGNED;
+
+// Number of shards the keys are split across, must be a power of 2
+#define SHARDS 16L
+// Number of bits needed to index into the shards
+#define SHARD_BITS 4
+
+// Macro used for locking the shard `s` for writing
+#define LOCK(s)       ts_lock_write( &((s)->lock) )
+// Macro used for locking the shard `s` for reading
+#define READ_LOCK(s)  ts_lock_read( &((s)->lock) )
+// Macro used for unlocking the shard `s`
+#define UNLOCK(s)     ts_lock_unlock( &((s)->lock) )
+
+// Macro returning the share of each shard in the bound `n`, rounded up, or `n` if unbounded
+#define SHARE(n)  ( ((n) <= 0L) ? (n) : ( ((n) + SHARDS - 1L) / SHARDS ) )
+
+/**
+ * Returns the shard in `cache` holding the key `key`. Hashes the key with a seed of its own, so
+ * the keys in a shard still spread over all of its buckets.
+ */
+static Shard *_shard_for(ConcurrentLruCache *cache, void *key) {
+
+    uint64_t code = cache->hash(key, cache->seed) * 0x9e3779b97f4a7c15UL;
+    return &(cache->shards[code >> (64 - SHARD_BITS)]);
+}
+
+/**
+ * Destroys the shards of `cache` that have been created so far, then frees `cache` itself.
+ */
+static void _free_cache(ConcurrentLruCache *cache, void (*valueDestructor)(void *)) {
+
+    long i;
+    for (i = 0L; i < SHARDS; i++) {
+        if (cache->shards[i].instance != NULL) {
+            lrucache_destroy(cache->shards[i].instance, valueDestructor);
+            ts_lock_destroy(&(cache->shards[i].lock));
+        }
+    }
+    free(cache->shards);
+    free(cache);
+}
+
+Status ts_lrucache_new(ConcurrentLruCache **cache, uint64_t (*hash)(void *, uint64_t),
+                       int (*keyComparator)(void *, void *), long capacity,
+                       void (*keyDestructor)(void *)) {
+
+    ConcurrentLruCache *temp;
+    Status status = OK;
+    long i;
+
+    temp = (ConcurrentLruCache *)ts_lock_alloc(sizeof(ConcurrentLruCache));
+    if (temp == NULL) {
+        return ALLOC_FAILURE;
+    }
+    temp->shards = (Shard *)ts_lock_alloc(SHARDS * sizeof(Shard));
+    if (temp->shards == NULL) {
+        free(temp);
+        return ALLOC_FAILURE;
+    }
+    temp->hash = hash;
+    temp->seed = hashing_seed();
+    for (i = 0L; i < SHARDS; i++) {
+        temp->shards[i].instance = NULL;
+    }
+
+    // Creates the cache and lock of each shard, each receiving its share of the capacity
+    for (i = 0L; i < SHARDS && status == OK; i++) {
+        status = lrucache_new(&(temp->shards[i].instance), hash, keyComparator,
+                              SHARE(capacity), keyDestructor);
+        if (status == OK) {
+            ts_lock_init(&(temp->shards[i].lock));
+        } else {
+            temp->shards[i].instance = NULL;
+        }
+    }
+    if (status != OK) {
+        _free_cache(temp, NULL);
+        return status;
+    }
+
+    *cache = temp;
+    return OK;
+}
+
+void ts_lrucache_setChargeLimit(ConcurrentLruCache *cache, long limit) {
+
+    long i;
+    for (i = 0L; i < SHARDS; i++) {
+        LOCK(&(cache->shards[i]));
+        lrucache_setChargeLimit(cache->shards[i].instance, SHARE(limit));
+        UNLOCK(&(cache->shards[i]));
+    }
+}
+
+void ts_lrucache_setEvictionListener(ConcurrentLruCache *cache,
+                                     void (*listener)(void *, void *, void *), void *context) {
+
+    long i;
+    for (i = 0L; i < SHARDS; i++) {
+        LOCK(&(cache->shards[i]));
+        lrucache_setEvictionListener(cache->shards[i].instance, listener, context);
+        UNLOCK(&(cache->shards[i]));
+    }
+}
+
+Status ts_lrucache_setFrequencyAdmission(ConcurrentLruCache *cache, Boolean enabled) {
+
+    Status status = OK;
+    long i;
+
+    for (i = 0L; i < SHARDS && status == OK; i++) {
+        LOCK(&(cache->shards[i]));
+        status = lrucache_setFrequencyAdmission(cache->shards[i].instance, enabled);
+        UNLOCK(&(cache->shards[i]));
+    }
+
+    return status;
+}
+
+Status ts_lrucache_put(ConcurrentLruCache *cache, void *key, void *value, long charge,
+                       void **previous) {
+
+    Shard *shard = _shard_for(cache, key);
+    LOCK(shard);
+    Status status = lrucache_put(shard->instance, key, value, charge, previous);
+    UNLOCK(shard);
+
+    return status;
+}
+
+Status ts_lrucache_get(ConcurrentLruCache *cache, void *key, void **value) {
+
+    Shard *shard = _shard_for(cache, key);
+    LOCK(shard);
+    Status status = lrucache_get(shard->instance, key, value);
+    UNLOCK(shard);
+
+    return status;
+}
+
+Status ts_lrucache_peek(ConcurrentLruCache *cache, void *key, void **value) {
+
+    Shard *shard = _shard_for(cache, key);
+    READ_LOCK(shard);
+    Status status = lrucache_peek(shard->instance, key, value);
+    UNLOCK(shard);
+
+    return status;
+}
+
+Boolean ts_lrucache_containsKey(ConcurrentLruCache *cache, void *key) {
+
+    Shard *shard = _shard_for(cache, key);
+    READ_LOCK(shard);
+    Boolean found = lrucache_containsKey(shard->instance, key);
+    UNLOCK(shard);
+
+    return found;
+}
+
+Status ts_lrucache_remove(ConcurrentLruCache *cache, void *key, void **value) {
+
+    Shard *shard = _shard_for(cache, key);
+    LOCK(shard);
+    Status status = lrucache_remove(shard->instance, key, value);
+    UNLOCK(shard);
+
+    return status;
+}
+
+long ts_lrucache_size(ConcurrentLruCache *cache) {
+
+    long i, size = 0L;
+    for (i = 0L; i < SHARDS; i++) {
+        READ_LOCK(&(cache->shards[i]));
+        size += lrucache_size(cache->shards[i].instance);
+        UNLOCK(&(cache->shards[i]));
+    }
+
+    return size;
+}
+
+long ts_lrucache_charge(ConcurrentLruCache *cache) {
+
+    long i, charge = 0L;
+    for (i = 0L; i < SHARDS; i++) {
+        READ_LOCK(&(cache->shards[i]));
+        charge += lrucache_charge(cache->shards[i].instance);
+        UNLOCK(&(cache->shards[i]));
+    }
+
+    return charge;
+}
+
+void ts_lrucache_stats(ConcurrentLruCache *cache, CacheStats *stats) {
+
+    CacheStats shard;
+    long i;
+
+    stats->hits = stats->misses = stats->evictions = stats->rejections = 0L;
+    for (i = 0L; i < SHARDS; i++) {
+        READ_LOCK(&(cache->shards[i]));
+        lrucache_stats(cache->shards[i].instance, &shard);
+        UNLOCK(&(cache->shards[i]));
+        stats->hits += shard.hits;
+        stats->misses += shard.misses;
+        stats->evictions += shard.evictions;
+        stats->rejections += shard.rejections;
+    }
+}
+
+void ts_lrucache_clear(ConcurrentLruCache *cache, void (*valueDestructor)(void *)) {
+
+    long i;
+    for (i = 0L; i < SHARDS; i++) {
+        LOCK(&(cache->shards[i]));
+        lrucache_clear(cache->shards[i].instance, valueDestructor);
+        UNLOCK(&(cache->shards[i]));
+    }
+}
+
+long ts_lrucache_memoryUsage(ConcurrentLruCache *cache) {
+
+    long i, bytes = (long)sizeof(ConcurrentLruCache) + SHARDS * (long)sizeof(Shard);
+    for (i = 0L; i < SHARDS; i++) {
+        READ_LOCK(&(cache->shards[i]));
+        bytes += lrucache_memoryUsage(cache->shards[i].instance);
+        UNLOCK(&(cache->shards[i]));
+    }
+
+    return bytes;
+}
+
+void ts_lrucache_lockStats(ConcurrentLruCache *cache, LockStats *stats) {
+
+    LockStats shard;
+    long i;
+
+    stats->acquisitions = stats->contended = stats->waitNanos = stats->holdNanos = 0L;
+    for (i = 0L; i < SHARDS; i++) {
+        ts_lock_stats(&(cache->shards[i].lock), &shard);
+        stats->acquisitions += shard.acquisitions;
+        stats->contended += shard.contended;
+        stats->waitNanos += shard.waitNanos;
+        stats->holdNanos += shard.holdNanos;
+    }
+}
+
+void ts_lrucache_destroy(ConcurrentLruCache *cache, void (*valueDestructor)(void *)) {
+
+    long i;
+    for (i = 0L; i < SHARDS; i++) {
+        LOCK(&(cache->shards[i]));
+    }
+    for (i = SHARDS - 1L; i >= 0L; i--) {
+        UNLOCK(&(cache->shards[i]));
+    }
+    _free_cache(cache, valueDestructor);
+}
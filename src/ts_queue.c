@@ -22,48 +22,75 @@
  * SOFTWARE.
  */
 
-#include <pthread.h>
 #include <stdlib.h>
 #include "queue.h"
 #include "ts_queue.h"
+#include "ts_lock.h"
 
 /**
  * Struct for the thread-safe queue.
  */
 struct ts_queue {
-    pthread_mutex_t lock;       // The lock
+    TsLock lock;                // The lock
     Queue *instance;            // Internal instance of Queue
-};
+} CACHE_ALIGNED;
 
-// Macro used for locking the queue `q`
-#define LOCK(q)    pthread_mutex_lock( &((q)->lock) )
+// Macro used for locking the queue `q` for writing
+#define LOCK(q)       ts_lock_write( &((q)->lock) )
+// Macro used for locking the queue `q` for reading
+#define READ_LOCK(q)  ts_lock_read( &((q)->lock) )
 // Macro used for unlocking the queue `q`
-#define UNLOCK(q)  pthread_mutex_unlock( &((q)->lock) )
+#define UNLOCK(q)     ts_lock_unlock( &((q)->lock) )
+
+Status ts_queue_newWithPool(ConcurrentQueue **queue, NodePool *pool) {
+
+    ConcurrentQueue *temp;
+    Status status;
+
+    // Allocates memory for the new queue
+    temp = (ConcurrentQueue *)ts_lock_alloc(sizeof(ConcurrentQueue));
+    if (temp == NULL) {
+        return ALLOC_FAILURE;
+    }
+
+    // Creates the internal queue instance
+    status = queue_newWithPool(&(temp->instance), pool);
+    if (status != OK) {
+        free(temp);
+        return status;
+    }
+
+    // Creates the lock with the calling thread's default lock policy
+    ts_lock_init(&(temp->lock));
+    *queue = temp;
+
+    return OK;
+}
 
 Status ts_queue_new(ConcurrentQueue **queue) {
+    return ts_queue_newWithPool(queue, NULL);
+}
 
+Status ts_queue_newUnrolled(ConcurrentQueue **queue)
+{
     ConcurrentQueue *temp;
     Status status;
-    pthread_mutexattr_t attr;
 
     // Allocates memory for the new queue
-    temp = (ConcurrentQueue *)malloc(sizeof(ConcurrentQueue));
+    temp = (ConcurrentQueue *)ts_lock_alloc(sizeof(ConcurrentQueue));
     if (temp == NULL) {
         return ALLOC_FAILURE;
     }
 
     // Creates the internal queue instance
-    status = queue_new(&(temp->instance));
+    status = queue_newUnrolled(&(temp->instance));
     if (status != OK) {
         free(temp);
         return status;
     }
 
-    // Creates pthread_mutex for locking
-    pthread_mutexattr_init(&attr);
-    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
-    pthread_mutex_init(&(temp->lock), &attr);
-    pthread_mutexattr_destroy(&attr);
+    // Creates the lock with the calling thread's default lock policy
+    ts_lock_init(&(temp->lock));
     *queue = temp;
 
     return OK;
@@ -77,6 +104,14 @@ void ts_queue_unlock(ConcurrentQueue *queue) {
     UNLOCK(queue);
 }
 
+void ts_queue_lockRead(ConcurrentQueue *queue) {
+    READ_LOCK(queue);
+}
+
+void ts_queue_lockWrite(ConcurrentQueue *queue) {
+    LOCK(queue);
+}
+
 Status ts_queue_add(ConcurrentQueue *queue, void *item) {
 
     LOCK(queue);
@@ -86,9 +121,18 @@ Status ts_queue_add(ConcurrentQueue *queue, void *item) {
     return status;
 }
 
-Status ts_queue_peek(ConcurrentQueue *queue, void **first) {
+Status ts_queue_addAll(ConcurrentQueue *queue, void **items, long n) {
 
     LOCK(queue);
+    Status status = queue_addAll(queue->instance, items, n);
+    UNLOCK(queue);
+
+    return status;
+}
+
+Status ts_queue_peek(ConcurrentQueue *queue, void **first) {
+
+    READ_LOCK(queue);
     Status status = queue_peek(queue->instance, first);
     UNLOCK(queue);
 
@@ -104,6 +148,15 @@ Status ts_queue_poll(ConcurrentQueue *queue, void **first) {
     return status;
 }
 
+long ts_queue_pollMany(ConcurrentQueue *queue, void **items, long max) {
+
+    LOCK(queue);
+    long removed = queue_pollMany(queue->instance, items, max);
+    UNLOCK(queue);
+
+    return removed;
+}
+
 void ts_queue_clear(ConcurrentQueue *queue, void (*destructor)(void *)) {
 
     LOCK(queue);
@@ -113,7 +166,7 @@ void ts_queue_clear(ConcurrentQueue *queue, void (*destructor)(void *)) {
 
 long ts_queue_size(ConcurrentQueue *queue) {
 
-    LOCK(queue);
+    READ_LOCK(queue);
     long size = queue_size(queue->instance);
     UNLOCK(queue);
 
@@ -122,7 +175,7 @@ long ts_queue_size(ConcurrentQueue *queue) {
 
 Boolean ts_queue_isEmpty(ConcurrentQueue *queue) {
 
-    LOCK(queue);
+    READ_LOCK(queue);
     Boolean isEmpty = queue_isEmpty(queue->instance);
     UNLOCK(queue);
 
@@ -131,7 +184,7 @@ Boolean ts_queue_isEmpty(ConcurrentQueue *queue) {
 
 Status ts_queue_toArray(ConcurrentQueue *queue, Array **array) {
 
-    LOCK(queue);
+    READ_LOCK(queue);
     Status status = queue_toArray(queue->instance, array);
     UNLOCK(queue);
 
@@ -144,7 +197,7 @@ Status ts_queue_iterator(ConcurrentQueue *queue, ConcurrentIterator **iter) {
     Status status;
 
     // Creates array of items and locks it
-    LOCK(queue);
+    READ_LOCK(queue);
     status = queue_toArray(queue->instance, &array);
     if (status != OK) {
         UNLOCK(queue);
@@ -152,7 +205,8 @@ Status ts_queue_iterator(ConcurrentQueue *queue, ConcurrentIterator **iter) {
     }
 
     // Creates the iterator
-    status = ts_iterator_new(iter, &(queue->lock), array->items, array->len);
+    status = ts_iterator_newWithRelease(iter, ts_lock_release, &(queue->lock),
+                                        array->items, array->len);
     if (status != OK) {
         FREE_ARRAY(array);
         UNLOCK(queue);
@@ -163,11 +217,57 @@ Status ts_queue_iterator(ConcurrentQueue *queue, ConcurrentIterator **iter) {
     return status;
 }
 
+Boolean ts_queue_forEach(ConcurrentQueue *queue, Boolean (*action)(void *, void *), void *context) {
+
+    READ_LOCK(queue);
+    Boolean complete = queue_forEach(queue->instance, action, context);
+    UNLOCK(queue);
+
+    return complete;
+}
+
+Status ts_queue_snapshot(ConcurrentQueue *queue, ConcurrentIterator **iter) {
+
+    Array *array;
+    Status status;
+
+    // Copies the items under the lock, then releases it right away
+    READ_LOCK(queue);
+    status = queue_toArray(queue->instance, &array);
+    UNLOCK(queue);
+    if (status != OK) {
+        return status;
+    }
+
+    // Creates the iterator, which holds no lock while the caller iterates
+    status = ts_iterator_newSnapshot(iter, array->items, array->len);
+    if (status != OK) {
+        FREE_ARRAY(array);
+    } else {
+        free(array);
+    }
+
+    return status;
+}
+
+long ts_queue_memoryUsage(ConcurrentQueue *queue) {
+
+    READ_LOCK(queue);
+    long bytes = (long)sizeof(ConcurrentQueue) + queue_memoryUsage(queue->instance);
+    UNLOCK(queue);
+
+    return bytes;
+}
+
+void ts_queue_lockStats(ConcurrentQueue *queue, LockStats *stats) {
+    ts_lock_stats(&(queue->lock), stats);
+}
+
 void ts_queue_destroy(ConcurrentQueue *queue, void (*destructor)(void *)) {
 
     LOCK(queue);
     queue_destroy(queue->instance, destructor);
     UNLOCK(queue);
-    pthread_mutex_destroy(&(queue->lock));
+    ts_lock_destroy(&(queue->lock));
     free(queue);
 }
@@ -22,53 +22,55 @@
  * SOFTWARE.
  */
 
-#include <pthread.h>
 #include <stdlib.h>
 #include "stack.h"
 #include "ts_stack.h"
+#include "ts_lock.h"
 
 /**
  * Struct for the thread-safe stack.
  */
 struct ts_stack {
-    pthread_mutex_t lock;       // The lock
+    TsLock lock;                // The lock
     Stack *instance;            // Internal instance of Stack.
-};
+} CACHE_ALIGNED;
 
-// Macro used for locking the stack `s`
-#define LOCK(s)    pthread_mutex_lock( &((s)->lock) )
+// Macro used for locking the stack `s` for writing
+#define LOCK(s)       ts_lock_write( &((s)->lock) )
+// Macro used for locking the stack `s` for reading
+#define READ_LOCK(s)  ts_lock_read( &((s)->lock) )
 // Macro used for unlocking the stack `s`
-#define UNLOCK(s)  pthread_mutex_unlock( &((s)->lock) )
+#define UNLOCK(s)     ts_lock_unlock( &((s)->lock) )
 
-Status ts_stack_new(ConcurrentStack **stack) {
+Status ts_stack_newWithPool(ConcurrentStack **stack, NodePool *pool) {
 
     ConcurrentStack *temp;
     Status status;
-    pthread_mutexattr_t attr;
 
     // Allocates memory for the stack
-    temp = (ConcurrentStack *)malloc(sizeof(ConcurrentStack));
+    temp = (ConcurrentStack *)ts_lock_alloc(sizeof(ConcurrentStack));
     if (temp == NULL) {
         return ALLOC_FAILURE;
     }
 
     // Creates the internal instance of the stack
-    status = stack_new(&(temp->instance));
+    status = stack_newWithPool(&(temp->instance), pool);
     if (status != OK) {
         free(temp);
         return status;
     }
 
-    // Creates the pthread_mutex for locking
-    pthread_mutexattr_init(&attr);
-    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
-    pthread_mutex_init(&(temp->lock), &attr);
-    pthread_mutexattr_destroy(&attr);
+    // Creates the lock with the calling thread's default lock policy
+    ts_lock_init(&(temp->lock));
     *stack = temp;
 
     return OK;
 }
 
+Status ts_stack_new(ConcurrentStack **stack) {
+    return ts_stack_newWithPool(stack, NULL);
+}
+
 void ts_stack_lock(ConcurrentStack *stack) {
     LOCK(stack);
 }
@@ -77,6 +79,14 @@ void ts_stack_unlock(ConcurrentStack *stack) {
     UNLOCK(stack);
 }
 
+void ts_stack_lockRead(ConcurrentStack *stack) {
+    READ_LOCK(stack);
+}
+
+void ts_stack_lockWrite(ConcurrentStack *stack) {
+    LOCK(stack);
+}
+
 Status ts_stack_push(ConcurrentStack *stack, void *item) {
 
     LOCK(stack);
@@ -86,9 +96,18 @@ Status ts_stack_push(ConcurrentStack *stack, void *item) {
     return status;
 }
 
-Status ts_stack_peek(ConcurrentStack *stack, void **top) {
+Status ts_stack_pushAll(ConcurrentStack *stack, void **items, long n) {
 
     LOCK(stack);
+    Status status = stack_pushAll(stack->instance, items, n);
+    UNLOCK(stack);
+
+    return status;
+}
+
+Status ts_stack_peek(ConcurrentStack *stack, void **top) {
+
+    READ_LOCK(stack);
     Status status = stack_peek(stack->instance, top);
     UNLOCK(stack);
 
@@ -104,6 +123,15 @@ Status ts_stack_pop(ConcurrentStack *stack, void **top) {
     return status;
 }
 
+long ts_stack_popMany(ConcurrentStack *stack, void **items, long max) {
+
+    LOCK(stack);
+    long popped = stack_popMany(stack->instance, items, max);
+    UNLOCK(stack);
+
+    return popped;
+}
+
 void ts_stack_clear(ConcurrentStack *stack, void (*destructor)(void *)) {
 
     LOCK(stack);
@@ -113,7 +141,7 @@ void ts_stack_clear(ConcurrentStack *stack, void (*destructor)(void *)) {
 
 long ts_stack_size(ConcurrentStack *stack) {
 
-    LOCK(stack);
+    READ_LOCK(stack);
     long size = stack_size(stack->instance);
     UNLOCK(stack);
 
@@ -122,7 +150,7 @@ long ts_stack_size(ConcurrentStack *stack) {
 
 Boolean ts_stack_isEmpty(ConcurrentStack *stack) {
 
-    LOCK(stack);
+    READ_LOCK(stack);
     Boolean isEmpty = stack_isEmpty(stack->instance);
     UNLOCK(stack);
 
@@ -131,7 +159,7 @@ Boolean ts_stack_isEmpty(ConcurrentStack *stack) {
 
 Status ts_stack_toArray(ConcurrentStack *stack, Array **array) {
 
-    LOCK(stack);
+    READ_LOCK(stack);
     Status status = stack_toArray(stack->instance, array);
     UNLOCK(stack);
 
@@ -144,7 +172,7 @@ Status ts_stack_iterator(ConcurrentStack *stack, ConcurrentIterator **iter) {
     Status status;
 
     // Creates the array of items and locks it
-    LOCK(stack);
+    READ_LOCK(stack);
     status = stack_toArray(stack->instance, &array);
     if (status != OK) {
         UNLOCK(stack);
@@ -152,7 +180,8 @@ Status ts_stack_iterator(ConcurrentStack *stack, ConcurrentIterator **iter) {
     }
 
     // Creates the iterator
-    status = ts_iterator_new(iter, &(stack->lock), array->items, array->len);
+    status = ts_iterator_newWithRelease(iter, ts_lock_release, &(stack->lock),
+                                        array->items, array->len);
     if (status != OK) {
         FREE_ARRAY(array);
         UNLOCK(stack);
@@ -163,11 +192,57 @@ Status ts_stack_iterator(ConcurrentStack *stack, ConcurrentIterator **iter) {
     return status;
 }
 
+Boolean ts_stack_forEach(ConcurrentStack *stack, Boolean (*action)(void *, void *), void *context) {
+
+    READ_LOCK(stack);
+    Boolean complete = stack_forEach(stack->instance, action, context);
+    UNLOCK(stack);
+
+    return complete;
+}
+
+Status ts_stack_snapshot(ConcurrentStack *stack, ConcurrentIterator **iter) {
+
+    Array *array;
+    Status status;
+
+    // Copies the items under the lock, then releases it right away
+    READ_LOCK(stack);
+    status = stack_toArray(stack->instance, &array);
+    UNLOCK(stack);
+    if (status != OK) {
+        return status;
+    }
+
+    // Creates the iterator, which holds no lock while the caller iterates
+    status = ts_iterator_newSnapshot(iter, array->items, array->len);
+    if (status != OK) {
+        FREE_ARRAY(array);
+    } else {
+        free(array);
+    }
+
+    return status;
+}
+
+long ts_stack_memoryUsage(ConcurrentStack *stack) {
+
+    READ_LOCK(stack);
+    long bytes = (long)sizeof(ConcurrentStack) + stack_memoryUsage(stack->instance);
+    UNLOCK(stack);
+
+    return bytes;
+}
+
+void ts_stack_lockStats(ConcurrentStack *stack, LockStats *stats) {
+    ts_lock_stats(&(stack->lock), stats);
+}
+
 void ts_stack_destroy(ConcurrentStack *stack, void (*destructor)(void *)) {
 
     LOCK(stack);
     stack_destroy(stack->instance, destructor);
     UNLOCK(stack);
-    pthread_mutex_destroy(&(stack->lock));
+    ts_lock_destroy(&(stack->lock));
     free(stack);
 }
@@ -19,32 +19,87 @@
  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 
-#include <pthread.h>
+#include <sched.h>
 #include <stdlib.h>
+#include <string.h>
 #include "string_builder.h"
 #include "ts_string_builder.h"
+#include "ts_lock.h"
 
 /**
  * Struct for the thread-safe string builder.
  */
 struct ts_string_builder {
-    pthread_mutex_t lock;
+    TsLock lock;
     StringBuilder *instance;
-};
+    char *window CACHE_ALIGNED; // Room after the builder's end open to shared appends, or NULL
+    long room;          // The number of characters the window can hold
+    long reserved;      // The number of characters reserved in the window so far
+    long active;        // The number of shared appends currently copying into the window
+    int open;           // Non-zero while shared appends may reserve room in the window
+} CACHE_ALIGNED;
 
-// Macro used for locking the string builder `s`
-#define LOCK(s)    pthread_mutex_lock( &((s)->lock) )
+// The smallest window to open for shared appends, so that the lock is rarely needed to grow it
+#define SHARED_WINDOW 65536L
+
+/**
+ * Stops new shared appends from reserving room in the builder's window, waits for those still
+ * copying into it to finish, and then adds the characters reserved to the builder. The window is
+ * left open if `reopen` is TRUE, minus the room just used up, or is closed otherwise. The caller
+ * must hold the lock for writing.
+ */
+static void _fold_window(ConcurrentStringBuilder *builder, Boolean reopen) {
+
+    if (builder->window == NULL) {
+        return;
+    }
+
+    __atomic_store_n(&(builder->open), 0, __ATOMIC_SEQ_CST);
+    while (__atomic_load_n(&(builder->active), __ATOMIC_SEQ_CST) != 0L) {
+        sched_yield();
+    }
+
+    long reserved = __atomic_load_n(&(builder->reserved), __ATOMIC_RELAXED);
+    (void)string_builder_commitTail(builder->instance, reserved);
+    __atomic_store_n(&(builder->reserved), 0L, __ATOMIC_RELAXED);
+    if (reopen == TRUE && builder->room > reserved) {
+        builder->window += reserved;
+        builder->room -= reserved;
+        __atomic_store_n(&(builder->open), 1, __ATOMIC_SEQ_CST);
+    } else {
+        builder->window = NULL;
+        builder->room = 0L;
+    }
+}
+
+/**
+ * Locks the builder for reading, first taking the lock for writing to add any characters reserved
+ * by shared appends, so that the reader sees them.
+ */
+static void _lock_read(ConcurrentStringBuilder *builder) {
+
+    if (__atomic_load_n(&(builder->reserved), __ATOMIC_SEQ_CST) != 0L) {
+        ts_lock_write(&(builder->lock));
+        _fold_window(builder, TRUE);
+        ts_lock_unlock(&(builder->lock));
+    }
+    ts_lock_read(&(builder->lock));
+}
+
+// Macro used for locking the string builder `s` for writing, closing its shared append window
+#define LOCK(s)       { ts_lock_write( &((s)->lock) ); _fold_window((s), FALSE); }
+// Macro used for locking the string builder `s` for reading
+#define READ_LOCK(s)  _lock_read(s)
 // Macro used for unlocking the string builder `s`
-#define UNLOCK(s)  pthread_mutex_unlock( &((s)->lock) )
+#define UNLOCK(s)     ts_lock_unlock( &((s)->lock) )
 
 Status ts_string_builder_new(ConcurrentStringBuilder **builder, long capacity, float growthFactor,
                              char *str) {
 
     ConcurrentStringBuilder *temp;
     Status status;
-    pthread_mutexattr_t attr;
 
-    temp = (ConcurrentStringBuilder *)malloc(sizeof(ConcurrentStringBuilder));
+    temp = (ConcurrentStringBuilder *)ts_lock_alloc(sizeof(ConcurrentStringBuilder));
     if (temp == NULL) {
         return ALLOC_FAILURE;
     }
@@ -55,11 +110,41 @@ Status ts_string_builder_new(ConcurrentStringBuilder **builder, long capacity, f
         return status;
     }
 
-    /* Creates the pthread_mutex for locking */
-    pthread_mutexattr_init(&attr);
-    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
-    pthread_mutex_init(&(temp->lock), &attr);
-    pthread_mutexattr_destroy(&attr);
+    /* Creates the lock with the calling thread's default lock policy */
+    ts_lock_init(&(temp->lock));
+    temp->window = NULL;
+    temp->room = 0L;
+    temp->reserved = 0L;
+    temp->active = 0L;
+    temp->open = 0;
+    *builder = temp;
+
+    return OK;
+}
+
+Status ts_string_builder_newRope(ConcurrentStringBuilder **builder, char *str) {
+
+    ConcurrentStringBuilder *temp;
+    Status status;
+
+    temp = (ConcurrentStringBuilder *)ts_lock_alloc(sizeof(ConcurrentStringBuilder));
+    if (temp == NULL) {
+        return ALLOC_FAILURE;
+    }
+
+    status = string_builder_newRope(&(temp->instance), str);
+    if (status != OK) {
+        free(temp);
+        return status;
+    }
+
+    /* Creates the lock with the calling thread's default lock policy */
+    ts_lock_init(&(temp->lock));
+    temp->window = NULL;
+    temp->room = 0L;
+    temp->reserved = 0L;
+    temp->active = 0L;
+    temp->open = 0;
     *builder = temp;
 
     return OK;
@@ -73,6 +158,14 @@ void ts_string_builder_unlock(ConcurrentStringBuilder *builder) {
     UNLOCK(builder);
 }
 
+void ts_string_builder_lockRead(ConcurrentStringBuilder *builder) {
+    READ_LOCK(builder);
+}
+
+void ts_string_builder_lockWrite(ConcurrentStringBuilder *builder) {
+    LOCK(builder);
+}
+
 Status ts_string_builder_appendChar(ConcurrentStringBuilder *builder, char ch) {
 
     LOCK(builder);
@@ -91,6 +184,16 @@ Status ts_string_builder_appendStr(ConcurrentStringBuilder *builder, char *str)
     return status;
 }
 
+Status ts_string_builder_appendBytes(ConcurrentStringBuilder *builder, const char *bytes,
+                                     long len) {
+
+    LOCK(builder);
+    Status status = string_builder_appendBytes(builder->instance, bytes, len);
+    UNLOCK(builder);
+
+    return status;
+}
+
 Status ts_string_builder_appendBoolean(ConcurrentStringBuilder *builder, Boolean b) {
 
     LOCK(builder);
@@ -169,7 +272,7 @@ Status ts_string_builder_appendStrBuilder(ConcurrentStringBuilder *builder,
                                           ConcurrentStringBuilder *other) {
 
     LOCK(builder);
-    LOCK(other);
+    READ_LOCK(other);
     Status status = string_builder_appendStrBuilder(builder->instance, other->instance);
     UNLOCK(other);
     UNLOCK(builder);
@@ -177,6 +280,70 @@ Status ts_string_builder_appendStrBuilder(ConcurrentStringBuilder *builder,
     return status;
 }
 
+Status ts_string_builder_appendAll(ConcurrentStringBuilder *builder, char **strs, long count) {
+
+    LOCK(builder);
+    Status status = string_builder_appendAll(builder->instance, strs, count);
+    UNLOCK(builder);
+
+    return status;
+}
+
+/**
+ * Attempts to reserve `len` characters of room in the builder's window and copy `bytes` into it,
+ * without taking the lock. Returns FALSE if the window is closed or too small.
+ */
+static Boolean _append_shared(ConcurrentStringBuilder *builder, const char *bytes, long len) {
+
+    Boolean appended = FALSE;
+    long offset;
+
+    // Announces the append before checking the window, so that a closing writer waits for it
+    __atomic_add_fetch(&(builder->active), 1L, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&(builder->open), __ATOMIC_SEQ_CST) != 0) {
+        offset = __atomic_load_n(&(builder->reserved), __ATOMIC_RELAXED);
+        while (offset + len <= builder->room) {
+            if (__atomic_compare_exchange_n(&(builder->reserved), &offset, offset + len, TRUE,
+                                            __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+                memcpy(builder->window + offset, bytes, len * sizeof(char));
+                appended = TRUE;
+                break;
+            }
+        }
+    }
+    __atomic_sub_fetch(&(builder->active), 1L, __ATOMIC_RELEASE);
+
+    return appended;
+}
+
+Status ts_string_builder_appendShared(ConcurrentStringBuilder *builder, const char *bytes,
+                                      long len) {
+
+    if (len < 0L) {
+        return INVALID_INDEX;
+    } else if (_append_shared(builder, bytes, len) == TRUE) {
+        return OK;
+    }
+
+    // The window is full (or closed), so appends under the lock and opens a larger window after
+    LOCK(builder);
+    Status status = string_builder_appendBytes(builder->instance, bytes, len);
+    if (status == OK) {
+        long want = ( string_builder_length(builder->instance) / 4L );
+        want = ( want > SHARED_WINDOW ) ? want : SHARED_WINDOW;
+        want = ( want > len ) ? want : len;
+        if (string_builder_reserveTail(builder->instance, want, &(builder->window),
+                                       &(builder->room)) == OK) {
+            __atomic_store_n(&(builder->open), 1, __ATOMIC_SEQ_CST);
+        } else {
+            builder->window = NULL;
+        }
+    }
+    UNLOCK(builder);
+
+    return status;
+}
+
 Status ts_string_builder_insertChar(ConcurrentStringBuilder *builder, long offset, char ch) {
 
     LOCK(builder);
@@ -195,6 +362,16 @@ Status ts_string_builder_insertStr(ConcurrentStringBuilder *builder, long offset
     return status;
 }
 
+Status ts_string_builder_insertBytes(ConcurrentStringBuilder *builder, long offset,
+                                     const char *bytes, long len) {
+
+    LOCK(builder);
+    Status status = string_builder_insertBytes(builder->instance, offset, bytes, len);
+    UNLOCK(builder);
+
+    return status;
+}
+
 Status ts_string_builder_insertBoolean(ConcurrentStringBuilder *builder, long offset, Boolean b) {
 
     LOCK(builder);
@@ -293,7 +470,7 @@ Status ts_string_builder_replace(ConcurrentStringBuilder *builder, long start, l
 
 Status ts_string_builder_charAt(ConcurrentStringBuilder *builder, long i, char *result) {
 
-    LOCK(builder);
+    READ_LOCK(builder);
     Status status = string_builder_charAt(builder->instance, i, result);
     UNLOCK(builder);
 
@@ -302,7 +479,7 @@ Status ts_string_builder_charAt(ConcurrentStringBuilder *builder, long i, char *
 
 Status ts_string_builder_substring(ConcurrentStringBuilder *builder, long start, char **result) {
 
-    LOCK(builder);
+    READ_LOCK(builder);
 
     Status status = string_builder_substring(builder->instance, start, result);
     UNLOCK(builder);
@@ -313,7 +490,7 @@ Status ts_string_builder_substring(ConcurrentStringBuilder *builder, long start,
 Status ts_string_builder_subsequence(ConcurrentStringBuilder *builder, long start, long end,
                                      char **result) {
 
-    LOCK(builder);
+    READ_LOCK(builder);
     Status status = string_builder_subsequence(builder->instance, start, end, result);
     UNLOCK(builder);
 
@@ -323,7 +500,7 @@ Status ts_string_builder_subsequence(ConcurrentStringBuilder *builder, long star
 Status ts_string_builder_getChars(ConcurrentStringBuilder *builder, long srcBegin, long srcEnd,
                                   char dst[], int dstBegin) {
 
-    LOCK(builder);
+    READ_LOCK(builder);
     Status status = string_builder_getChars(builder->instance, srcBegin, srcEnd, dst, dstBegin);
     UNLOCK(builder);
 
@@ -350,7 +527,7 @@ Status ts_string_builder_setLength(ConcurrentStringBuilder *builder, long len, c
 
 long ts_string_builder_indexOf(ConcurrentStringBuilder *builder, char *str) {
 
-    LOCK(builder);
+    READ_LOCK(builder);
     long idx = string_builder_indexOf(builder->instance, str);
     UNLOCK(builder);
 
@@ -359,7 +536,7 @@ long ts_string_builder_indexOf(ConcurrentStringBuilder *builder, char *str) {
 
 long ts_string_builder_indexOfFrom(ConcurrentStringBuilder *builder, char *str, long fromIndex) {
 
-    LOCK(builder);
+    READ_LOCK(builder);
     long idx = string_builder_indexOfFrom(builder->instance, str, fromIndex);
     UNLOCK(builder);
 
@@ -368,7 +545,7 @@ long ts_string_builder_indexOfFrom(ConcurrentStringBuilder *builder, char *str,
 
 long ts_string_builder_lastIndexOf(ConcurrentStringBuilder *builder, char *str) {
 
-    LOCK(builder);
+    READ_LOCK(builder);
     long idx = string_builder_lastIndexOf(builder->instance, str);
     UNLOCK(builder);
 
@@ -378,7 +555,7 @@ long ts_string_builder_lastIndexOf(ConcurrentStringBuilder *builder, char *str)
 long ts_string_builder_lastIndexOfFrom(ConcurrentStringBuilder *builder, char *str, long fromIndex)
 {
 
-    LOCK(builder);
+    READ_LOCK(builder);
     long idx = string_builder_lastIndexOfFrom(builder->instance, str, fromIndex);
     UNLOCK(builder);
 
@@ -387,8 +564,13 @@ long ts_string_builder_lastIndexOfFrom(ConcurrentStringBuilder *builder, char *s
 
 int ts_string_builder_compareTo(ConcurrentStringBuilder *builder, ConcurrentStringBuilder *other) {
 
-    LOCK(builder);
-    LOCK(other);
+    // The same builder would otherwise be locked twice for reading
+    if (builder == other) {
+        return 0;
+    }
+
+    READ_LOCK(builder);
+    READ_LOCK(other);
     int result = string_builder_compareTo(builder->instance, other->instance);
     UNLOCK(other);
     UNLOCK(builder);
@@ -448,7 +630,7 @@ void ts_string_builder_clear(ConcurrentStringBuilder *builder) {
 
 long ts_string_builder_length(ConcurrentStringBuilder *builder) {
 
-    LOCK(builder);
+    READ_LOCK(builder);
     long len = string_builder_length(builder->instance);
     UNLOCK(builder);
 
@@ -457,7 +639,7 @@ long ts_string_builder_length(ConcurrentStringBuilder *builder) {
 
 long ts_string_builder_capacity(ConcurrentStringBuilder *builder) {
 
-    LOCK(builder);
+    READ_LOCK(builder);
     long capacity = string_builder_capacity(builder->instance);
     UNLOCK(builder);
 
@@ -466,18 +648,68 @@ long ts_string_builder_capacity(ConcurrentStringBuilder *builder) {
 
 Status ts_string_builder_toString(ConcurrentStringBuilder *builder, char **result) {
 
-    LOCK(builder);
+    READ_LOCK(builder);
     Status status = string_builder_toString(builder->instance, result);
     UNLOCK(builder);
 
     return status;
 }
 
+Status ts_string_builder_appendFromFd(ConcurrentStringBuilder *builder, int fd, long max) {
+
+    LOCK(builder);
+    Status status = string_builder_appendFromFd(builder->instance, fd, max);
+    UNLOCK(builder);
+
+    return status;
+}
+
+Status ts_string_builder_appendFile(ConcurrentStringBuilder *builder, const char *path) {
+
+    LOCK(builder);
+    Status status = string_builder_appendFile(builder->instance, path);
+    UNLOCK(builder);
+
+    return status;
+}
+
+Status ts_string_builder_writeTo(ConcurrentStringBuilder *builder, int fd) {
+
+    READ_LOCK(builder);
+    Status status = string_builder_writeTo(builder->instance, fd);
+    UNLOCK(builder);
+
+    return status;
+}
+
+Status ts_string_builder_detach(ConcurrentStringBuilder *builder, char **result) {
+
+    LOCK(builder);
+    Status status = string_builder_detach(builder->instance, result);
+    UNLOCK(builder);
+
+    return status;
+}
+
+long ts_string_builder_memoryUsage(ConcurrentStringBuilder *builder) {
+
+    READ_LOCK(builder);
+    long bytes = (long)sizeof(ConcurrentStringBuilder);
+    bytes += string_builder_memoryUsage(builder->instance);
+    UNLOCK(builder);
+
+    return bytes;
+}
+
+void ts_string_builder_lockStats(ConcurrentStringBuilder *builder, LockStats *stats) {
+    ts_lock_stats(&(builder->lock), stats);
+}
+
 void ts_string_builder_destroy(ConcurrentStringBuilder *builder) {
 
     LOCK(builder);
     string_builder_destroy(builder->instance);
     UNLOCK(builder);
-    pthread_mutex_destroy(&(builder->lock));
+    ts_lock_destroy(&(builder->lock));
     free(builder);
 }
@@ -0,0 +1,238 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2020 Cole Vikupitz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+#include "timer_wheel.h"
+#include "ts_timer_wheel.h"
+#include "ts_lock.h"
+
+/**
+ * Struct for the thread-safe timer wheel.
+ */
+struct ts_timer_wheel {
+    TsLock lock;                // The lock
+    TimerWheel *instance;       // Internal instance of TimerWheel
+} CACHE_ALIGNED;
+
+/**
+ * An expired timer's item and deadline, held until its callback can run unlocked.
+ */
+typedef struct {
+    void *item;                 // The timer's item
+    uint64_t deadline;          // The timer's deadline
+} Expired;
+
+/**
+ * The timers expired by one advance of the wheel, collected while the wheel is locked.
+ */
+typedef struct {
+    TimerWheel *wheel;          // The wheel being advanced
+    Expired *expired;           // The collected timers, `local` until it overflows
+    long size;                  // Number of collected timers
+    long capacity;              // Number of timers `expired` holds
+    Expired local[64];          // Initial storage, so most advances allocate nothing
+} Batch;
+
+// Macro used for locking the timer wheel `w` for writing
+#define LOCK(w)       ts_lock_write( &((w)->lock) )
+// Macro used for locking the timer wheel `w` for reading
+#define READ_LOCK(w)  ts_lock_read( &((w)->lock) )
+// Macro used for unlocking the timer wheel `w`
+#define UNLOCK(w)     ts_lock_unlock( &((w)->lock) )
+
+/**
+ * Collects an expired timer into the batch. Should the batch fail to grow, the timer is scheduled
+ * again as overdue instead, which reuses the memory just freed by the expiry, and fires on the
+ * next advance.
+ */
+static void _collect(void *item, uint64_t deadline, void *context) {
+
+    Batch *batch = (Batch *)context;
+
+    if (batch->size == batch->capacity) {
+        Expired *grown = (Expired *)malloc(sizeof(Expired) * batch->capacity * 2);
+        if (grown == NULL) {
+            timerwheel_schedule(batch->wheel, deadline, item, NULL);
+            return;
+        }
+        memcpy(grown, batch->expired, sizeof(Expired) * batch->size);
+        if (batch->expired != batch->local) {
+            free(batch->expired);
+        }
+        batch->expired = grown;
+        batch->capacity *= 2;
+    }
+    batch->expired[batch->size].item = item;
+    batch->expired[batch->size].deadline = deadline;
+    batch->size++;
+}
+
+Status ts_timerwheel_new(ConcurrentTimerWheel **wheel, uint64_t now) {
+
+    ConcurrentTimerWheel *temp;
+    Status status;
+
+    // Allocates memory for the timer wheel
+    temp = (ConcurrentTimerWheel *)ts_lock_alloc(sizeof(ConcurrentTimerWheel));
+    if (temp == NULL) {
+        return ALLOC_FAILURE;
+    }
+
+    // Creates the internal timer wheel instance
+    status = timerwheel_new(&(temp->instance), now);
+    if (status != OK) {
+        free(temp);
+        return status;
+    }
+
+    // Creates the lock with the calling thread's default lock policy
+    ts_lock_init(&(temp->lock));
+    *wheel = temp;
+
+    return OK;
+}
+
+Status ts_timerwheel_schedule(ConcurrentTimerWheel *wheel, uint64_t deadline, void *item,
+                              TimerHandle *handle) {
+
+    LOCK(wheel);
+    Status status = timerwheel_schedule(wheel->instance, deadline, item, handle);
+    UNLOCK(wheel);
+
+    return status;
+}
+
+Status ts_timerwheel_reschedule(ConcurrentTimerWheel *wheel, TimerHandle handle,
+                                uint64_t deadline) {
+
+    LOCK(wheel);
+    Status status = timerwheel_reschedule(wheel->instance, handle, deadline);
+    UNLOCK(wheel);
+
+    return status;
+}
+
+Status ts_timerwheel_cancel(ConcurrentTimerWheel *wheel, TimerHandle handle, void **item) {
+
+    LOCK(wheel);
+    Status status = timerwheel_cancel(wheel->instance, handle, item);
+    UNLOCK(wheel);
+
+    return status;
+}
+
+long ts_timerwheel_advance(ConcurrentTimerWheel *wheel, uint64_t now,
+                           void (*expire)(void *, uint64_t, void *), void *context) {
+
+    Batch batch;
+    long i;
+
+    batch.wheel = wheel->instance;
+    batch.expired = batch.local;
+    batch.size = 0L;
+    batch.capacity = (long)(sizeof(batch.local) / sizeof(Expired));
+
+    // Take the expired timers out while locked, then run their callbacks unlocked
+    LOCK(wheel);
+    timerwheel_advance(wheel->instance, now, _collect, &batch);
+    UNLOCK(wheel);
+
+    if (expire != NULL) {
+        for (i = 0L; i < batch.size; i++) {
+            expire(batch.expired[i].item, batch.expired[i].deadline, context);
+        }
+    }
+    if (batch.expired != batch.local) {
+        free(batch.expired);
+    }
+
+    return batch.size;
+}
+
+Status ts_timerwheel_nextDeadline(ConcurrentTimerWheel *wheel, uint64_t *deadline) {
+
+    READ_LOCK(wheel);
+    Status status = timerwheel_nextDeadline(wheel->instance, deadline);
+    UNLOCK(wheel);
+
+    return status;
+}
+
+uint64_t ts_timerwheel_now(ConcurrentTimerWheel *wheel) {
+
+    READ_LOCK(wheel);
+    uint64_t now = timerwheel_now(wheel->instance);
+    UNLOCK(wheel);
+
+    return now;
+}
+
+long ts_timerwheel_size(ConcurrentTimerWheel *wheel) {
+
+    READ_LOCK(wheel);
+    long size = timerwheel_size(wheel->instance);
+    UNLOCK(wheel);
+
+    return size;
+}
+
+Boolean ts_timerwheel_isEmpty(ConcurrentTimerWheel *wheel) {
+
+    READ_LOCK(wheel);
+    Boolean isEmpty = timerwheel_isEmpty(wheel->instance);
+    UNLOCK(wheel);
+
+    return isEmpty;
+}
+
+void ts_timerwheel_clear(ConcurrentTimerWheel *wheel, void (*destructor)(void *)) {
+
+    LOCK(wheel);
+    timerwheel_clear(wheel->instance, destructor);
+    UNLOCK(wheel);
+}
+
+long ts_timerwheel_memoryUsage(ConcurrentTimerWheel *wheel) {
+
+    READ_LOCK(wheel);
+    long bytes = (long)sizeof(ConcurrentTimerWheel) + timerwheel_memoryUsage(wheel->instance);
+    UNLOCK(wheel);
+
+    return bytes;
+}
+
+void ts_timerwheel_lockStats(ConcurrentTimerWheel *wheel, LockStats *stats) {
+    ts_lock_stats(&(wheel->lock), stats);
+}
+
+void ts_timerwheel_destroy(ConcurrentTimerWheel *wheel, void (*destructor)(void *)) {
+
+    LOCK(wheel);
+    timerwheel_destroy(wheel->instance, destructor);
+    UNLOCK(wheel);
+    ts_lock_destroy(&(wheel->lock));
+    free(wheel);
+}
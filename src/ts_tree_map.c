@@ -22,49 +22,79 @@
  * SOFTWARE.
  */
 
-#include <pthread.h>
 #include <stdlib.h>
 #include "tree_map.h"
 #include "ts_tree_map.h"
+#include "ts_lock.h"
 
 /**
  * Struct for the thread-safe treemap.
  */
 struct ts_treemap {
-    pthread_mutex_t lock;       // The lock
+    TsLock lock;                // The lock
     TreeMap *instance;          // Internal instance of TreeMap
-};
+} CACHE_ALIGNED;
 
-// Macro used for locking the tree `t`
-#define LOCK(t)    pthread_mutex_lock( &((t)->lock) )
+// Macro used for locking the tree `t` for writing
+#define LOCK(t)       ts_lock_write( &((t)->lock) )
+// Macro used for locking the tree `t` for reading
+#define READ_LOCK(t)  ts_lock_read( &((t)->lock) )
 // Macro used for unlocking the tree `t`
-#define UNLOCK(t)  pthread_mutex_unlock( &((t)->lock) )
+#define UNLOCK(t)     ts_lock_unlock( &((t)->lock) )
+
+Status ts_treemap_newWithPool(ConcurrentTreeMap **tree, int (*keyComparator)(void *, void *),
+        void (*keyDestructor)(void *), NodePool *pool)
+{
+    ConcurrentTreeMap *temp;
+    Status status;
+
+    // Allocates memory for the new tree
+    temp = (ConcurrentTreeMap *)ts_lock_alloc(sizeof(ConcurrentTreeMap));
+    if (temp == NULL) {
+        return ALLOC_FAILURE;
+    }
+
+    // Creates the internal tree instance
+    status = treemap_newWithPool(&(temp->instance), keyComparator, keyDestructor, pool);
+    if (status != OK) {
+        free(temp);
+        return status;
+    }
+
+    // Creates the lock with the calling thread's default lock policy
+    ts_lock_init(&(temp->lock));
+    *tree = temp;
+
+    return OK;
+}
 
 Status ts_treemap_new(ConcurrentTreeMap **tree, int (*keyComparator)(void *, void *),
         void (*keyDestructor)(void *))
+{
+    return ts_treemap_newWithPool(tree, keyComparator, keyDestructor, NULL);
+}
+
+Status ts_treemap_newBTree(ConcurrentTreeMap **tree, int (*keyComparator)(void *, void *),
+        void (*keyDestructor)(void *))
 {
     ConcurrentTreeMap *temp;
     Status status;
-    pthread_mutexattr_t attr;
 
     // Allocates memory for the new tree
-    temp = (ConcurrentTreeMap *)malloc(sizeof(ConcurrentTreeMap));
+    temp = (ConcurrentTreeMap *)ts_lock_alloc(sizeof(ConcurrentTreeMap));
     if (temp == NULL) {
         return ALLOC_FAILURE;
     }
 
     // Creates the internal tree instance
-    status = treemap_new(&(temp->instance), keyComparator, keyDestructor);
+    status = treemap_newBTree(&(temp->instance), keyComparator, keyDestructor);
     if (status != OK) {
         free(temp);
         return status;
     }
 
-    // Creates the pthread_mutex for locking
-    pthread_mutexattr_init(&attr);
-    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
-    pthread_mutex_init(&(temp->lock), &attr);
-    pthread_mutexattr_destroy(&attr);
+    // Creates the lock with the calling thread's default lock policy
+    ts_lock_init(&(temp->lock));
     *tree = temp;
 
     return OK;
@@ -78,6 +108,14 @@ void ts_treemap_unlock(ConcurrentTreeMap *tree) {
     UNLOCK(tree);
 }
 
+void ts_treemap_lockRead(ConcurrentTreeMap *tree) {
+    READ_LOCK(tree);
+}
+
+void ts_treemap_lockWrite(ConcurrentTreeMap *tree) {
+    LOCK(tree);
+}
+
 Status ts_treemap_put(ConcurrentTreeMap *tree, void *key, void *value, void **previous) {
 
     LOCK(tree);
@@ -89,7 +127,7 @@ Status ts_treemap_put(ConcurrentTreeMap *tree, void *key, void *value, void **pr
 
 Status ts_treemap_firstKey(ConcurrentTreeMap *tree, void **firstKey) {
 
-    LOCK(tree);
+    READ_LOCK(tree);
     Status status = treemap_firstKey(tree->instance, firstKey);
     UNLOCK(tree);
 
@@ -98,7 +136,7 @@ Status ts_treemap_firstKey(ConcurrentTreeMap *tree, void **firstKey) {
 
 Status ts_treemap_first(ConcurrentTreeMap *tree, TmEntry **first) {
 
-    LOCK(tree);
+    READ_LOCK(tree);
     Status status = treemap_first(tree->instance, first);
     UNLOCK(tree);
 
@@ -107,7 +145,7 @@ Status ts_treemap_first(ConcurrentTreeMap *tree, TmEntry **first) {
 
 Status ts_treemap_lastKey(ConcurrentTreeMap *tree, void **lastKey) {
 
-    LOCK(tree);
+    READ_LOCK(tree);
     Status status = treemap_lastKey(tree->instance, lastKey);
     UNLOCK(tree);
 
@@ -116,7 +154,7 @@ Status ts_treemap_lastKey(ConcurrentTreeMap *tree, void **lastKey) {
 
 Status ts_treemap_last(ConcurrentTreeMap *tree, TmEntry **last) {
 
-    LOCK(tree);
+    READ_LOCK(tree);
     Status status = treemap_last(tree->instance, last);
     UNLOCK(tree);
 
@@ -125,7 +163,7 @@ Status ts_treemap_last(ConcurrentTreeMap *tree, TmEntry **last) {
 
 Status ts_treemap_floorKey(ConcurrentTreeMap *tree, void *key, void **floorKey) {
 
-    LOCK(tree);
+    READ_LOCK(tree);
     Status status = treemap_floorKey(tree->instance, key, floorKey);
     UNLOCK(tree);
 
@@ -134,7 +172,7 @@ Status ts_treemap_floorKey(ConcurrentTreeMap *tree, void *key, void **floorKey)
 
 Status ts_treemap_floor(ConcurrentTreeMap *tree, void *key, TmEntry **floor) {
 
-    LOCK(tree);
+    READ_LOCK(tree);
     Status status = treemap_floor(tree->instance, key, floor);
     UNLOCK(tree);
 
@@ -143,7 +181,7 @@ Status ts_treemap_floor(ConcurrentTreeMap *tree, void *key, TmEntry **floor) {
 
 Status ts_treemap_ceilingKey(ConcurrentTreeMap *tree, void *key, void **ceilingKey) {
 
-    LOCK(tree);
+    READ_LOCK(tree);
     Status status = treemap_ceilingKey(tree->instance, key, ceilingKey);
     UNLOCK(tree);
 
@@ -152,7 +190,7 @@ Status ts_treemap_ceilingKey(ConcurrentTreeMap *tree, void *key, void **ceilingK
 
 Status ts_treemap_ceiling(ConcurrentTreeMap *tree, void *key, TmEntry **ceiling) {
 
-    LOCK(tree);
+    READ_LOCK(tree);
     Status status = treemap_ceiling(tree->instance, key, ceiling);
     UNLOCK(tree);
 
@@ -161,7 +199,7 @@ Status ts_treemap_ceiling(ConcurrentTreeMap *tree, void *key, TmEntry **ceiling)
 
 Status ts_treemap_lowerKey(ConcurrentTreeMap *tree, void *key, void **lowerKey) {
 
-    LOCK(tree);
+    READ_LOCK(tree);
     Status status = treemap_lowerKey(tree->instance, key, lowerKey);
     UNLOCK(tree);
 
@@ -170,7 +208,7 @@ Status ts_treemap_lowerKey(ConcurrentTreeMap *tree, void *key, void **lowerKey)
 
 Status ts_treemap_lower(ConcurrentTreeMap *tree, void *key, TmEntry **lower) {
 
-    LOCK(tree);
+    READ_LOCK(tree);
     Status status = treemap_lower(tree->instance, key, lower);
     UNLOCK(tree);
 
@@ -179,7 +217,7 @@ Status ts_treemap_lower(ConcurrentTreeMap *tree, void *key, TmEntry **lower) {
 
 Status ts_treemap_higherKey(ConcurrentTreeMap *tree, void *key, void **higherKey) {
 
-    LOCK(tree);
+    READ_LOCK(tree);
     Status status = treemap_higherKey(tree->instance, key, higherKey);
     UNLOCK(tree);
 
@@ -188,7 +226,7 @@ Status ts_treemap_higherKey(ConcurrentTreeMap *tree, void *key, void **higherKey
 
 Status ts_treemap_higher(ConcurrentTreeMap *tree, void *key, TmEntry **higher) {
 
-    LOCK(tree);
+    READ_LOCK(tree);
     Status status = treemap_higher(tree->instance, key, higher);
     UNLOCK(tree);
 
@@ -197,7 +235,7 @@ Status ts_treemap_higher(ConcurrentTreeMap *tree, void *key, TmEntry **higher) {
 
 Boolean ts_treemap_containsKey(ConcurrentTreeMap *tree, void *key) {
 
-    LOCK(tree);
+    READ_LOCK(tree);
     Boolean containsKey = treemap_containsKey(tree->instance, key);
     UNLOCK(tree);
 
@@ -206,7 +244,7 @@ Boolean ts_treemap_containsKey(ConcurrentTreeMap *tree, void *key) {
 
 Status ts_treemap_get(ConcurrentTreeMap *tree, void *key, void **value) {
 
-    LOCK(tree);
+    READ_LOCK(tree);
     Status status = treemap_get(tree->instance, key, value);
     UNLOCK(tree);
 
@@ -240,6 +278,34 @@ Status ts_treemap_remove(ConcurrentTreeMap *tree, void *key, void **value) {
     return status;
 }
 
+Status ts_treemap_putAll(ConcurrentTreeMap *tree, void **keys, void **values, long n,
+                         void **previous) {
+
+    LOCK(tree);
+    Status status = treemap_putAll(tree->instance, keys, values, n, previous);
+    UNLOCK(tree);
+
+    return status;
+}
+
+long ts_treemap_getAll(ConcurrentTreeMap *tree, void **keys, void **values, long n) {
+
+    READ_LOCK(tree);
+    long found = treemap_getAll(tree->instance, keys, values, n);
+    UNLOCK(tree);
+
+    return found;
+}
+
+long ts_treemap_removeAll(ConcurrentTreeMap *tree, void **keys, void **values, long n) {
+
+    LOCK(tree);
+    long removed = treemap_removeAll(tree->instance, keys, values, n);
+    UNLOCK(tree);
+
+    return removed;
+}
+
 void ts_treemap_clear(ConcurrentTreeMap *tree, void (*valueDestructor)(void *)) {
 
     LOCK(tree);
@@ -249,7 +315,7 @@ void ts_treemap_clear(ConcurrentTreeMap *tree, void (*valueDestructor)(void *))
 
 long ts_treemap_size(ConcurrentTreeMap *tree) {
 
-    LOCK(tree);
+    READ_LOCK(tree);
     long size = treemap_size(tree->instance);
     UNLOCK(tree);
 
@@ -258,7 +324,7 @@ long ts_treemap_size(ConcurrentTreeMap *tree) {
 
 Boolean ts_treemap_isEmpty(ConcurrentTreeMap *tree) {
 
-    LOCK(tree);
+    READ_LOCK(tree);
     Boolean isEmpty = treemap_isEmpty(tree->instance);
     UNLOCK(tree);
 
@@ -267,7 +333,7 @@ Boolean ts_treemap_isEmpty(ConcurrentTreeMap *tree) {
 
 Status ts_treemap_keyArray(ConcurrentTreeMap *tree, Array **keys) {
 
-    LOCK(tree);
+    READ_LOCK(tree);
     Status status = treemap_keyArray(tree->instance, keys);
     UNLOCK(tree);
 
@@ -276,7 +342,7 @@ Status ts_treemap_keyArray(ConcurrentTreeMap *tree, Array **keys) {
 
 Status ts_treemap_entryArray(ConcurrentTreeMap *tree, Array **entries) {
 
-    LOCK(tree);
+    READ_LOCK(tree);
     Status status = treemap_entryArray(tree->instance, entries);
     UNLOCK(tree);
 
@@ -289,7 +355,7 @@ Status ts_treemap_iterator(ConcurrentTreeMap *tree, ConcurrentIterator **iter) {
     Status status;
 
     // Creates the array of items and locks it
-    LOCK(tree);
+    READ_LOCK(tree);
     status = treemap_entryArray(tree->instance, &array);
     if (status != OK) {
         UNLOCK(tree);
@@ -297,7 +363,8 @@ Status ts_treemap_iterator(ConcurrentTreeMap *tree, ConcurrentIterator **iter) {
     }
 
     // Creates the iterator
-    status = ts_iterator_new(iter, &(tree->lock), array->items, array->len);
+    status = ts_iterator_newWithRelease(iter, ts_lock_release, &(tree->lock),
+                                        array->items, array->len);
     if (status != OK) {
         FREE_ARRAY(array);
         UNLOCK(tree);
@@ -308,11 +375,79 @@ Status ts_treemap_iterator(ConcurrentTreeMap *tree, ConcurrentIterator **iter) {
     return status;
 }
 
+Boolean ts_treemap_forEach(ConcurrentTreeMap *tree, Boolean (*action)(void *, void *, void *),
+                           void *context) {
+
+    READ_LOCK(tree);
+    Boolean complete = treemap_forEach(tree->instance, action, context);
+    UNLOCK(tree);
+
+    return complete;
+}
+
+Boolean ts_treemap_parallelForEach(ConcurrentTreeMap *tree, int nthreads,
+                                   Boolean (*action)(void *, void *, void *), void *context) {
+
+    READ_LOCK(tree);
+    Boolean complete = treemap_parallelForEach(tree->instance, nthreads, action, context);
+    UNLOCK(tree);
+
+    return complete;
+}
+
+void *ts_treemap_parallelReduce(ConcurrentTreeMap *tree, int nthreads,
+                                void *(*reducer)(void *, void *, void *, void *),
+                                void *(*combiner)(void *, void *, void *), void *context) {
+
+    READ_LOCK(tree);
+    void *result = treemap_parallelReduce(tree->instance, nthreads, reducer, combiner, context);
+    UNLOCK(tree);
+
+    return result;
+}
+
+Status ts_treemap_snapshot(ConcurrentTreeMap *tree, ConcurrentIterator **iter) {
+
+    Array *array;
+    Status status;
+
+    // Copies the entries under the lock, then releases it right away
+    READ_LOCK(tree);
+    status = treemap_entrySnapshot(tree->instance, &array);
+    UNLOCK(tree);
+    if (status != OK) {
+        return status;
+    }
+
+    // Creates the iterator, which holds no lock while the caller iterates
+    status = ts_iterator_newSnapshot(iter, array->items, array->len);
+    if (status != OK) {
+        FREE_ARRAY(array);
+    } else {
+        free(array);
+    }
+
+    return status;
+}
+
+long ts_treemap_memoryUsage(ConcurrentTreeMap *tree) {
+
+    READ_LOCK(tree);
+    long bytes = (long)sizeof(ConcurrentTreeMap) + treemap_memoryUsage(tree->instance);
+    UNLOCK(tree);
+
+    return bytes;
+}
+
+void ts_treemap_lockStats(ConcurrentTreeMap *tree, LockStats *stats) {
+    ts_lock_stats(&(tree->lock), stats);
+}
+
 void ts_treemap_destroy(ConcurrentTreeMap *tree, void (*valueDestructor)(void *)) {
 
     LOCK(tree);
     treemap_destroy(tree->instance, valueDestructor);
     UNLOCK(tree);
-    pthread_mutex_destroy(&(tree->lock));
+    ts_lock_destroy(&(tree->lock));
     free(tree);
 }
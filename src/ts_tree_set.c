@@ -22,53 +22,56 @@
  * SOFTWARE.
  */
 
-#include <pthread.h>
 #include <stdlib.h>
 #include "tree_set.h"
 #include "ts_tree_set.h"
+#include "ts_lock.h"
 
 /**
  * Struct for the thread-safe treeset.
  */
 struct ts_treeset {
-    pthread_mutex_t lock;       // The lock
+    TsLock lock;                // The lock
     TreeSet *instance;          // Internal instance of TreeSet
-};
+} CACHE_ALIGNED;
 
-// Macro used for locking the tree `t`
-#define LOCK(t)    pthread_mutex_lock( &((t)->lock) )
+// Macro used for locking the tree `t` for writing
+#define LOCK(t)       ts_lock_write( &((t)->lock) )
+// Macro used for locking the tree `t` for reading
+#define READ_LOCK(t)  ts_lock_read( &((t)->lock) )
 // Macro used for unlocking the tree `t`
-#define UNLOCK(t)  pthread_mutex_unlock( &((t)->lock) )
+#define UNLOCK(t)     ts_lock_unlock( &((t)->lock) )
 
-Status ts_treeset_new(ConcurrentTreeSet **tree, int (*comparator)(void *, void *)) {
+Status ts_treeset_newWithPool(ConcurrentTreeSet **tree, int (*comparator)(void *, void *),
+                              NodePool *pool) {
 
     ConcurrentTreeSet *temp;
     Status status;
-    pthread_mutexattr_t attr;
 
     // Allocates memory for the treeset
-    temp = (ConcurrentTreeSet *)malloc(sizeof(ConcurrentTreeSet));
+    temp = (ConcurrentTreeSet *)ts_lock_alloc(sizeof(ConcurrentTreeSet));
     if (temp == NULL) {
         return ALLOC_FAILURE;
     }
 
     // Creates the internal treeset instance
-    status = treeset_new(&(temp->instance), comparator);
+    status = treeset_newWithPool(&(temp->instance), comparator, pool);
     if (status != OK) {
         free(temp);
         return status;
     }
 
-    // Creates the pthread_mutex for locking
-    pthread_mutexattr_init(&attr);
-    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
-    pthread_mutex_init(&(temp->lock), &attr);
-    pthread_mutexattr_destroy(&attr);
+    // Creates the lock with the calling thread's default lock policy
+    ts_lock_init(&(temp->lock));
     *tree = temp;
 
     return OK;
 }
 
+Status ts_treeset_new(ConcurrentTreeSet **tree, int (*comparator)(void *, void *)) {
+    return ts_treeset_newWithPool(tree, comparator, NULL);
+}
+
 void ts_treeset_lock(ConcurrentTreeSet *tree) {
     LOCK(tree);
 }
@@ -77,6 +80,14 @@ void ts_treeset_unlock(ConcurrentTreeSet *tree) {
     UNLOCK(tree);
 }
 
+void ts_treeset_lockRead(ConcurrentTreeSet *tree) {
+    READ_LOCK(tree);
+}
+
+void ts_treeset_lockWrite(ConcurrentTreeSet *tree) {
+    LOCK(tree);
+}
+
 Status ts_treeset_add(ConcurrentTreeSet *tree, void *item) {
 
     LOCK(tree);
@@ -88,7 +99,7 @@ Status ts_treeset_add(ConcurrentTreeSet *tree, void *item) {
 
 Boolean ts_treeset_contains(ConcurrentTreeSet *tree, void *item) {
 
-    LOCK(tree);
+    READ_LOCK(tree);
     Boolean contains = treeset_contains(tree->instance, item);
     UNLOCK(tree);
 
@@ -97,7 +108,7 @@ Boolean ts_treeset_contains(ConcurrentTreeSet *tree, void *item) {
 
 Status ts_treeset_first(ConcurrentTreeSet *tree, void **first) {
 
-    LOCK(tree);
+    READ_LOCK(tree);
     Status status = treeset_first(tree->instance, first);
     UNLOCK(tree);
 
@@ -106,7 +117,7 @@ Status ts_treeset_first(ConcurrentTreeSet *tree, void **first) {
 
 Status ts_treeset_last(ConcurrentTreeSet *tree, void **last) {
 
-    LOCK(tree);
+    READ_LOCK(tree);
     Status status = treeset_last(tree->instance, last);
     UNLOCK(tree);
 
@@ -115,7 +126,7 @@ Status ts_treeset_last(ConcurrentTreeSet *tree, void **last) {
 
 Status ts_treeset_floor(ConcurrentTreeSet *tree, void *item, void **floor) {
 
-    LOCK(tree);
+    READ_LOCK(tree);
     Status status = treeset_floor(tree->instance, item, floor);
     UNLOCK(tree);
 
@@ -124,7 +135,7 @@ Status ts_treeset_floor(ConcurrentTreeSet *tree, void *item, void **floor) {
 
 Status ts_treeset_ceiling(ConcurrentTreeSet *tree, void *item, void **ceiling) {
 
-    LOCK(tree);
+    READ_LOCK(tree);
     Status status = treeset_ceiling(tree->instance, item, ceiling);
     UNLOCK(tree);
 
@@ -133,7 +144,7 @@ Status ts_treeset_ceiling(ConcurrentTreeSet *tree, void *item, void **ceiling) {
 
 Status ts_treeset_lower(ConcurrentTreeSet *tree, void *item, void **lower) {
 
-    LOCK(tree);
+    READ_LOCK(tree);
     Status status = treeset_lower(tree->instance, item, lower);
     UNLOCK(tree);
 
@@ -142,7 +153,7 @@ Status ts_treeset_lower(ConcurrentTreeSet *tree, void *item, void **lower) {
 
 Status ts_treeset_higher(ConcurrentTreeSet *tree, void *item, void **higher) {
 
-    LOCK(tree);
+    READ_LOCK(tree);
     Status status = treeset_higher(tree->instance, item, higher);
     UNLOCK(tree);
 
@@ -176,6 +187,25 @@ Status ts_treeset_remove(ConcurrentTreeSet *tree, void *item, void (*destructor)
     return status;
 }
 
+Status ts_treeset_addAll(ConcurrentTreeSet *tree, void **items, long n) {
+
+    LOCK(tree);
+    Status status = treeset_addAll(tree->instance, items, n);
+    UNLOCK(tree);
+
+    return status;
+}
+
+long ts_treeset_removeAll(ConcurrentTreeSet *tree, void **items, long n,
+                          void (*destructor)(void *)) {
+
+    LOCK(tree);
+    long removed = treeset_removeAll(tree->instance, items, n, destructor);
+    UNLOCK(tree);
+
+    return removed;
+}
+
 void ts_treeset_clear(ConcurrentTreeSet *tree, void (*destructor)(void *)) {
 
     LOCK(tree);
@@ -185,7 +215,7 @@ void ts_treeset_clear(ConcurrentTreeSet *tree, void (*destructor)(void *)) {
 
 long ts_treeset_size(ConcurrentTreeSet *tree) {
 
-    LOCK(tree);
+    READ_LOCK(tree);
     long size = treeset_size(tree->instance);
     UNLOCK(tree);
 
@@ -194,7 +224,7 @@ long ts_treeset_size(ConcurrentTreeSet *tree) {
 
 Boolean ts_treeset_isEmpty(ConcurrentTreeSet *tree) {
 
-    LOCK(tree);
+    READ_LOCK(tree);
     Boolean isEmpty = treeset_isEmpty(tree->instance);
     UNLOCK(tree);
 
@@ -203,7 +233,7 @@ Boolean ts_treeset_isEmpty(ConcurrentTreeSet *tree) {
 
 Status ts_treeset_toArray(ConcurrentTreeSet *tree, Array **array) {
 
-    LOCK(tree);
+    READ_LOCK(tree);
     Status status = treeset_toArray(tree->instance, array);
     UNLOCK(tree);
 
@@ -216,7 +246,7 @@ Status ts_treeset_iterator(ConcurrentTreeSet *tree, ConcurrentIterator **iter) {
     Status status;
 
     // Creates the array of items and locks it
-    LOCK(tree);
+    READ_LOCK(tree);
     status = treeset_toArray(tree->instance, &array);
     if (status != OK) {
         UNLOCK(tree);
@@ -224,7 +254,8 @@ Status ts_treeset_iterator(ConcurrentTreeSet *tree, ConcurrentIterator **iter) {
     }
 
     // Creates the iterator
-    status = ts_iterator_new(iter, &(tree->lock), array->items, array->len);
+    status = ts_iterator_newWithRelease(iter, ts_lock_release, &(tree->lock),
+                                        array->items, array->len);
     if (status != OK) {
         FREE_ARRAY(array);
         UNLOCK(tree);
@@ -235,11 +266,58 @@ Status ts_treeset_iterator(ConcurrentTreeSet *tree, ConcurrentIterator **iter) {
     return status;
 }
 
+Boolean ts_treeset_forEach(ConcurrentTreeSet *tree, Boolean (*action)(void *, void *),
+                           void *context) {
+
+    READ_LOCK(tree);
+    Boolean complete = treeset_forEach(tree->instance, action, context);
+    UNLOCK(tree);
+
+    return complete;
+}
+
+Status ts_treeset_snapshot(ConcurrentTreeSet *tree, ConcurrentIterator **iter) {
+
+    Array *array;
+    Status status;
+
+    // Copies the items under the lock, then releases it right away
+    READ_LOCK(tree);
+    status = treeset_toArray(tree->instance, &array);
+    UNLOCK(tree);
+    if (status != OK) {
+        return status;
+    }
+
+    // Creates the iterator, which holds no lock while the caller iterates
+    status = ts_iterator_newSnapshot(iter, array->items, array->len);
+    if (status != OK) {
+        FREE_ARRAY(array);
+    } else {
+        free(array);
+    }
+
+    return status;
+}
+
+long ts_treeset_memoryUsage(ConcurrentTreeSet *tree) {
+
+    READ_LOCK(tree);
+    long bytes = (long)sizeof(ConcurrentTreeSet) + treeset_memoryUsage(tree->instance);
+    UNLOCK(tree);
+
+    return bytes;
+}
+
+void ts_treeset_lockStats(ConcurrentTreeSet *tree, LockStats *stats) {
+    ts_lock_stats(&(tree->lock), stats);
+}
+
 void ts_treeset_destroy(ConcurrentTreeSet *tree, void (*destructor)(void *)) {
 
     LOCK(tree);
     treeset_destroy(tree->instance, destructor);
     UNLOCK(tree);
-    pthread_mutex_destroy(&(tree->lock));
+    ts_lock_destroy(&(tree->lock));
     free(tree);
 }
@@ -0,0 +1,218 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2020 Cole Vikupitz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include "work_deque.h"
+
+// The size of a cache line, the owner's and the thieves' indices are kept apart by
+#define CACHE_LINE 64
+#define ALIGNED __attribute__((aligned(CACHE_LINE)))
+
+// The default capacity to assign when the capacity given is invalid
+#define DEFAULT_CAPACITY 64L
+
+/**
+ * A circular array of tasks.
+ */
+typedef struct task_array {
+    long mask;                  // The capacity minus one, maps a position to its index
+    struct task_array *prev;    // The array this one replaced, kept until the deque is destroyed
+    void *items[];              // The tasks
+} TaskArray;
+
+/**
+ * Struct for the work-stealing deque ADT. Positions only ever grow; the tasks live at positions
+ * top..bottom-1, each one stored at index (position & mask) of the current array.
+ */
+struct work_deque {
+    ALIGNED long top;           // The position of the oldest task, advanced by thieves
+    ALIGNED long bottom;        // The position past the newest task, only moved by the owner
+    TaskArray *array;           // The current array of tasks
+    ALIGNED char end;           // Pads the struct so no other allocation shares the last line
+};
+
+/**
+ * Allocates a new array of `capacity` tasks, a power of two.
+ */
+static TaskArray *_new_array(long capacity, TaskArray *prev) {
+
+    TaskArray *array = (TaskArray *)malloc(sizeof(TaskArray) + capacity * sizeof(void *));
+    if (array != NULL) {
+        array->mask = capacity - 1L;
+        array->prev = prev;
+    }
+
+    return array;
+}
+
+Status workdeque_new(WorkDeque **deque, long capacity) {
+
+    WorkDeque *temp;
+    long cap = 1L, wanted = ( capacity <= 0L ) ? DEFAULT_CAPACITY : capacity;
+
+    // Rounds the capacity up to the next power of two
+    while (cap < wanted) {
+        cap <<= 1;
+    }
+
+    if (posix_memalign((void **)&temp, CACHE_LINE, sizeof(WorkDeque)) != 0) {
+        return ALLOC_FAILURE;
+    }
+    temp->array = _new_array(cap, NULL);
+    if (temp->array == NULL) {
+        free(temp);
+        return ALLOC_FAILURE;
+    }
+    temp->top = 0L;
+    temp->bottom = 0L;
+    *deque = temp;
+
+    return OK;
+}
+
+/**
+ * Copies the tasks between positions `top` and `bottom` into a new array twice the size, and
+ * publishes it as the deque's current array. Only called by the owner.
+ */
+static TaskArray *_grow(WorkDeque *deque, TaskArray *array, long top, long bottom) {
+
+    TaskArray *bigger = _new_array(2L * (array->mask + 1L), array);
+    long i;
+
+    if (bigger == NULL) {
+        return NULL;
+    }
+    for (i = top; i < bottom; i++) {
+        bigger->items[i & bigger->mask] =
+            __atomic_load_n(&(array->items[i & array->mask]), __ATOMIC_RELAXED);
+    }
+    __atomic_store_n(&(deque->array), bigger, __ATOMIC_RELEASE);
+
+    return bigger;
+}
+
+Status workdeque_push(WorkDeque *deque, void *item) {
+
+    long bottom = __atomic_load_n(&(deque->bottom), __ATOMIC_RELAXED);
+    long top = __atomic_load_n(&(deque->top), __ATOMIC_ACQUIRE);
+    TaskArray *array = __atomic_load_n(&(deque->array), __ATOMIC_RELAXED);
+
+    if (bottom - top > array->mask) {
+        array = _grow(deque, array, top, bottom);
+        if (array == NULL) {
+            return ALLOC_FAILURE;
+        }
+    }
+
+    // Publishes the task to the thieves by moving the bottom past it
+    __atomic_store_n(&(array->items[bottom & array->mask]), item, __ATOMIC_RELAXED);
+    __atomic_store_n(&(deque->bottom), bottom + 1L, __ATOMIC_RELEASE);
+
+    return OK;
+}
+
+Status workdeque_pop(WorkDeque *deque, void **item) {
+
+    long bottom = __atomic_load_n(&(deque->bottom), __ATOMIC_RELAXED) - 1L;
+    TaskArray *array = __atomic_load_n(&(deque->array), __ATOMIC_RELAXED);
+    Status status = OK;
+    long top;
+
+    // Reserves the bottom task first, so thieves that read the bottom afterwards skip it
+    __atomic_store_n(&(deque->bottom), bottom, __ATOMIC_SEQ_CST);
+    top = __atomic_load_n(&(deque->top), __ATOMIC_SEQ_CST);
+
+    if (top > bottom) {
+        // The deque was already empty
+        __atomic_store_n(&(deque->bottom), bottom + 1L, __ATOMIC_RELAXED);
+        return STRUCT_EMPTY;
+    }
+
+    *item = __atomic_load_n(&(array->items[bottom & array->mask]), __ATOMIC_RELAXED);
+    if (top == bottom) {
+        // The last task is also up for stealing, races the thieves for it
+        if (!__atomic_compare_exchange_n(&(deque->top), &top, top + 1L, FALSE,
+                                         __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+            status = STRUCT_EMPTY;
+        }
+        __atomic_store_n(&(deque->bottom), bottom + 1L, __ATOMIC_RELAXED);
+    }
+
+    return status;
+}
+
+Status workdeque_steal(WorkDeque *deque, void **item) {
+
+    TaskArray *array;
+    long top, bottom;
+    void *task;
+
+    top = __atomic_load_n(&(deque->top), __ATOMIC_SEQ_CST);
+    while (TRUE) {
+        bottom = __atomic_load_n(&(deque->bottom), __ATOMIC_SEQ_CST);
+        if (top >= bottom) {
+            return STRUCT_EMPTY;
+        }
+
+        // Reads the task before claiming it, the owner cannot overwrite it until the top moves
+        array = __atomic_load_n(&(deque->array), __ATOMIC_ACQUIRE);
+        task = __atomic_load_n(&(array->items[top & array->mask]), __ATOMIC_RELAXED);
+        if (__atomic_compare_exchange_n(&(deque->top), &top, top + 1L, FALSE,
+                                        __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)) {
+            *item = task;
+            return OK;
+        }
+        // Lost the race to another thief or the owner, tries the next task
+    }
+}
+
+long workdeque_size(WorkDeque *deque) {
+
+    long top = __atomic_load_n(&(deque->top), __ATOMIC_ACQUIRE);
+    long bottom = __atomic_load_n(&(deque->bottom), __ATOMIC_ACQUIRE);
+
+    return ( bottom > top ) ? bottom - top : 0L;
+}
+
+Boolean workdeque_isEmpty(WorkDeque *deque) {
+    return ( workdeque_size(deque) == 0L ) ? TRUE : FALSE;
+}
+
+void workdeque_destroy(WorkDeque *deque, void (*destructor)(void *)) {
+
+    TaskArray *array = deque->array, *prev;
+    long i;
+
+    if (destructor != NULL) {
+        for (i = deque->top; i < deque->bottom; i++) {
+            (*destructor)(array->items[i & array->mask]);
+        }
+    }
+    while (array != NULL) {
+        prev = array->prev;
+        free(array);
+        array = prev;
+    }
+    free(deque);
+}
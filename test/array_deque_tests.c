@@ -0,0 +1,424 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2020 Cole Vikupitz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include <CUnit/Basic.h>
+#include "array_deque.h"
+
+/* Default ArrayDeque capacity */
+#define CAPACITY 2L
+
+/* Single item used for testing */
+static char *singleItem = "Test";
+
+/* Collection of items used for testing */
+#define LEN 9
+static char *array[] = {"red", "orange", "yellow", "green", "blue", "purple", "gray", "white", "black"};
+
+/* Number of operations used in the mixed workload test */
+#define MIXED_LEN 2000L
+
+static void validateEmptyArrayDeque(ArrayDeque *deque) {
+
+    Array *arr;
+    Iterator *iter;
+    char *item;
+
+    CU_ASSERT_TRUE( arraydeque_first(deque, (void **)&item) == STRUCT_EMPTY );
+    CU_ASSERT_TRUE( arraydeque_last(deque, (void **)&item) == STRUCT_EMPTY );
+    CU_ASSERT_TRUE( arraydeque_get(deque, 0L, (void **)&item) == STRUCT_EMPTY );
+    CU_ASSERT_TRUE( arraydeque_set(deque, 0L, singleItem, (void **)&item) == STRUCT_EMPTY );
+    CU_ASSERT_TRUE( arraydeque_removeFirst(deque, (void **)&item) == STRUCT_EMPTY );
+    CU_ASSERT_TRUE( arraydeque_removeLast(deque, (void **)&item) == STRUCT_EMPTY );
+    CU_ASSERT_TRUE( arraydeque_remove(deque, 0L, (void **)&item) == STRUCT_EMPTY );
+    CU_ASSERT_TRUE( arraydeque_size(deque) == 0L );
+    CU_ASSERT_TRUE( arraydeque_isEmpty(deque) == TRUE );
+    CU_ASSERT_TRUE( arraydeque_iterator(deque, &iter) == STRUCT_EMPTY );
+    CU_ASSERT_TRUE( arraydeque_toArray(deque, &arr) == STRUCT_EMPTY );
+}
+
+static void testEmptyArrayDeque() {
+
+    ArrayDeque *deque;
+    Status stat;
+
+    stat = arraydeque_new(&deque, CAPACITY);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testEmptyArrayDeque() - allocation failure");
+
+    validateEmptyArrayDeque(deque);
+    arraydeque_destroy(deque, NULL);
+    CU_PASS("testEmptyArrayDeque() - Test Passed");
+}
+
+static void testSingleItem() {
+
+    ArrayDeque *deque;
+    Status stat;
+    char *item;
+
+    stat = arraydeque_new(&deque, CAPACITY);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testSingleItem() - allocation failure");
+
+    CU_ASSERT_TRUE( arraydeque_addFirst(deque, singleItem) == OK );
+    CU_ASSERT_TRUE( arraydeque_size(deque) == 1L );
+    CU_ASSERT_TRUE( arraydeque_capacity(deque) == CAPACITY );
+    CU_ASSERT_TRUE( arraydeque_isEmpty(deque) == FALSE );
+    CU_ASSERT_TRUE( arraydeque_first(deque, (void **)&item) == OK );
+    CU_ASSERT_TRUE( strcmp(item, singleItem) == 0 );
+    CU_ASSERT_TRUE( arraydeque_last(deque, (void **)&item) == OK );
+    CU_ASSERT_TRUE( strcmp(item, singleItem) == 0 );
+    CU_ASSERT_TRUE( arraydeque_get(deque, 0L, (void **)&item) == OK );
+    CU_ASSERT_TRUE( strcmp(item, singleItem) == 0 );
+    CU_ASSERT_TRUE( arraydeque_removeLast(deque, (void **)&item) == OK );
+    CU_ASSERT_TRUE( strcmp(item, singleItem) == 0 );
+    CU_ASSERT_TRUE( arraydeque_removeFirst(deque, (void **)&item) == STRUCT_EMPTY );
+
+    validateEmptyArrayDeque(deque);
+    arraydeque_destroy(deque, NULL);
+
+    CU_PASS("testSingleItem() - Test Passed");
+}
+
+static void testInvalidIndexAccess() {
+
+    ArrayDeque *deque;
+    Status stat;
+    int i;
+    char *item;
+
+    stat = arraydeque_new(&deque, CAPACITY);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testInvalidIndexAccess() - allocation failure");
+
+    CU_ASSERT_TRUE( arraydeque_insert(deque, 1L, singleItem) == INVALID_INDEX );
+    CU_ASSERT_TRUE( arraydeque_insert(deque, -1L, singleItem) == INVALID_INDEX );
+    for (i = 0; i < LEN; i++)
+        CU_ASSERT_TRUE( arraydeque_addLast(deque, array[i]) == OK );
+
+    CU_ASSERT_TRUE( arraydeque_get(deque, -1L, (void **)&item) == INVALID_INDEX );
+    CU_ASSERT_TRUE( arraydeque_get(deque, LEN, (void **)&item) == INVALID_INDEX );
+    CU_ASSERT_TRUE( arraydeque_set(deque, LEN, singleItem, (void **)&item) == INVALID_INDEX );
+    CU_ASSERT_TRUE( arraydeque_remove(deque, LEN, (void **)&item) == INVALID_INDEX );
+    CU_ASSERT_TRUE( arraydeque_insert(deque, LEN + 1L, singleItem) == INVALID_INDEX );
+    CU_ASSERT_TRUE( arraydeque_size(deque) == LEN );
+
+    arraydeque_destroy(deque, NULL);
+
+    CU_PASS("testInvalidIndexAccess() - Test Passed");
+}
+
+static void testBothEnds() {
+
+    ArrayDeque *deque;
+    Status stat;
+    int i;
+    char *item;
+
+    stat = arraydeque_new(&deque, CAPACITY);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testBothEnds() - allocation failure");
+
+    // Pushes onto both ends so the elements wrap around the array as it grows
+    for (i = 0; i < LEN; i++) {
+        if (i % 2 == 0)
+            CU_ASSERT_TRUE( arraydeque_addFirst(deque, array[i]) == OK );
+        else
+            CU_ASSERT_TRUE( arraydeque_addLast(deque, array[i]) == OK );
+    }
+    CU_ASSERT_TRUE( arraydeque_size(deque) == LEN );
+    CU_ASSERT_TRUE( arraydeque_capacity(deque) == 16L );
+
+    // Front holds the even items in reverse, back holds the odd items in order
+    for (i = 0; i < LEN / 2 + 1; i++) {
+        CU_ASSERT_TRUE( arraydeque_get(deque, i, (void **)&item) == OK );
+        CU_ASSERT_TRUE( strcmp(item, array[(LEN / 2 - i) * 2]) == 0 );
+    }
+    for (; i < LEN; i++) {
+        CU_ASSERT_TRUE( arraydeque_get(deque, i, (void **)&item) == OK );
+        CU_ASSERT_TRUE( strcmp(item, array[(i - LEN / 2) * 2 - 1]) == 0 );
+    }
+
+    CU_ASSERT_TRUE( arraydeque_first(deque, (void **)&item) == OK );
+    CU_ASSERT_TRUE( strcmp(item, array[LEN - 1]) == 0 );
+    CU_ASSERT_TRUE( arraydeque_last(deque, (void **)&item) == OK );
+    CU_ASSERT_TRUE( strcmp(item, array[LEN - 2]) == 0 );
+
+    for (i = LEN - 1; i >= 0; i -= 2) {
+        CU_ASSERT_TRUE( arraydeque_removeFirst(deque, (void **)&item) == OK );
+        CU_ASSERT_TRUE( strcmp(item, array[i]) == 0 );
+    }
+    for (i = LEN - 2; i >= 0; i -= 2) {
+        CU_ASSERT_TRUE( arraydeque_removeLast(deque, (void **)&item) == OK );
+        CU_ASSERT_TRUE( strcmp(item, array[i]) == 0 );
+    }
+
+    validateEmptyArrayDeque(deque);
+    arraydeque_destroy(deque, NULL);
+
+    CU_PASS("testBothEnds() - Test Passed");
+}
+
+static void testSetItem() {
+
+    ArrayDeque *deque;
+    Status stat;
+    int i;
+    char *item;
+
+    stat = arraydeque_new(&deque, CAPACITY);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testSetItem() - allocation failure");
+
+    for (i = 0; i < LEN; i++)
+        CU_ASSERT_TRUE( arraydeque_addFirst(deque, singleItem) == OK );
+    for (i = 0; i < LEN; i++) {
+        CU_ASSERT_TRUE( arraydeque_set(deque, i, array[i], (void **)&item) == OK );
+        CU_ASSERT_TRUE( strcmp(item, singleItem) == 0 );
+    }
+    for (i = 0; i < LEN; i++) {
+        CU_ASSERT_TRUE( arraydeque_get(deque, i, (void **)&item) == OK );
+        CU_ASSERT_TRUE( strcmp(item, array[i]) == 0 );
+    }
+
+    arraydeque_destroy(deque, NULL);
+
+    CU_PASS("testSetItem() - Test Passed");
+}
+
+static void testMixedOperations() {
+
+    ArrayDeque *deque;
+    long model[MIXED_LEN], i, j, n = 0L;
+    void *item;
+
+    Status stat = arraydeque_new(&deque, CAPACITY);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testMixedOperations() - allocation failure");
+
+    // Mixes insertions at both ends and at indices on either side of the middle
+    for (i = 1L; i <= MIXED_LEN; i++) {
+        j = ( i % 4L == 0L ) ? 0L : ( i % 4L == 1L ) ? n
+          : ( i % 4L == 2L ) ? n / 3L : (n * 3L) / 4L;
+        CU_ASSERT_TRUE( arraydeque_insert(deque, j, (void *)i) == OK );
+        memmove(model + j + 1L, model + j, (n - j) * sizeof(long));
+        model[j] = i;
+        n++;
+
+        // Removes every third element added, again from different positions
+        if (i % 3L == 0L) {
+            j = ( i % 2L == 0L ) ? n / 4L : (n * 2L) / 3L;
+            CU_ASSERT_TRUE( arraydeque_remove(deque, j, &item) == OK );
+            CU_ASSERT_EQUAL( (long)item, model[j] );
+            n--;
+            memmove(model + j, model + j + 1L, (n - j) * sizeof(long));
+        }
+    }
+
+    CU_ASSERT_TRUE( arraydeque_size(deque) == n );
+    for (i = 0L; i < n; i++) {
+        CU_ASSERT_TRUE( arraydeque_get(deque, i, &item) == OK );
+        CU_ASSERT_EQUAL( (long)item, model[i] );
+    }
+
+    arraydeque_destroy(deque, NULL);
+
+    CU_PASS("testMixedOperations() - Test Passed");
+}
+
+static void testEnsureCapacity() {
+
+    ArrayDeque *deque;
+    Status stat;
+    int i;
+    char *item;
+
+    stat = arraydeque_new(&deque, CAPACITY);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testEnsureCapacity() - allocation failure");
+
+    for (i = 0; i < LEN; i++)
+        CU_ASSERT_TRUE( arraydeque_addFirst(deque, array[LEN - 1 - i]) == OK );
+    CU_ASSERT_TRUE( arraydeque_ensureCapacity(deque, 100L) == OK );
+    CU_ASSERT_TRUE( arraydeque_capacity(deque) == 128L );
+    CU_ASSERT_TRUE( arraydeque_ensureCapacity(deque, 10L) == OK );
+    CU_ASSERT_TRUE( arraydeque_capacity(deque) == 128L );
+    for (i = 0; i < LEN; i++) {
+        CU_ASSERT_TRUE( arraydeque_get(deque, i, (void **)&item) == OK );
+        CU_ASSERT_TRUE( strcmp(item, array[i]) == 0 );
+    }
+
+    arraydeque_destroy(deque, NULL);
+
+    CU_PASS("testEnsureCapacity() - Test Passed");
+}
+
+static void testArrayDequeToArray() {
+
+    Array *arr;
+    ArrayDeque *deque;
+    Status stat;
+    int i;
+
+    stat = arraydeque_new(&deque, LEN);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testArrayDequeToArray() - allocation failure");
+
+    // Wraps the items around the end of the array
+    for (i = LEN / 2; i < LEN; i++)
+        CU_ASSERT_TRUE( arraydeque_addLast(deque, array[i]) == OK );
+    for (i = LEN / 2 - 1; i >= 0; i--)
+        CU_ASSERT_TRUE( arraydeque_addFirst(deque, array[i]) == OK );
+    CU_ASSERT_TRUE( arraydeque_toArray(deque, &arr) == OK );
+    CU_ASSERT_TRUE( arr->len == LEN );
+
+    for (i = 0; i < arr->len; i++)
+        CU_ASSERT_TRUE( strcmp(arr->items[i], array[i]) == 0 );
+
+    FREE_ARRAY(arr)
+    arraydeque_destroy(deque, NULL);
+
+    CU_PASS("testArrayDequeToArray() - Test Passed");
+}
+
+static void testArrayDequeIterator() {
+
+    ArrayDeque *deque;
+    Iterator *iter;
+    Status stat;
+    int i;
+    char *item;
+
+    stat = arraydeque_new(&deque, LEN);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testArrayDequeIterator() - allocation failure");
+
+    for (i = LEN - 1; i >= 0; i--)
+        CU_ASSERT_TRUE( arraydeque_addFirst(deque, array[i]) == OK );
+    CU_ASSERT_TRUE( arraydeque_iterator(deque, &iter) == OK );
+
+    i = 0;
+    while (iterator_hasNext(iter) == TRUE) {
+        CU_ASSERT_TRUE( iterator_next(iter, (void **)&item) == OK );
+        CU_ASSERT_TRUE( strcmp(item, array[i++]) == 0 );
+    }
+    CU_ASSERT_TRUE( i == LEN );
+
+    iterator_destroy(iter);
+    arraydeque_destroy(deque, NULL);
+
+    CU_PASS("testArrayDequeIterator() - Test Passed");
+}
+
+static void testArrayDequeCursor() {
+
+    ArrayDeque *deque;
+    Cursor cursor;
+    Status stat;
+    int i;
+    char *item;
+
+    stat = arraydeque_new(&deque, CAPACITY);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testArrayDequeCursor() - allocation failure");
+
+    arraydeque_cursor(deque, &cursor);
+    CU_ASSERT_TRUE( cursor_hasNext(&cursor) == FALSE );
+    CU_ASSERT_TRUE( arraydeque_cursorNext(&cursor, (void **)&item) == ITER_END );
+
+    for (i = LEN - 1; i >= 0; i--)
+        CU_ASSERT_TRUE( arraydeque_addFirst(deque, array[i]) == OK );
+    arraydeque_cursor(deque, &cursor);
+    i = 0;
+    while (cursor_hasNext(&cursor) == TRUE) {
+        CU_ASSERT_TRUE( arraydeque_cursorNext(&cursor, (void **)&item) == OK );
+        CU_ASSERT_TRUE( strcmp(item, array[i++]) == 0 );
+    }
+    CU_ASSERT_TRUE( i == LEN );
+    CU_ASSERT_TRUE( arraydeque_cursorNext(&cursor, (void **)&item) == ITER_END );
+
+    arraydeque_cursor(deque, &cursor);
+    CU_ASSERT_TRUE( arraydeque_cursorNext(&cursor, (void **)&item) == OK );
+    CU_ASSERT_TRUE( arraydeque_removeFirst(deque, (void **)&item) == OK );
+    CU_ASSERT_TRUE( arraydeque_cursorNext(&cursor, (void **)&item) == CONCURRENT_MODIFICATION );
+    arraydeque_destroy(deque, NULL);
+
+    CU_PASS("testArrayDequeCursor() - Test Passed");
+}
+
+static void testArrayDequeClear() {
+
+    ArrayDeque *deque;
+    Status stat;
+    int i;
+
+    stat = arraydeque_new(&deque, CAPACITY);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testArrayDequeClear() - allocation failure");
+
+    for (i = 0; i < LEN; i++)
+        CU_ASSERT_TRUE( arraydeque_addFirst(deque, strdup(array[i])) == OK );
+    arraydeque_clear(deque, free);
+    validateEmptyArrayDeque(deque);
+
+    for (i = 0; i < LEN; i++)
+        CU_ASSERT_TRUE( arraydeque_addLast(deque, strdup(array[i])) == OK );
+    arraydeque_destroy(deque, free);
+
+    CU_PASS("testArrayDequeClear() - Test Passed");
+}
+
+#define UNUSED __attribute__((unused))
+int main(UNUSED int argc, UNUSED char **argv) {
+
+    if (CU_initialize_registry() != CUE_SUCCESS) {
+        return CU_get_error();
+    }
+
+    CU_pSuite suite = CU_add_suite("ArrayDeque Tests", NULL, NULL);
+    if (suite == NULL) {
+        CU_cleanup_registry();
+        return CU_get_error();
+    }
+
+    CU_add_test(suite, "ArrayDeque - Empty", testEmptyArrayDeque);
+    CU_add_test(suite, "ArrayDeque - Single Item", testSingleItem);
+    CU_add_test(suite, "ArrayDeque - Invalid Index Access", testInvalidIndexAccess);
+    CU_add_test(suite, "ArrayDeque - Both Ends", testBothEnds);
+    CU_add_test(suite, "ArrayDeque - Set", testSetItem);
+    CU_add_test(suite, "ArrayDeque - Mixed Operations", testMixedOperations);
+    CU_add_test(suite, "ArrayDeque - Ensure", testEnsureCapacity);
+    CU_add_test(suite, "ArrayDeque - Array", testArrayDequeToArray);
+    CU_add_test(suite, "ArrayDeque - Iterator", testArrayDequeIterator);
+    CU_add_test(suite, "ArrayDeque - Cursor", testArrayDequeCursor);
+    CU_add_test(suite, "ArrayDeque - Clear", testArrayDequeClear);
+
+    CU_basic_set_mode(CU_BRM_VERBOSE);
+    CU_basic_run_tests();
+    CU_cleanup_registry();
+
+    return 0;
+}
@@ -22,9 +22,12 @@
  * SOFTWARE.
  */
 
+#include <limits.h>
+#include <pthread.h>
 #include <stdlib.h>
 #include <CUnit/Basic.h>
 #include "array_list.h"
+#include "cow_array_list.h"
 
 /* Default ArrayList capacity */
 #define CAPACITY 2L
@@ -229,6 +232,46 @@ static void testEnsureCapacity() {
     CU_PASS("testEnsureCapacity() - Test Passed");
 }
 
+static void testGrowthFactor() {
+
+    ArrayList *list;
+    Status stat;
+    long i;
+    void *item;
+
+    stat = arraylist_new(&list, 100L);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testGrowthFactor() - allocation failure");
+
+    // Grows by a quarter instead of doubling, then back to doubling for invalid factors
+    arraylist_setGrowthFactor(list, 0.25f);
+    for (i = 0L; i <= 100L; i++)
+        CU_ASSERT_TRUE( arraylist_add(list, (void *)i) == OK );
+    CU_ASSERT_TRUE( arraylist_capacity(list) == 125L );
+    arraylist_setGrowthFactor(list, 1.5f);
+    for (; i <= 125L; i++)
+        CU_ASSERT_TRUE( arraylist_add(list, (void *)i) == OK );
+    CU_ASSERT_TRUE( arraylist_capacity(list) == 250L );
+
+    // A batch larger than the growth is fit in one go
+    CU_ASSERT_TRUE( arraylist_addAll(list, (void **)array, LEN) == OK );
+    CU_ASSERT_TRUE( arraylist_capacity(list) == 250L );
+    for (i = 0L; i < 40L; i++)
+        CU_ASSERT_TRUE( arraylist_insertAll(list, 0L, (void **)array, LEN) == OK );
+    CU_ASSERT_TRUE( arraylist_size(list) == 126L + (41L * LEN) );
+    CU_ASSERT_TRUE( arraylist_capacity(list) == 500L );
+    CU_ASSERT_TRUE( arraylist_get(list, 40L * LEN, &item) == OK );
+    CU_ASSERT_TRUE( item == (void *)0L );
+
+    // Sizes that can't be addressed fail cleanly
+    CU_ASSERT_TRUE( arraylist_ensureCapacity(list, LONG_MAX) == ALLOC_FAILURE );
+    CU_ASSERT_TRUE( arraylist_capacity(list) == 500L );
+
+    arraylist_destroy(list, NULL);
+
+    CU_PASS("testGrowthFactor() - Test Passed");
+}
+
 static void testTrimToSize() {
 
     ArrayList *list;
@@ -331,6 +374,207 @@ static void testArrayListIterator() {
     CU_PASS("testArrayListIterator() - Test Passed");
 }
 
+static Boolean isShortColor(void *item) {
+    return ( strlen((char *)item) <= 4 ) ? TRUE : FALSE;
+}
+
+static void testBulkOperations() {
+
+    ArrayList *list;
+    Status stat;
+    int i;
+    char *item;
+    char *expected[] = {"orange", "yellow", "green", "purple", "white", "black"};
+
+    stat = arraylist_new(&list, CAPACITY);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testBulkOperations() - allocation failure");
+
+    CU_ASSERT_TRUE( arraylist_addAll(list, (void **)array, -1L) == INVALID_INDEX );
+    CU_ASSERT_TRUE( arraylist_addAll(list, (void **)array + 3, LEN - 3) == OK );
+    CU_ASSERT_TRUE( arraylist_insertAll(list, LEN, (void **)array, 3L) == INVALID_INDEX );
+    CU_ASSERT_TRUE( arraylist_insertAll(list, 0L, (void **)array, 3L) == OK );
+    CU_ASSERT_TRUE( arraylist_size(list) == LEN );
+    for (i = 0; i < LEN; i++) {
+        CU_ASSERT_TRUE( arraylist_get(list, i, (void **)&item) == OK );
+        CU_ASSERT_TRUE( strcmp(item, array[i]) == 0 );
+    }
+
+    // Removes "yellow" through "blue", then puts them back
+    CU_ASSERT_TRUE( arraylist_removeRange(list, 3L, 2L, NULL) == INVALID_INDEX );
+    CU_ASSERT_TRUE( arraylist_removeRange(list, 0L, LEN + 1, NULL) == INVALID_INDEX );
+    CU_ASSERT_TRUE( arraylist_removeRange(list, 2L, 5L, NULL) == OK );
+    CU_ASSERT_TRUE( arraylist_size(list) == LEN - 3 );
+    CU_ASSERT_TRUE( arraylist_get(list, 2L, (void **)&item) == OK );
+    CU_ASSERT_TRUE( strcmp(item, "purple") == 0 );
+    CU_ASSERT_TRUE( arraylist_insertAll(list, 2L, (void **)array + 2, 3L) == OK );
+
+    // Removes "red", "blue" and "gray"
+    CU_ASSERT_TRUE( arraylist_removeIf(list, isShortColor, NULL) == 3L );
+    CU_ASSERT_TRUE( arraylist_size(list) == 6L );
+    for (i = 0; i < 6; i++) {
+        CU_ASSERT_TRUE( arraylist_get(list, i, (void **)&item) == OK );
+        CU_ASSERT_TRUE( strcmp(item, expected[i]) == 0 );
+    }
+    CU_ASSERT_TRUE( arraylist_removeIf(list, isShortColor, NULL) == 0L );
+
+    CU_ASSERT_TRUE( arraylist_removeRange(list, 0L, 6L, NULL) == OK );
+    validateEmptyArrayList(list);
+    arraylist_destroy(list, NULL);
+
+    CU_PASS("testBulkOperations() - Test Passed");
+}
+
+/* Sort keys are packed into the pointers, with a sequence number below them */
+#define SORT_LEN 100000L
+#define SORT_KEY(x)  ( (long)(x) >> 20 )
+
+static int compareSortKeys(void *a, void *b) {
+    return ( SORT_KEY(a) > SORT_KEY(b) ) - ( SORT_KEY(a) < SORT_KEY(b) );
+}
+
+static void fillSortList(ArrayList *list) {
+
+    long i;
+
+    arraylist_clear(list, NULL);
+    for (i = 0L; i < SORT_LEN; i++)
+        (void)arraylist_add(list, (void *)( ( ((i * 7919L) % 1009L) << 20 ) | i ));
+}
+
+static void validateSorted(ArrayList *list, Boolean stable) {
+
+    long i;
+    void *prev, *item;
+
+    CU_ASSERT_TRUE( arraylist_size(list) == SORT_LEN );
+    CU_ASSERT_TRUE( arraylist_get(list, 0L, &prev) == OK );
+    for (i = 1L; i < SORT_LEN; i++) {
+        CU_ASSERT_TRUE( arraylist_get(list, i, &item) == OK );
+        CU_ASSERT_TRUE( compareSortKeys(prev, item) <= 0 );
+        if (stable == TRUE && compareSortKeys(prev, item) == 0)
+            CU_ASSERT_TRUE( (long)prev < (long)item );
+        prev = item;
+    }
+}
+
+static void testArrayListSort() {
+
+    ArrayList *list;
+    Status stat;
+    int i;
+    char *item, *prev;
+
+    stat = arraylist_new(&list, CAPACITY);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testArrayListSort() - allocation failure");
+
+    // Empty and short lists
+    CU_ASSERT_TRUE( arraylist_sort(list, (int (*)(void *, void *))strcmp) == OK );
+    validateEmptyArrayList(list);
+    CU_ASSERT_TRUE( arraylist_addAll(list, (void **)array, LEN) == OK );
+    CU_ASSERT_TRUE( arraylist_sort(list, (int (*)(void *, void *))strcmp) == OK );
+    for (i = 1; i < LEN; i++) {
+        CU_ASSERT_TRUE( arraylist_get(list, i - 1, (void **)&prev) == OK );
+        CU_ASSERT_TRUE( arraylist_get(list, i, (void **)&item) == OK );
+        CU_ASSERT_TRUE( strcmp(prev, item) < 0 );
+    }
+    CU_ASSERT_TRUE( arraylist_get(list, 0L, (void **)&item) == OK );
+    CU_ASSERT_TRUE( strcmp(item, "black") == 0 );
+    CU_ASSERT_TRUE( arraylist_get(list, LEN - 1, (void **)&item) == OK );
+    CU_ASSERT_TRUE( strcmp(item, "yellow") == 0 );
+
+    // Long lists with many duplicates
+    fillSortList(list);
+    CU_ASSERT_TRUE( arraylist_sort(list, compareSortKeys) == OK );
+    validateSorted(list, FALSE);
+    fillSortList(list);
+    CU_ASSERT_TRUE( arraylist_stableSort(list, compareSortKeys) == OK );
+    validateSorted(list, TRUE);
+    CU_ASSERT_TRUE( arraylist_stableSort(list, compareSortKeys) == OK );
+    validateSorted(list, TRUE);
+    fillSortList(list);
+    CU_ASSERT_TRUE( arraylist_parallelSort(list, compareSortKeys, 3) == OK );
+    validateSorted(list, FALSE);
+    fillSortList(list);
+    CU_ASSERT_TRUE( arraylist_parallelSort(list, compareSortKeys, 4) == OK );
+    validateSorted(list, FALSE);
+
+    arraylist_destroy(list, NULL);
+
+    CU_PASS("testArrayListSort() - Test Passed");
+}
+
+static void testSortedSearch() {
+
+    ArrayList *list;
+    FrozenArray *frozen;
+    Status stat;
+    long i, index, lower;
+    void *item, *prev;
+
+    stat = arraylist_new(&list, CAPACITY);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testSortedSearch() - allocation failure");
+
+    // Searching the empty list
+    CU_ASSERT_TRUE( arraylist_lowerBound(list, (void *)(5L << 20), compareSortKeys) == 0L );
+    CU_ASSERT_TRUE( arraylist_binarySearch(list, NULL, compareSortKeys, &index) == NOT_FOUND );
+    CU_ASSERT_TRUE( index == 0L );
+    CU_ASSERT_TRUE( frozenarray_new(&frozen, list, compareSortKeys) == OK );
+    CU_ASSERT_TRUE( frozenarray_contains(frozen, NULL) == FALSE );
+    frozenarray_destroy(frozen);
+
+    // Keys 0, 2, 4, ..., 1998, each inserted three times in scrambled order
+    for (i = 0L; i < 3000L; i++) {
+        item = (void *)( ( (((i * 7L) % 1000L) * 2L) << 20 ) | i );
+        CU_ASSERT_TRUE( arraylist_insertSorted(list, item, compareSortKeys) == OK );
+    }
+    CU_ASSERT_TRUE( arraylist_size(list) == 3000L );
+    CU_ASSERT_TRUE( arraylist_get(list, 0L, &prev) == OK );
+    for (i = 1L; i < 3000L; i++) {
+        CU_ASSERT_TRUE( arraylist_get(list, i, &item) == OK );
+        CU_ASSERT_TRUE( compareSortKeys(prev, item) <= 0 );
+        // Equal keys stay in the order they were inserted in
+        if (compareSortKeys(prev, item) == 0)
+            CU_ASSERT_TRUE( (long)prev < (long)item );
+        prev = item;
+    }
+
+    for (i = 0L; i < 2000L; i++) {
+        item = (void *)(i << 20);
+        lower = ( (i + 1L) / 2L ) * 3L;
+        CU_ASSERT_TRUE( arraylist_lowerBound(list, item, compareSortKeys) == lower );
+        stat = arraylist_binarySearch(list, item, compareSortKeys, &index);
+        CU_ASSERT_TRUE( index == lower );
+        if (i % 2L == 0L) {
+            CU_ASSERT_TRUE( stat == OK );
+            CU_ASSERT_TRUE( arraylist_upperBound(list, item, compareSortKeys) == lower + 3L );
+        } else {
+            CU_ASSERT_TRUE( stat == NOT_FOUND );
+            CU_ASSERT_TRUE( arraylist_upperBound(list, item, compareSortKeys) == lower );
+        }
+    }
+    CU_ASSERT_TRUE( arraylist_upperBound(list, (void *)(5000L << 20), compareSortKeys) == 3000L );
+
+    // The frozen copy answers the same lookups
+    CU_ASSERT_TRUE( frozenarray_new(&frozen, list, compareSortKeys) == OK );
+    CU_ASSERT_TRUE( frozenarray_size(frozen) == 3000L );
+    for (i = -1L; i <= 2000L; i++) {
+        stat = frozenarray_get(frozen, (void *)(i * (1L << 20)), &item);
+        if (i >= 0L && i < 2000L && i % 2L == 0L) {
+            CU_ASSERT_TRUE( stat == OK );
+            CU_ASSERT_TRUE( SORT_KEY(item) == i );
+        } else {
+            CU_ASSERT_TRUE( stat == NOT_FOUND );
+        }
+    }
+    frozenarray_destroy(frozen);
+    arraylist_destroy(list, NULL);
+
+    CU_PASS("testSortedSearch() - Test Passed");
+}
+
 static void testArrayListClear() {
 
     ArrayList *list;
@@ -350,6 +594,287 @@ static void testArrayListClear() {
     CU_PASS("testArrayListClear() - Test Passed");
 }
 
+static void testArrayListCursor() {
+
+    Iterator *iter;
+    Cursor cursor;
+    ArrayList *list;
+    Status stat;
+    int i;
+    char *item, *other;
+
+    stat = arraylist_new(&list, CAPACITY);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testArrayListCursor() - allocation failure");
+
+    arraylist_cursor(list, &cursor);
+    CU_ASSERT_TRUE( cursor_hasNext(&cursor) == FALSE );
+    CU_ASSERT_TRUE( arraylist_cursorNext(&cursor, (void **)&item) == ITER_END );
+
+    for (i = 0; i < LEN; i++)
+        CU_ASSERT_TRUE( arraylist_add(list, array[i]) == OK );
+    CU_ASSERT_TRUE( arraylist_iterator(list, &iter) == OK );
+
+    // The cursor must visit the same items in the same order as the iterator
+    i = 0;
+    arraylist_cursor(list, &cursor);
+    while (cursor_hasNext(&cursor) == TRUE) {
+        CU_ASSERT_TRUE( arraylist_cursorNext(&cursor, (void **)&item) == OK );
+        CU_ASSERT_TRUE( iterator_next(iter, (void **)&other) == OK );
+        CU_ASSERT_TRUE( item == other );
+        i++;
+    }
+    CU_ASSERT_EQUAL( i, LEN );
+    CU_ASSERT_TRUE( arraylist_cursorNext(&cursor, (void **)&item) == ITER_END );
+    iterator_destroy(iter);
+
+    // A structural change invalidates any cursor already in progress
+    arraylist_cursor(list, &cursor);
+    CU_ASSERT_TRUE( arraylist_cursorNext(&cursor, (void **)&item) == OK );
+    CU_ASSERT_TRUE( arraylist_add(list, singleItem) == OK );
+    CU_ASSERT_TRUE( arraylist_cursorNext(&cursor, (void **)&item) == CONCURRENT_MODIFICATION );
+    arraylist_destroy(list, NULL);
+
+    CU_PASS("testArrayListCursor() - Test Passed");
+}
+
+/* Visitor recording each item it is passed, stopping once `limit` items have been seen */
+static char *visited[LEN];
+static int nVisited = 0, limit = LEN;
+static Boolean visit(void *item, void *context) {
+    (void)context;
+    visited[nVisited++] = (char *)item;
+    return ( nVisited < limit ) ? TRUE : FALSE;
+}
+
+static void testArrayListForEach() {
+
+    ArrayList *list;
+    Status stat;
+    int i;
+
+    stat = arraylist_new(&list, CAPACITY);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testArrayListForEach() - allocation failure");
+
+    nVisited = 0;
+    CU_ASSERT_TRUE( arraylist_forEach(list, visit, NULL) == TRUE );
+    CU_ASSERT_EQUAL( nVisited, 0 );
+    for (i = 0; i < LEN; i++)
+        CU_ASSERT_TRUE( arraylist_add(list, array[i]) == OK );
+
+    // Every item is visited in index order
+    nVisited = 0;
+    limit = LEN + 1;
+    CU_ASSERT_TRUE( arraylist_forEach(list, visit, NULL) == TRUE );
+    CU_ASSERT_EQUAL( nVisited, LEN );
+    for (i = 0; i < LEN; i++)
+        CU_ASSERT_TRUE( visited[i] == array[i] );
+
+    // The walk ends as soon as the visitor asks it to
+    nVisited = 0;
+    limit = LEN / 2;
+    CU_ASSERT_TRUE( arraylist_forEach(list, visit, NULL) == FALSE );
+    CU_ASSERT_EQUAL( nVisited, LEN / 2 );
+    arraylist_destroy(list, NULL);
+
+    CU_PASS("testArrayListForEach() - Test Passed");
+}
+
+#define PARALLEL_LEN 100000L
+
+/* Reducer and combiner summing the items, stored as longs */
+static void *sumItems(void *partial, void *item, void *context) {
+    (void)context;
+    return (void *)( (long)partial + (long)item );
+}
+static void *sumPartials(void *partial, void *other, void *context) {
+    (void)context;
+    return (void *)( (long)partial + (long)other );
+}
+
+/* Visitor counting the items it is passed into `context`, stopping at the item 1000 */
+static Boolean countItems(void *item, void *context) {
+    __atomic_add_fetch((long *)context, 1L, __ATOMIC_RELAXED);
+    return ( (long)item != 1000L ) ? TRUE : FALSE;
+}
+
+static void testArrayListParallel() {
+
+    ArrayList *list;
+    Status stat;
+    long i, count;
+    void *item;
+
+    stat = arraylist_new(&list, CAPACITY);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testArrayListParallel() - allocation failure");
+
+    CU_ASSERT_TRUE( arraylist_parallelReduce(list, 4, sumItems, sumPartials, NULL) == NULL );
+    for (i = 1L; i <= PARALLEL_LEN; i++)
+        CU_ASSERT_TRUE( arraylist_add(list, (void *)i) == OK );
+
+    // Any number of threads reduces to the same sum
+    CU_ASSERT_EQUAL( (long)arraylist_parallelReduce(list, 1, sumItems, sumPartials, NULL),
+                     PARALLEL_LEN * ( PARALLEL_LEN + 1L ) / 2L );
+    CU_ASSERT_EQUAL( (long)arraylist_parallelReduce(list, 4, sumItems, sumPartials, NULL),
+                     PARALLEL_LEN * ( PARALLEL_LEN + 1L ) / 2L );
+    CU_ASSERT_EQUAL( (long)arraylist_parallelReduce(list, 1000, sumItems, sumPartials, NULL),
+                     PARALLEL_LEN * ( PARALLEL_LEN + 1L ) / 2L );
+
+    // Every item is visited once, unless the walk is stopped
+    count = 0L;
+    CU_ASSERT_TRUE( arraylist_remove(list, 999L, &item) == OK );
+    CU_ASSERT_TRUE( arraylist_parallelForEach(list, 4, countItems, &count) == TRUE );
+    CU_ASSERT_EQUAL( count, PARALLEL_LEN - 1L );
+    count = 0L;
+    CU_ASSERT_TRUE( arraylist_add(list, (void *)1000L) == OK );
+    CU_ASSERT_TRUE( arraylist_parallelForEach(list, 4, countItems, &count) == FALSE );
+    CU_ASSERT_TRUE( count <= PARALLEL_LEN );
+    arraylist_destroy(list, NULL);
+
+    CU_PASS("testArrayListParallel() - Test Passed");
+}
+
+static void testCopyOnWrite() {
+
+    CopyOnWriteArrayList *list;
+    ArrayList *snapshot;
+    char *item;
+    long i;
+
+    Status stat = cow_arraylist_new(&list, CAPACITY);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testCopyOnWrite() - allocation failure");
+
+    CU_ASSERT_TRUE( cow_arraylist_isEmpty(list) == TRUE );
+    CU_ASSERT_TRUE( cow_arraylist_get(list, 0L, (void **)&item) == STRUCT_EMPTY );
+    CU_ASSERT_TRUE( cow_arraylist_addAll(list, (void **)array, 4L) == OK );
+    CU_ASSERT_TRUE( cow_arraylist_add(list, array[5]) == OK );
+    CU_ASSERT_TRUE( cow_arraylist_insert(list, 4L, array[4]) == OK );
+    CU_ASSERT_TRUE( cow_arraylist_insert(list, 9L, array[6]) == INVALID_INDEX );
+    CU_ASSERT_EQUAL( cow_arraylist_size(list), 6L );
+    for (i = 0L; i < 6L; i++) {
+        CU_ASSERT_TRUE( cow_arraylist_get(list, i, (void **)&item) == OK );
+        CU_ASSERT_TRUE( item == array[i] );
+    }
+
+    // A snapshot keeps its contents while newer versions are published
+    CU_ASSERT_TRUE( cow_arraylist_acquire(list, &snapshot) == OK );
+    CU_ASSERT_TRUE( cow_arraylist_set(list, 0L, array[8], (void **)&item) == OK );
+    CU_ASSERT_TRUE( item == array[0] );
+    CU_ASSERT_TRUE( cow_arraylist_remove(list, 5L, (void **)&item) == OK );
+    CU_ASSERT_TRUE( item == array[5] );
+    CU_ASSERT_EQUAL( arraylist_size(snapshot), 6L );
+    CU_ASSERT_TRUE( arraylist_get(snapshot, 0L, (void **)&item) == OK );
+    CU_ASSERT_TRUE( item == array[0] );
+    cow_arraylist_release(list);
+    CU_ASSERT_EQUAL( cow_arraylist_size(list), 5L );
+    CU_ASSERT_TRUE( cow_arraylist_get(list, 0L, (void **)&item) == OK );
+    CU_ASSERT_TRUE( item == array[8] );
+
+    // Cleared items are retired, not freed while readers may still hold them
+    CU_ASSERT_TRUE( cow_arraylist_clear(list, NULL) == OK );
+    CU_ASSERT_TRUE( cow_arraylist_isEmpty(list) == TRUE );
+    CU_ASSERT_TRUE( cow_arraylist_add(list, malloc(8)) == OK );
+    CU_ASSERT_TRUE( cow_arraylist_add(list, malloc(8)) == OK );
+    CU_ASSERT_TRUE( cow_arraylist_clear(list, free) == OK );
+    CU_ASSERT_TRUE( cow_arraylist_add(list, malloc(8)) == OK );
+    cow_arraylist_destroy(list, free);
+
+    CU_PASS("testCopyOnWrite() - Test Passed");
+}
+
+/* State shared between the copy-on-write writer and its readers */
+#define COW_READERS 3
+#define COW_ITEMS 2000L
+static CopyOnWriteArrayList *cowList;
+static int cowDone;
+
+/**
+ * Reader thread, checks that every version it reads holds the items 0 to size - 1 in order.
+ */
+static void *_readVersions(void *arg) {
+
+    long size, i, *bad = (long *)arg;
+    void *item;
+
+    while (__atomic_load_n(&cowDone, __ATOMIC_ACQUIRE) == 0) {
+        size = cow_arraylist_size(cowList);
+        for (i = 0L; i < size; i += 7L) {
+            if (cow_arraylist_get(cowList, i, &item) != OK || (long)item != i)
+                __atomic_fetch_add(bad, 1L, __ATOMIC_RELAXED);
+        }
+    }
+
+    return NULL;
+}
+
+static void testCopyOnWriteConcurrent() {
+
+    pthread_t readers[COW_READERS];
+    long i, bad = 0L;
+    int j;
+
+    if (cow_arraylist_new(&cowList, 0L) != OK)
+        CU_FAIL_FATAL("ERROR: testCopyOnWriteConcurrent() - allocation failure");
+
+    cowDone = 0;
+    for (j = 0; j < COW_READERS; j++)
+        CU_ASSERT_TRUE( pthread_create(&readers[j], NULL, _readVersions, &bad) == 0 );
+    for (i = 0L; i < COW_ITEMS; i++)
+        CU_ASSERT_TRUE( cow_arraylist_add(cowList, (void *)i) == OK );
+    __atomic_store_n(&cowDone, 1, __ATOMIC_RELEASE);
+    for (j = 0; j < COW_READERS; j++)
+        CU_ASSERT_TRUE( pthread_join(readers[j], NULL) == 0 );
+
+    CU_ASSERT_EQUAL( bad, 0L );
+    CU_ASSERT_EQUAL( cow_arraylist_size(cowList), COW_ITEMS );
+    cow_arraylist_destroy(cowList, NULL);
+
+    CU_PASS("testCopyOnWriteConcurrent() - Test Passed");
+}
+
+#define LARGE_LEN 1000000L
+
+static void testLargePages() {
+
+    ArrayList *list;
+    int flags[] = { 0, LARGE_PAGES_LOCKED | LARGE_PAGES_HUGETLB };
+    void *item;
+    long i;
+    int j;
+
+    for (j = 0; j < 2; j++) {
+        Status stat = arraylist_newWithAllocator(&list, CAPACITY, allocator_largePages(flags[j]));
+        if (stat != OK)
+            CU_FAIL_FATAL("ERROR: testLargePages() - allocation failure");
+
+        // Grows from a small block into a mapping, then remaps it
+        for (i = 0L; i < LARGE_LEN; i++)
+            CU_ASSERT_TRUE( arraylist_add(list, (void *)i) == OK );
+        CU_ASSERT_EQUAL( arraylist_size(list), LARGE_LEN );
+        for (i = 0L; i < LARGE_LEN; i += 997L) {
+            CU_ASSERT_TRUE( arraylist_get(list, i, &item) == OK );
+            CU_ASSERT_EQUAL( (long)item, i );
+        }
+
+        // Shrinks back into a small block
+        CU_ASSERT_TRUE( arraylist_removeRange(list, 10L, LARGE_LEN, NULL) == OK );
+        CU_ASSERT_TRUE( arraylist_trimToSize(list) == OK );
+        for (i = 0L; i < 10L; i++) {
+            CU_ASSERT_TRUE( arraylist_get(list, i, &item) == OK );
+            CU_ASSERT_EQUAL( (long)item, i );
+        }
+        CU_ASSERT_TRUE( arraylist_ensureCapacity(list, LARGE_LEN) == OK );
+        CU_ASSERT_TRUE( arraylist_get(list, 9L, &item) == OK );
+        CU_ASSERT_EQUAL( (long)item, 9L );
+        arraylist_destroy(list, NULL);
+    }
+
+    CU_PASS("testLargePages() - Test Passed");
+}
+
 #define UNUSED __attribute__((unused))
 int main(UNUSED int argc, UNUSED char **argv) {
 
@@ -372,9 +897,19 @@ int main(UNUSED int argc, UNUSED char **argv) {
     CU_add_test(suite, "ArrayList - Random Delete", testRandomDelete);
     CU_add_test(suite, "ArrayList - Ensure", testEnsureCapacity);
     CU_add_test(suite, "ArrayList - Trim to Size", testTrimToSize);
+    CU_add_test(suite, "ArrayList - Growth Factor", testGrowthFactor);
     CU_add_test(suite, "ArrayList - Array", testArrayListToArray);
     CU_add_test(suite, "ArrayList - Iterator", testArrayListIterator);
+    CU_add_test(suite, "ArrayList - Cursor", testArrayListCursor);
+    CU_add_test(suite, "ArrayList - For Each", testArrayListForEach);
+    CU_add_test(suite, "ArrayList - Parallel", testArrayListParallel);
     CU_add_test(suite, "ArrayList - Clear", testArrayListClear);
+    CU_add_test(suite, "ArrayList - Bulk Operations", testBulkOperations);
+    CU_add_test(suite, "ArrayList - Sort", testArrayListSort);
+    CU_add_test(suite, "ArrayList - Sorted Search", testSortedSearch);
+    CU_add_test(suite, "ArrayList - Copy on Write", testCopyOnWrite);
+    CU_add_test(suite, "ArrayList - Copy on Write Concurrent", testCopyOnWriteConcurrent);
+    CU_add_test(suite, "ArrayList - Large Pages", testLargePages);
 
     CU_basic_set_mode(CU_BRM_VERBOSE);
     CU_basic_run_tests();
@@ -0,0 +1,144 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2020 Cole Vikupitz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <stdlib.h>
+#include <CUnit/Basic.h>
+#include "bloom_filter.h"
+#include "hashing.h"
+
+/* Sizes and rates used for testing */
+#define N 100000L
+#define FPP 0.01
+
+/* Elements are stored directly in the pointers */
+#define E(x) ((void *)(long)(x))
+
+static void testEmptyFilter() {
+
+    BloomFilter *filter;
+    long i;
+
+    Status stat = bloomfilter_new(&filter, hashing_pointer, N, FPP);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testEmptyFilter() - allocation failure");
+
+    for (i = 0L; i < N; i++)
+        CU_ASSERT_TRUE( bloomfilter_mightContain(filter, E(i)) == FALSE );
+    bloomfilter_destroy(filter);
+
+    // Invalid sizes fall back on the defaults
+    stat = bloomfilter_new(&filter, hashing_pointer, 0L, 0.0);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testEmptyFilter() - allocation failure");
+    bloomfilter_add(filter, E(1));
+    CU_ASSERT_TRUE( bloomfilter_mightContain(filter, E(1)) == TRUE );
+    bloomfilter_destroy(filter);
+
+    CU_PASS("testEmptyFilter() - Test Passed");
+}
+
+static void testFalsePositives() {
+
+    BloomFilter *filter;
+    long i, positives = 0L;
+
+    Status stat = bloomfilter_new(&filter, hashing_pointer, N, FPP);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testFalsePositives() - allocation failure");
+
+    // Never a false negative, and false positives near the rate asked for
+    for (i = 0L; i < N; i++)
+        bloomfilter_add(filter, E(i));
+    for (i = 0L; i < N; i++)
+        CU_ASSERT_TRUE( bloomfilter_mightContain(filter, E(i)) == TRUE );
+    for (i = N; i < 2L * N; i++)
+        positives += ( bloomfilter_mightContain(filter, E(i)) == TRUE ) ? 1L : 0L;
+    CU_ASSERT_TRUE( positives < (long)( 2.0 * FPP * N ) );
+
+    // A few bits per element, rather than a hashset entry's tens of bytes
+    CU_ASSERT_TRUE( bloomfilter_memoryUsage(filter) < 2L * N );
+
+    bloomfilter_clear(filter);
+    for (i = 0L; i < N; i++)
+        CU_ASSERT_TRUE( bloomfilter_mightContain(filter, E(i)) == FALSE );
+    bloomfilter_destroy(filter);
+
+    CU_PASS("testFalsePositives() - Test Passed");
+}
+
+static void testMerge() {
+
+    BloomFilter *evens, *odds, *other;
+    long i;
+
+    Status stat = bloomfilter_new(&evens, hashing_pointer, N, FPP);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testMerge() - allocation failure");
+    stat = bloomfilter_newLike(&odds, evens);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testMerge() - allocation failure");
+    stat = bloomfilter_new(&other, hashing_pointer, N, FPP);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testMerge() - allocation failure");
+
+    for (i = 0L; i < N; i++)
+        bloomfilter_add(( i % 2L == 0L ) ? evens : odds, E(i));
+    CU_ASSERT_TRUE( bloomfilter_merge(evens, odds) == TRUE );
+    for (i = 0L; i < N; i++)
+        CU_ASSERT_TRUE( bloomfilter_mightContain(evens, E(i)) == TRUE );
+
+    // Filters drawing their own seeds cannot be merged
+    CU_ASSERT_TRUE( bloomfilter_merge(evens, other) == FALSE );
+
+    bloomfilter_destroy(evens);
+    bloomfilter_destroy(odds);
+    bloomfilter_destroy(other);
+
+    CU_PASS("testMerge() - Test Passed");
+}
+
+#define UNUSED __attribute__((unused))
+int main(UNUSED int argc, UNUSED char **argv) {
+
+    if (CU_initialize_registry() != CUE_SUCCESS) {
+        return CU_get_error();
+    }
+
+    CU_pSuite suite = CU_add_suite("BloomFilter Tests", NULL, NULL);
+    if (suite == NULL) {
+        CU_cleanup_registry();
+        return CU_get_error();
+    }
+
+    CU_add_test(suite, "BloomFilter - Empty Filter", testEmptyFilter);
+    CU_add_test(suite, "BloomFilter - False Positives", testFalsePositives);
+    CU_add_test(suite, "BloomFilter - Merge", testMerge);
+
+    CU_basic_set_mode(CU_BRM_VERBOSE);
+    CU_basic_run_tests();
+    CU_cleanup_registry();
+
+    return 0;
+}
@@ -22,9 +22,13 @@
  * SOFTWARE.
  */
 
+#include <stdint.h>
 #include <stdlib.h>
+#include <pthread.h>
 #include <CUnit/Basic.h>
 #include "bounded_queue.h"
+#include "ts_bounded_queue.h"
+#include "ts_lock.h"
 
 /* Single item used for testing */
 static char *singleItem = "Test";
@@ -226,6 +230,237 @@ static void testBoundedQueueClear() {
     CU_PASS("testBoundedQueueClear() - Test Passed");
 }
 
+static void testBoundedQueueCursor() {
+
+    Iterator *iter;
+    Cursor cursor;
+    BoundedQueue *queue;
+    Status stat;
+    int i;
+    char *item, *other;
+
+    stat = boundedqueue_new(&queue, LEN);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testBoundedQueueCursor() - allocation failure");
+
+    boundedqueue_cursor(queue, &cursor);
+    CU_ASSERT_TRUE( cursor_hasNext(&cursor) == FALSE );
+    CU_ASSERT_TRUE( boundedqueue_cursorNext(&cursor, (void **)&item) == ITER_END );
+
+    for (i = 0; i < LEN; i++)
+        CU_ASSERT_TRUE( boundedqueue_add(queue, array[i]) == OK );
+    CU_ASSERT_TRUE( boundedqueue_iterator(queue, &iter) == OK );
+
+    // The cursor must visit the same items in the same order as the iterator
+    i = 0;
+    boundedqueue_cursor(queue, &cursor);
+    while (cursor_hasNext(&cursor) == TRUE) {
+        CU_ASSERT_TRUE( boundedqueue_cursorNext(&cursor, (void **)&item) == OK );
+        CU_ASSERT_TRUE( iterator_next(iter, (void **)&other) == OK );
+        CU_ASSERT_TRUE( item == other );
+        i++;
+    }
+    CU_ASSERT_EQUAL( i, LEN );
+    CU_ASSERT_TRUE( boundedqueue_cursorNext(&cursor, (void **)&item) == ITER_END );
+    iterator_destroy(iter);
+
+    // A structural change invalidates any cursor already in progress
+    boundedqueue_cursor(queue, &cursor);
+    CU_ASSERT_TRUE( boundedqueue_cursorNext(&cursor, (void **)&item) == OK );
+    CU_ASSERT_TRUE( boundedqueue_poll(queue, (void **)&item) == OK );
+    CU_ASSERT_TRUE( boundedqueue_cursorNext(&cursor, (void **)&item) == CONCURRENT_MODIFICATION );
+    boundedqueue_destroy(queue, NULL);
+
+    CU_PASS("testBoundedQueueCursor() - Test Passed");
+}
+
+#define THREADS 4
+#define PER_THREAD 20000L
+#define BATCH 8
+
+/**
+ * Producer thread, puts the values 1..PER_THREAD into the queue.
+ */
+static void *_produce(void *arg) {
+
+    ConcurrentBoundedQueue *queue = (ConcurrentBoundedQueue *)arg;
+    long i;
+
+    for (i = 1L; i <= PER_THREAD; i++) {
+        if (ts_boundedqueue_put(queue, (void *)i) != OK)
+            return arg;
+    }
+
+    return NULL;
+}
+
+/**
+ * Consumer thread, takes values in batches until it sees a NULL and returns their sum.
+ */
+static void *_consume(void *arg) {
+
+    ConcurrentBoundedQueue *queue = (ConcurrentBoundedQueue *)arg;
+    void *batch[BATCH];
+    long i, count, sum = 0L;
+    Boolean done = FALSE;
+
+    while (done == FALSE) {
+        if (ts_boundedqueue_take(queue, &(batch[0])) != OK)
+            return (void *)-1L;
+        count = 1L + ts_boundedqueue_drainTo(queue, &(batch[1]), BATCH - 1);
+        for (i = 0L; i < count; i++) {
+            if (batch[i] == NULL) {
+                // Hands any surplus stop marker back to the other consumers
+                if (done == TRUE)
+                    ts_boundedqueue_put(queue, NULL);
+                done = TRUE;
+            } else {
+                sum += (long)batch[i];
+            }
+        }
+    }
+
+    return (void *)sum;
+}
+
+static void testBlockingQueue() {
+
+    ConcurrentBoundedQueue *queue;
+    pthread_t producers[THREADS], consumers[THREADS];
+    void *item, *result;
+    long i, sum = 0L;
+    Status stat;
+
+    stat = ts_boundedqueue_new(&queue, CAPACITY);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testBlockingQueue() - allocation failure");
+
+    // Timed operations give up once the timeout elapses
+    CU_ASSERT_TRUE( ts_boundedqueue_takeTimed(queue, &item, 10L) == STRUCT_EMPTY );
+    for (i = 0L; i < CAPACITY; i++)
+        CU_ASSERT_TRUE( ts_boundedqueue_putTimed(queue, array[i], 10L) == OK );
+    CU_ASSERT_TRUE( ts_boundedqueue_putTimed(queue, singleItem, 10L) == STRUCT_FULL );
+    CU_ASSERT_TRUE( ts_boundedqueue_takeTimed(queue, &item, 10L) == OK );
+    CU_ASSERT_TRUE( item == array[0] );
+
+    // Draining returns the remaining items in order, bounded by `max`
+    void *drained[CAPACITY];
+    CU_ASSERT_EQUAL( ts_boundedqueue_drainTo(queue, drained, 2L), 2L );
+    CU_ASSERT_TRUE( drained[0] == array[1] && drained[1] == array[2] );
+    CU_ASSERT_EQUAL( ts_boundedqueue_drainTo(queue, drained, CAPACITY), 1L );
+    CU_ASSERT_TRUE( drained[0] == array[3] );
+    CU_ASSERT_EQUAL( ts_boundedqueue_drainTo(queue, drained, CAPACITY), 0L );
+
+    // Producers and consumers block on the small queue, every item must arrive exactly once
+    for (i = 0L; i < THREADS; i++) {
+        CU_ASSERT_TRUE( pthread_create(&consumers[i], NULL, _consume, queue) == 0 );
+        CU_ASSERT_TRUE( pthread_create(&producers[i], NULL, _produce, queue) == 0 );
+    }
+    for (i = 0L; i < THREADS; i++) {
+        CU_ASSERT_TRUE( pthread_join(producers[i], &result) == 0 );
+        CU_ASSERT_TRUE( result == NULL );
+    }
+    for (i = 0L; i < THREADS; i++)
+        CU_ASSERT_TRUE( ts_boundedqueue_put(queue, NULL) == OK );
+    for (i = 0L; i < THREADS; i++) {
+        CU_ASSERT_TRUE( pthread_join(consumers[i], &result) == 0 );
+        sum += (long)result;
+    }
+    CU_ASSERT_EQUAL( sum, THREADS * (PER_THREAD * (PER_THREAD + 1L) / 2L) );
+    CU_ASSERT_TRUE( ts_boundedqueue_isEmpty(queue) == TRUE );
+
+    // The lock is only instrumented if compiled in
+    LockStats stats;
+    ts_boundedqueue_lockStats(queue, &stats);
+#ifdef CDS_LOCK_STATS
+    CU_ASSERT_TRUE( stats.acquisitions >= 2L * THREADS * PER_THREAD );
+    CU_ASSERT_TRUE( stats.contended <= stats.acquisitions );
+    CU_ASSERT_TRUE( stats.waitNanos >= 0L && stats.holdNanos > 0L );
+#else
+    CU_ASSERT_TRUE( stats.acquisitions == 0L && stats.contended == 0L );
+    CU_ASSERT_TRUE( stats.waitNanos == 0L && stats.holdNanos == 0L );
+#endif
+    ts_boundedqueue_destroy(queue, NULL);
+
+    CU_PASS("testBlockingQueue() - Test Passed");
+}
+
+static void testBlockingQueuePolicies() {
+
+    LockPolicy policies[] = { LOCK_MUTEX, LOCK_RWLOCK, LOCK_NORMAL, LOCK_SPIN, LOCK_TICKET };
+    ConcurrentBoundedQueue *queue;
+    pthread_t producers[THREADS], consumers[THREADS];
+    void *item, *result;
+    long i, sum;
+    int p;
+
+    for (p = 0; p < 5; p++) {
+        ts_lock_setDefaultPolicy(policies[p]);
+        if (ts_boundedqueue_new(&queue, CAPACITY) != OK)
+            CU_FAIL_FATAL("ERROR: testBlockingQueuePolicies() - allocation failure");
+
+        // Every policy lets the thread holding the lock acquire it again
+        ts_boundedqueue_lockWrite(queue);
+        CU_ASSERT_TRUE( ts_boundedqueue_put(queue, singleItem) == OK );
+        CU_ASSERT_TRUE( ts_boundedqueue_size(queue) == 1L );
+        CU_ASSERT_TRUE( ts_boundedqueue_take(queue, &item) == OK );
+        CU_ASSERT_TRUE( item == singleItem );
+        ts_boundedqueue_unlock(queue);
+
+        sum = 0L;
+        for (i = 0L; i < THREADS; i++) {
+            CU_ASSERT_TRUE( pthread_create(&consumers[i], NULL, _consume, queue) == 0 );
+            CU_ASSERT_TRUE( pthread_create(&producers[i], NULL, _produce, queue) == 0 );
+        }
+        for (i = 0L; i < THREADS; i++)
+            CU_ASSERT_TRUE( pthread_join(producers[i], &result) == 0 && result == NULL );
+        for (i = 0L; i < THREADS; i++)
+            CU_ASSERT_TRUE( ts_boundedqueue_put(queue, NULL) == OK );
+        for (i = 0L; i < THREADS; i++) {
+            CU_ASSERT_TRUE( pthread_join(consumers[i], &result) == 0 );
+            sum += (long)result;
+        }
+        CU_ASSERT_EQUAL( sum, THREADS * (PER_THREAD * (PER_THREAD + 1L) / 2L) );
+        CU_ASSERT_TRUE( ts_boundedqueue_isEmpty(queue) == TRUE );
+        ts_boundedqueue_destroy(queue, NULL);
+    }
+    ts_lock_setDefaultPolicy(LOCK_MUTEX);
+
+    CU_PASS("testBlockingQueuePolicies() - Test Passed");
+}
+
+static void testBlockingQueuePlacement() {
+
+    ConcurrentBoundedQueue *queue;
+    void *item;
+    Status stat;
+
+    // Out of range nodes leave the placement to the kernel
+    ts_lock_setDefaultNode(64);
+    CU_ASSERT_EQUAL( ts_lock_getDefaultNode(), -1 );
+
+    // Node 0 always exists, and the queue starts on a cache line of its own
+    ts_lock_setDefaultNode(0);
+    CU_ASSERT_EQUAL( ts_lock_getDefaultNode(), 0 );
+    stat = ts_boundedqueue_new(&queue, CAPACITY);
+    ts_lock_setDefaultNode(-1);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testBlockingQueuePlacement() - allocation failure");
+    CU_ASSERT_EQUAL( (uintptr_t)queue % CDS_CACHE_LINE, 0UL );
+    CU_ASSERT_TRUE( ts_boundedqueue_put(queue, singleItem) == OK );
+    CU_ASSERT_TRUE( ts_boundedqueue_take(queue, &item) == OK );
+    CU_ASSERT_TRUE( item == singleItem );
+    ts_boundedqueue_destroy(queue, NULL);
+
+    stat = ts_boundedqueue_new(&queue, CAPACITY);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testBlockingQueuePlacement() - allocation failure");
+    CU_ASSERT_EQUAL( (uintptr_t)queue % CDS_CACHE_LINE, 0UL );
+    ts_boundedqueue_destroy(queue, NULL);
+
+    CU_PASS("testBlockingQueuePlacement() - Test Passed");
+}
+
 #define UNUSED __attribute__((unused))
 int main(UNUSED int argc, UNUSED char **argv) {
 
@@ -245,7 +480,11 @@ int main(UNUSED int argc, UNUSED char **argv) {
     CU_add_test(suite, "BoundedQueue - Capacity Check", testCapacity);
     CU_add_test(suite, "BoundedQueue - Array", testBoundedQueueToArray);
     CU_add_test(suite, "BoundedQueue - Iterator", testBoundedQueueIterator);
+    CU_add_test(suite, "BoundedQueue - Cursor", testBoundedQueueCursor);
     CU_add_test(suite, "BoundedQueue - Clear", testBoundedQueueClear);
+    CU_add_test(suite, "BoundedQueue - Blocking Queue", testBlockingQueue);
+    CU_add_test(suite, "BoundedQueue - Blocking Queue Policies", testBlockingQueuePolicies);
+    CU_add_test(suite, "BoundedQueue - Blocking Queue Placement", testBlockingQueuePlacement);
 
     CU_basic_set_mode(CU_BRM_VERBOSE);
     CU_basic_run_tests();
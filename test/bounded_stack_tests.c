@@ -228,6 +228,50 @@ static void testBoundedStackClear() {
     CU_PASS("testBoundedStackClear() - Test Passed");
 }
 
+static void testBoundedStackCursor() {
+
+    Iterator *iter;
+    Cursor cursor;
+    BoundedStack *stack;
+    Status stat;
+    int i;
+    char *item, *other;
+
+    stat = boundedstack_new(&stack, LEN);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testBoundedStackCursor() - allocation failure");
+
+    boundedstack_cursor(stack, &cursor);
+    CU_ASSERT_TRUE( cursor_hasNext(&cursor) == FALSE );
+    CU_ASSERT_TRUE( boundedstack_cursorNext(&cursor, (void **)&item) == ITER_END );
+
+    for (i = 0; i < LEN; i++)
+        CU_ASSERT_TRUE( boundedstack_push(stack, array[i]) == OK );
+    CU_ASSERT_TRUE( boundedstack_iterator(stack, &iter) == OK );
+
+    // The cursor must visit the same items in the same order as the iterator
+    i = 0;
+    boundedstack_cursor(stack, &cursor);
+    while (cursor_hasNext(&cursor) == TRUE) {
+        CU_ASSERT_TRUE( boundedstack_cursorNext(&cursor, (void **)&item) == OK );
+        CU_ASSERT_TRUE( iterator_next(iter, (void **)&other) == OK );
+        CU_ASSERT_TRUE( item == other );
+        i++;
+    }
+    CU_ASSERT_EQUAL( i, LEN );
+    CU_ASSERT_TRUE( boundedstack_cursorNext(&cursor, (void **)&item) == ITER_END );
+    iterator_destroy(iter);
+
+    // A structural change invalidates any cursor already in progress
+    boundedstack_cursor(stack, &cursor);
+    CU_ASSERT_TRUE( boundedstack_cursorNext(&cursor, (void **)&item) == OK );
+    CU_ASSERT_TRUE( boundedstack_pop(stack, (void **)&item) == OK );
+    CU_ASSERT_TRUE( boundedstack_cursorNext(&cursor, (void **)&item) == CONCURRENT_MODIFICATION );
+    boundedstack_destroy(stack, NULL);
+
+    CU_PASS("testBoundedStackCursor() - Test Passed");
+}
+
 #define UNUSED __attribute__((unused))
 int main(UNUSED int argc, UNUSED char **argv) {
 
@@ -247,6 +291,7 @@ int main(UNUSED int argc, UNUSED char **argv) {
     CU_add_test(suite, "BoundedStack - Capacity Check", testCapacity);
     CU_add_test(suite, "BoundedStack - Array", testBoundedStackToArray);
     CU_add_test(suite, "BoundedStack - Iterator", testBoundedStackIterator);
+    CU_add_test(suite, "BoundedStack - Cursor", testBoundedStackCursor);
     CU_add_test(suite, "BoundedStack - Clear", testBoundedStackClear);
 
     CU_basic_set_mode(CU_BRM_VERBOSE);
@@ -412,6 +412,143 @@ static void testCircularListClear() {
     CU_PASS("testCircularListClear() - Test Passed");
 }
 
+static void testCircularListCursor() {
+
+    Iterator *iter;
+    Cursor cursor;
+    CircularList *list;
+    Status stat;
+    int i;
+    char *item, *other;
+
+    stat = circularlist_new(&list);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testCircularListCursor() - allocation failure");
+
+    circularlist_cursor(list, &cursor);
+    CU_ASSERT_TRUE( cursor_hasNext(&cursor) == FALSE );
+    CU_ASSERT_TRUE( circularlist_cursorNext(&cursor, (void **)&item) == ITER_END );
+
+    for (i = 0; i < LEN; i++)
+        CU_ASSERT_TRUE( circularlist_addLast(list, array[i]) == OK );
+    CU_ASSERT_TRUE( circularlist_iterator(list, &iter) == OK );
+
+    // The cursor must visit the same items in the same order as the iterator
+    i = 0;
+    circularlist_cursor(list, &cursor);
+    while (cursor_hasNext(&cursor) == TRUE) {
+        CU_ASSERT_TRUE( circularlist_cursorNext(&cursor, (void **)&item) == OK );
+        CU_ASSERT_TRUE( iterator_next(iter, (void **)&other) == OK );
+        CU_ASSERT_TRUE( item == other );
+        i++;
+    }
+    CU_ASSERT_EQUAL( i, LEN );
+    CU_ASSERT_TRUE( circularlist_cursorNext(&cursor, (void **)&item) == ITER_END );
+    iterator_destroy(iter);
+
+    // A structural change invalidates any cursor already in progress
+    circularlist_cursor(list, &cursor);
+    CU_ASSERT_TRUE( circularlist_cursorNext(&cursor, (void **)&item) == OK );
+    CU_ASSERT_TRUE( circularlist_addFirst(list, singleItem) == OK );
+    CU_ASSERT_TRUE( circularlist_cursorNext(&cursor, (void **)&item) == CONCURRENT_MODIFICATION );
+    circularlist_destroy(list, NULL);
+
+    CU_PASS("testCircularListCursor() - Test Passed");
+}
+
+/* Checks that `list` holds exactly the elements `expected` of `array`, in order */
+static void validateOrder(CircularList *list, const int *expected, long len) {
+
+    Array *arr;
+    long i;
+
+    CU_ASSERT_TRUE( circularlist_size(list) == len );
+    if (circularlist_toArray(list, &arr) != OK)
+        return;
+    for (i = 0L; i < len && i < arr->len; i++)
+        CU_ASSERT_TRUE( arr->items[i] == array[expected[i]] );
+    FREE_ARRAY(arr)
+}
+
+static void testCircularListHandles() {
+
+    CircularList *list;
+    ListLink *handles[LEN];
+    Status stat;
+    char *item;
+    int i;
+
+    stat = circularlist_new(&list);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testCircularListHandles() - allocation failure");
+
+    CU_ASSERT_TRUE( circularlist_firstHandle(list) == NULL );
+    for (i = 0; i < 4; i++)
+        CU_ASSERT_TRUE( circularlist_addLastHandle(list, array[i], &handles[i]) == OK );
+    CU_ASSERT_TRUE( circularlist_addFirstHandle(list, array[4], &handles[4]) == OK );
+    CU_ASSERT_TRUE( circularlist_insertAfter(list, handles[3], array[5], &handles[5]) == OK );
+    validateOrder(list, (int []){4, 0, 1, 2, 3, 5}, 6L);
+    CU_ASSERT_TRUE( circularlist_firstHandle(list) == handles[4] );
+    CU_ASSERT_TRUE( handles[5]->next == handles[4] );
+
+    // Moving the head back or the tail to the front rotates, the others are relinked
+    circularlist_moveToBack(list, handles[4]);
+    circularlist_moveToFront(list, handles[4]);
+    circularlist_moveToFront(list, handles[2]);
+    circularlist_moveToBack(list, handles[0]);
+    validateOrder(list, (int []){2, 4, 1, 3, 5, 0}, 6L);
+
+    CU_ASSERT_TRUE( circularlist_removeHandle(list, handles[2]) == array[2] );
+    CU_ASSERT_TRUE( circularlist_removeHandle(list, handles[0]) == array[0] );
+    CU_ASSERT_TRUE( circularlist_removeHandle(list, handles[3]) == array[3] );
+    validateOrder(list, (int []){4, 1, 5}, 3L);
+    CU_ASSERT_TRUE( circularlist_last(list, (void **)&item) == OK && item == array[5] );
+
+    CU_ASSERT_TRUE( circularlist_removeHandle(list, handles[1]) == array[1] );
+    CU_ASSERT_TRUE( circularlist_removeFirst(list, (void **)&item) == OK && item == array[4] );
+    CU_ASSERT_TRUE( circularlist_removeHandle(list, handles[5]) == array[5] );
+    validateEmptyCircularList(list);
+    CU_ASSERT_TRUE( circularlist_firstHandle(list) == NULL );
+
+    circularlist_destroy(list, NULL);
+
+    CU_PASS("testCircularListHandles() - Test Passed");
+}
+
+static void testCircularListIntrusive() {
+
+    CircularList *list;
+    ListLink links[LEN];
+    Status stat;
+    long empty;
+    char *item;
+
+    stat = circularlist_newIntrusive(&list);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testCircularListIntrusive() - allocation failure");
+    empty = circularlist_memoryUsage(list);
+
+    circularlist_linkLast(list, &links[1], array[1]);
+    circularlist_linkFirst(list, &links[0], array[0]);
+    circularlist_linkLast(list, &links[3], array[3]);
+    circularlist_linkAfter(list, &links[1], &links[2], array[2]);
+    validateOrder(list, (int []){0, 1, 2, 3}, 4L);
+    CU_ASSERT_TRUE( circularlist_memoryUsage(list) == empty );
+
+    // Removing unlinks the caller's link, which may be linked in again
+    CU_ASSERT_TRUE( circularlist_removeHandle(list, &links[0]) == array[0] );
+    CU_ASSERT_TRUE( circularlist_removeLast(list, (void **)&item) == OK && item == array[3] );
+    circularlist_linkFirst(list, &links[3], array[3]);
+    validateOrder(list, (int []){3, 1, 2}, 3L);
+
+    circularlist_clear(list, NULL);
+    validateEmptyCircularList(list);
+    circularlist_linkLast(list, &links[4], array[4]);
+    circularlist_destroy(list, NULL);
+
+    CU_PASS("testCircularListIntrusive() - Test Passed");
+}
+
 #define UNUSED __attribute__((unused))
 int main(UNUSED int argc, UNUSED char **argv) {
 
@@ -437,7 +574,10 @@ int main(UNUSED int argc, UNUSED char **argv) {
     CU_add_test(suite, "CircularList - Rotations", testRotations);
     CU_add_test(suite, "CircularList - Array", testCircularListToArray);
     CU_add_test(suite, "CircularList - Iterator", testCircularListIterator);
+    CU_add_test(suite, "CircularList - Cursor", testCircularListCursor);
     CU_add_test(suite, "CircularList - Clear", testCircularListClear);
+    CU_add_test(suite, "CircularList - Handles", testCircularListHandles);
+    CU_add_test(suite, "CircularList - Intrusive", testCircularListIntrusive);
 
     CU_basic_set_mode(CU_BRM_VERBOSE);
     CU_basic_run_tests();
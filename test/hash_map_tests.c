@@ -22,9 +22,17 @@
  * SOFTWARE.
  */
 
+#include <pthread.h>
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
 #include <CUnit/Basic.h>
+#include "cds_stats.h"
+#include "cow_hash_map.h"
 #include "hash_map.h"
+#include "snapshot.h"
+#include "ts_hash_map.h"
 
 /* Assigned default capacity for hashmap */
 #define CAPACITY 4L
@@ -76,6 +84,15 @@ static int keyCmp(void *this, void *other) {
     return strcmp((char *)this, (char *)other);
 }
 
+/* Number of elements passed to countDestroyed() so far */
+static int destroyed = 0;
+
+/* Destructor counting the elements it is called on, leaving the elements themselves alone */
+static void countDestroyed(void *item) {
+    (void)item;
+    destroyed++;
+}
+
 static void validateEmptyHashMap(HashMap *map) {
 
     Array *keyArray, *entryArray;
@@ -202,7 +219,20 @@ static void testHashMapClear() {
         CU_ASSERT_TRUE( hashmap_put(map, keys[i], entries[i], (void **)&prev) == INSERTED );
     hashmap_clear(map, NULL);
     validateEmptyHashMap(map);
-    hashmap_destroy(map, NULL);
+
+    // The map is reusable once cleared, and the destructor sees every value exactly once
+    for (i = 0; i < LEN; i++)
+        CU_ASSERT_TRUE( hashmap_put(map, keys[i], entries[i], (void **)&prev) == INSERTED );
+    CU_ASSERT_TRUE( hashmap_get(map, keys[0], (void **)&prev) == OK );
+    destroyed = 0;
+    hashmap_clear(map, countDestroyed);
+    CU_ASSERT_TRUE( destroyed == LEN );
+    validateEmptyHashMap(map);
+    for (i = 0; i < LEN; i++)
+        CU_ASSERT_TRUE( hashmap_put(map, keys[i], entries[i], (void **)&prev) == INSERTED );
+    destroyed = 0;
+    hashmap_destroy(map, countDestroyed);
+    CU_ASSERT_TRUE( destroyed == LEN );
 
     CU_PASS("testHashMapClear() - Test Passed");
 }
@@ -258,6 +288,1384 @@ static void testHashMapIterator() {
     CU_PASS("testHashMapIterator() - Test Passed");
 }
 
+/*
+ * Full-width hash function used by the hashmap, counts its invocations.
+ */
+static long hashCalls = 0L;
+static uint64_t fullHash(void *key) {
+
+    uint64_t val = 14695981039346656037UL;
+    char *ch;
+
+    hashCalls++;
+    for (ch = key; *ch != '\0'; ch++)
+        val = (val ^ (unsigned char)*ch) * 1099511628211UL;
+    return val;
+}
+
+#define NKEYS 2000
+static void testHashMapFullHash() {
+
+    HashMap *map;
+    Status stat;
+    static char buffers[NKEYS][16];
+    int i;
+    char *prev;
+
+    stat = hashmap_newFullHash(&map, fullHash, keyCmp, CAPACITY, LOAD_FACTOR, NULL);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testHashMapFullHash() - allocation failure");
+
+    validateEmptyHashMap(map);
+    hashCalls = 0L;
+    for (i = 0; i < NKEYS; i++) {
+        sprintf(buffers[i], "key-%d", i);
+        CU_ASSERT_TRUE( hashmap_put(map, buffers[i], buffers[i], (void **)&prev) == INSERTED );
+    }
+    /* The map has grown several times, but each key was only ever hashed once */
+    CU_ASSERT_TRUE( hashCalls == NKEYS );
+    CU_ASSERT_TRUE( hashmap_size(map) == NKEYS );
+
+    for (i = 0; i < NKEYS; i++) {
+        CU_ASSERT_TRUE( hashmap_get(map, buffers[i], (void **)&prev) == OK );
+        CU_ASSERT_TRUE( prev == buffers[i] );
+    }
+    CU_ASSERT_TRUE( hashmap_put(map, buffers[0], singleValue, (void **)&prev) == REPLACED );
+    CU_ASSERT_TRUE( prev == buffers[0] );
+    CU_ASSERT_TRUE( hashmap_containsKey(map, singleKey) == FALSE );
+
+    for (i = 0; i < NKEYS; i++)
+        CU_ASSERT_TRUE( hashmap_remove(map, buffers[i], (void **)&prev) == OK );
+    validateEmptyHashMap(map);
+    hashmap_destroy(map, NULL);
+
+    CU_PASS("testHashMapFullHash() - Test Passed");
+}
+
+static void testHashMapFlat() {
+
+    HashMap *map;
+    HmEntry *entry;
+    Iterator *iter;
+    Array *array;
+    Status stat;
+    static char buffers[NKEYS][16];
+    int i;
+    long count;
+    char *prev;
+
+    stat = hashmap_newFlat(&map, fullHash, keyCmp, CAPACITY, LOAD_FACTOR, NULL);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testHashMapFlat() - allocation failure");
+
+    validateEmptyHashMap(map);
+    for (i = 0; i < NKEYS; i++) {
+        sprintf(buffers[i], "flat-%d", i);
+        CU_ASSERT_TRUE( hashmap_put(map, buffers[i], buffers[i], (void **)&prev) == INSERTED );
+    }
+    CU_ASSERT_TRUE( hashmap_size(map) == NKEYS );
+    for (i = 0; i < NKEYS; i++) {
+        CU_ASSERT_TRUE( hashmap_get(map, buffers[i], (void **)&prev) == OK );
+        CU_ASSERT_TRUE( prev == buffers[i] );
+    }
+    CU_ASSERT_TRUE( hashmap_put(map, buffers[7], singleValue, (void **)&prev) == REPLACED );
+    CU_ASSERT_TRUE( prev == buffers[7] );
+    CU_ASSERT_TRUE( hashmap_get(map, singleKey, (void **)&prev) == NOT_FOUND );
+
+    /* Remove every other key, then re-insert them to reuse the freed slots */
+    for (i = 0; i < NKEYS; i += 2)
+        CU_ASSERT_TRUE( hashmap_remove(map, buffers[i], (void **)&prev) == OK );
+    CU_ASSERT_TRUE( hashmap_size(map) == NKEYS / 2 );
+    for (i = 0; i < NKEYS; i++)
+        CU_ASSERT_TRUE( hashmap_containsKey(map, buffers[i]) == ( (i % 2) ? TRUE : FALSE ) );
+    for (i = 0; i < NKEYS; i += 2)
+        CU_ASSERT_TRUE( hashmap_put(map, buffers[i], buffers[i], (void **)&prev) == INSERTED );
+    CU_ASSERT_TRUE( hashmap_size(map) == NKEYS );
+
+    CU_ASSERT_TRUE( hashmap_entryArray(map, &array) == OK );
+    CU_ASSERT_TRUE( array->len == NKEYS );
+    FREE_ARRAY(array)
+    CU_ASSERT_TRUE( hashmap_keyArray(map, &array) == OK );
+    CU_ASSERT_TRUE( array->len == NKEYS );
+    FREE_ARRAY(array)
+
+    count = 0L;
+    CU_ASSERT_TRUE( hashmap_iterator(map, &iter) == OK );
+    while (iterator_hasNext(iter) == TRUE) {
+        CU_ASSERT_TRUE( iterator_next(iter, (void **)&entry) == OK );
+        CU_ASSERT_TRUE( hashmap_containsKey(map, hmentry_getKey(entry)) == TRUE );
+        count++;
+    }
+    CU_ASSERT_TRUE( count == NKEYS );
+    iterator_destroy(iter);
+
+    hashmap_clear(map, NULL);
+    validateEmptyHashMap(map);
+    CU_ASSERT_TRUE( hashmap_put(map, singleKey, singleValue, (void **)&prev) == INSERTED );
+    hashmap_destroy(map, NULL);
+
+    CU_PASS("testHashMapFlat() - Test Passed");
+}
+
+static void testHashMapIncremental() {
+
+    HashMap *map;
+    Array *array;
+    Status stat;
+    static char buffers[NKEYS][16];
+    int i;
+    char *prev;
+
+    stat = hashmap_new(&map, hash, keyCmp, CAPACITY, LOAD_FACTOR, NULL);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testHashMapIncremental() - allocation failure");
+    hashmap_setIncrementalResize(map, TRUE);
+
+    /* Every key must stay reachable while the buckets are moved over */
+    for (i = 0; i < NKEYS; i++) {
+        sprintf(buffers[i], "inc-%d", i);
+        CU_ASSERT_TRUE( hashmap_put(map, buffers[i], buffers[i], (void **)&prev) == INSERTED );
+        CU_ASSERT_TRUE( hashmap_get(map, buffers[i / 2], (void **)&prev) == OK );
+        CU_ASSERT_TRUE( prev == buffers[i / 2] );
+        CU_ASSERT_TRUE( hashmap_get(map, buffers[0], (void **)&prev) == OK );
+    }
+    CU_ASSERT_TRUE( hashmap_size(map) == NKEYS );
+    CU_ASSERT_TRUE( hashmap_entryArray(map, &array) == OK );
+    CU_ASSERT_TRUE( array->len == NKEYS );
+    FREE_ARRAY(array)
+
+    for (i = 0; i < NKEYS; i += 2)
+        CU_ASSERT_TRUE( hashmap_remove(map, buffers[i], (void **)&prev) == OK );
+    CU_ASSERT_TRUE( hashmap_size(map) == NKEYS / 2 );
+    for (i = 0; i < NKEYS; i++)
+        CU_ASSERT_TRUE( hashmap_containsKey(map, buffers[i]) == ( (i % 2) ? TRUE : FALSE ) );
+    CU_ASSERT_TRUE( hashmap_keyArray(map, &array) == OK );
+    CU_ASSERT_TRUE( array->len == NKEYS / 2 );
+    FREE_ARRAY(array)
+
+    /* Turning it off mid-resize must finish the resize in place */
+    hashmap_setIncrementalResize(map, FALSE);
+    for (i = 1; i < NKEYS; i += 2)
+        CU_ASSERT_TRUE( hashmap_containsKey(map, buffers[i]) == TRUE );
+
+    hashmap_clear(map, NULL);
+    validateEmptyHashMap(map);
+    hashmap_destroy(map, NULL);
+
+    CU_PASS("testHashMapIncremental() - Test Passed");
+}
+
+/*
+ * Grows `map` to NKEYS entries and drains it back down, which must start out empty.
+ */
+static void validateSpikeAndDrain(HashMap *map) {
+
+    static char buffers[NKEYS][16];
+    int i, j;
+    char *prev;
+
+    for (i = 0; i < NKEYS; i++) {
+        sprintf(buffers[i], "spike-%d", i);
+        CU_ASSERT_TRUE( hashmap_put(map, buffers[i], buffers[i], (void **)&prev) == INSERTED );
+    }
+
+    /* The remaining keys must stay reachable as the table shrinks underneath them */
+    for (i = NKEYS - 1; i >= 10; i--) {
+        CU_ASSERT_TRUE( hashmap_remove(map, buffers[i], (void **)&prev) == OK );
+        CU_ASSERT_TRUE( prev == buffers[i] );
+        if (i % 97 == 0) {
+            for (j = 0; j < i; j++)
+                CU_ASSERT_TRUE( hashmap_containsKey(map, buffers[j]) == TRUE );
+        }
+    }
+    CU_ASSERT_TRUE( hashmap_size(map) == 10L );
+    for (i = 0; i < NKEYS; i++)
+        CU_ASSERT_TRUE( hashmap_containsKey(map, buffers[i]) == ( (i < 10) ? TRUE : FALSE ) );
+
+    /* Then spikes again from the shrunken table */
+    for (i = 10; i < NKEYS; i++)
+        CU_ASSERT_TRUE( hashmap_put(map, buffers[i], buffers[i], (void **)&prev) == INSERTED );
+    CU_ASSERT_TRUE( hashmap_size(map) == NKEYS );
+    for (i = 0; i < NKEYS; i++)
+        CU_ASSERT_TRUE( hashmap_remove(map, buffers[i], (void **)&prev) == OK );
+    validateEmptyHashMap(map);
+}
+
+static void testHashMapShrink() {
+
+    HashMap *map;
+
+    if (hashmap_new(&map, hash, keyCmp, CAPACITY, LOAD_FACTOR, NULL) != OK)
+        CU_FAIL_FATAL("ERROR: testHashMapShrink() - allocation failure");
+    validateSpikeAndDrain(map);
+    hashmap_setIncrementalResize(map, TRUE);
+    validateSpikeAndDrain(map);
+    hashmap_destroy(map, NULL);
+
+    if (hashmap_newFullHash(&map, fullHash, keyCmp, CAPACITY, LOAD_FACTOR, NULL) != OK)
+        CU_FAIL_FATAL("ERROR: testHashMapShrink() - allocation failure");
+    validateSpikeAndDrain(map);
+    hashmap_destroy(map, NULL);
+
+    if (hashmap_newFlat(&map, fullHash, keyCmp, CAPACITY, LOAD_FACTOR, NULL) != OK)
+        CU_FAIL_FATAL("ERROR: testHashMapShrink() - allocation failure");
+    validateSpikeAndDrain(map);
+    hashmap_destroy(map, NULL);
+
+    CU_PASS("testHashMapShrink() - Test Passed");
+}
+
+/*
+ * Reserves room in `map` ahead of loading it, then shrinks it back down. The map must start empty.
+ */
+static void validateReserve(HashMap *map) {
+
+    static char buffers[NKEYS][16];
+    int i;
+    char *prev;
+
+    CU_ASSERT_TRUE( hashmap_reserve(map, NKEYS) == OK );
+    CU_ASSERT_TRUE( hashmap_reserve(map, 1L) == OK );
+    for (i = 0; i < NKEYS; i++) {
+        sprintf(buffers[i], "reserve-%d", i);
+        CU_ASSERT_TRUE( hashmap_put(map, buffers[i], buffers[i], (void **)&prev) == INSERTED );
+    }
+    CU_ASSERT_TRUE( hashmap_size(map) == NKEYS );
+
+    /* Drains most of the map, then shrinks what is left to fit */
+    for (i = 10; i < NKEYS; i++)
+        CU_ASSERT_TRUE( hashmap_remove(map, buffers[i], (void **)&prev) == OK );
+    CU_ASSERT_TRUE( hashmap_shrinkToFit(map) == OK );
+    CU_ASSERT_TRUE( hashmap_size(map) == 10L );
+    for (i = 0; i < NKEYS; i++)
+        CU_ASSERT_TRUE( hashmap_containsKey(map, buffers[i]) == ( (i < 10) ? TRUE : FALSE ) );
+    for (i = 0; i < 10; i++)
+        CU_ASSERT_TRUE( hashmap_remove(map, buffers[i], (void **)&prev) == OK );
+
+    /* An empty map shrinks down to its smallest table, and still grows from there */
+    CU_ASSERT_TRUE( hashmap_shrinkToFit(map) == OK );
+    validateEmptyHashMap(map);
+    for (i = 0; i < NKEYS; i++)
+        CU_ASSERT_TRUE( hashmap_put(map, buffers[i], buffers[i], (void **)&prev) == INSERTED );
+    for (i = 0; i < NKEYS; i++)
+        CU_ASSERT_TRUE( hashmap_remove(map, buffers[i], (void **)&prev) == OK );
+    validateEmptyHashMap(map);
+}
+
+static void testHashMapReserve() {
+
+    HashMap *map;
+
+    if (hashmap_new(&map, hash, keyCmp, CAPACITY, LOAD_FACTOR, NULL) != OK)
+        CU_FAIL_FATAL("ERROR: testHashMapReserve() - allocation failure");
+    validateReserve(map);
+    hashmap_setIncrementalResize(map, TRUE);
+    validateReserve(map);
+    hashmap_destroy(map, NULL);
+
+    if (hashmap_newFullHash(&map, fullHash, keyCmp, CAPACITY, LOAD_FACTOR, NULL) != OK)
+        CU_FAIL_FATAL("ERROR: testHashMapReserve() - allocation failure");
+    validateReserve(map);
+    hashmap_destroy(map, NULL);
+
+    if (hashmap_newFlat(&map, fullHash, keyCmp, CAPACITY, LOAD_FACTOR, NULL) != OK)
+        CU_FAIL_FATAL("ERROR: testHashMapReserve() - allocation failure");
+    validateReserve(map);
+    hashmap_destroy(map, NULL);
+
+    CU_PASS("testHashMapReserve() - Test Passed");
+}
+
+/*
+ * Runs the batch operations over `map`, which must start out empty.
+ */
+static void validateBatch(HashMap *map) {
+
+    static char buffers[NKEYS][16];
+    static void *bkeys[NKEYS], *values[NKEYS], *out[NKEYS];
+    static Status statuses[NKEYS];
+    int i;
+
+    for (i = 0; i < NKEYS; i++) {
+        sprintf(buffers[i], "batch-%d", i);
+        bkeys[i] = buffers[i];
+        values[i] = buffers[i];
+    }
+    CU_ASSERT_TRUE( hashmap_getAll(map, bkeys, out, NKEYS) == 0L );
+    CU_ASSERT_TRUE( out[0] == NULL && out[NKEYS - 1] == NULL );
+    CU_ASSERT_TRUE( hashmap_getMany(map, bkeys, NKEYS, out, statuses) == 0L );
+    CU_ASSERT_TRUE( out[1] == NULL && statuses[1] == STRUCT_EMPTY );
+
+    /* Inserts the first half, then the whole batch, replacing the first half's values */
+    CU_ASSERT_TRUE( hashmap_putAll(map, bkeys, values, NKEYS / 2, NULL) == OK );
+    CU_ASSERT_TRUE( hashmap_size(map) == NKEYS / 2 );
+    for (i = 0; i < NKEYS; i++)
+        values[i] = singleValue;
+    CU_ASSERT_TRUE( hashmap_putAll(map, bkeys, values, NKEYS, out) == OK );
+    CU_ASSERT_TRUE( hashmap_size(map) == NKEYS );
+    for (i = 0; i < NKEYS; i++)
+        CU_ASSERT_TRUE( out[i] == ( ( i < NKEYS / 2 ) ? buffers[i] : NULL ) );
+
+    /* Looks up every key, plus one that is missing */
+    CU_ASSERT_TRUE( hashmap_getAll(map, bkeys, out, NKEYS) == NKEYS );
+    for (i = 0; i < NKEYS; i++)
+        CU_ASSERT_TRUE( out[i] == singleValue );
+    bkeys[NKEYS / 3] = singleKey;
+    CU_ASSERT_TRUE( hashmap_getAll(map, bkeys, out, NKEYS) == NKEYS - 1 );
+    CU_ASSERT_TRUE( out[NKEYS / 3] == NULL && out[NKEYS / 3 + 1] == singleValue );
+    CU_ASSERT_TRUE( hashmap_getMany(map, bkeys, NKEYS, out, statuses) == NKEYS - 1 );
+    for (i = 0; i < NKEYS; i++) {
+        CU_ASSERT_TRUE( statuses[i] == ( ( i == NKEYS / 3 ) ? NOT_FOUND : OK ) );
+        CU_ASSERT_TRUE( out[i] == ( ( i == NKEYS / 3 ) ? NULL : singleValue ) );
+    }
+    CU_ASSERT_TRUE( hashmap_getMany(map, bkeys + 1, NKEYS - 1, out, NULL) == NKEYS - 2 );
+
+    /* Removes every key but the one replaced by the missing key */
+    CU_ASSERT_TRUE( hashmap_removeAll(map, bkeys, out, NKEYS) == NKEYS - 1 );
+    CU_ASSERT_TRUE( out[NKEYS / 3] == NULL && out[0] == singleValue );
+    CU_ASSERT_TRUE( hashmap_size(map) == 1L );
+    CU_ASSERT_TRUE( hashmap_containsKey(map, buffers[NKEYS / 3]) == TRUE );
+    bkeys[0] = buffers[NKEYS / 3];
+    CU_ASSERT_TRUE( hashmap_removeAll(map, bkeys, NULL, NKEYS) == 1L );
+    validateEmptyHashMap(map);
+}
+
+static void testHashMapBatch() {
+
+    HashMap *map;
+
+    if (hashmap_new(&map, hash, keyCmp, CAPACITY, LOAD_FACTOR, NULL) != OK)
+        CU_FAIL_FATAL("ERROR: testHashMapBatch() - allocation failure");
+    validateBatch(map);
+    hashmap_setIncrementalResize(map, TRUE);
+    validateBatch(map);
+    hashmap_destroy(map, NULL);
+
+    if (hashmap_newFullHash(&map, fullHash, keyCmp, CAPACITY, LOAD_FACTOR, NULL) != OK)
+        CU_FAIL_FATAL("ERROR: testHashMapBatch() - allocation failure");
+    validateBatch(map);
+    hashmap_destroy(map, NULL);
+
+    if (hashmap_newFlat(&map, fullHash, keyCmp, CAPACITY, LOAD_FACTOR, NULL) != OK)
+        CU_FAIL_FATAL("ERROR: testHashMapBatch() - allocation failure");
+    validateBatch(map);
+    validateBatch(map);
+    hashmap_destroy(map, NULL);
+
+    CU_PASS("testHashMapBatch() - Test Passed");
+}
+
+static void testHashMapSeeded() {
+
+    HashMap *map;
+    char copy[16];
+    long a = 42L, b = 42L, c = 43L;
+    uint64_t seed = hashing_seed();
+
+    /* The built-in hashes must agree on equal keys, and depend on the seed */
+    strcpy(copy, keys[0]);
+    CU_ASSERT_TRUE( hashing_string(keys[0], seed) == hashing_string(copy, seed) );
+    CU_ASSERT_TRUE( hashing_string(keys[0], seed) != hashing_string(keys[0], seed + 1UL) );
+    CU_ASSERT_TRUE( hashing_string(keys[0], seed) != hashing_string(keys[1], seed) );
+    CU_ASSERT_TRUE( hashing_long(&a, seed) == hashing_long(&b, seed) );
+    CU_ASSERT_TRUE( hashing_long(&a, seed) != hashing_long(&c, seed) );
+    CU_ASSERT_TRUE( hashing_seed() != hashing_seed() );
+    CU_ASSERT_TRUE( hashing_compareString(keys[0], copy) == 0 );
+    CU_ASSERT_TRUE( hashing_compareLong(&a, &b) == 0 && hashing_compareLong(&a, &c) < 0 );
+    CU_ASSERT_TRUE( hashing_comparePointer(&a, &a) == 0 && hashing_comparePointer(&a, &b) != 0 );
+
+    if (hashmap_newSeeded(&map, hashing_string, hashing_compareString, CAPACITY, LOAD_FACTOR,
+                          NULL) != OK)
+        CU_FAIL_FATAL("ERROR: testHashMapSeeded() - allocation failure");
+    validateSpikeAndDrain(map);
+    hashmap_setIncrementalResize(map, TRUE);
+    validateBatch(map);
+    hashmap_destroy(map, NULL);
+
+    if (hashmap_newFlatSeeded(&map, hashing_string, hashing_compareString, CAPACITY,
+                              LOAD_FACTOR, NULL) != OK)
+        CU_FAIL_FATAL("ERROR: testHashMapSeeded() - allocation failure");
+    validateSpikeAndDrain(map);
+    validateBatch(map);
+    validateReserve(map);
+    hashmap_destroy(map, NULL);
+
+    CU_PASS("testHashMapSeeded() - Test Passed");
+}
+
+static void testHashMapSmall() {
+
+    HashMap *map;
+    HashStats stats;
+    Iterator *iter;
+    HmEntry *entry;
+    Cursor cursor;
+    int i;
+    long count;
+    char *prev;
+
+    if (hashmap_newSmall(&map, hashing_string, hashing_compareString, LOAD_FACTOR, NULL) != OK)
+        CU_FAIL_FATAL("ERROR: testHashMapSmall() - allocation failure");
+    validateEmptyHashMap(map);
+
+    /* Fills the inline storage, which must not grow the map */
+    for (i = 0; i < 8; i++)
+        CU_ASSERT_TRUE( hashmap_put(map, keys[i], entries[i], (void **)&prev) == INSERTED );
+    CU_ASSERT_TRUE( hashmap_put(map, keys[3], singleValue, (void **)&prev) == REPLACED );
+    CU_ASSERT_TRUE( prev == entries[3] );
+    CU_ASSERT_TRUE( hashmap_put(map, keys[3], entries[3], (void **)&prev) == REPLACED );
+    hashmap_stats(map, &stats);
+    CU_ASSERT_TRUE( stats.capacity == 8L && stats.size == 8L && stats.resizes == 0L );
+    CU_ASSERT_TRUE( hashmap_get(map, keys[8], (void **)&prev) == NOT_FOUND );
+
+    /* Removing from the middle keeps the remaining entries reachable */
+    CU_ASSERT_TRUE( hashmap_remove(map, keys[2], (void **)&prev) == OK );
+    CU_ASSERT_TRUE( prev == entries[2] );
+    CU_ASSERT_TRUE( hashmap_remove(map, keys[2], (void **)&prev) == NOT_FOUND );
+    for (i = 0; i < 8; i++)
+        CU_ASSERT_TRUE( hashmap_containsKey(map, keys[i]) == ( (i != 2) ? TRUE : FALSE ) );
+    count = 0L;
+    CU_ASSERT_TRUE( hashmap_iterator(map, &iter) == OK );
+    while (iterator_hasNext(iter) == TRUE) {
+        CU_ASSERT_TRUE( iterator_next(iter, (void **)&entry) == OK );
+        CU_ASSERT_TRUE( hashmap_containsKey(map, hmentry_getKey(entry)) == TRUE );
+        count++;
+    }
+    CU_ASSERT_TRUE( count == 7L );
+    iterator_destroy(iter);
+
+    /* Inserting past the inline storage promotes the map, keeping every entry */
+    for (i = 0; i < LEN; i++)
+        (void)hashmap_put(map, keys[i], entries[i], (void **)&prev);
+    hashmap_stats(map, &stats);
+    CU_ASSERT_TRUE( stats.size == LEN && stats.capacity > 8L && stats.resizes > 0L );
+    count = 0L;
+    hashmap_cursor(map, &cursor);
+    while (hashmap_cursorNext(&cursor, (void **)&entry) == OK)
+        count++;
+    CU_ASSERT_TRUE( count == LEN );
+    for (i = 0; i < LEN; i++) {
+        CU_ASSERT_TRUE( hashmap_get(map, keys[i], (void **)&prev) == OK );
+        CU_ASSERT_TRUE( prev == entries[i] );
+    }
+    hashmap_clear(map, NULL);
+    validateEmptyHashMap(map);
+    validateSpikeAndDrain(map);
+    hashmap_destroy(map, NULL);
+
+    /* Batch operations and reservations may promote the map along the way */
+    if (hashmap_newSmall(&map, hashing_string, hashing_compareString, LOAD_FACTOR, NULL) != OK)
+        CU_FAIL_FATAL("ERROR: testHashMapSmall() - allocation failure");
+    validateBatch(map);
+    hashmap_destroy(map, NULL);
+    if (hashmap_newSmall(&map, hashing_string, hashing_compareString, LOAD_FACTOR, NULL) != OK)
+        CU_FAIL_FATAL("ERROR: testHashMapSmall() - allocation failure");
+    CU_ASSERT_TRUE( hashmap_reserve(map, 4L) == OK );
+    CU_ASSERT_TRUE( hashmap_shrinkToFit(map) == OK );
+    hashmap_stats(map, &stats);
+    CU_ASSERT_TRUE( stats.capacity == 8L );
+    validateReserve(map);
+    hashmap_destroy(map, NULL);
+
+    CU_PASS("testHashMapSmall() - Test Passed");
+}
+
+/*
+ * Degenerate hash function, which places every key into the same bucket.
+ */
+static long badHash(void *key, long N) {
+
+    (void)key;
+    (void)N;
+    return 0L;
+}
+
+/*
+ * Checks that the chain lengths reported in `stats` add up to the hashmap's size.
+ */
+static void validateStats(HashStats *stats) {
+
+    long i, chains = 0L, total = 0L;
+
+    CU_ASSERT_TRUE( stats->maxChain < HASH_STATS_BINS );
+    for (i = 0L; i < HASH_STATS_BINS; i++) {
+        chains += stats->histogram[i];
+        total += ( i * stats->histogram[i] );
+    }
+    CU_ASSERT_TRUE( chains - stats->histogram[0] == stats->usedBuckets );
+    CU_ASSERT_TRUE( stats->meanChain * stats->usedBuckets > total - 0.5 );
+    CU_ASSERT_TRUE( stats->meanChain * stats->usedBuckets < total + 0.5 );
+    CU_ASSERT_TRUE( stats->load * stats->capacity > stats->size - 0.5 );
+}
+
+static void testHashMapStats() {
+
+    HashMap *map;
+    HashStats stats;
+    static char buffers[NKEYS][16];
+    int i;
+    char *prev;
+
+    if (hashmap_newSeeded(&map, hashing_string, keyCmp, CAPACITY, LOAD_FACTOR, NULL) != OK)
+        CU_FAIL_FATAL("ERROR: testHashMapStats() - allocation failure");
+    hashmap_stats(map, &stats);
+    CU_ASSERT_TRUE( stats.size == 0L && stats.usedBuckets == 0L && stats.maxChain == 0L );
+    CU_ASSERT_TRUE( stats.histogram[0] == stats.capacity && stats.resizes == 0L );
+
+    /* A good hash keeps every chain short, and every bucket is accounted for */
+    for (i = 0; i < NKEYS; i++) {
+        sprintf(buffers[i], "stats-%d", i);
+        CU_ASSERT_TRUE( hashmap_put(map, buffers[i], buffers[i], (void **)&prev) == INSERTED );
+    }
+    hashmap_stats(map, &stats);
+    CU_ASSERT_TRUE( stats.size == NKEYS && stats.load <= LOAD_FACTOR );
+    CU_ASSERT_TRUE( stats.resizes > 0L && stats.resizeNanos > 0L );
+    CU_ASSERT_TRUE( stats.maxChain < 10L && stats.tombstones == 0L );
+    validateStats(&stats);
+    hashmap_destroy(map, NULL);
+
+    /* The same keys in a flat map are counted by their probe lengths instead */
+    if (hashmap_newFlatSeeded(&map, hashing_string, keyCmp, CAPACITY, LOAD_FACTOR, NULL) != OK)
+        CU_FAIL_FATAL("ERROR: testHashMapStats() - allocation failure");
+    for (i = 0; i < NKEYS; i++)
+        CU_ASSERT_TRUE( hashmap_put(map, buffers[i], buffers[i], (void **)&prev) == INSERTED );
+    hashmap_stats(map, &stats);
+    CU_ASSERT_TRUE( stats.size == NKEYS && stats.usedBuckets == NKEYS );
+    CU_ASSERT_TRUE( stats.histogram[0] == 0L && stats.histogram[1] > NKEYS / 2 );
+    validateStats(&stats);
+    hashmap_destroy(map, NULL);
+
+    /* A degenerate hash shows up as a single long chain */
+    if (hashmap_new(&map, badHash, keyCmp, CAPACITY, LOAD_FACTOR, NULL) != OK)
+        CU_FAIL_FATAL("ERROR: testHashMapStats() - allocation failure");
+    for (i = 0; i < LEN; i++)
+        CU_ASSERT_TRUE( hashmap_put(map, keys[i], entries[i], (void **)&prev) == INSERTED );
+    hashmap_stats(map, &stats);
+    CU_ASSERT_TRUE( stats.usedBuckets == 1L && stats.maxChain == LEN );
+    CU_ASSERT_TRUE( stats.histogram[HASH_STATS_BINS - 1] == 1L );
+    hashmap_destroy(map, NULL);
+
+    CU_PASS("testHashMapStats() - Test Passed");
+}
+
+static void testHashMapCursor() {
+
+    Iterator *iter;
+    Cursor cursor;
+    HashMap *map;
+    Status stat;
+    int i;
+    char *item, *other;
+
+    stat = hashmap_new(&map, hash, keyCmp, CAPACITY, LOAD_FACTOR, NULL);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testHashMapCursor() - allocation failure");
+
+    hashmap_cursor(map, &cursor);
+    CU_ASSERT_TRUE( cursor_hasNext(&cursor) == FALSE );
+    CU_ASSERT_TRUE( hashmap_cursorNext(&cursor, (void **)&item) == ITER_END );
+
+    for (i = 0; i < LEN; i++)
+        CU_ASSERT_TRUE( hashmap_put(map, keys[i], entries[i], (void **)&item) == INSERTED );
+    CU_ASSERT_TRUE( hashmap_iterator(map, &iter) == OK );
+
+    // The cursor must visit the same items in the same order as the iterator
+    i = 0;
+    hashmap_cursor(map, &cursor);
+    while (cursor_hasNext(&cursor) == TRUE) {
+        CU_ASSERT_TRUE( hashmap_cursorNext(&cursor, (void **)&item) == OK );
+        CU_ASSERT_TRUE( iterator_next(iter, (void **)&other) == OK );
+        CU_ASSERT_TRUE( item == other );
+        i++;
+    }
+    CU_ASSERT_EQUAL( i, LEN );
+    CU_ASSERT_TRUE( hashmap_cursorNext(&cursor, (void **)&item) == ITER_END );
+    iterator_destroy(iter);
+
+    // A structural change invalidates any cursor already in progress
+    hashmap_cursor(map, &cursor);
+    CU_ASSERT_TRUE( hashmap_cursorNext(&cursor, (void **)&item) == OK );
+    CU_ASSERT_TRUE( hashmap_put(map, singleKey, singleValue, (void **)&item) == INSERTED );
+    CU_ASSERT_TRUE( hashmap_cursorNext(&cursor, (void **)&item) == CONCURRENT_MODIFICATION );
+    hashmap_destroy(map, NULL);
+
+    CU_PASS("testHashMapCursor() - Test Passed");
+}
+
+static void testHashMapSnapshot() {
+
+    Array *array;
+    HashMap *map;
+    HmEntry *entry;
+    Status stat;
+    int i;
+    char *prev;
+
+    stat = hashmap_new(&map, hash, keyCmp, CAPACITY, LOAD_FACTOR, NULL);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testHashMapSnapshot() - allocation failure");
+
+    CU_ASSERT_TRUE( hashmap_entrySnapshot(map, &array) == STRUCT_EMPTY );
+    for (i = 0; i < LEN; i++)
+        CU_ASSERT_TRUE( hashmap_put(map, keys[i], entries[i], (void **)&prev) == INSERTED );
+    CU_ASSERT_TRUE( hashmap_entrySnapshot(map, &array) == OK );
+    CU_ASSERT_EQUAL( array->len, LEN );
+    for (i = 0; i < array->len; i++) {
+        entry = (HmEntry *)array->items[i];
+        CU_ASSERT_TRUE( hashmap_get(map, hmentry_getKey(entry), (void **)&prev) == OK );
+        CU_ASSERT_TRUE( strcmp(hmentry_getValue(entry), prev) == 0 );
+    }
+
+    // The copies outlive the hashmap they were taken from
+    hashmap_destroy(map, NULL);
+    for (i = 0; i < array->len; i++)
+        CU_ASSERT_TRUE( hmentry_getKey((HmEntry *)array->items[i]) != NULL );
+    FREE_ARRAY(array)
+
+    CU_PASS("testHashMapSnapshot() - Test Passed");
+}
+
+/* Visitor checking each entry it is passed against the map in `context` and counting it */
+static int nVisited = 0;
+static Boolean checkEntry(void *key, void *value, void *context) {
+    char *found;
+    if (hashmap_get((HashMap *)context, key, (void **)&found) != OK || found != value)
+        return FALSE;
+    nVisited++;
+    return TRUE;
+}
+
+static void testHashMapForEach() {
+
+    HashMap *map;
+    Status stat;
+    int i;
+    char *prev;
+
+    stat = hashmap_new(&map, hash, keyCmp, CAPACITY, LOAD_FACTOR, NULL);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testHashMapForEach() - allocation failure");
+
+    nVisited = 0;
+    CU_ASSERT_TRUE( hashmap_forEach(map, checkEntry, map) == TRUE );
+    CU_ASSERT_EQUAL( nVisited, 0 );
+    for (i = 0; i < LEN; i++)
+        CU_ASSERT_TRUE( hashmap_put(map, keys[i], entries[i], (void **)&prev) == INSERTED );
+    nVisited = 0;
+    CU_ASSERT_TRUE( hashmap_forEach(map, checkEntry, map) == TRUE );
+    CU_ASSERT_EQUAL( nVisited, LEN );
+    hashmap_destroy(map, NULL);
+
+    CU_PASS("testHashMapForEach() - Test Passed");
+}
+
+static void testHashMapMemoryUsage() {
+
+    HashMap *map;
+    Status stat;
+    int i;
+    long empty;
+    char *prev;
+
+    stat = hashmap_new(&map, hash, keyCmp, CAPACITY, LOAD_FACTOR, NULL);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testHashMapMemoryUsage() - allocation failure");
+
+    // The buckets are charged up front, the entries as they are added
+    empty = hashmap_memoryUsage(map);
+    CU_ASSERT_TRUE( empty >= CAPACITY * (long)sizeof(void *) );
+    for (i = 0; i < LEN; i++)
+        CU_ASSERT_TRUE( hashmap_put(map, keys[i], entries[i], (void **)&prev) == INSERTED );
+    CU_ASSERT_TRUE( hashmap_memoryUsage(map) > empty );
+    hashmap_destroy(map, NULL);
+
+    CU_PASS("testHashMapMemoryUsage() - Test Passed");
+}
+
+/* Allocator counting the blocks it has handed out and not yet taken back into `context` */
+static void *countingAlloc(size_t size, void *context) {
+    ++*(long *)context;
+    return malloc(size);
+}
+static void *countingRealloc(void *ptr, size_t size, void *context) {
+    if (ptr == NULL)
+        ++*(long *)context;
+    return realloc(ptr, size);
+}
+static void countingFree(void *ptr, void *context) {
+    if (ptr != NULL)
+        --*(long *)context;
+    free(ptr);
+}
+
+static void testHashMapAllocator() {
+
+    HashMap *map;
+    Status stat;
+    int i;
+    long live = 0L;
+    char *prev;
+    CdsAllocator allocator = { countingAlloc, countingRealloc, countingFree, &live };
+
+    stat = hashmap_newWithAllocator(&map, hash, keyCmp, CAPACITY, LOAD_FACTOR, NULL, &allocator);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testHashMapAllocator() - allocation failure");
+
+    // Every block the map holds comes from the allocator, and goes back to it on destroy
+    CU_ASSERT_TRUE( live > 0L );
+    for (i = 0; i < LEN; i++)
+        CU_ASSERT_TRUE( hashmap_put(map, keys[i], entries[i], (void **)&prev) == INSERTED );
+    for (i = 0; i < LEN; i += 2)
+        CU_ASSERT_TRUE( hashmap_remove(map, keys[i], (void **)&prev) == OK );
+    CU_ASSERT_TRUE( hashmap_size(map) == LEN / 2 );
+    CU_ASSERT_TRUE( live > 0L );
+    hashmap_destroy(map, NULL);
+    CU_ASSERT_EQUAL( live, 0L );
+
+    CU_PASS("testHashMapAllocator() - Test Passed");
+}
+
+#define PARALLEL_LEN 100000
+
+/* Reducer and combiner counting the entries whose value is their key */
+static void *countEntries(void *partial, void *key, void *value, void *context) {
+    (void)context;
+    return (void *)( (long)partial + ( (key == value) ? 1L : 0L ) );
+}
+static void *sumCounts(void *partial, void *other, void *context) {
+    (void)context;
+    return (void *)( (long)partial + (long)other );
+}
+
+/* Visitor counting the entries it is passed into `context`, stopping at a key in "-7" */
+static Boolean countVisits(void *key, void *value, void *context) {
+    (void)value;
+    __atomic_add_fetch((long *)context, 1L, __ATOMIC_RELAXED);
+    return ( strcmp((char *)key + strlen(key) - 2, "-7") != 0 ) ? TRUE : FALSE;
+}
+
+static void validateParallel(HashMap *map) {
+
+    long count;
+
+    CU_ASSERT_EQUAL( (long)hashmap_parallelReduce(map, 1, countEntries, sumCounts, NULL),
+                     (long)PARALLEL_LEN );
+    CU_ASSERT_EQUAL( (long)hashmap_parallelReduce(map, 6, countEntries, sumCounts, NULL),
+                     (long)PARALLEL_LEN );
+    count = 0L;
+    CU_ASSERT_TRUE( hashmap_parallelForEach(map, 6, countVisits, &count) == FALSE );
+    CU_ASSERT_TRUE( count >= 1L && count <= PARALLEL_LEN );
+}
+
+static void testHashMapParallel() {
+
+    HashMap *map;
+    Status stat;
+    static char buffers[PARALLEL_LEN][16];
+    int i;
+    char *prev;
+
+    stat = hashmap_newFullHash(&map, fullHash, keyCmp, CAPACITY, LOAD_FACTOR, NULL);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testHashMapParallel() - allocation failure");
+    CU_ASSERT_TRUE( hashmap_parallelReduce(map, 4, countEntries, sumCounts, NULL) == NULL );
+    for (i = 0; i < PARALLEL_LEN; i++) {
+        sprintf(buffers[i], "par-%d", i);
+        CU_ASSERT_TRUE( hashmap_put(map, buffers[i], buffers[i], (void **)&prev) == INSERTED );
+    }
+    validateParallel(map);
+    hashmap_destroy(map, NULL);
+
+    stat = hashmap_newFlat(&map, fullHash, keyCmp, CAPACITY, LOAD_FACTOR, NULL);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testHashMapParallel() - allocation failure");
+    for (i = 0; i < PARALLEL_LEN; i++)
+        CU_ASSERT_TRUE( hashmap_put(map, buffers[i], buffers[i], (void **)&prev) == INSERTED );
+    validateParallel(map);
+    hashmap_destroy(map, NULL);
+
+    CU_PASS("testHashMapParallel() - Test Passed");
+}
+
+static void testCopyOnWriteHashMap() {
+
+    CopyOnWriteHashMap *map;
+    HashMap *snapshot;
+    char *value, *prev[LEN];
+    int i;
+
+    Status stat = cow_hashmap_new(&map, hash, keyCmp, CAPACITY, LOAD_FACTOR, free);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testCopyOnWriteHashMap() - allocation failure");
+
+    CU_ASSERT_TRUE( cow_hashmap_isEmpty(map) == TRUE );
+    CU_ASSERT_TRUE( cow_hashmap_get(map, keys[0], (void **)&value) == STRUCT_EMPTY );
+    CU_ASSERT_TRUE( cow_hashmap_remove(map, keys[0], (void **)&value) == STRUCT_EMPTY );
+
+    // The keys are owned by the map, which frees them once no reader can still use them
+    CU_ASSERT_TRUE( cow_hashmap_put(map, strdup(singleKey), singleValue, (void **)&value) ==
+                    INSERTED );
+    CU_ASSERT_TRUE( cow_hashmap_put(map, singleKey, otherValue, (void **)&value) == REPLACED );
+    CU_ASSERT_TRUE( value == singleValue );
+    CU_ASSERT_TRUE( cow_hashmap_get(map, singleKey, (void **)&value) == OK );
+    CU_ASSERT_TRUE( value == otherValue );
+
+    // A batch is published as one version
+    char *batch[LEN];
+    for (i = 0; i < LEN; i++)
+        batch[i] = strdup(keys[i]);
+    CU_ASSERT_TRUE( cow_hashmap_putAll(map, (void **)batch, (void **)entries, LEN,
+                                       (void **)prev) == OK );
+    CU_ASSERT_EQUAL( cow_hashmap_size(map), LEN + 1L );
+    for (i = 0; i < LEN; i++) {
+        CU_ASSERT_TRUE( prev[i] == NULL );
+        CU_ASSERT_TRUE( cow_hashmap_containsKey(map, keys[i]) == TRUE );
+    }
+
+    // A snapshot keeps its contents while newer versions are published
+    CU_ASSERT_TRUE( cow_hashmap_acquire(map, &snapshot) == OK );
+    CU_ASSERT_TRUE( cow_hashmap_remove(map, keys[0], (void **)&value) == OK );
+    CU_ASSERT_TRUE( value == entries[0] );
+    CU_ASSERT_TRUE( cow_hashmap_remove(map, keys[0], (void **)&value) == NOT_FOUND );
+    CU_ASSERT_TRUE( hashmap_get(snapshot, keys[0], (void **)&value) == OK );
+    CU_ASSERT_TRUE( value == entries[0] );
+    CU_ASSERT_EQUAL( hashmap_size(snapshot), LEN + 1L );
+    cow_hashmap_release(map);
+    CU_ASSERT_EQUAL( cow_hashmap_size(map), LEN );
+    CU_ASSERT_TRUE( cow_hashmap_containsKey(map, keys[0]) == FALSE );
+
+    CU_ASSERT_TRUE( cow_hashmap_clear(map, NULL) == OK );
+    CU_ASSERT_TRUE( cow_hashmap_isEmpty(map) == TRUE );
+    CU_ASSERT_TRUE( cow_hashmap_put(map, strdup(singleKey), singleValue, (void **)&value) ==
+                    INSERTED );
+    cow_hashmap_destroy(map, NULL);
+
+    CU_PASS("testCopyOnWriteHashMap() - Test Passed");
+}
+
+/*
+ * Serializes a string as its characters, without the terminator.
+ */
+static long serializeString(void *item, void *buffer, long capacity) {
+
+    long len = (long)strlen((char *)item);
+
+    if (len <= capacity)
+        memcpy(buffer, item, len);
+    return len;
+}
+
+/*
+ * Deserializes a string serialized by serializeString() into a new, terminated copy.
+ */
+static void *deserializeString(const void *bytes, long len) {
+
+    char *str = (char *)malloc(len + 1);
+
+    if (str != NULL) {
+        memcpy(str, bytes, len);
+        str[len] = '\0';
+    }
+    return str;
+}
+
+static void testHashMapSaveLoad() {
+
+    HashMap *map, *loaded;
+    Snapshot *snapshot;
+    const void *key, *value;
+    long keyLen, valueLen;
+    char *found, *prev;
+    FILE *file;
+    int i, fd;
+
+    Status stat = hashmap_new(&map, hash, keyCmp, CAPACITY, LOAD_FACTOR, NULL);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testHashMapSaveLoad() - allocation failure");
+    stat = hashmap_new(&loaded, hash, keyCmp, CAPACITY, LOAD_FACTOR, free);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testHashMapSaveLoad() - allocation failure");
+    if ((file = tmpfile()) == NULL)
+        CU_FAIL_FATAL("ERROR: testHashMapSaveLoad() - could not create a temporary file");
+    fd = fileno(file);
+
+    // A snapshot that was never written is rejected
+    CU_ASSERT_TRUE( hashmap_loadFrom(loaded, fd, deserializeString, deserializeString,
+                                     free) == IO_FAILURE );
+    for (i = 0; i < LEN; i++)
+        (void)hashmap_put(map, keys[i], entries[i], (void **)&prev);
+    CU_ASSERT_TRUE( hashmap_saveTo(map, fd, serializeString, serializeString) == OK );
+
+    // Lookups are served straight from the mapped file
+    CU_ASSERT_TRUE( lseek(fd, 0, SEEK_SET) == 0 );
+    CU_ASSERT_TRUE( snapshot_open(&snapshot, fd) == OK );
+    CU_ASSERT_EQUAL( snapshot_size(snapshot), LEN );
+    CU_ASSERT_TRUE( snapshot_isSorted(snapshot) == FALSE );
+    for (i = 0; i < LEN; i++) {
+        CU_ASSERT_TRUE( snapshot_get(snapshot, keys[i], strlen(keys[i]), &value, &valueLen) ==
+                        OK );
+        CU_ASSERT_EQUAL( valueLen, (long)strlen(entries[i]) );
+        CU_ASSERT_TRUE( memcmp(value, entries[i], valueLen) == 0 );
+    }
+    CU_ASSERT_TRUE( snapshot_get(snapshot, singleKey, strlen(singleKey), &value, &valueLen) ==
+                    NOT_FOUND );
+    CU_ASSERT_TRUE( snapshot_entry(snapshot, 0L, &key, &keyLen, &value, &valueLen) == OK );
+    CU_ASSERT_TRUE( snapshot_entry(snapshot, LEN, &key, &keyLen, &value, &valueLen) ==
+                    INVALID_INDEX );
+    snapshot_close(snapshot);
+
+    // Loading into a map that already holds some of the keys replaces their values
+    CU_ASSERT_TRUE( hashmap_put(loaded, strdup(keys[0]), strdup(singleValue), (void **)&prev) ==
+                    INSERTED );
+    CU_ASSERT_TRUE( hashmap_put(loaded, strdup(singleKey), strdup(singleValue), (void **)&prev) ==
+                    INSERTED );
+    CU_ASSERT_TRUE( lseek(fd, 0, SEEK_SET) == 0 );
+    CU_ASSERT_TRUE( hashmap_loadFrom(loaded, fd, deserializeString, deserializeString,
+                                     free) == OK );
+    CU_ASSERT_EQUAL( hashmap_size(loaded), LEN + 1L );
+    for (i = 0; i < LEN; i++) {
+        CU_ASSERT_TRUE( hashmap_get(loaded, keys[i], (void **)&found) == OK );
+        CU_ASSERT_TRUE( strcmp(found, entries[i]) == 0 );
+    }
+    CU_ASSERT_TRUE( hashmap_containsKey(loaded, singleKey) == TRUE );
+
+    fclose(file);
+    hashmap_destroy(map, NULL);
+    hashmap_destroy(loaded, free);
+
+    CU_PASS("testHashMapSaveLoad() - Test Passed");
+}
+
+/* Positions of the slot count and of the hash index within a snapshot's header */
+#define SNAPSHOT_SLOTS_POS 32
+#define SNAPSHOT_INDEX_POS 48
+
+static void testSnapshotFullIndex() {
+
+    HashMap *map;
+    Snapshot *snapshot;
+    const void *value;
+    long valueLen;
+    uint64_t slots, indexPos, slot[2], j;
+    char *prev;
+    FILE *file;
+    int i, fd;
+
+    Status stat = hashmap_new(&map, hash, keyCmp, CAPACITY, LOAD_FACTOR, NULL);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testSnapshotFullIndex() - allocation failure");
+    if ((file = tmpfile()) == NULL)
+        CU_FAIL_FATAL("ERROR: testSnapshotFullIndex() - could not create a temporary file");
+    fd = fileno(file);
+    for (i = 0; i < LEN; i++)
+        (void)hashmap_put(map, keys[i], entries[i], (void **)&prev);
+    CU_ASSERT_TRUE( hashmap_saveTo(map, fd, serializeString, serializeString) == OK );
+
+    // Fills every slot of the index, pointing at real records under hashes no key has
+    CU_ASSERT_TRUE( pread(fd, &slots, sizeof(slots), SNAPSHOT_SLOTS_POS) == sizeof(slots) );
+    CU_ASSERT_TRUE( pread(fd, &indexPos, sizeof(indexPos), SNAPSHOT_INDEX_POS) ==
+                    sizeof(indexPos) );
+    for (j = 0UL; j < slots; j++) {
+        slot[0] = 0UL;
+        slot[1] = ( j % LEN ) + 1UL;
+        CU_ASSERT_TRUE( pwrite(fd, slot, sizeof(slot), indexPos + j * sizeof(slot)) ==
+                        sizeof(slot) );
+    }
+
+    // Lookups in the damaged index give up after one pass instead of probing forever
+    CU_ASSERT_TRUE( lseek(fd, 0, SEEK_SET) == 0 );
+    CU_ASSERT_TRUE( snapshot_open(&snapshot, fd) == OK );
+    CU_ASSERT_TRUE( snapshot_get(snapshot, keys[0], strlen(keys[0]), &value, &valueLen) ==
+                    NOT_FOUND );
+    CU_ASSERT_TRUE( snapshot_get(snapshot, singleKey, strlen(singleKey), &value, &valueLen) ==
+                    NOT_FOUND );
+    snapshot_close(snapshot);
+
+    fclose(file);
+    hashmap_destroy(map, NULL);
+
+    CU_PASS("testSnapshotFullIndex() - Test Passed");
+}
+
+static void testHashMapFreeze() {
+
+    HashMap *map;
+    FrozenHashMap *frozen;
+    static char buffers[NKEYS][16];
+    char *value, *prev;
+    long before;
+    int i;
+
+    Status stat = hashmap_new(&map, hash, keyCmp, CAPACITY, LOAD_FACTOR, NULL);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testHashMapFreeze() - allocation failure");
+
+    // An empty hashmap freezes into an empty frozen hashmap
+    CU_ASSERT_TRUE( hashmap_freeze(map, &frozen) == OK );
+    CU_ASSERT_EQUAL( frozenhashmap_size(frozen), 0L );
+    CU_ASSERT_TRUE( frozenhashmap_get(frozen, keys[0], (void **)&value) == NOT_FOUND );
+    frozenhashmap_destroy(frozen, NULL);
+
+    // The entries are moved over, leaving the hashmap empty but usable
+    for (i = 0; i < LEN; i++)
+        (void)hashmap_put(map, keys[i], entries[i], (void **)&prev);
+    before = hashmap_memoryUsage(map);
+    CU_ASSERT_TRUE( hashmap_freeze(map, &frozen) == OK );
+    CU_ASSERT_TRUE( hashmap_isEmpty(map) == TRUE );
+    CU_ASSERT_EQUAL( frozenhashmap_size(frozen), LEN );
+    CU_ASSERT_TRUE( frozenhashmap_memoryUsage(frozen) < before );
+    for (i = 0; i < LEN; i++) {
+        CU_ASSERT_TRUE( frozenhashmap_get(frozen, keys[i], (void **)&value) == OK );
+        CU_ASSERT_TRUE( value == entries[i] );
+    }
+    CU_ASSERT_TRUE( frozenhashmap_containsKey(frozen, singleKey) == FALSE );
+    CU_ASSERT_TRUE( hashmap_put(map, singleKey, singleValue, (void **)&prev) == INSERTED );
+    frozenhashmap_destroy(frozen, NULL);
+    hashmap_destroy(map, NULL);
+
+    // Keys whose hash codes all collide are kept aside, and still found
+    stat = hashmap_new(&map, badHash, keyCmp, CAPACITY, LOAD_FACTOR, NULL);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testHashMapFreeze() - allocation failure");
+    for (i = 0; i < LEN; i++)
+        (void)hashmap_put(map, keys[i], entries[i], (void **)&prev);
+    CU_ASSERT_TRUE( hashmap_freeze(map, &frozen) == OK );
+    CU_ASSERT_EQUAL( frozenhashmap_size(frozen), LEN );
+    for (i = 0; i < LEN; i++) {
+        CU_ASSERT_TRUE( frozenhashmap_get(frozen, keys[i], (void **)&value) == OK );
+        CU_ASSERT_TRUE( value == entries[i] );
+    }
+    CU_ASSERT_TRUE( frozenhashmap_containsKey(frozen, singleKey) == FALSE );
+    frozenhashmap_destroy(frozen, NULL);
+    hashmap_destroy(map, NULL);
+
+    // A larger map, with its keys owned by the frozen hashmap afterwards
+    stat = hashmap_newFullHash(&map, fullHash, keyCmp, CAPACITY, LOAD_FACTOR, free);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testHashMapFreeze() - allocation failure");
+    for (i = 0; i < NKEYS; i++) {
+        sprintf(buffers[i], "key-%d", i);
+        (void)hashmap_put(map, strdup(buffers[i]), entries[i % LEN], (void **)&prev);
+    }
+    CU_ASSERT_TRUE( hashmap_freeze(map, &frozen) == OK );
+    hashmap_destroy(map, NULL);
+    CU_ASSERT_EQUAL( frozenhashmap_size(frozen), NKEYS );
+    for (i = 0; i < NKEYS; i++) {
+        CU_ASSERT_TRUE( frozenhashmap_get(frozen, buffers[i], (void **)&value) == OK );
+        CU_ASSERT_TRUE( value == entries[i % LEN] );
+    }
+    CU_ASSERT_TRUE( frozenhashmap_containsKey(frozen, singleKey) == FALSE );
+    frozenhashmap_destroy(frozen, NULL);
+
+    CU_PASS("testHashMapFreeze() - Test Passed");
+}
+
+/* State shared between the copy-on-write writer and its readers */
+#define COW_READERS 3
+static CopyOnWriteHashMap *cowMap;
+static int cowDone;
+
+/**
+ * Reader thread, checks that each key it finds maps to its own value, as every version should.
+ */
+static void *_lookupVersions(void *arg) {
+
+    long *bad = (long *)arg;
+    void *value;
+    int i;
+
+    while (__atomic_load_n(&cowDone, __ATOMIC_ACQUIRE) == 0) {
+        for (i = 0; i < LEN; i++) {
+            if (cow_hashmap_get(cowMap, keys[i], &value) == OK && value != entries[i])
+                __atomic_fetch_add(bad, 1L, __ATOMIC_RELAXED);
+        }
+    }
+
+    return NULL;
+}
+
+static void testCopyOnWriteHashMapConcurrent() {
+
+    pthread_t readers[COW_READERS];
+    long bad = 0L;
+    void *value;
+    int i, j, round;
+
+    if (cow_hashmap_new(&cowMap, hash, keyCmp, CAPACITY, LOAD_FACTOR, NULL) != OK)
+        CU_FAIL_FATAL("ERROR: testCopyOnWriteHashMapConcurrent() - allocation failure");
+
+    cowDone = 0;
+    for (j = 0; j < COW_READERS; j++)
+        CU_ASSERT_TRUE( pthread_create(&readers[j], NULL, _lookupVersions, &bad) == 0 );
+    for (round = 0; round < 200; round++) {
+        for (i = 0; i < LEN; i++)
+            CU_ASSERT_TRUE( cow_hashmap_put(cowMap, keys[i], entries[i], &value) != ALLOC_FAILURE );
+        for (i = round % 2; i < LEN; i += 2)
+            CU_ASSERT_TRUE( cow_hashmap_remove(cowMap, keys[i], &value) == OK );
+    }
+    __atomic_store_n(&cowDone, 1, __ATOMIC_RELEASE);
+    for (j = 0; j < COW_READERS; j++)
+        CU_ASSERT_TRUE( pthread_join(readers[j], NULL) == 0 );
+
+    CU_ASSERT_EQUAL( bad, 0L );
+    CU_ASSERT_EQUAL( cow_hashmap_size(cowMap), LEN / 2L );
+    cow_hashmap_destroy(cowMap, NULL);
+
+    CU_PASS("testCopyOnWriteHashMapConcurrent() - Test Passed");
+}
+
+/* Number of durations each recording thread adds to a probe */
+#define RECORDS 10000L
+
+/**
+ * Recording thread, adds the durations 1 to RECORDS into its own histogram of the probe.
+ */
+static void *_recordDurations(void *arg) {
+
+    long i;
+
+    (void)arg;
+    for (i = 1L; i <= RECORDS; i++)
+        cds_stats_record(CDS_PROBE_QUEUE_POLL, (uint64_t)i);
+
+    return NULL;
+}
+
+static void testHashMapOpStats() {
+
+    pthread_t threads[4];
+    CdsOpStats stats;
+    HashMap *map;
+    void *value;
+    FILE *out;
+    char line[256];
+    int i, found = 0;
+
+    if (hashmap_new(&map, hash, keyCmp, 8L, 0.75, NULL) != OK)
+        CU_FAIL_FATAL("ERROR: testHashMapOpStats() - allocation failure");
+    cds_stats_reset();
+    for (i = 0; i < LEN; i++)
+        CU_ASSERT_TRUE( hashmap_put(map, keys[i], entries[i], &value) == INSERTED );
+    for (i = 0; i < LEN; i++)
+        CU_ASSERT_TRUE( hashmap_get(map, keys[i], &value) == OK );
+
+    // The hashmap's operations are only timed if compiled in
+    cds_stats_get(CDS_PROBE_HASHMAP_PUT, &stats);
+#ifdef CDS_OP_STATS
+    HashStats hashStats;
+    CU_ASSERT_TRUE( stats.count == LEN );
+    CU_ASSERT_TRUE( stats.p50Nanos <= stats.p99Nanos && stats.p99Nanos <= stats.maxNanos );
+    cds_stats_get(CDS_PROBE_HASHMAP_GET, &stats);
+    CU_ASSERT_TRUE( stats.count == LEN );
+    hashmap_stats(map, &hashStats);
+    cds_stats_get(CDS_EVENT_HASHMAP_RESIZE, &stats);
+    CU_ASSERT_TRUE( stats.count == hashStats.resizes && stats.count > 0L );
+#else
+    CU_ASSERT_TRUE( stats.count == 0L && stats.maxNanos == 0L );
+#endif
+    hashmap_destroy(map, NULL);
+
+    // Each thread records into its own histogram, merged together when read
+    cds_stats_reset();
+    for (i = 0; i < 4; i++)
+        CU_ASSERT_TRUE( pthread_create(&threads[i], NULL, _recordDurations, NULL) == 0 );
+    for (i = 0; i < 4; i++)
+        CU_ASSERT_TRUE( pthread_join(threads[i], NULL) == 0 );
+    cds_stats_get(CDS_PROBE_QUEUE_POLL, &stats);
+    CU_ASSERT_TRUE( stats.count == 4L * RECORDS );
+    CU_ASSERT_TRUE( stats.p50Nanos <= stats.p90Nanos && stats.p90Nanos <= stats.p99Nanos );
+    CU_ASSERT_TRUE( stats.p99Nanos <= stats.p999Nanos && stats.p999Nanos <= stats.maxNanos );
+    CU_ASSERT_TRUE( stats.maxNanos > 0L && stats.meanNanos > 0.0 );
+
+    // The dump lists the probes that recorded anything
+    out = tmpfile();
+    CU_ASSERT_TRUE( out != NULL );
+    if (out != NULL) {
+        cds_stats_dump(out);
+        rewind(out);
+        while (fgets(line, sizeof(line), out) != NULL)
+            found += ( strncmp(line, "queue_poll ", 11) == 0 ) ? 1 : 0;
+        fclose(out);
+        CU_ASSERT_TRUE( found == 1 );
+    }
+    cds_stats_reset();
+    cds_stats_get(CDS_PROBE_QUEUE_POLL, &stats);
+    CU_ASSERT_TRUE( stats.count == 0L );
+
+    CU_PASS("testHashMapOpStats() - Test Passed");
+}
+
+/* Visitor counting the entries of the concurrent hashmap whose value matches their key's index */
+static Boolean countMatching(void *key, void *value, void *context) {
+    int i;
+    for (i = 0; i < LEN; i++) {
+        if (key == keys[i] && value == entries[i])
+            ++*(int *)context;
+    }
+    return TRUE;
+}
+
+static void testConcurrentHashMap() {
+
+    ConcurrentHashMap *map;
+    ConcurrentIterator *iter;
+    Array *array;
+    void *previous[LEN], *values[LEN];
+    char *prev, *found;
+    int i, matching;
+
+    Status stat = ts_hashmap_new(&map, hash, keyCmp, CAPACITY, LOAD_FACTOR, NULL);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testConcurrentHashMap() - allocation failure");
+    CU_ASSERT_TRUE( ts_hashmap_isEmpty(map) == TRUE );
+    CU_ASSERT_TRUE( ts_hashmap_keyArray(map, &array) == STRUCT_EMPTY );
+
+    // The first half is put one by one, then the whole batch replaces it and fills the rest
+    for (i = 0; i < LEN / 2; i++)
+        CU_ASSERT_TRUE( ts_hashmap_put(map, keys[i], otherValue, (void **)&prev) == INSERTED );
+    CU_ASSERT_TRUE( ts_hashmap_putAll(map, (void **)keys, (void **)entries, LEN, previous) ==
+                    OK );
+    for (i = 0; i < LEN; i++)
+        CU_ASSERT_TRUE( previous[i] == ( i < LEN / 2 ? otherValue : NULL ) );
+    CU_ASSERT_EQUAL( ts_hashmap_size(map), LEN );
+    CU_ASSERT_EQUAL( ts_hashmap_getAll(map, (void **)keys, values, LEN), LEN );
+    for (i = 0; i < LEN; i++) {
+        CU_ASSERT_TRUE( values[i] == entries[i] );
+        CU_ASSERT_TRUE( ts_hashmap_get(map, keys[i], (void **)&found) == OK );
+        CU_ASSERT_TRUE( found == entries[i] );
+    }
+    CU_ASSERT_TRUE( ts_hashmap_containsKey(map, singleKey) == FALSE );
+
+    // Arrays, iterators and walks see the entries of every stripe
+    CU_ASSERT_TRUE( ts_hashmap_keyArray(map, &array) == OK );
+    CU_ASSERT_EQUAL( array->len, LEN );
+    FREE_ARRAY(array)
+    CU_ASSERT_TRUE( ts_hashmap_entryArray(map, &array) == OK );
+    CU_ASSERT_EQUAL( array->len, LEN );
+    FREE_ARRAY(array)
+    CU_ASSERT_TRUE( ts_hashmap_iterator(map, &iter) == OK );
+    for (i = 0; ts_iterator_hasNext(iter) == TRUE; i++)
+        CU_ASSERT_TRUE( ts_iterator_next(iter, (void **)&prev) == OK );
+    CU_ASSERT_EQUAL( i, LEN );
+    ts_iterator_destroy(iter);
+    matching = 0;
+    CU_ASSERT_TRUE( ts_hashmap_forEach(map, countMatching, &matching) == TRUE );
+    CU_ASSERT_EQUAL( matching, LEN );
+
+    // Holding every stripe still lets the same thread operate on the hashmap
+    ts_hashmap_lock(map);
+    CU_ASSERT_TRUE( ts_hashmap_put(map, singleKey, singleValue, (void **)&prev) == INSERTED );
+    CU_ASSERT_EQUAL( ts_hashmap_size(map), LEN + 1 );
+    ts_hashmap_unlock(map);
+
+    CU_ASSERT_EQUAL( ts_hashmap_removeAll(map, (void **)keys, values, LEN / 2), LEN / 2 );
+    for (i = 0; i < LEN; i++)
+        CU_ASSERT_TRUE( ts_hashmap_containsKey(map, keys[i]) == ( i < LEN / 2 ? FALSE : TRUE ) );
+    CU_ASSERT_TRUE( ts_hashmap_remove(map, singleKey, (void **)&prev) == OK );
+    CU_ASSERT_TRUE( prev == singleValue );
+    CU_ASSERT_EQUAL( ts_hashmap_size(map), LEN - LEN / 2 );
+    ts_hashmap_clear(map, NULL);
+    CU_ASSERT_TRUE( ts_hashmap_isEmpty(map) == TRUE );
+    ts_hashmap_destroy(map, NULL);
+
+    CU_PASS("testConcurrentHashMap() - Test Passed");
+}
+
+/* Number of threads writing to the concurrent hashmap, and the keys each one owns */
+#define WRITERS 4
+#define WRITER_KEYS 4096
+/* Number of keys each writer puts at once */
+#define WRITER_BATCH 64
+
+static char writerKeys[WRITERS * WRITER_KEYS][16];
+
+/* The hashmap a writer works on, and the first of the keys it owns */
+typedef struct {
+    ConcurrentHashMap *map;
+    long first;
+} Writer;
+
+/*
+ * Puts the keys owned by the Writer `arg` in batches, removes the odd ones, then replaces the
+ * value of every fourth one. Returns NULL if every operation succeeded.
+ */
+static void *_writeKeys(void *arg) {
+
+    ConcurrentHashMap *map = ((Writer *)arg)->map;
+    long first = ((Writer *)arg)->first;
+    void *batch[WRITER_BATCH];
+    void *prev, *result = NULL;
+    long i, j;
+
+    for (i = first; i < first + WRITER_KEYS; i += WRITER_BATCH) {
+        for (j = 0L; j < WRITER_BATCH; j++)
+            batch[j] = writerKeys[i + j];
+        if (ts_hashmap_putAll(map, batch, batch, WRITER_BATCH, NULL) != OK)
+            result = arg;
+    }
+    for (i = first + 1L; i < first + WRITER_KEYS; i += 2L) {
+        if (ts_hashmap_remove(map, writerKeys[i], &prev) != OK || prev != writerKeys[i])
+            result = arg;
+    }
+    for (i = first; i < first + WRITER_KEYS; i += 4L) {
+        if (ts_hashmap_put(map, writerKeys[i], otherValue, &prev) != REPLACED)
+            result = arg;
+    }
+
+    return result;
+}
+
+static void testConcurrentHashMapWriters() {
+
+    ConcurrentHashMap *map;
+    ConcurrentIterator *iter;
+    Writer writers[WRITERS];
+    pthread_t threads[WRITERS];
+    void *result, *found;
+    long i, size;
+
+    Status stat = ts_hashmap_newSeeded(&map, hashing_string, hashing_compareString, 0L,
+                                       LOAD_FACTOR, NULL);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testConcurrentHashMapWriters() - allocation failure");
+    for (i = 0L; i < WRITERS * WRITER_KEYS; i++)
+        sprintf(writerKeys[i], "writer-%ld", i);
+    for (i = 0L; i < WRITERS; i++) {
+        writers[i].map = map;
+        writers[i].first = i * WRITER_KEYS;
+        CU_ASSERT_TRUE( pthread_create(&threads[i], NULL, _writeKeys, &writers[i]) == 0 );
+    }
+
+    // Sizes taken while the writers run always count whole operations
+    for (i = 0L; i < 100L; i++) {
+        size = ts_hashmap_size(map);
+        CU_ASSERT_TRUE( size >= 0L && size <= WRITERS * WRITER_KEYS );
+    }
+    for (i = 0L; i < WRITERS; i++) {
+        CU_ASSERT_TRUE( pthread_join(threads[i], &result) == 0 );
+        CU_ASSERT_TRUE( result == NULL );
+    }
+
+    // The even keys remain, every fourth one holding the replaced value
+    CU_ASSERT_EQUAL( ts_hashmap_size(map), WRITERS * WRITER_KEYS / 2 );
+    for (i = 0L; i < WRITERS * WRITER_KEYS; i++) {
+        if (i % 2L == 1L) {
+            CU_ASSERT_TRUE( ts_hashmap_get(map, writerKeys[i], &found) == NOT_FOUND );
+        } else {
+            CU_ASSERT_TRUE( ts_hashmap_get(map, writerKeys[i], &found) == OK );
+            CU_ASSERT_TRUE( found == ( i % 4L == 0L ? (void *)otherValue : writerKeys[i] ) );
+        }
+    }
+    CU_ASSERT_TRUE( ts_hashmap_iterator(map, &iter) == OK );
+    for (i = 0L; ts_iterator_hasNext(iter) == TRUE; i++)
+        CU_ASSERT_TRUE( ts_iterator_next(iter, &found) == OK );
+    CU_ASSERT_EQUAL( i, WRITERS * WRITER_KEYS / 2 );
+    ts_iterator_destroy(iter);
+    ts_hashmap_destroy(map, NULL);
+
+    CU_PASS("testConcurrentHashMapWriters() - Test Passed");
+}
+
 #define UNUSED __attribute__((unused))
 int main(UNUSED int argc, UNUSED char **argv) {
 
@@ -278,6 +1686,29 @@ int main(UNUSED int argc, UNUSED char **argv) {
     CU_add_test(suite, "HashMap - Clear", testHashMapClear);
     CU_add_test(suite, "HashMap - Array", testHashMapToArray);
     CU_add_test(suite, "HashMap - Iterator", testHashMapIterator);
+    CU_add_test(suite, "HashMap - Cursor", testHashMapCursor);
+    CU_add_test(suite, "HashMap - Snapshot", testHashMapSnapshot);
+    CU_add_test(suite, "HashMap - For Each", testHashMapForEach);
+    CU_add_test(suite, "HashMap - Memory Usage", testHashMapMemoryUsage);
+    CU_add_test(suite, "HashMap - Allocator", testHashMapAllocator);
+    CU_add_test(suite, "HashMap - Parallel", testHashMapParallel);
+    CU_add_test(suite, "HashMap - Full Hash", testHashMapFullHash);
+    CU_add_test(suite, "HashMap - Flat", testHashMapFlat);
+    CU_add_test(suite, "HashMap - Incremental Resize", testHashMapIncremental);
+    CU_add_test(suite, "HashMap - Batch", testHashMapBatch);
+    CU_add_test(suite, "HashMap - Shrink", testHashMapShrink);
+    CU_add_test(suite, "HashMap - Reserve", testHashMapReserve);
+    CU_add_test(suite, "HashMap - Seeded", testHashMapSeeded);
+    CU_add_test(suite, "HashMap - Small", testHashMapSmall);
+    CU_add_test(suite, "HashMap - Stats", testHashMapStats);
+    CU_add_test(suite, "HashMap - Save and Load", testHashMapSaveLoad);
+    CU_add_test(suite, "HashMap - Snapshot Full Index", testSnapshotFullIndex);
+    CU_add_test(suite, "HashMap - Freeze", testHashMapFreeze);
+    CU_add_test(suite, "HashMap - Copy on Write", testCopyOnWriteHashMap);
+    CU_add_test(suite, "HashMap - Copy on Write Concurrent", testCopyOnWriteHashMapConcurrent);
+    CU_add_test(suite, "HashMap - Operation Stats", testHashMapOpStats);
+    CU_add_test(suite, "HashMap - Concurrent", testConcurrentHashMap);
+    CU_add_test(suite, "HashMap - Concurrent Writers", testConcurrentHashMapWriters);
 
     CU_basic_set_mode(CU_BRM_VERBOSE);
     CU_basic_run_tests();
@@ -22,9 +22,11 @@
  * SOFTWARE.
  */
 
+#include <stdio.h>
 #include <stdlib.h>
 #include <CUnit/Basic.h>
 #include "hash_set.h"
+#include "ts_hash_set.h"
 
 /* Default capacity for the hashset */
 #define CAPACITY 4L
@@ -61,6 +63,15 @@ static char *array[] = {
     "blue gray", "indigo", "pea green", "amber", "peach", "maroon"
 };
 
+/* Number of elements passed to countDestroyed() so far */
+static int destroyed = 0;
+
+/* Destructor counting the elements it is called on, leaving the elements themselves alone */
+static void countDestroyed(void *item) {
+    (void)item;
+    destroyed++;
+}
+
 static void validateEmptyHashSet(HashSet *set) {
 
     Array *arr;
@@ -156,7 +167,20 @@ static void testHashSetClear() {
 
     hashset_clear(set, NULL);
     validateEmptyHashSet(set);
-    hashset_destroy(set, NULL);
+
+    // The set is reusable once cleared, and the destructor sees every element exactly once
+    for (i = 0; i < LEN; i++)
+        CU_ASSERT_TRUE( hashset_add(set, array[i]) == OK );
+    CU_ASSERT_TRUE( hashset_contains(set, array[0]) == TRUE );
+    destroyed = 0;
+    hashset_clear(set, countDestroyed);
+    CU_ASSERT_TRUE( destroyed == LEN );
+    validateEmptyHashSet(set);
+    for (i = 0; i < LEN; i++)
+        CU_ASSERT_TRUE( hashset_add(set, array[i]) == OK );
+    destroyed = 0;
+    hashset_destroy(set, countDestroyed);
+    CU_ASSERT_TRUE( destroyed == LEN );
 
     CU_PASS("testHashSetClear() - Test Passed");
 }
@@ -203,6 +227,527 @@ static void testHashSetIterator() {
     CU_PASS("testHashSetIterator() - Test Passed");
 }
 
+#define NITEMS 2000
+static void testHashSetIncremental() {
+
+    HashSet *set;
+    Iterator *iter;
+    Array *arr;
+    Status stat;
+    static char buffers[NITEMS][16];
+    char *item;
+    long count;
+    int i;
+
+    stat = hashset_new(&set, hash, strCmp, CAPACITY, LOAD_FACTOR);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testHashSetIncremental() - allocation failure");
+    hashset_setIncrementalResize(set, TRUE);
+
+    /* Every item must stay reachable while the buckets are moved over */
+    for (i = 0; i < NITEMS; i++) {
+        sprintf(buffers[i], "inc-%d", i);
+        CU_ASSERT_TRUE( hashset_add(set, buffers[i]) == OK );
+        CU_ASSERT_TRUE( hashset_add(set, buffers[i / 2]) == ALREADY_EXISTS );
+        CU_ASSERT_TRUE( hashset_contains(set, buffers[0]) == TRUE );
+    }
+    CU_ASSERT_TRUE( hashset_size(set) == NITEMS );
+
+    for (i = 0; i < NITEMS; i += 2)
+        CU_ASSERT_TRUE( hashset_remove(set, buffers[i], NULL) == OK );
+    CU_ASSERT_TRUE( hashset_size(set) == NITEMS / 2 );
+    for (i = 0; i < NITEMS; i++)
+        CU_ASSERT_TRUE( hashset_contains(set, buffers[i]) == ( (i % 2) ? TRUE : FALSE ) );
+    CU_ASSERT_TRUE( hashset_toArray(set, &arr) == OK );
+    CU_ASSERT_TRUE( arr->len == NITEMS / 2 );
+    FREE_ARRAY(arr)
+
+    count = 0L;
+    CU_ASSERT_TRUE( hashset_iterator(set, &iter) == OK );
+    while (iterator_hasNext(iter) == TRUE) {
+        CU_ASSERT_TRUE( iterator_next(iter, (void **)&item) == OK );
+        CU_ASSERT_TRUE( hashset_contains(set, item) == TRUE );
+        count++;
+    }
+    CU_ASSERT_TRUE( count == NITEMS / 2 );
+    iterator_destroy(iter);
+
+    hashset_clear(set, NULL);
+    validateEmptyHashSet(set);
+    hashset_destroy(set, NULL);
+
+    CU_PASS("testHashSetIncremental() - Test Passed");
+}
+
+static void testHashSetBatch() {
+
+    HashSet *set;
+    Status stat;
+    static char buffers[NITEMS][16];
+    static void *items[NITEMS];
+    static Boolean results[NITEMS];
+    int i;
+
+    stat = hashset_new(&set, hash, strCmp, CAPACITY, LOAD_FACTOR);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testHashSetBatch() - allocation failure");
+
+    for (i = 0; i < NITEMS; i++) {
+        sprintf(buffers[i], "batch-%d", i);
+        items[i] = buffers[i];
+    }
+    CU_ASSERT_TRUE( hashset_removeAll(set, items, NITEMS, NULL) == 0L );
+
+    /* Adds the first half, then the whole batch, skipping the items already present */
+    CU_ASSERT_TRUE( hashset_addAll(set, items, NITEMS / 2) == OK );
+    CU_ASSERT_TRUE( hashset_size(set) == NITEMS / 2 );
+    CU_ASSERT_TRUE( hashset_addAll(set, items, NITEMS) == OK );
+    CU_ASSERT_TRUE( hashset_size(set) == NITEMS );
+    for (i = 0; i < NITEMS; i++)
+        CU_ASSERT_TRUE( hashset_contains(set, buffers[i]) == TRUE );
+
+    /* Removes every other item, including one that is missing */
+    for (i = 0; i < NITEMS / 2; i++)
+        items[i] = buffers[i * 2];
+    items[0] = singleItem;
+    CU_ASSERT_TRUE( hashset_removeAll(set, items, NITEMS / 2, NULL) == NITEMS / 2 - 1 );
+    CU_ASSERT_TRUE( hashset_size(set) == NITEMS / 2 + 1 );
+    for (i = 1; i < NITEMS; i++)
+        CU_ASSERT_TRUE( hashset_contains(set, buffers[i]) == ( (i % 2) ? TRUE : FALSE ) );
+    CU_ASSERT_TRUE( hashset_contains(set, buffers[0]) == TRUE );
+
+    /* Looks up the whole batch at once, which must agree with the single lookups */
+    for (i = 0; i < NITEMS; i++)
+        items[i] = buffers[i];
+    CU_ASSERT_TRUE( hashset_containsMany(set, items, NITEMS, results) == NITEMS / 2 + 1 );
+    for (i = 0; i < NITEMS; i++)
+        CU_ASSERT_TRUE( results[i] == hashset_contains(set, buffers[i]) );
+
+    hashset_clear(set, NULL);
+    validateEmptyHashSet(set);
+    hashset_destroy(set, NULL);
+
+    CU_PASS("testHashSetBatch() - Test Passed");
+}
+
+static void testHashSetShrink() {
+
+    HashSet *set;
+    Status stat;
+    static char buffers[NITEMS][16];
+    int i, j, round;
+
+    stat = hashset_new(&set, hash, strCmp, CAPACITY, LOAD_FACTOR);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testHashSetShrink() - allocation failure");
+
+    for (i = 0; i < NITEMS; i++)
+        sprintf(buffers[i], "spike-%d", i);
+
+    /* Spikes and drains twice, the second time while resizing incrementally */
+    for (round = 0; round < 2; round++) {
+        hashset_setIncrementalResize(set, ( round == 1 ) ? TRUE : FALSE);
+        for (i = 0; i < NITEMS; i++)
+            CU_ASSERT_TRUE( hashset_add(set, buffers[i]) == OK );
+        for (i = NITEMS - 1; i >= 10; i--) {
+            CU_ASSERT_TRUE( hashset_remove(set, buffers[i], NULL) == OK );
+            if (i % 97 == 0) {
+                for (j = 0; j < i; j++)
+                    CU_ASSERT_TRUE( hashset_contains(set, buffers[j]) == TRUE );
+            }
+        }
+        CU_ASSERT_TRUE( hashset_size(set) == 10L );
+        for (i = 0; i < NITEMS; i++)
+            CU_ASSERT_TRUE( hashset_contains(set, buffers[i]) == ( (i < 10) ? TRUE : FALSE ) );
+        for (i = 0; i < 10; i++)
+            CU_ASSERT_TRUE( hashset_remove(set, buffers[i], NULL) == OK );
+        validateEmptyHashSet(set);
+    }
+    hashset_destroy(set, NULL);
+
+    CU_PASS("testHashSetShrink() - Test Passed");
+}
+
+static void testHashSetReserve() {
+
+    HashSet *set;
+    Status stat;
+    static char buffers[NITEMS][16];
+    int i;
+
+    stat = hashset_new(&set, hash, strCmp, CAPACITY, LOAD_FACTOR);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testHashSetReserve() - allocation failure");
+
+    CU_ASSERT_TRUE( hashset_reserve(set, NITEMS) == OK );
+    CU_ASSERT_TRUE( hashset_reserve(set, 1L) == OK );
+    for (i = 0; i < NITEMS; i++) {
+        sprintf(buffers[i], "reserve-%d", i);
+        CU_ASSERT_TRUE( hashset_add(set, buffers[i]) == OK );
+    }
+    CU_ASSERT_TRUE( hashset_size(set) == NITEMS );
+
+    /* Drains most of the set, then shrinks what is left to fit */
+    for (i = 10; i < NITEMS; i++)
+        CU_ASSERT_TRUE( hashset_remove(set, buffers[i], NULL) == OK );
+    CU_ASSERT_TRUE( hashset_shrinkToFit(set) == OK );
+    CU_ASSERT_TRUE( hashset_size(set) == 10L );
+    for (i = 0; i < NITEMS; i++)
+        CU_ASSERT_TRUE( hashset_contains(set, buffers[i]) == ( (i < 10) ? TRUE : FALSE ) );
+
+    hashset_clear(set, NULL);
+    CU_ASSERT_TRUE( hashset_shrinkToFit(set) == OK );
+    validateEmptyHashSet(set);
+    for (i = 0; i < NITEMS; i++)
+        CU_ASSERT_TRUE( hashset_add(set, buffers[i]) == OK );
+    CU_ASSERT_TRUE( hashset_size(set) == NITEMS );
+    hashset_destroy(set, NULL);
+
+    CU_PASS("testHashSetReserve() - Test Passed");
+}
+
+static void testHashSetSeeded() {
+
+    HashSet *set;
+    Status stat;
+    static char buffers[NITEMS][16];
+    static void *items[NITEMS];
+    static Boolean results[NITEMS];
+    int i;
+
+    stat = hashset_newSeeded(&set, hashing_string, hashing_compareString, CAPACITY, LOAD_FACTOR);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testHashSetSeeded() - allocation failure");
+    hashset_setIncrementalResize(set, TRUE);
+
+    for (i = 0; i < NITEMS; i++) {
+        sprintf(buffers[i], "seeded-%d", i);
+        items[i] = buffers[i];
+        CU_ASSERT_TRUE( hashset_add(set, buffers[i]) == OK );
+        CU_ASSERT_TRUE( hashset_contains(set, buffers[i / 2]) == TRUE );
+    }
+    CU_ASSERT_TRUE( hashset_add(set, buffers[0]) == ALREADY_EXISTS );
+    CU_ASSERT_TRUE( hashset_size(set) == NITEMS );
+    CU_ASSERT_TRUE( hashset_containsMany(set, items, NITEMS, results) == NITEMS );
+
+    /* Drains the set while it shrinks, then shrinks the rest to fit */
+    for (i = 0; i < NITEMS - 10; i++) {
+        CU_ASSERT_TRUE( hashset_remove(set, buffers[i], NULL) == OK );
+        CU_ASSERT_TRUE( hashset_contains(set, buffers[NITEMS - 1]) == TRUE );
+    }
+    CU_ASSERT_TRUE( hashset_shrinkToFit(set) == OK );
+    for (i = 0; i < NITEMS; i++)
+        CU_ASSERT_TRUE( hashset_contains(set, buffers[i]) == ( (i < NITEMS - 10) ? FALSE : TRUE ) );
+    CU_ASSERT_TRUE( hashset_reserve(set, NITEMS) == OK );
+    CU_ASSERT_TRUE( hashset_addAll(set, items, NITEMS) == OK );
+    CU_ASSERT_TRUE( hashset_size(set) == NITEMS );
+
+    hashset_clear(set, NULL);
+    validateEmptyHashSet(set);
+    hashset_destroy(set, NULL);
+
+    CU_PASS("testHashSetSeeded() - Test Passed");
+}
+
+static void testHashSetSmall() {
+
+    HashSet *set;
+    HashStats stats;
+    Cursor cursor;
+    Status stat;
+    static void *items[LEN];
+    static Boolean results[LEN];
+    int i;
+    long count;
+    char *item;
+
+    stat = hashset_newSmall(&set, hashing_string, hashing_compareString, LOAD_FACTOR);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testHashSetSmall() - allocation failure");
+    validateEmptyHashSet(set);
+
+    /* Fills the inline entries, which must not grow the set */
+    for (i = 0; i < 8; i++)
+        CU_ASSERT_TRUE( hashset_add(set, array[i]) == OK );
+    CU_ASSERT_TRUE( hashset_add(set, array[5]) == ALREADY_EXISTS );
+    hashset_stats(set, &stats);
+    CU_ASSERT_TRUE( stats.capacity == 8L && stats.size == 8L && stats.resizes == 0L );
+    CU_ASSERT_TRUE( hashset_remove(set, array[1], NULL) == OK );
+    CU_ASSERT_TRUE( hashset_remove(set, array[1], NULL) == NOT_FOUND );
+    for (i = 0; i < 8; i++)
+        CU_ASSERT_TRUE( hashset_contains(set, array[i]) == ( (i != 1) ? TRUE : FALSE ) );
+    count = 0L;
+    hashset_cursor(set, &cursor);
+    while (hashset_cursorNext(&cursor, (void **)&item) == OK) {
+        CU_ASSERT_TRUE( hashset_contains(set, item) == TRUE );
+        count++;
+    }
+    CU_ASSERT_TRUE( count == 7L );
+
+    /* Adding past the inline entries promotes the set, keeping every element */
+    for (i = 0; i < LEN; i++)
+        items[i] = array[i];
+    CU_ASSERT_TRUE( hashset_addAll(set, items, LEN) == OK );
+    hashset_stats(set, &stats);
+    CU_ASSERT_TRUE( stats.size == LEN && stats.capacity > 8L && stats.resizes > 0L );
+    CU_ASSERT_TRUE( hashset_containsMany(set, items, LEN, results) == LEN );
+    CU_ASSERT_TRUE( hashset_removeAll(set, items, LEN, NULL) == LEN );
+    validateEmptyHashSet(set);
+    hashset_destroy(set, NULL);
+
+    /* Reserving room for more elements than fit inline promotes the set up front */
+    stat = hashset_newSmall(&set, hashing_string, hashing_compareString, LOAD_FACTOR);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testHashSetSmall() - allocation failure");
+    CU_ASSERT_TRUE( hashset_shrinkToFit(set) == OK );
+    CU_ASSERT_TRUE( hashset_reserve(set, LEN) == OK );
+    hashset_stats(set, &stats);
+    CU_ASSERT_TRUE( stats.capacity > 8L && stats.resizes == 1L );
+    for (i = 0; i < LEN; i++)
+        CU_ASSERT_TRUE( hashset_add(set, array[i]) == OK );
+    hashset_clear(set, NULL);
+    validateEmptyHashSet(set);
+    hashset_destroy(set, NULL);
+
+    CU_PASS("testHashSetSmall() - Test Passed");
+}
+
+static void testHashSetStats() {
+
+    HashSet *set;
+    HashStats stats;
+    Status stat;
+    static char buffers[NITEMS][16];
+    long i, chains = 0L, total = 0L;
+
+    stat = hashset_newSeeded(&set, hashing_string, strCmp, CAPACITY, LOAD_FACTOR);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testHashSetStats() - allocation failure");
+    hashset_stats(set, &stats);
+    CU_ASSERT_TRUE( stats.size == 0L && stats.usedBuckets == 0L && stats.maxChain == 0L );
+    CU_ASSERT_TRUE( stats.histogram[0] == stats.capacity && stats.resizes == 0L );
+
+    for (i = 0L; i < NITEMS; i++) {
+        sprintf(buffers[i], "stats-%ld", i);
+        CU_ASSERT_TRUE( hashset_add(set, buffers[i]) == OK );
+    }
+    hashset_stats(set, &stats);
+    CU_ASSERT_TRUE( stats.size == NITEMS && stats.load <= LOAD_FACTOR );
+    CU_ASSERT_TRUE( stats.resizes > 0L && stats.maxChain < 10L );
+
+    /* Every bucket is accounted for, and the chains add up to the set's size */
+    for (i = 0L; i < HASH_STATS_BINS; i++) {
+        chains += stats.histogram[i];
+        total += ( i * stats.histogram[i] );
+    }
+    CU_ASSERT_TRUE( chains == stats.capacity && total == NITEMS );
+    CU_ASSERT_TRUE( chains - stats.histogram[0] == stats.usedBuckets );
+    hashset_destroy(set, NULL);
+
+    CU_PASS("testHashSetStats() - Test Passed");
+}
+
+static void testHashSetCursor() {
+
+    Iterator *iter;
+    Cursor cursor;
+    HashSet *set;
+    Status stat;
+    int i;
+    char *item, *other;
+
+    stat = hashset_new(&set, hash, strCmp, CAPACITY, LOAD_FACTOR);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testHashSetCursor() - allocation failure");
+
+    hashset_cursor(set, &cursor);
+    CU_ASSERT_TRUE( cursor_hasNext(&cursor) == FALSE );
+    CU_ASSERT_TRUE( hashset_cursorNext(&cursor, (void **)&item) == ITER_END );
+
+    for (i = 0; i < LEN; i++)
+        CU_ASSERT_TRUE( hashset_add(set, array[i]) == OK );
+    CU_ASSERT_TRUE( hashset_iterator(set, &iter) == OK );
+
+    // The cursor must visit the same items in the same order as the iterator
+    i = 0;
+    hashset_cursor(set, &cursor);
+    while (cursor_hasNext(&cursor) == TRUE) {
+        CU_ASSERT_TRUE( hashset_cursorNext(&cursor, (void **)&item) == OK );
+        CU_ASSERT_TRUE( iterator_next(iter, (void **)&other) == OK );
+        CU_ASSERT_TRUE( item == other );
+        i++;
+    }
+    CU_ASSERT_EQUAL( i, LEN );
+    CU_ASSERT_TRUE( hashset_cursorNext(&cursor, (void **)&item) == ITER_END );
+    iterator_destroy(iter);
+
+    // A structural change invalidates any cursor already in progress
+    hashset_cursor(set, &cursor);
+    CU_ASSERT_TRUE( hashset_cursorNext(&cursor, (void **)&item) == OK );
+    CU_ASSERT_TRUE( hashset_add(set, singleItem) == OK );
+    CU_ASSERT_TRUE( hashset_cursorNext(&cursor, (void **)&item) == CONCURRENT_MODIFICATION );
+    hashset_destroy(set, NULL);
+
+    CU_PASS("testHashSetCursor() - Test Passed");
+}
+
+/* Number of distinct elements used when testing the set operations */
+#define SETOP_LEN 3000
+
+/* Two copies of the same keys, for telling which hashset the elements of a result come from */
+static char keysA[SETOP_LEN][8];
+static char keysB[SETOP_LEN][8];
+
+/* Result of findIn(), the copy of the key held by the set */
+static void *foundKey;
+
+static Boolean findIn(void *item, void *context) {
+    if (strcmp((char *)item, (char *)context) == 0) {
+        foundKey = item;
+        return FALSE;
+    }
+    return TRUE;
+}
+
+/* Checks that `result` holds exactly the keys `i` for which `owner[i]` is set, taking each of them
+ * from `keysA` if 'a', or from `keysB` if 'b' */
+static void validateSetOp(HashSet *result, const char *owner) {
+
+    long i, size = 0L;
+
+    for (i = 0L; i < SETOP_LEN; i++) {
+        if (owner[i] != 0) {
+            size++;
+            foundKey = NULL;
+            hashset_forEach(result, findIn, keysA[i]);
+            CU_ASSERT_TRUE( foundKey == (void *)( owner[i] == 'a' ? keysA[i] : keysB[i] ) );
+        } else {
+            CU_ASSERT_TRUE( hashset_contains(result, keysA[i]) == FALSE );
+        }
+    }
+    CU_ASSERT_TRUE( hashset_size(result) == size );
+}
+
+static void testHashSetAlgebra() {
+
+    static char owner[SETOP_LEN];
+    HashSet *a, *b, *result;
+    long i;
+
+    if (hashset_newSeeded(&a, hashing_string, hashing_compareString, 0L, 0.0) != OK
+            || hashset_new(&b, hash, strCmp, CAPACITY, LOAD_FACTOR) != OK)
+        CU_FAIL_FATAL("ERROR: testHashSetAlgebra() - allocation failure");
+
+    // `a` holds the multiples of 2, `b` the multiples of 3
+    for (i = 0L; i < SETOP_LEN; i++) {
+        sprintf(keysA[i], "%05ld", i);
+        sprintf(keysB[i], "%05ld", i);
+        if (i % 2L == 0L)
+            CU_ASSERT_TRUE( hashset_add(a, keysA[i]) == OK );
+        if (i % 3L == 0L)
+            CU_ASSERT_TRUE( hashset_add(b, keysB[i]) == OK );
+    }
+
+    // Elements in both hashsets are taken from the first one, whichever is walked
+    CU_ASSERT_TRUE( hashset_union(a, b, &result) == OK );
+    for (i = 0L; i < SETOP_LEN; i++)
+        owner[i] = ( i % 2L == 0L ) ? 'a' : ( i % 3L == 0L ) ? 'b' : 0;
+    validateSetOp(result, owner);
+    hashset_destroy(result, NULL);
+
+    CU_ASSERT_TRUE( hashset_intersect(a, b, &result) == OK );
+    for (i = 0L; i < SETOP_LEN; i++)
+        owner[i] = ( i % 6L == 0L ) ? 'a' : 0;
+    validateSetOp(result, owner);
+    hashset_destroy(result, NULL);
+
+    CU_ASSERT_TRUE( hashset_difference(a, b, &result) == OK );
+    for (i = 0L; i < SETOP_LEN; i++)
+        owner[i] = ( i % 2L == 0L && i % 3L != 0L ) ? 'a' : 0;
+    validateSetOp(result, owner);
+    hashset_destroy(result, NULL);
+
+    // The result of an unseeded hashset hashes the same way, so it can still be added to
+    CU_ASSERT_TRUE( hashset_difference(b, a, &result) == OK );
+    for (i = 0L; i < SETOP_LEN; i++)
+        owner[i] = ( i % 3L == 0L && i % 2L != 0L ) ? 'b' : 0;
+    validateSetOp(result, owner);
+    CU_ASSERT_TRUE( hashset_add(result, keysA[1]) == OK );
+    hashset_destroy(result, NULL);
+
+    hashset_destroy(a, NULL);
+    hashset_destroy(b, NULL);
+
+    CU_PASS("testHashSetAlgebra() - Test Passed");
+}
+
+/* Number of distinct elements built in parallel */
+#define BUILD_DISTINCT 100000L
+/* Number of elements in the parallel build, each distinct element appearing twice */
+#define BUILD_LEN ( 2L * BUILD_DISTINCT )
+/* Number of threads building the concurrent hashset */
+#define BUILD_THREADS 4
+
+/*
+ * Tests the concurrent hashset's stripes and its parallel bulk build, including duplicates within
+ * the batch.
+ */
+static void testConcurrentHashSet() {
+
+    ConcurrentHashSet *set;
+    Array *items;
+    static char buffers[BUILD_DISTINCT][12];
+    static void *batch[BUILD_LEN];
+    long i;
+
+    CU_ASSERT_TRUE( ts_hashset_new(&set, hash, strCmp, CAPACITY, LOAD_FACTOR) == OK );
+    CU_ASSERT_TRUE( ts_hashset_isEmpty(set) == TRUE );
+    CU_ASSERT_TRUE( ts_hashset_toArray(set, &items) == STRUCT_EMPTY );
+    for (i = 0L; i < LEN; i++)
+        CU_ASSERT_TRUE( ts_hashset_add(set, array[i]) == OK );
+    CU_ASSERT_TRUE( ts_hashset_add(set, array[0]) == ALREADY_EXISTS );
+    CU_ASSERT_TRUE( ts_hashset_addAll(set, (void **)array, LEN) == OK );
+    CU_ASSERT_TRUE( ts_hashset_size(set) == LEN );
+    CU_ASSERT_TRUE( ts_hashset_toArray(set, &items) == OK );
+    CU_ASSERT_TRUE( items->len == LEN );
+    FREE_ARRAY(items)
+    CU_ASSERT_TRUE( ts_hashset_removeAll(set, (void **)array, LEN / 2, NULL) == LEN / 2 );
+    for (i = 0L; i < LEN; i++)
+        CU_ASSERT_TRUE( ts_hashset_contains(set, array[i]) == ( i < LEN / 2 ? FALSE : TRUE ) );
+    ts_hashset_destroy(set, NULL);
+
+    // Every distinct element appears twice, in separate threads' shares of the batch
+    CU_ASSERT_TRUE( ts_hashset_newSeeded(&set, hashing_string, hashing_compareString, 0L,
+                                         LOAD_FACTOR) == OK );
+    for (i = 0L; i < BUILD_DISTINCT; i++) {
+        sprintf(buffers[i], "id-%ld", i);
+        batch[i] = batch[BUILD_DISTINCT + i] = buffers[i];
+    }
+    CU_ASSERT_TRUE( ts_hashset_addAllParallel(set, batch, BUILD_LEN, BUILD_THREADS) == OK );
+    CU_ASSERT_TRUE( ts_hashset_size(set) == BUILD_DISTINCT );
+    for (i = 0L; i < BUILD_DISTINCT; i++)
+        CU_ASSERT_TRUE( ts_hashset_contains(set, buffers[i]) == TRUE );
+    CU_ASSERT_TRUE( ts_hashset_contains(set, singleItem) == FALSE );
+
+    // Building again only finds duplicates, as does a batch too small to be split
+    CU_ASSERT_TRUE( ts_hashset_addAllParallel(set, batch, BUILD_LEN, BUILD_THREADS) == OK );
+    CU_ASSERT_TRUE( ts_hashset_addAllParallel(set, batch, 10L, BUILD_THREADS) == OK );
+    CU_ASSERT_TRUE( ts_hashset_size(set) == BUILD_DISTINCT );
+    CU_ASSERT_TRUE( ts_hashset_toArray(set, &items) == OK );
+    CU_ASSERT_TRUE( items->len == BUILD_DISTINCT );
+    FREE_ARRAY(items)
+
+    CU_ASSERT_TRUE( ts_hashset_removeAll(set, batch, BUILD_DISTINCT, NULL) == BUILD_DISTINCT );
+    CU_ASSERT_TRUE( ts_hashset_isEmpty(set) == TRUE );
+    CU_ASSERT_TRUE( ts_hashset_addAllParallel(set, batch, BUILD_LEN, 1) == OK );
+    CU_ASSERT_TRUE( ts_hashset_size(set) == BUILD_DISTINCT );
+    ts_hashset_clear(set, NULL);
+    CU_ASSERT_TRUE( ts_hashset_isEmpty(set) == TRUE );
+    ts_hashset_destroy(set, NULL);
+
+    CU_PASS("testConcurrentHashSet() - Test Passed");
+}
+
 #define UNUSED __attribute__((unused))
 int main(UNUSED int argc, UNUSED char **argv) {
 
@@ -222,6 +767,16 @@ int main(UNUSED int argc, UNUSED char **argv) {
     CU_add_test(suite, "Hashset - Clear", testHashSetClear);
     CU_add_test(suite, "HashSet - Array", testHashSetToArray);
     CU_add_test(suite, "HashSet - Iterator", testHashSetIterator);
+    CU_add_test(suite, "HashSet - Cursor", testHashSetCursor);
+    CU_add_test(suite, "HashSet - Incremental Resize", testHashSetIncremental);
+    CU_add_test(suite, "HashSet - Batch", testHashSetBatch);
+    CU_add_test(suite, "HashSet - Shrink", testHashSetShrink);
+    CU_add_test(suite, "HashSet - Reserve", testHashSetReserve);
+    CU_add_test(suite, "HashSet - Seeded", testHashSetSeeded);
+    CU_add_test(suite, "HashSet - Small", testHashSetSmall);
+    CU_add_test(suite, "HashSet - Stats", testHashSetStats);
+    CU_add_test(suite, "HashSet - Algebra", testHashSetAlgebra);
+    CU_add_test(suite, "HashSet - Concurrent", testConcurrentHashSet);
 
     CU_basic_set_mode(CU_BRM_VERBOSE);
     CU_basic_run_tests();
@@ -213,6 +213,278 @@ static void testHeapIterator() {
     CU_PASS("testHeapIterator() - Test Passed");
 }
 
+static void testHeapCursor() {
+
+    Iterator *iter;
+    Cursor cursor;
+    Heap *heap;
+    Status stat;
+    int i;
+    char *item, *other;
+
+    stat = heap_new(&heap, CAPACITY, heapCmp);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testHeapCursor() - allocation failure");
+
+    heap_cursor(heap, &cursor);
+    CU_ASSERT_TRUE( cursor_hasNext(&cursor) == FALSE );
+    CU_ASSERT_TRUE( heap_cursorNext(&cursor, (void **)&item) == ITER_END );
+
+    for (i = 0; i < LEN; i++)
+        CU_ASSERT_TRUE( heap_insert(heap, array[i]) == OK );
+    CU_ASSERT_TRUE( heap_iterator(heap, &iter) == OK );
+
+    // The cursor must visit the same items in the same order as the iterator
+    i = 0;
+    heap_cursor(heap, &cursor);
+    while (cursor_hasNext(&cursor) == TRUE) {
+        CU_ASSERT_TRUE( heap_cursorNext(&cursor, (void **)&item) == OK );
+        CU_ASSERT_TRUE( iterator_next(iter, (void **)&other) == OK );
+        CU_ASSERT_TRUE( item == other );
+        i++;
+    }
+    CU_ASSERT_EQUAL( i, LEN );
+    CU_ASSERT_TRUE( heap_cursorNext(&cursor, (void **)&item) == ITER_END );
+    iterator_destroy(iter);
+
+    // A structural change invalidates any cursor already in progress
+    heap_cursor(heap, &cursor);
+    CU_ASSERT_TRUE( heap_cursorNext(&cursor, (void **)&item) == OK );
+    CU_ASSERT_TRUE( heap_poll(heap, (void **)&item) == OK );
+    CU_ASSERT_TRUE( heap_cursorNext(&cursor, (void **)&item) == CONCURRENT_MODIFICATION );
+    heap_destroy(heap, NULL);
+
+    CU_PASS("testHeapCursor() - Test Passed");
+}
+
+static void testHeapFromArray() {
+
+    Heap *heap;
+    Status stat;
+    int i;
+    char *item;
+
+    stat = heap_fromArray(&heap, NULL, 0L, heapCmp);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testHeapFromArray() - allocation failure");
+    validateEmptyHeap(heap);
+    heap_destroy(heap, NULL);
+
+    stat = heap_fromArray(&heap, (void **)array, LEN, heapCmp);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testHeapFromArray() - allocation failure");
+    CU_ASSERT_TRUE( heap_size(heap) == LEN );
+    for (i = 0; i < LEN; i++) {
+        CU_ASSERT_TRUE( heap_poll(heap, (void **)&item) == OK );
+        CU_ASSERT_TRUE( strcmp(item, orderedArray[i]) == 0 );
+    }
+    validateEmptyHeap(heap);
+    heap_destroy(heap, NULL);
+
+    CU_PASS("testHeapFromArray() - Test Passed");
+}
+
+static void testHeapInsertAll() {
+
+    Heap *heap;
+    Status stat;
+    int i;
+    char *item;
+
+    stat = heap_new(&heap, CAPACITY, heapCmp);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testHeapInsertAll() - allocation failure");
+
+    // A large batch rebuilds the heap, past its capacity
+    CU_ASSERT_TRUE( heap_insertAll(heap, (void **)array, 0L) == OK );
+    CU_ASSERT_TRUE( heap_insert(heap, array[0]) == OK );
+    CU_ASSERT_TRUE( heap_insertAll(heap, (void **)&(array[1]), LEN - 1) == OK );
+    CU_ASSERT_TRUE( heap_size(heap) == LEN );
+    for (i = 0; i < LEN; i++) {
+        CU_ASSERT_TRUE( heap_poll(heap, (void **)&item) == OK );
+        CU_ASSERT_TRUE( strcmp(item, orderedArray[i]) == 0 );
+    }
+
+    // A small batch is sifted into the existing heap
+    CU_ASSERT_TRUE( heap_insertAll(heap, (void **)&(array[1]), LEN - 1) == OK );
+    CU_ASSERT_TRUE( heap_insertAll(heap, (void **)array, 1L) == OK );
+    CU_ASSERT_TRUE( heap_size(heap) == LEN );
+    for (i = 0; i < LEN; i++) {
+        CU_ASSERT_TRUE( heap_poll(heap, (void **)&item) == OK );
+        CU_ASSERT_TRUE( strcmp(item, orderedArray[i]) == 0 );
+    }
+    validateEmptyHeap(heap);
+    heap_destroy(heap, NULL);
+
+    CU_PASS("testHeapInsertAll() - Test Passed");
+}
+
+static void testHeapArity() {
+
+    Heap *heap;
+    Status stat;
+    long arities[] = {0L, 3L, 4L, 8L};
+    int i, j;
+    char *item;
+
+    for (j = 0; j < 4; j++) {
+        stat = heap_newWithArity(&heap, CAPACITY, arities[j], heapCmp);
+        if (stat != OK)
+            CU_FAIL_FATAL("ERROR: testHeapArity() - allocation failure");
+
+        validateEmptyHeap(heap);
+        for (i = 0; i < LEN; i++)
+            CU_ASSERT_TRUE( heap_insert(heap, array[i]) == OK );
+        CU_ASSERT_TRUE( heap_peek(heap, (void **)&item) == OK );
+        CU_ASSERT_TRUE( strcmp(item, orderedArray[0]) == 0 );
+        for (i = 0; i < LEN; i++) {
+            CU_ASSERT_TRUE( heap_poll(heap, (void **)&item) == OK );
+            CU_ASSERT_TRUE( strcmp(item, orderedArray[i]) == 0 );
+        }
+
+        // Batches are heapified using the same arity
+        CU_ASSERT_TRUE( heap_insertAll(heap, (void **)array, LEN) == OK );
+        for (i = 0; i < LEN; i++) {
+            CU_ASSERT_TRUE( heap_poll(heap, (void **)&item) == OK );
+            CU_ASSERT_TRUE( strcmp(item, orderedArray[i]) == 0 );
+        }
+        validateEmptyHeap(heap);
+        heap_destroy(heap, NULL);
+    }
+
+    CU_PASS("testHeapArity() - Test Passed");
+}
+
+static void testHeapGrowthFactor() {
+
+    Heap *heap;
+    Status stat;
+    int i, j;
+    char *item;
+
+    stat = heap_new(&heap, CAPACITY, heapCmp);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testHeapGrowthFactor() - allocation failure");
+
+    // Growing one slot at a time still keeps every element in order
+    heap_setGrowthFactor(heap, 0.01f);
+    for (j = 0; j < 3; j++) {
+        for (i = 0; i < LEN; i++)
+            CU_ASSERT_TRUE( heap_insert(heap, array[i]) == OK );
+    }
+    CU_ASSERT_TRUE( heap_insertAll(heap, (void **)array, LEN) == OK );
+    CU_ASSERT_TRUE( heap_size(heap) == 4L * LEN );
+    for (i = 0; i < LEN; i++) {
+        for (j = 0; j < 4; j++) {
+            CU_ASSERT_TRUE( heap_poll(heap, (void **)&item) == OK );
+            CU_ASSERT_TRUE( strcmp(item, orderedArray[i]) == 0 );
+        }
+    }
+    validateEmptyHeap(heap);
+    heap_destroy(heap, NULL);
+
+    CU_PASS("testHeapGrowthFactor() - Test Passed");
+}
+
+static void testHeapHandles() {
+
+    Heap *heap;
+    HeapHandle handles[LEN];
+    char *expected[] = {"A", "Test", "blue", "gray", "orange", "purple", "white", "yellow", "z"};
+    Status stat;
+    int i;
+    char *item;
+
+    stat = heap_new(&heap, CAPACITY, heapCmp);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testHeapHandles() - allocation failure");
+
+    CU_ASSERT_TRUE( heap_update(heap, 0L, singleItem) == NOT_FOUND );
+    CU_ASSERT_TRUE( heap_removeHandle(heap, 0L, (void **)&item) == NOT_FOUND );
+    for (i = 0; i < LEN; i++)
+        CU_ASSERT_TRUE( heap_insertHandle(heap, array[i], &(handles[i])) == OK );
+    CU_ASSERT_TRUE( heap_insert(heap, singleItem) == OK );
+
+    // Moves "red" to the top, and "black" to the bottom
+    CU_ASSERT_TRUE( heap_update(heap, handles[0], "A") == OK );
+    CU_ASSERT_TRUE( heap_peek(heap, (void **)&item) == OK );
+    CU_ASSERT_TRUE( strcmp(item, "A") == 0 );
+    CU_ASSERT_TRUE( heap_update(heap, handles[LEN - 1], "z") == OK );
+
+    // Removes "green" from the middle of the heap
+    CU_ASSERT_TRUE( heap_removeHandle(heap, handles[3], (void **)&item) == OK );
+    CU_ASSERT_TRUE( item == array[3] );
+    CU_ASSERT_TRUE( heap_removeHandle(heap, handles[3], (void **)&item) == NOT_FOUND );
+    CU_ASSERT_TRUE( heap_size(heap) == LEN );
+
+    // The rest come out in order, with the untracked element among them
+    for (i = 0; i < LEN; i++) {
+        CU_ASSERT_TRUE( heap_poll(heap, (void **)&item) == OK );
+        CU_ASSERT_TRUE( strcmp(item, expected[i]) == 0 );
+    }
+    CU_ASSERT_TRUE( heap_update(heap, handles[0], singleItem) == NOT_FOUND );
+    validateEmptyHeap(heap);
+    heap_destroy(heap, NULL);
+
+    CU_PASS("testHeapHandles() - Test Passed");
+}
+
+static void testHeapMerge() {
+
+    Heap *dst, *src;
+    HeapHandle handle, released;
+    char *rest[] = {"black", "blue", "gray", "green", "orange", "purple", "white", "yellow"};
+    Status stat;
+    int i;
+    char *item;
+
+    stat = heap_new(&dst, CAPACITY, heapCmp);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testHeapMerge() - allocation failure");
+    stat = heap_newWithArity(&src, CAPACITY, 4L, heapCmp);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testHeapMerge() - allocation failure");
+
+    // Merging an empty heap, or a heap into itself, changes nothing
+    CU_ASSERT_TRUE( heap_merge(dst, src) == OK );
+    CU_ASSERT_TRUE( heap_insert(dst, array[0]) == OK );
+    CU_ASSERT_TRUE( heap_merge(dst, dst) == OK );
+    CU_ASSERT_TRUE( heap_size(dst) == 1L );
+
+    // A larger heap is moved over whole, emptying it
+    for (i = 1; i < LEN; i++)
+        CU_ASSERT_TRUE( heap_insert(src, array[i]) == OK );
+    CU_ASSERT_TRUE( heap_merge(dst, src) == OK );
+    validateEmptyHeap(src);
+    CU_ASSERT_TRUE( heap_size(dst) == LEN );
+    for (i = 0; i < LEN; i++) {
+        CU_ASSERT_TRUE( heap_poll(dst, (void **)&item) == OK );
+        CU_ASSERT_TRUE( strcmp(item, orderedArray[i]) == 0 );
+    }
+
+    // Handles into the destination survive the merge, those into the source are released
+    CU_ASSERT_TRUE( heap_insertHandle(dst, array[0], &handle) == OK );
+    for (i = 1; i < LEN; i++)
+        CU_ASSERT_TRUE( heap_insert(dst, array[i]) == OK );
+    CU_ASSERT_TRUE( heap_insertHandle(src, singleItem, &released) == OK );
+    CU_ASSERT_TRUE( heap_merge(dst, src) == OK );
+    CU_ASSERT_TRUE( heap_removeHandle(src, released, (void **)&item) == NOT_FOUND );
+    CU_ASSERT_TRUE( heap_update(dst, handle, "A") == OK );
+    CU_ASSERT_TRUE( heap_poll(dst, (void **)&item) == OK );
+    CU_ASSERT_TRUE( strcmp(item, "A") == 0 );
+    CU_ASSERT_TRUE( heap_poll(dst, (void **)&item) == OK );
+    CU_ASSERT_TRUE( item == singleItem );
+    for (i = 0; i < LEN - 1; i++) {
+        CU_ASSERT_TRUE( heap_poll(dst, (void **)&item) == OK );
+        CU_ASSERT_TRUE( strcmp(item, rest[i]) == 0 );
+    }
+    validateEmptyHeap(dst);
+    heap_destroy(dst, NULL);
+    heap_destroy(src, NULL);
+
+    CU_PASS("testHeapMerge() - Test Passed");
+}
+
 #define UNUSED __attribute__((unused))
 int main(UNUSED int argc, UNUSED char **argv) {
 
@@ -232,6 +504,13 @@ int main(UNUSED int argc, UNUSED char **argv) {
     CU_add_test(suite, "Heap - Ordered Set", testOrderedSet);
     CU_add_test(suite, "Heap - Array", testHeapToArray);
     CU_add_test(suite, "Heap - Iterator", testHeapIterator);
+    CU_add_test(suite, "Heap - Cursor", testHeapCursor);
+    CU_add_test(suite, "Heap - From Array", testHeapFromArray);
+    CU_add_test(suite, "Heap - Insert All", testHeapInsertAll);
+    CU_add_test(suite, "Heap - Arity", testHeapArity);
+    CU_add_test(suite, "Heap - Growth Factor", testHeapGrowthFactor);
+    CU_add_test(suite, "Heap - Handles", testHeapHandles);
+    CU_add_test(suite, "Heap - Merge", testHeapMerge);
     CU_add_test(suite, "Heap - Clear", testHeapClear);
 
     CU_basic_set_mode(CU_BRM_VERBOSE);
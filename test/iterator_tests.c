@@ -24,6 +24,7 @@
 
 #include <stdlib.h>
 #include <CUnit/Basic.h>
+#include "array_list.h"
 #include "iterator.h"
 
 /* Collection of items used for testing */
@@ -84,6 +85,187 @@ void testIteration() {
     CU_PASS("testIteration() - Test Passed");
 }
 
+void testSplit() {
+
+    Iterator *iter, *prefix, *inner;
+    Status stat;
+    char *item, **items;
+    int i;
+
+    items = (char **)malloc(sizeof(char *) * 6);
+    if (items == NULL)
+        CU_FAIL_FATAL("ERROR: testSplit() - allocation failure");
+    for (i = 0; i < LEN; i++)
+        items[i] = array[i];
+
+    stat = iterator_new(&iter, (void **)items, 6L);
+    if (stat != OK) {
+        free(items);
+        CU_FAIL_FATAL("ERROR: testSplit() - allocation failure");
+    }
+
+    // The first half goes to the new iterator, the second stays behind
+    CU_ASSERT_TRUE( iterator_next(iter, (void **)&item) == OK );
+    CU_ASSERT_TRUE( iterator_trySplit(iter, &prefix) == OK );
+    CU_ASSERT_EQUAL( iterator_remaining(prefix), 2L );
+    CU_ASSERT_EQUAL( iterator_remaining(iter), 3L );
+    CU_ASSERT_TRUE( iterator_trySplit(iter, &inner) == OK );
+    CU_ASSERT_EQUAL( iterator_remaining(inner), 1L );
+    CU_ASSERT_TRUE( iterator_trySplit(inner, &prefix) == ITER_END );
+
+    for (i = 1; i < 3; i++) {
+        CU_ASSERT_TRUE( iterator_next(prefix, (void **)&item) == OK );
+        CU_ASSERT_TRUE( item == array[i] );
+    }
+    CU_ASSERT_TRUE( iterator_next(prefix, (void **)&item) == ITER_END );
+    CU_ASSERT_TRUE( iterator_next(inner, (void **)&item) == OK );
+    CU_ASSERT_TRUE( item == array[3] );
+    for (i = 4; i < LEN; i++) {
+        CU_ASSERT_TRUE( iterator_next(iter, (void **)&item) == OK );
+        CU_ASSERT_TRUE( item == array[i] );
+    }
+    CU_ASSERT_TRUE( iterator_hasNext(iter) == FALSE );
+
+    // The items are only freed with the last of the three
+    iterator_destroy(iter);
+    iterator_destroy(prefix);
+    iterator_destroy(inner);
+
+    CU_PASS("testSplit() - Test Passed");
+}
+
+/* Keeps the words of five letters or more, counting the calls in `context` */
+static Boolean isLong(void *item, void *context) {
+
+    (*(long *)context)++;
+    return ( strlen((char *)item) >= 5 ) ? TRUE : FALSE;
+}
+
+/* Maps a word to its first letter */
+static void *firstLetter(void *item, void *context) {
+
+    (void)context;
+    return (void *)(long)((char *)item)[0];
+}
+
+/**
+ * Creates a snapshot iterator over a copy of the test items.
+ */
+static Iterator *newSnapshot() {
+
+    Iterator *iter;
+    char **items = (char **)malloc(sizeof(char *) * LEN);
+    int i;
+
+    if (items == NULL)
+        CU_FAIL_FATAL("ERROR: newSnapshot() - allocation failure");
+    for (i = 0; i < LEN; i++)
+        items[i] = array[i];
+    if (iterator_new(&iter, (void **)items, LEN) != OK)
+        CU_FAIL_FATAL("ERROR: newSnapshot() - allocation failure");
+
+    return iter;
+}
+
+void testAdaptors() {
+
+    Iterator *iter, *filtered, *limited, *mapped, *prefix;
+    char *expected[] = {"orange", "yellow", "green", "red", "orange"};
+    long calls = 0L;
+    char *item;
+    int i;
+
+    // The first 3 long words, then every word again
+    CU_ASSERT_TRUE( iterator_filter(&filtered, newSnapshot(), isLong, &calls) == OK );
+    CU_ASSERT_TRUE( iterator_limit(&limited, filtered, -1L) == INVALID_INDEX );
+    CU_ASSERT_TRUE( iterator_limit(&limited, filtered, 3L) == OK );
+    CU_ASSERT_TRUE( iterator_concat(&iter, limited, newSnapshot()) == OK );
+    CU_ASSERT_EQUAL( iterator_remaining(iter), 3L + LEN );
+    CU_ASSERT_TRUE( iterator_trySplit(iter, &prefix) == ITER_END );
+
+    // Asking twice fetches ahead only once
+    CU_ASSERT_TRUE( iterator_hasNext(iter) == TRUE );
+    CU_ASSERT_TRUE( iterator_hasNext(iter) == TRUE );
+    CU_ASSERT_EQUAL( calls, 2L );
+    for (i = 0; i < 5; i++) {
+        CU_ASSERT_TRUE( iterator_next(iter, (void **)&item) == OK );
+        CU_ASSERT_TRUE( strcmp(item, expected[i]) == 0 );
+    }
+
+    // The filter is never asked past the limit
+    CU_ASSERT_EQUAL( calls, 4L );
+    CU_ASSERT_EQUAL( iterator_remaining(iter), LEN - 2L );
+
+    // Maps the rest to their first letters
+    CU_ASSERT_TRUE( iterator_map(&mapped, iter, firstLetter, NULL) == OK );
+    for (i = 2; i < LEN; i++) {
+        CU_ASSERT_TRUE( iterator_hasNext(mapped) == TRUE );
+        CU_ASSERT_TRUE( iterator_next(mapped, (void **)&item) == OK );
+        CU_ASSERT_EQUAL( (long)item, (long)array[i][0] );
+    }
+    CU_ASSERT_TRUE( iterator_hasNext(mapped) == FALSE );
+    CU_ASSERT_TRUE( iterator_next(mapped, (void **)&item) == ITER_END );
+    CU_ASSERT_EQUAL( iterator_remaining(mapped), 0L );
+    iterator_destroy(mapped);
+
+    // An empty limit takes nothing from its source
+    CU_ASSERT_TRUE( iterator_limit(&iter, newSnapshot(), 0L) == OK );
+    CU_ASSERT_TRUE( iterator_hasNext(iter) == FALSE );
+    CU_ASSERT_EQUAL( iterator_remaining(iter), 0L );
+    iterator_destroy(iter);
+
+    CU_PASS("testAdaptors() - Test Passed");
+}
+
+/* Keeps the even numbers, counting the calls in `context` */
+static Boolean isEven(void *item, void *context) {
+
+    (*(long *)context)++;
+    return ( (long)item % 2L == 0L ) ? TRUE : FALSE;
+}
+
+void testCursorIterator() {
+
+    ArrayList *list;
+    Cursor cursor;
+    Iterator *iter, *evens, *top;
+    long i, calls = 0L;
+    void *item;
+
+    if (arraylist_new(&list, 0L) != OK)
+        CU_FAIL_FATAL("ERROR: testCursorIterator() - allocation failure");
+    for (i = 0L; i < 1000L; i++)
+        CU_ASSERT_TRUE( arraylist_add(list, (void *)i) == OK );
+
+    // The first 5 even numbers only visit the first 9 elements of the list
+    arraylist_cursor(list, &cursor);
+    CU_ASSERT_TRUE( iterator_fromCursor(&iter, &cursor, arraylist_cursorNext) == OK );
+    CU_ASSERT_EQUAL( iterator_remaining(iter), 1000L );
+    CU_ASSERT_TRUE( iterator_filter(&evens, iter, isEven, &calls) == OK );
+    CU_ASSERT_TRUE( iterator_limit(&top, evens, 5L) == OK );
+    for (i = 0L; i < 5L; i++) {
+        CU_ASSERT_TRUE( iterator_next(top, &item) == OK );
+        CU_ASSERT_EQUAL( (long)item, 2L * i );
+    }
+    CU_ASSERT_TRUE( iterator_next(top, &item) == ITER_END );
+    CU_ASSERT_EQUAL( calls, 9L );
+    CU_ASSERT_EQUAL( iterator_remaining(iter), 991L );
+    iterator_destroy(top);
+
+    // Fails fast once the list is modified
+    arraylist_cursor(list, &cursor);
+    CU_ASSERT_TRUE( iterator_fromCursor(&iter, &cursor, arraylist_cursorNext) == OK );
+    CU_ASSERT_TRUE( iterator_next(iter, &item) == OK );
+    CU_ASSERT_TRUE( arraylist_add(list, NULL) == OK );
+    CU_ASSERT_TRUE( iterator_hasNext(iter) == FALSE );
+    CU_ASSERT_TRUE( iterator_next(iter, &item) == CONCURRENT_MODIFICATION );
+    CU_ASSERT_TRUE( iterator_next(iter, &item) == CONCURRENT_MODIFICATION );
+    iterator_destroy(iter);
+    arraylist_destroy(list, NULL);
+
+    CU_PASS("testCursorIterator() - Test Passed");
+}
+
 #define UNUSED __attribute__((unused))
 int main(UNUSED int argc, UNUSED char **argv) {
 
@@ -99,6 +281,9 @@ int main(UNUSED int argc, UNUSED char **argv) {
 
     CU_add_test(suite, "Iterator - Empty", testEmptyIterator);
     CU_add_test(suite, "Iterator - Full Set", testIteration);
+    CU_add_test(suite, "Iterator - Split", testSplit);
+    CU_add_test(suite, "Iterator - Lazy Adaptors", testAdaptors);
+    CU_add_test(suite, "Iterator - Cursor", testCursorIterator);
 
     CU_basic_set_mode(CU_BRM_VERBOSE);
     CU_basic_run_tests();
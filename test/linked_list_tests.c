@@ -368,6 +368,332 @@ static void testLinkedListClear() {
     CU_PASS("testLinkedListClear() - Test Passed");
 }
 
+static void testLinkedListCursor() {
+
+    Iterator *iter;
+    Cursor cursor;
+    LinkedList *list;
+    Status stat;
+    int i;
+    char *item, *other;
+
+    stat = linkedlist_new(&list);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testLinkedListCursor() - allocation failure");
+
+    linkedlist_cursor(list, &cursor);
+    CU_ASSERT_TRUE( cursor_hasNext(&cursor) == FALSE );
+    CU_ASSERT_TRUE( linkedlist_cursorNext(&cursor, (void **)&item) == ITER_END );
+
+    for (i = 0; i < LEN; i++)
+        CU_ASSERT_TRUE( linkedlist_addLast(list, array[i]) == OK );
+    CU_ASSERT_TRUE( linkedlist_iterator(list, &iter) == OK );
+
+    // The cursor must visit the same items in the same order as the iterator
+    i = 0;
+    linkedlist_cursor(list, &cursor);
+    while (cursor_hasNext(&cursor) == TRUE) {
+        CU_ASSERT_TRUE( linkedlist_cursorNext(&cursor, (void **)&item) == OK );
+        CU_ASSERT_TRUE( iterator_next(iter, (void **)&other) == OK );
+        CU_ASSERT_TRUE( item == other );
+        i++;
+    }
+    CU_ASSERT_EQUAL( i, LEN );
+    CU_ASSERT_TRUE( linkedlist_cursorNext(&cursor, (void **)&item) == ITER_END );
+    iterator_destroy(iter);
+
+    // A structural change invalidates any cursor already in progress
+    linkedlist_cursor(list, &cursor);
+    CU_ASSERT_TRUE( linkedlist_cursorNext(&cursor, (void **)&item) == OK );
+    CU_ASSERT_TRUE( linkedlist_removeFirst(list, (void **)&item) == OK );
+    CU_ASSERT_TRUE( linkedlist_cursorNext(&cursor, (void **)&item) == CONCURRENT_MODIFICATION );
+    linkedlist_destroy(list, NULL);
+
+    CU_PASS("testLinkedListCursor() - Test Passed");
+}
+
+#define UNROLLED_LEN 2000L
+
+/**
+ * Checks that the list holds exactly the `n` values in `model`, through every way of reading it.
+ */
+static void validateUnrolled(LinkedList *list, long *model, long n) {
+
+    Array *arr;
+    Cursor cursor;
+    void *item;
+    long i;
+
+    CU_ASSERT_EQUAL( linkedlist_size(list), n );
+    for (i = 0L; i < n; i++) {
+        CU_ASSERT_TRUE( linkedlist_get(list, i, &item) == OK );
+        CU_ASSERT_EQUAL( (long)item, model[i] );
+    }
+    CU_ASSERT_TRUE( linkedlist_toArray(list, &arr) == OK );
+    for (i = 0L; i < n; i++)
+        CU_ASSERT_EQUAL( (long)arr->items[i], model[i] );
+    FREE_ARRAY(arr);
+    i = 0L;
+    linkedlist_cursor(list, &cursor);
+    while (linkedlist_cursorNext(&cursor, &item) == OK)
+        CU_ASSERT_EQUAL( (long)item, model[i++] );
+    CU_ASSERT_EQUAL( i, n );
+}
+
+static void testUnrolledLinkedList() {
+
+    LinkedList *list;
+    long model[UNROLLED_LEN + 1L], i, j, n = 0L;
+    void *item;
+
+    Status stat = linkedlist_newUnrolled(&list);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testUnrolledLinkedList() - allocation failure");
+    validateEmptyLinkedList(list);
+
+    // Grows the list from both ends and the middle, splitting many chunks along the way
+    for (i = 1L; i <= UNROLLED_LEN; i++) {
+        if (i % 3L == 0L) {
+            CU_ASSERT_TRUE( linkedlist_addFirst(list, (void *)i) == OK );
+            for (j = n; j > 0L; j--)
+                model[j] = model[j - 1L];
+            model[0] = i;
+        } else if (i % 3L == 1L || n == 0L) {
+            CU_ASSERT_TRUE( linkedlist_addLast(list, (void *)i) == OK );
+            model[n] = i;
+        } else {
+            CU_ASSERT_TRUE( linkedlist_insert(list, n / 2L, (void *)i) == OK );
+            for (j = n; j > n / 2L; j--)
+                model[j] = model[j - 1L];
+            model[n / 2L] = i;
+        }
+        n++;
+    }
+    validateUnrolled(list, model, n);
+    CU_ASSERT_TRUE( linkedlist_set(list, n / 3L, (void *)-1L, &item) == OK );
+    CU_ASSERT_EQUAL( (long)item, model[n / 3L] );
+    model[n / 3L] = -1L;
+
+    // Shrinks it again from both ends and the middle, merging the sparse chunks
+    while (n > UNROLLED_LEN / 4L) {
+        j = ( n % 3L == 0L ) ? 0L : ( n % 3L == 1L ) ? n - 1L : (n * 2L) / 3L;
+        CU_ASSERT_TRUE( linkedlist_remove(list, j, &item) == OK );
+        CU_ASSERT_EQUAL( (long)item, model[j] );
+        for (n--; j < n; j++)
+            model[j] = model[j + 1L];
+    }
+    validateUnrolled(list, model, n);
+    CU_ASSERT_TRUE( linkedlist_first(list, &item) == OK );
+    CU_ASSERT_EQUAL( (long)item, model[0] );
+    CU_ASSERT_TRUE( linkedlist_last(list, &item) == OK );
+    CU_ASSERT_EQUAL( (long)item, model[n - 1L] );
+    CU_ASSERT_TRUE( linkedlist_get(list, n, &item) == INVALID_INDEX );
+
+    linkedlist_clear(list, NULL);
+    validateEmptyLinkedList(list);
+    for (i = 0L; i < LEN; i++)
+        CU_ASSERT_TRUE( linkedlist_addLast(list, array[i]) == OK );
+    linkedlist_destroy(list, NULL);
+
+    CU_PASS("testUnrolledLinkedList() - Test Passed");
+}
+
+/* Visitor adding each item it is passed to the sum in `context`, stopping once it exceeds 100 */
+static Boolean sumItems(void *item, void *context) {
+    *(long *)context += *(long *)item;
+    return ( *(long *)context <= 100L ) ? TRUE : FALSE;
+}
+
+static void testLinkedListForEach() {
+
+    LinkedList *list;
+    Status stat;
+    long i, sum, items[UNROLLED_LEN];
+
+    // Walks both the plain and the unrolled layouts
+    for (i = 0L; i < UNROLLED_LEN; i++)
+        items[i] = 1L;
+    stat = linkedlist_new(&list);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testLinkedListForEach() - allocation failure");
+    for (i = 0L; i < 50L; i++)
+        CU_ASSERT_TRUE( linkedlist_addLast(list, &items[i]) == OK );
+    sum = 0L;
+    CU_ASSERT_TRUE( linkedlist_forEach(list, sumItems, &sum) == TRUE );
+    CU_ASSERT_EQUAL( sum, 50L );
+    for (i = 50L; i < UNROLLED_LEN; i++)
+        CU_ASSERT_TRUE( linkedlist_addLast(list, &items[i]) == OK );
+    sum = 0L;
+    CU_ASSERT_TRUE( linkedlist_forEach(list, sumItems, &sum) == FALSE );
+    CU_ASSERT_EQUAL( sum, 101L );
+    linkedlist_destroy(list, NULL);
+
+    stat = linkedlist_newUnrolled(&list);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testLinkedListForEach() - allocation failure");
+    for (i = 0L; i < 50L; i++)
+        CU_ASSERT_TRUE( linkedlist_addFirst(list, &items[i]) == OK );
+    sum = 0L;
+    CU_ASSERT_TRUE( linkedlist_forEach(list, sumItems, &sum) == TRUE );
+    CU_ASSERT_EQUAL( sum, 50L );
+    for (i = 50L; i < UNROLLED_LEN; i++)
+        CU_ASSERT_TRUE( linkedlist_addLast(list, &items[i]) == OK );
+    sum = 0L;
+    CU_ASSERT_TRUE( linkedlist_forEach(list, sumItems, &sum) == FALSE );
+    CU_ASSERT_EQUAL( sum, 101L );
+    linkedlist_destroy(list, NULL);
+
+    CU_PASS("testLinkedListForEach() - Test Passed");
+}
+
+static void testLinkedListMemoryUsage() {
+
+    LinkedList *list;
+    Status stat;
+    long i, empty, items[UNROLLED_LEN];
+    int unrolled;
+
+    for (unrolled = 0; unrolled < 2; unrolled++) {
+        stat = ( unrolled == 0 ) ? linkedlist_new(&list) : linkedlist_newUnrolled(&list);
+        if (stat != OK)
+            CU_FAIL_FATAL("ERROR: testLinkedListMemoryUsage() - allocation failure");
+
+        empty = linkedlist_memoryUsage(list);
+        CU_ASSERT_TRUE( empty > 0L );
+        for (i = 0L; i < UNROLLED_LEN; i++)
+            CU_ASSERT_TRUE( linkedlist_addLast(list, &items[i]) == OK );
+        CU_ASSERT_TRUE( linkedlist_memoryUsage(list) > empty );
+        linkedlist_destroy(list, NULL);
+    }
+
+    CU_PASS("testLinkedListMemoryUsage() - Test Passed");
+}
+
+/* Checks that `list` holds exactly the elements `expected` of `array`, in order */
+static void validateOrder(LinkedList *list, const int *expected, long len) {
+
+    Array *arr;
+    long i;
+
+    CU_ASSERT_TRUE( linkedlist_size(list) == len );
+    if (linkedlist_toArray(list, &arr) != OK)
+        return;
+    for (i = 0L; i < len && i < arr->len; i++)
+        CU_ASSERT_TRUE( arr->items[i] == array[expected[i]] );
+    FREE_ARRAY(arr)
+}
+
+static void testLinkedListHandles() {
+
+    LinkedList *list;
+    ListLink *handles[LEN], *link;
+    Status stat;
+    char *item;
+    int i;
+
+    stat = linkedlist_new(&list);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testLinkedListHandles() - allocation failure");
+
+    for (i = 0; i < 4; i++)
+        CU_ASSERT_TRUE( linkedlist_addLastHandle(list, array[i], &handles[i]) == OK );
+    CU_ASSERT_TRUE( linkedlist_addFirstHandle(list, array[4], &handles[4]) == OK );
+    CU_ASSERT_TRUE( linkedlist_insertAfter(list, handles[1], array[5], &handles[5]) == OK );
+    CU_ASSERT_TRUE( handles[5]->data == array[5] );
+    validateOrder(list, (int []){4, 0, 1, 5, 2, 3}, 6L);
+
+    linkedlist_moveToFront(list, handles[3]);
+    linkedlist_moveToBack(list, handles[4]);
+    linkedlist_moveToFront(list, handles[3]);
+    validateOrder(list, (int []){3, 0, 1, 5, 2, 4}, 6L);
+
+    CU_ASSERT_TRUE( linkedlist_removeHandle(list, handles[5]) == array[5] );
+    CU_ASSERT_TRUE( linkedlist_removeHandle(list, handles[3]) == array[3] );
+    CU_ASSERT_TRUE( linkedlist_removeHandle(list, handles[4]) == array[4] );
+    validateOrder(list, (int []){0, 1, 2}, 3L);
+    CU_ASSERT_TRUE( linkedlist_first(list, (void **)&item) == OK && item == array[0] );
+    CU_ASSERT_TRUE( linkedlist_last(list, (void **)&item) == OK && item == array[2] );
+
+    // Walks the handles in both directions
+    i = 0;
+    link = linkedlist_firstHandle(list);
+    for (; link != NULL; link = linkedlist_nextHandle(list, link))
+        CU_ASSERT_TRUE( link->data == array[i++] );
+    CU_ASSERT_TRUE( i == 3 );
+    for (link = linkedlist_lastHandle(list); link != NULL; link = linkedlist_prevHandle(list, link))
+        CU_ASSERT_TRUE( link->data == array[--i] );
+    CU_ASSERT_TRUE( i == 0 );
+
+    // Indexed operations still see the handle-inserted elements
+    CU_ASSERT_TRUE( linkedlist_remove(list, 1L, (void **)&item) == OK && item == array[1] );
+    CU_ASSERT_TRUE( linkedlist_removeHandle(list, handles[0]) == array[0] );
+    CU_ASSERT_TRUE( linkedlist_removeHandle(list, handles[2]) == array[2] );
+    validateEmptyLinkedList(list);
+    CU_ASSERT_TRUE( linkedlist_firstHandle(list) == NULL );
+    CU_ASSERT_TRUE( linkedlist_lastHandle(list) == NULL );
+
+    linkedlist_destroy(list, NULL);
+
+    CU_PASS("testLinkedListHandles() - Test Passed");
+}
+
+/* A caller's struct with the list link embedded */
+typedef struct {
+    ListLink link;
+    int index;
+} Element;
+
+static int released;
+
+static void releaseElement(void *element) {
+    released += ((Element *)element)->index;
+}
+
+static void testLinkedListIntrusive() {
+
+    LinkedList *list;
+    Element elements[LEN];
+    Status stat;
+    char *item;
+    long empty;
+    int i;
+
+    stat = linkedlist_newIntrusive(&list);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testLinkedListIntrusive() - allocation failure");
+    empty = linkedlist_memoryUsage(list);
+
+    for (i = 0; i < LEN; i++)
+        elements[i].index = i;
+    linkedlist_linkLast(list, &elements[1].link, array[1]);
+    linkedlist_linkFirst(list, &elements[0].link, array[0]);
+    linkedlist_linkLast(list, &elements[3].link, array[3]);
+    linkedlist_linkAfter(list, &elements[1].link, &elements[2].link, array[2]);
+    validateOrder(list, (int []){0, 1, 2, 3}, 4L);
+
+    // Removing unlinks the caller's link, which may be linked in again
+    CU_ASSERT_TRUE( linkedlist_removeHandle(list, &elements[1].link) == array[1] );
+    CU_ASSERT_TRUE( linkedlist_removeFirst(list, (void **)&item) == OK && item == array[0] );
+    linkedlist_linkLast(list, &elements[1].link, array[1]);
+    linkedlist_moveToFront(list, &elements[3].link);
+    validateOrder(list, (int []){3, 2, 1}, 3L);
+    // The links belong to the caller, the list allocates nothing per element
+    CU_ASSERT_TRUE( linkedlist_memoryUsage(list) == empty );
+
+    // Points each link at its own struct, so the destructor can release the elements
+    released = 0;
+    for (i = 1; i <= 3; i++)
+        elements[i].link.data = &elements[i];
+    linkedlist_clear(list, releaseElement);
+    CU_ASSERT_TRUE( released == 6 );
+    validateEmptyLinkedList(list);
+
+    linkedlist_linkLast(list, &elements[4].link, array[4]);
+    linkedlist_destroy(list, NULL);
+
+    CU_PASS("testLinkedListIntrusive() - Test Passed");
+}
+
 #define UNUSED __attribute__((unused))
 int main(UNUSED int argc, UNUSED char **argv) {
 
@@ -392,7 +718,13 @@ int main(UNUSED int argc, UNUSED char **argv) {
     CU_add_test(suite, "LinkedList - Random Delete", testRandomDelete);
     CU_add_test(suite, "LinkedList - Array", testLinkedListToArray);
     CU_add_test(suite, "LinkedList - Iterator", testLinkedListIterator);
+    CU_add_test(suite, "LinkedList - Cursor", testLinkedListCursor);
     CU_add_test(suite, "LinkedList - Clear", testLinkedListClear);
+    CU_add_test(suite, "LinkedList - Unrolled", testUnrolledLinkedList);
+    CU_add_test(suite, "LinkedList - For Each", testLinkedListForEach);
+    CU_add_test(suite, "LinkedList - Memory Usage", testLinkedListMemoryUsage);
+    CU_add_test(suite, "LinkedList - Handles", testLinkedListHandles);
+    CU_add_test(suite, "LinkedList - Intrusive", testLinkedListIntrusive);
 
     CU_basic_set_mode(CU_BRM_VERBOSE);
     CU_basic_run_tests();
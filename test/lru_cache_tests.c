@@ -0,0 +1,276 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2020 Cole Vikupitz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <CUnit/Basic.h>
+#include "hashing.h"
+#include "lru_cache.h"
+#include "ts_lru_cache.h"
+
+/* Sizes used for testing */
+#define CAPACITY 1000L
+#define THREADS 8L
+#define OPS_PER_THREAD 100000L
+
+/* Keys and values are stored directly in the pointers */
+#define E(x) ((void *)(long)(x))
+
+/* Records the entries passed to the eviction listener */
+static long evictedCount;
+static long evictedSum;
+
+static void recordEviction(void *key, void *value, void *context) {
+    CU_ASSERT_TRUE( (long)key == (long)value );
+    CU_ASSERT_TRUE( context == (void *)&evictedCount );
+    evictedCount++;
+    evictedSum += (long)key;
+}
+
+static void testLeastRecentlyUsed() {
+
+    LruCache *cache;
+    void *value;
+    long i;
+
+    Status stat = lrucache_new(&cache, hashing_pointer, hashing_comparePointer, CAPACITY, NULL);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testLeastRecentlyUsed() - allocation failure");
+    evictedCount = evictedSum = 0L;
+    lrucache_setEvictionListener(cache, recordEviction, &evictedCount);
+
+    for (i = 0L; i < CAPACITY; i++)
+        CU_ASSERT_TRUE( lrucache_put(cache, E(i), E(i), 1L, &value) == INSERTED );
+    CU_ASSERT_TRUE( lrucache_size(cache) == CAPACITY );
+    CU_ASSERT_TRUE( evictedCount == 0L );
+
+    // Requesting the first half makes the second half the least recently used
+    for (i = 0L; i < CAPACITY / 2L; i++) {
+        CU_ASSERT_TRUE( lrucache_get(cache, E(i), &value) == OK );
+        CU_ASSERT_TRUE( value == E(i) );
+    }
+    // Peeking does not, so the keys peeked at are still evicted first
+    for (i = CAPACITY / 2L; i < CAPACITY; i++)
+        CU_ASSERT_TRUE( lrucache_peek(cache, E(i), &value) == OK );
+    for (i = CAPACITY; i < CAPACITY + CAPACITY / 2L; i++)
+        CU_ASSERT_TRUE( lrucache_put(cache, E(i), E(i), 1L, &value) == INSERTED );
+
+    CU_ASSERT_TRUE( lrucache_size(cache) == CAPACITY );
+    CU_ASSERT_TRUE( evictedCount == CAPACITY / 2L );
+    for (i = 0L; i < CAPACITY + CAPACITY / 2L; i++) {
+        Boolean expected = ( i < CAPACITY / 2L || i >= CAPACITY ) ? TRUE : FALSE;
+        CU_ASSERT_TRUE( lrucache_containsKey(cache, E(i)) == expected );
+    }
+    CU_ASSERT_TRUE( lrucache_get(cache, E(CAPACITY - 1L), &value) == NOT_FOUND );
+
+    // Replacing a key keeps a single entry, removing it evicts nothing
+    CU_ASSERT_TRUE( lrucache_put(cache, E(0), E(7), 1L, &value) == REPLACED );
+    CU_ASSERT_TRUE( value == E(0) );
+    CU_ASSERT_TRUE( lrucache_remove(cache, E(0), &value) == OK );
+    CU_ASSERT_TRUE( value == E(7) );
+    CU_ASSERT_TRUE( lrucache_remove(cache, E(0), &value) == NOT_FOUND );
+    CU_ASSERT_TRUE( lrucache_size(cache) == CAPACITY - 1L );
+    CU_ASSERT_TRUE( evictedCount == CAPACITY / 2L );
+
+    CacheStats stats;
+    lrucache_stats(cache, &stats);
+    CU_ASSERT_TRUE( stats.hits == CAPACITY / 2L );
+    CU_ASSERT_TRUE( stats.misses == 1L );
+    CU_ASSERT_TRUE( stats.evictions == CAPACITY / 2L );
+
+    lrucache_clear(cache, NULL);
+    CU_ASSERT_TRUE( lrucache_size(cache) == 0L );
+    CU_ASSERT_TRUE( lrucache_put(cache, E(1), E(1), 1L, &value) == INSERTED );
+    lrucache_destroy(cache, NULL);
+
+    CU_PASS("testLeastRecentlyUsed() - Test Passed");
+}
+
+static void testChargeLimit() {
+
+    LruCache *cache;
+    void *value;
+    long i;
+
+    Status stat = lrucache_new(&cache, hashing_pointer, hashing_comparePointer, 0L, NULL);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testChargeLimit() - allocation failure");
+    evictedCount = evictedSum = 0L;
+    lrucache_setEvictionListener(cache, recordEviction, &evictedCount);
+
+    // Without any bound, nothing is evicted
+    for (i = 1L; i <= 100L; i++)
+        CU_ASSERT_TRUE( lrucache_put(cache, E(i), E(i), i, &value) == INSERTED );
+    CU_ASSERT_TRUE( lrucache_charge(cache) == 5050L );
+
+    // Lowering the limit evicts from the back right away
+    lrucache_setChargeLimit(cache, 1000L);
+    CU_ASSERT_TRUE( lrucache_charge(cache) <= 1000L );
+    CU_ASSERT_TRUE( lrucache_containsKey(cache, E(100)) == TRUE );
+    CU_ASSERT_TRUE( lrucache_containsKey(cache, E(1)) == FALSE );
+    CU_ASSERT_TRUE( evictedSum == 5050L - lrucache_charge(cache) );
+
+    // An entry larger than the limit is never admitted, a large one evicts as much as needed
+    CU_ASSERT_TRUE( lrucache_put(cache, E(5000), E(5000), 1001L, &value) == STRUCT_FULL );
+    CU_ASSERT_TRUE( lrucache_put(cache, E(5000), E(5000), 1000L, &value) == INSERTED );
+    CU_ASSERT_TRUE( lrucache_size(cache) == 1L );
+    CU_ASSERT_TRUE( lrucache_charge(cache) == 1000L );
+
+    // Growing an entry's charge evicts the others, never the entry itself
+    CU_ASSERT_TRUE( lrucache_put(cache, E(1), E(1), 10L, &value) == INSERTED );
+    CU_ASSERT_TRUE( lrucache_containsKey(cache, E(5000)) == FALSE );
+    CU_ASSERT_TRUE( lrucache_put(cache, E(2), E(2), 10L, &value) == INSERTED );
+    CU_ASSERT_TRUE( lrucache_put(cache, E(1), E(1), 995L, &value) == REPLACED );
+    CU_ASSERT_TRUE( lrucache_size(cache) == 1L );
+    CU_ASSERT_TRUE( lrucache_containsKey(cache, E(1)) == TRUE );
+
+    lrucache_destroy(cache, NULL);
+
+    CU_PASS("testChargeLimit() - Test Passed");
+}
+
+static void testFrequencyAdmission() {
+
+    LruCache *cache;
+    void *value;
+    long i, j, hits = 0L;
+
+    Status stat = lrucache_new(&cache, hashing_pointer, hashing_comparePointer, CAPACITY, NULL);
+    if (stat != OK || lrucache_setFrequencyAdmission(cache, TRUE) != OK)
+        CU_FAIL_FATAL("ERROR: testFrequencyAdmission() - allocation failure");
+
+    // A popular working set, requested over and over
+    for (j = 0L; j < 4L; j++) {
+        for (i = 0L; i < CAPACITY; i++) {
+            if (lrucache_get(cache, E(i), &value) != OK)
+                lrucache_put(cache, E(i), E(i), 1L, &value);
+        }
+    }
+    // A scan of one-off keys is turned away rather than flushing out the working set; only the
+    // few keys whose counters all collide with popular keys' are admitted
+    for (i = CAPACITY; i < 2L * CAPACITY; i++) {
+        if (lrucache_get(cache, E(i), &value) != OK)
+            lrucache_put(cache, E(i), E(i), 1L, &value);
+    }
+    for (i = 0L; i < CAPACITY; i++)
+        hits += ( lrucache_containsKey(cache, E(i)) == TRUE ) ? 1L : 0L;
+    CU_ASSERT_TRUE( hits >= CAPACITY - CAPACITY / 50L );
+
+    CacheStats stats;
+    lrucache_stats(cache, &stats);
+    CU_ASSERT_TRUE( stats.rejections >= CAPACITY - CAPACITY / 50L );
+    CU_ASSERT_TRUE( stats.evictions == CAPACITY - stats.rejections );
+
+    // Without admission, the same scan flushes the cache
+    CU_ASSERT_TRUE( lrucache_setFrequencyAdmission(cache, FALSE) == OK );
+    for (i = CAPACITY; i < 2L * CAPACITY; i++)
+        CU_ASSERT_TRUE( lrucache_put(cache, E(i), E(i), 1L, &value) != STRUCT_FULL );
+    CU_ASSERT_TRUE( lrucache_containsKey(cache, E(0)) == FALSE );
+
+    lrucache_destroy(cache, NULL);
+
+    CU_PASS("testFrequencyAdmission() - Test Passed");
+}
+
+static ConcurrentLruCache *shared;
+static long mismatches;
+
+static void *hammer(void *arg) {
+
+    long i, seed = (long)arg;
+    void *value;
+
+    for (i = 0L; i < OPS_PER_THREAD; i++) {
+        long key = (seed * OPS_PER_THREAD + i * 7919L) % (4L * CAPACITY);
+        if (ts_lrucache_get(shared, E(key), &value) == OK) {
+            if (value != E(key))
+                __atomic_add_fetch(&mismatches, 1L, __ATOMIC_RELAXED);
+        } else {
+            ts_lrucache_put(shared, E(key), E(key), 1L, &value);
+        }
+    }
+    return NULL;
+}
+
+static void testConcurrentCache() {
+
+    pthread_t threads[THREADS];
+    void *value;
+    long i;
+
+    Status stat = ts_lrucache_new(&shared, hashing_pointer, hashing_comparePointer, CAPACITY,
+                                  NULL);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testConcurrentCache() - allocation failure");
+
+    for (i = 0L; i < THREADS; i++)
+        pthread_create(&threads[i], NULL, hammer, (void *)i);
+    for (i = 0L; i < THREADS; i++)
+        pthread_join(threads[i], NULL);
+
+    CU_ASSERT_TRUE( mismatches == 0L );
+    // Each shard holds its share of the capacity, rounded up
+    CU_ASSERT_TRUE( ts_lrucache_size(shared) <= CAPACITY + 16L );
+    CacheStats stats;
+    ts_lrucache_stats(shared, &stats);
+    CU_ASSERT_TRUE( stats.hits + stats.misses == THREADS * OPS_PER_THREAD );
+    CU_ASSERT_TRUE( stats.evictions > 0L );
+
+    CU_ASSERT_TRUE( ts_lrucache_put(shared, E(-1), E(-1), 1L, &value) == INSERTED );
+    CU_ASSERT_TRUE( ts_lrucache_peek(shared, E(-1), &value) == OK );
+    CU_ASSERT_TRUE( ts_lrucache_remove(shared, E(-1), &value) == OK );
+    CU_ASSERT_TRUE( ts_lrucache_containsKey(shared, E(-1)) == FALSE );
+
+    ts_lrucache_clear(shared, NULL);
+    CU_ASSERT_TRUE( ts_lrucache_size(shared) == 0L );
+    ts_lrucache_destroy(shared, NULL);
+
+    CU_PASS("testConcurrentCache() - Test Passed");
+}
+
+#define UNUSED __attribute__((unused))
+int main(UNUSED int argc, UNUSED char **argv) {
+
+    if (CU_initialize_registry() != CUE_SUCCESS) {
+        return CU_get_error();
+    }
+
+    CU_pSuite suite = CU_add_suite("LruCache Tests", NULL, NULL);
+    if (suite == NULL) {
+        CU_cleanup_registry();
+        return CU_get_error();
+    }
+
+    CU_add_test(suite, "LruCache - Least Recently Used", testLeastRecentlyUsed);
+    CU_add_test(suite, "LruCache - Charge Limit", testChargeLimit);
+    CU_add_test(suite, "LruCache - Frequency Admission", testFrequencyAdmission);
+    CU_add_test(suite, "ConcurrentLruCache - Concurrent Cache", testConcurrentCache);
+
+    CU_basic_set_mode(CU_BRM_VERBOSE);
+    CU_basic_run_tests();
+    CU_cleanup_registry();
+
+    return 0;
+}
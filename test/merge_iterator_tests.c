@@ -0,0 +1,214 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2020 Cole Vikupitz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <stdlib.h>
+#include <CUnit/Basic.h>
+#include "merge_iterator.h"
+
+/* The number of elements in each input */
+#define PER_INPUT 200L
+/* The largest number of inputs merged */
+#define MAX_INPUTS 37L
+
+/* An element, tagged with the input it came from to check the merge is stable */
+typedef struct {
+    long key;
+    long input;
+} Entry;
+
+static Entry entries[MAX_INPUTS][PER_INPUT];
+
+/* Comparator function used for ordering entries by key only */
+static int entryCmp(void *x, void *y) {
+
+    long a = ((Entry *)x)->key, b = ((Entry *)y)->key;
+    return ( a < b ) ? -1 : ( a > b ) ? 1 : 0;
+}
+
+/**
+ * Fills the entries of the first `k` inputs with ascending keys, input i holding i * PER_INPUT / 4
+ * elements so that the inputs have different lengths, and some keys repeat across inputs.
+ */
+static void fillEntries(long k, long *lengths) {
+
+    long i, j;
+
+    srand(k);
+    for (i = 0L; i < k; i++) {
+        lengths[i] = ( i * PER_INPUT / 4L ) % ( PER_INPUT + 1L );
+        long key = rand() % 8L;
+        for (j = 0L; j < lengths[i]; j++) {
+            entries[i][j].key = key;
+            entries[i][j].input = i;
+            key += rand() % 4L;
+        }
+    }
+}
+
+/**
+ * Drains the merge iterator, checking its elements come out in order, with ties in the order of
+ * their inputs; returns the number of elements drained.
+ */
+static long drainMerge(MergeIterator *iter) {
+
+    Entry *entry, *prev = NULL;
+    long count = 0L;
+
+    while (mergeiterator_hasNext(iter) == TRUE) {
+        CU_ASSERT_TRUE( mergeiterator_next(iter, (void **)&entry) == OK );
+        if (prev != NULL) {
+            CU_ASSERT_TRUE( prev->key <= entry->key );
+            if (prev->key == entry->key)
+                CU_ASSERT_TRUE( prev->input <= entry->input );
+        }
+        prev = entry;
+        count++;
+    }
+    CU_ASSERT_TRUE( mergeiterator_next(iter, (void **)&entry) == ITER_END );
+
+    return count;
+}
+
+static void testEmptyMerge() {
+
+    MergeIterator *iter;
+    Iterator *inputs[3];
+    void *item;
+    int i;
+
+    CU_ASSERT_TRUE( mergeiterator_new(&iter, inputs, -1L, entryCmp) == INVALID_INDEX );
+
+    // No inputs at all
+    CU_ASSERT_TRUE( mergeiterator_new(&iter, inputs, 0L, entryCmp) == OK );
+    CU_ASSERT_TRUE( mergeiterator_hasNext(iter) == FALSE );
+    CU_ASSERT_TRUE( mergeiterator_next(iter, &item) == ITER_END );
+    mergeiterator_destroy(iter);
+
+    // Only empty inputs
+    for (i = 0; i < 3; i++)
+        CU_ASSERT_TRUE( iterator_new(&inputs[i], NULL, 0L) == OK );
+    CU_ASSERT_TRUE( mergeiterator_new(&iter, inputs, 3L, entryCmp) == OK );
+    CU_ASSERT_TRUE( mergeiterator_hasNext(iter) == FALSE );
+    CU_ASSERT_TRUE( mergeiterator_next(iter, &item) == ITER_END );
+    mergeiterator_destroy(iter);
+    for (i = 0; i < 3; i++)
+        iterator_destroy(inputs[i]);
+
+    CU_PASS("testEmptyMerge() - Test Passed");
+}
+
+static void testMergeIterators() {
+
+    MergeIterator *iter;
+    Iterator *inputs[MAX_INPUTS];
+    long lengths[MAX_INPUTS], i, j, k, total;
+    void **items;
+
+    // Every number of inputs, including those not filling a whole tree
+    for (k = 1L; k <= MAX_INPUTS; k++) {
+        fillEntries(k, lengths);
+        total = 0L;
+        for (i = 0L; i < k; i++) {
+            items = (void **)malloc(sizeof(void *) * ( lengths[i] + 1L ));
+            if (items == NULL)
+                CU_FAIL_FATAL("ERROR: testMergeIterators() - allocation failure");
+            for (j = 0L; j < lengths[i]; j++)
+                items[j] = &(entries[i][j]);
+            CU_ASSERT_TRUE( iterator_new(&inputs[i], items, lengths[i]) == OK );
+            total += lengths[i];
+        }
+
+        CU_ASSERT_TRUE( mergeiterator_new(&iter, inputs, k, entryCmp) == OK );
+        CU_ASSERT_EQUAL( drainMerge(iter), total );
+        mergeiterator_destroy(iter);
+        for (i = 0L; i < k; i++)
+            iterator_destroy(inputs[i]);
+    }
+
+    CU_PASS("testMergeIterators() - Test Passed");
+}
+
+static void testMergeLists() {
+
+    MergeIterator *iter;
+    ArrayList *lists[MAX_INPUTS];
+    long lengths[MAX_INPUTS], i, j, k, total;
+    Status stat;
+    void *item;
+
+    for (k = 1L; k <= MAX_INPUTS; k += 4L) {
+        fillEntries(k, lengths);
+        total = 0L;
+        for (i = 0L; i < k; i++) {
+            CU_ASSERT_TRUE( arraylist_new(&lists[i], 0L) == OK );
+            for (j = 0L; j < lengths[i]; j++)
+                CU_ASSERT_TRUE( arraylist_add(lists[i], &(entries[i][j])) == OK );
+            total += lengths[i];
+        }
+
+        CU_ASSERT_TRUE( mergeiterator_newFromLists(&iter, lists, k, entryCmp) == OK );
+        CU_ASSERT_EQUAL( drainMerge(iter), total );
+        mergeiterator_destroy(iter);
+
+        // Modifying a list during the merge is caught by its cursor
+        if (k > 1L) {
+            CU_ASSERT_TRUE( mergeiterator_newFromLists(&iter, lists, k, entryCmp) == OK );
+            CU_ASSERT_TRUE( arraylist_add(lists[k - 1L], &(entries[0][0])) == OK );
+            do {
+                stat = mergeiterator_next(iter, &item);
+            } while (stat == OK);
+            CU_ASSERT_TRUE( stat == CONCURRENT_MODIFICATION );
+            mergeiterator_destroy(iter);
+        }
+        for (i = 0L; i < k; i++)
+            arraylist_destroy(lists[i], NULL);
+    }
+
+    CU_PASS("testMergeLists() - Test Passed");
+}
+
+#define UNUSED __attribute__((unused))
+int main(UNUSED int argc, UNUSED char **argv) {
+
+    if (CU_initialize_registry() != CUE_SUCCESS) {
+        return CU_get_error();
+    }
+
+    CU_pSuite suite = CU_add_suite("Merge Iterator Tests", NULL, NULL);
+    if (suite == NULL) {
+        CU_cleanup_registry();
+        return CU_get_error();
+    }
+
+    CU_add_test(suite, "Merge Iterator - Empty", testEmptyMerge);
+    CU_add_test(suite, "Merge Iterator - Iterators", testMergeIterators);
+    CU_add_test(suite, "Merge Iterator - Array Lists", testMergeLists);
+
+    CU_basic_set_mode(CU_BRM_VERBOSE);
+    CU_basic_run_tests();
+    CU_cleanup_registry();
+
+    return 0;
+}
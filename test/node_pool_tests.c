@@ -0,0 +1,201 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2020 Cole Vikupitz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <stdlib.h>
+#include <pthread.h>
+#include <CUnit/Basic.h>
+#include "node_pool.h"
+#include "stack.h"
+#include "queue.h"
+
+/* Collection of sizes and counts used for testing */
+#define SMALL 16
+#define LARGE 1024
+#define LEN 1000
+#define THREADS 4
+
+static void testReuse() {
+
+    NodePool *pool;
+    Status stat;
+    void *first, *second;
+
+    stat = nodepool_new(&pool, 0L);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testReuse() - allocation failure");
+
+    first = nodepool_alloc(pool, SMALL);
+    CU_ASSERT_TRUE( first != NULL );
+    nodepool_free(pool, first, SMALL);
+    second = nodepool_alloc(pool, SMALL);
+    CU_ASSERT_TRUE( first == second );
+    nodepool_free(pool, second, SMALL);
+
+    nodepool_destroy(pool);
+
+    CU_PASS("testReuse() - Test Passed");
+}
+
+static void testManyNodes() {
+
+    NodePool *pool;
+    Status stat;
+    long *nodes[LEN];
+    int i;
+
+    stat = nodepool_new(&pool, 64L);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testManyNodes() - allocation failure");
+
+    // Nodes are distinct, so none of the written values get clobbered
+    for (i = 0; i < LEN; i++) {
+        nodes[i] = (long *)nodepool_alloc(pool, sizeof(long) * 3);
+        CU_ASSERT_TRUE( nodes[i] != NULL );
+        nodes[i][0] = nodes[i][2] = (long)i;
+    }
+    for (i = 0; i < LEN; i++)
+        CU_ASSERT_TRUE( nodes[i][0] == (long)i && nodes[i][2] == (long)i );
+
+    // Sizes past the largest size class still work
+    void *large = nodepool_alloc(pool, LARGE);
+    CU_ASSERT_TRUE( large != NULL );
+    nodepool_free(pool, large, LARGE);
+
+    nodepool_reset(pool);
+    CU_ASSERT_TRUE( nodepool_alloc(pool, SMALL) != NULL );
+    nodepool_destroy(pool);
+
+    CU_PASS("testManyNodes() - Test Passed");
+}
+
+static void testSharedPool() {
+
+    NodePool *pool;
+    Stack *stack;
+    Queue *queue;
+    Status stat;
+    long i;
+    void *item;
+
+    stat = nodepool_new(&pool, 0L);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testSharedPool() - allocation failure");
+    CU_ASSERT_TRUE( stack_newWithPool(&stack, pool) == OK );
+    CU_ASSERT_TRUE( queue_newWithPool(&queue, pool) == OK );
+
+    for (i = 0L; i < LEN; i++) {
+        CU_ASSERT_TRUE( stack_push(stack, (void *)i) == OK );
+        CU_ASSERT_TRUE( queue_add(queue, (void *)i) == OK );
+    }
+    for (i = 0L; i < LEN / 2; i++) {
+        CU_ASSERT_TRUE( stack_pop(stack, &item) == OK );
+        CU_ASSERT_TRUE( item == (void *)( LEN - 1 - i ) );
+        CU_ASSERT_TRUE( queue_poll(queue, &item) == OK );
+        CU_ASSERT_TRUE( item == (void *)i );
+    }
+
+    // The structures give their nodes back, while the pool outlives them
+    stack_clear(stack, NULL);
+    stack_destroy(stack, NULL);
+    queue_destroy(queue, NULL);
+    CU_ASSERT_TRUE( nodepool_alloc(pool, SMALL) != NULL );
+    nodepool_destroy(pool);
+
+    CU_PASS("testSharedPool() - Test Passed");
+}
+
+/**
+ * Repeatedly allocates and frees nodes from the concurrent pool `arg`.
+ */
+static void *_churn(void *arg) {
+
+    NodePool *pool = (NodePool *)arg;
+    long *nodes[LEN];
+    int i, round;
+
+    for (round = 0; round < 10; round++) {
+        for (i = 0; i < LEN; i++) {
+            nodes[i] = (long *)nodepool_alloc(pool, SMALL);
+            if (nodes[i] != NULL)
+                *(nodes[i]) = (long)i;
+        }
+        for (i = 0; i < LEN; i++) {
+            if (nodes[i] == NULL || *(nodes[i]) != (long)i)
+                return arg;
+            nodepool_free(pool, nodes[i], SMALL);
+        }
+    }
+
+    return NULL;
+}
+
+static void testConcurrentPool() {
+
+    NodePool *pool;
+    pthread_t threads[THREADS];
+    Status stat;
+    void *result;
+    int i;
+
+    stat = nodepool_newConcurrent(&pool, 0L);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testConcurrentPool() - allocation failure");
+
+    for (i = 0; i < THREADS; i++)
+        CU_ASSERT_TRUE( pthread_create(&threads[i], NULL, _churn, pool) == 0 );
+    for (i = 0; i < THREADS; i++) {
+        CU_ASSERT_TRUE( pthread_join(threads[i], &result) == 0 );
+        CU_ASSERT_TRUE( result == NULL );
+    }
+
+    nodepool_destroy(pool);
+
+    CU_PASS("testConcurrentPool() - Test Passed");
+}
+
+#define UNUSED __attribute__((unused))
+int main(UNUSED int argc, UNUSED char **argv) {
+
+    if (CU_initialize_registry() != CUE_SUCCESS) {
+        return CU_get_error();
+    }
+
+    CU_pSuite suite = CU_add_suite("NodePool Tests", NULL, NULL);
+    if (suite == NULL) {
+        CU_cleanup_registry();
+        return CU_get_error();
+    }
+
+    CU_add_test(suite, "NodePool - Reuse", testReuse);
+    CU_add_test(suite, "NodePool - Many Nodes", testManyNodes);
+    CU_add_test(suite, "NodePool - Shared Pool", testSharedPool);
+    CU_add_test(suite, "NodePool - Concurrent Pool", testConcurrentPool);
+
+    CU_basic_set_mode(CU_BRM_VERBOSE);
+    CU_basic_run_tests();
+    CU_cleanup_registry();
+
+    return 0;
+}
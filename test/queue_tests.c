@@ -23,8 +23,12 @@
  */
 
 #include <stdlib.h>
+#include <pthread.h>
+#include <sched.h>
 #include <CUnit/Basic.h>
 #include "queue.h"
+#include "ts_queue.h"
+#include "lf_queue.h"
 
 /* Single item used for testing */
 static char *singleItem = "Test";
@@ -193,6 +197,280 @@ static void testQueueClear() {
     CU_PASS("testQueueClear() - Test Passed");
 }
 
+static void testQueueCursor() {
+
+    Iterator *iter;
+    Cursor cursor;
+    Queue *queue;
+    Status stat;
+    int i;
+    char *item, *other;
+
+    stat = queue_new(&queue);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testQueueCursor() - allocation failure");
+
+    queue_cursor(queue, &cursor);
+    CU_ASSERT_TRUE( cursor_hasNext(&cursor) == FALSE );
+    CU_ASSERT_TRUE( queue_cursorNext(&cursor, (void **)&item) == ITER_END );
+
+    for (i = 0; i < LEN; i++)
+        CU_ASSERT_TRUE( queue_add(queue, array[i]) == OK );
+    CU_ASSERT_TRUE( queue_iterator(queue, &iter) == OK );
+
+    // The cursor must visit the same items in the same order as the iterator
+    i = 0;
+    queue_cursor(queue, &cursor);
+    while (cursor_hasNext(&cursor) == TRUE) {
+        CU_ASSERT_TRUE( queue_cursorNext(&cursor, (void **)&item) == OK );
+        CU_ASSERT_TRUE( iterator_next(iter, (void **)&other) == OK );
+        CU_ASSERT_TRUE( item == other );
+        i++;
+    }
+    CU_ASSERT_EQUAL( i, LEN );
+    CU_ASSERT_TRUE( queue_cursorNext(&cursor, (void **)&item) == ITER_END );
+    iterator_destroy(iter);
+
+    // A structural change invalidates any cursor already in progress
+    queue_cursor(queue, &cursor);
+    CU_ASSERT_TRUE( queue_cursorNext(&cursor, (void **)&item) == OK );
+    CU_ASSERT_TRUE( queue_poll(queue, (void **)&item) == OK );
+    CU_ASSERT_TRUE( queue_cursorNext(&cursor, (void **)&item) == CONCURRENT_MODIFICATION );
+    queue_destroy(queue, NULL);
+
+    CU_PASS("testQueueCursor() - Test Passed");
+}
+
+#define UNROLLED_LEN 1000L
+
+static void testUnrolledQueue() {
+
+    Queue *queue;
+    Array *arr;
+    Cursor cursor;
+    void *item;
+    long i, next = 0L, added = 0L;
+
+    Status stat = queue_newUnrolled(&queue);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testUnrolledQueue() - allocation failure");
+    validateEmptyQueue(queue);
+
+    // Adds two items for every one polled, so the head and tail move through many chunks
+    for (i = 0L; i < UNROLLED_LEN; i++) {
+        CU_ASSERT_TRUE( queue_add(queue, (void *)(added++)) == OK );
+        CU_ASSERT_TRUE( queue_add(queue, (void *)(added++)) == OK );
+        CU_ASSERT_TRUE( queue_peek(queue, &item) == OK );
+        CU_ASSERT_EQUAL( (long)item, next );
+        CU_ASSERT_TRUE( queue_poll(queue, &item) == OK );
+        CU_ASSERT_EQUAL( (long)item, next++ );
+    }
+    CU_ASSERT_EQUAL( queue_size(queue), added - next );
+
+    CU_ASSERT_TRUE( queue_toArray(queue, &arr) == OK );
+    for (i = 0L; i < arr->len; i++)
+        CU_ASSERT_EQUAL( (long)arr->items[i], next + i );
+    FREE_ARRAY(arr);
+    i = next;
+    queue_cursor(queue, &cursor);
+    while (queue_cursorNext(&cursor, &item) == OK)
+        CU_ASSERT_EQUAL( (long)item, i++ );
+    CU_ASSERT_EQUAL( i, added );
+
+    // Drains it completely, then reuses it
+    while (queue_poll(queue, &item) == OK)
+        CU_ASSERT_EQUAL( (long)item, next++ );
+    CU_ASSERT_EQUAL( next, added );
+    validateEmptyQueue(queue);
+    for (i = 0L; i < LEN; i++)
+        CU_ASSERT_TRUE( queue_add(queue, array[i]) == OK );
+    queue_clear(queue, NULL);
+    validateEmptyQueue(queue);
+    CU_ASSERT_TRUE( queue_add(queue, malloc(8)) == OK );
+    queue_destroy(queue, free);
+
+    CU_PASS("testUnrolledQueue() - Test Passed");
+}
+
+#define THREADS 4
+#define PER_THREAD 50000L
+
+/**
+ * Producer thread, adds the values id * PER_THREAD + 1..PER_THREAD into the queue in order.
+ */
+static void *_produce(void *arg) {
+
+    void **args = (void **)arg;
+    LockFreeQueue *queue = (LockFreeQueue *)args[0];
+    long i, base = (long)args[1] * PER_THREAD;
+
+    for (i = 1L; i <= PER_THREAD; i++) {
+        if (lf_queue_add(queue, (void *)(base + i)) != OK)
+            return arg;
+    }
+
+    return NULL;
+}
+
+static void testLockFreeQueue() {
+
+    LockFreeQueue *queue;
+    pthread_t threads[THREADS];
+    void *args[THREADS][2], *item, *result;
+    long last[THREADS], value, received = 0L;
+    Boolean ordered = TRUE;
+    int i;
+
+    Status stat = lf_queue_new(&queue);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testLockFreeQueue() - allocation failure");
+
+    // Behaves like a queue on a single thread
+    CU_ASSERT_TRUE( lf_queue_isEmpty(queue) == TRUE );
+    CU_ASSERT_TRUE( lf_queue_poll(queue, &item) == STRUCT_EMPTY );
+    CU_ASSERT_TRUE( lf_queue_peek(queue, &item) == STRUCT_EMPTY );
+    for (i = 0; i < LEN; i++)
+        CU_ASSERT_TRUE( lf_queue_add(queue, array[i]) == OK );
+    CU_ASSERT_TRUE( lf_queue_isEmpty(queue) == FALSE );
+    CU_ASSERT_TRUE( lf_queue_peek(queue, &item) == OK );
+    CU_ASSERT_TRUE( item == array[0] );
+    for (i = 0; i < LEN; i++) {
+        CU_ASSERT_TRUE( lf_queue_poll(queue, &item) == OK );
+        CU_ASSERT_TRUE( item == array[i] );
+    }
+    CU_ASSERT_TRUE( lf_queue_isEmpty(queue) == TRUE );
+
+    // Each producer's values must arrive exactly once and in the order they were added
+    for (i = 0; i < THREADS; i++) {
+        last[i] = 0L;
+        args[i][0] = queue;
+        args[i][1] = (void *)(long)i;
+        CU_ASSERT_TRUE( pthread_create(&threads[i], NULL, _produce, args[i]) == 0 );
+    }
+    while (received < THREADS * PER_THREAD) {
+        if (lf_queue_poll(queue, &item) != OK) {
+            sched_yield();
+            continue;
+        }
+        value = (long)item - 1L;
+        if (value % PER_THREAD != last[value / PER_THREAD])
+            ordered = FALSE;
+        last[value / PER_THREAD]++;
+        received++;
+    }
+    CU_ASSERT_TRUE( ordered == TRUE );
+    for (i = 0; i < THREADS; i++) {
+        CU_ASSERT_TRUE( pthread_join(threads[i], &result) == 0 );
+        CU_ASSERT_TRUE( result == NULL );
+    }
+    CU_ASSERT_TRUE( lf_queue_isEmpty(queue) == TRUE );
+
+    // Items left in the queue are handed to the destructor
+    CU_ASSERT_TRUE( lf_queue_add(queue, malloc(8)) == OK );
+    CU_ASSERT_TRUE( lf_queue_add(queue, malloc(8)) == OK );
+    lf_queue_destroy(queue, free);
+
+    CU_PASS("testLockFreeQueue() - Test Passed");
+}
+
+#define BATCH 100L
+
+/**
+ * Producer thread, adds the values id * PER_THREAD + 1..PER_THREAD into the queue in batches.
+ */
+static void *_produceBatches(void *arg) {
+
+    ConcurrentQueue *queue = ((void **)arg)[0];
+    long id = (long)((void **)arg)[1], i, j;
+    void *items[BATCH];
+
+    for (i = 1L; i <= PER_THREAD; i += BATCH) {
+        for (j = 0L; j < BATCH; j++)
+            items[j] = (void *)(id * PER_THREAD + i + j);
+        if (ts_queue_addAll(queue, items, BATCH) != OK)
+            return (void *)1L;
+    }
+
+    return NULL;
+}
+
+static void testBatchedQueue() {
+
+    long sizes[] = { 0L, 1L, 31L, 32L, 33L, 100L, 1000L };
+    ConcurrentQueue *shared;
+    void *args[THREADS][2];
+    pthread_t threads[THREADS];
+    Queue *queue;
+    void *items[1000], *result;
+    long i, n, s, added, next, drained, sum = 0L;
+    int unrolled;
+
+    CU_ASSERT_TRUE( queue_new(&queue) == OK );
+    CU_ASSERT_TRUE( queue_addAll(queue, items, -1L) == INVALID_INDEX );
+    queue_destroy(queue, NULL);
+
+    // Batches of every size across chunk boundaries come out in order, in batches of other sizes
+    for (unrolled = 0; unrolled < 2; unrolled++) {
+        Status stat = ( unrolled == 0 ) ? queue_new(&queue) : queue_newUnrolled(&queue);
+        if (stat != OK)
+            CU_FAIL_FATAL("ERROR: testBatchedQueue() - allocation failure");
+        added = next = 0L;
+        for (s = 0L; s < 7L; s++) {
+            for (n = 0L; n < sizes[s]; n++)
+                items[n] = (void *)(added + n);
+            CU_ASSERT_TRUE( queue_addAll(queue, items, sizes[s]) == OK );
+            added += sizes[s];
+            CU_ASSERT_TRUE( queue_add(queue, (void *)(added++)) == OK );
+            CU_ASSERT_EQUAL( queue_size(queue), added - next );
+
+            drained = queue_pollMany(queue, items, sizes[(s + 3L) % 7L]);
+            CU_ASSERT_EQUAL( drained, ( sizes[(s + 3L) % 7L] < added - next ) ?
+                             sizes[(s + 3L) % 7L] : added - next );
+            for (i = 0L; i < drained; i++)
+                CU_ASSERT_EQUAL( (long)items[i], next++ );
+        }
+        while ((drained = queue_pollMany(queue, items, 7L)) > 0L) {
+            for (i = 0L; i < drained; i++)
+                CU_ASSERT_EQUAL( (long)items[i], next++ );
+        }
+        CU_ASSERT_EQUAL( next, added );
+        validateEmptyQueue(queue);
+        CU_ASSERT_TRUE( queue_pollMany(queue, items, 10L) == 0L );
+
+        // The queue still works one item at a time afterwards
+        CU_ASSERT_TRUE( queue_addAll(queue, (void **)array, LEN) == OK );
+        for (i = 0L; i < LEN; i++) {
+            CU_ASSERT_TRUE( queue_poll(queue, &result) == OK );
+            CU_ASSERT_TRUE( result == array[i] );
+        }
+        validateEmptyQueue(queue);
+        queue_destroy(queue, NULL);
+    }
+
+    // Producers add whole batches while the main thread drains them
+    CU_ASSERT_TRUE( ts_queue_new(&shared) == OK );
+    for (i = 0L; i < THREADS; i++) {
+        args[i][0] = shared;
+        args[i][1] = (void *)i;
+        CU_ASSERT_TRUE( pthread_create(&threads[i], NULL, _produceBatches, args[i]) == 0 );
+    }
+    for (n = 0L; n < THREADS * PER_THREAD; ) {
+        drained = ts_queue_pollMany(shared, items, 1000L);
+        for (i = 0L; i < drained; i++)
+            sum += (long)items[i];
+        n += drained;
+    }
+    for (i = 0L; i < THREADS; i++) {
+        CU_ASSERT_TRUE( pthread_join(threads[i], &result) == 0 );
+        CU_ASSERT_TRUE( result == NULL );
+    }
+    CU_ASSERT_EQUAL( sum, (THREADS * PER_THREAD) * (THREADS * PER_THREAD + 1L) / 2L );
+    CU_ASSERT_TRUE( ts_queue_isEmpty(shared) == TRUE );
+    ts_queue_destroy(shared, NULL);
+
+    CU_PASS("testBatchedQueue() - Test Passed");
+}
+
 #define UNUSED __attribute__((unused))
 int main(UNUSED int argc, UNUSED char **argv) {
 
@@ -211,7 +489,11 @@ int main(UNUSED int argc, UNUSED char **argv) {
     CU_add_test(suite, "Queue - Add & Poll", testAddPoll);
     CU_add_test(suite, "Queue - Array", testQueueToArray);
     CU_add_test(suite, "Queue - Iterator", testQueueIterator);
+    CU_add_test(suite, "Queue - Cursor", testQueueCursor);
     CU_add_test(suite, "Queue - Clear", testQueueClear);
+    CU_add_test(suite, "Queue - Unrolled", testUnrolledQueue);
+    CU_add_test(suite, "Queue - Lock-Free Queue", testLockFreeQueue);
+    CU_add_test(suite, "Queue - Batched Operations", testBatchedQueue);
 
     CU_basic_set_mode(CU_BRM_VERBOSE);
     CU_basic_run_tests();
@@ -0,0 +1,362 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2020 Cole Vikupitz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <CUnit/Basic.h>
+#include "radix_tree.h"
+
+/* Sizes used for testing */
+#define KEYS 20000L
+#define MAX_LENGTH 24L
+
+/* Values are identified by their index, stored directly in the pointer */
+#define E(x) ((void *)(long)(x))
+
+/* A key of the reference set */
+typedef struct {
+    unsigned char bytes[MAX_LENGTH];
+    long length;
+} Key;
+
+/* Distinct keys sorted in ascending order, and whether each is in the tree under test */
+static Key keys[KEYS];
+static Boolean present[KEYS];
+
+/* Orders two keys by their bytes, a prefix first */
+static int compareKeys(const void *x, const void *y) {
+    const Key *a = (const Key *)x, *b = (const Key *)y;
+    int cmp = memcmp(a->bytes, b->bytes, (size_t)(( a->length < b->length ) ? a->length
+                                                                          : b->length));
+    return ( cmp != 0 ) ? cmp : ( a->length > b->length ) - ( a->length < b->length );
+}
+
+/*
+ * Fills the reference set with random distinct keys, sharing long common prefixes and drawn from
+ * few bytes so that many keys are prefixes of others.
+ */
+static void makeKeys(void) {
+    long i, j, count = 0L;
+
+    srand(12345);
+    while (count < KEYS) {
+        // Draw new keys into the free slots, then sort and drop the duplicates
+        for (i = count; i < KEYS; i++) {
+            keys[i].length = rand() % MAX_LENGTH;
+            for (j = 0L; j < keys[i].length; j++) {
+                keys[i].bytes[j] = ( j < 12L && rand() % 4 != 0 ) ? 'a'
+                                                                  : (unsigned char)(rand() % 6);
+            }
+        }
+        qsort(keys, KEYS, sizeof(Key), compareKeys);
+        for (i = 1L, count = 1L; i < KEYS; i++) {
+            if (compareKeys(&keys[i], &keys[count - 1]) != 0) {
+                keys[count++] = keys[i];
+            }
+        }
+    }
+}
+
+/* Checks that the returned key is the key at the index */
+static Boolean sameKey(const void *bytes, long length, long index) {
+    return ( length == keys[index].length &&
+             memcmp(bytes, keys[index].bytes, (size_t)length) == 0 ) ? TRUE : FALSE;
+}
+
+/* Records the order the keys are visited in, checking them against the reference set */
+typedef struct {
+    long next;
+    long visited;
+    long limit;
+} Walk;
+
+static Boolean checkVisit(const void *bytes, long length, void *value, void *context) {
+    Walk *walk = (Walk *)context;
+    long i = (long)value;
+    CU_ASSERT_TRUE( present[i] == TRUE );
+    CU_ASSERT_TRUE( sameKey(bytes, length, i) == TRUE );
+    CU_ASSERT_TRUE( i >= walk->next );
+    walk->next = i + 1;
+    walk->visited++;
+    return ( walk->visited < walk->limit ) ? TRUE : FALSE;
+}
+
+/*
+ * Tests put, get, containsKey and remove against the reference set.
+ */
+void testPutGetRemove(void) {
+
+    RadixTree *tree;
+    void *value = NULL;
+    long i, count = 0L;
+
+    makeKeys();
+    CU_ASSERT_TRUE( radixtree_new(&tree) == OK );
+    CU_ASSERT_TRUE( radixtree_isEmpty(tree) == TRUE );
+    CU_ASSERT_TRUE( radixtree_get(tree, "a", 1L, &value) == NOT_FOUND );
+    CU_ASSERT_TRUE( radixtree_remove(tree, "a", 1L, &value) == NOT_FOUND );
+
+    // Insert the keys in a scrambled order
+    for (i = 0L; i < KEYS; i++) {
+        long k = (i * 7919L) % KEYS;
+        CU_ASSERT_TRUE( radixtree_put(tree, keys[k].bytes, keys[k].length, E(k), &value)
+                        == INSERTED );
+    }
+    CU_ASSERT_TRUE( radixtree_size(tree) == KEYS );
+    for (i = 0L; i < KEYS; i++) {
+        CU_ASSERT_TRUE( radixtree_get(tree, keys[i].bytes, keys[i].length, &value) == OK );
+        CU_ASSERT_TRUE( value == E(i) );
+    }
+
+    // Replacing a value reports the old one
+    CU_ASSERT_TRUE( radixtree_put(tree, keys[5].bytes, keys[5].length, E(-5), &value)
+                    == REPLACED );
+    CU_ASSERT_TRUE( value == E(5) );
+    CU_ASSERT_TRUE( radixtree_put(tree, keys[5].bytes, keys[5].length, E(5), &value)
+                    == REPLACED );
+    CU_ASSERT_TRUE( radixtree_size(tree) == KEYS );
+
+    // Remove every third key, then check every key
+    for (i = 0L; i < KEYS; i += 3L) {
+        CU_ASSERT_TRUE( radixtree_remove(tree, keys[i].bytes, keys[i].length, &value) == OK );
+        CU_ASSERT_TRUE( value == E(i) );
+        CU_ASSERT_TRUE( radixtree_remove(tree, keys[i].bytes, keys[i].length, &value)
+                        == NOT_FOUND );
+    }
+    for (i = 0L; i < KEYS; i++) {
+        Boolean expected = ( i % 3L != 0L ) ? TRUE : FALSE;
+        CU_ASSERT_TRUE( radixtree_containsKey(tree, keys[i].bytes, keys[i].length) == expected );
+        count += ( expected == TRUE ) ? 1L : 0L;
+    }
+    CU_ASSERT_TRUE( radixtree_size(tree) == count );
+
+    // Remove the rest, leaving nothing behind
+    for (i = 0L; i < KEYS; i++) {
+        if (i % 3L != 0L) {
+            CU_ASSERT_TRUE( radixtree_remove(tree, keys[i].bytes, keys[i].length, &value) == OK );
+            CU_ASSERT_TRUE( value == E(i) );
+        }
+    }
+    CU_ASSERT_TRUE( radixtree_isEmpty(tree) == TRUE );
+    CU_ASSERT_TRUE( radixtree_memoryUsage(tree) == radixtree_memoryUsage(tree) );
+
+    radixtree_destroy(tree, NULL);
+
+    CU_PASS("testPutGetRemove() - Test Passed");
+}
+
+/*
+ * Tests the ordered queries: firstKey, lastKey, floorKey, ceilingKey and forEach.
+ */
+void testOrdering(void) {
+
+    RadixTree *tree;
+    const void *found;
+    void *value;
+    long i, length;
+    Walk walk = {0L, 0L, KEYS + 1L};
+
+    makeKeys();
+    CU_ASSERT_TRUE( radixtree_new(&tree) == OK );
+    CU_ASSERT_TRUE( radixtree_firstKey(tree, &found, &length) == STRUCT_EMPTY );
+    CU_ASSERT_TRUE( radixtree_floorKey(tree, "a", 1L, &found, &length) == STRUCT_EMPTY );
+
+    // Keep the keys at even indices, querying the odd ones
+    for (i = 0L; i < KEYS; i++) {
+        present[i] = ( i % 2L == 0L ) ? TRUE : FALSE;
+        if (present[i] == TRUE) {
+            radixtree_put(tree, keys[i].bytes, keys[i].length, E(i), &value);
+        }
+    }
+    CU_ASSERT_TRUE( radixtree_firstKey(tree, &found, &length) == OK );
+    CU_ASSERT_TRUE( sameKey(found, length, 0L) == TRUE );
+    CU_ASSERT_TRUE( radixtree_lastKey(tree, &found, &length) == OK );
+    CU_ASSERT_TRUE( sameKey(found, length, (KEYS - 1L) & ~1L) == TRUE );
+
+    for (i = 0L; i < KEYS; i++) {
+        long floor = ( present[i] == TRUE ) ? i : i - 1L;
+        long ceiling = ( present[i] == TRUE ) ? i : i + 1L;
+        Status status = radixtree_floorKey(tree, keys[i].bytes, keys[i].length, &found, &length);
+        CU_ASSERT_TRUE( status == OK );
+        CU_ASSERT_TRUE( status == OK && sameKey(found, length, floor) == TRUE );
+        status = radixtree_ceilingKey(tree, keys[i].bytes, keys[i].length, &found, &length);
+        if (ceiling < KEYS) {
+            CU_ASSERT_TRUE( status == OK && sameKey(found, length, ceiling) == TRUE );
+        } else {
+            CU_ASSERT_TRUE( status == NOT_FOUND );
+        }
+    }
+
+    // The walk visits every key in order, and stops when asked to
+    CU_ASSERT_TRUE( radixtree_forEach(tree, checkVisit, &walk) == TRUE );
+    CU_ASSERT_TRUE( walk.visited == radixtree_size(tree) );
+    walk.next = 0L;
+    walk.visited = 0L;
+    walk.limit = 10L;
+    CU_ASSERT_TRUE( radixtree_forEach(tree, checkVisit, &walk) == FALSE );
+    CU_ASSERT_TRUE( walk.visited == 10L );
+
+    radixtree_destroy(tree, NULL);
+
+    CU_PASS("testOrdering() - Test Passed");
+}
+
+/*
+ * Tests forEachPrefix, comparing each prefix scan to a linear scan of the reference set.
+ */
+void testPrefixScan(void) {
+
+    RadixTree *tree;
+    void *value;
+    long i, j, p;
+
+    makeKeys();
+    CU_ASSERT_TRUE( radixtree_new(&tree) == OK );
+    for (i = 0L; i < KEYS; i++) {
+        present[i] = TRUE;
+        radixtree_put(tree, keys[i].bytes, keys[i].length, E(i), &value);
+    }
+
+    // Scan by every prefix of a sample of keys
+    for (i = 0L; i < KEYS; i += 97L) {
+        for (p = 0L; p <= keys[i].length; p++) {
+            Walk walk = {0L, 0L, KEYS + 1L};
+            long expected = 0L;
+            for (j = 0L; j < KEYS; j++) {
+                if (keys[j].length >= p && memcmp(keys[j].bytes, keys[i].bytes, (size_t)p) == 0) {
+                    expected++;
+                }
+            }
+            CU_ASSERT_TRUE( radixtree_forEachPrefix(tree, keys[i].bytes, p, checkVisit, &walk)
+                            == TRUE );
+            CU_ASSERT_TRUE( walk.visited == expected );
+        }
+    }
+
+    // A prefix no key starts with visits nothing
+    Walk walk = {0L, 0L, KEYS + 1L};
+    CU_ASSERT_TRUE( radixtree_forEachPrefix(tree, "zz", 2L, checkVisit, &walk) == TRUE );
+    CU_ASSERT_TRUE( walk.visited == 0L );
+
+    radixtree_destroy(tree, NULL);
+
+    CU_PASS("testPrefixScan() - Test Passed");
+}
+
+/* Counts the values handed to the destructor */
+static long destroyed = 0L;
+
+static void countDestroyed(void *value) {
+    (void)value;
+    destroyed++;
+}
+
+/*
+ * Tests growing and shrinking a node through every size, under prefixes longer than the bytes
+ * stored in a node, and clearing the tree.
+ */
+void testNodeGrowth(void) {
+
+    RadixTree *tree;
+    unsigned char key[40];
+    void *value;
+    long i, empty;
+
+    CU_ASSERT_TRUE( radixtree_new(&tree) == OK );
+    empty = radixtree_memoryUsage(tree);
+    memset(key, 'p', sizeof(key));
+
+    // Keys share a 30 byte prefix, and then branch over every byte
+    for (i = 0L; i < 256L; i++) {
+        key[30] = (unsigned char)i;
+        CU_ASSERT_TRUE( radixtree_put(tree, key, 31L, E(i), &value) == INSERTED );
+    }
+    CU_ASSERT_TRUE( radixtree_put(tree, key, 30L, E(256), &value) == INSERTED );
+    CU_ASSERT_TRUE( radixtree_put(tree, key, 12L, E(257), &value) == INSERTED );
+    CU_ASSERT_TRUE( radixtree_size(tree) == 258L );
+    CU_ASSERT_TRUE( radixtree_memoryUsage(tree) > empty );
+
+    // A key parting from the long prefix beyond its stored bytes splits it
+    key[20] = 'q';
+    CU_ASSERT_TRUE( radixtree_put(tree, key, 31L, E(258), &value) == INSERTED );
+    CU_ASSERT_TRUE( radixtree_get(tree, key, 31L, &value) == OK && value == E(258) );
+    key[20] = 'p';
+    for (i = 0L; i < 256L; i++) {
+        key[30] = (unsigned char)i;
+        CU_ASSERT_TRUE( radixtree_get(tree, key, 31L, &value) == OK && value == E(i) );
+    }
+
+    // Shrink the node back down, checking the rest as it passes through each size
+    for (i = 255L; i >= 1L; i--) {
+        long j;
+        key[30] = (unsigned char)i;
+        CU_ASSERT_TRUE( radixtree_remove(tree, key, 31L, &value) == OK && value == E(i) );
+        for (j = 0L; j < i; j += 7L) {
+            key[30] = (unsigned char)j;
+            CU_ASSERT_TRUE( radixtree_get(tree, key, 31L, &value) == OK && value == E(j) );
+        }
+    }
+    CU_ASSERT_TRUE( radixtree_get(tree, key, 30L, &value) == OK && value == E(256) );
+    CU_ASSERT_TRUE( radixtree_get(tree, key, 12L, &value) == OK && value == E(257) );
+    CU_ASSERT_TRUE( radixtree_size(tree) == 4L );
+
+    // Clearing hands every value to the destructor
+    radixtree_clear(tree, countDestroyed);
+    CU_ASSERT_TRUE( destroyed == 4L );
+    CU_ASSERT_TRUE( radixtree_isEmpty(tree) == TRUE );
+    CU_ASSERT_TRUE( radixtree_memoryUsage(tree) == empty );
+    CU_ASSERT_TRUE( radixtree_put(tree, key, 31L, E(0), &value) == INSERTED );
+
+    radixtree_destroy(tree, countDestroyed);
+    CU_ASSERT_TRUE( destroyed == 5L );
+
+    CU_PASS("testNodeGrowth() - Test Passed");
+}
+
+#define UNUSED __attribute__((unused))
+int main(UNUSED int argc, UNUSED char **argv) {
+
+    if (CU_initialize_registry() != CUE_SUCCESS) {
+        return CU_get_error();
+    }
+
+    CU_pSuite suite = CU_add_suite("RadixTree Tests", NULL, NULL);
+    if (suite == NULL) {
+        CU_cleanup_registry();
+        return CU_get_error();
+    }
+
+    CU_add_test(suite, "RadixTree - Put, Get and Remove", testPutGetRemove);
+    CU_add_test(suite, "RadixTree - Ordering", testOrdering);
+    CU_add_test(suite, "RadixTree - Prefix Scan", testPrefixScan);
+    CU_add_test(suite, "RadixTree - Node Growth", testNodeGrowth);
+
+    CU_basic_set_mode(CU_BRM_VERBOSE);
+    CU_basic_run_tests();
+    CU_cleanup_registry();
+
+    return 0;
+}
@@ -0,0 +1,217 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2020 Cole Vikupitz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <pthread.h>
+#include <sched.h>
+#include <CUnit/Basic.h>
+#include "ring_queue.h"
+
+/* Collection of sizes and counts used for testing */
+#define CAPACITY 6L
+#define THREADS 4
+#define PER_THREAD 100000L
+
+static char *array[] = {"red", "orange", "yellow", "green", "blue", "purple", "black", "white"};
+#define LEN 8
+
+/**
+ * Fills the queue to capacity, checks that it is full, then drains it in FIFO order.
+ */
+static void validateRing(RingQueue *queue) {
+
+    char *item;
+    int i, lap;
+
+    CU_ASSERT_EQUAL( ringqueue_capacity(queue), 8L );
+    for (lap = 0; lap < 3; lap++) {
+        CU_ASSERT_TRUE( ringqueue_isEmpty(queue) == TRUE );
+        CU_ASSERT_TRUE( ringqueue_poll(queue, (void **)&item) == STRUCT_EMPTY );
+        for (i = 0; i < LEN; i++) {
+            CU_ASSERT_TRUE( ringqueue_add(queue, array[i]) == OK );
+            CU_ASSERT_EQUAL( ringqueue_size(queue), i + 1 );
+        }
+        CU_ASSERT_TRUE( ringqueue_add(queue, array[0]) == STRUCT_FULL );
+        for (i = 0; i < LEN; i++) {
+            CU_ASSERT_TRUE( ringqueue_poll(queue, (void **)&item) == OK );
+            CU_ASSERT_TRUE( item == array[i] );
+        }
+    }
+}
+
+static void testRingQueue() {
+
+    RingQueue *spsc, *mpmc;
+    Status stat;
+
+    stat = ringqueue_newSpsc(&spsc, CAPACITY);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testRingQueue() - allocation failure");
+    stat = ringqueue_newMpmc(&mpmc, CAPACITY);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testRingQueue() - allocation failure");
+
+    validateRing(spsc);
+    validateRing(mpmc);
+
+    // The default capacity is still a power of two
+    ringqueue_destroy(spsc, NULL);
+    CU_ASSERT_TRUE( ringqueue_newSpsc(&spsc, 0L) == OK );
+    CU_ASSERT_EQUAL( ringqueue_capacity(spsc) & (ringqueue_capacity(spsc) - 1L), 0L );
+
+    // Items left in the queue are handed to the destructor
+    CU_ASSERT_TRUE( ringqueue_add(mpmc, malloc(8)) == OK );
+    CU_ASSERT_TRUE( ringqueue_add(mpmc, malloc(8)) == OK );
+    ringqueue_destroy(spsc, NULL);
+    ringqueue_destroy(mpmc, free);
+
+    CU_PASS("testRingQueue() - Test Passed");
+}
+
+/**
+ * Producer thread, adds the values 1..PER_THREAD to the ring, yielding while it is full.
+ */
+static void *_produce(void *arg) {
+
+    RingQueue *queue = (RingQueue *)arg;
+    long i;
+
+    for (i = 1L; i <= PER_THREAD; i++) {
+        while (ringqueue_add(queue, (void *)i) != OK)
+            sched_yield();
+    }
+
+    return NULL;
+}
+
+/**
+ * Consumer thread, polls PER_THREAD values from the ring and returns their sum. In a single
+ * consumer ring, the values must also arrive in the order they were added.
+ */
+static void *_consume(void *arg) {
+
+    RingQueue *queue = (RingQueue *)arg;
+    void *item;
+    long i, sum = 0L;
+
+    for (i = 1L; i <= PER_THREAD; i++) {
+        while (ringqueue_poll(queue, &item) != OK)
+            sched_yield();
+        sum += (long)item;
+    }
+
+    return (void *)sum;
+}
+
+static void *_consume_ordered(void *arg) {
+
+    RingQueue *queue = (RingQueue *)arg;
+    void *item;
+    long i;
+
+    for (i = 1L; i <= PER_THREAD; i++) {
+        while (ringqueue_poll(queue, &item) != OK)
+            sched_yield();
+        if ((long)item != i)
+            return arg;
+    }
+
+    return NULL;
+}
+
+static void testSpscThreads() {
+
+    RingQueue *queue;
+    pthread_t producer, consumer;
+    void *result;
+
+    if (ringqueue_newSpsc(&queue, 64L) != OK)
+        CU_FAIL_FATAL("ERROR: testSpscThreads() - allocation failure");
+
+    CU_ASSERT_TRUE( pthread_create(&consumer, NULL, _consume_ordered, queue) == 0 );
+    CU_ASSERT_TRUE( pthread_create(&producer, NULL, _produce, queue) == 0 );
+    CU_ASSERT_TRUE( pthread_join(producer, &result) == 0 );
+    CU_ASSERT_TRUE( result == NULL );
+    CU_ASSERT_TRUE( pthread_join(consumer, &result) == 0 );
+    CU_ASSERT_TRUE( result == NULL );
+    CU_ASSERT_TRUE( ringqueue_isEmpty(queue) == TRUE );
+    ringqueue_destroy(queue, NULL);
+
+    CU_PASS("testSpscThreads() - Test Passed");
+}
+
+static void testMpmcThreads() {
+
+    RingQueue *queue;
+    pthread_t producers[THREADS], consumers[THREADS];
+    void *result;
+    long sum = 0L;
+    int i;
+
+    if (ringqueue_newMpmc(&queue, 64L) != OK)
+        CU_FAIL_FATAL("ERROR: testMpmcThreads() - allocation failure");
+
+    // Every item added by any producer must be polled by exactly one consumer
+    for (i = 0; i < THREADS; i++) {
+        CU_ASSERT_TRUE( pthread_create(&consumers[i], NULL, _consume, queue) == 0 );
+        CU_ASSERT_TRUE( pthread_create(&producers[i], NULL, _produce, queue) == 0 );
+    }
+    for (i = 0; i < THREADS; i++) {
+        CU_ASSERT_TRUE( pthread_join(producers[i], &result) == 0 );
+        CU_ASSERT_TRUE( result == NULL );
+    }
+    for (i = 0; i < THREADS; i++) {
+        CU_ASSERT_TRUE( pthread_join(consumers[i], &result) == 0 );
+        sum += (long)result;
+    }
+    CU_ASSERT_EQUAL( sum, THREADS * (PER_THREAD * (PER_THREAD + 1L) / 2L) );
+    CU_ASSERT_TRUE( ringqueue_isEmpty(queue) == TRUE );
+    ringqueue_destroy(queue, NULL);
+
+    CU_PASS("testMpmcThreads() - Test Passed");
+}
+
+#define UNUSED __attribute__((unused))
+int main(UNUSED int argc, UNUSED char **argv) {
+
+    if (CU_initialize_registry() != CUE_SUCCESS) {
+        return CU_get_error();
+    }
+
+    CU_pSuite suite = CU_add_suite("RingQueue Tests", NULL, NULL);
+    if (suite == NULL) {
+        CU_cleanup_registry();
+        return CU_get_error();
+    }
+
+    CU_add_test(suite, "RingQueue - Add & Poll", testRingQueue);
+    CU_add_test(suite, "RingQueue - SPSC Threads", testSpscThreads);
+    CU_add_test(suite, "RingQueue - MPMC Threads", testMpmcThreads);
+
+    CU_basic_set_mode(CU_BRM_VERBOSE);
+    CU_basic_run_tests();
+    CU_cleanup_registry();
+
+    return 0;
+}
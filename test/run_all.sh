@@ -1,5 +1,7 @@
 #!/bin/bash
+./array_deque_tests
 ./array_list_tests
+./bloom_filter_tests
 ./bounded_queue_tests
 ./bounded_stack_tests
 ./circular_list_tests
@@ -8,8 +10,17 @@
 ./heap_tests
 ./iterator_tests
 ./linked_list_tests
+./lru_cache_tests
+./merge_iterator_tests
+./node_pool_tests
 ./queue_tests
+./radix_tree_tests
+./ring_queue_tests
+./skip_list_map_tests
 ./stack_tests
+./string_builder_tests
+./timer_wheel_tests
 ./tree_map_tests
 ./tree_set_tests
-
+./typed_containers_tests
+./work_deque_tests
@@ -0,0 +1,260 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2020 Cole Vikupitz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <pthread.h>
+#include <CUnit/Basic.h>
+#include "skip_list_map.h"
+
+/* Sizes and counts used for testing */
+#define THREADS 4
+#define KEYS 50000L
+
+/* Keys are stored directly in the pointers */
+#define K(x) ((void *)(long)(x))
+
+static int longCmp(void *a, void *b) {
+    return ( (long)a < (long)b ) ? -1 : ( (long)a > (long)b ) ? 1 : 0;
+}
+
+/* Counts the keys handed to the key destructor */
+static long destroyed = 0L;
+static void countKey(void *key) {
+    (void)key;
+    __atomic_fetch_add(&destroyed, 1L, __ATOMIC_RELAXED);
+}
+
+static void testNavigation() {
+
+    ConcurrentSkipListMap *map;
+    void *key, *value;
+    long i;
+
+    Status stat = skiplistmap_new(&map, longCmp, NULL);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testNavigation() - allocation failure");
+
+    CU_ASSERT_TRUE( skiplistmap_isEmpty(map) == TRUE );
+    CU_ASSERT_TRUE( skiplistmap_firstKey(map, &key) == STRUCT_EMPTY );
+    CU_ASSERT_TRUE( skiplistmap_lastKey(map, &key) == STRUCT_EMPTY );
+    CU_ASSERT_TRUE( skiplistmap_floorKey(map, K(5), &key) == NOT_FOUND );
+    CU_ASSERT_TRUE( skiplistmap_pollFirst(map, &key, &value) == STRUCT_EMPTY );
+
+    // Inserts the even keys from 2 to 200, out of order
+    for (i = 100L; i >= 1L; i -= 2L)
+        CU_ASSERT_TRUE( skiplistmap_put(map, K(2L * i), K(i), &value) == INSERTED );
+    for (i = 1L; i <= 100L; i += 2L)
+        CU_ASSERT_TRUE( skiplistmap_put(map, K(2L * i), K(i), &value) == INSERTED );
+    CU_ASSERT_EQUAL( skiplistmap_size(map), 100L );
+    CU_ASSERT_TRUE( skiplistmap_put(map, K(10), K(-5), &value) == REPLACED );
+    CU_ASSERT_TRUE( value == K(5) );
+    CU_ASSERT_EQUAL( skiplistmap_size(map), 100L );
+
+    CU_ASSERT_TRUE( skiplistmap_get(map, K(10), &value) == OK );
+    CU_ASSERT_TRUE( value == K(-5) );
+    CU_ASSERT_TRUE( skiplistmap_get(map, K(11), &value) == NOT_FOUND );
+    CU_ASSERT_TRUE( skiplistmap_containsKey(map, K(200)) == TRUE );
+    CU_ASSERT_TRUE( skiplistmap_containsKey(map, K(201)) == FALSE );
+
+    CU_ASSERT_TRUE( skiplistmap_firstKey(map, &key) == OK );
+    CU_ASSERT_TRUE( key == K(2) );
+    CU_ASSERT_TRUE( skiplistmap_last(map, &key, &value) == OK );
+    CU_ASSERT_TRUE( key == K(200) && value == K(100) );
+
+    CU_ASSERT_TRUE( skiplistmap_floorKey(map, K(11), &key) == OK );
+    CU_ASSERT_TRUE( key == K(10) );
+    CU_ASSERT_TRUE( skiplistmap_floor(map, K(12), &key, &value) == OK );
+    CU_ASSERT_TRUE( key == K(12) && value == K(6) );
+    CU_ASSERT_TRUE( skiplistmap_floorKey(map, K(1), &key) == NOT_FOUND );
+    CU_ASSERT_TRUE( skiplistmap_ceilingKey(map, K(11), &key) == OK );
+    CU_ASSERT_TRUE( key == K(12) );
+    CU_ASSERT_TRUE( skiplistmap_ceilingKey(map, K(12), &key) == OK );
+    CU_ASSERT_TRUE( key == K(12) );
+    CU_ASSERT_TRUE( skiplistmap_ceilingKey(map, K(201), &key) == NOT_FOUND );
+    CU_ASSERT_TRUE( skiplistmap_lowerKey(map, K(12), &key) == OK );
+    CU_ASSERT_TRUE( key == K(10) );
+    CU_ASSERT_TRUE( skiplistmap_lowerKey(map, K(2), &key) == NOT_FOUND );
+    CU_ASSERT_TRUE( skiplistmap_higherKey(map, K(12), &key) == OK );
+    CU_ASSERT_TRUE( key == K(14) );
+    CU_ASSERT_TRUE( skiplistmap_higher(map, K(13), &key, &value) == OK );
+    CU_ASSERT_TRUE( key == K(14) && value == K(7) );
+    CU_ASSERT_TRUE( skiplistmap_higherKey(map, K(200), &key) == NOT_FOUND );
+
+    // Removed keys are skipped by the navigation
+    CU_ASSERT_TRUE( skiplistmap_remove(map, K(12), &value) == OK );
+    CU_ASSERT_TRUE( value == K(6) );
+    CU_ASSERT_TRUE( skiplistmap_remove(map, K(12), &value) == NOT_FOUND );
+    CU_ASSERT_TRUE( skiplistmap_floorKey(map, K(13), &key) == OK );
+    CU_ASSERT_TRUE( key == K(10) );
+    CU_ASSERT_TRUE( skiplistmap_ceilingKey(map, K(11), &key) == OK );
+    CU_ASSERT_TRUE( key == K(14) );
+
+    // Polls from both ends in order
+    CU_ASSERT_TRUE( skiplistmap_pollFirst(map, &key, &value) == OK );
+    CU_ASSERT_TRUE( key == K(2) && value == K(1) );
+    CU_ASSERT_TRUE( skiplistmap_pollLast(map, &key, &value) == OK );
+    CU_ASSERT_TRUE( key == K(200) && value == K(100) );
+    CU_ASSERT_TRUE( skiplistmap_firstKey(map, &key) == OK );
+    CU_ASSERT_TRUE( key == K(4) );
+    CU_ASSERT_EQUAL( skiplistmap_size(map), 97L );
+
+    skiplistmap_destroy(map, NULL);
+
+    CU_PASS("testNavigation() - Test Passed");
+}
+
+static void testKeyDestructor() {
+
+    ConcurrentSkipListMap *map;
+    void *key, *value;
+    long i;
+
+    Status stat = skiplistmap_new(&map, longCmp, countKey);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testKeyDestructor() - allocation failure");
+
+    destroyed = 0L;
+    for (i = 0L; i < 10L; i++)
+        CU_ASSERT_TRUE( skiplistmap_put(map, K(i), K(i), &value) == INSERTED );
+
+    // Polled keys go to the caller, removed ones to the destructor once reclaimed
+    CU_ASSERT_TRUE( skiplistmap_pollFirst(map, &key, &value) == OK );
+    CU_ASSERT_TRUE( skiplistmap_remove(map, K(5), &value) == OK );
+    skiplistmap_destroy(map, NULL);
+    CU_ASSERT_TRUE( destroyed >= 8L && destroyed <= 9L );
+
+    CU_PASS("testKeyDestructor() - Test Passed");
+}
+
+/* State shared between the writer threads */
+static ConcurrentSkipListMap *shared;
+static long polled[KEYS];
+
+/**
+ * Writer thread, inserts every THREADS-th key from its offset, then removes every other one.
+ */
+static void *_write(void *arg) {
+
+    long offset = (long)arg, i;
+    void *value;
+
+    for (i = offset; i < KEYS; i += THREADS)
+        skiplistmap_put(shared, K(i), K(i), &value);
+    for (i = offset; i < KEYS; i += 2L * THREADS)
+        skiplistmap_remove(shared, K(i), &value);
+
+    return NULL;
+}
+
+/**
+ * Poller thread, polls the first entry until the map is empty, checking that keys come in order.
+ */
+static void *_poll(void *arg) {
+
+    void *key, *value;
+    long last = -1L;
+
+    while (skiplistmap_pollFirst(shared, &key, &value) == OK) {
+        if ((long)key <= last)
+            __atomic_store_n((long *)arg, 1L, __ATOMIC_RELAXED);
+        last = (long)key;
+        __atomic_fetch_add(&(polled[(long)key]), 1L, __ATOMIC_RELAXED);
+    }
+
+    return NULL;
+}
+
+static void testConcurrentWrites() {
+
+    pthread_t threads[THREADS];
+    void *key, *prev;
+    long i, count = 0L, disorder = 0L, missed = 0L;
+    int j;
+
+    if (skiplistmap_new(&shared, longCmp, NULL) != OK)
+        CU_FAIL_FATAL("ERROR: testConcurrentWrites() - allocation failure");
+
+    // Writers insert interleaved keys, so they contend on neighbouring nodes
+    for (j = 0; j < THREADS; j++)
+        CU_ASSERT_TRUE( pthread_create(&threads[j], NULL, _write, K(j)) == 0 );
+    for (j = 0; j < THREADS; j++)
+        CU_ASSERT_TRUE( pthread_join(threads[j], NULL) == 0 );
+
+    // Exactly the keys whose quotient by THREADS is odd remain, in order
+    CU_ASSERT_EQUAL( skiplistmap_size(shared), KEYS / 2L );
+    for (i = 0L; i < KEYS; i++) {
+        if (skiplistmap_containsKey(shared, K(i)) != (((i / THREADS) % 2L == 1L) ? TRUE : FALSE))
+            missed++;
+    }
+    CU_ASSERT_EQUAL( missed, 0L );
+    prev = K(-1);
+    while (skiplistmap_higherKey(shared, prev, &key) == OK) {
+        count++;
+        prev = key;
+    }
+    CU_ASSERT_EQUAL( count, KEYS / 2L );
+
+    // Pollers drain the map, each seeing increasing keys and every key taken exactly once
+    for (i = 0L; i < KEYS; i++)
+        polled[i] = 0L;
+    for (j = 0; j < THREADS; j++)
+        CU_ASSERT_TRUE( pthread_create(&threads[j], NULL, _poll, &disorder) == 0 );
+    for (j = 0; j < THREADS; j++)
+        CU_ASSERT_TRUE( pthread_join(threads[j], NULL) == 0 );
+    CU_ASSERT_EQUAL( disorder, 0L );
+    missed = 0L;
+    for (i = 0L; i < KEYS; i++) {
+        if (polled[i] != (((i / THREADS) % 2L == 1L) ? 1L : 0L))
+            missed++;
+    }
+    CU_ASSERT_EQUAL( missed, 0L );
+    CU_ASSERT_TRUE( skiplistmap_isEmpty(shared) == TRUE );
+    skiplistmap_destroy(shared, NULL);
+
+    CU_PASS("testConcurrentWrites() - Test Passed");
+}
+
+#define UNUSED __attribute__((unused))
+int main(UNUSED int argc, UNUSED char **argv) {
+
+    if (CU_initialize_registry() != CUE_SUCCESS) {
+        return CU_get_error();
+    }
+
+    CU_pSuite suite = CU_add_suite("ConcurrentSkipListMap Tests", NULL, NULL);
+    if (suite == NULL) {
+        CU_cleanup_registry();
+        return CU_get_error();
+    }
+
+    CU_add_test(suite, "ConcurrentSkipListMap - Navigation", testNavigation);
+    CU_add_test(suite, "ConcurrentSkipListMap - Key Destructor", testKeyDestructor);
+    CU_add_test(suite, "ConcurrentSkipListMap - Concurrent Writes", testConcurrentWrites);
+
+    CU_basic_set_mode(CU_BRM_VERBOSE);
+    CU_basic_run_tests();
+    CU_cleanup_registry();
+
+    return 0;
+}
@@ -23,8 +23,11 @@
  */
 
 #include <stdlib.h>
+#include <pthread.h>
 #include <CUnit/Basic.h>
 #include "stack.h"
+#include "ts_stack.h"
+#include "lf_stack.h"
 
 /* Single item used for testing */
 static char *singleItem = "Test";
@@ -193,6 +196,204 @@ static void testStackClear() {
     CU_PASS("testStackClear() - Test Passed");
 }
 
+static void testStackCursor() {
+
+    Iterator *iter;
+    Cursor cursor;
+    Stack *stack;
+    Status stat;
+    int i;
+    char *item, *other;
+
+    stat = stack_new(&stack);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testStackCursor() - allocation failure");
+
+    stack_cursor(stack, &cursor);
+    CU_ASSERT_TRUE( cursor_hasNext(&cursor) == FALSE );
+    CU_ASSERT_TRUE( stack_cursorNext(&cursor, (void **)&item) == ITER_END );
+
+    for (i = 0; i < LEN; i++)
+        CU_ASSERT_TRUE( stack_push(stack, array[i]) == OK );
+    CU_ASSERT_TRUE( stack_iterator(stack, &iter) == OK );
+
+    // The cursor must visit the same items in the same order as the iterator
+    i = 0;
+    stack_cursor(stack, &cursor);
+    while (cursor_hasNext(&cursor) == TRUE) {
+        CU_ASSERT_TRUE( stack_cursorNext(&cursor, (void **)&item) == OK );
+        CU_ASSERT_TRUE( iterator_next(iter, (void **)&other) == OK );
+        CU_ASSERT_TRUE( item == other );
+        i++;
+    }
+    CU_ASSERT_EQUAL( i, LEN );
+    CU_ASSERT_TRUE( stack_cursorNext(&cursor, (void **)&item) == ITER_END );
+    iterator_destroy(iter);
+
+    // A structural change invalidates any cursor already in progress
+    stack_cursor(stack, &cursor);
+    CU_ASSERT_TRUE( stack_cursorNext(&cursor, (void **)&item) == OK );
+    CU_ASSERT_TRUE( stack_pop(stack, (void **)&item) == OK );
+    CU_ASSERT_TRUE( stack_cursorNext(&cursor, (void **)&item) == CONCURRENT_MODIFICATION );
+    stack_destroy(stack, NULL);
+
+    CU_PASS("testStackCursor() - Test Passed");
+}
+
+#define THREADS 4
+#define PER_THREAD 50000L
+
+/**
+ * Worker thread, alternates pushes and pops and returns the sum of the values it popped.
+ */
+static void *_pushPop(void *arg) {
+
+    LockFreeStack *stack = (LockFreeStack *)arg;
+    void *top;
+    long i, sum = 0L;
+
+    for (i = 1L; i <= PER_THREAD; i++) {
+        if (lf_stack_push(stack, (void *)i) != OK)
+            return (void *)-1L;
+        if (lf_stack_pop(stack, &top) == OK)
+            sum += (long)top;
+    }
+
+    return (void *)sum;
+}
+
+static void testLockFreeStack() {
+
+    LockFreeStack *stack;
+    pthread_t threads[THREADS];
+    void *item, *result;
+    long sum = 0L;
+    int i;
+
+    Status stat = lf_stack_new(&stack);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testLockFreeStack() - allocation failure");
+
+    // Behaves like a stack on a single thread
+    CU_ASSERT_TRUE( lf_stack_isEmpty(stack) == TRUE );
+    CU_ASSERT_TRUE( lf_stack_pop(stack, &item) == STRUCT_EMPTY );
+    CU_ASSERT_TRUE( lf_stack_peek(stack, &item) == STRUCT_EMPTY );
+    for (i = 0; i < LEN; i++)
+        CU_ASSERT_TRUE( lf_stack_push(stack, array[i]) == OK );
+    CU_ASSERT_TRUE( lf_stack_isEmpty(stack) == FALSE );
+    CU_ASSERT_TRUE( lf_stack_peek(stack, &item) == OK );
+    CU_ASSERT_TRUE( item == array[LEN - 1] );
+    for (i = LEN - 1; i >= 0; i--) {
+        CU_ASSERT_TRUE( lf_stack_pop(stack, &item) == OK );
+        CU_ASSERT_TRUE( item == array[i] );
+    }
+    CU_ASSERT_TRUE( lf_stack_isEmpty(stack) == TRUE );
+
+    // Every value pushed by any thread must be popped exactly once
+    for (i = 0; i < THREADS; i++)
+        CU_ASSERT_TRUE( pthread_create(&threads[i], NULL, _pushPop, stack) == 0 );
+    for (i = 0; i < THREADS; i++) {
+        CU_ASSERT_TRUE( pthread_join(threads[i], &result) == 0 );
+        sum += (long)result;
+    }
+    while (lf_stack_pop(stack, &item) == OK)
+        sum += (long)item;
+    CU_ASSERT_EQUAL( sum, THREADS * (PER_THREAD * (PER_THREAD + 1L) / 2L) );
+
+    // Items left on the stack are handed to the destructor
+    CU_ASSERT_TRUE( lf_stack_push(stack, malloc(8)) == OK );
+    CU_ASSERT_TRUE( lf_stack_push(stack, malloc(8)) == OK );
+    lf_stack_destroy(stack, free);
+
+    CU_PASS("testLockFreeStack() - Test Passed");
+}
+
+#define BATCH 100L
+
+/**
+ * Thread that pushes batches of BATCH values and pops half a batch back, returning what it popped.
+ */
+static void *_pushPopBatches(void *arg) {
+
+    ConcurrentStack *stack = (ConcurrentStack *)arg;
+    void *items[BATCH];
+    long i, j, n, sum = 0L;
+
+    for (i = 1L; i <= PER_THREAD; i += BATCH) {
+        for (j = 0L; j < BATCH; j++)
+            items[j] = (void *)(i + j);
+        if (ts_stack_pushAll(stack, items, BATCH) != OK)
+            return (void *)-1L;
+        n = ts_stack_popMany(stack, items, BATCH / 2L);
+        for (j = 0L; j < n; j++)
+            sum += (long)items[j];
+    }
+
+    return (void *)sum;
+}
+
+static void testBatchedStack() {
+
+    ConcurrentStack *shared;
+    pthread_t threads[THREADS];
+    Stack *stack;
+    void *items[1000], *item, *result;
+    long i, n, sum = 0L;
+
+    Status stat = stack_new(&stack);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testBatchedStack() - allocation failure");
+
+    CU_ASSERT_TRUE( stack_pushAll(stack, items, -1L) == INVALID_INDEX );
+    CU_ASSERT_TRUE( stack_pushAll(stack, items, 0L) == OK );
+    CU_ASSERT_TRUE( stack_popMany(stack, items, 10L) == 0L );
+
+    // The last item of a batch ends up on top, as if pushed one at a time
+    CU_ASSERT_TRUE( stack_pushAll(stack, (void **)array, LEN) == OK );
+    CU_ASSERT_EQUAL( stack_size(stack), LEN );
+    CU_ASSERT_TRUE( stack_peek(stack, &item) == OK );
+    CU_ASSERT_TRUE( item == array[LEN - 1] );
+    CU_ASSERT_TRUE( stack_push(stack, array[0]) == OK );
+    CU_ASSERT_EQUAL( stack_popMany(stack, items, 3L), 3L );
+    CU_ASSERT_TRUE( items[0] == array[0] );
+    CU_ASSERT_TRUE( items[1] == array[LEN - 1] );
+    CU_ASSERT_TRUE( items[2] == array[LEN - 2] );
+    CU_ASSERT_EQUAL( stack_popMany(stack, items, 1000L), LEN - 2 );
+    for (i = 0L; i < LEN - 2; i++)
+        CU_ASSERT_TRUE( items[i] == array[LEN - 3 - i] );
+    CU_ASSERT_TRUE( stack_isEmpty(stack) == TRUE );
+
+    // Large batches pop back in reverse order
+    for (i = 0L; i < 1000L; i++)
+        items[i] = (void *)i;
+    CU_ASSERT_TRUE( stack_pushAll(stack, items, 1000L) == OK );
+    for (n = 999L; n >= 0L; ) {
+        long popped = stack_popMany(stack, items, 77L);
+        for (i = 0L; i < popped; i++)
+            CU_ASSERT_EQUAL( (long)items[i], n - i );
+        n -= popped;
+    }
+    CU_ASSERT_TRUE( stack_isEmpty(stack) == TRUE );
+    stack_destroy(stack, NULL);
+
+    // Every value pushed by any thread must be popped exactly once
+    CU_ASSERT_TRUE( ts_stack_new(&shared) == OK );
+    for (i = 0L; i < THREADS; i++)
+        CU_ASSERT_TRUE( pthread_create(&threads[i], NULL, _pushPopBatches, shared) == 0 );
+    for (i = 0L; i < THREADS; i++) {
+        CU_ASSERT_TRUE( pthread_join(threads[i], &result) == 0 );
+        sum += (long)result;
+    }
+    while ((n = ts_stack_popMany(shared, items, 1000L)) > 0L) {
+        for (i = 0L; i < n; i++)
+            sum += (long)items[i];
+    }
+    CU_ASSERT_EQUAL( sum, THREADS * (PER_THREAD * (PER_THREAD + 1L) / 2L) );
+    ts_stack_destroy(shared, NULL);
+
+    CU_PASS("testBatchedStack() - Test Passed");
+}
+
 #define UNUSED __attribute__((unused))
 int main(UNUSED int argc, UNUSED char **argv) {
 
@@ -211,7 +412,10 @@ int main(UNUSED int argc, UNUSED char **argv) {
     CU_add_test(suite, "Stack - Push & Pop", testPushPop);
     CU_add_test(suite, "Stack - Array", testStackToArray);
     CU_add_test(suite, "Stack - Iterator", testStackIterator);
+    CU_add_test(suite, "Stack - Cursor", testStackCursor);
     CU_add_test(suite, "Stack - Clear", testStackClear);
+    CU_add_test(suite, "Stack - Lock-Free Stack", testLockFreeStack);
+    CU_add_test(suite, "Stack - Batched Operations", testBatchedStack);
 
     CU_basic_set_mode(CU_BRM_VERBOSE);
     CU_basic_run_tests();
@@ -19,7 +19,11 @@
  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 
+#include <limits.h>
+#include <stdio.h>
 #include <stdlib.h>
+#include <unistd.h>
+#include <sys/stat.h>
 #include <CUnit/Basic.h>
 #include "string_builder.h"
 
@@ -267,6 +271,386 @@ VALIDATE_INDEX_RANGE(start, end, max) \
     string_builder_destroy(builder);
 }
 
+static void _test_append_bytes() {
+
+    StringBuilder *builder;
+    Status status;
+    char *temp;
+
+    status = string_builder_new(&builder, 4L, DEFAULT_GROWTH_FACTOR, NULL);
+    CU_ASSERT_EQUAL( status, OK );
+
+    // Only the given number of characters are copied, terminator or not
+    CU_ASSERT_EQUAL( string_builder_appendBytes(builder, "Hello, World!", 5), OK );
+    CU_ASSERT_EQUAL( string_builder_appendBytes(builder, "!", 0), OK );
+    CU_ASSERT_EQUAL( string_builder_appendBytes(builder, "!", -1), INVALID_INDEX );
+    CU_ASSERT_EQUAL( string_builder_insertBytes(builder, 0, ">> ", 3), OK );
+    CU_ASSERT_EQUAL( string_builder_insertBytes(builder, 9, "x", 1), INVALID_INDEX );
+    CU_ASSERT_EQUAL( string_builder_insertBytes(builder, 8, "!?", 1), OK );
+    CU_ASSERT_EQUAL( string_builder_length(builder), 9 );
+    CU_ASSERT_EQUAL( string_builder_toString(builder, &temp), OK );
+    CU_ASSERT_EQUAL( strcmp(">> Hello!", temp), 0 );
+    free(temp);
+
+    // A builder may be appended and inserted into itself
+    CU_ASSERT_EQUAL( string_builder_appendStrBuilder(builder, builder), OK );
+    CU_ASSERT_EQUAL( string_builder_insertStrBuilder(builder, 3, builder), OK );
+    CU_ASSERT_EQUAL( string_builder_length(builder), 36 );
+    CU_ASSERT_EQUAL( string_builder_toString(builder, &temp), OK );
+    CU_ASSERT_EQUAL( strcmp(">> >> Hello!>> Hello!Hello!>> Hello!", temp), 0 );
+    free(temp);
+
+    // Full words are reversed eight characters at a time, the middle one by one
+    string_builder_reverse(builder);
+    CU_ASSERT_EQUAL( string_builder_toString(builder, &temp), OK );
+    CU_ASSERT_EQUAL( strcmp("!olleH >>!olleH!olleH >>!olleH >> >>", temp), 0 );
+    free(temp);
+
+    // Shrinking keeps the capacity, growing pads the new characters
+    CU_ASSERT_EQUAL( string_builder_setLength(builder, 6, '-'), OK );
+    CU_ASSERT_EQUAL( string_builder_capacity(builder) >= 36, TRUE );
+    CU_ASSERT_EQUAL( string_builder_setLength(builder, 10, '-'), OK );
+    CU_ASSERT_EQUAL( string_builder_replace(builder, 0, 2, "ab"), OK );
+    CU_ASSERT_EQUAL( string_builder_delete(builder, 6, 8), OK );
+    CU_ASSERT_EQUAL( string_builder_toString(builder, &temp), OK );
+    CU_ASSERT_EQUAL( strcmp("ablleH--", temp), 0 );
+    free(temp);
+    string_builder_destroy(builder);
+}
+
+static void _test_append_numbers() {
+
+    StringBuilder *builder;
+    Status status;
+    char expected[512];
+    char *temp;
+
+    status = string_builder_new(&builder, 4L, DEFAULT_GROWTH_FACTOR, NULL);
+    CU_ASSERT_EQUAL( status, OK );
+
+    // Integers are formatted in place, including the extremes of their range
+    CU_ASSERT_EQUAL( string_builder_appendLong(builder, LONG_MIN), OK );
+    CU_ASSERT_EQUAL( string_builder_appendChar(builder, ' '), OK );
+    CU_ASSERT_EQUAL( string_builder_appendLong(builder, LONG_MAX), OK );
+    CU_ASSERT_EQUAL( string_builder_appendChar(builder, ' '), OK );
+    CU_ASSERT_EQUAL( string_builder_appendInt(builder, -40), OK );
+    CU_ASSERT_EQUAL( string_builder_appendShort(builder, 0), OK );
+    CU_ASSERT_EQUAL( string_builder_insertInt(builder, 0, 7), OK );
+    sprintf(expected, "7%ld %ld -400", LONG_MIN, LONG_MAX);
+    CU_ASSERT_EQUAL( string_builder_toString(builder, &temp), OK );
+    CU_ASSERT_EQUAL( strcmp(expected, temp), 0 );
+    free(temp);
+    string_builder_destroy(builder);
+
+    status = string_builder_new(&builder, 4L, DEFAULT_GROWTH_FACTOR, NULL);
+    CU_ASSERT_EQUAL( status, OK );
+
+    // Decimals keep the six rounded digits of "%f", ties going to even
+    CU_ASSERT_EQUAL( string_builder_appendDouble(builder, 0.0078125), OK );
+    CU_ASSERT_EQUAL( string_builder_appendChar(builder, ' '), OK );
+    CU_ASSERT_EQUAL( string_builder_appendDouble(builder, -0.0), OK );
+    CU_ASSERT_EQUAL( string_builder_appendChar(builder, ' '), OK );
+    CU_ASSERT_EQUAL( string_builder_appendFloat(builder, -2.5f), OK );
+    CU_ASSERT_EQUAL( string_builder_appendChar(builder, ' '), OK );
+    CU_ASSERT_EQUAL( string_builder_appendDouble(builder, 1e300), OK );
+    sprintf(expected, "0.007812 -0.000000 -2.500000 %f", 1e300);
+    CU_ASSERT_EQUAL( string_builder_toString(builder, &temp), OK );
+    CU_ASSERT_EQUAL( strcmp(expected, temp), 0 );
+    free(temp);
+    string_builder_destroy(builder);
+}
+
+static void _test_rope() {
+
+    StringBuilder *builder;
+    StringBuilder *flat;
+    Status status;
+    char *temp;
+    char ch;
+    long i;
+
+    status = string_builder_newRope(&builder, "Hello, World!");
+    CU_ASSERT_EQUAL( status, OK );
+    CU_ASSERT_EQUAL( string_builder_length(builder), 13 );
+
+    // Grows the builder over many chunks, editing near the front as it goes
+    for (i = 0; i < 5000; i++) {
+        CU_ASSERT_EQUAL( string_builder_appendStr(builder, "abcdefghij"), OK );
+        CU_ASSERT_EQUAL( string_builder_insertChar(builder, 7, '#'), OK );
+        CU_ASSERT_EQUAL( string_builder_deleteCharAt(builder, 7), OK );
+    }
+    CU_ASSERT_EQUAL( string_builder_length(builder), 50013 );
+    CU_ASSERT_EQUAL( string_builder_charAt(builder, 50012, &ch), OK );
+    CU_ASSERT_EQUAL( ch, 'j' );
+    CU_ASSERT_EQUAL( string_builder_indexOf(builder, "jabc"), 22 );
+    CU_ASSERT_EQUAL( string_builder_lastIndexOf(builder, "jabc"), 50002 );
+    CU_ASSERT_EQUAL( string_builder_indexOf(builder, "jj"), -1 );
+
+    // Removes a range spanning many chunks, then edits across the seam
+    CU_ASSERT_EQUAL( string_builder_delete(builder, 5, 50000), OK );
+    CU_ASSERT_EQUAL( string_builder_replace(builder, 3, 5, "p!"), OK );
+    CU_ASSERT_EQUAL( string_builder_insertInt(builder, 5, -42), OK );
+    CU_ASSERT_EQUAL( string_builder_setCharAt(builder, 0, 'J'), OK );
+    CU_ASSERT_EQUAL( string_builder_toString(builder, &temp), OK );
+    CU_ASSERT_EQUAL( strcmp("Jelp!-42hijabcdefghij", temp), 0 );
+    free(temp);
+
+    CU_ASSERT_EQUAL( string_builder_subsequence(builder, 3, 8, &temp), OK );
+    CU_ASSERT_EQUAL( strcmp("p!-42", temp), 0 );
+    free(temp);
+    CU_ASSERT_EQUAL( string_builder_new(&flat, DEFAULT_CAPACITY, DEFAULT_GROWTH_FACTOR, NULL), OK );
+    CU_ASSERT_EQUAL( string_builder_appendStrBuilder(flat, builder), OK );
+    CU_ASSERT_EQUAL( string_builder_compareTo(flat, builder), 0 );
+    string_builder_reverse(builder);
+    CU_ASSERT_EQUAL( string_builder_compareTo(flat, builder) < 0, TRUE );
+    string_builder_destroy(flat);
+
+    // The builder may be emptied and used again
+    string_builder_clear(builder);
+    CU_ASSERT_EQUAL( string_builder_length(builder), 0 );
+    CU_ASSERT_EQUAL( string_builder_setLength(builder, 3, '-'), OK );
+    CU_ASSERT_EQUAL( string_builder_toString(builder, &temp), OK );
+    CU_ASSERT_EQUAL( strcmp("---", temp), 0 );
+    free(temp);
+    string_builder_destroy(builder);
+}
+
+static void _test_data_detach() {
+
+    StringBuilder *builder;
+    struct iovec segments[4];
+    const char *data;
+    char *temp;
+    long len, i, total;
+
+    CU_ASSERT_EQUAL( string_builder_new(&builder, 64L, DEFAULT_GROWTH_FACTOR, "Hello"), OK );
+    data = string_builder_data(builder, &len);
+    CU_ASSERT_EQUAL( len, 5 );
+    CU_ASSERT_EQUAL( strcmp("Hello", data), 0 );
+    CU_ASSERT_EQUAL( string_builder_segments(builder, segments, 4), 1 );
+    CU_ASSERT_EQUAL( segments[0].iov_base, data );
+    CU_ASSERT_EQUAL( segments[0].iov_len, 5 );
+
+    // The buffer itself is handed over, leaving an empty builder to reuse
+    CU_ASSERT_EQUAL( string_builder_detach(builder, &temp), OK );
+    CU_ASSERT_EQUAL( temp, data );
+    CU_ASSERT_EQUAL( strcmp("Hello", temp), 0 );
+    CU_ASSERT_EQUAL( string_builder_length(builder), 0 );
+    CU_ASSERT_EQUAL( string_builder_segments(builder, segments, 4), 0 );
+    CU_ASSERT_EQUAL( string_builder_appendStr(builder, "World"), OK );
+    free(temp);
+    CU_ASSERT_EQUAL( string_builder_toString(builder, &temp), OK );
+    CU_ASSERT_EQUAL( strcmp("World", temp), 0 );
+    free(temp);
+    string_builder_destroy(builder);
+
+    // A rope exports one segment per chunk, only counting those that don't fit
+    CU_ASSERT_EQUAL( string_builder_newRope(&builder, NULL), OK );
+    CU_ASSERT_EQUAL( string_builder_setLength(builder, 3000, 'r'), OK );
+    CU_ASSERT_EQUAL( string_builder_data(builder, &len), NULL );
+    CU_ASSERT_EQUAL( len, 3000 );
+    CU_ASSERT_EQUAL( string_builder_segments(builder, NULL, 0) > 4, TRUE );
+    CU_ASSERT_EQUAL( string_builder_trimToSize(builder), OK );
+    CU_ASSERT_EQUAL( string_builder_segments(builder, segments, 4), 6 );
+    for (i = 0, total = 0; i < 4; i++) {
+        total += segments[i].iov_len;
+    }
+    CU_ASSERT_EQUAL( total, 4 * 512 );
+    CU_ASSERT_EQUAL( string_builder_detach(builder, &temp), OK );
+    CU_ASSERT_EQUAL( strlen(temp), 3000 );
+    CU_ASSERT_EQUAL( string_builder_length(builder), 0 );
+    free(temp);
+    string_builder_destroy(builder);
+}
+
+static void _test_file_io() {
+
+    StringBuilder *builder;
+    StringBuilder *mapped;
+    StringBuilder *rope;
+    Status status;
+    struct stat info;
+    char *temp;
+    long size;
+    FILE *file;
+
+    CU_ASSERT_EQUAL( stat("great-expectations.txt", &info), 0 );
+    size = (long)info.st_size;
+
+    // The whole file is read into a buffer sized once, with room for the end of file check
+    status = string_builder_new(&builder, DEFAULT_CAPACITY, DEFAULT_GROWTH_FACTOR, NULL);
+    CU_ASSERT_EQUAL( status, OK );
+    CU_ASSERT_EQUAL( string_builder_appendFile(builder, "great-expectations.txt"), OK );
+    CU_ASSERT_EQUAL( string_builder_length(builder), size );
+    CU_ASSERT_EQUAL( string_builder_capacity(builder), size + 1 );
+    CU_ASSERT_EQUAL( string_builder_appendFile(builder, "missing-file.txt"), IO_FAILURE );
+
+    CU_ASSERT_EQUAL( string_builder_newMapped(&mapped, "great-expectations.txt"), OK );
+    CU_ASSERT_EQUAL( string_builder_newRope(&rope, NULL), OK );
+    CU_ASSERT_EQUAL( string_builder_appendFile(rope, "great-expectations.txt"), OK );
+    CU_ASSERT_EQUAL( string_builder_length(mapped), size );
+    CU_ASSERT_EQUAL( string_builder_compareTo(builder, mapped), 0 );
+    CU_ASSERT_EQUAL( string_builder_compareTo(builder, rope), 0 );
+    CU_ASSERT_EQUAL( string_builder_lastIndexOf(mapped, "Pip"),
+                     string_builder_lastIndexOf(builder, "Pip") );
+
+    // Growing a mapped builder moves it over to the heap, leaving the file alone
+    CU_ASSERT_EQUAL( string_builder_appendStr(mapped, "THE END"), OK );
+    CU_ASSERT_EQUAL( string_builder_length(mapped), size + 7 );
+    CU_ASSERT_EQUAL( string_builder_lastIndexOf(mapped, "THE END"), size );
+    string_builder_destroy(mapped);
+
+    // Writes out the rope, then reads back only the start of it
+    file = tmpfile();
+    CU_ASSERT_TRUE( file != NULL );
+    CU_ASSERT_EQUAL( string_builder_writeTo(rope, fileno(file)), OK );
+    CU_ASSERT_EQUAL( lseek(fileno(file), 0, SEEK_END), size );
+    CU_ASSERT_EQUAL( lseek(fileno(file), 0, SEEK_SET), 0 );
+    string_builder_clear(builder);
+    CU_ASSERT_EQUAL( string_builder_appendFromFd(builder, fileno(file), 10), OK );
+    CU_ASSERT_EQUAL( string_builder_length(builder), 10 );
+    CU_ASSERT_EQUAL( string_builder_subsequence(rope, 0, 10, &temp), OK );
+    CU_ASSERT_EQUAL( strcmp(string_builder_data(builder, &size), temp), 0 );
+    free(temp);
+    fclose(file);
+
+    string_builder_destroy(rope);
+    string_builder_destroy(builder);
+}
+
+static void _test_append_all() {
+
+    StringBuilder *builder;
+    Status status;
+    char *strs[] = { "alpha", NULL, "", "beta" };
+    char *temp, *tail;
+    long room;
+
+    status = string_builder_new(&builder, 4L, DEFAULT_GROWTH_FACTOR, NULL);
+    CU_ASSERT_EQUAL( status, OK );
+    CU_ASSERT_EQUAL( string_builder_appendAll(builder, strs, -1), INVALID_INDEX );
+    CU_ASSERT_EQUAL( string_builder_appendAll(builder, strs, 4), OK );
+    CU_ASSERT_EQUAL( string_builder_length(builder), 13 );
+
+    // Characters written into the reserved room only count once committed
+    CU_ASSERT_EQUAL( string_builder_reserveTail(builder, 32, &tail, &room), OK );
+    CU_ASSERT_EQUAL( room >= 32, TRUE );
+    CU_ASSERT_EQUAL( snprintf(tail, room, "[%d]", 42), 4 );
+    CU_ASSERT_EQUAL( string_builder_length(builder), 13 );
+    CU_ASSERT_EQUAL( string_builder_commitTail(builder, room + 1), INVALID_INDEX );
+    CU_ASSERT_EQUAL( string_builder_commitTail(builder, 4), OK );
+    CU_ASSERT_EQUAL( string_builder_toString(builder, &temp), OK );
+    CU_ASSERT_EQUAL( strcmp("alphanullbeta[42]", temp), 0 );
+    free(temp);
+    string_builder_destroy(builder);
+
+    // A rope has no contiguous room to hand out
+    CU_ASSERT_EQUAL( string_builder_newRope(&builder, NULL), OK );
+    CU_ASSERT_EQUAL( string_builder_appendAll(builder, strs, 4), OK );
+    CU_ASSERT_EQUAL( string_builder_reserveTail(builder, 8, &tail, &room), STRUCT_FULL );
+    CU_ASSERT_EQUAL( string_builder_length(builder), 13 );
+    string_builder_destroy(builder);
+}
+
+static void _test_pool() {
+
+    StringBuilder *builder, *other;
+    long i;
+
+    // A released builder comes back empty, with the buffer it grew
+    CU_ASSERT_EQUAL( string_builder_acquire(&builder), OK );
+    CU_ASSERT_EQUAL( string_builder_appendStr(builder, "pooled builder"), OK );
+    string_builder_release(builder);
+    CU_ASSERT_EQUAL( string_builder_acquire(&other), OK );
+    CU_ASSERT_EQUAL( other == builder, TRUE );
+    CU_ASSERT_EQUAL( string_builder_length(other), 0 );
+    CU_ASSERT_EQUAL( string_builder_appendStr(other, "abc"), OK );
+    CU_ASSERT_EQUAL( strcmp("abc", string_builder_data(other, &i)), 0 );
+    CU_ASSERT_EQUAL( i, 3 );
+
+    // Outlier buffers are shrunk back down when released
+    for (i = 0L; i < 200000L; i++) {
+        CU_ASSERT_EQUAL( string_builder_appendChar(other, 'x'), OK );
+    }
+    string_builder_release(other);
+    CU_ASSERT_EQUAL( string_builder_acquire(&builder), OK );
+    CU_ASSERT_EQUAL( string_builder_capacity(builder) <= 65536L, TRUE );
+    CU_ASSERT_EQUAL( string_builder_length(builder), 0 );
+    string_builder_release(builder);
+    string_builder_freePool();
+}
+
+static void _test_small_string() {
+
+    StringBuilder *builder;
+    const char *data, *moved;
+    char *temp;
+    long len, i;
+
+    // Short strings live in the builder itself until they outgrow it
+    CU_ASSERT_EQUAL( string_builder_new(&builder, 0L, DEFAULT_GROWTH_FACTOR, "key"), OK );
+    data = string_builder_data(builder, &len);
+    CU_ASSERT_EQUAL( (const char *)builder < data, TRUE );
+    CU_ASSERT_EQUAL( data < (const char *)builder + 128, TRUE );
+    for (i = 0L; i < 44L; i++) {
+        CU_ASSERT_EQUAL( string_builder_appendChar(builder, 'a' + (i % 26)), OK );
+    }
+    CU_ASSERT_EQUAL( string_builder_data(builder, &len), data );
+    CU_ASSERT_EQUAL( string_builder_appendStr(builder, "overflow"), OK );
+    moved = string_builder_data(builder, &len);
+    CU_ASSERT_EQUAL( moved != data, TRUE );
+    CU_ASSERT_EQUAL( len, 55 );
+    CU_ASSERT_EQUAL( strncmp("keyabcdefghijklmnopqrstuvwxyzabcdefghijklmnopqr", moved, 47), 0 );
+    CU_ASSERT_EQUAL( strcmp("overflow", moved + 47), 0 );
+
+    // Trimming back down moves the characters back in, detaching then copies them out
+    CU_ASSERT_EQUAL( string_builder_setLength(builder, 3L, ' '), OK );
+    CU_ASSERT_EQUAL( string_builder_trimToSize(builder), OK );
+    CU_ASSERT_EQUAL( string_builder_data(builder, &len), data );
+    CU_ASSERT_EQUAL( string_builder_detach(builder, &temp), OK );
+    CU_ASSERT_EQUAL( strcmp("key", temp), 0 );
+    CU_ASSERT_EQUAL( temp != data, TRUE );
+    free(temp);
+    CU_ASSERT_EQUAL( string_builder_appendStr(builder, "again"), OK );
+    CU_ASSERT_EQUAL( strcmp("again", string_builder_data(builder, &len)), 0 );
+    string_builder_destroy(builder);
+}
+
+static void _test_index_of() {
+
+    StringBuilder *builder;
+    Status status;
+    int i;
+
+    status = string_builder_new(&builder, DEFAULT_CAPACITY, DEFAULT_GROWTH_FACTOR, "aaab");
+    CU_ASSERT_EQUAL( status, OK );
+
+    // Matches may overlap with partial matches ending just before them
+    CU_ASSERT_EQUAL( string_builder_indexOf(builder, "aab"), 1 );
+    CU_ASSERT_EQUAL( string_builder_lastIndexOf(builder, "aa"), 1 );
+    CU_ASSERT_EQUAL( string_builder_indexOfFrom(builder, "a", 2), 2 );
+    CU_ASSERT_EQUAL( string_builder_lastIndexOfFrom(builder, "aa", 1), 0 );
+    CU_ASSERT_EQUAL( string_builder_indexOf(builder, "aaaab"), -1 );
+    CU_ASSERT_EQUAL( string_builder_lastIndexOf(builder, "aaaab"), -1 );
+    CU_ASSERT_EQUAL( string_builder_indexOf(builder, NULL), -1 );
+    CU_ASSERT_EQUAL( string_builder_indexOf(builder, ""), 0 );
+
+    // Searches across many blocks of candidates, with matches at the very ends
+    for (i = 0; i < 100; i++) {
+        CU_ASSERT_EQUAL( string_builder_appendStr(builder, "abcab"), OK );
+    }
+    CU_ASSERT_EQUAL( string_builder_appendStr(builder, "xyz"), OK );
+    CU_ASSERT_EQUAL( string_builder_indexOf(builder, "xyz"), 504 );
+    CU_ASSERT_EQUAL( string_builder_lastIndexOf(builder, "xyz"), 504 );
+    CU_ASSERT_EQUAL( string_builder_indexOf(builder, "aaab"), 0 );
+    CU_ASSERT_EQUAL( string_builder_lastIndexOf(builder, "aaab"), 0 );
+    CU_ASSERT_EQUAL( string_builder_indexOfFrom(builder, "bca", 100), 100 );
+    CU_ASSERT_EQUAL( string_builder_lastIndexOfFrom(builder, "bca", 102), 100 );
+    CU_ASSERT_EQUAL( string_builder_lastIndexOf(builder, "babc"), 498 );
+    CU_ASSERT_EQUAL( string_builder_indexOf(builder, "cc"), -1 );
+    string_builder_destroy(builder);
+}
+
 #define UNUSED __attribute__((unused))
 int main(UNUSED int argc, UNUSED char **argv) {
 
@@ -290,6 +674,15 @@ int main(UNUSED int argc, UNUSED char **argv) {
     CU_add_test(suite, "StringBuilder - Append Int", _test_append_int);
     CU_add_test(suite, "StringBuilder - Append Long", _test_append_long);
     CU_add_test(suite, "StringBuilder - Append SubStr #1", _test_append_sub_string1);
+    CU_add_test(suite, "StringBuilder - Append Bytes", _test_append_bytes);
+    CU_add_test(suite, "StringBuilder - Append Numbers", _test_append_numbers);
+    CU_add_test(suite, "StringBuilder - Rope", _test_rope);
+    CU_add_test(suite, "StringBuilder - Data & Detach", _test_data_detach);
+    CU_add_test(suite, "StringBuilder - File I/O", _test_file_io);
+    CU_add_test(suite, "StringBuilder - Append All", _test_append_all);
+    CU_add_test(suite, "StringBuilder - Index Of", _test_index_of);
+    CU_add_test(suite, "StringBuilder - Pool", _test_pool);
+    CU_add_test(suite, "StringBuilder - Small String", _test_small_string);
 
     CU_basic_set_mode(CU_BRM_VERBOSE);
     CU_basic_run_tests();
@@ -0,0 +1,309 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2020 Cole Vikupitz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <CUnit/Basic.h>
+#include "timer_wheel.h"
+#include "ts_timer_wheel.h"
+
+/* Sizes used for testing */
+#define TIMERS 20000L
+#define THREADS 8L
+#define OPS_PER_THREAD 50000L
+
+/* Timers are identified by their index, stored directly in the item pointer */
+#define E(x) ((void *)(long)(x))
+
+/* The deadline each timer was scheduled for, and how often it fired */
+static uint64_t deadlines[TIMERS];
+static long fired[TIMERS];
+
+/* The span of time covered by the advance in progress */
+static uint64_t advancedFrom;
+static uint64_t advancedTo;
+
+/* Checks that each timer fires once, during the first advance past its deadline */
+static void checkExpiry(void *item, uint64_t deadline, void *context) {
+    long i = (long)item;
+    CU_ASSERT_TRUE( context == (void *)fired );
+    CU_ASSERT_TRUE( deadline == deadlines[i] );
+    CU_ASSERT_TRUE( deadline <= advancedTo );
+    CU_ASSERT_TRUE( deadline > advancedFrom || advancedFrom == advancedTo );
+    fired[i]++;
+}
+
+/* Advances the wheel to `now`, checking the expired timers */
+static long advanceTo(TimerWheel *wheel, uint64_t now) {
+    long expired;
+    advancedFrom = timerwheel_now(wheel);
+    advancedTo = now;
+    expired = timerwheel_advance(wheel, now, checkExpiry, fired);
+    CU_ASSERT_TRUE( timerwheel_now(wheel) == now );
+    return expired;
+}
+
+static void testScheduleAndAdvance() {
+
+    TimerWheel *wheel;
+    uint64_t now = 1000000UL, deadline, earliest;
+    long i, total = 0L;
+
+    Status stat = timerwheel_new(&wheel, now);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testScheduleAndAdvance() - allocation failure");
+    CU_ASSERT_TRUE( timerwheel_nextDeadline(wheel, &deadline) == STRUCT_EMPTY );
+
+    // Deadlines on every level, most within a few thousand ticks, some far beyond the wheel
+    srand(42);
+    earliest = UINT64_MAX;
+    for (i = 0L; i < TIMERS; i++) {
+        if (i % 10L == 0L)
+            deadlines[i] = now + 1UL + ((uint64_t)rand() << 8);
+        else
+            deadlines[i] = now + 1UL + (uint64_t)(rand() % 5000);
+        fired[i] = 0L;
+        earliest = ( deadlines[i] < earliest ) ? deadlines[i] : earliest;
+        CU_ASSERT_TRUE( timerwheel_schedule(wheel, deadlines[i], E(i), NULL) == OK );
+    }
+    CU_ASSERT_TRUE( timerwheel_size(wheel) == TIMERS );
+    CU_ASSERT_TRUE( timerwheel_nextDeadline(wheel, &deadline) == OK );
+    CU_ASSERT_TRUE( deadline == earliest );
+
+    // Small steps through the near timers, then growing jumps through the far ones
+    for (i = 1L; now < 1000000UL + 6000UL; i++) {
+        now += (uint64_t)(i % 7L);
+        total += advanceTo(wheel, now);
+    }
+    while (timerwheel_isEmpty(wheel) == FALSE) {
+        CU_ASSERT_TRUE( timerwheel_nextDeadline(wheel, &deadline) == OK );
+        now = deadline + (uint64_t)(rand() % 100000);
+        total += advanceTo(wheel, now);
+    }
+    CU_ASSERT_TRUE( total == TIMERS );
+    for (i = 0L; i < TIMERS; i++)
+        CU_ASSERT_TRUE( fired[i] == 1L );
+
+    // A deadline that has already passed fires on the next advance, even without moving the clock
+    deadlines[0] = now - 5UL;
+    fired[0] = 0L;
+    CU_ASSERT_TRUE( timerwheel_schedule(wheel, deadlines[0], E(0), NULL) == OK );
+    CU_ASSERT_TRUE( timerwheel_nextDeadline(wheel, &deadline) == OK );
+    CU_ASSERT_TRUE( deadline == deadlines[0] );
+    CU_ASSERT_TRUE( advanceTo(wheel, now) == 1L );
+    CU_ASSERT_TRUE( fired[0] == 1L );
+
+    CU_ASSERT_TRUE( timerwheel_memoryUsage(wheel) > 0L );
+    timerwheel_destroy(wheel, NULL);
+
+    CU_PASS("testScheduleAndAdvance() - Test Passed");
+}
+
+static void testCancelAndReschedule() {
+
+    TimerWheel *wheel;
+    TimerHandle *handles = (TimerHandle *)malloc(sizeof(TimerHandle) * TIMERS);
+    uint64_t now = 0UL, deadline;
+    void *item;
+    long i, total = 0L;
+
+    Status stat = timerwheel_new(&wheel, now);
+    if (stat != OK || handles == NULL)
+        CU_FAIL_FATAL("ERROR: testCancelAndReschedule() - allocation failure");
+
+    srand(43);
+    for (i = 0L; i < TIMERS; i++) {
+        deadlines[i] = 1UL + (uint64_t)(rand() % 3) * ((uint64_t)rand() << (i % 24L));
+        fired[i] = 0L;
+        CU_ASSERT_TRUE( timerwheel_schedule(wheel, deadlines[i], E(i), &handles[i]) == OK );
+    }
+
+    // Cancel every third timer, and move every other third one to a new deadline
+    for (i = 0L; i < TIMERS; i += 3L) {
+        CU_ASSERT_TRUE( timerwheel_cancel(wheel, handles[i], &item) == OK );
+        CU_ASSERT_TRUE( item == E(i) );
+        CU_ASSERT_TRUE( timerwheel_cancel(wheel, handles[i], &item) == NOT_FOUND );
+        CU_ASSERT_TRUE( timerwheel_reschedule(wheel, handles[i], 1UL) == NOT_FOUND );
+    }
+    for (i = 1L; i < TIMERS; i += 3L) {
+        deadlines[i] = 1UL + (uint64_t)rand() * (uint64_t)(i % 5L);
+        CU_ASSERT_TRUE( timerwheel_reschedule(wheel, handles[i], deadlines[i]) == OK );
+    }
+    CU_ASSERT_TRUE( timerwheel_size(wheel) == TIMERS - (TIMERS + 2L) / 3L );
+
+    // Timers that fired leave stale handles, even once their memory is reused
+    while (timerwheel_isEmpty(wheel) == FALSE) {
+        now += 1UL + (uint64_t)rand();
+        total += advanceTo(wheel, now);
+    }
+    CU_ASSERT_TRUE( total == TIMERS - (TIMERS + 2L) / 3L );
+    for (i = 0L; i < TIMERS; i++) {
+        CU_ASSERT_TRUE( fired[i] == ((i % 3L == 0L) ? 0L : 1L) );
+        CU_ASSERT_TRUE( timerwheel_cancel(wheel, handles[i], &item) == NOT_FOUND );
+    }
+    CU_ASSERT_TRUE( timerwheel_schedule(wheel, now + 10UL, E(0), &handles[0]) == OK );
+    CU_ASSERT_TRUE( timerwheel_cancel(wheel, handles[1], &item) == NOT_FOUND );
+    CU_ASSERT_TRUE( timerwheel_cancel(wheel, handles[0], &item) == OK );
+
+    // Clearing the wheel cancels everything
+    for (i = 0L; i < 100L; i++) {
+        deadline = now + (1UL << i % 40L);
+        CU_ASSERT_TRUE( timerwheel_schedule(wheel, deadline, E(i), &handles[i]) == OK );
+    }
+    timerwheel_clear(wheel, NULL);
+    CU_ASSERT_TRUE( timerwheel_isEmpty(wheel) == TRUE );
+    CU_ASSERT_TRUE( timerwheel_cancel(wheel, handles[50], &item) == NOT_FOUND );
+    CU_ASSERT_TRUE( timerwheel_advance(wheel, UINT64_MAX, NULL, NULL) == 0L );
+
+    timerwheel_destroy(wheel, NULL);
+    free(handles);
+
+    CU_PASS("testCancelAndReschedule() - Test Passed");
+}
+
+/* Reschedules each expired timer once more, from within the callback */
+static void rescheduleOnce(void *item, uint64_t deadline, void *context) {
+    TimerWheel *wheel = (TimerWheel *)context;
+    if ((long)item < 1000L)
+        timerwheel_schedule(wheel, deadline + 1000UL, E((long)item + 1000L), NULL);
+}
+
+static void testCallbackReentry() {
+
+    TimerWheel *wheel;
+    long i;
+
+    Status stat = timerwheel_new(&wheel, 0UL);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testCallbackReentry() - allocation failure");
+
+    for (i = 0L; i < 1000L; i++)
+        CU_ASSERT_TRUE( timerwheel_schedule(wheel, (uint64_t)i, E(i), NULL) == OK );
+    // Timers the callbacks schedule in the past only fire on the next advance
+    CU_ASSERT_TRUE( timerwheel_advance(wheel, 5000UL, rescheduleOnce, wheel) == 1000L );
+    CU_ASSERT_TRUE( timerwheel_size(wheel) == 1000L );
+    CU_ASSERT_TRUE( timerwheel_advance(wheel, 5000UL, rescheduleOnce, wheel) == 1000L );
+    CU_ASSERT_TRUE( timerwheel_isEmpty(wheel) == TRUE );
+
+    timerwheel_destroy(wheel, NULL);
+
+    CU_PASS("testCallbackReentry() - Test Passed");
+}
+
+static ConcurrentTimerWheel *shared;
+static long cancelled;
+static long expired;
+static int stop;
+
+static void countExpiry(void *item, uint64_t deadline, void *context) {
+    (void)item;
+    (void)deadline;
+    (void)context;
+    __atomic_add_fetch(&expired, 1L, __ATOMIC_RELAXED);
+}
+
+static void *scheduler(void *arg) {
+
+    TimerHandle handles[16];
+    long i, seed = (long)arg;
+    void *item;
+
+    for (i = 0L; i < OPS_PER_THREAD; i++) {
+        uint64_t now = ts_timerwheel_now(shared);
+        // Keep a window of timers, cancelling each when its place comes round again
+        if (i >= 16L && ts_timerwheel_cancel(shared, handles[i % 16L], &item) == OK)
+            __atomic_add_fetch(&cancelled, 1L, __ATOMIC_RELAXED);
+        ts_timerwheel_schedule(shared, now + (uint64_t)((seed + i * 31L) % 200L), E(i),
+                               &handles[i % 16L]);
+    }
+    return NULL;
+}
+
+static void *ticker(void *arg) {
+
+    uint64_t now = 0UL;
+
+    (void)arg;
+    while (__atomic_load_n(&stop, __ATOMIC_ACQUIRE) == 0)
+        ts_timerwheel_advance(shared, ++now, countExpiry, NULL);
+    return NULL;
+}
+
+static void testConcurrentTimerWheel() {
+
+    pthread_t threads[THREADS], clock;
+    uint64_t deadline;
+    long i;
+
+    Status stat = ts_timerwheel_new(&shared, 0UL);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testConcurrentTimerWheel() - allocation failure");
+
+    pthread_create(&clock, NULL, ticker, NULL);
+    for (i = 0L; i < THREADS; i++)
+        pthread_create(&threads[i], NULL, scheduler, (void *)i);
+    for (i = 0L; i < THREADS; i++)
+        pthread_join(threads[i], NULL);
+    __atomic_store_n(&stop, 1, __ATOMIC_RELEASE);
+    pthread_join(clock, NULL);
+
+    // Every timer was either cancelled, expired, or is still pending
+    CU_ASSERT_TRUE( cancelled + expired + ts_timerwheel_size(shared) == THREADS * OPS_PER_THREAD );
+    if (ts_timerwheel_isEmpty(shared) == FALSE) {
+        CU_ASSERT_TRUE( ts_timerwheel_nextDeadline(shared, &deadline) == OK );
+        ts_timerwheel_advance(shared, deadline + 200UL, countExpiry, NULL);
+    }
+    CU_ASSERT_TRUE( cancelled + expired == THREADS * OPS_PER_THREAD );
+    CU_ASSERT_TRUE( ts_timerwheel_isEmpty(shared) == TRUE );
+
+    ts_timerwheel_destroy(shared, NULL);
+
+    CU_PASS("testConcurrentTimerWheel() - Test Passed");
+}
+
+#define UNUSED __attribute__((unused))
+int main(UNUSED int argc, UNUSED char **argv) {
+
+    if (CU_initialize_registry() != CUE_SUCCESS) {
+        return CU_get_error();
+    }
+
+    CU_pSuite suite = CU_add_suite("TimerWheel Tests", NULL, NULL);
+    if (suite == NULL) {
+        CU_cleanup_registry();
+        return CU_get_error();
+    }
+
+    CU_add_test(suite, "TimerWheel - Schedule and Advance", testScheduleAndAdvance);
+    CU_add_test(suite, "TimerWheel - Cancel and Reschedule", testCancelAndReschedule);
+    CU_add_test(suite, "TimerWheel - Callback Reentry", testCallbackReentry);
+    CU_add_test(suite, "ConcurrentTimerWheel - Concurrent Wheel", testConcurrentTimerWheel);
+
+    CU_basic_set_mode(CU_BRM_VERBOSE);
+    CU_basic_run_tests();
+    CU_cleanup_registry();
+
+    return 0;
+}
@@ -22,9 +22,15 @@
  * SOFTWARE.
  */
 
+#include <pthread.h>
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
 #include <CUnit/Basic.h>
+#include "snapshot.h"
 #include "tree_map.h"
+#include "ts_tree_map.h"
 
 /* Single item used for testing */
 static char *singleKey = "10";
@@ -51,6 +57,15 @@ static int treeCmp(void *x, void *y) {
     return strcmp((char *)x, (char *)y);
 }
 
+/* Number of elements passed to countDestroyed() so far */
+static int destroyed = 0;
+
+/* Destructor counting the elements it is called on, leaving the elements themselves alone */
+static void countDestroyed(void *item) {
+    (void)item;
+    destroyed++;
+}
+
 static void validateEmptyTreeMap(TreeMap *tree) {
 
     Array *arr;
@@ -425,6 +440,35 @@ static void testTreeMapIterator() {
     CU_PASS("testTreeMapIterator() - Test Passed");
 }
 
+static void testTreeMapMemoryUsage() {
+
+    TreeMap *tree;
+    Status stat;
+    int i, btree;
+    long empty;
+    char *prev;
+
+    for (btree = 0; btree < 2; btree++) {
+        stat = ( btree == 0 ) ? treemap_new(&tree, treeCmp, NULL)
+                              : treemap_newBTree(&tree, treeCmp, NULL);
+        if (stat != OK)
+            CU_FAIL_FATAL("ERROR: testTreeMapMemoryUsage() - allocation failure");
+
+        empty = treemap_memoryUsage(tree);
+        CU_ASSERT_TRUE( empty > 0L );
+        for (i = 0; i < LEN; i++) {
+            stat = treemap_put(tree, orderedKeys[i], orderedValues[i], (void **)&prev);
+            CU_ASSERT_TRUE( stat == INSERTED );
+        }
+        // A private pool may already hold room for every node, but never shrinks while in use
+        CU_ASSERT_TRUE( treemap_memoryUsage(tree) >= empty );
+        CU_ASSERT_TRUE( treemap_memoryUsage(tree) >= LEN * 2L * (long)sizeof(void *) );
+        treemap_destroy(tree, NULL);
+    }
+
+    CU_PASS("testTreeMapMemoryUsage() - Test Passed");
+}
+
 static void testTreeMapClear() {
 
     TreeMap *tree;
@@ -440,11 +484,676 @@ static void testTreeMapClear() {
         CU_ASSERT_TRUE( treemap_put(tree, orderedKeys[i], orderedValues[i], (void **)&prev) == INSERTED );
     treemap_clear(tree, NULL);
     validateEmptyTreeMap(tree);
-    treemap_destroy(tree, NULL);
+
+    // The tree is reusable once cleared, and the destructor sees every value exactly once
+    for (i = 0; i < LEN; i++)
+        CU_ASSERT_TRUE( treemap_put(tree, orderedKeys[i], orderedValues[i], (void **)&prev) == INSERTED );
+    destroyed = 0;
+    treemap_clear(tree, countDestroyed);
+    CU_ASSERT_TRUE( destroyed == LEN );
+    validateEmptyTreeMap(tree);
+    for (i = LEN - 1; i >= 0; i--)
+        CU_ASSERT_TRUE( treemap_put(tree, orderedKeys[i], orderedValues[i], (void **)&prev) == INSERTED );
+    destroyed = 0;
+    treemap_destroy(tree, countDestroyed);
+    CU_ASSERT_TRUE( destroyed == LEN );
 
     CU_PASS("testTreeMapClear() - Test Passed");
 }
 
+static void testTreeMapCursor() {
+
+    Iterator *iter;
+    Cursor cursor;
+    TreeMap *tree;
+    Status stat;
+    int i;
+    char *item, *other;
+
+    stat = treemap_new(&tree, treeCmp, NULL);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testTreeMapCursor() - allocation failure");
+
+    treemap_cursor(tree, &cursor);
+    CU_ASSERT_TRUE( cursor_hasNext(&cursor) == FALSE );
+    CU_ASSERT_TRUE( treemap_cursorNext(&cursor, (void **)&item) == ITER_END );
+
+    for (i = 0; i < LEN; i++)
+        CU_ASSERT_TRUE( treemap_put(tree, orderedKeys[i], orderedValues[i], (void **)&item) == INSERTED );
+    CU_ASSERT_TRUE( treemap_iterator(tree, &iter) == OK );
+
+    // The cursor must visit the same items in the same order as the iterator
+    i = 0;
+    treemap_cursor(tree, &cursor);
+    while (cursor_hasNext(&cursor) == TRUE) {
+        CU_ASSERT_TRUE( treemap_cursorNext(&cursor, (void **)&item) == OK );
+        CU_ASSERT_TRUE( iterator_next(iter, (void **)&other) == OK );
+        CU_ASSERT_TRUE( item == other );
+        i++;
+    }
+    CU_ASSERT_EQUAL( i, LEN );
+    CU_ASSERT_TRUE( treemap_cursorNext(&cursor, (void **)&item) == ITER_END );
+    iterator_destroy(iter);
+
+    // A structural change invalidates any cursor already in progress
+    treemap_cursor(tree, &cursor);
+    CU_ASSERT_TRUE( treemap_cursorNext(&cursor, (void **)&item) == OK );
+    CU_ASSERT_TRUE( treemap_pollFirst(tree, (void **)&item, (void **)&other) == OK );
+    CU_ASSERT_TRUE( treemap_cursorNext(&cursor, (void **)&item) == CONCURRENT_MODIFICATION );
+    treemap_destroy(tree, NULL);
+
+    CU_PASS("testTreeMapCursor() - Test Passed");
+}
+
+static void testTreeMapSnapshot() {
+
+    Array *array;
+    TreeMap *tree;
+    TmEntry *entry;
+    Status stat;
+    int i;
+    char *prev;
+
+    stat = treemap_new(&tree, treeCmp, NULL);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testTreeMapSnapshot() - allocation failure");
+
+    CU_ASSERT_TRUE( treemap_entrySnapshot(tree, &array) == STRUCT_EMPTY );
+    for (i = 0; i < LEN; i++)
+        CU_ASSERT_TRUE( treemap_put(tree, orderedKeys[i], orderedValues[i], (void **)&prev) == INSERTED );
+    CU_ASSERT_TRUE( treemap_entrySnapshot(tree, &array) == OK );
+    CU_ASSERT_EQUAL( array->len, LEN );
+    for (i = 0; i < array->len; i++) {
+        entry = (TmEntry *)array->items[i];
+        CU_ASSERT_TRUE( strcmp(tmentry_getKey(entry), orderedKeys[i]) == 0 );
+        CU_ASSERT_TRUE( strcmp(tmentry_getValue(entry), orderedValues[i]) == 0 );
+    }
+
+    // The copies outlive the treemap they were taken from
+    treemap_destroy(tree, NULL);
+    for (i = 0; i < array->len; i++)
+        CU_ASSERT_TRUE( tmentry_getKey((TmEntry *)array->items[i]) != NULL );
+    FREE_ARRAY(array)
+
+    CU_PASS("testTreeMapSnapshot() - Test Passed");
+}
+
+/* Visitor checking that entries arrive in ascending order, stopping after the key in `context` */
+static int nVisited = 0;
+static Boolean checkOrder(void *key, void *value, void *context) {
+    if (key != orderedKeys[nVisited] || value != orderedValues[nVisited])
+        return FALSE;
+    nVisited++;
+    return ( context == NULL || treeCmp(key, context) < 0 ) ? TRUE : FALSE;
+}
+
+static void testTreeMapForEach() {
+
+    TreeMap *tree;
+    Status stat;
+    int i;
+    char *prev;
+
+    stat = treemap_new(&tree, treeCmp, NULL);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testTreeMapForEach() - allocation failure");
+
+    nVisited = 0;
+    CU_ASSERT_TRUE( treemap_forEach(tree, checkOrder, NULL) == TRUE );
+    CU_ASSERT_EQUAL( nVisited, 0 );
+    for (i = LEN - 1; i >= 0; i--)
+        CU_ASSERT_TRUE( treemap_put(tree, orderedKeys[i], orderedValues[i], (void **)&prev) == INSERTED );
+
+    nVisited = 0;
+    CU_ASSERT_TRUE( treemap_forEach(tree, checkOrder, NULL) == TRUE );
+    CU_ASSERT_EQUAL( nVisited, LEN );
+    nVisited = 0;
+    CU_ASSERT_TRUE( treemap_forEach(tree, checkOrder, singleKey) == FALSE );
+    CU_ASSERT_EQUAL( nVisited, 10 );
+    treemap_destroy(tree, NULL);
+
+    CU_PASS("testTreeMapForEach() - Test Passed");
+}
+
+#define PARALLEL_LEN 100000
+static char parKeys[PARALLEL_LEN][8];
+static int outOfOrder = 0;
+
+/* Reducer and combiner returning the largest key, flagging any key seen out of order */
+static void *lastKey(void *partial, void *key, void *value, void *context) {
+    (void)value;
+    (void)context;
+    if (partial != NULL && treeCmp(partial, key) >= 0)
+        outOfOrder++;
+    return key;
+}
+static void *laterKey(void *partial, void *other, void *context) {
+    (void)context;
+    if (treeCmp(partial, other) >= 0)
+        outOfOrder++;
+    return other;
+}
+
+/* Visitor counting the entries it is passed into `context` */
+static Boolean countVisits(void *key, void *value, void *context) {
+    (void)key;
+    (void)value;
+    __atomic_add_fetch((long *)context, 1L, __ATOMIC_RELAXED);
+    return TRUE;
+}
+
+static void validateParallel(TreeMap *tree) {
+
+    long count = 0L;
+
+    outOfOrder = 0;
+    CU_ASSERT_TRUE( treemap_parallelReduce(tree, 1, lastKey, laterKey, NULL) ==
+                    parKeys[PARALLEL_LEN - 1] );
+    CU_ASSERT_TRUE( treemap_parallelReduce(tree, 5, lastKey, laterKey, NULL) ==
+                    parKeys[PARALLEL_LEN - 1] );
+    CU_ASSERT_EQUAL( outOfOrder, 0 );
+    CU_ASSERT_TRUE( treemap_parallelForEach(tree, 5, countVisits, &count) == TRUE );
+    CU_ASSERT_EQUAL( count, (long)PARALLEL_LEN );
+}
+
+static void testTreeMapParallel() {
+
+    TreeMap *tree;
+    Status stat;
+    int i;
+    char *prev;
+
+    for (i = 0; i < PARALLEL_LEN; i++)
+        sprintf(parKeys[i], "%06d", i);
+
+    stat = treemap_new(&tree, treeCmp, NULL);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testTreeMapParallel() - allocation failure");
+    CU_ASSERT_TRUE( treemap_parallelReduce(tree, 4, lastKey, laterKey, NULL) == NULL );
+    for (i = PARALLEL_LEN - 1; i >= 0; i--)
+        CU_ASSERT_TRUE( treemap_put(tree, parKeys[i], parKeys[i], (void **)&prev) == INSERTED );
+    validateParallel(tree);
+    treemap_destroy(tree, NULL);
+
+    stat = treemap_newBTree(&tree, treeCmp, NULL);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testTreeMapParallel() - allocation failure");
+    for (i = 0; i < PARALLEL_LEN; i++)
+        CU_ASSERT_TRUE( treemap_put(tree, parKeys[i], parKeys[i], (void **)&prev) == INSERTED );
+    validateParallel(tree);
+    treemap_destroy(tree, NULL);
+
+    CU_PASS("testTreeMapParallel() - Test Passed");
+}
+
+/* Number of keys used for testing the B+-tree engine, enough for several levels of nodes */
+#define BT_LEN 2000
+static char btKeys[BT_LEN][8];
+
+static void testTreeMapBTree() {
+
+    Cursor cursor;
+    Array *array;
+    TreeMap *tree;
+    TmEntry *entry;
+    Status stat;
+    int i, j;
+    char probe[8], *key, *value, *prev;
+
+    stat = treemap_newBTree(&tree, treeCmp, NULL);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testTreeMapBTree() - allocation failure");
+    validateEmptyTreeMap(tree);
+
+    // Inserts the even keys in a scrambled order, so splits happen all over the tree
+    for (i = 0; i < BT_LEN; i++)
+        sprintf(btKeys[i], "%06d", 2 * i);
+    for (i = 0; i < BT_LEN; i++) {
+        j = ( i * 7919 ) % BT_LEN;
+        CU_ASSERT_TRUE( treemap_put(tree, btKeys[j], btKeys[j], (void **)&prev) == INSERTED );
+    }
+    CU_ASSERT_TRUE( treemap_put(tree, btKeys[5], singleValue, (void **)&prev) == REPLACED );
+    CU_ASSERT_TRUE( prev == btKeys[5] );
+    CU_ASSERT_TRUE( treemap_put(tree, btKeys[5], btKeys[5], (void **)&prev) == REPLACED );
+    CU_ASSERT_EQUAL( treemap_size(tree), BT_LEN );
+
+    // Checks the lookups and the navigation functions around each key
+    for (i = 0; i < BT_LEN; i++) {
+        CU_ASSERT_TRUE( treemap_get(tree, btKeys[i], (void **)&value) == OK );
+        CU_ASSERT_TRUE( value == btKeys[i] );
+        CU_ASSERT_TRUE( treemap_floorKey(tree, btKeys[i], (void **)&key) == OK );
+        CU_ASSERT_TRUE( key == btKeys[i] );
+        CU_ASSERT_TRUE( treemap_ceilingKey(tree, btKeys[i], (void **)&key) == OK );
+        CU_ASSERT_TRUE( key == btKeys[i] );
+        stat = treemap_lowerKey(tree, btKeys[i], (void **)&key);
+        CU_ASSERT_TRUE( ( i == 0 ) ? stat == NOT_FOUND : ( stat == OK && key == btKeys[i - 1] ) );
+        stat = treemap_higherKey(tree, btKeys[i], (void **)&key);
+        CU_ASSERT_TRUE( ( i == BT_LEN - 1 ) ? stat == NOT_FOUND
+                                            : ( stat == OK && key == btKeys[i + 1] ) );
+
+        // Odd probes fall between two keys
+        sprintf(probe, "%06d", 2 * i + 1);
+        CU_ASSERT_TRUE( treemap_containsKey(tree, probe) == FALSE );
+        CU_ASSERT_TRUE( treemap_floor(tree, probe, &entry) == OK );
+        CU_ASSERT_TRUE( tmentry_getKey(entry) == btKeys[i] );
+        stat = treemap_ceiling(tree, probe, &entry);
+        if (i == BT_LEN - 1) {
+            CU_ASSERT_TRUE( stat == NOT_FOUND );
+        } else {
+            CU_ASSERT_TRUE( stat == OK && tmentry_getKey(entry) == btKeys[i + 1] );
+        }
+    }
+
+    // The array and the cursor both walk the keys in order
+    CU_ASSERT_TRUE( treemap_keyArray(tree, &array) == OK );
+    CU_ASSERT_EQUAL( array->len, BT_LEN );
+    for (i = 0; i < array->len; i++)
+        CU_ASSERT_TRUE( array->items[i] == btKeys[i] );
+    FREE_ARRAY(array)
+    i = 0;
+    treemap_cursor(tree, &cursor);
+    while (treemap_cursorNext(&cursor, (void **)&entry) == OK)
+        CU_ASSERT_TRUE( tmentry_getKey(entry) == btKeys[i++] );
+    CU_ASSERT_EQUAL( i, BT_LEN );
+
+    // Removes every other key, merging and borrowing between the nodes
+    for (i = 0; i < BT_LEN; i += 2)
+        CU_ASSERT_TRUE( treemap_remove(tree, btKeys[i], (void **)&value) == OK );
+    CU_ASSERT_TRUE( treemap_remove(tree, btKeys[0], (void **)&value) == NOT_FOUND );
+    CU_ASSERT_EQUAL( treemap_size(tree), BT_LEN / 2 );
+    for (i = 0; i < BT_LEN; i++)
+        CU_ASSERT_TRUE( treemap_containsKey(tree, btKeys[i]) == ( i % 2 == 1 ) );
+    CU_ASSERT_TRUE( treemap_floorKey(tree, btKeys[2], (void **)&key) == OK );
+    CU_ASSERT_TRUE( key == btKeys[1] );
+
+    // Polls from both ends until the tree collapses back into a single leaf
+    for (i = 1, j = BT_LEN - 1; i < j; i += 2, j -= 2) {
+        CU_ASSERT_TRUE( treemap_pollFirst(tree, (void **)&key, (void **)&value) == OK );
+        CU_ASSERT_TRUE( key == btKeys[i] );
+        CU_ASSERT_TRUE( treemap_pollLast(tree, (void **)&key, (void **)&value) == OK );
+        CU_ASSERT_TRUE( key == btKeys[j] );
+    }
+    validateEmptyTreeMap(tree);
+
+    // Clearing a large tree leaves it empty and usable
+    for (i = 0; i < BT_LEN; i++)
+        CU_ASSERT_TRUE( treemap_put(tree, btKeys[i], btKeys[i], (void **)&prev) == INSERTED );
+    treemap_clear(tree, NULL);
+    validateEmptyTreeMap(tree);
+    CU_ASSERT_TRUE( treemap_put(tree, singleKey, singleValue, (void **)&prev) == INSERTED );
+    CU_ASSERT_TRUE( treemap_lastKey(tree, (void **)&key) == OK );
+    CU_ASSERT_TRUE( key == singleKey );
+    treemap_destroy(tree, NULL);
+
+    CU_PASS("testTreeMapBTree() - Test Passed");
+}
+
+/* Walks the cursor, checking that it visits exactly the keys btKeys[first] to btKeys[last] */
+static void validateRange(Cursor *cursor, int first, int last) {
+
+    TmEntry *entry;
+    int i = first;
+
+    while (cursor_hasNext(cursor) == TRUE) {
+        CU_ASSERT_TRUE( treemap_cursorNext(cursor, (void **)&entry) == OK );
+        CU_ASSERT_TRUE( i <= last && tmentry_getKey(entry) == btKeys[i] );
+        i++;
+    }
+    CU_ASSERT_EQUAL( i, ( last < first ) ? first : last + 1 );
+    CU_ASSERT_TRUE( treemap_cursorNext(cursor, (void **)&entry) == ITER_END );
+}
+
+static void testTreeMapRange() {
+
+    Cursor cursor;
+    TreeMap *tree;
+    Status stat;
+    int i, engine;
+    char *prev, low[8], high[8];
+
+    for (i = 0; i < BT_LEN; i++)
+        sprintf(btKeys[i], "%06d", 2 * i);
+
+    // Checks both the red-black tree and the B+-tree engines
+    for (engine = 0; engine < 2; engine++) {
+        stat = ( engine == 0 ) ? treemap_new(&tree, treeCmp, NULL)
+                               : treemap_newBTree(&tree, treeCmp, NULL);
+        if (stat != OK)
+            CU_FAIL_FATAL("ERROR: testTreeMapRange() - allocation failure");
+
+        treemap_subMap(tree, btKeys[0], TRUE, btKeys[5], TRUE, &cursor);
+        validateRange(&cursor, 0, -1);
+        for (i = 0; i < BT_LEN; i++)
+            CU_ASSERT_TRUE( treemap_put(tree, btKeys[i], btKeys[i], (void **)&prev) == INSERTED );
+
+        // Bounds that are keys of the treemap, in each combination of inclusiveness
+        treemap_subMap(tree, btKeys[100], TRUE, btKeys[200], TRUE, &cursor);
+        validateRange(&cursor, 100, 200);
+        treemap_subMap(tree, btKeys[100], FALSE, btKeys[200], FALSE, &cursor);
+        validateRange(&cursor, 101, 199);
+        treemap_subMap(tree, btKeys[100], TRUE, btKeys[100], TRUE, &cursor);
+        validateRange(&cursor, 100, 100);
+        treemap_subMap(tree, btKeys[100], TRUE, btKeys[100], FALSE, &cursor);
+        validateRange(&cursor, 100, 99);
+        treemap_subMap(tree, btKeys[200], TRUE, btKeys[100], TRUE, &cursor);
+        validateRange(&cursor, 200, 199);
+
+        // Bounds that fall between keys, or past either end
+        sprintf(low, "%06d", 2 * 500 + 1);
+        sprintf(high, "%06d", 2 * 900 + 1);
+        treemap_subMap(tree, low, TRUE, high, FALSE, &cursor);
+        validateRange(&cursor, 501, 900);
+        treemap_subMap(tree, "", TRUE, "999999", TRUE, &cursor);
+        validateRange(&cursor, 0, BT_LEN - 1);
+        treemap_headMap(tree, btKeys[10], FALSE, &cursor);
+        validateRange(&cursor, 0, 9);
+        treemap_headMap(tree, "", TRUE, &cursor);
+        validateRange(&cursor, 0, -1);
+        treemap_tailMap(tree, btKeys[BT_LEN - 10], TRUE, &cursor);
+        validateRange(&cursor, BT_LEN - 10, BT_LEN - 1);
+        treemap_tailMap(tree, btKeys[BT_LEN - 1], FALSE, &cursor);
+        validateRange(&cursor, BT_LEN, BT_LEN - 1);
+        treemap_destroy(tree, NULL);
+    }
+
+    CU_PASS("testTreeMapRange() - Test Passed");
+}
+
+static void testTreeMapFromSorted() {
+
+    Array *array;
+    TreeMap *tree;
+    Status stat;
+    int i;
+    char *key, *value, *prev;
+
+    stat = treemap_fromSorted(&tree, treeCmp, NULL, NULL, NULL, 0L);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testTreeMapFromSorted() - allocation failure");
+    validateEmptyTreeMap(tree);
+    treemap_destroy(tree, NULL);
+
+    stat = treemap_fromSorted(&tree, treeCmp, NULL, (void **)orderedKeys, (void **)orderedValues,
+                              LEN);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testTreeMapFromSorted() - allocation failure");
+    CU_ASSERT_EQUAL( treemap_size(tree), LEN );
+    CU_ASSERT_TRUE( treemap_keyArray(tree, &array) == OK );
+    for (i = 0; i < LEN; i++) {
+        CU_ASSERT_TRUE( array->items[i] == orderedKeys[i] );
+        CU_ASSERT_TRUE( treemap_get(tree, orderedKeys[i], (void **)&value) == OK );
+        CU_ASSERT_TRUE( value == orderedValues[i] );
+    }
+    FREE_ARRAY(array)
+
+    // The tree must keep working as a regular treemap afterwards
+    CU_ASSERT_TRUE( treemap_put(tree, singleKey, singleValue, (void **)&prev) == REPLACED );
+    CU_ASSERT_TRUE( treemap_remove(tree, orderedKeys[0], (void **)&value) == OK );
+    CU_ASSERT_TRUE( treemap_firstKey(tree, (void **)&key) == OK );
+    CU_ASSERT_TRUE( key == orderedKeys[1] );
+    CU_ASSERT_TRUE( treemap_pollLast(tree, (void **)&key, (void **)&value) == OK );
+    CU_ASSERT_TRUE( key == orderedKeys[LEN - 1] );
+    CU_ASSERT_EQUAL( treemap_size(tree), LEN - 2 );
+    treemap_destroy(tree, NULL);
+
+    CU_PASS("testTreeMapFromSorted() - Test Passed");
+}
+
+/* Serializes a string as its characters, without the terminator */
+static long serializeString(void *item, void *buffer, long capacity) {
+
+    long len = (long)strlen((char *)item);
+
+    if (len <= capacity)
+        memcpy(buffer, item, len);
+    return len;
+}
+
+/* Deserializes a string serialized by serializeString() into a new, terminated copy */
+static void *deserializeString(const void *bytes, long len) {
+
+    char *str = (char *)malloc(len + 1);
+
+    if (str != NULL) {
+        memcpy(str, bytes, len);
+        str[len] = '\0';
+    }
+    return str;
+}
+
+static void testTreeMapSaveLoad() {
+
+    TreeMap *tree, *loaded;
+    Snapshot *snapshot;
+    const void *key, *value;
+    long keyLen, valueLen;
+    char *found, *prev;
+    Status stat;
+    FILE *file;
+    int i, engine, fd;
+
+    stat = treemap_fromSorted(&tree, treeCmp, NULL, (void **)orderedKeys, (void **)orderedValues,
+                              LEN);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testTreeMapSaveLoad() - allocation failure");
+    if ((file = tmpfile()) == NULL)
+        CU_FAIL_FATAL("ERROR: testTreeMapSaveLoad() - could not create a temporary file");
+    fd = fileno(file);
+    CU_ASSERT_TRUE( treemap_saveTo(tree, fd, serializeString, serializeString) == OK );
+
+    // The records are written in ascending key order
+    CU_ASSERT_TRUE( lseek(fd, 0, SEEK_SET) == 0 );
+    CU_ASSERT_TRUE( snapshot_open(&snapshot, fd) == OK );
+    CU_ASSERT_EQUAL( snapshot_size(snapshot), LEN );
+    CU_ASSERT_TRUE( snapshot_isSorted(snapshot) == TRUE );
+    for (i = 0; i < LEN; i++) {
+        CU_ASSERT_TRUE( snapshot_entry(snapshot, i, &key, &keyLen, &value, &valueLen) == OK );
+        CU_ASSERT_TRUE( keyLen == 2L && memcmp(key, orderedKeys[i], 2) == 0 );
+        CU_ASSERT_TRUE( valueLen == (long)strlen(orderedValues[i]) );
+    }
+    CU_ASSERT_TRUE( snapshot_get(snapshot, singleKey, 2L, &value, &valueLen) == OK );
+    CU_ASSERT_TRUE( valueLen == 3L && memcmp(value, orderedValues[9], 3) == 0 );
+    snapshot_close(snapshot);
+
+    // Empty red-black trees are built in one pass, the others take a put per record
+    for (engine = 0; engine < 3; engine++) {
+        if (engine == 2)
+            stat = treemap_newBTree(&loaded, treeCmp, free);
+        else
+            stat = treemap_new(&loaded, treeCmp, free);
+        if (stat != OK)
+            CU_FAIL_FATAL("ERROR: testTreeMapSaveLoad() - allocation failure");
+        if (engine == 1)
+            (void)treemap_put(loaded, strdup(singleKey), strdup(singleValue), (void **)&prev);
+        CU_ASSERT_TRUE( lseek(fd, 0, SEEK_SET) == 0 );
+        CU_ASSERT_TRUE( treemap_loadFrom(loaded, fd, deserializeString, deserializeString,
+                                         free) == OK );
+        CU_ASSERT_EQUAL( treemap_size(loaded), LEN );
+        for (i = 0; i < LEN; i++) {
+            CU_ASSERT_TRUE( treemap_get(loaded, orderedKeys[i], (void **)&found) == OK );
+            CU_ASSERT_TRUE( strcmp(found, orderedValues[i]) == 0 );
+        }
+        CU_ASSERT_TRUE( treemap_firstKey(loaded, (void **)&found) == OK );
+        CU_ASSERT_TRUE( strcmp(found, orderedKeys[0]) == 0 );
+        CU_ASSERT_TRUE( treemap_remove(loaded, orderedKeys[LEN - 1], (void **)&found) == OK );
+        free(found);
+        treemap_destroy(loaded, free);
+    }
+
+    fclose(file);
+    treemap_destroy(tree, NULL);
+
+    CU_PASS("testTreeMapSaveLoad() - Test Passed");
+}
+
+static void testTreeMapRank() {
+
+    TreeMap *tree;
+    TmEntry *entry;
+    Status stat;
+    int i, engine;
+    char *prev, probe[8];
+
+    for (i = 0; i < BT_LEN; i++)
+        sprintf(btKeys[i], "%06d", 2 * i);
+
+    // Checks both the red-black tree and the B+-tree engines
+    for (engine = 0; engine < 2; engine++) {
+        stat = ( engine == 0 ) ? treemap_new(&tree, treeCmp, NULL)
+                               : treemap_newBTree(&tree, treeCmp, NULL);
+        if (stat != OK)
+            CU_FAIL_FATAL("ERROR: testTreeMapRank() - allocation failure");
+
+        CU_ASSERT_TRUE( treemap_select(tree, 0L, &entry) == STRUCT_EMPTY );
+        CU_ASSERT_EQUAL( treemap_rank(tree, singleKey), 0L );
+        CU_ASSERT_EQUAL( treemap_countRange(tree, btKeys[0], TRUE, btKeys[9], TRUE), 0L );
+        for (i = 0; i < BT_LEN; i++) {
+            int j = ( i * 7919 ) % BT_LEN;
+            CU_ASSERT_TRUE( treemap_put(tree, btKeys[j], btKeys[j], (void **)&prev) == INSERTED );
+        }
+
+        // Every key is selected at its own rank
+        for (i = 0; i < BT_LEN; i++) {
+            CU_ASSERT_TRUE( treemap_select(tree, i, &entry) == OK );
+            CU_ASSERT_TRUE( tmentry_getKey(entry) == btKeys[i] );
+            CU_ASSERT_EQUAL( treemap_rank(tree, btKeys[i]), i );
+            sprintf(probe, "%06d", 2 * i + 1);
+            CU_ASSERT_EQUAL( treemap_rank(tree, probe), i + 1 );
+        }
+        CU_ASSERT_TRUE( treemap_select(tree, -1L, &entry) == INVALID_INDEX );
+        CU_ASSERT_TRUE( treemap_select(tree, BT_LEN, &entry) == INVALID_INDEX );
+
+        // Ranges in each combination of inclusiveness, then after removing half of the keys
+        CU_ASSERT_EQUAL( treemap_countRange(tree, btKeys[10], TRUE, btKeys[20], TRUE), 11L );
+        CU_ASSERT_EQUAL( treemap_countRange(tree, btKeys[10], FALSE, btKeys[20], FALSE), 9L );
+        CU_ASSERT_EQUAL( treemap_countRange(tree, btKeys[10], TRUE, btKeys[10], FALSE), 0L );
+        CU_ASSERT_EQUAL( treemap_countRange(tree, btKeys[20], TRUE, btKeys[10], TRUE), 0L );
+        CU_ASSERT_EQUAL( treemap_countRange(tree, "", TRUE, "999999", TRUE), BT_LEN );
+        for (i = 0; i < BT_LEN; i += 2)
+            CU_ASSERT_TRUE( treemap_remove(tree, btKeys[i], (void **)&prev) == OK );
+        CU_ASSERT_EQUAL( treemap_countRange(tree, btKeys[10], TRUE, btKeys[20], TRUE), 5L );
+        CU_ASSERT_TRUE( treemap_select(tree, 3L, &entry) == OK );
+        CU_ASSERT_TRUE( tmentry_getKey(entry) == btKeys[7] );
+        CU_ASSERT_EQUAL( treemap_rank(tree, btKeys[7]), 3L );
+        treemap_destroy(tree, NULL);
+    }
+
+    CU_PASS("testTreeMapRank() - Test Passed");
+}
+
+static void testTreeMapBatch() {
+
+    TreeMap *tree;
+    Status stat;
+    void *keys[LEN], *values[LEN], *out[LEN];
+    int i;
+
+    stat = treemap_new(&tree, treeCmp, NULL);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testTreeMapBatch() - allocation failure");
+
+    for (i = 0; i < LEN; i++) {
+        keys[i] = orderedKeys[LEN - 1 - i];
+        values[i] = orderedValues[LEN - 1 - i];
+    }
+    CU_ASSERT_TRUE( treemap_putAll(tree, keys, values, LEN / 2, NULL) == OK );
+    CU_ASSERT_TRUE( treemap_size(tree) == LEN / 2 );
+    CU_ASSERT_TRUE( treemap_putAll(tree, keys, values, LEN, out) == OK );
+    CU_ASSERT_TRUE( treemap_size(tree) == LEN );
+    for (i = 0; i < LEN; i++)
+        CU_ASSERT_TRUE( out[i] == ( ( i < LEN / 2 ) ? values[i] : NULL ) );
+
+    keys[0] = "00";
+    CU_ASSERT_TRUE( treemap_getAll(tree, keys, out, LEN) == LEN - 1 );
+    CU_ASSERT_TRUE( out[0] == NULL );
+    for (i = 1; i < LEN; i++)
+        CU_ASSERT_TRUE( out[i] == values[i] );
+
+    CU_ASSERT_TRUE( treemap_removeAll(tree, keys, out, LEN) == LEN - 1 );
+    CU_ASSERT_TRUE( out[0] == NULL && out[1] == values[1] );
+    CU_ASSERT_TRUE( treemap_size(tree) == 1L );
+    CU_ASSERT_TRUE( treemap_containsKey(tree, orderedKeys[LEN - 1]) == TRUE );
+    treemap_destroy(tree, NULL);
+
+    CU_PASS("testTreeMapBatch() - Test Passed");
+}
+
+#define READERS 4
+#define STABLE 1000L
+#define ROUNDS 20000L
+
+/* Comparator for keys that are longs cast to pointers */
+static int longCmp(void *x, void *y) {
+    return ( (long)x > (long)y ) - ( (long)x < (long)y );
+}
+
+/* Set once the writer of testConcurrentTreeMapBiased() is done */
+static int writerDone = 0;
+
+/**
+ * Reader thread, looks up the stable keys until the writer is done. Returns the number of lookups
+ * that went wrong.
+ */
+static void *_lookup(void *arg) {
+
+    ConcurrentTreeMap *tree = (ConcurrentTreeMap *)arg;
+    void *value, *floor;
+    long i = 0L, errors = 0L;
+
+    while (__atomic_load_n(&writerDone, __ATOMIC_ACQUIRE) == 0 || i < ROUNDS) {
+        long key = ( i++ % STABLE ) * 2L;
+        if (ts_treemap_get(tree, (void *)key, &value) != OK || (long)value != key)
+            errors++;
+        if (ts_treemap_floorKey(tree, (void *)key, &floor) != OK || (long)floor != key)
+            errors++;
+    }
+
+    return (void *)errors;
+}
+
+static void testConcurrentTreeMapBiased() {
+
+    ConcurrentTreeMap *tree;
+    pthread_t readers[READERS];
+    void *value, *result;
+    long i, errors = 0L;
+
+    ts_lock_setDefaultPolicy(LOCK_BIASED);
+    if (ts_treemap_new(&tree, longCmp, NULL) != OK)
+        CU_FAIL_FATAL("ERROR: testConcurrentTreeMapBiased() - allocation failure");
+    ts_lock_setDefaultPolicy(LOCK_MUTEX);
+
+    // The even keys stay put while the odd ones come and go under the readers
+    for (i = 0L; i < STABLE; i++)
+        CU_ASSERT_TRUE( ts_treemap_put(tree, (void *)(i * 2L), (void *)(i * 2L), &value)
+                        == INSERTED );
+    writerDone = 0;
+    for (i = 0L; i < READERS; i++)
+        CU_ASSERT_TRUE( pthread_create(&readers[i], NULL, _lookup, tree) == 0 );
+    for (i = 0L; i < ROUNDS; i++) {
+        long key = ( i % STABLE ) * 2L + 1L;
+        CU_ASSERT_TRUE( ts_treemap_put(tree, (void *)key, (void *)key, &value) == INSERTED );
+        CU_ASSERT_TRUE( ts_treemap_remove(tree, (void *)key, &value) == OK );
+    }
+    __atomic_store_n(&writerDone, 1, __ATOMIC_RELEASE);
+    for (i = 0L; i < READERS; i++) {
+        CU_ASSERT_TRUE( pthread_join(readers[i], &result) == 0 );
+        errors += (long)result;
+    }
+    CU_ASSERT_EQUAL( errors, 0L );
+
+    // Reads re-enter, and the writer sees the reads made under the bias
+    ts_treemap_lockRead(tree);
+    CU_ASSERT_TRUE( ts_treemap_get(tree, (void *)0L, &value) == OK );
+    CU_ASSERT_TRUE( ts_treemap_size(tree) == STABLE );
+    ts_treemap_unlock(tree);
+    CU_ASSERT_TRUE( ts_treemap_put(tree, (void *)1L, (void *)1L, &value) == INSERTED );
+    CU_ASSERT_TRUE( ts_treemap_size(tree) == STABLE + 1L );
+    ts_treemap_destroy(tree, NULL);
+
+    CU_PASS("testConcurrentTreeMapBiased() - Test Passed");
+}
+
 #define UNUSED __attribute__((unused))
 int main(UNUSED int argc, UNUSED char **argv) {
 
@@ -465,7 +1174,19 @@ int main(UNUSED int argc, UNUSED char **argv) {
     CU_add_test(suite, "TreeMap - Poll Last", testPollLast);
     CU_add_test(suite, "TreeMap - Array", testTreeMapToArray);
     CU_add_test(suite, "TreeMap - Iterator", testTreeMapIterator);
+    CU_add_test(suite, "TreeMap - Cursor", testTreeMapCursor);
+    CU_add_test(suite, "TreeMap - Snapshot", testTreeMapSnapshot);
+    CU_add_test(suite, "TreeMap - For Each", testTreeMapForEach);
+    CU_add_test(suite, "TreeMap - Parallel", testTreeMapParallel);
+    CU_add_test(suite, "TreeMap - B+-Tree", testTreeMapBTree);
+    CU_add_test(suite, "TreeMap - Range", testTreeMapRange);
+    CU_add_test(suite, "TreeMap - From Sorted", testTreeMapFromSorted);
+    CU_add_test(suite, "TreeMap - Save and Load", testTreeMapSaveLoad);
+    CU_add_test(suite, "TreeMap - Rank", testTreeMapRank);
+    CU_add_test(suite, "TreeMap - Batch", testTreeMapBatch);
     CU_add_test(suite, "TreeMap - Clear", testTreeMapClear);
+    CU_add_test(suite, "TreeMap - Memory Usage", testTreeMapMemoryUsage);
+    CU_add_test(suite, "TreeMap - Concurrent Biased Reads", testConcurrentTreeMapBiased);
 
     CU_basic_set_mode(CU_BRM_VERBOSE);
     CU_basic_run_tests();
@@ -22,6 +22,7 @@
  * SOFTWARE.
  */
 
+#include <stdio.h>
 #include <stdlib.h>
 #include <CUnit/Basic.h>
 #include "tree_set.h"
@@ -42,6 +43,15 @@ static int treeCmp(void *x, void *y) {
     return strcmp((char *)x, (char *)y);
 }
 
+/* Number of elements passed to countDestroyed() so far */
+static int destroyed = 0;
+
+/* Destructor counting the elements it is called on, leaving the elements themselves alone */
+static void countDestroyed(void *item) {
+    (void)item;
+    destroyed++;
+}
+
 static void validateEmptyTreeSet(TreeSet *tree) {
 
     Array *arr;
@@ -296,11 +306,269 @@ static void testTreeSetClear() {
         CU_ASSERT_TRUE( treeset_add(tree, &(orderedSet[i])) == OK );
     treeset_clear(tree, NULL);
     validateEmptyTreeSet(tree);
-    treeset_destroy(tree, NULL);
+
+    // The tree is reusable once cleared, and the destructor sees every element exactly once
+    for (i = 0; i < LEN; i++)
+        CU_ASSERT_TRUE( treeset_add(tree, orderedSet[i]) == OK );
+    destroyed = 0;
+    treeset_clear(tree, countDestroyed);
+    CU_ASSERT_TRUE( destroyed == LEN );
+    validateEmptyTreeSet(tree);
+    for (i = LEN - 1; i >= 0; i--)
+        CU_ASSERT_TRUE( treeset_add(tree, orderedSet[i]) == OK );
+    destroyed = 0;
+    treeset_destroy(tree, countDestroyed);
+    CU_ASSERT_TRUE( destroyed == LEN );
 
     CU_PASS("testTreeSetClear() - Test Passed");
 }
 
+static void testTreeSetCursor() {
+
+    Iterator *iter;
+    Cursor cursor;
+    TreeSet *tree;
+    Status stat;
+    int i;
+    char *item, *other;
+
+    stat = treeset_new(&tree, treeCmp);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testTreeSetCursor() - allocation failure");
+
+    treeset_cursor(tree, &cursor);
+    CU_ASSERT_TRUE( cursor_hasNext(&cursor) == FALSE );
+    CU_ASSERT_TRUE( treeset_cursorNext(&cursor, (void **)&item) == ITER_END );
+
+    for (i = 0; i < LEN; i++)
+        CU_ASSERT_TRUE( treeset_add(tree, orderedSet[i]) == OK );
+    CU_ASSERT_TRUE( treeset_iterator(tree, &iter) == OK );
+
+    // The cursor must visit the same items in the same order as the iterator
+    i = 0;
+    treeset_cursor(tree, &cursor);
+    while (cursor_hasNext(&cursor) == TRUE) {
+        CU_ASSERT_TRUE( treeset_cursorNext(&cursor, (void **)&item) == OK );
+        CU_ASSERT_TRUE( iterator_next(iter, (void **)&other) == OK );
+        CU_ASSERT_TRUE( item == other );
+        i++;
+    }
+    CU_ASSERT_EQUAL( i, LEN );
+    CU_ASSERT_TRUE( treeset_cursorNext(&cursor, (void **)&item) == ITER_END );
+    iterator_destroy(iter);
+
+    // A structural change invalidates any cursor already in progress
+    treeset_cursor(tree, &cursor);
+    CU_ASSERT_TRUE( treeset_cursorNext(&cursor, (void **)&item) == OK );
+    CU_ASSERT_TRUE( treeset_pollFirst(tree, (void **)&item) == OK );
+    CU_ASSERT_TRUE( treeset_cursorNext(&cursor, (void **)&item) == CONCURRENT_MODIFICATION );
+    treeset_destroy(tree, NULL);
+
+    CU_PASS("testTreeSetCursor() - Test Passed");
+}
+
+/* Walks the cursor, checking that it visits exactly orderedSet[first] to orderedSet[last] */
+static void validateRange(Cursor *cursor, int first, int last) {
+
+    char *item;
+    int i = first;
+
+    while (cursor_hasNext(cursor) == TRUE) {
+        CU_ASSERT_TRUE( treeset_cursorNext(cursor, (void **)&item) == OK );
+        CU_ASSERT_TRUE( i <= last && item == orderedSet[i] );
+        i++;
+    }
+    CU_ASSERT_EQUAL( i, ( last < first ) ? first : last + 1 );
+    CU_ASSERT_TRUE( treeset_cursorNext(cursor, (void **)&item) == ITER_END );
+}
+
+static void testTreeSetRange() {
+
+    Cursor cursor;
+    TreeSet *tree;
+    Status stat;
+    int i;
+
+    stat = treeset_new(&tree, treeCmp);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testTreeSetRange() - allocation failure");
+
+    treeset_subSet(tree, orderedSet[0], TRUE, orderedSet[5], TRUE, &cursor);
+    validateRange(&cursor, 0, -1);
+    for (i = 0; i < LEN; i++)
+        CU_ASSERT_TRUE( treeset_add(tree, orderedSet[i]) == OK );
+
+    treeset_subSet(tree, orderedSet[4], TRUE, orderedSet[9], TRUE, &cursor);
+    validateRange(&cursor, 4, 9);
+    treeset_subSet(tree, orderedSet[4], FALSE, orderedSet[9], FALSE, &cursor);
+    validateRange(&cursor, 5, 8);
+    treeset_subSet(tree, orderedSet[4], TRUE, orderedSet[4], FALSE, &cursor);
+    validateRange(&cursor, 4, 3);
+    treeset_subSet(tree, orderedSet[9], TRUE, orderedSet[4], TRUE, &cursor);
+    validateRange(&cursor, 9, 8);
+    treeset_subSet(tree, "055", TRUE, "105", TRUE, &cursor);
+    validateRange(&cursor, 5, 9);
+    treeset_headSet(tree, orderedSet[3], TRUE, &cursor);
+    validateRange(&cursor, 0, 3);
+    treeset_tailSet(tree, orderedSet[25], FALSE, &cursor);
+    validateRange(&cursor, 26, LEN - 1);
+    treeset_tailSet(tree, "31", TRUE, &cursor);
+    validateRange(&cursor, LEN, LEN - 1);
+    treeset_destroy(tree, NULL);
+
+    CU_PASS("testTreeSetRange() - Test Passed");
+}
+
+static void testTreeSetFromSorted() {
+
+    Array *array;
+    TreeSet *tree;
+    Status stat;
+    int i;
+    char *item;
+
+    stat = treeset_fromSorted(&tree, treeCmp, NULL, 0L);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testTreeSetFromSorted() - allocation failure");
+    validateEmptyTreeSet(tree);
+    treeset_destroy(tree, NULL);
+
+    stat = treeset_fromSorted(&tree, treeCmp, (void **)orderedSet, LEN);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testTreeSetFromSorted() - allocation failure");
+    CU_ASSERT_EQUAL( treeset_size(tree), LEN );
+    CU_ASSERT_TRUE( treeset_toArray(tree, &array) == OK );
+    for (i = 0; i < LEN; i++) {
+        CU_ASSERT_TRUE( array->items[i] == orderedSet[i] );
+        CU_ASSERT_TRUE( treeset_contains(tree, orderedSet[i]) == TRUE );
+    }
+    FREE_ARRAY(array)
+
+    // The tree must keep working as a regular treeset afterwards
+    CU_ASSERT_TRUE( treeset_add(tree, singleItem) == ALREADY_EXISTS );
+    CU_ASSERT_TRUE( treeset_remove(tree, orderedSet[0], NULL) == OK );
+    CU_ASSERT_TRUE( treeset_first(tree, (void **)&item) == OK );
+    CU_ASSERT_TRUE( item == orderedSet[1] );
+    CU_ASSERT_TRUE( treeset_pollLast(tree, (void **)&item) == OK );
+    CU_ASSERT_TRUE( item == orderedSet[LEN - 1] );
+    CU_ASSERT_EQUAL( treeset_size(tree), LEN - 2 );
+    treeset_destroy(tree, NULL);
+
+    CU_PASS("testTreeSetFromSorted() - Test Passed");
+}
+
+static void testTreeSetBatch() {
+
+    TreeSet *tree;
+    Status stat;
+    void *items[LEN];
+    int i;
+
+    stat = treeset_new(&tree, treeCmp);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testTreeSetBatch() - allocation failure");
+
+    for (i = 0; i < LEN; i++)
+        items[i] = orderedSet[LEN - 1 - i];
+    CU_ASSERT_TRUE( treeset_addAll(tree, items, LEN / 2) == OK );
+    CU_ASSERT_TRUE( treeset_size(tree) == LEN / 2 );
+    CU_ASSERT_TRUE( treeset_addAll(tree, items, LEN) == OK );
+    CU_ASSERT_TRUE( treeset_size(tree) == LEN );
+
+    items[0] = "00";
+    CU_ASSERT_TRUE( treeset_removeAll(tree, items, LEN, NULL) == LEN - 1 );
+    CU_ASSERT_TRUE( treeset_size(tree) == 1L );
+    CU_ASSERT_TRUE( treeset_contains(tree, orderedSet[LEN - 1]) == TRUE );
+    treeset_destroy(tree, NULL);
+
+    CU_PASS("testTreeSetBatch() - Test Passed");
+}
+
+/* Number of distinct elements used when testing the set operations */
+#define SETOP_LEN 3000
+
+/* Two copies of the same keys, for telling which treeset the elements of a result come from */
+static char keysA[SETOP_LEN][8];
+static char keysB[SETOP_LEN][8];
+
+/* Checks that `result` holds exactly the keys `i` for which `owner[i]` is set, taking each of them
+ * from `keysA` if 'a', or from `keysB` if 'b' */
+static void validateSetOp(TreeSet *result, const char *owner) {
+
+    long i, size = 0L;
+    void *found;
+
+    for (i = 0L; i < SETOP_LEN; i++) {
+        if (owner[i] != 0) {
+            size++;
+            CU_ASSERT_TRUE( treeset_ceiling(result, keysA[i], &found) == OK );
+            CU_ASSERT_TRUE( found == (void *)( owner[i] == 'a' ? keysA[i] : keysB[i] ) );
+        } else {
+            CU_ASSERT_TRUE( treeset_contains(result, keysA[i]) == FALSE );
+        }
+    }
+    CU_ASSERT_TRUE( treeset_size(result) == size );
+}
+
+static void testTreeSetAlgebra() {
+
+    static char owner[SETOP_LEN];
+    TreeSet *a, *b, *small, *result;
+    void *found;
+    long i;
+
+    if (treeset_new(&a, treeCmp) != OK || treeset_new(&b, treeCmp) != OK
+            || treeset_new(&small, treeCmp) != OK)
+        CU_FAIL_FATAL("ERROR: testTreeSetAlgebra() - allocation failure");
+
+    // `a` holds the multiples of 2, `b` the multiples of 3
+    for (i = 0L; i < SETOP_LEN; i++) {
+        sprintf(keysA[i], "%05ld", i);
+        sprintf(keysB[i], "%05ld", i);
+        if (i % 2L == 0L)
+            CU_ASSERT_TRUE( treeset_add(a, keysA[i]) == OK );
+        if (i % 3L == 0L)
+            CU_ASSERT_TRUE( treeset_add(b, keysB[i]) == OK );
+    }
+
+    // Elements in both treesets are taken from the first one
+    CU_ASSERT_TRUE( treeset_union(a, b, &result) == OK );
+    for (i = 0L; i < SETOP_LEN; i++)
+        owner[i] = ( i % 2L == 0L ) ? 'a' : ( i % 3L == 0L ) ? 'b' : 0;
+    validateSetOp(result, owner);
+    treeset_destroy(result, NULL);
+
+    CU_ASSERT_TRUE( treeset_intersect(a, b, &result) == OK );
+    for (i = 0L; i < SETOP_LEN; i++)
+        owner[i] = ( i % 6L == 0L ) ? 'a' : 0;
+    validateSetOp(result, owner);
+    treeset_destroy(result, NULL);
+
+    CU_ASSERT_TRUE( treeset_difference(a, b, &result) == OK );
+    for (i = 0L; i < SETOP_LEN; i++)
+        owner[i] = ( i % 2L == 0L && i % 3L != 0L ) ? 'a' : 0;
+    validateSetOp(result, owner);
+    treeset_destroy(result, NULL);
+
+    // A much smaller treeset is looked up in the larger one rather than merged with it
+    CU_ASSERT_TRUE( treeset_add(small, keysB[6]) == OK );
+    CU_ASSERT_TRUE( treeset_add(small, keysB[7]) == OK );
+    CU_ASSERT_TRUE( treeset_intersect(a, small, &result) == OK );
+    CU_ASSERT_TRUE( treeset_size(result) == 1L );
+    CU_ASSERT_TRUE( treeset_first(result, &found) == OK && found == keysA[6] );
+    treeset_destroy(result, NULL);
+    CU_ASSERT_TRUE( treeset_difference(small, a, &result) == OK );
+    CU_ASSERT_TRUE( treeset_size(result) == 1L );
+    CU_ASSERT_TRUE( treeset_first(result, &found) == OK && found == keysB[7] );
+    treeset_destroy(result, NULL);
+
+    treeset_destroy(a, NULL);
+    treeset_destroy(b, NULL);
+    treeset_destroy(small, NULL);
+
+    CU_PASS("testTreeSetAlgebra() - Test Passed");
+}
+
 #define UNUSED __attribute__((unused))
 int main(UNUSED int argc, UNUSED char **argv) {
 
@@ -321,7 +589,12 @@ int main(UNUSED int argc, UNUSED char **argv) {
     CU_add_test(suite, "TreeSet - Poll Last", testPollLast);
     CU_add_test(suite, "TreeSet - Array", testTreeSetToArray);
     CU_add_test(suite, "TreeSet - Iterator", testTreeSetIterator);
+    CU_add_test(suite, "TreeSet - Cursor", testTreeSetCursor);
+    CU_add_test(suite, "TreeSet - Range", testTreeSetRange);
+    CU_add_test(suite, "TreeSet - From Sorted", testTreeSetFromSorted);
+    CU_add_test(suite, "TreeSet - Batch", testTreeSetBatch);
     CU_add_test(suite, "TreeSet - Clear", testTreeSetClear);
+    CU_add_test(suite, "TreeSet - Algebra", testTreeSetAlgebra);
 
     CU_basic_set_mode(CU_BRM_VERBOSE);
     CU_basic_run_tests();
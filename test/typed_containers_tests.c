@@ -0,0 +1,313 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2020 Cole Vikupitz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <stdlib.h>
+#include <CUnit/Basic.h>
+#include "typed_array_list.h"
+#include "typed_hash_map.h"
+#include "typed_heap.h"
+#include "typed_tree_map.h"
+
+/* Sizes used for testing */
+#define SIZE 5000L
+#define KEY_RANGE 2000L
+#define OPERATIONS 200000L
+
+/* Marks an absent key in the reference arrays */
+#define ABSENT (-1L)
+
+static int compareLong(long a, long b) {
+    return (a > b) - (a < b);
+}
+
+static long hashLong(long key) {
+    return key;
+}
+
+#define EQUAL_LONG(a, b) ((a) == (b))
+
+/* Point keys all collide in the hash table, to exercise probing and backward shifts */
+typedef struct {
+    int x;
+    int y;
+} Point;
+
+#define HASH_POINT(p) ((p).x & 3)
+#define EQUAL_POINT(a, b) ((a).x == (b).x && (a).y == (b).y)
+
+CDS_DEFINE_ARRAYLIST(LongList, long)
+CDS_DEFINE_HEAP(LongHeap, long, compareLong)
+CDS_DEFINE_HASHMAP(LongMap, long, long, hashLong, EQUAL_LONG)
+CDS_DEFINE_HASHMAP(PointMap, Point, double, HASH_POINT, EQUAL_POINT)
+CDS_DEFINE_TREEMAP(LongTree, long, long, compareLong)
+
+static void testTypedArrayList() {
+
+    LongList *list;
+    long i, item = 0L;
+
+    Status stat = LongList_new(&list, 0L);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testTypedArrayList() - allocation failure");
+    CU_ASSERT_EQUAL( LongList_get(list, 0L, &item), STRUCT_EMPTY );
+    CU_ASSERT_EQUAL( LongList_remove(list, 0L, &item), STRUCT_EMPTY );
+    /* Even numbers appended, odd numbers inserted between them */
+    for (i = 0L; i < SIZE; i += 2)
+        CU_ASSERT_EQUAL( LongList_add(list, i), OK );
+    for (i = 1L; i < SIZE; i += 2)
+        CU_ASSERT_EQUAL( LongList_insert(list, i, i), OK );
+    CU_ASSERT_EQUAL( LongList_insert(list, SIZE + 1, 0L), INVALID_INDEX );
+    CU_ASSERT_EQUAL( LongList_size(list), SIZE );
+    for (i = 0L; i < SIZE; i++)
+        CU_ASSERT_EQUAL( LongList_array(list)[i], i );
+    CU_ASSERT_EQUAL( LongList_get(list, SIZE, &item), INVALID_INDEX );
+    CU_ASSERT_EQUAL( LongList_get(list, -1L, &item), INVALID_INDEX );
+    CU_ASSERT_EQUAL( LongList_set(list, 10L, -10L, &item), OK );
+    CU_ASSERT_EQUAL( item, 10L );
+    CU_ASSERT_EQUAL( LongList_get(list, 10L, &item), OK );
+    CU_ASSERT_EQUAL( item, -10L );
+    /* Removing from the front shifts the rest down */
+    CU_ASSERT_EQUAL( LongList_remove(list, 0L, &item), OK );
+    CU_ASSERT_EQUAL( item, 0L );
+    CU_ASSERT_EQUAL( LongList_remove(list, 0L, NULL), OK );
+    CU_ASSERT_EQUAL( LongList_get(list, 0L, &item), OK );
+    CU_ASSERT_EQUAL( item, 2L );
+    CU_ASSERT_EQUAL( LongList_size(list), SIZE - 2 );
+    CU_ASSERT_TRUE( LongList_memoryUsage(list) >= (long)(sizeof(long) * SIZE) );
+    LongList_clear(list);
+    CU_ASSERT_TRUE( LongList_isEmpty(list) );
+    LongList_destroy(list);
+    CU_PASS("testTypedArrayList() - Test Passed");
+}
+
+static void testTypedHeap() {
+
+    LongHeap *heap;
+    long i, item = 0L, last;
+
+    Status stat = LongHeap_new(&heap, 0L);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testTypedHeap() - allocation failure");
+    CU_ASSERT_EQUAL( LongHeap_peek(heap, &item), STRUCT_EMPTY );
+    CU_ASSERT_EQUAL( LongHeap_poll(heap, &item), STRUCT_EMPTY );
+    srand(41);
+    for (i = 0L; i < SIZE; i++)
+        CU_ASSERT_EQUAL( LongHeap_insert(heap, rand() % KEY_RANGE), OK );
+    CU_ASSERT_EQUAL( LongHeap_size(heap), SIZE );
+    /* Polling yields the elements in ascending order */
+    for (i = 0L, last = -1L; i < SIZE; i++) {
+        CU_ASSERT_EQUAL( LongHeap_peek(heap, &item), OK );
+        CU_ASSERT_EQUAL( LongHeap_poll(heap, &item), OK );
+        CU_ASSERT_TRUE( item >= last );
+        last = item;
+    }
+    CU_ASSERT_TRUE( LongHeap_isEmpty(heap) );
+    LongHeap_destroy(heap);
+    CU_PASS("testTypedHeap() - Test Passed");
+}
+
+static Boolean sumEntries(long key, long value, void *context) {
+    CU_ASSERT_EQUAL( value, key * 3 );
+    *((long *)context) += key;
+    return TRUE;
+}
+
+static void testTypedHashMap() {
+
+    LongMap *map;
+    PointMap *points;
+    long i, key, value, count = 0L, sum = 0L, check = 0L;
+    long *expected = (long *)malloc(sizeof(long) * KEY_RANGE);
+    Point point;
+    double real;
+
+    Status stat = LongMap_new(&map, 0L);
+    if (stat != OK || expected == NULL)
+        CU_FAIL_FATAL("ERROR: testTypedHashMap() - allocation failure");
+    /* Random operations checked against a direct-mapped reference */
+    for (i = 0L; i < KEY_RANGE; i++)
+        expected[i] = ABSENT;
+    srand(42);
+    for (i = 0L; i < OPERATIONS; i++) {
+        key = rand() % KEY_RANGE;
+        switch (rand() % 3) {
+        case 0:
+            stat = LongMap_put(map, key, key * 3, &value);
+            CU_ASSERT_EQUAL( stat, (expected[key] == ABSENT) ? INSERTED : REPLACED );
+            count += (expected[key] == ABSENT) ? 1 : 0;
+            expected[key] = key * 3;
+            break;
+        case 1:
+            stat = LongMap_remove(map, key, &value);
+            CU_ASSERT_EQUAL( stat, (expected[key] == ABSENT) ? NOT_FOUND : OK );
+            count -= (expected[key] == ABSENT) ? 0 : 1;
+            expected[key] = ABSENT;
+            break;
+        default:
+            stat = LongMap_get(map, key, &value);
+            CU_ASSERT_EQUAL( stat, (expected[key] == ABSENT) ? NOT_FOUND : OK );
+            if (stat == OK)
+                CU_ASSERT_EQUAL( value, expected[key] );
+            break;
+        }
+    }
+    CU_ASSERT_EQUAL( LongMap_size(map), count );
+    for (i = 0L; i < KEY_RANGE; i++) {
+        CU_ASSERT_EQUAL( LongMap_containsKey(map, i), (expected[i] != ABSENT) ? TRUE : FALSE );
+        check += (expected[i] != ABSENT) ? i : 0;
+    }
+    CU_ASSERT_TRUE( LongMap_forEach(map, sumEntries, &sum) );
+    CU_ASSERT_EQUAL( sum, check );
+    LongMap_clear(map);
+    CU_ASSERT_TRUE( LongMap_isEmpty(map) );
+    CU_ASSERT_TRUE( !LongMap_containsKey(map, 0L) );
+    LongMap_destroy(map);
+    free(expected);
+
+    /* Struct keys whose hashes all collide into four probe runs */
+    if (PointMap_new(&points, 4L) != OK)
+        CU_FAIL_FATAL("ERROR: testTypedHashMap() - allocation failure");
+    for (i = 0L; i < 256L; i++) {
+        point.x = (int)(i % 16);
+        point.y = (int)(i / 16);
+        CU_ASSERT_EQUAL( PointMap_put(points, point, (double)i, NULL), INSERTED );
+    }
+    for (i = 0L; i < 256L; i += 2) {
+        point.x = (int)(i % 16);
+        point.y = (int)(i / 16);
+        CU_ASSERT_EQUAL( PointMap_remove(points, point, NULL), OK );
+    }
+    for (i = 0L; i < 256L; i++) {
+        point.x = (int)(i % 16);
+        point.y = (int)(i / 16);
+        stat = PointMap_get(points, point, &real);
+        CU_ASSERT_EQUAL( stat, (i % 2 == 0) ? NOT_FOUND : OK );
+        if (stat == OK)
+            CU_ASSERT_EQUAL( real, (double)i );
+    }
+    CU_ASSERT_EQUAL( PointMap_size(points), 128L );
+    PointMap_destroy(points);
+    CU_PASS("testTypedHashMap() - Test Passed");
+}
+
+/* Checks that forEach() visits the keys in strictly ascending order */
+static Boolean checkAscending(long key, long value, void *context) {
+    long *last = (long *)context;
+    CU_ASSERT_EQUAL( value, key * 5 );
+    CU_ASSERT_TRUE( key > *last );
+    *last = key;
+    return TRUE;
+}
+
+static void testTypedTreeMap() {
+
+    LongTree *tree;
+    long i, j, key, value, count = 0L, last = -1L;
+    long *expected = (long *)malloc(sizeof(long) * KEY_RANGE);
+
+    Status stat = LongTree_new(&tree);
+    if (stat != OK || expected == NULL)
+        CU_FAIL_FATAL("ERROR: testTypedTreeMap() - allocation failure");
+    CU_ASSERT_EQUAL( LongTree_firstKey(tree, &key), STRUCT_EMPTY );
+    CU_ASSERT_EQUAL( LongTree_floorKey(tree, 0L, &key), STRUCT_EMPTY );
+    for (i = 0L; i < KEY_RANGE; i++)
+        expected[i] = ABSENT;
+    srand(43);
+    for (i = 0L; i < OPERATIONS; i++) {
+        key = rand() % KEY_RANGE;
+        if (rand() % 2 == 0) {
+            stat = LongTree_put(tree, key, key * 5, &value);
+            CU_ASSERT_EQUAL( stat, (expected[key] == ABSENT) ? INSERTED : REPLACED );
+            count += (expected[key] == ABSENT) ? 1 : 0;
+            expected[key] = key * 5;
+        } else {
+            stat = LongTree_remove(tree, key, &value);
+            CU_ASSERT_EQUAL( stat, (expected[key] == ABSENT) ? NOT_FOUND : OK );
+            if (stat == OK)
+                CU_ASSERT_EQUAL( value, key * 5 );
+            count -= (expected[key] == ABSENT) ? 0 : 1;
+            expected[key] = ABSENT;
+        }
+    }
+    CU_ASSERT_EQUAL( LongTree_size(tree), count );
+    CU_ASSERT_TRUE( LongTree_forEach(tree, checkAscending, &last) );
+    /* Floor and ceiling agree with a linear scan of the reference */
+    for (i = 0L; i < KEY_RANGE; i++) {
+        CU_ASSERT_EQUAL( LongTree_containsKey(tree, i), (expected[i] != ABSENT) ? TRUE : FALSE );
+        for (j = i; j >= 0L && expected[j] == ABSENT; j--)
+            ;
+        stat = LongTree_floorKey(tree, i, &key);
+        CU_ASSERT_EQUAL( stat, (j >= 0L) ? OK : NOT_FOUND );
+        if (stat == OK)
+            CU_ASSERT_EQUAL( key, j );
+        for (j = i; j < KEY_RANGE && expected[j] == ABSENT; j++)
+            ;
+        stat = LongTree_ceilingKey(tree, i, &key);
+        CU_ASSERT_EQUAL( stat, (j < KEY_RANGE) ? OK : NOT_FOUND );
+        if (stat == OK)
+            CU_ASSERT_EQUAL( key, j );
+    }
+    for (i = 0L; expected[i] == ABSENT; i++)
+        ;
+    CU_ASSERT_EQUAL( LongTree_firstKey(tree, &key), OK );
+    CU_ASSERT_EQUAL( key, i );
+    for (i = KEY_RANGE - 1; expected[i] == ABSENT; i--)
+        ;
+    CU_ASSERT_EQUAL( LongTree_lastKey(tree, &key), OK );
+    CU_ASSERT_EQUAL( key, i );
+    LongTree_clear(tree);
+    CU_ASSERT_TRUE( LongTree_isEmpty(tree) );
+    CU_ASSERT_EQUAL( LongTree_put(tree, 1L, 5L, NULL), INSERTED );
+    CU_ASSERT_EQUAL( LongTree_get(tree, 1L, &value), OK );
+    CU_ASSERT_EQUAL( value, 5L );
+    LongTree_destroy(tree);
+    free(expected);
+    CU_PASS("testTypedTreeMap() - Test Passed");
+}
+
+#define UNUSED __attribute__((unused))
+int main(UNUSED int argc, UNUSED char **argv) {
+
+    if (CU_initialize_registry() != CUE_SUCCESS) {
+        return CU_get_error();
+    }
+
+    CU_pSuite suite = CU_add_suite("Typed Container Tests", NULL, NULL);
+    if (suite == NULL) {
+        CU_cleanup_registry();
+        return CU_get_error();
+    }
+
+    CU_add_test(suite, "Typed Containers - ArrayList", testTypedArrayList);
+    CU_add_test(suite, "Typed Containers - Heap", testTypedHeap);
+    CU_add_test(suite, "Typed Containers - HashMap", testTypedHashMap);
+    CU_add_test(suite, "Typed Containers - TreeMap", testTypedTreeMap);
+
+    CU_basic_set_mode(CU_BRM_VERBOSE);
+    CU_basic_run_tests();
+    CU_cleanup_registry();
+
+    return 0;
+}
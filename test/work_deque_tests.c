@@ -0,0 +1,165 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2020 Cole Vikupitz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <pthread.h>
+#include <sched.h>
+#include <CUnit/Basic.h>
+#include "work_deque.h"
+
+/* Collection of items used for testing */
+#define LEN 6
+static char *array[] = {"red", "orange", "yellow", "green", "blue", "purple"};
+
+/* Sizes and counts used for testing */
+#define THIEVES 3
+#define TASKS 200000L
+
+static void testPushPopSteal() {
+
+    WorkDeque *deque;
+    char *item;
+    long i;
+
+    Status stat = workdeque_new(&deque, 2L);
+    if (stat != OK)
+        CU_FAIL_FATAL("ERROR: testPushPopSteal() - allocation failure");
+
+    CU_ASSERT_TRUE( workdeque_isEmpty(deque) == TRUE );
+    CU_ASSERT_TRUE( workdeque_pop(deque, (void **)&item) == STRUCT_EMPTY );
+    CU_ASSERT_TRUE( workdeque_steal(deque, (void **)&item) == STRUCT_EMPTY );
+
+    // Pushes past the initial capacity, so the array has to grow twice
+    for (i = 0L; i < LEN; i++) {
+        CU_ASSERT_TRUE( workdeque_push(deque, array[i]) == OK );
+        CU_ASSERT_EQUAL( workdeque_size(deque), i + 1L );
+    }
+
+    // The owner pops the newest tasks, thieves take the oldest
+    CU_ASSERT_TRUE( workdeque_pop(deque, (void **)&item) == OK );
+    CU_ASSERT_TRUE( item == array[LEN - 1] );
+    CU_ASSERT_TRUE( workdeque_steal(deque, (void **)&item) == OK );
+    CU_ASSERT_TRUE( item == array[0] );
+    CU_ASSERT_TRUE( workdeque_steal(deque, (void **)&item) == OK );
+    CU_ASSERT_TRUE( item == array[1] );
+    CU_ASSERT_EQUAL( workdeque_size(deque), LEN - 3L );
+    for (i = LEN - 2L; i >= 2L; i--) {
+        CU_ASSERT_TRUE( workdeque_pop(deque, (void **)&item) == OK );
+        CU_ASSERT_TRUE( item == array[i] );
+    }
+    CU_ASSERT_TRUE( workdeque_isEmpty(deque) == TRUE );
+    CU_ASSERT_TRUE( workdeque_pop(deque, (void **)&item) == STRUCT_EMPTY );
+
+    // Tasks left in the deque are handed to the destructor
+    CU_ASSERT_TRUE( workdeque_push(deque, malloc(8)) == OK );
+    CU_ASSERT_TRUE( workdeque_push(deque, malloc(8)) == OK );
+    workdeque_destroy(deque, free);
+
+    CU_PASS("testPushPopSteal() - Test Passed");
+}
+
+/* State shared between the owner and the thieves */
+static WorkDeque *shared;
+static int done;
+static long seen[TASKS + 1];
+
+/**
+ * Thief thread, steals tasks until the owner is done and the deque is drained.
+ */
+static void *_steal(void *arg) {
+
+    void *task;
+
+    while (__atomic_load_n(&done, __ATOMIC_ACQUIRE) == 0 || workdeque_isEmpty(shared) == FALSE) {
+        if (workdeque_steal(shared, &task) == OK)
+            __atomic_fetch_add(&(seen[(long)task]), 1L, __ATOMIC_RELAXED);
+        else
+            sched_yield();
+    }
+
+    return arg;
+}
+
+static void testConcurrentSteal() {
+
+    pthread_t thieves[THIEVES];
+    void *task;
+    long i, missed = 0L;
+    int j;
+
+    if (workdeque_new(&shared, 0L) != OK)
+        CU_FAIL_FATAL("ERROR: testConcurrentSteal() - allocation failure");
+
+    done = 0;
+    for (i = 0L; i <= TASKS; i++)
+        seen[i] = 0L;
+    for (j = 0; j < THIEVES; j++)
+        CU_ASSERT_TRUE( pthread_create(&thieves[j], NULL, _steal, NULL) == 0 );
+
+    // The owner pushes every task and pops back every third one while the thieves steal
+    for (i = 1L; i <= TASKS; i++) {
+        CU_ASSERT_TRUE( workdeque_push(shared, (void *)i) == OK );
+        if (i % 3L == 0L && workdeque_pop(shared, &task) == OK)
+            __atomic_fetch_add(&(seen[(long)task]), 1L, __ATOMIC_RELAXED);
+    }
+    while (workdeque_pop(shared, &task) == OK)
+        __atomic_fetch_add(&(seen[(long)task]), 1L, __ATOMIC_RELAXED);
+    __atomic_store_n(&done, 1, __ATOMIC_RELEASE);
+    for (j = 0; j < THIEVES; j++)
+        CU_ASSERT_TRUE( pthread_join(thieves[j], NULL) == 0 );
+
+    // Every task must have been taken exactly once, by either the owner or a thief
+    for (i = 1L; i <= TASKS; i++) {
+        if (seen[i] != 1L)
+            missed++;
+    }
+    CU_ASSERT_EQUAL( missed, 0L );
+    CU_ASSERT_TRUE( workdeque_isEmpty(shared) == TRUE );
+    workdeque_destroy(shared, NULL);
+
+    CU_PASS("testConcurrentSteal() - Test Passed");
+}
+
+#define UNUSED __attribute__((unused))
+int main(UNUSED int argc, UNUSED char **argv) {
+
+    if (CU_initialize_registry() != CUE_SUCCESS) {
+        return CU_get_error();
+    }
+
+    CU_pSuite suite = CU_add_suite("WorkDeque Tests", NULL, NULL);
+    if (suite == NULL) {
+        CU_cleanup_registry();
+        return CU_get_error();
+    }
+
+    CU_add_test(suite, "WorkDeque - Push, Pop & Steal", testPushPopSteal);
+    CU_add_test(suite, "WorkDeque - Concurrent Steal", testConcurrentSteal);
+
+    CU_basic_set_mode(CU_BRM_VERBOSE);
+    CU_basic_run_tests();
+    CU_cleanup_registry();
+
+    return 0;
+}